@@ -0,0 +1,137 @@
+import os
+import csv
+import random
+
+
+# Generates a Graph500 Kronecker graph of 2^scale vertices and edge_factor * 2^scale edges,
+# using the Graph500 R-MAT initiator probabilities.
+# Vertex IDs are randomly permuted such that the degree of a vertex doesn't follow from its ID.
+class Graph500(object):
+    A = 0.57
+    B = 0.19
+    C = 0.19
+
+    def __init__(self, scale, edge_factor=16, seed=0):
+        self.scale = scale
+        self.edge_factor = edge_factor
+        self.rng = random.Random(seed)
+        self.vertex_count = 1 << scale
+        self.edge_count = edge_factor * self.vertex_count
+
+    def _edge(self):
+        src = 0
+        dest = 0
+        ab = self.A + self.B
+        c_norm = self.C / (1 - ab)
+        a_norm = self.A / ab
+        for bit in range(self.scale):
+            src_bit = self.rng.random() > ab
+            dest_bit = self.rng.random() > (c_norm if src_bit else a_norm)
+            src |= src_bit << bit
+            dest |= dest_bit << bit
+        return src, dest
+
+    # Writes node and relation CSVs in the bulk loader's format, returns their paths.
+    def write_csvs(self, path):
+        permutation = list(range(self.vertex_count))
+        self.rng.shuffle(permutation)
+
+        nodes = os.path.join(path, 'Vertex.csv')
+        with open(nodes, 'w') as f:
+            writer = csv.writer(f)
+            writer.writerow(['id'])
+            for v in range(self.vertex_count):
+                writer.writerow([v])
+
+        relations = os.path.join(path, 'EDGE.csv')
+        with open(relations, 'w') as f:
+            writer = csv.writer(f)
+            writer.writerow(['src', 'dest'])
+            for _ in range(self.edge_count):
+                src, dest = self._edge()
+                writer.writerow([permutation[src], permutation[dest]])
+
+        return [nodes], [relations]
+
+
+# Generates a social network modeled after the LDBC Social Network Benchmark:
+# persons living in cities, who know each other with a skewed degree distribution,
+# create posts and like the posts of others.
+# Scale factor 1 holds 10,000 persons.
+class Social(object):
+    PERSONS_PER_SCALE = 10000
+    CITIES_PER_SCALE = 100
+    POSTS_PER_PERSON = 5
+    LIKES_PER_PERSON = 10
+    MEAN_KNOWS = 20
+
+    def __init__(self, scale, seed=0):
+        self.rng = random.Random(seed)
+        self.person_count = max(1, int(self.PERSONS_PER_SCALE * scale))
+        self.city_count = max(1, int(self.CITIES_PER_SCALE * scale))
+        self.post_count = self.person_count * self.POSTS_PER_PERSON
+
+    # Number of persons a person knows, Pareto distributed with the configured mean.
+    def _degree(self):
+        alpha = 2.0
+        degree = int(self.rng.paretovariate(alpha) * self.MEAN_KNOWS * (alpha - 1) / alpha)
+        return min(degree, self.person_count - 1)
+
+    # Node identifiers must be unique across all label files,
+    # the leading underscore keeps them out of the graph.
+    def write_csvs(self, path):
+        rng = self.rng
+        persons = os.path.join(path, 'Person.csv')
+        with open(persons, 'w') as f:
+            writer = csv.writer(f)
+            writer.writerow(['_identifier', 'id', 'name', 'age'])
+            for p in range(self.person_count):
+                writer.writerow(['p%d' % p, p, 'person_%d' % p, rng.randint(16, 80)])
+
+        cities = os.path.join(path, 'City.csv')
+        with open(cities, 'w') as f:
+            writer = csv.writer(f)
+            writer.writerow(['_identifier', 'id', 'name'])
+            for c in range(self.city_count):
+                writer.writerow(['c%d' % c, c, 'city_%d' % c])
+
+        posts = os.path.join(path, 'Post.csv')
+        with open(posts, 'w') as f:
+            writer = csv.writer(f)
+            writer.writerow(['_identifier', 'id', 'length'])
+            for m in range(self.post_count):
+                writer.writerow(['m%d' % m, m, rng.randint(1, 2000)])
+
+        knows = os.path.join(path, 'KNOWS.csv')
+        with open(knows, 'w') as f:
+            writer = csv.writer(f)
+            writer.writerow(['src', 'dest', 'since'])
+            for p in range(self.person_count):
+                for _ in range(self._degree()):
+                    friend = rng.randrange(self.person_count)
+                    if friend != p:
+                        writer.writerow(['p%d' % p, 'p%d' % friend, rng.randint(2000, 2020)])
+
+        lives_in = os.path.join(path, 'LIVES_IN.csv')
+        with open(lives_in, 'w') as f:
+            writer = csv.writer(f)
+            writer.writerow(['src', 'dest'])
+            for p in range(self.person_count):
+                writer.writerow(['p%d' % p, 'c%d' % rng.randrange(self.city_count)])
+
+        created = os.path.join(path, 'CREATED.csv')
+        with open(created, 'w') as f:
+            writer = csv.writer(f)
+            writer.writerow(['src', 'dest'])
+            for m in range(self.post_count):
+                writer.writerow(['p%d' % rng.randrange(self.person_count), 'm%d' % m])
+
+        likes = os.path.join(path, 'LIKES.csv')
+        with open(likes, 'w') as f:
+            writer = csv.writer(f)
+            writer.writerow(['src', 'dest'])
+            for p in range(self.person_count):
+                for _ in range(rng.randint(0, 2 * self.LIKES_PER_PERSON)):
+                    writer.writerow(['p%d' % p, 'm%d' % rng.randrange(self.post_count)])
+
+        return [persons, cities, posts], [knows, lives_in, created, likes]
@@ -0,0 +1,184 @@
+import os
+import sys
+import json
+import time
+import random
+import shutil
+import tempfile
+import threading
+import redis
+import click
+
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+sys.path.append(os.path.dirname(os.path.abspath(__file__)) + '/../bulk_insert')
+from generators import Graph500, Social
+from workloads import WORKLOADS
+import bulk_insert
+
+DEFAULT_MIX = 'lookup=50,hop2=20,hop3=10,aggregate=10,write=10'
+
+
+# Latencies recorded by a single client, per query class.
+class ClientStats(object):
+    def __init__(self, classes):
+        self.latencies = {c.name: [] for c in classes}
+        self.errors = {c.name: 0 for c in classes}
+
+
+def parse_mix(mix, classes):
+    weights = {}
+    for entry in mix.split(','):
+        name, weight = entry.split('=')
+        weights[name.strip()] = float(weight)
+    unknown = set(weights) - set(c.name for c in classes)
+    if unknown:
+        raise click.BadParameter("unknown query classes: %s" % ', '.join(sorted(unknown)))
+    return [weights.get(c.name, 0) for c in classes]
+
+
+DEFAULT_SCALE = {
+    'graph500': 16,
+    'social': 1,
+}
+
+
+def generate(dataset_name, scale, seed):
+    if dataset_name == 'graph500':
+        return Graph500(int(scale), seed=seed)
+    return Social(scale, seed=seed)
+
+
+# Generates the dataset and loads it through GRAPH.BULK.
+def load(host, port, password, graph, dataset):
+    path = tempfile.mkdtemp(prefix='redisgraph_benchmark_')
+    try:
+        start = time.time()
+        nodes, relations = dataset.write_csvs(path)
+        print("Generated dataset in %.2f seconds" % (time.time() - start))
+
+        args = [graph, '--host', host, '--port', str(port)]
+        if password:
+            args += ['--password', password]
+        for n in nodes:
+            args += ['--nodes', n]
+        for r in relations:
+            args += ['--relations', r]
+        bulk_insert.bulk_insert.main(args, standalone_mode=False)
+    finally:
+        shutil.rmtree(path)
+
+
+def client(host, port, password, graph, classes, weights, deadline, seed, stats):
+    con = redis.StrictRedis(host=host, port=port, password=password)
+    rng = random.Random(seed)
+    while time.time() < deadline:
+        query_class = rng.choices(classes, weights)[0]
+        query = query_class.build(rng)
+        start = time.perf_counter()
+        try:
+            con.execute_command("GRAPH.QUERY", graph, query)
+        except redis.exceptions.ResponseError:
+            stats.errors[query_class.name] += 1
+            continue
+        stats.latencies[query_class.name].append((time.perf_counter() - start) * 1000)
+
+
+def percentile(latencies, p):
+    if not latencies:
+        return 0
+    return latencies[min(len(latencies) - 1, int(len(latencies) * p))]
+
+
+def summarize(name, latencies, errors, duration):
+    latencies.sort()
+    return {
+        'class': name,
+        'count': len(latencies),
+        'errors': errors,
+        'throughput': len(latencies) / duration,
+        'mean_ms': sum(latencies) / len(latencies) if latencies else 0,
+        'p50_ms': percentile(latencies, 0.5),
+        'p90_ms': percentile(latencies, 0.9),
+        'p99_ms': percentile(latencies, 0.99),
+        'p999_ms': percentile(latencies, 0.999),
+        'max_ms': latencies[-1] if latencies else 0,
+    }
+
+
+def report(summaries):
+    print("%-10s %9s %7s %10s %9s %9s %9s %9s %9s" %
+          ('class', 'count', 'errors', 'qps', 'mean_ms', 'p50_ms', 'p99_ms', 'p999_ms', 'max_ms'))
+    for s in summaries:
+        print("%-10s %9d %7d %10.1f %9.3f %9.3f %9.3f %9.3f %9.3f" %
+              (s['class'], s['count'], s['errors'], s['throughput'], s['mean_ms'],
+               s['p50_ms'], s['p99_ms'], s['p999_ms'], s['max_ms']))
+
+
+@click.command()
+@click.option('--host', '-h', default='127.0.0.1', help='Redis server host')
+@click.option('--port', '-p', default=6379, help='Redis server port')
+@click.option('--password', '-a', default=None, help='Redis server password')
+@click.option('--graph', '-g', default='benchmark', help='Name of the benchmarked graph')
+@click.option('--dataset', '-d', type=click.Choice(sorted(WORKLOADS)), default='social', help='Generated dataset')
+@click.option('--scale', '-s', type=float, default=None,
+              help='Scale factor, the log2 of the vertex count for graph500 (default 16 for graph500, 1 for social)')
+@click.option('--seed', default=0, help='Seed of the dataset generator and of the clients')
+@click.option('--skip-load', is_flag=True, help='Benchmark an already loaded graph of the same dataset and scale')
+@click.option('--clients', '-c', default=8, help='Number of concurrent clients')
+@click.option('--duration', '-t', default=60, help='Benchmark duration in seconds')
+@click.option('--mix', '-m', default=DEFAULT_MIX, help='Query class weights (default %s)' % DEFAULT_MIX)
+@click.option('--output', '-o', default=None, help='Path to write the results to as JSON')
+def benchmark(host, port, password, graph, dataset, scale, seed, skip_load, clients, duration, mix, output):
+    if scale is None:
+        scale = DEFAULT_SCALE[dataset]
+    data = generate(dataset, scale, seed)
+    workload = WORKLOADS[dataset](data)
+    weights = parse_mix(mix, workload.classes)
+
+    con = redis.StrictRedis(host=host, port=port, password=password)
+    if not skip_load:
+        if con.exists(graph):
+            con.execute_command("GRAPH.DELETE", graph)
+        load(host, port, password, graph, data)
+        for index in workload.indices:
+            con.execute_command("GRAPH.QUERY", graph, index)
+
+    print("Running %d clients for %d seconds, mix: %s" % (clients, duration, mix))
+    deadline = time.time() + duration
+    stats = [ClientStats(workload.classes) for _ in range(clients)]
+    threads = [threading.Thread(target=client,
+                                args=(host, port, password, graph, workload.classes, weights,
+                                      deadline, seed + i + 1, stats[i]))
+               for i in range(clients)]
+    start = time.time()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    elapsed = time.time() - start
+
+    summaries = []
+    for c in workload.classes:
+        latencies = [l for s in stats for l in s.latencies[c.name]]
+        errors = sum(s.errors[c.name] for s in stats)
+        summaries.append(summarize(c.name, latencies, errors, elapsed))
+    summaries.append(summarize('total',
+                               [l for s in stats for ls in s.latencies.values() for l in ls],
+                               sum(e for s in stats for e in s.errors.values()), elapsed))
+    report(summaries)
+
+    if output:
+        with open(output, 'w') as f:
+            json.dump({
+                'dataset': dataset,
+                'scale': scale,
+                'seed': seed,
+                'clients': clients,
+                'duration': elapsed,
+                'mix': mix,
+                'results': summaries,
+            }, f, indent=2)
+
+
+if __name__ == '__main__':
+    benchmark()
@@ -0,0 +1,194 @@
+import os
+import sys
+import json
+import time
+import glob
+import shutil
+import redis
+import click
+
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+from graph_benchmark import generate, load
+
+DEFAULT_SCALES = {
+    'graph500': '14,16,18',
+    'social': '1,2,4',
+}
+
+
+def info(con, section, field):
+    return con.info(section)[field]
+
+
+def rdb_path(con):
+    directory = con.config_get('dir')['dir']
+    filename = con.config_get('dbfilename')['dbfilename']
+    return os.path.join(directory, filename)
+
+
+# Waits for the background save in progress, if any, to complete.
+def wait_bgsave(con):
+    while info(con, 'persistence', 'rdb_bgsave_in_progress'):
+        time.sleep(0.01)
+
+
+# Saves the dataset in the foreground and in the background, returning save times and the RDB size.
+def measure_save(con):
+    wait_bgsave(con)
+    start = time.time()
+    con.execute_command('SAVE')
+    save = time.time() - start
+
+    start = time.time()
+    con.execute_command('BGSAVE')
+    time.sleep(0.01)
+    wait_bgsave(con)
+    bgsave = time.time() - start
+
+    persistence = con.info('persistence')
+    return {
+        'save_sec': save,
+        'bgsave_sec': bgsave,
+        'bgsave_cow_bytes': persistence.get('rdb_last_cow_size'),
+        'rdb_bytes': os.path.getsize(rdb_path(con)),
+    }
+
+
+# Reloads the dataset from the RDB file, returning the load time and memory held once loaded.
+def measure_load(con):
+    start = time.time()
+    try:
+        con.execute_command('DEBUG', 'RELOAD', 'NOSAVE')
+        load_time = time.time() - start
+    except redis.exceptions.ResponseError:
+        # Servers older than 6.2 save before reloading, the save is measured separately.
+        con.execute_command('SAVE')
+        save = time.time() - start
+        start = time.time()
+        con.execute_command('DEBUG', 'RELOAD')
+        load_time = time.time() - start - save
+    memory = con.info('memory')
+    return {
+        'load_sec': load_time,
+        'memory_bytes': memory['used_memory'],
+        'peak_memory_bytes': memory['used_memory_peak'],
+    }
+
+
+# Resynchronizes replica from scratch, returning the time until its link to the master is up.
+def measure_sync(con, host, port, replica):
+    replica_host, replica_port = replica.split(':')
+    rcon = redis.StrictRedis(host=replica_host, port=int(replica_port))
+    rcon.execute_command('REPLICAOF', 'NO', 'ONE')
+    rcon.flushall()
+    start = time.time()
+    rcon.execute_command('REPLICAOF', host, port)
+    while True:
+        replication = rcon.info('replication')
+        if replication.get('master_link_status') == 'up' and not replication.get('master_sync_in_progress'):
+            break
+        time.sleep(0.01)
+    sync = time.time() - start
+    rcon.execute_command('REPLICAOF', 'NO', 'ONE')
+    return {'sync_sec': sync}
+
+
+def median(results, key):
+    values = sorted(r[key] for r in results if r.get(key) is not None)
+    return values[len(values) // 2] if values else None
+
+
+def summarize(name, results):
+    summary = {'name': name}
+    for key in results[0]:
+        summary[key] = median(results, key)
+    return summary
+
+
+def fmt(seconds):
+    return '-' if seconds is None else '%.3f' % seconds
+
+
+def report(summaries):
+    print("%-24s %12s %9s %9s %9s %14s %14s %9s" %
+          ('graph', 'rdb_bytes', 'save_s', 'bgsave_s', 'load_s', 'memory_bytes', 'peak_bytes', 'sync_s'))
+    for s in summaries:
+        print("%-24s %12s %9s %9s %9s %14s %14s %9s" %
+              (s['name'], s.get('rdb_bytes', '-'), fmt(s.get('save_sec')), fmt(s.get('bgsave_sec')),
+               fmt(s.get('load_sec')), s.get('memory_bytes', '-'), s.get('peak_memory_bytes', '-'),
+               fmt(s.get('sync_sec'))))
+
+
+@click.command()
+@click.option('--host', '-h', default='127.0.0.1', help='Redis server host, the server must share the local filesystem')
+@click.option('--port', '-p', default=6379, help='Redis server port')
+@click.option('--password', '-a', default=None, help='Redis server password')
+@click.option('--graph', '-g', default='benchmark', help='Name of the benchmarked graph')
+@click.option('--dataset', '-d', type=click.Choice(sorted(DEFAULT_SCALES)), default='social', help='Generated dataset')
+@click.option('--scales', '-s', default=None,
+              help='Comma separated scale factors, in ascending order (default 1,2,4 for social, 14,16,18 for graph500)')
+@click.option('--seed', default=0, help='Seed of the dataset generator')
+@click.option('--repetitions', '-r', default=3, help='Number of times each graph is saved and loaded, medians are reported')
+@click.option('--replica', default=None, help='host:port of a replica to measure full resynchronization against')
+@click.option('--fixtures', default=None,
+              help='Directory of RDB files saved by previous releases, loaded to measure each encoding version')
+@click.option('--output', '-o', default=None, help='Path to write the results to as JSON')
+def benchmark(host, port, password, graph, dataset, scales, seed, repetitions, replica, fixtures, output):
+    con = redis.StrictRedis(host=host, port=port, password=password)
+    scales = [float(s) for s in (scales or DEFAULT_SCALES[dataset]).split(',')]
+    summaries = []
+
+    for scale in scales:
+        con.flushall()
+        load(host, port, password, graph, generate(dataset, scale, seed))
+        results = []
+        for _ in range(repetitions):
+            result = measure_save(con)
+            result.update(measure_load(con))
+            if replica:
+                result.update(measure_sync(con, host, port, replica))
+            results.append(result)
+        summaries.append(summarize('%s-%g' % (dataset, scale), results))
+
+    # Loading RDB files saved by previous releases measures the decoders of older encoding versions.
+    if fixtures:
+        path = rdb_path(con)
+        backup = path + '.benchmark'
+        if os.path.exists(path):
+            shutil.copy(path, backup)
+        try:
+            for fixture in sorted(glob.glob(os.path.join(fixtures, '*.rdb'))):
+                con.flushall()
+                results = []
+                for _ in range(repetitions):
+                    shutil.copy(fixture, path)
+                    start = time.time()
+                    con.execute_command('DEBUG', 'RELOAD', 'NOSAVE')
+                    memory = con.info('memory')
+                    results.append({
+                        'rdb_bytes': os.path.getsize(fixture),
+                        'load_sec': time.time() - start,
+                        'memory_bytes': memory['used_memory'],
+                        'peak_memory_bytes': memory['used_memory_peak'],
+                    })
+                summaries.append(summarize(os.path.basename(fixture), results))
+        finally:
+            if os.path.exists(backup):
+                shutil.move(backup, path)
+
+    report(summaries)
+
+    if output:
+        with open(output, 'w') as f:
+            json.dump({
+                'dataset': dataset,
+                'scales': scales,
+                'seed': seed,
+                'repetitions': repetitions,
+                'server': con.info('server')['redis_version'],
+                'results': summaries,
+            }, f, indent=2)
+
+
+if __name__ == '__main__':
+    benchmark()
@@ -0,0 +1,81 @@
+import itertools
+
+# Query classes run against each dataset.
+# Every class builds a parameterized query given a random number generator,
+# such that executions share a cached plan, as application queries would.
+
+
+class QueryClass(object):
+    def __init__(self, name, write, build):
+        self.name = name
+        self.write = write      # Does the query modify the graph.
+        self.build = build      # Returns a query string given a random number generator.
+
+
+class Graph500Workload(object):
+    # Indices created once the graph is loaded.
+    indices = ["CREATE INDEX ON :Vertex(id)"]
+
+    def __init__(self, dataset):
+        n = dataset.vertex_count
+
+        def vertex(rng):
+            return rng.randrange(n)
+
+        self.classes = [
+            QueryClass('lookup', False, lambda rng:
+                       "CYPHER id=%d MATCH (v:Vertex {id: $id}) RETURN v.id" % vertex(rng)),
+            QueryClass('hop2', False, lambda rng:
+                       "CYPHER id=%d MATCH (v:Vertex {id: $id})-[:EDGE]->()-[:EDGE]->(x) "
+                       "RETURN count(DISTINCT x)" % vertex(rng)),
+            QueryClass('hop3', False, lambda rng:
+                       "CYPHER id=%d MATCH (v:Vertex {id: $id})-[:EDGE]->()-[:EDGE]->()-[:EDGE]->(x) "
+                       "RETURN count(DISTINCT x)" % vertex(rng)),
+            QueryClass('aggregate', False, lambda rng:
+                       "CYPHER id=%d MATCH (v:Vertex {id: $id})-[:EDGE]->(x)-[:EDGE]->(y) "
+                       "RETURN x.id, count(y) AS degree ORDER BY degree DESC LIMIT 10" % vertex(rng)),
+            QueryClass('write', True, lambda rng:
+                       "CYPHER src=%d dest=%d MATCH (a:Vertex {id: $src}), (b:Vertex {id: $dest}) "
+                       "CREATE (a)-[:EDGE]->(b)" % (vertex(rng), vertex(rng))),
+        ]
+
+
+class SocialWorkload(object):
+    indices = ["CREATE INDEX ON :Person(id)",
+               "CREATE INDEX ON :City(id)",
+               "CREATE INDEX ON :Post(id)"]
+
+    def __init__(self, dataset):
+        persons = dataset.person_count
+        cities = dataset.city_count
+        # Post IDs are assigned past the generated ones, shared by all clients.
+        post_ids = itertools.count(dataset.post_count)
+
+        def person(rng):
+            return rng.randrange(persons)
+
+        def new_post(rng):
+            return "CYPHER author=%d id=%d length=%d MATCH (a:Person {id: $author}) " \
+                   "CREATE (a)-[:CREATED]->(:Post {id: $id, length: $length})" % \
+                   (person(rng), next(post_ids), rng.randint(1, 2000))
+
+        self.classes = [
+            QueryClass('lookup', False, lambda rng:
+                       "CYPHER id=%d MATCH (p:Person {id: $id}) RETURN p.name, p.age" % person(rng)),
+            QueryClass('hop2', False, lambda rng:
+                       "CYPHER id=%d MATCH (p:Person {id: $id})-[:KNOWS]->()-[:KNOWS]->(fof) "
+                       "RETURN count(DISTINCT fof)" % person(rng)),
+            QueryClass('hop3', False, lambda rng:
+                       "CYPHER id=%d MATCH (p:Person {id: $id})-[:KNOWS]->()-[:KNOWS]->(f)-[:CREATED]->(m:Post) "
+                       "RETURN count(m)" % person(rng)),
+            QueryClass('aggregate', False, lambda rng:
+                       "CYPHER id=%d MATCH (c:City {id: $id})<-[:LIVES_IN]-(p:Person)-[:CREATED]->(m:Post) "
+                       "RETURN p.age, count(m), avg(m.length) ORDER BY p.age" % rng.randrange(cities)),
+            QueryClass('write', True, new_post),
+        ]
+
+
+WORKLOADS = {
+    'graph500': Graph500Workload,
+    'social': SocialWorkload,
+}
@@ -6475,6 +6475,17 @@ GrB_Info GxB_Matrix_Pending
     bool *pending                   // are there any pending operations
 ) ;
 
+//------------------------------------------------------------------------------
+// GxB_Matrix_Hyper_Info:  Reports whether a matrix is hypersparse and the
+// number of vector pointers allocated for it
+//------------------------------------------------------------------------------
+GrB_Info GxB_Matrix_Hyper_Info
+(
+    GrB_Matrix A,                   // matrix to query
+    bool *is_hyper,                 // is the matrix hypersparse
+    GrB_Index *plen                 // number of allocated vector pointers
+) ;
+
 //------------------------------------------------------------------------------
 // GxB_MatrixTupleIter:  Iterates over all none zero values of a matrix
 //------------------------------------------------------------------------------
@@ -6530,6 +6541,17 @@ GrB_Info GxB_MatrixTupleIter_next
     bool *depleted                  // indicate if iterator depleted
 ) ;
 
+// Advance iterator over the remaining none zero values of the current row
+GrB_Info GxB_MatrixTupleIter_next_row
+(
+    GxB_MatrixTupleIter *iter,      // iterator to consume
+    GrB_Index *row,                 // optional row index of the slice
+    const GrB_Index **cols,         // column indices of the slice
+    const void **vals,              // optional values of the slice
+    GrB_Index *count,               // number of none zero values in slice
+    bool *depleted                  // indicate if iterator depleted
+) ;
+
 // Reset iterator
 GrB_Info GxB_MatrixTupleIter_reset
 (
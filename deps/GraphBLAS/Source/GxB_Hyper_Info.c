@@ -0,0 +1,25 @@
+//------------------------------------------------------------------------------
+// GxB_Matrix_Hyper_Info: reports matrix vector pointers layout
+//------------------------------------------------------------------------------
+
+#include "GB.h"
+
+GrB_Info GxB_Matrix_Hyper_Info  // report matrix vector pointers layout
+(
+	GrB_Matrix A,           // matrix to query
+	bool *is_hyper,         // is the matrix hypersparse
+	GrB_Index *plen         // number of allocated vector pointers
+) {
+	GB_WHERE("GxB_Matrix_Hyper_Info (A)") ;
+	//--------------------------------------------------------------------------
+	// check inputs
+	//--------------------------------------------------------------------------
+	GB_RETURN_IF_NULL_OR_FAULTY(A) ;
+	GB_RETURN_IF_NULL(is_hyper) ;
+	GB_RETURN_IF_NULL(plen) ;
+
+	(*is_hyper) = A->is_hyper ;
+	(*plen) = A->plen ;
+
+	return (GrB_SUCCESS) ;
+}
@@ -13,6 +13,34 @@ static inline void _EmptyIterator
 	iter->nnz_idx = 0;
 }
 
+// Number of vectors (rows) stored in the iterated matrix.
+static inline int64_t _VectorCount
+(
+	const GxB_MatrixTupleIter *iter
+) {
+	return (iter->A->is_hyper) ? iter->A->nvec : (int64_t)iter->nrows ;
+}
+
+// Position of the first stored vector whose row index is >= rowIdx.
+static inline int64_t _LowerBound
+(
+	const GxB_MatrixTupleIter *iter,
+	GrB_Index rowIdx
+) {
+	const GrB_Matrix A = iter->A ;
+	if(!A->is_hyper) return GB_IMIN((int64_t)rowIdx, (int64_t)iter->nrows) ;
+
+	// Hypersparse, A->h holds the sorted row indices of non-empty rows.
+	int64_t lo = 0 ;
+	int64_t hi = A->nvec ;
+	while(lo < hi) {
+		int64_t mid = lo + (hi - lo) / 2 ;
+		if(A->h[mid] < (int64_t)rowIdx) lo = mid + 1 ;
+		else hi = mid ;
+	}
+	return lo ;
+}
+
 // Create a new iterator
 GrB_Info GxB_MatrixTupleIter_new
 (
@@ -51,9 +79,15 @@ GrB_Info GxB_MatrixTupleIter_iterate_row
 		return (GB_ERROR(GrB_INVALID_INDEX, (GB_LOG, "Row index out of range"))) ;
 	}
 
-	iter->nvals = iter->A->p[rowIdx + 1];
-	iter->nnz_idx = iter->A->p[rowIdx];
-	iter->row_idx = rowIdx;
+	int64_t k = _LowerBound(iter, rowIdx) ;
+	// Hypersparse matrix without entries in row, iterator is depleted.
+	if(iter->A->is_hyper && (k >= iter->A->nvec || iter->A->h[k] != (int64_t)rowIdx)) {
+		return (GrB_SUCCESS) ;
+	}
+
+	iter->nvals = iter->A->p[k + 1];
+	iter->nnz_idx = iter->A->p[k];
+	iter->row_idx = k;
 	iter->p = 0;
 	return (GrB_SUCCESS) ;
 }
@@ -73,9 +107,10 @@ GrB_Info GxB_MatrixTupleIter_jump_to_row
 		return (GB_ERROR(GrB_INVALID_INDEX, (GB_LOG, "Row index out of range"))) ;
 	}
 
+	int64_t k = _LowerBound(iter, rowIdx) ;
 	GrB_Matrix_nvals(&(iter->nvals), iter->A) ;
-	iter->nnz_idx = iter->A->p[rowIdx] ;
-	iter->row_idx = rowIdx ;
+	iter->nnz_idx = iter->A->p[k] ;
+	iter->row_idx = k ;
 	iter->p = 0 ;
 	return (GrB_SUCCESS) ;
 }
@@ -100,9 +135,10 @@ GrB_Info GxB_MatrixTupleIter_iterate_range
 		return (GB_ERROR(GrB_INVALID_INDEX, (GB_LOG, "Start row index > end row index"))) ;
 	}
 
-	iter->nnz_idx = iter->A->p[startRowIdx] ;
-	iter->row_idx = startRowIdx ;
-	if(endRowIdx < iter->nrows) iter->nvals = iter->A->p[endRowIdx + 1] ;
+	int64_t k = _LowerBound(iter, startRowIdx) ;
+	iter->nnz_idx = iter->A->p[k] ;
+	iter->row_idx = k ;
+	if(endRowIdx < iter->nrows) iter->nvals = iter->A->p[_LowerBound(iter, endRowIdx + 1)] ;
 	else GrB_Matrix_nvals(&(iter->nvals), iter->A) ;
 	iter->p = 0 ;
 	return (GrB_SUCCESS) ;
@@ -141,14 +177,17 @@ GrB_Info GxB_MatrixTupleIter_next
 	//--------------------------------------------------------------------------
 
 	const int64_t *Ap = A->p;
+	const int64_t *Ah = A->h;
+	const int64_t nvec = _VectorCount(iter);
 	int64_t i = iter->row_idx;
 
-	for(; i < iter->nrows; i++) {
+	// For hypersparse matrices i is the position of the row within A->h.
+	for(; i < nvec; i++) {
 		int64_t p = iter->p + Ap[i];
 		if(p < Ap[i + 1]) {
 			iter->p++;
 			if(row)
-				*row = i;
+				*row = (A->is_hyper) ? Ah[i] : i;
 			break;
 		}
 		iter->p = 0;
@@ -162,6 +201,58 @@ GrB_Info GxB_MatrixTupleIter_next
 	return (GrB_SUCCESS) ;
 }
 
+// Advance iterator over the rest of the current row, exposing its column
+// indices and values in place rather than a single entry at a time.
+// The slice is valid as long as the iterated matrix isn't modified.
+GrB_Info GxB_MatrixTupleIter_next_row
+(
+	GxB_MatrixTupleIter *iter,      // iterator to consume
+	GrB_Index *row,                 // optional output row index
+	const GrB_Index **cols,         // output column indices
+	const void **vals,              // optional output values
+	GrB_Index *count,               // output number of entries
+	bool *depleted                  // indicate if iterator depleted
+) {
+	GB_WHERE("GxB_MatrixTupleIter_next_row (iter, row, cols, vals, count, depleted)") ;
+	GB_RETURN_IF_NULL(iter) ;
+	GB_RETURN_IF_NULL(cols) ;
+	GB_RETURN_IF_NULL(count) ;
+	GB_RETURN_IF_NULL(depleted) ;
+
+	if(iter->nnz_idx >= iter->nvals) {
+		*count = 0 ;
+		*depleted = true ;
+		return (GrB_SUCCESS) ;
+	}
+
+	GrB_Matrix A = iter->A ;
+	const int64_t *Ap = A->p ;
+	const int64_t nvec = _VectorCount(iter) ;
+	int64_t i = iter->row_idx ;
+
+	// Skip rows already consumed.
+	while(i < nvec && iter->p + Ap[i] >= Ap[i + 1]) {
+		iter->p = 0 ;
+		i++ ;
+	}
+
+	// The slice ends with the row, or with the iterated range.
+	GrB_Index start = Ap[i] + iter->p ;
+	GrB_Index end = GB_IMIN((GrB_Index)Ap[i + 1], iter->nvals) ;
+
+	*cols = (const GrB_Index *)(A->i + start) ;
+	if(vals) *vals = (const GB_void *)A->x + start * A->type->size ;
+	if(row) *row = (A->is_hyper) ? A->h[i] : i ;
+	*count = end - start ;
+
+	iter->row_idx = i ;
+	iter->p += end - start ;
+	iter->nnz_idx = end ;
+
+	*depleted = false ;
+	return (GrB_SUCCESS) ;
+}
+
 // Reset iterator
 GrB_Info GxB_MatrixTupleIter_reset
 (
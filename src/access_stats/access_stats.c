@@ -0,0 +1,130 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "access_stats.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+#include <assert.h>
+#include <stdlib.h>
+
+__thread long long access_sample_countdown[ACCESS_TYPE_COUNT];
+
+// Scrambles an entity ID into a uniformly distributed hash code (splitmix64 finalizer).
+static inline uint64_t _Hash(uint64_t id) {
+	id += 0x9e3779b97f4a7c15ULL;
+	id = (id ^ (id >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	id = (id ^ (id >> 27)) * 0x94d049bb133111ebULL;
+	return id ^ (id >> 31);
+}
+
+AccessStats *AccessStats_New(void) {
+	if(access_sample_rate <= 0) return NULL;
+	AccessStats *stats = rm_calloc(1, sizeof(AccessStats));
+	for(int i = 0; i < ACCESS_TYPE_COUNT; i++) stats->sketches[i] = CMS_New();
+	int res = pthread_mutex_init(&stats->lock, NULL);
+	assert(res == 0);
+	return stats;
+}
+
+// Returns true if id is a candidate of type, read without holding the lock.
+static bool _IsCandidate(const AccessStats *stats, AccessType type, uint64_t id) {
+	uint count = __atomic_load_n(&stats->top_count[type], __ATOMIC_RELAXED);
+	for(uint i = 0; i < count; i++) {
+		if(__atomic_load_n(&stats->top[type][i].id, __ATOMIC_RELAXED) == id) return true;
+	}
+	return false;
+}
+
+void AccessStats_Add(AccessStats *stats, AccessType type, uint64_t id, uint64_t weight) {
+	assert(stats && type < ACCESS_TYPE_COUNT);
+	CMS *sketch = stats->sketches[type];
+	uint64_t estimate = CMS_Add(sketch, _Hash(id), weight);
+
+	/* Most accesses are either to entities which aren't hot enough to become candidates,
+	 * or to candidates whose counts are read back from the sketch, neither takes the lock. */
+	if(estimate <= __atomic_load_n(&stats->threshold[type], __ATOMIC_RELAXED)) return;
+	if(_IsCandidate(stats, type, id)) return;
+
+	pthread_mutex_lock(&stats->lock);
+	{
+		// Critical section.
+		AccessCandidate *top = stats->top[type];
+		uint count = stats->top_count[type];
+		bool present = false;
+		uint min = 0;
+		// Refresh candidate estimates, locating the least accessed candidate.
+		for(uint i = 0; i < count; i++) {
+			top[i].accesses = CMS_Estimate(sketch, _Hash(top[i].id));
+			if(top[i].id == id) present = true;
+			if(top[i].accesses < top[min].accesses) min = i;
+		}
+
+		if(!present) {
+			if(count < ACCESS_STATS_TOP_K) {
+				top[count].id = id;
+				top[count].accesses = estimate;
+				__atomic_store_n(&stats->top_count[type], count + 1, __ATOMIC_RELAXED);
+			} else if(estimate > top[min].accesses) {
+				__atomic_store_n(&top[min].id, id, __ATOMIC_RELAXED);
+				top[min].accesses = estimate;
+			}
+		}
+
+		// Once all candidates are chosen, only entities outcounting the least accessed one compete.
+		if(stats->top_count[type] == ACCESS_STATS_TOP_K) {
+			uint64_t threshold = top[0].accesses;
+			for(uint i = 1; i < ACCESS_STATS_TOP_K; i++) {
+				if(top[i].accesses < threshold) threshold = top[i].accesses;
+			}
+			__atomic_store_n(&stats->threshold[type], threshold, __ATOMIC_RELAXED);
+		}
+		// End of critical section.
+	}
+	pthread_mutex_unlock(&stats->lock);
+}
+
+void AccessStats_Sample(AccessType type, uint64_t id) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	if(gc == NULL || gc->access_stats == NULL) return;
+	// Each sampled access stands for access_sample_rate accesses.
+	AccessStats_Add(gc->access_stats, type, id, access_sample_rate);
+}
+
+static int _CandidateCompare(const void *a, const void *b) {
+	const AccessCandidate *ca = a;
+	const AccessCandidate *cb = b;
+	if(ca->accesses == cb->accesses) return (ca->id > cb->id) - (ca->id < cb->id);
+	return (ca->accesses < cb->accesses) ? 1 : -1;
+}
+
+AccessCandidate *AccessStats_Top(AccessStats *stats, AccessType type, uint *count) {
+	assert(stats && type < ACCESS_TYPE_COUNT && count);
+	AccessCandidate *top = rm_malloc(sizeof(AccessCandidate) * ACCESS_STATS_TOP_K);
+
+	pthread_mutex_lock(&stats->lock);
+	*count = stats->top_count[type];
+	for(uint i = 0; i < *count; i++) {
+		top[i].id = stats->top[type][i].id;
+		top[i].accesses = CMS_Estimate(stats->sketches[type], _Hash(top[i].id));
+	}
+	pthread_mutex_unlock(&stats->lock);
+
+	qsort(top, *count, sizeof(AccessCandidate), _CandidateCompare);
+	return top;
+}
+
+uint64_t AccessStats_Total(const AccessStats *stats, AccessType type) {
+	assert(stats && type < ACCESS_TYPE_COUNT);
+	return CMS_Total(stats->sketches[type]);
+}
+
+void AccessStats_Free(AccessStats *stats) {
+	if(stats == NULL) return;
+	for(int i = 0; i < ACCESS_TYPE_COUNT; i++) CMS_Free(stats->sketches[i]);
+	pthread_mutex_destroy(&stats->lock);
+	rm_free(stats);
+}
@@ -0,0 +1,74 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include "../util/cms.h"
+
+// Maximum number of most accessed entities reported per access type.
+#define ACCESS_STATS_TOP_K 16
+
+// Type of accessed entity.
+typedef enum {
+	ACCESS_NODE,        // Node, by ID.
+	ACCESS_LABEL,       // Label, by ID, scanned.
+	ACCESS_RELATION,    // Relationship type, by ID, traversed.
+	ACCESS_INDEX,       // Index, by label ID, queried.
+	ACCESS_TYPE_COUNT
+} AccessType;
+
+// An entity estimated to be among the most accessed.
+typedef struct {
+	uint64_t id;        // Entity ID.
+	uint64_t accesses;  // Estimated number of accesses.
+} AccessCandidate;
+
+/* Sampled entity accesses of a graph, counted by a count-min sketch per access type.
+ * Alongside each sketch the ACCESS_STATS_TOP_K entities with the highest estimates are kept,
+ * an entity replaces the least accessed candidate once its estimate exceeds the candidate's. */
+typedef struct {
+	CMS *sketches[ACCESS_TYPE_COUNT];   // Access counts per entity.
+	AccessCandidate top[ACCESS_TYPE_COUNT][ACCESS_STATS_TOP_K]; // Most accessed entities.
+	uint top_count[ACCESS_TYPE_COUNT];  // Number of candidates per access type.
+	uint64_t threshold[ACCESS_TYPE_COUNT]; // Estimate to exceed to become a candidate.
+	pthread_mutex_t lock;               // Guards the candidates.
+} AccessStats;
+
+extern long long access_sample_rate;    // One in access_sample_rate accesses is sampled, 0 disables.
+// Accesses left until the next sample, per access type.
+extern __thread long long access_sample_countdown[ACCESS_TYPE_COUNT];
+
+// Create access stats, returns NULL if access sampling is disabled.
+AccessStats *AccessStats_New(void);
+
+// Count weight accesses to entity id of type.
+void AccessStats_Add(AccessStats *stats, AccessType type, uint64_t id, uint64_t weight);
+
+// Count a sampled access to entity id of type, in the current query's graph.
+void AccessStats_Sample(AccessType type, uint64_t id);
+
+/* Note an access to entity id of type, one in ACCESS_SAMPLE_RATE accesses of each type
+ * is counted, standing for ACCESS_SAMPLE_RATE accesses. */
+static inline void AccessStats_Touch(AccessType type, uint64_t id) {
+	if(access_sample_rate == 0) return;
+	if(--access_sample_countdown[type] > 0) return;
+	access_sample_countdown[type] = access_sample_rate;
+	AccessStats_Sample(type, id);
+}
+
+/* Returns the most accessed entities of type, ordered by descending access count,
+ * sets count to the number of entities returned. The returned array is freed with rm_free. */
+AccessCandidate *AccessStats_Top(AccessStats *stats, AccessType type, uint *count);
+
+// Returns the total number of accesses of type counted.
+uint64_t AccessStats_Total(const AccessStats *stats, AccessType type);
+
+// Free access stats.
+void AccessStats_Free(AccessStats *stats);
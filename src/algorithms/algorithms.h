@@ -12,5 +12,8 @@
 #include "./all_paths.h"
 #include "./detect_cycle.h"
 #include "./longest_path.h"
+#include "./node_ordering.h"
+#include "./shortest_paths.h"
+#include "./reachable_nodes.h"
 
 #endif
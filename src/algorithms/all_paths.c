@@ -5,8 +5,10 @@
 */
 
 #include "all_paths.h"
+#include "reachable_nodes.h"
 #include "../util/arr.h"
 #include "../util/rmalloc.h"
+#include "../query_ctx.h"
 
 // Make sure context levels array have atleast 'level' entries,
 // Append given 'node' to given 'level' array.
@@ -26,6 +28,91 @@ static bool _AllPathsCtx_LevelNotEmpty(const AllPathsCtx *ctx, uint level) {
 	return (level < array_len(ctx->levels) && array_len(ctx->levels[level]) > 0);
 }
 
+static inline uint32_t *_AllPathsCtx_NodeBucket(AllPathsCtx *ctx, const Node *n) {
+	return ctx->nodeFilter + (ENTITY_GET_ID(n) % ALL_PATHS_NODE_FILTER_SIZE);
+}
+
+// Check to see if node is on the current path.
+static bool _AllPathsCtx_OnPath(AllPathsCtx *ctx, Node *n) {
+	// No path node shares the node's bucket.
+	if(*_AllPathsCtx_NodeBucket(ctx, n) == 0) return false;
+	return Path_ContainsNode(ctx->path, n);
+}
+
+static void _AllPathsCtx_PushNode(AllPathsCtx *ctx, Node n) {
+	Path_AppendNode(ctx->path, n);
+	(*_AllPathsCtx_NodeBucket(ctx, &n))++;
+}
+
+static void _AllPathsCtx_PopNode(AllPathsCtx *ctx) {
+	Node n = Path_PopNode(ctx->path);
+	(*_AllPathsCtx_NodeBucket(ctx, &n))--;
+}
+
+// Check to see if edge matches every inlined property.
+static bool _AllPathsCtx_EdgePasses(const AllPathsCtx *ctx, Edge *e) {
+	for(uint i = 0; i < ctx->filterCount; i++) {
+		SIValue *v = GraphEntity_GetProperty((GraphEntity *)e, ctx->filters[i].attr);
+		if(v == PROPERTY_NOTFOUND) return false;
+		int disjointOrNull = 0;
+		int res = SIValue_Compare(*v, ctx->filters[i].value, &disjointOrNull);
+		if(disjointOrNull == COMPARED_NULL || disjointOrNull == DISJOINT || res != 0) return false;
+	}
+	return true;
+}
+
+/* Check to see if destination can be reached from node within remaining edges,
+ * by its distance ignoring edge filters and path uniqueness. */
+static bool _AllPathsCtx_WithinReach(const AllPathsCtx *ctx, const Node *n, uint32_t remaining) {
+	if(!ctx->withinReach) return true;
+	uint32_t levels = array_len(ctx->withinReach);
+	if(remaining >= levels) remaining = levels - 1;
+	bool x;
+	return GrB_Vector_extractElement_BOOL(&x, ctx->withinReach[remaining], ENTITY_GET_ID(n)) ==
+		   GrB_SUCCESS;
+}
+
+/* Maps nodes by the number of edges needed to reach the destination,
+ * such that branches which can't reach it within the path maximum length are pruned. */
+static void _AllPathsCtx_ComputeReach(AllPathsCtx *ctx) {
+	GrB_Index n = Graph_RequiredMatrixDim(ctx->g);
+	GrB_Vector visited;
+	GrB_Vector frontier;
+	GrB_Vector_new(&visited, GrB_BOOL, n);
+	GrB_Vector_new(&frontier, GrB_BOOL, n);
+	GrB_Vector_setElement_BOOL(visited, true, ENTITY_GET_ID(ctx->dst));
+	GrB_Vector_setElement_BOOL(frontier, true, ENTITY_GET_ID(ctx->dst));
+
+	// Expanding from the destination, edges are followed in reverse.
+	GRAPH_EDGE_DIR dir = ctx->dir;
+	if(dir == GRAPH_EDGE_DIR_OUTGOING) dir = GRAPH_EDGE_DIR_INCOMING;
+	else if(dir == GRAPH_EDGE_DIR_INCOMING) dir = GRAPH_EDGE_DIR_OUTGOING;
+
+	ctx->withinReach = array_new(GrB_Vector, 4);
+	uint32_t max_edges = ctx->maxLen - 1;
+	while(true) {
+		GrB_Vector reach;
+		GrB_Vector_dup(&reach, visited);
+		ctx->withinReach = array_append(ctx->withinReach, reach);
+		if(array_len(ctx->withinReach) > max_edges) break;
+
+		GrB_Index nvals;
+		GrB_Vector next;
+		GrB_Vector_new(&next, GrB_BOOL, n);
+		ReachableNodes_Expand(ctx->g, next, frontier, visited, ctx->relationIDs, ctx->relationCount,
+							  dir);
+		GrB_Vector_nvals(&nvals, next);
+		GrB_free(&frontier);
+		frontier = next;
+		// Nothing new is reached, remaining levels are the same.
+		if(nvals == 0) break;
+		GrB_eWiseAdd_Vector_BinaryOp(visited, GrB_NULL, GrB_NULL, GrB_LOR, visited, next, GrB_NULL);
+	}
+
+	GrB_free(&visited);
+	GrB_free(&frontier);
+}
+
 // Traverse from the frontier node in the specified direction and add all encountered nodes and edges.
 static void _addNeighbors(AllPathsCtx *ctx, LevelConnection *frontier, uint32_t depth,
 						  GRAPH_EDGE_DIR dir) {
@@ -42,6 +129,7 @@ static void _addNeighbors(AllPathsCtx *ctx, LevelConnection *frontier, uint32_t
 	for(uint32_t i = 0; i < neighborsCount; i++) {
 		// Don't follow the frontier edge again.
 		if(frontierId == ENTITY_GET_ID(ctx->neighbors + i)) continue;
+		if(ctx->filters && !_AllPathsCtx_EdgePasses(ctx, ctx->neighbors + i)) continue;
 		// Set the neighbor by following the edge in the correct directoin.
 		Node neighbor;
 		switch(dir) {
@@ -54,6 +142,8 @@ static void _addNeighbors(AllPathsCtx *ctx, LevelConnection *frontier, uint32_t
 		default:
 			assert(false && "encountered unexpected traversal direction in AllPaths");
 		}
+		// Skip neighbors from which the destination is out of reach, reached at depth edges.
+		if(!_AllPathsCtx_WithinReach(ctx, &neighbor, ctx->maxLen - 1 - depth)) continue;
 		// Add the node and edge to the frontier.
 		_AllPathsCtx_AddConnectionToLevel(ctx, depth, &neighbor, (ctx->neighbors + i));
 	}
@@ -80,13 +170,27 @@ AllPathsCtx *AllPathsCtx_New(Node *src, Node *dst, Graph *g, int *relationIDs, i
 	ctx->neighbors = array_new(Edge, 32);
 	_AllPathsCtx_AddConnectionToLevel(ctx, 0, src, NULL);
 	ctx->dst = dst;
+	ctx->filters = NULL;
+	ctx->filterCount = 0;
+	memset(ctx->nodeFilter, 0, sizeof(ctx->nodeFilter));
+	ctx->withinReach = NULL;
+	// Deep searches to a destination skip branches which can't reach it.
+	if(dst && maxLen >= ALL_PATHS_PRUNE_MIN_LEN) _AllPathsCtx_ComputeReach(ctx);
 	return ctx;
 }
 
+void AllPathsCtx_SetEdgeFilters(AllPathsCtx *ctx, AllPathsEdgeFilter *filters, uint filterCount) {
+	assert(ctx && Path_NodeCount(ctx->path) == 0);
+	ctx->filters = filterCount > 0 ? filters : NULL;
+	ctx->filterCount = filterCount;
+}
+
 Path *AllPathsCtx_NextPath(AllPathsCtx *ctx) {
 	if(!ctx) return NULL;
 	// As long as path is not empty OR there are neighbors to traverse.
 	while(Path_NodeCount(ctx->path) || _AllPathsCtx_LevelNotEmpty(ctx, 0)) {
+		// Traversals may run for long, abort queries which exceeded their timeout.
+		QueryCtx_CheckTimeout(NULL);
 		uint32_t depth = Path_NodeCount(ctx->path);
 
 		// Can we advance?
@@ -100,10 +204,10 @@ Path *AllPathsCtx_NextPath(AllPathsCtx *ctx) {
 			 * such as in the case of a cycle, but in such case we
 			 * won't expand frontier.
 			 * i.e. closing a cycle and continuing traversal. */
-			bool frontierAlreadyOnPath = Path_ContainsNode(ctx->path, &frontierNode);
+			bool frontierAlreadyOnPath = _AllPathsCtx_OnPath(ctx, &frontierNode);
 
 			// Add frontier to path.
-			Path_AppendNode(ctx->path, frontierNode);
+			_AllPathsCtx_PushNode(ctx, frontierNode);
 
 			/* If depth is 0 this is the source node, there is no leading edge to it.
 			 * For depth > 0 for each frontier node, there is a leading edge. */
@@ -140,7 +244,7 @@ Path *AllPathsCtx_NextPath(AllPathsCtx *ctx) {
 			}
 		} else {
 			// No way to advance, backtrack.
-			Path_PopNode(ctx->path);
+			_AllPathsCtx_PopNode(ctx);
 			if(Path_EdgeCount(ctx->path)) Path_PopEdge(ctx->path);
 		}
 	}
@@ -155,6 +259,11 @@ void AllPathsCtx_Free(AllPathsCtx *ctx) {
 	array_free(ctx->levels);
 	Path_Free(ctx->path);
 	array_free(ctx->neighbors);
+	if(ctx->withinReach) {
+		uint32_t reachCount = array_len(ctx->withinReach);
+		for(uint32_t i = 0; i < reachCount; i++) GrB_free(&ctx->withinReach[i]);
+		array_free(ctx->withinReach);
+	}
 	rm_free(ctx);
 	ctx = NULL;
 }
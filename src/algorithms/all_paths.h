@@ -22,11 +22,20 @@
 #include "../graph/graph.h"
 #include "../graph/entities/node.h"
 
+#define ALL_PATHS_NODE_FILTER_SIZE 256  // Buckets counting path nodes by ID.
+#define ALL_PATHS_PRUNE_MIN_LEN 3        // Minimal path length, in edges, for pruning searches to a destination.
+
 typedef struct {
 	Node node;
 	Edge edge;
 } LevelConnection;
 
+// Inlined property every traversed edge must match.
+typedef struct {
+	Attribute_ID attr;  // Edge attribute.
+	SIValue value;      // Required value.
+} AllPathsEdgeFilter;
+
 typedef struct {
 	LevelConnection **levels;   // Nodes reached at depth i, and edges leading to them.
 	Path *path;                 // Current path.
@@ -38,6 +47,10 @@ typedef struct {
 	unsigned int minLen;        // Path minimum length.
 	unsigned int maxLen;        // Path max length.
 	Node *dst;                  // Destination node, defaults to NULL in case of general all paths execution.
+	AllPathsEdgeFilter *filters;    // Properties traversed edges must match, NULL if unfiltered.
+	uint filterCount;           // Length of filters.
+	uint32_t nodeFilter[ALL_PATHS_NODE_FILTER_SIZE];  // Path nodes count by bucket, rules out cycles cheaply.
+	GrB_Vector *withinReach;    // Nodes within i edges of the destination, NULL if not pruning.
 } AllPathsCtx;
 
 // Create a new All paths context object.
@@ -52,6 +65,10 @@ AllPathsCtx *AllPathsCtx_New(
 	unsigned int maxLen  // Path length must not exceed maxLen + 1 nodes.
 );
 
+/* Restrict traversed edges to those matching every filter, must be called
+ * before the first path is produced. filters are owned by the caller. */
+void AllPathsCtx_SetEdgeFilters(AllPathsCtx *ctx, AllPathsEdgeFilter *filters, uint filterCount);
+
 // Tries to produce a new path from given context
 // If no additional path can be computed return NULL.
 Path *AllPathsCtx_NextPath(AllPathsCtx *ctx);
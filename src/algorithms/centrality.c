@@ -0,0 +1,273 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "centrality.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include <stdlib.h>
+#include <assert.h>
+
+// Descriptors shared by the operations of a single computation.
+typedef struct {
+	GrB_Descriptor plain;       // No options.
+	GrB_Descriptor t0;          // Transposed first input.
+	GrB_Descriptor rs;          // Replaced output, structural mask.
+	GrB_Descriptor rst1;        // Replaced output, structural mask, transposed second input.
+	GrB_Descriptor rsc;         // Replaced output, structural complemented mask.
+	GrB_Descriptor rsct1;       // Replaced output, structural complemented mask, transposed second input.
+} CentralityDescriptors;
+
+static GrB_Descriptor _Centrality_Descriptor(bool replace, GrB_Desc_Value mask, bool t0, bool t1,
+											 int nthreads) {
+	GrB_Descriptor desc;
+	assert(GrB_Descriptor_new(&desc) == GrB_SUCCESS);
+	if(replace) GrB_Descriptor_set(desc, GrB_OUTP, GrB_REPLACE);
+	if(mask != GxB_DEFAULT) GrB_Descriptor_set(desc, GrB_MASK, mask);
+	if(t0) GrB_Descriptor_set(desc, GrB_INP0, GrB_TRAN);
+	if(t1) GrB_Descriptor_set(desc, GrB_INP1, GrB_TRAN);
+	if(nthreads > 0) GxB_Desc_set(desc, GxB_NTHREADS, nthreads);
+	return desc;
+}
+
+static void _Centrality_DescriptorsInit(CentralityDescriptors *d, int nthreads) {
+	GrB_Desc_Value s = GrB_STRUCTURE;
+	GrB_Desc_Value sc = GrB_STRUCTURE + GrB_COMP;
+	d->plain = _Centrality_Descriptor(false, GxB_DEFAULT, false, false, nthreads);
+	d->t0 = _Centrality_Descriptor(false, GxB_DEFAULT, true, false, nthreads);
+	d->rs = _Centrality_Descriptor(true, s, false, false, nthreads);
+	d->rst1 = _Centrality_Descriptor(true, s, false, true, nthreads);
+	d->rsc = _Centrality_Descriptor(true, sc, false, false, nthreads);
+	d->rsct1 = _Centrality_Descriptor(true, sc, false, true, nthreads);
+}
+
+static void _Centrality_DescriptorsFree(CentralityDescriptors *d) {
+	GrB_free(&d->plain);
+	GrB_free(&d->t0);
+	GrB_free(&d->rs);
+	GrB_free(&d->rst1);
+	GrB_free(&d->rsc);
+	GrB_free(&d->rsct1);
+}
+
+// Builds the ns x n matrix M(i, sources[i]) = 1.
+static void _Centrality_SourceMatrix(GrB_Matrix *M, GrB_Type type, const GrB_Index *sources,
+									 GrB_Index ns, GrB_Index n) {
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * ns);
+	double *X = rm_malloc(sizeof(double) * ns);
+	for(GrB_Index i = 0; i < ns; i++) {
+		I[i] = i;
+		X[i] = 1;
+	}
+	assert(GrB_Matrix_new(M, type, ns, n) == GrB_SUCCESS);
+	assert(GrB_Matrix_build_FP64(*M, I, sources, X, ns, GrB_PLUS_FP64) == GrB_SUCCESS);
+	rm_free(I);
+	rm_free(X);
+}
+
+GrB_Index *Centrality_SampleSources(GrB_Index n, GrB_Index sample, GrB_Index *count) {
+	if(sample == 0 || sample > n) sample = n;
+	GrB_Index *sources = rm_malloc(sizeof(GrB_Index) * (sample + 1));
+
+	// Selection sampling, row i is picked with probability remaining picks / remaining rows.
+	GrB_Index picked = 0;
+	for(GrB_Index i = 0; i < n && picked < sample; i++) {
+		double r = (double)rand() / ((double)RAND_MAX + 1);
+		if(r * (n - i) < sample - picked) sources[picked++] = i;
+	}
+	*count = picked;
+	return sources;
+}
+
+/* Accumulates the dependencies of the nodes on a batch of sources into centrality.
+ * The forward phase counts the shortest paths from each source, paths(s, v),
+ * recording the nodes discovered at each depth. The backward phase walks the
+ * depths bottom up, bcu(s, v) = 1 + delta(s, v) where
+ * delta(s, v) = sum over successors w of v one level below of paths(s, v) / paths(s, w) * bcu(s, w).
+ * Returns false once the query is to be aborted, centrality is then partially accumulated. */
+static bool _Betweenness_Batch(GrB_Matrix A, const GrB_Index *sources, GrB_Index ns, GrB_Index n,
+							   GrB_Vector centrality, CentralityDescriptors *d) {
+	GrB_Matrix paths;
+	GrB_Matrix frontier;
+	GrB_Index nvals;
+	_Centrality_SourceMatrix(&paths, GrB_FP64, sources, ns, n);
+	assert(GrB_Matrix_new(&frontier, GrB_FP64, ns, n) == GrB_SUCCESS);
+
+	// Nodes discovered at each depth, depth 0 holds the sources.
+	GrB_Matrix *levels = array_new(GrB_Matrix, 16);
+	GrB_Matrix level;
+	assert(GrB_Matrix_new(&level, GrB_BOOL, ns, n) == GrB_SUCCESS);
+	assert(GrB_apply(level, GrB_NULL, GrB_NULL, GxB_ONE_BOOL, paths, d->plain) == GrB_SUCCESS);
+	levels = array_append(levels, level);
+
+	// frontier<!paths> = paths * A, every search in the batch advances a level.
+	assert(GrB_mxm(frontier, paths, GrB_NULL, GxB_PLUS_FIRST_FP64, paths, A, d->rsc) == GrB_SUCCESS);
+	assert(GrB_Matrix_nvals(&nvals, frontier) == GrB_SUCCESS);
+	bool aborted = false;
+	while(nvals > 0) {
+		// Searches may run for long, stop once the query is to be aborted.
+		if((aborted = QueryCtx_PollTimeout(NULL))) break;
+		assert(GrB_Matrix_new(&level, GrB_BOOL, ns, n) == GrB_SUCCESS);
+		assert(GrB_apply(level, GrB_NULL, GrB_NULL, GxB_ONE_BOOL, frontier, d->plain) == GrB_SUCCESS);
+		levels = array_append(levels, level);
+		assert(GrB_eWiseAdd(paths, GrB_NULL, GrB_NULL, GrB_PLUS_FP64, paths, frontier,
+							d->plain) == GrB_SUCCESS);
+		assert(GrB_mxm(frontier, paths, GrB_NULL, GxB_PLUS_FIRST_FP64, frontier, A,
+					   d->rsc) == GrB_SUCCESS);
+		assert(GrB_Matrix_nvals(&nvals, frontier) == GrB_SUCCESS);
+	}
+
+	GrB_Matrix bcu;
+	GrB_Matrix W = frontier;
+	assert(GrB_Matrix_new(&bcu, GrB_FP64, ns, n) == GrB_SUCCESS);
+	assert(GrB_apply(bcu, GrB_NULL, GrB_NULL, GxB_ONE_FP64, paths, d->plain) == GrB_SUCCESS);
+	// Sources depend on nobody, stop at the first level.
+	for(int depth = array_len(levels) - 1; !aborted && depth >= 2; depth--) {
+		if((aborted = QueryCtx_PollTimeout(NULL))) break;
+		// W<levels[depth]> = bcu ./ paths
+		assert(GrB_eWiseMult(W, levels[depth], GrB_NULL, GrB_DIV_FP64, bcu, paths,
+							 d->rs) == GrB_SUCCESS);
+		// W<levels[depth - 1]> = W * A', sums the contributions of each node's successors.
+		assert(GrB_mxm(W, levels[depth - 1], GrB_NULL, GxB_PLUS_FIRST_FP64, W, A,
+					   d->rst1) == GrB_SUCCESS);
+		// bcu += W .* paths
+		assert(GrB_eWiseMult(bcu, GrB_NULL, GrB_PLUS_FP64, GrB_TIMES_FP64, W, paths,
+							 d->plain) == GrB_SUCCESS);
+	}
+
+	if(!aborted) {
+		// centrality += column sums of bcu - 1 per discovered node.
+		assert(GrB_Matrix_reduce_Monoid(centrality, GrB_NULL, GrB_PLUS_FP64, GxB_PLUS_FP64_MONOID,
+										bcu, d->t0) == GrB_SUCCESS);
+		assert(GrB_apply(W, GrB_NULL, GrB_NULL, GxB_ONE_FP64, paths, d->plain) == GrB_SUCCESS);
+		assert(GrB_Matrix_reduce_Monoid(centrality, GrB_NULL, GrB_MINUS_FP64, GxB_PLUS_FP64_MONOID,
+										W, d->t0) == GrB_SUCCESS);
+	}
+
+	uint level_count = array_len(levels);
+	for(uint i = 0; i < level_count; i++) GrB_free(&levels[i]);
+	array_free(levels);
+	GrB_free(&bcu);
+	GrB_free(&paths);
+	GrB_free(&frontier);
+	return !aborted;
+}
+
+double *BetweennessCentrality(GrB_Matrix A, const GrB_Index *sources, GrB_Index source_count,
+							  int nthreads) {
+	GrB_Index n;
+	assert(GrB_Matrix_nrows(&n, A) == GrB_SUCCESS);
+	CentralityDescriptors d;
+	_Centrality_DescriptorsInit(&d, nthreads);
+
+	// Dense, accumulating into missing entries would discard the accumulator.
+	GrB_Vector centrality;
+	assert(GrB_Vector_new(&centrality, GrB_FP64, n) == GrB_SUCCESS);
+	assert(GrB_Vector_assign_FP64(centrality, GrB_NULL, GrB_NULL, 0, GrB_ALL, n,
+								  GrB_NULL) == GrB_SUCCESS);
+
+	bool aborted = false;
+	for(GrB_Index i = 0; i < source_count; i += CENTRALITY_BATCH_SIZE) {
+		GrB_Index ns = source_count - i;
+		if(ns > CENTRALITY_BATCH_SIZE) ns = CENTRALITY_BATCH_SIZE;
+		if((aborted = !_Betweenness_Batch(A, sources + i, ns, n, centrality, &d))) break;
+	}
+	if(aborted) {
+		GrB_free(&centrality);
+		_Centrality_DescriptorsFree(&d);
+		return NULL;
+	}
+
+	double *scores = rm_malloc(sizeof(double) * n);
+	GrB_Index nvals = n;
+	assert(GrB_Vector_extractTuples_FP64(GrB_NULL, scores, &nvals, centrality) == GrB_SUCCESS);
+	// Scale sampled sums by the inverse sampling rate.
+	if(source_count > 0 && source_count < n) {
+		double scale = (double)n / source_count;
+		for(GrB_Index i = 0; i < n; i++) scores[i] *= scale;
+	}
+
+	GrB_free(&centrality);
+	_Centrality_DescriptorsFree(&d);
+	return scores;
+}
+
+/* Searches backwards from a batch of sources, frontier(s, v) holds the nodes
+ * reaching source s in exactly depth hops, accumulates the number of sources
+ * each node reaches into hits and the distances to them into distances.
+ * Returns false once the query is to be aborted. */
+static bool _Closeness_Batch(GrB_Matrix A, const GrB_Index *sources, GrB_Index ns, GrB_Index n,
+							 uint64_t *hits, uint64_t *distances, CentralityDescriptors *d) {
+	GrB_Matrix visited;
+	GrB_Matrix frontier;
+	GrB_Vector counts;
+	GrB_Index nvals;
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * n);
+	uint64_t *X = rm_malloc(sizeof(uint64_t) * n);
+	_Centrality_SourceMatrix(&frontier, GrB_BOOL, sources, ns, n);
+	assert(GrB_Matrix_dup(&visited, frontier) == GrB_SUCCESS);
+	assert(GrB_Vector_new(&counts, GrB_UINT64, n) == GrB_SUCCESS);
+
+	bool aborted = false;
+	for(uint64_t depth = 1;; depth++) {
+		// Searches may run for long, stop once the query is to be aborted.
+		if((aborted = QueryCtx_PollTimeout(NULL))) break;
+		// frontier<!visited> = frontier * A', u joins if it has an edge into the frontier.
+		assert(GrB_mxm(frontier, visited, GrB_NULL, GxB_ANY_PAIR_BOOL, frontier, A,
+					   d->rsct1) == GrB_SUCCESS);
+		assert(GrB_Matrix_nvals(&nvals, frontier) == GrB_SUCCESS);
+		if(nvals == 0) break;
+		assert(GrB_eWiseAdd(visited, GrB_NULL, GrB_NULL, GrB_LOR, visited, frontier,
+							d->plain) == GrB_SUCCESS);
+
+		// Number of sources each node reaches in depth hops.
+		assert(GrB_Matrix_reduce_Monoid(counts, GrB_NULL, GrB_NULL, GxB_PLUS_UINT64_MONOID, frontier,
+										d->t0) == GrB_SUCCESS);
+		nvals = n;
+		assert(GrB_Vector_extractTuples_UINT64(I, X, &nvals, counts) == GrB_SUCCESS);
+		for(GrB_Index i = 0; i < nvals; i++) {
+			hits[I[i]] += X[i];
+			distances[I[i]] += depth * X[i];
+		}
+	}
+
+	rm_free(I);
+	rm_free(X);
+	GrB_free(&counts);
+	GrB_free(&visited);
+	GrB_free(&frontier);
+	return !aborted;
+}
+
+double *ClosenessCentrality(GrB_Matrix A, const GrB_Index *sources, GrB_Index source_count,
+							int nthreads) {
+	GrB_Index n;
+	assert(GrB_Matrix_nrows(&n, A) == GrB_SUCCESS);
+	CentralityDescriptors d;
+	_Centrality_DescriptorsInit(&d, nthreads);
+
+	uint64_t *hits = rm_calloc(n, sizeof(uint64_t));
+	uint64_t *distances = rm_calloc(n, sizeof(uint64_t));
+	bool aborted = false;
+	for(GrB_Index i = 0; i < source_count; i += CENTRALITY_BATCH_SIZE) {
+		GrB_Index ns = source_count - i;
+		if(ns > CENTRALITY_BATCH_SIZE) ns = CENTRALITY_BATCH_SIZE;
+		if((aborted = !_Closeness_Batch(A, sources + i, ns, n, hits, distances, &d))) break;
+	}
+
+	double *scores = NULL;
+	if(!aborted) {
+		scores = rm_malloc(sizeof(double) * n);
+		for(GrB_Index i = 0; i < n; i++) {
+			scores[i] = (distances[i] > 0) ? (double)hits[i] / distances[i] : 0;
+		}
+	}
+
+	rm_free(hits);
+	rm_free(distances);
+	_Centrality_DescriptorsFree(&d);
+	return scores;
+}
@@ -0,0 +1,56 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+/*
+ * Betweenness and closeness centrality over a boolean adjacency matrix.
+ * Both run breadth first searches from batches of source nodes at once,
+ * each row of the batch frontier holding a single search, such that a level
+ * of every search in the batch advances by a single matrix product.
+ * Betweenness accumulates dependencies as in Brandes' algorithm,
+ * sampling sources estimates both measures on large graphs.
+ * */
+
+#ifndef _CENTRALITY_H_
+#define _CENTRALITY_H_
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// Number of sources searched by a single batch.
+#define CENTRALITY_BATCH_SIZE 64
+
+/* Picks sample distinct rows out of n uniformly at random, in ascending order,
+ * all n rows if sample is 0 or exceeds n. Sets count to the number of picked rows.
+ * Caller is responsible for freeing the returned array. */
+GrB_Index *Centrality_SampleSources(
+	GrB_Index n,        // Number of rows.
+	GrB_Index sample,   // Number of rows to pick.
+	GrB_Index *count    // [output] number of picked rows.
+);
+
+/* Computes the betweenness centrality of each row of A, the sum over source
+ * and target pairs of the fraction of shortest paths passing through the row.
+ * When sources is a sample, sums are scaled by the inverse sampling rate.
+ * Returns an array holding each row's centrality, caller is responsible for freeing it,
+ * NULL once the query is to be aborted, see QueryCtx_PollTimeout. */
+double *BetweennessCentrality(
+	GrB_Matrix A,               // Square boolean matrix, row i connects to column j.
+	const GrB_Index *sources,   // Distinct source rows.
+	GrB_Index source_count,     // Number of sources.
+	int nthreads                // Number of threads, 0 for GraphBLAS's default.
+);
+
+/* Computes the closeness centrality of each row of A, the inverse of the
+ * average distance from the row to the sources it reaches, 0 if it reaches none.
+ * Returns an array holding each row's centrality, caller is responsible for freeing it,
+ * NULL once the query is to be aborted, see QueryCtx_PollTimeout. */
+double *ClosenessCentrality(
+	GrB_Matrix A,               // Square boolean matrix, row i connects to column j.
+	const GrB_Index *sources,   // Distinct source rows.
+	GrB_Index source_count,     // Number of sources.
+	int nthreads                // Number of threads, 0 for GraphBLAS's default.
+);
+
+#endif
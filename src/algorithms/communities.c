@@ -0,0 +1,301 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "communities.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include <string.h>
+#include <assert.h>
+
+// Weighted symmetric matrix in compressed sparse row form.
+typedef struct {
+	GrB_Index n;        // Number of rows.
+	GrB_Index *p;       // Row i spans entries p[i] to p[i + 1].
+	GrB_Index *j;       // Column of each entry.
+	double *x;          // Weight of each entry.
+} CommunitiesCSR;
+
+// Relabels each community by the smallest row within it.
+static void _Communities_Normalize(GrB_Index *communities, GrB_Index n) {
+	GrB_Index *smallest = rm_malloc(sizeof(GrB_Index) * n);
+	for(GrB_Index i = 0; i < n; i++) smallest[i] = n;
+	for(GrB_Index i = 0; i < n; i++) {
+		if(smallest[communities[i]] == n) smallest[communities[i]] = i;
+		communities[i] = smallest[communities[i]];
+	}
+	rm_free(smallest);
+}
+
+// Builds S = A + A', self loops are kept if with_diagonal and removed otherwise.
+static GrB_Matrix _Communities_Symmetric(GrB_Matrix A, GrB_Type type, bool with_diagonal) {
+	GrB_Index n;
+	GrB_Matrix S;
+	assert(GrB_Matrix_nrows(&n, A) == GrB_SUCCESS);
+	assert(GrB_Matrix_new(&S, type, n, n) == GrB_SUCCESS);
+	assert(GrB_eWiseAdd(S, GrB_NULL, GrB_NULL, GrB_LOR, A, A, GrB_DESC_T1) == GrB_SUCCESS);
+	if(!with_diagonal) {
+		assert(GxB_select(S, GrB_NULL, GrB_NULL, GxB_OFFDIAG, S, GrB_NULL, GrB_NULL) == GrB_SUCCESS);
+		return S;
+	}
+	for(GrB_Index i = 0; i < n; i++) {
+		assert(GrB_Matrix_setElement_BOOL(S, true, i, i) == GrB_SUCCESS);
+	}
+	return S;
+}
+
+// Builds the n x c matrix M(i, communities[i]) = 1.
+static GrB_Matrix _Communities_Assignment(const GrB_Index *communities, GrB_Index n, GrB_Index c,
+										  GrB_Type type) {
+	GrB_Matrix M;
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * n);
+	double *X = rm_malloc(sizeof(double) * n);
+	for(GrB_Index i = 0; i < n; i++) {
+		I[i] = i;
+		X[i] = 1;
+	}
+	assert(GrB_Matrix_new(&M, type, n, c) == GrB_SUCCESS);
+	assert(GrB_Matrix_build_FP64(M, I, communities, X, n, GrB_PLUS_FP64) == GrB_SUCCESS);
+	rm_free(I);
+	rm_free(X);
+	return M;
+}
+
+GrB_Index *LabelPropagation(GrB_Matrix A, uint max_iterations, uint *iterations) {
+	GrB_Index n;
+	assert(GrB_Matrix_nrows(&n, A) == GrB_SUCCESS);
+	GrB_Matrix S = _Communities_Symmetric(A, GrB_BOOL, true);
+	GrB_Matrix C;
+	assert(GrB_Matrix_new(&C, GrB_UINT64, n, n) == GrB_SUCCESS);
+
+	GrB_Index *labels = rm_malloc(sizeof(GrB_Index) * n);
+	uint64_t *best = rm_malloc(sizeof(uint64_t) * n);
+	for(GrB_Index i = 0; i < n; i++) labels[i] = i;
+	// Every row holds its own label, C has at most nvals(S) entries.
+	GrB_Index nvals;
+	assert(GrB_Matrix_nvals(&nvals, S) == GrB_SUCCESS);
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * nvals);
+	GrB_Index *J = rm_malloc(sizeof(GrB_Index) * nvals);
+	uint64_t *X = rm_malloc(sizeof(uint64_t) * nvals);
+
+	*iterations = 0;
+	bool aborted = false;
+	bool changed = (n > 0);
+	while(changed && *iterations < max_iterations) {
+		// Propagation may run for long, stop once the query is to be aborted.
+		if((aborted = QueryCtx_PollTimeout(NULL))) break;
+		(*iterations)++;
+
+		// C(i, l) = number of neighbors of i labeled l.
+		GrB_Matrix L = _Communities_Assignment(labels, n, n, GrB_BOOL);
+		assert(GrB_mxm(C, GrB_NULL, GrB_NULL, GxB_PLUS_PAIR_UINT64, S, L, GrB_NULL) == GrB_SUCCESS);
+		GrB_free(&L);
+
+		// Adopt the most frequent label, the smallest on ties.
+		GrB_Index count = nvals;
+		assert(GrB_Matrix_extractTuples_UINT64(I, J, X, &count, C) == GrB_SUCCESS);
+		for(GrB_Index i = 0; i < n; i++) best[i] = 0;
+		changed = false;
+		GrB_Index *next = rm_malloc(sizeof(GrB_Index) * n);
+		memcpy(next, labels, sizeof(GrB_Index) * n);
+		for(GrB_Index k = 0; k < count; k++) {
+			GrB_Index i = I[k];
+			if(X[k] > best[i] || (X[k] == best[i] && J[k] < next[i])) {
+				best[i] = X[k];
+				next[i] = J[k];
+			}
+		}
+		for(GrB_Index i = 0; i < n; i++) changed |= (next[i] != labels[i]);
+		rm_free(labels);
+		labels = next;
+	}
+
+	rm_free(I);
+	rm_free(J);
+	rm_free(X);
+	rm_free(best);
+	GrB_free(&C);
+	GrB_free(&S);
+	if(aborted) {
+		rm_free(labels);
+		return NULL;
+	}
+	_Communities_Normalize(labels, n);
+	return labels;
+}
+
+static void _CSR_Build(CommunitiesCSR *csr, GrB_Matrix S) {
+	GrB_Index nvals;
+	assert(GrB_Matrix_nrows(&csr->n, S) == GrB_SUCCESS);
+	assert(GrB_Matrix_nvals(&nvals, S) == GrB_SUCCESS);
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * nvals);
+	GrB_Index *J = rm_malloc(sizeof(GrB_Index) * nvals);
+	double *X = rm_malloc(sizeof(double) * nvals);
+	assert(GrB_Matrix_extractTuples_FP64(I, J, X, &nvals, S) == GrB_SUCCESS);
+
+	// Counting sort by row.
+	csr->p = rm_calloc(csr->n + 1, sizeof(GrB_Index));
+	csr->j = rm_malloc(sizeof(GrB_Index) * nvals);
+	csr->x = rm_malloc(sizeof(double) * nvals);
+	for(GrB_Index k = 0; k < nvals; k++) csr->p[I[k] + 1]++;
+	for(GrB_Index i = 0; i < csr->n; i++) csr->p[i + 1] += csr->p[i];
+	for(GrB_Index k = 0; k < nvals; k++) {
+		GrB_Index pos = csr->p[I[k]]++;
+		csr->j[pos] = J[k];
+		csr->x[pos] = X[k];
+	}
+	// Restore row starts, shifted by the placement above.
+	for(GrB_Index i = csr->n; i > 0; i--) csr->p[i] = csr->p[i - 1];
+	csr->p[0] = 0;
+
+	rm_free(I);
+	rm_free(J);
+	rm_free(X);
+}
+
+static void _CSR_Free(CommunitiesCSR *csr) {
+	rm_free(csr->p);
+	rm_free(csr->j);
+	rm_free(csr->x);
+}
+
+// Q = sum over communities c of in(c) / m2 - (tot(c) / m2)^2.
+static double _Louvain_Modularity(const CommunitiesCSR *csr, const GrB_Index *communities,
+								  const double *tot, double m2) {
+	double q = 0;
+	for(GrB_Index i = 0; i < csr->n; i++) {
+		for(GrB_Index k = csr->p[i]; k < csr->p[i + 1]; k++) {
+			if(communities[csr->j[k]] == communities[i]) q += csr->x[k];
+		}
+		// Communities are labeled by row, sums at most one term per community.
+		q -= tot[i] * tot[i] / m2;
+	}
+	return q / m2;
+}
+
+/* Moves nodes of a single level to the neighboring community of largest modularity gain.
+ * Returns true if any node moved, sets aborted once the query is to be aborted. */
+static bool _Louvain_Level(const CommunitiesCSR *csr, GrB_Index *communities, uint max_iterations,
+						   double tolerance, double m2, double *modularity, bool *aborted) {
+	GrB_Index n = csr->n;
+	double *k = rm_calloc(n, sizeof(double));         // Weighted degree of each node.
+	double *tot = rm_calloc(n, sizeof(double));       // Weighted degree of each community.
+	double *w = rm_calloc(n, sizeof(double));         // Weight from the node to each community.
+	GrB_Index *touched = rm_malloc(sizeof(GrB_Index) * n);
+	for(GrB_Index i = 0; i < n; i++) {
+		communities[i] = i;
+		for(GrB_Index e = csr->p[i]; e < csr->p[i + 1]; e++) k[i] += csr->x[e];
+		tot[i] = k[i];
+	}
+
+	bool moved = false;
+	double q = _Louvain_Modularity(csr, communities, tot, m2);
+	for(uint pass = 0; pass < max_iterations; pass++) {
+		// Passes may run for long, stop once the query is to be aborted.
+		if((*aborted = QueryCtx_PollTimeout(NULL))) break;
+		bool pass_moved = false;
+		for(GrB_Index i = 0; i < n; i++) {
+			GrB_Index current = communities[i];
+			GrB_Index touched_count = 0;
+			for(GrB_Index e = csr->p[i]; e < csr->p[i + 1]; e++) {
+				GrB_Index c = communities[csr->j[e]];
+				if(csr->j[e] == i) continue;
+				if(w[c] == 0) touched[touched_count++] = c;
+				w[c] += csr->x[e];
+			}
+
+			// Gain of joining c, up to terms shared by every community.
+			tot[current] -= k[i];
+			GrB_Index target = current;
+			double best = w[current] - tot[current] * k[i] / m2;
+			for(GrB_Index t = 0; t < touched_count; t++) {
+				GrB_Index c = touched[t];
+				double gain = w[c] - tot[c] * k[i] / m2;
+				if(gain > best || (gain == best && c < target)) {
+					best = gain;
+					target = c;
+				}
+			}
+			tot[target] += k[i];
+			communities[i] = target;
+			pass_moved |= (target != current);
+			for(GrB_Index t = 0; t < touched_count; t++) w[touched[t]] = 0;
+			w[current] = 0;
+		}
+
+		double pass_q = _Louvain_Modularity(csr, communities, tot, m2);
+		moved |= pass_moved;
+		bool converged = !pass_moved || pass_q - q < tolerance;
+		q = pass_q;
+		if(converged) break;
+	}
+
+	*modularity = q;
+	rm_free(k);
+	rm_free(tot);
+	rm_free(w);
+	rm_free(touched);
+	return moved;
+}
+
+GrB_Index *Louvain(GrB_Matrix A, uint max_iterations, double tolerance, double *modularity) {
+	GrB_Index n;
+	assert(GrB_Matrix_nrows(&n, A) == GrB_SUCCESS);
+	GrB_Index *communities = rm_malloc(sizeof(GrB_Index) * n);
+	for(GrB_Index i = 0; i < n; i++) communities[i] = i;
+	*modularity = 0;
+
+	// Total weight, each edge is held twice.
+	double m2;
+	GrB_Matrix S = _Communities_Symmetric(A, GrB_FP64, false);
+	assert(GrB_Matrix_reduce_FP64(&m2, GrB_NULL, GxB_PLUS_FP64_MONOID, S, GrB_NULL) == GrB_SUCCESS);
+
+	bool aborted = false;
+	GrB_Index *level = rm_malloc(sizeof(GrB_Index) * n);
+	while(m2 > 0) {
+		CommunitiesCSR csr;
+		_CSR_Build(&csr, S);
+		bool moved = _Louvain_Level(&csr, level, max_iterations, tolerance, m2, modularity,
+									&aborted);
+		_CSR_Free(&csr);
+		if(!moved || aborted) break;
+
+		// Number the level's communities consecutively.
+		GrB_Index rows;
+		GrB_Index c = 0;
+		assert(GrB_Matrix_nrows(&rows, S) == GrB_SUCCESS);
+		GrB_Index *ids = rm_malloc(sizeof(GrB_Index) * rows);
+		for(GrB_Index i = 0; i < rows; i++) ids[i] = rows;
+		for(GrB_Index i = 0; i < rows; i++) {
+			if(ids[level[i]] == rows) ids[level[i]] = c++;
+			level[i] = ids[level[i]];
+		}
+		rm_free(ids);
+		for(GrB_Index i = 0; i < n; i++) communities[i] = level[communities[i]];
+
+		// Aggregate, S = P' * S * P.
+		GrB_Matrix P = _Communities_Assignment(level, rows, c, GrB_FP64);
+		GrB_Matrix SP;
+		GrB_Matrix aggregated;
+		assert(GrB_Matrix_new(&SP, GrB_FP64, rows, c) == GrB_SUCCESS);
+		assert(GrB_Matrix_new(&aggregated, GrB_FP64, c, c) == GrB_SUCCESS);
+		assert(GrB_mxm(SP, GrB_NULL, GrB_NULL, GxB_PLUS_TIMES_FP64, S, P, GrB_NULL) == GrB_SUCCESS);
+		assert(GrB_mxm(aggregated, GrB_NULL, GrB_NULL, GxB_PLUS_TIMES_FP64, P, SP,
+					   GrB_DESC_T0) == GrB_SUCCESS);
+		GrB_free(&P);
+		GrB_free(&SP);
+		GrB_free(&S);
+		S = aggregated;
+	}
+
+	rm_free(level);
+	GrB_free(&S);
+	if(aborted) {
+		rm_free(communities);
+		return NULL;
+	}
+	_Communities_Normalize(communities, n);
+	return communities;
+}
@@ -0,0 +1,47 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+/*
+ * Community detection over a boolean adjacency matrix, edge directions are
+ * ignored and parallel edges count once. Each node is assigned the smallest
+ * row index within its community.
+ * Label propagation counts the labels among each node's neighbors, itself
+ * included, by the product S * L of the symmetric adjacency matrix and the
+ * label assignment matrix, nodes adopt their most frequent label, the
+ * smallest on ties, all at once.
+ * Louvain greedily moves nodes between communities while modularity improves,
+ * then aggregates each community into a single node by the product P' * S * P
+ * of the community assignment matrix and repeats on the aggregated graph.
+ * */
+
+#ifndef _COMMUNITIES_H_
+#define _COMMUNITIES_H_
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// Detects communities by label propagation, stops once labels are stable
+// or after max_iterations. Sets iterations to the number of iterations ran.
+// Returns an array holding each row's community, caller is responsible for freeing it.
+// Returns NULL once the query is to be aborted, see QueryCtx_PollTimeout.
+GrB_Index *LabelPropagation(
+	GrB_Matrix A,           // Square boolean matrix, row i connects to column j.
+	uint max_iterations,    // Maximum number of iterations.
+	uint *iterations        // [output] number of iterations ran.
+);
+
+// Detects communities maximizing modularity, every level moves nodes until
+// a pass improves modularity by less than tolerance or after max_iterations passes,
+// levels aggregate while nodes move. Sets modularity to the partition's modularity.
+// Returns an array holding each row's community, caller is responsible for freeing it.
+// Returns NULL once the query is to be aborted, see QueryCtx_PollTimeout.
+GrB_Index *Louvain(
+	GrB_Matrix A,           // Square boolean matrix, row i connects to column j.
+	uint max_iterations,    // Maximum number of passes per level.
+	double tolerance,       // Minimal modularity improvement of a pass.
+	double *modularity      // [output] modularity of the detected communities.
+);
+
+#endif
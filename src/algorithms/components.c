@@ -0,0 +1,170 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "components.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include <assert.h>
+
+// Returns true if the entries of a and b differ, both share the same structure.
+static bool _Components_Changed(GrB_Vector a, GrB_Vector b, GrB_Vector diff) {
+	bool changed = false;
+	assert(GrB_eWiseMult(diff, GrB_NULL, GrB_NULL, GrB_NE_UINT64, a, b, GrB_NULL) == GrB_SUCCESS);
+	assert(GrB_reduce(&changed, GrB_NULL, GxB_LOR_BOOL_MONOID, diff, GrB_NULL) == GrB_SUCCESS);
+	return changed;
+}
+
+// Sets v(i) = i for each index in I.
+static void _Components_Identity(GrB_Vector v, const GrB_Index *I, GrB_Index n) {
+	assert(GrB_Vector_clear(v) == GrB_SUCCESS);
+	assert(GrB_Vector_build_UINT64(v, I, I, n, GrB_FIRST_UINT64) == GrB_SUCCESS);
+}
+
+GrB_Index *WeaklyConnectedComponents(GrB_Matrix A) {
+	GrB_Index n;
+	assert(GrB_Matrix_nrows(&n, A) == GrB_SUCCESS);
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * n);
+	GrB_Index *labels = rm_malloc(sizeof(GrB_Index) * n);
+	for(GrB_Index i = 0; i < n; i++) I[i] = i;
+
+	// Ignore edge direction, S = A + A'.
+	GrB_Matrix S;
+	assert(GrB_Matrix_new(&S, GrB_BOOL, n, n) == GrB_SUCCESS);
+	assert(GrB_eWiseAdd(S, GrB_NULL, GrB_NULL, GrB_LOR, A, A, GrB_DESC_T1) == GrB_SUCCESS);
+
+	GrB_Vector f;       // Current label of each node.
+	GrB_Vector prev;    // Labels prior to the last propagation.
+	GrB_Vector diff;
+	assert(GrB_Vector_new(&f, GrB_UINT64, n) == GrB_SUCCESS);
+	assert(GrB_Vector_new(&diff, GrB_BOOL, n) == GrB_SUCCESS);
+	_Components_Identity(f, I, n);
+
+	bool aborted = false;
+	bool changed = (n > 0);
+	while(changed) {
+		// Propagation may run for long, stop once the query is to be aborted.
+		if((aborted = QueryCtx_PollTimeout(NULL))) break;
+		assert(GrB_Vector_dup(&prev, f) == GrB_SUCCESS);
+
+		// Adopt the smallest label among neighbors, f = min(f, S min.second f).
+		assert(GrB_mxv(f, GrB_NULL, GrB_MIN_UINT64, GxB_MIN_SECOND_UINT64, S, f,
+					   GrB_NULL) == GrB_SUCCESS);
+		// Pointer jumping, f = f(f), labels only ever decrease.
+		assert(GrB_Vector_extractTuples_UINT64(GrB_NULL, labels, &n, f) == GrB_SUCCESS);
+		assert(GrB_Vector_extract(f, GrB_NULL, GrB_MIN_UINT64, f, labels, n,
+								  GrB_NULL) == GrB_SUCCESS);
+
+		changed = _Components_Changed(f, prev, diff);
+		GrB_free(&prev);
+	}
+
+	if(!aborted) {
+		assert(GrB_Vector_extractTuples_UINT64(GrB_NULL, labels, &n, f) == GrB_SUCCESS);
+	}
+
+	rm_free(I);
+	GrB_free(&S);
+	GrB_free(&f);
+	GrB_free(&diff);
+	if(aborted) {
+		rm_free(labels);
+		return NULL;
+	}
+	return labels;
+}
+
+GrB_Index *StronglyConnectedComponents(GrB_Matrix A) {
+	GrB_Index n;
+	GrB_Index nvals;
+	assert(GrB_Matrix_nrows(&n, A) == GrB_SUCCESS);
+	GrB_Index *X = rm_malloc(sizeof(GrB_Index) * n);
+	GrB_Index *V = rm_malloc(sizeof(GrB_Index) * n);
+	GrB_Index *components = rm_malloc(sizeof(GrB_Index) * n);
+
+	GrB_Vector remaining;   // Nodes yet to be assigned a component.
+	GrB_Vector color;       // Smallest remaining node reaching each remaining node.
+	GrB_Vector prev;
+	GrB_Vector reached;     // Nodes reaching their color's root, holding their color.
+	GrB_Vector t;
+	GrB_Vector diff;
+	assert(GrB_Vector_new(&remaining, GrB_BOOL, n) == GrB_SUCCESS);
+	assert(GrB_Vector_new(&color, GrB_UINT64, n) == GrB_SUCCESS);
+	assert(GrB_Vector_new(&reached, GrB_UINT64, n) == GrB_SUCCESS);
+	assert(GrB_Vector_new(&t, GrB_UINT64, n) == GrB_SUCCESS);
+	assert(GrB_Vector_new(&diff, GrB_BOOL, n) == GrB_SUCCESS);
+	assert(GrB_assign(remaining, GrB_NULL, GrB_NULL, true, GrB_ALL, n, GrB_NULL) == GrB_SUCCESS);
+
+	bool aborted = false;
+	assert(GrB_Vector_nvals(&nvals, remaining) == GrB_SUCCESS);
+	while(nvals > 0) {
+		// color(i) = i for each remaining node.
+		assert(GrB_Vector_extractTuples_BOOL(X, GrB_NULL, &nvals, remaining) == GrB_SUCCESS);
+		_Components_Identity(color, X, nvals);
+
+		/* Forward propagation, a node's color becomes the smallest remaining node
+		 * reaching it, color(j) = min(color(j), min color(i) over edges i->j). */
+		bool changed = true;
+		while(changed) {
+			if((aborted = QueryCtx_PollTimeout(NULL))) break;
+			assert(GrB_Vector_dup(&prev, color) == GrB_SUCCESS);
+			assert(GrB_mxv(color, remaining, GrB_MIN_UINT64, GxB_MIN_SECOND_UINT64, A, color,
+						   GrB_DESC_ST0) == GrB_SUCCESS);
+			changed = _Components_Changed(color, prev, diff);
+			GrB_free(&prev);
+		}
+		if(aborted) break;
+
+		// Roots are nodes retaining their own color.
+		assert(GrB_Vector_extractTuples_UINT64(X, V, &nvals, color) == GrB_SUCCESS);
+		assert(GrB_Vector_clear(reached) == GrB_SUCCESS);
+		for(GrB_Index i = 0; i < nvals; i++) {
+			if(X[i] == V[i]) {
+				assert(GrB_Vector_setElement_UINT64(reached, X[i], X[i]) == GrB_SUCCESS);
+			}
+		}
+
+		/* Backward propagation from each root within its color, a node's successors
+		 * are colored no greater than itself, as such the greatest color amongst
+		 * its reached successors matches its own color if any of them does. */
+		GrB_Index reached_count;
+		assert(GrB_Vector_nvals(&reached_count, reached) == GrB_SUCCESS);
+		changed = true;
+		while(changed) {
+			if((aborted = QueryCtx_PollTimeout(NULL))) break;
+			assert(GrB_mxv(t, remaining, GrB_NULL, GxB_MAX_SECOND_UINT64, A, reached,
+						   GrB_DESC_RS) == GrB_SUCCESS);
+			assert(GrB_eWiseMult(diff, GrB_NULL, GrB_NULL, GrB_EQ_UINT64, t, color,
+								 GrB_NULL) == GrB_SUCCESS);
+			assert(GrB_assign(reached, diff, GrB_NULL, color, GrB_ALL, n,
+							  GrB_NULL) == GrB_SUCCESS);
+			GrB_Index count;
+			assert(GrB_Vector_nvals(&count, reached) == GrB_SUCCESS);
+			changed = (count != reached_count);
+			reached_count = count;
+		}
+		if(aborted) break;
+
+		// Reached nodes form the components of their roots.
+		assert(GrB_Vector_extractTuples_UINT64(X, V, &reached_count, reached) == GrB_SUCCESS);
+		for(GrB_Index i = 0; i < reached_count; i++) components[X[i]] = V[i];
+		assert(GrB_apply(remaining, reached, GrB_NULL, GrB_IDENTITY_BOOL, remaining,
+						 GrB_DESC_RSC) == GrB_SUCCESS);
+		assert(GrB_Vector_nvals(&nvals, remaining) == GrB_SUCCESS);
+	}
+
+	rm_free(X);
+	rm_free(V);
+	GrB_free(&remaining);
+	GrB_free(&color);
+	GrB_free(&reached);
+	GrB_free(&t);
+	GrB_free(&diff);
+	if(aborted) {
+		rm_free(components);
+		return NULL;
+	}
+	return components;
+}
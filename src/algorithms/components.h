@@ -0,0 +1,34 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+/*
+ * Connected components by label propagation over a boolean adjacency matrix.
+ * Each node is assigned the smallest row index within its component,
+ * components are computed by matrix-vector products, min-label propagation
+ * followed by pointer jumping for weak components, forward-backward
+ * coloring for strong components.
+ * */
+
+#ifndef _COMPONENTS_H_
+#define _COMPONENTS_H_
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// Computes the weakly connected components of A, edge directions are ignored.
+// Returns an array holding each row's component, caller is responsible for freeing it.
+// Returns NULL once the query is to be aborted, see QueryCtx_PollTimeout.
+GrB_Index *WeaklyConnectedComponents(
+	GrB_Matrix A    // Square boolean matrix, row i connects to column j.
+);
+
+// Computes the strongly connected components of A.
+// Returns an array holding each row's component, caller is responsible for freeing it.
+// Returns NULL once the query is to be aborted, see QueryCtx_PollTimeout.
+GrB_Index *StronglyConnectedComponents(
+	GrB_Matrix A    // Square boolean matrix, row i connects to column j.
+);
+
+#endif
@@ -0,0 +1,116 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "node_ordering.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
+#include <assert.h>
+#include <stdbool.h>
+
+// Appends the unvisited neighbors of node v found on row v of M.
+static void _VisitNeighbors(GxB_MatrixTupleIter *it, GrB_Index v, bool *visited,
+							GrB_Index *order, GrB_Index *tail) {
+	GrB_Index neighbor;
+	bool depleted = false;
+	GxB_MatrixTupleIter_iterate_row(it, v);
+	while(true) {
+		GxB_MatrixTupleIter_next(it, NULL, &neighbor, &depleted);
+		if(depleted) break;
+		if(visited[neighbor]) continue;
+		visited[neighbor] = true;
+		order[(*tail)++] = neighbor;
+	}
+}
+
+GrB_Index *ReverseCuthillMcKee(GrB_Matrix A, GrB_Matrix AT) {
+	assert(A && AT);
+
+	GrB_Index n;
+	GrB_Matrix_nrows(&n, A);
+
+	GrB_Index *perm = rm_malloc(sizeof(GrB_Index) * n);
+	if(n == 0) return perm;
+
+	GrB_Index i;
+	GrB_Index j;
+	bool depleted = false;
+	GxB_MatrixTupleIter *it;
+	GxB_MatrixTupleIter *t_it;
+	GrB_Index *degree = rm_calloc(n, sizeof(GrB_Index));
+	GrB_Index *roots = rm_malloc(sizeof(GrB_Index) * n);
+	GrB_Index *order = rm_malloc(sizeof(GrB_Index) * n);
+	bool *visited = rm_calloc(n, sizeof(bool));
+
+	// Undirected degree of each node.
+	GxB_MatrixTupleIter_new(&it, A);
+	while(true) {
+		GxB_MatrixTupleIter_next(it, &i, &j, &depleted);
+		if(depleted) break;
+		degree[i]++;
+		degree[j]++;
+	}
+	GxB_MatrixTupleIter_new(&t_it, AT);
+
+	// Components are entered through their lowest degree node.
+	for(i = 0; i < n; i++) roots[i] = i;
+#define DEGREE_ISLT(a, b) (degree[*(a)] < degree[*(b)] || (degree[*(a)] == degree[*(b)] && *(a) < *(b)))
+	QSORT(GrB_Index, roots, n, DEGREE_ISLT);
+
+	GrB_Index head = 0;
+	GrB_Index tail = 0;
+	for(GrB_Index r = 0; r < n; r++) {
+		GrB_Index root = roots[r];
+		if(visited[root]) continue;
+		visited[root] = true;
+		order[tail++] = root;
+
+		// Breadth first scan, both outgoing and incoming edges are followed.
+		while(head < tail) {
+			GrB_Index v = order[head++];
+			GrB_Index level_start = tail;
+			_VisitNeighbors(it, v, visited, order, &tail);
+			_VisitNeighbors(t_it, v, visited, order, &tail);
+			// Visit newly discovered neighbors in increasing degree order.
+			QSORT(GrB_Index, order + level_start, tail - level_start, DEGREE_ISLT);
+		}
+	}
+#undef DEGREE_ISLT
+	assert(tail == n);
+
+	// Reverse visitation order.
+	for(i = 0; i < n; i++) perm[order[i]] = n - 1 - i;
+
+	GxB_MatrixTupleIter_free(it);
+	GxB_MatrixTupleIter_free(t_it);
+	rm_free(degree);
+	rm_free(roots);
+	rm_free(order);
+	rm_free(visited);
+	return perm;
+}
+
+double NodeOrdering_MeanDistance(GrB_Matrix A) {
+	assert(A);
+
+	GrB_Index nvals;
+	GrB_Matrix_nvals(&nvals, A);
+	if(nvals == 0) return 0;
+
+	GrB_Index i;
+	GrB_Index j;
+	double total = 0;
+	bool depleted = false;
+	GxB_MatrixTupleIter *it;
+	GxB_MatrixTupleIter_new(&it, A);
+	while(true) {
+		GxB_MatrixTupleIter_next(it, &i, &j, &depleted);
+		if(depleted) break;
+		total += (i > j) ? i - j : j - i;
+	}
+	GxB_MatrixTupleIter_free(it);
+
+	return total / nvals;
+}
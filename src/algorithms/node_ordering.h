@@ -0,0 +1,27 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+/* Computes a Reverse Cuthill-McKee ordering of the graph represented by A,
+ * edge directions are disregarded.
+ * Nodes are visited breadth first, starting from the lowest degree node
+ * of each connected component, neighbors visited in increasing degree order.
+ * Such that adjacent nodes are assigned nearby positions.
+ * Returns an array mapping each node to its position, caller is responsible for freeing it. */
+GrB_Index *ReverseCuthillMcKee
+(
+	GrB_Matrix A,   // Adjacency matrix.
+	GrB_Matrix AT   // Transposed adjacency matrix.
+);
+
+// Mean distance between the IDs of connected nodes, lower is more local.
+double NodeOrdering_MeanDistance
+(
+	GrB_Matrix A    // Adjacency matrix.
+);
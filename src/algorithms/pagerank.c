@@ -25,6 +25,7 @@
 */
 
 #include "pagerank.h"
+#include "../util/heap.h"
 #include "../util/rmalloc.h"
 #include <assert.h>
 
@@ -32,8 +33,6 @@
 // scalar operators
 //------------------------------------------------------------------------------
 
-#define DAMPING 0.85
-
 void fdiff(void *z, const void *x, const void *y) {
 	float delta = (* ((float *) x)) - (* ((float *) y)) ;
 	(*((float *) z)) = delta * delta ;
@@ -57,6 +56,11 @@ int compar(const void *x, const void *y) {
 	}
 }
 
+// heap priority, the lowest ranked page is at the top of the heap
+static int _rank_min_compare(const void *x, const void *y, const void *udata) {
+	return compar(y, x) ;
+}
+
 //------------------------------------------------------------------------------
 // LAGraph_pagerank: compute the pagerank of all nodes in a graph
 //------------------------------------------------------------------------------
@@ -64,7 +68,11 @@ int compar(const void *x, const void *y) {
 GrB_Info Pagerank               // GrB_SUCCESS or error condition
 (
 	LAGraph_PageRank **Phandle, // output: array of LAGraph_PageRank structs
+	GrB_Index *topk,            // input: number of top ranked nodes to return, 0 for all
+	                            // output: number of ranked nodes returned
 	GrB_Matrix A,               // binary input graph, not modified
+	const float *seed,          // initial rank of each node, negative if unknown, may be NULL
+	double damping,             // damping factor
 	int itermax,                // max number of iterations
 	double tol,                 // stop when norm (r-rnew,2) < tol
 	int *iters                  // number of iterations taken
@@ -87,28 +95,50 @@ GrB_Info Pagerank               // GrB_SUCCESS or error condition
 	(*Phandle) = NULL ;
 
 	// n = size (A,1) ;         // number of nodes
+	assert(topk != NULL) ;
 	assert(GrB_Matrix_nrows(&n, A) == GrB_SUCCESS) ;
-	if(n == 0) return (GrB_SUCCESS) ;
+	if(n == 0) {
+		(*topk) = 0 ;
+		return (GrB_SUCCESS) ;
+	}
 
-	// teleport = (1 - 0.85) / n
+	// teleport = (1 - damping) / n
 	float one = 1.0 ;
-	float teleport = (one - DAMPING) / ((float) n) ;
+	float teleport = (one - damping) / ((float) n) ;
 
 	// r (i) = 1/n for all nodes i
 	float x = 1.0 / ((float) n) ;
 	assert(GrB_Vector_new(&r, GrB_FP32, n) == GrB_SUCCESS) ;
 	assert(GrB_assign(r, NULL, NULL, x, GrB_ALL, n, NULL) == GrB_SUCCESS) ;
 
+	// warm start, r (i) = seed (i) for nodes of known rank,
+	// such that a previous ranking converges within few iterations
+	if(seed != NULL) {
+		float total = 0 ;
+		for(GrB_Index i = 0 ; i < n ; i++) {
+			if(seed [i] >= 0) {
+				assert(GrB_Vector_setElement(r, seed [i], i) == GrB_SUCCESS) ;
+				total += seed [i] ;
+			} else {
+				total += x ;
+			}
+		}
+		// normalize r, such that sum (r) = 1
+		if(total > 0) {
+			assert(GrB_Vector_assign_FP32(r, NULL, GrB_TIMES_FP32, 1 / total, GrB_ALL, n, NULL) == GrB_SUCCESS) ;
+		}
+	}
+
 	// d (i) = out deg of node i
 	assert(GrB_Vector_new(&d, GrB_FP32, n) == GrB_SUCCESS) ;
 	assert(GrB_reduce(d, NULL, NULL, GrB_PLUS_FP32, A, NULL) == GrB_SUCCESS) ;
 	// GxB_print (d, 3) ;
 
-	// D = (1/diag (d)) * DAMPING
+	// D = (1/diag (d)) * damping
 	GrB_Type type ;
 	assert(GxB_Vector_export(&d, &type, &n, &nvals, &I, (void **)(&X), NULL) == GrB_SUCCESS) ;
 
-	for(int64_t k = 0 ; k < nvals ; k++) X [k] = DAMPING / X [k] ;
+	for(int64_t k = 0 ; k < nvals ; k++) X [k] = damping / X [k] ;
 	assert(GrB_Matrix_new(&D, GrB_FP32, n, n) == GrB_SUCCESS) ;
 	assert(GrB_Matrix_build(D, I, I, X, nvals, GrB_PLUS_FP32) == GrB_SUCCESS) ;
 	rm_free(I) ;
@@ -224,8 +254,28 @@ GrB_Info Pagerank               // GrB_SUCCESS or error condition
 		P [k].page = k ;
 	}
 
-	// qsort (P) in descending order
-	qsort(P, n, sizeof(LAGraph_PageRank), compar) ;
+	if((*topk) == 0 || (*topk) >= n) {
+		// qsort (P) in descending order
+		(*topk) = n ;
+		qsort(P, n, sizeof(LAGraph_PageRank), compar) ;
+	} else {
+		// retain the k top ranked pages, sparing a sort of all pages
+		heap_t *heap = heap_new(_rank_min_compare, NULL) ;
+		for(int64_t i = 0 ; i < n ; i++) {
+			if((GrB_Index)heap_count(heap) < (*topk)) {
+				heap_offer(&heap, P + i) ;
+			} else if(compar(P + i, heap_peek(heap)) < 0) {
+				heap_poll(heap) ;
+				heap_offer(&heap, P + i) ;
+			}
+		}
+		// the heap pops pages in ascending order
+		LAGraph_PageRank *top = rm_malloc((*topk) * sizeof(LAGraph_PageRank)) ;
+		for(int64_t i = (*topk) - 1 ; i >= 0 ; i--) top [i] = *(LAGraph_PageRank *)heap_poll(heap) ;
+		heap_free(heap) ;
+		rm_free(P) ;
+		P = top ;
+	}
 
 	//--------------------------------------------------------------------------
 	// return result
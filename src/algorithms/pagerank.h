@@ -33,7 +33,11 @@ LAGraph_PageRank ;
 GrB_Info Pagerank               // GrB_SUCCESS or error condition
 (
 	LAGraph_PageRank **Phandle, // output: array of LAGraph_PageRank structs
+	GrB_Index *topk,            // input: number of top ranked nodes to return, 0 for all
+	                            // output: number of ranked nodes returned
 	GrB_Matrix A,               // binary input graph, not modified
+	const float *seed,          // initial rank of each node, negative if unknown, may be NULL
+	double damping,             // damping factor
 	int itermax,                // max number of iterations
 	double tol,                 // stop when norm (r-rnew,2) < tol
 	int *iters                  // number of iterations taken
@@ -0,0 +1,207 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "random_walk.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include <assert.h>
+#include <pthread.h>
+
+struct RandomWalker {
+	GrB_Index n;                // Number of rows.
+	GrB_Index *p;               // Row i spans entries p[i] to p[i + 1].
+	GrB_Index *j;               // Column of each entry, ascending within a row.
+	GrB_Index *sources;         // Source rows.
+	GrB_Index source_count;     // Number of sources.
+	uint length;                // Number of hops per walk.
+	uint walks_per_node;        // Number of walks from each source.
+	double p_weight;            // Weight of returning to the previous row, 1/p.
+	double q_weight;            // Weight of moving away from the previous row, 1/q.
+	double max_weight;          // Largest hop weight.
+	uint64_t seed;              // Generators seed.
+	int nthreads;               // Number of threads sampling a batch.
+	uint64_t walk_count;        // Total number of walks.
+	uint64_t sampled;           // Number of walks sampled by previous batches.
+	GrB_Index *batch;           // Rows of the current batch, length + 1 per walk.
+	uint *lens;                 // Number of rows of each walk in the current batch.
+	uint64_t batch_count;       // Number of walks in the current batch.
+	uint64_t batch_pos;         // Next walk of the current batch to return.
+};
+
+// Walks sampled by a single thread.
+typedef struct {
+	RandomWalker *walker;
+	uint64_t first;             // First walk of the batch.
+	uint64_t last;              // Walk following the last one.
+} RandomWalkTask;
+
+static inline uint64_t _splitmix64(uint64_t x) {
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+// xorshift64* step.
+static inline uint64_t _next(uint64_t *state) {
+	uint64_t x = *state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*state = x;
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+static inline double _uniform(uint64_t *state) {
+	return (_next(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Returns true if row i has an entry at column c.
+static bool _HasEntry(const RandomWalker *w, GrB_Index i, GrB_Index c) {
+	GrB_Index lo = w->p[i];
+	GrB_Index hi = w->p[i + 1];
+	while(lo < hi) {
+		GrB_Index mid = lo + (hi - lo) / 2;
+		if(w->j[mid] == c) return true;
+		if(w->j[mid] < c) lo = mid + 1;
+		else hi = mid;
+	}
+	return false;
+}
+
+// Samples walk number id into rows, returns the number of rows.
+static uint _Walk(const RandomWalker *w, uint64_t id, GrB_Index *rows) {
+	uint64_t state = _splitmix64(w->seed ^ _splitmix64(id));
+	if(state == 0) state = 1;
+	bool biased = (w->p_weight != 1 || w->q_weight != 1);
+
+	GrB_Index prev = 0;
+	GrB_Index cur = w->sources[id / w->walks_per_node];
+	uint len = 0;
+	rows[len++] = cur;
+	while(len <= w->length) {
+		GrB_Index deg = w->p[cur + 1] - w->p[cur];
+		if(deg == 0) break;
+
+		GrB_Index next;
+		while(true) {
+			next = w->j[w->p[cur] + _next(&state) % deg];
+			// The first hop has no previous row, hops are uniform when unbiased.
+			if(!biased || len == 1) break;
+			double weight = 1;
+			if(next == prev) weight = w->p_weight;
+			else if(!_HasEntry(w, prev, next)) weight = w->q_weight;
+			if(_uniform(&state) * w->max_weight < weight) break;
+		}
+
+		prev = cur;
+		cur = next;
+		rows[len++] = cur;
+	}
+	return len;
+}
+
+static void *_RandomWalker_Sample(void *arg) {
+	RandomWalkTask *task = arg;
+	RandomWalker *w = task->walker;
+	for(uint64_t k = task->first; k < task->last; k++) {
+		w->lens[k] = _Walk(w, w->sampled + k, w->batch + k * (w->length + 1));
+	}
+	return NULL;
+}
+
+// Samples the next batch of walks, splitting it between threads.
+static void _RandomWalker_Batch(RandomWalker *w) {
+	uint64_t remaining = w->walk_count - w->sampled;
+	w->batch_count = (remaining < RANDOM_WALK_BATCH_SIZE) ? remaining : RANDOM_WALK_BATCH_SIZE;
+	w->batch_pos = 0;
+
+	int nthreads = w->nthreads;
+	if((uint64_t)nthreads > w->batch_count) nthreads = w->batch_count;
+	if(nthreads < 1) nthreads = 1;
+
+	RandomWalkTask tasks[nthreads];
+	pthread_t threads[nthreads];
+	uint64_t chunk = (w->batch_count + nthreads - 1) / nthreads;
+	for(int t = 0; t < nthreads; t++) {
+		tasks[t].walker = w;
+		tasks[t].first = t * chunk;
+		tasks[t].last = (t + 1) * chunk;
+		if(tasks[t].last > w->batch_count) tasks[t].last = w->batch_count;
+	}
+
+	// The calling thread samples the first chunk.
+	for(int t = 1; t < nthreads; t++) {
+		int res = pthread_create(&threads[t], NULL, _RandomWalker_Sample, &tasks[t]);
+		assert(res == 0);
+	}
+	_RandomWalker_Sample(&tasks[0]);
+	for(int t = 1; t < nthreads; t++) pthread_join(threads[t], NULL);
+
+	w->sampled += w->batch_count;
+}
+
+RandomWalker *RandomWalker_New(GrB_Matrix A, GrB_Index *sources, GrB_Index source_count,
+							   uint length, uint walks_per_node, double p, double q,
+							   uint64_t seed, int nthreads) {
+	assert(p > 0 && q > 0);
+	RandomWalker *w = rm_malloc(sizeof(RandomWalker));
+	w->sources = sources;
+	w->source_count = source_count;
+	w->length = length;
+	w->walks_per_node = walks_per_node;
+	w->p_weight = 1 / p;
+	w->q_weight = 1 / q;
+	w->max_weight = 1;
+	if(w->p_weight > w->max_weight) w->max_weight = w->p_weight;
+	if(w->q_weight > w->max_weight) w->max_weight = w->q_weight;
+	w->seed = seed;
+	w->walk_count = source_count * walks_per_node;
+	w->sampled = 0;
+	w->batch_count = 0;
+	w->batch_pos = 0;
+	if(nthreads <= 0) GxB_get(GxB_NTHREADS, &nthreads);
+	w->nthreads = nthreads;
+
+	// Tuples are extracted in row order, counting entries per row forms the row pointers.
+	GrB_Index nvals;
+	assert(GrB_Matrix_nrows(&w->n, A) == GrB_SUCCESS);
+	assert(GrB_Matrix_nvals(&nvals, A) == GrB_SUCCESS);
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * (nvals + 1));
+	w->j = rm_malloc(sizeof(GrB_Index) * (nvals + 1));
+	assert(GrB_Matrix_extractTuples_BOOL(I, w->j, GrB_NULL, &nvals, A) == GrB_SUCCESS);
+	w->p = rm_calloc(w->n + 1, sizeof(GrB_Index));
+	for(GrB_Index k = 0; k < nvals; k++) w->p[I[k] + 1]++;
+	for(GrB_Index i = 0; i < w->n; i++) w->p[i + 1] += w->p[i];
+	rm_free(I);
+
+	w->batch = rm_malloc(sizeof(GrB_Index) * RANDOM_WALK_BATCH_SIZE * (length + 1));
+	w->lens = rm_malloc(sizeof(uint) * RANDOM_WALK_BATCH_SIZE);
+	return w;
+}
+
+bool RandomWalker_Next(RandomWalker *w, const GrB_Index **walk, uint *len) {
+	if(w->batch_pos == w->batch_count) {
+		if(w->sampled == w->walk_count) return false;
+		// Sampling may run for long, stop once the query is to be aborted.
+		if(QueryCtx_PollTimeout(NULL)) return false;
+		_RandomWalker_Batch(w);
+	}
+
+	uint64_t k = w->batch_pos++;
+	*walk = w->batch + k * (w->length + 1);
+	*len = w->lens[k];
+	return true;
+}
+
+void RandomWalker_Free(RandomWalker *w) {
+	rm_free(w->sources);
+	rm_free(w->p);
+	rm_free(w->j);
+	rm_free(w->batch);
+	rm_free(w->lens);
+	rm_free(w);
+}
@@ -0,0 +1,52 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+/*
+ * Random walks over a boolean adjacency matrix held in compressed sparse row
+ * form, such that a hop samples a neighbor by indexing the current row.
+ * Walks follow node2vec, a hop returning to the previous node is weighed 1/p,
+ * a hop to a neighbor of the previous node 1 and any other hop 1/q,
+ * biased hops are drawn by rejection sampling. Walks are produced in batches,
+ * the walks of a batch are sampled concurrently, each walk drawing from its
+ * own generator such that walks depend on the seed only.
+ * */
+
+#ifndef _RANDOM_WALK_H_
+#define _RANDOM_WALK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// Number of walks sampled by a single batch.
+#define RANDOM_WALK_BATCH_SIZE 4096
+
+typedef struct RandomWalker RandomWalker;
+
+/* Creates a walker producing walks_per_node walks of length hops from each source,
+ * in source order, walks stop early at rows lacking entries.
+ * Takes ownership of sources, A is not referenced once the walker is created. */
+RandomWalker *RandomWalker_New(
+	GrB_Matrix A,               // Square boolean matrix, row i connects to column j.
+	GrB_Index *sources,         // Source rows.
+	GrB_Index source_count,     // Number of sources.
+	uint length,                // Number of hops per walk.
+	uint walks_per_node,        // Number of walks from each source.
+	double p,                   // Return parameter.
+	double q,                   // In-out parameter.
+	uint64_t seed,              // Generators seed.
+	int nthreads                // Number of threads, 0 for GraphBLAS's default.
+);
+
+/* Retrieves the next walk, sets walk to its rows and len to its number of rows.
+ * The walk remains valid until the next call, returns false once depleted
+ * or once the query is to be aborted, see QueryCtx_PollTimeout. */
+bool RandomWalker_Next(RandomWalker *walker, const GrB_Index **walk, uint *len);
+
+// Frees walker.
+void RandomWalker_Free(RandomWalker *walker);
+
+#endif
@@ -0,0 +1,159 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "reachable_nodes.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../query_ctx.h"
+
+void ReachableNodes_Expand(Graph *g, GrB_Vector next, GrB_Vector frontier, GrB_Vector visited,
+						   int *relationIDs, int relationCount, GRAPH_EDGE_DIR dir) {
+	for(int i = 0; i < relationCount; i++) {
+		int r = relationIDs[i];
+		// Mask out visited nodes.
+		if(dir != GRAPH_EDGE_DIR_INCOMING) {
+			GrB_vxm(next, visited, GrB_LOR, GxB_ANY_PAIR_BOOL, frontier,
+					Graph_GetRelationMatrix(g, r), GrB_DESC_C);
+		}
+		if(dir != GRAPH_EDGE_DIR_OUTGOING) {
+			GrB_vxm(next, visited, GrB_LOR, GxB_ANY_PAIR_BOOL, frontier,
+					Graph_GetTransposedRelationMatrix(g, r), GrB_DESC_C);
+		}
+	}
+}
+
+IDSet *ReachableNodes(Graph *g, const Node *src, int *relationIDs, int relationCount,
+					  GRAPH_EDGE_DIR dir, unsigned int maxLen) {
+	GrB_Index n = Graph_RequiredMatrixDim(g);
+	GrB_Vector visited;
+	GrB_Vector frontier;
+	GrB_Vector next;
+	GrB_Vector_new(&visited, GrB_BOOL, n);
+	GrB_Vector_new(&frontier, GrB_BOOL, n);
+	GrB_Vector_new(&next, GrB_BOOL, n);
+
+	GrB_Vector_setElement_BOOL(frontier, true, ENTITY_GET_ID(src));
+	GrB_Vector_setElement_BOOL(visited, true, ENTITY_GET_ID(src));
+
+	for(unsigned int depth = 0; depth < maxLen; depth++) {
+		// Traversals may run for long, stop once the query is to be aborted.
+		if(QueryCtx_PollTimeout(NULL)) {
+			GrB_free(&visited);
+			GrB_free(&frontier);
+			GrB_free(&next);
+			return NULL;
+		}
+		GrB_Vector_clear(next);
+		ReachableNodes_Expand(g, next, frontier, visited, relationIDs, relationCount, dir);
+
+		GrB_Index nvals;
+		GrB_Vector_nvals(&nvals, next);
+		if(nvals == 0) break;
+		GrB_eWiseAdd_Vector_BinaryOp(visited, GrB_NULL, GrB_NULL, GrB_LOR, visited, next, GrB_NULL);
+		GrB_Vector tmp = frontier;
+		frontier = next;
+		next = tmp;
+	}
+
+	// Collect every visited node but the source.
+	GrB_Index nvals;
+	GrB_Vector_nvals(&nvals, visited);
+	GrB_Index *ids = rm_malloc(sizeof(GrB_Index) * (nvals + 1));
+	GrB_Vector_extractTuples_BOOL(ids, GrB_NULL, &nvals, visited);
+	// IDs are extracted in ascending order, appended to the set's last container.
+	IDSet *reached = IDSet_New();
+	for(GrB_Index i = 0; i < nvals; i++) {
+		if(ids[i] != ENTITY_GET_ID(src)) IDSet_Add(reached, ids[i]);
+	}
+
+	rm_free(ids);
+	GrB_free(&visited);
+	GrB_free(&frontier);
+	GrB_free(&next);
+	return reached;
+}
+
+struct ReachableNodesIter {
+	Graph *g;               // Graph to traverse.
+	int *relationIDs;       // Edge type(s) on which we'll traverse.
+	int relationCount;      // Length of relationIDs.
+	GRAPH_EDGE_DIR dir;     // Traversal direction.
+	unsigned int maxLen;    // Maximal distance.
+	unsigned int depth;     // Distance of the current level.
+	GrB_Vector visited;     // Nodes reached so far.
+	GrB_Vector frontier;    // Nodes of the current level.
+	GrB_Vector next;        // Nodes of the following level.
+	GrB_Index *level;       // IDs of the current level's nodes.
+	GrB_Index level_count;  // Number of nodes in the current level.
+	GrB_Index pos;          // Next node of the current level to produce.
+};
+
+ReachableNodesIter *ReachableNodesIter_New(Graph *g, NodeID src, int *relationIDs,
+										   int relationCount, GRAPH_EDGE_DIR dir,
+										   unsigned int maxLen) {
+	GrB_Index n = Graph_RequiredMatrixDim(g);
+	ReachableNodesIter *iter = rm_malloc(sizeof(ReachableNodesIter));
+	iter->g = g;
+	iter->relationIDs = relationIDs;
+	iter->relationCount = relationCount;
+	iter->dir = dir;
+	iter->maxLen = maxLen;
+	iter->depth = 0;
+	iter->level = NULL;
+	iter->level_count = 0;
+	iter->pos = 0;
+	GrB_Vector_new(&iter->visited, GrB_BOOL, n);
+	GrB_Vector_new(&iter->frontier, GrB_BOOL, n);
+	GrB_Vector_new(&iter->next, GrB_BOOL, n);
+
+	GrB_Vector_setElement_BOOL(iter->frontier, true, src);
+	GrB_Vector_setElement_BOOL(iter->visited, true, src);
+	return iter;
+}
+
+// Expands the following level, returns false if no new nodes are reached.
+static bool _ReachableNodesIter_Expand(ReachableNodesIter *iter) {
+	if(iter->depth >= iter->maxLen) return false;
+	// Traversals may run for long, abort queries which exceeded their timeout.
+	QueryCtx_CheckTimeout(NULL);
+
+	GrB_Vector_clear(iter->next);
+	ReachableNodes_Expand(iter->g, iter->next, iter->frontier, iter->visited, iter->relationIDs,
+						  iter->relationCount, iter->dir);
+
+	GrB_Index nvals;
+	GrB_Vector_nvals(&nvals, iter->next);
+	if(nvals == 0) return false;
+
+	GrB_eWiseAdd_Vector_BinaryOp(iter->visited, GrB_NULL, GrB_NULL, GrB_LOR, iter->visited,
+								 iter->next, GrB_NULL);
+	GrB_Vector tmp = iter->frontier;
+	iter->frontier = iter->next;
+	iter->next = tmp;
+	iter->depth++;
+
+	if(iter->level) rm_free(iter->level);
+	iter->level = rm_malloc(sizeof(GrB_Index) * nvals);
+	GrB_Vector_extractTuples_BOOL(iter->level, GrB_NULL, &nvals, iter->frontier);
+	iter->level_count = nvals;
+	iter->pos = 0;
+	return true;
+}
+
+bool ReachableNodesIter_Next(ReachableNodesIter *iter, NodeID *id, unsigned int *distance) {
+	if(iter->pos == iter->level_count && !_ReachableNodesIter_Expand(iter)) return false;
+	*id = iter->level[iter->pos++];
+	*distance = iter->depth;
+	return true;
+}
+
+void ReachableNodesIter_Free(ReachableNodesIter *iter) {
+	if(iter->level) rm_free(iter->level);
+	GrB_free(&iter->visited);
+	GrB_free(&iter->frontier);
+	GrB_free(&iter->next);
+	rm_free(iter);
+}
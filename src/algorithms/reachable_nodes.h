@@ -0,0 +1,64 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+/*
+ * Finds the distinct nodes reachable from a given source node.
+ * Nodes are discovered a level at a time, a frontier vector holding the nodes
+ * first reached at distance i is multiplied by the traversed relation matrices
+ * masked by the nodes already visited, no paths are built along the way.
+ * */
+
+#ifndef _REACHABLE_NODES_H_
+#define _REACHABLE_NODES_H_
+
+#include "../graph/graph.h"
+#include "../graph/entities/node.h"
+#include "../util/id_set.h"
+
+// Sets next to the nodes one hop away from frontier in direction dir, which aren't visited.
+void ReachableNodes_Expand(
+	Graph *g,            // Graph to traverse.
+	GrB_Vector next,     // Empty vector set to the newly reached nodes.
+	GrB_Vector frontier, // Nodes to expand.
+	GrB_Vector visited,  // Nodes to ignore.
+	int *relationIDs,    // Edge type(s) on which we'll traverse.
+	int relationCount,   // Length of relationIDs.
+	GRAPH_EDGE_DIR dir   // Traversal direction.
+);
+
+// Returns the set of nodes at distance 1 to maxLen from src, src itself excluded.
+// Returns NULL once the query is to be aborted, see QueryCtx_PollTimeout.
+IDSet *ReachableNodes(
+	Graph *g,            // Graph to traverse.
+	const Node *src,     // Source node to traverse.
+	int *relationIDs,    // Edge type(s) on which we'll traverse.
+	int relationCount,   // Length of relationIDs.
+	GRAPH_EDGE_DIR dir,  // Traversal direction.
+	unsigned int maxLen  // Nodes must be reached within maxLen edges.
+);
+
+// Iterates the nodes reachable from a source a level at a time.
+typedef struct ReachableNodesIter ReachableNodesIter;
+
+/* Creates an iterator over the nodes at distance 1 to maxLen from src, src itself excluded,
+ * nodes are produced by ascending distance, by ascending ID within a distance.
+ * Levels are expanded once the previous level is consumed, relationIDs must outlive the iterator. */
+ReachableNodesIter *ReachableNodesIter_New(
+	Graph *g,            // Graph to traverse.
+	NodeID src,          // Source node to traverse.
+	int *relationIDs,    // Edge type(s) on which we'll traverse.
+	int relationCount,   // Length of relationIDs.
+	GRAPH_EDGE_DIR dir,  // Traversal direction.
+	unsigned int maxLen  // Nodes must be reached within maxLen edges.
+);
+
+// Retrieves the next reached node and its distance from src, returns false once depleted.
+bool ReachableNodesIter_Next(ReachableNodesIter *iter, NodeID *id, unsigned int *distance);
+
+// Frees iterator.
+void ReachableNodesIter_Free(ReachableNodesIter *iter);
+
+#endif
@@ -0,0 +1,334 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "shortest_paths.h"
+#include "reachable_nodes.h"
+#include <assert.h>
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../query_ctx.h"
+
+static inline GRAPH_EDGE_DIR _ReverseDirection(GRAPH_EDGE_DIR dir) {
+	if(dir == GRAPH_EDGE_DIR_OUTGOING) return GRAPH_EDGE_DIR_INCOMING;
+	if(dir == GRAPH_EDGE_DIR_INCOMING) return GRAPH_EDGE_DIR_OUTGOING;
+	return GRAPH_EDGE_DIR_BOTH;
+}
+
+static inline bool _VectorContains(GrB_Vector v, NodeID id) {
+	bool x;
+	return GrB_Vector_extractElement_BOOL(&x, v, id) == GrB_SUCCESS;
+}
+
+static GrB_Vector _NewFrontier(const ShortestPathsCtx *ctx, const Node *n) {
+	GrB_Vector v;
+	GrB_Vector_new(&v, GrB_BOOL, Graph_RequiredMatrixDim(ctx->g));
+	if(n) GrB_Vector_setElement_BOOL(v, true, ENTITY_GET_ID(n));
+	return v;
+}
+
+// Returns the node IDs held by v.
+static NodeID *_VectorIDs(GrB_Vector v) {
+	GrB_Index nvals;
+	GrB_Vector_nvals(&nvals, v);
+	GrB_Index *ids = rm_malloc(sizeof(GrB_Index) * (nvals + 1));
+	GrB_Vector_extractTuples_BOOL(ids, GrB_NULL, &nvals, v);
+	NodeID *targets = array_new(NodeID, nvals);
+	for(GrB_Index i = 0; i < nvals; i++) targets = array_append(targets, ids[i]);
+	rm_free(ids);
+	return targets;
+}
+
+/* Sets next to the unvisited nodes one hop away from frontier in direction dir,
+ * and marks them as visited. */
+static GrB_Vector _Expand(ShortestPathsCtx *ctx, GrB_Vector frontier, GrB_Vector visited,
+						  GRAPH_EDGE_DIR dir) {
+	GrB_Vector next = _NewFrontier(ctx, NULL);
+	ReachableNodes_Expand(ctx->g, next, frontier, visited, ctx->relationIDs, ctx->relationCount, dir);
+	GrB_eWiseAdd_Vector_BinaryOp(visited, GrB_NULL, GrB_NULL, GrB_LOR, visited, next, GrB_NULL);
+	return next;
+}
+
+/* Having expanded levels to next, sets the targets to the nodes of next which
+ * the other search reached, closest to its origin first.
+ * Returns false if the searches didn't meet. */
+static bool _Meet(ShortestPathsCtx *ctx, GrB_Vector next, GrB_Vector other_visited,
+				  GrB_Vector *other_levels, uint *other_depth) {
+	GrB_Index nvals;
+	GrB_Vector meet = _NewFrontier(ctx, NULL);
+	GrB_eWiseMult_Vector_BinaryOp(meet, GrB_NULL, GrB_NULL, GrB_LAND, next, other_visited,
+								  GrB_NULL);
+	GrB_Vector_nvals(&nvals, meet);
+	if(nvals == 0) {
+		GrB_free(&meet);
+		return false;
+	}
+
+	// Only nodes closest to the other search's origin lie on shortest paths.
+	NodeID *meeting = _VectorIDs(meet);
+	GrB_free(&meet);
+	uint levels = array_len(other_levels);
+	for(uint depth = 0; depth < levels && array_len(ctx->targets) == 0; depth++) {
+		for(uint i = 0; i < array_len(meeting); i++) {
+			if(!_VectorContains(other_levels[depth], meeting[i])) continue;
+			ctx->targets = array_append(ctx->targets, meeting[i]);
+			*other_depth = depth;
+		}
+	}
+	array_free(meeting);
+	return true;
+}
+
+// Expands from both ends, until the searches meet.
+// Returns false once the query is to be aborted.
+static bool _BidirectionalSearch(ShortestPathsCtx *ctx) {
+	GrB_Vector forward_visited = _NewFrontier(ctx, &ctx->src);
+	GrB_Vector backward_visited = _NewFrontier(ctx, &ctx->dst);
+	ctx->backward = array_append(ctx->backward, _NewFrontier(ctx, &ctx->dst));
+
+	bool aborted = false;
+	while(true) {
+		// Searches may run for long, stop once the query is to be aborted.
+		if((aborted = QueryCtx_PollTimeout(NULL))) break;
+		uint depth = array_len(ctx->forward) - 1;
+		uint back_depth = array_len(ctx->backward) - 1;
+		if(depth + back_depth >= ctx->maxLen) break;
+
+		// Expand the smaller frontier.
+		GrB_Index forward_size;
+		GrB_Index backward_size;
+		GrB_Vector_nvals(&forward_size, ctx->forward[depth]);
+		GrB_Vector_nvals(&backward_size, ctx->backward[back_depth]);
+
+		GrB_Vector next;
+		GrB_Index nvals;
+		bool met;
+		if(forward_size <= backward_size) {
+			next = _Expand(ctx, ctx->forward[depth], forward_visited, ctx->dir);
+			ctx->forward = array_append(ctx->forward, next);
+			met = _Meet(ctx, next, backward_visited, ctx->backward, &ctx->backDepth);
+			ctx->depth = depth + 1;
+		} else {
+			next = _Expand(ctx, ctx->backward[back_depth], backward_visited,
+						   _ReverseDirection(ctx->dir));
+			ctx->backward = array_append(ctx->backward, next);
+			met = _Meet(ctx, next, forward_visited, ctx->forward, &ctx->depth);
+			ctx->backDepth = back_depth + 1;
+		}
+		if(met) break;
+
+		// Dead end, the destination isn't reachable.
+		GrB_Vector_nvals(&nvals, next);
+		if(nvals == 0) break;
+	}
+
+	GrB_free(&forward_visited);
+	GrB_free(&backward_visited);
+	return !aborted;
+}
+
+// Expands from the source until every reachable node is discovered.
+// Returns false once the query is to be aborted.
+static bool _SingleSourceSearch(ShortestPathsCtx *ctx) {
+	GrB_Vector visited = _NewFrontier(ctx, &ctx->src);
+	bool aborted = false;
+	while(array_len(ctx->forward) - 1 < ctx->maxLen) {
+		// Searches may run for long, stop once the query is to be aborted.
+		if((aborted = QueryCtx_PollTimeout(NULL))) break;
+		GrB_Index nvals;
+		GrB_Vector next = _Expand(ctx, ctx->forward[array_len(ctx->forward) - 1], visited, ctx->dir);
+		GrB_Vector_nvals(&nvals, next);
+		if(nvals == 0) {
+			GrB_free(&next);
+			break;
+		}
+		ctx->forward = array_append(ctx->forward, next);
+	}
+	GrB_free(&visited);
+	return !aborted;
+}
+
+/* Collects the chains extending chain, whose head is at distance depth,
+ * through nodes at decreasing distances, reached by following edges in direction dir. */
+static void _CollectChains(ShortestPathsCtx *ctx, Path *chain, uint depth, GrB_Vector *levels,
+						   GRAPH_EDGE_DIR dir, Path ***chains) {
+	if(depth == 0) {
+		*chains = array_append(*chains, Path_Clone(chain));
+		return;
+	}
+
+	Node head = Path_Head(chain);
+	NodeID head_id = ENTITY_GET_ID(&head);
+	Edge *edges = array_new(Edge, 4);
+	for(int i = 0; i < ctx->relationCount; i++) {
+		Graph_GetNodeEdges(ctx->g, &head, dir, ctx->relationIDs[i], &edges);
+	}
+
+	uint edge_count = array_len(edges);
+	for(uint i = 0; i < edge_count; i++) {
+		// A single shortest path requires a single chain.
+		if(!ctx->all && array_len(*chains) > 0) break;
+		Edge *e = edges + i;
+		NodeID neighbor_id = (Edge_GetSrcNodeID(e) == head_id) ? Edge_GetDestNodeID(e) :
+							 Edge_GetSrcNodeID(e);
+		if(!_VectorContains(levels[depth - 1], neighbor_id)) continue;
+
+		Node neighbor;
+		Graph_GetNode(ctx->g, neighbor_id, &neighbor);
+		Path_AppendEdge(chain, *e);
+		Path_AppendNode(chain, neighbor);
+		_CollectChains(ctx, chain, depth - 1, levels, dir, chains);
+		Path_PopNode(chain);
+		Path_PopEdge(chain);
+	}
+	array_free(edges);
+}
+
+static Path **_TargetChains(ShortestPathsCtx *ctx, NodeID target, uint depth, GrB_Vector *levels,
+							GRAPH_EDGE_DIR dir) {
+	Path **chains = array_new(Path *, 1);
+	Path *chain = Path_New(depth + 1);
+	Node n;
+	Graph_GetNode(ctx->g, target, &n);
+	Path_AppendNode(chain, n);
+	_CollectChains(ctx, chain, depth, levels, dir, &chains);
+	Path_Free(chain);
+	return chains;
+}
+
+// Builds the shortest paths passing through target.
+static void _CollectPaths(ShortestPathsCtx *ctx, NodeID target) {
+	// Chains leading back from target to the source.
+	Path **prefixes = _TargetChains(ctx, target, ctx->depth, ctx->forward,
+									_ReverseDirection(ctx->dir));
+	// Chains leading on from target to the destination.
+	Path **suffixes = NULL;
+	if(ctx->bound) suffixes = _TargetChains(ctx, target, ctx->backDepth, ctx->backward, ctx->dir);
+
+	uint prefix_count = array_len(prefixes);
+	uint suffix_count = ctx->bound ? array_len(suffixes) : 1;
+	for(uint i = 0; i < prefix_count; i++) {
+		for(uint j = 0; j < suffix_count; j++) {
+			Path *p = Path_Clone(prefixes[i]);
+			Path_Reverse(p);
+			if(ctx->bound) {
+				Path *suffix = suffixes[j];
+				size_t edge_count = Path_EdgeCount(suffix);
+				for(size_t k = 0; k < edge_count; k++) {
+					Path_AppendEdge(p, *Path_GetEdge(suffix, k));
+					Path_AppendNode(p, *Path_GetNode(suffix, k + 1));
+				}
+			}
+			ctx->paths = array_append(ctx->paths, p);
+		}
+	}
+
+	for(uint i = 0; i < prefix_count; i++) Path_Free(prefixes[i]);
+	array_free(prefixes);
+	if(suffixes) {
+		for(uint i = 0; i < array_len(suffixes); i++) Path_Free(suffixes[i]);
+		array_free(suffixes);
+	}
+}
+
+// Advances to the next node paths pass through, returns false once depleted.
+static bool _NextTarget(ShortestPathsCtx *ctx, NodeID *target) {
+	if(ctx->bound) {
+		// A single shortest path requires a single target.
+		if(ctx->targetIdx == array_len(ctx->targets) || (!ctx->all && ctx->targetIdx > 0)) {
+			return false;
+		}
+		*target = ctx->targets[ctx->targetIdx++];
+		return true;
+	}
+
+	// Destinations are produced a level at a time.
+	while(ctx->targetIdx == array_len(ctx->targets)) {
+		if(ctx->depth + 1 >= array_len(ctx->forward)) return false;
+		ctx->depth++;
+		array_free(ctx->targets);
+		ctx->targets = _VectorIDs(ctx->forward[ctx->depth]);
+		ctx->targetIdx = 0;
+	}
+	*target = ctx->targets[ctx->targetIdx++];
+	return true;
+}
+
+ShortestPathsCtx *ShortestPathsCtx_New(Node *src, Node *dst, Graph *g, int *relationIDs,
+									   int relationCount, GRAPH_EDGE_DIR dir, unsigned int minLen, unsigned int maxLen,
+									   bool all) {
+	assert(src && minLen <= 1);
+
+	ShortestPathsCtx *ctx = rm_malloc(sizeof(ShortestPathsCtx));
+	ctx->g = g;
+	ctx->dir = dir;
+	ctx->all = all;
+	ctx->minLen = minLen;
+	ctx->maxLen = maxLen;
+	ctx->relationIDs = relationIDs;
+	ctx->relationCount = relationCount;
+	ctx->src = *src;
+	ctx->bound = (dst != NULL);
+	if(dst) ctx->dst = *dst;
+	ctx->forward = array_new(GrB_Vector, 1);
+	ctx->backward = array_new(GrB_Vector, 1);
+	ctx->targets = array_new(NodeID, 1);
+	ctx->targetIdx = 0;
+	ctx->depth = 0;
+	ctx->backDepth = 0;
+	ctx->paths = array_new(Path *, 1);
+	ctx->path = NULL;
+
+	bool searched = true;
+	ctx->forward = array_append(ctx->forward, _NewFrontier(ctx, src));
+	if(ctx->bound) {
+		if(ENTITY_GET_ID(src) == ENTITY_GET_ID(dst)) {
+			// The source is its own destination, at distance zero.
+			if(minLen == 0) ctx->targets = array_append(ctx->targets, ENTITY_GET_ID(src));
+		} else {
+			searched = _BidirectionalSearch(ctx);
+		}
+	} else {
+		searched = _SingleSourceSearch(ctx);
+		// Start from the source, if zero length paths are requested.
+		if(minLen == 0) ctx->targets = array_append(ctx->targets, ENTITY_GET_ID(src));
+	}
+
+	if(!searched) {
+		ShortestPathsCtx_Free(ctx);
+		return NULL;
+	}
+	return ctx;
+}
+
+Path *ShortestPathsCtx_NextPath(ShortestPathsCtx *ctx) {
+	if(!ctx) return NULL;
+	if(ctx->path) {
+		Path_Free(ctx->path);
+		ctx->path = NULL;
+	}
+
+	while(array_len(ctx->paths) == 0) {
+		NodeID target;
+		if(!_NextTarget(ctx, &target)) return NULL;
+		_CollectPaths(ctx, target);
+	}
+
+	ctx->path = array_pop(ctx->paths);
+	return ctx->path;
+}
+
+void ShortestPathsCtx_Free(ShortestPathsCtx *ctx) {
+	if(!ctx) return;
+	for(uint i = 0; i < array_len(ctx->forward); i++) GrB_free(&ctx->forward[i]);
+	for(uint i = 0; i < array_len(ctx->backward); i++) GrB_free(&ctx->backward[i]);
+	for(uint i = 0; i < array_len(ctx->paths); i++) Path_Free(ctx->paths[i]);
+	array_free(ctx->forward);
+	array_free(ctx->backward);
+	array_free(ctx->targets);
+	array_free(ctx->paths);
+	if(ctx->path) Path_Free(ctx->path);
+	rm_free(ctx);
+}
@@ -0,0 +1,69 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+/*
+ * Finds the shortest paths starting at a given source node.
+ * Nodes are discovered a level at a time, a frontier vector holding the nodes
+ * first reached at distance i is multiplied by the traversed relation matrices
+ * masked by the nodes already visited.
+ * When the destination node is known, frontiers are expanded from both ends,
+ * starting with the smaller one, until they meet.
+ * Otherwise, the shortest paths to every node reachable from the source are produced.
+ * Paths are reconstructed by walking back from the nodes where both searches met,
+ * through neighbors discovered at the previous level.
+ * */
+
+#ifndef _SHORTEST_PATHS_H_
+#define _SHORTEST_PATHS_H_
+
+#include "../datatypes/path/path.h"
+#include "../graph/graph.h"
+#include "../graph/entities/node.h"
+
+typedef struct {
+	Graph *g;                   // Graph to traverse.
+	int *relationIDs;           // Edge type(s) to traverse.
+	int relationCount;          // Length of relationIDs.
+	GRAPH_EDGE_DIR dir;         // Traverse direction.
+	unsigned int minLen;        // Path minimum length, in edges.
+	unsigned int maxLen;        // Path maximum length, in edges.
+	bool all;                   // Produce every shortest path, rather than a single one.
+	Node src;                   // Source node.
+	Node dst;                   // Destination node, if known.
+	bool bound;                 // Destination node is known.
+	GrB_Vector *forward;        // Nodes reached at distance i from source.
+	GrB_Vector *backward;       // Nodes reached at distance i from destination.
+	NodeID *targets;            // Nodes through which the next paths pass.
+	uint targetIdx;             // Next target.
+	uint depth;                 // Distance of targets from source.
+	uint backDepth;             // Distance of targets from destination.
+	Path **paths;               // Paths through the current target yet to be produced.
+	Path *path;                 // Last produced path.
+} ShortestPathsCtx;
+
+// Create a new shortest paths context object.
+// Returns NULL once the query is to be aborted, see QueryCtx_PollTimeout.
+ShortestPathsCtx *ShortestPathsCtx_New(
+	Node *src,           // Source node to traverse.
+	Node *dst,           // Destination node of the paths, NULL for every reachable node.
+	Graph *g,            // Graph to traverse.
+	int *relationIDs,    // Edge type(s) on which we'll traverse.
+	int relationCount,   // Length of relationIDs.
+	GRAPH_EDGE_DIR dir,  // Traversal direction.
+	unsigned int minLen, // Path must contain at least minLen edges, either 0 or 1.
+	unsigned int maxLen, // Path must not contain more than maxLen edges.
+	bool all             // Produce every shortest path to each destination.
+);
+
+// Tries to produce a new path from given context
+// If no additional path can be computed return NULL.
+// The path is owned by the context and valid until the next call.
+Path *ShortestPathsCtx_NextPath(ShortestPathsCtx *ctx);
+
+// Free context object.
+void ShortestPathsCtx_Free(ShortestPathsCtx *ctx);
+
+#endif
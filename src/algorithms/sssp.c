@@ -0,0 +1,116 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "sssp.h"
+#include "../query_ctx.h"
+#include <assert.h>
+
+// Sets w to the entries of u for which op(u, bound) holds.
+static void _SSSP_Select(GrB_Vector w, GxB_SelectOp op, GrB_Vector u, double bound) {
+	GxB_Scalar thunk;
+	assert(GxB_Scalar_new(&thunk, GrB_FP64) == GrB_SUCCESS);
+	assert(GxB_Scalar_setElement_FP64(thunk, bound) == GrB_SUCCESS);
+	assert(GxB_Vector_select(w, GrB_NULL, GrB_NULL, op, u, thunk, GrB_DESC_R) == GrB_SUCCESS);
+	GrB_free(&thunk);
+}
+
+static void _SSSP_SelectMatrix(GrB_Matrix C, GxB_SelectOp op, GrB_Matrix A, double bound) {
+	GxB_Scalar thunk;
+	assert(GxB_Scalar_new(&thunk, GrB_FP64) == GrB_SUCCESS);
+	assert(GxB_Scalar_setElement_FP64(thunk, bound) == GrB_SUCCESS);
+	assert(GxB_Matrix_select(C, GrB_NULL, GrB_NULL, op, A, thunk, GrB_NULL) == GrB_SUCCESS);
+	GrB_free(&thunk);
+}
+
+static inline GrB_Index _SSSP_Nvals(GrB_Vector v) {
+	GrB_Index nvals;
+	assert(GrB_Vector_nvals(&nvals, v) == GrB_SUCCESS);
+	return nvals;
+}
+
+/* Relaxes the edges of A leaving frontier, t = min(t, frontier min.plus A).
+ * Sets improved to the nodes whose tentative distance decreased. */
+static void _SSSP_Relax(GrB_Vector t, GrB_Vector frontier, GrB_Matrix A, GrB_Vector req,
+						GrB_Vector improved) {
+	assert(GrB_vxm(req, GrB_NULL, GrB_NULL, GxB_MIN_PLUS_FP64, frontier, A,
+				   GrB_NULL) == GrB_SUCCESS);
+	// Improved are requests either shorter than or absent from t.
+	assert(GrB_eWiseMult(improved, GrB_NULL, GrB_NULL, GrB_LT_FP64, req, t,
+						 GrB_NULL) == GrB_SUCCESS);
+	assert(GrB_apply(improved, t, GrB_LOR, GxB_ONE_BOOL, req, GrB_DESC_SC) == GrB_SUCCESS);
+	assert(GrB_eWiseAdd(t, GrB_NULL, GrB_NULL, GrB_MIN_FP64, t, req, GrB_NULL) == GrB_SUCCESS);
+}
+
+GrB_Vector SSSP_DeltaStepping(GrB_Matrix W, GrB_Index src, double delta) {
+	assert(W && delta > 0);
+	GrB_Index n;
+	assert(GrB_Matrix_nrows(&n, W) == GrB_SUCCESS);
+
+	// Split edges into light and heavy ones.
+	GrB_Matrix AL;
+	GrB_Matrix AH;
+	assert(GrB_Matrix_new(&AL, GrB_FP64, n, n) == GrB_SUCCESS);
+	assert(GrB_Matrix_new(&AH, GrB_FP64, n, n) == GrB_SUCCESS);
+	_SSSP_SelectMatrix(AL, GxB_LE_THUNK, W, delta);
+	_SSSP_SelectMatrix(AH, GxB_GT_THUNK, W, delta);
+
+	GrB_Vector t;           // Tentative distances.
+	GrB_Vector pending;     // Tentative distances of nodes beyond the current bucket.
+	GrB_Vector frontier;    // Nodes of the current bucket to relax.
+	GrB_Vector settled;     // Nodes settled within the current bucket.
+	GrB_Vector req;         // Relaxation requests.
+	GrB_Vector improved;    // Nodes whose tentative distance decreased.
+	assert(GrB_Vector_new(&t, GrB_FP64, n) == GrB_SUCCESS);
+	assert(GrB_Vector_new(&pending, GrB_FP64, n) == GrB_SUCCESS);
+	assert(GrB_Vector_new(&frontier, GrB_FP64, n) == GrB_SUCCESS);
+	assert(GrB_Vector_new(&settled, GrB_FP64, n) == GrB_SUCCESS);
+	assert(GrB_Vector_new(&req, GrB_FP64, n) == GrB_SUCCESS);
+	assert(GrB_Vector_new(&improved, GrB_BOOL, n) == GrB_SUCCESS);
+	assert(GrB_Vector_setElement_FP64(t, 0, src) == GrB_SUCCESS);
+
+	double lb = 0;
+	bool aborted = false;
+	_SSSP_Select(pending, GxB_GE_THUNK, t, lb);
+	while(_SSSP_Nvals(pending) > 0) {
+		// Traversals may run for long, stop once the query is to be aborted.
+		if((aborted = QueryCtx_PollTimeout(NULL))) break;
+
+		// Skip empty buckets, the next bucket starts at the closest pending node.
+		assert(GrB_reduce(&lb, GrB_NULL, GxB_MIN_FP64_MONOID, pending, GrB_NULL) == GrB_SUCCESS);
+		double ub = lb + delta;
+		_SSSP_Select(frontier, GxB_LT_THUNK, pending, ub);
+		assert(GrB_Vector_clear(settled) == GrB_SUCCESS);
+
+		// Relax light edges until the bucket stops changing.
+		while(_SSSP_Nvals(frontier) > 0) {
+			if((aborted = QueryCtx_PollTimeout(NULL))) break;
+			assert(GrB_eWiseAdd(settled, GrB_NULL, GrB_NULL, GrB_MIN_FP64, settled, frontier,
+								GrB_NULL) == GrB_SUCCESS);
+			_SSSP_Relax(t, frontier, AL, req, improved);
+			// Improved nodes falling within the bucket are relaxed again.
+			assert(GrB_assign(frontier, improved, GrB_NULL, t, GrB_ALL, n,
+							  GrB_DESC_R) == GrB_SUCCESS);
+			_SSSP_Select(frontier, GxB_LT_THUNK, frontier, ub);
+		}
+		if(aborted) break;
+
+		// Settled nodes hold their final distances, relax their heavy edges once.
+		assert(GrB_assign(settled, settled, GrB_NULL, t, GrB_ALL, n, GrB_DESC_S) == GrB_SUCCESS);
+		_SSSP_Relax(t, settled, AH, req, improved);
+
+		_SSSP_Select(pending, GxB_GE_THUNK, t, ub);
+	}
+
+	GrB_free(&AL);
+	GrB_free(&AH);
+	GrB_free(&pending);
+	GrB_free(&frontier);
+	GrB_free(&settled);
+	GrB_free(&req);
+	GrB_free(&improved);
+	if(aborted) GrB_free(&t);
+	return t;
+}
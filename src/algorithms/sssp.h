@@ -0,0 +1,30 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+/*
+ * Single source shortest paths over a non-negatively weighted matrix, by delta-stepping.
+ * Tentative distances are kept in a vector, nodes are settled a bucket at a time,
+ * each bucket holding the unsettled nodes within delta of the closest one.
+ * The nodes of a bucket repeatedly relax their light edges, weighing at most delta,
+ * until the bucket stops changing, its heavy edges are then relaxed once.
+ * Each relaxation is a single min-plus vector-matrix product.
+ * */
+
+#ifndef _SSSP_H_
+#define _SSSP_H_
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// Returns the distances from src to every node it reaches, a FP64 vector,
+// unreached nodes hold no entry. Caller is responsible for freeing the vector.
+// Returns GrB_NULL once the query is to be aborted, see QueryCtx_PollTimeout.
+GrB_Vector SSSP_DeltaStepping(
+	GrB_Matrix W,   // Square FP64 matrix, W[i, j] is the weight of edge i->j, non-negative.
+	GrB_Index src,  // Source row.
+	double delta    // Bucket width, positive.
+);
+
+#endif
@@ -0,0 +1,123 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "subgraph_matrix.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+#include <assert.h>
+
+GrB_Matrix SubgraphMatrix(Graph *g, int label, const int *relations, uint relation_count,
+						  GrB_Index **mappings, GrB_Index *n) {
+	GrB_Index rows = Graph_RequiredMatrixDim(g);
+	GrB_Matrix r;
+	assert(GrB_Matrix_new(&r, GrB_BOOL, rows, rows) == GrB_SUCCESS);
+
+	if(relations == NULL) {
+		assert(GrB_apply(r, GrB_NULL, GrB_NULL, GxB_ONE_BOOL, Graph_GetAdjacencyMatrix(g),
+						 GrB_NULL) == GrB_SUCCESS);
+	} else {
+		// Connections of any of the given types count once.
+		for(uint i = 0; i < relation_count; i++) {
+			assert(GrB_apply(r, GrB_NULL, GrB_LOR, GxB_ONE_BOOL,
+							 Graph_GetRelationMatrix(g, relations[i]), GrB_NULL) == GrB_SUCCESS);
+		}
+	}
+
+	// Collect the considered nodes.
+	*n = 0;
+	*mappings = NULL;
+	if(label != GRAPH_NO_LABEL) {
+		GrB_Index id;
+		IDSetIterator it;
+		const IDSet *ids = Graph_GetLabelIDs(g, label);
+		*n = IDSet_Cardinality(ids);
+		*mappings = rm_malloc(sizeof(GrB_Index) * (*n + 1));
+		IDSet_Iterate(ids, &it);
+		for(GrB_Index i = 0; IDSetIterator_Next(&it, &id); i++) (*mappings)[i] = id;
+	} else if(Graph_NodeCount(g) != rows) {
+		// Skip deleted nodes and unused rows.
+		Node node;
+		*n = Graph_NodeCount(g);
+		*mappings = rm_malloc(sizeof(GrB_Index) * (*n + 1));
+		DataBlockIterator *iter = Graph_ScanNodes(g);
+		for(GrB_Index i = 0; i < *n; i++) {
+			node.entity = DataBlockIterator_Next(iter);
+			assert(node.entity);
+			(*mappings)[i] = ENTITY_GET_ID(&node);
+		}
+		DataBlockIterator_Free(iter);
+	} else {
+		*n = rows;
+	}
+
+	if(*n == 0) {
+		GrB_free(&r);
+		return GrB_NULL;
+	}
+	if(*mappings == NULL) return r;
+
+	GrB_Matrix reduced;
+	assert(GrB_Matrix_new(&reduced, GrB_BOOL, *n, *n) == GrB_SUCCESS);
+	assert(GrB_extract(reduced, GrB_NULL, GrB_NULL, r, *mappings, *n, *mappings, *n,
+					   GrB_NULL) == GrB_SUCCESS);
+	GrB_free(&r);
+	return reduced;
+}
+
+bool SubgraphMatrix_ValidArgs(SIValue label, SIValue relations) {
+	if(!(SI_TYPE(label) & (T_STRING | T_NULL))) return false;
+	if(!(SI_TYPE(relations) & (T_STRING | T_ARRAY | T_NULL))) return false;
+	if(SI_TYPE(relations) & T_ARRAY) {
+		uint relation_count = SIArray_Length(relations);
+		for(uint i = 0; i < relation_count; i++) {
+			if(!(SI_TYPE(SIArray_Get(relations, i)) & T_STRING)) return false;
+		}
+	}
+	return true;
+}
+
+bool SubgraphMatrix_ResolveArgs(GraphContext *gc, SIValue label, SIValue relations,
+								int *label_id, int **relation_ids) {
+	*label_id = GRAPH_NO_LABEL;
+	*relation_ids = NULL;
+	if(SI_TYPE(label) & T_STRING) {
+		Schema *s = GraphContext_GetSchema(gc, label.stringval, SCHEMA_NODE);
+		if(!s) return false;
+		*label_id = s->id;
+	}
+
+	if(!(SI_TYPE(relations) & T_NULL)) {
+		uint relation_count = (SI_TYPE(relations) & T_ARRAY) ? SIArray_Length(relations) : 1;
+		*relation_ids = array_new(int, relation_count);
+		for(uint i = 0; i < relation_count; i++) {
+			const char *relation = (SI_TYPE(relations) & T_ARRAY) ?
+								   SIArray_Get(relations, i).stringval : relations.stringval;
+			Schema *s = GraphContext_GetSchema(gc, relation, SCHEMA_EDGE);
+			if(s) *relation_ids = array_append(*relation_ids, s->id);
+		}
+	}
+	return true;
+}
+
+GrB_Matrix SubgraphMatrix_FromArgs(GraphContext *gc, SIValue label, SIValue relations,
+								   GrB_Index **mappings, GrB_Index *n) {
+	int label_id;
+	int *relation_ids;
+	*n = 0;
+	*mappings = NULL;
+	if(!SubgraphMatrix_ResolveArgs(gc, label, relations, &label_id, &relation_ids)) return GrB_NULL;
+
+	// Reuse the matrices of a projection over the same subgraph.
+	GrB_Matrix A;
+	uint relation_count = relation_ids ? array_len(relation_ids) : 0;
+	if(!Projections_Lookup(GraphContext_GetProjections(gc), gc->g, label_id, relation_ids,
+						   relation_count, ATTRIBUTE_NOTFOUND, &A, NULL, mappings, n)) {
+		A = SubgraphMatrix(gc->g, label_id, relation_ids, relation_count, mappings, n);
+	}
+	if(relation_ids) array_free(relation_ids);
+	return A;
+}
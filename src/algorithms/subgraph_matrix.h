@@ -0,0 +1,54 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#ifndef _SUBGRAPH_MATRIX_H_
+#define _SUBGRAPH_MATRIX_H_
+
+#include "../value.h"
+#include "../graph/graphcontext.h"
+
+/* Builds the boolean matrix connecting the nodes of a label through edges
+ * of the given relationship types, row i connects to column j if node i
+ * has an edge leading to node j. Sets mappings to the node ID of each row,
+ * or NULL if rows correspond to node IDs, and n to the number of rows.
+ * Returns GrB_NULL if there are no nodes. */
+GrB_Matrix SubgraphMatrix(
+	Graph *g,               // Graph.
+	int label,              // Label ID, GRAPH_NO_LABEL for every node.
+	const int *relations,   // Relation IDs, NULL for every relationship type.
+	uint relation_count,    // Length of relations.
+	GrB_Index **mappings,   // [output] node ID of each row, caller is responsible for freeing it.
+	GrB_Index *n            // [output] number of rows.
+);
+
+/* Builds the subgraph matrix of procedure arguments, label is a label name
+ * and relations either a relationship type or a list of types,
+ * NULL considers every node or relationship type. Unknown types are ignored.
+ * The matrix is copied from a projection over the same subgraph if one is defined. */
+GrB_Matrix SubgraphMatrix_FromArgs(
+	GraphContext *gc,       // Graph context.
+	SIValue label,          // Label name or NULL.
+	SIValue relations,      // Relationship type, list of types or NULL.
+	GrB_Index **mappings,   // [output] node ID of each row, caller is responsible for freeing it.
+	GrB_Index *n            // [output] number of rows.
+);
+
+/* Resolves procedure arguments into a label ID, GRAPH_NO_LABEL if label is NULL,
+ * and an array of relation IDs, NULL if relations is NULL. Unknown relationship
+ * types are ignored, returns false if label names an unknown label.
+ * The caller is responsible for freeing relation_ids. */
+bool SubgraphMatrix_ResolveArgs(
+	GraphContext *gc,       // Graph context.
+	SIValue label,          // Label name or NULL.
+	SIValue relations,      // Relationship type, list of types or NULL.
+	int *label_id,          // [output] label ID.
+	int **relation_ids      // [output] relation IDs.
+);
+
+// Returns true if label and relations are valid SubgraphMatrix_FromArgs arguments.
+bool SubgraphMatrix_ValidArgs(SIValue label, SIValue relations);
+
+#endif
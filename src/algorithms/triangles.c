@@ -0,0 +1,99 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "triangles.h"
+#include "../util/rmalloc.h"
+#include <string.h>
+#include <assert.h>
+
+// Builds S = A + A' without self loops.
+static GrB_Matrix _Triangles_Symmetric(GrB_Matrix A, GrB_Index n) {
+	GrB_Matrix S;
+	assert(GrB_Matrix_new(&S, GrB_BOOL, n, n) == GrB_SUCCESS);
+	assert(GrB_eWiseAdd(S, GrB_NULL, GrB_NULL, GrB_LOR, A, A, GrB_DESC_T1) == GrB_SUCCESS);
+	assert(GxB_select(S, GrB_NULL, GrB_NULL, GxB_OFFDIAG, S, GrB_NULL, GrB_NULL) == GrB_SUCCESS);
+	return S;
+}
+
+// Sets sums to the sum of each row of M, boolean entries count as 1.
+static void _Triangles_RowSums(GrB_Matrix M, GrB_Index n, uint64_t *sums) {
+	GrB_Vector d;
+	GrB_Index nvals = n;
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * n);
+	uint64_t *X = rm_malloc(sizeof(uint64_t) * n);
+	assert(GrB_Vector_new(&d, GrB_UINT64, n) == GrB_SUCCESS);
+	assert(GrB_Matrix_reduce_Monoid(d, GrB_NULL, GrB_NULL, GxB_PLUS_UINT64_MONOID, M,
+									GrB_NULL) == GrB_SUCCESS);
+	assert(GrB_Vector_extractTuples_UINT64(I, X, &nvals, d) == GrB_SUCCESS);
+	memset(sums, 0, sizeof(uint64_t) * n);
+	for(GrB_Index i = 0; i < nvals; i++) sums[I[i]] = X[i];
+	GrB_free(&d);
+	rm_free(I);
+	rm_free(X);
+}
+
+uint64_t TriangleCount(GrB_Matrix A, uint64_t *triples) {
+	GrB_Index n;
+	assert(GrB_Matrix_nrows(&n, A) == GrB_SUCCESS);
+	GrB_Matrix S = _Triangles_Symmetric(A, n);
+
+	if(triples) {
+		uint64_t *degrees = rm_malloc(sizeof(uint64_t) * n);
+		_Triangles_RowSums(S, n, degrees);
+		*triples = 0;
+		for(GrB_Index i = 0; i < n; i++) {
+			if(degrees[i] > 1) *triples += degrees[i] * (degrees[i] - 1) / 2;
+		}
+		rm_free(degrees);
+	}
+
+	/* Triangle a < b < c is counted once, at C(c, b) by way of a:
+	 * L(c, a) and U(a, b), where L = tril(S, -1) and U = triu(S, 1). */
+	GrB_Matrix L;
+	GrB_Matrix U;
+	GrB_Matrix C;
+	assert(GrB_Matrix_new(&L, GrB_BOOL, n, n) == GrB_SUCCESS);
+	assert(GrB_Matrix_new(&U, GrB_BOOL, n, n) == GrB_SUCCESS);
+	assert(GrB_Matrix_new(&C, GrB_UINT64, n, n) == GrB_SUCCESS);
+	GxB_Scalar thunk;
+	assert(GxB_Scalar_new(&thunk, GrB_INT64) == GrB_SUCCESS);
+	assert(GxB_Scalar_setElement_INT64(thunk, -1) == GrB_SUCCESS);
+	assert(GxB_select(L, GrB_NULL, GrB_NULL, GxB_TRIL, S, thunk, GrB_NULL) == GrB_SUCCESS);
+	assert(GxB_Scalar_setElement_INT64(thunk, 1) == GrB_SUCCESS);
+	assert(GxB_select(U, GrB_NULL, GrB_NULL, GxB_TRIU, S, thunk, GrB_NULL) == GrB_SUCCESS);
+	GrB_free(&thunk);
+	GrB_free(&S);
+
+	assert(GrB_mxm(C, L, GrB_NULL, GxB_PLUS_PAIR_UINT64, L, U, GrB_NULL) == GrB_SUCCESS);
+	uint64_t triangles = 0;
+	assert(GrB_Matrix_reduce_UINT64(&triangles, GrB_NULL, GxB_PLUS_UINT64_MONOID, C,
+									GrB_NULL) == GrB_SUCCESS);
+
+	GrB_free(&L);
+	GrB_free(&U);
+	GrB_free(&C);
+	return triangles;
+}
+
+uint64_t *TriangleCount_PerNode(GrB_Matrix A, uint64_t **degrees) {
+	GrB_Index n;
+	assert(GrB_Matrix_nrows(&n, A) == GrB_SUCCESS);
+	GrB_Matrix S = _Triangles_Symmetric(A, n);
+	*degrees = rm_malloc(sizeof(uint64_t) * n);
+	_Triangles_RowSums(S, n, *degrees);
+
+	// C(i, j) counts the common neighbors of adjacent i and j, each triangle of i appears twice in row i.
+	GrB_Matrix C;
+	assert(GrB_Matrix_new(&C, GrB_UINT64, n, n) == GrB_SUCCESS);
+	assert(GrB_mxm(C, S, GrB_NULL, GxB_PLUS_PAIR_UINT64, S, S, GrB_NULL) == GrB_SUCCESS);
+	GrB_free(&S);
+
+	uint64_t *triangles = rm_malloc(sizeof(uint64_t) * n);
+	_Triangles_RowSums(C, n, triangles);
+	GrB_free(&C);
+	for(GrB_Index i = 0; i < n; i++) triangles[i] /= 2;
+	return triangles;
+}
@@ -0,0 +1,35 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+/*
+ * Triangle counting over a boolean adjacency matrix, edge directions
+ * and self loops are ignored, parallel edges count once.
+ * The graph's triangles are counted by the masked product C<L> = L * U of
+ * the lower and upper triangular parts of the symmetric adjacency matrix,
+ * per node triangles by the masked product C<S> = S * S.
+ * */
+
+#ifndef _TRIANGLES_H_
+#define _TRIANGLES_H_
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// Counts the triangles of A.
+// Sets triples to the number of connected triples, paths of length two, if not NULL.
+uint64_t TriangleCount(
+	GrB_Matrix A,       // Square boolean matrix, row i connects to column j.
+	uint64_t *triples   // [output] number of connected triples.
+);
+
+// Counts the triangles each row takes part in.
+// Returns an array holding each row's triangle count and sets degrees to
+// each row's number of distinct neighbors, caller is responsible for freeing both.
+uint64_t *TriangleCount_PerNode(
+	GrB_Matrix A,       // Square boolean matrix, row i connects to column j.
+	uint64_t **degrees  // [output] number of neighbors of each row.
+);
+
+#endif
@@ -17,9 +17,11 @@ struct AggCtx {
 	SIValue result;
 	int (*Step)(struct AggCtx *ctx, SIValue *argv, int argc);
 	int (*Finalize)(struct AggCtx *ctx);
+	int (*Merge)(struct AggCtx *ctx, struct AggCtx *other);
 	void *(*AggCtx_PrivateData_New)();
 	void (*AggCtx_PrivateData_Free)(struct AggCtx *ctx);
 	bool isDistinct;
+	void *udf;  // User-defined aggregation the context evaluates, NULL for built-ins.
 };
 typedef struct AggCtx AggCtx;
 
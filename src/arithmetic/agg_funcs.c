@@ -13,8 +13,11 @@
 #include "../util/qsort.h"
 #include <assert.h>
 #include <math.h>
+#include <string.h>
 #include "../datatypes/array.h"
 #include "../datatypes/set.h"
+#include "../util/hll.h"
+#include "../util/tdigest.h"
 
 
 #define ISLT(a,b) ((*a) < (*b))
@@ -50,6 +53,13 @@ int __agg_sumDistinctStep(AggCtx *ctx, SIValue *argv, int argc) {
 	return AGG_OK;
 }
 
+int __agg_sumMerge(AggCtx *ctx, AggCtx *other) {
+	__agg_sumCtx *ac = Agg_FuncCtx(ctx);
+	__agg_sumCtx *oc = Agg_FuncCtx(other);
+	ac->total += oc->total;
+	return AGG_OK;
+}
+
 int __agg_sumReduceNext(AggCtx *ctx) {
 	__agg_sumCtx *ac = Agg_FuncCtx(ctx);
 	Agg_SetResult(ctx, SI_DoubleVal(ac->total));
@@ -75,8 +85,10 @@ AggCtx *Agg_SumFunc(bool distinct) {
 		return Agg_NewCtx(__agg_sumDistinctStep, __agg_sumReduceNext, __agg_sumCtxNew, __agg_sumCtxFree,
 						  distinct);
 	} else {
-		return Agg_NewCtx(__agg_sumStep, __agg_sumReduceNext, __agg_sumCtxNew, __agg_sumCtxFree,
-						  distinct);
+		AggCtx *ctx = Agg_NewCtx(__agg_sumStep, __agg_sumReduceNext, __agg_sumCtxNew, __agg_sumCtxFree,
+								 distinct);
+		Agg_SetMerge(ctx, __agg_sumMerge);
+		return ctx;
 	}
 
 }
@@ -118,6 +130,14 @@ int __agg_avgDistinctStep(AggCtx *ctx, SIValue *argv, int argc) {
 	return AGG_OK;
 }
 
+int __agg_avgMerge(AggCtx *ctx, AggCtx *other) {
+	__agg_avgCtx *ac = Agg_FuncCtx(ctx);
+	__agg_avgCtx *oc = Agg_FuncCtx(other);
+	ac->count += oc->count;
+	ac->total += oc->total;
+	return AGG_OK;
+}
+
 int __agg_avgReduceNext(AggCtx *ctx) {
 	__agg_avgCtx *ac = Agg_FuncCtx(ctx);
 
@@ -149,8 +169,10 @@ AggCtx *Agg_AvgFunc(bool distinct) {
 		return Agg_NewCtx(__agg_avgDistinctStep, __agg_avgReduceNext, __agg_avgCtxNew, __agg_avgCtxFree,
 						  distinct);
 	} else {
-		return Agg_NewCtx(__agg_avgStep, __agg_avgReduceNext, __agg_avgCtxNew, __agg_avgCtxFree,
-						  distinct);
+		AggCtx *ctx = Agg_NewCtx(__agg_avgStep, __agg_avgReduceNext, __agg_avgCtxNew, __agg_avgCtxFree,
+								 distinct);
+		Agg_SetMerge(ctx, __agg_avgMerge);
+		return ctx;
 	}
 }
 
@@ -181,6 +203,12 @@ int __agg_maxStep(AggCtx *ctx, SIValue *argv, int argc) {
 	return AGG_OK;
 }
 
+int __agg_maxMerge(AggCtx *ctx, AggCtx *other) {
+	__agg_maxCtx *oc = Agg_FuncCtx(other);
+	if(oc->init) __agg_maxStep(ctx, &oc->max, 1);
+	return AGG_OK;
+}
+
 int __agg_maxReduceNext(AggCtx *ctx) {
 	__agg_maxCtx *ac = Agg_FuncCtx(ctx);
 	Agg_SetResult(ctx, ac->max);
@@ -201,7 +229,10 @@ void *__agg_maxCtxNew() {
 
 AggCtx *Agg_MaxFunc(bool distinct) {
 	// Max aggregation do not care about distinct.
-	return Agg_NewCtx(__agg_maxStep, __agg_maxReduceNext, __agg_maxCtxNew, __agg_maxCtxFree, distinct);
+	AggCtx *ctx = Agg_NewCtx(__agg_maxStep, __agg_maxReduceNext, __agg_maxCtxNew, __agg_maxCtxFree,
+							 distinct);
+	Agg_SetMerge(ctx, __agg_maxMerge);
+	return ctx;
 }
 
 //------------------------------------------------------------------------
@@ -231,6 +262,12 @@ int __agg_minStep(AggCtx *ctx, SIValue *argv, int argc) {
 	return AGG_OK;
 }
 
+int __agg_minMerge(AggCtx *ctx, AggCtx *other) {
+	__agg_minCtx *oc = Agg_FuncCtx(other);
+	if(oc->init) __agg_minStep(ctx, &oc->min, 1);
+	return AGG_OK;
+}
+
 int __agg_minReduceNext(AggCtx *ctx) {
 	__agg_minCtx *ac = Agg_FuncCtx(ctx);
 	Agg_SetResult(ctx, ac->min);
@@ -251,7 +288,10 @@ void __agg_minCtxFree(AggCtx *ctx) {
 
 AggCtx *Agg_MinFunc(bool distinct) {
 	// Min aggregation do not care about distinct.
-	return Agg_NewCtx(__agg_minStep, __agg_minReduceNext, __agg_minCtxNew, __agg_minCtxFree, distinct);
+	AggCtx *ctx = Agg_NewCtx(__agg_minStep, __agg_minReduceNext, __agg_minCtxNew, __agg_minCtxFree,
+							 distinct);
+	Agg_SetMerge(ctx, __agg_minMerge);
+	return ctx;
 }
 
 //------------------------------------------------------------------------
@@ -281,6 +321,13 @@ int __agg_countDistinctStep(AggCtx *ctx, SIValue *argv, int argc) {
 	return AGG_OK;
 }
 
+int __agg_countMerge(AggCtx *ctx, AggCtx *other) {
+	__agg_countCtx *ac = Agg_FuncCtx(ctx);
+	__agg_countCtx *oc = Agg_FuncCtx(other);
+	ac->count += oc->count;
+	return AGG_OK;
+}
+
 int __agg_countReduceNext(AggCtx *ctx) {
 	__agg_countCtx *ac = Agg_FuncCtx(ctx);
 	Agg_SetResult(ctx, SI_LongVal(ac->count));
@@ -306,8 +353,10 @@ AggCtx *Agg_CountFunc(bool distinct) {
 		return Agg_NewCtx(__agg_countDistinctStep, __agg_countReduceNext, __agg_countCtxNew,
 						  __agg_countCtxFree, distinct);
 	} else {
-		return Agg_NewCtx(__agg_countStep, __agg_countReduceNext, __agg_countCtxNew,
-						  __agg_countCtxFree, distinct);
+		AggCtx *ctx = Agg_NewCtx(__agg_countStep, __agg_countReduceNext, __agg_countCtxNew,
+								 __agg_countCtxFree, distinct);
+		Agg_SetMerge(ctx, __agg_countMerge);
+		return ctx;
 	}
 }
 
@@ -340,7 +389,7 @@ int __agg_percStep(AggCtx *ctx, SIValue *argv, int argc) {
 		}
 	}
 
-	if(ac->count > ac->values_allocated) {
+	if(ac->count >= ac->values_allocated) {
 		ac->values_allocated *= 2;
 		ac->values = rm_realloc(ac->values, sizeof(double) * ac->values_allocated);
 	}
@@ -369,6 +418,22 @@ int __agg_percDistinctStep(AggCtx *ctx, SIValue *argv, int argc) {
 	return AGG_OK;
 }
 
+// Values are kept as is, so partial value sets simply concatenate.
+int __agg_percMerge(AggCtx *ctx, AggCtx *other) {
+	__agg_percCtx *ac = Agg_FuncCtx(ctx);
+	__agg_percCtx *oc = Agg_FuncCtx(other);
+	if(ac->percentile < 0) ac->percentile = oc->percentile;
+
+	if(ac->count + oc->count > ac->values_allocated) {
+		ac->values_allocated = ac->count + oc->count;
+		ac->values = rm_realloc(ac->values, sizeof(double) * ac->values_allocated);
+	}
+	memcpy(ac->values + ac->count, oc->values, sizeof(double) * oc->count);
+	ac->count += oc->count;
+
+	return AGG_OK;
+}
+
 int __agg_percDiscReduceNext(AggCtx *ctx) {
 	__agg_percCtx *ac = Agg_FuncCtx(ctx);
 
@@ -448,8 +513,10 @@ AggCtx *Agg_PercDiscFunc(bool distinct) {
 		return Agg_NewCtx(__agg_percDistinctStep, __agg_percDiscReduceNext, __agg_PercCtxNew,
 						  __agg_PercCtxFree, distinct);
 	} else {
-		return Agg_NewCtx(__agg_percStep, __agg_percDiscReduceNext, __agg_PercCtxNew,
-						  __agg_PercCtxFree, distinct);
+		AggCtx *ctx = Agg_NewCtx(__agg_percStep, __agg_percDiscReduceNext, __agg_PercCtxNew,
+								 __agg_PercCtxFree, distinct);
+		Agg_SetMerge(ctx, __agg_percMerge);
+		return ctx;
 	}
 }
 
@@ -458,8 +525,10 @@ AggCtx *Agg_PercContFunc(bool distinct) {
 		return Agg_NewCtx(__agg_percDistinctStep, __agg_percContReduceNext, __agg_PercCtxNew,
 						  __agg_PercCtxFree, distinct);
 	} else {
-		return Agg_NewCtx(__agg_percStep, __agg_percContReduceNext, __agg_PercCtxNew,
-						  __agg_PercCtxFree, distinct);
+		AggCtx *ctx = Agg_NewCtx(__agg_percStep, __agg_percContReduceNext, __agg_PercCtxNew,
+								 __agg_PercCtxFree, distinct);
+		Agg_SetMerge(ctx, __agg_percMerge);
+		return ctx;
 	}
 }
 
@@ -507,6 +576,21 @@ int __agg_StdevDistinctStep(AggCtx *ctx, SIValue *argv, int argc) {
 	return AGG_OK;
 }
 
+int __agg_StdevMerge(AggCtx *ctx, AggCtx *other) {
+	__agg_stdevCtx *ac = Agg_FuncCtx(ctx);
+	__agg_stdevCtx *oc = Agg_FuncCtx(other);
+
+	if(ac->count + oc->count > ac->values_allocated) {
+		ac->values_allocated = ac->count + oc->count;
+		ac->values = rm_realloc(ac->values, sizeof(double) * ac->values_allocated);
+	}
+	memcpy(ac->values + ac->count, oc->values, sizeof(double) * oc->count);
+	ac->count += oc->count;
+	ac->total += oc->total;
+
+	return AGG_OK;
+}
+
 int __agg_StdevReduceNext(AggCtx *ctx) {
 	__agg_stdevCtx *ac = Agg_FuncCtx(ctx);
 
@@ -553,8 +637,10 @@ AggCtx *Agg_StdevFunc(bool distinct) {
 		return Agg_NewCtx(__agg_StdevDistinctStep, __agg_StdevReduceNext, __agg_stdevCtxNew,
 						  __agg_StdevCtxFree, distinct);
 	} else {
-		return Agg_NewCtx(__agg_StdevStep, __agg_StdevReduceNext, __agg_stdevCtxNew,
-						  __agg_StdevCtxFree, distinct);
+		AggCtx *ctx = Agg_NewCtx(__agg_StdevStep, __agg_StdevReduceNext, __agg_stdevCtxNew,
+								 __agg_StdevCtxFree, distinct);
+		Agg_SetMerge(ctx, __agg_StdevMerge);
+		return ctx;
 	}
 }
 
@@ -596,6 +682,14 @@ int __agg_collectDistinctStep(AggCtx *ctx, SIValue *argv, int argc) {
 	return AGG_OK;
 }
 
+int __agg_collectMerge(AggCtx *ctx, AggCtx *other) {
+	__agg_collectCtx *ac = Agg_FuncCtx(ctx);
+	__agg_collectCtx *oc = Agg_FuncCtx(other);
+	uint32_t count = SIArray_Length(oc->list);
+	for(uint32_t i = 0; i < count; i++) SIArray_Append(&ac->list, SIArray_Get(oc->list, i));
+	return AGG_OK;
+}
+
 int __agg_collectReduceNext(AggCtx *ctx) {
 	__agg_collectCtx *ac = Agg_FuncCtx(ctx);
 	/* Share the Collect context's internal list with the caller,
@@ -626,9 +720,138 @@ AggCtx *Agg_CollectFunc(bool distinct) {
 		return Agg_NewCtx(__agg_collectDistinctStep, __agg_collectReduceNext, __agg_collectCtxNew,
 						  __agg_collectCtxFree, distinct);
 	} else {
-		return Agg_NewCtx(__agg_collectStep, __agg_collectReduceNext, __agg_collectCtxNew,
-						  __agg_collectCtxFree, distinct);
+		AggCtx *ctx = Agg_NewCtx(__agg_collectStep, __agg_collectReduceNext, __agg_collectCtxNew,
+								 __agg_collectCtxFree, distinct);
+		Agg_SetMerge(ctx, __agg_collectMerge);
+		return ctx;
+	}
+}
+
+//------------------------------------------------------------------------
+
+typedef struct {
+	HLL *hll;
+} __agg_approxCountDistinctCtx;
+
+int __agg_approxCountDistinctStep(AggCtx *ctx, SIValue *argv, int argc) {
+	assert(argc == 1);
+	__agg_approxCountDistinctCtx *ac = Agg_FuncCtx(ctx);
+	SIValue v = argv[0];
+	if(SIValue_IsNull(v)) return AGG_OK;
+
+	HLL_Add(ac->hll, SIValue_HashCode(v));
+	return AGG_OK;
+}
+
+int __agg_approxCountDistinctMerge(AggCtx *ctx, AggCtx *other) {
+	__agg_approxCountDistinctCtx *ac = Agg_FuncCtx(ctx);
+	__agg_approxCountDistinctCtx *oc = Agg_FuncCtx(other);
+	HLL_Merge(ac->hll, oc->hll);
+	return AGG_OK;
+}
+
+int __agg_approxCountDistinctReduceNext(AggCtx *ctx) {
+	__agg_approxCountDistinctCtx *ac = Agg_FuncCtx(ctx);
+	Agg_SetResult(ctx, SI_LongVal(HLL_Count(ac->hll)));
+	return AGG_OK;
+}
+
+void *__agg_approxCountDistinctCtxNew(AggCtx *ctx) {
+	__agg_approxCountDistinctCtx *ac = rm_malloc(sizeof(__agg_approxCountDistinctCtx));
+	ac->hll = HLL_New();
+	return ac;
+}
+
+void __agg_approxCountDistinctCtxFree(AggCtx *ctx) {
+	__agg_approxCountDistinctCtx *ac = Agg_FuncCtx(ctx);
+	HLL_Free(ac->hll);
+	rm_free(ac);
+}
+
+AggCtx *Agg_ApproxCountDistinctFunc(bool distinct) {
+	// Values are counted once regardless of distinct.
+	AggCtx *ctx = Agg_NewCtx(__agg_approxCountDistinctStep, __agg_approxCountDistinctReduceNext,
+							 __agg_approxCountDistinctCtxNew, __agg_approxCountDistinctCtxFree, distinct);
+	Agg_SetMerge(ctx, __agg_approxCountDistinctMerge);
+	return ctx;
+}
+
+//------------------------------------------------------------------------
+
+typedef struct {
+	double percentile;
+	TDigest *digest;
+} __agg_approxPercCtx;
+
+int __agg_approxPercStep(AggCtx *ctx, SIValue *argv, int argc) {
+	assert(argc == 2);
+	__agg_approxPercCtx *ac = Agg_FuncCtx(ctx);
+
+	// The requested percentile is validated on the first invocation.
+	if(ac->percentile < 0) {
+		if(!SIValue_ToDouble(&argv[1], &ac->percentile)) {
+			return Agg_SetError(ctx,
+								"APPROX_PERCENTILE Could not convert percentile argument to double");
+		}
+		if(ac->percentile < 0 || ac->percentile > 1) {
+			return Agg_SetError(ctx,
+								"APPROX_PERCENTILE Invalid input for percentile is not a valid argument, must be a number in the range 0.0 to 1.0");
+		}
 	}
+
+	SIValue v = argv[0];
+	SIType t = SI_TYPE(v);
+	if(t == T_NULL) return AGG_OK;
+	if(!(t & SI_NUMERIC)) return Agg_SetError(ctx,
+												  "APPROX_PERCENTILE Could not convert upstream value to double");
+
+	double n;
+	SIValue_ToDouble(&v, &n);
+	TDigest_Add(ac->digest, n);
+
+	return AGG_OK;
+}
+
+int __agg_approxPercMerge(AggCtx *ctx, AggCtx *other) {
+	__agg_approxPercCtx *ac = Agg_FuncCtx(ctx);
+	__agg_approxPercCtx *oc = Agg_FuncCtx(other);
+	if(ac->percentile < 0) ac->percentile = oc->percentile;
+	TDigest_Merge(ac->digest, oc->digest);
+	return AGG_OK;
+}
+
+int __agg_approxPercReduceNext(AggCtx *ctx) {
+	__agg_approxPercCtx *ac = Agg_FuncCtx(ctx);
+
+	if(TDigest_Count(ac->digest) == 0) {
+		Agg_SetResult(ctx, SI_NullVal());
+		return AGG_OK;
+	}
+
+	Agg_SetResult(ctx, SI_DoubleVal(TDigest_Quantile(ac->digest, ac->percentile)));
+	return AGG_OK;
+}
+
+void *__agg_approxPercCtxNew(AggCtx *ctx) {
+	__agg_approxPercCtx *ac = rm_malloc(sizeof(__agg_approxPercCtx));
+	// Percentile will be updated by the first call to Step
+	ac->percentile = -1;
+	ac->digest = TDigest_New();
+	return ac;
+}
+
+void __agg_approxPercCtxFree(AggCtx *ctx) {
+	__agg_approxPercCtx *ac = Agg_FuncCtx(ctx);
+	TDigest_Free(ac->digest);
+	rm_free(ac);
+}
+
+AggCtx *Agg_ApproxPercentileFunc(bool distinct) {
+	// Approximate percentiles do not track distinct values.
+	AggCtx *ctx = Agg_NewCtx(__agg_approxPercStep, __agg_approxPercReduceNext, __agg_approxPercCtxNew,
+							 __agg_approxPercCtxFree, distinct);
+	Agg_SetMerge(ctx, __agg_approxPercMerge);
+	return ctx;
 }
 
 //------------------------------------------------------------------------
@@ -644,5 +867,7 @@ void Agg_RegisterFuncs() {
 	Agg_RegisterFunc("stDev", Agg_StdevFunc);
 	Agg_RegisterFunc("stDevP", Agg_StdevPFunc);
 	Agg_RegisterFunc("collect", Agg_CollectFunc);
+	Agg_RegisterFunc("approxCountDistinct", Agg_ApproxCountDistinctFunc);
+	Agg_RegisterFunc("approxPercentile", Agg_ApproxPercentileFunc);
 }
 
@@ -10,6 +10,7 @@
 #include "agg_ctx.h"
 
 typedef AggCtx *(*AggFuncInit)(bool distinct);
+typedef AggCtx *(*AggUDFInit)(bool distinct, void *udf);
 
 AggCtx *Agg_SumFunc(bool distinct);
 AggCtx *Agg_AvgFunc(bool distinct);
@@ -21,6 +22,8 @@ AggCtx *Agg_PercDiscFunc(bool distinct);
 AggCtx *Agg_stDev(bool distinct);
 AggCtx *Agg_StdevPFunc(bool distinct);
 AggCtx *Agg_CollectFunc(bool distinct);
+AggCtx *Agg_ApproxCountDistinctFunc(bool distinct);
+AggCtx *Agg_ApproxPercentileFunc(bool distinct);
 
 void Agg_RegisterFuncs();
 
@@ -6,28 +6,42 @@
 
 #include "aggregate.h"
 #include "../util/rmalloc.h"
+#include <assert.h>
 
 AggCtx *Agg_NewCtx(StepFunc step, FinalizeFunc finalize, AggCtx_PrivateData_New privateDataNew,
 				   AggCtx_PrivateData_Free privateDataFree, bool isDistinct) {
+	return Agg_NewUDFCtx(step, finalize, privateDataNew, privateDataFree, isDistinct, NULL);
+}
+
+AggCtx *Agg_NewUDFCtx(StepFunc step, FinalizeFunc finalize, AggCtx_PrivateData_New privateDataNew,
+					  AggCtx_PrivateData_Free privateDataFree, bool isDistinct, void *udf) {
 	// Allocate.
 	AggCtx *ac = rm_malloc(sizeof(AggCtx));
 	// Set methods.
 	ac->Step = step;
 	ac->Finalize = finalize;
+	ac->Merge = NULL;
 	ac->AggCtx_PrivateData_New = privateDataNew;
 	ac->AggCtx_PrivateData_Free = privateDataFree;
 	// Initialize members.
 	ac->isDistinct = isDistinct;
-	// This member initialization depends on isDistinct.
+	ac->udf = udf;
+	// This member initialization depends on isDistinct and udf.
 	ac->fctx = ac->AggCtx_PrivateData_New(ac);
 	ac->err = NULL;
 	ac->result = SI_NullVal();
 	return ac;
 }
 
+void Agg_SetMerge(AggCtx *ctx, MergeFunc merge) {
+	ctx->Merge = merge;
+}
+
 AggCtx *Agg_CloneCtx(AggCtx *ctx) {
-	return Agg_NewCtx(ctx->Step, ctx->Finalize, ctx->AggCtx_PrivateData_New,
-					  ctx->AggCtx_PrivateData_Free, ctx->isDistinct);
+	AggCtx *clone = Agg_NewUDFCtx(ctx->Step, ctx->Finalize, ctx->AggCtx_PrivateData_New,
+								  ctx->AggCtx_PrivateData_Free, ctx->isDistinct, ctx->udf);
+	clone->Merge = ctx->Merge;
+	return clone;
 }
 
 void AggCtx_Free(AggCtx *ctx) {
@@ -49,6 +63,18 @@ int Agg_Finalize(AggCtx *ctx) {
 	return ctx->Finalize(ctx);
 }
 
+bool Agg_Mergeable(const AggCtx *ctx) {
+	return ctx->Merge != NULL;
+}
+
+int Agg_Merge(AggCtx *ctx, AggCtx *other) {
+	assert(ctx->Merge && ctx->Merge == other->Merge);
+	// Errors raised by either part are reported.
+	if(ctx->err) return AGG_ERR;
+	if(other->err) return Agg_SetError(ctx, other->err);
+	return ctx->Merge(ctx, other);
+}
+
 inline void *Agg_FuncCtx(AggCtx *ctx) {
 	return ctx->fctx;
 }
@@ -24,6 +24,7 @@
 
 typedef int (*StepFunc)(AggCtx *ctx, SIValue *argv, int argc);  // Aggregatoin step function.
 typedef int (*FinalizeFunc)(AggCtx *ctx);                       // Aggregation finalize function.
+typedef int (*MergeFunc)(AggCtx *ctx, AggCtx *other);           // Aggregation merge function.
 // Aggregation context inner data creation function.
 typedef void *(*AggCtx_PrivateData_New)(AggCtx *ctx);
 // Aggregation context inner data free function.
@@ -42,6 +43,24 @@ typedef void (*AggCtx_PrivateData_Free)(AggCtx *ctx);
 AggCtx *Agg_NewCtx(StepFunc step, FinalizeFunc finalize, AggCtx_PrivateData_New privateDataNew,
 				   AggCtx_PrivateData_Free privateDataFree, bool isDistinct);
 
+/**
+ * @brief  Creates a new aggregation context evaluating a user-defined aggregation,
+ *         udf is accessible to privateDataNew and shared by clones of the context.
+ * @param  udf: User-defined aggregation.
+ * @retval New aggregation context.
+ */
+AggCtx *Agg_NewUDFCtx(StepFunc step, FinalizeFunc finalize, AggCtx_PrivateData_New privateDataNew,
+					  AggCtx_PrivateData_Free privateDataFree, bool isDistinct, void *udf);
+
+/**
+ * @brief  Sets the function combining the partial state of an aggregation into another,
+ *         aggregations without a merge function can't be computed in parts.
+ * @param  *ctx: Aggregation context.
+ * @param  merge: Aggregation merge function.
+ * @retval None
+ */
+void Agg_SetMerge(AggCtx *ctx, MergeFunc merge);
+
 /**
  * @brief  Clones an aggregation context. This will duplicate the original context methods
  *         and isDistinct indicator, and will create a new inner data.
@@ -95,4 +114,21 @@ int Agg_Step(AggCtx *ctx, SIValue *argv, int argc);
  * @retval AGG_OK
  */
 int Agg_Finalize(AggCtx *ctx);
+
+/**
+ * @brief  Returns true if partial states of the aggregation can be merged.
+ * @param  *ctx: Aggregation context.
+ * @retval True if the aggregation has a merge function.
+ */
+bool Agg_Mergeable(const AggCtx *ctx);
+
+/**
+ * @brief  Combines the state accumulated by other into ctx, as if ctx had stepped
+ *         through other's values after its own. Both contexts must be of the same function.
+ *         other is left in an unspecified state and should only be freed.
+ * @param  *ctx: Aggregation context.
+ * @param  *other: Aggregation context holding another part of the input.
+ * @retval AGG_OK in case of succsess, AGG_ERR in case of an exception.
+ */
+int Agg_Merge(AggCtx *ctx, AggCtx *other);
 #endif
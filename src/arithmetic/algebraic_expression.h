@@ -39,6 +39,8 @@ struct AlgebraicExpression {
             const char *dest;       // Alias given to operand's columns (destination node).
             const char *edge;       // Alias given to operand (edge).
             const char *label;      // Label attached to matrix.
+            const IDSet *ids;       // Node IDs of a label operand, NULL for other operands.
+            uint64_t *bitmap;       // Entries of a diagonal matrix, built on first selection.
         } operand;
 		struct {
 			AL_EXP_OP op;                       // Operation: `*`,`+`,`transpose`
@@ -108,6 +110,14 @@ const char *AlgebraicExpression_Edge
     const AlgebraicExpression *root   // Root of expression.
 );
 
+/* Collects the relationship types traversed by the expression's operands,
+ * appending their names to the relations array. */
+void AlgebraicExpression_RelationTypes
+(
+    const AlgebraicExpression *root,    // Root of expression.
+    const char ***relations             // Array of relationship type names.
+);
+
 // Returns the number of child nodes directly under root.
 uint AlgebraicExpression_ChildCount
 (
@@ -218,6 +228,17 @@ void AlgebraicExpression_Eval
     GrB_Matrix res                  // Result output.
 );
 
+// Replace the operands trailing the leftmost operand of an evaluated multiplication
+// by their product, e.g. F * A * R * B becomes F * P where P = A * R * B.
+// Applies only if at most one trailing operand isn't diagonal, such that P
+// holds no more entries than that operand, returns false otherwise.
+// The caller owns product and must keep it alive for as long as exp is evaluated.
+bool AlgebraicExpression_MultiplyTrailingOperands
+(
+    AlgebraicExpression *exp,   // Root node, fetched by a previous evaluation.
+    GrB_Matrix *product         // Product of trailing operands.
+);
+
 //------------------------------------------------------------------------------
 // AlgebraicExpression debugging utilities.
 //------------------------------------------------------------------------------
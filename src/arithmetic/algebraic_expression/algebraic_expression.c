@@ -53,8 +53,11 @@ static AlgebraicExpression *_AlgebraicExpression_CloneOperand
 (
 	const AlgebraicExpression *exp
 ) {
-	return AlgebraicExpression_NewOperand(exp->operand.matrix, exp->operand.diagonal, exp->operand.src,
-										  exp->operand.dest, exp->operand.edge, exp->operand.label);
+	AlgebraicExpression *clone = AlgebraicExpression_NewOperand(exp->operand.matrix,
+			exp->operand.diagonal, exp->operand.src, exp->operand.dest, exp->operand.edge,
+			exp->operand.label);
+	clone->operand.ids = exp->operand.ids;
+	return clone;
 }
 
 //------------------------------------------------------------------------------
@@ -91,6 +94,8 @@ AlgebraicExpression *AlgebraicExpression_NewOperand
 	node->operand.dest = dest;
 	node->operand.edge = edge;
 	node->operand.label = label;
+	node->operand.ids = NULL;
+	node->operand.bitmap = NULL;
 	return node;
 }
 
@@ -170,6 +175,30 @@ const char *AlgebraicExpression_Edge
 	return NULL;
 }
 
+void AlgebraicExpression_RelationTypes
+(
+	const AlgebraicExpression *root,    // Root of expression.
+	const char ***relations             // Array of relationship type names.
+) {
+	assert(root && relations);
+
+	uint child_count = 0;
+	switch(root->type) {
+	case AL_OPERATION:
+		child_count = AlgebraicExpression_ChildCount(root);
+		for(uint i = 0; i < child_count; i++) {
+			AlgebraicExpression_RelationTypes(CHILD_AT(root, i), relations);
+		}
+		break;
+	case AL_OPERAND:
+		// Diagonal operands are labels, unlabeled operands aren't of a single type.
+		if(!root->operand.diagonal && root->operand.label) {
+			*relations = array_append(*relations, root->operand.label);
+		}
+		break;
+	}
+}
+
 // Returns the number of child nodes directly under root.
 uint AlgebraicExpression_ChildCount
 (
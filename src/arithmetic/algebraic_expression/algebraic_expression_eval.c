@@ -6,7 +6,13 @@
 
 #include "utils.h"
 #include "../../query_ctx.h"
+#include "../../util/rmalloc.h"
+#include "../../util/matrix_pool.h"
+#include "../../util/graphblas_threads.h"
+#include "../../util/simple_timer.h"
+#include "../../execution_plan/ops/op.h"
 #include "../algebraic_expression.h"
+#include <pthread.h>
 
 // Forward declarations
 GrB_Matrix _AlgebraicExpression_Eval(const AlgebraicExpression *exp, GrB_Matrix res);
@@ -28,7 +34,6 @@ static GrB_Matrix _Eval_Transpose
 static GrB_Matrix _Eval_Add(const AlgebraicExpression *exp, GrB_Matrix res) {
 	assert(exp && AlgebraicExpression_ChildCount(exp) > 1);
 
-	GrB_Info info;
 	GrB_Index nrows;                // Number of rows of operand.
 	GrB_Index ncols;                // Number of columns of operand.
 	GrB_Matrix a = GrB_NULL;        // Left operand.
@@ -38,6 +43,7 @@ static GrB_Matrix _Eval_Add(const AlgebraicExpression *exp, GrB_Matrix res) {
 	bool res_in_use = false;        // Can we use `res` for intermidate evaluation.
 
 	GrB_Descriptor_new(&desc);
+	GraphBLASThreads_SetDescriptor(desc);
 
 	// Get left and right operands.
 	AlgebraicExpression *left = CHILD_AT(exp, 0);
@@ -69,11 +75,7 @@ static GrB_Matrix _Eval_Add(const AlgebraicExpression *exp, GrB_Matrix res) {
 			// `res` is in use, create an additional matrix.
 			GrB_Matrix_nrows(&nrows, a);
 			GrB_Matrix_ncols(&ncols, a);
-			info = GrB_Matrix_new(&inter, GrB_BOOL, nrows, ncols);
-			if(info != GrB_SUCCESS) {
-				fprintf(stderr, "%s", GrB_error());
-				assert(false);
-			}
+			inter = MatrixPool_Acquire(nrows, ncols);
 			b = _AlgebraicExpression_Eval(right, inter);
 		} else {
 			// `res` is not used just yet, use it for RHS evaluation.
@@ -108,24 +110,117 @@ static GrB_Matrix _Eval_Add(const AlgebraicExpression *exp, GrB_Matrix res) {
 				// Can't use `res`, use an intermidate matrix.
 				GrB_Matrix_nrows(&nrows, res);
 				GrB_Matrix_ncols(&ncols, res);
-				GrB_Matrix_new(&inter, GrB_BOOL, nrows, ncols);
+				inter = MatrixPool_Acquire(nrows, ncols);
 			}
 			b = _AlgebraicExpression_Eval(right, inter);
 		}
 
 		// Perform addition.
 		if(GrB_eWiseAdd_Matrix_Semiring(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, res, b,
-										GrB_NULL) != GrB_SUCCESS) {
+										desc) != GrB_SUCCESS) {
 			printf("Failed adding operands, error:%s\n", GrB_error());
 			assert(false);
 		}
 	}
 
-	if(inter != GrB_NULL) GrB_Matrix_free(&inter);
+	MatrixPool_Release(&inter);
 	GrB_free(&desc);
 	return res;
 }
 
+/* Multiplying by a diagonal label matrix keeps the rows (leading diagonal) or
+ * columns (trailing diagonal) of the other operand which the label holds.
+ * Rather than performing mxm, such entries are selected directly by a bitmap
+ * over the label, skipping the computation of entries filtered out anyway. */
+static GxB_SelectOp _select_rows = GrB_NULL;
+static GxB_SelectOp _select_columns = GrB_NULL;
+static pthread_once_t _select_once = PTHREAD_ONCE_INIT;
+
+static inline bool _bitmap_test(const void *thunk, GrB_Index idx) {
+	const uint64_t *bitmap = (const uint64_t *)(*(const uint64_t *)thunk);
+	return bitmap[idx >> 6] & (1ULL << (idx & 63));
+}
+
+static bool _select_row(GrB_Index i, GrB_Index j, GrB_Index nrows, GrB_Index ncols,
+						const void *x, const void *thunk) {
+	return _bitmap_test(thunk, i);
+}
+
+static bool _select_column(GrB_Index i, GrB_Index j, GrB_Index nrows, GrB_Index ncols,
+						   const void *x, const void *thunk) {
+	return _bitmap_test(thunk, j);
+}
+
+static void _init_select_ops(void) {
+	GrB_Info info;
+	info = GxB_SelectOp_new(&_select_rows, _select_row, GrB_NULL, GrB_UINT64);
+	assert(info == GrB_SUCCESS);
+	info = GxB_SelectOp_new(&_select_columns, _select_column, GrB_NULL, GrB_UINT64);
+	assert(info == GrB_SUCCESS);
+}
+
+/* Operands other than boolean ones hold edge IDs, rather than selecting from them
+ * and typecasting their values, such operands are multiplied. */
+static inline bool _Eval_SelectableOperand(GrB_Matrix m) {
+	GrB_Type type;
+	if(m == IDENTITY_MATRIX) return false;
+	GxB_Matrix_type(&type, m);
+	return type == GrB_BOOL;
+}
+
+/* Returns the bitmap of the node IDs held by diagonal operand D.
+ * The bitmap is built on first use and retained by the operand, expressions are
+ * evaluated batch after batch over the same matrices, operands fetched again
+ * are operands of a newly compiled expression. */
+static const uint64_t *_Eval_DiagonalBitmap(AlgebraicExpression *D) {
+	assert(D->type == AL_OPERAND && D->operand.diagonal);
+	if(D->operand.bitmap) return D->operand.bitmap;
+
+	GrB_Index n;
+	GrB_Index nvals;
+	GrB_Matrix M = D->operand.matrix;
+	GrB_Matrix_nrows(&n, M);
+	uint64_t *bitmap = rm_calloc((n + 63) / 64, sizeof(uint64_t));
+
+	if(D->operand.ids) {
+		// Label operand, read the label's node IDs rather than extracting the matrix's tuples.
+		GrB_Index id;
+		IDSetIterator it;
+		IDSet_Iterate(D->operand.ids, &it);
+		while(IDSetIterator_Next(&it, &id)) bitmap[id >> 6] |= 1ULL << (id & 63);
+	} else {
+		GrB_Matrix_nvals(&nvals, M);
+		GrB_Index *ids = rm_malloc(sizeof(GrB_Index) * (nvals + 1));
+		GrB_Matrix_extractTuples_BOOL(ids, GrB_NULL, GrB_NULL, &nvals, M);
+		for(GrB_Index i = 0; i < nvals; i++) bitmap[ids[i] >> 6] |= 1ULL << (ids[i] & 63);
+		rm_free(ids);
+	}
+
+	D->operand.bitmap = bitmap;
+	return bitmap;
+}
+
+// res = D * A when rows is set, res = A * D otherwise, D is a diagonal operand.
+static void _Eval_SelectByDiagonal(GrB_Matrix res, GrB_Matrix A, AlgebraicExpression *D, bool rows,
+								   GrB_Descriptor desc) {
+	pthread_once(&_select_once, _init_select_ops);
+
+	// Bitmap of the label's node IDs.
+	const uint64_t *bitmap = _Eval_DiagonalBitmap(D);
+
+	GxB_Scalar thunk;
+	GxB_Scalar_new(&thunk, GrB_UINT64);
+	GxB_Scalar_setElement_UINT64(thunk, (uint64_t)bitmap);
+	GrB_Info info = GxB_select(res, GrB_NULL, GrB_NULL, rows ? _select_rows : _select_columns,
+							   A, thunk, desc);
+	if(info != GrB_SUCCESS) {
+		fprintf(stderr, "Encountered an error in diagonal selection:\n%s\n", GrB_error());
+		assert(false);
+	}
+
+	GrB_free(&thunk);
+}
+
 static GrB_Matrix _Eval_Mul(const AlgebraicExpression *exp, GrB_Matrix res) {
 	assert(exp &&
 		   AlgebraicExpression_ChildCount(exp) > 1 &&
@@ -139,7 +234,10 @@ static GrB_Matrix _Eval_Mul(const AlgebraicExpression *exp, GrB_Matrix res) {
 	AlgebraicExpression *left = CHILD_AT(exp, 0);
 	AlgebraicExpression *right = CHILD_AT(exp, 1);
 
+	bool transpose_right = false;
+
 	GrB_Descriptor_new(&desc);  // Descriptor used for transposing operands.
+	GraphBLASThreads_SetDescriptor(desc);
 
 	if(left->type == AL_OPERATION) {
 		assert(left->operation.op == AL_EXP_TRANSPOSE);
@@ -152,6 +250,7 @@ static GrB_Matrix _Eval_Mul(const AlgebraicExpression *exp, GrB_Matrix res) {
 		assert(right->operation.op == AL_EXP_TRANSPOSE);
 		GrB_Descriptor_set(desc, GrB_INP1, GrB_TRAN);
 		right = CHILD_AT(right, 0);
+		transpose_right = true;
 	}
 	B = right->operand.matrix;
 
@@ -163,6 +262,17 @@ static GrB_Matrix _Eval_Mul(const AlgebraicExpression *exp, GrB_Matrix res) {
 			fprintf(stderr, "Encountered an error in matrix multiplication:\n%s\n", GrB_error());
 			assert(false);
 		}
+	} else if(right->operand.diagonal && _Eval_SelectableOperand(A)) {
+		// B is a label matrix, select A's columns, A's transpose is described by INP0.
+		_Eval_SelectByDiagonal(res, A, right, false, desc);
+	} else if(left->operand.diagonal && A != IDENTITY_MATRIX && _Eval_SelectableOperand(B)) {
+		// A is a label matrix, select B's rows.
+		GrB_Descriptor select_desc;
+		GrB_Descriptor_new(&select_desc);
+		GraphBLASThreads_SetDescriptor(select_desc);
+		if(transpose_right) GrB_Descriptor_set(select_desc, GrB_INP0, GrB_TRAN);
+		_Eval_SelectByDiagonal(res, B, left, true, select_desc);
+		GrB_free(&select_desc);
 	} else {
 		// Perform multiplication.
 		info = GrB_mxm(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, A, B, desc);
@@ -191,7 +301,10 @@ static GrB_Matrix _Eval_Mul(const AlgebraicExpression *exp, GrB_Matrix res) {
 		}
 		B = right->operand.matrix;
 
-		if(B != IDENTITY_MATRIX) {
+		if(right->operand.diagonal && B != IDENTITY_MATRIX) {
+			// B is a label matrix, select res's columns, INP0 is reset.
+			_Eval_SelectByDiagonal(res, res, right, false, desc);
+		} else if(B != IDENTITY_MATRIX) {
 			// Perform multiplication.
 			info = GrB_mxm(res, GrB_NULL, GrB_NULL, GxB_ANY_PAIR_BOOL, res, B, desc);
 			if(info != GrB_SUCCESS) {
@@ -244,9 +357,79 @@ GrB_Matrix _AlgebraicExpression_Eval(const AlgebraicExpression *exp, GrB_Matrix
 void AlgebraicExpression_Eval(const AlgebraicExpression *exp, GrB_Matrix res) {
 	assert(exp && exp->type == AL_OPERATION);
 
+	// Profiled operations account the evaluation, operand retrieval included.
+	double tic[2];
+	OpStats *stats = op_profiled_stats;
+	if(stats) simple_tic(tic);
+
 	// On first evaluation we need to fetch operands
 	_AlgebraicExpression_FetchOperands((AlgebraicExpression *)exp, QueryCtx_GetGraphCtx(),
 									   QueryCtx_GetGraph());
 
 	_AlgebraicExpression_Eval(exp, res);
+
+	if(stats) {
+		stats->profileMatrixTime += simple_toc(tic);
+		stats->profileMatrixOps++;
+	}
+}
+
+// Returns the operand of a trailing multiplication child, NULL if it can't be multiplied ahead.
+static const AlgebraicExpression *_TrailingOperand(const AlgebraicExpression *child) {
+	if(child->type == AL_OPERATION) {
+		if(child->operation.op != AL_EXP_TRANSPOSE) return NULL;
+		child = FIRST_CHILD(child);
+		if(child->type != AL_OPERAND) return NULL;
+	}
+	GrB_Matrix m = child->operand.matrix;
+	if(m == GrB_NULL || m == IDENTITY_MATRIX) return NULL;
+	return child;
+}
+
+bool AlgebraicExpression_MultiplyTrailingOperands(AlgebraicExpression *exp, GrB_Matrix *product) {
+	assert(exp && product);
+	if(exp->type != AL_OPERATION || exp->operation.op != AL_EXP_MUL) return false;
+
+	uint child_count = AlgebraicExpression_ChildCount(exp);
+	if(child_count < 3) return false;
+
+	// Trailing operands must be fetched, at most one of which isn't diagonal.
+	uint relations = 0;
+	for(uint i = 1; i < child_count; i++) {
+		AlgebraicExpression *child = CHILD_AT(exp, i);
+		const AlgebraicExpression *operand = _TrailingOperand(child);
+		if(operand == NULL) return false;
+		if(child->type == AL_OPERATION || !operand->operand.diagonal) relations++;
+	}
+	if(relations > 1) return false;
+
+	// Product rows and columns, transposed operands swap their dimensions.
+	GrB_Index nrows;
+	GrB_Index ncols;
+	AlgebraicExpression *first = CHILD_AT(exp, 1);
+	AlgebraicExpression *last = CHILD_AT(exp, child_count - 1);
+	if(first->type == AL_OPERATION) GrB_Matrix_ncols(&nrows, FIRST_CHILD(first)->operand.matrix);
+	else GrB_Matrix_nrows(&nrows, first->operand.matrix);
+	if(last->type == AL_OPERATION) GrB_Matrix_nrows(&ncols, FIRST_CHILD(last)->operand.matrix);
+	else GrB_Matrix_ncols(&ncols, last->operand.matrix);
+	const char *src = _TrailingOperand(first)->operand.src;
+	const char *dest = _TrailingOperand(last)->operand.dest;
+
+	// Move trailing operands into a multiplication of their own.
+	AlgebraicExpression *trailing[child_count - 1];
+	for(uint i = child_count - 1; i > 0; i--) {
+		trailing[i - 1] = _AlgebraicExpression_OperationRemoveRightmostChild(exp);
+	}
+	AlgebraicExpression *mul = AlgebraicExpression_NewOperation(AL_EXP_MUL);
+	for(uint i = 0; i < child_count - 1; i++) AlgebraicExpression_AddChild(mul, trailing[i]);
+
+	GrB_Info info = GrB_Matrix_new(product, GrB_BOOL, nrows, ncols);
+	assert(info == GrB_SUCCESS);
+	_Eval_Mul(mul, *product);
+	// Operands don't own their matrices.
+	AlgebraicExpression_Free(mul);
+
+	AlgebraicExpression_AddChild(exp, AlgebraicExpression_NewOperand(*product, false, src, dest,
+																	  NULL, NULL));
+	return true;
 }
@@ -164,6 +164,7 @@ void _AlgebraicExpression_FreeOperand
 	AlgebraicExpression *node
 ) {
 	assert(node && node->type == AL_OPERAND);
+	if(node->operand.bitmap) rm_free(node->operand.bitmap);
 }
 
 // Locate operand at position `operand_idx` counting from left to right.
@@ -206,6 +207,37 @@ AlgebraicExpression *_AlgebraicExpression_GetOperand
 	return __AlgebraicExpression_GetOperand(root, operand_idx, &current_operand_idx);
 }
 
+/* Replaces Transpose(R) with the graph's transposed matrix of relation R,
+ * sparing the evaluation from transposing R.
+ * Returns true if exp was replaced by a transposed operand. */
+static bool _AlgebraicExpression_FetchTransposedOperand(AlgebraicExpression *exp,
+														const GraphContext *gc, Graph *g) {
+	if(exp->operation.op != AL_EXP_TRANSPOSE) return false;
+	assert(AlgebraicExpression_ChildCount(exp) == 1);
+
+	AlgebraicExpression *child = FIRST_CHILD(exp);
+	// Only relation operands have a transposed counterpart maintained by the graph.
+	if(child->type != AL_OPERAND || child->operand.diagonal ||
+	   child->operand.matrix != GrB_NULL) return false;
+
+	GrB_Matrix m;
+	const char *label = child->operand.label;
+	if(label == NULL) {
+		m = Graph_GetTransposedRelationMatrix(g, GRAPH_NO_RELATION);
+	} else {
+		Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_EDGE);
+		if(!s) m = Graph_GetZeroMatrix(g);
+		else m = Graph_GetTransposedRelationMatrix(g, s->id);
+	}
+
+	/* Child's source and destination already describe the transposed matrix,
+	 * replace the transpose operation with its child. */
+	child = _AlgebraicExpression_OperationRemoveRightmostChild(exp);
+	child->operand.matrix = m;
+	_AlgebraicExpression_InplaceRepurpose(exp, child);
+	return true;
+}
+
 void _AlgebraicExpression_FetchOperands(AlgebraicExpression *exp, const GraphContext *gc,
 										Graph *g) {
 	Schema *s = NULL;
@@ -215,6 +247,7 @@ void _AlgebraicExpression_FetchOperands(AlgebraicExpression *exp, const GraphCon
 
 	switch(exp->type) {
 	case AL_OPERATION:
+		if(_AlgebraicExpression_FetchTransposedOperand(exp, gc, g)) break;
 		child_count = AlgebraicExpression_ChildCount(exp);
 		for(uint i = 0; i < child_count; i++) {
 			_AlgebraicExpression_FetchOperands(CHILD_AT(exp, i), gc, g);
@@ -227,8 +260,12 @@ void _AlgebraicExpression_FetchOperands(AlgebraicExpression *exp, const GraphCon
 				m = Graph_GetAdjacencyMatrix(g);
 			} else if(exp->operand.diagonal) {
 				s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
-				if(!s) m = Graph_GetZeroMatrix(g);
-				else m = Graph_GetLabelMatrix(g, s->id);
+				if(!s) {
+					m = Graph_GetZeroMatrix(g);
+				} else {
+					m = Graph_GetLabelMatrix(g, s->id);
+					exp->operand.ids = Graph_GetLabelIDs(g, s->id);
+				}
 			} else {
 				s = GraphContext_GetSchema(gc, label, SCHEMA_EDGE);
 				if(!s) m = Graph_GetZeroMatrix(g);
@@ -14,9 +14,11 @@
 #include "../query_ctx.h"
 #include "../graph/graph.h"
 #include "../util/rmalloc.h"
+#include "../util/string_matcher.h"
 #include "../graph/graphcontext.h"
 #include "../datatypes/temporal_value.h"
 #include "../datatypes/array.h"
+#include "./list_funcs/list_funcs.h"
 
 #include <ctype.h>
 #include <assert.h>
@@ -54,6 +56,10 @@ static AR_ExpNode *_AR_EXP_CloneOperand(AR_ExpNode *exp) {
 		}
 		clone->operand.variadic.entity_prop_idx = exp->operand.variadic.entity_prop_idx;
 		break;
+	case AR_EXP_PARAM:
+		clone->operand.type = AR_EXP_PARAM;
+		clone->operand.param_name = exp->operand.param_name;
+		break;
 	default:
 		assert(false);
 		break;
@@ -133,6 +139,7 @@ bool AR_EXP_PerformDistinct(AR_ExpNode *op) {
 AR_ExpNode *AR_EXP_NewVariableOperandNode(const char *alias, const char *prop) {
 	AR_ExpNode *node = rm_malloc(sizeof(AR_ExpNode));
 	node->resolved_name = NULL;
+	node->program = NULL;
 	node->type = AR_EXP_OPERAND;
 	node->operand.type = AR_EXP_VARIADIC;
 	node->operand.variadic.entity_alias = alias;
@@ -146,12 +153,25 @@ AR_ExpNode *AR_EXP_NewVariableOperandNode(const char *alias, const char *prop) {
 AR_ExpNode *AR_EXP_NewConstOperandNode(SIValue constant) {
 	AR_ExpNode *node = rm_malloc(sizeof(AR_ExpNode));
 	node->resolved_name = NULL;
+	node->program = NULL;
 	node->type = AR_EXP_OPERAND;
 	node->operand.type = AR_EXP_CONSTANT;
+	// Constants may be cached with their plan, outliving the query's transient values.
+	if(constant.allocation == M_TRANSIENT) constant = SI_CloneValue(constant);
 	node->operand.constant = constant;
 	return node;
 }
 
+AR_ExpNode *AR_EXP_NewParameterOperandNode(const char *param_name) {
+	AR_ExpNode *node = rm_malloc(sizeof(AR_ExpNode));
+	node->resolved_name = NULL;
+	node->program = NULL;
+	node->type = AR_EXP_OPERAND;
+	node->operand.type = AR_EXP_PARAM;
+	node->operand.param_name = param_name;
+	return node;
+}
+
 /* Compact tree by evaluating constant expressions
  * e.g. MINUS(X) where X is a constant number will be reduced to
  * a single node with the value -X
@@ -162,7 +182,7 @@ bool AR_EXP_ReduceToScalar(AR_ExpNode **root) {
 			// Root is already a constant
 			return true;
 		}
-		// Root is variadic, no way to reduce.
+		// Root is variadic or a parameter, no way to reduce.
 		return false;
 	} else {
 		// root represents an operation.
@@ -285,7 +305,7 @@ static AR_EXP_Result _AR_EXP_EvaluateFunctionCall(AR_ExpNode *node, const Record
 	}
 
 	/* Evaluate self. */
-	*result = node->op.f->func(sub_trees, node->op.child_count);
+	*result = AR_FuncDesc_Invoke(node->op.f, sub_trees, node->op.child_count);
 
 	if(SIValue_IsNull(*result) && QueryCtx_EncounteredError()) {
 		/* An error was encountered while evaluating this function, and has already been set in
@@ -361,6 +381,23 @@ static AR_EXP_Result _AR_EXP_EvaluateVariadic(AR_ExpNode *node, const Record r,
 	return EVAL_OK;
 }
 
+static AR_EXP_Result _AR_EXP_EvaluateParam(AR_ExpNode *node, SIValue *result) {
+	const char *param_name = node->operand.param_name;
+	rax *params = QueryCtx_GetParams();
+	AR_ExpNode *param_value = raxFind(params, (unsigned char *)param_name, strlen(param_name));
+	if(param_value == raxNotFound) {
+		char *error;
+		asprintf(&error, "Missing parameter %s", param_name);
+		QueryCtx_SetError(error);
+		return EVAL_ERR;
+	}
+	/* The plan now depends on the value of this parameter,
+	 * if this happens while the plan is being built it's specialized for the value. */
+	QueryCtx_SetPlanParam(param_name);
+	// Parameter values are constant expressions, evaluate without a record.
+	return _AR_EXP_Evaluate(param_value, NULL, result);
+}
+
 /* Evaluate an expression tree, placing the calculated value in 'result' and returning
  * whether an error occurred during evaluation. */
 static AR_EXP_Result _AR_EXP_Evaluate(AR_ExpNode *root, const Record r, SIValue *result) {
@@ -376,6 +413,8 @@ static AR_EXP_Result _AR_EXP_Evaluate(AR_ExpNode *root, const Record r, SIValue
 			return res;
 		case AR_EXP_VARIADIC:
 			return _AR_EXP_EvaluateVariadic(root, r, result);
+		case AR_EXP_PARAM:
+			return _AR_EXP_EvaluateParam(root, result);
 		default:
 			assert(false && "Invalid expression type");
 		}
@@ -386,9 +425,354 @@ static AR_EXP_Result _AR_EXP_Evaluate(AR_ExpNode *root, const Record r, SIValue
 	return res;
 }
 
+/* Expressions evaluated against records are compiled into a flat sequence of
+ * instructions over a register file, avoiding the recursive walk per record.
+ * Instructions are laid out in post order, and the children of a function call
+ * occupy consecutive registers starting at the call's own destination, hence
+ * whenever an instruction executes registers [0, dst) are exactly the values
+ * computed so far and not yet consumed. */
+typedef enum {
+	AR_INST_CONSTANT,   // Share a constant value.
+	AR_INST_VARIADIC,   // Fetch an alias or an entity property from the record.
+	AR_INST_PARAM,      // Resolve a query parameter.
+	AR_INST_AGGREGATE,  // Share an aggregation result.
+	AR_INST_CALL,       // Invoke a function over its argument registers.
+	/* Binary operators with an inlined path for numeric operands,
+	 * any other operands are handled as AR_INST_CALL.
+	 * A numeric constant operand is held by the instruction as an immediate. */
+	AR_INST_ADD,
+	AR_INST_SUB,
+	AR_INST_MUL,
+	AR_INST_DIV,
+	AR_INST_MOD,
+	AR_INST_EQ,
+	AR_INST_NE,
+	AR_INST_LT,
+	AR_INST_LE,
+	AR_INST_GT,
+	AR_INST_GE,
+	/* String predicate against a constant pattern, matched by a precompiled
+	 * matcher, any other operands are handled as AR_INST_CALL. */
+	AR_INST_MATCH,
+	/* IN over a constant or parameter list, evaluated once and hashed
+	 * into a lookup, other lists are handled as AR_INST_CALL. */
+	AR_INST_IN,
+} AR_Opcode;
+
+typedef struct {
+	AR_Opcode opcode;         // Operation to perform.
+	uint dst;                 // Destination register, first argument register of calls.
+	AR_ExpNode *node;         // Expression node evaluated by this instruction.
+	int imm_arg;              // Argument held as an immediate, -1 if none, binary operators only.
+	SIValue imm;              // Immediate numeric operand.
+	StringMatcher *matcher;   // Pattern matcher, AR_INST_MATCH only.
+	bool prepared;            // List has been evaluated, AR_INST_IN only.
+	SIValue list;             // Evaluated list, AR_INST_IN only.
+	ListLookup *lookup;       // Lookup over list, AR_INST_IN only.
+} AR_Instruction;
+
+typedef struct AR_Program {
+	AR_Instruction *code;   // Instructions in execution order.
+	uint reg_count;         // Number of registers the program requires.
+} AR_Program;
+
+static AR_Opcode _AR_EXP_CallOpcode(const AR_ExpNode *node) {
+	if(node->op.child_count != 2) return AR_INST_CALL;
+
+	const char *name = node->op.f->name;
+	if(strcmp(name, "add") == 0) return AR_INST_ADD;
+	if(strcmp(name, "sub") == 0) return AR_INST_SUB;
+	if(strcmp(name, "mul") == 0) return AR_INST_MUL;
+	if(strcmp(name, "div") == 0) return AR_INST_DIV;
+	if(strcmp(name, "mod") == 0) return AR_INST_MOD;
+	if(strcmp(name, "eq") == 0) return AR_INST_EQ;
+	if(strcmp(name, "neq") == 0) return AR_INST_NE;
+	if(strcmp(name, "lt") == 0) return AR_INST_LT;
+	if(strcmp(name, "le") == 0) return AR_INST_LE;
+	if(strcmp(name, "gt") == 0) return AR_INST_GT;
+	if(strcmp(name, "ge") == 0) return AR_INST_GE;
+	return AR_INST_CALL;
+}
+
+// Returns a matcher for string predicates over a constant pattern, NULL otherwise.
+static StringMatcher *_AR_EXP_CallMatcher(const AR_ExpNode *node) {
+	if(node->op.child_count != 2) return NULL;
+	const AR_ExpNode *pattern = node->op.children[1];
+	if(pattern->type != AR_EXP_OPERAND || pattern->operand.type != AR_EXP_CONSTANT) return NULL;
+	if(SI_TYPE(pattern->operand.constant) != T_STRING) return NULL;
+
+	StringMatchMode mode;
+	const char *name = node->op.f->name;
+	if(strcmp(name, "contains") == 0) mode = STRING_MATCH_CONTAINS;
+	else if(strcmp(name, "starts with") == 0) mode = STRING_MATCH_PREFIX;
+	else if(strcmp(name, "ends with") == 0) mode = STRING_MATCH_SUFFIX;
+	else return NULL;
+
+	return StringMatcher_New(pattern->operand.constant.stringval, mode);
+}
+
+// Returns true if node is an IN over a constant or a parameter list.
+static bool _AR_EXP_IsListLookup(const AR_ExpNode *node) {
+	if(node->op.child_count != 2 || strcmp(node->op.f->name, "in") != 0) return false;
+	const AR_ExpNode *list = node->op.children[1];
+	return AR_EXP_IsConstant(list) || AR_EXP_IsParameter(list);
+}
+
+// Returns true if node is a numeric constant.
+static inline bool _AR_EXP_IsNumericConstant(const AR_ExpNode *node) {
+	return AR_EXP_IsConstant(node) && (SI_TYPE(node->operand.constant) & SI_NUMERIC);
+}
+
+static void _AR_EXP_CompileNode(AR_ExpNode *node, uint dst, AR_Program *program) {
+	AR_Instruction inst = {.dst = dst, .node = node, .imm_arg = -1, .matcher = NULL, .prepared = false,
+						   .list = SI_NullVal(), .lookup = NULL
+						  };
+	if(dst >= program->reg_count) program->reg_count = dst + 1;
+
+	if(node->type == AR_EXP_OP) {
+		if(node->op.type == AR_OP_AGGREGATE) {
+			inst.opcode = AR_INST_AGGREGATE;
+		} else if(_AR_EXP_IsListLookup(node)) {
+			// The list is evaluated by the instruction itself, only once.
+			_AR_EXP_CompileNode(node->op.children[0], dst, program);
+			if(dst + 1 >= program->reg_count) program->reg_count = dst + 2;
+			inst.opcode = AR_INST_IN;
+		} else {
+			inst.matcher = _AR_EXP_CallMatcher(node);
+			inst.opcode = inst.matcher ? AR_INST_MATCH : _AR_EXP_CallOpcode(node);
+			// Hold a numeric constant operand of a binary operator as an immediate.
+			if(inst.opcode >= AR_INST_ADD && inst.opcode <= AR_INST_GE) {
+				if(_AR_EXP_IsNumericConstant(node->op.children[1])) inst.imm_arg = 1;
+				else if(_AR_EXP_IsNumericConstant(node->op.children[0])) inst.imm_arg = 0;
+			}
+			if(inst.imm_arg != -1) {
+				inst.imm = node->op.children[inst.imm_arg]->operand.constant;
+				// The other operand is computed into the instruction's destination.
+				_AR_EXP_CompileNode(node->op.children[1 - inst.imm_arg], dst, program);
+				if(dst + 1 >= program->reg_count) program->reg_count = dst + 2;
+			} else {
+				for(int i = 0; i < node->op.child_count; i++) {
+					_AR_EXP_CompileNode(node->op.children[i], dst + i, program);
+				}
+			}
+		}
+	} else {
+		switch(node->operand.type) {
+		case AR_EXP_CONSTANT:
+			inst.opcode = AR_INST_CONSTANT;
+			break;
+		case AR_EXP_VARIADIC:
+			inst.opcode = AR_INST_VARIADIC;
+			break;
+		case AR_EXP_PARAM:
+			inst.opcode = AR_INST_PARAM;
+			break;
+		default:
+			assert(false && "Invalid expression type");
+		}
+	}
+
+	program->code = array_append(program->code, inst);
+}
+
+static AR_Program *_AR_EXP_Compile(AR_ExpNode *root) {
+	AR_Program *program = rm_malloc(sizeof(AR_Program));
+	program->code = array_new(AR_Instruction, 8);
+	program->reg_count = 0;
+	_AR_EXP_CompileNode(root, 0, program);
+	return program;
+}
+
+static void _AR_EXP_FreeProgram(AR_Program *program) {
+	uint inst_count = array_len(program->code);
+	for(uint i = 0; i < inst_count; i++) {
+		AR_Instruction *inst = program->code + i;
+		if(inst->matcher) StringMatcher_Free(inst->matcher);
+		if(inst->lookup) ListLookup_Free(inst->lookup);
+		SIValue_Free(inst->list);
+	}
+	array_free(program->code);
+	rm_free(program);
+}
+
+// Numeric comparison, consistent with SIValue_Compare.
+static inline int _AR_EXP_NumericCompare(const SIValue a, const SIValue b) {
+	if(a.type == T_INT64 && b.type == T_INT64) return SAFE_COMPARISON_RESULT(a.longval - b.longval);
+	return SAFE_COMPARISON_RESULT(SI_GET_NUMERIC(a) - SI_GET_NUMERIC(b));
+}
+
+// Evaluate the list of an AR_INST_IN instruction and build its lookup.
+static AR_EXP_Result _AR_EXP_PrepareListLookup(AR_Instruction *inst, const Record r) {
+	SIValue list;
+	if(_AR_EXP_Evaluate(inst->node->op.children[1], r, &list) != EVAL_OK) return EVAL_ERR;
+	SIValue_Persist(&list);
+	inst->list = list;
+	if(SI_TYPE(list) == T_ARRAY) inst->lookup = ListLookup_New(list);
+	inst->prepared = true;
+	return EVAL_OK;
+}
+
+/* Binary operator over numeric operands, consistent with the operators' functions.
+ * Integer operands, the common case, are handled first without conversions. */
+static inline SIValue _AR_EXP_NumericOp(AR_Opcode opcode, const SIValue a, const SIValue b) {
+	if(a.type == T_INT64 && b.type == T_INT64) {
+		int64_t x = a.longval;
+		int64_t y = b.longval;
+		switch(opcode) {
+		case AR_INST_ADD:
+			return SI_LongVal(x + y);
+		case AR_INST_SUB:
+			return SI_LongVal(x - y);
+		case AR_INST_MUL:
+			return SI_LongVal(x * y);
+		case AR_INST_EQ:
+			return SI_BoolVal(x == y);
+		case AR_INST_NE:
+			return SI_BoolVal(x != y);
+		case AR_INST_LT:
+			return SI_BoolVal(x < y);
+		case AR_INST_LE:
+			return SI_BoolVal(x <= y);
+		case AR_INST_GT:
+			return SI_BoolVal(x > y);
+		case AR_INST_GE:
+			return SI_BoolVal(x >= y);
+		default:
+			break;
+		}
+	}
+
+	switch(opcode) {
+	case AR_INST_ADD:
+		return SIValue_Add(a, b);
+	case AR_INST_SUB:
+		return SIValue_Subtract(a, b);
+	case AR_INST_MUL:
+		return SIValue_Multiply(a, b);
+	case AR_INST_DIV:
+		return SIValue_Divide(a, b);
+	case AR_INST_MOD:
+		return SIValue_Modulo(a, b);
+	case AR_INST_EQ:
+		return SI_BoolVal(_AR_EXP_NumericCompare(a, b) == 0);
+	case AR_INST_NE:
+		return SI_BoolVal(_AR_EXP_NumericCompare(a, b) != 0);
+	case AR_INST_LT:
+		return SI_BoolVal(_AR_EXP_NumericCompare(a, b) < 0);
+	case AR_INST_LE:
+		return SI_BoolVal(_AR_EXP_NumericCompare(a, b) <= 0);
+	case AR_INST_GT:
+		return SI_BoolVal(_AR_EXP_NumericCompare(a, b) > 0);
+	case AR_INST_GE:
+		return SI_BoolVal(_AR_EXP_NumericCompare(a, b) >= 0);
+	default:
+		assert(false);
+		return SI_NullVal();
+	}
+}
+
+static AR_EXP_Result _AR_EXP_Run(AR_Program *program, const Record r, SIValue *result) {
+	SIValue regs[program->reg_count];
+	uint inst_count = array_len(program->code);
+	AR_Instruction *inst = NULL;
+
+	for(uint i = 0; i < inst_count; i++) {
+		inst = program->code + i;
+		AR_ExpNode *node = inst->node;
+		SIValue *dst = regs + inst->dst;
+
+		switch(inst->opcode) {
+		case AR_INST_CONSTANT:
+			*dst = SI_ShareValue(node->operand.constant);
+			continue;
+		case AR_INST_VARIADIC:
+			if(_AR_EXP_EvaluateVariadic(node, r, dst) != EVAL_OK) goto error;
+			continue;
+		case AR_INST_PARAM:
+			if(_AR_EXP_EvaluateParam(node, dst) != EVAL_OK) goto error;
+			continue;
+		case AR_INST_AGGREGATE:
+			// The AggCtx will ultimately free its result.
+			*dst = SI_ShareValue(node->op.agg_func->result);
+			continue;
+		case AR_INST_CALL:
+			break;
+		case AR_INST_MATCH:
+			// Null and non-string operands are left to the function.
+			if(SI_TYPE(dst[0]) != T_STRING) break;
+			bool match = StringMatcher_Match(inst->matcher, dst[0].stringval);
+			_AR_EXP_FreeResultsArray(dst, 2);
+			*dst = SI_BoolVal(match);
+			continue;
+		case AR_INST_IN:
+			if(!inst->prepared && _AR_EXP_PrepareListLookup(inst, r) != EVAL_OK) {
+				SIValue_Free(dst[0]);
+				goto error;
+			}
+			if(inst->lookup) {
+				SIValue in = ListLookup_In(inst->lookup, dst[0]);
+				SIValue_Free(dst[0]);
+				*dst = in;
+				continue;
+			}
+			dst[1] = SI_ShareValue(inst->list);
+			break;
+		default: {
+			SIValue a = dst[0];
+			SIValue b = dst[1];
+			if(inst->imm_arg == 0) {
+				a = inst->imm;
+				b = dst[0];
+			} else if(inst->imm_arg == 1) {
+				b = inst->imm;
+			}
+			// Numeric operands pass validation and own no allocations.
+			if((SI_TYPE(a) & SI_NUMERIC) && (SI_TYPE(b) & SI_NUMERIC)) {
+				*dst = _AR_EXP_NumericOp(inst->opcode, a, b);
+				continue;
+			}
+			// Lay out the arguments for the function, numeric immediates own no allocations.
+			dst[0] = a;
+			dst[1] = b;
+			break;
+		}
+		}
+
+		// Invoke the function over its argument registers.
+		AR_FuncDesc *f = node->op.f;
+		int argc = node->op.child_count;
+		SIValue v = SI_NullVal();
+		bool ok = _AR_EXP_ValidateInvocation(f, dst, argc);
+		if(ok) {
+			v = AR_FuncDesc_Invoke(f, dst, argc);
+			// An error encountered by the function has already been set in the QueryCtx.
+			ok = !(SIValue_IsNull(v) && QueryCtx_EncounteredError());
+		}
+		_AR_EXP_FreeResultsArray(dst, argc);
+		if(!ok) goto error;
+		*dst = v;
+	}
+
+	*result = regs[0];
+	return EVAL_OK;
+
+error:
+	// Free the values computed by preceding instructions.
+	_AR_EXP_FreeResultsArray(regs, inst->dst);
+	return EVAL_ERR;
+}
+
 SIValue AR_EXP_Evaluate(AR_ExpNode *root, const Record r) {
 	SIValue result;
-	AR_EXP_Result res = _AR_EXP_Evaluate(root, r, &result);
+	AR_EXP_Result res;
+	if(r != NULL && root->type == AR_EXP_OP && root->op.type == AR_OP_FUNC) {
+		/* Compile on the first evaluation against a record,
+		 * once plan construction is done reducing the tree. */
+		if(root->program == NULL) root->program = _AR_EXP_Compile(root);
+		res = _AR_EXP_Run(root->program, r, &result);
+	} else {
+		res = _AR_EXP_Evaluate(root, r, &result);
+	}
 	if(res != EVAL_OK) {
 		QueryCtx_RaiseRuntimeException();  // Raise an exception if we're in a run-time context.
 		return SI_NullVal(); // Otherwise return NULL; the query-level error will be emitted after cleanup.
@@ -437,6 +821,30 @@ void AR_EXP_Reduce(const AR_ExpNode *root) {
 	}
 }
 
+bool AR_EXP_Mergeable(const AR_ExpNode *root) {
+	if(root->type != AR_EXP_OP) return true;
+	if(root->op.type == AR_OP_AGGREGATE) return Agg_Mergeable(root->op.agg_func);
+	for(int i = 0; i < root->op.child_count; i++) {
+		if(!AR_EXP_Mergeable(root->op.children[i])) return false;
+	}
+	return true;
+}
+
+void AR_EXP_Merge(const AR_ExpNode *root, const AR_ExpNode *other) {
+	if(root->type == AR_EXP_OP) {
+		assert(other->type == AR_EXP_OP && root->op.child_count == other->op.child_count);
+		if(root->op.type == AR_OP_AGGREGATE) {
+			/* Merge. */
+			Agg_Merge(root->op.agg_func, other->op.agg_func);
+		} else {
+			/* Keep searching for aggregation nodes. */
+			for(int i = 0; i < root->op.child_count; i++) {
+				AR_EXP_Merge(root->op.children[i], other->op.children[i]);
+			}
+		}
+	}
+}
+
 void AR_EXP_CollectEntities(AR_ExpNode *root, rax *aliases) {
 	if(root->type == AR_EXP_OP) {
 		for(int i = 0; i < root->op.child_count; i ++) {
@@ -491,6 +899,10 @@ bool inline  AR_EXP_IsConstant(const AR_ExpNode *exp) {
 	return exp->type == AR_EXP_OPERAND && exp->operand.type == AR_EXP_CONSTANT;
 }
 
+bool inline AR_EXP_IsParameter(const AR_ExpNode *exp) {
+	return exp->type == AR_EXP_OPERAND && exp->operand.type == AR_EXP_PARAM;
+}
+
 void _AR_EXP_ToString(const AR_ExpNode *root, char **str, size_t *str_size,
 					  size_t *bytes_written) {
 	/* Make sure there are at least 64 bytes in str. */
@@ -548,6 +960,8 @@ void _AR_EXP_ToString(const AR_ExpNode *root, char **str, size_t *str_size,
 		// Concat Operand node.
 		if(root->operand.type == AR_EXP_CONSTANT) {
 			SIValue_ToString(root->operand.constant, str, str_size, bytes_written);
+		} else if(root->operand.type == AR_EXP_PARAM) {
+			*bytes_written += sprintf((*str + *bytes_written), "$%s", root->operand.param_name);
 		} else {
 			if(root->operand.variadic.entity_prop != NULL) {
 				*bytes_written += sprintf(
@@ -604,6 +1018,7 @@ void AR_EXP_Free(AR_ExpNode *root) {
 	} else if(root->operand.type == AR_EXP_CONSTANT) {
 		SIValue_Free(root->operand.constant);
 	}
+	if(root->program) _AR_EXP_FreeProgram(root->program);
 	rm_free(root);
 }
 
@@ -34,11 +34,13 @@ typedef enum {
 } AR_OPType;
 
 /* AR_OperandNodeType type of leaf node,
- * either a constant: 3, or a variable: node.property. */
+ * either a constant: 3, a variable: node.property,
+ * or a query parameter: $param. */
 typedef enum {
 	AR_EXP_OP_UNKNOWN,
 	AR_EXP_CONSTANT,
 	AR_EXP_VARIADIC,
+	AR_EXP_PARAM,
 } AR_OperandNodeType;
 
 /* Success of an evaluation. */
@@ -70,10 +72,14 @@ typedef struct {
 			int entity_alias_idx;
 			Attribute_ID entity_prop_idx;
 		} variadic;
+		const char *param_name;
 	};
 	AR_OperandNodeType type;
 } AR_OperandNode;
 
+/* Flat instruction sequence compiled from an expression tree. */
+struct AR_Program;
+
 /* AR_ExpNode a node within an arithmetic expression tree,
  * This node can take one of two forms:
  * 1. OpNode
@@ -86,6 +92,8 @@ typedef struct AR_ExpNode {
 	AR_ExpNodeType type;
 	// The string representation of the node, such as the literal string "ID(a) + 5"
 	const char *resolved_name;
+	// Compiled form of the tree rooted at this node, built on first evaluation against a record.
+	struct AR_Program *program;
 } AR_ExpNode;
 
 /* Creates a new Arithmetic expression operation node */
@@ -100,6 +108,10 @@ AR_ExpNode *AR_EXP_NewVariableOperandNode(const char *alias, const char *prop);
 /* Creates a new Arithmetic expression constant operand node */
 AR_ExpNode *AR_EXP_NewConstOperandNode(SIValue constant);
 
+/* Creates a new Arithmetic expression parameter operand node,
+ * the parameter value is resolved from the query context on evaluation. */
+AR_ExpNode *AR_EXP_NewParameterOperandNode(const char *param_name);
+
 /* Returns if the operation is distinct aggregation */
 bool AR_EXP_PerformDistinct(AR_ExpNode *op);
 
@@ -111,6 +123,13 @@ SIValue AR_EXP_Evaluate(AR_ExpNode *root, const Record r);
 void AR_EXP_Aggregate(const AR_ExpNode *root, const Record r);
 void AR_EXP_Reduce(const AR_ExpNode *root);
 
+/* Returns true if every aggregation within the expression can be computed in parts. */
+bool AR_EXP_Mergeable(const AR_ExpNode *root);
+
+/* Combines the aggregations of other, a clone of root which aggregated
+ * a different part of the input, into root's. */
+void AR_EXP_Merge(const AR_ExpNode *root, const AR_ExpNode *other);
+
 /* Utility functions */
 /* Traverse an expression tree and add all entity aliases to a rax. */
 void AR_EXP_CollectEntities(AR_ExpNode *root, rax *aliases);
@@ -135,6 +154,9 @@ bool AR_EXP_ContainsFunc(const AR_ExpNode *root, const char *func);
 /* Returns true if an arithmetic expression node is a constant. */
 bool AR_EXP_IsConstant(const AR_ExpNode *exp);
 
+/* Returns true if an arithmetic expression node is a query parameter. */
+bool AR_EXP_IsParameter(const AR_ExpNode *exp);
+
 /* Generate a heap-allocated name for an arithmetic expression.
  * This routine is only used to name ORDER BY expressions. */
 char *AR_EXP_BuildResolvedName(AR_ExpNode *root);
@@ -7,6 +7,7 @@
 #include "entity_funcs.h"
 #include "../func_desc.h"
 #include "../../util/arr.h"
+#include "../../datatypes/array.h"
 #include "../../query_ctx.h"
 #include "../../graph/graphcontext.h"
 #include "../../graph/entities/node.h"
@@ -19,17 +20,43 @@ SIValue AR_ID(SIValue *argv, int argc) {
 	return SI_LongVal(ENTITY_GET_ID(graph_entity));
 }
 
-/* returns a string representations the label of a node. */
+/* returns a string representations the label of a node,
+ * nodes holding multiple labels are represented by an array of labels. */
 SIValue AR_LABELS(SIValue *argv, int argc) {
 	char *label = "";
 	Node *node = argv[0].ptrval;
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	Graph *g = gc->g;
-	int labelID = Graph_GetNodeLabel(g, ENTITY_GET_ID(node));
+	EntityID id = ENTITY_GET_ID(node);
+	uint label_count = Graph_GetNodeLabels(g, id, NULL, 0);
+	if(label_count > 1) {
+		int labels[label_count];
+		Graph_GetNodeLabels(g, id, labels, label_count);
+		SIValue res = SI_Array(label_count);
+		for(uint i = 0; i < label_count; i++) {
+			SIArray_Append(&res, SI_ConstStringVal(gc->node_schemas[labels[i]]->name));
+		}
+		return res;
+	}
+
+	int labelID = Graph_GetNodeLabel(g, id);
 	if(labelID != GRAPH_NO_LABEL) label = gc->node_schemas[labelID]->name;
 	return SI_ConstStringVal(label);
 }
 
+/* returns true if node is labeled by each of the specified labels. */
+SIValue AR_HAS_LABELS(SIValue *argv, int argc) {
+	if(SIValue_IsNull(argv[0])) return SI_NullVal();
+	Node *node = argv[0].ptrval;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	EntityID id = ENTITY_GET_ID(node);
+	for(int i = 1; i < argc; i++) {
+		Schema *s = GraphContext_GetSchema(gc, argv[i].stringval, SCHEMA_NODE);
+		if(!s || !Graph_IsNodeLabeled(gc->g, id, s->id)) return SI_BoolVal(false);
+	}
+	return SI_BoolVal(true);
+}
+
 /* returns a string representation of the type of a relation. */
 SIValue AR_TYPE(SIValue *argv, int argc) {
 	char *type = "";
@@ -52,9 +79,11 @@ SIValue AR_EXISTS(SIValue *argv, int argc) {
 
 SIValue _AR_NodeDegree(SIValue *argv, int argc, GRAPH_EDGE_DIR dir) {
 	Node *n = (Node *)argv[0].ptrval;
-	Edge *edges = array_new(Edge, 0);
+	NodeID id = ENTITY_GET_ID(n);
 	GraphContext *gc = QueryCtx_GetGraphCtx();
+	uint64_t degree = 0;
 
+	// Edges are counted off the relation matrices, without being retrieved.
 	if(argc > 1) {
 		// We're interested in specific relationship type(s).
 		for(int i = 1; i < argc; i++) {
@@ -65,16 +94,14 @@ SIValue _AR_NodeDegree(SIValue *argv, int argc, GRAPH_EDGE_DIR dir) {
 			if(!s) continue;
 
 			// Accumulate edges.
-			Graph_GetNodeEdges(gc->g, n, dir, s->id, &edges);
+			degree += Graph_GetNodeDegree(gc->g, id, dir, s->id);
 		}
 	} else {
-		// Get all relations, regardless of their type.
-		Graph_GetNodeEdges(gc->g, n, dir, GRAPH_NO_RELATION, &edges);
+		// Count all relations, regardless of their type.
+		degree = Graph_GetNodeDegree(gc->g, id, dir, GRAPH_NO_RELATION);
 	}
 
-	SIValue res = SI_LongVal(array_len(edges));
-	array_free(edges);
-	return res;
+	return SI_LongVal(degree);
 }
 
 /* Returns the number of incoming edges for given node. */
@@ -101,6 +128,12 @@ void Register_EntityFuncs() {
 	func_desc = AR_FuncDescNew("labels", AR_LABELS, 1, 1, types, false);
 	AR_RegFunc(func_desc);
 
+	types = array_new(SIType, 2);
+	types = array_append(types, T_NODE | T_NULL);
+	types = array_append(types, T_STRING);
+	func_desc = AR_FuncDescNew("has_labels", AR_HAS_LABELS, 2, VAR_ARG_LEN, types, false);
+	AR_RegFunc(func_desc);
+
 	types = array_new(SIType, 1);
 	types = array_append(types, T_EDGE);
 	func_desc = AR_FuncDescNew("type", AR_TYPE, 1, 1, types, false);
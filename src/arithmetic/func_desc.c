@@ -35,6 +35,16 @@ AR_FuncDesc *AR_FuncDescNew(const char *name, AR_Func func, uint min_argc, uint
 	desc->max_argc = max_argc;
 	desc->types = types;
 	desc->reducible = reducible;
+	desc->udf = NULL;
+	desc->privdata = NULL;
+	return desc;
+}
+
+AR_FuncDesc *AR_UDFDescNew(const char *name, AR_UDF udf, void *privdata, uint min_argc,
+						   uint max_argc, SIType *types, bool reducible) {
+	AR_FuncDesc *desc = AR_FuncDescNew(name, NULL, min_argc, max_argc, types, reducible);
+	desc->udf = udf;
+	desc->privdata = privdata;
 	return desc;
 }
 
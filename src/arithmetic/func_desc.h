@@ -14,6 +14,9 @@
 /* AR_Func - Function pointer to an operation with an arithmetic expression */
 typedef SIValue(*AR_Func)(SIValue *argv, int argc);
 
+/* AR_UDF - Function pointer to a user-defined function, receiving its descriptor's private data */
+typedef SIValue(*AR_UDF)(SIValue *argv, int argc, void *privdata);
+
 typedef struct {
 	uint min_argc;      // Minimal number of arguments function expects
 	uint max_argc;      // Maximal number of arguments function expects
@@ -21,14 +24,26 @@ typedef struct {
 	SIType *types;      // Types of arguments.
 	const char *name;   // Function name.
 	bool reducible;     // Can be reduced using static evaluation.
+	AR_UDF udf;         // User-defined function invoked in place of func, NULL for built-ins.
+	void *privdata;     // Private data passed to udf.
 } AR_FuncDesc;
 
 AR_FuncDesc *AR_FuncDescNew(const char *name, AR_Func func, uint min_argc, uint max_argc,
 							SIType *types, bool reducible);
 
+/* Create a descriptor of a user-defined function. */
+AR_FuncDesc *AR_UDFDescNew(const char *name, AR_UDF udf, void *privdata, uint min_argc,
+						   uint max_argc, SIType *types, bool reducible);
+
 /* Register arithmetic function to repository. */
 void AR_RegFunc(AR_FuncDesc *func);
 
+/* Invoke function over its arguments. */
+static inline SIValue AR_FuncDesc_Invoke(const AR_FuncDesc *func, SIValue *argv, int argc) {
+	if(func->udf) return func->udf(argv, argc, func->privdata);
+	return func->func(argv, argc);
+}
+
 /* Retrieves an arithmetic function by its name. */
 AR_FuncDesc *AR_GetFunc(const char *func_name);
 
@@ -23,6 +23,7 @@ void AR_RegisterFuncs() {
 	Register_BooleanFuncs();
 	Register_ConditionalFuncs();
 	Register_PathFuncs();
+	Register_PointFuncs();
 	Register_PlaceholderFuncs();
 }
 
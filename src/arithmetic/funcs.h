@@ -14,6 +14,7 @@
 #include "numeric_funcs/numeric_funcs.h"
 #include "conditional_funcs/conditional_funcs.h"
 #include "path_funcs/path_funcs.h"
+#include "point_funcs/point_funcs.h"
 #include "placeholder_funcs/placeholder_funcs.h"
 
 /* Registers all arithmetic functions. */
@@ -133,6 +133,64 @@ SIValue AR_IN(SIValue *argv, int argc) {
 	return comparedNull ? SI_NullVal() : SI_BoolVal(false);
 }
 
+// Element types a list lookup hashes, all of which hash consistently with equality.
+#define LIST_LOOKUP_TYPES (SI_NUMERIC | T_STRING | T_BOOL | T_NULL)
+
+ListLookup *ListLookup_New(SIValue list) {
+	assert(SI_TYPE(list) == T_ARRAY);
+	uint len = SIArray_Length(list);
+	for(uint i = 0; i < len; i++) {
+		if(!(SI_TYPE(SIArray_Get(list, i)) & LIST_LOOKUP_TYPES)) return NULL;
+	}
+
+	ListLookup *lookup = rm_malloc(sizeof(ListLookup));
+	lookup->list = list;
+	lookup->elements = raxNew();
+	lookup->contains_null = false;
+	for(uint i = 0; i < len; i++) {
+		SIValue v = SIArray_Get(list, i);
+		if(SIValue_IsNull(v)) {
+			lookup->contains_null = true;
+			continue;
+		}
+		// Duplicates map to their first occurrence.
+		unsigned long long const hash = SIValue_HashCode(v);
+		raxTryInsert(lookup->elements, (unsigned char *)&hash, sizeof(hash),
+					 (void *)(uintptr_t)i, NULL);
+	}
+	return lookup;
+}
+
+SIValue ListLookup_In(const ListLookup *lookup, SIValue v) {
+	// Null compares as null against every element.
+	if(SIValue_IsNull(v)) {
+		return (SIArray_Length(lookup->list) > 0) ? SI_NullVal() : SI_BoolVal(false);
+	}
+
+	if(SI_TYPE(v) & LIST_LOOKUP_TYPES) {
+		unsigned long long const hash = SIValue_HashCode(v);
+		void *pos = raxFind(lookup->elements, (unsigned char *)&hash, sizeof(hash));
+		if(pos != raxNotFound) {
+			int disjointOrNull = 0;
+			SIValue element = SIArray_Get(lookup->list, (uintptr_t)pos);
+			if(SIValue_Compare(v, element, &disjointOrNull) == 0 && disjointOrNull == 0) {
+				return SI_BoolVal(true);
+			}
+			// Hash collision, fall back to scanning the list.
+			SIValue argv[2] = {v, lookup->list};
+			return AR_IN(argv, 2);
+		}
+	}
+
+	// Other types are disjoint from every element.
+	return lookup->contains_null ? SI_NullVal() : SI_BoolVal(false);
+}
+
+void ListLookup_Free(ListLookup *lookup) {
+	raxFree(lookup->elements);
+	rm_free(lookup);
+}
+
 /* Return a list/string/map/path size.
    "RETURN size([1, 2, 3])" will return 3
    TODO: when map and path are implemented, add their functionality */
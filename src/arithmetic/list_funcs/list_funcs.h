@@ -6,6 +6,26 @@
 
 #pragma once
 
+#include "rax.h"
 #include "../../value.h"
 
+/* A list lookup answers `v IN list` for many values against the same constant
+ * list, hashing the list's elements once rather than scanning it per value.
+ * Lookups agree with the IN function. */
+typedef struct {
+	SIValue list;        // Looked up list, not owned by the lookup.
+	rax *elements;       // Maps element hash codes to element positions.
+	bool contains_null;  // List contains a null element.
+} ListLookup;
+
+/* Create a lookup over list, returns NULL if list holds elements
+ * which aren't hashed, i.e. any but numerics, strings, booleans and nulls. */
+ListLookup *ListLookup_New(SIValue list);
+
+// Evaluates `v IN list`.
+SIValue ListLookup_In(const ListLookup *lookup, SIValue v);
+
+// Free lookup.
+void ListLookup_Free(ListLookup *lookup);
+
 void Register_ListFuncs();
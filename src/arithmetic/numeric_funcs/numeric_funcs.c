@@ -8,6 +8,7 @@
 #include "../func_desc.h"
 #include "../../util/arr.h"
 #include "../../util/rmalloc.h"
+#include "../../query_ctx.h"
 
 #include <math.h>
 #include <errno.h>
@@ -21,6 +22,16 @@ static inline int _validate_numeric(const SIValue v) {
 /* The '+' operator is overloaded to perform string concatenation
  * as well as arithmetic addition. */
 SIValue AR_ADD(SIValue *argv, int argc) {
+	// Concatenated strings are scoped to the query.
+	if(SI_TYPE(argv[0]) == T_STRING && SI_TYPE(argv[1]) == T_STRING) {
+		size_t a_len = strlen(argv[0].stringval);
+		size_t b_len = strlen(argv[1].stringval);
+		char *str;
+		SIValue v = QueryCtx_NewTransientString(a_len + b_len, &str);
+		memcpy(str, argv[0].stringval, a_len);
+		memcpy(str + a_len, argv[1].stringval, b_len + 1);
+		return v;
+	}
 	return SIValue_Add(argv[0], argv[1]);
 }
 
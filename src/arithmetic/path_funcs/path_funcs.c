@@ -23,7 +23,7 @@ SIValue AR_TOPATH(SIValue *argv, int argc) {
 	const cypher_astnode_t *ast_path = argv[0].ptrval;
 	uint nelements = cypher_ast_pattern_path_nelements(ast_path);
 	assert(argc == (nelements + 1));
-	SIValue path = SIPathBuilder_New(nelements);
+	Path *path = SIPathBuilder_New(nelements);
 	for(uint i = 0; i < nelements; i++) {
 		SIValue element = argv[i + 1];
 		if(i % 2 == 0) {
@@ -51,7 +51,7 @@ SIValue AR_TOPATH(SIValue *argv, int argc) {
 			}
 		}
 	}
-	return path;
+	return SIPathBuilder_Build(path);
 }
 
 SIValue AR_PATH_NODES(SIValue *argv, int argc) {
@@ -0,0 +1,50 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "point_funcs.h"
+#include "../func_desc.h"
+#include "../../util/arr.h"
+#include "../../query_ctx.h"
+#include "../../datatypes/point.h"
+
+/* Returns a point at the given latitude and longitude, in degrees. */
+SIValue AR_POINT(SIValue *argv, int argc) {
+	if(SIValue_IsNull(argv[0]) || SIValue_IsNull(argv[1])) return SI_NullVal();
+
+	double latitude = SI_GET_NUMERIC(argv[0]);
+	double longitude = SI_GET_NUMERIC(argv[1]);
+	if(!Point_ValidCoordinates(latitude, longitude)) {
+		char *error;
+		asprintf(&error, "ArgumentError: point() requires latitude within [-90, 90] and longitude within [-180, 180]");
+		QueryCtx_SetError(error);
+		QueryCtx_RaiseRuntimeException();
+		return SI_NullVal();
+	}
+	return SI_Point(latitude, longitude);
+}
+
+/* Returns the great-circle distance between two points, in meters. */
+SIValue AR_DISTANCE(SIValue *argv, int argc) {
+	if(SIValue_IsNull(argv[0]) || SIValue_IsNull(argv[1])) return SI_NullVal();
+	return SI_DoubleVal(Point_Distance(argv[0], argv[1]));
+}
+
+void Register_PointFuncs() {
+	SIType *types;
+	AR_FuncDesc *func_desc;
+
+	types = array_new(SIType, 2);
+	types = array_append(types, SI_NUMERIC | T_NULL);
+	types = array_append(types, SI_NUMERIC | T_NULL);
+	func_desc = AR_FuncDescNew("point", AR_POINT, 2, 2, types, true);
+	AR_RegFunc(func_desc);
+
+	types = array_new(SIType, 2);
+	types = array_append(types, T_POINT | T_NULL);
+	types = array_append(types, T_POINT | T_NULL);
+	func_desc = AR_FuncDescNew("distance", AR_DISTANCE, 2, 2, types, true);
+	AR_RegFunc(func_desc);
+}
@@ -6,6 +6,6 @@
 
 #pragma once
 
-#include "../ast.h"
+#include "../../value.h"
 
-void AST_AnnotateParams(AST *ast);
+void Register_PointFuncs();
@@ -0,0 +1,85 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+/* Public ABI of user-defined function plug-ins.
+ * A plug-in is a shared library loaded with the LOADFUNC module argument,
+ * it includes this header alone and exports RedisGraph_UDF_OnLoad,
+ * through which it registers its scalar and aggregate functions.
+ * See docs/udf.md for details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Version of the ABI described by this header.
+#define GRAPH_UDF_API_VERSION 1
+
+// Status codes returned by plug-in callbacks and registration functions.
+#define GRAPH_UDF_OK 0
+#define GRAPH_UDF_ERR 1
+
+// Scalar function flags.
+#define GRAPH_UDF_DETERMINISTIC 0x1 // Same arguments always produce the same result.
+
+// Name of the symbol every plug-in exports.
+#define GRAPH_UDF_ONLOAD "RedisGraph_UDF_OnLoad"
+
+typedef enum {
+	GRAPH_UDF_NULL,
+	GRAPH_UDF_INTEGER,
+	GRAPH_UDF_DOUBLE,
+	GRAPH_UDF_BOOLEAN,
+	GRAPH_UDF_STRING,
+	GRAPH_UDF_ERROR,    // Returned by a function failing with the message held in string.
+} GraphUDFType;
+
+/* A value exchanged with a plug-in.
+ * Argument strings are valid for the duration of the call,
+ * returned strings are copied and must remain valid until the function returns again
+ * on the same thread, e.g. a static or thread local buffer. */
+typedef struct {
+	GraphUDFType type;
+	union {
+		int64_t integer;
+		double number;
+		bool boolean;
+		const char *string;
+	};
+} GraphUDFValue;
+
+/* Scalar function, invoked once per evaluation with its arguments.
+ * privdata is the pointer supplied at registration.
+ * Functions are invoked concurrently by query threads and must be thread safe. */
+typedef GraphUDFValue(*GraphUDFScalarFunc)(const GraphUDFValue *argv, int argc, void *privdata);
+
+/* Aggregate function, each group of an aggregation holds a state of its own,
+ * a state is only accessed by a single thread at a time. */
+typedef struct {
+	void *(*init)(void *privdata);                // Create a state.
+	int (*step)(void *state, const GraphUDFValue *argv, int argc, const char **err);  // Fold a row's arguments into the state.
+	GraphUDFValue(*finalize)(void *state);        // Compute the result of the state.
+	void (*free)(void *state);                    // Free a state.
+} GraphUDFAggregate;
+
+// Registration functions handed to the plug-in.
+typedef struct {
+	int version;    // GRAPH_UDF_API_VERSION of the module.
+
+	/* Register a scalar function accepting between min_argc and max_argc arguments,
+	 * a negative max_argc accepts any number of arguments.
+	 * Fails if the name is already taken or longer than 31 characters. */
+	int (*RegisterScalar)(const char *name, GraphUDFScalarFunc func, int min_argc, int max_argc,
+						  int flags, void *privdata);
+
+	/* Register an aggregate function, agg is copied.
+	 * Fails if the name is already taken or longer than 31 characters. */
+	int (*RegisterAggregate)(const char *name, const GraphUDFAggregate *agg, void *privdata);
+} GraphUDFRegistry;
+
+/* Entry point of a plug-in, registers its functions.
+ * Returning anything but GRAPH_UDF_OK fails loading the module. */
+typedef int (*GraphUDFOnLoad)(const GraphUDFRegistry *registry);
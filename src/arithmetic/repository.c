@@ -10,6 +10,13 @@
 #include <ctype.h>
 #include <assert.h>
 
+// Registered aggregation, either built-in or user-defined.
+typedef struct {
+	AggFuncInit init;
+	AggUDFInit udf_init;
+	void *udf;
+} AggFuncEntry;
+
 static rax *__aggRegisteredFuncs = NULL;
 
 static void inline _toLower(const char *str, char *lower, short *lower_len) {
@@ -31,12 +38,28 @@ static void __agg_initRegistry() {
 	}
 }
 
-void Agg_RegisterFunc(const char *name, AggFuncInit f) {
+static void _Agg_RegisterEntry(const char *name, AggFuncInit init, AggUDFInit udf_init, void *udf) {
 	__agg_initRegistry();
 	char lower_func_name[32] = {0};
 	short lower_func_name_len = 32;
 	_toLower(name, &lower_func_name[0], &lower_func_name_len);
-	raxInsert(__aggRegisteredFuncs, (unsigned char *)lower_func_name, lower_func_name_len, f, NULL);
+
+	AggFuncEntry *entry = rm_malloc(sizeof(AggFuncEntry));
+	entry->init = init;
+	entry->udf_init = udf_init;
+	entry->udf = udf;
+	AggFuncEntry *old = NULL;
+	raxInsert(__aggRegisteredFuncs, (unsigned char *)lower_func_name, lower_func_name_len, entry,
+			  (void **)&old);
+	if(old) rm_free(old);
+}
+
+void Agg_RegisterFunc(const char *name, AggFuncInit f) {
+	_Agg_RegisterEntry(name, f, NULL, NULL);
+}
+
+void Agg_RegisterUDF(const char *name, AggUDFInit f, void *udf) {
+	_Agg_RegisterEntry(name, NULL, f, udf);
 }
 
 bool Agg_FuncExists(const char *name) {
@@ -56,8 +79,10 @@ void Agg_GetFunc(const char *name, bool distinct, AggCtx **ctx) {
 	char lower_func_name[32] = {0};
 	short lower_func_name_len = 32;
 	_toLower(name, &lower_func_name[0], &lower_func_name_len);
-	AggFuncInit f = raxFind(__aggRegisteredFuncs, (unsigned char *)lower_func_name,
-							lower_func_name_len);
-	if(f != raxNotFound) *ctx = f(distinct);
+	AggFuncEntry *entry = raxFind(__aggRegisteredFuncs, (unsigned char *)lower_func_name,
+								  lower_func_name_len);
+	if(entry == raxNotFound) return;
+	if(entry->init) *ctx = entry->init(distinct);
+	else *ctx = entry->udf_init(distinct, entry->udf);
 }
 
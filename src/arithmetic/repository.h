@@ -15,4 +15,6 @@
 void Agg_GetFunc(const char *name, bool distinct, AggCtx **ctx);
 bool Agg_FuncExists(const char *name);
 void Agg_RegisterFunc(const char *name, AggFuncInit f);
+/* Register a user-defined aggregation, f creates its contexts, receiving udf. */
+void Agg_RegisterUDF(const char *name, AggUDFInit f, void *udf);
 #endif
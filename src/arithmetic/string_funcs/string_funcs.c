@@ -8,9 +8,19 @@
 #include "../func_desc.h"
 #include "../../util/arr.h"
 #include "../../util/rmalloc.h"
+#include "../../query_ctx.h"
 #include <ctype.h>
 #include <assert.h>
 
+// Copies len characters of str into a string scoped to the current query.
+static inline SIValue _transientCopy(const char *str, size_t len) {
+	char *copy;
+	SIValue v = QueryCtx_NewTransientString(len, &copy);
+	memcpy(copy, str, len);
+	copy[len] = '\0';
+	return v;
+}
+
 static inline void _toLower(const char *str, char *lower, size_t lower_len) {
 	size_t i = 0;
 	for(; i < lower_len; i++) lower[i] = tolower(str[i]);
@@ -28,14 +38,10 @@ SIValue AR_LEFT(SIValue *argv, int argc) {
 	if(SIValue_IsNull(argv[0])) return SI_NullVal();
 
 	int64_t newlen = argv[1].longval;
-	if(strlen(argv[0].stringval) <= newlen) {
-		// No need to truncate this string based on the requested length
-		return SI_DuplicateStringVal(argv[0].stringval);
-	}
-	char *left_str = rm_malloc((newlen + 1) * sizeof(char));
-	strncpy(left_str, argv[0].stringval, newlen * sizeof(char));
-	left_str[newlen] = '\0';
-	return SI_TransferStringVal(left_str);
+	size_t len = strlen(argv[0].stringval);
+	// No need to truncate this string based on the requested length
+	if(len <= newlen) return _transientCopy(argv[0].stringval, len);
+	return _transientCopy(argv[0].stringval, newlen);
 }
 
 /* returns the original string with leading whitespace removed. */
@@ -48,7 +54,7 @@ SIValue AR_LTRIM(SIValue *argv, int argc) {
 		trimmed ++;
 	}
 
-	return SI_DuplicateStringVal(trimmed);
+	return _transientCopy(trimmed, strlen(trimmed));
 }
 
 /* returns a string containing the specified number of rightmost characters of the original string. */
@@ -56,13 +62,14 @@ SIValue AR_RIGHT(SIValue *argv, int argc) {
 	if(SIValue_IsNull(argv[0])) return SI_NullVal();
 
 	int64_t newlen = argv[1].longval;
-	int64_t start = strlen(argv[0].stringval) - newlen;
+	int64_t len = strlen(argv[0].stringval);
+	int64_t start = len - newlen;
 
 	if(start <= 0) {
 		// No need to truncate this string based on the requested length
-		return SI_DuplicateStringVal(argv[0].stringval);
+		return _transientCopy(argv[0].stringval, len);
 	}
-	return SI_DuplicateStringVal(argv[0].stringval + start);
+	return _transientCopy(argv[0].stringval + start, newlen);
 }
 
 /* returns the original string with trailing whitespace removed. */
@@ -76,11 +83,7 @@ SIValue AR_RTRIM(SIValue *argv, int argc) {
 		i --;
 	}
 
-	char *trimmed = rm_malloc((i + 1) * sizeof(char));
-	strncpy(trimmed, str, i);
-	trimmed[i] = '\0';
-
-	return SI_TransferStringVal(trimmed);
+	return _transientCopy(str, i);
 }
 
 /* returns a string in which the order of all characters in the original string have been reversed. */
@@ -88,7 +91,8 @@ SIValue AR_REVERSE(SIValue *argv, int argc) {
 	if(SIValue_IsNull(argv[0])) return SI_NullVal();
 	char *str = argv[0].stringval;
 	size_t str_len = strlen(str);
-	char *reverse = rm_malloc((str_len + 1) * sizeof(char));
+	char *reverse;
+	SIValue v = QueryCtx_NewTransientString(str_len, &reverse);
 
 	int i = str_len - 1;
 	int j = 0;
@@ -96,7 +100,7 @@ SIValue AR_REVERSE(SIValue *argv, int argc) {
 		reverse[j++] = str[i--];
 	}
 	reverse[j] = '\0';
-	return SI_TransferStringVal(reverse);
+	return v;
 }
 
 /* returns a substring of the original string, beginning with a 0-based index start and length. */
@@ -132,11 +136,7 @@ SIValue AR_SUBSTRING(SIValue *argv, int argc) {
 		}
 	}
 
-	char *substring = rm_malloc((length + 1) * sizeof(char));
-	strncpy(substring, original + start, length);
-	substring[length] = '\0';
-
-	return SI_TransferStringVal(substring);
+	return _transientCopy(original + start, length);
 }
 
 /* returns the original string in lowercase. */
@@ -144,9 +144,10 @@ SIValue AR_TOLOWER(SIValue *argv, int argc) {
 	if(SIValue_IsNull(argv[0])) return SI_NullVal();
 	char *original = argv[0].stringval;
 	short lower_len = strlen(original);
-	char *lower = rm_malloc((lower_len + 1) * sizeof(char));
+	char *lower;
+	SIValue v = QueryCtx_NewTransientString(lower_len, &lower);
 	_toLower(original, lower, lower_len);
-	return SI_TransferStringVal(lower);
+	return v;
 }
 
 /* returns the original string in uppercase. */
@@ -154,14 +155,23 @@ SIValue AR_TOUPPER(SIValue *argv, int argc) {
 	if(SIValue_IsNull(argv[0])) return SI_NullVal();
 	char *original = argv[0].stringval;
 	size_t upper_len = strlen(original);
-	char *upper = rm_malloc((upper_len + 1) * sizeof(char));
+	char *upper;
+	SIValue v = QueryCtx_NewTransientString(upper_len, &upper);
 	_toUpper(original, upper, upper_len);
-	return SI_TransferStringVal(upper);
+	return v;
 }
 
 /* converts an integer, float or boolean value to a string. */
 SIValue AR_TOSTRING(SIValue *argv, int argc) {
 	if(SIValue_IsNull(argv[0])) return SI_NullVal();
+	SIValue v = argv[0];
+	// Strings and integers are of known length.
+	if(SI_TYPE(v) == T_STRING) return _transientCopy(v.stringval, strlen(v.stringval));
+	if(SI_TYPE(v) == T_INT64) {
+		char buf[32];
+		int n = snprintf(buf, sizeof(buf), "%lld", (long long)v.longval);
+		return _transientCopy(buf, n);
+	}
 	size_t len = SIValue_StringJoinLen(argv, 1, "");
 	char *str = rm_malloc(len * sizeof(char));
 	size_t bytesWritten = 0;
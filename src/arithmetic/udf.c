@@ -0,0 +1,270 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "udf.h"
+#include "redisgraph_udf.h"
+#include "func_desc.h"
+#include "aggregate.h"
+#include "repository.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/set.h"
+#include "../datatypes/array.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <string.h>
+
+// Registered function names are shorter than 32 characters.
+#define UDF_MAX_NAME_LEN 31
+
+// Types of values exchanged with plug-ins.
+#define UDF_TYPES (SI_NUMERIC | T_STRING | T_BOOL | T_NULL)
+
+typedef struct {
+	char *name;
+	GraphUDFScalarFunc func;
+	void *privdata;
+} UDFScalar;
+
+typedef struct {
+	char *name;
+	GraphUDFAggregate agg;
+	void *privdata;
+} UDFAggregate;
+
+// Private data of an aggregation context evaluating a user-defined aggregation.
+typedef struct {
+	void *state;    // Plug-in state of the aggregation.
+	set *hashSet;   // Arguments seen by a distinct aggregation.
+} UDFAggregateCtx;
+
+static GraphUDFValue _UDF_ToValue(SIValue v) {
+	GraphUDFValue u;
+	switch(SI_TYPE(v)) {
+	case T_INT64:
+		u.type = GRAPH_UDF_INTEGER;
+		u.integer = v.longval;
+		break;
+	case T_DOUBLE:
+		u.type = GRAPH_UDF_DOUBLE;
+		u.number = v.doubleval;
+		break;
+	case T_BOOL:
+		u.type = GRAPH_UDF_BOOLEAN;
+		u.boolean = v.longval;
+		break;
+	case T_STRING:
+		u.type = GRAPH_UDF_STRING;
+		u.string = v.stringval;
+		break;
+	default:
+		u.type = GRAPH_UDF_NULL;
+		break;
+	}
+	return u;
+}
+
+/* Convert a value returned by a plug-in, strings are copied to the query's transient arena
+ * unless the value outlives its evaluation.
+ * Returns false and sets the query error if the plug-in reported an error. */
+static bool _UDF_FromValue(const char *name, GraphUDFValue u, bool transient, SIValue *v) {
+	switch(u.type) {
+	case GRAPH_UDF_INTEGER:
+		*v = SI_LongVal(u.integer);
+		return true;
+	case GRAPH_UDF_DOUBLE:
+		*v = SI_DoubleVal(u.number);
+		return true;
+	case GRAPH_UDF_BOOLEAN:
+		*v = SI_BoolVal(u.boolean);
+		return true;
+	case GRAPH_UDF_STRING:
+		if(u.string == NULL) {
+			*v = SI_NullVal();
+		} else if(transient) {
+			size_t len = strlen(u.string);
+			char *copy;
+			*v = QueryCtx_NewTransientString(len, &copy);
+			memcpy(copy, u.string, len + 1);
+		} else {
+			*v = SI_DuplicateStringVal(u.string);
+		}
+		return true;
+	case GRAPH_UDF_ERROR: {
+		char *error;
+		if(u.string) asprintf(&error, "%s", u.string);
+		else asprintf(&error, "User-defined function '%s' failed", name);
+		QueryCtx_SetError(error);
+		*v = SI_NullVal();
+		return false;
+	}
+	default:
+		*v = SI_NullVal();
+		return true;
+	}
+}
+
+static SIValue _UDF_InvokeScalar(SIValue *argv, int argc, void *privdata) {
+	UDFScalar *udf = privdata;
+	// Arguments were validated to be of UDF_TYPES.
+	GraphUDFValue args[argc + 1];
+	for(int i = 0; i < argc; i++) args[i] = _UDF_ToValue(argv[i]);
+
+	SIValue v;
+	// A reported error has been set in the QueryCtx.
+	_UDF_FromValue(udf->name, udf->func(args, argc, udf->privdata), true, &v);
+	return v;
+}
+
+static void *_UDF_AggCtxNew(AggCtx *ctx) {
+	UDFAggregate *udf = ctx->udf;
+	UDFAggregateCtx *ac = rm_malloc(sizeof(UDFAggregateCtx));
+	ac->state = udf->agg.init(udf->privdata);
+	ac->hashSet = (ctx->isDistinct) ? Set_New() : NULL;
+	return ac;
+}
+
+static void _UDF_AggCtxFree(AggCtx *ctx) {
+	UDFAggregate *udf = ctx->udf;
+	UDFAggregateCtx *ac = Agg_FuncCtx(ctx);
+	udf->agg.free(ac->state);
+	if(ac->hashSet) Set_Free(ac->hashSet);
+	rm_free(ac);
+}
+
+// Aggregation errors are raised, as the aggregating operation doesn't inspect them.
+static void _UDF_AggRaise(const char *name, const char *err) {
+	char *error;
+	if(err) asprintf(&error, "%s", err);
+	else asprintf(&error, "User-defined function '%s' failed", name);
+	QueryCtx_SetError(error);
+	QueryCtx_RaiseRuntimeException();
+}
+
+static bool _UDF_AggSeen(UDFAggregateCtx *ac, SIValue *argv, int argc) {
+	if(argc == 1) return !Set_Add(ac->hashSet, argv[0]);
+
+	// Distinct over the tuple of arguments.
+	SIValue tuple = SIArray_New(argc);
+	for(int i = 0; i < argc; i++) SIArray_Append(&tuple, argv[i]);
+	bool seen = !Set_Add(ac->hashSet, tuple);
+	SIValue_Free(tuple);
+	return seen;
+}
+
+static int _UDF_AggStep(AggCtx *ctx, SIValue *argv, int argc) {
+	UDFAggregate *udf = ctx->udf;
+	UDFAggregateCtx *ac = Agg_FuncCtx(ctx);
+
+	GraphUDFValue args[argc + 1];
+	for(int i = 0; i < argc; i++) {
+		SIType t = SI_TYPE(argv[i]);
+		if(!(t & UDF_TYPES)) {
+			char *error;
+			asprintf(&error, "Type mismatch: user-defined function '%s' received %s", udf->name,
+					 SIType_ToString(t));
+			QueryCtx_SetError(error);
+			QueryCtx_RaiseRuntimeException();
+			return AGG_ERR;
+		}
+		args[i] = _UDF_ToValue(argv[i]);
+	}
+
+	if(ac->hashSet && _UDF_AggSeen(ac, argv, argc)) return AGG_OK;
+
+	const char *err = NULL;
+	if(udf->agg.step(ac->state, args, argc, &err) != GRAPH_UDF_OK) {
+		_UDF_AggRaise(udf->name, err);
+		return AGG_ERR;
+	}
+	return AGG_OK;
+}
+
+static int _UDF_AggFinalize(AggCtx *ctx) {
+	UDFAggregate *udf = ctx->udf;
+	UDFAggregateCtx *ac = Agg_FuncCtx(ctx);
+
+	SIValue v;
+	if(!_UDF_FromValue(udf->name, udf->agg.finalize(ac->state), false, &v)) {
+		QueryCtx_RaiseRuntimeException();
+		return AGG_ERR;
+	}
+	Agg_SetResult(ctx, v);
+	return AGG_OK;
+}
+
+static AggCtx *_UDF_AggInit(bool distinct, void *udf) {
+	return Agg_NewUDFCtx(_UDF_AggStep, _UDF_AggFinalize, _UDF_AggCtxNew, _UDF_AggCtxFree, distinct,
+						 udf);
+}
+
+// Names must fit the registries and not shadow existing functions.
+static bool _UDF_ValidName(const char *name) {
+	if(name == NULL) return false;
+	size_t len = strlen(name);
+	if(len == 0 || len > UDF_MAX_NAME_LEN) return false;
+	return !AR_FuncExists(name) && !Agg_FuncExists(name);
+}
+
+static int _UDF_RegisterScalar(const char *name, GraphUDFScalarFunc func, int min_argc,
+							   int max_argc, int flags, void *privdata) {
+	if(func == NULL || min_argc < 0) return GRAPH_UDF_ERR;
+	if(max_argc >= 0 && max_argc < min_argc) return GRAPH_UDF_ERR;
+	if(!_UDF_ValidName(name)) return GRAPH_UDF_ERR;
+
+	UDFScalar *udf = rm_malloc(sizeof(UDFScalar));
+	udf->name = rm_strdup(name);
+	udf->func = func;
+	udf->privdata = privdata;
+
+	SIType *types = array_new(SIType, 1);
+	types = array_append(types, UDF_TYPES);
+	uint max = (max_argc < 0) ? VAR_ARG_LEN : (uint)max_argc;
+	bool reducible = (flags & GRAPH_UDF_DETERMINISTIC);
+	AR_RegFunc(AR_UDFDescNew(udf->name, _UDF_InvokeScalar, udf, min_argc, max, types, reducible));
+	return GRAPH_UDF_OK;
+}
+
+static int _UDF_RegisterAggregate(const char *name, const GraphUDFAggregate *agg, void *privdata) {
+	if(agg == NULL || !agg->init || !agg->step || !agg->finalize || !agg->free) return GRAPH_UDF_ERR;
+	if(!_UDF_ValidName(name)) return GRAPH_UDF_ERR;
+
+	UDFAggregate *udf = rm_malloc(sizeof(UDFAggregate));
+	udf->name = rm_strdup(name);
+	udf->agg = *agg;
+	udf->privdata = privdata;
+	Agg_RegisterUDF(udf->name, _UDF_AggInit, udf);
+	return GRAPH_UDF_OK;
+}
+
+static const GraphUDFRegistry _registry = {
+	.version = GRAPH_UDF_API_VERSION,
+	.RegisterScalar = _UDF_RegisterScalar,
+	.RegisterAggregate = _UDF_RegisterAggregate,
+};
+
+bool UDF_Load(const char *path, char **err) {
+	void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if(handle == NULL) {
+		asprintf(err, "Failed to load user-defined functions from %s: %s", path, dlerror());
+		return false;
+	}
+
+	GraphUDFOnLoad onload = (GraphUDFOnLoad)dlsym(handle, GRAPH_UDF_ONLOAD);
+	if(onload == NULL) {
+		asprintf(err, "%s does not export %s", path, GRAPH_UDF_ONLOAD);
+		dlclose(handle);
+		return false;
+	}
+
+	// The library remains loaded, registered functions refer to it.
+	if(onload(&_registry) != GRAPH_UDF_OK) {
+		asprintf(err, "%s failed to register its functions", path);
+		return false;
+	}
+	return true;
+}
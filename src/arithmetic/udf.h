@@ -0,0 +1,14 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdbool.h>
+
+/* Load the user-defined function plug-in at path and register its functions,
+ * see redisgraph_udf.h for the plug-in ABI.
+ * Returns false and sets err if the plug-in fails to load. */
+bool UDF_Load(const char *path, char **err);
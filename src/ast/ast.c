@@ -14,6 +14,7 @@
 #include "../arithmetic/repository.h"
 #include "../arithmetic/arithmetic_expression.h"
 #include "ast_build_ar_exp.h"
+#include "../execution_plan/ops/shared/traverse_batch.h"
 #include "../procedures/procedure.h"
 
 // TODO duplicated logic, find shared place for it
@@ -61,6 +62,31 @@ static inline int _get_limit(const cypher_astnode_t *project_clause) {
 	return AST_ParseIntegerNode(limit_node);
 }
 
+/* Returns the number of records a projection limited to limit results consumes,
+ * projections which sort, aggregate, deduplicate or filter their records
+ * may consume every record regardless of their limit. */
+static uint _get_record_cap(const cypher_astnode_t *project_clause, uint limit) {
+	if(limit == UNLIMITED) return UNLIMITED;
+
+	const cypher_astnode_t *skip_node;
+	if(cypher_astnode_type(project_clause) == CYPHER_AST_WITH) {
+		if(cypher_ast_with_get_order_by(project_clause) ||
+		   cypher_ast_with_is_distinct(project_clause) ||
+		   cypher_ast_with_get_predicate(project_clause)) return UNLIMITED;
+		skip_node = cypher_ast_with_get_skip(project_clause);
+	} else {
+		if(cypher_ast_return_get_order_by(project_clause) ||
+		   cypher_ast_return_is_distinct(project_clause)) return UNLIMITED;
+		skip_node = cypher_ast_return_get_skip(project_clause);
+	}
+	if(AST_ClauseContainsAggregation(project_clause)) return UNLIMITED;
+
+	// Skipped records are consumed as well.
+	uint64_t cap = limit;
+	if(skip_node) cap += AST_ParseIntegerNode(skip_node);
+	return MIN(cap, UNLIMITED);
+}
+
 // If the project clause has a LIMIT modifier, set its value in the constructed AST.
 static void _AST_LimitResults(AST *ast, const cypher_astnode_t *root_clause,
 							  const cypher_astnode_t *project_clause) {
@@ -68,9 +94,11 @@ static void _AST_LimitResults(AST *ast, const cypher_astnode_t *root_clause,
 	if(root_type == CYPHER_AST_RETURN || root_type == CYPHER_AST_WITH) {
 		// Use the root clause of this AST if it is a projection.
 		ast->limit = _get_limit(root_clause);
+		ast->record_cap = _get_record_cap(root_clause, ast->limit);
 	} else if(project_clause) {
 		// Use the subsequent projection clause (if one is provided) otherwise.
 		ast->limit = _get_limit(project_clause);
+		ast->record_cap = _get_record_cap(project_clause, ast->limit);
 	}
 }
 
@@ -102,7 +130,9 @@ static bool _AST_ReadOnly(const cypher_astnode_t *root) {
 	   type == CYPHER_AST_DELETE                 ||
 	   type == CYPHER_AST_SET                    ||
 	   type == CYPHER_AST_CREATE_NODE_PROPS_INDEX ||
-	   type == CYPHER_AST_DROP_NODE_PROPS_INDEX) {
+	   type == CYPHER_AST_DROP_NODE_PROPS_INDEX ||
+	   type == CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT ||
+	   type == CYPHER_AST_DROP_NODE_PROP_CONSTRAINT) {
 		return false;
 	}
 	// In case of procedure call which modifies the graph/indices.
@@ -250,6 +280,7 @@ AST *AST_Build(cypher_parse_result_t *parse_result) {
 	ast->anot_ctx_collection = AST_AnnotationCtxCollection_New();
 	ast->free_root = false;
 	ast->limit = UNLIMITED;
+	ast->record_cap = UNLIMITED;
 
 	// Retrieve the AST root node from a parsed query.
 	const cypher_astnode_t *statement = cypher_parse_result_get_root(parse_result, 0);
@@ -278,6 +309,7 @@ AST *AST_NewSegment(AST *master_ast, uint start_offset, uint end_offset) {
 	ast->canonical_entity_names = master_ast->canonical_entity_names;
 	ast->free_root = true;
 	ast->limit = UNLIMITED;
+	ast->record_cap = UNLIMITED;
 	uint n = end_offset - start_offset;
 
 	const cypher_astnode_t *clauses[n];
@@ -327,6 +359,29 @@ inline long AST_ParseIntegerNode(const cypher_astnode_t *int_node) {
 	return strtol(value_str, NULL, 0);
 }
 
+bool AST_RelationVariableLength(const cypher_astnode_t *rel) {
+	assert(rel);
+
+	const cypher_astnode_t *range = cypher_ast_rel_pattern_get_varlength(rel);
+	if(!range) return false;
+
+	const cypher_astnode_t *start = cypher_ast_range_get_start(range);
+	const cypher_astnode_t *end = cypher_ast_range_get_end(range);
+	// An unbounded range is always of variable length.
+	if(!end) return true;
+	long min_hops = start ? AST_ParseIntegerNode(start) : 1;
+	return min_hops != AST_ParseIntegerNode(end);
+}
+
+const cypher_astnode_t *AST_GetShortestPath(const cypher_astnode_t *path) {
+	assert(path);
+
+	// Named paths wrap the pattern they name.
+	if(cypher_astnode_type(path) == CYPHER_AST_NAMED_PATH) path = cypher_ast_named_path_get_path(path);
+	if(cypher_astnode_type(path) == CYPHER_AST_SHORTEST_PATH) return path;
+	return NULL;
+}
+
 bool AST_ClauseContainsAggregation(const cypher_astnode_t *clause) {
 	assert(clause);
 
@@ -433,7 +488,8 @@ const char **AST_BuildCallColumnNames(const cypher_astnode_t *call_clause) {
 // Determine the maximum number of records
 // which will be considered when evaluating an algebraic expression.
 int TraverseRecordCap(const AST *ast) {
-	return MIN(ast->limit, 16);  // Use 16 as the default value.
+	// Batches adapt up to the number of records the segment's projection consumes.
+	return MIN(ast->record_cap, TRAVERSE_BATCH_MAX);
 }
 
 inline AST_AnnotationCtxCollection *AST_GetAnnotationCtxCollection(AST *ast) {
@@ -458,6 +514,21 @@ cypher_parse_result_t *parse(const char *query) {
 	return cypher_parse(query, NULL, NULL, CYPHER_PARSE_ONLY_STATEMENTS);
 }
 
+cypher_parse_result_t *parse_params(const char *params, size_t len) {
+	// Parameters are only accepted as a statement prefix, complete them with a trivial query body.
+	char *query;
+	asprintf(&query, "%.*s RETURN 0", (int)len, params);
+	cypher_parse_result_t *parse_result = parse(query);
+	free(query);
+	return parse_result;
+}
+
+void AST_ExtractParams(const cypher_parse_result_t *parse_result) {
+	const cypher_astnode_t *statement = cypher_parse_result_get_root(parse_result, 0);
+	assert(cypher_astnode_type(statement) == CYPHER_AST_STATEMENT);
+	_extract_params(statement);
+}
+
 void parse_result_free(cypher_parse_result_t *parse_result) {
 	if(parse_result) cypher_parse_result_free(parse_result);
 }
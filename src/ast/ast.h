@@ -26,6 +26,7 @@ typedef struct {
 	AST_AnnotationCtxCollection *anot_ctx_collection;   // Holds annotations contexts.
 	rax *canonical_entity_names;                        // Storage for canonical graph entity names.
 	uint limit;                                         // The maximum number of results in this segment.
+	uint record_cap;                                    // The maximum number of records the segment's projection consumes.
 	bool free_root;                                     // The root should only be freed if this is a sub-AST we constructed
 } AST;
 
@@ -35,6 +36,9 @@ bool AST_ContainsErrors(const cypher_parse_result_t *result);
 // Make sure the parse result and the AST tree pass all validations.
 AST_Validation AST_Validate(RedisModuleCtx *ctx, const cypher_parse_result_t *result);
 
+// Validate a query which is prepared for later execution, without requiring parameter values.
+AST_Validation AST_ValidatePrepared(RedisModuleCtx *ctx, const cypher_parse_result_t *result);
+
 // Checks if the parse result represents a read-only query.
 bool AST_ReadOnly(const cypher_parse_result_t *result);
 
@@ -85,6 +89,12 @@ bool AST_AliasIsReferenced(AST *ast, const char *alias);
 // Convert an AST integer node (which is stored internally as a string) into an integer.
 long AST_ParseIntegerNode(const cypher_astnode_t *int_node);
 
+// Returns true if the given relation pattern matches a variable number of hops, as in -[*1..3]->.
+bool AST_RelationVariableLength(const cypher_astnode_t *rel);
+
+// Returns the shortestPath or allShortestPaths node of the given pattern path, NULL if there is none.
+const cypher_astnode_t *AST_GetShortestPath(const cypher_astnode_t *path);
+
 // Returns true if the given clause contains an aggregate function.
 bool AST_ClauseContainsAggregation(const cypher_astnode_t *clause);
 
@@ -102,12 +112,19 @@ const char **AST_BuildReturnColumnNames(const cypher_astnode_t *return_clause);
 const char **AST_BuildCallColumnNames(const cypher_astnode_t *return_clause);
 
 // Determine the maximum number of records
-// which will be considered when evaluating an algebraic expression.
+// which will be considered at once when evaluating an algebraic expression.
 int TraverseRecordCap(const AST *ast);
 
 // Parse a query to construct an immutable AST.
 cypher_parse_result_t *parse(const char *query);
 
+/* Parse the parameters prefix of a query, e.g. "CYPHER a=1 b='x'".
+ * The returned parse result must outlive any use of the extracted parameters. */
+cypher_parse_result_t *parse_params(const char *params, size_t len);
+
+// Store the parameters specified by the parsed query in the query context.
+void AST_ExtractParams(const cypher_parse_result_t *parse_result);
+
 // Free the immutable AST generated by the parser.
 void parse_result_free(cypher_parse_result_t *parse_result);
 
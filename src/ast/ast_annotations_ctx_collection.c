@@ -10,7 +10,6 @@
 AST_AnnotationCtxCollection *AST_AnnotationCtxCollection_New() {
 	AST_AnnotationCtxCollection *anotCtxCollection = rm_malloc(sizeof(AST_AnnotationCtxCollection));
 	anotCtxCollection->name_ctx = NULL;
-	anotCtxCollection->params_ctx = NULL;
 	anotCtxCollection->named_paths_ctx = NULL;
 	anotCtxCollection->project_all_ctx = NULL;
 	return anotCtxCollection;
@@ -21,11 +20,6 @@ inline AnnotationCtx *AST_AnnotationCtxCollection_GetNameCtx(const AST_Annotatio
 	return anot_ctx_collection->name_ctx;
 }
 
-inline AnnotationCtx *AST_AnnotationCtxCollection_GetParamsCtx(const AST_AnnotationCtxCollection
-															   *anot_ctx_collection) {
-	return anot_ctx_collection->params_ctx;
-}
-
 inline AnnotationCtx *AST_AnnotationCtxCollection_GetNamedPathsCtx(const AST_AnnotationCtxCollection
 																   *anot_ctx_collection) {
 	return anot_ctx_collection->named_paths_ctx;
@@ -41,12 +35,6 @@ inline void AST_AnnotationCtxCollection_SetNameCtx(AST_AnnotationCtxCollection *
 	anot_ctx_collection->name_ctx = name_ctx;
 }
 
-inline void AST_AnnotationCtxCollection_SetParamsCtx(AST_AnnotationCtxCollection
-													 *anot_ctx_collection,
-													 AnnotationCtx *params_ctx) {
-	anot_ctx_collection->params_ctx = params_ctx;
-}
-
 inline void AST_AnnotationCtxCollection_SetNamedPathsCtx(AST_AnnotationCtxCollection
 														 *anot_ctx_collection,
 														 AnnotationCtx *named_paths_ctx) {
@@ -62,7 +50,6 @@ inline void AST_AnnotationCtxCollection_SetProjectAllCtx(AST_AnnotationCtxCollec
 void AST_AnnotationCtxCollection_Free(AST_AnnotationCtxCollection *anotCtxCollection) {
 	if(anotCtxCollection) {
 		if(anotCtxCollection->name_ctx) cypher_ast_annotation_context_free(anotCtxCollection->name_ctx);
-		if(anotCtxCollection->params_ctx) cypher_ast_annotation_context_free(anotCtxCollection->params_ctx);
 		if(anotCtxCollection->named_paths_ctx) cypher_ast_annotation_context_free(
 				anotCtxCollection->named_paths_ctx);
 		if(anotCtxCollection->project_all_ctx) cypher_ast_annotation_context_free(
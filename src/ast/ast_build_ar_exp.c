@@ -97,12 +97,71 @@ static AR_ExpNode *AR_EXP_NewOpNodeFromAST(AST_Operator op, uint child_count) {
 	return AR_EXP_NewOpNode(func_name, child_count);
 }
 
+// Returns true if node pattern introduces no label or property constraints.
+static inline bool _AR_EXP_UnconstrainedNode(const cypher_astnode_t *node) {
+	return cypher_ast_node_pattern_nlabels(node) == 0 &&
+		   cypher_ast_node_pattern_get_properties(node) == NULL;
+}
+
+/* Rewrites the size of a pattern counting a node's relationships, e.g. size((n)-[:R]->()),
+ * into the node's degree, which is read off the relation matrices rather than
+ * evaluated by matching the pattern. Each edge counts, including every edge
+ * connecting the same pair of nodes.
+ * Returns NULL if the pattern is not a single directed relationship from
+ * a named node to an anonymous, unconstrained one. */
+static AR_ExpNode *_AR_EXP_DegreeFromPatternSize(const cypher_astnode_t *path) {
+	if(cypher_ast_pattern_path_nelements(path) != 3) return NULL;
+	const cypher_astnode_t *src = cypher_ast_pattern_path_get_element(path, 0);
+	const cypher_astnode_t *edge = cypher_ast_pattern_path_get_element(path, 1);
+	const cypher_astnode_t *dest = cypher_ast_pattern_path_get_element(path, 2);
+
+	if(!_AR_EXP_UnconstrainedNode(src) || !_AR_EXP_UnconstrainedNode(dest)) return NULL;
+	if(cypher_ast_rel_pattern_get_identifier(edge) ||
+	   cypher_ast_rel_pattern_get_properties(edge) ||
+	   cypher_ast_rel_pattern_get_varlength(edge)) return NULL;
+
+	enum cypher_rel_direction dir = cypher_ast_rel_pattern_get_direction(edge);
+	if(dir == CYPHER_REL_BIDIRECTIONAL) return NULL;
+
+	// Exactly one endpoint is named, its relationships are counted.
+	const cypher_astnode_t *src_identifier = cypher_ast_node_pattern_get_identifier(src);
+	const cypher_astnode_t *dest_identifier = cypher_ast_node_pattern_get_identifier(dest);
+	if((src_identifier == NULL) == (dest_identifier == NULL)) return NULL;
+
+	bool outgoing = (dir == CYPHER_REL_OUTBOUND);
+	const cypher_astnode_t *identifier = src_identifier;
+	if(identifier == NULL) {
+		identifier = dest_identifier;
+		outgoing = !outgoing;
+	}
+
+	uint reltype_count = cypher_ast_rel_pattern_nreltypes(edge);
+	AR_ExpNode *op = AR_EXP_NewOpNode(outgoing ? "outdegree" : "indegree", 1 + reltype_count);
+	op->op.children[0] = AR_EXP_NewVariableOperandNode(cypher_ast_identifier_get_name(identifier),
+														NULL);
+	for(uint i = 0; i < reltype_count; i++) {
+		const cypher_astnode_t *reltype = cypher_ast_rel_pattern_get_reltype(edge, i);
+		SIValue name = SI_ConstStringVal((char *)cypher_ast_reltype_get_name(reltype));
+		op->op.children[1 + i] = AR_EXP_NewConstOperandNode(name);
+	}
+	return op;
+}
+
 static AR_ExpNode *_AR_EXP_FromApplyExpression(const cypher_astnode_t *expr) {
 	AR_ExpNode *op;
 	const cypher_astnode_t *func_node = cypher_ast_apply_operator_get_func_name(expr);
 	const char *func_name = cypher_ast_function_name_get_value(func_node);
 	unsigned int arg_count = cypher_ast_apply_operator_narguments(expr);
 	bool distinct = cypher_ast_apply_operator_get_distinct(expr);
+
+	// size() of a relationship pattern is the degree of the pattern's node.
+	if(arg_count == 1 && !distinct && strcasecmp(func_name, "size") == 0) {
+		const cypher_astnode_t *arg = cypher_ast_apply_operator_get_argument(expr, 0);
+		if(cypher_astnode_type(arg) == CYPHER_AST_PATTERN_PATH) {
+			op = _AR_EXP_DegreeFromPatternSize(arg);
+			if(op) return op;
+		}
+	}
 	if(distinct) op = AR_EXP_NewDistinctOpNode(func_name, arg_count);
 	else op = AR_EXP_NewOpNode(func_name, arg_count);
 
@@ -427,10 +486,8 @@ static AR_ExpNode *_AR_EXP_FromExpression(const cypher_astnode_t *expr) {
 	} else if(type == CYPHER_AST_NODE_PATTERN || type == CYPHER_AST_REL_PATTERN) {
 		return _AR_ExpNodeFromGraphEntity(expr);
 	} else if(type == CYPHER_AST_PARAMETER) {
-		AST *ast = QueryCtx_GetAST();
-		AnnotationCtx *params_ctx = AST_AnnotationCtxCollection_GetParamsCtx(ast->anot_ctx_collection);
-		AR_ExpNode *param_value = cypher_astnode_get_annotation(params_ctx, expr);
-		return AR_EXP_Clone(param_value);
+		// Parameters are resolved on evaluation, to allow reusing the expression.
+		return AR_EXP_NewParameterOperandNode(cypher_ast_parameter_get_name(expr));
 	} else {
 		/*
 		   Unhandled types:
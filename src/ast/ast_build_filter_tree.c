@@ -204,6 +204,22 @@ static FT_FilterNode *_convertInlinedProperties(const AST *ast, const cypher_ast
 	return root;
 }
 
+static FT_FilterNode *_convertInlinedLabels(const AST *ast, const cypher_astnode_t *entity) {
+	/* A node is matched by scanning or traversing a single label matrix,
+	 * additional labels e.g. MATCH (n:A:B) are verified by a filter. */
+	uint nlabels = cypher_ast_node_pattern_nlabels(entity);
+	if(nlabels < 2) return NULL;
+
+	const char *alias = AST_GetEntityName(ast, entity);
+	AR_ExpNode *exp = AR_EXP_NewOpNode("has_labels", 1 + nlabels);
+	exp->op.children[0] = AR_EXP_NewVariableOperandNode(alias, NULL);
+	for(uint i = 0; i < nlabels; i++) {
+		const char *label = cypher_ast_label_get_name(cypher_ast_node_pattern_get_label(entity, i));
+		exp->op.children[1 + i] = AR_EXP_NewConstOperandNode(SI_ConstStringVal((char *)label));
+	}
+	return FilterTree_CreateExpressionFilter(exp);
+}
+
 static FT_FilterNode *_convertPatternPath(const cypher_astnode_t *entity) {
 	// Collect aliases specified in pattern.
 	const char **aliases = array_new(const char *, 1);
@@ -269,10 +285,14 @@ void _AST_ConvertGraphPatternToFilter(const AST *ast, FT_FilterNode **root,
 			const cypher_astnode_t *node = cypher_ast_pattern_path_get_element(path, n);
 			ft_node = _convertInlinedProperties(ast, node, GETYPE_NODE);
 			if(ft_node) _FT_Append(root, ft_node);
+			ft_node = _convertInlinedLabels(ast, node);
+			if(ft_node) _FT_Append(root, ft_node);
 		}
 		// Edges are in odd places.
 		for(uint e = 1; e < nelements; e += 2) {
 			const cypher_astnode_t *edge = cypher_ast_pattern_path_get_element(path, e);
+			// Variable length traversals verify inlined properties on every edge they follow.
+			if(AST_RelationVariableLength(edge)) continue;
 			ft_node = _convertInlinedProperties(ast, edge, GETYPE_EDGE);
 			if(ft_node) _FT_Append(root, ft_node);
 		}
@@ -82,6 +82,11 @@ static void _AST_MapReferencedNode(AST *ast, const cypher_astnode_t *node, bool
 static void _AST_MapReferencedEdge(AST *ast, const cypher_astnode_t *edge, bool force_mapping) {
 
 	const cypher_astnode_t *properties = cypher_ast_rel_pattern_get_properties(edge);
+	// Variable length edges apply their inlined filters while traversing, without being referenced.
+	if(properties && !force_mapping && AST_RelationVariableLength(edge)) {
+		_AST_MapExpression(ast, properties);
+		return;
+	}
 	// An edge with inlined filters is always referenced for the FilterTree.
 	// (In the case of a CREATE path, these are properties being set)
 	if(properties || force_mapping) {
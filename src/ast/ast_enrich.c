@@ -5,7 +5,6 @@
 */
 
 #include "enrichment/annotate_entities.h"
-#include "enrichment/annotate_params.h"
 #include "enrichment/annotate_project_all.h"
 #include "enrichment/annotate_projected_named_paths.h"
 
@@ -20,6 +19,5 @@ void AST_Enrich(AST *ast) {
 	AST_AnnotateEntities(ast);
 	AST_AnnotateProjectAll(ast);
 	AST_AnnotateNamedPaths(ast);
-	AST_AnnotateParams(ast);
 }
 
@@ -14,6 +14,7 @@ AST *AST_MockMatchPattern(AST *master_ast, const cypher_astnode_t *original_path
 	ast->anot_ctx_collection = master_ast->anot_ctx_collection;
 	ast->free_root = true;
 	ast->limit = UNLIMITED;
+	ast->record_cap = UNLIMITED;
 	struct cypher_input_range range = {};
 
 	// Reuse the input path directly. We cannot clone, as this causes annotations (entity names) to be lost.
@@ -279,6 +279,23 @@ static inline bool _AliasIsReturned(rax *projections, const char *identifier) {
 	return raxFind(projections, (unsigned char *)identifier, strlen(identifier)) != raxNotFound;
 }
 
+static bool _ValueIsConstant(const cypher_astnode_t *root) {
+	cypher_astnode_type_t type = cypher_astnode_type(root);
+	if(type == CYPHER_AST_PROPERTY_OPERATOR ||
+	   type == CYPHER_AST_IDENTIFIER
+	  ) {
+		return false;
+	}
+
+	// Recursively visit children
+	uint child_count = cypher_astnode_nchildren(root);
+	for(uint i = 0; i < child_count; i++) {
+		if(!_ValueIsConstant(cypher_astnode_get_child(root, i))) return false;
+	}
+
+	return true;
+}
+
 // If we have a multi-hop traversal (fixed or variable length), we cannot currently return that entity.
 static AST_Validation _ValidateMultiHopTraversal(rax *projections, const cypher_astnode_t *edge,
 												 const cypher_astnode_t *range,
@@ -302,8 +319,10 @@ static AST_Validation _ValidateMultiHopTraversal(rax *projections, const cypher_
 	bool multihop = (start > 1) || (start != end);
 	if(!multihop) return AST_VALID;
 
-	// Multi-hop traversals cannot (currently) be filtered on
-	if(cypher_ast_rel_pattern_get_properties(edge) != NULL) {
+	/* Variable length traversals apply inlined filters to every edge they follow,
+	 * which must be resolved before traversing. Fixed multi-hop traversals can't be filtered on. */
+	const cypher_astnode_t *props = cypher_ast_rel_pattern_get_properties(edge);
+	if(props != NULL && (start == end || !_ValueIsConstant(props))) {
 		asprintf(reason, "RedisGraph does not currently support filters on variable-length paths.");
 		return AST_INVALID;
 	}
@@ -370,6 +389,30 @@ static AST_Validation _ValidateRelation(rax *projections, const cypher_astnode_t
 	return res;
 }
 
+// Shortest paths are searched between two nodes, over a single relationship pattern.
+static AST_Validation _ValidateShortestPath(const cypher_astnode_t *path, char **reason) {
+	if(cypher_ast_pattern_path_nelements(path) != 3) {
+		asprintf(reason, "shortestPath requires a pattern containing a single relationship.");
+		return AST_INVALID;
+	}
+
+	const cypher_astnode_t *edge = cypher_ast_pattern_path_get_element(path, 1);
+	const cypher_astnode_t *range = cypher_ast_rel_pattern_get_varlength(edge);
+	const cypher_astnode_t *range_start = range ? cypher_ast_range_get_start(range) : NULL;
+	if(range_start && AST_ParseIntegerNode(range_start) > 1) {
+		asprintf(reason,
+				 "shortestPath does not support a minimal length different from 0 or 1.");
+		return AST_INVALID;
+	}
+
+	if(cypher_ast_rel_pattern_get_properties(edge) != NULL) {
+		asprintf(reason, "RedisGraph does not currently support filters on shortestPath relationships.");
+		return AST_INVALID;
+	}
+
+	return AST_VALID;
+}
+
 static AST_Validation _ValidatePath(const cypher_astnode_t *path,
 									rax *projections,
 									rax *edge_aliases,
@@ -377,6 +420,11 @@ static AST_Validation _ValidatePath(const cypher_astnode_t *path,
 	AST_Validation res = AST_VALID;
 	uint path_len = cypher_ast_pattern_path_nelements(path);
 
+	if(AST_GetShortestPath(path)) {
+		res = _ValidateShortestPath(path, reason);
+		if(res != AST_VALID) return res;
+	}
+
 	// Check all relations on the path (every odd offset) and collect aliases.
 	for(uint i = 1; i < path_len; i += 2) {
 		const cypher_astnode_t *edge = cypher_ast_pattern_path_get_element(path, i);
@@ -399,23 +447,6 @@ static AST_Validation _ValidatePattern(rax *projections, const cypher_astnode_t
 	return res;
 }
 
-static bool _ValueIsConstant(const cypher_astnode_t *root) {
-	cypher_astnode_type_t type = cypher_astnode_type(root);
-	if(type == CYPHER_AST_PROPERTY_OPERATOR ||
-	   type == CYPHER_AST_IDENTIFIER
-	  ) {
-		return false;
-	}
-
-	// Recursively visit children
-	uint child_count = cypher_astnode_nchildren(root);
-	for(uint i = 0; i < child_count; i++) {
-		if(!_ValueIsConstant(cypher_astnode_get_child(root, i))) return false;
-	}
-
-	return true;
-}
-
 // Validate the property maps used in node/edge patterns in MATCH, and CREATE clauses
 static AST_Validation _ValidateInlinedProperties(const cypher_astnode_t *props, char **reason) {
 	if(cypher_astnode_type(props) != CYPHER_AST_MAP) {
@@ -748,6 +779,11 @@ static AST_Validation _Validate_MERGE_Clauses(const AST *ast, char **reason) {
 
 		const cypher_astnode_t *merge_clause = cypher_ast_query_get_clause(ast->root, clause_idx);
 		const cypher_astnode_t *path = cypher_ast_merge_get_pattern_path(merge_clause);
+		if(AST_GetShortestPath(path)) {
+			asprintf(reason, "shortestPath is not supported in a MERGE clause.");
+			res = AST_INVALID;
+			goto cleanup;
+		}
 		uint nelems = cypher_ast_pattern_path_nelements(path);
 		for(uint j = 0; j < nelems; j ++) {
 			const cypher_astnode_t *entity = cypher_ast_pattern_path_get_element(path, j);
@@ -778,6 +814,10 @@ static AST_Validation _Validate_CREATE_Entities(const cypher_astnode_t *clause,
 	uint path_count = cypher_ast_pattern_npaths(pattern);
 	for(uint i = 0; i < path_count; i ++) {
 		const cypher_astnode_t *path = cypher_ast_pattern_get_path(pattern, i);
+		if(AST_GetShortestPath(path)) {
+			asprintf(reason, "shortestPath is not supported in a CREATE clause.");
+			return AST_INVALID;
+		}
 		// Validate that inlined properties are valid.
 		if(_ValidateInlinedPropertiesOnPath(path, reason) != AST_VALID) return AST_INVALID;
 
@@ -1638,7 +1678,8 @@ bool AST_ContainsErrors(const cypher_parse_result_t *result) {
 	return cypher_parse_result_nerrors(result) > 0;
 }
 
-AST_Validation AST_Validate(RedisModuleCtx *ctx, const cypher_parse_result_t *result) {
+static AST_Validation _AST_Validate(RedisModuleCtx *ctx, const cypher_parse_result_t *result,
+									bool params_bound) {
 	// Check for failures in libcypher-parser
 	if(AST_ContainsErrors(result)) {
 		char *errMsg = _AST_ReportErrors(result);
@@ -1674,7 +1715,7 @@ AST_Validation AST_Validate(RedisModuleCtx *ctx, const cypher_parse_result_t *re
 		return AST_INVALID;
 	}
 
-	if(_ValidateParameters(root, &reason) != AST_VALID) {
+	if(params_bound && _ValidateParameters(root, &reason) != AST_VALID) {
 		RedisModule_ReplyWithError(ctx, reason);
 		free(reason);
 		return AST_INVALID;
@@ -1683,8 +1724,10 @@ AST_Validation AST_Validate(RedisModuleCtx *ctx, const cypher_parse_result_t *re
 	const cypher_astnode_t *body = cypher_ast_statement_get_body(root);
 	cypher_astnode_type_t body_type = cypher_astnode_type(body);
 	if(body_type == CYPHER_AST_CREATE_NODE_PROPS_INDEX ||
-	   body_type == CYPHER_AST_DROP_NODE_PROPS_INDEX) {
-		// Index operation; validations are handled elsewhere.
+	   body_type == CYPHER_AST_DROP_NODE_PROPS_INDEX ||
+	   body_type == CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT ||
+	   body_type == CYPHER_AST_DROP_NODE_PROP_CONSTRAINT) {
+		// Index or constraint operation; validations are handled elsewhere.
 		return AST_VALID;
 	}
 
@@ -1705,3 +1748,11 @@ AST_Validation AST_Validate(RedisModuleCtx *ctx, const cypher_parse_result_t *re
 	return res;
 }
 
+AST_Validation AST_Validate(RedisModuleCtx *ctx, const cypher_parse_result_t *result) {
+	return _AST_Validate(ctx, result, true);
+}
+
+AST_Validation AST_ValidatePrepared(RedisModuleCtx *ctx, const cypher_parse_result_t *result) {
+	// Parameter values are only bound once the prepared query is executed.
+	return _AST_Validate(ctx, result, false);
+}
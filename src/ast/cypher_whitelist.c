@@ -35,8 +35,8 @@ static void _buildTypesWhitelist(void) {
 		// CYPHER_AST_SCHEMA_COMMAND,
 		CYPHER_AST_CREATE_NODE_PROPS_INDEX,
 		CYPHER_AST_DROP_NODE_PROPS_INDEX,
-		// CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT,
-		// CYPHER_AST_DROP_NODE_PROP_CONSTRAINT,
+		CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT,
+		CYPHER_AST_DROP_NODE_PROP_CONSTRAINT,
 		// CYPHER_AST_CREATE_REL_PROP_CONSTRAINT,
 		// CYPHER_AST_DROP_REL_PROP_CONSTRAINT,
 		CYPHER_AST_QUERY,
@@ -123,7 +123,7 @@ static void _buildTypesWhitelist(void) {
 		CYPHER_AST_PROC_NAME,
 		CYPHER_AST_PATTERN,
 		CYPHER_AST_NAMED_PATH,
-		// CYPHER_AST_SHORTEST_PATH,
+		CYPHER_AST_SHORTEST_PATH,
 		CYPHER_AST_PATTERN_PATH,
 		CYPHER_AST_NODE_PATTERN,
 		CYPHER_AST_REL_PATTERN,
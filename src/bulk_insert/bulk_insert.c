@@ -6,35 +6,58 @@
 
 #include "bulk_insert.h"
 #include "../schema/schema.h"
+#include "../util/arr.h"
 #include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+#include "../util/thpool/pools.h"
 #include <errno.h>
+#include <inttypes.h>
 #include <assert.h>
 
-// The first byte of each property in the binary stream
-// is used to indicate the type of the subsequent SIValue
-typedef enum {
-	BI_NULL,
-	BI_BOOL,
-	BI_DOUBLE,
-	BI_STRING,
-	BI_LONG
-} TYPE;
+// Connections of each relation, collected from all relation tokens.
+typedef struct {
+	GrB_Index **src;            // Source node IDs, per relation.
+	GrB_Index **dest;           // Destination node IDs, per relation.
+	EdgeID **ids;               // Edge IDs, per relation.
+} BulkRelations;
+
+// Retrieve schema by name, introducing it if missing.
+static int _BulkInsert_Schema(GraphContext *gc, const char *name, SchemaType t) {
+	Schema *schema = GraphContext_GetSchema(gc, name, t);
+	if(schema == NULL) schema = GraphContext_AddSchema(gc, name, t);
+	// Bulk inserted entities aren't tracked, statistics are rebuilt once required.
+	SchemaStats_Invalidate(schema->stats);
+	return schema->id;
+}
 
 // Read the header of a data stream to parse its property keys and update schemas.
 static Attribute_ID *_BulkInsert_ReadHeader(GraphContext *gc, SchemaType t,
 											const char *data, size_t *data_idx,
-											int *label_id, unsigned int *prop_count) {
+											int **label_ids, unsigned int *prop_count) {
 	/* Binary header format:
 	 * - entity name : null-terminated C string
+	 * - if entity name is empty, node files only:
+	 *   - label count : 4-byte unsigned integer
+	 *   [0..label_count] : null-terminated C string
 	 * - property count : 4-byte unsigned integer
 	 * [0..property_count] : null-terminated C string
 	 */
 	// First sequence is entity name
 	const char *name = data + *data_idx;
 	*data_idx += strlen(name) + 1;
-	Schema *schema = GraphContext_GetSchema(gc, name, t);
-	if(schema == NULL) schema = GraphContext_AddSchema(gc, name, t);
-	*label_id = schema->id;
+	*label_ids = array_new(int, 1);
+	if(name[0] != '\0' || t == SCHEMA_EDGE) {
+		*label_ids = array_append(*label_ids, _BulkInsert_Schema(gc, name, t));
+	} else {
+		// Nodes with no label or multiple labels, the first label is the node's primary label.
+		unsigned int label_count = *(unsigned int *)&data[*data_idx];
+		*data_idx += sizeof(unsigned int);
+		for(unsigned int j = 0; j < label_count; j++) {
+			const char *label = data + *data_idx;
+			*data_idx += strlen(label) + 1;
+			*label_ids = array_append(*label_ids, _BulkInsert_Schema(gc, label, t));
+		}
+	}
 
 	// Next 4 bytes are property count
 	*prop_count = *(unsigned int *)&data[*data_idx];
@@ -56,13 +79,15 @@ static Attribute_ID *_BulkInsert_ReadHeader(GraphContext *gc, SchemaType t,
 }
 
 // Read an SIValue from the data stream and update the index appropriately
-static inline SIValue _BulkInsert_ReadProperty(const char *data, size_t *data_idx) {
+static SIValue _BulkInsert_ReadProperty(const char *data, size_t *data_idx) {
 	/* Binary property format:
 	 * - property type : 1-byte integer corresponding to TYPE enum
 	 * - Nothing if type is NULL
 	 * - 1-byte true/false if type is boolean
 	 * - 8-byte double if type is numeric
 	 * - Null-terminated C string if type is string
+	 * - 8-byte element count followed by each element if type is array
+	 * - 8-byte double latitude followed by 8-byte double longitude if type is point
 	 */
 	SIValue v;
 	TYPE t = data[*data_idx];
@@ -88,66 +113,260 @@ static inline SIValue _BulkInsert_ReadProperty(const char *data, size_t *data_id
 		*data_idx += strlen(s) + 1;
 		// The string itself will be cloned when added to the GraphEntity properties.
 		v = SI_ConstStringVal((char *)s);
+	} else if(t == BI_ARRAY) {
+		uint64_t len = *(uint64_t *)&data[*data_idx];
+		*data_idx += sizeof(uint64_t);
+		v = SI_Array(len);
+		for(uint64_t i = 0; i < len; i++) {
+			SIValue elem = _BulkInsert_ReadProperty(data, data_idx);
+			SIArray_Append(&v, elem); // Appended element is cloned.
+			SIValue_Free(elem);
+		}
+	} else if(t == BI_POINT) {
+		double latitude = *(double *)&data[*data_idx];
+		double longitude = *(double *)&data[*data_idx + sizeof(double)];
+		*data_idx += 2 * sizeof(double);
+		v = SI_Point(latitude, longitude);
 	} else {
 		assert(0);
 	}
 	return v;
 }
 
+/* Read an entity's properties and add them to it,
+ * attrs and values are scratch buffers of prop_count elements. */
+static void _BulkInsert_ReadProperties(GraphContext *gc, GraphEntity *e, const char *data,
+									   size_t *data_idx, const Attribute_ID *prop_indicies,
+									   unsigned int prop_count, Attribute_ID *attrs, SIValue *values,
+									   SIValue *raw) {
+	// NULL values are omitted from the entity.
+	unsigned int count = 0;
+	for(unsigned int i = 0; i < prop_count; i++) {
+		SIValue value = _BulkInsert_ReadProperty(data, data_idx);
+		if(SIValue_IsNull(value)) continue;
+		attrs[count] = prop_indicies[i];
+		raw[count] = value;
+		values[count] = GraphContext_InternValue(gc, prop_indicies[i], value);
+		count++;
+	}
+	GraphEntity_AddProperties(e, count, attrs, values);
+	// Entity holds its own copies of arrays.
+	for(unsigned int i = 0; i < count; i++) SIValue_Free(raw[i]);
+}
+
+// Skip over an SIValue in the data stream.
+static void _BulkInsert_SkipProperty(const char *data, size_t *data_idx) {
+	TYPE t = data[*data_idx];
+	*data_idx += 1;
+	if(t == BI_BOOL) {
+		*data_idx += 1;
+	} else if(t == BI_DOUBLE || t == BI_LONG) {
+		*data_idx += 8;
+	} else if(t == BI_POINT) {
+		*data_idx += 16;
+	} else if(t == BI_STRING) {
+		*data_idx += strlen(data + *data_idx) + 1;
+	} else if(t == BI_ARRAY) {
+		uint64_t len = *(uint64_t *)&data[*data_idx];
+		*data_idx += sizeof(uint64_t);
+		for(uint64_t i = 0; i < len; i++) _BulkInsert_SkipProperty(data, data_idx);
+	}
+}
+
+// Skip over a relation header, returns the number of properties each relation holds.
+static unsigned int _BulkInsert_SkipRelationHeader(const char *data, size_t *data_idx) {
+	*data_idx += strlen(data + *data_idx) + 1;
+	unsigned int prop_count = *(unsigned int *)&data[*data_idx];
+	*data_idx += sizeof(unsigned int);
+	for(unsigned int j = 0; j < prop_count; j++) *data_idx += strlen(data + *data_idx) + 1;
+	return prop_count;
+}
+
+/* Resolve the node whose key attribute holds v through the key's exact-match index,
+ * the key must identify a single node. */
+static int _BulkInsert_ResolveKey(RedisModuleCtx *ctx, const BulkInsertKey *key, SIValue v,
+								  NodeID *id) {
+	OrderedIndexIter *iter;
+	if(SI_TYPE(v) == T_STRING) {
+		StringRange range = {.min = v.stringval, .max = v.stringval, .include_min = true,
+							 .include_max = true, .valid = true};
+		iter = OrderedIndex_IterateStringRange(key->idx->ordered, key->attribute_id, &range);
+	} else if(SI_TYPE(v) & (SI_NUMERIC | T_BOOL)) {
+		double d = SI_GET_NUMERIC(v);
+		NumericRange range = {.min = d, .max = d, .include_min = true, .include_max = true,
+							  .valid = true};
+		iter = OrderedIndex_IterateNumericRange(key->idx->ordered, key->attribute_id, &range);
+	} else {
+		RedisModule_ReplyWithError(ctx, "Bulk insert key values must be strings, numerics or booleans.");
+		return BULK_FAIL;
+	}
+
+	NodeID match;
+	bool found = OrderedIndexIter_Next(iter, id);
+	bool unique = found && !OrderedIndexIter_Next(iter, &match);
+	OrderedIndexIter_Free(iter);
+
+	if(!unique) {
+		char *err;
+		size_t len = 64;
+		size_t written = 0;
+		char *value = rm_calloc(len, sizeof(char));
+		SIValue_ToString(v, &value, &len, &written);
+		asprintf(&err, "Bulk insert key %s of :%s(%s) %s.", value, key->label, key->attribute,
+				 found ? "matches multiple nodes" : "does not match any node");
+		RedisModule_ReplyWithError(ctx, err);
+		free(err);
+		rm_free(value);
+		return BULK_FAIL;
+	}
+	return BULK_OK;
+}
+
+/* Resolve and validate the endpoints of each relation within the data stream,
+ * endpoints identified by key are resolved into the endpoints array as source, destination pairs,
+ * endpoints identified by ID are verified to refer to existing nodes. */
+static int _BulkInsert_ResolveRelationFile(RedisModuleCtx *ctx, GraphContext *gc,
+										   const BulkInsertKey *key, const char *data,
+										   size_t data_len, NodeID **endpoints) {
+	size_t data_idx = 0;
+	unsigned int prop_count = _BulkInsert_SkipRelationHeader(data, &data_idx);
+	*endpoints = (key) ? array_new(NodeID, 2) : NULL;
+
+	while(data_idx < data_len) {
+		for(int i = 0; i < 2; i++) {
+			NodeID id;
+			if(key) {
+				SIValue v = _BulkInsert_ReadProperty(data, &data_idx);
+				int rc = _BulkInsert_ResolveKey(ctx, key, v, &id);
+				SIValue_Free(v);
+				if(rc != BULK_OK) return BULK_FAIL;
+				*endpoints = array_append(*endpoints, id);
+			} else {
+				Node n;
+				id = *(NodeID *)&data[data_idx];
+				data_idx += sizeof(NodeID);
+				if(!Graph_GetNode(gc->g, id, &n)) {
+					char *err;
+					asprintf(&err, "Bulk insert relation endpoint %" PRIu64 " does not refer to an existing node.",
+							 id);
+					RedisModule_ReplyWithError(ctx, err);
+					free(err);
+					return BULK_FAIL;
+				}
+			}
+		}
+		for(unsigned int i = 0; i < prop_count; i++) _BulkInsert_SkipProperty(data, &data_idx);
+	}
+
+	return BULK_OK;
+}
+
 int _BulkInsert_ProcessNodeFile(RedisModuleCtx *ctx, GraphContext *gc, const char *data,
 								size_t data_len) {
 	size_t data_idx = 0;
 
-	int label_id;
+	int *label_ids;
 	unsigned int prop_count;
-	Attribute_ID *prop_indicies = _BulkInsert_ReadHeader(gc, SCHEMA_NODE, data, &data_idx, &label_id,
+	Attribute_ID *prop_indicies = _BulkInsert_ReadHeader(gc, SCHEMA_NODE, data, &data_idx, &label_ids,
 														 &prop_count);
+	uint label_count = array_len(label_ids);
+	int label = (label_count > 0) ? label_ids[0] : GRAPH_NO_LABEL;
 
+	// Nodes appended to an indexed label are introduced to its indices.
+	Schema **indexed = array_new(Schema *, label_count);
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, label_ids[i], SCHEMA_NODE);
+		if(Schema_HasIndices(s)) indexed = array_append(indexed, s);
+	}
+	uint indexed_count = array_len(indexed);
+
+	Attribute_ID *attrs = rm_malloc(sizeof(Attribute_ID) * prop_count);
+	SIValue *values = rm_malloc(sizeof(SIValue) * prop_count);
+	SIValue *raw = rm_malloc(sizeof(SIValue) * prop_count);
 	while(data_idx < data_len) {
 		Node n;
-		Graph_CreateNode(gc->g, label_id, &n);
-		for(unsigned int i = 0; i < prop_count; i++) {
-			SIValue value = _BulkInsert_ReadProperty(data, &data_idx);
-			GraphEntity_AddProperty((GraphEntity *)&n, prop_indicies[i], value);
-		}
+		Graph_CreateNode(gc->g, label, &n);
+		for(uint i = 1; i < label_count; i++) Graph_LabelNode(gc->g, ENTITY_GET_ID(&n), label_ids[i]);
+		_BulkInsert_ReadProperties(gc, (GraphEntity *)&n, data, &data_idx, prop_indicies, prop_count,
+								   attrs, values, raw);
+		for(uint i = 0; i < indexed_count; i++) Schema_AddNodeToIndices(indexed[i], &n, false);
 	}
 
+	rm_free(raw);
+	rm_free(values);
+	rm_free(attrs);
+	array_free(indexed);
+	array_free(label_ids);
 	free(prop_indicies);
 	return BULK_OK;
 }
 
+/* Create the relations of the data stream, endpoints holds the relations' resolved endpoints
+ * when these are identified by key. Connections are collected into rels,
+ * to be introduced to the matrices once all tokens are processed. */
 int _BulkInsert_ProcessRelationFile(RedisModuleCtx *ctx, GraphContext *gc, const char *data,
-									size_t data_len) {
+									size_t data_len, const NodeID *endpoints, BulkRelations *rels) {
 	size_t data_idx = 0;
 
-	int reltype_id;
+	int *label_ids;
 	unsigned int prop_count;
 	// Read property keys from header and update schema
-	Attribute_ID *prop_indicies = _BulkInsert_ReadHeader(gc, SCHEMA_EDGE, data, &data_idx, &reltype_id,
+	Attribute_ID *prop_indicies = _BulkInsert_ReadHeader(gc, SCHEMA_EDGE, data, &data_idx, &label_ids,
 														 &prop_count);
+	int reltype_id = label_ids[0];
+	Schema *s = GraphContext_GetSchemaByID(gc, reltype_id, SCHEMA_EDGE);
 	NodeID src;
 	NodeID dest;
+	Attribute_ID *attrs = rm_malloc(sizeof(Attribute_ID) * prop_count);
+	SIValue *values = rm_malloc(sizeof(SIValue) * prop_count);
+	SIValue *raw = rm_malloc(sizeof(SIValue) * prop_count);
+	uint edge_count = 0;
+
+	// Introduce connection arrays for relations created by this header.
+	while(array_len(rels->ids) <= reltype_id) {
+		rels->src = array_append(rels->src, array_new(GrB_Index, 1024));
+		rels->dest = array_append(rels->dest, array_new(GrB_Index, 1024));
+		rels->ids = array_append(rels->ids, array_new(EdgeID, 1024));
+	}
+	GrB_Index **srcs = rels->src + reltype_id;
+	GrB_Index **dests = rels->dest + reltype_id;
+	EdgeID **ids = rels->ids + reltype_id;
 
 	while(data_idx < data_len) {
 		Edge e;
-		// Next 8 bytes are source ID
-		src = *(NodeID *)&data[data_idx];
-		data_idx += sizeof(NodeID);
-		// Next 8 bytes are destination ID
-		dest = *(NodeID *)&data[data_idx];
-		data_idx += sizeof(NodeID);
+		if(endpoints) {
+			// Skip source and destination keys, these are already resolved.
+			src = endpoints[edge_count * 2];
+			dest = endpoints[edge_count * 2 + 1];
+			_BulkInsert_SkipProperty(data, &data_idx);
+			_BulkInsert_SkipProperty(data, &data_idx);
+		} else {
+			// Next 8 bytes are source ID
+			src = *(NodeID *)&data[data_idx];
+			data_idx += sizeof(NodeID);
+			// Next 8 bytes are destination ID
+			dest = *(NodeID *)&data[data_idx];
+			data_idx += sizeof(NodeID);
+		}
 
-		Graph_ConnectNodes(gc->g, src, dest, reltype_id, &e);
+		Graph_CreateEdge(gc->g, src, dest, reltype_id, &e);
+		*srcs = array_append(*srcs, src);
+		*dests = array_append(*dests, dest);
+		*ids = array_append(*ids, ENTITY_GET_ID(&e));
+		edge_count++;
 
 		if(prop_count == 0) continue;
 
 		// Process and add relation properties
-		for(unsigned int i = 0; i < prop_count; i ++) {
-			SIValue value = _BulkInsert_ReadProperty(data, &data_idx);
-			GraphEntity_AddProperty((GraphEntity *)&e, prop_indicies[i], value);
-		}
+		_BulkInsert_ReadProperties(gc, (GraphEntity *)&e, data, &data_idx, prop_indicies, prop_count,
+								   attrs, values, raw);
+		if(s->index) Schema_AddEdgeToIndices(s, &e, false);
 	}
 
+	rm_free(raw);
+	rm_free(values);
+	rm_free(attrs);
+	array_free(label_ids);
 	free(prop_indicies);
 	return BULK_OK;
 }
@@ -167,22 +386,52 @@ int _BulkInsert_InsertNodes(RedisModuleCtx *ctx, GraphContext *gc, int token_cou
 	return BULK_OK;
 }
 
-int _BulkInsert_Insert_Edges(RedisModuleCtx *ctx, GraphContext *gc, int token_count,
-							 RedisModuleString ***argv, int *argc) {
-	int rc;
-	for(int i = 0; i < token_count; i ++) {
+int _BulkInsert_Insert_Edges(RedisModuleCtx *ctx, GraphContext *gc, const BulkInsertKey *key,
+							 int token_count, RedisModuleString ***argv, int *argc) {
+	int rc = BULK_OK;
+	NodeID **endpoints = rm_calloc(token_count, sizeof(NodeID *));
+
+	// Resolve all endpoints prior to introducing any relation.
+	for(int i = 0; i < token_count && rc == BULK_OK; i ++) {
+		size_t len;
+		const char *data = RedisModule_StringPtrLen((*argv)[i], &len);
+		rc = _BulkInsert_ResolveRelationFile(ctx, gc, key, data, len, &endpoints[i]);
+	}
+
+	BulkRelations rels = {array_new(GrB_Index *, 0), array_new(GrB_Index *, 0), array_new(EdgeID *, 0)};
+	for(int i = 0; i < token_count && rc == BULK_OK; i ++) {
 		size_t len;
 		// Retrieve a pointer to the next binary stream and record its length
-		const char *data = RedisModule_StringPtrLen(**argv, &len);
-		*argv += 1;
-		*argc -= 1;
-		rc = _BulkInsert_ProcessRelationFile(ctx, gc, data, len);
+		const char *data = RedisModule_StringPtrLen((*argv)[i], &len);
+		rc = _BulkInsert_ProcessRelationFile(ctx, gc, data, len, endpoints[i], &rels);
 		assert(rc == BULK_OK);
 	}
-	return BULK_OK;
+	*argv += token_count;
+	*argc -= token_count;
+
+	/* Each relation's connections are sorted and merged into its matrices at once,
+	 * relations are merged concurrently. */
+	uint relation_count = array_len(rels.ids);
+	if(rc == BULK_OK) {
+		Graph_MergeRelations(gc->g, rels.src, rels.dest, rels.ids, relation_count,
+							 ThreadPools_ThreadCount());
+	}
+	for(uint r = 0; r < relation_count; r++) {
+		array_free(rels.src[r]);
+		array_free(rels.dest[r]);
+		array_free(rels.ids[r]);
+	}
+	array_free(rels.src);
+	array_free(rels.dest);
+	array_free(rels.ids);
+
+	for(int i = 0; i < token_count; i ++) if(endpoints[i]) array_free(endpoints[i]);
+	rm_free(endpoints);
+	return rc;
 }
 
-int BulkInsert(RedisModuleCtx *ctx, GraphContext *gc, RedisModuleString **argv, int argc) {
+int BulkInsert(RedisModuleCtx *ctx, GraphContext *gc, const BulkInsertKey *key,
+			   RedisModuleString **argv, int argc) {
 
 	if(argc < 2) {
 		RedisModule_ReplyWithError(ctx, "Bulk insert format error, failed to parse bulk insert sections.");
@@ -203,6 +452,12 @@ int BulkInsert(RedisModuleCtx *ctx, GraphContext *gc, RedisModuleString **argv,
 	}
 	argc -= 2;
 
+	if(node_token_count < 0 || relation_token_count < 0 ||
+	   node_token_count + relation_token_count != argc) {
+		RedisModule_ReplyWithError(ctx, "Bulk insert format error, token count mismatch.");
+		return BULK_FAIL;
+	}
+
 	if(node_token_count > 0) {
 		int rc = _BulkInsert_InsertNodes(ctx, gc, node_token_count, &argv, &argc);
 		if(rc != BULK_OK) {
@@ -213,7 +468,7 @@ int BulkInsert(RedisModuleCtx *ctx, GraphContext *gc, RedisModuleString **argv,
 	}
 
 	if(relation_token_count > 0) {
-		int rc = _BulkInsert_Insert_Edges(ctx, gc, relation_token_count, &argv, &argc);
+		int rc = _BulkInsert_Insert_Edges(ctx, gc, key, relation_token_count, &argv, &argc);
 		if(rc != BULK_OK) {
 			return BULK_FAIL;
 		} else if(argc == 0) {
@@ -225,4 +480,3 @@ int BulkInsert(RedisModuleCtx *ctx, GraphContext *gc, RedisModuleString **argv,
 
 	return BULK_OK;
 }
-
@@ -10,20 +10,44 @@
 #include "../redismodule.h"
 #include "../graph/graph.h"
 #include "../graph/graphcontext.h"
+#include "../index/index.h"
 
 #define BULK_OK 1
 #define BULK_FAIL 0
 
+// The first byte of each property in the binary stream
+// is used to indicate the type of the subsequent SIValue
+typedef enum {
+	BI_NULL,
+	BI_BOOL,
+	BI_DOUBLE,
+	BI_STRING,
+	BI_LONG,
+	BI_ARRAY,
+	BI_POINT
+} TYPE;
+
+// Identifies relation endpoints by the value of an indexed node attribute.
+typedef struct {
+	const char *label;          // Label of endpoint nodes.
+	const char *attribute;      // Key attribute.
+	Attribute_ID attribute_id;  // Key attribute ID.
+	Index *idx;                 // Exact-match index of label over attribute.
+} BulkInsertKey;
+
 /*
  * Bulk insert performs fast insertion of large amount of data,
  * it's an alternative to Cypher's CREATE query, one should prefer using
  * bulk insert over CREATE queries when constructing a fairly large
- * (thousands of entities) new graph. */
+ * (thousands of entities) new graph.
+ * Graphs which are already populated can be extended as well, in which case new relations
+ * may connect existing nodes, identified either by ID or by key. */
 
 /* Parse bulk insert format and inserts new entities */
 int BulkInsert(
 	RedisModuleCtx *ctx,        // Redis thread-safe context.
 	GraphContext *gc,           // GraphContext hosting schemas and Graph.
+	const BulkInsertKey *key,   // Optional, identifies relation endpoints by key.
 	RedisModuleString **argv,   // Arguments passed to bulk insert command.
 	int argc                    // Number of elements in argv.
 );
@@ -0,0 +1,340 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "change_feed.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+#include "../graph/graphcontext.h"
+#include <assert.h>
+#include <sys/param.h>
+
+// Names of the change types, as appended to streams.
+static const char *_change_names[] = {
+	[CHANGE_NODE_CREATED] = "node_created",
+	[CHANGE_NODE_UPDATED] = "node_updated",
+	[CHANGE_NODE_DELETED] = "node_deleted",
+	[CHANGE_EDGE_CREATED] = "edge_created",
+	[CHANGE_EDGE_UPDATED] = "edge_updated",
+	[CHANGE_EDGE_DELETED] = "edge_deleted",
+};
+
+ChangeFeed *ChangeFeed_New(void) {
+	if(change_feed_maxlen <= 0) return NULL;
+	ChangeFeed *feed = rm_malloc(sizeof(ChangeFeed));
+	feed->staged = array_new(Change, 0);
+	feed->queued = array_new(Change, 0);
+	feed->emitting = false;
+	int res = pthread_mutex_init(&feed->lock, NULL);
+	assert(res == 0);
+	return feed;
+}
+
+// Returns the current query's graph change feed, NULL if changes aren't captured.
+static inline ChangeFeed *_ChangeFeed_Current(GraphContext **gc) {
+	if(change_feed_maxlen <= 0) return NULL;
+	*gc = QueryCtx_GetGraphCtx();
+	return (*gc) ? (*gc)->changes : NULL;
+}
+
+// Stage a change of type to entity id.
+static Change *_ChangeFeed_Stage(ChangeFeed *feed, ChangeType type, EntityID id) {
+	Change c = {
+		.type = type,
+		.id = id,
+		.src = INVALID_ENTITY_ID,
+		.dest = INVALID_ENTITY_ID,
+		.labels = NULL,
+		.keys = NULL,
+		.values = NULL,
+		.version = 0,
+	};
+	feed->staged = array_append(feed->staged, c);
+	return feed->staged + array_len(feed->staged) - 1;
+}
+
+// Copy the properties of entity e into change c.
+static void _ChangeFeed_StageProperties(GraphContext *gc, Change *c, Entity *e) {
+	if(e->prop_count == 0) return;
+	EntityProperty *properties = Entity_Properties(e);
+	c->keys = array_new(const char *, e->prop_count);
+	c->values = array_new(SIValue, e->prop_count);
+	for(int i = 0; i < e->prop_count; i++) {
+		c->keys = array_append(c->keys, GraphContext_GetAttributeString(gc, properties[i].id));
+		c->values = array_append(c->values, SI_CloneValue(properties[i].value));
+	}
+}
+
+// Stage the relationship type and endpoints of edge e into change c.
+static void _ChangeFeed_StageEdge(GraphContext *gc, Change *c, const Edge *e, int relation) {
+	c->src = Edge_GetSrcNodeID(e);
+	c->dest = Edge_GetDestNodeID(e);
+	if(relation == GRAPH_NO_RELATION) return;
+	Schema *s = GraphContext_GetSchemaByID(gc, relation, SCHEMA_EDGE);
+	c->labels = array_new(const char *, 1);
+	c->labels = array_append(c->labels, s->name);
+}
+
+void ChangeFeed_NodeCreated(const Node *n, const char **labels, uint label_count) {
+	GraphContext *gc;
+	ChangeFeed *feed = _ChangeFeed_Current(&gc);
+	if(feed == NULL) return;
+
+	Change *c = _ChangeFeed_Stage(feed, CHANGE_NODE_CREATED, ENTITY_GET_ID(n));
+	if(label_count > 0) {
+		c->labels = array_new(const char *, label_count);
+		for(uint i = 0; i < label_count; i++) {
+			// Labels are named by their schemas, the caller's names are freed with the query.
+			Schema *s = GraphContext_GetSchema(gc, labels[i], SCHEMA_NODE);
+			c->labels = array_append(c->labels, s->name);
+		}
+	}
+	_ChangeFeed_StageProperties(gc, c, n->entity);
+}
+
+void ChangeFeed_EdgeCreated(const Edge *e, int relation) {
+	GraphContext *gc;
+	ChangeFeed *feed = _ChangeFeed_Current(&gc);
+	if(feed == NULL) return;
+
+	Change *c = _ChangeFeed_Stage(feed, CHANGE_EDGE_CREATED, ENTITY_GET_ID(e));
+	_ChangeFeed_StageEdge(gc, c, e, relation);
+	_ChangeFeed_StageProperties(gc, c, e->entity);
+}
+
+void ChangeFeed_PropertySet(const GraphEntity *ge, GraphEntityType type, Attribute_ID attr,
+							SIValue v) {
+	GraphContext *gc;
+	ChangeFeed *feed = _ChangeFeed_Current(&gc);
+	if(feed == NULL) return;
+
+	ChangeType t = (type == GETYPE_NODE) ? CHANGE_NODE_UPDATED : CHANGE_EDGE_UPDATED;
+	Change *c = _ChangeFeed_Stage(feed, t, ENTITY_GET_ID(ge));
+	c->keys = array_new(const char *, 1);
+	c->keys = array_append(c->keys, GraphContext_GetAttributeString(gc, attr));
+	c->values = array_new(SIValue, 1);
+	c->values = array_append(c->values, SI_CloneValue(v));
+}
+
+void ChangeFeed_NodeDeleted(const Node *n) {
+	GraphContext *gc;
+	ChangeFeed *feed = _ChangeFeed_Current(&gc);
+	if(feed == NULL) return;
+
+	_ChangeFeed_Stage(feed, CHANGE_NODE_DELETED, ENTITY_GET_ID(n));
+}
+
+void ChangeFeed_EdgeDeleted(const Edge *e) {
+	GraphContext *gc;
+	ChangeFeed *feed = _ChangeFeed_Current(&gc);
+	if(feed == NULL) return;
+
+	int relation = Edge_GetRelationID(e);
+	if(relation == GRAPH_NO_RELATION) relation = Graph_GetEdgeRelation(gc->g, (Edge *)e);
+	Change *c = _ChangeFeed_Stage(feed, CHANGE_EDGE_DELETED, ENTITY_GET_ID(e));
+	_ChangeFeed_StageEdge(gc, c, e, relation);
+}
+
+static void _Change_Free(Change *c) {
+	if(c->labels) array_free(c->labels);
+	if(c->keys) array_free(c->keys);
+	if(c->values) {
+		uint count = array_len(c->values);
+		for(uint i = 0; i < count; i++) SIValue_Free(c->values[i]);
+		array_free(c->values);
+	}
+}
+
+void ChangeFeed_Commit(RedisModuleCtx *ctx, ChangeFeed *feed, uint64_t version) {
+	if(feed == NULL) return;
+	uint count = array_len(feed->staged);
+	if(count == 0) return;
+
+	// Replicas receive the master's stream entries.
+	int flags = RedisModule_GetContextFlags(ctx);
+	if(flags & (REDISMODULE_CTX_FLAGS_SLAVE | REDISMODULE_CTX_FLAGS_LOADING)) {
+		for(uint i = 0; i < count; i++) _Change_Free(feed->staged + i);
+		array_clear(feed->staged);
+		return;
+	}
+
+	pthread_mutex_lock(&feed->lock);
+	for(uint i = 0; i < count; i++) {
+		feed->staged[i].version = version;
+		feed->queued = array_append(feed->queued, feed->staged[i]);
+	}
+	pthread_mutex_unlock(&feed->lock);
+	array_clear(feed->staged);
+}
+
+bool ChangeFeed_BeginEmit(ChangeFeed *feed) {
+	bool begin = false;
+	pthread_mutex_lock(&feed->lock);
+	if(!feed->emitting && array_len(feed->queued) > 0) {
+		feed->emitting = true;
+		begin = true;
+	}
+	pthread_mutex_unlock(&feed->lock);
+	return begin;
+}
+
+// Append value to buf as a Cypher literal, strings are single quoted.
+static void _ChangeFeed_WriteValue(SIValue v, char **buf, size_t *cap, size_t *len) {
+	if(SI_TYPE(v) & T_ARRAY) {
+		uint count = SIArray_Length(v);
+		if(*cap - *len < 2) *buf = rm_realloc(*buf, (*cap *= 2));
+		(*buf)[(*len)++] = '[';
+		for(uint i = 0; i < count; i++) {
+			if(i > 0) {
+				if(*cap - *len < 3) *buf = rm_realloc(*buf, (*cap *= 2));
+				(*buf)[(*len)++] = ',';
+				(*buf)[(*len)++] = ' ';
+			}
+			_ChangeFeed_WriteValue(SIArray_Get(v, i), buf, cap, len);
+		}
+		if(*cap - *len < 2) *buf = rm_realloc(*buf, (*cap *= 2));
+		(*buf)[(*len)++] = ']';
+	} else if(SI_TYPE(v) & T_STRING) {
+		// Every character may be escaped, in addition to the quotes.
+		size_t n = strlen(v.stringval);
+		if(*cap - *len < n * 2 + 3) *buf = rm_realloc(*buf, (*cap = *cap + n * 2 + 3));
+		(*buf)[(*len)++] = '\'';
+		for(size_t i = 0; i < n; i++) {
+			char ch = v.stringval[i];
+			if(ch == '\'' || ch == '\\') (*buf)[(*len)++] = '\\';
+			(*buf)[(*len)++] = ch;
+		}
+		(*buf)[(*len)++] = '\'';
+	} else {
+		SIValue_ToString(v, buf, cap, len);
+	}
+}
+
+static inline RedisModuleString *_ChangeFeed_Id(RedisModuleCtx *ctx, EntityID id) {
+	return RedisModule_CreateStringFromLongLong(ctx, (long long)id);
+}
+
+/* Append change c to the stream at key, as an entry holding:
+ * version, op, id, [labels | type], [src, dest], followed by
+ * a field per property, named by the property prefixed with a dot. */
+static void _ChangeFeed_Append(RedisModuleCtx *ctx, RedisModuleString *key, RedisModuleString *maxlen,
+							   const Change *c, char **buf, size_t *cap) {
+	uint prop_count = (c->keys) ? array_len(c->keys) : 0;
+	// Key, MAXLEN ~ N *, up to 6 pairs and a pair per property.
+	RedisModuleString *argv[5 + 12 + prop_count * 2];
+	int argc = 0;
+	argv[argc++] = key;
+	argv[argc++] = RedisModule_CreateString(ctx, "MAXLEN", 6);
+	argv[argc++] = RedisModule_CreateString(ctx, "~", 1);
+	argv[argc++] = maxlen;
+	argv[argc++] = RedisModule_CreateString(ctx, "*", 1);
+	int owned = argc;   // Arguments from here on are created per change.
+
+	argv[argc++] = RedisModule_CreateString(ctx, "version", 7);
+	argv[argc++] = RedisModule_CreateStringFromLongLong(ctx, (long long)c->version);
+	argv[argc++] = RedisModule_CreateString(ctx, "op", 2);
+	argv[argc++] = RedisModule_CreateString(ctx, _change_names[c->type],
+											strlen(_change_names[c->type]));
+	argv[argc++] = RedisModule_CreateString(ctx, "id", 2);
+	argv[argc++] = _ChangeFeed_Id(ctx, c->id);
+
+	bool is_edge = (c->type == CHANGE_EDGE_CREATED || c->type == CHANGE_EDGE_DELETED);
+	if(c->labels) {
+		// Multiple labels are joined as in a pattern, e.g. Person:Employee.
+		size_t len = 0;
+		uint label_count = array_len(c->labels);
+		for(uint i = 0; i < label_count; i++) {
+			size_t n = strlen(c->labels[i]);
+			if(*cap - len < n + 1) *buf = rm_realloc(*buf, (*cap = *cap + n + 1));
+			if(i > 0) (*buf)[len++] = ':';
+			memcpy(*buf + len, c->labels[i], n);
+			len += n;
+		}
+		argv[argc++] = (is_edge) ? RedisModule_CreateString(ctx, "type", 4) :
+					   RedisModule_CreateString(ctx, "labels", 6);
+		argv[argc++] = RedisModule_CreateString(ctx, *buf, len);
+	}
+	if(is_edge) {
+		argv[argc++] = RedisModule_CreateString(ctx, "src", 3);
+		argv[argc++] = _ChangeFeed_Id(ctx, c->src);
+		argv[argc++] = RedisModule_CreateString(ctx, "dest", 4);
+		argv[argc++] = _ChangeFeed_Id(ctx, c->dest);
+	}
+	for(uint i = 0; i < prop_count; i++) {
+		size_t len = 0;
+		_ChangeFeed_WriteValue(c->values[i], buf, cap, &len);
+		argv[argc++] = RedisModule_CreateStringPrintf(ctx, ".%s", c->keys[i]);
+		argv[argc++] = RedisModule_CreateString(ctx, *buf, len);
+	}
+
+	RedisModuleCallReply *reply = RedisModule_Call(ctx, "XADD", "!v", argv, (size_t)argc);
+	if(reply == NULL || RedisModule_CallReplyType(reply) == REDISMODULE_REPLY_ERROR) {
+		RedisModule_Log(ctx, "warning", "Failed appending a change to %s",
+						RedisModule_StringPtrLen(key, NULL));
+	}
+	if(reply) RedisModule_FreeCallReply(reply);
+
+	for(int i = 1; i < owned; i++) {
+		if(argv[i] != maxlen) RedisModule_FreeString(ctx, argv[i]);
+	}
+	for(int i = owned; i < argc; i++) RedisModule_FreeString(ctx, argv[i]);
+}
+
+void ChangeFeed_Emit(void *arg) {
+	GraphContext *gc = arg;
+	ChangeFeed *feed = gc->changes;
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	RedisModuleString *maxlen = RedisModule_CreateStringFromLongLong(ctx, change_feed_maxlen);
+	size_t cap = 256;
+	char *buf = rm_malloc(cap);
+
+	while(true) {
+		pthread_mutex_lock(&feed->lock);
+		Change *changes = feed->queued;
+		uint count = array_len(changes);
+		if(count == 0) {
+			// Writers committing from here on reschedule.
+			feed->emitting = false;
+			pthread_mutex_unlock(&feed->lock);
+			break;
+		}
+		feed->queued = array_new(Change, 0);
+		pthread_mutex_unlock(&feed->lock);
+
+		// Changes are appended in batches, such that the GIL isn't held for long.
+		for(uint i = 0; i < count; i += CHANGE_FEED_BATCH_SIZE) {
+			uint end = MIN(count, i + CHANGE_FEED_BATCH_SIZE);
+			RedisModule_ThreadSafeContextLock(ctx);
+			// The key follows the graph's key, which may have been renamed.
+			RedisModuleString *key = RedisModule_CreateStringPrintf(ctx, "%s" CHANGE_FEED_KEY_SUFFIX,
+																	 gc->graph_name);
+			for(uint j = i; j < end; j++) _ChangeFeed_Append(ctx, key, maxlen, changes + j, &buf, &cap);
+			RedisModule_FreeString(ctx, key);
+			RedisModule_ThreadSafeContextUnlock(ctx);
+		}
+
+		for(uint i = 0; i < count; i++) _Change_Free(changes + i);
+		array_free(changes);
+	}
+
+	rm_free(buf);
+	RedisModule_FreeString(ctx, maxlen);
+	RedisModule_FreeThreadSafeContext(ctx);
+	GraphContext_Release(gc);
+}
+
+void ChangeFeed_Free(ChangeFeed *feed) {
+	if(feed == NULL) return;
+	uint count = array_len(feed->staged);
+	for(uint i = 0; i < count; i++) _Change_Free(feed->staged + i);
+	array_free(feed->staged);
+	count = array_len(feed->queued);
+	for(uint i = 0; i < count; i++) _Change_Free(feed->queued + i);
+	array_free(feed->queued);
+	pthread_mutex_destroy(&feed->lock);
+	rm_free(feed);
+}
@@ -0,0 +1,83 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "../value.h"
+#include "../redismodule.h"
+#include "../graph/entities/node.h"
+#include "../graph/entities/edge.h"
+
+// Suffix of the key holding a graph's change stream, following the graph's key.
+#define CHANGE_FEED_KEY_SUFFIX ":changes"
+// Maximum number of changes appended to a stream per acquisition of the GIL.
+#define CHANGE_FEED_BATCH_SIZE 256
+
+extern long long change_feed_maxlen;    // Approximate number of stream entries retained, 0 disables.
+
+// Kind of captured mutation.
+typedef enum {
+	CHANGE_NODE_CREATED,
+	CHANGE_NODE_UPDATED,
+	CHANGE_NODE_DELETED,
+	CHANGE_EDGE_CREATED,
+	CHANGE_EDGE_UPDATED,
+	CHANGE_EDGE_DELETED,
+} ChangeType;
+
+/* A mutation of a single entity, names are borrowed from the graph's
+ * schemas and attribute mapping, which outlive the graph's changes. */
+typedef struct {
+	ChangeType type;        // Kind of mutation.
+	EntityID id;            // Mutated entity.
+	NodeID src;             // Source node of an edge.
+	NodeID dest;            // Destination node of an edge.
+	const char **labels;    // Labels of a created node, or an edge's relationship type, NULL if none.
+	const char **keys;      // Names of the properties set, NULL if none.
+	SIValue *values;        // Values of the properties set, owned by the change.
+	uint64_t version;       // Write version of the graph once the mutation committed.
+} Change;
+
+/* Mutations of a graph awaiting its change stream. Writers stage the changes they commit,
+ * once the commit is released the staged changes are queued and a thread pool job appends
+ * them to the stream in batches, holding the GIL but not the graph's lock. */
+typedef struct {
+	Change *staged;         // Changes of the committing writer, guarded by the graph's write lock.
+	Change *queued;         // Committed changes not yet appended, guarded by lock.
+	bool emitting;          // A job appending the queued changes is scheduled or running.
+	pthread_mutex_t lock;   // Guards the queued changes.
+} ChangeFeed;
+
+// Create a change feed, returns NULL if changes aren't captured.
+ChangeFeed *ChangeFeed_New(void);
+
+/* Capture a mutation of the current query's graph, expects the write lock.
+ * Created entities are captured once their properties are set. */
+void ChangeFeed_NodeCreated(const Node *n, const char **labels, uint label_count);
+void ChangeFeed_EdgeCreated(const Edge *e, int relation);
+void ChangeFeed_PropertySet(const GraphEntity *ge, GraphEntityType type, Attribute_ID attr,
+							SIValue v);
+// Captured prior to deleting the entity, deleted nodes imply the deletion of their edges.
+void ChangeFeed_NodeDeleted(const Node *n);
+void ChangeFeed_EdgeDeleted(const Edge *e);
+
+/* Queue the staged changes as committed at version, expects the write lock.
+ * Changes applied by replicas or while loading are discarded,
+ * their stream is replicated and persisted along with the graph. */
+void ChangeFeed_Commit(RedisModuleCtx *ctx, ChangeFeed *feed, uint64_t version);
+
+/* Marks the feed as emitting, returns false if there's nothing to emit,
+ * or changes are already being emitted. */
+bool ChangeFeed_BeginEmit(ChangeFeed *feed);
+
+/* Runs on a thread pool thread, appends the graph's queued changes to its stream,
+ * an entry per change, until none are left. */
+void ChangeFeed_Emit(void *arg);
+
+void ChangeFeed_Free(ChangeFeed *feed);
@@ -6,9 +6,11 @@
 
 #include "cmd_bulk_insert.h"
 #include "./cmd_context.h"
+#include "cmd_view.h"
 #include "../graph/graph.h"
 #include "../bulk_insert/bulk_insert.h"
 #include "../util/rmalloc.h"
+#include "../schema/schema.h"
 
 void _MGraph_BulkInsert(void *args) {
 	// Establish thread-safe environment for batch insertion
@@ -25,9 +27,16 @@ void _MGraph_BulkInsert(void *args) {
 	int len;
 
 	GraphContext *gc = NULL;
+	bool begin = false;
+	bool inserted = false;
+
+	// Optional relation endpoints key, GRAPH.BULK graph nodes edges KEY label attribute ...
+	BulkInsertKey key_desc;
+	BulkInsertKey *endpoint_key = NULL;
 
 	// Number of entities already created
 	size_t initial_node_count = 0;
+	size_t initial_edge_count = 0;
 
 	// Number of entities being created in this query
 	// (declared as long longs to match Redis conversion function)
@@ -37,6 +46,7 @@ void _MGraph_BulkInsert(void *args) {
 	if(!strcmp(RedisModule_StringPtrLen(*argv, 0), "BEGIN")) {
 		argv ++;
 		argc --;
+		begin = true;
 		// Verify that graph does not already exist.
 		key = RedisModule_OpenKey(ctx, rs_graph_name, REDISMODULE_READ);
 		RedisModule_CloseKey(key);
@@ -62,8 +72,46 @@ void _MGraph_BulkInsert(void *args) {
 	}
 	argc -= 2; // already read node count and edge count
 
-	gc = GraphContext_Retrieve(ctx, rs_graph_name, false, true);
+	if(argc > 0 && !strcasecmp(RedisModule_StringPtrLen(*argv, NULL), "KEY")) {
+		if(argc < 3) {
+			RedisModule_ReplyWithError(ctx, "Error parsing relation endpoints key, expecting KEY label attribute.");
+			goto cleanup;
+		}
+		key_desc.label = RedisModule_StringPtrLen(argv[1], NULL);
+		key_desc.attribute = RedisModule_StringPtrLen(argv[2], NULL);
+		argv += 3;
+		argc -= 3;
+		endpoint_key = &key_desc;
+	}
+
+	// Relations identified by key can only extend an existing graph.
+	gc = GraphContext_Retrieve(ctx, rs_graph_name, false, endpoint_key == NULL);
+	if(gc == NULL) {
+		RedisModule_ReplyWithError(ctx, endpoint_key ? "Relation endpoints key requires an existing graph." :
+								   "Redis key holds a value of a different type.");
+		goto cleanup;
+	}
+
+	if(endpoint_key) {
+		// Endpoints are resolved through the key's exact-match index.
+		Schema *s = GraphContext_GetSchema(gc, endpoint_key->label, SCHEMA_NODE);
+		endpoint_key->idx = (s) ? Schema_GetIndex(s, endpoint_key->attribute, IDX_EXACT_MATCH) : NULL;
+		if(endpoint_key->idx == NULL || !Index_IsOperational(endpoint_key->idx)) {
+			char *err;
+			asprintf(&err, (endpoint_key->idx == NULL) ?
+					 "Relation endpoints key requires an exact-match index on :%s(%s)." :
+					 "Relation endpoints key index on :%s(%s) is still under construction.",
+					 endpoint_key->label, endpoint_key->attribute);
+			RedisModule_ReplyWithError(ctx, err);
+			free(err);
+			GraphContext_Release(gc);
+			gc = NULL;
+			goto cleanup;
+		}
+		endpoint_key->attribute_id = GraphContext_GetAttributeID(gc, endpoint_key->attribute);
+	}
 	initial_node_count = Graph_NodeCount(gc->g);
+	initial_edge_count = Graph_EdgeCount(gc->g);
 
 	// Lock the graph for writing.
 	Graph_AcquireWriteLock(gc->g);
@@ -71,19 +119,29 @@ void _MGraph_BulkInsert(void *args) {
 	// Disable matrix synchronization for bulk insert operation
 	Graph_SetMatrixPolicy(gc->g, RESIZE_TO_CAPACITY);
 
-	// Allocate or extend datablocks to accommodate all incoming entities
+	/* Allocate or extend datablocks to accommodate all incoming entities,
+	 * a newly created graph sizes its blocks accordingly. */
 	Graph_AllocateNodes(gc->g, nodes_in_query + initial_node_count);
+	Graph_AllocateEdges(gc->g, relations_in_query + initial_edge_count);
 
-	int rc = BulkInsert(ctx, gc, argv, argc);
+	int rc = BulkInsert(ctx, gc, endpoint_key, argv, argc);
 
 	if(rc == BULK_FAIL) {
-		// If insertion failed, clean up keyspace and free added entities.
-		key = RedisModule_OpenKey(ctx, rs_graph_name, REDISMODULE_WRITE);
-		RedisModule_DeleteKey(key);
-		gc = NULL;
+		/* If insertion failed, a graph created by this command is removed from the keyspace,
+		 * an extended graph retains the nodes introduced prior to the failure,
+		 * relations are only introduced once all of their endpoints are valid. */
+		if(begin) {
+			key = RedisModule_OpenKey(ctx, rs_graph_name, REDISMODULE_WRITE);
+			RedisModule_DeleteKey(key);
+			gc = NULL;
+		}
 		goto cleanup;
 	}
 
+	inserted = true;
+	// Replicas advance their version as they apply the replicated command.
+	GraphContext_AdvanceWriteVersion(gc);
+
 	// Replay to caller.
 	len = snprintf(reply, 1024, "%llu nodes created, %llu edges created",
 				   nodes_in_query, relations_in_query);
@@ -92,6 +150,8 @@ void _MGraph_BulkInsert(void *args) {
 cleanup:
 	if(gc) {
 		Graph_ReleaseLock(gc->g);
+		// Views reflect the inserted entities.
+		if(inserted) Graph_RefreshViews(command_ctx, gc);
 		GraphContext_Release(gc);
 	}
 	CommandCtx_ThreadSafeContextUnlock(command_ctx);
@@ -7,9 +7,6 @@
 #pragma once
 
 #include "../redismodule.h"
-#include "../util/thpool/thpool.h"
-
-extern threadpool _thpool;
 
 /* Multi threaded bulk insert context. */
 typedef struct {
@@ -0,0 +1,182 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_compact.h"
+#include "cmd_view.h"
+#include "cmd_context.h"
+#include "../query_ctx.h"
+#include "../graph/graph.h"
+#include "../graph/graphcontext.h"
+#include "../graph/serializers/graphcontext_type.h"
+#include "../algorithms/node_ordering.h"
+#include "../util/rmalloc.h"
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+// Checks that graph key still holds the graph context.
+static bool _Compact_VerifyKey(RedisModuleCtx *ctx, GraphContext *gc) {
+	RedisModuleString *graphID = RedisModule_CreateString(ctx, gc->graph_name,
+														  strlen(gc->graph_name));
+	RedisModuleKey *key = RedisModule_OpenKey(ctx, graphID, REDISMODULE_READ);
+	RedisModule_FreeString(ctx, graphID);
+	bool valid = (RedisModule_KeyType(key) == REDISMODULE_KEYTYPE_MODULE &&
+				  RedisModule_ModuleTypeGetType(key) == GraphContextRedisModuleType &&
+				  RedisModule_ModuleTypeGetValue(key) == gc);
+	RedisModule_CloseKey(key);
+	return valid;
+}
+
+/* Entity IDs changed, rebuild the indices of renumbered entities,
+ * edge indices record their endpoints, and are rebuilt either way. */
+static void _Compact_RebuildIndices(GraphContext *gc, bool nodes_renumbered) {
+	unsigned short schema_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
+	for(unsigned short i = 0; nodes_renumbered && i < schema_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, i, SCHEMA_NODE);
+		if(s->index) Index_Construct(s->index);
+		if(s->fulltextIdx) Index_Construct(s->fulltextIdx);
+		uint vector_count = array_len(s->vectorIndices);
+		for(uint j = 0; j < vector_count; j++) VectorIndex_Construct(s->vectorIndices[j]);
+	}
+
+	schema_count = GraphContext_SchemaCount(gc, SCHEMA_EDGE);
+	for(unsigned short i = 0; i < schema_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, i, SCHEMA_EDGE);
+		if(s->index) Index_Construct(s->index);
+	}
+}
+
+/* Assigns nearby IDs to connected nodes, such that traversals
+ * access neighboring matrix rows and datablock items. */
+static void _Compact_ReorderNodes(Graph *g, double *distance_before, double *distance_after) {
+	GrB_Matrix A = Graph_GetAdjacencyMatrix(g);
+	GrB_Matrix AT = Graph_GetTransposedRelationMatrix(g, GRAPH_NO_RELATION);
+	*distance_before = NodeOrdering_MeanDistance(A);
+
+	GrB_Index *perm = ReverseCuthillMcKee(A, AT);
+	Graph_PermuteNodes(g, perm);
+	rm_free(perm);
+
+	*distance_after = NodeOrdering_MeanDistance(Graph_GetAdjacencyMatrix(g));
+}
+
+/* Packs the properties of entities not accessed since the previous packing,
+ * returns the number of entities packed. */
+static uint64_t _Compact_PackProperties(Graph *g) {
+	uint64_t packed = 0;
+	Entity *e;
+	DataBlockIterator *iter = Graph_ScanNodes(g);
+	while((e = DataBlockIterator_Next(iter))) packed += Entity_Pack(e);
+	DataBlockIterator_Free(iter);
+
+	iter = Graph_ScanEdges(g);
+	while((e = DataBlockIterator_Next(iter))) packed += Entity_Pack(e);
+	DataBlockIterator_Free(iter);
+	return packed;
+}
+
+/* Renumbers graph nodes and edges densely, reclaiming the IDs of deleted entities
+ * and shrinking graph matrices accordingly.
+ * Args:
+ * argv[1] graph name
+ * argv[2..3] optional REORDER, renumber nodes by locality,
+ * and PACK, pack the properties of entities not accessed since last packed */
+void Graph_Compact(void *args) {
+	char *reply = NULL;
+	bool reorder = false;
+	bool pack = false;
+	uint64_t entities_packed = 0;
+	double distance_before = 0;
+	double distance_after = 0;
+	uint64_t nodes_reclaimed = 0;
+	uint64_t edges_reclaimed = 0;
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	Graph *g = gc->g;
+
+	QueryCtx_BeginTimer();
+	QueryCtx_SetGlobalExecutionCtx(command_ctx);
+
+	if(command_ctx->argc < 2 || command_ctx->argc > 4) {
+		RedisModule_WrongArity(ctx);
+		goto cleanup;
+	}
+	for(int i = 2; i < command_ctx->argc; i++) {
+		const char *option = RedisModule_StringPtrLen(command_ctx->argv[i], NULL);
+		if(strcasecmp(option, "REORDER") == 0) {
+			reorder = true;
+		} else if(strcasecmp(option, "PACK") == 0) {
+			pack = true;
+		} else {
+			RedisModule_ReplyWithError(ctx, "Unknown GRAPH.COMPACT option, expecting REORDER or PACK.");
+			goto cleanup;
+		}
+	}
+
+	/* Compaction renumbers entities, exclude writers and readers,
+	 * and hold the GIL such that the graph isn't persisted midway. */
+	Graph_WriterEnter(g);
+	CommandCtx_ThreadSafeContextLock(command_ctx);
+	if(!_Compact_VerifyKey(ctx, gc)) {
+		CommandCtx_ThreadSafeContextUnlock(command_ctx);
+		Graph_WriterLeave(g);
+		RedisModule_ReplyWithError(ctx, "Graph is either missing or referred key is of a different type.");
+		goto cleanup;
+	}
+
+	Graph_AcquireWriteLock(g);
+	Graph_SetMatrixPolicy(g, SYNC_AND_MINIMIZE_SPACE);
+	Graph_Defragment(g, &nodes_reclaimed, &edges_reclaimed);
+	if(reorder) _Compact_ReorderNodes(g, &distance_before, &distance_after);
+	if(nodes_reclaimed > 0 || reorder) _Compact_RebuildIndices(gc, true);
+	else if(edges_reclaimed > 0) _Compact_RebuildIndices(gc, false);
+	// Packing only affects memory layout, it is not replicated.
+	if(pack) entities_packed = _Compact_PackProperties(g);
+
+	// Replicas renumber their entities identically.
+	if(reorder) {
+		RedisModule_Replicate(ctx, "GRAPH.COMPACT", "cc", gc->graph_name, "REORDER");
+	} else if(nodes_reclaimed > 0 || edges_reclaimed > 0) {
+		RedisModule_Replicate(ctx, "GRAPH.COMPACT", "c", gc->graph_name);
+	}
+
+	Graph_ReleaseLock(g);
+	CommandCtx_ThreadSafeContextUnlock(command_ctx);
+	Graph_WriterLeave(g);
+
+	if(reorder) {
+		asprintf(&reply,
+				 "Reclaimed %llu node IDs and %llu relationship IDs, mean neighbor ID distance %.2f before and %.2f after reordering, internal execution time: %.6f milliseconds",
+				 (unsigned long long)nodes_reclaimed, (unsigned long long)edges_reclaimed,
+				 distance_before, distance_after, QueryCtx_GetExecutionTime());
+	} else {
+		asprintf(&reply,
+				 "Reclaimed %llu node IDs and %llu relationship IDs, internal execution time: %.6f milliseconds",
+				 (unsigned long long)nodes_reclaimed, (unsigned long long)edges_reclaimed,
+				 QueryCtx_GetExecutionTime());
+	}
+	if(pack) {
+		char *packed_reply;
+		asprintf(&packed_reply, "%s, packed the properties of %llu entities", reply,
+				 (unsigned long long)entities_packed);
+		free(reply);
+		reply = packed_reply;
+	}
+	RedisModule_ReplyWithStringBuffer(ctx, reply, strlen(reply));
+	free(reply);
+
+	// Views hold node IDs, which compaction renumbers.
+	if(nodes_reclaimed > 0 || reorder) {
+		QueryCtx_Free();
+		Graph_RefreshViews(command_ctx, gc);
+	}
+
+cleanup:
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
+}
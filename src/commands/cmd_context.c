@@ -2,7 +2,13 @@
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
 #include "../slow_log/slow_log.h"
+#include "rax.h"
 #include <assert.h>
+#include <pthread.h>
+
+// Commands reporting their progress, keyed by blocked client.
+static rax *_tracked = NULL;
+static pthread_mutex_t _tracked_lock = PTHREAD_MUTEX_INITIALIZER;
 
 CommandCtx *CommandCtx_New
 (
@@ -24,6 +30,10 @@ CommandCtx *CommandCtx_New
 	context->command_name = NULL;
 	context->graph_ctx = graph_ctx;
 	context->replicated_command = replicated_command;
+	context->tracked = NULL;
+	context->progress.records = 0;
+	context->progress.op = NULL;
+	context->progress.cancelled = false;
 
 	size_t len;
 	if(cmd_name) {
@@ -91,7 +101,37 @@ void CommandCtx_ThreadSafeContextUnlock(const CommandCtx *command_ctx) {
 	if(command_ctx->bc) RedisModule_ThreadSafeContextUnlock(command_ctx->ctx);
 }
 
+void CommandCtx_TrackProgress(CommandCtx *command_ctx) {
+	assert(command_ctx->bc);
+	pthread_mutex_lock(&_tracked_lock);
+	if(_tracked == NULL) _tracked = raxNew();
+	command_ctx->tracked = command_ctx->bc;
+	raxInsert(_tracked, (unsigned char *)&command_ctx->tracked, sizeof(command_ctx->tracked),
+			  command_ctx, NULL);
+	pthread_mutex_unlock(&_tracked_lock);
+}
+
+bool CommandCtx_CancelBlocked(RedisModuleBlockedClient *bc, QueryProgress *progress) {
+	pthread_mutex_lock(&_tracked_lock);
+	CommandCtx *command_ctx = (_tracked) ? raxFind(_tracked, (unsigned char *)&bc, sizeof(bc)) :
+							  raxNotFound;
+	bool found = (command_ctx != raxNotFound);
+	if(found) {
+		progress->records = __atomic_load_n(&command_ctx->progress.records, __ATOMIC_RELAXED);
+		progress->op = __atomic_load_n(&command_ctx->progress.op, __ATOMIC_RELAXED);
+		__atomic_store_n(&command_ctx->progress.cancelled, true, __ATOMIC_RELAXED);
+	}
+	pthread_mutex_unlock(&_tracked_lock);
+	return found;
+}
+
 void CommandCtx_Free(CommandCtx *command_ctx) {
+	if(command_ctx->tracked) {
+		pthread_mutex_lock(&_tracked_lock);
+		raxRemove(_tracked, (unsigned char *)&command_ctx->tracked, sizeof(command_ctx->tracked),
+				  NULL);
+		pthread_mutex_unlock(&_tracked_lock);
+	}
 	if(command_ctx->bc) {
 		RedisModule_UnblockClient(command_ctx->bc, NULL);
 		RedisModule_FreeThreadSafeContext(command_ctx->ctx);
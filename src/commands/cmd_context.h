@@ -10,6 +10,14 @@
 #include "../redismodule.h"
 #include "../graph/graphcontext.h"
 
+/* Progress of a running query, published by the thread executing it
+ * and read by the main thread once the query's client times out. */
+typedef struct {
+	uint64_t records;               // Number of records produced.
+	const char *op;                 // Name of an operation being executed, NULL before execution.
+	bool cancelled;                 // The client was released, the query is to be aborted.
+} QueryProgress;
+
 /* Query context, used for concurent query processing. */
 typedef struct {
 	char *query;                    // Query string.
@@ -20,6 +28,8 @@ typedef struct {
 	RedisModuleBlockedClient *bc;   // Blocked client.
 	int argc;                       // Argument count.
 	bool replicated_command;        // Whether this instance was spawned by a replication command.
+	RedisModuleBlockedClient *tracked; // Blocked client whose timeout callback reads progress, if any.
+	QueryProgress progress;         // Query progress.
 } CommandCtx;
 
 // Create a new command context.
@@ -76,6 +86,21 @@ void CommandCtx_ThreadSafeContextUnlock
 	const CommandCtx *command_ctx
 );
 
+/* Report the command's progress to the timeout callback of its blocked client,
+ * until the command context is freed. */
+void CommandCtx_TrackProgress
+(
+	CommandCtx *command_ctx
+);
+
+/* Retrieve the progress of the command issued by blocked client bc,
+ * marking the command as cancelled. Returns false if no such command is tracked. */
+bool CommandCtx_CancelBlocked
+(
+	RedisModuleBlockedClient *bc,
+	QueryProgress *progress
+);
+
 // Free command context.
 void CommandCtx_Free
 (
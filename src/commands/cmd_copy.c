@@ -0,0 +1,86 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_copy.h"
+#include "cmd_context.h"
+#include "../query_ctx.h"
+#include "../graph/graph.h"
+#include "../graph/graphcontext.h"
+#include "../graph/serializers/graphcontext_type.h"
+#include <stdio.h>
+#include <string.h>
+
+// Returns true if key doesn't exist, expects the GIL to be held.
+static bool _Copy_KeyIsEmpty(RedisModuleCtx *ctx, RedisModuleString *name) {
+	RedisModuleKey *key = RedisModule_OpenKey(ctx, name, REDISMODULE_READ);
+	bool empty = (RedisModule_KeyType(key) == REDISMODULE_KEYTYPE_EMPTY);
+	RedisModule_CloseKey(key);
+	return empty;
+}
+
+/* Copies a graph into a new key, entities retain their IDs.
+ * The source is copied under its read lock, such that queries
+ * against it proceed while the copy is made.
+ * Args:
+ * argv[1] source graph name
+ * argv[2] destination graph name, must not exist */
+void Graph_Copy(void *args) {
+	char *reply = NULL;
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	QueryCtx_BeginTimer();
+	QueryCtx_SetGlobalExecutionCtx(command_ctx);
+
+	if(command_ctx->argc != 3) {
+		RedisModule_WrongArity(ctx);
+		goto cleanup;
+	}
+
+	RedisModuleString *rs_dest = command_ctx->argv[2];
+	const char *dest = RedisModule_StringPtrLen(rs_dest, NULL);
+
+	// Fail early rather than copying a graph that can't be stored.
+	CommandCtx_ThreadSafeContextLock(command_ctx);
+	bool available = _Copy_KeyIsEmpty(ctx, rs_dest);
+	CommandCtx_ThreadSafeContextUnlock(command_ctx);
+	if(!available) {
+		RedisModule_ReplyWithError(ctx, "Destination key already exists.");
+		goto cleanup;
+	}
+
+	Graph_AcquireReadLock(gc->g);
+	GraphContext *clone = GraphContext_Clone(gc, dest);
+	Graph_ReleaseLock(gc->g);
+
+	// Destination might have been introduced while copying.
+	CommandCtx_ThreadSafeContextLock(command_ctx);
+	if(!_Copy_KeyIsEmpty(ctx, rs_dest)) {
+		CommandCtx_ThreadSafeContextUnlock(command_ctx);
+		GraphContext_Delete(clone);
+		RedisModule_ReplyWithError(ctx, "Destination key already exists.");
+		goto cleanup;
+	}
+	RedisModuleKey *key = RedisModule_OpenKey(ctx, rs_dest, REDISMODULE_WRITE);
+	RedisModule_ModuleTypeSetValue(key, GraphContextRedisModuleType, clone);
+	RedisModule_CloseKey(key);
+	// Register graph context for BGSave.
+	GraphContext_RegisterWithModule(clone);
+	RedisModule_Replicate(ctx, "GRAPH.COPY", "cc", gc->graph_name, dest);
+	CommandCtx_ThreadSafeContextUnlock(command_ctx);
+
+	asprintf(&reply, "Copied %llu nodes and %llu relationships, internal execution time: %.6f milliseconds",
+			 (unsigned long long)Graph_NodeCount(clone->g),
+			 (unsigned long long)Graph_EdgeCount(clone->g), QueryCtx_GetExecutionTime());
+	RedisModule_ReplyWithStringBuffer(ctx, reply, strlen(reply));
+	free(reply);
+
+cleanup:
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
+}
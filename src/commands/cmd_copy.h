@@ -0,0 +1,11 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../redismodule.h"
+
+void Graph_Copy(void *args);
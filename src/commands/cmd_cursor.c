@@ -0,0 +1,202 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_cursor.h"
+#include "../query_ctx.h"
+#include "../graph/graph.h"
+#include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
+#include "../util/thpool/pools.h"
+#include <string.h>
+#include <strings.h>
+
+// A read-only query suspended between reads of its records.
+typedef struct {
+	ExecutionPlan *plan;                        // Suspended plan.
+	ResultSet *result_set;                      // Query result set, rebound by each read.
+	CachedPlan *cached_plan;                    // Cache entry owning the AST, if any.
+	AST *ast;                                   // Query AST.
+	cypher_parse_result_t *parse_result;        // Query parse result.
+	cypher_parse_result_t *params_parse_result; // Parse result referenced by parameter values.
+	char *query;                                // Query string.
+	QueryCtx *query_ctx;                        // Detached QueryCtx of the query.
+	uint64_t count;                             // Default number of records replied per read.
+	uint64_t version;                           // Graph version the plan's iterators were created at.
+} QueryCursor;
+
+// Free cursor, expects its QueryCtx to be attached to the current thread.
+static void _QueryCursor_Release(QueryCursor *cursor) {
+	ExecutionPlan_Free(cursor->plan);
+	ResultSet_Free(cursor->result_set);
+	if(cursor->cached_plan) {
+		CachedPlan_Release(cursor->cached_plan);
+	} else {
+		AST_Free(cursor->ast);
+		parse_result_free(cursor->parse_result);
+	}
+	QueryCtx_Free();
+	parse_result_free(cursor->params_parse_result);
+	rm_free(cursor->query);
+	rm_free(cursor);
+}
+
+// Free a suspended cursor, invoked by the cursors registry on any thread.
+static void _QueryCursor_Free(void *arg) {
+	QueryCursor *cursor = arg;
+	// Set the current thread's QueryCtx aside while freeing the cursor's.
+	QueryCtx *current = QueryCtx_Detach();
+	QueryCtx_Attach(cursor->query_ctx);
+	_QueryCursor_Release(cursor);
+	if(current) QueryCtx_Attach(current);
+}
+
+// Detach the cursor's QueryCtx and return the cursor to the registry.
+static void _QueryCursor_Put(GraphContext *gc, uint64_t id, QueryCursor *cursor) {
+	cursor->query_ctx = QueryCtx_Detach();
+	// The command issuing the query is freed, the query is owned by the cursor.
+	cursor->query_ctx->query_data.query = cursor->query;
+	Cursors_Put(GraphContext_GetCursors(gc), id, cursor, _QueryCursor_Free);
+}
+
+void QueryCursor_Suspend(GraphContext *gc, uint64_t id, uint64_t count, uint64_t version,
+						 const char *query, ExecutionPlan *plan, ResultSet *set,
+						 CachedPlan *cached_plan, AST *ast, cypher_parse_result_t *parse_result,
+						 cypher_parse_result_t *params_parse_result) {
+	QueryCursor *cursor = rm_malloc(sizeof(QueryCursor));
+	cursor->plan = plan;
+	cursor->result_set = set;
+	cursor->cached_plan = cached_plan;
+	cursor->ast = ast;
+	cursor->parse_result = parse_result;
+	cursor->params_parse_result = params_parse_result;
+	cursor->query = rm_strdup(query);
+	cursor->count = count;
+	cursor->version = version;
+	_QueryCursor_Put(gc, id, cursor);
+}
+
+// Reply with the next count records of cursor id, 0 reads the cursor's default count.
+static void _Cursor_Read(CommandCtx *command_ctx, GraphContext *gc, uint64_t id, uint64_t count) {
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	Cursors *cursors = GraphContext_GetCursors(gc);
+	QueryCursor *cursor = Cursors_Take(cursors, id);
+	if(cursor == NULL) {
+		RedisModule_ReplyWithError(ctx, "Cursor is either unknown or being read");
+		return;
+	}
+	if(count == 0) count = cursor->count;
+
+	// Resume the query on the current thread.
+	QueryCtx_Attach(cursor->query_ctx);
+	cursor->query_ctx = NULL;
+	QueryCtx_SetResumedExecutionCtx(command_ctx);
+	QueryCtx_BeginTimer();
+	if(ThreadPools_CurrentLane() != THPOOL_LANE_COUNT) QueryCtx_SetQueueWait(ThreadPools_CurrentWait());
+	ResultSet_Rebind(cursor->result_set, ctx);
+
+	/* The graph's lock isn't held between reads, the plan's iterators are only valid
+	 * as long as no writer acquired the graph since the cursor was opened. */
+	double wait_timer[2];
+	simple_tic(wait_timer);
+	Graph_AcquireReadLock(gc->g);
+	QueryCtx_AddLockWait(simple_toc(wait_timer) * 1000);
+	if(gc->g->version != cursor->version) {
+		Graph_ReleaseLock(gc->g);
+		RedisModule_ReplyWithError(ctx, "Cursor invalidated, the graph was modified since it was opened");
+		Cursors_Remove(cursors, id);
+		_QueryCursor_Release(cursor);
+		return;
+	}
+
+	Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
+	bool depleted = ExecutionPlan_ExecuteLimit(cursor->plan, count);
+	cursor->result_set->cursor = (depleted) ? 0 : id;
+	double reply_timer[2];
+	simple_tic(reply_timer);
+	ResultSet_Reply(cursor->result_set);
+	double reply_time = simple_toc(reply_timer) * 1000;
+	Graph_ReleaseLock(gc->g);
+
+	SlowLog *slowlog = GraphContext_GetSlowLog(gc);
+	SlowLogStats stats = {
+		.latency = QueryCtx_GetExecutionTime(),
+		.lock_wait = QueryCtx_GetLockWait(),
+		.queue_wait = QueryCtx_GetQueueWait(),
+		.matrix_sync = QueryCtx_GetMatrixSync(),
+		.reply = reply_time,
+		.rows = cursor->result_set->recordCount,
+		.peak_memory = QueryCtx_GetPeakMemory()
+	};
+	if(SlowLog_Considers(stats.latency)) stats.plan_fingerprint = ExecutionPlan_Fingerprint(cursor->plan);
+	SlowLog_Add(slowlog, command_ctx->command_name, cursor->query, &stats);
+	Graph_RecordLatency(gc->g, GRAPH_LATENCY_READ_QUERY, stats.latency);
+
+	if(depleted) {
+		Cursors_Remove(cursors, id);
+		_QueryCursor_Release(cursor);
+	} else {
+		_QueryCursor_Put(gc, id, cursor);
+	}
+}
+
+static void _Cursor_Delete(CommandCtx *command_ctx, GraphContext *gc, uint64_t id) {
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	Cursors *cursors = GraphContext_GetCursors(gc);
+	QueryCursor *cursor = Cursors_Take(cursors, id);
+	if(cursor == NULL) {
+		RedisModule_ReplyWithError(ctx, "Cursor is either unknown or being read");
+		return;
+	}
+
+	Cursors_Remove(cursors, id);
+	_QueryCursor_Free(cursor);
+	RedisModule_ReplyWithSimpleString(ctx, "OK");
+}
+
+/* Reads the records of a query suspended by the cursor option of GRAPH.QUERY,
+ * replying with a page of records, the page's statistics hold the cursor to read
+ * the following page through, 0 once the query is depleted.
+ * Args:
+ * argv[1] graph name
+ * argv[2] READ <cursor> [COUNT <count>] | DEL <cursor> */
+void Graph_Cursor(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	long long id = 0;
+	long long count = 0;
+	const char *op = (command_ctx->argc > 2) ?
+					 RedisModule_StringPtrLen(command_ctx->argv[2], NULL) : "";
+	bool read = (strcasecmp(op, "READ") == 0 &&
+				 (command_ctx->argc == 4 || command_ctx->argc == 6));
+	bool del = (strcasecmp(op, "DEL") == 0 && command_ctx->argc == 4);
+
+	if(!read && !del) {
+		RedisModule_WrongArity(ctx);
+		goto cleanup;
+	}
+	if(RedisModule_StringToLongLong(command_ctx->argv[3], &id) != REDISMODULE_OK || id <= 0) {
+		RedisModule_ReplyWithError(ctx, "Invalid cursor");
+		goto cleanup;
+	}
+	if(command_ctx->argc == 6) {
+		const char *arg = RedisModule_StringPtrLen(command_ctx->argv[4], NULL);
+		if(strcasecmp(arg, "COUNT") != 0 ||
+		   RedisModule_StringToLongLong(command_ctx->argv[5], &count) != REDISMODULE_OK ||
+		   count <= 0) {
+			RedisModule_ReplyWithError(ctx, "Failed to parse cursor count");
+			goto cleanup;
+		}
+	}
+
+	if(read) _Cursor_Read(command_ctx, gc, id, count);
+	else _Cursor_Delete(command_ctx, gc, id);
+
+cleanup:
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
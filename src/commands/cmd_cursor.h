@@ -0,0 +1,25 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "cmd_context.h"
+#include "../ast/ast.h"
+#include "../resultset/resultset.h"
+#include "../execution_plan/plan_cache.h"
+#include "../execution_plan/execution_plan.h"
+
+void Graph_Cursor(void *args);
+
+/* Suspend a read-only query once it replied with its first count records,
+ * its remaining records are read through cursor id, reserved by Cursors_Reserve.
+ * The cursor takes ownership of the plan, result set, AST and parse results,
+ * the AST is owned by cached_plan if set. The thread's QueryCtx is detached,
+ * version is the graph version the plan's iterators were created at. */
+void QueryCursor_Suspend(GraphContext *gc, uint64_t id, uint64_t count, uint64_t version,
+						 const char *query, ExecutionPlan *plan, ResultSet *set,
+						 CachedPlan *cached_plan, AST *ast, cypher_parse_result_t *parse_result,
+						 cypher_parse_result_t *params_parse_result);
@@ -8,9 +8,6 @@
 #define GRAPH_DELETE_H
 
 #include "../redismodule.h"
-#include "../util/thpool/thpool.h"
-
-extern threadpool _thpool;
 
 int MGraph_Delete(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 
@@ -6,9 +6,16 @@
 
 #include "commands.h"
 #include "cmd_context.h"
+#include "../util/thpool/pools.h"
+#include "../procedures/procedure.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
 #include <assert.h>
 #include <strings.h>
 
+extern long long default_query_timeout; // Default query timeout, defined in module.c
+
 // Command handler function pointer.
 typedef void(*Command_Handler)(void *args);
 
@@ -23,6 +30,32 @@ static Command_Handler get_command_handler(GRAPH_Commands cmd) {
 		return Graph_Profile;
 	case CMD_SLOWLOG:
 		return Graph_Slowlog;
+	case CMD_PREPARE:
+		return Graph_Prepare;
+	case CMD_EXECUTE:
+		return Graph_Execute;
+	case CMD_BATCH:
+		return Graph_Batch;
+	case CMD_RO_QUERY:
+		return Graph_ReadOnlyQuery;
+	case CMD_COMPACT:
+		return Graph_Compact;
+	case CMD_COPY:
+		return Graph_Copy;
+	case CMD_VIEW:
+		return Graph_View;
+	case CMD_PLAN:
+		return Graph_Plan;
+	case CMD_CURSOR:
+		return Graph_Cursor;
+	case CMD_FETCH:
+		return Graph_Fetch;
+	case CMD_EXPORT:
+		return Graph_Export;
+	case CMD_MEMORY:
+		return Graph_Memory;
+	case CMD_STATS:
+		return Graph_Stats;
 	default:
 		assert(false);
 	}
@@ -35,11 +68,189 @@ static GRAPH_Commands determine_command(const char *cmd_name) {
 	if(strcasecmp(cmd_name, "graph.EXPLAIN") == 0) return CMD_EXPLAIN;
 	if(strcasecmp(cmd_name, "graph.PROFILE") == 0) return CMD_PROFILE;
 	if(strcasecmp(cmd_name, "graph.SLOWLOG") == 0) return CMD_SLOWLOG;
+	if(strcasecmp(cmd_name, "graph.PREPARE") == 0) return CMD_PREPARE;
+	if(strcasecmp(cmd_name, "graph.EXECUTE") == 0) return CMD_EXECUTE;
+	if(strcasecmp(cmd_name, "graph.BATCH") == 0) return CMD_BATCH;
+	if(strcasecmp(cmd_name, "graph.RO_QUERY") == 0) return CMD_RO_QUERY;
+	if(strcasecmp(cmd_name, "graph.COMPACT") == 0) return CMD_COMPACT;
+	if(strcasecmp(cmd_name, "graph.COPY") == 0) return CMD_COPY;
+	if(strcasecmp(cmd_name, "graph.VIEW") == 0) return CMD_VIEW;
+	if(strcasecmp(cmd_name, "graph.PLAN") == 0) return CMD_PLAN;
+	if(strcasecmp(cmd_name, "graph.CURSOR") == 0) return CMD_CURSOR;
+	if(strcasecmp(cmd_name, "graph.FETCH") == 0) return CMD_FETCH;
+	if(strcasecmp(cmd_name, "graph.EXPORT") == 0) return CMD_EXPORT;
+	if(strcasecmp(cmd_name, "graph.MEMORY") == 0) return CMD_MEMORY;
+	if(strcasecmp(cmd_name, "graph.STATS") == 0) return CMD_STATS;
 
 	assert(false);
 	return CMD_UNKNOWN;
 }
 
+// Clauses which modify the graph.
+static const char *_write_clauses[] = {"CREATE", "MERGE", "SET", "DELETE", "REMOVE"};
+// Clauses which are likely to make a read expensive.
+static const char *_long_read_clauses[] = {"shortestPath", "allShortestPaths"};
+// Longest procedure name looked up in the procedures registry.
+#define PROCEDURE_NAME_MAX 128
+
+static bool _MatchesKeyword(const char *word, size_t len, const char **keywords, int count) {
+	for(int i = 0; i < count; i++) {
+		if(strlen(keywords[i]) == len && strncasecmp(word, keywords[i], len) == 0) return true;
+	}
+	return false;
+}
+
+/* Classify the procedure called at s, following a CALL clause.
+ * Procedure calls are likely to be expensive, calls to procedures which
+ * aren't registered as read-only, or which can't be resolved, may modify the graph. */
+static const char *_ClassifyCall(const char *s, bool *writes, bool *long_read) {
+	*long_read = true;
+	while(isspace(*s)) s++;
+	const char *name = s;
+	while(isalnum(*s) || *s == '_' || *s == '.') s++;
+	size_t len = s - name;
+	if(len == 0 || len >= PROCEDURE_NAME_MAX) {
+		*writes = true;
+		return s;
+	}
+	char proc_name[PROCEDURE_NAME_MAX];
+	memcpy(proc_name, name, len);
+	proc_name[len] = '\0';
+	if(!Proc_ReadOnly(proc_name)) *writes = true;
+	return s;
+}
+
+/* Lexically scan a query, looking for clauses which modify the graph
+ * and for constructs which are likely to be expensive to evaluate, such as
+ * variable length traversals and procedure calls.
+ * The scan is a heuristic, a misclassified query is merely scheduled
+ * on a different lane. */
+static void _ClassifyQuery(const char *query, bool *writes, bool *long_read) {
+	*writes = false;
+	*long_read = false;
+	bool in_relationship = false;   // Within a relationship pattern [...].
+	char prev = '\0';               // Last non-whitespace character.
+
+	const char *s = query;
+	while(*s) {
+		char c = *s;
+		if(c == '\'' || c == '"' || c == '`') {
+			// Skip quoted strings and escaped identifiers.
+			s++;
+			while(*s && *s != c) {
+				if(*s == '\\' && s[1]) s++;
+				s++;
+			}
+			if(*s) s++;
+			prev = c;
+		} else if(isalpha(c) || c == '_') {
+			const char *word = s;
+			while(isalnum(*s) || *s == '_') s++;
+			// Ignore property names and parameters.
+			bool ignore = (prev == '.' || prev == '$');
+			prev = c;
+			if(ignore) continue;
+			size_t len = s - word;
+			if(_MatchesKeyword(word, len, _write_clauses, 5)) *writes = true;
+			if(_MatchesKeyword(word, len, _long_read_clauses, 2)) *long_read = true;
+			if(len == 4 && strncasecmp(word, "CALL", 4) == 0) {
+				s = _ClassifyCall(s, writes, long_read);
+			}
+		} else {
+			if(c == '[') in_relationship = true;
+			else if(c == ']') in_relationship = false;
+			else if(c == '*' && in_relationship) *long_read = true;
+			if(!isspace(c)) prev = c;
+			s++;
+		}
+	}
+}
+
+/* Pick the thread pool lane a command is executed on,
+ * keeping short queries from queuing behind expensive ones. */
+static ThreadPoolLane _DispatchLane(GRAPH_Commands cmd, RedisModuleString *query) {
+	bool writes = false;
+	bool long_read = false;
+	const char *q = (query) ? RedisModule_StringPtrLen(query, NULL) : "";
+
+	switch(cmd) {
+	case CMD_SLOWLOG:
+	case CMD_STATS:
+	case CMD_EXPLAIN:
+	case CMD_PREPARE:
+	case CMD_PLAN:
+	case CMD_FETCH:
+		// Don't execute queries.
+		return THPOOL_LANE_SHORT_READ;
+	case CMD_BATCH:
+		return THPOOL_LANE_LONG_READ;
+	case CMD_EXECUTE:
+		// The prepared query text isn't known at this point.
+		return THPOOL_LANE_WRITER;
+	case CMD_COMPACT:
+		return THPOOL_LANE_WRITER;
+	case CMD_COPY:
+		// Reads the source graph in its entirety.
+		return THPOOL_LANE_LONG_READ;
+	case CMD_EXPORT:
+		// Reads the graph in its entirety.
+		return THPOOL_LANE_LONG_READ;
+	case CMD_MEMORY:
+		// Measures every entity's properties unless sampled.
+		return THPOOL_LANE_LONG_READ;
+	case CMD_VIEW:
+		// Defining a view runs its query.
+		return THPOOL_LANE_LONG_READ;
+	case CMD_CURSOR:
+		// Reads are bounded by their count, the cost of producing each record is unknown.
+		return THPOOL_LANE_LONG_READ;
+	case CMD_RO_QUERY:
+		_ClassifyQuery(q, &writes, &long_read);
+		return (long_read) ? THPOOL_LANE_LONG_READ : THPOOL_LANE_SHORT_READ;
+	default:
+		_ClassifyQuery(q, &writes, &long_read);
+		if(writes) return THPOOL_LANE_WRITER;
+		return (long_read) ? THPOOL_LANE_LONG_READ : THPOOL_LANE_SHORT_READ;
+	}
+}
+
+/* Read the timeout of a query command, specified as "timeout <milliseconds>",
+ * defaulting to the module level timeout, 0 if the query isn't timed out. */
+static long long _QueryTimeout(RedisModuleString **argv, int argc) {
+	long long timeout = default_query_timeout;
+	for(int i = 3; i < argc - 1; i++) {
+		if(strcasecmp(RedisModule_StringPtrLen(argv[i], NULL), "timeout")) continue;
+		// Invalid timeouts are reported by the command.
+		if(RedisModule_StringToLongLong(argv[i + 1], &timeout) != REDISMODULE_OK || timeout < 0) {
+			timeout = 0;
+		}
+		break;
+	}
+	return timeout;
+}
+
+/* Invoked on the main thread once a blocked client's query exceeded its timeout,
+ * before it replied, e.g. while queued or waiting for the graph's lock.
+ * Replies with the query's progress, the query is aborted at its next timeout check. */
+static int _QueryTimedOut(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	QueryProgress progress;
+	RedisModuleBlockedClient *bc = RedisModule_GetBlockedClientHandle(ctx);
+	if(!CommandCtx_CancelBlocked(bc, &progress)) {
+		return RedisModule_ReplyWithError(ctx, "Query timed out");
+	}
+
+	char *error;
+	if(progress.op) {
+		asprintf(&error, "Query timed out after producing %llu records, while executing %s",
+				 (unsigned long long)progress.records, progress.op);
+	} else {
+		asprintf(&error, "Query timed out before its execution started");
+	}
+	RedisModule_ReplyWithError(ctx, error);
+	free(error);
+	return REDISMODULE_OK;
+}
+
 int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	CommandCtx *context;
 	// TODO: get number of arguments form command.
@@ -50,7 +261,19 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	const char *command_name = RedisModule_StringPtrLen(argv[0], NULL);
 	GRAPH_Commands cmd = determine_command(command_name);
 	Command_Handler handler = get_command_handler(cmd);
-	GraphContext *gc = GraphContext_Retrieve(ctx, graph_name, true, true);
+	/* Read-only commands may be served by replicas,
+	 * these must not create the graph key, nor should compacting, copying, viewing
+	 * or pinning plans of a missing graph. */
+	bool readonly_cmd = (cmd == CMD_RO_QUERY || cmd == CMD_BATCH || cmd == CMD_CURSOR ||
+						 cmd == CMD_FETCH || cmd == CMD_EXPORT || cmd == CMD_MEMORY ||
+						 cmd == CMD_STATS);
+	bool create = !(readonly_cmd || cmd == CMD_COMPACT || cmd == CMD_COPY || cmd == CMD_VIEW ||
+					 cmd == CMD_PLAN);
+	GraphContext *gc = GraphContext_Retrieve(ctx, graph_name, true, create);
+	if(!gc) {
+		return RedisModule_ReplyWithError(ctx,
+										  "Graph is either missing or referred key is of a different type.");
+	}
 
 	/* Determin query execution context
 	 * queries issued within a LUA script or multi exec block must
@@ -65,10 +288,30 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 		context = CommandCtx_New(ctx, NULL, argv[0], query, argc, argv, gc, is_replicated);
 		handler(context);
 	} else {
-		// Run query on a dedicated thread.
-		RedisModuleBlockedClient *bc = RedisModule_BlockClient(ctx, NULL, NULL, NULL, 0);
+		/* Run query on a dedicated thread.
+		 * Clients of read-only queries are released once their query times out,
+		 * even if it didn't reach a timeout check. Writers are never released,
+		 * as their changes may be committed past the timeout. */
+		ThreadPoolLane lane = _DispatchLane(cmd, query);
+		// Concurrent writers are committed in groups, see Graph_GroupCommitQuery.
+		if(cmd == CMD_QUERY && lane == THPOOL_LANE_WRITER) handler = Graph_GroupCommitQuery;
+		long long timeout = 0;
+		if((cmd == CMD_QUERY || cmd == CMD_RO_QUERY) && lane != THPOOL_LANE_WRITER) {
+			timeout = _QueryTimeout(argv, argc);
+		}
+		RedisModuleBlockedClient *bc = RedisModule_BlockClient(ctx, NULL,
+															   (timeout > 0) ? _QueryTimedOut : NULL,
+															   NULL, timeout);
 		context = CommandCtx_New(NULL, bc, argv[0], query, argc, argv, gc, is_replicated);
-		thpool_add_work(_thpool, handler, context);
+		if(timeout > 0) CommandCtx_TrackProgress(context);
+		if(ThreadPools_AddWork(lane, handler, context) != 0) {
+			// Thread pool queue is full, shed load.
+			RedisModule_AbortBlock(bc);
+			context->bc = NULL;
+			CommandCtx_Free(context);
+			GraphContext_Release(gc);
+			return RedisModule_ReplyWithError(ctx, "Max pending queries exceeded");
+		}
 	}
 
 	return REDISMODULE_OK;
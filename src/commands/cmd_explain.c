@@ -10,12 +10,23 @@
 #include "../index/index.h"
 #include "../util/rmalloc.h"
 #include "../execution_plan/execution_plan.h"
+#include <strings.h>
+
+// Returns true if the plan should be reported as a structured tree.
+static bool _Explain_Structured(CommandCtx *command_ctx) {
+	for(int i = 3; i < command_ctx->argc; i++) {
+		const char *arg = RedisModule_StringPtrLen(command_ctx->argv[i], NULL);
+		if(!strcasecmp(arg, "--structured")) return true;
+	}
+	return false;
+}
 
 /* Builds an execution plan but does not execute it
  * reports plan back to the client
  * Args:
  * argv[1] graph name
- * argv[2] query */
+ * argv[2] query
+ * argv[3] optional --structured, reply with a tree of operations and their estimates */
 void Graph_Explain(void *args) {
 	AST *ast = NULL;
 	bool lock_acquired = false;
@@ -45,13 +56,19 @@ void Graph_Explain(void *args) {
 	} else if(root_type == CYPHER_AST_DROP_NODE_PROPS_INDEX) {
 		RedisModule_ReplyWithSimpleString(ctx, "Drop Index");
 		goto cleanup;
+	} else if(root_type == CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT) {
+		RedisModule_ReplyWithSimpleString(ctx, "Create Constraint");
+		goto cleanup;
+	} else if(root_type == CYPHER_AST_DROP_NODE_PROP_CONSTRAINT) {
+		RedisModule_ReplyWithSimpleString(ctx, "Drop Constraint");
+		goto cleanup;
 	}
 
 	Graph_AcquireReadLock(gc->g);
 	lock_acquired = true;
 
 	plan = NewExecutionPlan();
-	ExecutionPlan_PreparePlan(plan);
+	ExecutionPlan_PreparePinnedPlan(plan, gc, query);
 	/* Make sure there are no compile-time errors.
 	 * We prefer to emit the error only once the entire execution-plan
 	 * is constructed in-favour of the time it was encountered
@@ -64,7 +81,9 @@ void Graph_Explain(void *args) {
 	if(plan == NULL) goto cleanup;
 
 	ExecutionPlan_Init(plan);       // Initialize the plan's ops.
-	ExecutionPlan_Print(plan, ctx); // Print the execution plan.
+	// Print the execution plan.
+	if(_Explain_Structured(command_ctx)) ExecutionPlan_PrintStructured(plan, ctx);
+	else ExecutionPlan_Print(plan, ctx);
 
 cleanup:
 	if(lock_acquired) Graph_ReleaseLock(gc->g);
@@ -0,0 +1,132 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_export.h"
+#include "cmd_context.h"
+#include "../graph/graph.h"
+#include "../graph/graph_partition.h"
+#include "../util/arr.h"
+#include "../graph/serializers/encoder/encode_aof.h"
+#include <strings.h>
+
+#define EXPORT_TOKEN_CAP (1024 * 1024) // Token size in bytes after which it is replied.
+
+typedef struct {
+	RedisModuleCtx *ctx;    // Context replied on.
+	bool relations;         // Relation tokens array is open.
+	long long node_tokens;  // Number of node tokens replied.
+	long long rel_tokens;   // Number of relation tokens replied.
+} ExportReply;
+
+// Reply with token, closing the node tokens array once the first relation token is replied.
+static void _Export_Token(const char *token, size_t len, bool is_node, void *privdata) {
+	ExportReply *reply = privdata;
+	if(!is_node && !reply->relations) {
+		RedisModule_ReplySetArrayLength(reply->ctx, reply->node_tokens);
+		RedisModule_ReplyWithArray(reply->ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+		reply->relations = true;
+	}
+	RedisModule_ReplyWithStringBuffer(reply->ctx, token, len);
+	if(is_node) reply->node_tokens++;
+	else reply->rel_tokens++;
+}
+
+// Parses the optional PARTITION arguments, replies with an error and returns false if invalid.
+static bool _Export_ParsePartition(RedisModuleCtx *ctx, RedisModuleString **argv, int argc,
+								   bool *partitioned, long long *index, long long *count,
+								   PartitionScheme *scheme) {
+	*partitioned = false;
+	*scheme = PARTITION_HASH;
+	if(argc == 2) return true;
+	if((argc != 5 && argc != 6) ||
+	   strcasecmp(RedisModule_StringPtrLen(argv[2], NULL), "PARTITION") != 0) {
+		RedisModule_WrongArity(ctx);
+		return false;
+	}
+
+	if(RedisModule_StringToLongLong(argv[4], count) != REDISMODULE_OK || *count < 1 ||
+	   RedisModule_StringToLongLong(argv[3], index) != REDISMODULE_OK ||
+	   *index < 0 || *index >= *count) {
+		RedisModule_ReplyWithError(ctx,
+								   "PARTITION expects a partition index within [0, count) and a positive partition count");
+		return false;
+	}
+
+	if(argc == 6) {
+		const char *s = RedisModule_StringPtrLen(argv[5], NULL);
+		if(strcasecmp(s, "HASH") == 0) {
+			*scheme = PARTITION_HASH;
+		} else if(strcasecmp(s, "RANGE") == 0) {
+			*scheme = PARTITION_RANGE;
+		} else {
+			RedisModule_ReplyWithError(ctx, "Unknown partitioning scheme, expecting HASH or RANGE");
+			return false;
+		}
+	}
+
+	*partitioned = true;
+	return true;
+}
+
+/* Exports a graph's entities in the binary format read by GRAPH.BULK,
+ * replying with the graph's node count, edge count, node tokens and relation tokens,
+ * each token holding up to about EXPORT_TOKEN_CAP bytes.
+ * With PARTITION, only the nodes and edges held by a single partition of the graph
+ * are exported, see graph_partition.h.
+ * The graph is exported under its read lock.
+ * Args:
+ * argv[1] graph name
+ * argv[2] optional PARTITION
+ * argv[3] partition index
+ * argv[4] partition count
+ * argv[5] optional partitioning scheme, HASH (default) or RANGE */
+void Graph_Export(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	bool partitioned;
+	long long index;
+	long long count;
+	PartitionScheme scheme;
+	if(!_Export_ParsePartition(ctx, command_ctx->argv, command_ctx->argc, &partitioned, &index,
+							   &count, &scheme)) {
+		goto cleanup;
+	}
+
+	Graph_AcquireReadLock(gc->g);
+	Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
+
+	ExportReply reply = {.ctx = ctx, .relations = false, .node_tokens = 0, .rel_tokens = 0};
+	RedisModule_ReplyWithArray(ctx, 4);
+	if(partitioned) {
+		uint64_t edge_count;
+		GraphPartition partition = GraphPartition_New(gc->g, scheme, index, count);
+		NodeID *nodes = GraphPartition_Nodes(&partition, gc->g, &edge_count);
+		RedisModule_ReplyWithLongLong(ctx, array_len(nodes));
+		RedisModule_ReplyWithLongLong(ctx, edge_count);
+		RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+		BulkEncodePartition(gc, &partition, nodes, EXPORT_TOKEN_CAP, _Export_Token, &reply);
+		array_free(nodes);
+	} else {
+		RedisModule_ReplyWithLongLong(ctx, Graph_NodeCount(gc->g));
+		RedisModule_ReplyWithLongLong(ctx, Graph_EdgeCount(gc->g));
+		RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+		BulkEncodeGraph(gc, EXPORT_TOKEN_CAP, _Export_Token, &reply);
+	}
+	if(reply.relations) {
+		RedisModule_ReplySetArrayLength(ctx, reply.rel_tokens);
+	} else {
+		RedisModule_ReplySetArrayLength(ctx, reply.node_tokens);
+		RedisModule_ReplyWithArray(ctx, 0);
+	}
+
+	Graph_ReleaseLock(gc->g);
+
+cleanup:
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
@@ -0,0 +1,97 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_fetch.h"
+#include "cmd_context.h"
+#include "../graph/graph.h"
+#include "../util/rmalloc.h"
+#include "../resultset/formatters/resultset_formatters.h"
+#include <strings.h>
+
+/* Reply with the properties of the graph entities with the given IDs, in compact form,
+ * complementing results returned through "--compact-ids".
+ * Missing entities reply with null.
+ * Args:
+ * argv[1] graph name
+ * argv[2] NODES | EDGES
+ * argv[3] number of IDs N
+ * argv[4..4+N) IDs
+ * [PROPERTIES <count> <name> ...] restricts the reply to the named properties. */
+void Graph_Fetch(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	RedisModuleString **argv = command_ctx->argv;
+	int argc = command_ctx->argc;
+	EntityID *ids = NULL;
+	Attribute_ID *attrs = NULL;
+	long long id_count = 0;
+	long long attr_count = 0;
+
+	const char *kind = (argc > 2) ? RedisModule_StringPtrLen(argv[2], NULL) : "";
+	bool nodes = (strcasecmp(kind, "NODES") == 0);
+	if((!nodes && strcasecmp(kind, "EDGES") != 0) || argc < 4) {
+		RedisModule_WrongArity(ctx);
+		goto cleanup;
+	}
+	if(RedisModule_StringToLongLong(argv[3], &id_count) != REDISMODULE_OK || id_count < 0 ||
+	   id_count > argc - 4) {
+		RedisModule_ReplyWithError(ctx, "Failed to parse ID count");
+		goto cleanup;
+	}
+
+	int props = 4 + id_count;
+	if(props < argc) {
+		const char *arg = RedisModule_StringPtrLen(argv[props], NULL);
+		if(strcasecmp(arg, "PROPERTIES") != 0 || props + 1 >= argc ||
+		   RedisModule_StringToLongLong(argv[props + 1], &attr_count) != REDISMODULE_OK ||
+		   attr_count < 0 || attr_count != argc - props - 2) {
+			RedisModule_ReplyWithError(ctx, "Failed to parse properties");
+			goto cleanup;
+		}
+		// Unknown properties are held by no entity.
+		attrs = rm_malloc(sizeof(Attribute_ID) * (attr_count + 1));
+		for(long long i = 0; i < attr_count; i++) {
+			const char *name = RedisModule_StringPtrLen(argv[props + 2 + i], NULL);
+			attrs[i] = GraphContext_GetAttributeID(gc, name);
+		}
+	}
+
+	ids = rm_malloc(sizeof(EntityID) * (id_count + 1));
+	for(long long i = 0; i < id_count; i++) {
+		long long id;
+		if(RedisModule_StringToLongLong(argv[4 + i], &id) != REDISMODULE_OK || id < 0) {
+			RedisModule_ReplyWithError(ctx, "Invalid entity ID");
+			goto cleanup;
+		}
+		ids[i] = id;
+	}
+
+	Graph_AcquireReadLock(gc->g);
+	RedisModule_ReplyWithArray(ctx, id_count);
+	for(long long i = 0; i < id_count; i++) {
+		GraphEntity *e;
+		Node n;
+		Edge edge;
+		bool found;
+		if(nodes) {
+			found = Graph_GetNode(gc->g, ids[i], &n);
+			e = (GraphEntity *)&n;
+		} else {
+			found = Graph_GetEdge(gc->g, ids[i], &edge);
+			e = (GraphEntity *)&edge;
+		}
+		if(found) ResultSet_ReplyWithCompactProperties(ctx, gc, e, attrs, attr_count);
+		else RedisModule_ReplyWithNull(ctx);
+	}
+	Graph_ReleaseLock(gc->g);
+
+cleanup:
+	if(ids) rm_free(ids);
+	if(attrs) rm_free(attrs);
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
@@ -0,0 +1,84 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_memory.h"
+#include "cmd_context.h"
+#include "../util/arr.h"
+#include "../graph/graph_memory.h"
+#include <string.h>
+#include <strings.h>
+
+static void _Memory_ReplySchemas(RedisModuleCtx *ctx, GraphContext *gc, SchemaType t,
+								 const size_t *usage) {
+	uint count = array_len(usage);
+	RedisModule_ReplyWithArray(ctx, count * 2);
+	for(uint i = 0; i < count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, i, t);
+		RedisModule_ReplyWithStringBuffer(ctx, s->name, strlen(s->name));
+		RedisModule_ReplyWithLongLong(ctx, usage[i]);
+	}
+}
+
+/* Reports the memory held by a graph, broken down by structure:
+ * node and edge storage, their properties, the adjacency, label and relation matrices
+ * and in-process indices. Properties are measured over every entity unless
+ * SAMPLES is specified, in which case at most n entities of each kind are measured.
+ * The graph is measured under its read lock.
+ * Args:
+ * argv[1] graph name
+ * argv[2] optional SAMPLES
+ * argv[3] number of entities to sample, 0 measures every entity */
+void Graph_Memory(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	RedisModuleString **argv = command_ctx->argv;
+	int argc = command_ctx->argc;
+
+	long long samples = 0;
+	if(argc == 4 && strcasecmp(RedisModule_StringPtrLen(argv[2], NULL), "SAMPLES") == 0) {
+		if(RedisModule_StringToLongLong(argv[3], &samples) != REDISMODULE_OK || samples < 0) {
+			RedisModule_ReplyWithError(ctx, "SAMPLES must be a non-negative integer");
+			goto cleanup;
+		}
+	} else if(argc != 2) {
+		RedisModule_WrongArity(ctx);
+		goto cleanup;
+	}
+
+	GraphMemory mem;
+	Graph_AcquireReadLock(gc->g);
+	Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
+	GraphMemory_Measure(gc, samples, &mem);
+	__atomic_store_n(&gc->memory_usage, mem.total, __ATOMIC_RELAXED);
+
+	RedisModule_ReplyWithArray(ctx, 18);
+	RedisModule_ReplyWithSimpleString(ctx, "total");
+	RedisModule_ReplyWithLongLong(ctx, mem.total);
+	RedisModule_ReplyWithSimpleString(ctx, "nodes");
+	RedisModule_ReplyWithLongLong(ctx, mem.nodes);
+	RedisModule_ReplyWithSimpleString(ctx, "node_properties");
+	RedisModule_ReplyWithLongLong(ctx, mem.node_properties);
+	RedisModule_ReplyWithSimpleString(ctx, "edges");
+	RedisModule_ReplyWithLongLong(ctx, mem.edges);
+	RedisModule_ReplyWithSimpleString(ctx, "edge_properties");
+	RedisModule_ReplyWithLongLong(ctx, mem.edge_properties);
+	RedisModule_ReplyWithSimpleString(ctx, "adjacency");
+	RedisModule_ReplyWithLongLong(ctx, mem.adjacency);
+	RedisModule_ReplyWithSimpleString(ctx, "labels");
+	_Memory_ReplySchemas(ctx, gc, SCHEMA_NODE, mem.labels);
+	RedisModule_ReplyWithSimpleString(ctx, "relations");
+	_Memory_ReplySchemas(ctx, gc, SCHEMA_EDGE, mem.relations);
+	RedisModule_ReplyWithSimpleString(ctx, "indices");
+	RedisModule_ReplyWithLongLong(ctx, mem.indices);
+	// Schemas are replied by name under the lock, as writers may add schemas.
+	Graph_ReleaseLock(gc->g);
+	GraphMemory_Free(&mem);
+
+cleanup:
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
@@ -0,0 +1,166 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_plan.h"
+#include "cmd_context.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../execution_plan/plan_cache.h"
+#include "../execution_plan/execution_plan.h"
+#include "../execution_plan/optimizations/optimizer.h"
+#include <string.h>
+#include <strings.h>
+
+// Reply with a pinned plan, an array of its query, shape, rules and mismatches.
+static void _Plan_ReplyWithPin(const char *query, size_t len, const PlanPin *pin, void *privdata) {
+	RedisModuleCtx *ctx = privdata;
+	RedisModule_ReplyWithArray(ctx, 4);
+	RedisModule_ReplyWithStringBuffer(ctx, query, len);
+	RedisModule_ReplyWithStringBuffer(ctx, pin->shape, strlen(pin->shape));
+	RedisModule_ReplyWithLongLong(ctx, pin->rules);
+	RedisModule_ReplyWithLongLong(ctx, pin->mismatches);
+}
+
+// Pin the plan the optimizer currently builds for a query, replying with its shape.
+static void _Plan_Pin(CommandCtx *command_ctx, GraphContext *gc) {
+	AST *ast = NULL;
+	char *shape = NULL;
+	ExecutionPlan *plan = NULL;
+	bool lock_acquired = false;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	const char *query = RedisModule_StringPtrLen(command_ctx->argv[3], NULL);
+
+	size_t body_offset;
+	if(!PlanCache_QueryBodyOffset(query, &body_offset)) {
+		RedisModule_ReplyWithError(ctx, "Failed to parse query parameters");
+		return;
+	}
+
+	cypher_parse_result_t *parse_result = parse(query);
+	if(parse_result == NULL) return;
+	if(AST_Validate(ctx, parse_result) != AST_VALID) goto cleanup;
+
+	ast = AST_Build(parse_result);
+	if(cypher_astnode_type(ast->root) != CYPHER_AST_QUERY) {
+		RedisModule_ReplyWithError(ctx, "Only plans of queries can be pinned");
+		goto cleanup;
+	}
+
+	Graph_AcquireReadLock(gc->g);
+	lock_acquired = true;
+
+	plan = NewExecutionPlan();
+	if(QueryCtx_EncounteredError()) {
+		QueryCtx_EmitException();
+		goto cleanup;
+	}
+	if(plan == NULL) goto cleanup;
+
+	// Record the rules shaping the plan, such that later builds apply them alone.
+	uint rules = ExecutionPlan_PreparePlanWithRules(plan, OPT_ALL_RULES, true);
+	shape = ExecutionPlan_Shape(plan);
+	PlanPins_Set(GraphContext_GetPlanPins(gc), query + body_offset, rules, shape);
+	// Cached plans were built regardless of the pin.
+	GraphContext_InvalidateCache(gc);
+
+	// Replicas and the AOF restore the pin as is.
+	CommandCtx_ThreadSafeContextLock(command_ctx);
+	RedisModule_Replicate(ctx, "GRAPH.PLAN", "ccclc", gc->graph_name, "RESTORE", query + body_offset,
+						  (long long)rules, shape);
+	CommandCtx_ThreadSafeContextUnlock(command_ctx);
+
+	RedisModule_ReplyWithStringBuffer(ctx, shape, strlen(shape));
+
+cleanup:
+	if(lock_acquired) Graph_ReleaseLock(gc->g);
+	if(plan) ExecutionPlan_Free(plan);
+	if(shape) rm_free(shape);
+	AST_Free(ast);
+	parse_result_free(parse_result);
+}
+
+// Pin a previously exported plan, given its query, rules and shape.
+static void _Plan_Restore(CommandCtx *command_ctx, GraphContext *gc) {
+	long long rules;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	if(RedisModule_StringToLongLong(command_ctx->argv[4], &rules) != REDISMODULE_OK || rules < 0) {
+		RedisModule_ReplyWithError(ctx, "Invalid optimizer rules");
+		return;
+	}
+	/* Rules unknown to this version are disregarded,
+	 * the shape reports whether the pinned plan is still built. */
+	rules &= OPT_ALL_RULES;
+
+	const char *query = RedisModule_StringPtrLen(command_ctx->argv[3], NULL);
+	const char *shape = RedisModule_StringPtrLen(command_ctx->argv[5], NULL);
+	PlanPins_Set(GraphContext_GetPlanPins(gc), query, rules, shape);
+	GraphContext_InvalidateCache(gc);
+
+	CommandCtx_ThreadSafeContextLock(command_ctx);
+	RedisModule_Replicate(ctx, "GRAPH.PLAN", "ccsss", gc->graph_name, "RESTORE",
+						  command_ctx->argv[3], command_ctx->argv[4], command_ctx->argv[5]);
+	CommandCtx_ThreadSafeContextUnlock(command_ctx);
+	RedisModule_ReplyWithSimpleString(ctx, "OK");
+}
+
+static void _Plan_Unpin(CommandCtx *command_ctx, GraphContext *gc) {
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	const char *query = RedisModule_StringPtrLen(command_ctx->argv[3], NULL);
+
+	size_t body_offset;
+	if(!PlanCache_QueryBodyOffset(query, &body_offset) ||
+	   !PlanPins_Remove(GraphContext_GetPlanPins(gc), query + body_offset)) {
+		RedisModule_ReplyWithError(ctx, "No plan is pinned for query");
+		return;
+	}
+	GraphContext_InvalidateCache(gc);
+
+	CommandCtx_ThreadSafeContextLock(command_ctx);
+	RedisModule_Replicate(ctx, "GRAPH.PLAN", "ccc", gc->graph_name, "UNPIN", query + body_offset);
+	CommandCtx_ThreadSafeContextUnlock(command_ctx);
+	RedisModule_ReplyWithSimpleString(ctx, "OK");
+}
+
+static void _Plan_List(CommandCtx *command_ctx, GraphContext *gc) {
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	PlanPins *pins = GraphContext_GetPlanPins(gc);
+	RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+	PlanPins_ForEach(pins, _Plan_ReplyWithPin, ctx, true);
+	RedisModule_ReplySetArrayLength(ctx, PlanPins_Count(pins));
+}
+
+/* Manages the execution plans pinned per query, shielding queries from optimizer changes.
+ * A pinned plan is built applying only the optimizer rules which shaped it when pinned,
+ * a warning is logged whenever the plan built no longer matches the pinned shape.
+ * Args:
+ * argv[1] graph name
+ * argv[2] PIN <query> | UNPIN <query> | LIST | RESTORE <query> <rules> <shape> */
+void Graph_Plan(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	QueryCtx_BeginTimer();
+	QueryCtx_SetGlobalExecutionCtx(command_ctx);
+
+	const char *op = (command_ctx->argc > 2) ?
+					 RedisModule_StringPtrLen(command_ctx->argv[2], NULL) : "";
+	if(strcasecmp(op, "PIN") == 0 && command_ctx->argc == 4) {
+		_Plan_Pin(command_ctx, gc);
+	} else if(strcasecmp(op, "UNPIN") == 0 && command_ctx->argc == 4) {
+		_Plan_Unpin(command_ctx, gc);
+	} else if(strcasecmp(op, "LIST") == 0 && command_ctx->argc == 3) {
+		_Plan_List(command_ctx, gc);
+	} else if(strcasecmp(op, "RESTORE") == 0 && command_ctx->argc == 6) {
+		_Plan_Restore(command_ctx, gc);
+	} else {
+		RedisModule_WrongArity(ctx);
+	}
+
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
+}
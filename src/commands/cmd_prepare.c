@@ -0,0 +1,131 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_prepare.h"
+#include "cmd_query.h"
+#include "../ast/ast.h"
+#include "cmd_context.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../execution_plan/plan_cache.h"
+#include <string.h>
+
+/* Validates a query and registers it for later execution
+ * replies with the prepared query handle
+ * Args:
+ * argv[1] graph name
+ * argv[2] query */
+void Graph_Prepare(void *args) {
+	cypher_parse_result_t *parse_result = NULL;
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	QueryCtx_SetGlobalExecutionCtx(command_ctx);
+
+	if(command_ctx->query == NULL) {
+		RedisModule_WrongArity(ctx);
+		goto cleanup;
+	}
+
+	// Parse the query to construct an AST
+	parse_result = parse(command_ctx->query);
+	if(parse_result == NULL) goto cleanup;
+
+	// Perform query validations, parameter values are bound on execution.
+	if(AST_ValidatePrepared(ctx, parse_result) != AST_VALID) goto cleanup;
+
+	const cypher_astnode_t *statement = cypher_parse_result_get_root(parse_result, 0);
+	if(cypher_ast_statement_noptions(statement) > 0) {
+		RedisModule_ReplyWithError(ctx,
+								   "Prepared queries can't specify parameter values, bind them with GRAPH.EXECUTE");
+		goto cleanup;
+	}
+
+	const cypher_astnode_t *body = cypher_ast_statement_get_body(statement);
+	if(cypher_astnode_type(body) != CYPHER_AST_QUERY) {
+		RedisModule_ReplyWithError(ctx, "Index operations can't be prepared");
+		goto cleanup;
+	}
+
+	PreparedStatements *statements = GraphContext_GetPreparedStatements(gc);
+	uint64_t handle = PreparedStatements_Add(statements, command_ctx->query);
+	RedisModule_ReplyWithLongLong(ctx, handle);
+
+cleanup:
+	parse_result_free(parse_result);
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
+}
+
+/* Executes a prepared query, binding the given parameter values
+ * Args:
+ * argv[1] graph name
+ * argv[2] prepared query handle
+ * argv[3] optional parameters, e.g. "CYPHER name='a' age=30"
+ * argv[3..] optional query options, as accepted by GRAPH.QUERY */
+void Graph_Execute(void *args) {
+	long long handle;
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	if(command_ctx->argc < 3) {
+		RedisModule_WrongArity(ctx);
+		goto error;
+	}
+
+	if(RedisModule_StringToLongLong(command_ctx->argv[2], &handle) != REDISMODULE_OK || handle < 0) {
+		RedisModule_ReplyWithError(ctx, "Invalid prepared query handle");
+		goto error;
+	}
+
+	PreparedStatements *statements = GraphContext_GetPreparedStatements(gc);
+	char *prepared = PreparedStatements_GetQuery(statements, handle);
+	if(prepared == NULL) {
+		RedisModule_ReplyWithError(ctx, "Unknown prepared query handle");
+		goto error;
+	}
+
+	const char *params = "";
+	if(command_ctx->argc > 3) {
+		const char *arg = RedisModule_StringPtrLen(command_ctx->argv[3], NULL);
+		if(Graph_QueryOptionLen(arg) == 0) {
+			// Parameters only, the prepared query makes up the query body.
+			size_t body_offset;
+			if(!PlanCache_QueryBodyOffset(arg, &body_offset) || arg[body_offset] != '\0') {
+				rm_free(prepared);
+				RedisModule_ReplyWithError(ctx, "Invalid prepared query parameters");
+				goto error;
+			}
+			params = arg;
+		}
+	}
+
+	/* Execute as a regular query with the parameters prefix prepended,
+	 * the query body is a stable key for the execution plan cache,
+	 * such that repeated executions only parse the parameters. */
+	size_t params_len = strlen(params);
+	size_t prepared_len = strlen(prepared);
+	char *query = rm_malloc(params_len + prepared_len + 2);
+	memcpy(query, params, params_len);
+	query[params_len] = ' ';
+	memcpy(query + params_len + 1, prepared, prepared_len + 1);
+	rm_free(prepared);
+
+	rm_free(command_ctx->query);
+	command_ctx->query = query;
+	// Effects are replicated as a regular query, replicas are unaware of prepared handles.
+	rm_free(command_ctx->command_name);
+	command_ctx->command_name = rm_strdup("GRAPH.QUERY");
+
+	Graph_Query(command_ctx);
+	return;
+
+error:
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
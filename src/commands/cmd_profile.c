@@ -9,9 +9,26 @@
 #include "../query_ctx.h"
 #include "../graph/graph.h"
 #include "../util/arr.h"
+#include "../util/simple_timer.h"
+#include "../util/thpool/pools.h"
 #include "../util/rmalloc.h"
 #include "../execution_plan/execution_plan.h"
+#include <strings.h>
 
+static bool _Profile_Structured(CommandCtx *command_ctx) {
+	for(int i = 3; i < command_ctx->argc; i++) {
+		const char *arg = RedisModule_StringPtrLen(command_ctx->argv[i], NULL);
+		if(!strcasecmp(arg, "--structured")) return true;
+	}
+	return false;
+}
+
+/* Executes a query, replying with its execution plan annotated with
+ * the statistics of each operation rather than with its results.
+ * Args:
+ * argv[1] graph name
+ * argv[2] query
+ * argv[3] optional --structured, reply with a tree of operations and their statistics */
 void Graph_Profile(void *args) {
 	AST *ast = NULL;
 	bool lockAcquired = false;
@@ -22,6 +39,7 @@ void Graph_Profile(void *args) {
 	QueryCtx_SetGlobalExecutionCtx(command_ctx);
 
 	QueryCtx_BeginTimer(); // Start query timing.
+	if(ThreadPools_CurrentLane() != THPOOL_LANE_COUNT) QueryCtx_SetQueueWait(ThreadPools_CurrentWait());
 
 	// Parse the query to construct an AST
 	cypher_parse_result_t *parse_result = parse(command_ctx->query);
@@ -36,24 +54,23 @@ void Graph_Profile(void *args) {
 	ast = AST_Build(parse_result);
 
 	// Acquire the appropriate lock.
+	double wait_timer[2];
+	simple_tic(wait_timer);
 	if(readonly) {
 		Graph_AcquireReadLock(gc->g);
 	} else {
-		Graph_WriterEnter(gc->g);  // Single writer.
-		/* If this is a writer query `we need to re-open the graph key with write flag
-		* this notifies Redis that the key is "dirty" any watcher on that key will
-		* be notified. */
-		CommandCtx_ThreadSafeContextLock(command_ctx);
-		{
-			GraphContext_MarkWriter(ctx, gc);
-		}
-		CommandCtx_ThreadSafeContextUnlock(command_ctx);
+		/* Single writer, Redis is notified that the key is "dirty"
+		 * once changes are committed. */
+		Graph_WriterEnter(gc->g);
 	}
 	lockAcquired = true;
+	QueryCtx_AddLockWait(simple_toc(wait_timer) * 1000);
 
 	const cypher_astnode_type_t root_type = cypher_astnode_type(ast->root);
 	if(root_type == CYPHER_AST_CREATE_NODE_PROPS_INDEX ||
-	   root_type == CYPHER_AST_DROP_NODE_PROPS_INDEX) {
+	   root_type == CYPHER_AST_DROP_NODE_PROPS_INDEX ||
+	   root_type == CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT ||
+	   root_type == CYPHER_AST_DROP_NODE_PROP_CONSTRAINT) {
 		RedisModule_ReplyWithError(ctx, "Can't profile index operations.");
 		goto cleanup;
 	} else if(root_type != CYPHER_AST_QUERY) {
@@ -75,10 +92,11 @@ void Graph_Profile(void *args) {
 	}
 
 	if(plan) {
-		ExecutionPlan_PreparePlan(plan);
+		ExecutionPlan_PreparePinnedPlan(plan, gc, command_ctx->query);
 		ExecutionPlan_Profile(plan);
 		QueryCtx_ForceUnlockCommit();
-		ExecutionPlan_Print(plan, ctx);
+		if(_Profile_Structured(command_ctx)) ExecutionPlan_PrintStructured(plan, ctx);
+		else ExecutionPlan_Print(plan, ctx);
 		ExecutionPlan_Free(plan);
 	}
 
@@ -7,11 +7,34 @@
 #include "cmd_query.h"
 #include "../ast/ast.h"
 #include "../util/arr.h"
+#include "cmd_view.h"
+#include "cmd_cursor.h"
 #include "cmd_context.h"
 #include "../query_ctx.h"
 #include "../graph/graph.h"
 #include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
+#include "../util/thpool/pools.h"
 #include "../execution_plan/execution_plan.h"
+#include "../execution_plan/plan_cache.h"
+#include "../arithmetic/func_desc.h"
+#include <unistd.h>
+
+extern long long default_query_timeout; // Default query timeout, defined in module.c
+extern long long min_version_wait;      // Milliseconds a query waits for MIN_VERSION, defined in module.c
+
+// Join index properties into a comma separated list, reported by errors.
+static char *_index_props_list(const char **props, uint prop_count) {
+	size_t len = 1;
+	for(uint i = 0; i < prop_count; i++) len += strlen(props[i]) + 2;
+	char *list = rm_malloc(len);
+	list[0] = '\0';
+	for(uint i = 0; i < prop_count; i++) {
+		if(i > 0) strcat(list, ", ");
+		strcat(list, props[i]);
+	}
+	return list;
+}
 
 static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc,
 							 const cypher_astnode_t *index_op) {
@@ -21,107 +44,589 @@ static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc,
 		// Retrieve strings from AST node
 		const char *label = cypher_ast_label_get_name(cypher_ast_create_node_props_index_get_label(
 														  index_op));
-		const char *prop = cypher_ast_prop_name_get_value(cypher_ast_create_node_props_index_get_prop_name(
-															  index_op, 0));
+		uint prop_count = cypher_ast_create_node_props_index_nprops(index_op);
+		const char *props[prop_count];
+		for(uint i = 0; i < prop_count; i++) {
+			props[i] = cypher_ast_prop_name_get_value(cypher_ast_create_node_props_index_get_prop_name(
+														  index_op, i));
+		}
 		QueryCtx_LockForCommit();
-		if(GraphContext_AddIndex(&idx, gc, label, prop, IDX_EXACT_MATCH) == INDEX_OK) Index_Construct(idx);
+		// Multiple properties make up a composite index.
+		int res = (prop_count == 1) ?
+				  GraphContext_AddIndex(&idx, gc, label, props[0], IDX_EXACT_MATCH) :
+				  GraphContext_AddCompositeIndex(&idx, gc, label, props, prop_count);
+		// Large labels are indexed in the background.
+		if(res == INDEX_OK) GraphContext_ConstructIndex(gc, idx);
 		QueryCtx_UnlockCommit(NULL);
 	} else {
 		// Retrieve strings from AST node
 		const char *label = cypher_ast_label_get_name(cypher_ast_drop_node_props_index_get_label(index_op));
-		const char *prop = cypher_ast_prop_name_get_value(cypher_ast_drop_node_props_index_get_prop_name(
-															  index_op, 0));
+		uint prop_count = cypher_ast_drop_node_props_index_nprops(index_op);
+		const char *props[prop_count];
+		for(uint i = 0; i < prop_count; i++) {
+			props[i] = cypher_ast_prop_name_get_value(cypher_ast_drop_node_props_index_get_prop_name(
+														  index_op, i));
+		}
+		// Indices backing a unique constraint are dropped along with the constraint.
+		Index *constrained = (prop_count == 1) ?
+							 GraphContext_GetIndex(gc, label, props[0], IDX_EXACT_MATCH) : NULL;
+		if(constrained &&
+		   Index_IsUnique(constrained, GraphContext_GetAttributeID(gc, props[0]))) {
+			char *error;
+			asprintf(&error, "ERR Unable to drop index on :%s(%s): index backs a unique constraint.",
+					 label, props[0]);
+			QueryCtx_SetError(error);
+			return;
+		}
+
 		QueryCtx_LockForCommit();
-		int res = GraphContext_DeleteIndex(gc, label, prop, IDX_EXACT_MATCH);
+		int res = (prop_count == 1) ?
+				  GraphContext_DeleteIndex(gc, label, props[0], IDX_EXACT_MATCH) :
+				  GraphContext_DeleteCompositeIndex(gc, label, props, prop_count);
 		QueryCtx_UnlockCommit(NULL);
 
 		if(res != INDEX_OK) {
 			char *error;
-			asprintf(&error, "ERR Unable to drop index on :%s(%s): no such index.", label, prop);
+			char *list = _index_props_list(props, prop_count);
+			asprintf(&error, "ERR Unable to drop index on :%s(%s): no such index.", label, list);
+			rm_free(list);
 			QueryCtx_SetError(error);
 		}
 	}
 }
 
-static inline bool _check_compact_flag(CommandCtx *command_ctx) {
-	// The only additional argument to check currently is whether the query results
-	// should be returned in compact form
-	return (command_ctx->argc > 3 &&
-			!strcasecmp(RedisModule_StringPtrLen(command_ctx->argv[3], NULL), "--compact"));
+/* Resolve the label and property of a constraint operation,
+ * returns false if the constraint isn't over a property of the constrained node. */
+static bool _constraint_target(const cypher_astnode_t *identifier, const cypher_astnode_t *label,
+							   const cypher_astnode_t *exp, const char **label_name, const char **prop) {
+	if(cypher_astnode_type(exp) != CYPHER_AST_PROPERTY_OPERATOR) return false;
+	const cypher_astnode_t *entity = cypher_ast_property_operator_get_expression(exp);
+	if(cypher_astnode_type(entity) != CYPHER_AST_IDENTIFIER ||
+	   strcmp(cypher_ast_identifier_get_name(entity), cypher_ast_identifier_get_name(identifier)) != 0) {
+		return false;
+	}
+	*label_name = cypher_ast_label_get_name(label);
+	*prop = cypher_ast_prop_name_get_value(cypher_ast_property_operator_get_prop_name(exp));
+	return true;
 }
 
-void Graph_Query(void *args) {
+static void _constraint_operation(RedisModuleCtx *ctx, GraphContext *gc,
+								  const cypher_astnode_t *constraint_op) {
+	char *error = NULL;
+	const char *label;
+	const char *prop;
+
+	if(cypher_astnode_type(constraint_op) == CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT) {
+		if(!cypher_ast_create_node_prop_constraint_is_unique(constraint_op) ||
+		   !_constraint_target(cypher_ast_create_node_prop_constraint_get_identifier(constraint_op),
+							   cypher_ast_create_node_prop_constraint_get_label(constraint_op),
+							   cypher_ast_create_node_prop_constraint_get_expression(constraint_op),
+							   &label, &prop)) {
+			QueryCtx_SetError(strdup("ERR Only unique constraints over a node property are supported."));
+			return;
+		}
+
+		QueryCtx_LockForCommit();
+		// Constraints are enforced through the property's exact-match index.
+		Index *idx = GraphContext_GetIndex(gc, label, prop, IDX_EXACT_MATCH);
+		bool indexed = (idx != NULL);
+		if(!indexed && GraphContext_AddIndex(&idx, gc, label, prop, IDX_EXACT_MATCH) == INDEX_OK) {
+			Index_Construct(idx);
+		} else if(!Index_IsOperational(idx)) {
+			// Duplicates are detected over a fully constructed index.
+			Index_Construct(idx);
+		}
+
+		if(Index_HasDuplicates(idx, GraphContext_GetAttributeID(gc, prop))) {
+			if(!indexed) GraphContext_DeleteIndex(gc, label, prop, IDX_EXACT_MATCH);
+			asprintf(&error, "ERR Unable to create unique constraint on :%s(%s): "
+					 "existing nodes hold duplicate values.", label, prop);
+		} else {
+			GraphContext_AddUniqueConstraint(gc, label, prop);
+		}
+		QueryCtx_UnlockCommit(NULL);
+	} else {
+		if(!cypher_ast_drop_node_prop_constraint_is_unique(constraint_op) ||
+		   !_constraint_target(cypher_ast_drop_node_prop_constraint_get_identifier(constraint_op),
+							   cypher_ast_drop_node_prop_constraint_get_label(constraint_op),
+							   cypher_ast_drop_node_prop_constraint_get_expression(constraint_op),
+							   &label, &prop)) {
+			QueryCtx_SetError(strdup("ERR Only unique constraints over a node property are supported."));
+			return;
+		}
+
+		QueryCtx_LockForCommit();
+		int res = GraphContext_DeleteUniqueConstraint(gc, label, prop);
+		QueryCtx_UnlockCommit(NULL);
+		if(res != INDEX_OK) {
+			asprintf(&error, "ERR Unable to drop unique constraint on :%s(%s): no such constraint.",
+					 label, prop);
+		}
+	}
+
+	if(error) QueryCtx_SetError(error);
+}
+
+/* Determine the result set format, results are returned in compact form
+ * given "--compact", in compact form without graph entities' properties given
+ * "--compact-ids", in compact form referencing repeated strings through a dictionary
+ * given "--compact-dict", packed into binary column batches given "--binary",
+ * in verbose form otherwise. */
+static ResultSetFormatterType _read_format(CommandCtx *command_ctx) {
+	for(int i = 3; i < command_ctx->argc; i++) {
+		const char *arg = RedisModule_StringPtrLen(command_ctx->argv[i], NULL);
+		if(!strcasecmp(arg, "--compact")) return FORMATTER_COMPACT;
+		if(!strcasecmp(arg, "--compact-ids")) return FORMATTER_COMPACT_IDS;
+		if(!strcasecmp(arg, "--compact-dict")) return FORMATTER_COMPACT_DICT;
+		if(!strcasecmp(arg, "--binary")) return FORMATTER_BINARY;
+	}
+	return FORMATTER_VERBOSE;
+}
+
+/* Read the reply compression, specified as "--compress <algorithm>",
+ * compressed replies use the binary format. Only lz4 is supported.
+ * Returns false if the specified algorithm is unsupported. */
+static bool _read_compression(CommandCtx *command_ctx, bool *compress) {
+	*compress = false;
+	for(int i = 3; i < command_ctx->argc - 1; i++) {
+		if(strcasecmp(RedisModule_StringPtrLen(command_ctx->argv[i], NULL), "--compress")) continue;
+		*compress = true;
+		return strcasecmp(RedisModule_StringPtrLen(command_ctx->argv[i + 1], NULL), "lz4") == 0;
+	}
+	return true;
+}
+
+/* Read the query timeout, specified as "timeout <milliseconds>",
+ * defaulting to the module level timeout.
+ * Returns false if the specified timeout is invalid. */
+static bool _read_timeout(CommandCtx *command_ctx, long long *timeout) {
+	*timeout = default_query_timeout;
+	for(int i = 3; i < command_ctx->argc - 1; i++) {
+		if(strcasecmp(RedisModule_StringPtrLen(command_ctx->argv[i], NULL), "timeout")) continue;
+		return (RedisModule_StringToLongLong(command_ctx->argv[i + 1], timeout) == REDISMODULE_OK &&
+				*timeout >= 0);
+	}
+	return true;
+}
+
+/* Read the trace context, specified as "trace <trace ID or traceparent>",
+ * returns NULL if the query isn't traced. */
+static const char *_read_trace_context(CommandCtx *command_ctx) {
+	for(int i = 3; i < command_ctx->argc - 1; i++) {
+		if(strcasecmp(RedisModule_StringPtrLen(command_ctx->argv[i], NULL), "trace")) continue;
+		return RedisModule_StringPtrLen(command_ctx->argv[i + 1], NULL);
+	}
+	return NULL;
+}
+
+/* Read the graph version the query must observe, specified as "min_version <version>",
+ * 0 if the query doesn't require a version.
+ * Returns false if the specified version is invalid. */
+static bool _read_min_version(CommandCtx *command_ctx, long long *version) {
+	*version = 0;
+	for(int i = 3; i < command_ctx->argc - 1; i++) {
+		if(strcasecmp(RedisModule_StringPtrLen(command_ctx->argv[i], NULL), "min_version")) continue;
+		return (RedisModule_StringToLongLong(command_ctx->argv[i + 1], version) == REDISMODULE_OK &&
+				*version >= 0);
+	}
+	return true;
+}
+
+/* Wait up to MIN_VERSION_WAIT milliseconds for a replica to apply the writes
+ * up to version, polling the graph's write version without holding its lock.
+ * Queries running under a lock held by their caller don't wait,
+ * as the awaited writes couldn't be applied meanwhile.
+ * Returns true once the graph reached version. */
+static bool _await_min_version(CommandCtx *command_ctx, GraphContext *gc, uint64_t version,
+							   bool wait) {
+	if(GraphContext_GetWriteVersion(gc) >= version) return true;
+	if(!wait || min_version_wait == 0) return false;
+
+	double timer[2];
+	simple_tic(timer);
+	while(simple_toc(timer) * 1000 < min_version_wait) {
+		if(__atomic_load_n(&command_ctx->progress.cancelled, __ATOMIC_RELAXED)) return false;
+		usleep(1000);
+		if(GraphContext_GetWriteVersion(gc) >= version) return true;
+	}
+	return false;
+}
+
+/* Read the number of records replied before the query is suspended,
+ * specified as "cursor <count>", 0 if the query isn't read through a cursor.
+ * Returns false if the specified count is invalid. */
+static bool _read_cursor_count(CommandCtx *command_ctx, long long *count) {
+	*count = 0;
+	for(int i = 3; i < command_ctx->argc - 1; i++) {
+		if(strcasecmp(RedisModule_StringPtrLen(command_ctx->argv[i], NULL), "cursor")) continue;
+		return (RedisModule_StringToLongLong(command_ctx->argv[i + 1], count) == REDISMODULE_OK &&
+				*count > 0);
+	}
+	return true;
+}
+
+// Options accepted by query commands, and the number of arguments making up each.
+static const struct {
+	const char *name;
+	int len;
+} _query_options[] = {
+	{"--compact", 1},
+	{"--compact-ids", 1},
+	{"--compact-dict", 1},
+	{"--binary", 1},
+	{"--compress", 2},
+	{"timeout", 2},
+	{"cursor", 2},
+	{"trace", 2},
+	{"min_version", 2},
+};
+
+int Graph_QueryOptionLen(const char *arg) {
+	for(size_t i = 0; i < sizeof(_query_options) / sizeof(_query_options[0]); i++) {
+		if(!strcasecmp(arg, _query_options[i].name)) return _query_options[i].len;
+	}
+	return 0;
+}
+
+/* Returns the number of arguments making up the query option at position i,
+ * 0 if the argument isn't an option. */
+static int _query_option_len(CommandCtx *command_ctx, int i) {
+	return Graph_QueryOptionLen(RedisModule_StringPtrLen(command_ctx->argv[i], NULL));
+}
+
+/* Determine whether the query body starts right after the scanned parameters prefix,
+ * making the body a valid cache key. */
+static bool _body_offset_verified(const cypher_parse_result_t *parse_result, size_t body_offset) {
+	const cypher_astnode_t *statement = cypher_parse_result_get_root(parse_result, 0);
+	const cypher_astnode_t *body = cypher_ast_statement_get_body(statement);
+	return cypher_astnode_range(body).start.offset == body_offset;
+}
+
+// Functions whose values differ between invocations over the same graph.
+static const char *_nondeterministic_funcs[] = {"rand", "randomUUID", "timestamp"};
+
+/* Determine whether the query's result is determined by the graph alone, such that
+ * it may be replayed as long as the graph isn't modified. Procedures may read state
+ * outside of the graph, user-defined functions aren't known to be deterministic. */
+static bool _result_reproducible(const AST *ast) {
+	if(AST_TreeContainsType(ast->root, CYPHER_AST_CALL)) return false;
+
+	bool reproducible = true;
+	rax *referred_funcs = raxNew();
+	AST_ReferredFunctions(ast->root, referred_funcs);
+
+	raxIterator it;
+	raxStart(&it, referred_funcs);
+	raxSeek(&it, "^", NULL, 0);
+	while(reproducible && raxNext(&it)) {
+		char func_name[it.key_len + 1];
+		memcpy(func_name, it.key, it.key_len);
+		func_name[it.key_len] = '\0';
+		for(uint i = 0; i < 3; i++) {
+			if(strcasecmp(func_name, _nondeterministic_funcs[i]) == 0) reproducible = false;
+		}
+		AR_FuncDesc *func = AR_GetFunc(func_name);
+		if(func && func->udf) reproducible = false;
+	}
+	raxStop(&it);
+	raxFree(referred_funcs);
+
+	return reproducible;
+}
+
+/* Build the result cache key of a query, its result format followed by the query,
+ * parameters included. */
+static char *_result_cache_key(const char *query, ResultSetFormatterType format, size_t *len) {
+	size_t query_len = strlen(query);
+	*len = query_len + 1;
+	char *key = rm_malloc(*len);
+	key[0] = (char)format;
+	memcpy(key + 1, query, query_len);
+	return key;
+}
+
+/* Run a single query, replying with its result set.
+ * Batched queries run under a read lock held by the caller.
+ * If readonly_only is set, queries which may modify the graph are rejected.
+ * Read-only queries issued with the cursor option are suspended
+ * once they replied with the requested number of records.
+ * If results are cached, read-only queries replay the result cached
+ * at the current graph version, skipping execution.
+ * Grouped queries are run by their commit group's leader, which holds the writers mutex
+ * and refreshes views once the group's window is committed.
+ * Traced queries record a span per phase, published once the query completes.
+ * Queries issued with a minimal version are rejected unless the graph reaches it,
+ * such that reads offloaded to replicas observe the writes the client made. */
+static void _Graph_RunQuery(CommandCtx *command_ctx, bool batched, bool readonly_only,
+							bool grouped) {
 	AST *ast = NULL;
+	bool readonly = false;
+	bool modified = false;
+	bool cache_hit = false;
 	bool lockAcquired = false;
+	uint64_t version = 0;
+	uint64_t cursor_id = 0;
+	uint64_t plan_fingerprint = 0;
+	double reply_time = 0;
+	const char *body = command_ctx->query;
+	char *result_key = NULL;
+	size_t result_key_len = 0;
+	CachedResult *cached_result = NULL;
+	ExecutionPlan *cursor_plan = NULL;
+	Trace *trace = NULL;
 	ResultSet *result_set = NULL;
-	CommandCtx *command_ctx = (CommandCtx *)args;
+	CachedPlan *cached_plan = NULL;
+	cypher_parse_result_t *parse_result = NULL;
+	cypher_parse_result_t *params_parse_result = NULL;
 	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
 	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
 	QueryCtx_SetGlobalExecutionCtx(command_ctx);
 
 	QueryCtx_BeginTimer(); // Start query timing.
 
-	// Parse the query to construct an AST.
-	cypher_parse_result_t *parse_result = parse(command_ctx->query);
-	if(parse_result == NULL) goto cleanup;
+	// Grouped and batched queries were queued as part of their group or batch.
+	if(!grouped && !batched && ThreadPools_CurrentLane() != THPOOL_LANE_COUNT) {
+		QueryCtx_SetQueueWait(ThreadPools_CurrentWait());
+		Graph_RecordLatency(gc->g, GRAPH_LATENCY_QUEUE_WAIT, QueryCtx_GetQueueWait());
+	}
 
-	// Perform query validations
-	if(AST_Validate(ctx, parse_result) != AST_VALID) goto cleanup;
+	long long timeout;
+	if(!_read_timeout(command_ctx, &timeout)) {
+		RedisModule_ReplyWithError(ctx, "Failed to parse query timeout");
+		goto cleanup;
+	}
+	QueryCtx_SetTimeout(timeout);
 
-	bool readonly = AST_ReadOnly(parse_result);
+	const char *trace_context = _read_trace_context(command_ctx);
+	if(trace_context) {
+		bool valid;
+		trace = Trace_New(trace_context, &valid);
+		if(!valid) {
+			RedisModule_ReplyWithError(ctx, "Invalid trace context, expecting a 32 hex digit trace ID "
+									   "or a traceparent");
+			goto cleanup;
+		}
+		QueryCtx_SetTrace(trace);
+	}
 
-	// Prepare the constructed AST for accesses from the module
-	ast = AST_Build(parse_result);
+	// The client timed out while the query was queued and was already replied to.
+	if(__atomic_load_n(&command_ctx->progress.cancelled, __ATOMIC_RELAXED)) goto cleanup;
+
+	long long min_version;
+	if(!_read_min_version(command_ctx, &min_version)) {
+		RedisModule_ReplyWithError(ctx, "Failed to parse minimal graph version");
+		goto cleanup;
+	}
+	if(min_version > 0 && !_await_min_version(command_ctx, gc, min_version, !batched && !grouped)) {
+		// The client may have timed out while waiting and was already replied to.
+		if(__atomic_load_n(&command_ctx->progress.cancelled, __ATOMIC_RELAXED)) goto cleanup;
+		char *error;
+		asprintf(&error, "Graph version %llu is behind the requested minimal version %lld",
+				 (unsigned long long)GraphContext_GetWriteVersion(gc), min_version);
+		RedisModule_ReplyWithError(ctx, error);
+		free(error);
+		goto cleanup;
+	}
 
-	bool compact = _check_compact_flag(command_ctx);
-	ResultSetFormatterType resultset_format = (compact) ? FORMATTER_COMPACT : FORMATTER_VERBOSE;
+	long long cursor_count;
+	if(!_read_cursor_count(command_ctx, &cursor_count)) {
+		RedisModule_ReplyWithError(ctx, "Failed to parse cursor count");
+		goto cleanup;
+	}
+	// Batched queries reply as part of the batch, they're never suspended.
+	if(batched) cursor_count = 0;
 
-	// Acquire the appropriate lock.
-	if(readonly) {
-		Graph_AcquireReadLock(gc->g);
-	} else {
-		Graph_WriterEnter(gc->g);  // Single writer.
-		/* If this is a writer query we need to re-open the graph key with write flag
-		* this notifies Redis that the key is "dirty" any watcher on that key will
-		* be notified. */
-		CommandCtx_ThreadSafeContextLock(command_ctx);
-		{
-			GraphContext_MarkWriter(ctx, gc);
+	bool compress;
+	if(!_read_compression(command_ctx, &compress)) {
+		RedisModule_ReplyWithError(ctx, "Unsupported reply compression, expecting lz4");
+		goto cleanup;
+	}
+
+	/* Cached plans are keyed by the query body, excluding parameters.
+	 * On a hit only the parameters are parsed. */
+	int64_t span_start = Trace_Now(trace);
+	size_t body_offset = 0;
+	Cache *cache = GraphContext_GetCache(gc);
+	bool cacheable = cache && PlanCache_QueryBodyOffset(command_ctx->query, &body_offset);
+	body = command_ctx->query + body_offset;
+	size_t body_len = strlen(body);
+	if(cacheable) {
+		cached_plan = Cache_GetValue(cache, body, body_len);
+		if(cached_plan && !PlanCache_ParseParams(cached_plan, command_ctx->query, body_offset,
+												 &params_parse_result)) {
+			// Invalid parameters, process the query from scratch to report errors.
+			CachedPlan_Release(cached_plan);
+			cached_plan = NULL;
+		}
+		if(cached_plan && cached_plan->plan_params) {
+			// The plan is specialized for parameter values, look for a plan matching these values.
+			cached_plan = PlanCache_GetVariant(cache, cached_plan, body, body_len);
+			// Otherwise the parameters are extracted again along with the query.
+			if(cached_plan == NULL) QueryCtx_ClearParams();
 		}
-		CommandCtx_ThreadSafeContextUnlock(command_ctx);
 	}
-	lockAcquired = true;
 
-	// Set policy after lock acquisition, avoid resetting policies between readers and writers.
-	Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
+	if(cached_plan) {
+		cache_hit = true;
+		ast = cached_plan->ast;
+		readonly = cached_plan->readonly;
+		QueryCtx_SetAST(ast);
+		Trace_EndSpan(trace, "parse", Trace_Root(trace), span_start, 0);
+	} else {
+		// Parse the query to construct an AST.
+		parse_result = parse(command_ctx->query);
+		Trace_EndSpan(trace, "parse", Trace_Root(trace), span_start, 0);
+		if(parse_result == NULL) goto cleanup;
+
+		// Perform query validations
+		span_start = Trace_Now(trace);
+		bool ast_valid = (AST_Validate(ctx, parse_result) == AST_VALID);
+		Trace_EndSpan(trace, "validate", Trace_Root(trace), span_start, 0);
+		if(!ast_valid) goto cleanup;
+
+		readonly = AST_ReadOnly(parse_result);
+
+		// Prepare the constructed AST for accesses from the module
+		ast = AST_Build(parse_result);
+	}
+
+	ResultSetFormatterType resultset_format = _read_format(command_ctx);
+	if(compress) resultset_format = FORMATTER_BINARY_LZ4;
+
+	if(readonly_only && !readonly) {
+		char *error;
+		asprintf(&error, "%s only supports read-only queries", command_ctx->command_name);
+		RedisModule_ReplyWithError(ctx, error);
+		free(error);
+		goto cleanup;
+	}
+
+	// A suspended writer would hold the graph exclusively between reads.
+	if(cursor_count > 0 && !readonly) {
+		RedisModule_ReplyWithError(ctx, "Cursors are only supported for read-only queries");
+		goto cleanup;
+	}
+
+	/* Results are cached per format, results read through a cursor
+	 * or which might differ between executions are never cached. */
+	Cache *result_cache = GraphContext_GetResultCache(gc);
+	const cypher_astnode_type_t root_type = cypher_astnode_type(ast->root);
+	if(result_cache && readonly && cursor_count == 0 && root_type == CYPHER_AST_QUERY &&
+	   _result_reproducible(ast)) {
+		result_key = _result_cache_key(command_ctx->query, resultset_format, &result_key_len);
+	}
+
+	// Acquire the appropriate lock, batched queries run under the caller's read lock.
+	double wait_timer[2];
+	simple_tic(wait_timer);
+	span_start = Trace_Now(trace);
+	if(readonly && !batched) {
+		Graph_AcquireReadLock(gc->g);
+		lockAcquired = true;
+	} else if(!readonly && !grouped) {
+		/* Single writer, Redis is notified that the key is "dirty"
+		 * once changes are committed. */
+		Graph_WriterEnter(gc->g);
+		lockAcquired = true;
+	}
+	double lock_wait = simple_toc(wait_timer) * 1000;
+	QueryCtx_AddLockWait(lock_wait);
+	Trace_AddSpan(trace, "lock_wait", Trace_Root(trace), span_start, lock_wait, 0);
+	// Cursors are invalidated once a writer acquires the graph.
+	version = gc->g->version;
+
+	/* Set policy after lock acquisition, avoid resetting policies between readers and writers.
+	 * Batched queries share a single policy set by the caller. */
+	if(!batched) Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
 	result_set = NewResultSet(ctx, resultset_format);
 	QueryCtx_SetResultSet(result_set);
-	const cypher_astnode_type_t root_type = cypher_astnode_type(ast->root);
-	if(root_type == CYPHER_AST_QUERY) {  // query operation
-		ExecutionPlan *plan = NewExecutionPlan();
-		/* Make sure there are no compile-time errors.
-		 * We prefer to emit the error only once the entire execution-plan
-		 * is constructed in-favour of the time it was encountered
-		 * for memory management considerations.
-		 * this should be revisited in order to save some time (fail fast). */
-		if(QueryCtx_EncounteredError()) {
-			if(plan) ExecutionPlan_Free(plan);
-			QueryCtx_EmitException();
-			goto cleanup;
-		}
+	if(result_key) cached_result = ResultCache_Get(result_cache, result_key, result_key_len, version);
+	if(cached_result) {
+		// The graph wasn't modified since the result was cached, replay it.
+		result_set->stats.cached = true;
+		ResultSet_AddCachedRecords(result_set, cached_result);
+		CachedResult_Release(cached_result);
+	} else if(root_type == CYPHER_AST_QUERY) {  // query operation
+		ExecutionPlan *plan;
+		span_start = Trace_Now(trace);
+		if(cache_hit) {
+			// Execute a clone of the cached plan, skipping plan construction and optimization.
+			plan = ExecutionPlan_Clone(cached_plan->plan);
+			assert(plan);
+		} else {
+			plan = NewExecutionPlan();
+			/* Make sure there are no compile-time errors.
+			 * We prefer to emit the error only once the entire execution-plan
+			 * is constructed in-favour of the time it was encountered
+			 * for memory management considerations.
+			 * this should be revisited in order to save some time (fail fast). */
+			if(QueryCtx_EncounteredError()) {
+				if(plan) ExecutionPlan_Free(plan);
+				QueryCtx_EmitException();
+				goto cleanup;
+			}
+
+			if(!plan) goto cleanup;
+			ExecutionPlan_PreparePinnedPlan(plan, gc, command_ctx->query);
 
-		if(!plan) goto cleanup;
-		ExecutionPlan_PreparePlan(plan);
-		result_set = ExecutionPlan_Execute(plan);
-		ExecutionPlan_Free(plan);
+			/* Cache the prepared plan if it doesn't depend on this query's data, plans depending
+			 * on parameter values are cached for those values. The cache entry takes ownership
+			 * of the plan and AST, a clone is executed. */
+			if(cacheable && QueryCtx_IsPlanReusable() &&
+			   _body_offset_verified(parse_result, body_offset)) {
+				ExecutionPlan *clone = ExecutionPlan_Clone(plan);
+				if(clone) {
+					cached_plan = CachedPlan_New(parse_result, ast, plan, readonly);
+					PlanCache_Add(cache, body, body_len, cached_plan, QueryCtx_GetPlanParams());
+					plan = clone;
+				}
+			}
+		}
+		Trace_EndSpan(trace, "plan", Trace_Root(trace), span_start, 0);
+		result_set->stats.cached = cache_hit;
+		if(result_key) {
+			ResultSet_CaptureRecords(result_set, CachedResult_New(result_set->columns,
+																  result_set->column_count, version));
+		}
+		if(cursor_count == 0) {
+			result_set = (trace) ? ExecutionPlan_Trace(plan, trace, Trace_Root(trace)) :
+						 ExecutionPlan_Execute(plan);
+			// Executions are aggregated by fingerprint, cached plans are fingerprinted once.
+			plan_fingerprint = (cached_plan) ? cached_plan->fingerprint : ExecutionPlan_Fingerprint(plan);
+			ExecutionPlan_Free(plan);
+			// Failing queries, timed out ones included, aren't cached.
+			if(result_set->capture && !QueryCtx_EncounteredError()) {
+				ResultCache_Add(result_cache, result_key, result_key_len, result_set->capture);
+			}
+		} else {
+			// Reply with the first records, the remaining records are read through a cursor.
+			span_start = Trace_Now(trace);
+			if(!ExecutionPlan_ExecuteLimit(plan, cursor_count)) {
+				cursor_id = Cursors_Reserve(GraphContext_GetCursors(gc));
+				if(cursor_id == 0) QueryCtx_SetError(strdup("Maximum number of open cursors reached"));
+			}
+			Trace_EndSpan(trace, "execute", Trace_Root(trace), span_start, result_set->recordCount);
+			plan_fingerprint = (cached_plan) ? cached_plan->fingerprint : ExecutionPlan_Fingerprint(plan);
+			if(cursor_id) cursor_plan = plan;
+			else ExecutionPlan_Free(plan);
+			result_set->cursor = cursor_id;
+		}
 	} else if(root_type == CYPHER_AST_CREATE_NODE_PROPS_INDEX ||
 			  root_type == CYPHER_AST_DROP_NODE_PROPS_INDEX) {
 		_index_operation(ctx, gc, ast->root);
+	} else if(root_type == CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT ||
+			  root_type == CYPHER_AST_DROP_NODE_PROP_CONSTRAINT) {
+		_constraint_operation(ctx, gc, ast->root);
 	} else {
 		assert("Unhandled query type" && false);
 	}
 	QueryCtx_ForceUnlockCommit();
+	span_start = Trace_Now(trace);
+	double reply_timer[2];
+	simple_tic(reply_timer);
 	ResultSet_Reply(result_set);    // Send result-set back to client.
+	reply_time = simple_toc(reply_timer) * 1000;
+	Trace_EndSpan(trace, "reply", Trace_Root(trace), span_start, result_set->recordCount);
 
 	// Clean up.
 cleanup:
@@ -135,12 +640,169 @@ cleanup:
 
 	// Log query to slowlog.
 	SlowLog *slowlog = GraphContext_GetSlowLog(gc);
-	SlowLog_Add(slowlog, command_ctx->command_name, command_ctx->query, QueryCtx_GetExecutionTime());
+	SlowLogStats stats = {
+		.latency = QueryCtx_GetExecutionTime(),
+		.lock_wait = QueryCtx_GetLockWait(),
+		.queue_wait = QueryCtx_GetQueueWait(),
+		.matrix_sync = QueryCtx_GetMatrixSync(),
+		.reply = reply_time,
+		.rows = (result_set) ? result_set->recordCount : 0,
+		.plan_fingerprint = plan_fingerprint,
+		.peak_memory = QueryCtx_GetPeakMemory()
+	};
+	SlowLog_Add(slowlog, command_ctx->command_name, command_ctx->query, &stats);
+	// Queries failing to parse are neither reads nor writes.
+	if(ast) {
+		Graph_RecordLatency(gc->g, (readonly) ? GRAPH_LATENCY_READ_QUERY : GRAPH_LATENCY_WRITE_QUERY,
+							stats.latency);
+	}
+	if(plan_fingerprint) {
+		QueryStats_Record(GraphContext_GetQueryStats(gc), plan_fingerprint, body, stats.latency,
+						  QueryCtx_EncounteredError());
+	}
+	Trace_Publish(trace, stats.rows);
+	QueryCtx_SetTrace(NULL);
 
+	if(cursor_id) {
+		// The cursor takes ownership of the suspended query.
+		QueryCursor_Suspend(gc, cursor_id, cursor_count, version, command_ctx->query, cursor_plan,
+							result_set, cached_plan, ast, parse_result, params_parse_result);
+		return;
+	}
+
+	if(result_key) rm_free(result_key);
+	if(!readonly && result_set) modified = ResultSetStat_IndicateModification(result_set->stats);
 	ResultSet_Free(result_set);
-	AST_Free(ast);
-	parse_result_free(parse_result);
+	if(cached_plan) {
+		// The cached plan owns the AST and its parse result.
+		CachedPlan_Release(cached_plan);
+	} else {
+		AST_Free(ast);
+		parse_result_free(parse_result);
+	}
+	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
+	// Parameter values reference the params parse result, free it once they're released.
+	parse_result_free(params_parse_result);
+
+	// Views reflect the modification once the write completes.
+	if(modified && !grouped) Graph_RefreshViews(command_ctx, gc);
+}
+
+void Graph_Query(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	_Graph_RunQuery(command_ctx, false, false, false);
+
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
+
+/* Concurrent writers of a graph are coalesced into a commit group, the first writer
+ * to arrive leads the group, running the writers queued behind it one after the other.
+ * Each window of up to COMMIT_GROUP_WINDOW_MAX writers schedules a single synchronization
+ * of the graph's matrices and refreshes views once, the window's clients are replied to
+ * once it is committed. The GIL and the graph's write lock are acquired by each writer
+ * for its own commit only, as the main thread takes graph locks while holding the GIL,
+ * and Redis must keep serving other clients while the window's writers execute. */
+void Graph_GroupCommitQuery(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	CommitGroup *group = GraphContext_GetCommitGroup(gc);
+
+	CommitGroupRole role = CommitGroup_Join(group, command_ctx);
+	if(role == COMMIT_GROUP_QUEUED) return; // Run by the group's leader.
+	if(role == COMMIT_GROUP_FULL) {
+		Graph_Query(args);
+		return;
+	}
+
+	uint count = 0;
+	CommandCtx *window[COMMIT_GROUP_WINDOW_MAX];
+	while(command_ctx) {
+		/* The writers mutex is held throughout the window, such that writers outside of
+		 * the group, and the group's next leader, wait for the window to end. */
+		if(count == 0) Graph_WriterEnter(gc->g);
+		_Graph_RunQuery(command_ctx, false, false, true);
+		window[count++] = command_ctx;
+
+		command_ctx = CommitGroup_Next(group);
+		if(command_ctx && count < COMMIT_GROUP_WINDOW_MAX) continue;
+
+		// Commit the window.
+		bool modified = QueryCtx_EndCommitWindow(gc);
+		Graph_WriterLeave(gc->g);
+		if(modified) Graph_RefreshViews(window[count - 1], gc);
+		// Each writer holds a reference to the graph, the last one may free it.
+		for(uint i = 0; i < count; i++) {
+			GraphContext_Release(gc);
+			CommandCtx_Free(window[i]);
+		}
+		count = 0;
+	}
+}
+
+void Graph_ReadOnlyQuery(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	_Graph_RunQuery(command_ctx, false, true, false);
+
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
+
+/* Runs multiple read-only queries under a single read lock acquisition
+ * replies with an array of result sets, one per query
+ * Args:
+ * argv[1] graph name
+ * argv[2..] queries */
+void Graph_Batch(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	// Count queries, skipping options.
+	long query_count = 0;
+	for(int i = 2; i < command_ctx->argc; i++) {
+		int option_len = _query_option_len(command_ctx, i);
+		if(option_len == 0) query_count++;
+		else i += option_len - 1;
+	}
+
+	if(query_count == 0) {
+		RedisModule_WrongArity(ctx);
+		goto cleanup;
+	}
+
+	Graph_AcquireReadLock(gc->g);
+	Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
+
+	RedisModule_ReplyWithArray(ctx, query_count);
+	char *batch_query = command_ctx->query;
+	for(int i = 2; i < command_ctx->argc; i++) {
+		int option_len = _query_option_len(command_ctx, i);
+		if(option_len > 0) {
+			i += option_len - 1;
+			continue;
+		}
+
+		size_t len;
+		const char *query = RedisModule_StringPtrLen(command_ctx->argv[i], &len);
+
+		// Make a copy of query, command context owns its query string.
+		command_ctx->query = rm_malloc(len + 1);
+		memcpy(command_ctx->query, query, len);
+		command_ctx->query[len] = '\0';
+
+		_Graph_RunQuery(command_ctx, true, true, false);
+		rm_free(command_ctx->query);
+	}
+	command_ctx->query = batch_query;
+
+	Graph_ReleaseLock(gc->g);
+
+cleanup:
 	GraphContext_Release(gc);
 	CommandCtx_Free(command_ctx);
-	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
 }
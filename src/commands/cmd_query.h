@@ -7,3 +7,10 @@
 #pragma once
 
 void Graph_Query(void *args);
+void Graph_GroupCommitQuery(void *args);
+void Graph_ReadOnlyQuery(void *args);
+void Graph_Batch(void *args);
+
+/* Returns the number of arguments making up the query option named arg,
+ * 0 if arg isn't a query option. */
+int Graph_QueryOptionLen(const char *arg);
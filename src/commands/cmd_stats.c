@@ -0,0 +1,60 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_stats.h"
+#include "cmd_context.h"
+#include <stdio.h>
+#include <string.h>
+
+// Replies with a latency in milliseconds, rounded to microseconds.
+static void _Stats_ReplyWithLatency(RedisModuleCtx *ctx, double ms) {
+	char str[32];
+	int len = snprintf(str, sizeof(str), "%.3f", ms);
+	RedisModule_ReplyWithStringBuffer(ctx, str, len);
+}
+
+/* Reports the latency distributions of a graph, each as its number of samples
+ * followed by its mean, median, 90th, 99th and 99.9th percentiles and maximum,
+ * in milliseconds. Distributions are read while being recorded into,
+ * the graph isn't locked.
+ * Args:
+ * argv[1] graph name */
+void Graph_Stats(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	if(command_ctx->argc != 2) {
+		RedisModule_WrongArity(ctx);
+		goto cleanup;
+	}
+
+	RedisModule_ReplyWithArray(ctx, GRAPH_LATENCY_COUNT * 2);
+	for(GraphLatency l = 0; l < GRAPH_LATENCY_COUNT; l++) {
+		LatencySummary summary = LatencyHistogram_Summarize(Graph_GetLatency(gc->g, l));
+		const char *name = Graph_LatencyName(l);
+		RedisModule_ReplyWithStringBuffer(ctx, name, strlen(name));
+		RedisModule_ReplyWithArray(ctx, 14);
+		RedisModule_ReplyWithSimpleString(ctx, "count");
+		RedisModule_ReplyWithLongLong(ctx, summary.count);
+		RedisModule_ReplyWithSimpleString(ctx, "mean_ms");
+		_Stats_ReplyWithLatency(ctx, summary.mean);
+		RedisModule_ReplyWithSimpleString(ctx, "p50_ms");
+		_Stats_ReplyWithLatency(ctx, summary.p50);
+		RedisModule_ReplyWithSimpleString(ctx, "p90_ms");
+		_Stats_ReplyWithLatency(ctx, summary.p90);
+		RedisModule_ReplyWithSimpleString(ctx, "p99_ms");
+		_Stats_ReplyWithLatency(ctx, summary.p99);
+		RedisModule_ReplyWithSimpleString(ctx, "p999_ms");
+		_Stats_ReplyWithLatency(ctx, summary.p999);
+		RedisModule_ReplyWithSimpleString(ctx, "max_ms");
+		_Stats_ReplyWithLatency(ctx, summary.max);
+	}
+
+cleanup:
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
@@ -0,0 +1,36 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_trace.h"
+#include "../tracing/trace.h"
+#include <strings.h>
+
+/* Drains spans recorded by traced queries, spans aren't associated with a graph.
+ * Args:
+ * argv[1] DRAIN [count], replies with and removes up to count of the oldest spans,
+ *         all buffered spans if count is omitted.
+ * argv[1] STATS, replies with the span buffer's capacity and occupancy. */
+int MGraph_Trace(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc < 2) return RedisModule_WrongArity(ctx);
+
+	const char *subcmd = RedisModule_StringPtrLen(argv[1], NULL);
+	if(!strcasecmp(subcmd, "DRAIN")) {
+		if(argc > 3) return RedisModule_WrongArity(ctx);
+		long long count = 0;
+		if(argc == 3 && (RedisModule_StringToLongLong(argv[2], &count) != REDISMODULE_OK || count < 1)) {
+			RedisModule_ReplyWithError(ctx, "Failed to parse span count");
+			return REDISMODULE_OK;
+		}
+		Trace_Drain(ctx, count);
+	} else if(!strcasecmp(subcmd, "STATS")) {
+		if(argc != 2) return RedisModule_WrongArity(ctx);
+		Trace_ReplyStats(ctx);
+	} else {
+		RedisModule_ReplyWithError(ctx, "Unknown subcommand, expecting DRAIN or STATS");
+	}
+
+	return REDISMODULE_OK;
+}
@@ -0,0 +1,254 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_view.h"
+#include "../ast/ast.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../graph/graph.h"
+#include "../util/rmalloc.h"
+#include "../execution_plan/execution_plan.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static int _View_CompareIDs(const void *a, const void *b) {
+	NodeID x = *(const NodeID *)a;
+	NodeID y = *(const NodeID *)b;
+	return (x > y) - (x < y);
+}
+
+/* Consume the records produced by projection, collecting the IDs of the nodes in column.
+ * Returns false if the column holds a value other than a node. */
+static bool _View_Collect(OpBase *projection, const char *column, NodeID **ids) {
+	Record r;
+	int idx = INVALID_INDEX;
+	while((r = OpBase_Consume(projection)) != NULL) {
+		if(idx == INVALID_INDEX) idx = Record_GetEntryIdx(r, column);
+		SIValue v = Record_Get(r, idx);
+		SIType t = SI_TYPE(v);
+		if(t == T_NODE) *ids = array_append(*ids, ENTITY_GET_ID((Node *)v.ptrval));
+		ExecutionPlan_ReturnRecord(r->owner, r);
+		if(t != T_NODE && t != T_NULL) {
+			QueryCtx_SetError(strdup("Materialized views must return nodes in their first column"));
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Run a view's query under the graph's read lock,
+ * collecting the sorted, distinct IDs of the nodes it returns in its first column.
+ * Returns false if the query fails, in which case the QueryCtx holds the error. */
+static bool _View_Materialize(CommandCtx *command_ctx, GraphContext *gc, const char *query,
+							  NodeID **ids, uint64_t *count) {
+	bool success = false;
+	ExecutionPlan *plan = NULL;
+	// Held on the heap, as it is modified past the exception handler.
+	NodeID **collected = rm_malloc(sizeof(NodeID *));
+	*collected = array_new(NodeID, 256);
+
+	QueryCtx_SetGlobalExecutionCtx(command_ctx);
+	QueryCtx_SetGraphCtx(gc);
+
+	// View queries are validated once defined.
+	cypher_parse_result_t *parse_result = parse(query);
+	AST *ast = AST_Build(parse_result);
+	ResultSet *set = NewResultSet(CommandCtx_GetRedisCtx(command_ctx), FORMATTER_NOP);
+	QueryCtx_SetResultSet(set);
+
+	Graph_AcquireReadLock(gc->g);
+	Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
+
+	plan = NewExecutionPlan();
+	if(!plan || QueryCtx_EncounteredError()) goto cleanup;
+	if(plan->root->type != OPType_RESULTS || set->column_count == 0) {
+		QueryCtx_SetError(strdup("Materialized views must return nodes in their first column"));
+		goto cleanup;
+	}
+	ExecutionPlan_PreparePlan(plan);
+
+	// Run-time errors return to this point.
+	if(SET_EXCEPTION_HANDLER()) goto cleanup;
+	QueryCtx_SetPlanBuilt();
+	ExecutionPlan_Init(plan);
+	// Records are pulled from below the Results operation, which would reply with them.
+	if(!_View_Collect(plan->root->children[0], set->columns[0], collected)) goto cleanup;
+
+	uint64_t n = array_len(*collected);
+	qsort(*collected, n, sizeof(NodeID), _View_CompareIDs);
+	*ids = rm_malloc(sizeof(NodeID) * (n + 1));
+	*count = 0;
+	for(uint64_t i = 0; i < n; i++) {
+		if(*count > 0 && (*ids)[*count - 1] == (*collected)[i]) continue;
+		(*ids)[(*count)++] = (*collected)[i];
+	}
+	success = true;
+
+cleanup:
+	if(plan) ExecutionPlan_Free(plan);
+	Graph_ReleaseLock(gc->g);
+	ResultSet_Free(set);
+	AST_Free(ast);
+	parse_result_free(parse_result);
+	array_free(*collected);
+	rm_free(collected);
+	return success;
+}
+
+void Graph_RefreshViews(CommandCtx *command_ctx, GraphContext *gc) {
+	MaterializedViews *views = GraphContext_GetMaterializedViews(gc);
+	if(MaterializedViews_Count(views) == 0) return;
+
+	/* Refreshes are serialized, such that a refresh following a modification
+	 * isn't overwritten by a concurrent one which computed its IDs earlier. */
+	pthread_mutex_lock(&views->refresh);
+	MaterializedViews_Invalidate(views);
+
+	char *name;
+	char *query;
+	while(MaterializedViews_NextStale(views, &name, &query)) {
+		NodeID *ids;
+		uint64_t count;
+		// A failing view retains its previous IDs.
+		if(_View_Materialize(command_ctx, gc, query, &ids, &count)) {
+			MaterializedViews_Refresh(views, name, query, ids, count);
+		}
+		QueryCtx_Free(); // Reset the QueryCtx for the next view.
+		rm_free(name);
+		rm_free(query);
+	}
+	pthread_mutex_unlock(&views->refresh);
+}
+
+// Validates a view's query, replying with an error if the query can't define a view.
+static bool _View_Validate(RedisModuleCtx *ctx, const char *query) {
+	bool valid = false;
+	cypher_parse_result_t *parse_result = parse(query);
+	if(parse_result == NULL) return false;
+	if(AST_Validate(ctx, parse_result) != AST_VALID) goto cleanup;
+
+	const cypher_astnode_t *statement = cypher_parse_result_get_root(parse_result, 0);
+	const cypher_astnode_t *body = cypher_ast_statement_get_body(statement);
+	if(cypher_ast_statement_noptions(statement) > 0) {
+		RedisModule_ReplyWithError(ctx, "Materialized views can't specify parameters");
+	} else if(cypher_astnode_type(body) != CYPHER_AST_QUERY || !AST_ReadOnly(parse_result)) {
+		RedisModule_ReplyWithError(ctx, "Materialized views must be defined by read-only queries");
+	} else {
+		valid = true;
+	}
+
+cleanup:
+	parse_result_free(parse_result);
+	return valid;
+}
+
+static void _View_Create(CommandCtx *command_ctx, GraphContext *gc) {
+	char *reply;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	MaterializedViews *views = GraphContext_GetMaterializedViews(gc);
+	const char *name = RedisModule_StringPtrLen(command_ctx->argv[3], NULL);
+	const char *query = RedisModule_StringPtrLen(command_ctx->argv[4], NULL);
+
+	if(!_View_Validate(ctx, query)) return;
+
+	NodeID *ids;
+	uint64_t count;
+	pthread_mutex_lock(&views->refresh);
+	bool materialized = _View_Materialize(command_ctx, gc, query, &ids, &count);
+	bool defined = materialized && MaterializedViews_Set(views, name, query, ids, count);
+	pthread_mutex_unlock(&views->refresh);
+
+	if(!materialized) {
+		QueryCtx_EmitException();
+		return;
+	}
+	if(!defined) {
+		asprintf(&reply, "Unable to create view %s: maximum number of views (%d) reached",
+				 name, MATERIALIZED_VIEWS_MAX);
+		RedisModule_ReplyWithError(ctx, reply);
+		free(reply);
+		return;
+	}
+
+	// Replicas maintain their own copy of the view.
+	CommandCtx_ThreadSafeContextLock(command_ctx);
+	RedisModule_Replicate(ctx, "GRAPH.VIEW", "ccss", gc->graph_name, "CREATE",
+						  command_ctx->argv[3], command_ctx->argv[4]);
+	CommandCtx_ThreadSafeContextUnlock(command_ctx);
+
+	asprintf(&reply, "Materialized %llu nodes, internal execution time: %.6f milliseconds",
+			 (unsigned long long)count, QueryCtx_GetExecutionTime());
+	RedisModule_ReplyWithStringBuffer(ctx, reply, strlen(reply));
+	free(reply);
+}
+
+static void _View_Drop(CommandCtx *command_ctx, GraphContext *gc) {
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	const char *name = RedisModule_StringPtrLen(command_ctx->argv[3], NULL);
+
+	if(!MaterializedViews_Remove(GraphContext_GetMaterializedViews(gc), name)) {
+		RedisModule_ReplyWithError(ctx, "No such materialized view");
+		return;
+	}
+
+	CommandCtx_ThreadSafeContextLock(command_ctx);
+	RedisModule_Replicate(ctx, "GRAPH.VIEW", "ccs", gc->graph_name, "DROP", command_ctx->argv[3]);
+	CommandCtx_ThreadSafeContextUnlock(command_ctx);
+	RedisModule_ReplyWithSimpleString(ctx, "OK");
+}
+
+// Reply with the name, query and node count of each view.
+static void _View_List(CommandCtx *command_ctx, GraphContext *gc) {
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	MaterializedViews *views = GraphContext_GetMaterializedViews(gc);
+
+	uint replied = 0;
+	char *name;
+	char *query;
+	uint64_t count;
+	RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+	while(MaterializedViews_Get(views, replied, &name, &query, &count)) {
+		RedisModule_ReplyWithArray(ctx, 3);
+		RedisModule_ReplyWithStringBuffer(ctx, name, strlen(name));
+		RedisModule_ReplyWithStringBuffer(ctx, query, strlen(query));
+		RedisModule_ReplyWithLongLong(ctx, count);
+		rm_free(name);
+		rm_free(query);
+		replied++;
+	}
+	RedisModule_ReplySetArrayLength(ctx, replied);
+}
+
+/* Manages the materialized views of a graph, the nodes returned by a read-only query,
+ * recomputed whenever the graph is modified and scanned by db.view.nodes.
+ * Args:
+ * argv[1] graph name
+ * argv[2] CREATE <name> <query> | DROP <name> | LIST */
+void Graph_View(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	QueryCtx_BeginTimer();
+	QueryCtx_SetGlobalExecutionCtx(command_ctx);
+
+	const char *op = (command_ctx->argc > 2) ?
+					 RedisModule_StringPtrLen(command_ctx->argv[2], NULL) : "";
+	if(strcasecmp(op, "CREATE") == 0 && command_ctx->argc == 5) {
+		_View_Create(command_ctx, gc);
+	} else if(strcasecmp(op, "DROP") == 0 && command_ctx->argc == 4) {
+		_View_Drop(command_ctx, gc);
+	} else if(strcasecmp(op, "LIST") == 0 && command_ctx->argc == 3) {
+		_View_List(command_ctx, gc);
+	} else {
+		RedisModule_WrongArity(ctx);
+	}
+
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
+}
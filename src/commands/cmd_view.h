@@ -0,0 +1,17 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "cmd_context.h"
+#include "../redismodule.h"
+#include "../graph/graphcontext.h"
+
+void Graph_View(void *args);
+
+/* Recompute the materialized views of a graph following its modification.
+ * Expects no active QueryCtx and neither graph lock to be held. */
+void Graph_RefreshViews(CommandCtx *command_ctx, GraphContext *gc);
@@ -14,6 +14,17 @@
 #include "cmd_explain.h"
 #include "cmd_profile.h"
 #include "cmd_slowlog.h"
+#include "cmd_prepare.h"
+#include "cmd_compact.h"
+#include "cmd_copy.h"
+#include "cmd_view.h"
+#include "cmd_plan.h"
+#include "cmd_cursor.h"
+#include "cmd_fetch.h"
+#include "cmd_export.h"
+#include "cmd_memory.h"
+#include "cmd_stats.h"
+#include "cmd_trace.h"
 #include "cmd_dispatcher.h"
 #include "cmd_bulk_insert.h"
 
@@ -24,5 +35,18 @@ typedef enum {
 	CMD_EXPLAIN,
 	CMD_PROFILE,
 	CMD_BULK_INSERT,
-    CMD_SLOWLOG
+    CMD_SLOWLOG,
+	CMD_PREPARE,
+	CMD_EXECUTE,
+	CMD_BATCH,
+	CMD_RO_QUERY,
+	CMD_COMPACT,
+	CMD_COPY,
+	CMD_VIEW,
+	CMD_PLAN,
+	CMD_CURSOR,
+	CMD_FETCH,
+	CMD_EXPORT,
+	CMD_MEMORY,
+	CMD_STATS
 } GRAPH_Commands;
@@ -0,0 +1,67 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "commit_group.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include <assert.h>
+
+CommitGroup *CommitGroup_New(void) {
+	CommitGroup *group = rm_malloc(sizeof(CommitGroup));
+	group->queue = array_new(void *, COMMIT_GROUP_QUEUE_MAX);
+	group->active = false;
+	group->modified = false;
+	int res = pthread_mutex_init(&group->lock, NULL);
+	assert(res == 0);
+	return group;
+}
+
+CommitGroupRole CommitGroup_Join(CommitGroup *group, void *writer) {
+	CommitGroupRole role;
+	pthread_mutex_lock(&group->lock);
+	if(!group->active) {
+		group->active = true;
+		group->leader = pthread_self();
+		role = COMMIT_GROUP_LEADER;
+	} else if(array_len(group->queue) < COMMIT_GROUP_QUEUE_MAX) {
+		group->queue = array_append(group->queue, writer);
+		role = COMMIT_GROUP_QUEUED;
+	} else {
+		role = COMMIT_GROUP_FULL;
+	}
+	pthread_mutex_unlock(&group->lock);
+	return role;
+}
+
+void *CommitGroup_Next(CommitGroup *group) {
+	void *writer = NULL;
+	pthread_mutex_lock(&group->lock);
+	uint count = array_len(group->queue);
+	if(count > 0) {
+		writer = group->queue[0];
+		array_del(group->queue, 0);
+	} else {
+		// Writers joining from now on lead a group of their own.
+		group->active = false;
+	}
+	pthread_mutex_unlock(&group->lock);
+	return writer;
+}
+
+bool CommitGroup_IsLeader(CommitGroup *group) {
+	pthread_mutex_lock(&group->lock);
+	bool leader = group->active && pthread_equal(group->leader, pthread_self());
+	pthread_mutex_unlock(&group->lock);
+	return leader;
+}
+
+void CommitGroup_Free(CommitGroup *group) {
+	if(group == NULL) return;
+	assert(array_len(group->queue) == 0);
+	array_free(group->queue);
+	pthread_mutex_destroy(&group->lock);
+	rm_free(group);
+}
@@ -0,0 +1,52 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <pthread.h>
+
+// Maximum number of writers waiting for a group's leader.
+#define COMMIT_GROUP_QUEUE_MAX 64
+// Maximum number of writers committed within a single window.
+#define COMMIT_GROUP_WINDOW_MAX 32
+
+// Role assigned to a writer joining a commit group.
+typedef enum {
+	COMMIT_GROUP_LEADER,    // The writer leads the group, running itself first.
+	COMMIT_GROUP_QUEUED,    // The writer is queued, to be run by the group's leader.
+	COMMIT_GROUP_FULL,      // The group's queue is full, the writer runs on its own.
+} CommitGroupRole;
+
+/* Coalesces concurrent writers of a graph, the group's leader runs the queued writers
+ * one after the other, in windows sharing a single scheduling of the work following commits.
+ * Each writer acquires the commit locks for its own commit alone, such that neither the GIL
+ * nor the graph's readers are held up while a writer of the window executes.
+ * Window state is accessed by the leader only, under the graph's writers mutex. */
+typedef struct {
+	void **queue;           // Writers waiting for the leader, in arrival order.
+	bool active;            // A leader runs the group.
+	pthread_t leader;       // Leader thread, valid while active.
+	bool modified;          // A writer of the window modified the graph.
+	pthread_mutex_t lock;   // Guards queue and leadership.
+} CommitGroup;
+
+// Create a new commit group.
+CommitGroup *CommitGroup_New(void);
+
+/* Join writer to the group, if no leader runs the group the caller becomes its leader,
+ * otherwise writer is queued unless the queue is full. */
+CommitGroupRole CommitGroup_Join(CommitGroup *group, void *writer);
+
+/* Dequeue the next writer for the leader to run,
+ * returns NULL once the queue is empty, in which case the leader steps down. */
+void *CommitGroup_Next(CommitGroup *group);
+
+// Returns true if the calling thread leads the group.
+bool CommitGroup_IsLeader(CommitGroup *group);
+
+// Free group, expects its queue to be empty.
+void CommitGroup_Free(CommitGroup *group);
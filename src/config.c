@@ -5,6 +5,7 @@
 */
 
 #include "config.h"
+#include "util/arr.h"
 #include <unistd.h>
 #include <string.h>
 #include <assert.h>
@@ -38,3 +39,436 @@ long long Config_GetThreadCount(RedisModuleCtx *ctx, RedisModuleString **argv, i
 
 	return threadCount;
 }
+
+// Scan key value pairs for a positive thread count named param.
+static long long _Config_GetLaneThreadCount(RedisModuleCtx *ctx, RedisModuleString **argv,
+											int argc, const char *name, long long defaultCount) {
+	long long threadCount = defaultCount;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, name) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &threadCount) != REDISMODULE_OK ||
+				   threadCount <= 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, using %lld threads.", name, defaultCount);
+					threadCount = defaultCount;
+				}
+				break;
+			}
+		}
+	}
+
+	return threadCount;
+}
+
+long long Config_GetWriterThreadCount(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	/* Default, the number of cores available.
+	 * Writers on the same graph are serialized, multiple writer threads
+	 * allow commits on different graphs to proceed in parallel. */
+	int CPUCount = sysconf(_SC_NPROCESSORS_ONLN);
+	long long threadCount = (CPUCount != -1) ? CPUCount : 1;
+	return _Config_GetLaneThreadCount(ctx, argv, argc, WRITER_THREAD_COUNT, threadCount);
+}
+
+long long Config_GetLongReadThreadCount(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, a single thread.
+	return _Config_GetLaneThreadCount(ctx, argv, argc, LONG_READ_THREAD_COUNT, 1);
+}
+
+long long Config_GetTimeout(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, no timeout.
+	long long timeout = 0;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for TIMEOUT.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, TIMEOUT) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &timeout) != REDISMODULE_OK || timeout < 0) {
+					RedisModule_Log(ctx, "warning", "Invalid query timeout, queries will not time out.");
+					timeout = 0;
+				}
+				break;
+			}
+		}
+	}
+
+	return timeout;
+}
+
+long long Config_GetMaxQueuedQueries(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, unbounded.
+	long long max_queued = 0;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for MAX_QUEUED_QUERIES.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, MAX_QUEUED_QUERIES) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &max_queued) != REDISMODULE_OK ||
+				   max_queued < 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, queues are unbounded.", MAX_QUEUED_QUERIES);
+					max_queued = 0;
+				}
+				break;
+			}
+		}
+	}
+
+	return max_queued;
+}
+
+bool Config_GetNUMAInterleave(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, placement is left to the operating system.
+	bool interleave = false;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for NUMA_INTERLEAVE.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, NUMA_INTERLEAVE) == 0) {
+				const char *value = RedisModule_StringPtrLen(argv[i + 1], NULL);
+				if(strcasecmp(value, "yes") == 0) {
+					interleave = true;
+				} else if(strcasecmp(value, "no") != 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, expecting yes or no.", NUMA_INTERLEAVE);
+				}
+				break;
+			}
+		}
+	}
+
+	return interleave;
+}
+
+bool Config_GetFlushBeforeFork(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, pending changes are left in place when forking.
+	bool flush = false;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for FLUSH_BEFORE_FORK.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, FLUSH_BEFORE_FORK) == 0) {
+				const char *value = RedisModule_StringPtrLen(argv[i + 1], NULL);
+				if(strcasecmp(value, "yes") == 0) {
+					flush = true;
+				} else if(strcasecmp(value, "no") != 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, expecting yes or no.", FLUSH_BEFORE_FORK);
+				}
+				break;
+			}
+		}
+	}
+
+	return flush;
+}
+
+long long Config_GetIndexChunkSize(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default number of nodes indexed per step.
+	long long chunk_size = 100000;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for INDEX_CHUNK_SIZE.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, INDEX_CHUNK_SIZE) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &chunk_size) != REDISMODULE_OK ||
+				   chunk_size <= 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, defaulting to 100000.", INDEX_CHUNK_SIZE);
+					chunk_size = 100000;
+				}
+				break;
+			}
+		}
+	}
+
+	return chunk_size;
+}
+
+long long Config_GetSortSpillThreshold(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default number of bytes buffered by a sort.
+	long long threshold = 268435456;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for SORT_SPILL_THRESHOLD.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, SORT_SPILL_THRESHOLD) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &threshold) != REDISMODULE_OK ||
+				   threshold < 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, defaulting to 268435456.", SORT_SPILL_THRESHOLD);
+					threshold = 268435456;
+				}
+				break;
+			}
+		}
+	}
+
+	return threshold;
+}
+
+long long Config_GetDistinctSpillThreshold(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default number of bytes held by distinct fingerprints.
+	long long threshold = 268435456;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for DISTINCT_SPILL_THRESHOLD.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, DISTINCT_SPILL_THRESHOLD) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &threshold) != REDISMODULE_OK ||
+				   threshold < 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, defaulting to 268435456.", DISTINCT_SPILL_THRESHOLD);
+					threshold = 268435456;
+				}
+				break;
+			}
+		}
+	}
+
+	return threshold;
+}
+
+rax *Config_GetInternedAttributes(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, string values are not interned.
+	rax *attributes = NULL;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for INTERN_STRINGS.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, INTERN_STRINGS) == 0) {
+				size_t len;
+				const char *value = RedisModule_StringPtrLen(argv[i + 1], &len);
+				attributes = raxNew();
+				// Split the comma separated attribute names.
+				const char *name = value;
+				const char *end = value + len;
+				while(name < end) {
+					const char *comma = memchr(name, ',', end - name);
+					size_t name_len = (comma) ? (size_t)(comma - name) : (size_t)(end - name);
+					if(name_len > 0) raxInsert(attributes, (unsigned char *)name, name_len, NULL, NULL);
+					name += name_len + 1;
+				}
+				break;
+			}
+		}
+	}
+
+	return attributes;
+}
+
+const char **Config_GetUDFLibraries(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, no plug-ins are loaded.
+	const char **paths = NULL;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for every LOADFUNC.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, LOADFUNC) == 0) {
+				if(paths == NULL) paths = array_new(const char *, 1);
+				paths = array_append(paths, RedisModule_StringPtrLen(argv[i + 1], NULL));
+			}
+		}
+	}
+
+	return paths;
+}
+
+long long Config_GetResultCacheSize(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, results are not cached.
+	long long size = 0;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for RESULT_CACHE_SIZE.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, RESULT_CACHE_SIZE) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &size) != REDISMODULE_OK || size < 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, results are not cached.", RESULT_CACHE_SIZE);
+					size = 0;
+				}
+				break;
+			}
+		}
+	}
+
+	return size;
+}
+
+long long Config_GetQueryMemCapacity(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, queries' memory is unlimited.
+	long long capacity = 0;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for QUERY_MEM_CAPACITY.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, QUERY_MEM_CAPACITY) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &capacity) != REDISMODULE_OK || capacity < 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, queries' memory is unlimited.", QUERY_MEM_CAPACITY);
+					capacity = 0;
+				}
+				break;
+			}
+		}
+	}
+
+	return capacity;
+}
+
+long long Config_GetGraphBLASThreadCount(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, the number of cores available.
+	int CPUCount = sysconf(_SC_NPROCESSORS_ONLN);
+	long long threadCount = (CPUCount != -1) ? CPUCount : 1;
+	return _Config_GetLaneThreadCount(ctx, argv, argc, GRAPHBLAS_THREAD_COUNT, threadCount);
+}
+
+long long Config_GetSlowLogSize(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, 10 queries per graph.
+	long long size = 10;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for SLOWLOG_SIZE.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, SLOWLOG_SIZE) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &size) != REDISMODULE_OK || size < 1) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, retaining 10 queries.", SLOWLOG_SIZE);
+					size = 10;
+				}
+				break;
+			}
+		}
+	}
+
+	return size;
+}
+
+long long Config_GetSlowLogThreshold(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, every query is considered.
+	long long threshold = 0;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for SLOWLOG_THRESHOLD.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, SLOWLOG_THRESHOLD) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &threshold) != REDISMODULE_OK ||
+				   threshold < 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, every query is considered.",
+									SLOWLOG_THRESHOLD);
+					threshold = 0;
+				}
+				break;
+			}
+		}
+	}
+
+	return threshold;
+}
+
+long long Config_GetTraceBufferSize(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, 10000 spans.
+	long long size = 10000;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for TRACE_BUFFER_SIZE.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, TRACE_BUFFER_SIZE) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &size) != REDISMODULE_OK || size < 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, retaining 10000 spans.", TRACE_BUFFER_SIZE);
+					size = 10000;
+				}
+				break;
+			}
+		}
+	}
+
+	return size;
+}
+
+long long Config_GetAccessSampleRate(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, accesses aren't sampled.
+	long long rate = 0;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for ACCESS_SAMPLE_RATE.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, ACCESS_SAMPLE_RATE) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &rate) != REDISMODULE_OK || rate < 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, access sampling disabled.", ACCESS_SAMPLE_RATE);
+					rate = 0;
+				}
+				break;
+			}
+		}
+	}
+
+	return rate;
+}
+
+long long Config_GetMinVersionWait(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, wait up to 100 milliseconds.
+	long long wait = 100;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for MIN_VERSION_WAIT.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, MIN_VERSION_WAIT) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &wait) != REDISMODULE_OK || wait < 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, waiting up to 100 milliseconds.", MIN_VERSION_WAIT);
+					wait = 100;
+				}
+				break;
+			}
+		}
+	}
+
+	return wait;
+}
+
+long long Config_GetChangeFeedMaxLen(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	// Default, changes aren't captured.
+	long long maxlen = 0;
+
+	// Expecting configuration to be in the form of key value pairs.
+	if(argc % 2 == 0) {
+		// Scan arguments for CHANGE_FEED_MAXLEN.
+		for(int i = 0; i < argc; i += 2) {
+			const char *param = RedisModule_StringPtrLen(argv[i], NULL);
+			if(strcasecmp(param, CHANGE_FEED_MAXLEN) == 0) {
+				if(RedisModule_StringToLongLong(argv[i + 1], &maxlen) != REDISMODULE_OK || maxlen < 0) {
+					RedisModule_Log(ctx, "warning", "Invalid %s, change feed disabled.", CHANGE_FEED_MAXLEN);
+					maxlen = 0;
+				}
+				break;
+			}
+		}
+	}
+
+	return maxlen;
+}
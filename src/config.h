@@ -7,9 +7,31 @@
 #ifndef _REDISGRAPH_CONFIG_
 #define _REDISGRAPH_CONFIG_
 
+#include <stdbool.h>
 #include "redismodule.h"
+#include "rax.h"
 
-#define THREAD_COUNT "THREAD_COUNT" // Config param, number of threads in thread pool
+#define THREAD_COUNT "THREAD_COUNT"                       // Config param, number of threads serving short reads
+#define WRITER_THREAD_COUNT "WRITER_THREAD_COUNT"         // Config param, number of threads serving writes
+#define LONG_READ_THREAD_COUNT "LONG_READ_THREAD_COUNT"   // Config param, number of threads serving long reads
+#define TIMEOUT "TIMEOUT"                                 // Config param, default query timeout in milliseconds
+#define MAX_QUEUED_QUERIES "MAX_QUEUED_QUERIES"           // Config param, maximum number of queries waiting per thread pool
+#define NUMA_INTERLEAVE "NUMA_INTERLEAVE"                 // Config param, spread threads and memory across NUMA nodes
+#define INTERN_STRINGS "INTERN_STRINGS"                   // Config param, attributes whose string values are interned
+#define FLUSH_BEFORE_FORK "FLUSH_BEFORE_FORK"             // Config param, apply pending matrix changes prior to forking
+#define INDEX_CHUNK_SIZE "INDEX_CHUNK_SIZE"               // Config param, number of nodes indexed per background construction step
+#define SORT_SPILL_THRESHOLD "SORT_SPILL_THRESHOLD"       // Config param, bytes buffered by ORDER BY before spilling to disk
+#define DISTINCT_SPILL_THRESHOLD "DISTINCT_SPILL_THRESHOLD" // Config param, bytes of DISTINCT fingerprints before spilling to disk
+#define LOADFUNC "LOADFUNC"                               // Config param, path of a user-defined function plug-in, repeatable
+#define RESULT_CACHE_SIZE "RESULT_CACHE_SIZE"             // Config param, bytes of read-only query results cached per graph
+#define QUERY_MEM_CAPACITY "QUERY_MEM_CAPACITY"           // Config param, bytes a single query may allocate before it is aborted
+#define GRAPHBLAS_THREAD_COUNT "GRAPHBLAS_THREAD_COUNT"   // Config param, threads shared by matrix operations of long reads
+#define SLOWLOG_SIZE "SLOWLOG_SIZE"                       // Config param, number of queries retained by each graph's slowlog
+#define SLOWLOG_THRESHOLD "SLOWLOG_THRESHOLD"             // Config param, milliseconds a query runs for before it is logged
+#define TRACE_BUFFER_SIZE "TRACE_BUFFER_SIZE"             // Config param, number of trace spans retained until drained
+#define ACCESS_SAMPLE_RATE "ACCESS_SAMPLE_RATE"           // Config param, one in how many entity accesses is sampled
+#define MIN_VERSION_WAIT "MIN_VERSION_WAIT"               // Config param, milliseconds a query waits for its graph to reach MIN_VERSION
+#define CHANGE_FEED_MAXLEN "CHANGE_FEED_MAXLEN"           // Config param, approximate number of entries retained by each graph's change stream
 
 // Tries to fetch number of threads from
 // command line arguments if specified
@@ -21,4 +43,186 @@ long long Config_GetThreadCount(
 	int argc
 );
 
+// Tries to fetch the number of threads serving the writer lane
+// from command line arguments if specified
+// otherwise returns thread count equals to the number
+// of cores available.
+long long Config_GetWriterThreadCount(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the number of threads serving the long read lane
+// from command line arguments if specified
+// otherwise returns 1.
+long long Config_GetLongReadThreadCount(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the default query timeout from
+// command line arguments if specified
+// otherwise returns 0, queries are not timed out.
+long long Config_GetTimeout(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the maximum number of queries waiting
+// on each thread pool from command line arguments if specified
+// otherwise returns 0, the queues are unbounded.
+long long Config_GetMaxQueuedQueries(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch whether threads and large allocations should be
+// spread across NUMA nodes from command line arguments if specified
+// otherwise returns false.
+bool Config_GetNUMAInterleave(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch a comma separated list of attribute names whose
+// string values should be interned from command line arguments if specified
+// returns a rax of attribute names, or NULL if none were specified.
+rax *Config_GetInternedAttributes(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Fetches the paths of user-defined function plug-ins from
+// command line arguments, every LOADFUNC specifies a single plug-in
+// returns an array of paths, or NULL if none were specified.
+const char **Config_GetUDFLibraries(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch whether pending matrix changes should be applied
+// prior to forking from command line arguments if specified
+// otherwise returns false.
+bool Config_GetFlushBeforeFork(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the number of nodes indexed per background
+// index construction step from command line arguments if specified
+// otherwise returns 100000.
+long long Config_GetIndexChunkSize(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the number of bytes ORDER BY buffers before
+// spilling sorted runs to temporary files from command line arguments
+// if specified, 0 disables spilling, otherwise returns 256MB.
+long long Config_GetSortSpillThreshold(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the number of bytes DISTINCT fingerprints may occupy
+// before spilling new records to temporary files from command line arguments
+// if specified, 0 disables spilling, otherwise returns 256MB.
+long long Config_GetDistinctSpillThreshold(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the number of bytes of read-only query results
+// cached per graph from command line arguments if specified
+// otherwise returns 0, results are not cached.
+long long Config_GetResultCacheSize(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the number of bytes a single query may allocate
+// before it is aborted from command line arguments if specified
+// otherwise returns 0, queries' memory is unlimited.
+long long Config_GetQueryMemCapacity(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the number of threads the matrix operations
+// of concurrent long read queries share from command line arguments
+// if specified, otherwise returns the number of cores available.
+long long Config_GetGraphBLASThreadCount(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the number of queries retained by each graph's
+// slowlog from command line arguments if specified
+// otherwise returns 10.
+long long Config_GetSlowLogSize(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the number of milliseconds a query must run for
+// to be logged to the slowlog from command line arguments if specified
+// otherwise returns 0, every query is considered.
+long long Config_GetSlowLogThreshold(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the number of spans recorded by traced queries
+// retained until drained from command line arguments if specified
+// otherwise returns 10000, 0 disables tracing.
+long long Config_GetTraceBufferSize(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the rate at which node, label, relationship type
+// and index accesses are sampled from command line arguments
+// if specified, one in N accesses is sampled,
+// otherwise returns 0, disabling access sampling.
+long long Config_GetAccessSampleRate(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the number of milliseconds a query issued with MIN_VERSION
+// waits for its graph to reach that version from command line arguments
+// if specified, otherwise returns 100. Queries are rejected right away if 0.
+long long Config_GetMinVersionWait(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// Tries to fetch the approximate number of entries retained by each graph's
+// change stream from command line arguments if specified,
+// otherwise returns 0, disabling the change feed.
+long long Config_GetChangeFeedMaxLen(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
 #endif
@@ -0,0 +1,129 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cursors.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include <assert.h>
+
+static inline Cursor *_Cursors_Find(Cursors *cursors, uint64_t id) {
+	Cursor *cursor = raxFind(cursors->cursors, (unsigned char *)&id, sizeof(uint64_t));
+	return (cursor == raxNotFound) ? NULL : cursor;
+}
+
+/* Remove cursors which weren't read for CURSOR_IDLE_TIMEOUT seconds,
+ * expects the lock to be held. The removed cursors are appended to expired. */
+static void _Cursors_RemoveIdle(Cursors *cursors, Cursor ***expired) {
+	time_t now = time(NULL);
+	uint64_t *ids = array_new(uint64_t, 0);
+
+	raxIterator it;
+	raxStart(&it, cursors->cursors);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		Cursor *cursor = it.data;
+		if(cursor->held || now - cursor->last_access < CURSOR_IDLE_TIMEOUT) continue;
+		ids = array_append(ids, *(uint64_t *)it.key);
+		*expired = array_append(*expired, cursor);
+	}
+	raxStop(&it);
+
+	uint count = array_len(ids);
+	for(uint i = 0; i < count; i++) {
+		raxRemove(cursors->cursors, (unsigned char *)&ids[i], sizeof(uint64_t), NULL);
+	}
+	array_free(ids);
+}
+
+static void _Cursor_Free(void *arg) {
+	Cursor *cursor = arg;
+	if(cursor->state) cursor->free(cursor->state);
+	rm_free(cursor);
+}
+
+Cursors *Cursors_New(void) {
+	Cursors *cursors = rm_malloc(sizeof(Cursors));
+	cursors->next_id = 1;
+	cursors->cursors = raxNew();
+	int res = pthread_mutex_init(&cursors->lock, NULL);
+	assert(res == 0);
+	return cursors;
+}
+
+uint64_t Cursors_Reserve(Cursors *cursors) {
+	uint64_t id = 0;
+	Cursor **expired = array_new(Cursor *, 0);
+
+	pthread_mutex_lock(&cursors->lock);
+	_Cursors_RemoveIdle(cursors, &expired);
+	if(raxSize(cursors->cursors) < CURSORS_MAX) {
+		Cursor *cursor = rm_malloc(sizeof(Cursor));
+		cursor->state = NULL;
+		cursor->free = NULL;
+		cursor->last_access = time(NULL);
+		cursor->held = true;
+		id = cursors->next_id++;
+		raxInsert(cursors->cursors, (unsigned char *)&id, sizeof(uint64_t), cursor, NULL);
+	}
+	pthread_mutex_unlock(&cursors->lock);
+
+	// States are freed outside of the lock, freeing a suspended computation may take a while.
+	uint expired_count = array_len(expired);
+	for(uint i = 0; i < expired_count; i++) _Cursor_Free(expired[i]);
+	array_free(expired);
+
+	return id;
+}
+
+void *Cursors_Take(Cursors *cursors, uint64_t id) {
+	void *state = NULL;
+
+	pthread_mutex_lock(&cursors->lock);
+	Cursor *cursor = _Cursors_Find(cursors, id);
+	if(cursor && !cursor->held && cursor->state) {
+		cursor->held = true;
+		state = cursor->state;
+	}
+	pthread_mutex_unlock(&cursors->lock);
+
+	return state;
+}
+
+void Cursors_Put(Cursors *cursors, uint64_t id, void *state, CursorStateFree free) {
+	pthread_mutex_lock(&cursors->lock);
+	Cursor *cursor = _Cursors_Find(cursors, id);
+	assert(cursor && cursor->held);
+	cursor->state = state;
+	cursor->free = free;
+	cursor->last_access = time(NULL);
+	cursor->held = false;
+	pthread_mutex_unlock(&cursors->lock);
+}
+
+void Cursors_Remove(Cursors *cursors, uint64_t id) {
+	Cursor *cursor = NULL;
+
+	pthread_mutex_lock(&cursors->lock);
+	raxRemove(cursors->cursors, (unsigned char *)&id, sizeof(uint64_t), (void **)&cursor);
+	pthread_mutex_unlock(&cursors->lock);
+
+	assert(cursor && cursor->held);
+	rm_free(cursor);
+}
+
+uint64_t Cursors_Count(Cursors *cursors) {
+	pthread_mutex_lock(&cursors->lock);
+	uint64_t count = raxSize(cursors->cursors);
+	pthread_mutex_unlock(&cursors->lock);
+	return count;
+}
+
+void Cursors_Free(Cursors *cursors) {
+	if(cursors == NULL) return;
+	raxFreeWithCallback(cursors->cursors, _Cursor_Free);
+	pthread_mutex_destroy(&cursors->lock);
+	rm_free(cursors);
+}
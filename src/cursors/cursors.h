@@ -0,0 +1,61 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <time.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "../../deps/rax/rax.h"
+
+// Maximum number of cursors open over a graph.
+#define CURSORS_MAX 128
+// Seconds a cursor may remain unread before it's discarded.
+#define CURSOR_IDLE_TIMEOUT 300
+
+// Frees the state of a cursor.
+typedef void (*CursorStateFree)(void *state);
+
+// An open cursor, the state of a suspended computation.
+typedef struct {
+	void *state;            // Cursor state, NULL while reserved.
+	CursorStateFree free;   // State free routine.
+	time_t last_access;     // Time the cursor was last returned to the registry.
+	bool held;              // The cursor is held by a reader.
+} Cursor;
+
+/* Registry of cursors, mapping IDs to cursors.
+ * A cursor is held by a single reader at a time, a held cursor isn't accessible
+ * to other readers until returned to the registry. */
+typedef struct {
+	uint64_t next_id;       // ID assigned to the next cursor, IDs start at 1.
+	rax *cursors;           // Mapping between IDs and cursors.
+	pthread_mutex_t lock;   // Guards registry state.
+} Cursors;
+
+// Create a new cursors registry.
+Cursors *Cursors_New(void);
+
+/* Reserve the ID of a new cursor, held by the caller until returned by Cursors_Put.
+ * Idle cursors are discarded, returns 0 if the maximum number of cursors is reached. */
+uint64_t Cursors_Reserve(Cursors *cursors);
+
+/* Hold cursor id, returns its state,
+ * NULL if no such cursor exists or it's held by another reader. */
+void *Cursors_Take(Cursors *cursors, uint64_t id);
+
+// Return held cursor id to the registry, along with its state.
+void Cursors_Put(Cursors *cursors, uint64_t id, void *state, CursorStateFree free);
+
+// Remove held cursor id from the registry, its state is freed by the caller.
+void Cursors_Remove(Cursors *cursors, uint64_t id);
+
+// Retrieve the number of open cursors.
+uint64_t Cursors_Count(Cursors *cursors);
+
+// Free registry and the states of all cursors.
+void Cursors_Free(Cursors *cursors);
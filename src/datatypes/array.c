@@ -3,6 +3,49 @@
 #include <limits.h>
 #include "xxhash.h"
 
+/* Arrays of at least TYPED_ARRAY_MIN_LEN elements, all of which are either integers,
+ * floats or booleans, are stored as typed arrays when cloned, e.g. as entity properties.
+ * A typed array holds raw values rather than SIValues, its first slot holds the
+ * elements type. Typed arrays are distinguished from SIValue arrays by their element size. */
+#define TYPED_ARRAY_MIN_LEN 4
+
+typedef union {
+	int64_t longval;
+	double doubleval;
+	SIType type;
+} TypedElement;
+
+static inline bool _SIArray_IsTyped(SIValue siarray) {
+	return array_hdr(siarray.array)->elem_sz == sizeof(TypedElement);
+}
+
+static inline TypedElement *_SIArray_TypedElements(SIValue siarray) {
+	return (TypedElement *)siarray.array;
+}
+
+// Returns the type shared by all elements, or T_NULL if the array can't be typed.
+static SIType _SIArray_ElementType(SIValue siarray) {
+	uint arrayLen = SIArray_Length(siarray);
+	if(arrayLen < TYPED_ARRAY_MIN_LEN) return T_NULL;
+
+	SIType t = SI_TYPE(SIArray_Get(siarray, 0));
+	if(!(t & (T_INT64 | T_DOUBLE | T_BOOL))) return T_NULL;
+	for(uint i = 1; i < arrayLen; i++) {
+		if(SI_TYPE(SIArray_Get(siarray, i)) != t) return T_NULL;
+	}
+	return t;
+}
+
+// Converts a typed array into an array of SIValues.
+static void _SIArray_Untype(SIValue *siarray) {
+	SIValue typed = *siarray;
+	uint arrayLen = SIArray_Length(typed);
+	SIValue *values = array_new(SIValue, arrayLen + 1);
+	for(uint i = 0; i < arrayLen; i++) values = array_append(values, SIArray_Get(typed, i));
+	array_free(typed.array);
+	siarray->array = values;
+}
+
 SIValue SIArray_New(uint32_t initialCapacity) {
 	SIValue siarray;
 	siarray.array = array_new(SIValue, initialCapacity);
@@ -12,6 +55,19 @@ SIValue SIArray_New(uint32_t initialCapacity) {
 }
 
 void SIArray_Append(SIValue *siarray, SIValue value) {
+	if(_SIArray_IsTyped(*siarray)) {
+		TypedElement *elements = _SIArray_TypedElements(*siarray);
+		if(SI_TYPE(value) == elements[0].type) {
+			TypedElement element;
+			if(SI_TYPE(value) == T_DOUBLE) element.doubleval = value.doubleval;
+			else element.longval = value.longval;
+			siarray->array = (SIValue *)array_append(elements, element);
+			return;
+		}
+		// Value differs in type from the array elements.
+		_SIArray_Untype(siarray);
+	}
+
 	// clone and persist incase of pointer values
 	SIValue clone = SI_CloneValue(value);
 	// append
@@ -22,15 +78,49 @@ void SIArray_Append(SIValue *siarray, SIValue value) {
 SIValue SIArray_Get(SIValue siarray, uint32_t index) {
 	// check index
 	if(index >= SIArray_Length(siarray)) return SI_NullVal();
+	if(_SIArray_IsTyped(siarray)) {
+		TypedElement *elements = _SIArray_TypedElements(siarray);
+		TypedElement element = elements[index + 1];
+		switch(elements[0].type) {
+		case T_INT64:
+			return SI_LongVal(element.longval);
+		case T_DOUBLE:
+			return SI_DoubleVal(element.doubleval);
+		default:
+			return SI_BoolVal(element.longval);
+		}
+	}
 	return SI_ShareValue(siarray.array[index]);
 }
 
 uint32_t SIArray_Length(SIValue siarray) {
-	return array_len(siarray.array);
+	uint32_t len = array_len(siarray.array);
+	// Discount the typed array's element type slot.
+	if(_SIArray_IsTyped(siarray)) len--;
+	return len;
 }
 
 SIValue SIArray_Clone(SIValue siarray) {
 	uint arrayLen = SIArray_Length(siarray);
+	SIType t = _SIArray_ElementType(siarray);
+	if(t != T_NULL) {
+		// Copy raw values into a typed array.
+		TypedElement *elements = array_new(TypedElement, arrayLen + 1);
+		elements = array_append(elements, ((TypedElement) {
+			.type = t
+		}));
+		for(uint i = 0; i < arrayLen; i++) {
+			SIValue value = SIArray_Get(siarray, i);
+			TypedElement element;
+			if(t == T_DOUBLE) element.doubleval = value.doubleval;
+			else element.longval = value.longval;
+			elements = array_append(elements, element);
+		}
+		return (SIValue) {
+			.array = (SIValue *)elements, .type = T_ARRAY, .allocation = M_SELF
+		};
+	}
+
 	SIValue newArray = SIArray_New(arrayLen);
 	for(uint i = 0; i < arrayLen; i++) {
 		SIArray_Append(&newArray, SIArray_Get(siarray, i));
@@ -67,13 +157,19 @@ XXH64_hash_t SIArray_HashCode(SIValue siarray) {
 	XXH64_hash_t hashCode = XXH64(&t, sizeof(t), 0);
 	uint arrayLen = SIArray_Length(siarray);
 	for(uint i = 0; i < arrayLen; i++) {
-		SIValue value = siarray.array[i];
+		SIValue value = SIArray_Get(siarray, i);
 		hashCode = 31 * hashCode + SIValue_HashCode(value);
 	}
 	return hashCode;
 }
 
 void SIArray_Free(SIValue siarray) {
+	// Typed arrays hold no allocations other than their own.
+	if(_SIArray_IsTyped(siarray)) {
+		array_free(siarray.array);
+		return;
+	}
+
 	uint arrayLen = SIArray_Length(siarray);
 	for(uint i = 0; i < arrayLen; i++) {
 		SIValue value = siarray.array[i];
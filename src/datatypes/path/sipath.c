@@ -8,17 +8,109 @@
 #include "../../util/rmalloc.h"
 #include "../../util/arr.h"
 #include "../array.h"
+#include <string.h>
 
-SIValue SIPath_New(Path *p) {
+// An edge of a path, connecting the nodes preceding and following it.
+typedef struct {
+	Entity *entity;     // Edge entity.
+	int relationID;     // Relationship type.
+	bool reversed;      // The edge leads from the following node to the preceding one.
+} PathEdge;
+
+/* Paths held by values retain their entities alone, within a single allocation:
+ * node entities followed by edges. Nodes and edges are materialized once first
+ * retrieved, typically as the path is replied, paths which are only passed on,
+ * compared or hashed are never materialized. */
+typedef struct {
+	uint32_t node_count;    // Number of nodes.
+	uint32_t edge_count;    // Number of edges, one less than the number of nodes.
+	Path *materialized;     // Nodes and edges of the path, NULL until retrieved.
+	Entity *nodes[];        // Node entities, followed by the path's edges.
+} PathValue;
+
+static inline PathEdge *_PathValue_Edges(const PathValue *pv) {
+	return (PathEdge *)(pv->nodes + pv->node_count);
+}
+
+static inline size_t _PathValue_Size(uint32_t node_count, uint32_t edge_count) {
+	return sizeof(PathValue) + node_count * sizeof(Entity *) + edge_count * sizeof(PathEdge);
+}
+
+static inline SIValue _SIPath_Wrap(PathValue *pv) {
 	SIValue path;
-	path.ptrval = Path_Clone(p);
+	path.ptrval = pv;
 	path.type = T_PATH;
 	path.allocation = M_SELF;
 	return path;
 }
 
+/* Materializes the path's nodes and edges, retained until the path is freed.
+ * Values replayed from the result cache are shared by concurrent readers,
+ * the first materialization installed wins and the others are discarded. */
+static Path *_SIPath_Materialize(SIValue p) {
+	PathValue *pv = (PathValue *)p.ptrval;
+	Path *materialized = __atomic_load_n(&pv->materialized, __ATOMIC_ACQUIRE);
+	if(materialized) return materialized;
+
+	Path *path = Path_New(pv->edge_count);
+	for(uint32_t i = 0; i < pv->node_count; i++) {
+		Node n = {.entity = pv->nodes[i], .label = NULL, .labelID = pv->nodes[i]->label};
+		Path_AppendNode(path, n);
+	}
+	PathEdge *edges = _PathValue_Edges(pv);
+	for(uint32_t i = 0; i < pv->edge_count; i++) {
+		NodeID prev = pv->nodes[i]->id;
+		NodeID next = pv->nodes[i + 1]->id;
+		Edge e = {.entity = edges[i].entity, .relationship = NULL, .relationID = edges[i].relationID,
+				  .srcNodeID = (edges[i].reversed) ? next : prev,
+				  .destNodeID = (edges[i].reversed) ? prev : next
+				 };
+		Path_AppendEdge(path, e);
+	}
+	if(!__atomic_compare_exchange_n(&pv->materialized, &materialized, path, false,
+									__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+		// Lost the race, materialized now holds the installed path.
+		Path_Free(path);
+		return materialized;
+	}
+	return path;
+}
+
+SIValue SIPath_New(Path *p) {
+	uint32_t node_count = Path_NodeCount(p);
+	uint32_t edge_count = Path_EdgeCount(p);
+	PathValue *pv = rm_malloc(_PathValue_Size(node_count, edge_count));
+	pv->node_count = node_count;
+	pv->edge_count = edge_count;
+	pv->materialized = NULL;
+
+	for(uint32_t i = 0; i < node_count; i++) pv->nodes[i] = Path_GetNode(p, i)->entity;
+	PathEdge *edges = _PathValue_Edges(pv);
+	for(uint32_t i = 0; i < edge_count; i++) {
+		Edge *e = Path_GetEdge(p, i);
+		edges[i].entity = e->entity;
+		edges[i].relationID = Edge_GetRelationID(e);
+		edges[i].reversed = (Edge_GetSrcNodeID(e) != ENTITY_GET_ID(Path_GetNode(p, i)));
+	}
+	return _SIPath_Wrap(pv);
+}
+
 SIValue SIPath_Clone(SIValue p) {
-	return SIPath_New((Path *)p.ptrval);
+	PathValue *pv = (PathValue *)p.ptrval;
+	return SIPath_FromRaw(pv, _PathValue_Size(pv->node_count, pv->edge_count));
+}
+
+const void *SIPath_Raw(SIValue p, size_t *size) {
+	PathValue *pv = (PathValue *)p.ptrval;
+	*size = _PathValue_Size(pv->node_count, pv->edge_count);
+	return pv;
+}
+
+SIValue SIPath_FromRaw(const void *raw, size_t size) {
+	PathValue *pv = rm_malloc(size);
+	memcpy(pv, raw, size);
+	pv->materialized = NULL;
+	return _SIPath_Wrap(pv);
 }
 
 SIValue SIPath_ToList(SIValue p) {
@@ -39,7 +131,7 @@ SIValue SIPath_ToList(SIValue p) {
 }
 
 SIValue SIPath_Relationships(SIValue p) {
-	Path *path = (Path *) p.ptrval;
+	Path *path = _SIPath_Materialize(p);
 	uint edgeCount = Path_EdgeCount(path);
 	SIValue array = SIArray_New(edgeCount);
 	for(uint i = 0; i < edgeCount; i++) {
@@ -50,12 +142,12 @@ SIValue SIPath_Relationships(SIValue p) {
 
 SIValue SIPath_GetRelationship(SIValue p, size_t i) {
 	assert(i < SIPath_Length(p) && i >= 0);
-	Path *path = (Path *) p.ptrval;
+	Path *path = _SIPath_Materialize(p);
 	return SI_Edge(Path_GetEdge(path, i));
 }
 
 SIValue SIPath_Nodes(SIValue p) {
-	Path *path = (Path *) p.ptrval;
+	Path *path = _SIPath_Materialize(p);
 	uint nodeCount = Path_NodeCount(path);
 	SIValue array = SIArray_New(nodeCount);
 	for(uint i = 0; i < nodeCount; i++) {
@@ -66,7 +158,7 @@ SIValue SIPath_Nodes(SIValue p) {
 
 SIValue SIPath_GetNode(SIValue p, size_t i) {
 	assert(i < SIPath_NodeCount(p) && i >= 0);
-	Path *path = (Path *) p.ptrval;
+	Path *path = _SIPath_Materialize(p);
 	return SI_Node(Path_GetNode(path, i));
 }
 
@@ -79,34 +171,42 @@ SIValue SIPath_Last(SIValue p) {
 }
 
 size_t SIPath_Length(SIValue p) {
-	Path *path = (Path *) p.ptrval;
-	return Path_Len(path);
+	return ((PathValue *)p.ptrval)->edge_count;
 }
 
 size_t SIPath_NodeCount(SIValue p) {
-	Path *path = (Path *) p.ptrval;
-	return Path_NodeCount(path);
+	return ((PathValue *)p.ptrval)->node_count;
 }
 
 size_t SIPath_EdgeCount(SIValue p) {
-	Path *path = (Path *) p.ptrval;
-	return Path_EdgeCount(path);
+	return ((PathValue *)p.ptrval)->edge_count;
+}
+
+// Hashes and comparisons only consider entity IDs, the path isn't materialized.
+static inline SIValue _SIPath_NodeRef(const PathValue *pv, uint32_t i, Node *n) {
+	n->entity = pv->nodes[i];
+	return SI_Node(n);
+}
+
+static inline SIValue _SIPath_EdgeRef(const PathValue *pv, uint32_t i, Edge *e) {
+	e->entity = _PathValue_Edges(pv)[i].entity;
+	return SI_Edge(e);
 }
 
 XXH64_hash_t SIPath_HashCode(SIValue p) {
+	PathValue *pv = (PathValue *)p.ptrval;
+	Node n;
+	Edge e;
 	SIType t = SI_TYPE(p);
 	XXH64_hash_t hashCode = XXH64(&t, sizeof(t), 0);
-	size_t nodeCount = SIPath_NodeCount(p);
+	size_t nodeCount = pv->node_count;
 	for(size_t i = 0; i < nodeCount - 1 ; i++) {
-		SIValue node = SIPath_GetNode(p, i);
-		hashCode = 31 * hashCode + SIValue_HashCode(node);
-		SIValue edge = SIPath_GetRelationship(p, i);
-		hashCode = 31 * hashCode + SIValue_HashCode(edge);
+		hashCode = 31 * hashCode + SIValue_HashCode(_SIPath_NodeRef(pv, i, &n));
+		hashCode = 31 * hashCode + SIValue_HashCode(_SIPath_EdgeRef(pv, i, &e));
 	}
 	// Handle last node.
 	if(nodeCount > 0) {
-		SIValue node = SIPath_GetNode(p, nodeCount - 1);
-		hashCode = 31 * hashCode + SIValue_HashCode(node);
+		hashCode = 31 * hashCode + SIValue_HashCode(_SIPath_NodeRef(pv, nodeCount - 1, &n));
 	}
 	return hashCode;
 }
@@ -145,27 +245,26 @@ void SIPath_ToString(SIValue p, char **buf, size_t *bufferLen, size_t *bytesWrit
 }
 
 int SIPath_Compare(SIValue p1, SIValue p2) {
+	PathValue *pv1 = (PathValue *)p1.ptrval;
+	PathValue *pv2 = (PathValue *)p2.ptrval;
+	Node n1, n2;
+	Edge e1, e2;
 
-	size_t p1NodeCount = SIPath_NodeCount(p1);
-	size_t p2NodeCount = SIPath_NodeCount(p2);
+	size_t p1NodeCount = pv1->node_count;
+	size_t p2NodeCount = pv2->node_count;
 	// Get minimal length
 	size_t nodeCount = p1NodeCount <= p2NodeCount ? p1NodeCount : p2NodeCount;
 	int res = 0;
 	for(size_t i = 0; i < nodeCount - 1 ; i++) {
-		SIValue p1node = SIPath_GetNode(p1, i);
-		SIValue p2node = SIPath_GetNode(p2, i);
-		res = SIValue_Compare(p1node, p2node, NULL);
+		res = SIValue_Compare(_SIPath_NodeRef(pv1, i, &n1), _SIPath_NodeRef(pv2, i, &n2), NULL);
 		if(res) return res;
-		SIValue p1edge = SIPath_GetRelationship(p1, i);
-		SIValue p2edge = SIPath_GetRelationship(p2, i);
-		res = SIValue_Compare(p1edge, p2edge, NULL);
+		res = SIValue_Compare(_SIPath_EdgeRef(pv1, i, &e1), _SIPath_EdgeRef(pv2, i, &e2), NULL);
 		if(res) return res;
 	}
 	// Handle last node.
 	if(nodeCount > 0) {
-		SIValue p1node = SIPath_GetNode(p1, nodeCount - 1);
-		SIValue p2node = SIPath_GetNode(p2, nodeCount - 1);
-		res = SIValue_Compare(p1node, p2node, NULL);
+		res = SIValue_Compare(_SIPath_NodeRef(pv1, nodeCount - 1, &n1),
+							  _SIPath_NodeRef(pv2, nodeCount - 1, &n2), NULL);
 		if(res) return res;
 	}
 	return p1NodeCount - p2NodeCount;
@@ -173,7 +272,8 @@ int SIPath_Compare(SIValue p1, SIValue p2) {
 
 void SIPath_Free(SIValue p) {
 	if(p.allocation == M_SELF) {
-		Path *path = (Path *) p.ptrval;
-		Path_Free(path);
+		PathValue *pv = (PathValue *)p.ptrval;
+		if(pv->materialized) Path_Free(pv->materialized);
+		rm_free(pv);
 	}
 }
@@ -13,6 +13,8 @@
 
 /**
  * @brief  Creates a new SIPath out of path struct.
+ * @note   The SIPath retains the path's entities alone, nodes and edges
+ *         are materialized once retrieved from the SIPath.
  * @param  p: Path struct pointer.
  * @retval SIValue which represents the given struct.
  */
@@ -25,6 +27,23 @@ SIValue SIPath_New(Path *p);
  */
 SIValue SIPath_Clone(SIValue p);
 
+/**
+ * @brief  Returns the path's representation, a single block holding its entities.
+ * @note   The block may be copied as is, and restored by SIPath_FromRaw while its entities exist.
+ * @param  p: SIPath.
+ * @param  size: Set to the block's size in bytes.
+ * @retval Path block.
+ */
+const void *SIPath_Raw(SIValue p, size_t *size);
+
+/**
+ * @brief  Creates a new SIPath out of a block retrieved by SIPath_Raw.
+ * @param  raw: Path block.
+ * @param  size: Block size in bytes.
+ * @retval SIValue which owns a copy of the block.
+ */
+SIValue SIPath_FromRaw(const void *raw, size_t size);
+
 /**
  * @brief  Returns a path as in a list represention of interliving nodes and edges.
  * @param  p: SIPath
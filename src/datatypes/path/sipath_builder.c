@@ -22,27 +22,22 @@ static Edge _Edge_ReverseDirection(Edge *e) {
 	return edge;
 }
 
-static void _SIPath_Reverse(SIValue p) {
-	Path *path = (Path *) p.ptrval;
-	Path_Reverse(path);
+Path *SIPathBuilder_New(uint entity_count) {
+	return Path_New(entity_count / 2);
 }
 
-SIValue SIPathBuilder_New(uint entity_count) {
-	SIValue path;
-	path.ptrval = Path_New(entity_count / 2);
-	path.type = T_PATH;
-	path.allocation = M_SELF;
-	return path;
+SIValue SIPathBuilder_Build(Path *path) {
+	SIValue p = SIPath_New(path);
+	Path_Free(path);
+	return p;
 }
 
-void SIPathBuilder_AppendNode(SIValue p, SIValue n) {
-	Path *path = (Path *) p.ptrval;
+void SIPathBuilder_AppendNode(Path *path, SIValue n) {
 	Node *node = (Node *) n.ptrval;
 	Path_AppendNode(path, *node);
 }
 
-void SIPathBuilder_AppendEdge(SIValue p, SIValue e, bool RTLEdge) {
-	Path *path = (Path *) p.ptrval;
+void SIPathBuilder_AppendEdge(Path *path, SIValue e, bool RTLEdge) {
 	Edge *edge = (Edge *) e.ptrval;
 	assert(Path_NodeCount(path) > 0);
 	// The edge should connect nodes[edge_count] to nodes[edge_count+1]
@@ -62,16 +57,15 @@ void SIPathBuilder_AppendEdge(SIValue p, SIValue e, bool RTLEdge) {
 	Path_AppendEdge(path, edge_to_append);
 }
 
-void SIPathBuilder_AppendPath(SIValue path, SIValue new_path, bool RTLEdge) {
-	uint path_node_count = SIPath_NodeCount(path);
+void SIPathBuilder_AppendPath(Path *path, SIValue new_path, bool RTLEdge) {
+	uint path_node_count = Path_NodeCount(path);
 	assert(path_node_count > 0);
 	// No need to append empty paths.
 	uint new_path_node_count = SIPath_NodeCount(new_path);
 
 	if(new_path_node_count <= 1) return;
 
-	SIValue last_LTR_node = SIPath_GetNode(path, path_node_count - 1);
-	EntityID last_LTR_node_id = ENTITY_GET_ID((Node *)last_LTR_node.ptrval);
+	EntityID last_LTR_node_id = ENTITY_GET_ID(Path_GetNode(path, path_node_count - 1));
 	SIValue new_path_node_0 = SIPath_Head(new_path);
 	EntityID new_path_node_0_id = ENTITY_GET_ID((Node *)new_path_node_0.ptrval);
 	SIValue new_path_last_node = SIPath_Last(new_path);
@@ -80,14 +74,15 @@ void SIPathBuilder_AppendPath(SIValue path, SIValue new_path, bool RTLEdge) {
 	assert(last_LTR_node_id == new_path_node_0_id || last_LTR_node_id == new_path_last_node_id);
 	int new_path_edge_count = SIPath_Length(new_path);
 
-	// Check if path needs to be rverse inserated or not.
-	if(last_LTR_node_id == new_path_last_node_id) _SIPath_Reverse(new_path);
+	// Check if path needs to be inserted in reverse, the appended path itself is left as is.
+	bool reverse = (last_LTR_node_id == new_path_last_node_id);
 
-	for(uint i = 0; i < new_path_edge_count - 1; i++) {
-		SIPathBuilder_AppendEdge(path, SIPath_GetRelationship(new_path, i), RTLEdge);
+	for(uint i = 0; i < new_path_edge_count; i++) {
+		uint edge_idx = (reverse) ? new_path_edge_count - 1 - i : i;
+		SIPathBuilder_AppendEdge(path, SIPath_GetRelationship(new_path, edge_idx), RTLEdge);
 		// Insert only nodes which are not the last and the first, since they will be added by append node specifically.
-		SIPathBuilder_AppendNode(path, SIPath_GetNode(new_path, i + 1));
-
+		if(i == new_path_edge_count - 1) break;
+		uint node_idx = (reverse) ? edge_idx : edge_idx + 1;
+		SIPathBuilder_AppendNode(path, SIPath_GetNode(new_path, node_idx));
 	}
-	SIPathBuilder_AppendEdge(path, SIPath_GetRelationship(new_path, new_path_edge_count - 1), RTLEdge);
 }
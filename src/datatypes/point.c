@@ -0,0 +1,82 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "point.h"
+#include <math.h>
+#include <assert.h>
+
+#define DEG_TO_RAD(d) ((d) * M_PI / 180.0)
+#define RAD_TO_DEG(r) ((r) * 180.0 / M_PI)
+
+// Pads areas, such that rounding doesn't exclude points on their edges.
+#define BOX_PADDING 1e-6
+
+bool Point_ValidCoordinates(double latitude, double longitude) {
+	return (latitude >= -90 && latitude <= 90 && longitude >= -180 && longitude <= 180);
+}
+
+double Point_Distance(SIValue a, SIValue b) {
+	assert(SI_TYPE(a) == T_POINT && SI_TYPE(b) == T_POINT);
+
+	// Haversine formula.
+	double lat_a = DEG_TO_RAD((double)a.point.latitude);
+	double lat_b = DEG_TO_RAD((double)b.point.latitude);
+	double dlat = lat_b - lat_a;
+	double dlon = DEG_TO_RAD((double)b.point.longitude - (double)a.point.longitude);
+	double h = sin(dlat / 2) * sin(dlat / 2) +
+			   cos(lat_a) * cos(lat_b) * sin(dlon / 2) * sin(dlon / 2);
+	if(h > 1) h = 1;
+	return 2 * EARTH_RADIUS_METERS * asin(sqrt(h));
+}
+
+uint Point_RadiusBoxes(SIValue center, double radius, PointBox boxes[2]) {
+	assert(SI_TYPE(center) == T_POINT && radius >= 0);
+
+	double lat = center.point.latitude;
+	double lon = center.point.longitude;
+	// Angular radius, the latitude span is exact.
+	double angle = radius / EARTH_RADIUS_METERS;
+	double dlat = RAD_TO_DEG(angle) + BOX_PADDING;
+	double min_lat = lat - dlat;
+	double max_lat = lat + dlat;
+
+	// A circle containing a pole spans every longitude.
+	if(min_lat <= -90 || max_lat >= 90 || angle >= M_PI / 2) {
+		boxes[0] = (PointBox) {
+			fmax(min_lat, -90), -180, fmin(max_lat, 90), 180
+		};
+		return 1;
+	}
+
+	// Widest longitude span, reached at the circle's tangent meridians.
+	double dlon = RAD_TO_DEG(asin(sin(angle) / cos(DEG_TO_RAD(lat)))) + BOX_PADDING;
+	double min_lon = lon - dlon;
+	double max_lon = lon + dlon;
+
+	if(min_lon < -180) {
+		boxes[0] = (PointBox) {
+			min_lat, min_lon + 360, max_lat, 180
+		};
+		boxes[1] = (PointBox) {
+			min_lat, -180, max_lat, max_lon
+		};
+		return 2;
+	}
+	if(max_lon > 180) {
+		boxes[0] = (PointBox) {
+			min_lat, min_lon, max_lat, 180
+		};
+		boxes[1] = (PointBox) {
+			min_lat, -180, max_lat, max_lon - 360
+		};
+		return 2;
+	}
+
+	boxes[0] = (PointBox) {
+		min_lat, min_lon, max_lat, max_lon
+	};
+	return 1;
+}
@@ -0,0 +1,43 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../value.h"
+
+// Mean earth radius, in meters.
+#define EARTH_RADIUS_METERS 6371008.8
+
+// Area spanned by latitude and longitude ranges, in degrees.
+typedef struct {
+	double min_lat;
+	double min_lon;
+	double max_lat;
+	double max_lon;
+} PointBox;
+
+// Returns true if latitude and longitude are valid coordinates, in degrees.
+bool Point_ValidCoordinates
+(
+	double latitude,
+	double longitude
+);
+
+// Great-circle distance between points a and b, in meters.
+double Point_Distance
+(
+	SIValue a,
+	SIValue b
+);
+
+/* Sets boxes to the areas containing every point within radius meters of center,
+ * returns the number of areas set, two when the areas span the antimeridian. */
+uint Point_RadiusBoxes
+(
+	SIValue center,
+	double radius,
+	PointBox boxes[2]
+);
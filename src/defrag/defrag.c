@@ -0,0 +1,108 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "defrag.h"
+#include <assert.h>
+#include "../util/numa.h"
+#include "../cursors/cursors.h"
+#include "../util/datablock/datablock.h"
+
+/* Defrag phases, the resume cursor holds the phase in its top bits
+ * and the position within the phase in the remaining bits. */
+typedef enum {
+	DEFRAG_NODES,       // Node properties.
+	DEFRAG_EDGES,       // Edge properties.
+	DEFRAG_NODE_BLOCKS, // Node blocks.
+	DEFRAG_EDGE_BLOCKS, // Edge blocks.
+	DEFRAG_PHASES
+} DefragPhase;
+
+#define DEFRAG_PHASE_SHIFT 60
+#define DEFRAG_POSITION_MASK ((1UL << DEFRAG_PHASE_SHIFT) - 1)
+
+static void *_Defrag_Relocate(void *ptr, void *arg) {
+	return RedisModule_DefragAlloc((RedisModuleDefragCtx *)arg, ptr);
+}
+
+// Relocates the allocations of entities from position pos, returns false if time ran out.
+static bool _Defrag_Entities(RedisModuleDefragCtx *ctx, DataBlock *entities, uint64_t *pos) {
+	for(uint64_t i = *pos; i < entities->itemCap; i++) {
+		if(i % DEFRAG_CHECK_INTERVAL == 0 && i > *pos && RedisModule_DefragShouldStop(ctx)) {
+			*pos = i;
+			return false;
+		}
+		Entity *e = DataBlock_GetItem(entities, i);
+		if(e) Entity_Relocate(e, _Defrag_Relocate, ctx);
+	}
+	return true;
+}
+
+/* Relocates the blocks of entities from block pos, returns false if time ran out.
+ * Sets moved if a block was relocated. */
+static bool _Defrag_Blocks(RedisModuleDefragCtx *ctx, DataBlock *entities, uint64_t *pos,
+						   bool *moved) {
+	for(uint i = *pos; i < entities->blockCount; i++) {
+		if(i > *pos && RedisModule_DefragShouldStop(ctx)) {
+			*pos = i;
+			return false;
+		}
+		// Interleaved blocks would lose their placement across NUMA nodes.
+		Block *block = entities->blocks[i];
+		if(NUMA_InterleaveEnabled() &&
+		   block->capacity * block->itemSize >= NUMA_INTERLEAVE_THRESHOLD) continue;
+		if(DataBlock_RelocateBlock(entities, i, _Defrag_Relocate, ctx)) *moved = true;
+	}
+	return true;
+}
+
+int Defrag_Graph(RedisModuleDefragCtx *ctx, GraphContext *gc) {
+	Graph *g = gc->g;
+	// Queries hold references to entities and their values, retry on the next cycle.
+	if(!Graph_TryAcquireExclusive(g)) return 0;
+	// Suspended queries retain references between reads.
+	if(Cursors_Count(GraphContext_GetCursors(gc)) > 0) {
+		Graph_ReleaseExclusive(g);
+		return 0;
+	}
+
+	// The cursor is only available to graphs defragmented over several calls.
+	unsigned long cursor = 0;
+	RedisModule_DefragCursorGet(ctx, &cursor);
+	uint phase = cursor >> DEFRAG_PHASE_SHIFT;
+	uint64_t pos = cursor & DEFRAG_POSITION_MASK;
+
+	bool done = true;
+	bool moved = false;
+	for(; phase < DEFRAG_PHASES && done; phase++) {
+		switch(phase) {
+		case DEFRAG_NODES:
+			done = _Defrag_Entities(ctx, g->nodes, &pos);
+			break;
+		case DEFRAG_EDGES:
+			done = _Defrag_Entities(ctx, g->edges, &pos);
+			break;
+		case DEFRAG_NODE_BLOCKS:
+			done = _Defrag_Blocks(ctx, g->nodes, &pos, &moved);
+			break;
+		case DEFRAG_EDGE_BLOCKS:
+			done = _Defrag_Blocks(ctx, g->edges, &pos, &moved);
+			break;
+		default:
+			assert(false);
+		}
+		if(done) pos = 0;
+		else RedisModule_DefragCursorSet(ctx, ((unsigned long)phase << DEFRAG_PHASE_SHIFT) | pos);
+	}
+
+	// Cached results reference entities by address, invalidate them.
+	if(moved) g->version++;
+	Graph_ReleaseExclusive(g);
+	return (done) ? 0 : 1;
+}
+
+size_t Defrag_Effort(const GraphContext *gc) {
+	return Graph_NodeCount(gc->g) + Graph_EdgeCount(gc->g);
+}
@@ -0,0 +1,24 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../redismodule.h"
+#include "../graph/graphcontext.h"
+
+// Number of entities relocated between checks of the defrag time slice.
+#define DEFRAG_CHECK_INTERVAL 64
+
+/* Relocates the graph's allocations on behalf of Redis active defragmentation:
+ * entity properties and string values, followed by the node and edge blocks.
+ * Large graphs are defragmented over several calls, each bounded by the time slice
+ * Redis grants, resuming from the cursor stored in ctx. Graphs in use by queries,
+ * or with open cursors, are skipped until the next defrag cycle.
+ * Returns 1 if the graph wasn't fully defragmented, 0 otherwise. */
+int Defrag_Graph(RedisModuleDefragCtx *ctx, GraphContext *gc);
+
+// Returns the effort of defragmenting the graph, its number of entities.
+size_t Defrag_Effort(const GraphContext *gc);
@@ -0,0 +1,238 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cardinality.h"
+#include "./ops/ops.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../graph/degree_stats.h"
+#include <math.h>
+
+// Fraction of a label's nodes an index lookup is assumed to match in the absence of statistics.
+#define CARDINALITY_INDEX_SELECTIVITY 0.1
+// Fraction of records a semi apply is assumed to pass.
+#define CARDINALITY_SEMI_APPLY_SELECTIVITY 0.5
+// Fraction of records forming distinct groups.
+#define CARDINALITY_GROUP_RATIO 0.1
+// Length assumed for lists which aren't known prior to execution.
+#define CARDINALITY_LIST_LENGTH 10
+// Number of hops considered for variable length traversals without an upper bound.
+#define CARDINALITY_MAX_HOPS 4
+
+double Cardinality_ExpressionFanout(GraphContext *gc, const AlgebraicExpression *exp,
+									bool transposed) {
+	if(gc == NULL) return -1;
+
+	if(exp->type == AL_OPERAND) {
+		if(exp->operand.diagonal) return 1;
+
+		int relation = GRAPH_NO_RELATION;
+		if(exp->operand.label) {
+			Schema *s = GraphContext_GetSchema(gc, exp->operand.label, SCHEMA_EDGE);
+			// Unknown relation, no nodes are reached.
+			if(s == NULL) return 0;
+			relation = s->id;
+		}
+
+		DegreeSummary summary;
+		GRAPH_EDGE_DIR dir = (transposed) ? GRAPH_EDGE_DIR_INCOMING : GRAPH_EDGE_DIR_OUTGOING;
+		DegreeStats_Get(gc->g, relation, dir, &summary);
+		return summary.avg;
+	}
+
+	uint child_count = AlgebraicExpression_ChildCount(exp);
+	switch(exp->operation.op) {
+	case AL_EXP_TRANSPOSE:
+		return Cardinality_ExpressionFanout(gc, exp->operation.children[0], !transposed);
+	case AL_EXP_ADD:
+	case AL_EXP_MUL: {
+		double fanout = (exp->operation.op == AL_EXP_ADD) ? 0 : 1;
+		for(uint i = 0; i < child_count; i++) {
+			double child = Cardinality_ExpressionFanout(gc, exp->operation.children[i], transposed);
+			if(child < 0) return -1;
+			fanout = (exp->operation.op == AL_EXP_ADD) ? fanout + child : fanout * child;
+		}
+		return fanout;
+	}
+	default:
+		return -1;
+	}
+}
+
+// Number of nodes n may resolve to.
+static double _LabelCount(GraphContext *gc, const QGNode *n) {
+	if(n == NULL || n->label == NULL) return Graph_NodeCount(gc->g);
+	// Unknown label, no nodes match.
+	if(n->labelID == GRAPH_NO_LABEL) return 0;
+	return Graph_LabeledNodeCount(gc->g, n->labelID);
+}
+
+// Fraction of the graph's nodes n may resolve to.
+static double _LabelFraction(GraphContext *gc, const QGNode *n) {
+	double node_count = Graph_NodeCount(gc->g);
+	if(node_count == 0) return 0;
+	return _LabelCount(gc, n) / node_count;
+}
+
+static const QueryGraph *_QueryGraph(const OpBase *op) {
+	return (op->plan) ? op->plan->query_graph : NULL;
+}
+
+static const QGNode *_ExpressionDestination(const OpBase *op, const AlgebraicExpression *ae) {
+	const QueryGraph *qg = _QueryGraph(op);
+	if(qg == NULL) return NULL;
+	return QueryGraph_GetNodeByAlias(qg, AlgebraicExpression_Destination(ae));
+}
+
+// Nodes reached per source record by traversing ae, restricted to the destination's label.
+static double _TraversalFanout(GraphContext *gc, const OpBase *op, const AlgebraicExpression *ae) {
+	double fanout = Cardinality_ExpressionFanout(gc, ae, false);
+	if(fanout < 0) fanout = 1;
+	return fanout * _LabelFraction(gc, _ExpressionDestination(op, ae));
+}
+
+static double _VarLenFanout(GraphContext *gc, const CondVarLenTraverse *op) {
+	double fanout = Cardinality_ExpressionFanout(gc, op->ae, false);
+	if(fanout < 0) fanout = 1;
+	uint max_hops = op->maxHops;
+	if(max_hops - op->minHops > CARDINALITY_MAX_HOPS) max_hops = op->minHops + CARDINALITY_MAX_HOPS;
+	double reached = 0;
+	double paths = pow(fanout, op->minHops);
+	for(uint hops = op->minHops; hops <= max_hops; hops++) {
+		reached += paths;
+		paths *= fanout;
+	}
+	// Each source reaches at most every node.
+	const QGNode *dest = _ExpressionDestination((const OpBase *)op, op->ae);
+	return fmin(reached, Graph_NodeCount(gc->g)) * _LabelFraction(gc, dest);
+}
+
+static double _ScanSize(GraphContext *gc, const OpBase *op) {
+	switch(op->type) {
+	case OPType_ALL_NODE_SCAN:
+		return Graph_NodeCount(gc->g);
+	case OPType_NODE_BY_LABEL_SCAN:
+	case OpType_NODE_BY_LABEL_AND_ID_SCAN: {
+		const NodeByLabelScan *scan = (const NodeByLabelScan *)op;
+		double count = _LabelCount(gc, scan->n);
+		const UnsignedRange *range = scan->id_range;
+		if(!range->valid) return 0;
+		// Labeled node IDs are assumed to spread evenly over the ID space.
+		double span = fmin((double)range->max, Graph_NodeCount(gc->g)) - range->min + 1;
+		double node_count = Graph_NodeCount(gc->g);
+		if(span < node_count && node_count > 0) count *= fmax(0, span) / node_count;
+		return count;
+	}
+	case OPType_INDEX_SCAN: {
+		const IndexScan *scan = (const IndexScan *)op;
+		double selectivity = (scan->selectivity >= 0) ? scan->selectivity :
+							 CARDINALITY_INDEX_SELECTIVITY;
+		return _LabelCount(gc, scan->n) * selectivity;
+	}
+	case OPType_INDEX_ORDER_SCAN:
+		return _LabelCount(gc, ((const IndexOrderScan *)op)->n);
+	case OPType_EDGE_INDEX_SCAN: {
+		DegreeSummary summary;
+		DegreeStats_Get(gc->g, ((const EdgeIndexScan *)op)->relation_id, GRAPH_EDGE_DIR_OUTGOING,
+						&summary);
+		return summary.entries * CARDINALITY_INDEX_SELECTIVITY;
+	}
+	case OPType_NODE_BY_ID_SEEK: {
+		const NodeByIdSeek *seek = (const NodeByIdSeek *)op;
+		if(seek->ids) return array_len(seek->ids);
+		if(seek->maxId < seek->minId) return 0;
+		double span = (double)seek->maxId - seek->minId + 1;
+		return fmin(span, Graph_NodeCount(gc->g)) * _LabelFraction(gc, seek->n);
+	}
+	default:
+		return 1;
+	}
+}
+
+static double _ChildEstimate(const OpBase *op, int i) {
+	return (op->childCount > i) ? Cardinality_Estimate(op->children[i]) : 1;
+}
+
+double Cardinality_Estimate(const OpBase *op) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	double input = _ChildEstimate(op, 0);
+
+	switch(op->type) {
+	case OPType_ALL_NODE_SCAN:
+	case OPType_NODE_BY_LABEL_SCAN:
+	case OpType_NODE_BY_LABEL_AND_ID_SCAN:
+	case OPType_INDEX_SCAN:
+	case OPType_INDEX_ORDER_SCAN:
+	case OPType_EDGE_INDEX_SCAN:
+	case OPType_NODE_BY_ID_SEEK:
+		// Scans with a child scan once per child record.
+		return input * _ScanSize(gc, op);
+	case OPType_ARGUMENT:
+		return 1;
+	case OPType_FILTER: {
+		const OpFilter *filter = (const OpFilter *)op;
+		return input * FilterTree_Selectivity(filter->filterTree, _QueryGraph(op));
+	}
+	case OPType_CONDITIONAL_TRAVERSE:
+		return input * _TraversalFanout(gc, op, ((const CondTraverse *)op)->ae);
+	case OPType_EXPAND_INTO: {
+		// The fraction of bound node pairs which are connected.
+		double node_count = Graph_NodeCount(gc->g);
+		if(node_count == 0) return 0;
+		double fanout = Cardinality_ExpressionFanout(gc, ((const OpExpandInto *)op)->ae, false);
+		if(fanout < 0) fanout = 1;
+		return input * fmin(1, fanout / node_count);
+	}
+	case OPType_CONDITIONAL_VAR_LEN_TRAVERSE:
+		return input * _VarLenFanout(gc, (const CondVarLenTraverse *)op);
+	case OPType_CONDITIONAL_VAR_LEN_TRAVERSE_EXPAND_INTO: {
+		double node_count = Graph_NodeCount(gc->g);
+		if(node_count == 0) return 0;
+		return input * fmin(1, _VarLenFanout(gc, (const CondVarLenTraverse *)op) / node_count);
+	}
+	case OPType_CARTESIAN_PRODUCT: {
+		double product = 1;
+		for(int i = 0; i < op->childCount; i++) product *= _ChildEstimate(op, i);
+		return product;
+	}
+	case OPType_APPLY:
+		// The branch is evaluated once per bound record.
+		return input * _ChildEstimate(op, 1);
+	case OPType_SEMI_APPLY:
+	case OpType_ANTI_SEMI_APPLY:
+	case OPType_OR_APPLY_MULTIPLEXER:
+	case OPType_AND_APPLY_MULTIPLEXER:
+		return input * CARDINALITY_SEMI_APPLY_SELECTIVITY;
+	case OPType_VALUE_HASH_JOIN:
+		// Equality joins are assumed to match each probe once.
+		return fmax(input, _ChildEstimate(op, 1));
+	case OPType_JOIN: {
+		double sum = 0;
+		for(int i = 0; i < op->childCount; i++) sum += _ChildEstimate(op, i);
+		return sum;
+	}
+	case OPType_UNWIND: {
+		const OpUnwind *unwind = (const OpUnwind *)op;
+		double len = CARDINALITY_LIST_LENGTH;
+		if(AR_EXP_IsConstant(unwind->exp) && SI_TYPE(unwind->exp->operand.constant) == T_ARRAY) {
+			len = SIArray_Length(unwind->exp->operand.constant);
+		}
+		return input * len;
+	}
+	case OPType_AGGREGATE: {
+		const OpAggregate *aggregate = (const OpAggregate *)op;
+		if(aggregate->key_count == 0) return 1;
+		return (input == 0) ? 0 : fmax(1, input * CARDINALITY_GROUP_RATIO);
+	}
+	case OPType_LIMIT:
+		return fmin(input, ((const OpLimit *)op)->limit);
+	case OPType_SKIP:
+		return fmax(0, input - ((const OpSkip *)op)->rec_to_skip);
+	default:
+		// Projections, sorts, updates and the like produce a record per input record.
+		return input;
+	}
+}
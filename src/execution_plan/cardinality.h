@@ -0,0 +1,26 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "./ops/op.h"
+#include "../graph/graphcontext.h"
+#include "../arithmetic/algebraic_expression.h"
+
+/* Cardinality estimation, derived from label counts, relation degree statistics,
+ * index selectivity and property statistics.
+ * Estimates guide the optimizer's choices and are reported by PROFILE. */
+
+/* Estimates the number of nodes reached from a node by evaluating exp,
+ * from its destination to its source if transposed.
+ * Relations contribute the average degree of the nodes they connect,
+ * returns a negative value if no estimate is available. */
+double Cardinality_ExpressionFanout(GraphContext *gc, const AlgebraicExpression *exp,
+									bool transposed);
+
+/* Estimates the number of records op produces. Operations within the branch of
+ * an Apply are estimated per record of the Apply's bound branch. */
+double Cardinality_Estimate(const OpBase *op);
@@ -6,6 +6,9 @@
 
 #include "execution_plan.h"
 #include "./ops/ops.h"
+#include "./cardinality.h"
+#include "./plan_cache.h"
+#include "./record_pool.h"
 #include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../util/qsort.h"
@@ -13,6 +16,7 @@
 #include "../util/vector.h"
 #include "../util/rmalloc.h"
 #include "../util/rax_extensions.h"
+#include "xxhash.h"
 #include "../graph/entities/edge.h"
 #include "../ast/ast_build_ar_exp.h"
 #include "./optimizations/optimizer.h"
@@ -231,6 +235,24 @@ static AR_ExpNode **_BuildCallArguments(const cypher_astnode_t *call_clause) {
 	return arguments;
 }
 
+/* Returns true if stream is a read-only procedure call, independent of earlier clauses,
+ * none of whose outputs are referred to by the pattern qg. */
+static bool _ExecutionPlan_IndependentCall(const OpBase *stream, const QueryGraph *qg,
+										   rax *bound_vars) {
+	if(stream->type != OPType_PROC_CALL || stream->childCount > 0 || stream->writer) return false;
+	uint node_count = array_len(qg->nodes);
+	for(uint i = 0; i < node_count; i++) {
+		const char *alias = qg->nodes[i]->alias;
+		if(raxFind(bound_vars, (unsigned char *)alias, strlen(alias)) != raxNotFound) return false;
+	}
+	uint edge_count = array_len(qg->edges);
+	for(uint i = 0; i < edge_count; i++) {
+		const char *alias = qg->edges[i]->alias;
+		if(raxFind(bound_vars, (unsigned char *)alias, strlen(alias)) != raxNotFound) return false;
+	}
+	return true;
+}
+
 static void _ExecutionPlan_ProcessQueryGraph(ExecutionPlan *plan, QueryGraph *qg,
 											 AST *ast, FT_FilterNode *ft) {
 	GraphContext *gc = QueryCtx_GetGraphCtx();
@@ -242,9 +264,13 @@ static void _ExecutionPlan_ProcessQueryGraph(ExecutionPlan *plan, QueryGraph *qg
 	rax *bound_vars = plan->record_map;
 
 	/* If we have multiple graph components, the root operation is a Cartesian Product.
-	 * Each chain of traversals will be a child of this op. */
+	 * Each chain of traversals will be a child of this op.
+	 * A pattern independent of a preceding procedure call is joined with the call's records
+	 * rather than scanned once per record, such that equality filters between the two,
+	 * e.g. over the nodes of another graph, reduce the product to a hash join. */
 	OpBase *cartesianProduct = NULL;
-	if(connectedComponentsCount > 1) {
+	if(connectedComponentsCount > 1 ||
+	   (plan->root && _ExecutionPlan_IndependentCall(plan->root, qg, bound_vars))) {
 		cartesianProduct = NewCartesianProductOp(plan);
 		_ExecutionPlan_UpdateRoot(plan, cartesianProduct);
 	}
@@ -267,7 +293,7 @@ static void _ExecutionPlan_ProcessQueryGraph(ExecutionPlan *plan, QueryGraph *qg
 			uint expCount = array_len(exps);
 
 			// Reorder exps, to the most performant arrangement of evaluation.
-			orderExpressions(qg, exps, expCount, ft, bound_vars);
+			orderExpressions(qg, exps, expCount, ft, bound_vars, gc);
 
 			/* Create the SCAN operation that will be the tail of the traversal chain. */
 			QGNode *src = QueryGraph_GetNodeByAlias(qg, AlgebraicExpression_Source(exps[0]));
@@ -412,6 +438,9 @@ static inline void _buildProjectionOps(ExecutionPlan *plan, AR_ExpNode **project
 									   AR_ExpNode **order_exps, uint skip,
 									   int *sort_directions, bool aggregate, bool distinct) {
 
+	// Records are distinct by their projections, prior to merging order expressions.
+	uint projection_count = array_len(projections);
+
 	// Merge order expressions into the projections array.
 	if(order_exps) _combine_projection_arrays(&projections, order_exps);
 
@@ -429,7 +458,9 @@ static inline void _buildProjectionOps(ExecutionPlan *plan, AR_ExpNode **project
 	/* Add modifier operations in order such that the final execution plan will follow the sequence:
 	 * Limit -> Skip -> Sort -> Distinct -> Project/Aggregate */
 	if(distinct) {
-		OpBase *op = NewDistinctOp(plan);
+		const char *aliases[projection_count];
+		for(uint i = 0; i < projection_count; i++) aliases[i] = projections[i]->resolved_name;
+		OpBase *op = NewDistinctOp(plan, aliases, projection_count);
 		_ExecutionPlan_UpdateRoot(plan, op);
 	}
 
@@ -722,7 +753,7 @@ ExecutionPlan *ExecutionPlan_UnionPlans(AST *ast) {
 	// Introduce distinct only if `ALL` isn't specified.
 	const cypher_astnode_t *union_clause = AST_GetClause(ast, CYPHER_AST_UNION);
 	if(!cypher_ast_union_has_all(union_clause)) {
-		OpBase *distinct_op = NewDistinctOp(plan);
+		OpBase *distinct_op = NewDistinctOp(plan, NULL, 0);
 		ExecutionPlan_AddOp(results_op, distinct_op);
 		parent = distinct_op;
 	}
@@ -857,10 +888,81 @@ void ExecutionPlan_PreparePlan(ExecutionPlan *plan) {
 	// Plan should be prepared only once.
 	assert(!plan->prepared);
 	optimizePlan(plan);
-	QueryCtx_SetLastWriter(_ExecutionPlan_FindLastWriter(plan->root));
 	plan->prepared = true;
 }
 
+uint ExecutionPlan_PreparePlanWithRules(ExecutionPlan *plan, uint rules, bool track) {
+	// Plan should be prepared only once.
+	assert(!plan->prepared);
+	uint applied = optimizePlanWithRules(plan, rules, track);
+	plan->prepared = true;
+	return applied;
+}
+
+void ExecutionPlan_PreparePinnedPlan(ExecutionPlan *plan, GraphContext *gc, const char *query) {
+	uint rules;
+	char *pinned;
+	size_t body_offset;
+	PlanPins *pins = GraphContext_GetPlanPins(gc);
+	if(PlanPins_Count(pins) == 0 || !PlanCache_QueryBodyOffset(query, &body_offset)) {
+		ExecutionPlan_PreparePlan(plan);
+		return;
+	}
+
+	const char *body = query + body_offset;
+	size_t body_len = strlen(body);
+	if(!PlanPins_Get(pins, body, body_len, &rules, &pinned)) {
+		ExecutionPlan_PreparePlan(plan);
+		return;
+	}
+
+	ExecutionPlan_PreparePlanWithRules(plan, rules, false);
+
+	// The pinned shape might no longer be reachable, e.g. once an index it scanned is dropped.
+	char *shape = ExecutionPlan_Shape(plan);
+	if(strcmp(shape, pinned) != 0) {
+		PlanPins_ReportMismatch(pins, body, body_len);
+		RedisModule_Log(QueryCtx_GetRedisModuleCtx(), "warning",
+						"Plan pinned for query %s no longer validates, pinned %s, built %s",
+						body, pinned, shape);
+	}
+	rm_free(shape);
+	rm_free(pinned);
+}
+
+static void _ExecutionPlan_Shape(const OpBase *op, char **shape, char *buffer, int buffer_len) {
+	int bytes_written = OpBase_ToString(op, buffer, buffer_len);
+	for(int i = 0; i < bytes_written; i++) *shape = array_append(*shape, buffer[i]);
+	if(op->childCount == 0) return;
+
+	*shape = array_append(*shape, '(');
+	for(int i = 0; i < op->childCount; i++) {
+		if(i > 0) {
+			*shape = array_append(*shape, ',');
+			*shape = array_append(*shape, ' ');
+		}
+		_ExecutionPlan_Shape(op->children[i], shape, buffer, buffer_len);
+	}
+	*shape = array_append(*shape, ')');
+}
+
+char *ExecutionPlan_Shape(const ExecutionPlan *plan) {
+	char buffer[1024];
+	char *shape = array_new(char, 256);
+	if(plan->root) _ExecutionPlan_Shape(plan->root, &shape, buffer, 1024);
+	shape = array_append(shape, '\0');
+	char *str = rm_strdup(shape);
+	array_free(shape);
+	return str;
+}
+
+uint64_t ExecutionPlan_Fingerprint(const ExecutionPlan *plan) {
+	char *shape = ExecutionPlan_Shape(plan);
+	uint64_t fingerprint = XXH64(shape, strlen(shape), 0);
+	rm_free(shape);
+	return fingerprint;
+}
+
 inline rax *ExecutionPlan_GetMappings(const ExecutionPlan *plan) {
 	assert(plan && plan->record_map);
 	return plan->record_map;
@@ -914,15 +1016,127 @@ void ExecutionPlan_Print(const ExecutionPlan *plan, RedisModuleCtx *ctx) {
 	RedisModule_ReplySetArrayLength(ctx, op_count);
 }
 
+// Reply with a key and a double value, or null if value is negative.
+static inline void _ExecutionPlan_ReplyWithEstimate(RedisModuleCtx *ctx, const char *key,
+													double value) {
+	RedisModule_ReplyWithSimpleString(ctx, key);
+	if(value < 0) RedisModule_ReplyWithNull(ctx);
+	else RedisModule_ReplyWithDouble(ctx, value);
+}
+
+static inline void _ExecutionPlan_ReplyWithCount(RedisModuleCtx *ctx, const char *key,
+												 long long value) {
+	RedisModule_ReplyWithSimpleString(ctx, key);
+	RedisModule_ReplyWithLongLong(ctx, value);
+}
+
+// Reply with the choices the optimizer made for op, returns the number of reply entries.
+static int _ExecutionPlan_PrintOpDetails(const OpBase *op, RedisModuleCtx *ctx) {
+	switch(op->type) {
+	case OPType_INDEX_SCAN: {
+		const IndexScan *scan = (const IndexScan *)op;
+		RedisModule_ReplyWithSimpleString(ctx, "index");
+		RedisModule_ReplyWithStringBuffer(ctx, scan->n->label, strlen(scan->n->label));
+		_ExecutionPlan_ReplyWithEstimate(ctx, "index_selectivity", scan->selectivity);
+		return 4;
+	}
+	case OPType_CONDITIONAL_TRAVERSE:
+		_ExecutionPlan_ReplyWithCount(ctx, "batch_size", ((const CondTraverse *)op)->batch.cap);
+		return 2;
+	case OPType_EXPAND_INTO:
+		_ExecutionPlan_ReplyWithCount(ctx, "batch_size", ((const OpExpandInto *)op)->batch.cap);
+		return 2;
+	case OPType_FILTER: {
+		const OpFilter *filter = (const OpFilter *)op;
+		_ExecutionPlan_ReplyWithCount(ctx, "batch_size", filter->batched ? FILTER_BATCH_MAX : 1);
+		return 2;
+	}
+	case OPType_VALUE_HASH_JOIN: {
+		const OpValueHashJoin *join = (const OpValueHashJoin *)op;
+		_ExecutionPlan_ReplyWithEstimate(ctx, "build_estimate", join->build_estimate);
+		_ExecutionPlan_ReplyWithEstimate(ctx, "probe_estimate", join->probe_estimate);
+		return 4;
+	}
+	default:
+		return 0;
+	}
+}
+
+// Reply with the profiled statistics of op, returns the number of reply entries.
+static int _ExecutionPlan_PrintOpStats(const OpBase *op, RedisModuleCtx *ctx) {
+	const OpStats *stats = op->stats;
+	_ExecutionPlan_ReplyWithCount(ctx, "records_produced", stats->profileRecordCount);
+	_ExecutionPlan_ReplyWithCount(ctx, "calls", stats->profileCalls);
+	_ExecutionPlan_ReplyWithEstimate(ctx, "execution_time_ms", stats->profileExecTime);
+	_ExecutionPlan_ReplyWithCount(ctx, "matrix_operations", stats->profileMatrixOps);
+	_ExecutionPlan_ReplyWithEstimate(ctx, "matrix_time_ms", stats->profileMatrixTime);
+	_ExecutionPlan_ReplyWithCount(ctx, "index_hits", stats->profileIndexHits);
+	_ExecutionPlan_ReplyWithCount(ctx, "memory", stats->profileMemory);
+	int len = 14;
+	// The query's memory is reported by the plan's root.
+	if(op->parent == NULL) {
+		_ExecutionPlan_ReplyWithCount(ctx, "peak_memory", stats->profilePeakMemory);
+		_ExecutionPlan_ReplyWithEstimate(ctx, "queue_wait_ms", stats->profileQueueWait);
+		_ExecutionPlan_ReplyWithEstimate(ctx, "lock_wait_ms", stats->profileLockWait);
+		_ExecutionPlan_ReplyWithEstimate(ctx, "matrix_sync_ms", stats->profileMatrixSync);
+		len += 8;
+	}
+	return len;
+}
+
+/* Reply with op as an array of key value pairs:
+ * operation, description, estimated_records, selectivity (the ratio of records
+ * produced to records consumed, for operations with a single child),
+ * operation specific details, profiled statistics if profiled, and children. */
+static void _ExecutionPlan_PrintStructured(const OpBase *op, RedisModuleCtx *ctx, char *buffer,
+										   int buffer_len) {
+	int len = 0;
+	RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+
+	RedisModule_ReplyWithSimpleString(ctx, "operation");
+	RedisModule_ReplyWithSimpleString(ctx, op->name);
+	int bytes_written = OpBase_ToString(op, buffer, buffer_len);
+	RedisModule_ReplyWithSimpleString(ctx, "description");
+	RedisModule_ReplyWithStringBuffer(ctx, buffer, bytes_written);
+	len += 4;
+
+	double estimate = Cardinality_Estimate(op);
+	_ExecutionPlan_ReplyWithEstimate(ctx, "estimated_records", estimate);
+	double selectivity = -1;
+	if(op->childCount == 1) {
+		double consumed = Cardinality_Estimate(op->children[0]);
+		if(consumed > 0 && estimate >= 0) selectivity = estimate / consumed;
+	}
+	_ExecutionPlan_ReplyWithEstimate(ctx, "selectivity", selectivity);
+	len += 4;
+
+	len += _ExecutionPlan_PrintOpDetails(op, ctx);
+	if(op->stats) len += _ExecutionPlan_PrintOpStats(op, ctx);
+
+	RedisModule_ReplyWithSimpleString(ctx, "children");
+	RedisModule_ReplyWithArray(ctx, op->childCount);
+	for(int i = 0; i < op->childCount; i++) {
+		_ExecutionPlan_PrintStructured(op->children[i], ctx, buffer, buffer_len);
+	}
+	len += 2;
+
+	RedisModule_ReplySetArrayLength(ctx, len);
+}
+
+void ExecutionPlan_PrintStructured(const ExecutionPlan *plan, RedisModuleCtx *ctx) {
+	assert(plan && ctx);
+	char buffer[1024];
+	_ExecutionPlan_PrintStructured(plan->root, ctx, buffer, 1024);
+}
+
 static inline void _ExecutionPlan_InitRecordPool(ExecutionPlan *plan) {
 	if(plan->record_pool) return;
 	/* Initialize record pool.
 	 * Determine Record size to inform ObjectPool allocation. */
 	uint entries_count = raxSize(plan->record_map);
-	uint rec_size = sizeof(_Record) + (sizeof(Entry) * entries_count);
 
-	// Create a data block with initial capacity of 256 records.
-	plan->record_pool = ObjectPool_New(256, rec_size, (fpDestructor)Record_FreeEntries);
+	// Reuse a pool released by an earlier plan executed on this thread.
+	plan->record_pool = RecordPool_Acquire(entries_count);
 }
 
 void _ExecutionPlanInit(OpBase *root) {
@@ -952,6 +1166,10 @@ ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan) {
 	// Encountered a run-time error - return immediately.
 	if(encountered_error) return QueryCtx_GetResultSet();
 
+	// Parameters evaluated from now on don't specialize the plan.
+	QueryCtx_SetPlanBuilt();
+	// The last writer of the executed plan is in charge of committing changes.
+	QueryCtx_SetLastWriter(_ExecutionPlan_FindLastWriter(plan->root));
 	ExecutionPlan_Init(plan);
 
 	Record r = NULL;
@@ -961,12 +1179,33 @@ ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan) {
 	return QueryCtx_GetResultSet();
 }
 
+bool ExecutionPlan_ExecuteLimit(ExecutionPlan *plan, uint64_t limit) {
+	assert(plan->prepared);
+	// Run-time errors deplete the plan.
+	if(SET_EXCEPTION_HANDLER()) return true;
+
+	// A resumed plan continues from where it stopped.
+	if(!plan->suspended) {
+		QueryCtx_SetPlanBuilt();
+		QueryCtx_SetLastWriter(_ExecutionPlan_FindLastWriter(plan->root));
+		ExecutionPlan_Init(plan);
+	}
+	plan->suspended = false;
+
+	Record r = NULL;
+	for(uint64_t i = 0; i < limit; i++) {
+		if((r = OpBase_Consume(plan->root)) == NULL) return true;
+		ExecutionPlan_ReturnRecord(r->owner, r);
+	}
+	plan->suspended = true;
+	return false;
+}
+
 static void _ExecutionPlan_InitProfiling(OpBase *root) {
 	root->profile = root->consume;
 	root->consume = OpBase_Profile;
-	root->stats = rm_malloc(sizeof(OpStats));
-	root->stats->profileExecTime = 0;
-	root->stats->profileRecordCount = 0;
+	root->stats = rm_calloc(1, sizeof(OpStats));
+	root->stats->profileEstimatedRecords = Cardinality_Estimate(root);
 
 	if(root->childCount) {
 		for(int i = 0; i < root->childCount; i++) {
@@ -985,12 +1224,37 @@ static void _ExecutionPlan_FinalizeProfiling(OpBase *root) {
 		}
 	}
 	root->stats->profileExecTime *= 1000;   // Milliseconds.
+	root->stats->profileMatrixTime *= 1000;
 }
 
 ResultSet *ExecutionPlan_Profile(ExecutionPlan *plan) {
 	_ExecutionPlan_InitProfiling(plan->root);
 	ResultSet *rs = ExecutionPlan_Execute(plan);
 	_ExecutionPlan_FinalizeProfiling(plan->root);
+	OpStats *stats = plan->root->stats;
+	stats->profilePeakMemory = QueryCtx_GetPeakMemory();
+	stats->profileQueueWait = QueryCtx_GetQueueWait();
+	stats->profileLockWait = QueryCtx_GetLockWait();
+	stats->profileMatrixSync = QueryCtx_GetMatrixSync();
+	return rs;
+}
+
+// Record a span per profiled operation, operations are consumed interleaved,
+// a span starts along with the execution and lasts the operation's aggregate time.
+static void _ExecutionPlan_TraceOps(const OpBase *op, Trace *trace, uint64_t parent_id,
+									int64_t start) {
+	uint64_t span_id = Trace_AddSpan(trace, op->name, parent_id, start, op->stats->profileExecTime,
+									 op->stats->profileRecordCount);
+	for(int i = 0; i < op->childCount; i++) {
+		_ExecutionPlan_TraceOps(op->children[i], trace, span_id, start);
+	}
+}
+
+ResultSet *ExecutionPlan_Trace(ExecutionPlan *plan, Trace *trace, uint64_t parent_id) {
+	int64_t start = Trace_Now(trace);
+	ResultSet *rs = ExecutionPlan_Profile(plan);
+	uint64_t span_id = Trace_EndSpan(trace, "execute", parent_id, start, rs->recordCount);
+	_ExecutionPlan_TraceOps(plan->root, trace, span_id, start);
 	return rs;
 }
 
@@ -1016,7 +1280,7 @@ static void _ExecutionPlan_FreeSubPlan(ExecutionPlan *plan) {
 
 	QueryGraph_Free(plan->query_graph);
 	if(plan->record_map) raxFree(plan->record_map);
-	if(plan->record_pool) ObjectPool_Free(plan->record_pool);
+	if(plan->record_pool) RecordPool_Release(plan->record_pool);
 	rm_free(plan);
 }
 
@@ -1044,7 +1308,7 @@ void ExecutionPlan_Free(ExecutionPlan *plan) {
 
 	QueryGraph_Free(plan->query_graph);
 	if(plan->record_map) raxFree(plan->record_map);
-	if(plan->record_pool) ObjectPool_Free(plan->record_pool);
+	if(plan->record_pool) RecordPool_Release(plan->record_pool);
 	rm_free(plan);
 }
 
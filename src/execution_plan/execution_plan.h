@@ -8,8 +8,10 @@
 
 #include "./ops/op.h"
 #include "../graph/graph.h"
+#include "../graph/graphcontext.h"
 #include "../resultset/resultset.h"
 #include "../filter_tree/filter_tree.h"
+#include "../tracing/trace.h"
 #include "../util/object_pool/object_pool.h"
 
 typedef struct ExecutionPlan ExecutionPlan;
@@ -26,6 +28,7 @@ struct ExecutionPlan {
 	ObjectPool *record_pool;
 	bool prepared;                      // Indicates if the execution plan is ready for execute.
 	bool is_union;                      // Indicates if the execution plan is a union of execution plans.
+	bool suspended;                     // Execution stopped before the plan was depleted, see ExecutionPlan_ExecuteLimit.
 };
 
 /* execution_plan_modify.c
@@ -104,6 +107,13 @@ void ExecutionPlan_BindPlanToOps(ExecutionPlan *plan, OpBase *root);
 OpBase *ExecutionPlan_BuildOpsFromPath(ExecutionPlan *plan, const char **vars,
 									   const cypher_astnode_t *path);
 
+/* execution_plan_clone.c */
+
+/* Clone an execution plan, including all of its segments.
+ * The template's query graphs are referenced by the clone and must outlive it.
+ * Returns NULL if any operation within the plan doesn't support cloning. */
+ExecutionPlan *ExecutionPlan_Clone(const ExecutionPlan *template);
+
 /* execution_plan.c */
 
 /* Creates a new execution plan from AST */
@@ -112,6 +122,21 @@ ExecutionPlan *NewExecutionPlan(void);
 /* Prepare an execution plan for execution: optimize, initialize result set schema. */
 void ExecutionPlan_PreparePlan(ExecutionPlan *plan);
 
+/* Prepare an execution plan applying only the given optimizer rules, see optimizer.h.
+ * If track is set, returns the rules which modified the plan's shape, otherwise 0. */
+uint ExecutionPlan_PreparePlanWithRules(ExecutionPlan *plan, uint rules, bool track);
+
+/* Prepare an execution plan for query, applying the rules of the plan pinned for its body if any.
+ * Logs a warning if the prepared plan doesn't match the pinned shape. */
+void ExecutionPlan_PreparePinnedPlan(ExecutionPlan *plan, GraphContext *gc, const char *query);
+
+/* Returns the shape of the plan, its operations' string representations in pre-order
+ * with each operation's children parenthesized. The string must be freed by the caller. */
+char *ExecutionPlan_Shape(const ExecutionPlan *plan);
+
+/* Returns a hash of the plan's shape, plans sharing a shape share a fingerprint. */
+uint64_t ExecutionPlan_Fingerprint(const ExecutionPlan *plan);
+
 /* Allocate a new ExecutionPlan segment. */
 ExecutionPlan *ExecutionPlan_NewEmptyExecutionPlan(void);
 
@@ -138,15 +163,28 @@ void ExecutionPlan_ReturnRecord(ExecutionPlan *plan, Record r);
 /* Prints execution plan. */
 void ExecutionPlan_Print(const ExecutionPlan *plan, RedisModuleCtx *ctx);
 
+/* Reply with a tree of key value arrays describing each operation of the plan,
+ * along with its cardinality estimates and the choices made by the optimizer. */
+void ExecutionPlan_PrintStructured(const ExecutionPlan *plan, RedisModuleCtx *ctx);
+
 /* Initialize all operations in an ExecutionPlan. */
 void ExecutionPlan_Init(ExecutionPlan *plan);
 
 /* Executes plan */
 ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan);
 
+/* Executes plan until its root produced limit records or the plan is depleted,
+ * a plan which produced limit records is suspended, and resumed by the next call.
+ * Returns false if the plan is suspended. */
+bool ExecutionPlan_ExecuteLimit(ExecutionPlan *plan, uint64_t limit);
+
 /* Profile executes plan */
 ResultSet *ExecutionPlan_Profile(ExecutionPlan *plan);
 
+/* Profile executes plan, recording an execution span under parent_id and, beneath it,
+ * a span per operation lasting the time spent consuming it, its children excluded. */
+ResultSet *ExecutionPlan_Trace(ExecutionPlan *plan, Trace *trace, uint64_t parent_id);
+
 /* Free execution plan */
 void ExecutionPlan_Free(ExecutionPlan *plan);
 
@@ -0,0 +1,92 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "execution_plan.h"
+#include "../util/rmalloc.h"
+#include "../util/rax_extensions.h"
+#include <assert.h>
+
+/* Clone the segment level data of an execution plan,
+ * operations are cloned separately. */
+static ExecutionPlan *_ClonePlanInternals(const ExecutionPlan *template) {
+	ExecutionPlan *clone = ExecutionPlan_NewEmptyExecutionPlan();
+	clone->is_union = template->is_union;
+	clone->prepared = template->prepared;
+	/* Seed the clone's record map with the template's mappings,
+	 * such that cloned operations resolve to the same record offsets. */
+	clone->record_map = raxClone(template->record_map);
+	if(template->query_graph) clone->query_graph = QueryGraph_Clone(template->query_graph);
+	return clone;
+}
+
+/* Retrieve the clone of the given plan segment, creating it if this is the
+ * first operation encountered that belongs to the segment. */
+static ExecutionPlan *_MapSegment(rax *segments, const ExecutionPlan *template) {
+	ExecutionPlan *clone = raxFind(segments, (unsigned char *)&template, sizeof(template));
+	if(clone == raxNotFound) {
+		clone = _ClonePlanInternals(template);
+		raxInsert(segments, (unsigned char *)&template, sizeof(template), clone, NULL);
+	}
+	return clone;
+}
+
+static void _FreeOpTree(OpBase *op) {
+	for(int i = 0; i < op->childCount; i++) _FreeOpTree(op->children[i]);
+	OpBase_Free(op);
+}
+
+/* Clone the operation tree rooted at op, binding each cloned operation to
+ * the clone of its original segment.
+ * Returns NULL if an operation within the tree doesn't support cloning. */
+static OpBase *_CloneOpTree(rax *segments, const OpBase *op) {
+	ExecutionPlan *plan = _MapSegment(segments, op->plan);
+	OpBase *clone = OpBase_Clone(plan, op);
+	if(clone == NULL) return NULL;
+
+	for(int i = 0; i < op->childCount; i++) {
+		OpBase *child = _CloneOpTree(segments, op->children[i]);
+		if(child == NULL) {
+			_FreeOpTree(clone);
+			return NULL;
+		}
+		ExecutionPlan_AddOp(clone, child);
+	}
+
+	return clone;
+}
+
+ExecutionPlan *ExecutionPlan_Clone(const ExecutionPlan *template) {
+	assert(template && template->root);
+
+	// Map from template segments to their clones.
+	rax *segments = raxNew();
+	ExecutionPlan *clone = _MapSegment(segments, template);
+	clone->root = _CloneOpTree(segments, template->root);
+
+	/* The clone owns all other cloned segments,
+	 * these will be freed alongside it. */
+	uint segment_count = raxSize(segments) - 1;
+	if(segment_count > 0) {
+		clone->segments = rm_malloc(segment_count * sizeof(ExecutionPlan *));
+		raxIterator it;
+		raxStart(&it, segments);
+		raxSeek(&it, "^", NULL, 0);
+		while(raxNext(&it)) {
+			ExecutionPlan *segment = it.data;
+			if(segment != clone) clone->segments[clone->segment_count++] = segment;
+		}
+		raxStop(&it);
+	}
+	raxFree(segments);
+
+	// Failed to clone the operation tree.
+	if(clone->root == NULL) {
+		ExecutionPlan_Free(clone);
+		return NULL;
+	}
+
+	return clone;
+}
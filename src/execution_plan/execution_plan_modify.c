@@ -277,6 +277,12 @@ static void _RebindQueryGraphReferences(OpBase *op, const QueryGraph *qg) {
 	case OPType_INDEX_SCAN:
 		((IndexScan *)op)->n = QueryGraph_GetNodeByAlias(qg, ((IndexScan *)op)->n->alias);
 		return;
+	case OPType_INDEX_ORDER_SCAN:
+		((IndexOrderScan *)op)->n = QueryGraph_GetNodeByAlias(qg, ((IndexOrderScan *)op)->n->alias);
+		return;
+	case OPType_EDGE_INDEX_SCAN:
+		((EdgeIndexScan *)op)->e = QueryGraph_GetEdgeByAlias(qg, ((EdgeIndexScan *)op)->e->alias);
+		return;
 	case OPType_ALL_NODE_SCAN:
 		((AllNodeScan *)op)->n = QueryGraph_GetNodeByAlias(qg, ((AllNodeScan *)op)->n->alias);
 		return;
@@ -33,9 +33,27 @@ static OpBase *_ApplyOpFromPathExpression(ExecutionPlan *plan, const char **vars
 		anti = true;
 		expression = expression->op.children[0];
 	}
-	// Build new Semi Apply op.
-	OpBase *op_semi_apply = NewSemiApplyOp(plan, anti);
 	const cypher_astnode_t *path = expression->op.children[0]->operand.constant.ptrval;
+
+	// The pattern's outcome is cached per values of the bound variables it references.
+	const char **referenced = array_new(const char *, 4);
+	AST_CollectAliases(&referenced, path);
+	const char **keys = array_new(const char *, 1);
+	uint var_count = vars ? array_len(vars) : 0;
+	uint referenced_count = array_len(referenced);
+	for(uint i = 0; i < var_count; i++) {
+		for(uint j = 0; j < referenced_count; j++) {
+			if(strcmp(vars[i], referenced[j]) == 0) {
+				keys = array_append(keys, vars[i]);
+				break;
+			}
+		}
+	}
+
+	// Build new Semi Apply op.
+	OpBase *op_semi_apply = NewSemiApplyOp(plan, anti, keys);
+	array_free(referenced);
+	array_free(keys);
 	// Add a match branch as a Semi Apply op child.
 	OpBase *match_branch = ExecutionPlan_BuildOpsFromPath(plan, vars, path);
 	ExecutionPlan_AddOp(op_semi_apply, match_branch);
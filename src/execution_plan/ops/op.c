@@ -7,9 +7,12 @@
 #include "op.h"
 #include "../../util/rmalloc.h"
 #include "../../util/simple_timer.h"
+#include "../../query_ctx.h"
 
 #include <assert.h>
 
+__thread OpStats *op_profiled_stats = NULL;
+
 /* Forward declarations */
 Record ExecutionPlan_BorrowRecord(struct ExecutionPlan *plan);
 rax *ExecutionPlan_GetMappings(const struct ExecutionPlan *plan);
@@ -43,6 +46,8 @@ void OpBase_Init(OpBase *op, OPType type, const char *name, fpInit init, fpConsu
 }
 
 inline Record OpBase_Consume(OpBase *op) {
+	// Cooperatively abort queries which exceeded their timeout.
+	QueryCtx_CheckTimeout(op);
 	return op->consume(op);
 }
 
@@ -94,10 +99,27 @@ void OpBase_PropagateReset(OpBase *op) {
 }
 
 static int _OpBase_StatsToString(const OpBase *op, char *buff, uint buff_len) {
-	return snprintf(buff, buff_len,
-					" | Records produced: %d, Execution time: %f ms",
-					op->stats->profileRecordCount,
-					op->stats->profileExecTime);
+	int bytes_written = snprintf(buff, buff_len,
+								 " | Records produced: %d, Estimated records: %.0f, Execution time: %f ms",
+								 op->stats->profileRecordCount,
+								 op->stats->profileEstimatedRecords,
+								 op->stats->profileExecTime);
+	if(op->stats->profileMatrixOps > 0) {
+		bytes_written += snprintf(buff + bytes_written, buff_len - bytes_written,
+								  ", Matrix time: %f ms", op->stats->profileMatrixTime);
+	}
+	if(op->stats->profileIndexHits > 0) {
+		bytes_written += snprintf(buff + bytes_written, buff_len - bytes_written,
+								  ", Index hits: %llu", (unsigned long long)op->stats->profileIndexHits);
+	}
+	// The query's memory is reported by the plan's root.
+	if(op->parent == NULL) {
+		bytes_written += snprintf(buff + bytes_written, buff_len - bytes_written,
+								  ", Peak memory: %zu bytes, Queue wait: %f ms, Lock wait: %f ms, Matrix sync: %f ms",
+								  op->stats->profilePeakMemory, op->stats->profileQueueWait,
+								  op->stats->profileLockWait, op->stats->profileMatrixSync);
+	}
+	return bytes_written;
 }
 
 int OpBase_ToString(const OpBase *op, char *buff, uint buff_len) {
@@ -117,12 +139,22 @@ int OpBase_ToString(const OpBase *op, char *buff, uint buff_len) {
 
 Record OpBase_Profile(OpBase *op) {
 	double tic [2];
+	// Counters are accounted to the innermost operation executing.
+	OpStats *caller = op_profiled_stats;
+	op_profiled_stats = op->stats;
 	// Start timer.
 	simple_tic(tic);
 	Record r = op->profile(op);
 	// Stop timer and accumulate.
 	op->stats->profileExecTime += simple_toc(tic);
+	op_profiled_stats = caller;
+
+	op->stats->profileCalls++;
 	if(r) op->stats->profileRecordCount++;
+	if(rm_account && rm_account->allocated > 0 &&
+	   (size_t)rm_account->allocated > op->stats->profileMemory) {
+		op->stats->profileMemory = rm_account->allocated;
+	}
 	return r;
 }
 
@@ -20,6 +20,8 @@ typedef enum {
 	OPType_ALL_NODE_SCAN,
 	OPType_NODE_BY_LABEL_SCAN,
 	OPType_INDEX_SCAN,
+	OPType_EDGE_INDEX_SCAN,
+	OPType_INDEX_ORDER_SCAN,
 	OPType_NODE_BY_ID_SEEK,
 	OpType_NODE_BY_LABEL_AND_ID_SCAN,
 	OPType_EXPAND_INTO,
@@ -50,6 +52,7 @@ typedef enum {
 	OpType_ANTI_SEMI_APPLY,
 	OPType_OR_APPLY_MULTIPLEXER,
 	OPType_AND_APPLY_MULTIPLEXER,
+	OPType_EXPAND_INTERSECT,
 } OPType;
 
 typedef enum {
@@ -68,8 +71,8 @@ static const OPType PROJECT_OPS[] = {OPType_PROJECT, OPType_AGGREGATE};
 #define TRAVERSE_OP_COUNT 2
 static const OPType TRAVERSE_OPS[] = {OPType_CONDITIONAL_TRAVERSE, OPType_CONDITIONAL_VAR_LEN_TRAVERSE};
 
-#define SCAN_OP_COUNT 5
-static const OPType SCAN_OPS[] = {OPType_ALL_NODE_SCAN, OPType_NODE_BY_LABEL_SCAN, OPType_INDEX_SCAN, OPType_NODE_BY_ID_SEEK, OpType_NODE_BY_LABEL_AND_ID_SCAN};
+#define SCAN_OP_COUNT 6
+static const OPType SCAN_OPS[] = {OPType_ALL_NODE_SCAN, OPType_NODE_BY_LABEL_SCAN, OPType_INDEX_SCAN, OPType_INDEX_ORDER_SCAN, OPType_NODE_BY_ID_SEEK, OpType_NODE_BY_LABEL_AND_ID_SCAN};
 
 struct OpBase;
 struct ExecutionPlan;
@@ -84,9 +87,28 @@ typedef struct OpBase *(*fpClone)(const struct ExecutionPlan *, const struct OpB
 // Execution plan operation statistics.
 typedef struct {
 	int profileRecordCount;     // Number of records generated.
-	double profileExecTime;     // Operation total execution time in ms.
+	double profileExecTime;     // Operation execution time in ms, excluding its children.
+	double profileEstimatedRecords; // Number of records the optimizer expected.
+	size_t profilePeakMemory;   // Maximum number of bytes the query had allocated at once, root only.
+	double profileQueueWait;    // Time the query waited in a thread pool queue in ms, root only.
+	double profileLockWait;     // Time the query waited for locks in ms, root only.
+	double profileMatrixSync;   // Time the query spent synchronizing matrices in ms, root only.
+	uint64_t profileCalls;      // Number of times the operation was consumed.
+	uint64_t profileMatrixOps;  // Number of algebraic expressions evaluated, a batch each.
+	double profileMatrixTime;   // Time spent evaluating algebraic expressions in ms.
+	uint64_t profileIndexHits;  // Number of entity IDs retrieved from indices.
+	size_t profileMemory;       // Maximum number of bytes the query held as the operation returned.
 }  OpStats;
 
+/* Statistics of the profiled operation executing on the calling thread,
+ * NULL if the calling thread isn't executing a profiled operation. */
+extern __thread OpStats *op_profiled_stats;
+
+// Account an entity ID retrieved from an index to the profiled operation, if any.
+static inline void OpBase_ProfileIndexHit(void) {
+	if(op_profiled_stats) op_profiled_stats->profileIndexHits++;
+}
+
 struct OpBase {
 	OPType type;                // Type of operation.
 	fpInit init;                // Called once before execution.
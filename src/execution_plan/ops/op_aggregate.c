@@ -13,6 +13,7 @@
 #include "../../arithmetic/aggregate.h"
 
 /* Forward declarations. */
+static OpResult AggregateInit(OpBase *opBase);
 static Record AggregateConsume(OpBase *opBase);
 static OpResult AggregateReset(OpBase *opBase);
 static OpBase *AggregateClone(const ExecutionPlan *plan, const OpBase *opBase);
@@ -49,30 +50,15 @@ static inline AR_ExpNode **_build_aggregate_exps(OpAggregate *op) {
 	return agg_exps;
 }
 
-/* Build a new Group key of the SIValue results of non-aggregate expressions. */
-static inline SIValue *_build_group_key(OpAggregate *op) {
-	SIValue *group_keys = rm_malloc(sizeof(SIValue) * op->key_count);
-
-	for(uint i = 0; i < op->key_count; i++) {
-		SIValue key = op->group_keys[i];
-		SIValue_Persist(&key);
-		group_keys[i] = key;
-	}
-
-	return group_keys;
-}
-
-static Group *_CreateGroup(OpAggregate *op, Record r) {
-	/* Create a new group
-	 * Clone group keys. */
-	SIValue *group_keys = _build_group_key(op);
-
+static Group *_CreateGroup(OpAggregate *op, Record r, uint64_t hash) {
 	/* Get a fresh copy of aggregation functions. */
 	AR_ExpNode **agg_exps = _build_aggregate_exps(op);
 
-	/* There's no need to keep a reference to record if we're not sorting groups. */
+	/* There's no need to keep a reference to record if we're not sorting groups.
+	 * Group keys are persisted by the cache. */
 	Record cache_record = (op->should_cache_records) ? r : NULL;
-	op->group = NewGroup(group_keys, op->key_count, agg_exps, op->aggregate_count, cache_record);
+	op->group = CacheGroupAdd(op->groups, op->group_keys, hash, agg_exps, op->aggregate_count,
+							  cache_record);
 
 	return op->group;
 }
@@ -84,54 +70,28 @@ static void _ComputeGroupKey(OpAggregate *op, Record r) {
 	}
 }
 
-static void _ComputeGroupKeyStr(OpAggregate *op, char **key) {
-	if(op->key_count == 0) {
-		*key = rm_strdup("SINGLE_GROUP");
-		return;
-	}
-
-	// Determine required size for group key string representation.
-	size_t key_len = SIValue_StringJoinLen(op->group_keys, op->key_count, ",");
-	*key = rm_malloc(sizeof(char) * key_len);
-	size_t bytesWritten = 0;
-	SIValue_StringJoin(op->group_keys, op->key_count, ",", key, &key_len, &bytesWritten);
+static void _FreeGroupKey(OpAggregate *op) {
+	for(uint i = 0; i < op->key_count; i++) SIValue_Free(op->group_keys[i]);
 }
 
 /* Retrieves group under which given record belongs to,
  * creates group if one doesn't exists. */
 static Group *_GetGroup(OpAggregate *op, Record r) {
-	char *group_key_str;
 	// Construct group key.
 	_ComputeGroupKey(op, r);
 
-	// First group created.
-	if(!op->group) {
-		op->group = _CreateGroup(op, r);
-		Group_KeyStr(op->group, &group_key_str);
-		CacheGroupAdd(op->groups, group_key_str, op->group);
-		goto cleanup;
-	}
-
-	// Evaluate non-aggregated fields, see if they match
-	// the last accessed group.
-	bool reuseLastAccessedGroup = true;
-	for(uint i = 0; reuseLastAccessedGroup && i < op->key_count; i++) {
-		reuseLastAccessedGroup = (SIValue_Compare(op->group->keys[i], op->group_keys[i], NULL) == 0);
-	}
-
 	// See if we can reuse last accessed group.
-	if(reuseLastAccessedGroup) return op->group;
-
-	// Can't reuse last accessed group, lookup group by identifier key.
-	_ComputeGroupKeyStr(op, &group_key_str);
-	op->group = CacheGroupGet(op->groups, group_key_str);
-	if(!op->group) {
-		// Group does not exists, create it.
-		op->group = _CreateGroup(op, r);
-		CacheGroupAdd(op->groups, group_key_str, op->group);
+	if(!op->group || !Group_KeysMatch(op->group, op->group_keys)) {
+		// Can't reuse last accessed group, lookup group by its key values.
+		uint64_t hash = CacheGroup_HashKeys(op->group_keys, op->key_count);
+		op->group = CacheGroupGet(op->groups, op->group_keys, hash);
+		if(!op->group) {
+			// Group does not exists, create it, the group takes ownership of the key values.
+			return _CreateGroup(op, r, hash);
+		}
 	}
-cleanup:
-	rm_free(group_key_str);
+
+	_FreeGroupKey(op);
 	return op->group;
 }
 
@@ -152,9 +112,8 @@ static void _aggregateRecord(OpAggregate *op, Record r) {
 
 /* Returns a record populated with group data. */
 static Record _handoff(OpAggregate *op) {
-	char *key;
 	Group *group;
-	if(!CacheGroupIterNext(op->group_iter, &key, &group)) return NULL;
+	if(!CacheGroupIterNext(op->group_iter, &group)) return NULL;
 
 	Record r = OpBase_CreateRecord((OpBase *)op);
 
@@ -177,6 +136,13 @@ static Record _handoff(OpAggregate *op) {
 		Record_AddScalar(r, rec_idx, res);
 	}
 
+	if(op->replayable) {
+		// Retain the record, handing off a copy sharing its values.
+		op->replay = array_append(op->replay, r);
+		op->replay_idx++;
+		r = OpBase_CloneRecord(r);
+	}
+
 	return r;
 }
 
@@ -185,8 +151,11 @@ OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should
 	op->group = NULL;
 	op->group_iter = NULL;
 	op->group_keys = NULL;
-	op->groups = CacheGroupNew();
+	op->groups = NULL;
 	op->should_cache_records = should_cache_records;
+	op->replayable = false;
+	op->replay = NULL;
+	op->replay_idx = 0;
 
 	// Migrate each expression to the keys array or the aggregations array as appropriate.
 	_migrate_expressions(op, exps);
@@ -194,8 +163,9 @@ OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should
 
 	// Allocate memory for group keys if we have any non-aggregate expressions.
 	if(op->key_count) op->group_keys = rm_malloc(op->key_count * sizeof(SIValue));
+	op->groups = CacheGroupNew(op->key_count);
 
-	OpBase_Init((OpBase *)op, OPType_AGGREGATE, "Aggregate", NULL, AggregateConsume,
+	OpBase_Init((OpBase *)op, OPType_AGGREGATE, "Aggregate", AggregateInit, AggregateConsume,
 				AggregateReset, NULL, AggregateClone, AggregateFree, false, plan);
 
 	// The projected record will associate values with their resolved name
@@ -215,8 +185,28 @@ OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should
 	return (OpBase *)op;
 }
 
+// Returns true if the records produced by root don't depend on outer records nor on writes.
+static bool _AggregateUncorrelated(const OpBase *root) {
+	if(root->type == OPType_ARGUMENT || root->writer) return false;
+	for(int i = 0; i < root->childCount; i++) {
+		if(!_AggregateUncorrelated(root->children[i])) return false;
+	}
+	return true;
+}
+
+static OpResult AggregateInit(OpBase *opBase) {
+	OpAggregate *op = (OpAggregate *)opBase;
+	op->replayable = (op->op.childCount == 0 || _AggregateUncorrelated(op->op.children[0]));
+	if(op->replayable) op->replay = array_new(Record, 1);
+	return OP_OK;
+}
+
 static Record AggregateConsume(OpBase *opBase) {
 	OpAggregate *op = (OpAggregate *)opBase;
+	// Replay the records handed off prior to a reset.
+	if(op->replay_idx < array_len(op->replay)) {
+		return OpBase_CloneRecord(op->replay[op->replay_idx++]);
+	}
 	if(op->group_iter) return _handoff(op);
 
 	Record r;
@@ -237,8 +227,14 @@ static Record AggregateConsume(OpBase *opBase) {
 static OpResult AggregateReset(OpBase *opBase) {
 	OpAggregate *op = (OpAggregate *)opBase;
 
+	// Groups are kept, replaying handed off records and resuming the iteration.
+	if(op->replayable) {
+		op->replay_idx = 0;
+		return OP_OK;
+	}
+
 	FreeGroupCache(op->groups);
-	op->groups = CacheGroupNew();
+	op->groups = CacheGroupNew(op->key_count);
 
 	if(op->group_iter) {
 		CacheGroupIterator_Free(op->group_iter);
@@ -288,6 +284,13 @@ static void AggregateFree(OpBase *opBase) {
 		op->aggregate_exps = NULL;
 	}
 
+	if(op->replay) {
+		uint count = array_len(op->replay);
+		for(uint i = 0; i < count; i++) OpBase_DeleteRecord(op->replay[i]);
+		array_free(op->replay);
+		op->replay = NULL;
+	}
+
 	if(op->groups) {
 		FreeGroupCache(op->groups);
 		op->groups = NULL;
@@ -18,14 +18,22 @@ typedef struct {
 	uint *record_offsets;               /* Record IDs for key and aggregate exps. */
 	AR_ExpNode **key_exps;              /* Array of expressions used to calculate the group key. */
 	AR_ExpNode **aggregate_exps;        /* Array of expressions that aggregate data for each key. */
-	rax *groups;                        /* Map of all groups built by this operation. */
+	CacheGroup *groups;                 /* Map of all groups built by this operation. */
 	Group *group;                       /* Last accessed group. */
 	SIValue *group_keys;                /* Array of values that represent a key associated with a Group of aggregations. */
 	CacheGroupIterator *group_iter;     /* Iterator for walking all groups. */
 	uint key_count;                     /* Number of key expressions. */
 	uint aggregate_count;               /* Number of aggregating expressions. */
 	bool should_cache_records;          /* Records should be cached if we're sorting after aggregation. */
+	bool replayable;                    /* Groups don't depend on outer records, and survive resets. */
+	Record *replay;                     /* Records handed off so far, replayed once reset if replayable. */
+	uint replay_idx;                    /* Next record to replay. */
 } OpAggregate;
 
+/* Aggregate
+ * Consumes its child entirely, grouping records by key expressions.
+ * An aggregation whose child subtree neither reads outer records through
+ * an Argument nor modifies the graph produces the same groups whenever it is reset,
+ * such a segment is executed once and its records are replayed afterwards. */
 OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should_cache_records);
 
@@ -9,6 +9,7 @@
 /* Forward declarations. */
 static Record ApplyConsume(OpBase *opBase);
 static OpResult ApplyReset(OpBase *opBase);
+static OpBase *ApplyClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ApplyFree(OpBase *opBase);
 
 OpBase *NewApplyOp(const ExecutionPlan *plan) {
@@ -19,7 +20,7 @@ OpBase *NewApplyOp(const ExecutionPlan *plan) {
 	op->rhs_records = array_new(Record, 32);
 
 	// Set our Op operations
-	OpBase_Init((OpBase *)op, OPType_APPLY, "Apply", NULL, ApplyConsume, ApplyReset, NULL, NULL,
+	OpBase_Init((OpBase *)op, OPType_APPLY, "Apply", NULL, ApplyConsume, ApplyReset, NULL, ApplyClone,
 				ApplyFree, false, plan);
 
 	return (OpBase *)op;
@@ -57,21 +58,26 @@ static Record ApplyConsume(OpBase *opBase) {
 		return NULL;
 	}
 
-	// Clone the left-hand record
-	Record r = OpBase_CloneRecord(op->lhs_record);
-
-	// No records were produced by the right-hand stream
-	if(rhs_count == 0) return r;
+	// No records were produced by the right-hand stream, pass the left-hand record on.
+	if(rhs_count == 0) {
+		Record r = op->lhs_record;
+		op->lhs_record = NULL;
+		return r;
+	}
 
 	rhs_record = op->rhs_records[op->rhs_idx++];
 
+	Record r;
 	if(op->rhs_idx == rhs_count) {
 		// We've joined all data from the right-hand stream with the current
-		// retrieval from the left-hand stream.
-		// The next call to ApplyConsume will attempt to pull new data.
-		OpBase_DeleteRecord(op->lhs_record);
+		// retrieval from the left-hand stream, hand the left-hand record off
+		// rather than copying it, the next call to ApplyConsume will pull new data.
+		r = op->lhs_record;
 		op->lhs_record = NULL;
 		op->rhs_idx = 0;
+	} else {
+		// Clone the left-hand record
+		r = OpBase_CloneRecord(op->lhs_record);
 	}
 
 	Record_Merge(&r, rhs_record);
@@ -85,6 +91,11 @@ static OpResult ApplyReset(OpBase *opBase) {
 	return OP_OK;
 }
 
+static inline OpBase *ApplyClone(const ExecutionPlan *plan, const OpBase *opBase) {
+	assert(opBase->type == OPType_APPLY);
+	return NewApplyOp(plan);
+}
+
 static void ApplyFree(OpBase *opBase) {
 	Apply *op = (Apply *)opBase;
 	if(op->lhs_record) {
@@ -18,7 +18,7 @@ OpBase *NewArgumentOp(const ExecutionPlan *plan, const char **variables) {
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_ARGUMENT, "Argument", NULL,
-				ArgumentConsume, ArgumentReset, NULL, NULL, ArgumentFree, false, plan);
+				ArgumentConsume, ArgumentReset, NULL, ArgumentClone, ArgumentFree, false, plan);
 
 	uint variable_count = array_len(variables);
 	for(uint i = 0; i < variable_count; i ++) {
@@ -5,6 +5,8 @@
 */
 
 #include "op_cartesian_product.h"
+#include "../cardinality.h"
+#include "../../util/arr.h"
 
 /* Forward declarations. */
 static OpResult CartesianProductInit(OpBase *opBase);
@@ -17,6 +19,7 @@ OpBase *NewCartesianProductOp(const ExecutionPlan *plan) {
 	CartesianProduct *op = rm_malloc(sizeof(CartesianProduct));
 	op->init = true;
 	op->r = NULL;
+	op->branches = NULL;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_CARTESIAN_PRODUCT, "Cartesian Product", CartesianProductInit,
@@ -25,33 +28,91 @@ OpBase *NewCartesianProductOp(const ExecutionPlan *plan) {
 	return (OpBase *)op;
 }
 
+static void _FreeBranchRecords(CartesianBranch *branch) {
+	if(!branch->records) return;
+	uint count = array_len(branch->records);
+	for(uint i = 0; i < count; i++) OpBase_DeleteRecord(branch->records[i]);
+	array_free(branch->records);
+	branch->records = NULL;
+}
+
+// Discards materialized records, branches are buffered again once read.
+static void _ResetBranches(CartesianProduct *op) {
+	uint last = op->op.childCount - 1;
+	for(uint i = 0; i < last; i++) {
+		CartesianBranch *branch = op->branches + i;
+		_FreeBranchRecords(branch);
+		branch->records = array_new(Record, 32);
+		branch->buffering = true;
+		branch->materialized = false;
+		branch->idx = 0;
+	}
+}
+
+// Pulls the next record of branch i into op->r, returns false if the branch is depleted.
+static bool _PullFromBranch(CartesianProduct *op, int i) {
+	CartesianBranch *branch = op->branches + i;
+	if(branch->materialized) {
+		if(branch->idx == array_len(branch->records)) return false;
+		// Share the buffered record's entries, which remain owned by the buffer.
+		Record buffered = branch->records[branch->idx++];
+		uint len = Record_length(buffered);
+		for(uint j = 0; j < len; j++) {
+			if(Record_GetType(buffered, j) == REC_TYPE_UNKNOWN) continue;
+			op->r->entries[j] = buffered->entries[j];
+			if(Record_GetType(buffered, j) == REC_TYPE_SCALAR) {
+				SIValue_MakeVolatile(&op->r->entries[j].value.s);
+			}
+		}
+		return true;
+	}
+
+	Record childRecord = OpBase_Consume(op->op.children[i]);
+	if(!childRecord) {
+		if(branch->buffering) branch->materialized = true;
+		return false;
+	}
+
+	/* Buffer the record, unless the branch outgrew the buffer,
+	 * in which case it is pulled from its child from now on.
+	 * Buffered records are kept, as emitted records share their entries. */
+	if(branch->buffering && array_len(branch->records) >= CARTESIAN_PRODUCT_BUFFER_CAP) {
+		branch->buffering = false;
+	}
+	if(branch->buffering) {
+		branch->records = array_append(branch->records, childRecord);
+		Record_Merge(&op->r, childRecord);
+		uint len = Record_length(childRecord);
+		for(uint j = 0; j < len; j++) {
+			if(Record_GetType(childRecord, j) == REC_TYPE_SCALAR) {
+				SIValue_MakeVolatile(&op->r->entries[j].value.s);
+			}
+		}
+	} else {
+		Record_TransferEntries(&op->r, childRecord);
+		OpBase_DeleteRecord(childRecord);
+	}
+	return true;
+}
+
 static void _ResetStreams(CartesianProduct *cp, int streamIdx) {
-	// Reset each child stream, Reset propagates upwards.
-	for(int i = 0; i < streamIdx; i++) OpBase_PropagateReset(cp->op.children[i]);
+	// Replay materialized streams, reset each other child stream, Reset propagates upwards.
+	for(int i = 0; i < streamIdx; i++) {
+		if(cp->branches[i].materialized) cp->branches[i].idx = 0;
+		else OpBase_PropagateReset(cp->op.children[i]);
+	}
 }
 
 static int _PullFromStreams(CartesianProduct *op) {
 	for(int i = 1; i < op->op.childCount; i++) {
-		OpBase *child = op->op.children[i];
-		Record childRecord = OpBase_Consume(child);
-
-		if(childRecord) {
-			Record_TransferEntries(&op->r, childRecord);
-			OpBase_DeleteRecord(childRecord);
+		if(_PullFromBranch(op, i)) {
 			/* Managed to get new data
 			 * Reset streams [0-i] */
 			_ResetStreams(op, i);
 
 			// Pull from resetted streams.
 			for(int j = 0; j < i; j++) {
-				child = op->op.children[j];
-				childRecord = OpBase_Consume(child);
-				if(childRecord) {
-					Record_TransferEntries(&op->r, childRecord);
-					OpBase_DeleteRecord(childRecord);
-				} else {
-					return 0;
-				}
+				if(!_PullFromBranch(op, j)) return 0;
 			}
 			// Ready to continue.
 			return 1;
@@ -66,36 +127,41 @@ static int _PullFromStreams(CartesianProduct *op) {
 static OpResult CartesianProductInit(OpBase *opBase) {
 	CartesianProduct *op = (CartesianProduct *)opBase;
 	op->r = OpBase_CreateRecord((OpBase *)op);
+
+	// The last stream is read once, make it the one estimated to produce the most records.
+	int last = opBase->childCount - 1;
+	int largest = last;
+	double largest_estimate = Cardinality_Estimate(opBase->children[last]);
+	for(int i = 0; i < last; i++) {
+		double estimate = Cardinality_Estimate(opBase->children[i]);
+		if(estimate > largest_estimate) {
+			largest = i;
+			largest_estimate = estimate;
+		}
+	}
+	OpBase *tmp = opBase->children[largest];
+	opBase->children[largest] = opBase->children[last];
+	opBase->children[last] = tmp;
+
+	op->branches = rm_calloc(opBase->childCount, sizeof(CartesianBranch));
+	_ResetBranches(op);
 	return OP_OK;
 }
 
 static Record CartesianProductConsume(OpBase *opBase) {
 	CartesianProduct *op = (CartesianProduct *)opBase;
-	OpBase *child;
-	Record childRecord;
 
 	if(op->init) {
 		op->init = false;
 
 		for(int i = 0; i < op->op.childCount; i++) {
-			child = op->op.children[i];
-			childRecord = OpBase_Consume(child);
-			if(!childRecord) return NULL;
-			Record_TransferEntries(&op->r, childRecord);
-			OpBase_DeleteRecord(childRecord);
+			if(!_PullFromBranch(op, i)) return NULL;
 		}
 		return OpBase_CloneRecord(op->r);
 	}
 
 	// Pull from first stream.
-	child = op->op.children[0];
-	childRecord = OpBase_Consume(child);
-
-	if(childRecord) {
-		// Managed to get data from first stream.
-		Record_TransferEntries(&op->r, childRecord);
-		OpBase_DeleteRecord(childRecord);
-	} else {
+	if(!_PullFromBranch(op, 0)) {
 		// Failed to get data from first stream,
 		// try pulling other streams for data.
 		if(!_PullFromStreams(op)) return NULL;
@@ -108,6 +174,8 @@ static Record CartesianProductConsume(OpBase *opBase) {
 static OpResult CartesianProductReset(OpBase *opBase) {
 	CartesianProduct *op = (CartesianProduct *)opBase;
 	op->init = true;
+	// Children are reset, their records may differ.
+	if(op->branches) _ResetBranches(op);
 	return OP_OK;
 }
 
@@ -118,9 +186,13 @@ static OpBase *CartesianProductClone(const ExecutionPlan *plan, const OpBase *op
 
 static void CartesianProductFree(OpBase *opBase) {
 	CartesianProduct *op = (CartesianProduct *)opBase;
+	if(op->branches) {
+		for(int i = 0; i < op->op.childCount; i++) _FreeBranchRecords(op->branches + i);
+		rm_free(op->branches);
+		op->branches = NULL;
+	}
 	if(op->r) {
 		OpBase_DeleteRecord(op->r);
 		op->r = NULL;
 	}
 }
-
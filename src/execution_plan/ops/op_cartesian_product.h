@@ -9,11 +9,26 @@
 #include "op.h"
 #include "../execution_plan.h"
 
-/* Cartesian product AKA Join. */
+// Maximum number of records materialized per branch.
+#define CARTESIAN_PRODUCT_BUFFER_CAP 65536
+
+// A cartesian product child, replayed from memory once materialized.
+typedef struct {
+	Record *records;        // Buffered records, NULL for the last branch.
+	uint idx;               // Next buffered record to replay.
+	bool buffering;         // Records read from the branch are buffered.
+	bool materialized;      // Every record of the branch is buffered.
+} CartesianBranch;
+
+/* Cartesian product AKA Join.
+ * Every branch but the last is repeatedly reset, such branches are buffered
+ * as they are first read and replayed from memory afterwards.
+ * The branch estimated to produce the most records is the one read only once. */
 typedef struct {
 	OpBase op;
 	Record r;
 	bool init;
+	CartesianBranch *branches;  // Per child state.
 } CartesianProduct;
 
 OpBase *NewCartesianProductOp(const ExecutionPlan *plan);
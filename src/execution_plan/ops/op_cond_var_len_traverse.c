@@ -11,8 +11,11 @@
 #include "../../util/arr.h"
 #include "../../ast/ast.h"
 #include "../../arithmetic/arithmetic_expression.h"
+#include "../../ast/ast_build_ar_exp.h"
 #include "../../graph/graphcontext.h"
 #include "../../algorithms/all_paths.h"
+#include "../../algorithms/shortest_paths.h"
+#include "../../algorithms/reachable_nodes.h"
 #include "../../query_ctx.h"
 
 /* Forward declarations. */
@@ -50,6 +53,52 @@ static void _setupTraversedRelations(CondVarLenTraverse *op) {
 
 		op->edgeRelationCount = array_len(op->edgeRelationTypes);
 	}
+
+	// Evaluate inlined properties once, they are constant throughout the query.
+	uint filter_count = op->filterAttrs ? array_len(op->filterAttrs) : 0;
+	if(filter_count == 0) return;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	op->edgeFilters = array_new(AllPathsEdgeFilter, filter_count);
+	for(uint i = 0; i < filter_count; i++) {
+		AllPathsEdgeFilter filter;
+		filter.attr = GraphContext_GetAttributeID(gc, op->filterAttrs[i]);
+		filter.value = AR_EXP_Evaluate(op->filterValues[i], op->r);
+		SIValue_Persist(&filter.value);
+		op->edgeFilters = array_append(op->edgeFilters, filter);
+		// No edge holds an unknown attribute, no edge can be traversed.
+		if(filter.attr == ATTRIBUTE_NOTFOUND) op->edgeRelationCount = 0;
+	}
+}
+
+// Collects the inlined properties of the traversed edge, as in -[*1..3 {weight: 1}]->
+static void _setupEdgeFilters(CondVarLenTraverse *op, AST *ast) {
+	const char *alias = AlgebraicExpression_Edge(op->ae);
+	const cypher_astnode_t **rels = AST_GetTypedNodes(ast->root, CYPHER_AST_REL_PATTERN);
+	uint rel_count = array_len(rels);
+	for(uint i = 0; i < rel_count; i++) {
+		const cypher_astnode_t *rel = rels[i];
+		const char *rel_alias = AST_GetEntityName(ast, rel);
+		if(!rel_alias || strcmp(rel_alias, alias) != 0) continue;
+		const cypher_astnode_t *props = cypher_ast_rel_pattern_get_properties(rel);
+		if(!props) break;
+
+		uint nelems = cypher_ast_map_nentries(props);
+		op->filterAttrs = array_new(const char *, nelems);
+		op->filterValues = array_new(AR_ExpNode *, nelems);
+		for(uint j = 0; j < nelems; j++) {
+			const char *attr = cypher_ast_prop_name_get_value(cypher_ast_map_get_key(props, j));
+			op->filterAttrs = array_append(op->filterAttrs, attr);
+			op->filterValues = array_append(op->filterValues,
+											AR_EXP_FromExpression(cypher_ast_map_get_value(props, j)));
+		}
+		break;
+	}
+	array_free(rels);
+}
+
+// Restricts the paths context to edges matching inlined properties.
+static inline void _applyEdgeFilters(CondVarLenTraverse *op, AllPathsCtx *ctx) {
+	if(op->edgeFilters) AllPathsCtx_SetEdgeFilters(ctx, op->edgeFilters, array_len(op->edgeFilters));
 }
 
 // Set the traversal direction to match the traversed edge and AlgebraicExpression form.
@@ -76,7 +125,14 @@ void CondVarLenTraverseOp_ExpandInto(CondVarLenTraverse *op) {
 	op->op.name = "Conditional Variable Length Traverse (Expand Into)";
 }
 
-OpBase *NewCondVarLenTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpression *ae) {
+void CondVarLenTraverseOp_DistinctDestinations(CondVarLenTraverse *op) {
+	assert(op->edgesIdx == -1 && op->paths == QG_EDGE_PATHS_ALL && op->minHops <= 1 &&
+		   op->filterAttrs == NULL);
+	op->distinctDestinations = true;
+}
+
+static OpBase *_NewCondVarLenTraverseOp(const ExecutionPlan *plan, Graph *g,
+										 AlgebraicExpression *ae, bool populate_edges) {
 	assert(ae && g);
 
 	CondVarLenTraverse *op = rm_malloc(sizeof(CondVarLenTraverse));
@@ -85,7 +141,13 @@ OpBase *NewCondVarLenTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicEx
 	op->r = NULL;
 	op->expandInto = false;
 	op->allPathsCtx = NULL;
+	op->shortestPathsCtx = NULL;
 	op->edgeRelationTypes = NULL;
+	op->filterAttrs = NULL;
+	op->filterValues = NULL;
+	op->edgeFilters = NULL;
+	op->distinctDestinations = false;
+	op->destinations = NULL;
 
 	OpBase_Init((OpBase *)op, OPType_CONDITIONAL_VAR_LEN_TRAVERSE,
 				"Conditional Variable Length Traverse", NULL, CondVarLenTraverseConsume, CondVarLenTraverseReset,
@@ -94,22 +156,117 @@ OpBase *NewCondVarLenTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicEx
 	assert(OpBase_Aware((OpBase *)op, AlgebraicExpression_Source(ae), &op->srcNodeIdx));
 	op->destNodeIdx = OpBase_Modifies((OpBase *)op, AlgebraicExpression_Destination(ae));
 
-	// Populate edge value in record only if it is referenced.
-	AST *ast = QueryCtx_GetAST();
 	QGEdge *e = QueryGraph_GetEdgeByAlias(plan->query_graph, AlgebraicExpression_Edge(op->ae));
-	op->edgesIdx = AST_AliasIsReferenced(ast, e->alias) ? OpBase_Modifies((OpBase *)op, e->alias) : -1;
+	op->edgesIdx = populate_edges ? OpBase_Modifies((OpBase *)op, e->alias) : -1;
+	op->paths = e->paths;
+	op->minHops = e->minHops;
+	op->maxHops = e->maxHops;
 	_setTraverseDirection(op, e);
 
 	return (OpBase *)op;
 }
 
+OpBase *NewCondVarLenTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpression *ae) {
+	// Populate edge value in record only if it is referenced.
+	AST *ast = QueryCtx_GetAST();
+	bool populate_edges = AST_AliasIsReferenced(ast, AlgebraicExpression_Edge(ae));
+	CondVarLenTraverse *op = (CondVarLenTraverse *)_NewCondVarLenTraverseOp(plan, g, ae,
+																			 populate_edges);
+	_setupEdgeFilters(op, ast);
+	return (OpBase *)op;
+}
+
+// Produces the next path from the current source node.
+static inline Path *_NextPath(CondVarLenTraverse *op) {
+	if(op->paths == QG_EDGE_PATHS_ALL) return AllPathsCtx_NextPath(op->allPathsCtx);
+	return ShortestPathsCtx_NextPath(op->shortestPathsCtx);
+}
+
+// Releases the paths context of the current source node.
+static inline void _FreePathsCtx(CondVarLenTraverse *op) {
+	AllPathsCtx_Free(op->allPathsCtx);
+	op->allPathsCtx = NULL;
+	ShortestPathsCtx_Free(op->shortestPathsCtx);
+	op->shortestPathsCtx = NULL;
+}
+
+// Determine whether src is connected to itself by a path within hop limits.
+static bool _SourceReachesItself(CondVarLenTraverse *op, Node *src) {
+	if(op->minHops == 0) return true;
+	/* Frontiers may only lead back to the source by reusing an edge,
+	 * confirm a cycle through the source by searching for a single path. */
+	AllPathsCtx *ctx = AllPathsCtx_New(src, src, op->g, op->edgeRelationTypes, op->edgeRelationCount,
+									   op->traverseDir, op->minHops, op->maxHops);
+	_applyEdgeFilters(op, ctx);
+	bool reached = (AllPathsCtx_NextPath(ctx) != NULL);
+	AllPathsCtx_Free(ctx);
+	return reached;
+}
+
+// Collects the distinct destinations reachable from src, or dest if it is reachable.
+static IDSet *_CollectDestinations(CondVarLenTraverse *op, Node *src, Node *dest) {
+	IDSet *destinations = NULL;
+	if(op->maxHops > 0 && op->edgeRelationCount > 0) {
+		destinations = ReachableNodes(op->g, src, op->edgeRelationTypes, op->edgeRelationCount,
+									  op->traverseDir, op->maxHops);
+		// Aborted, the query's error is set.
+		if(!destinations) QueryCtx_RaiseRuntimeException();
+	} else {
+		destinations = IDSet_New();
+	}
+	if(_SourceReachesItself(op, src)) IDSet_Add(destinations, ENTITY_GET_ID(src));
+	if(!dest) return destinations;
+
+	// Expanding into a known destination, keep it alone if it was reached.
+	bool reached = IDSet_Contains(destinations, ENTITY_GET_ID(dest));
+	IDSet_Clear(destinations);
+	if(reached) IDSet_Add(destinations, ENTITY_GET_ID(dest));
+	return destinations;
+}
+
+static Record _ConsumeDistinctDestinations(CondVarLenTraverse *op) {
+	OpBase *child = op->op.children[0];
+
+	NodeID id;
+	while(!op->destinations || !IDSetIterator_Next(&op->destinationIter, &id)) {
+		Record childRecord = OpBase_Consume(child);
+		if(!childRecord) return NULL;
+
+		if(op->r) OpBase_DeleteRecord(op->r);
+		op->r = childRecord;
+
+		// Create edge relation type array on first call to consume.
+		if(!op->edgeRelationTypes) {
+			_setupTraversedRelations(op);
+			if(op->edgeRelationCount == 0 && op->minHops > 0) return NULL;
+		}
+
+		Node *destNode = NULL;
+		Node *srcNode = Record_GetNode(op->r, op->srcNodeIdx);
+		if(op->expandInto) destNode = Record_GetNode(op->r, op->destNodeIdx);
+
+		IDSet_Free(op->destinations);
+		op->destinations = _CollectDestinations(op, srcNode, destNode);
+		IDSet_Iterate(op->destinations, &op->destinationIter);
+	}
+
+	if(!op->expandInto) {
+		Node n;
+		Graph_GetNode(op->g, id, &n);
+		Record_AddNode(op->r, op->destNodeIdx, n);
+	}
+
+	return OpBase_CloneRecord(op->r);
+}
+
 static Record CondVarLenTraverseConsume(OpBase *opBase) {
 	CondVarLenTraverse *op = (CondVarLenTraverse *)opBase;
+	if(op->distinctDestinations) return _ConsumeDistinctDestinations(op);
 	OpBase *child = op->op.children[0];
 	bool reused_record = true;
 	Path *p = NULL;
 
-	while(!(p = AllPathsCtx_NextPath(op->allPathsCtx))) {
+	while(!(p = _NextPath(op))) {
 		reused_record = false;
 		Record childRecord = OpBase_Consume(child);
 		if(!childRecord) return NULL;
@@ -132,9 +289,18 @@ static Record CondVarLenTraverseConsume(OpBase *opBase) {
 		// The destination node is known in advance if we're performing an ExpandInto.
 		if(op->expandInto) destNode = Record_GetNode(op->r, op->destNodeIdx);
 
-		AllPathsCtx_Free(op->allPathsCtx);
-		op->allPathsCtx = AllPathsCtx_New(srcNode, destNode, op->g, op->edgeRelationTypes,
-										  op->edgeRelationCount, op->traverseDir, op->minHops, op->maxHops);
+		_FreePathsCtx(op);
+		if(op->paths == QG_EDGE_PATHS_ALL) {
+			op->allPathsCtx = AllPathsCtx_New(srcNode, destNode, op->g, op->edgeRelationTypes,
+											  op->edgeRelationCount, op->traverseDir, op->minHops, op->maxHops);
+			_applyEdgeFilters(op, op->allPathsCtx);
+		} else {
+			op->shortestPathsCtx = ShortestPathsCtx_New(srcNode, destNode, op->g, op->edgeRelationTypes,
+														op->edgeRelationCount, op->traverseDir, op->minHops, op->maxHops,
+														op->paths == QG_EDGE_PATHS_ALL_SHORTEST);
+			// Aborted, the query's error is set.
+			if(!op->shortestPathsCtx) QueryCtx_RaiseRuntimeException();
+		}
 
 	}
 
@@ -158,16 +324,35 @@ static OpResult CondVarLenTraverseReset(OpBase *ctx) {
 		OpBase_DeleteRecord(op->r);
 		op->r = NULL;
 	}
-	AllPathsCtx_Free(op->allPathsCtx);
-	op->allPathsCtx = NULL;
+	_FreePathsCtx(op);
+	if(op->destinations) {
+		IDSet_Free(op->destinations);
+		op->destinations = NULL;
+	}
 	return OP_OK;
 }
 
 static OpBase *CondVarLenTraverseClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	assert(opBase->type == OPType_CONDITIONAL_VAR_LEN_TRAVERSE);
 	CondVarLenTraverse *op = (CondVarLenTraverse *) opBase;
-	OpBase *op_clone = NewCondVarLenTraverseOp(plan, QueryCtx_GetGraph(),
-											   AlgebraicExpression_Clone(op->ae));
+	/* The clone is built outside of the AST segment the original was built from,
+	 * inherit whether edges are populated rather than consulting the AST. */
+	bool populate_edges = (op->edgesIdx != -1);
+	OpBase *op_clone = _NewCondVarLenTraverseOp(plan, QueryCtx_GetGraph(),
+												AlgebraicExpression_Clone(op->ae), populate_edges);
+	if(op->expandInto) CondVarLenTraverseOp_ExpandInto((CondVarLenTraverse *)op_clone);
+	if(op->distinctDestinations) {
+		CondVarLenTraverseOp_DistinctDestinations((CondVarLenTraverse *)op_clone);
+	}
+	if(op->filterAttrs) {
+		CondVarLenTraverse *clone = (CondVarLenTraverse *)op_clone;
+		uint filter_count = array_len(op->filterAttrs);
+		array_clone(clone->filterAttrs, op->filterAttrs);
+		clone->filterValues = array_new(AR_ExpNode *, filter_count);
+		for(uint i = 0; i < filter_count; i++) {
+			clone->filterValues = array_append(clone->filterValues, AR_EXP_Clone(op->filterValues[i]));
+		}
+	}
 	return op_clone;
 }
 
@@ -179,6 +364,25 @@ static void CondVarLenTraverseFree(OpBase *ctx) {
 		op->edgeRelationTypes = NULL;
 	}
 
+	if(op->filterAttrs) {
+		array_free(op->filterAttrs);
+		op->filterAttrs = NULL;
+	}
+
+	if(op->filterValues) {
+		uint filter_count = array_len(op->filterValues);
+		for(uint i = 0; i < filter_count; i++) AR_EXP_Free(op->filterValues[i]);
+		array_free(op->filterValues);
+		op->filterValues = NULL;
+	}
+
+	if(op->edgeFilters) {
+		uint filter_count = array_len(op->edgeFilters);
+		for(uint i = 0; i < filter_count; i++) SIValue_Free(op->edgeFilters[i].value);
+		array_free(op->edgeFilters);
+		op->edgeFilters = NULL;
+	}
+
 	if(op->ae) {
 		AlgebraicExpression_Free(op->ae);
 		op->ae = NULL;
@@ -189,9 +393,11 @@ static void CondVarLenTraverseFree(OpBase *ctx) {
 		op->r = NULL;
 	}
 
-	if(op->allPathsCtx) {
-		AllPathsCtx_Free(op->allPathsCtx);
-		op->allPathsCtx = NULL;
+	_FreePathsCtx(op);
+
+	if(op->destinations) {
+		IDSet_Free(op->destinations);
+		op->destinations = NULL;
 	}
 }
 
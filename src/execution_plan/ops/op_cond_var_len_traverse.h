@@ -10,6 +10,7 @@
 #include "../execution_plan.h"
 #include "../../graph/graph.h"
 #include "../../algorithms/algorithms.h"
+#include "../../util/id_set.h"
 #include "../../arithmetic/algebraic_expression.h"
 
 /* OP Traverse */
@@ -27,6 +28,14 @@ typedef struct {
 	int edgeRelationCount;          /* Length of edgeRelationTypes. */
 	int *edgeRelationTypes;         /* Relation(s) we're traversing. */
 	AllPathsCtx *allPathsCtx;
+	ShortestPathsCtx *shortestPathsCtx;
+	QGEdgePaths paths;              /* Paths to produce, all or shortest only. */
+	const char **filterAttrs;       /* Inlined properties traversed edges must match. */
+	AR_ExpNode **filterValues;      /* Values of filterAttrs. */
+	AllPathsEdgeFilter *edgeFilters;    /* Evaluated inlined properties. */
+	bool distinctDestinations;      /* Produce each reachable destination once, without paths. */
+	IDSet *destinations;            /* Destinations reached from the current source node. */
+	IDSetIterator destinationIter;  /* Position within destinations. */
 	GRAPH_EDGE_DIR traverseDir;     /* Traverse direction. */
 } CondVarLenTraverse;
 
@@ -36,3 +45,7 @@ OpBase *NewCondVarLenTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicEx
  * to Expand Into Conditional Variable Length Traverse */
 void CondVarLenTraverseOp_ExpandInto(CondVarLenTraverse *op);
 
+/* Produce each destination reachable from a source once rather than once per path,
+ * valid when paths aren't projected and duplicate records are discarded later on. */
+void CondVarLenTraverseOp_DistinctDestinations(CondVarLenTraverse *op);
+
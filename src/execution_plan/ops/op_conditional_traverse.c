@@ -7,9 +7,11 @@
 #include "op_conditional_traverse.h"
 #include "shared/print_functions.h"
 #include "../../util/arr.h"
+#include "../../util/matrix_pool.h"
 #include "../../GraphBLASExt/GxB_Delete.h"
 #include "../../arithmetic/arithmetic_expression.h"
 #include "../../query_ctx.h"
+#include "../../access_stats/access_stats.h"
 
 /* Forward declarations. */
 static Record CondTraverseConsume(OpBase *opBase);
@@ -29,6 +31,26 @@ static void _setupTraversedRelations(CondTraverse *op, QGEdge *e) {
 	}
 }
 
+/* The destination of a traversal needs no record entry when nothing reads it:
+ * it is not referenced by the query, no other edge of the pattern connects to it
+ * and the traversal doesn't collect edges, e.g. the anonymous node in
+ * MATCH (a)-[:R]->() RETURN a
+ * Dropping it narrows every record of the plan. */
+static bool _CondTraverse_DestinationUnused(CondTraverse *op, const AlgebraicExpression *ae) {
+	const ExecutionPlan *plan = op->op.plan;
+	if(AlgebraicExpression_Edge(ae)) return false;
+	if(!plan->query_graph) return false;
+
+	const char *dest = AlgebraicExpression_Destination(ae);
+	// Already bound, e.g. when the traversal acts as a label filter.
+	if(OpBase_Aware((OpBase *)op, dest, NULL)) return false;
+	if(AST_AliasIsReferenced(QueryCtx_GetAST(), dest)) return false;
+
+	QGNode *n = QueryGraph_GetNodeByAlias(plan->query_graph, dest);
+	if(!n) return false;
+	return (array_len(n->incoming_edges) + array_len(n->outgoing_edges)) == 1;
+}
+
 // Updates query graph edge.
 static int _CondTraverse_SetEdge(CondTraverse *op, Record r) {
 	// Consumed edges connecting current source and destination nodes.
@@ -82,32 +104,50 @@ static void _populate_filter_matrix(CondTraverse *op) {
 	}
 }
 
+// Count an access to each traversed relation type per source in the current batch.
+static void _touchRelations(CondTraverse *op) {
+	if(access_sample_rate == 0) return;
+	if(op->accessedRelations == NULL) {
+		// Resolve relation types on first use, relation types created later on aren't counted.
+		GraphContext *gc = QueryCtx_GetGraphCtx();
+		const char **relations = array_new(const char *, 1);
+		AlgebraicExpression_RelationTypes(op->ae, &relations);
+		op->accessedRelations = array_new(int, array_len(relations));
+		for(uint i = 0; i < array_len(relations); i++) {
+			Schema *s = GraphContext_GetSchema(gc, relations[i], SCHEMA_EDGE);
+			if(s) op->accessedRelations = array_append(op->accessedRelations, s->id);
+		}
+		array_free(relations);
+	}
+
+	uint count = array_len(op->accessedRelations);
+	for(int i = 0; i < op->recordsLen; i++) {
+		for(uint j = 0; j < count; j++) AccessStats_Touch(ACCESS_RELATION, op->accessedRelations[j]);
+	}
+}
+
 /* Evaluate algebraic expression:
- * prepends filter matrix as the left most operand
+ * populates filter matrix, the left most operand of the compiled expression
  * perform multiplications
  * set iterator over result matrix
- * removed filter matrix from original expression
  * clears filter matrix. */
 void _traverse(CondTraverse *op) {
 	// Create both filter and result matrices.
 	if(op->F == GrB_NULL) {
 		size_t required_dim = Graph_RequiredMatrixDim(op->graph);
-		GrB_Matrix_new(&op->M, GrB_BOOL, op->recordsCap, required_dim);
-		GrB_Matrix_new(&op->F, GrB_BOOL, op->recordsCap, required_dim);
+		op->M = MatrixPool_Acquire(op->recordsCap, required_dim);
+		op->F = MatrixPool_Acquire(op->recordsCap, required_dim);
 	}
 
 	// Populate filter matrix.
 	_populate_filter_matrix(op);
-	// Clone expression, as we're about to modify the structure with Optimize.
-	AlgebraicExpression *clone = AlgebraicExpression_Clone(op->ae);
-	// Prepend matrix to algebraic expression, as the left most operand.
-	AlgebraicExpression_MultiplyToTheLeft(&clone, op->F);
-	// TODO: consider performing optimization as part of evaluation.
-	AlgebraicExpression_Optimize(&clone);
-	// Evaluate expression.
-	AlgebraicExpression_Eval(clone, op->M);
-	// Free clone.
-	AlgebraicExpression_Free(clone);
+	// Evaluate expression, compiled by the first batch.
+	TraverseExpression_Eval(&op->expression, op->ae, op->F, op->M);
+
+	// Size the next batch by this batch's fan-out.
+	GrB_Index entries;
+	GrB_Matrix_nvals(&entries, op->M);
+	TraverseBatch_Observe(&op->batch, op->recordsLen, entries);
 
 	if(op->iter == NULL) GxB_MatrixTupleIter_new(&op->iter, op->M);
 	else GxB_MatrixTupleIter_reuse(op->iter, op->M);
@@ -117,7 +157,11 @@ void _traverse(CondTraverse *op) {
 }
 
 static inline int CondTraverseToString(const OpBase *ctx, char *buf, uint buf_len) {
-	return TraversalToString(ctx, buf, buf_len, ((const CondTraverse *)ctx)->ae);
+	const CondTraverse *op = (const CondTraverse *)ctx;
+	int offset = TraversalToString(ctx, buf, buf_len, op->ae);
+	// Profiled operations report their batch sizes.
+	if(ctx->stats) offset += TraverseBatch_ToString(&op->batch, buf + offset, buf_len - offset);
+	return offset;
 }
 
 OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpression *ae,
@@ -127,14 +171,23 @@ OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpressi
 	op->ae = ae;
 	op->r = NULL;
 	op->iter = NULL;
+	op->neighbors = NULL;
+	op->neighborCount = 0;
+	op->neighborIdx = 0;
+	op->supernode = false;
+	op->deferred = NULL;
+	op->splitSupernodes = SupernodeScan_Init(&op->supernodes, ae);
 	op->edges = NULL;
 	op->F = GrB_NULL;
 	op->M = GrB_NULL;
 	op->recordsLen = 0;
 	op->direction = GRAPH_EDGE_DIR_OUTGOING;
 	op->edgeRelationTypes = NULL;
+	op->accessedRelations = NULL;
 	op->recordsCap = records_cap;
 	op->records = rm_calloc(op->recordsCap, sizeof(Record));
+	TraverseBatch_Init(&op->batch, op->recordsCap);
+	TraverseExpression_Init(&op->expression);
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_CONDITIONAL_TRAVERSE, "Conditional Traverse", NULL,
@@ -142,7 +195,8 @@ OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpressi
 				false, plan);
 
 	assert(OpBase_Aware((OpBase *)op, AlgebraicExpression_Source(ae), &op->srcNodeIdx));
-	op->destNodeIdx = OpBase_Modifies((OpBase *)op, AlgebraicExpression_Destination(ae));
+	if(_CondTraverse_DestinationUnused(op, ae)) op->destNodeIdx = INVALID_INDEX;
+	else op->destNodeIdx = OpBase_Modifies((OpBase *)op, AlgebraicExpression_Destination(ae));
 
 	const char *edge = AlgebraicExpression_Edge(ae);
 	if(edge) {
@@ -164,6 +218,34 @@ OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpressi
 	return (OpBase *)op;
 }
 
+// Returns true if the record's source is traversed in a batch of its own.
+static bool _CondTraverse_Supernode(CondTraverse *op, Record r) {
+	if(!op->splitSupernodes) return false;
+	Node *src = Record_GetNode(r, op->srcNodeIdx);
+	return SupernodeScan_Degree(&op->supernodes, ENTITY_GET_ID(src)) >= SUPERNODE_SCAN_DEGREE;
+}
+
+// Retrieves the next destination of the current batch, returns false once the batch is depleted.
+static bool _CondTraverse_NextDestination(CondTraverse *op, NodeID *dest) {
+	if(op->supernode) {
+		op->srcRow = 0;
+		return SupernodeScan_Next(&op->supernodes, dest);
+	}
+
+	while(op->neighborIdx == op->neighborCount) {
+		// Pull the next row of M, sliced in place.
+		bool depleted = true;
+		op->neighborIdx = 0;
+		op->neighborCount = 0;
+		if(op->iter) GxB_MatrixTupleIter_next_row(op->iter, &op->srcRow, &op->neighbors, NULL,
+												  &op->neighborCount, &depleted);
+		if(depleted) return false;
+	}
+
+	*dest = op->neighbors[op->neighborIdx++];
+	return true;
+}
+
 /* CondTraverseConsume next operation
  * each call will update the graph
  * returns OP_DEPLETED when no additional updates are available */
@@ -175,40 +257,56 @@ static Record CondTraverseConsume(OpBase *opBase) {
 	 * Otherwise, try to get a new pair of source and destination nodes. */
 	if(op->setEdge && _CondTraverse_SetEdge(op, op->r)) return OpBase_CloneRecord(op->r);
 
-	bool depleted = true;
-	NodeID src_id = INVALID_ENTITY_ID;
-	NodeID dest_id = INVALID_ENTITY_ID;
-
-	while(true) {
-		if(op->iter) GxB_MatrixTupleIter_next(op->iter, &src_id, &dest_id, &depleted);
-
-		// Managed to get a tuple, break.
-		if(!depleted) break;
-
+	NodeID dest_id;
+	while(!_CondTraverse_NextDestination(op, &dest_id)) {
 		/* Run out of tuples, try to get new data.
 		 * Free old records. */
+		QueryCtx_CheckTimeout(opBase);
 		op->r = NULL;
+		op->supernode = false;
 		for(int i = 0; i < op->recordsLen; i++) OpBase_DeleteRecord(op->records[i]);
 
-		// Ask child operations for data.
-		for(op->recordsLen = 0; op->recordsLen < op->recordsCap; op->recordsLen++) {
-			Record childRecord = OpBase_Consume(child);
-			if(!childRecord) break;
-			// Store received record.
-			Record_PersistScalars(childRecord);
+		// Ask child operations for data, starting with a deferred high degree source.
+		for(op->recordsLen = 0; op->recordsLen < op->batch.size; op->recordsLen++) {
+			Record childRecord = op->deferred;
+			op->deferred = NULL;
+			if(!childRecord) {
+				childRecord = OpBase_Consume(child);
+				if(!childRecord) break;
+				// Store received record.
+				Record_PersistScalars(childRecord);
+			}
+
+			if(_CondTraverse_Supernode(op, childRecord)) {
+				// High degree sources are traversed in a batch of their own.
+				if(op->recordsLen > 0) {
+					op->deferred = childRecord;
+					break;
+				}
+				op->records[0] = childRecord;
+				op->recordsLen = 1;
+				op->supernode = true;
+				Node *src = Record_GetNode(childRecord, op->srcNodeIdx);
+				SupernodeScan_Start(&op->supernodes, ENTITY_GET_ID(src));
+				break;
+			}
 			op->records[op->recordsLen] = childRecord;
 		}
 
 		// No data.
 		if(op->recordsLen == 0) return NULL;
 
-		_traverse(op);
+		_touchRelations(op);
+		if(!op->supernode) _traverse(op);
 	}
 
 	/* Get node from current column. */
-	op->r = op->records[src_id];
-	Node *destNode = Record_GetNode(op->r, op->destNodeIdx);
-	Graph_GetNode(op->graph, dest_id, destNode);
+	op->r = op->records[op->srcRow];
+	AccessStats_Touch(ACCESS_NODE, dest_id);
+	if(op->destNodeIdx != INVALID_INDEX) {
+		Node *destNode = Record_GetNode(op->r, op->destNodeIdx);
+		Graph_GetNode(op->graph, dest_id, destNode);
+	}
 
 	if(op->setEdge) {
 		_CondTraverse_CollectEdges(op, op->destNodeIdx, op->srcNodeIdx);
@@ -227,6 +325,14 @@ static OpResult CondTraverseReset(OpBase *ctx) {
 	op->r = NULL;
 	for(int i = 0; i < op->recordsLen; i++) OpBase_DeleteRecord(op->records[i]);
 	op->recordsLen = 0;
+	op->neighborCount = 0;
+	op->neighborIdx = 0;
+	op->supernode = false;
+	if(op->deferred) {
+		OpBase_DeleteRecord(op->deferred);
+		op->deferred = NULL;
+	}
+	SupernodeScan_Reset(&op->supernodes);
 
 	if(op->edges) array_clear(op->edges);
 	if(op->iter) {
@@ -252,16 +358,18 @@ static void CondTraverseFree(OpBase *ctx) {
 		op->iter = NULL;
 	}
 
-	if(op->F != GrB_NULL) {
-		GrB_Matrix_free(&op->F);
-		op->F = GrB_NULL;
-	}
+	TraverseExpression_Free(&op->expression);
+	SupernodeScan_Free(&op->supernodes);
 
-	if(op->M != GrB_NULL) {
-		GrB_Matrix_free(&op->M);
-		op->M = GrB_NULL;
+	if(op->deferred) {
+		OpBase_DeleteRecord(op->deferred);
+		op->deferred = NULL;
 	}
 
+	// Matrices are retained for reuse by later traversals.
+	MatrixPool_Release(&op->F);
+	MatrixPool_Release(&op->M);
+
 	if(op->edges) {
 		array_free(op->edges);
 		op->edges = NULL;
@@ -277,6 +385,11 @@ static void CondTraverseFree(OpBase *ctx) {
 		op->edgeRelationTypes = NULL;
 	}
 
+	if(op->accessedRelations) {
+		array_free(op->accessedRelations);
+		op->accessedRelations = NULL;
+	}
+
 	if(op->records) {
 		for(int i = 0; i < op->recordsLen; i++) OpBase_DeleteRecord(op->records[i]);
 		rm_free(op->records);
@@ -7,6 +7,9 @@
 #pragma once
 
 #include "op.h"
+#include "shared/traverse_batch.h"
+#include "shared/supernode_scan.h"
+#include "shared/traverse_expression.h"
 #include "../execution_plan.h"
 #include "../../arithmetic/algebraic_expression.h"
 #include "../../../deps/GraphBLAS/Include/GraphBLAS.h"
@@ -20,20 +23,31 @@ typedef struct {
 	int destNodeIdx;            // Index into record.
 	int *edgeRelationTypes;     // One or more relation types.
 	int edgeRelationCount;      // length of edgeRelationTypes.
+	int *accessedRelations;     // Relation types traversed, resolved once accesses are sampled.
 	GrB_Matrix F;               // Filter matrix.
 	GrB_Matrix M;               // Algebraic expression result.
 	bool setEdge;               // Edge needs to be set.
 	Edge *edges;                // Discovered edges.
 	GxB_MatrixTupleIter *iter;  // Iterator over M.
+	const GrB_Index *neighbors; // Destinations of the current row of M.
+	GrB_Index neighborCount;    // Length of neighbors.
+	GrB_Index neighborIdx;      // Next destination in neighbors.
+	GrB_Index srcRow;           // Current row of M, index into records.
+	SupernodeScan supernodes;   // Traverses high degree sources on their own.
+	bool splitSupernodes;       // Expression supports traversing high degree sources on their own.
+	bool supernode;             // Current batch is a single high degree source.
+	Record deferred;            // High degree source record awaiting its own batch.
 	int edgeRecIdx;             // Index into record.
 	int recordsCap;             // Max number of records to process.
 	int recordsLen;             // Number of records to process.
+	TraverseBatch batch;        // Number of records processed at a time.
+	TraverseExpression expression;  // F * (ae), compiled by the first batch.
 	GRAPH_EDGE_DIR direction;   // The direction of the referenced edge being traversed.
 	Record *records;            // Array of records.
 	Record r;                   // Current selected record.
 } CondTraverse;
 
-/* Creates a new Traverse operation */
+/* Creates a new Traverse operation, processing up to records_cap records at a time */
 OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpression *ae,
 						  uint records_cap);
 
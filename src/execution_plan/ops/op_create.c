@@ -5,10 +5,14 @@
 */
 
 #include "op_create.h"
+#include "op_unwind.h"
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
 #include "../../schema/schema.h"
+#include "../../datatypes/array.h"
 #include <assert.h>
+#include <string.h>
+#include <strings.h>
 #include "../../query_ctx.h"
 
 /* Forward declarations. */
@@ -90,12 +94,158 @@ static void _CreateEdges(OpCreate *op, Record r) {
 
 		/* Save edge for later insertion. */
 		op->pending.created_edges = array_append(op->pending.created_edges, newEdge);
+		op->pending.edge_srcs = array_append(op->pending.edge_srcs, src_node);
+		op->pending.edge_dests = array_append(op->pending.edge_dests, dest_node);
 
 		/* Save properties to insert with node. */
 		op->pending.edge_properties = array_append(op->pending.edge_properties, converted_properties);
 	}
 }
 
+// Sources of the property values of nodes created from an UNWIND list element.
+typedef enum {
+	ROW_CONSTANT,   // Constant value.
+	ROW_ELEMENT,    // The list element.
+	ROW_SUBSCRIPT,  // Item of the list element at a constant index.
+} RowAccessorType;
+
+typedef struct {
+	RowAccessorType type;
+	SIValue constant;   // Value of a constant accessor.
+	int64_t index;      // Index of a subscript accessor.
+} RowAccessor;
+
+static inline bool _IsListElement(const AR_ExpNode *exp, const char *alias) {
+	return exp->type == AR_EXP_OPERAND && exp->operand.type == AR_EXP_VARIADIC &&
+		   exp->operand.variadic.entity_prop == NULL &&
+		   strcmp(exp->operand.variadic.entity_alias, alias) == 0;
+}
+
+/* Resolve the accessor of a property value, taken from the list element alias,
+ * returns false if the value is computed by any other expression. */
+static bool _RowAccessor_Resolve(const AR_ExpNode *exp, const char *alias, RowAccessor *accessor) {
+	if(AR_EXP_IsConstant(exp)) {
+		accessor->type = ROW_CONSTANT;
+		accessor->constant = exp->operand.constant;
+		return true;
+	}
+	if(_IsListElement(exp, alias)) {
+		accessor->type = ROW_ELEMENT;
+		return true;
+	}
+	if(exp->type == AR_EXP_OP && exp->op.child_count == 2 &&
+	   strcasecmp(exp->op.func_name, "subscript") == 0 &&
+	   _IsListElement(exp->op.children[0], alias) && AR_EXP_IsConstant(exp->op.children[1]) &&
+	   SI_TYPE(exp->op.children[1]->operand.constant) == T_INT64) {
+		accessor->type = ROW_SUBSCRIPT;
+		accessor->index = exp->op.children[1]->operand.constant.longval;
+		return true;
+	}
+	return false;
+}
+
+// Retrieve a property value of the node created from list element row, shared with row.
+static inline SIValue _RowAccessor_Get(const RowAccessor *accessor, SIValue row) {
+	switch(accessor->type) {
+	case ROW_CONSTANT:
+		return accessor->constant;
+	case ROW_ELEMENT:
+		return row;
+	default: {
+		int64_t len = SIArray_Length(row);
+		int64_t index = accessor->index;
+		if(index < 0) index += len;
+		if(index < 0 || index >= len) return SI_NullVal();
+		return SIArray_Get(row, index);
+	}
+	}
+}
+
+/* Queries ingesting a list of rows, such as
+ * UNWIND $rows AS r CREATE (:N {id: r[0], name: r[1]})
+ * create nodes directly from the elements of the UNWIND list,
+ * rather than through a record per element evaluating each property expression.
+ * Applies when no operation consumes the created records, only nodes are created
+ * and every property is either constant, the list element or one of its items.
+ * Property values are shared with the list, which outlives the commit.
+ * Returns false if the query doesn't follow the pattern. */
+static bool _CreateFromList(OpCreate *op) {
+	OpBase *opBase = (OpBase *)op;
+	if(opBase->parent || opBase->childCount != 1) return false;
+	if(array_len(op->pending.edges_to_create) > 0) return false;
+	OpBase *child = opBase->children[0];
+	// The list of an UNWIND without child operations is evaluated once initialized.
+	if(child->type != OPType_UNWIND || child->childCount != 0) return false;
+
+	OpUnwind *unwind = (OpUnwind *)child;
+	const char *alias = unwind->exp->resolved_name;
+	SIValue list = unwind->list;
+	uint row_count = SIArray_Length(list);
+	NodeCreateCtx *blueprints = op->pending.nodes_to_create;
+	uint blueprint_count = array_len(blueprints);
+
+	uint property_count = 0;
+	for(uint i = 0; i < blueprint_count; i++) {
+		if(blueprints[i].properties) property_count += blueprints[i].properties->property_count;
+	}
+
+	bool subscripts = false;
+	RowAccessor accessors[property_count + 1];
+	for(uint i = 0, k = 0; i < blueprint_count; i++) {
+		PropertyMap *map = blueprints[i].properties;
+		if(map == NULL) continue;
+		for(int j = 0; j < map->property_count; j++, k++) {
+			if(!_RowAccessor_Resolve(map->values[j], alias, accessors + k)) return false;
+			subscripts |= (accessors[k].type == ROW_SUBSCRIPT);
+		}
+	}
+	// Subscripting any other value is an error, reported by evaluating the expression.
+	if(subscripts) {
+		for(uint i = 0; i < row_count; i++) {
+			if(SI_TYPE(SIArray_Get(list, i)) != T_ARRAY) return false;
+		}
+	}
+
+	uint node_count = row_count * blueprint_count;
+	op->nodes = rm_malloc(sizeof(Node) * (node_count + 1));
+	op->props = rm_malloc(sizeof(PendingProperties) * (node_count + 1));
+	op->values = rm_malloc(sizeof(SIValue) * (row_count * property_count + 1));
+	array_free(op->pending.created_nodes);
+	array_free(op->pending.node_properties);
+	op->pending.created_nodes = array_new(Node *, node_count);
+	op->pending.node_properties = array_new(PendingProperties *, node_count);
+
+	SIValue *values = op->values;
+	for(uint i = 0; i < row_count; i++) {
+		SIValue row = SIArray_Get(list, i);
+		const RowAccessor *accessor = accessors;
+		for(uint j = 0; j < blueprint_count; j++) {
+			QGNode *blueprint = blueprints[j].node;
+			Node *n = op->nodes + (i * blueprint_count + j);
+			n->entity = NULL;
+			n->label = blueprint->label;
+			n->labelID = blueprint->labelID;
+
+			PendingProperties *props = NULL;
+			PropertyMap *map = blueprints[j].properties;
+			if(map) {
+				props = op->props + (i * blueprint_count + j);
+				props->attr_keys = map->keys;
+				props->property_count = map->property_count;
+				props->values = values;
+				for(int k = 0; k < map->property_count; k++) {
+					values[k] = _RowAccessor_Get(accessor++, row);
+				}
+				values += map->property_count;
+			}
+
+			op->pending.created_nodes = array_append(op->pending.created_nodes, n);
+			op->pending.node_properties = array_append(op->pending.node_properties, props);
+		}
+	}
+	return true;
+}
+
 // Return mode, emit a populated Record.
 static Record _handoff(OpCreate *op) {
 	Record r = NULL;
@@ -113,6 +263,12 @@ static Record CreateConsume(OpBase *opBase) {
 	// Consume mode.
 	op->records = array_new(Record, 32);
 
+	// Nodes created from an UNWIND list produce no records.
+	if(_CreateFromList(op)) {
+		CommitNewEntities(opBase, &op->pending);
+		return NULL;
+	}
+
 	OpBase *child = NULL;
 	if(!op->op.childCount) {
 		// No child operation to call.
@@ -168,6 +324,17 @@ static void CreateFree(OpBase *ctx) {
 		op->records = NULL;
 	}
 
+	// Properties of nodes created from an UNWIND list are shared with the list.
+	if(op->nodes) {
+		array_clear(op->pending.node_properties);
+		rm_free(op->nodes);
+		rm_free(op->props);
+		rm_free(op->values);
+		op->nodes = NULL;
+		op->props = NULL;
+		op->values = NULL;
+	}
+
 	PendingCreationsFree(&op->pending);
 }
 
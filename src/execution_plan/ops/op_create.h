@@ -19,6 +19,9 @@ typedef struct {
 	OpBase op;                 // The base operation.
 	Record *records;           // Array of Records created by this operation.
 	PendingCreations pending;  // Container struct for all graph changes to be committed.
+	Node *nodes;               // Nodes created from an UNWIND list, see _CreateFromList.
+	PendingProperties *props;  // Properties of nodes created from an UNWIND list.
+	SIValue *values;           // Property values of nodes created from an UNWIND list.
 } OpCreate;
 
 OpBase *NewCreateOp(const ExecutionPlan *plan, NodeCreateCtx *nodes, EdgeCreateCtx *edges);
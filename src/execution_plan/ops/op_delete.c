@@ -6,7 +6,9 @@
 
 #include "./op_delete.h"
 #include "../../util/arr.h"
+#include "../../util/qsort.h"
 #include "../../query_ctx.h"
+#include "../../change_feed/change_feed.h"
 #include "../../arithmetic/arithmetic_expression.h"
 #include <assert.h>
 
@@ -15,6 +17,36 @@ static Record DeleteConsume(OpBase *opBase);
 static OpBase *DeleteClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void DeleteFree(OpBase *opBase);
 
+/* Account for deleted nodes in label statistics,
+ * nodes are sorted such that a node deleted multiple times is accounted for once. */
+static void _RemoveNodesFromStatistics(OpDelete *op, uint node_count) {
+#define is_node_lt(a, b) (ENTITY_GET_ID((a)) < ENTITY_GET_ID((b)))
+	QSORT(Node, op->deleted_nodes, node_count, is_node_lt);
+	for(uint i = 0; i < node_count; i++) {
+		Node *n = op->deleted_nodes + i;
+		if(i > 0 && ENTITY_GET_ID(n) == ENTITY_GET_ID(n - 1)) continue;
+		GraphContext_RemoveNodeFromStatistics(op->gc, n);
+	}
+}
+
+/* Capture the deletions for the graph's change stream, nodes are expected to be sorted,
+ * edges are sorted such that an edge deleted multiple times is captured once. */
+static void _CaptureDeletions(OpDelete *op, uint node_count, uint edge_count) {
+	if(op->gc->changes == NULL) return;
+	for(uint i = 0; i < node_count; i++) {
+		Node *n = op->deleted_nodes + i;
+		if(i > 0 && ENTITY_GET_ID(n) == ENTITY_GET_ID(n - 1)) continue;
+		ChangeFeed_NodeDeleted(n);
+	}
+#define is_edge_lt(a, b) (ENTITY_GET_ID((a)) < ENTITY_GET_ID((b)))
+	QSORT(Edge, op->deleted_edges, edge_count, is_edge_lt);
+	for(uint i = 0; i < edge_count; i++) {
+		Edge *e = op->deleted_edges + i;
+		if(i > 0 && ENTITY_GET_ID(e) == ENTITY_GET_ID(e - 1)) continue;
+		ChangeFeed_EdgeDeleted(e);
+	}
+}
+
 void _DeleteEntities(OpDelete *op) {
 	Graph *g = op->gc->g;
 	uint node_deleted = 0;
@@ -33,8 +65,15 @@ void _DeleteEntities(OpDelete *op) {
 			Node *n = op->deleted_nodes + i;
 			GraphContext_DeleteNodeFromIndices(op->gc, n);
 		}
+		for(int i = 0; i < edge_count; i++) {
+			Edge *e = op->deleted_edges + i;
+			GraphContext_DeleteEdgeFromIndices(op->gc, e);
+		}
 	}
 
+	if(node_count > 0) _RemoveNodesFromStatistics(op, node_count);
+	_CaptureDeletions(op, node_count, edge_count);
+
 	Graph_BulkDelete(g, op->deleted_nodes, node_count, op->deleted_edges,
 					 edge_count, &node_deleted, &relationships_deleted);
 
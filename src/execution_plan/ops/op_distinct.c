@@ -7,19 +7,193 @@
 #include "op_distinct.h"
 #include "xxhash.h"
 #include "../../util/arr.h"
+#include "../../util/rmalloc.h"
+#include "../../query_ctx.h"
+
+// Number of partitions records are spilled to once fingerprints exceed memory.
+#define DISTINCT_PARTITION_BITS 4
+#define DISTINCT_PARTITION_COUNT (1 << DISTINCT_PARTITION_BITS)
+
+// Bytes fingerprints may occupy before spilling, 0 never spills.
+extern long long distinct_spill_threshold;
 
 /* Forward declarations. */
 static Record DistinctConsume(OpBase *opBase);
 static OpBase *DistinctClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void DistinctFree(OpBase *opBase);
 
-OpBase *NewDistinctOp(const ExecutionPlan *plan) {
+static void _FingerprintSet_Init(FingerprintSet *set) {
+	set->mask = 15;
+	set->count = 0;
+	set->slots = rm_calloc(set->mask + 1, sizeof(uint64_t));
+}
+
+static void _FingerprintSet_Free(FingerprintSet *set) {
+	if(set->slots) rm_free(set->slots);
+	set->slots = NULL;
+}
+
+// Returns the slot holding fingerprint, or the empty slot it belongs in.
+static inline uint64_t *_FingerprintSet_Find(const FingerprintSet *set, uint64_t fingerprint) {
+	uint64_t i = fingerprint & set->mask;
+	while(set->slots[i] && set->slots[i] != fingerprint) i = (i + 1) & set->mask;
+	return set->slots + i;
+}
+
+// Bytes held by the set once it holds another fingerprint.
+static inline size_t _FingerprintSet_NextFootprint(const FingerprintSet *set) {
+	uint64_t slots = set->mask + 1;
+	// Sets are kept at most half full.
+	if((set->count + 1) * 2 > slots) slots *= 2;
+	return slots * sizeof(uint64_t);
+}
+
+static void _FingerprintSet_Insert(FingerprintSet *set, uint64_t *slot, uint64_t fingerprint) {
+	*slot = fingerprint;
+	set->count++;
+	if(set->count * 2 <= set->mask + 1) return;
+
+	// Double slots, rehashing fingerprints.
+	uint64_t *slots = set->slots;
+	uint64_t slot_count = set->mask + 1;
+	set->mask = slot_count * 2 - 1;
+	set->slots = rm_calloc(slot_count * 2, sizeof(uint64_t));
+	for(uint64_t i = 0; i < slot_count; i++) {
+		if(slots[i]) *_FingerprintSet_Find(set, slots[i]) = slots[i];
+	}
+	rm_free(slots);
+}
+
+// Fingerprints the record's projected aliases, never 0.
+static uint64_t _Distinct_Fingerprint(const OpDistinct *op, Record r) {
+	uint64_t fingerprint;
+	if(!op->aliases) {
+		fingerprint = Record_Hash64(r);
+	} else {
+		XXH64_state_t state;
+		XXH_errorcode res = XXH64_reset(&state, 0);
+		assert(res != XXH_ERROR);
+		uint alias_count = array_len(op->offsets);
+		for(uint i = 0; i < alias_count; i++) {
+			int idx = op->offsets[i];
+			XXH64_hash_t hash = 0;
+			if(Record_GetType(r, idx) != REC_TYPE_UNKNOWN) hash = SIValue_HashCode(Record_Get(r, idx));
+			XXH64_update(&state, &hash, sizeof(hash));
+		}
+		fingerprint = XXH64_digest(&state);
+	}
+	return fingerprint ? fingerprint : 1;
+}
+
+static bool _Distinct_CreatePartitions(OpDistinct *op) {
+	op->partitions = array_new(RecordSpill *, DISTINCT_PARTITION_COUNT);
+	for(uint i = 0; i < DISTINCT_PARTITION_COUNT; i++) {
+		RecordSpill *spill = RecordSpill_New();
+		if(!spill) return false;
+		op->partitions = array_append(op->partitions, spill);
+	}
+	return true;
+}
+
+static void _Distinct_FreePartitions(OpDistinct *op) {
+	if(!op->partitions) return;
+	uint count = array_len(op->partitions);
+	for(uint i = 0; i < count; i++) {
+		if(op->partitions[i]) RecordSpill_Free(op->partitions[i]);
+	}
+	array_free(op->partitions);
+	op->partitions = NULL;
+}
+
+/* Spills r to its fingerprint's partition, the fingerprints of
+ * emitted records no longer fit in memory. Returns false if r wasn't spilled. */
+static bool _Distinct_Spill(OpDistinct *op, Record r, uint64_t fingerprint) {
+	if(op->spill_failed) return false;
+	if(!op->partitions && !_Distinct_CreatePartitions(op)) {
+		_Distinct_FreePartitions(op);
+		op->spill_failed = true;
+		return false;
+	}
+
+	RecordSpill *partition = op->partitions[fingerprint >> (64 - DISTINCT_PARTITION_BITS)];
+	if(!RecordSpill_Write(partition, r)) {
+		char *error;
+		asprintf(&error, "Failed to spill distinct records to a temporary file");
+		QueryCtx_SetError(error);
+		QueryCtx_RaiseRuntimeException();
+	}
+	OpBase_DeleteRecord(r);
+	return true;
+}
+
+/* Prepares partitions for reading once every in memory record was emitted.
+ * Spilled fingerprints were never emitted, emitted fingerprints are discarded. */
+static void _Distinct_RewindPartitions(OpDistinct *op) {
+	uint partition_count = array_len(op->partitions);
+	for(uint i = 0; i < partition_count; i++) {
+		if(!RecordSpill_Rewind(op->partitions[i])) {
+			char *error;
+			asprintf(&error, "Failed to read back records spilled by DISTINCT");
+			QueryCtx_SetError(error);
+			QueryCtx_RaiseRuntimeException();
+		}
+	}
+	_FingerprintSet_Free(&op->found);
+	_FingerprintSet_Init(&op->found);
+}
+
+// Emits spilled records, a partition at a time, each deduplicated by its own set.
+static Record _Distinct_EmitPartitions(OpDistinct *op) {
+	uint partition_count = array_len(op->partitions);
+	while(op->partition < partition_count) {
+		RecordSpill *partition = op->partitions[op->partition];
+		Record r = OpBase_CreateRecord((OpBase *)op);
+		if(!RecordSpill_Read(partition, r)) {
+			OpBase_DeleteRecord(r);
+			RecordSpill_Free(partition);
+			op->partitions[op->partition] = NULL;
+			op->partition++;
+			// Partitions hold disjoint fingerprints.
+			_FingerprintSet_Free(&op->found);
+			_FingerprintSet_Init(&op->found);
+			continue;
+		}
+
+		uint64_t fingerprint = _Distinct_Fingerprint(op, r);
+		uint64_t *slot = _FingerprintSet_Find(&op->found, fingerprint);
+		if(*slot == 0) {
+			_FingerprintSet_Insert(&op->found, slot, fingerprint);
+			return r;
+		}
+		OpBase_DeleteRecord(r);
+	}
+	return NULL;
+}
+
+OpBase *NewDistinctOp(const ExecutionPlan *plan, const char **aliases, uint alias_count) {
 	OpDistinct *op = rm_malloc(sizeof(OpDistinct));
-	op->found = raxNew();
+	op->aliases = NULL;
+	op->offsets = NULL;
+	op->partitions = NULL;
+	op->partition = 0;
+	op->depleted = false;
+	op->spill_failed = false;
+	_FingerprintSet_Init(&op->found);
 
 	OpBase_Init((OpBase *)op, OPType_DISTINCT, "Distinct", NULL, DistinctConsume,
 				NULL, NULL, DistinctClone, DistinctFree, false, plan);
 
+	if(aliases) {
+		op->aliases = array_new(const char *, alias_count);
+		op->offsets = array_new(uint, alias_count);
+		for(uint i = 0; i < alias_count; i++) {
+			int record_idx;
+			assert(OpBase_Aware((OpBase *)op, aliases[i], &record_idx));
+			op->aliases = array_append(op->aliases, aliases[i]);
+			op->offsets = array_append(op->offsets, record_idx);
+		}
+	}
+
 	return (OpBase *)op;
 }
 
@@ -27,27 +201,51 @@ static Record DistinctConsume(OpBase *opBase) {
 	OpDistinct *self = (OpDistinct *)opBase;
 	OpBase *child = self->op.children[0];
 
-	while(true) {
+	while(!self->depleted) {
 		Record r = OpBase_Consume(child);
-		if(!r) return NULL;
+		if(!r) {
+			self->depleted = true;
+			if(self->partitions) _Distinct_RewindPartitions(self);
+			break;
+		}
 
-		unsigned long long const hash = Record_Hash64(r);
-		int is_new = raxInsert(self->found, (unsigned char *) &hash, sizeof(hash), NULL, NULL);
-		if(is_new) return r;
-		OpBase_DeleteRecord(r);
+		uint64_t fingerprint = _Distinct_Fingerprint(self, r);
+		uint64_t *slot = _FingerprintSet_Find(&self->found, fingerprint);
+		if(*slot) {
+			OpBase_DeleteRecord(r);
+			continue;
+		}
+
+		// Spill once fingerprints exceed memory, emitted fingerprints are still filtered.
+		if(distinct_spill_threshold &&
+		   _FingerprintSet_NextFootprint(&self->found) > distinct_spill_threshold &&
+		   _Distinct_Spill(self, r, fingerprint)) continue;
+
+		_FingerprintSet_Insert(&self->found, slot, fingerprint);
+		return r;
 	}
+
+	if(!self->partitions) return NULL;
+	return _Distinct_EmitPartitions(self);
 }
 
 static inline OpBase *DistinctClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	assert(opBase->type == OPType_DISTINCT);
-	return NewDistinctOp(plan);
+	const OpDistinct *op = (const OpDistinct *)opBase;
+	uint alias_count = op->aliases ? array_len(op->aliases) : 0;
+	return NewDistinctOp(plan, op->aliases, alias_count);
 }
 
 static void DistinctFree(OpBase *ctx) {
 	OpDistinct *op = (OpDistinct *)ctx;
-	if(op->found) {
-		raxFree(op->found);
-		op->found = NULL;
+	_FingerprintSet_Free(&op->found);
+	_Distinct_FreePartitions(op);
+	if(op->aliases) {
+		array_free(op->aliases);
+		op->aliases = NULL;
+	}
+	if(op->offsets) {
+		array_free(op->offsets);
+		op->offsets = NULL;
 	}
 }
-
@@ -7,12 +7,27 @@
 #pragma once
 
 #include "op.h"
-#include "rax.h"
 #include "../execution_plan.h"
+#include "shared/record_spill.h"
+
+// Open addressing set of record fingerprints, 0 marks an empty slot.
+typedef struct {
+	uint64_t *slots;    // Fingerprint slots, a power of 2 of them.
+	uint64_t mask;      // Number of slots - 1.
+	uint64_t count;     // Number of fingerprints held.
+} FingerprintSet;
 
 typedef struct {
 	OpBase op;
-	rax *found;
+	const char **aliases;       // Projected aliases records are distinct by, NULL for entire records.
+	uint *offsets;              // Record offsets of projected aliases.
+	FingerprintSet found;       // Fingerprints of emitted records.
+	RecordSpill **partitions;   // Records not fitting in memory, partitioned by fingerprint.
+	uint partition;             // Partition being emitted, once child is depleted.
+	bool depleted;              // Child has no more records.
+	bool spill_failed;          // Partitions couldn't be created, keep every fingerprint in memory.
 } OpDistinct;
 
-OpBase *NewDistinctOp(const ExecutionPlan *plan);
+/* Emits records whose projected aliases were not seen before,
+ * as soon as they are first seen. If aliases is NULL entire records are compared. */
+OpBase *NewDistinctOp(const ExecutionPlan *plan, const char **aliases, uint alias_count);
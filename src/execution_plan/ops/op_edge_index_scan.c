@@ -0,0 +1,96 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "op_edge_index_scan.h"
+#include "../../util/arr.h"
+#include "../../query_ctx.h"
+
+/* Forward declarations. */
+static Record EdgeIndexScanConsume(OpBase *opBase);
+static OpResult EdgeIndexScanReset(OpBase *opBase);
+static void EdgeIndexScanFree(OpBase *opBase);
+
+static int EdgeIndexScanToString(const OpBase *ctx, char *buf, uint buf_len) {
+	const EdgeIndexScan *op = (const EdgeIndexScan *)ctx;
+	int offset = snprintf(buf, buf_len, "%s | ", ctx->name);
+	offset += QGNode_ToString(op->e->src, buf + offset, buf_len - offset);
+	offset += snprintf(buf + offset, buf_len - offset, "-");
+	offset += QGEdge_ToString(op->e, buf + offset, buf_len - offset);
+	offset += snprintf(buf + offset, buf_len - offset, "->");
+	offset += QGNode_ToString(op->e->dest, buf + offset, buf_len - offset);
+	return offset;
+}
+
+OpBase *NewEdgeIndexScanOp(const ExecutionPlan *plan, Graph *g, const QGEdge *e, int relation_id,
+						   OrderedIndexIter *iter) {
+	EdgeIndexScan *op = rm_malloc(sizeof(EdgeIndexScan));
+	op->g = g;
+	op->e = e;
+	op->iter = iter;
+	op->relation_id = relation_id;
+
+	// Set our Op operations
+	OpBase_Init((OpBase *)op, OPType_EDGE_INDEX_SCAN, "Edge Index Scan", NULL,
+				EdgeIndexScanConsume, EdgeIndexScanReset, EdgeIndexScanToString, NULL, EdgeIndexScanFree,
+				false, plan);
+
+	op->srcNodeRecIdx = OpBase_Modifies((OpBase *)op, e->src->alias);
+	op->destNodeRecIdx = OpBase_Modifies((OpBase *)op, e->dest->alias);
+	op->edgeRecIdx = OpBase_Modifies((OpBase *)op, e->alias);
+	return (OpBase *)op;
+}
+
+// Returns true if node is a member of each of the labels specified for n.
+static inline bool _NodeLabeled(const EdgeIndexScan *op, const QGNode *n, NodeID id) {
+	uint label_count = QGNode_LabelCount(n);
+	for(uint i = 0; i < label_count; i++) {
+		if(!Graph_IsNodeLabeled(op->g, id, n->labelsID[i])) return false;
+	}
+	return true;
+}
+
+static Record EdgeIndexScanConsume(OpBase *opBase) {
+	EdgeIndexScan *op = (EdgeIndexScan *)opBase;
+
+	EdgeID edge_id;
+	NodeID src_id;
+	NodeID dest_id;
+	while(OrderedIndexIter_NextEdge(op->iter, &edge_id, &src_id, &dest_id)) {
+		OpBase_ProfileIndexHit();
+		// Both endpoints must match their labels.
+		if(!_NodeLabeled(op, op->e->src, src_id) || !_NodeLabeled(op, op->e->dest, dest_id)) continue;
+
+		Record r = OpBase_CreateRecord((OpBase *)op);
+
+		Node *src = Record_GetNode(r, op->srcNodeRecIdx);
+		assert(Graph_GetNode(op->g, src_id, src));
+		Node *dest = Record_GetNode(r, op->destNodeRecIdx);
+		assert(Graph_GetNode(op->g, dest_id, dest));
+
+		Edge *e = Record_GetEdge(r, op->edgeRecIdx);
+		assert(Graph_GetEdge(op->g, edge_id, e));
+		e->relationID = op->relation_id;
+		e->srcNodeID = src_id;
+		e->destNodeID = dest_id;
+		return r;
+	}
+
+	return NULL;
+}
+
+static OpResult EdgeIndexScanReset(OpBase *opBase) {
+	EdgeIndexScan *op = (EdgeIndexScan *)opBase;
+	OrderedIndexIter_Reset(op->iter);
+	return OP_OK;
+}
+
+static void EdgeIndexScanFree(OpBase *opBase) {
+	EdgeIndexScan *op = (EdgeIndexScan *)opBase;
+	if(op->iter) {
+		OrderedIndexIter_Free(op->iter);
+		op->iter = NULL;
+	}
+}
@@ -0,0 +1,31 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "op.h"
+#include "../execution_plan.h"
+#include "../../graph/graph.h"
+#include "../../index/index.h"
+
+/* EdgeIndexScan, resolves edges of a single relationship type through
+ * the relationship type's ordered index, producing each edge along with
+ * its source and destination nodes. */
+typedef struct {
+	OpBase op;
+	Graph *g;
+	const QGEdge *e;            /* Edge being scanned. */
+	int relation_id;            /* Scanned relationship type. */
+	int srcNodeRecIdx;          /* Source node position within record. */
+	int destNodeRecIdx;         /* Destination node position within record. */
+	int edgeRecIdx;             /* Edge position within record. */
+	OrderedIndexIter *iter;     /* Iterator over the ordered index. */
+} EdgeIndexScan;
+
+/* Creates a new EdgeIndexScan operation,
+ * the operation takes ownership of the iterator. */
+OpBase *NewEdgeIndexScanOp(const ExecutionPlan *plan, Graph *g, const QGEdge *e, int relation_id,
+						   OrderedIndexIter *iter);
@@ -0,0 +1,214 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "op_expand_intersect.h"
+#include "shared/print_functions.h"
+#include "../../util/arr.h"
+#include "../../util/rmalloc.h"
+#include "../../query_ctx.h"
+
+/* Forward declarations. */
+static Record ExpandIntersectConsume(OpBase *opBase);
+static OpResult ExpandIntersectReset(OpBase *opBase);
+static OpBase *ExpandIntersectClone(const ExecutionPlan *plan, const OpBase *opBase);
+static void ExpandIntersectFree(OpBase *opBase);
+
+// Returns the single relation operand of ae.
+static const AlgebraicExpression *_RelationOperand(const AlgebraicExpression *ae) {
+	if(ae->type == AL_OPERATION) {
+		if(ae->operation.op != AL_EXP_TRANSPOSE || AlgebraicExpression_ChildCount(ae) != 1) return NULL;
+		ae = ae->operation.children[0];
+	}
+	if(ae->type != AL_OPERAND || ae->operand.diagonal) return NULL;
+	return ae;
+}
+
+bool ExpandIntersect_IntersectableExpression(const AlgebraicExpression *ae) {
+	return (_RelationOperand(ae) != NULL && AlgebraicExpression_Edge(ae) == NULL);
+}
+
+// String representation of operation.
+static int ExpandIntersectToString(const OpBase *ctx, char *buf, uint buf_len) {
+	const OpExpandIntersect *op = (const OpExpandIntersect *)ctx;
+	int offset = TraversalToString(ctx, buf, buf_len, op->operands[0].ae);
+	AlgebraicExpression *closing = op->operands[1].ae;
+	QGNode *src = QueryGraph_GetNodeByAlias(ctx->plan->query_graph,
+											AlgebraicExpression_Source(closing));
+	QGNode *dest = QueryGraph_GetNodeByAlias(ctx->plan->query_graph,
+											 AlgebraicExpression_Destination(closing));
+	offset += snprintf(buf + offset, buf_len - offset, " & ");
+	offset += QGNode_ToString(src, buf + offset, buf_len - offset);
+	offset += snprintf(buf + offset, buf_len - offset, "->");
+	offset += QGNode_ToString(dest, buf + offset, buf_len - offset);
+	return offset;
+}
+
+/* Sets operand to read the rows of the bound end of ae,
+ * dest is the alias of the node resolved by the intersection. */
+static void _InitOperand(OpExpandIntersect *op, IntersectOperand *operand, AlgebraicExpression *ae,
+						 const char *dest) {
+	const AlgebraicExpression *relation = _RelationOperand(ae);
+	assert(relation);
+
+	operand->ae = ae;
+	operand->relation = relation->operand.label;
+	operand->M = GrB_NULL;
+	operand->row = GrB_NULL;
+	operand->transposed = AlgebraicExpression_Transposed(ae);
+
+	const char *bound = AlgebraicExpression_Source(ae);
+	if(strcmp(bound, dest) == 0) {
+		// The expression leads to the bound node, read its columns as rows.
+		bound = AlgebraicExpression_Destination(ae);
+		operand->transposed = !operand->transposed;
+	}
+	assert(OpBase_Aware((OpBase *)op, bound, &operand->nodeIdx));
+}
+
+// Retrieves the relation matrices, returns false if a relation doesn't exist.
+static bool _ResolveOperands(OpExpandIntersect *op) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	GrB_Index n = Graph_RequiredMatrixDim(op->graph);
+
+	for(int i = 0; i < 2; i++) {
+		IntersectOperand *operand = op->operands + i;
+		int relation_id = GRAPH_NO_RELATION;
+		if(operand->relation) {
+			Schema *s = GraphContext_GetSchema(gc, operand->relation, SCHEMA_EDGE);
+			if(!s) return false;
+			relation_id = s->id;
+		}
+		operand->M = operand->transposed ?
+					 Graph_GetTransposedRelationMatrix(op->graph, relation_id) :
+					 Graph_GetRelationMatrix(op->graph, relation_id);
+		GrB_Vector_new(&operand->row, GrB_BOOL, n);
+	}
+
+	GrB_Vector_new(&op->intersection, GrB_BOOL, n);
+	return true;
+}
+
+// Collects the destinations connected to both bound nodes of the current record.
+static void _Intersect(OpExpandIntersect *op) {
+	GrB_Index n = Graph_RequiredMatrixDim(op->graph);
+	for(int i = 0; i < 2; i++) {
+		IntersectOperand *operand = op->operands + i;
+		Node *bound = Record_GetNode(op->r, operand->nodeIdx);
+		// Extract the bound node's row, as a column of the transposed matrix.
+		GrB_Col_extract(operand->row, GrB_NULL, GrB_NULL, operand->M, GrB_ALL, n,
+						ENTITY_GET_ID(bound), GrB_DESC_T0);
+	}
+
+	// Both rows are sorted, intersect their patterns.
+	GrB_eWiseMult_Vector_BinaryOp(op->intersection, GrB_NULL, GrB_NULL, GxB_PAIR_BOOL,
+								  op->operands[0].row, op->operands[1].row, GrB_NULL);
+
+	GrB_Index nvals;
+	GrB_Vector_nvals(&nvals, op->intersection);
+	if(nvals > op->destinationCap) {
+		op->destinations = rm_realloc(op->destinations, sizeof(GrB_Index) * nvals);
+		op->destinationCap = nvals;
+	}
+	GrB_Vector_extractTuples_BOOL(op->destinations, GrB_NULL, &nvals, op->intersection);
+	op->destinationCount = nvals;
+	op->destinationIdx = 0;
+}
+
+OpBase *NewExpandIntersectOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpression *traversal,
+							 AlgebraicExpression *closing) {
+	assert(ExpandIntersect_IntersectableExpression(traversal) &&
+		   ExpandIntersect_IntersectableExpression(closing));
+
+	OpExpandIntersect *op = rm_calloc(1, sizeof(OpExpandIntersect));
+	op->graph = g;
+	op->r = NULL;
+	op->resolved = false;
+	op->intersection = GrB_NULL;
+	op->destinations = NULL;
+	op->destinationCount = 0;
+	op->destinationCap = 0;
+	op->destinationIdx = 0;
+
+	OpBase_Init((OpBase *)op, OPType_EXPAND_INTERSECT, "Expand Intersect", NULL,
+				ExpandIntersectConsume, ExpandIntersectReset, ExpandIntersectToString, ExpandIntersectClone,
+				ExpandIntersectFree, false, plan);
+
+	const char *dest = AlgebraicExpression_Destination(traversal);
+	_InitOperand(op, op->operands, traversal, dest);
+	_InitOperand(op, op->operands + 1, closing, dest);
+	op->destNodeIdx = OpBase_Modifies((OpBase *)op, dest);
+
+	return (OpBase *)op;
+}
+
+static Record ExpandIntersectConsume(OpBase *opBase) {
+	OpExpandIntersect *op = (OpExpandIntersect *)opBase;
+	OpBase *child = op->op.children[0];
+
+	while(op->destinationIdx == op->destinationCount) {
+		Record childRecord = OpBase_Consume(child);
+		if(!childRecord) return NULL;
+
+		if(op->r) OpBase_DeleteRecord(op->r);
+		op->r = childRecord;
+
+		if(!op->resolved) {
+			// A missing relation connects no nodes.
+			if(!_ResolveOperands(op)) return NULL;
+			op->resolved = true;
+		}
+
+		_Intersect(op);
+	}
+
+	Node dest;
+	Graph_GetNode(op->graph, op->destinations[op->destinationIdx++], &dest);
+	Record_AddNode(op->r, op->destNodeIdx, dest);
+	return OpBase_CloneRecord(op->r);
+}
+
+static OpResult ExpandIntersectReset(OpBase *ctx) {
+	OpExpandIntersect *op = (OpExpandIntersect *)ctx;
+	if(op->r) {
+		OpBase_DeleteRecord(op->r);
+		op->r = NULL;
+	}
+	op->destinationCount = 0;
+	op->destinationIdx = 0;
+	return OP_OK;
+}
+
+static OpBase *ExpandIntersectClone(const ExecutionPlan *plan, const OpBase *opBase) {
+	assert(opBase->type == OPType_EXPAND_INTERSECT);
+	const OpExpandIntersect *op = (const OpExpandIntersect *)opBase;
+	return NewExpandIntersectOp(plan, QueryCtx_GetGraph(), AlgebraicExpression_Clone(op->operands[0].ae),
+								AlgebraicExpression_Clone(op->operands[1].ae));
+}
+
+static void ExpandIntersectFree(OpBase *ctx) {
+	OpExpandIntersect *op = (OpExpandIntersect *)ctx;
+
+	for(int i = 0; i < 2; i++) {
+		IntersectOperand *operand = op->operands + i;
+		if(operand->ae) {
+			AlgebraicExpression_Free(operand->ae);
+			operand->ae = NULL;
+		}
+		if(operand->row != GrB_NULL) GrB_free(&operand->row);
+	}
+
+	if(op->intersection != GrB_NULL) GrB_free(&op->intersection);
+
+	if(op->destinations) {
+		rm_free(op->destinations);
+		op->destinations = NULL;
+	}
+
+	if(op->r) {
+		OpBase_DeleteRecord(op->r);
+		op->r = NULL;
+	}
+}
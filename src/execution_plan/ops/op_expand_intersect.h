@@ -0,0 +1,53 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "op.h"
+#include "../execution_plan.h"
+#include "../../graph/graph.h"
+#include "../../arithmetic/algebraic_expression.h"
+
+/* Expand Intersect closes a cycle by resolving a node connected to two
+ * bound nodes at once, e.g. the last node of a triangle:
+ * MATCH (a)-[:F]->(b)-[:F]->(c)-[:F]->(a)
+ * rather than traversing from b to every neighbor c and then verifying each
+ * c is connected to a, c is drawn from the intersection of b's and a's
+ * adjacency rows, bounding the work by the smaller row. */
+
+// Adjacency rows intersected to resolve the destination.
+typedef struct {
+	AlgebraicExpression *ae;    // Single relation traversed from the bound node.
+	const char *relation;       // Relation type, NULL for any type.
+	bool transposed;            // Traverse the relation against its direction.
+	int nodeIdx;                // Bound node, index into record.
+	GrB_Matrix M;               // Relation matrix, rows indexed by the bound node.
+	GrB_Vector row;             // Adjacency row of the bound node.
+} IntersectOperand;
+
+typedef struct {
+	OpBase op;
+	Graph *graph;
+	IntersectOperand operands[2];   // Traversals leading to the destination.
+	int destNodeIdx;            // Resolved node, index into record.
+	bool resolved;              // Relation matrices are resolved.
+	GrB_Vector intersection;    // Destinations of the current record.
+	GrB_Index *destinations;    // Destinations yet to be produced.
+	GrB_Index destinationCount; // Length of destinations.
+	GrB_Index destinationCap;   // Allocated length of destinations.
+	GrB_Index destinationIdx;   // Next destination.
+	Record r;                   // Current record.
+} OpExpandIntersect;
+
+/* Creates a new Expand Intersect operation, resolving the destination of traversal
+ * which must also be reached by closing, where each is a single relation
+ * operand whose edge isn't referenced. Takes ownership of both expressions. */
+OpBase *NewExpandIntersectOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpression *traversal,
+							 AlgebraicExpression *closing);
+
+/* Returns true if ae traverses a single relation, without referencing its edge,
+ * such that it can be one of the intersected traversals. */
+bool ExpandIntersect_IntersectableExpression(const AlgebraicExpression *ae);
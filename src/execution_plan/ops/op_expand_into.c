@@ -8,6 +8,7 @@
 #include "shared/print_functions.h"
 #include "../../ast/ast.h"
 #include "../../util/arr.h"
+#include "../../util/matrix_pool.h"
 #include "../../util/rmalloc.h"
 #include "../../query_ctx.h"
 #include "../../GraphBLASExt/GxB_Delete.h"
@@ -20,7 +21,11 @@ static void ExpandIntoFree(OpBase *opBase);
 
 // String representation of operation.
 static inline int ExpandIntoToString(const OpBase *ctx, char *buf, uint buf_len) {
-	return TraversalToString(ctx, buf, buf_len, ((const OpExpandInto *)ctx)->ae);
+	const OpExpandInto *op = (const OpExpandInto *)ctx;
+	int offset = TraversalToString(ctx, buf, buf_len, op->ae);
+	// Profiled operations report their batch sizes.
+	if(ctx->stats) offset += TraverseBatch_ToString(&op->batch, buf + offset, buf_len - offset);
+	return offset;
 }
 
 /* Collects traversed edge relations.
@@ -63,30 +68,25 @@ static void _populate_filter_matrix(OpExpandInto *op) {
 }
 
 /* Evaluate algebraic expression:
- * appends filter matrix as the left most operand
+ * populates filter matrix, the left most operand of the compiled expression
  * perform multiplications.
- * removed filter matrix from original expression
  * clears filter matrix. */
 static void _traverse(OpExpandInto *op) {
 	// Create both filter and result matrices.
 	if(op->F == GrB_NULL) {
 		size_t required_dim = Graph_RequiredMatrixDim(op->graph);
-		GrB_Matrix_new(&op->M, GrB_BOOL, op->recordsCap, required_dim);
-		GrB_Matrix_new(&op->F, GrB_BOOL, op->recordsCap, required_dim);
+		op->M = MatrixPool_Acquire(op->recordsCap, required_dim);
+		op->F = MatrixPool_Acquire(op->recordsCap, required_dim);
 	}
 
 	// Populate filter matrix.
 	_populate_filter_matrix(op);
-	// Clone expression, as we're about to modify the structure with Optimize.
-	AlgebraicExpression *clone = AlgebraicExpression_Clone(op->ae);
-	// Append filter matrix to algebraic expression, as the left most operand.
-	AlgebraicExpression_MultiplyToTheLeft(&clone, op->F);
-	// TODO: consider performing optimization as part of evaluation.
-	AlgebraicExpression_Optimize(&clone);
-	// Evaluate expression.
-	AlgebraicExpression_Eval(clone, op->M);
-	// Free clone.
-	AlgebraicExpression_Free(clone);
+	// Evaluate expression, compiled by the first batch.
+	TraverseExpression_Eval(&op->expression, op->ae, op->F, op->M);
+	// Size the next batch by this batch's fan-out.
+	GrB_Index entries;
+	GrB_Matrix_nvals(&entries, op->M);
+	TraverseBatch_Observe(&op->batch, op->recordCount, entries);
 	// Clear filter matrix.
 	GrB_Matrix_clear(op->F);
 }
@@ -104,6 +104,8 @@ OpBase *NewExpandIntoOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpression
 	op->edgeRelationTypes = NULL;
 	op->recordsCap = records_cap;
 	op->records = rm_calloc(op->recordsCap, sizeof(Record));
+	TraverseBatch_Init(&op->batch, op->recordsCap);
+	TraverseExpression_Init(&op->expression);
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_EXPAND_INTO, "Expand Into", NULL, ExpandIntoConsume,
@@ -203,7 +205,7 @@ static Record ExpandIntoConsume(OpBase *opBase) {
 		}
 
 		// Ask child operations for data.
-		for(op->recordCount = 0; op->recordCount < op->recordsCap; op->recordCount++) {
+		for(op->recordCount = 0; op->recordCount < op->batch.size; op->recordCount++) {
 			Record childRecord = OpBase_Consume(child);
 			// Did not managed to get new data, break.
 			if(!childRecord) break;
@@ -247,15 +249,11 @@ static inline OpBase *ExpandIntoClone(const ExecutionPlan *plan, const OpBase *o
 /* Frees ExpandInto */
 static void ExpandIntoFree(OpBase *ctx) {
 	OpExpandInto *op = (OpExpandInto *)ctx;
-	if(op->F != GrB_NULL) {
-		GrB_Matrix_free(&op->F);
-		op->F = GrB_NULL;
-	}
+	TraverseExpression_Free(&op->expression);
 
-	if(op->M != GrB_NULL) {
-		GrB_Matrix_free(&op->M);
-		op->M = GrB_NULL;
-	}
+	// Matrices are retained for reuse by later traversals.
+	MatrixPool_Release(&op->F);
+	MatrixPool_Release(&op->M);
 
 	if(op->edges) {
 		array_free(op->edges);
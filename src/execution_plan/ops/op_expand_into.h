@@ -7,6 +7,8 @@
 #pragma once
 
 #include "op.h"
+#include "shared/traverse_batch.h"
+#include "shared/traverse_expression.h"
 #include "../execution_plan.h"
 #include "../../graph/graph.h"
 #include "../../graph/entities/edge.h"
@@ -28,6 +30,8 @@ typedef struct {
 	int edgeIdx;                // Index into record.
 	uint recordsCap;            // Max number of records to process.
 	uint recordCount;           // Number of records to process.
+	TraverseBatch batch;        // Number of records processed at a time.
+	TraverseExpression expression;  // F * (ae), compiled by the first batch.
 	Record *records;            // Array of records.
 	Record r;                   // Current selected record.
 } OpExpandInto;
@@ -5,23 +5,194 @@
 */
 
 #include "op_filter.h"
+#include "../../util/arr.h"
 
 /* Forward declarations. */
+static OpResult FilterInit(OpBase *opBase);
 static Record FilterConsume(OpBase *opBase);
+static OpResult FilterReset(OpBase *opBase);
 static OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void FilterFree(OpBase *opBase);
 
 OpBase *NewFilterOp(const ExecutionPlan *plan, FT_FilterNode *filterTree) {
 	OpFilter *op = rm_malloc(sizeof(OpFilter));
 	op->filterTree = filterTree;
+	op->batched = false;
+	op->batch = NULL;
+	op->sel = NULL;
+	op->sel_count = 0;
+	op->sel_idx = 0;
+	op->batch_size = FILTER_BATCH_INITIAL;
+	op->shared = NULL;
+	op->conjuncts = NULL;
+	op->evaluated = 0;
 
 	// Set our Op operations
-	OpBase_Init((OpBase *)op, OPType_FILTER, "Filter", NULL, FilterConsume,
-				NULL, NULL, FilterClone, FilterFree, false, plan);
+	OpBase_Init((OpBase *)op, OPType_FILTER, "Filter", FilterInit, FilterConsume,
+				FilterReset, NULL, FilterClone, FilterFree, false, plan);
 
 	return (OpBase *)op;
 }
 
+void FilterOp_ShareExpression(OpFilter *op, AR_ExpNode *exp, const char *alias) {
+	if(!op->shared) op->shared = array_new(FilterSharedExp, 1);
+	FilterSharedExp shared = {.exp = exp, .alias = alias};
+	shared.idx = OpBase_Modifies((OpBase *)op, alias);
+	op->shared = array_append(op->shared, shared);
+}
+
+// Compute shared expressions into r.
+static inline void _FilterShare(OpFilter *filter, Record r) {
+	if(!filter->shared) return;
+	uint count = array_len(filter->shared);
+	for(uint i = 0; i < count; i++) {
+		FilterSharedExp *shared = filter->shared + i;
+		SIValue v = AR_EXP_Evaluate(shared->exp, r);
+		// Values referring to scalars held within r are persisted, entities are copied.
+		if(!(v.type & SI_GRAPHENTITY)) SIValue_Persist(&v);
+		Record_Add(r, shared->idx, v);
+	}
+}
+
+// Order the filter's conditions by their estimates.
+static void _FilterPrepareConjuncts(OpFilter *filter) {
+	const QueryGraph *qg = filter->op.plan->query_graph;
+	FilterTree_Reorder(filter->filterTree, qg);
+
+	FT_FilterNode **trees = FilterTree_Conjuncts(filter->filterTree);
+	uint count = array_len(trees);
+	if(count > 1) {
+		filter->conjuncts = array_new(FilterConjunct, count);
+		for(uint i = 0; i < count; i++) {
+			FilterConjunct c = {.tree = trees[i], .evaluated = 0, .passed = 0};
+			c.cost = FilterTree_Cost(trees[i], qg);
+			c.selectivity = FilterTree_Selectivity(trees[i], qg);
+			filter->conjuncts = array_append(filter->conjuncts, c);
+		}
+	}
+	array_free(trees);
+}
+
+static inline double _FilterConjunctRank(const FilterConjunct *c) {
+	double pass_rate = (c->passed + FILTER_PASS_RATE_PRIOR * c->selectivity) /
+					   (c->evaluated + FILTER_PASS_RATE_PRIOR);
+	return FilterTree_Rank(c->cost, pass_rate, OP_AND);
+}
+
+/* Account for count records evaluated, reordering conjuncts by their
+ * observed pass rates once enough records have been evaluated. */
+static void _FilterObserve(OpFilter *filter, uint count) {
+	filter->evaluated += count;
+	if(filter->evaluated < FILTER_REORDER_INTERVAL) return;
+	filter->evaluated = 0;
+
+	// Stable insertion sort, conjuncts of equal rank keep their order.
+	FilterConjunct *conjuncts = filter->conjuncts;
+	uint conjunct_count = array_len(conjuncts);
+	for(uint i = 1; i < conjunct_count; i++) {
+		FilterConjunct c = conjuncts[i];
+		double rank = _FilterConjunctRank(&c);
+		uint j = i;
+		for(; j > 0 && _FilterConjunctRank(conjuncts + j - 1) > rank; j--) {
+			conjuncts[j] = conjuncts[j - 1];
+		}
+		conjuncts[j] = c;
+	}
+
+	// Decay observations, such that pass rates track changes in the input.
+	for(uint i = 0; i < conjunct_count; i++) {
+		conjuncts[i].evaluated /= 2;
+		conjuncts[i].passed /= 2;
+	}
+}
+
+// Runs r through the filter's conditions.
+static int _FilterApply(OpFilter *filter, Record r) {
+	if(!filter->conjuncts) return FilterTree_applyFilters(filter->filterTree, r);
+
+	int pass = FILTER_PASS;
+	uint count = array_len(filter->conjuncts);
+	for(uint i = 0; i < count; i++) {
+		FilterConjunct *c = filter->conjuncts + i;
+		c->evaluated++;
+		if(FilterTree_applyFilters(c->tree, r) != FILTER_PASS) {
+			pass = FILTER_FAIL;
+			break;
+		}
+		c->passed++;
+	}
+	_FilterObserve(filter, 1);
+	return pass;
+}
+
+// Runs the batch's count records through the filter's conditions.
+static uint _FilterApplyBatch(OpFilter *filter, uint count) {
+	if(!filter->conjuncts) {
+		return FilterTree_applyBatchFilters(filter->filterTree, filter->batch, filter->sel, count);
+	}
+
+	uint n = count;
+	uint conjunct_count = array_len(filter->conjuncts);
+	for(uint i = 0; i < conjunct_count && n > 0; i++) {
+		FilterConjunct *c = filter->conjuncts + i;
+		c->evaluated += n;
+		n = FilterTree_applyBatchFilters(c->tree, filter->batch, filter->sel, n);
+		c->passed += n;
+	}
+	_FilterObserve(filter, count);
+	return n;
+}
+
+static OpResult FilterInit(OpBase *opBase) {
+	OpFilter *filter = (OpFilter *)opBase;
+	_FilterPrepareConjuncts(filter);
+
+	/* Records are only read ahead of a scan without children, or of an aggregation
+	 * separating query segments, whose records hold values owned by its groups.
+	 * Records produced by other operations may share values
+	 * which are released once their next record is produced. */
+	OpBase *child = filter->op.children[0];
+	bool batched = (child->type == OPType_AGGREGATE);
+	for(uint i = 0; i < SCAN_OP_COUNT && !batched && child->childCount == 0; i++) {
+		batched = (child->type == SCAN_OPS[i]);
+	}
+	if(batched) {
+		filter->batched = true;
+		filter->batch = rm_malloc(sizeof(Record) * FILTER_BATCH_MAX);
+		filter->sel = rm_malloc(sizeof(uint) * FILTER_BATCH_MAX);
+	}
+	return OP_OK;
+}
+
+/* Pulls the next batch from child and runs it through the filter tree,
+ * returns false once child is depleted. */
+static bool _FilterNextBatch(OpFilter *filter) {
+	OpBase *child = filter->op.children[0];
+
+	uint count = 0;
+	while(count < filter->batch_size) {
+		Record r = OpBase_Consume(child);
+		if(!r) break;
+		_FilterShare(filter, r);
+		filter->batch[count] = r;
+		filter->sel[count] = count;
+		count++;
+	}
+	if(count == 0) return false;
+
+	filter->sel_count = _FilterApplyBatch(filter, count);
+	filter->sel_idx = 0;
+
+	// Discard failing records, passing indices are in ascending order.
+	for(uint i = 0, j = 0; i < count; i++) {
+		if(j < filter->sel_count && filter->sel[j] == i) j++;
+		else OpBase_DeleteRecord(filter->batch[i]);
+	}
+
+	if(filter->batch_size < FILTER_BATCH_MAX) filter->batch_size *= 2;
+	return true;
+}
+
 /* FilterConsume next operation
  * returns OP_OK when graph passes filter tree. */
 static Record FilterConsume(OpBase *opBase) {
@@ -29,22 +200,53 @@ static Record FilterConsume(OpBase *opBase) {
 	OpFilter *filter = (OpFilter *)opBase;
 	OpBase *child = filter->op.children[0];
 
+	if(filter->batched) {
+		while(filter->sel_idx == filter->sel_count) {
+			if(!_FilterNextBatch(filter)) return NULL;
+		}
+		return filter->batch[filter->sel[filter->sel_idx++]];
+	}
+
 	while(true) {
 		r = OpBase_Consume(child);
 		if(!r) break;
+		_FilterShare(filter, r);
 
 		/* Pass graph through filter tree */
-		if(FilterTree_applyFilters(filter->filterTree, r) == FILTER_PASS) break;
+		if(_FilterApply(filter, r) == FILTER_PASS) break;
 		else OpBase_DeleteRecord(r);
 	}
 
 	return r;
 }
 
+// Discard passing records yet to be handed off.
+static void _FilterDiscardBatch(OpFilter *filter) {
+	for(; filter->sel_idx < filter->sel_count; filter->sel_idx++) {
+		OpBase_DeleteRecord(filter->batch[filter->sel[filter->sel_idx]]);
+	}
+	filter->sel_idx = 0;
+	filter->sel_count = 0;
+}
+
+static OpResult FilterReset(OpBase *opBase) {
+	OpFilter *filter = (OpFilter *)opBase;
+	_FilterDiscardBatch(filter);
+	filter->batch_size = FILTER_BATCH_INITIAL;
+	return OP_OK;
+}
+
 static inline OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	assert(opBase->type == OPType_FILTER);
 	OpFilter *op = (OpFilter *)opBase;
-	return NewFilterOp(plan, FilterTree_Clone(op->filterTree));
+	OpFilter *clone = (OpFilter *)NewFilterOp(plan, FilterTree_Clone(op->filterTree));
+	if(op->shared) {
+		uint count = array_len(op->shared);
+		for(uint i = 0; i < count; i++) {
+			FilterOp_ShareExpression(clone, AR_EXP_Clone(op->shared[i].exp), op->shared[i].alias);
+		}
+	}
+	return (OpBase *)clone;
 }
 
 /* Frees OpFilter*/
@@ -54,5 +256,23 @@ static void FilterFree(OpBase *ctx) {
 		FilterTree_Free(filter->filterTree);
 		filter->filterTree = NULL;
 	}
+	if(filter->batch) {
+		_FilterDiscardBatch(filter);
+		rm_free(filter->batch);
+		filter->batch = NULL;
+	}
+	if(filter->sel) {
+		rm_free(filter->sel);
+		filter->sel = NULL;
+	}
+	if(filter->conjuncts) {
+		array_free(filter->conjuncts);
+		filter->conjuncts = NULL;
+	}
+	if(filter->shared) {
+		uint count = array_len(filter->shared);
+		for(uint i = 0; i < count; i++) AR_EXP_Free(filter->shared[i].exp);
+		array_free(filter->shared);
+		filter->shared = NULL;
+	}
 }
-
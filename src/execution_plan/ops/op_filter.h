@@ -10,12 +10,58 @@
 #include "../execution_plan.h"
 #include "../../filter_tree/filter_tree.h"
 
+// Number of records of the first batch.
+#define FILTER_BATCH_INITIAL 16
+// Maximal number of records per batch.
+#define FILTER_BATCH_MAX 256
+
+// Number of records evaluated between reorderings of the filter's conjuncts.
+#define FILTER_REORDER_INTERVAL 1024
+// Weight of the estimated pass rate, in records, against observed pass rates.
+#define FILTER_PASS_RATE_PRIOR 16
+
+// Operand of the filter's top AND chain along with its observed pass rate.
+typedef struct {
+	FT_FilterNode *tree;    // Subtree to evaluate.
+	double cost;            // Estimated cost of evaluating the subtree.
+	double selectivity;     // Estimated pass rate.
+	uint64_t evaluated;     // Number of records evaluated.
+	uint64_t passed;        // Number of records passing.
+} FilterConjunct;
+
+// Expression evaluated by the filter and shared with later operations.
+typedef struct {
+	AR_ExpNode *exp;        // Expression to evaluate.
+	const char *alias;      // Alias under which the value is shared.
+	int idx;                // Record offset of the shared value.
+} FilterSharedExp;
+
 /* Filter
- * filters graph according to where cluase */
+ * filters graph according to where cluase
+ * when fed directly by a scan or an aggregation, records are pulled and evaluated in batches,
+ * batches start small and double in size, bounding the records read ahead
+ * of a consumer which stops early.
+ * Conditions are ordered by estimated cost and selectivity on initialization,
+ * the operands of the top AND chain are reordered periodically by their
+ * observed pass rates. */
 typedef struct {
 	OpBase op;
 	FT_FilterNode *filterTree;
+	bool batched;               // Evaluate records in batches.
+	Record *batch;              // Records pulled from child.
+	uint *sel;                  // Indices of passing records within batch.
+	uint sel_count;             // Number of passing records.
+	uint sel_idx;               // Next passing record to hand off.
+	uint batch_size;            // Number of records to pull for the next batch.
+	FilterSharedExp *shared;    // Expressions computed into each record prior to filtering.
+	FilterConjunct *conjuncts;  // Operands of the top AND chain in evaluation order, if any.
+	uint64_t evaluated;         // Records evaluated since conjuncts were last reordered.
 } OpFilter;
 
 /* Creates a new Filter operation */
 OpBase *NewFilterOp(const ExecutionPlan *plan, FT_FilterNode *filterTree);
+
+/* Evaluate exp into each record under alias prior to filtering,
+ * such that the filter tree and later operations read its value.
+ * The filter takes ownership of exp. */
+void FilterOp_ShareExpression(OpFilter *op, AR_ExpNode *exp, const char *alias);
@@ -0,0 +1,171 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "op_index_order_scan.h"
+#include "shared/print_functions.h"
+#include "../../query_ctx.h"
+#include "../../util/rmalloc.h"
+
+// Number of value types iterated, strings and numerics.
+#define INDEX_ORDER_SCAN_PASSES 2
+
+/* Forward declarations. */
+static OpResult IndexOrderScanInit(OpBase *opBase);
+static Record IndexOrderScanConsume(OpBase *opBase);
+static Record IndexOrderScanNoOp(OpBase *opBase);
+static OpResult IndexOrderScanReset(OpBase *opBase);
+static OpBase *IndexOrderScanClone(const ExecutionPlan *plan, const OpBase *opBase);
+static void IndexOrderScanFree(OpBase *opBase);
+
+static inline int IndexOrderScanToString(const OpBase *ctx, char *buf, uint buf_len) {
+	return ScanToString(ctx, buf, buf_len, ((const IndexOrderScan *)ctx)->n);
+}
+
+OpBase *NewIndexOrderScanOp(const ExecutionPlan *plan, const QGNode *n, const char *attribute,
+							bool descending) {
+	IndexOrderScan *op = rm_malloc(sizeof(IndexOrderScan));
+	op->g = NULL;
+	op->n = n;
+	op->attribute = rm_strdup(attribute);
+	op->descending = descending;
+	op->ordered = false;
+	op->index = NULL;
+	op->attr = ATTRIBUTE_NOTFOUND;
+	op->pass = 0;
+	op->iter = NULL;
+	op->label_iter.set = NULL;
+
+	// Set our Op operations
+	OpBase_Init((OpBase *)op, OPType_INDEX_ORDER_SCAN, "Index Order Scan", IndexOrderScanInit,
+				IndexOrderScanConsume, IndexOrderScanReset, IndexOrderScanToString,
+				IndexOrderScanClone, IndexOrderScanFree, false, plan);
+
+	op->nodeRecIdx = OpBase_Modifies((OpBase *)op, n->alias);
+
+	return (OpBase *)op;
+}
+
+bool IndexOrderScan_Ordered(const IndexOrderScan *op) {
+	return op->ordered;
+}
+
+/* ORDER BY sorts strings before numerics, ascending passes iterate strings first,
+ * descending passes iterate numerics first. */
+static OrderedIndexIter *_PassIterator(const IndexOrderScan *op) {
+	bool strings = (op->pass == 0) != op->descending;
+	return OrderedIndex_IterateAttribute(op->index, op->attr, strings ? T_STRING : T_DOUBLE,
+										 op->descending);
+}
+
+static OpResult IndexOrderScanInit(OpBase *opBase) {
+	IndexOrderScan *op = (IndexOrderScan *)opBase;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	op->g = gc->g;
+
+	Schema *schema = GraphContext_GetSchema(gc, op->n->label, SCHEMA_NODE);
+	if(!schema) {
+		// Missing schema, use the NOP consume function.
+		OpBase_UpdateConsume(opBase, IndexOrderScanNoOp);
+		return OP_OK;
+	}
+
+	/* The index orders the scan only if every labeled node is indexed,
+	 * boolean values are indexed as numerics and as such are out of order. */
+	Index *idx = Schema_GetIndex(schema, op->attribute, IDX_EXACT_MATCH);
+	Attribute_ID attr = GraphContext_GetAttributeID(gc, op->attribute);
+	if(idx && Index_IsOperational(idx) && attr != ATTRIBUTE_NOTFOUND) {
+		uint64_t booleans;
+		uint64_t entries = OrderedIndex_AttributeEntryCount(idx->ordered, attr, &booleans);
+		op->ordered = (booleans == 0 &&
+					   entries == Graph_LabeledNodeCount(op->g, schema->id));
+	}
+
+	if(op->ordered) {
+		op->index = idx->ordered;
+		op->attr = attr;
+		op->iter = _PassIterator(op);
+	} else {
+		IDSet_Iterate(Graph_GetLabelIDs(op->g, schema->id), &op->label_iter);
+	}
+
+	return OP_OK;
+}
+
+static inline void _UpdateRecord(IndexOrderScan *op, Record r, NodeID node_id) {
+	// Get a pointer to the node's allocated space within the Record.
+	Node *n = Record_GetNode(r, op->nodeRecIdx);
+	// Populate the Record with the graph entity data.
+	Graph_GetNode(op->g, node_id, n);
+}
+
+// Advance whichever iterator the scan uses, returns false once depleted.
+static bool _IndexOrderScan_Next(IndexOrderScan *op, NodeID *node_id) {
+	if(!op->ordered) return IDSetIterator_Next(&op->label_iter, node_id);
+
+	while(op->iter) {
+		if(OrderedIndexIter_Next(op->iter, node_id)) {
+			OpBase_ProfileIndexHit();
+			return true;
+		}
+		// Current value type is depleted, proceed to the next one.
+		OrderedIndexIter_Free(op->iter);
+		op->iter = NULL;
+		if(++op->pass < INDEX_ORDER_SCAN_PASSES) op->iter = _PassIterator(op);
+	}
+
+	return false;
+}
+
+static Record IndexOrderScanConsume(OpBase *opBase) {
+	IndexOrderScan *op = (IndexOrderScan *)opBase;
+
+	NodeID node_id;
+	if(!_IndexOrderScan_Next(op, &node_id)) return NULL;
+
+	Record r = OpBase_CreateRecord((OpBase *)op);
+	// Populate the Record with the actual node.
+	_UpdateRecord(op, r, node_id);
+	return r;
+}
+
+/* This function is invoked when the op has no valid label,
+ * the op simply needs to return NULL. */
+static Record IndexOrderScanNoOp(OpBase *opBase) {
+	return NULL;
+}
+
+static OpResult IndexOrderScanReset(OpBase *ctx) {
+	IndexOrderScan *op = (IndexOrderScan *)ctx;
+	if(op->label_iter.set) IDSet_Iterate(op->label_iter.set, &op->label_iter);
+	if(op->ordered) {
+		if(op->iter) OrderedIndexIter_Free(op->iter);
+		op->pass = 0;
+		op->iter = _PassIterator(op);
+	}
+	return OP_OK;
+}
+
+static OpBase *IndexOrderScanClone(const ExecutionPlan *plan, const OpBase *opBase) {
+	assert(opBase->type == OPType_INDEX_ORDER_SCAN);
+	IndexOrderScan *op = (IndexOrderScan *)opBase;
+	return NewIndexOrderScanOp(plan, op->n, op->attribute, op->descending);
+}
+
+static void IndexOrderScanFree(OpBase *opBase) {
+	IndexOrderScan *op = (IndexOrderScan *)opBase;
+
+	if(op->iter) {
+		OrderedIndexIter_Free(op->iter);
+		op->iter = NULL;
+	}
+
+	op->label_iter.set = NULL;
+
+	if(op->attribute) {
+		rm_free(op->attribute);
+		op->attribute = NULL;
+	}
+}
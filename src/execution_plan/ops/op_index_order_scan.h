@@ -0,0 +1,42 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "op.h"
+#include "../execution_plan.h"
+#include "../../graph/graph.h"
+#include "../../index/index.h"
+#include "../../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+/* IndexOrderScan, scans entire label in attribute order.
+ * Nodes are produced in the order ORDER BY sorts their attribute values,
+ * given every labeled node holds a string or numeric indexed value,
+ * otherwise nodes are produced in ID order, as a label scan would. */
+
+typedef struct {
+	OpBase op;
+	Graph *g;
+	const QGNode *n;                /* Node being scanned. */
+	uint nodeRecIdx;                /* Node position within record. */
+	char *attribute;                /* Attribute nodes are ordered by. */
+	bool descending;                /* Produce nodes in descending attribute order. */
+	bool ordered;                   /* Nodes are produced in attribute order. */
+	const OrderedIndex *index;      /* Index nodes are ordered by. */
+	Attribute_ID attr;              /* Attribute ID within index. */
+	uint pass;                      /* Value type iterated, strings and numerics. */
+	OrderedIndexIter *iter;         /* Index iterator over current value type. */
+	IDSetIterator label_iter;       /* Label iterator, used when nodes aren't ordered. */
+} IndexOrderScan;
+
+/* Creates a new IndexOrderScan operation over node's label,
+ * ordered by node's attribute. */
+OpBase *NewIndexOrderScanOp(const ExecutionPlan *plan, const QGNode *n, const char *attribute,
+							bool descending);
+
+/* Returns true if nodes are produced in attribute order,
+ * valid once the operation is initialized. */
+bool IndexOrderScan_Ordered(const IndexOrderScan *op);
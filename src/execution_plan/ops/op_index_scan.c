@@ -6,11 +6,15 @@
 
 #include "op_index_scan.h"
 #include "shared/print_functions.h"
+#include "../../query_ctx.h"
+#include "../../util/rmalloc.h"
+#include "../../access_stats/access_stats.h"
 
 /* Forward declarations. */
 static OpResult IndexScanInit(OpBase *opBase);
 static Record IndexScanConsume(OpBase *opBase);
 static Record IndexScanConsumeFromChild(OpBase *opBase);
+static Record IndexScanConsumeCovered(OpBase *opBase);
 static OpResult IndexScanReset(OpBase *opBase);
 static void IndexScanFree(OpBase *opBase);
 
@@ -25,7 +29,13 @@ OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, const QGNode *n, RSI
 	op->n = n;
 	op->idx = idx;
 	op->iter = iter;
+	op->range_iter = NULL;
+	op->id_stream = NULL;
+	op->covered_alias = NULL;
+	op->coveredRecIdx = -1;
+	op->covered_attr = ATTRIBUTE_NOTFOUND;
 	op->child_record = NULL;
+	op->selectivity = -1;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_INDEX_SCAN, "Index Scan", IndexScanInit, IndexScanConsume,
@@ -35,8 +45,46 @@ OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, const QGNode *n, RSI
 	return (OpBase *)op;
 }
 
+OpBase *NewIndexRangeScanOp(const ExecutionPlan *plan, Graph *g, const QGNode *n,
+							OrderedIndexIter *iter) {
+	IndexScan *op = (IndexScan *)NewIndexScanOp(plan, g, n, NULL, NULL);
+	op->range_iter = iter;
+	return (OpBase *)op;
+}
+
+OpBase *NewIndexIDStreamScanOp(const ExecutionPlan *plan, Graph *g, const QGNode *n,
+							   IDStream *stream) {
+	IndexScan *op = (IndexScan *)NewIndexScanOp(plan, g, n, NULL, NULL);
+	op->id_stream = stream;
+	return (OpBase *)op;
+}
+
+const char *IndexScanOp_Cover(IndexScan *op) {
+	assert(op->range_iter && op->op.childCount == 0);
+	op->covered_attr = OrderedIndexIter_Attribute(op->range_iter);
+	assert(op->covered_attr != ATTRIBUTE_NOTFOUND);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	const char *attribute = GraphContext_GetAttributeString(gc, op->covered_attr);
+	size_t len = strlen(op->n->alias) + strlen(attribute) + sizeof(". (covered)");
+	op->covered_alias = rm_malloc(len);
+	snprintf(op->covered_alias, len, "%s.%s (covered)", op->n->alias, attribute);
+	op->coveredRecIdx = OpBase_Modifies((OpBase *)op, op->covered_alias);
+
+	op->op.name = "Covering Index Scan";
+	return op->covered_alias;
+}
+
 static OpResult IndexScanInit(OpBase *opBase) {
-	if(opBase->childCount > 0) OpBase_UpdateConsume(opBase, IndexScanConsumeFromChild);
+	IndexScan *op = (IndexScan *)opBase;
+	if(opBase->childCount > 0) {
+		// The index is looked up per child record.
+		OpBase_UpdateConsume(opBase, IndexScanConsumeFromChild);
+		return OP_OK;
+	}
+
+	AccessStats_Touch(ACCESS_INDEX, op->n->labelID);
+	if(op->covered_alias) OpBase_UpdateConsume(opBase, IndexScanConsumeCovered);
 	return OP_OK;
 }
 
@@ -45,6 +93,31 @@ static inline void _UpdateRecord(IndexScan *op, Record r, EntityID node_id) {
 	Node *n = Record_GetNode(r, op->nodeRecIdx);
 	// Update node's internal entity pointer.
 	assert(Graph_GetNode(op->g, node_id, n));
+	AccessStats_Touch(ACCESS_NODE, node_id);
+}
+
+// Advance whichever iterator the scan uses, returns false once depleted.
+static inline bool _IndexScan_Next(IndexScan *op, EntityID *node_id) {
+	bool found;
+	if(op->range_iter) {
+		found = OrderedIndexIter_Next(op->range_iter, node_id);
+	} else if(op->id_stream) {
+		found = IDStream_Next(op->id_stream, node_id);
+	} else {
+		const EntityID *id = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL);
+		found = (id != NULL);
+		if(found) *node_id = *id;
+	}
+	if(found) OpBase_ProfileIndexHit();
+	return found;
+}
+
+static inline void _IndexScan_ResetIterator(IndexScan *op) {
+	// Each reset looks the index up anew.
+	AccessStats_Touch(ACCESS_INDEX, op->n->labelID);
+	if(op->range_iter) OrderedIndexIter_Reset(op->range_iter);
+	else if(op->id_stream) IDStream_Reset(op->id_stream);
+	else RediSearch_ResultsIteratorReset(op->iter);
 }
 
 static Record IndexScanConsumeFromChild(OpBase *opBase) {
@@ -53,47 +126,66 @@ static Record IndexScanConsumeFromChild(OpBase *opBase) {
 	if(op->child_record == NULL) {
 		op->child_record = OpBase_Consume(op->op.children[0]);
 		if(op->child_record == NULL) return NULL;
-		else RediSearch_ResultsIteratorReset(op->iter);
+		else _IndexScan_ResetIterator(op);
 	}
 
-	const EntityID *nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL);
-	if(!nodeId) { // Index scan depleted.
+	EntityID nodeId;
+	if(!_IndexScan_Next(op, &nodeId)) { // Index scan depleted.
 		OpBase_DeleteRecord(op->child_record); // Free old record.
 		// Pull a new record from child.
 		op->child_record = OpBase_Consume(op->op.children[0]);
 		if(op->child_record == NULL) return NULL; // Child depleted.
 
 		// Reset iterator and evaluate again.
-		RediSearch_ResultsIteratorReset(op->iter);
-		nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL);
-		if(!nodeId) return NULL; // Empty iterator, return immediately.
+		_IndexScan_ResetIterator(op);
+		if(!_IndexScan_Next(op, &nodeId)) return NULL; // Empty iterator, return immediately.
 	}
 
 	// Clone the held Record, as it will be freed upstream.
 	Record r = OpBase_CloneRecord(op->child_record);
 
 	// Populate the Record with the actual node.
-	_UpdateRecord(op, r, *nodeId);
+	_UpdateRecord(op, r, nodeId);
 
 	return r;
 }
 
 static Record IndexScanConsume(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
-	const EntityID *nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL);
-	if(!nodeId) return NULL;
+	EntityID nodeId;
+	if(!_IndexScan_Next(op, &nodeId)) return NULL;
 
 	Record r = OpBase_CreateRecord((OpBase *)op);
 
 	// Populate the Record with the actual node.
-	_UpdateRecord(op, r, *nodeId);
+	_UpdateRecord(op, r, nodeId);
 
 	return r;
 }
 
+// Produce indexed values, nodes are only accessed for values the index doesn't restore.
+static Record IndexScanConsumeCovered(OpBase *opBase) {
+	IndexScan *op = (IndexScan *)opBase;
+	EntityID nodeId;
+	SIValue v;
+	if(!OrderedIndexIter_NextValue(op->range_iter, &nodeId, &v)) return NULL;
+
+	if(SIValue_IsNull(v)) {
+		Node n;
+		assert(Graph_GetNode(op->g, nodeId, &n));
+		SIValue *property = GraphEntity_GetProperty((GraphEntity *)&n, op->covered_attr);
+		assert(property != PROPERTY_NOTFOUND);
+		v = SI_ConstValue(*property);
+	}
+
+	Record r = OpBase_CreateRecord((OpBase *)op);
+	Record_AddScalar(r, op->coveredRecIdx, v);
+	return r;
+}
+
 static OpResult IndexScanReset(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
-	RediSearch_ResultsIteratorReset(op->iter);
+	_IndexScan_ResetIterator(op);
 	return OP_OK;
 }
 
@@ -108,6 +200,21 @@ static void IndexScanFree(OpBase *opBase) {
 		op->iter = NULL;
 	}
 
+	if(op->range_iter) {
+		OrderedIndexIter_Free(op->range_iter);
+		op->range_iter = NULL;
+	}
+
+	if(op->id_stream) {
+		IDStream_Free(op->id_stream);
+		op->id_stream = NULL;
+	}
+
+	if(op->covered_alias) {
+		rm_free(op->covered_alias);
+		op->covered_alias = NULL;
+	}
+
 	if(op->child_record) {
 		OpBase_DeleteRecord(op->child_record);
 		op->child_record = NULL;
@@ -10,6 +10,7 @@
 #include "../execution_plan.h"
 #include "../../graph/graph.h"
 #include "../../index/index.h"
+#include "../../index/id_stream.h"
 #include "redisearch_api.h"
 
 typedef struct {
@@ -19,10 +20,30 @@ typedef struct {
 	const QGNode *n;
 	uint nodeRecIdx;
 	RSResultsIterator *iter;
+	OrderedIndexIter *range_iter; /* Ordered index iterator, used in place of iter if set. */
+	IDStream *id_stream;        /* Combined ordered index lookups, used in place of iter if set. */
+	char *covered_alias;        /* Alias of the covered attribute value, NULL if nodes are produced. */
+	int coveredRecIdx;          /* Covered value position within record. */
+	Attribute_ID covered_attr;  /* Attribute whose value is produced in place of the node. */
 	Record child_record;        /* The Record this op acts on if it is not a tap. */
+	double selectivity;         /* Estimated fraction of labeled nodes matched, negative if unknown. */
 } IndexScan;
 
 /* Creates a new IndexScan operation */
 OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, const QGNode *n, RSIndex *idx,
 					   RSResultsIterator *iter);
 
+/* Creates a new IndexScan operation over an ordered index range,
+ * the operation takes ownership of the iterator. */
+OpBase *NewIndexRangeScanOp(const ExecutionPlan *plan, Graph *g, const QGNode *n,
+							OrderedIndexIter *iter);
+
+/* Creates a new IndexScan operation over a stream of ordered index lookups,
+ * the operation takes ownership of the stream. */
+OpBase *NewIndexIDStreamScanOp(const ExecutionPlan *plan, Graph *g, const QGNode *n,
+							   IDStream *stream);
+
+/* Transform an ordered index range scan into an index-only scan, producing
+ * the ranged attribute's value as read from the index in place of the node.
+ * Returns the alias the value is produced under. */
+const char *IndexScanOp_Cover(IndexScan *op);
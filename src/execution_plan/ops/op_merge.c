@@ -6,11 +6,21 @@
 
 #include "op_merge.h"
 #include "op_merge_create.h"
+#include "shared/unique_constraints.h"
 #include "../../query_ctx.h"
 #include "../../schema/schema.h"
+#include "../../util/qsort.h"
+#include "../../graph/weight_matrices.h"
+#include "../../change_feed/change_feed.h"
 #include "../../arithmetic/arithmetic_expression.h"
 #include <assert.h>
 
+// Ratio between the merged label's node count and the number of input records
+// under which scanning the label is preferred over probing an index per record.
+#define MERGE_HASH_SCAN_RATIO 16
+
+#define MERGE_HASH_ISLT(a, b) ((a)->hash < (b)->hash)
+
 /* Forward declarations. */
 static OpResult MergeInit(OpBase *opBase);
 static Record MergeConsume(OpBase *opBase);
@@ -32,12 +42,35 @@ static void _UpdateIndices(GraphContext *gc, Node *n) {
 
 }
 
+// Perform necessary edge index, maintained weight matrix and interval index updates.
+static void _UpdateEdgeIndices(GraphContext *gc, Edge *e, Attribute_ID attr) {
+	int relation_id = Edge_GetRelationID(e);
+	if(relation_id == GRAPH_NO_RELATION) relation_id = Graph_GetEdgeRelation(gc->g, e);
+	if(relation_id == GRAPH_NO_RELATION) return;
+
+	WeightMatrices_Touch(gc->g, relation_id, attr, Edge_GetSrcNodeID(e), Edge_GetDestNodeID(e));
+
+	Schema *s = GraphContext_GetSchemaByID(gc, relation_id, SCHEMA_EDGE);
+	if(s->intervals) {
+		IntervalIndex_Touch(s->intervals, attr, Edge_GetSrcNodeID(e), Edge_GetDestNodeID(e));
+	}
+	if(!Schema_HasIndices(s)) return; // No indices, no need to update.
+
+	Schema_AddEdgeToIndices(s, e, true);
+}
+
 // Update the appropriate property on a graph entity.
-static void _UpdateProperty(Record r, GraphEntity *ge, EntityUpdateEvalCtx *update_ctx) {
+static void _UpdateProperty(GraphContext *gc, Record r, GraphEntity *ge, bool is_node,
+							EntityUpdateEvalCtx *update_ctx) {
 	SIValue new_value = AR_EXP_Evaluate(update_ctx->exp, r);
+	new_value = GraphContext_InternValue(gc, update_ctx->attribute_idx, new_value);
 
 	// Try to get current property value.
 	SIValue *old_value = GraphEntity_GetProperty(ge, update_ctx->attribute_idx);
+	if(is_node) {
+		GraphContext_UpdateNodeStatistics(gc, (Node *)ge, update_ctx->attribute_idx, *old_value,
+										  new_value);
+	}
 
 	if(old_value == PROPERTY_NOTFOUND) {
 		// Add new property.
@@ -46,6 +79,42 @@ static void _UpdateProperty(Record r, GraphEntity *ge, EntityUpdateEvalCtx *upda
 		// Update property.
 		GraphEntity_SetProperty(ge, update_ctx->attribute_idx, new_value);
 	}
+	ChangeFeed_PropertySet(ge, (is_node) ? GETYPE_NODE : GETYPE_EDGE, update_ctx->attribute_idx,
+						   new_value);
+}
+
+/* Fail the query if an update assigns a value taken under a uniquely
+ * constrained attribute of the node's label. Runs prior to applying any update. */
+static void _ValidateUniqueConstraints(GraphContext *gc, EntityUpdateEvalCtx *updates,
+									   Record *records, uint record_count) {
+	const Schema *violated = NULL;
+	Attribute_ID violated_attr = ATTRIBUTE_NOTFOUND;
+	UniqueClaims claims = UniqueClaims_New();
+	uint update_count = array_len(updates);
+
+	for(uint i = 0; i < record_count && !violated; i ++) {
+		Record r = records[i];
+		for(uint j = 0; j < update_count && !violated; j ++) {
+			EntityUpdateEvalCtx *update_ctx = &updates[j];
+			if(Record_GetType(r, update_ctx->record_idx) != REC_TYPE_NODE) continue;
+
+			Node *n = Record_GetNode(r, update_ctx->record_idx);
+			int label_id = Graph_GetNodeLabel(gc->g, ENTITY_GET_ID(n));
+			if(label_id == GRAPH_NO_LABEL) continue;
+			Schema *s = GraphContext_GetSchemaByID(gc, label_id, SCHEMA_NODE);
+			if(!Schema_IsUnique(s, update_ctx->attribute_idx)) continue;
+
+			SIValue v = AR_EXP_Evaluate(update_ctx->exp, r);
+			if(!UniqueClaims_Claim(&claims, s, update_ctx->attribute_idx, v, ENTITY_GET_ID(n))) {
+				violated = s;
+				violated_attr = update_ctx->attribute_idx;
+			}
+			SIValue_Free(v);
+		}
+	}
+
+	UniqueClaims_Free(&claims);
+	if(violated) UniqueConstraint_RaiseViolation(violated, violated_attr);
 }
 
 // Apply a set of updates to the given records.
@@ -61,6 +130,10 @@ static void _UpdateProperties(ResultSetStatistics *stats, EntityUpdateEvalCtx *u
 		updates[i].attribute_idx = GraphContext_FindOrAddAttribute(gc, updates[i].attribute);
 	}
 
+	// Records may hold values borrowed from the entities about to be updated, copy these first.
+	for(uint i = 0; i < record_count; i ++) Record_PersistBorrowedScalars(records[i]);
+	_ValidateUniqueConstraints(gc, updates, records, record_count);
+
 	for(uint i = 0; i < record_count; i ++) {  // For each record to update
 		Record r = records[i];
 		for(uint j = 0; j < update_count; j ++) { // For each pending update.
@@ -71,8 +144,10 @@ static void _UpdateProperties(ResultSetStatistics *stats, EntityUpdateEvalCtx *u
 			assert(t == REC_TYPE_NODE || t == REC_TYPE_EDGE);
 			GraphEntity *ge = Record_GetGraphEntity(r, update_ctx->record_idx);
 
-			_UpdateProperty(r, ge, update_ctx); // Update the entity.
-			if(t == REC_TYPE_NODE) _UpdateIndices(gc, (Node *)ge); // Update indices if necessary.
+			_UpdateProperty(gc, r, ge, t == REC_TYPE_NODE, update_ctx); // Update the entity.
+			// Update indices if necessary.
+			if(t == REC_TYPE_NODE) _UpdateIndices(gc, (Node *)ge);
+			else _UpdateEdgeIndices(gc, (Edge *)ge, update_ctx->attribute_idx);
 		}
 	}
 	if(stats) stats->properties_set += update_count * record_count;
@@ -203,6 +278,201 @@ static OpResult MergeInit(OpBase *opBase) {
 	return OP_OK;
 }
 
+/* Determine whether the pattern is a single labeled node holding
+ * a property its label constrains to be unique, in which case the
+ * pattern is resolved by probing the constraint's index. */
+static void _SetupUniqueProbe(OpMerge *op) {
+	const OpMergeCreate *merge_create = (OpMergeCreate *)_LocateOp(op->create_stream,
+																   OPType_MERGE_CREATE);
+	if(array_len(merge_create->pending.nodes_to_create) != 1 ||
+	   array_len(merge_create->pending.edges_to_create) != 0) return;
+
+	const NodeCreateCtx *node_ctx = merge_create->pending.nodes_to_create;
+	const PropertyMap *props = node_ctx->properties;
+	if(props == NULL || QGNode_LabelCount(node_ctx->node) != 1) return;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	const Schema *s = GraphContext_GetSchema(gc, node_ctx->node->labels[0], SCHEMA_NODE);
+	if(!Schema_HasUniqueConstraints(s)) return;
+
+	for(int i = 0; i < props->property_count; i++) {
+		if(!Schema_IsUnique(s, props->keys[i])) continue;
+		op->probe_node = node_ctx;
+		op->probe_schema = s;
+		op->probe_prop = i;
+		return;
+	}
+}
+
+// Values resolvable through the unique constraint's index or the label's hash.
+static inline bool _ProbableValue(SIValue v) {
+	return (SI_TYPE(v) & (SI_NUMERIC | T_STRING | T_BOOL));
+}
+
+/* Resolve the merged node through its uniquely constrained property,
+ * setting match to the matching record or NULL if the node doesn't exist.
+ * Returns false if the property value can't be probed. */
+static bool _ProbeUniqueNode(OpMerge *op, Record lhs_record, Record *match) {
+	*match = NULL;
+	const PropertyMap *props = op->probe_node->properties;
+	Attribute_ID attr = props->keys[op->probe_prop];
+
+	SIValue v = AR_EXP_Evaluate(props->values[op->probe_prop], lhs_record);
+	bool probable = _ProbableValue(v);
+	EntityID id;
+	bool found = probable &&
+				 Index_UniqueLookup(op->probe_schema->index, attr, v, INVALID_ENTITY_ID, &id);
+	SIValue_Free(v);
+	if(!found) return probable;
+
+	Node n;
+	Graph *g = QueryCtx_GetGraph();
+	assert(Graph_GetNode(g, id, &n));
+
+	// The node's remaining properties must match as well.
+	for(int i = 0; i < props->property_count; i++) {
+		if(i == op->probe_prop) continue;
+		SIValue expected = AR_EXP_Evaluate(props->values[i], lhs_record);
+		SIValue *actual = GraphEntity_GetProperty((GraphEntity *)&n, props->keys[i]);
+		int disjoint_or_null = 0;
+		bool equal = (actual != PROPERTY_NOTFOUND &&
+					  SIValue_Compare(*actual, expected, &disjoint_or_null) == 0 &&
+					  disjoint_or_null == 0);
+		SIValue_Free(expected);
+		if(!equal) return true;
+	}
+
+	*match = (lhs_record) ? OpBase_CloneRecord(lhs_record) : OpBase_CreateRecord((OpBase *)op);
+	Node *node = Record_GetNode(*match, op->probe_node->node_idx);
+	*node = n;
+	node->label = op->probe_schema->name;
+	node->labelID = op->probe_schema->id;
+	return true;
+}
+
+static XXH64_hash_t _HashValues(const SIValue *values, int count) {
+	XXH64_state_t state;
+	XXH_errorcode res = XXH64_reset(&state, 0);
+	assert(res != XXH_ERROR);
+	for(int i = 0; i < count; i++) {
+		XXH64_hash_t value_hash = SIValue_HashCode(values[i]);
+		XXH64_update(&state, &value_hash, sizeof(value_hash));
+	}
+	return XXH64_digest(&state);
+}
+
+/* Determine whether the pattern is a single labeled node merged by multiple input records,
+ * resolved by hashing the label's nodes if that's cheaper than matching each record,
+ * which scans the label unless one of the node's properties is indexed. */
+static void _SetupHashProbe(OpMerge *op) {
+	if(op->probe_node || op->input_records == NULL) return;
+	uint record_count = array_len(op->input_records);
+	if(record_count < 2) return;
+
+	const OpMergeCreate *merge_create = (OpMergeCreate *)_LocateOp(op->create_stream,
+																   OPType_MERGE_CREATE);
+	if(array_len(merge_create->pending.nodes_to_create) != 1 ||
+	   array_len(merge_create->pending.edges_to_create) != 0) return;
+
+	const NodeCreateCtx *node_ctx = merge_create->pending.nodes_to_create;
+	const PropertyMap *props = node_ctx->properties;
+	if(props == NULL || props->property_count == 0 || QGNode_LabelCount(node_ctx->node) != 1) return;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	const Schema *s = GraphContext_GetSchema(gc, node_ctx->node->labels[0], SCHEMA_NODE);
+	if(s) {
+		bool indexed = false;
+		for(int i = 0; i < props->property_count && !indexed; i++) {
+			const char *attr = GraphContext_GetAttributeString(gc, props->keys[i]);
+			indexed = (attr && Schema_GetIndex(s, attr, IDX_EXACT_MATCH));
+		}
+		if(indexed &&
+		   Graph_LabeledNodeCount(gc->g, s->id) > (size_t)record_count * MERGE_HASH_SCAN_RATIO) return;
+	}
+
+	op->hash_node = node_ctx;
+	op->hash_schema = s;
+	op->hash_entries = array_new(MergeHashEntry, 0);
+	if(s == NULL) return; // Missing label, no node matches.
+
+	// Hash the label's nodes holding probable values for all merged properties.
+	Graph *g = gc->g;
+	NodeID id;
+	IDSetIterator iter;
+	IDSet_Iterate(Graph_GetLabelIDs(g, s->id), &iter);
+	SIValue values[props->property_count];
+	while(IDSetIterator_Next(&iter, &id)) {
+		Node n;
+		Graph_GetNode(g, id, &n);
+		bool probable = true;
+		for(int i = 0; i < props->property_count && probable; i++) {
+			SIValue *v = GraphEntity_GetProperty((GraphEntity *)&n, props->keys[i]);
+			probable = (v != PROPERTY_NOTFOUND && _ProbableValue(*v));
+			if(probable) values[i] = *v;
+		}
+		if(!probable) continue;
+
+		MergeHashEntry entry = {.hash = _HashValues(values, props->property_count), .id = id};
+		op->hash_entries = array_append(op->hash_entries, entry);
+	}
+
+	QSORT(MergeHashEntry, op->hash_entries, array_len(op->hash_entries), MERGE_HASH_ISLT);
+}
+
+/* Resolve the merged node through the label's hash, appending a record for each
+ * matching node to the output records and setting matched to their number.
+ * Returns false if the property values can't be probed. */
+static bool _HashProbeNode(OpMerge *op, Record lhs_record, uint *matched) {
+	*matched = 0;
+	const PropertyMap *props = op->hash_node->properties;
+	SIValue values[props->property_count];
+	bool probable = true;
+	for(int i = 0; i < props->property_count; i++) {
+		values[i] = AR_EXP_Evaluate(props->values[i], lhs_record);
+		probable &= _ProbableValue(values[i]);
+	}
+
+	if(probable) {
+		// Locate the first node sharing the values' hash.
+		XXH64_hash_t hash = _HashValues(values, props->property_count);
+		uint lo = 0;
+		uint hi = array_len(op->hash_entries);
+		while(lo < hi) {
+			uint mid = lo + (hi - lo) / 2;
+			if(op->hash_entries[mid].hash < hash) lo = mid + 1;
+			else hi = mid;
+		}
+
+		Graph *g = QueryCtx_GetGraph();
+		uint entry_count = array_len(op->hash_entries);
+		for(uint i = lo; i < entry_count && op->hash_entries[i].hash == hash; i++) {
+			Node n;
+			Graph_GetNode(g, op->hash_entries[i].id, &n);
+			// Nodes sharing a hash might hold different values.
+			bool equal = true;
+			for(int j = 0; j < props->property_count && equal; j++) {
+				SIValue *actual = GraphEntity_GetProperty((GraphEntity *)&n, props->keys[j]);
+				int disjoint_or_null = 0;
+				equal = (actual != PROPERTY_NOTFOUND &&
+						 SIValue_Compare(*actual, values[j], &disjoint_or_null) == 0 &&
+						 disjoint_or_null == 0);
+			}
+			if(!equal) continue;
+
+			Record match = OpBase_CloneRecord(lhs_record);
+			Node *node = Record_GetNode(match, op->hash_node->node_idx);
+			*node = n;
+			node->label = op->hash_schema->name;
+			node->labelID = op->hash_schema->id;
+			op->output_records = array_append(op->output_records, match);
+			(*matched)++;
+		}
+	}
+
+	for(int i = 0; i < props->property_count; i++) SIValue_Free(values[i]);
+	return probable;
+}
+
 static Record _handoff(OpMerge *op) {
 	Record r = NULL;
 	if(array_len(op->output_records)) r = array_pop(op->output_records);
@@ -217,6 +487,7 @@ static Record MergeConsume(OpBase *opBase) {
 
 	// Consume mode.
 	op->output_records = array_new(Record, 32);
+	_SetupUniqueProbe(op);
 	// If we have a bound variable stream, pull from it and store records until depleted.
 	if(op->bound_variable_stream) {
 		Record input_record;
@@ -224,6 +495,7 @@ static Record MergeConsume(OpBase *opBase) {
 			op->input_records = array_append(op->input_records, input_record);
 		}
 	}
+	_SetupHashProbe(op);
 
 	bool must_create_records = false;
 	bool reading_matches = true;
@@ -239,9 +511,6 @@ static Record MergeConsume(OpBase *opBase) {
 
 			// Pull a new input record.
 			lhs_record = array_pop(op->input_records);
-			// Propagate record to the top of the Match stream.
-			// (Must clone the Record, as it will be freed in the Match stream.)
-			Argument_AddRecord(op->match_argument_tap, OpBase_CloneRecord(lhs_record));
 		} else {
 			// This loop only executes once if we don't have input records resolving bound variables.
 			reading_matches = false;
@@ -249,12 +518,29 @@ static Record MergeConsume(OpBase *opBase) {
 
 		bool should_create_pattern = true;
 		Record rhs_record;
-		// Retrieve Records from the Match stream until it's depleted.
-		while((rhs_record = _pullFromStream(op->match_stream))) {
-			// Pattern was successfully matched.
-			should_create_pattern = false;
-			op->output_records = array_append(op->output_records, rhs_record);
-			match_count++;
+		uint matched;
+		if(op->probe_node && _ProbeUniqueNode(op, lhs_record, &rhs_record)) {
+			// Pattern resolved through the unique constraint's index.
+			if(rhs_record) {
+				should_create_pattern = false;
+				op->output_records = array_append(op->output_records, rhs_record);
+				match_count++;
+			}
+		} else if(op->hash_node && _HashProbeNode(op, lhs_record, &matched)) {
+			// Pattern resolved through the label's hash.
+			should_create_pattern = (matched == 0);
+			match_count += matched;
+		} else {
+			// Propagate record to the top of the Match stream.
+			// (Must clone the Record, as it will be freed in the Match stream.)
+			if(lhs_record) Argument_AddRecord(op->match_argument_tap, OpBase_CloneRecord(lhs_record));
+			// Retrieve Records from the Match stream until it's depleted.
+			while((rhs_record = _pullFromStream(op->match_stream))) {
+				// Pattern was successfully matched.
+				should_create_pattern = false;
+				op->output_records = array_append(op->output_records, rhs_record);
+				match_count++;
+			}
 		}
 
 		if(should_create_pattern) {
@@ -320,6 +606,11 @@ static OpBase *MergeClone(const ExecutionPlan *plan, const OpBase *opBase) {
 
 static void MergeFree(OpBase *opBase) {
 	OpMerge *op = (OpMerge *)opBase;
+	if(op->hash_entries) {
+		array_free(op->hash_entries);
+		op->hash_entries = NULL;
+	}
+
 	if(op->input_records) {
 		uint input_count = array_len(op->input_records);
 		for(uint i = 0; i < input_count; i ++) {
@@ -9,8 +9,15 @@
 #include "op.h"
 #include "op_argument.h"
 #include "../execution_plan.h"
+#include "../../schema/schema.h"
 #include "../../resultset/resultset_statistics.h"
 
+// A node of the merged label, keyed by the hash of the merged properties.
+typedef struct {
+	XXH64_hash_t hash;  // Hash of the node's values of the merged properties.
+	NodeID id;          // Node ID.
+} MergeHashEntry;
+
 /* The Merge operation accepts exactly one path in the query and attempts to match it.
  * If the path is not found, it will be created, making new instances of every path variable
  * not bound in an earlier clause in the query. */
@@ -26,6 +33,16 @@ typedef struct {
 	EntityUpdateEvalCtx *on_match;    // Updates to be performed on a successful match.
 	EntityUpdateEvalCtx *on_create;   // Updates to be performed on creation.
 	ResultSetStatistics *stats;       // Required for tracking statistics updates in ON MATCH.
+	/* A single node pattern holding a uniquely constrained property
+	 * is resolved by probing the constraint's index instead of the Match stream. */
+	const NodeCreateCtx *probe_node;  // Merged node.
+	const Schema *probe_schema;       // Schema of the merged node's label.
+	int probe_prop;                   // Position of the constrained property within the node's properties.
+	/* Otherwise, a single node pattern merged by many input records is resolved
+	 * through a hash of the label's nodes, built by a single scan of the label. */
+	const NodeCreateCtx *hash_node;   // Merged node.
+	const Schema *hash_schema;        // Schema of the merged node's label.
+	MergeHashEntry *hash_entries;     // Nodes of the label, sorted by hash.
 } OpMerge;
 
 OpBase *NewMergeOp(const ExecutionPlan *plan, EntityUpdateEvalCtx *on_match,
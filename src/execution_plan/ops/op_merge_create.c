@@ -47,6 +47,8 @@ static void _RollbackPendingCreations(OpMergeCreate *op) {
 	uint edges_to_create_count = array_len(op->pending.edges_to_create);
 	for(uint i = 0; i < edges_to_create_count; i++) {
 		array_pop(op->pending.created_edges);
+		array_pop(op->pending.edge_srcs);
+		array_pop(op->pending.edge_dests);
 		PendingProperties *props = array_pop(op->pending.edge_properties);
 		PendingPropertiesFree(props);
 	}
@@ -154,6 +156,8 @@ static bool _CreateEntities(OpMergeCreate *op, Record r) {
 
 		/* Save edge for later insertion. */
 		op->pending.created_edges = array_append(op->pending.created_edges, newEdge);
+		op->pending.edge_srcs = array_append(op->pending.edge_srcs, src_node);
+		op->pending.edge_dests = array_append(op->pending.edge_dests, dest_node);
 
 		/* Save properties to insert with node. */
 		op->pending.edge_properties = array_append(op->pending.edge_properties, converted_properties);
@@ -7,6 +7,9 @@
 #include "op_node_by_id_seek.h"
 #include "shared/print_functions.h"
 #include "../../query_ctx.h"
+#include "../../util/arr.h"
+#include "../../util/qsort.h"
+#include "../../access_stats/access_stats.h"
 
 /* Forward declarations. */
 static OpResult NodeByIdSeekInit(OpBase *opBase);
@@ -34,6 +37,8 @@ OpBase *NewNodeByIdSeekOp(const ExecutionPlan *plan, const QGNode *n, UnsignedRa
 	op->g = QueryCtx_GetGraph();
 	op->n = n;
 	op->child_record = NULL;
+	op->ids = NULL;
+	op->idIdx = 0;
 
 	op->minId = id_range->include_min ? id_range->min : id_range->min + 1;
 	/* The largest possible entity ID is the same as Graph_RequiredMatrixDim.
@@ -52,6 +57,22 @@ OpBase *NewNodeByIdSeekOp(const ExecutionPlan *plan, const QGNode *n, UnsignedRa
 	return (OpBase *)op;
 }
 
+void NodeByIdSeekOp_SetIDs(NodeByIdSeek *op, NodeID *ids) {
+	if(op->ids) array_free(op->ids);
+	// Sort and deduplicate, such that each node is produced once and seeks stop past maxId.
+	uint count = array_len(ids);
+#define islt(a,b) (*a < *b)
+	QSORT(NodeID, ids, count, islt);
+#undef islt
+	uint unique = 0;
+	for(uint i = 0; i < count; i++) {
+		if(unique == 0 || ids[unique - 1] != ids[i]) ids[unique++] = ids[i];
+	}
+	ids = array_trimm_len(ids, unique);
+	op->ids = ids;
+	op->idIdx = 0;
+}
+
 static OpResult NodeByIdSeekInit(OpBase *opBase) {
 	assert(opBase->type == OPType_NODE_BY_ID_SEEK);
 	NodeByIdSeek *op = (NodeByIdSeek *)opBase;
@@ -64,18 +85,33 @@ static OpResult NodeByIdSeekInit(OpBase *opBase) {
 static inline Node _SeekNextNode(NodeByIdSeek *op) {
 	Node n = { .entity = NULL };
 
-	/* As long as we're within range bounds
-	 * and we've yet to get a node. */
-	while(!_outOfBounds(op)) {
-		if(Graph_GetNode(op->g, op->currentId, &n)) break;
+	if(op->ids) {
+		// Seek the listed IDs within range bounds.
+		uint count = array_len(op->ids);
+		while(op->idIdx < count) {
+			NodeID id = op->ids[op->idIdx++];
+			if(id < op->minId) continue;
+			if(id > op->maxId) {
+				op->idIdx = count;
+				break;
+			}
+			if(Graph_GetNode(op->g, id, &n)) break;
+		}
+	} else {
+		/* As long as we're within range bounds
+		 * and we've yet to get a node. */
+		while(!_outOfBounds(op)) {
+			if(Graph_GetNode(op->g, op->currentId, &n)) break;
+			op->currentId++;
+		}
+
+		// Advance id for next consume call.
 		op->currentId++;
 	}
 
-	// Advance id for next consume call.
-	op->currentId++;
-
 	// Did we manage to get an entity?
 	if(!n.entity) return n;
+	AccessStats_Touch(ACCESS_NODE, ENTITY_GET_ID(&n));
 	// Null-set the label in case an operation (like op_delete) accesses it.
 	// TODO If we're replacing a label scan, the correct label can be populated now.
 	n.label = NULL;
@@ -133,12 +169,13 @@ static Record NodeByIdSeekConsume(OpBase *opBase) {
 static OpResult NodeByIdSeekReset(OpBase *ctx) {
 	NodeByIdSeek *op = (NodeByIdSeek *)ctx;
 	op->currentId = op->minId;
+	op->idIdx = 0;
 	return OP_OK;
 }
 
 static OpBase *NodeByIdSeekClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	assert(opBase->type == OPType_NODE_BY_ID_SEEK);
-	NodeByIdSeek *op = (NodeByIdSeek *)op;
+	NodeByIdSeek *op = (NodeByIdSeek *)opBase;
 	UnsignedRange range;
 	range.min = op->minId;
 	range.max = op->maxId;
@@ -150,7 +187,13 @@ static OpBase *NodeByIdSeekClone(const ExecutionPlan *plan, const OpBase *opBase
 	 * the clone will set its values to be the same as in the origin. */
 	range.include_min = true;
 	range.include_max = true;
-	return NewNodeByIdSeekOp(plan, op->n, &range);
+	OpBase *clone = NewNodeByIdSeekOp(plan, op->n, &range);
+	if(op->ids) {
+		NodeID *ids;
+		array_clone(ids, op->ids);
+		NodeByIdSeekOp_SetIDs((NodeByIdSeek *)clone, ids);
+	}
+	return clone;
 }
 
 static void NodeByIdSeekFree(OpBase *opBase) {
@@ -159,5 +202,9 @@ static void NodeByIdSeekFree(OpBase *opBase) {
 		OpBase_DeleteRecord(op->child_record);
 		op->child_record = NULL;
 	}
+	if(op->ids) {
+		array_free(op->ids);
+		op->ids = NULL;
+	}
 }
 
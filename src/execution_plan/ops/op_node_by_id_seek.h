@@ -22,8 +22,14 @@ typedef struct {
 	NodeID currentId;       // Current ID fetched.
 	NodeID minId;           // Min ID to fetch.
 	NodeID maxId;           // Max ID to fetch.
+	NodeID *ids;            // Sorted IDs to fetch within range, NULL to fetch the entire range.
+	uint idIdx;             // Position of the next ID to fetch.
 	int nodeRecIdx;         // Position of entity within record.
 } NodeByIdSeek;
 
 OpBase *NewNodeByIdSeekOp(const ExecutionPlan *plan, const QGNode *n, UnsignedRange *id_range);
 
+/* Restrict the seek to the given IDs within its range, e.g. id(n) IN [1, 5, 9].
+ * The op takes ownership of the ids array. */
+void NodeByIdSeekOp_SetIDs(NodeByIdSeek *op, NodeID *ids);
+
@@ -8,6 +8,7 @@
 #include "shared/print_functions.h"
 #include "../../ast/ast.h"
 #include "../../query_ctx.h"
+#include "../../access_stats/access_stats.h"
 
 /* Forward declarations. */
 static OpResult NodeByLabelScanInit(OpBase *opBase);
@@ -27,7 +28,7 @@ OpBase *NewNodeByLabelScanOp(const ExecutionPlan *plan, const QGNode *n) {
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	op->g = gc->g;
 	op->n = n;
-	op->iter = NULL;
+	op->iter.set = NULL;
 	op->child_record = NULL;
 	// Defaults to [0...UINT64_MAX].
 	op->id_range = UnsignedRange_New();
@@ -50,12 +51,24 @@ void NodeByLabelScanOp_SetIDRange(NodeByLabelScan *op, UnsignedRange *id_range)
 	op->op.name = "Node By Label and ID Scan";
 }
 
-static GrB_Info _ConstructIterator(NodeByLabelScan *op, Schema *schema) {
+// Positions the iterator on the first node of its label within the ID range.
+static void _ResetIterator(NodeByLabelScan *op) {
+	const UnsignedRange *r = op->id_range;
+	NodeID minId = r->include_min ? r->min : r->min + 1;
+	NodeID maxId = r->include_max ? r->max : r->max - 1;
+	// Exclusive bounds at the edges of the ID domain leave no ID to scan.
+	if((!r->include_min && r->min == UINT64_MAX) || (!r->include_max && r->max == 0)) {
+		minId = 1;
+		maxId = 0;
+	}
+	IDSet_IterateRange(op->iter.set, &op->iter, minId, maxId);
+}
+
+static void _ConstructIterator(NodeByLabelScan *op, Schema *schema) {
 	GraphContext *gc = QueryCtx_GetGraphCtx();
-	GxB_MatrixTupleIter_new(&op->iter, Graph_GetLabelMatrix(gc->g, schema->id));
-	NodeID minId = op->id_range->include_min ? op->id_range->min : op->id_range->min + 1;
-	NodeID maxId = op->id_range->include_max ? op->id_range->max : op->id_range->max - 1;
-	return GxB_MatrixTupleIter_iterate_range(op->iter, minId, maxId);
+	op->iter.set = Graph_GetLabelIDs(gc->g, schema->id);
+	AccessStats_Touch(ACCESS_LABEL, schema->id);
+	_ResetIterator(op);
 }
 
 static OpResult NodeByLabelScanInit(OpBase *opBase) {
@@ -77,14 +90,7 @@ static OpResult NodeByLabelScanInit(OpBase *opBase) {
 		return OP_OK;
 	}
 
-	// The iterator build may fail if the ID range does not match the matrix dimensions.
-	GrB_Info iterator_built = _ConstructIterator(op, schema);
-	if(iterator_built != GrB_SUCCESS) {
-		// Invalid range, use the NOP consume function.
-		OpBase_UpdateConsume(opBase, NodeByLabelScanNoOp);
-		return OP_OK;
-	}
-
+	_ConstructIterator(op, schema);
 	return OP_OK;
 }
 
@@ -93,12 +99,7 @@ static inline void _UpdateRecord(NodeByLabelScan *op, Record r, GrB_Index node_i
 	Node *n = Record_GetNode(r, op->nodeRecIdx);
 	// Populate the Record with the graph entity data.
 	Graph_GetNode(op->g, node_id, n);
-}
-
-static inline void _ResetIterator(NodeByLabelScan *op) {
-	NodeID minId = op->id_range->include_min ? op->id_range->min : op->id_range->min + 1;
-	NodeID maxId = op->id_range->include_max ? op->id_range->max : op->id_range->max - 1 ;
-	GxB_MatrixTupleIter_iterate_range(op->iter, minId, maxId);
+	AccessStats_Touch(ACCESS_NODE, node_id);
 }
 
 static Record NodeByLabelScanConsumeFromChild(OpBase *opBase) {
@@ -106,12 +107,11 @@ static Record NodeByLabelScanConsumeFromChild(OpBase *opBase) {
 
 	// Try to get new nodeID.
 	GrB_Index nodeId;
-	bool depleted = true;
-	GxB_MatrixTupleIter_next(op->iter, NULL, &nodeId, &depleted);
+	bool depleted = (op->iter.set == NULL || !IDSetIterator_Next(&op->iter, &nodeId));
 	/* depleted will be true in the following cases:
-	 * 1. No iterator: GxB_MatrixTupleIter_next will fail and depleted will stay true. This scenario means
-	 * that there was no consumption of a record from a child, otherwise there was an iterator.
-	 * 2. Iterator depleted - For every child record the iterator finished the entire matrix scan and it needs to restart. */
+	 * 1. No iterator: This scenario means that there was no consumption of a record from a child,
+	 * otherwise there was an iterator.
+	 * 2. Iterator depleted - For every child record the iterator finished the entire label scan and it needs to restart. */
 	while(depleted) {
 		// Try to get a record.
 		if(op->child_record) OpBase_DeleteRecord(op->child_record);
@@ -120,20 +120,20 @@ static Record NodeByLabelScanConsumeFromChild(OpBase *opBase) {
 		if(op->child_record == NULL) return NULL;
 
 		// Got a record.
-		if(!op->iter) {
+		if(op->iter.set == NULL) {
 			// Iterator wasn't set up until now.
 			GraphContext *gc = QueryCtx_GetGraphCtx();
 			Schema *schema = GraphContext_GetSchema(gc, op->n->label, SCHEMA_NODE);
-			// No label matrix, it might be created in the next iteration.
+			// No label, it might be created in the next iteration.
 			if(!schema) continue;
-			_ConstructIterator(op, schema); // OK to fail (invalid range) iter will be depleted.
+			_ConstructIterator(op, schema);
 		} else {
 			// Iterator depleted - reset.
-			// TODO: GxB_MatrixTupleIter_reset
 			_ResetIterator(op);
+			if(op->n->labelID >= 0) AccessStats_Touch(ACCESS_LABEL, op->n->labelID);
 		}
 		// Try to get new NodeID.
-		GxB_MatrixTupleIter_next(op->iter, NULL, &nodeId, &depleted);
+		depleted = !IDSetIterator_Next(&op->iter, &nodeId);
 	}
 
 	// We've got a record and NodeID.
@@ -148,9 +148,7 @@ static Record NodeByLabelScanConsume(OpBase *opBase) {
 	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 
 	GrB_Index nodeId;
-	bool depleted = false;
-	GxB_MatrixTupleIter_next(op->iter, NULL, &nodeId, &depleted);
-	if(depleted) return NULL;
+	if(!IDSetIterator_Next(&op->iter, &nodeId)) return NULL;
 
 	Record r = OpBase_CreateRecord((OpBase *)op);
 
@@ -172,24 +170,26 @@ static OpResult NodeByLabelScanReset(OpBase *ctx) {
 		OpBase_DeleteRecord(op->child_record); // Free old record.
 		op->child_record = NULL;
 	}
-	_ResetIterator(op);
+	if(op->iter.set) _ResetIterator(op);
 	return OP_OK;
 }
 
 static OpBase *NodeByLabelScanClone(const ExecutionPlan *plan, const OpBase *opBase) {
-	assert(opBase->type == OPType_NODE_BY_LABEL_SCAN);
+	assert(opBase->type == OPType_NODE_BY_LABEL_SCAN ||
+		   opBase->type == OpType_NODE_BY_LABEL_AND_ID_SCAN);
 	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 	OpBase *clone = NewNodeByLabelScanOp(plan, op->n);
+	// Retain the ID range set by the seek by ID optimization.
+	if(opBase->type == OpType_NODE_BY_LABEL_AND_ID_SCAN) {
+		NodeByLabelScanOp_SetIDRange((NodeByLabelScan *)clone, op->id_range);
+	}
 	return clone;
 }
 
 static void NodeByLabelScanFree(OpBase *op) {
 	NodeByLabelScan *nodeByLabelScan = (NodeByLabelScan *)op;
 
-	if(nodeByLabelScan->iter) {
-		GxB_MatrixTupleIter_free(nodeByLabelScan->iter);
-		nodeByLabelScan->iter = NULL;
-	}
+	nodeByLabelScan->iter.set = NULL;
 
 	if(nodeByLabelScan->child_record) {
 		OpBase_DeleteRecord(nodeByLabelScan->child_record);
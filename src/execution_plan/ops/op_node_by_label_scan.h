@@ -21,7 +21,7 @@ typedef struct {
 	const QGNode *n;            /* Node being scanned. */
 	unsigned int nodeRecIdx;    /* Node position within record. */
 	UnsignedRange *id_range;    /* ID range to iterate over. */
-	GxB_MatrixTupleIter *iter;
+	IDSetIterator iter;         /* Iterator over the label's node IDs. */
 	Record child_record;        /* The Record this op acts on if it is not a tap. */
 } NodeByLabelScan;
 
@@ -8,13 +8,25 @@
 #include "../../util/arr.h"
 #include "../../util/rmalloc.h"
 #include "../../query_ctx.h"
+#include <inttypes.h>
 
 /* Forward declarations. */
 static Record ProcCallConsume(OpBase *opBase);
 static OpResult ProcCallReset(OpBase *opBase);
 static OpBase *ProcCallClone(const ExecutionPlan *plan, const OpBase *opBase);
+static int ProcCallToString(const OpBase *ctx, char *buf, uint buf_len);
 static void ProcCallFree(OpBase *opBase);
 
+/* Retrieves a fresh procedure context, informed of the outputs
+ * yielded and of the number of records consumed. */
+static ProcedureCtx *_getProcedure(OpProcCall *op, const char *proc_name) {
+	ProcedureCtx *proc = Proc_Get(proc_name);
+	if(!proc) return NULL;
+	Proc_SetYields(proc, op->output, array_len(op->output));
+	Proc_SetLimit(proc, op->limit);
+	return proc;
+}
+
 static Record _yield(OpProcCall *op) {
 	SIValue *outputs = Proc_Step(op->procedure);
 	if(outputs == NULL) return NULL;
@@ -72,6 +84,7 @@ OpBase *NewProcCallOp(const ExecutionPlan *plan, const char *proc_name, AR_ExpNo
 	op->arg_exps = arg_exps;
 	op->yield_map = NULL;
 	op->yield_exps = yield_exps;
+	op->limit = 0;
 	op->first_call = true;
 	op->arg_count = array_len(arg_exps);
 	op->args = array_new(SIValue, op->arg_count);
@@ -85,7 +98,7 @@ OpBase *NewProcCallOp(const ExecutionPlan *plan, const char *proc_name, AR_ExpNo
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_PROC_CALL, "ProcedureCall", NULL, ProcCallConsume,
-				ProcCallReset, NULL, ProcCallClone, ProcCallFree, !op->procedure->readOnly, plan);
+				ProcCallReset, ProcCallToString, ProcCallClone, ProcCallFree, !op->procedure->readOnly, plan);
 
 	// Set modifiers.
 	for(uint i = 0; i < yield_count; i ++) {
@@ -100,6 +113,24 @@ OpBase *NewProcCallOp(const ExecutionPlan *plan, const char *proc_name, AR_ExpNo
 	return (OpBase *)op;
 }
 
+void ProcCallOp_SetLimit(OpProcCall *op, uint64_t limit) {
+	assert(op);
+	op->limit = limit;
+}
+
+// Procedures bounded by a limit produce at most limit records, as presented by EXPLAIN.
+static int ProcCallToString(const OpBase *ctx, char *buf, uint buf_len) {
+	const OpProcCall *op = (const OpProcCall *)ctx;
+	if(!op->limit) return snprintf(buf, buf_len, "%s", ctx->name);
+	return snprintf(buf, buf_len, "%s | Limit %" PRIu64, ctx->name, op->limit);
+}
+
+// Procedures modifying the graph commit once depleted, releasing the commit locks they hold.
+static Record _depleted(OpProcCall *op) {
+	if(op->op.writer) QueryCtx_UnlockCommit((OpBase *)op);
+	return NULL;
+}
+
 static Record ProcCallConsume(OpBase *opBase) {
 	OpProcCall *op = (OpProcCall *)opBase;
 
@@ -113,13 +144,13 @@ static Record ProcCallConsume(OpBase *opBase) {
 
 		if(op->op.childCount == 0) {
 			// "Static evaluation", return data for first call only!
-			if(!op->first_call) return NULL;
+			if(!op->first_call) return _depleted(op);
 			op->first_call = false;
 			op->r = OpBase_CreateRecord((OpBase *)op);
 		} else {
 			OpBase *child = op->op.children[0];
 			op->r = OpBase_Consume(child);
-			if(!op->r) return NULL;
+			if(!op->r) return _depleted(op);
 		}
 
 		// Evaluate arguments, free args from previous call.
@@ -135,11 +166,11 @@ static Record ProcCallConsume(OpBase *opBase) {
 		 * TODO: replace with Proc_Reset */
 		const char *proc_name = op->procedure->name;
 		Proc_Free(op->procedure);
-		op->procedure = Proc_Get(proc_name);
+		op->procedure = _getProcedure(op, proc_name);
 		ProcedureResult res = Proc_Invoke(op->procedure, op->args);
 		/* TODO: should rise run-time exception?
 		 * op->r will be freed in ProcCallFree. */
-		if(res != PROCEDURE_OK) return NULL;
+		if(res != PROCEDURE_OK) return _depleted(op);
 	}
 
 	return yield_record;
@@ -158,7 +189,10 @@ static OpBase *ProcCallClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	AR_ExpNode **yield_exps;
 	array_clone_with_cb(args_exp, op->arg_exps, AR_EXP_Clone);
 	array_clone_with_cb(yield_exps, op->yield_exps, AR_EXP_Clone);
-	return NewProcCallOp(plan, op->procedure->name, args_exp, yield_exps);
+	OpProcCall *clone = (OpProcCall *)NewProcCallOp(plan, op->procedure->name, args_exp,
+													yield_exps);
+	ProcCallOp_SetLimit(clone, op->limit);
+	return (OpBase *)clone;
 }
 
 static void ProcCallFree(OpBase *ctx) {
@@ -30,6 +30,7 @@ typedef struct {
     AR_ExpNode **yield_exps;    // Yield expressions.
 	ProcedureCtx *procedure;    // Procedure to call.
 	OutputMap *yield_map;       // Maps between yield to procedure output and record idx.
+	uint64_t limit;             // Records required per invocation, 0 for unbounded.
     bool first_call;            // Indicate first call.
 } OpProcCall;
 
@@ -39,3 +40,7 @@ OpBase *NewProcCallOp(
     AR_ExpNode **arg_exps,          // Arguments passed to procedure invocation.
 	AR_ExpNode **yield_exps     // Procedure output.
 );
+
+/* Bounds the number of records each procedure invocation produces,
+ * as no more than limit records are consumed by the op's parent. */
+void ProcCallOp_SetLimit(OpProcCall *op, uint64_t limit);
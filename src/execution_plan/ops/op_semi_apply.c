@@ -6,6 +6,7 @@
 
 #include "op_semi_apply.h"
 #include "../execution_plan.h"
+#include "../../util/arr.h"
 
 // Forward declarations.
 static OpResult SemiApplyInit(OpBase *opBase);
@@ -19,12 +20,34 @@ static inline Record _pullFromMatchStream(OpSemiApply *op) {
 	return OpBase_Consume(op->match_branch);
 }
 
-OpBase *NewSemiApplyOp(const ExecutionPlan *plan, bool anti) {
+/* Returns whether the match branch produces data for the bound record,
+ * evaluating the branch only for bound values not seen before. */
+static bool _matchBranchProduces(OpSemiApply *op) {
+	uint64_t hash;
+	bool produces;
+	bool cacheable = op->cache && ArgumentCache_Hash(op->cache, op->r, &hash);
+	if(cacheable && ArgumentCache_Get(op->cache, op->r, hash, &produces)) return produces;
+
+	// Propagate Record to the top of the Match stream.
+	// (Must clone the Record, as it will be freed in the Match stream.)
+	if(op->op_arg) Argument_AddRecord(op->op_arg, OpBase_CloneRecord(op->r));
+	Record rhs_record = _pullFromMatchStream(op);
+	// Reset the match branch to maintain parity with the bound branch.
+	OpBase_PropagateReset(op->match_branch);
+
+	produces = (rhs_record != NULL);
+	if(rhs_record) OpBase_DeleteRecord(rhs_record);
+	if(cacheable) ArgumentCache_Add(op->cache, op->r, hash, produces);
+	return produces;
+}
+
+OpBase *NewSemiApplyOp(const ExecutionPlan *plan, bool anti, const char **keys) {
 	OpSemiApply *op = rm_malloc(sizeof(OpSemiApply));
 	op->r = NULL;
 	op->op_arg = NULL;
 	op->bound_branch = NULL;
 	op->match_branch = NULL;
+	op->cache = NULL;
 	// Set our Op operations
 	if(anti) {
 		OpBase_Init((OpBase *)op, OpType_ANTI_SEMI_APPLY, "Anti Semi Apply", SemiApplyInit,
@@ -33,6 +56,17 @@ OpBase *NewSemiApplyOp(const ExecutionPlan *plan, bool anti) {
 		OpBase_Init((OpBase *)op, OPType_SEMI_APPLY, "Semi Apply", SemiApplyInit, SemiApplyConsume,
 					SemiApplyReset, NULL, SemiApplyClone, SemiApplyFree, false, plan);
 	}
+
+	if(keys) {
+		uint key_count = array_len(keys);
+		uint offsets[key_count];
+		for(uint i = 0; i < key_count; i++) {
+			int record_idx;
+			assert(OpBase_Aware((OpBase *)op, keys[i], &record_idx));
+			offsets[i] = record_idx;
+		}
+		op->cache = ArgumentCache_New(offsets, key_count);
+	}
 	return (OpBase *) op;
 }
 
@@ -61,16 +95,9 @@ static Record SemiApplyConsume(OpBase *opBase) {
 		// Try to get a record from bound stream.
 		op->r = OpBase_Consume(op->bound_branch);
 		if(!op->r) return NULL; // Depleted.
-		// Propagate Record to the top of the Match stream.
-		if(op->op_arg) Argument_AddRecord(op->op_arg, OpBase_CloneRecord(op->r));
-
-		Record rhs_record = _pullFromMatchStream(op);
-		// Reset the match branch to maintain parity with the bound branch.
-		OpBase_PropagateReset(op->match_branch);
-		if(rhs_record) {
-			/* Successfully retrieved a Record from the match stream,
-			 * free it and return the bound Record. */
-			OpBase_DeleteRecord(rhs_record);
+
+		if(_matchBranchProduces(op)) {
+			// The match stream produced data, return the bound Record.
 			Record r = op->r;
 			op->r = NULL;   // Null to avoid double free.
 			return r;
@@ -90,18 +117,10 @@ static Record AntiSemiApplyConsume(OpBase *opBase) {
 		op->r = OpBase_Consume(op->bound_branch);
 		if(!op->r) return NULL; // Depleted.
 
-		// Propagate record to the top of the Match stream.
-		// (Must clone the Record, as it will be freed in the Match stream.)
-		if(op->op_arg) Argument_AddRecord(op->op_arg, OpBase_CloneRecord(op->r));
 		/* Try to pull data from the right stream,
 		 * returning the bound stream record if unsuccessful. */
-		Record rhs_record = _pullFromMatchStream(op);
-		// Reset the match branch to maintain parity with the bound branch.
-		OpBase_PropagateReset(op->match_branch);
-		if(rhs_record) {
-			/* Successfully retrieved a Record from the match stream,
-			 * free it and pull again from the bound stream. */
-			OpBase_DeleteRecord(rhs_record);
+		if(_matchBranchProduces(op)) {
+			// The match stream produced data, pull again from the bound stream.
 			OpBase_DeleteRecord(op->r);
 		} else {
 			// Right stream returned NULL, return left handside record.
@@ -118,6 +137,8 @@ static OpResult SemiApplyReset(OpBase *opBase) {
 		OpBase_DeleteRecord(op->r);
 		op->r = NULL;
 	}
+	// The graph may have changed since outcomes were cached.
+	if(op->cache) ArgumentCache_Clear(op->cache);
 	return OP_OK;
 }
 
@@ -125,12 +146,21 @@ static inline OpBase *SemiApplyClone(const ExecutionPlan *plan, const OpBase *op
 	assert(opBase->type == OPType_SEMI_APPLY || opBase->type == OpType_ANTI_SEMI_APPLY);
 	OpSemiApply *op = (OpSemiApply *)opBase;
 	bool anti = opBase->type == OpType_ANTI_SEMI_APPLY;
-	return NewSemiApplyOp(plan, anti);
+	OpSemiApply *clone = (OpSemiApply *)NewSemiApplyOp(plan, anti, NULL);
+	if(op->cache) {
+		clone->cache = ArgumentCache_New(op->cache->offsets, array_len(op->cache->offsets));
+	}
+	return (OpBase *)clone;
 }
 
 static void SemiApplyFree(OpBase *opBase) {
 	OpSemiApply *op = (OpSemiApply *)opBase;
 
+	if(op->cache) {
+		ArgumentCache_Free(op->cache);
+		op->cache = NULL;
+	}
+
 	if(op->r) {
 		OpBase_DeleteRecord(op->r);
 		op->r = NULL;
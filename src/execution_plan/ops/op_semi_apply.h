@@ -8,6 +8,7 @@
 
 #include "op.h"
 #include "op_argument.h"
+#include "shared/argument_cache.h"
 #include "../execution_plan.h"
 
 /* SemiApply operation tests for the presence of a pattern
@@ -18,7 +19,9 @@
  * Anti Semi Apply: Starts by pulling on the main execution plan branch,
  * for each record received it tries to get a record from the match branch
  * if no data is produced the main execution plan branch record is passed onward
- * otherwise it will try to fetch a new data point from the main execution plan branch. */
+ * otherwise it will try to fetch a new data point from the main execution plan branch.
+ * Both memoize whether the match branch produced data per distinct values of
+ * the bound variables the pattern references, evaluating the branch once per values. */
 
 typedef struct OpSemiApply {
 	OpBase op;
@@ -26,6 +29,9 @@ typedef struct OpSemiApply {
 	OpBase *bound_branch;           // Bound branch root;
 	OpBase *match_branch;           // Match branch root;
 	Argument *op_arg;               // Match branch tap.
+	ArgumentCache *cache;           // Match branch outcome per referenced bound values.
 } OpSemiApply;
 
-OpBase *NewSemiApplyOp(const ExecutionPlan *plan, bool anti);
+/* Creates a semi apply op, keys are the bound variables referenced by the match branch.
+ * NULL keys disables caching. */
+OpBase *NewSemiApplyOp(const ExecutionPlan *plan, bool anti, const char **keys);
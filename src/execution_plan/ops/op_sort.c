@@ -7,12 +7,18 @@
 #include "op_sort.h"
 #include "op_project.h"
 #include "op_aggregate.h"
+#include "op_index_order_scan.h"
 #include "../../util/arr.h"
 #include "../../util/qsort.h"
 #include "../../util/rmalloc.h"
+#include "../../query_ctx.h"
+
+// Number of bytes buffered by a sort before spilling, 0 never spills.
+extern long long sort_spill_threshold;
 
 /* Forward declarations. */
 static Record SortConsume(OpBase *opBase);
+static Record SortStreamConsume(OpBase *opBase);
 static OpResult SortReset(OpBase *opBase);
 static OpBase *SortClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void SortFree(OpBase *opBase);
@@ -32,13 +38,6 @@ static int _record_compare(Record a, Record b, const OpSort *op) {
 	return 0;
 }
 
-// Quicksort function to compare two records on a subset of fields.
-// Returns true if a is less than b.
-static bool _record_islt(Record a, Record b, const OpSort *op) {
-	return _record_compare(a, b, op) >
-		   0; // Return true if the current left element is less than the right.
-}
-
 // Compares two heap record nodes.
 static int _heap_elem_compare(const void *A, const void *B, const void *udata) {
 	OpSort *op = (OpSort *)udata;
@@ -47,10 +46,232 @@ static int _heap_elem_compare(const void *A, const void *B, const void *udata) {
 	return _record_compare(aRec, bRec, op);
 }
 
+// Buffers of at least this many records are radix sorted.
+#define SORT_RADIX_MIN 64
+
+// Normalized sort key of a record, paired with the record.
+typedef struct {
+	uint64_t key;
+	Record r;
+} SortKey;
+
+/* Encodes v into an unsigned integer whose order agrees with SIValue_Compare,
+ * such that a < b implies key(a) <= key(b). The top bits hold the value's type,
+ * as values of differing types are ordered by type, numerics sharing a single type.
+ * The remaining bits hold an order preserving prefix of the value,
+ * equal keys are ordered by comparing their records. */
+static uint64_t _normalize(SIValue v) {
+	SIType t = SI_TYPE(v);
+	if(t & SI_NUMERIC) t = T_INT64;
+
+	uint64_t bits = 0;
+	switch(t) {
+	case T_INT64: {
+		// -0 and 0 are equal.
+		double d = SI_GET_NUMERIC(v) + 0.0;
+		memcpy(&bits, &d, sizeof(bits));
+		// Flip negatives entirely, and the sign bit of positives.
+		bits = (bits >> 63) ? ~bits : bits ^ (1ULL << 63);
+		break;
+	}
+	case T_BOOL:
+		bits = (uint64_t)(v.longval != 0) << 63;
+		break;
+	case T_STRING: {
+		// Big endian prefix of the string's first bytes.
+		const unsigned char *str = (const unsigned char *)v.stringval;
+		for(int i = 0; i < 8 && str[i]; i++) bits |= (uint64_t)str[i] << (56 - 8 * i);
+		break;
+	}
+	case T_NODE:
+	case T_EDGE:
+		bits = ENTITY_GET_ID((GraphEntity *)v.ptrval) << 5;
+		break;
+	default:
+		// Remaining types are ordered by comparison alone.
+		break;
+	}
+	return ((uint64_t)__builtin_ctz(t) << 59) | (bits >> 5);
+}
+
+/* `op` is an actual variable in the caller function. Using it in a
+ * macro like this is rather ugly, but the macro passed to QSORT must
+ * accept only 2 arguments. */
+#define SORT_KEY_LT(a, b) ((a)->key < (b)->key || \
+	((a)->key == (b)->key && _record_compare((a)->r, (b)->r, op) < 0))
+#define SORT_RECORD_LT(a, b) (_record_compare((a)->r, (b)->r, op) < 0)
+
+/* Sorts keys by their low to high bytes, skipping bytes shared by all keys.
+ * Returns whichever of keys and tmp holds the sorted keys. */
+static SortKey *_radix_sort(SortKey *keys, SortKey *tmp, uint n) {
+	uint counts[8][256] = {{0}};
+	for(uint i = 0; i < n; i++) {
+		for(uint b = 0; b < 8; b++) counts[b][(keys[i].key >> (8 * b)) & 0xFF]++;
+	}
+
+	for(uint b = 0; b < 8; b++) {
+		uint *count = counts[b];
+		if(count[(keys[0].key >> (8 * b)) & 0xFF] == n) continue;
+
+		uint offset = 0;
+		for(uint i = 0; i < 256; i++) {
+			uint c = count[i];
+			count[i] = offset;
+			offset += c;
+		}
+		for(uint i = 0; i < n; i++) tmp[count[(keys[i].key >> (8 * b)) & 0xFF]++] = keys[i];
+
+		SortKey *swap = keys;
+		keys = tmp;
+		tmp = swap;
+	}
+
+	return keys;
+}
+
+/* Sorts buffered records, such that they're handed off in order.
+ * Records are sorted by the normalized key of their first sort value,
+ * records sharing a key are then sorted by comparing them. */
+static void _sort_buffer(OpSort *op) {
+	uint n = array_len(op->buffer);
+	if(n < 2) return;
+
+	int offset = op->record_offsets[0];
+	bool descending = op->directions[0] < 0;
+	SortKey *keys = rm_malloc(sizeof(SortKey) * n);
+	for(uint i = 0; i < n; i++) {
+		Record r = op->buffer[i];
+		uint64_t key = _normalize(Record_Get(r, offset));
+		keys[i].key = descending ? ~key : key;
+		keys[i].r = r;
+	}
+
+	SortKey *sorted = keys;
+	SortKey *tmp = NULL;
+	if(n >= SORT_RADIX_MIN) {
+		tmp = rm_malloc(sizeof(SortKey) * n);
+		sorted = _radix_sort(keys, tmp, n);
+		// Order records sharing a key.
+		for(uint i = 0; i < n;) {
+			uint j = i + 1;
+			while(j < n && sorted[j].key == sorted[i].key) j++;
+			if(j - i > 1) {
+				SortKey *run = sorted + i;
+				QSORT(SortKey, run, j - i, SORT_RECORD_LT);
+			}
+			i = j;
+		}
+	} else {
+		QSORT(SortKey, sorted, n, SORT_KEY_LT);
+	}
+
+	// Records are handed off from the buffer's end.
+	for(uint i = 0; i < n; i++) op->buffer[n - 1 - i] = sorted[i].r;
+
+	rm_free(keys);
+	if(tmp) rm_free(tmp);
+}
+
+// Orders runs by their next record, the heap's top is the run whose record comes first.
+static int _merge_compare(const void *A, const void *B, const void *udata) {
+	OpSort *op = (OpSort *)udata;
+	Record aRec = *(Record *)A;
+	Record bRec = *(Record *)B;
+	return _record_compare(bRec, aRec, op);
+}
+
+// Sorts buffered records and writes them to a new run, in the order they're handed off.
+static void _spill_buffer(OpSort *op) {
+	RecordSpill *run = RecordSpill_New();
+	if(run == NULL) {
+		// Without temporary files records remain in memory.
+		op->spill_failed = true;
+		return;
+	}
+
+	_sort_buffer(op);
+	bool written = true;
+	while(array_len(op->buffer) > 0) {
+		Record r = array_pop(op->buffer);
+		written = written && RecordSpill_Write(run, r);
+		OpBase_DeleteRecord(r);
+	}
+	op->buffered_bytes = 0;
+	op->runs = array_append(op->runs, run);
+
+	if(!written || !RecordSpill_Rewind(run)) {
+		char *error;
+		asprintf(&error, "Failed to spill sorted records to a temporary file");
+		QueryCtx_SetError(error);
+		QueryCtx_RaiseRuntimeException();
+	}
+}
+
+// Loads the first record of every run, records are then merged on hand off.
+static void _init_merge(OpSort *op) {
+	// Remaining records form the last run.
+	if(array_len(op->buffer) > 0) _spill_buffer(op);
+
+	uint run_count = array_len(op->runs);
+	op->heads = rm_malloc(sizeof(Record) * run_count);
+	op->merge = heap_new(_merge_compare, op);
+	for(uint i = 0; i < run_count; i++) {
+		op->heads[i] = OpBase_CreateRecord((OpBase *)op);
+		if(RecordSpill_Read(op->runs[i], op->heads[i])) {
+			heap_offer(&op->merge, op->heads + i);
+		} else {
+			OpBase_DeleteRecord(op->heads[i]);
+			op->heads[i] = NULL;
+		}
+	}
+}
+
+// Hands off the first of the runs' next records, replacing it with its successor.
+static Record _merge_handoff(OpSort *op) {
+	if(heap_count(op->merge) == 0) return NULL;
+
+	Record *head = heap_poll(op->merge);
+	Record r = *head;
+	uint run = head - op->heads;
+	*head = OpBase_CreateRecord((OpBase *)op);
+	if(RecordSpill_Read(op->runs[run], *head)) {
+		heap_offer(&op->merge, head);
+	} else {
+		OpBase_DeleteRecord(*head);
+		*head = NULL;
+	}
+	return r;
+}
+
+// Frees spilled runs and the records merged from them.
+static void _free_runs(OpSort *op) {
+	uint run_count = array_len(op->runs);
+	if(op->heads) {
+		for(uint i = 0; i < run_count; i++) {
+			if(op->heads[i]) OpBase_DeleteRecord(op->heads[i]);
+		}
+		rm_free(op->heads);
+		op->heads = NULL;
+	}
+
+	if(op->merge) {
+		heap_free(op->merge);
+		op->merge = NULL;
+	}
+
+	for(uint i = 0; i < run_count; i++) RecordSpill_Free(op->runs[i]);
+	array_clear(op->runs);
+}
+
 static void _accumulate(OpSort *op, Record r) {
 	if(!op->limit) {
 		/* Not using a heap and there's room for record. */
 		op->buffer = array_append(op->buffer, r);
+		// Once the buffer grows beyond the threshold it's spilled as a sorted run.
+		if(sort_spill_threshold > 0 && !op->spill_failed) {
+			op->buffered_bytes += RecordSpill_Footprint(r) + sizeof(Record);
+			if(op->buffered_bytes > (size_t)sort_spill_threshold) _spill_buffer(op);
+		}
 		return;
 	}
 
@@ -74,6 +295,13 @@ static inline Record _handoff(OpSort *op) {
 	return NULL;
 }
 
+// Sorts holding a limit retain the top limit records, as presented by EXPLAIN.
+static int SortToString(const OpBase *ctx, char *buf, uint buf_len) {
+	const OpSort *op = (const OpSort *)ctx;
+	if(!op->limit) return snprintf(buf, buf_len, "%s", ctx->name);
+	return snprintf(buf, buf_len, "%s | Top %u", ctx->name, op->limit);
+}
+
 OpBase *NewSortOp(const ExecutionPlan *plan, AR_ExpNode **exps, int *directions, uint limit) {
 	OpSort *op = rm_malloc(sizeof(OpSort));
 	op->heap = NULL;
@@ -81,13 +309,20 @@ OpBase *NewSortOp(const ExecutionPlan *plan, AR_ExpNode **exps, int *directions,
 	op->limit = limit;
 	op->directions = directions;
 	op->exps = exps;
+	op->presorted = false;
+	op->emitted = 0;
+	op->buffered_bytes = 0;
+	op->runs = array_new(RecordSpill *, 0);
+	op->heads = NULL;
+	op->merge = NULL;
+	op->spill_failed = false;
 
 	if(op->limit) op->heap = heap_new(_heap_elem_compare, op);
 	else op->buffer = array_new(Record, 32);
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_SORT, "Sort", NULL,
-				SortConsume, SortReset, NULL, SortClone, SortFree, false, plan);
+				SortConsume, SortReset, SortToString, SortClone, SortFree, false, plan);
 
 	uint comparison_count = array_len(exps);
 	op->record_offsets = array_new(uint, comparison_count);
@@ -100,13 +335,29 @@ OpBase *NewSortOp(const ExecutionPlan *plan, AR_ExpNode **exps, int *directions,
 	return (OpBase *)op;
 }
 
-/* `op` is an actual variable in the caller function. Using it in a
- * macro like this is rather ugly, but the macro passed to QSORT must
- * accept only 2 arguments. */
-#define RECORD_SORT(a, b) (_record_islt((*a), (*b), op))
+void SortOp_SetPresorted(OpSort *op) {
+	op->presorted = true;
+}
+
+// Locates the index order scan feeding a presorted sort.
+static const IndexOrderScan *_PresortingScan(const OpBase *op) {
+	while(op->type != OPType_INDEX_ORDER_SCAN) {
+		assert(op->childCount == 1);
+		op = op->children[0];
+	}
+	return (const IndexOrderScan *)op;
+}
 
 static Record SortConsume(OpBase *opBase) {
 	OpSort *op = (OpSort *)opBase;
+	/* The scan's order is resolved once it's initialized,
+	 * nodes it doesn't order are sorted as usual. */
+	if(op->presorted && IndexOrderScan_Ordered(_PresortingScan(op->op.children[0]))) {
+		OpBase_UpdateConsume(opBase, SortStreamConsume);
+		return SortStreamConsume(opBase);
+	}
+
+	if(op->merge) return _merge_handoff(op);
 	Record r = _handoff(op);
 	if(r) return r;
 
@@ -120,8 +371,14 @@ static Record SortConsume(OpBase *opBase) {
 	}
 	if(!newData) return NULL;
 
+	// Records were spilled, merge the sorted runs.
+	if(array_len(op->runs) > 0) {
+		_init_merge(op);
+		return _merge_handoff(op);
+	}
+
 	if(op->buffer) {
-		QSORT(Record, op->buffer, array_len(op->buffer), RECORD_SORT);
+		_sort_buffer(op);
 	} else {
 		// Heap, responses need to be reversed.
 		int records_count = heap_count(op->heap);
@@ -139,10 +396,23 @@ static Record SortConsume(OpBase *opBase) {
 	return _handoff(op);
 }
 
+// Records arrive in sort order, stop once limit records were produced.
+static Record SortStreamConsume(OpBase *opBase) {
+	OpSort *op = (OpSort *)opBase;
+	if(op->limit && op->emitted == op->limit) return NULL;
+
+	Record r = OpBase_Consume(op->op.children[0]);
+	if(r) op->emitted++;
+	return r;
+}
+
 /* Restart iterator */
 static OpResult SortReset(OpBase *ctx) {
 	OpSort *op = (OpSort *)ctx;
 	uint recordCount;
+	op->emitted = 0;
+	op->buffered_bytes = 0;
+	_free_runs(op);
 
 	if(op->heap) {
 		recordCount = heap_count(op->heap);
@@ -170,7 +440,9 @@ static OpBase *SortClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	AR_ExpNode **exps;
 	array_clone(directions, op->directions);
 	array_clone_with_cb(exps, op->exps, AR_EXP_Clone);
-	return NewSortOp(plan, exps, directions, op->limit);
+	OpBase *clone = NewSortOp(plan, exps, directions, op->limit);
+	if(op->presorted) SortOp_SetPresorted((OpSort *)clone);
+	return clone;
 }
 
 /* Frees Sort */
@@ -197,6 +469,12 @@ static void SortFree(OpBase *ctx) {
 		op->buffer = NULL;
 	}
 
+	if(op->runs) {
+		_free_runs(op);
+		array_free(op->runs);
+		op->runs = NULL;
+	}
+
 	if(op->record_offsets) {
 		array_free(op->record_offsets);
 		op->record_offsets = NULL;
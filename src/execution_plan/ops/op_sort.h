@@ -8,6 +8,7 @@
 
 #include "op.h"
 #include "../../util/heap.h"
+#include "shared/record_spill.h"
 #include "../execution_plan.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
@@ -19,8 +20,19 @@ typedef struct {
 	uint limit;                 // Total number of records to produce, 0 no limit.
 	int *directions;            // Array of sort directions(ascending / desending) for each item.
 	AR_ExpNode **exps;          // Projected expressons.
+	bool presorted;             // Records are produced by an index order scan.
+	uint emitted;               // Number of records streamed while presorted.
+	size_t buffered_bytes;      // Approximate size of buffered records.
+	RecordSpill **runs;         // Sorted runs spilled to disk.
+	Record *heads;              // Next record of each run, NULL once depleted.
+	heap_t *merge;              // Runs ordered by their next record.
+	bool spill_failed;          // Temporary files are unavailable, keep buffering.
 } OpSort;
 
 /* Creates a new Sort operation */
 OpBase *NewSortOp(const ExecutionPlan *plan, AR_ExpNode **exps, int *directions, uint limit);
 
+/* Marks sort as fed by an index order scan, once the scan produces
+ * records in sort order they're streamed through up to limit. */
+void SortOp_SetPresorted(OpSort *op);
+
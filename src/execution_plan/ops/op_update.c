@@ -5,9 +5,13 @@
 */
 
 #include "op_update.h"
+#include "shared/unique_constraints.h"
 #include "../../query_ctx.h"
 #include "../../util/arr.h"
+#include "../../util/qsort.h"
 #include "../../util/rmalloc.h"
+#include "../../graph/weight_matrices.h"
+#include "../../change_feed/change_feed.h"
 #include "../../arithmetic/arithmetic_expression.h"
 #include "../../query_ctx.h"
 
@@ -43,14 +47,21 @@ static void _QueueUpdate(OpUpdate *op, GraphEntity *entity, GraphEntityType type
 	op->pending_updates_count++;
 }
 
-/* Introduce updated entity to index. */
-static void _UpdateIndex(EntityUpdateCtx *ctx, GraphContext *gc, Schema *s, SIValue *old_value,
-						 SIValue *new_value) {
-	Node *n = &ctx->n;
-	EntityID node_id = ENTITY_GET_ID(n);
+/* Returns true if setting attribute to new_value modifies
+ * an indexed value of which old_value is the current. */
+static bool _ModifiesIndex(const Schema *s, Attribute_ID attr, const SIValue *old_value,
+						   SIValue new_value) {
+	if(!Schema_IndexesAttribute(s, attr)) return false;
+	if(old_value == PROPERTY_NOTFOUND) return true;
+	if(SI_TYPE(*old_value) != SI_TYPE(new_value)) return true;
+	int disjoint_or_null = 0;
+	return (SIValue_Compare(*old_value, new_value, &disjoint_or_null) != 0 || disjoint_or_null != 0);
+}
 
-	// Reindex.
-	Schema_AddNodeToIndices(s, n, true);
+/* Queue entity to be reindexed under schema s, once all updates are applied. */
+static inline void _QueueReindex(OpUpdate *op, Schema *s, EntityUpdateCtx *ctx) {
+	PendingReindex pending = {.s = s, .ctx = ctx};
+	op->pending_reindex = array_append(op->pending_reindex, pending);
 }
 
 static void _UpdateNode(OpUpdate *op, EntityUpdateCtx *ctx) {
@@ -69,17 +80,18 @@ static void _UpdateNode(OpUpdate *op, EntityUpdateCtx *ctx) {
 
 	// Try to get current property value.
 	SIValue *old_value = GraphEntity_GetProperty((GraphEntity *)node, ctx->attr_id);
+	SIValue new_value = GraphContext_InternValue(op->gc, ctx->attr_id, ctx->new_value);
+	GraphContext_UpdateNodeStatistics(op->gc, node, ctx->attr_id, *old_value, new_value);
+	if(_ModifiesIndex(s, ctx->attr_id, old_value, new_value)) _QueueReindex(op, s, ctx);
 
 	if(old_value == PROPERTY_NOTFOUND) {
 		// Add new property.
-		GraphEntity_AddProperty((GraphEntity *)node, ctx->attr_id, ctx->new_value);
+		GraphEntity_AddProperty((GraphEntity *)node, ctx->attr_id, new_value);
 	} else {
 		// Update property.
-		GraphEntity_SetProperty((GraphEntity *)node, ctx->attr_id, ctx->new_value);
+		GraphEntity_SetProperty((GraphEntity *)node, ctx->attr_id, new_value);
 	}
-
-	// Update index for node entities.
-	_UpdateIndex(ctx, op->gc, s, old_value, &ctx->new_value);
+	ChangeFeed_PropertySet((GraphEntity *)node, GETYPE_NODE, ctx->attr_id, new_value);
 }
 
 static void _UpdateEdge(OpUpdate *op, EntityUpdateCtx *ctx) {
@@ -88,20 +100,106 @@ static void _UpdateEdge(OpUpdate *op, EntityUpdateCtx *ctx) {
 	* but only a pointer to an Entity object,
 	* to use the GraphEntity_Get, GraphEntity_Add functions we'll use a place holder
 	* to hold our entity. */
+	Schema *s = NULL;
 	Edge *edge = &ctx->e;
 
 	int label_id = Graph_GetEdgeRelation(op->gc->g, edge);
+	if(label_id != GRAPH_NO_RELATION) {
+		s = GraphContext_GetSchemaByID(op->gc, label_id, SCHEMA_EDGE);
+	}
 
 	// Try to get current property value.
 	SIValue *old_value = GraphEntity_GetProperty((GraphEntity *)edge, ctx->attr_id);
+	SIValue new_value = GraphContext_InternValue(op->gc, ctx->attr_id, ctx->new_value);
+	if(_ModifiesIndex(s, ctx->attr_id, old_value, new_value)) _QueueReindex(op, s, ctx);
 
 	if(old_value == PROPERTY_NOTFOUND) {
 		// Add new property.
-		GraphEntity_AddProperty((GraphEntity *)edge, ctx->attr_id, ctx->new_value);
+		GraphEntity_AddProperty((GraphEntity *)edge, ctx->attr_id, new_value);
 	} else {
 		// Update property.
-		GraphEntity_SetProperty((GraphEntity *)edge, ctx->attr_id, ctx->new_value);
+		GraphEntity_SetProperty((GraphEntity *)edge, ctx->attr_id, new_value);
+	}
+	ChangeFeed_PropertySet((GraphEntity *)edge, GETYPE_EDGE, ctx->attr_id, new_value);
+	// Reweighted and retimed edges are reflected by weight matrices and interval indices.
+	if(label_id != GRAPH_NO_RELATION) {
+		WeightMatrices_Touch(op->gc->g, label_id, ctx->attr_id, Edge_GetSrcNodeID(edge),
+							 Edge_GetDestNodeID(edge));
+	}
+	if(s && s->intervals) {
+		IntervalIndex_Touch(s->intervals, ctx->attr_id, Edge_GetSrcNodeID(edge),
+							Edge_GetDestNodeID(edge));
+	}
+}
+
+// Orders pending reindexes by schema, entity type and entity ID.
+static inline bool _PendingReindexLessThan(const PendingReindex *a, const PendingReindex *b) {
+	if(a->s != b->s) return a->s < b->s;
+	if(a->ctx->entity_type != b->ctx->entity_type) return a->ctx->entity_type < b->ctx->entity_type;
+	GraphEntity *ea = (a->ctx->entity_type == GETYPE_NODE) ? (GraphEntity *)&a->ctx->n :
+					  (GraphEntity *)&a->ctx->e;
+	GraphEntity *eb = (b->ctx->entity_type == GETYPE_NODE) ? (GraphEntity *)&b->ctx->n :
+					  (GraphEntity *)&b->ctx->e;
+	return ENTITY_GET_ID(ea) < ENTITY_GET_ID(eb);
+}
+
+/* Reindex the entities whose indexed values were modified,
+ * each entity is reindexed once, however many of its attributes were updated,
+ * the entities of a schema are reindexed as a single batch. */
+static void _CommitReindex(OpUpdate *op) {
+	uint count = array_len(op->pending_reindex);
+	if(count == 0) return;
+	PendingReindex *pending = op->pending_reindex;
+	QSORT(PendingReindex, pending, count, _PendingReindexLessThan);
+
+	Node *nodes = array_new(Node, 0);
+	Edge *edges = array_new(Edge, 0);
+	for(uint i = 0; i < count; i++) {
+		EntityUpdateCtx *ctx = pending[i].ctx;
+		// Skip repeated updates of an entity.
+		bool repeated = (i > 0 && !_PendingReindexLessThan(pending + i - 1, pending + i));
+		if(!repeated && ctx->entity_type == GETYPE_NODE) nodes = array_append(nodes, ctx->n);
+		else if(!repeated) edges = array_append(edges, ctx->e);
+
+		if(i + 1 < count && pending[i + 1].s == pending[i].s) continue;
+		// Last entity of the schema.
+		if(array_len(nodes) > 0) Schema_ReindexNodes(pending[i].s, nodes, array_len(nodes));
+		if(array_len(edges) > 0) Schema_ReindexEdges(pending[i].s, edges, array_len(edges));
+		array_clear(nodes);
+		array_clear(edges);
+	}
+
+	array_free(nodes);
+	array_free(edges);
+	array_clear(op->pending_reindex);
+}
+
+/* Fail the query if an update assigns a value taken under a uniquely
+ * constrained attribute of the node's label, by either another node
+ * or another pending update. Runs prior to applying any update. */
+static void _ValidateUniqueConstraints(OpUpdate *op) {
+	const Schema *violated = NULL;
+	Attribute_ID violated_attr = ATTRIBUTE_NOTFOUND;
+	UniqueClaims claims = UniqueClaims_New();
+
+	for(uint i = 0; i < op->pending_updates_count && !violated; i++) {
+		EntityUpdateCtx *ctx = &op->pending_updates[i];
+		if(ctx->entity_type != GETYPE_NODE || ctx->attr_id == ATTRIBUTE_NOTFOUND) continue;
+
+		NodeID id = ENTITY_GET_ID(&ctx->n);
+		int label_id = Graph_GetNodeLabel(op->gc->g, id);
+		if(label_id == GRAPH_NO_LABEL) continue;
+		Schema *s = GraphContext_GetSchemaByID(op->gc, label_id, SCHEMA_NODE);
+		if(!Schema_IsUnique(s, ctx->attr_id)) continue;
+
+		if(!UniqueClaims_Claim(&claims, s, ctx->attr_id, ctx->new_value, id)) {
+			violated = s;
+			violated_attr = ctx->attr_id;
+		}
 	}
+
+	UniqueClaims_Free(&claims);
+	if(violated) UniqueConstraint_RaiseViolation(violated, violated_attr);
 }
 
 /* Executes delayed updates. */
@@ -119,6 +217,7 @@ static void _CommitUpdates(OpUpdate *op) {
 		}
 		SIValue_Free(ctx->new_value);
 	}
+	_CommitReindex(op);
 
 	if(op->stats) op->stats->properties_set += op->pending_updates_count;
 }
@@ -150,6 +249,7 @@ OpBase *NewUpdateOp(const ExecutionPlan *plan, EntityUpdateEvalCtx *update_exps)
 	op->update_expressions = update_exps;
 	op->update_expressions_count = array_len(update_exps);
 	op->pending_updates = rm_malloc(sizeof(EntityUpdateCtx) * op->pending_updates_cap);
+	op->pending_reindex = array_new(PendingReindex, 0);
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_UPDATE, "Update", UpdateInit, UpdateConsume,
@@ -204,8 +304,16 @@ static Record UpdateConsume(OpBase *opBase) {
 	 * index R/W lock, as such free all execution plan operation up the chain. */
 	OpBase_PropagateFree(child);
 
+	/* Cached records may hold values borrowed from the entities about to be updated,
+	 * copy these before updating. */
+	if(op->records) {
+		uint record_count = array_len(op->records);
+		for(uint i = 0; i < record_count; i++) Record_PersistBorrowedScalars(op->records[i]);
+	}
+
 	/* Lock everything. */
 	QueryCtx_LockForCommit();
+	_ValidateUniqueConstraints(op);
 	_CommitUpdates(op);
 	// Release lock.
 	QueryCtx_UnlockCommit(opBase);
@@ -229,6 +337,7 @@ static OpResult UpdateReset(OpBase *ctx) {
 	op->pending_updates_cap = 16; /* 16 seems reasonable number to start with. */
 	op->pending_updates = rm_realloc(op->pending_updates,
 									 op->pending_updates_cap * sizeof(EntityUpdateCtx));
+	array_clear(op->pending_reindex);
 	return OP_OK;
 }
 
@@ -258,5 +367,10 @@ static void UpdateFree(OpBase *ctx) {
 		rm_free(op->pending_updates);
 		op->pending_updates = NULL;
 	}
+
+	if(op->pending_reindex) {
+		array_free(op->pending_reindex);
+		op->pending_reindex = NULL;
+	}
 }
 
@@ -10,6 +10,7 @@
 #include "../execution_plan.h"
 #include "../../graph/entities/node.h"
 #include "../../graph/entities/edge.h"
+#include "../../schema/schema.h"
 #include "../../resultset/resultset_statistics.h"
 #include "../../arithmetic/arithmetic_expression.h"
 #include "../../ast/ast_build_op_contexts.h"
@@ -24,6 +25,12 @@ typedef struct {
 	SIValue new_value;                  /* Constant value to set. */
 } EntityUpdateCtx;
 
+// Entity whose indexed values were modified, reindexed once all updates are applied.
+typedef struct {
+	Schema *s;                          /* Schema whose indices hold the entity. */
+	EntityUpdateCtx *ctx;               /* Update of the entity. */
+} PendingReindex;
+
 typedef struct {
 	OpBase op;
 	GraphContext *gc;
@@ -37,6 +44,7 @@ typedef struct {
 	uint pending_updates_count;
 	EntityUpdateCtx
 	*pending_updates;           /* List of entities to update and their actual new value. */
+	PendingReindex *pending_reindex;            /* Updated entities to reindex. */
 	Record *records;                            /* Updated records, used only when query inspects updated entities. */
 	bool updates_commited;                      /* Updates performed? */
 } OpUpdate;
@@ -5,10 +5,10 @@
 */
 
 #include "op_value_hash_join.h"
+#include "../cardinality.h"
 #include "../../value.h"
 #include "../../util/arr.h"
 #include "../../util/rmalloc.h"
-#include "../../util/qsort.h"
 #include <assert.h>
 
 /* Forward declarations. */
@@ -18,127 +18,186 @@ static OpResult ValueHashJoinReset(OpBase *opBase);
 static OpBase *ValueHashJoinClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ValueHashJoinFree(OpBase *opBase);
 
-/* Determins order between two records by inspecting
- * element stored at postion idx. */
-static bool _record_islt(Record l, Record r, uint idx) {
-	SIValue lv = Record_GetScalar(l, idx);
-	SIValue rv = Record_GetScalar(r, idx);
-	return SIValue_Compare(lv, rv, NULL) < 0;
+// Returns true if both join values are equal, null values never join.
+static inline bool _values_equal(SIValue a, SIValue b) {
+	int disjointOrNull;
+	return SIValue_Compare(a, b, &disjointOrNull) == 0 && disjointOrNull == 0;
 }
 
-/* `idx` is an actual variable in the caller function.
- * Using it in a macro like this is rather ugly,
- * but the macro passed to QSORT must accept only 2 arguments. */
-#define RECORD_SORT_ON_ENTRY(a, b) (_record_islt((*a), (*b), idx))
-
-// Performs binary search, returns the leftmost index of a match.
-static int64_t _binarySearchLeftmost(Record *array, int join_key_idx, SIValue v) {
-	int64_t recordCount = array_len(array);
-	int64_t pos;
-	int64_t left = 0;
-	int64_t right = recordCount;
-	while(left < right) {
-		pos = (right + left) / 2;
-		SIValue x = Record_GetScalar(array[pos], join_key_idx);
-		if(SIValue_Compare(x, v, NULL) < 0) left = pos + 1;
-		else right = pos;
-	}
-	return left;
-}
-
-// Performs binary search, returns the rightmost index of a match.
-static int64_t _binarySearchRightmost(Record *array, int64_t array_len, int join_key_idx,
-									  SIValue v) {
-	int64_t pos;
-	int64_t left = 0;
-	int64_t right = array_len;
-	while(left < right) {
-		pos = (right + left) / 2;
-		SIValue x = Record_GetScalar(array[pos], join_key_idx);
-		if(SIValue_Compare(v, x, NULL) < 0) right = pos;
-		else left = pos + 1;
+/* Locates the bucket holding value v, or the empty bucket v would be placed in.
+ * Buckets are probed linearly, the table always holds an empty bucket. */
+static JoinBucket *_locate_bucket(OpValueHashJoin *op, SIValue v, uint64_t hash) {
+	uint64_t pos = hash & op->bucket_mask;
+	while(true) {
+		JoinBucket *bucket = op->buckets + pos;
+		if(bucket->head == 0) return bucket;
+		if(bucket->hash == hash) {
+			Record r = op->cached_records[bucket->head - 1];
+			if(_values_equal(Record_GetScalar(r, op->join_value_rec_idx), v)) return bucket;
+		}
+		pos = (pos + 1) & op->bucket_mask;
 	}
-	return right - 1;
 }
 
 /* Retrive the next intersecting record
  * if such exists, otherwise returns NULL. */
 static Record _get_intersecting_record(OpValueHashJoin *op) {
 	// No more intersecting records.
-	if(op->intersect_idx == -1 ||
-	   op->number_of_intersections == 0) return NULL;
+	if(op->intersect_idx == 0) return NULL;
 
-	Record cr = op->cached_records[op->intersect_idx];
-
-	// Update intersection trackers.
-	op->intersect_idx++;
-	op->number_of_intersections--;
+	uint32_t idx = op->intersect_idx - 1;
+	op->intersect_idx = op->chain[idx];
+	return op->cached_records[idx];
+}
 
-	return cr;
+/* Joins the probing record with the intersecting cached record l.
+ * The probing record is handed off once l is the last record it intersects,
+ * otherwise it is copied, cached records are never modified and lend their values. */
+static Record _join(OpValueHashJoin *op, Record l) {
+	Record r;
+	if(op->intersect_idx == 0) {
+		r = op->rhs_rec;
+		op->rhs_rec = NULL;
+	} else {
+		r = OpBase_CloneRecord(op->rhs_rec);
+	}
+	Record_Inherit(r, l);
+	return r;
 }
 
 /* Look up first intersecting cached record CR position.
- * Returns false if intersecting record is found. */
+ * Returns false if no intersecting record is found. */
 static bool _set_intersection_idx(OpValueHashJoin *op, SIValue v) {
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
-	uint record_count = array_len(op->cached_records);
-
-	int64_t leftmost_idx = _binarySearchLeftmost(op->cached_records, op->join_value_rec_idx, v);
-	if(leftmost_idx >= record_count) return false;
-
-	// Make sure value was found.
-	Record r = op->cached_records[leftmost_idx];
-	SIValue x = Record_GetScalar(r, op->join_value_rec_idx);
-	if(SIValue_Compare(x, v, NULL) != 0) return false; // Value wasn't found.
-
-	/* Value was found
-	 * idx points to the first intersecting record.
-	 * update number_of_intersections to count how many
-	 * records share the same value. */
-	op->intersect_idx = leftmost_idx;
-
-	/* Count how many records share the same node.
-	 * reduce search space by truncating left bound */
-	int64_t rightmost_idx = _binarySearchRightmost(op->cached_records + leftmost_idx,
-												   record_count - leftmost_idx,
-												   op->join_value_rec_idx,
-												   v);
-	// Compensate index.
-	rightmost_idx += leftmost_idx;
-	// +1 consider rightmost_idx == leftmost_idx.
-	op->number_of_intersections = rightmost_idx - leftmost_idx + 1;
-	assert(op->number_of_intersections > 0);
-
-	return true;
+	op->intersect_idx = 0;
+	if(SI_TYPE(v) == T_NULL || array_len(op->cached_records) == 0) return false;
+
+	JoinBucket *bucket = _locate_bucket(op, v, SIValue_HashCode(v));
+	op->intersect_idx = bucket->head;
+	return op->intersect_idx != 0;
 }
 
-/* Sorts cached records by joined value. */
-void _sort_cached_records(OpValueHashJoin *op) {
-	uint idx = op->join_value_rec_idx;
-	QSORT(Record, op->cached_records,
-		  array_len(op->cached_records), RECORD_SORT_ON_ENTRY);
+/* Builds the hash table over the cached records' join values,
+ * records sharing a value are chained in the order they were cached. */
+static void _hash_cached_records(OpValueHashJoin *op) {
+	uint32_t record_count = array_len(op->cached_records);
+
+	// Keep the load factor at most 1/2.
+	uint64_t bucket_count = 2;
+	while(bucket_count < (uint64_t)record_count * 2) bucket_count <<= 1;
+	op->bucket_mask = bucket_count - 1;
+	op->buckets = rm_calloc(bucket_count, sizeof(JoinBucket));
+	op->chain = rm_calloc(record_count ? record_count : 1, sizeof(uint32_t));
+
+	for(uint32_t i = 0; i < record_count; i++) {
+		SIValue v = Record_GetScalar(op->cached_records[i], op->join_value_rec_idx);
+		if(SI_TYPE(v) == T_NULL) continue;
+
+		uint64_t hash = SIValue_HashCode(v);
+		JoinBucket *bucket = _locate_bucket(op, v, hash);
+		if(bucket->head == 0) {
+			bucket->hash = hash;
+			bucket->head = i + 1;
+		} else {
+			op->chain[bucket->tail - 1] = i + 1;
+		}
+		bucket->tail = i + 1;
+	}
 }
 
-/* Caches all records coming from left branch. */
-void _cache_records(OpValueHashJoin *op) {
-	assert(op->cached_records == NULL);
+// Caches records from the left branch, or from the right one once the sides switch.
+static void _set_sides(OpValueHashJoin *op, bool switched) {
+	op->switched = switched;
+	op->build_child = op->op.children[switched ? 1 : 0];
+	op->probe_child = op->op.children[switched ? 0 : 1];
+	op->build_exp = switched ? op->rhs_exp : op->lhs_exp;
+	op->probe_exp = switched ? op->lhs_exp : op->rhs_exp;
+}
+
+/* Returns true if the records cached so far considerably exceed the estimate
+ * of the cached side, while the probing side is expected to be smaller. */
+static bool _misestimated(const OpValueHashJoin *op) {
+	uint32_t record_count = array_len(op->cached_records);
+	if(op->switched || record_count % VALUE_HASH_JOIN_ADAPT_BATCH != 0) return false;
+	return record_count > op->build_estimate * VALUE_HASH_JOIN_ADAPT_RATIO &&
+		   op->probe_estimate < record_count;
+}
 
-	OpBase *left_child = op->op.children[0];
+/* Switch sides, the records cached so far await probing,
+ * their join values are discarded as they're evaluated again once probing. */
+static void _switch_sides(OpValueHashJoin *op) {
+	op->pending = op->cached_records;
+	op->pending_idx = 0;
+	uint32_t record_count = array_len(op->pending);
+	for(uint32_t i = 0; i < record_count; i++) {
+		Record r = op->pending[i];
+		SIValue_Free(Record_GetScalar(r, op->join_value_rec_idx));
+		r->entries[op->join_value_rec_idx].type = REC_TYPE_UNKNOWN;
+	}
 	op->cached_records = array_new(Record, 32);
+	_set_sides(op, true);
+}
+
+/* Caches all records coming from the build branch. */
+static void _cache_records(OpValueHashJoin *op) {
+	assert(op->cached_records == NULL);
 
-	Record r = left_child->consume(left_child);
-	if(!r) return;
+	op->cached_records = array_new(Record, 32);
 
-	// As long as there's data coming in from left branch.
-	do {
+	Record r;
+	// As long as there's data coming in from the build branch.
+	while((r = op->build_child->consume(op->build_child))) {
 		// Add joined value to record.
 		op->cached_records = array_append(op->cached_records, r);
 
 		// Evaluate joined expression.
-		SIValue v = AR_EXP_Evaluate(op->lhs_exp, r);
+		SIValue v = AR_EXP_Evaluate(op->build_exp, r);
 		Record_AddScalar(r, op->join_value_rec_idx, v);
-	} while((r = left_child->consume(left_child)));
+
+		// At batch boundaries, make sure the smaller side is being cached.
+		if(_misestimated(op)) _switch_sides(op);
+	}
+}
+
+// Returns the next probing record, records cached prior to switching sides first.
+static Record _next_probe_record(OpValueHashJoin *op) {
+	if(op->pending) {
+		if(op->pending_idx < array_len(op->pending)) return op->pending[op->pending_idx++];
+		array_free(op->pending);
+		op->pending = NULL;
+	}
+	return op->probe_child->consume(op->probe_child);
+}
+
+// Frees records cached prior to switching sides which haven't probed yet.
+static void _free_pending_records(OpValueHashJoin *op) {
+	if(op->pending == NULL) return;
+	uint record_count = array_len(op->pending);
+	for(uint i = op->pending_idx; i < record_count; i++) OpBase_DeleteRecord(op->pending[i]);
+	array_free(op->pending);
+	op->pending = NULL;
+}
+
+// Frees cached records and the hash table over them.
+static void _free_cached_records(OpValueHashJoin *op) {
+	if(op->cached_records) {
+		uint record_count = array_len(op->cached_records);
+		for(uint i = 0; i < record_count; i++) {
+			Record r = op->cached_records[i];
+			OpBase_DeleteRecord(r);
+		}
+		array_free(op->cached_records);
+		op->cached_records = NULL;
+	}
+
+	if(op->buckets) {
+		rm_free(op->buckets);
+		op->buckets = NULL;
+	}
+
+	if(op->chain) {
+		rm_free(op->chain);
+		op->chain = NULL;
+	}
 }
 
 /* String representation of operation */
@@ -160,6 +219,8 @@ static int ValueHashJoinToString(const OpBase *ctx, char *buff, uint buff_len) {
 	offset += snprintf(buff + offset, buff_len - offset, "%s", exp_str);
 	rm_free(exp_str);
 
+	if(op->switched) offset += snprintf(buff + offset, buff_len - offset, " | Switched sides");
+
 	return offset;
 }
 
@@ -169,9 +230,20 @@ OpBase *NewValueHashJoin(const ExecutionPlan *plan, AR_ExpNode *lhs_exp, AR_ExpN
 	op->rhs_rec = NULL;
 	op->lhs_exp = lhs_exp;
 	op->rhs_exp = rhs_exp;
-	op->intersect_idx = -1;
+	op->intersect_idx = 0;
 	op->cached_records = NULL;
-	op->number_of_intersections = 0;
+	op->chain = NULL;
+	op->buckets = NULL;
+	op->bucket_mask = 0;
+	op->build_child = NULL;
+	op->probe_child = NULL;
+	op->build_exp = NULL;
+	op->probe_exp = NULL;
+	op->build_estimate = 0;
+	op->probe_estimate = 0;
+	op->switched = false;
+	op->pending = NULL;
+	op->pending_idx = 0;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_VALUE_HASH_JOIN, "Value Hash Join", ValueHashJoinInit,
@@ -184,6 +256,10 @@ OpBase *NewValueHashJoin(const ExecutionPlan *plan, AR_ExpNode *lhs_exp, AR_ExpN
 
 static OpResult ValueHashJoinInit(OpBase *ctx) {
 	assert(ctx->childCount == 2);
+	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
+	op->build_estimate = Cardinality_Estimate(ctx->children[0]);
+	op->probe_estimate = Cardinality_Estimate(ctx->children[1]);
+	_set_sides(op, false);
 	return OP_OK;
 }
 
@@ -192,13 +268,12 @@ static OpResult ValueHashJoinInit(OpBase *ctx) {
  * of this operation. */
 static Record ValueHashJoinConsume(OpBase *opBase) {
 	OpValueHashJoin *op = (OpValueHashJoin *)opBase;
-	OpBase *right_child = op->op.children[1];
 
-	// Eager, pull from left branch until depleted.
+	// Eager, pull from the build branch until depleted.
 	if(op->cached_records == NULL) {
 		_cache_records(op);
-		// Sort cache on intersect node ID.
-		_sort_cached_records(op);
+		// Hash cache on joined value.
+		_hash_cached_records(op);
 	}
 
 	/* Try to produce a record:
@@ -211,14 +286,7 @@ static Record ValueHashJoinConsume(OpBase *opBase) {
 	 * X merged with R. */
 
 	Record l;
-	if(op->number_of_intersections > 0) {
-		while((l = _get_intersecting_record(op))) {
-			/* Merge into cached records to avoid
-			 * record extension */
-			Record_Merge(&l, op->rhs_rec);
-			return OpBase_CloneRecord(l);
-		}
-	}
+	if((l = _get_intersecting_record(op))) return _join(op, l);
 
 	/* If we're here there are no more
 	 * left hand side records which intersect with R
@@ -228,12 +296,12 @@ static Record ValueHashJoinConsume(OpBase *opBase) {
 	/* Try to get new right hand side record
 	 * which intersect with a left hand side record. */
 	while(true) {
-		// Pull from right branch.
-		op->rhs_rec = right_child->consume(right_child);
+		// Pull from the probing branch.
+		op->rhs_rec = _next_probe_record(op);
 		if(!op->rhs_rec) return NULL;
 
 		// Get value on which we're intersecting.
-		SIValue v = AR_EXP_Evaluate(op->rhs_exp, op->rhs_rec);
+		SIValue v = AR_EXP_Evaluate(op->probe_exp, op->rhs_rec);
 
 		// No intersection, discard R.
 		if(!_set_intersection_idx(op, v)) {
@@ -243,15 +311,13 @@ static Record ValueHashJoinConsume(OpBase *opBase) {
 
 		// Found atleast one intersecting record.
 		l = _get_intersecting_record(op);
-		Record_Merge(&l, op->rhs_rec);
-		return OpBase_CloneRecord(l);
+		return _join(op, l);
 	}
 }
 
 static OpResult ValueHashJoinReset(OpBase *ctx) {
 	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
+	op->intersect_idx = 0;
 
 	// Clear cached records.
 	if(op->rhs_rec) {
@@ -259,15 +325,9 @@ static OpResult ValueHashJoinReset(OpBase *ctx) {
 		op->rhs_rec = NULL;
 	}
 
-	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
-		array_free(op->cached_records);
-		op->cached_records = NULL;
-	}
+	_free_pending_records(op);
+	_free_cached_records(op);
+	_set_sides(op, false);
 
 	return OP_OK;
 }
@@ -287,15 +347,8 @@ static void ValueHashJoinFree(OpBase *ctx) {
 		op->rhs_rec = NULL;
 	}
 
-	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
-		array_free(op->cached_records);
-		op->cached_records = NULL;
-	}
+	_free_pending_records(op);
+	_free_cached_records(op);
 
 	if(op->lhs_exp) {
 		AR_EXP_Free(op->lhs_exp);
@@ -10,15 +10,49 @@
 #include "../execution_plan.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
+/* Value Hash Join caches every record of its left hand side, keyed by the value
+ * of the left join expression, within an open addressing hash table.
+ * Each right hand side record probes the table in constant time,
+ * and is merged with every cached record whose join value equals its own.
+ *
+ * The left hand side is cached as it is expected to be the smaller stream.
+ * Once the records cached exceed that expectation considerably, and the right
+ * hand side is expected to be smaller still, the sides switch roles:
+ * the right hand side is cached instead, and the records cached so far
+ * probe it ahead of the remainder of the left hand side. */
+
+// Records cached between checks for a misestimated cache side.
+#define VALUE_HASH_JOIN_ADAPT_BATCH 1024
+// Factor by which the records cached must exceed their estimate for the sides to switch.
+#define VALUE_HASH_JOIN_ADAPT_RATIO 4
+
+// Hash table slot, groups cached records sharing a join value.
+typedef struct {
+	uint64_t hash;      // Hash code of the join value.
+	uint32_t head;      // First record joined on value, index + 1 into cached records, 0 if empty.
+	uint32_t tail;      // Last record joined on value, index + 1 into cached records.
+} JoinBucket;
+
 typedef struct {
 	OpBase op;
-	Record rhs_rec;                     // Right hand side record.
+	Record rhs_rec;                     // Probing record.
 	AR_ExpNode *lhs_exp;                // Left hand side expression to join on.
 	AR_ExpNode *rhs_exp;                // Right hand side expression to join on.
-	int64_t intersect_idx;              // Current intersection, < number_of_intersections
+	OpBase *build_child;                // Child whose records are cached.
+	OpBase *probe_child;                // Child whose records probe the cache.
+	AR_ExpNode *build_exp;              // Join expression of the cached side.
+	AR_ExpNode *probe_exp;              // Join expression of the probing side.
+	double build_estimate;              // Estimated number of records on the cached side.
+	double probe_estimate;              // Estimated number of records on the probing side.
+	bool switched;                      // True if the sides switched roles.
+	Record *pending;                    // Records cached before switching, probing first.
+	uint pending_idx;                   // Next pending record.
+	uint32_t intersect_idx;             // Next intersecting record, index + 1 into cached records, 0 if none.
 	Record *cached_records;             // Cached left hand side records.
+	uint32_t *chain;                    // Next record sharing a join value, index + 1, 0 ends the chain.
+	JoinBucket *buckets;                // Open addressing hash table over the join values.
+	uint64_t bucket_mask;               // Number of buckets - 1, a power of 2.
 	uint join_value_rec_idx;            // position on joined expression within record.
-	int64_t number_of_intersections;    // Number of intersections located.
 } OpValueHashJoin;
 
 /* Creates a new ValueHashJoin operation */
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "argument_cache.h"
+#include "xxhash.h"
+#include "../../../util/arr.h"
+#include "../../../util/rmalloc.h"
+#include "../../../datatypes/path/sipath.h"
+#include <assert.h>
+
+// Scalar types which can be hashed and compared.
+#define CACHEABLE_TYPES (T_NODE | T_EDGE | T_ARRAY | T_PATH | T_STRING | T_BOOL | \
+						 T_INT64 | T_DOUBLE | T_NULL | T_POINT)
+
+ArgumentCache *ArgumentCache_New(const uint *offsets, uint offset_count) {
+	ArgumentCache *cache = rm_malloc(sizeof(ArgumentCache));
+	cache->offsets = array_new(uint, offset_count);
+	for(uint i = 0; i < offset_count; i++) cache->offsets = array_append(cache->offsets, offsets[i]);
+	cache->entries = array_new(ArgumentCacheEntry, 16);
+	cache->bucket_mask = 31;
+	cache->buckets = rm_calloc(cache->bucket_mask + 1, sizeof(uint32_t));
+	return cache;
+}
+
+bool ArgumentCache_Hash(const ArgumentCache *cache, Record r, uint64_t *hash) {
+	XXH64_state_t state;
+	XXH_errorcode res = XXH64_reset(&state, 0);
+	assert(res != XXH_ERROR);
+
+	uint key_count = array_len(cache->offsets);
+	for(uint i = 0; i < key_count; i++) {
+		int idx = cache->offsets[i];
+		RecordEntryType type = Record_GetType(r, idx);
+		XXH64_hash_t h = 0;
+		if(type == REC_TYPE_NODE || type == REC_TYPE_EDGE) {
+			EntityID id = ENTITY_GET_ID(Record_GetGraphEntity(r, idx));
+			h = XXH64(&id, sizeof(id), type);
+		} else if(type == REC_TYPE_SCALAR) {
+			SIValue v = Record_GetScalar(r, idx);
+			if(!(SI_TYPE(v) & CACHEABLE_TYPES)) return false;
+			h = SIValue_HashCode(v);
+		}
+		XXH64_update(&state, &type, sizeof(type));
+		XXH64_update(&state, &h, sizeof(h));
+	}
+
+	*hash = XXH64_digest(&state);
+	return true;
+}
+
+static bool _ArgumentCache_KeysMatch(const ArgumentCache *cache, const ArgumentKey *keys,
+									 Record r) {
+	uint key_count = array_len(cache->offsets);
+	for(uint i = 0; i < key_count; i++) {
+		int idx = cache->offsets[i];
+		RecordEntryType type = Record_GetType(r, idx);
+		if(keys[i].type != type) return false;
+		if(type == REC_TYPE_NODE || type == REC_TYPE_EDGE) {
+			if(keys[i].value.longval != ENTITY_GET_ID(Record_GetGraphEntity(r, idx))) return false;
+		} else if(type == REC_TYPE_SCALAR) {
+			SIValue v = Record_GetScalar(r, idx);
+			SIValue key = keys[i].value;
+			if(SI_TYPE(v) == T_PATH || SI_TYPE(key) == T_PATH) {
+				if(SI_TYPE(v) != SI_TYPE(key) || SIPath_Compare(key, v) != 0) return false;
+			} else if(!(SI_TYPE(v) == T_NULL && SI_TYPE(key) == T_NULL) &&
+					  SIValue_Compare(key, v, NULL) != 0) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Returns the bucket of the entry matching r, or the empty bucket it belongs in.
+static uint32_t *_ArgumentCache_Bucket(const ArgumentCache *cache, Record r, uint64_t hash) {
+	uint32_t i = hash & cache->bucket_mask;
+	while(cache->buckets[i]) {
+		const ArgumentCacheEntry *entry = cache->entries + cache->buckets[i] - 1;
+		if(entry->hash == hash && _ArgumentCache_KeysMatch(cache, entry->keys, r)) break;
+		i = (i + 1) & cache->bucket_mask;
+	}
+	return cache->buckets + i;
+}
+
+bool ArgumentCache_Get(const ArgumentCache *cache, Record r, uint64_t hash, bool *result) {
+	uint32_t *bucket = _ArgumentCache_Bucket(cache, r, hash);
+	if(*bucket == 0) return false;
+	*result = cache->entries[*bucket - 1].result;
+	return true;
+}
+
+// Doubles buckets, reinserting entries by their hashes.
+static void _ArgumentCache_Grow(ArgumentCache *cache) {
+	rm_free(cache->buckets);
+	cache->bucket_mask = cache->bucket_mask * 2 + 1;
+	cache->buckets = rm_calloc(cache->bucket_mask + 1, sizeof(uint32_t));
+	uint entry_count = array_len(cache->entries);
+	for(uint i = 0; i < entry_count; i++) {
+		uint32_t b = cache->entries[i].hash & cache->bucket_mask;
+		while(cache->buckets[b]) b = (b + 1) & cache->bucket_mask;
+		cache->buckets[b] = i + 1;
+	}
+}
+
+void ArgumentCache_Add(ArgumentCache *cache, Record r, uint64_t hash, bool result) {
+	uint entry_count = array_len(cache->entries);
+	if(entry_count >= ARGUMENT_CACHE_CAP) return;
+
+	uint32_t *bucket = _ArgumentCache_Bucket(cache, r, hash);
+	if(*bucket) return;
+
+	uint key_count = array_len(cache->offsets);
+	ArgumentCacheEntry entry = {.hash = hash, .result = result, .keys = NULL};
+	if(key_count) entry.keys = rm_malloc(sizeof(ArgumentKey) * key_count);
+	for(uint i = 0; i < key_count; i++) {
+		int idx = cache->offsets[i];
+		RecordEntryType type = Record_GetType(r, idx);
+		entry.keys[i].type = type;
+		if(type == REC_TYPE_NODE || type == REC_TYPE_EDGE) {
+			entry.keys[i].value = SI_LongVal(ENTITY_GET_ID(Record_GetGraphEntity(r, idx)));
+		} else if(type == REC_TYPE_SCALAR) {
+			entry.keys[i].value = SI_CloneValue(Record_GetScalar(r, idx));
+		} else {
+			entry.keys[i].value = SI_NullVal();
+		}
+	}
+
+	cache->entries = array_append(cache->entries, entry);
+	*bucket = entry_count + 1;
+	// Keep buckets at most half full.
+	if((entry_count + 1) * 2 > cache->bucket_mask + 1) _ArgumentCache_Grow(cache);
+}
+
+void ArgumentCache_Clear(ArgumentCache *cache) {
+	uint key_count = array_len(cache->offsets);
+	uint entry_count = array_len(cache->entries);
+	for(uint i = 0; i < entry_count; i++) {
+		ArgumentKey *keys = cache->entries[i].keys;
+		if(!keys) continue;
+		for(uint j = 0; j < key_count; j++) SIValue_Free(keys[j].value);
+		rm_free(keys);
+	}
+	array_clear(cache->entries);
+	memset(cache->buckets, 0, sizeof(uint32_t) * (cache->bucket_mask + 1));
+}
+
+void ArgumentCache_Free(ArgumentCache *cache) {
+	ArgumentCache_Clear(cache);
+	array_free(cache->entries);
+	array_free(cache->offsets);
+	rm_free(cache->buckets);
+	rm_free(cache);
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../record.h"
+
+// Maximum number of distinct arguments cached.
+#define ARGUMENT_CACHE_CAP 65536
+
+// A cached argument value, graph entities are kept by ID.
+typedef struct {
+	RecordEntryType type;   // Record entry type.
+	SIValue value;          // Owned scalar, or entity ID.
+} ArgumentKey;
+
+typedef struct {
+	uint64_t hash;          // Hash of keys.
+	ArgumentKey *keys;      // Argument values, one per cached offset.
+	bool result;            // Cached outcome for these arguments.
+} ArgumentCacheEntry;
+
+/* Memoizes a boolean outcome, such as whether a pattern exists,
+ * per distinct combination of record values at a set of offsets.
+ * Entries are located through an open addressing table over their hashes. */
+typedef struct {
+	uint *offsets;                  // Record offsets of the argument values.
+	ArgumentCacheEntry *entries;    // Cached entries, in insertion order.
+	uint32_t *buckets;              // Entry index + 1 per bucket, 0 marks an empty bucket.
+	uint32_t bucket_mask;           // Number of buckets - 1.
+} ArgumentCache;
+
+// Creates a cache keyed on the values of the given record offsets.
+ArgumentCache *ArgumentCache_New(const uint *offsets, uint offset_count);
+
+// Hashes r's arguments into hash, returns false if they can't be cached.
+bool ArgumentCache_Hash(const ArgumentCache *cache, Record r, uint64_t *hash);
+
+// Looks up r's arguments of the given hash, on success sets result and returns true.
+bool ArgumentCache_Get(const ArgumentCache *cache, Record r, uint64_t hash, bool *result);
+
+// Caches result for r's arguments, ignored once the cache is full.
+void ArgumentCache_Add(ArgumentCache *cache, Record r, uint64_t hash, bool result);
+
+// Removes every cached entry.
+void ArgumentCache_Clear(ArgumentCache *cache);
+
+void ArgumentCache_Free(ArgumentCache *cache);
@@ -5,18 +5,72 @@
  */
 
 #include "create_functions.h"
+#include "unique_constraints.h"
 #include "../../../query_ctx.h"
+#include "../../../change_feed/change_feed.h"
 
 // Add properties to the GraphEntity.
-static inline void _AddProperties(ResultSetStatistics *stats, GraphEntity *ge,
+static inline void _AddProperties(GraphContext *gc, ResultSetStatistics *stats, GraphEntity *ge,
 								  PendingProperties *props) {
+	SIValue values[props->property_count];
 	for(int i = 0; i < props->property_count; i++) {
-		GraphEntity_AddProperty(ge, props->attr_keys[i], props->values[i]);
+		values[i] = GraphContext_InternValue(gc, props->attr_keys[i], props->values[i]);
 	}
+	GraphEntity_AddProperties(ge, props->property_count, props->attr_keys, values);
 
 	if(stats) stats->properties_set += props->property_count;
 }
 
+/* Fail the query if a pending node holds a value taken under a uniquely
+ * constrained attribute of one of its labels, by either an existing node
+ * or another pending node. Runs prior to introducing any node. */
+static void _ValidateUniqueConstraints(PendingCreations *pending) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	// Collect the constrained schemas of each blueprint.
+	bool constrained = false;
+	uint blueprint_node_count = array_len(pending->nodes_to_create);
+	Schema **schemas[blueprint_node_count];
+	for(uint i = 0; i < blueprint_node_count; i++) {
+		QGNode *blueprint = pending->nodes_to_create[i].node;
+		uint label_count = QGNode_LabelCount(blueprint);
+		schemas[i] = array_new(Schema *, label_count);
+		for(uint j = 0; j < label_count; j++) {
+			Schema *s = GraphContext_GetSchema(gc, blueprint->labels[j], SCHEMA_NODE);
+			if(Schema_HasUniqueConstraints(s)) schemas[i] = array_append(schemas[i], s);
+		}
+		constrained |= (array_len(schemas[i]) > 0);
+	}
+
+	const Schema *violated = NULL;
+	Attribute_ID violated_attr = ATTRIBUTE_NOTFOUND;
+	if(constrained) {
+		UniqueClaims claims = UniqueClaims_New();
+		uint node_count = array_len(pending->created_nodes);
+		for(uint i = 0; i < node_count && !violated; i++) {
+			PendingProperties *props = pending->node_properties[i];
+			if(props == NULL) continue;
+			Schema **node_schemas = schemas[i % blueprint_node_count];
+			uint schema_count = array_len(node_schemas);
+			for(uint j = 0; j < schema_count && !violated; j++) {
+				for(int k = 0; k < props->property_count && !violated; k++) {
+					Attribute_ID attr = props->attr_keys[k];
+					if(!Schema_IsUnique(node_schemas[j], attr)) continue;
+					if(!UniqueClaims_Claim(&claims, node_schemas[j], attr, props->values[k],
+										   INVALID_ENTITY_ID)) {
+						violated = node_schemas[j];
+						violated_attr = attr;
+					}
+				}
+			}
+		}
+		UniqueClaims_Free(&claims);
+	}
+
+	for(uint i = 0; i < blueprint_node_count; i++) array_free(schemas[i]);
+	if(violated) UniqueConstraint_RaiseViolation(violated, violated_attr);
+}
+
 /* Commit insertions. */
 static void _CommitNodes(PendingCreations *pending) {
 	Node *n;
@@ -31,8 +85,10 @@ static void _CommitNodes(PendingCreations *pending) {
 	for(uint i = 0; i < blueprint_node_count; i++) {
 		NodeCreateCtx *node_ctx = pending->nodes_to_create + i;
 
-		const char *label = node_ctx->node->label;
-		if(label) {
+		QGNode *blueprint = node_ctx->node;
+		uint label_count = QGNode_LabelCount(blueprint);
+		for(uint j = 0; j < label_count; j++) {
+			const char *label = blueprint->labels[j];
 			if(GraphContext_GetSchema(gc, label, SCHEMA_NODE) == NULL) {
 				Schema *s = GraphContext_AddSchema(gc, label, SCHEMA_NODE);
 				pending->stats->labels_added++;
@@ -40,29 +96,37 @@ static void _CommitNodes(PendingCreations *pending) {
 		}
 	}
 
+	// Reserve IDs for all created nodes at once.
 	uint node_count = array_len(pending->created_nodes);
-	Graph_AllocateNodes(g, node_count);
+	NodeID *ids = rm_malloc(sizeof(NodeID) * node_count);
+	Graph_ReserveNodes(g, node_count, ids);
 
 	for(uint i = 0; i < node_count; i++) {
 		n = pending->created_nodes[i];
-		Schema *s = NULL;
-
-		// Get label ID.
-		int labelID = GRAPH_NO_LABEL;
-		if(n->label != NULL) {
-			s = GraphContext_GetSchema(gc, n->label, SCHEMA_NODE);
+		/* Nodes are buffered a Record at a time, following the CREATE pattern order,
+		 * as such the i'th created node originates from the following blueprint. */
+		QGNode *blueprint = pending->nodes_to_create[i % blueprint_node_count].node;
+		uint label_count = QGNode_LabelCount(blueprint);
+
+		// Introduce node into graph, the first label becomes the node's primary label.
+		Graph_StageNode(g, ids[i], n);
+		for(uint j = 0; j < label_count; j++) {
+			Schema *s = GraphContext_GetSchema(gc, blueprint->labels[j], SCHEMA_NODE);
 			assert(s);
-			labelID = s->id;
+			Graph_LabelNode(g, ids[i], s->id);
 		}
 
-		// Introduce node into graph.
-		Graph_CreateNode(g, labelID, n);
-
-		if(pending->node_properties[i]) _AddProperties(pending->stats, (GraphEntity *)n,
+		if(pending->node_properties[i]) _AddProperties(gc, pending->stats, (GraphEntity *)n,
 														   pending->node_properties[i]);
 
-		if(s && Schema_HasIndices(s)) Schema_AddNodeToIndices(s, n, false);
+		for(uint j = 0; j < label_count; j++) {
+			Schema *s = GraphContext_GetSchema(gc, blueprint->labels[j], SCHEMA_NODE);
+			SchemaStats_AddEntity(s->stats, (GraphEntity *)n);
+			if(Schema_HasIndices(s)) Schema_AddNodeToIndices(s, n, false);
+		}
+		ChangeFeed_NodeCreated(n, blueprint->labels, label_count);
 	}
+	rm_free(ids);
 }
 
 static void _CommitEdges(PendingCreations *pending) {
@@ -100,12 +164,12 @@ static void _CommitEdges(PendingCreations *pending) {
 
 		// Nodes which already existed prior to this query would
 		// have their ID set under e->srcNodeID and e->destNodeID
-		// Nodes which are created as part of this query would be
-		// saved under edge src/dest pointer.
+		// Nodes which are created as part of this query were
+		// assigned their ID once committed.
 		if(e->srcNodeID != INVALID_ENTITY_ID) srcNodeID = e->srcNodeID;
-		else srcNodeID = ENTITY_GET_ID(Edge_GetSrcNode(e));
+		else srcNodeID = ENTITY_GET_ID(pending->edge_srcs[i]);
 		if(e->destNodeID != INVALID_ENTITY_ID) destNodeID = e->destNodeID;
-		else destNodeID = ENTITY_GET_ID(Edge_GetDestNode(e));
+		else destNodeID = ENTITY_GET_ID(pending->edge_dests[i]);
 
 		Schema *schema = GraphContext_GetSchema(gc, e->relationship, SCHEMA_EDGE);
 		if(!schema) schema = GraphContext_AddSchema(gc, e->relationship, SCHEMA_EDGE);
@@ -113,8 +177,11 @@ static void _CommitEdges(PendingCreations *pending) {
 
 		assert(Graph_ConnectNodes(g, srcNodeID, destNodeID, relation_id, e));
 
-		if(pending->edge_properties[i]) _AddProperties(pending->stats, (GraphEntity *)e,
+		if(pending->edge_properties[i]) _AddProperties(gc, pending->stats, (GraphEntity *)e,
 														   pending->edge_properties[i]);
+
+		if(schema->index) Schema_AddEdgeToIndices(schema, e, false);
+		ChangeFeed_EdgeCreated(e, relation_id);
 	}
 }
 
@@ -125,6 +192,8 @@ PendingCreations NewPendingCreationsContainer(NodeCreateCtx *nodes, EdgeCreateCt
 	pending.edges_to_create = edges;
 	pending.created_nodes = array_new(Node *, 0);
 	pending.created_edges = array_new(Edge *, 0);
+	pending.edge_srcs = array_new(Node *, 0);
+	pending.edge_dests = array_new(Node *, 0);
 	pending.node_properties = array_new(PendingProperties *, 0);
 	pending.edge_properties = array_new(PendingProperties *, 0);
 	pending.stats = QueryCtx_GetResultSetStatistics();
@@ -139,6 +208,8 @@ void CommitNewEntities(OpBase *op, PendingCreations *pending) {
 	uint edge_count = array_len(pending->created_edges);
 	// Lock everything.
 	QueryCtx_LockForCommit();
+	// No node is introduced if any violates a unique constraint.
+	if(node_count > 0) _ValidateUniqueConstraints(pending);
 
 	/* Set sync policy to resize to capacity only for node introduction
 	 * as only node creation can have an effect on matrix dimensions. */
@@ -210,6 +281,13 @@ void PendingCreationsFree(PendingCreations *pending) {
 		pending->created_edges = NULL;
 	}
 
+	if(pending->edge_srcs) {
+		array_free(pending->edge_srcs);
+		array_free(pending->edge_dests);
+		pending->edge_srcs = NULL;
+		pending->edge_dests = NULL;
+	}
+
 	// Free all graph-committed properties associated with nodes.
 	if(pending->node_properties) {
 		uint prop_count = array_len(pending->node_properties);
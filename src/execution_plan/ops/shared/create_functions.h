@@ -26,6 +26,8 @@ typedef struct {
 
 	Node **created_nodes;
 	Edge **created_edges;
+	Node **edge_srcs;       // Source node of each created edge, resolved once nodes are committed.
+	Node **edge_dests;      // Destination node of each created edge.
 	ResultSetStatistics *stats;
 } PendingCreations;
 
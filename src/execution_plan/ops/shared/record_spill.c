@@ -0,0 +1,239 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "record_spill.h"
+#include "../../../util/rmalloc.h"
+#include "../../../datatypes/array.h"
+#include "../../../datatypes/path/sipath.h"
+#include <assert.h>
+
+static inline bool _write(RecordSpill *spill, const void *buf, size_t len) {
+	return fwrite(buf, len, 1, spill->file) == 1;
+}
+
+static inline void _read(RecordSpill *spill, void *buf, size_t len) {
+	size_t res = fread(buf, len, 1, spill->file);
+	assert(res == 1);
+}
+
+static bool _write_value(RecordSpill *spill, SIValue v) {
+	SIType t = SI_TYPE(v);
+	if(!_write(spill, &t, sizeof(t))) return false;
+
+	switch(t) {
+	case T_NULL:
+		return true;
+	case T_INT64:
+	case T_BOOL:
+		return _write(spill, &v.longval, sizeof(v.longval));
+	case T_DOUBLE:
+		return _write(spill, &v.doubleval, sizeof(v.doubleval));
+	case T_POINT:
+		return _write(spill, &v.point, sizeof(v.point));
+	case T_STRING: {
+		uint32_t len = strlen(v.stringval);
+		return _write(spill, &len, sizeof(len)) && _write(spill, v.stringval, len);
+	}
+	case T_NODE:
+		return _write(spill, v.ptrval, sizeof(Node));
+	case T_EDGE:
+		return _write(spill, v.ptrval, sizeof(Edge));
+	case T_ARRAY: {
+		uint32_t len = SIArray_Length(v);
+		if(!_write(spill, &len, sizeof(len))) return false;
+		for(uint32_t i = 0; i < len; i++) {
+			if(!_write_value(spill, SIArray_Get(v, i))) return false;
+		}
+		return true;
+	}
+	case T_PATH: {
+		// Paths are a single block retaining their entities.
+		size_t size;
+		const void *raw = SIPath_Raw(v, &size);
+		uint32_t len = size;
+		return _write(spill, &len, sizeof(len)) && _write(spill, raw, len);
+	}
+	default:
+		// Pointers and not yet supported types are never sorted.
+		assert(false && "Encountered unspillable SIValue type");
+		return false;
+	}
+}
+
+// Reads a value, which owns all of its allocations.
+static SIValue _read_value(RecordSpill *spill) {
+	SIType t;
+	_read(spill, &t, sizeof(t));
+
+	SIValue v;
+	switch(t) {
+	case T_NULL:
+		return SI_NullVal();
+	case T_INT64:
+		_read(spill, &v.longval, sizeof(v.longval));
+		return SI_LongVal(v.longval);
+	case T_BOOL:
+		_read(spill, &v.longval, sizeof(v.longval));
+		return SI_BoolVal(v.longval);
+	case T_DOUBLE:
+		_read(spill, &v.doubleval, sizeof(v.doubleval));
+		return SI_DoubleVal(v.doubleval);
+	case T_POINT:
+		_read(spill, &v.point, sizeof(v.point));
+		return SI_Point(v.point.latitude, v.point.longitude);
+	case T_STRING: {
+		uint32_t len;
+		_read(spill, &len, sizeof(len));
+		char *s = rm_malloc(len + 1);
+		_read(spill, s, len);
+		s[len] = '\0';
+		return SI_TransferStringVal(s);
+	}
+	case T_NODE: {
+		Node n;
+		_read(spill, &n, sizeof(n));
+		return SI_CloneValue(SI_Node(&n));
+	}
+	case T_EDGE: {
+		Edge e;
+		_read(spill, &e, sizeof(e));
+		return SI_CloneValue(SI_Edge(&e));
+	}
+	case T_ARRAY: {
+		uint32_t len;
+		_read(spill, &len, sizeof(len));
+		v = SI_Array(len);
+		for(uint32_t i = 0; i < len; i++) {
+			// SIArray_Append clones the element.
+			SIValue elem = _read_value(spill);
+			SIArray_Append(&v, elem);
+			SIValue_Free(elem);
+		}
+		return v;
+	}
+	case T_PATH: {
+		uint32_t len;
+		_read(spill, &len, sizeof(len));
+		void *raw = rm_malloc(len);
+		_read(spill, raw, len);
+		v = SIPath_FromRaw(raw, len);
+		rm_free(raw);
+		return v;
+	}
+	default:
+		assert(false && "Encountered unspillable SIValue type");
+		return SI_NullVal();
+	}
+}
+
+RecordSpill *RecordSpill_New(void) {
+	FILE *file = tmpfile();
+	if(file == NULL) return NULL;
+
+	RecordSpill *spill = rm_malloc(sizeof(RecordSpill));
+	spill->file = file;
+	spill->count = 0;
+	spill->read = 0;
+	return spill;
+}
+
+bool RecordSpill_Write(RecordSpill *spill, const Record r) {
+	uint len = Record_length(r);
+	for(uint i = 0; i < len; i++) {
+		uint8_t type = r->entries[i].type;
+		if(!_write(spill, &type, sizeof(type))) return false;
+		switch(r->entries[i].type) {
+		case REC_TYPE_UNKNOWN:
+			break;
+		case REC_TYPE_NODE:
+			if(!_write(spill, &r->entries[i].value.n, sizeof(Node))) return false;
+			break;
+		case REC_TYPE_EDGE:
+			if(!_write(spill, &r->entries[i].value.e, sizeof(Edge))) return false;
+			break;
+		case REC_TYPE_SCALAR:
+			if(!_write_value(spill, r->entries[i].value.s)) return false;
+			break;
+		default:
+			assert(false && "Encountered unspillable record entry type");
+		}
+	}
+	spill->count++;
+	return true;
+}
+
+bool RecordSpill_Rewind(RecordSpill *spill) {
+	return fflush(spill->file) == 0 && fseek(spill->file, 0, SEEK_SET) == 0;
+}
+
+bool RecordSpill_Read(RecordSpill *spill, Record r) {
+	if(spill->read == spill->count) return false;
+
+	uint len = Record_length(r);
+	for(uint i = 0; i < len; i++) {
+		uint8_t type;
+		_read(spill, &type, sizeof(type));
+		switch(type) {
+		case REC_TYPE_UNKNOWN:
+			break;
+		case REC_TYPE_NODE: {
+			Node n;
+			_read(spill, &n, sizeof(n));
+			Record_AddNode(r, i, n);
+			break;
+		}
+		case REC_TYPE_EDGE: {
+			Edge e;
+			_read(spill, &e, sizeof(e));
+			Record_AddEdge(r, i, e);
+			break;
+		}
+		case REC_TYPE_SCALAR:
+			Record_AddScalar(r, i, _read_value(spill));
+			break;
+		default:
+			assert(false);
+		}
+	}
+	spill->read++;
+	return true;
+}
+
+static size_t _value_footprint(SIValue v) {
+	switch(SI_TYPE(v)) {
+	case T_STRING:
+		// Only owned strings are freed once the record is spilled.
+		return (v.allocation == M_SELF) ? strlen(v.stringval) + 1 : 0;
+	case T_ARRAY: {
+		uint32_t len = SIArray_Length(v);
+		size_t size = len * sizeof(SIValue);
+		for(uint32_t i = 0; i < len; i++) size += _value_footprint(SIArray_Get(v, i));
+		return size;
+	}
+	case T_PATH: {
+		size_t size;
+		SIPath_Raw(v, &size);
+		return size;
+	}
+	default:
+		return 0;
+	}
+}
+
+size_t RecordSpill_Footprint(const Record r) {
+	uint len = Record_length(r);
+	size_t size = sizeof(_Record) + len * sizeof(Entry);
+	for(uint i = 0; i < len; i++) {
+		if(r->entries[i].type == REC_TYPE_SCALAR) size += _value_footprint(r->entries[i].value.s);
+	}
+	return size;
+}
+
+void RecordSpill_Free(RecordSpill *spill) {
+	if(spill == NULL) return;
+	fclose(spill->file);
+	rm_free(spill);
+}
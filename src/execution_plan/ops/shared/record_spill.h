@@ -0,0 +1,41 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "../../record.h"
+
+/* Records spilled to a temporary file, to be read back by the same query.
+ * Scalars are written by value, while graph entities are written as is,
+ * referencing their entities within the graph, which outlive the query.
+ * The file is removed once closed. */
+typedef struct {
+	FILE *file;     // Temporary file.
+	size_t count;   // Number of records written.
+	size_t read;    // Number of records read back.
+} RecordSpill;
+
+// Creates a new, empty, spill file, returns NULL if no temporary file could be created.
+RecordSpill *RecordSpill_New(void);
+
+// Appends r to the spill, returns false on write failure.
+bool RecordSpill_Write(RecordSpill *spill, const Record r);
+
+// Prepares a spill, which is no longer written to, for reading.
+// Returns false on failure.
+bool RecordSpill_Rewind(RecordSpill *spill);
+
+// Reads the next record into r, which must be empty and of the written records' length.
+// Returns false once every record was read.
+bool RecordSpill_Read(RecordSpill *spill, Record r);
+
+// Approximate number of bytes held by a record's entries.
+size_t RecordSpill_Footprint(const Record r);
+
+// Closes and removes spill file.
+void RecordSpill_Free(RecordSpill *spill);
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "supernode_scan.h"
+#include "../../../query_ctx.h"
+#include <string.h>
+#include <assert.h>
+
+// Returns the relation operand of exp if exp is a, possibly transposed, relation.
+static const AlgebraicExpression *_RelationOperand(const AlgebraicExpression *exp,
+												   bool *transposed) {
+	*transposed = false;
+	if(exp->type == AL_OPERATION) {
+		if(exp->operation.op != AL_EXP_TRANSPOSE || AlgebraicExpression_ChildCount(exp) != 1) return NULL;
+		*transposed = true;
+		exp = exp->operation.children[0];
+	}
+	if(exp->type != AL_OPERAND || exp->operand.diagonal) return NULL;
+	return exp;
+}
+
+static inline bool _LabelOperand(const AlgebraicExpression *exp) {
+	return exp->type == AL_OPERAND && exp->operand.diagonal && exp->operand.label;
+}
+
+// Resolves scan's matrices, returns false if the relation doesn't exist.
+static bool _SupernodeScan_Resolve(SupernodeScan *scan) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Graph *g = gc->g;
+
+	int relation_id = GRAPH_NO_RELATION;
+	const char *relation = scan->relation->operand.label;
+	if(relation) {
+		Schema *s = GraphContext_GetSchema(gc, relation, SCHEMA_EDGE);
+		if(!s) return false;
+		relation_id = s->id;
+	}
+	scan->R = (scan->transposed) ? Graph_GetTransposedRelationMatrix(g, relation_id) :
+			  Graph_GetRelationMatrix(g, relation_id);
+
+	scan->S = GrB_NULL;
+	scan->D = GrB_NULL;
+	const AlgebraicExpression *labels[2] = {scan->src_label, scan->dest_label};
+	GrB_Matrix *matrices[2] = {&scan->S, &scan->D};
+	for(int i = 0; i < 2; i++) {
+		if(!labels[i]) continue;
+		Schema *s = GraphContext_GetSchema(gc, labels[i]->operand.label, SCHEMA_NODE);
+		*matrices[i] = (s) ? Graph_GetLabelMatrix(g, s->id) : Graph_GetZeroMatrix(g);
+	}
+
+	if(scan->iter == NULL) GxB_MatrixTupleIter_new(&scan->iter, scan->R);
+	scan->resolved = true;
+	return true;
+}
+
+static inline bool _HasEntry(GrB_Matrix M, GrB_Index row, GrB_Index col) {
+	bool x;
+	return GrB_Matrix_extractElement_BOOL(&x, M, row, col) == GrB_SUCCESS;
+}
+
+bool SupernodeScan_Init(SupernodeScan *scan, const AlgebraicExpression *exp) {
+	memset(scan, 0, sizeof(SupernodeScan));
+
+	// Split exp into its multiplied operands.
+	uint count = 1;
+	const AlgebraicExpression *const *operands = &exp;
+	if(exp->type == AL_OPERATION && exp->operation.op == AL_EXP_MUL) {
+		count = AlgebraicExpression_ChildCount(exp);
+		operands = (const AlgebraicExpression * const *)exp->operation.children;
+	}
+	if(count > 3) return false;
+
+	uint i = 0;
+	if(count > 1 && _LabelOperand(operands[0])) scan->src_label = operands[i++];
+	if(i == count) return false;
+	scan->relation = _RelationOperand(operands[i++], &scan->transposed);
+	if(!scan->relation) return false;
+	if(i < count) {
+		if(!_LabelOperand(operands[i])) return false;
+		scan->dest_label = operands[i++];
+	}
+	return i == count;
+}
+
+GrB_Index SupernodeScan_Degree(SupernodeScan *scan, NodeID src) {
+	if(!scan->resolved && !_SupernodeScan_Resolve(scan)) return 0;
+
+	// Row length, as bounded by the iterator over the row.
+	GxB_MatrixTupleIter_reuse(scan->iter, scan->R);
+	if(GxB_MatrixTupleIter_iterate_row(scan->iter, src) != GrB_SUCCESS) return 0;
+	return scan->iter->nvals - scan->iter->nnz_idx;
+}
+
+void SupernodeScan_Start(SupernodeScan *scan, NodeID src) {
+	assert(scan->resolved);
+	scan->src = src;
+	scan->slice_len = 0;
+	scan->slice_idx = 0;
+
+	scan->by_label = false;
+
+	// Source isn't labeled as required, no destinations are reached.
+	scan->depleted = (scan->S != GrB_NULL && !_HasEntry(scan->S, src, src));
+	if(scan->depleted) return;
+
+	// Scan the destination label if it holds fewer nodes than src's neighbors.
+	GrB_Index degree = SupernodeScan_Degree(scan, src);
+	if(scan->D != GrB_NULL) {
+		GrB_Index labeled;
+		GrB_Matrix_nvals(&labeled, scan->D);
+		if(labeled < degree) {
+			scan->by_label = true;
+			GxB_MatrixTupleIter_reuse(scan->iter, scan->D);
+		}
+	}
+}
+
+bool SupernodeScan_Next(SupernodeScan *scan, NodeID *dest) {
+	if(scan->depleted) return false;
+	bool depleted;
+
+	if(scan->by_label) {
+		// Confirm each labeled node is connected to src.
+		while(true) {
+			GrB_Index id;
+			GxB_MatrixTupleIter_next(scan->iter, &id, NULL, &depleted);
+			if(depleted) {
+				scan->depleted = true;
+				return false;
+			}
+			if(_HasEntry(scan->R, scan->src, id)) {
+				*dest = id;
+				return true;
+			}
+		}
+	}
+
+	while(true) {
+		while(scan->slice_idx < scan->slice_len) {
+			GrB_Index id = scan->slice[scan->slice_idx++];
+			if(scan->D == GrB_NULL || _HasEntry(scan->D, id, id)) {
+				*dest = id;
+				return true;
+			}
+		}
+		// Pull the next slice of src's row.
+		scan->slice_idx = 0;
+		GxB_MatrixTupleIter_next_row(scan->iter, NULL, &scan->slice, NULL, &scan->slice_len,
+									 &depleted);
+		if(depleted) break;
+	}
+
+	scan->depleted = true;
+	return false;
+}
+
+void SupernodeScan_Reset(SupernodeScan *scan) {
+	scan->resolved = false;
+	scan->slice_len = 0;
+	scan->slice_idx = 0;
+}
+
+void SupernodeScan_Free(SupernodeScan *scan) {
+	if(scan->iter) {
+		GxB_MatrixTupleIter_free(scan->iter);
+		scan->iter = NULL;
+	}
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../../graph/graph.h"
+#include "../../../arithmetic/algebraic_expression.h"
+#include "../../../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+/* A traversal reaching a node with millions of neighbors would materialize them all
+ * within a single row of its result matrix. Sources whose degree reaches
+ * SUPERNODE_SCAN_DEGREE are instead traversed on their own, reading their
+ * neighbors straight from the relation matrix a slice at a time, across consume calls.
+ * When the destination is labeled and the label holds fewer nodes than the source's
+ * degree, the label's nodes are scanned instead, each checked for a connecting edge.
+ * Only expressions of a single relation, possibly transposed and enclosed
+ * by source and destination labels, are supported, e.g. [L0] * T([R]) * [L1]. */
+
+// Degree from which a source node is traversed on its own.
+#define SUPERNODE_SCAN_DEGREE 65536
+
+typedef struct {
+	const AlgebraicExpression *src_label;   // Source label operand, optional.
+	const AlgebraicExpression *relation;    // Relation operand.
+	const AlgebraicExpression *dest_label;  // Destination label operand, optional.
+	bool transposed;            // Relation is traversed against its direction.
+	bool resolved;              // Matrices are resolved.
+	GrB_Matrix S;               // Source label matrix.
+	GrB_Matrix R;               // Relation matrix, rows indexed by source.
+	GrB_Matrix D;               // Destination label matrix.
+	GxB_MatrixTupleIter *iter;  // Iterator over R's row, or over D.
+	bool by_label;              // Iterating over D rather than R's row.
+	bool depleted;              // No destinations remain.
+	NodeID src;                 // Traversed source node.
+	const GrB_Index *slice;     // Neighbors slice of R's row.
+	GrB_Index slice_len;        // Length of slice.
+	GrB_Index slice_idx;        // Next neighbor in slice.
+} SupernodeScan;
+
+// Initialize scan for exp, returns false if exp isn't supported.
+bool SupernodeScan_Init(SupernodeScan *scan, const AlgebraicExpression *exp);
+
+// Returns the degree of node src, 0 if unknown.
+GrB_Index SupernodeScan_Degree(SupernodeScan *scan, NodeID src);
+
+// Starts traversing from src.
+void SupernodeScan_Start(SupernodeScan *scan, NodeID src);
+
+// Retrieves the next destination reached from src, returns false once depleted.
+bool SupernodeScan_Next(SupernodeScan *scan, NodeID *dest);
+
+// Forgets resolved matrices, these are resolved again by the next degree check.
+void SupernodeScan_Reset(SupernodeScan *scan);
+
+// Free scan's resources.
+void SupernodeScan_Free(SupernodeScan *scan);
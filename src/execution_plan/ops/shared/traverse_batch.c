@@ -0,0 +1,46 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "traverse_batch.h"
+#include <stdio.h>
+#include <assert.h>
+
+void TraverseBatch_Init(TraverseBatch *batch, uint cap) {
+	assert(batch);
+	batch->cap = cap;
+	batch->size = (cap < TRAVERSE_BATCH_INITIAL) ? cap : TRAVERSE_BATCH_INITIAL;
+	batch->smallest = batch->size;
+	batch->largest = batch->size;
+	batch->batches = 0;
+}
+
+void TraverseBatch_Observe(TraverseBatch *batch, uint count, GrB_Index entries) {
+	assert(batch);
+	if(count == 0) return;
+	batch->batches++;
+
+	double fan_out = (double)entries / count;
+	uint size = batch->size;
+	if(fan_out * size > TRAVERSE_BATCH_MAX_ENTRIES) {
+		// Results exceed the ceiling, shrink to the number of records expected to fit.
+		size = TRAVERSE_BATCH_MAX_ENTRIES / fan_out;
+		if(size == 0) size = 1;
+	} else if(count == size && fan_out * size * 2 <= TRAVERSE_BATCH_MAX_ENTRIES) {
+		/* Grow full batches only, partial batches are collected
+		 * once the child operation is depleted. */
+		size *= 2;
+	}
+	if(size > batch->cap) size = batch->cap;
+
+	batch->size = size;
+	if(size < batch->smallest) batch->smallest = size;
+	if(size > batch->largest) batch->largest = size;
+}
+
+int TraverseBatch_ToString(const TraverseBatch *batch, char *buf, uint buf_len) {
+	return snprintf(buf, buf_len, " | Batches: %llu, Batch size: %u-%u",
+					(unsigned long long)batch->batches, batch->smallest, batch->largest);
+}
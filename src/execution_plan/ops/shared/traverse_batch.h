@@ -0,0 +1,41 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+#include "../../../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+/* Traversals evaluate their algebraic expression over a batch of records at a time,
+ * the number of records per batch adapts to the observed fan-out,
+ * batches grow while their results stay small and shrink once results grow large,
+ * such that the filter and result matrices remain bounded. */
+
+// Number of records of the first batch.
+#define TRAVERSE_BATCH_INITIAL 16
+// Maximal number of records per batch.
+#define TRAVERSE_BATCH_MAX 1024
+// Number of result entries batches are sized to produce at most.
+#define TRAVERSE_BATCH_MAX_ENTRIES 65536
+
+typedef struct {
+	uint cap;           // Maximal batch size, matrices are sized accordingly.
+	uint size;          // Number of records collected for the next batch.
+	uint smallest;      // Smallest batch size used.
+	uint largest;       // Largest batch size used.
+	uint64_t batches;   // Number of batches evaluated.
+} TraverseBatch;
+
+// Initialize batch sizing, batches hold at most cap records.
+void TraverseBatch_Init(TraverseBatch *batch, uint cap);
+
+/* Adapts the next batch size to a batch of count records
+ * producing entries result matrix entries. */
+void TraverseBatch_Observe(TraverseBatch *batch, uint count, GrB_Index entries);
+
+// Prints the batch sizes used, as reported by PROFILE.
+int TraverseBatch_ToString(const TraverseBatch *batch, char *buf, uint buf_len);
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "traverse_expression.h"
+#include "../../../query_ctx.h"
+#include <assert.h>
+
+void TraverseExpression_Init(TraverseExpression *te) {
+	assert(te);
+	te->exp = NULL;
+	te->product = GrB_NULL;
+	te->evaluations = 0;
+	te->reusable = false;
+}
+
+void TraverseExpression_Eval(TraverseExpression *te, const AlgebraicExpression *ae,
+							 GrB_Matrix F, GrB_Matrix M) {
+	assert(te && ae && F && M);
+
+	if(te->exp == NULL) {
+		// Clone expression, as we're about to modify the structure with Optimize.
+		te->exp = AlgebraicExpression_Clone(ae);
+		// Prepend filter matrix to algebraic expression, as the left most operand.
+		AlgebraicExpression_MultiplyToTheLeft(&te->exp, F);
+		AlgebraicExpression_Optimize(&te->exp);
+		/* Operands are fetched from the graph on first evaluation,
+		 * writing queries may modify the graph's matrices in-between batches. */
+		te->reusable = (QueryCtx_GetLastWriter() == NULL);
+	}
+
+	AlgebraicExpression_Eval(te->exp, M);
+	te->evaluations++;
+
+	if(!te->reusable) {
+		// Recompile on next evaluation, fetching operands again.
+		AlgebraicExpression_Free(te->exp);
+		te->exp = NULL;
+		return;
+	}
+
+	if(te->evaluations == TRAVERSE_EXPRESSION_CACHE_THRESHOLD) {
+		AlgebraicExpression_MultiplyTrailingOperands(te->exp, &te->product);
+	}
+}
+
+void TraverseExpression_Free(TraverseExpression *te) {
+	assert(te);
+	if(te->exp) {
+		AlgebraicExpression_Free(te->exp);
+		te->exp = NULL;
+	}
+	if(te->product != GrB_NULL) {
+		GrB_Matrix_free(&te->product);
+		te->product = GrB_NULL;
+	}
+}
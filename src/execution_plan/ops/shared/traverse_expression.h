@@ -0,0 +1,40 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../../arithmetic/algebraic_expression.h"
+#include "../../../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+/* Traversals multiply a filter matrix F, selecting the batch's source nodes,
+ * by their algebraic expression. The optimized expression F * (exp) is compiled once
+ * and evaluated for every batch, F's content changing in-between.
+ * Queries which don't write leave the graph's matrices intact, once enough batches
+ * were evaluated the product of the operands trailing F is computed once and reused,
+ * e.g. F * L_person * R_knows * L_person is evaluated as F * P. */
+
+// Number of batches evaluated before the trailing operands product is cached.
+#define TRAVERSE_EXPRESSION_CACHE_THRESHOLD 4
+
+typedef struct {
+	AlgebraicExpression *exp;   // Compiled expression, F * (exp).
+	GrB_Matrix product;         // Cached product of the operands trailing F.
+	uint64_t evaluations;       // Number of evaluations of the compiled expression.
+	bool reusable;              // Compiled expression may be evaluated across batches.
+} TraverseExpression;
+
+// Initialize an empty, uncompiled expression.
+void TraverseExpression_Init(TraverseExpression *te);
+
+/* Evaluates F * (ae) into M, compiling the expression on first call.
+ * F must remain the same matrix across calls. */
+void TraverseExpression_Eval(TraverseExpression *te, const AlgebraicExpression *ae,
+							 GrB_Matrix F, GrB_Matrix M);
+
+// Free the compiled expression and cached product.
+void TraverseExpression_Free(TraverseExpression *te);
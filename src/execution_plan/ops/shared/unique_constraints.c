@@ -0,0 +1,63 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "unique_constraints.h"
+#include "../../../util/arr.h"
+#include "../../../query_ctx.h"
+
+UniqueClaims UniqueClaims_New(void) {
+	UniqueClaims claims;
+	claims.schemas = array_new(const Schema *, 1);
+	claims.claimed = array_new(OrderedIndex *, 1);
+	claims.created = 0;
+	return claims;
+}
+
+// Returns the values claimed under schema, creating the set if required.
+static OrderedIndex *_UniqueClaims_Get(UniqueClaims *claims, const Schema *s) {
+	uint schema_count = array_len(claims->schemas);
+	for(uint i = 0; i < schema_count; i++) {
+		if(claims->schemas[i] == s) return claims->claimed[i];
+	}
+
+	OrderedIndex *claimed = OrderedIndex_New();
+	claims->schemas = array_append(claims->schemas, s);
+	claims->claimed = array_append(claims->claimed, claimed);
+	return claimed;
+}
+
+bool UniqueClaims_Claim(UniqueClaims *claims, const Schema *s, Attribute_ID attr, SIValue v,
+						EntityID id) {
+	assert(claims && Schema_IsUnique(s, attr));
+
+	// Committed entities.
+	if(Schema_UniqueValueTaken(s, attr, v, id)) return false;
+
+	// Entities pending commit, entities yet to be created are told apart from existing ones.
+	if(id == INVALID_ENTITY_ID) id = (1ULL << 63) | claims->created++;
+	EntityID holder;
+	OrderedIndex *claimed = _UniqueClaims_Get(claims, s);
+	if(OrderedIndex_Lookup(claimed, attr, v, id, &holder)) return false;
+
+	OrderedIndex_Insert(claimed, id, attr, v);
+	return true;
+}
+
+void UniqueClaims_Free(UniqueClaims *claims) {
+	uint schema_count = array_len(claims->schemas);
+	for(uint i = 0; i < schema_count; i++) OrderedIndex_Free(claims->claimed[i]);
+	array_free(claims->schemas);
+	array_free(claims->claimed);
+}
+
+void UniqueConstraint_RaiseViolation(const Schema *s, Attribute_ID attr) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	char *error;
+	asprintf(&error, "Unique constraint violation: another node labeled %s holds the same %s.",
+			 s->name, GraphContext_GetAttributeString(gc, attr));
+	QueryCtx_SetError(error);
+	QueryCtx_RaiseRuntimeException();
+}
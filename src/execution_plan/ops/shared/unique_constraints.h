@@ -0,0 +1,33 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include "../../../schema/schema.h"
+#include "../../../index/ordered_index.h"
+
+// Values claimed under unique constraints by entities pending commit.
+typedef struct {
+	const Schema **schemas;     // Constrained schemas values were claimed under.
+	OrderedIndex **claimed;     // Values claimed under each schema.
+	EntityID created;           // Number of claims made by entities yet to be created.
+} UniqueClaims;
+
+// Create an empty set of claims.
+UniqueClaims UniqueClaims_New(void);
+
+/* Claim v under the uniquely constrained attribute of schema for entity id,
+ * INVALID_ENTITY_ID for entities yet to be created.
+ * Returns false if another entity holds v, either committed or pending. */
+bool UniqueClaims_Claim(UniqueClaims *claims, const Schema *s, Attribute_ID attr, SIValue v,
+						EntityID id);
+
+// Free claims.
+void UniqueClaims_Free(UniqueClaims *claims);
+
+/* Fail the query, reporting a violation of the unique constraint
+ * over the attribute of schema. */
+void UniqueConstraint_RaiseViolation(const Schema *s, Attribute_ID attr);
@@ -10,12 +10,16 @@
 #include "rax.h"
 #include "../ops/op_value_hash_join.h"
 #include "../ops/op_cartesian_product.h"
+#include "../cardinality.h"
 #include "../../util/rax_extensions.h"
 
 
 // To be used as a possible output of _relate_exp_to_stream.
 #define NOT_RESOLVED -1
 
+// A stream is cached in place of the other once its estimate is smaller by this factor.
+#define JOIN_ESTIMATE_RATIO 2
+
 /**
  * @brief Given an expression node from a filter tree, returns the stream number
  *        that fully resolves the expression's references.
@@ -75,12 +79,22 @@ static OpBase *_build_hash_join_op(const ExecutionPlan *plan, OpBase *left_branc
 	OpBase *value_hash_join;
 
 	/* The Value Hash Join will cache its left-hand stream. To reduce the cache size,
-	 * prefer to cache the stream which will produce the smallest number of records.
-	 * Our current heuristic for this is to prefer a stream which contains a filter operation. */
-	bool left_branch_filtered = (ExecutionPlan_LocateOp(left_branch, OPType_FILTER) != NULL);
-	bool right_branch_filtered = (ExecutionPlan_LocateOp(right_branch, OPType_FILTER) != NULL);
-	if(!left_branch_filtered && right_branch_filtered) {
-		// Only the RHS stream is filtered, swap the input streams and expressions.
+	 * prefer to cache the stream estimated to produce the smallest number of records.
+	 * Estimates which are close fall back to preferring a stream containing a filter operation. */
+	bool swap;
+	double left_estimate = Cardinality_Estimate(left_branch);
+	double right_estimate = Cardinality_Estimate(right_branch);
+	if(right_estimate * JOIN_ESTIMATE_RATIO < left_estimate) {
+		swap = true;
+	} else if(left_estimate * JOIN_ESTIMATE_RATIO < right_estimate) {
+		swap = false;
+	} else {
+		bool left_branch_filtered = (ExecutionPlan_LocateOp(left_branch, OPType_FILTER) != NULL);
+		bool right_branch_filtered = (ExecutionPlan_LocateOp(right_branch, OPType_FILTER) != NULL);
+		swap = !left_branch_filtered && right_branch_filtered;
+	}
+	if(swap) {
+		// The RHS stream is expected to be smaller, swap the input streams and expressions.
 		value_hash_join = NewValueHashJoin(plan, rhs_join_exp, lhs_join_exp);
 		OpBase *t = left_branch;
 		left_branch = right_branch;
@@ -0,0 +1,365 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "columnar_aggregate.h"
+#include "../ops/ops.h"
+#include "../../util/arr.h"
+#include "../../query_ctx.h"
+#include "../../util/rmalloc.h"
+#include "../../graph/property_columns.h"
+#include <math.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Integers beyond 2^53 can't be compared exactly against double column values.
+#define COLUMNAR_MAX_EXACT_INT (1LL << 53)
+
+// Selection bitmap covering the scanned node IDs.
+typedef struct {
+	uint64_t *words;    // Bit i is set if node i is selected.
+	uint64_t word_count;
+} Selection;
+
+// Columnar evaluation context.
+typedef struct {
+	Graph *g;
+	GraphContext *gc;
+	const char *alias;  // Alias of scanned node.
+	int label;          // Scanned label, GRAPH_NO_LABEL for all nodes.
+	uint64_t len;       // Number of node IDs covered by columns.
+} ColumnarCtx;
+
+// Resolves the column of exp, expecting exp to be an attribute of the scanned node.
+static const PropertyColumn *_GetColumn(const ColumnarCtx *ctx, const AR_ExpNode *exp) {
+	if(exp->type != AR_EXP_OPERAND ||
+	   exp->operand.type != AR_EXP_VARIADIC ||
+	   exp->operand.variadic.entity_prop == NULL ||
+	   strcmp(exp->operand.variadic.entity_alias, ctx->alias)) return NULL;
+
+	Attribute_ID attr = GraphContext_GetAttributeID(ctx->gc, exp->operand.variadic.entity_prop);
+	if(attr == ATTRIBUTE_NOTFOUND) return NULL;
+
+	const PropertyColumn *c = PropertyColumns_Get(ctx->g, ctx->label, attr);
+	if(c) assert(c->len == ctx->len);
+	return c;
+}
+
+// Retrieves a numeric constant which can be compared exactly against column values.
+static bool _GetConstant(const AR_ExpNode *exp, double *v) {
+	if(exp->type != AR_EXP_OPERAND || exp->operand.type != AR_EXP_CONSTANT) return false;
+	SIValue c = exp->operand.constant;
+	if(SI_TYPE(c) == T_INT64) {
+		if(llabs(c.longval) >= COLUMNAR_MAX_EXACT_INT) return false;
+		*v = c.longval;
+		return true;
+	}
+	if(SI_TYPE(c) == T_DOUBLE && !isnan(c.doubleval)) {
+		*v = c.doubleval;
+		return true;
+	}
+	return false;
+}
+
+// Sets bits of nodes holding a value satisfying `value OP x`.
+#define SELECT_VALUES(OP)                                                       \
+	for(uint64_t w = 0; w < sel->word_count; w++) {                             \
+		uint64_t bits = 0;                                                      \
+		uint64_t base = w * PROPERTY_COLUMN_WORD_BITS;                          \
+		uint64_t n = MIN(PROPERTY_COLUMN_WORD_BITS, c->len - base);             \
+		const double *values = c->values + base;                                \
+		for(uint64_t j = 0; j < n; j++) bits |= (uint64_t)(values[j] OP x) << j;\
+		sel->words[w] = bits & c->valid[w];                                     \
+	}
+
+static void _SelectColumn(const PropertyColumn *c, AST_Operator op, double x, Selection *sel) {
+	switch(op) {
+	case OP_EQUAL:
+		SELECT_VALUES(==);
+		break;
+	case OP_NEQUAL:
+		SELECT_VALUES(!=);
+		break;
+	case OP_LT:
+		SELECT_VALUES(<);
+		break;
+	case OP_GT:
+		SELECT_VALUES(>);
+		break;
+	case OP_LE:
+		SELECT_VALUES(<=);
+		break;
+	case OP_GE:
+		SELECT_VALUES(>=);
+		break;
+	default:
+		assert(false);
+	}
+}
+
+// Mirrors comparison operator, used when the constant is the left hand-side operand.
+static AST_Operator _ReverseOp(AST_Operator op) {
+	switch(op) {
+	case OP_LT:
+		return OP_GT;
+	case OP_GT:
+		return OP_LT;
+	case OP_LE:
+		return OP_GE;
+	case OP_GE:
+		return OP_LE;
+	default:
+		return op;
+	}
+}
+
+static inline Selection *_NewSelection(const ColumnarCtx *ctx) {
+	Selection *sel = rm_malloc(sizeof(Selection));
+	sel->word_count = (ctx->len + PROPERTY_COLUMN_WORD_BITS - 1) / PROPERTY_COLUMN_WORD_BITS;
+	sel->words = rm_malloc(sel->word_count * sizeof(uint64_t));
+	return sel;
+}
+
+static void _FreeSelection(Selection *sel) {
+	if(sel == NULL) return;
+	rm_free(sel->words);
+	rm_free(sel);
+}
+
+/* Evaluates filter tree against columns, returns NULL if the tree contains
+ * a filter which can't be evaluated using columns.
+ * Nodes missing an attribute fail any comparison against it, as they do
+ * when filtering records. */
+static Selection *_EvalFilter(const ColumnarCtx *ctx, const FT_FilterNode *f) {
+	if(f->t == FT_N_PRED) {
+		double x;
+		AST_Operator op = f->pred.op;
+		if(op != OP_EQUAL && op != OP_NEQUAL && op != OP_LT &&
+		   op != OP_GT && op != OP_LE && op != OP_GE) return NULL;
+
+		const AR_ExpNode *prop = f->pred.lhs;
+		const AR_ExpNode *constant = f->pred.rhs;
+		if(!_GetConstant(constant, &x)) {
+			prop = f->pred.rhs;
+			constant = f->pred.lhs;
+			op = _ReverseOp(op);
+			if(!_GetConstant(constant, &x)) return NULL;
+		}
+
+		const PropertyColumn *c = _GetColumn(ctx, prop);
+		if(c == NULL) return NULL;
+
+		Selection *sel = _NewSelection(ctx);
+		_SelectColumn(c, op, x, sel);
+		return sel;
+	}
+
+	if(f->t != FT_N_COND || (f->cond.op != OP_AND && f->cond.op != OP_OR)) return NULL;
+
+	Selection *left = _EvalFilter(ctx, f->cond.left);
+	if(left == NULL) return NULL;
+	Selection *right = _EvalFilter(ctx, f->cond.right);
+	if(right == NULL) {
+		_FreeSelection(left);
+		return NULL;
+	}
+
+	if(f->cond.op == OP_AND) {
+		for(uint64_t w = 0; w < left->word_count; w++) left->words[w] &= right->words[w];
+	} else {
+		for(uint64_t w = 0; w < left->word_count; w++) left->words[w] |= right->words[w];
+	}
+	_FreeSelection(right);
+	return left;
+}
+
+// Returns the selected word of column, all column values if there's no selection.
+static inline uint64_t _SelectedWord(const PropertyColumn *c, const Selection *sel, uint64_t w) {
+	return (sel) ? c->valid[w] & sel->words[w] : c->valid[w];
+}
+
+/* Computes aggregation func over the selected column values,
+ * values are visited in ascending node ID order, as they are
+ * by a scan, producing results identical to the Aggregate operation. */
+static bool _Aggregate(const char *func, const PropertyColumn *c, const Selection *sel,
+					   SIValue *res) {
+	bool count = !strcasecmp(func, "count");
+	bool sum = !strcasecmp(func, "sum");
+	bool avg = !strcasecmp(func, "avg");
+	bool min = !strcasecmp(func, "min");
+	bool max = !strcasecmp(func, "max");
+	if(!(count || sum || avg || min || max)) return false;
+	// Min and max return the original value, which must be of a known type.
+	if((min || max) && !PropertyColumn_Homogeneous(c)) return false;
+
+	uint64_t n = 0;
+	double total = 0;
+	double best = 0;
+	uint64_t word_count = PropertyColumn_WordCount(c);
+	for(uint64_t w = 0; w < word_count; w++) {
+		uint64_t bits = _SelectedWord(c, sel, w);
+		if(count) {
+			n += __builtin_popcountll(bits);
+			continue;
+		}
+		while(bits) {
+			uint64_t id = w * PROPERTY_COLUMN_WORD_BITS + __builtin_ctzll(bits);
+			double v = c->values[id];
+			if(n == 0 || (min && v < best) || (max && v > best)) best = v;
+			total += v;
+			n++;
+			bits &= bits - 1;
+		}
+	}
+
+	if(count) {
+		*res = SI_LongVal(n);
+	} else if(sum) {
+		*res = SI_DoubleVal(total);
+	} else if(avg) {
+		*res = SI_DoubleVal(n > 0 ? total / n : 0);
+	} else if(n == 0) {
+		*res = SI_NullVal();
+	} else if(c->types == T_INT64) {
+		*res = SI_LongVal((int64_t)best);
+	} else {
+		*res = SI_DoubleVal(best);
+	}
+	return true;
+}
+
+// Computes the value of an aggregation expression, returns false if it can't be computed.
+static bool _ComputeAggregation(const ColumnarCtx *ctx, AR_ExpNode *exp, const Selection *sel,
+								uint64_t selected, SIValue *res) {
+	if(exp->type != AR_EXP_OP ||
+	   exp->op.type != AR_OP_AGGREGATE ||
+	   exp->op.child_count != 1 ||
+	   AR_EXP_PerformDistinct(exp)) return false;
+
+	AR_ExpNode *arg = exp->op.children[0];
+	if(arg->type != AR_EXP_OPERAND || arg->operand.type != AR_EXP_VARIADIC) return false;
+
+	// count(n), counts selected nodes.
+	if(arg->operand.variadic.entity_prop == NULL) {
+		if(strcasecmp(exp->op.func_name, "count") ||
+		   strcmp(arg->operand.variadic.entity_alias, ctx->alias)) return false;
+		*res = SI_LongVal(selected);
+		return true;
+	}
+
+	const PropertyColumn *c = _GetColumn(ctx, arg);
+	if(c == NULL) return false;
+	return _Aggregate(exp->op.func_name, c, sel, res);
+}
+
+/* Checks if execution plan is structured as follows:
+ * "Scan -> [Filter] -> Aggregate -> Results" */
+static bool _identifyPattern(OpBase *root, OpResult **opResult, OpAggregate **opAggregate,
+							 OpFilter **opFilter, OpBase **opScan) {
+	*opFilter = NULL;
+
+	OpBase *op = root;
+	if(op->type != OPType_RESULTS || op->childCount != 1) return false;
+	*opResult = (OpResult *)op;
+
+	op = op->children[0];
+	if(op->type != OPType_AGGREGATE || op->childCount != 1) return false;
+	*opAggregate = (OpAggregate *)op;
+	if((*opAggregate)->key_count != 0) return false;
+
+	op = op->children[0];
+	if(op->type == OPType_FILTER) {
+		if(op->childCount != 1) return false;
+		*opFilter = (OpFilter *)op;
+		op = op->children[0];
+	}
+
+	if(op->childCount != 0) return false;
+	if(op->type == OPType_NODE_BY_LABEL_SCAN) {
+		// Additional labels are verified by a filter.
+		if(QGNode_LabelCount(((NodeByLabelScan *)op)->n) > 1) return false;
+	} else if(op->type != OPType_ALL_NODE_SCAN) {
+		return false;
+	}
+	*opScan = op;
+
+	return true;
+}
+
+void columnarAggregate(ExecutionPlan *plan) {
+	OpBase *opScan;
+	OpFilter *opFilter;
+	OpResult *opResult;
+	OpAggregate *opAggregate;
+	if(!_identifyPattern(plan->root, &opResult, &opAggregate, &opFilter, &opScan)) return;
+
+	ColumnarCtx ctx;
+	ctx.gc = QueryCtx_GetGraphCtx();
+	ctx.g = ctx.gc->g;
+	ctx.len = Graph_RequiredMatrixDim(ctx.g);
+
+	uint64_t selected;
+	if(opScan->type == OPType_NODE_BY_LABEL_SCAN) {
+		const QGNode *n = ((NodeByLabelScan *)opScan)->n;
+		Schema *s = GraphContext_GetSchema(ctx.gc, n->label, SCHEMA_NODE);
+		if(s == NULL) return;
+		ctx.alias = n->alias;
+		ctx.label = s->id;
+		selected = Graph_LabeledNodeCount(ctx.g, ctx.label);
+	} else {
+		ctx.alias = ((AllNodeScan *)opScan)->n->alias;
+		ctx.label = GRAPH_NO_LABEL;
+		selected = Graph_NodeCount(ctx.g);
+	}
+
+	Selection *sel = NULL;
+	if(opFilter) {
+		sel = _EvalFilter(&ctx, opFilter->filterTree);
+		if(sel == NULL) return;
+		selected = 0;
+		for(uint64_t w = 0; w < sel->word_count; w++) selected += __builtin_popcountll(sel->words[w]);
+	}
+
+	// Aggregate doesn't produce a record when no records are aggregated.
+	uint aggregate_count = opAggregate->aggregate_count;
+	SIValue values[aggregate_count];
+	bool computed = (selected > 0);
+	for(uint i = 0; i < aggregate_count && computed; i++) {
+		computed = _ComputeAggregation(&ctx, opAggregate->aggregate_exps[i], sel, selected,
+									   &values[i]);
+	}
+	_FreeSelection(sel);
+	if(!computed) return;
+
+	/* The aggregations are folded into the plan, which makes
+	 * the plan valid for the current graph state only. */
+	QueryCtx_SetPlanUnreusable();
+
+	// Construct constant expressions, used by a new projection operation.
+	AR_ExpNode **exps = array_new(AR_ExpNode *, aggregate_count);
+	for(uint i = 0; i < aggregate_count; i++) {
+		AR_ExpNode *exp = AR_EXP_NewConstOperandNode(values[i]);
+		// The new expression must be aliased to populate the Record.
+		exp->resolved_name = opAggregate->aggregate_exps[i]->resolved_name;
+		exps = array_append(exps, exp);
+	}
+
+	OpBase *opProject = NewProjectOp(opAggregate->op.plan, exps);
+
+	// New execution plan: "Project -> Results"
+	ExecutionPlan_RemoveOp(plan, opScan);
+	OpBase_Free(opScan);
+
+	if(opFilter) {
+		ExecutionPlan_RemoveOp(plan, (OpBase *)opFilter);
+		OpBase_Free((OpBase *)opFilter);
+	}
+
+	ExecutionPlan_RemoveOp(plan, (OpBase *)opAggregate);
+	OpBase_Free((OpBase *)opAggregate);
+
+	ExecutionPlan_AddOp((OpBase *)opResult, opProject);
+}
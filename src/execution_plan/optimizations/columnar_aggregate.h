@@ -0,0 +1,18 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../execution_plan.h"
+
+/* The columnarAggregate optimization will look for execution plans
+ * aggregating node attributes over a full or label scan, optionally filtered
+ * by numeric comparisons, e.g.
+ * MATCH (p:Person) WHERE p.age > 30 RETURN avg(p.age), max(p.height)
+ * In which case the filter and aggregations are evaluated against the graph's
+ * columnar property store, replacing SCAN, FILTER and AGGREGATE
+ * with a projection of the computed values. */
+void columnarAggregate(ExecutionPlan *plan);
@@ -0,0 +1,112 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cover_index_scans.h"
+#include "../ops/ops.h"
+#include "../../util/arr.h"
+#include "../../query_ctx.h"
+#include "../../arithmetic/agg_ctx.h"
+#include <string.h>
+#include <strings.h>
+
+/* Aggregations which consume their arguments right away, others retain values,
+ * which for strings read from the index are only valid until the scan advances. */
+static bool _ConsumingAggregation(const AR_ExpNode *exp) {
+	const char *func = exp->op.func_name;
+	return (!exp->op.agg_func->isDistinct &&
+			(!strcasecmp(func, "count") || !strcasecmp(func, "sum") || !strcasecmp(func, "avg")));
+}
+
+/* Returns true if every reference exp makes to alias is to attribute,
+ * or for counting aggregations to the node itself, which the attribute's value
+ * substitutes as every indexed node holds a value.
+ * A NULL attribute disallows any reference to alias. */
+static bool _Covered(const AR_ExpNode *exp, const char *alias, const char *attribute,
+					 bool counted) {
+	if(exp->type == AR_EXP_OPERAND) {
+		if(exp->operand.type != AR_EXP_VARIADIC ||
+		   strcmp(exp->operand.variadic.entity_alias, alias)) return true;
+		if(exp->operand.variadic.entity_prop == NULL) return counted;
+		return (attribute && !strcmp(exp->operand.variadic.entity_prop, attribute));
+	}
+
+	counted = false;
+	if(exp->op.type == AR_OP_AGGREGATE) {
+		if(!_ConsumingAggregation(exp)) attribute = NULL;
+		else counted = !strcasecmp(exp->op.func_name, "count");
+	}
+
+	for(int i = 0; i < exp->op.child_count; i++) {
+		if(!_Covered(exp->op.children[i], alias, attribute, counted)) return false;
+	}
+	return true;
+}
+
+// Redirect exp's references to alias to the covered value.
+static void _Cover(AR_ExpNode *exp, const char *alias, const char *covered_alias) {
+	if(exp->type == AR_EXP_OPERAND) {
+		if(exp->operand.type != AR_EXP_VARIADIC ||
+		   strcmp(exp->operand.variadic.entity_alias, alias)) return;
+		exp->operand.variadic.entity_alias = covered_alias;
+		exp->operand.variadic.entity_prop = NULL;
+		exp->operand.variadic.entity_alias_idx = IDENTIFIER_NOT_FOUND;
+		exp->operand.variadic.entity_prop_idx = ATTRIBUTE_NOTFOUND;
+		return;
+	}
+
+	for(int i = 0; i < exp->op.child_count; i++) _Cover(exp->op.children[i], alias, covered_alias);
+}
+
+static bool _CoveredExps(AR_ExpNode **exps, uint count, const char *alias, const char *attribute) {
+	for(uint i = 0; i < count; i++) {
+		if(!_Covered(exps[i], alias, attribute, false)) return false;
+	}
+	return true;
+}
+
+static void _CoverExps(AR_ExpNode **exps, uint count, const char *alias, const char *covered_alias) {
+	for(uint i = 0; i < count; i++) _Cover(exps[i], alias, covered_alias);
+}
+
+static void _coverIndexScan(IndexScan *scan) {
+	OpBase *parent = scan->op.parent;
+	if(scan->range_iter == NULL || scan->op.childCount != 0 || parent == NULL ||
+	   parent->plan != scan->op.plan) return;
+
+	Attribute_ID attr = OrderedIndexIter_Attribute(scan->range_iter);
+	if(attr == ATTRIBUTE_NOTFOUND) return;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	const char *attribute = GraphContext_GetAttributeString(gc, attr);
+	const char *alias = scan->n->alias;
+
+	if(parent->type == OPType_PROJECT) {
+		OpProject *project = (OpProject *)parent;
+		if(!_CoveredExps(project->exps, project->exp_count, alias, attribute)) return;
+		const char *covered_alias = IndexScanOp_Cover(scan);
+		_CoverExps(project->exps, project->exp_count, alias, covered_alias);
+	} else if(parent->type == OPType_AGGREGATE) {
+		OpAggregate *aggregate = (OpAggregate *)parent;
+		// Cached records would refer to values read from the index.
+		if(aggregate->should_cache_records) return;
+		if(!_CoveredExps(aggregate->key_exps, aggregate->key_count, alias, attribute) ||
+		   !_CoveredExps(aggregate->aggregate_exps, aggregate->aggregate_count, alias,
+						 attribute)) return;
+		const char *covered_alias = IndexScanOp_Cover(scan);
+		_CoverExps(aggregate->key_exps, aggregate->key_count, alias, covered_alias);
+		_CoverExps(aggregate->aggregate_exps, aggregate->aggregate_count, alias, covered_alias);
+	}
+}
+
+void coverIndexScans(ExecutionPlan *plan) {
+	OpBase **scans = ExecutionPlan_CollectOps(plan->root, OPType_INDEX_SCAN);
+
+	for(uint i = 0; i < array_len(scans); i++) {
+		_coverIndexScan((IndexScan *)scans[i]);
+	}
+
+	array_free(scans);
+}
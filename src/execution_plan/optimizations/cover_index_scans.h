@@ -0,0 +1,18 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../execution_plan.h"
+
+/* The coverIndexScans optimization will look for execution plans
+ * projecting or aggregating solely the indexed attribute of nodes
+ * found by an index range scan, e.g.
+ * MATCH (p:Person) WHERE p.email > 'm' RETURN p.email
+ * MATCH (p:Person) WHERE p.age > 30 RETURN count(p)
+ * In which case the attribute values are read from the index entries,
+ * such that nodes and their properties aren't accessed. */
+void coverIndexScans(ExecutionPlan *plan);
@@ -0,0 +1,55 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "distinct_traversals.h"
+#include "../../util/arr.h"
+#include "../ops/op_cond_var_len_traverse.h"
+
+/* Returns true if the records produced by op are deduplicated
+ * before any operation is sensitive to their multiplicity. */
+static bool _DuplicatesDiscarded(const OpBase *op) {
+	for(const OpBase *parent = op->parent; parent; parent = parent->parent) {
+		switch(parent->type) {
+		case OPType_DISTINCT:
+			return true;
+		// Operations which map each record independently of the others.
+		case OPType_FILTER:
+		case OPType_PROJECT:
+		case OPType_EXPAND_INTO:
+		case OPType_EXPAND_INTERSECT:
+		case OPType_CONDITIONAL_TRAVERSE:
+		case OPType_CONDITIONAL_VAR_LEN_TRAVERSE:
+		case OPType_CONDITIONAL_VAR_LEN_TRAVERSE_EXPAND_INTO:
+			continue;
+		default:
+			return false;
+		}
+	}
+	return false;
+}
+
+void distinctTraversals(ExecutionPlan *plan) {
+	const OPType types[] = {OPType_CONDITIONAL_VAR_LEN_TRAVERSE,
+							OPType_CONDITIONAL_VAR_LEN_TRAVERSE_EXPAND_INTO
+						   };
+	OpBase **traversals = ExecutionPlan_CollectOpsMatchingType(plan->root, types, 2);
+	uint traversals_count = array_len(traversals);
+
+	for(uint i = 0; i < traversals_count; i++) {
+		CondVarLenTraverse *traverse = (CondVarLenTraverse *)traversals[i];
+		// Paths must not be projected, frontiers don't apply inlined edge properties.
+		if(traverse->edgesIdx != -1 || traverse->paths != QG_EDGE_PATHS_ALL) continue;
+		if(traverse->filterAttrs) continue;
+		/* A node first discovered at distance d is reachable by a path of length d,
+		 * but may also be reachable by longer paths, only minimal lengths of 0 or 1
+		 * are guaranteed to be satisfied. */
+		if(traverse->minHops > 1) continue;
+		if(!_DuplicatesDiscarded((OpBase *)traverse)) continue;
+		CondVarLenTraverseOp_DistinctDestinations(traverse);
+	}
+
+	array_free(traversals);
+}
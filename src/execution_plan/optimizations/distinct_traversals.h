@@ -0,0 +1,17 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../execution_plan.h"
+
+/* Distinct traversals looks for variable length traversals whose paths
+ * aren't referenced and whose records are deduplicated by a later distinct
+ * operation, e.g.
+ * MATCH (a)-[*1..4]->(b) RETURN DISTINCT b
+ * As only reachability matters, such traversals produce each destination
+ * once, discovered by expanding frontiers rather than by building every path. */
+void distinctTraversals(ExecutionPlan *plan);
@@ -0,0 +1,56 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "intersect_traversals.h"
+#include "../../util/arr.h"
+#include "../../util/strcmp.h"
+#include "../ops/op_expand_into.h"
+#include "../ops/op_expand_intersect.h"
+#include "../ops/op_conditional_traverse.h"
+
+// Returns true if expand_into verifies the node resolved by traverse against another resolved node.
+static bool _ClosesCycle(const OpExpandInto *expand_into, const CondTraverse *traverse) {
+	AlgebraicExpression *traversal = traverse->ae;
+	AlgebraicExpression *closing = expand_into->ae;
+	if(!ExpandIntersect_IntersectableExpression(traversal) ||
+	   !ExpandIntersect_IntersectableExpression(closing)) return false;
+
+	const char *dest = AlgebraicExpression_Destination(traversal);
+	const char *src = AlgebraicExpression_Source(closing);
+	const char *other = AlgebraicExpression_Destination(closing);
+	if(!RG_STRCMP(other, dest)) other = src;
+	else if(RG_STRCMP(src, dest)) return false;
+
+	// The closing expression must lead to the resolved node from a different one.
+	return RG_STRCMP(other, dest) != 0;
+}
+
+void intersectTraversals(ExecutionPlan *plan) {
+	OpBase **expand_intos = ExecutionPlan_CollectOps(plan->root, OPType_EXPAND_INTO);
+	uint expand_into_count = array_len(expand_intos);
+
+	for(uint i = 0; i < expand_into_count; i++) {
+		OpExpandInto *expand_into = (OpExpandInto *)expand_intos[i];
+		OpBase *child = expand_into->op.children[0];
+		if(expand_into->op.childCount != 1 || child->type != OPType_CONDITIONAL_TRAVERSE) continue;
+
+		CondTraverse *traverse = (CondTraverse *)child;
+		if(!_ClosesCycle(expand_into, traverse)) continue;
+
+		OpBase *intersect = NewExpandIntersectOp(expand_into->op.plan, expand_into->graph,
+												 traverse->ae, expand_into->ae);
+
+		// Set algebraic expressions to NULL to avoid early free.
+		traverse->ae = NULL;
+		expand_into->ae = NULL;
+		ExecutionPlan_RemoveOp(plan, (OpBase *)traverse);
+		ExecutionPlan_ReplaceOp(plan, (OpBase *)expand_into, intersect);
+		OpBase_Free((OpBase *)traverse);
+		OpBase_Free((OpBase *)expand_into);
+	}
+
+	array_free(expand_intos);
+}
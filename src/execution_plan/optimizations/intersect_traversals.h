@@ -0,0 +1,17 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../execution_plan.h"
+
+/* Intersect traversals looks for a traversal resolving a node which is
+ * immediately verified to be connected to a previously resolved node by an
+ * expand into operation, closing a cycle, e.g.
+ * MATCH (a)-[:F]->(b)-[:F]->(c)-[:F]->(a)
+ * Both operations are replaced by a single expand intersect operation,
+ * drawing the closing node from the intersection of both bound nodes' adjacency rows. */
+void intersectTraversals(ExecutionPlan *plan);
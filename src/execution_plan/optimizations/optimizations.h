@@ -9,6 +9,7 @@
 
 #include "./apply_join.h"
 #include "./seek_by_id.h"
+#include "./sort_by_index.h"
 #include "./reduce_count.h"
 #include "./reduce_scans.h"
 #include "./reduce_filters.h"
@@ -17,6 +18,12 @@
 #include "./utilize_indices.h"
 #include "./reduce_distinct.h"
 #include "./reduce_traversal.h"
+#include "./intersect_traversals.h"
+#include "./distinct_traversals.h"
+#include "./columnar_aggregate.h"
+#include "./cover_index_scans.h"
+#include "./share_expressions.h"
+#include "./pushdown_proc_limit.h"
 #include "./optimize_cartesian_product.h"
 
 #endif
@@ -7,9 +7,14 @@
 #include "optimize_cartesian_product.h"
 #include "../ops/op_filter.h"
 #include "../ops/op_cartesian_product.h"
+#include "../cardinality.h"
 #include "../../util/rax_extensions.h"
+#include "../../util/rmalloc.h"
 #include "../../util/qsort.h"
 
+// Maximal number of streams whose join order is planned exhaustively.
+#define JOIN_ORDER_MAX_STREAMS 10
+
 #define FilterCtx_LT(a ,b) ((raxSize((a)->entities)) < (raxSize((b)->entities)))
 
 // This struct is an auxilary struct for sorting filters according to their referenced entities count.
@@ -130,13 +135,210 @@ static void _optimize_cartesian_product(ExecutionPlan *plan, OpBase *cp) {
 	array_free(filter_ctx_arr);
 }
 
+// A filter located upstream from a Cartesian Product, described by the streams it references.
+typedef struct {
+	OpFilter *filter;   // Filter operation.
+	uint mask;          // Streams referenced by the filter.
+	uint lhs_mask;      // Streams referenced by the left side of an equality predicate.
+	uint rhs_mask;      // Streams referenced by the right side of an equality predicate.
+	uint node;          // Set of streams above whose join the filter is placed.
+	double selectivity; // Estimated fraction of records passing the filter.
+} JoinFilter;
+
+/* Returns the set of streams binding the entities, or full if an entity isn't bound
+ * by any of the streams, in which case the filter can't be moved. */
+static uint _streams_mask(rax *entities, rax **stream_entities, uint stream_count, uint full) {
+	uint mask = 0;
+	raxIterator it;
+	raxStart(&it, entities);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		uint i = 0;
+		for(; i < stream_count; i++) {
+			if(raxFind(stream_entities[i], it.key, it.key_len) != raxNotFound) break;
+		}
+		if(i == stream_count) {
+			mask = full;
+			break;
+		}
+		mask |= 1 << i;
+	}
+	raxStop(&it);
+	return mask;
+}
+
+static uint _exp_mask(AR_ExpNode *exp, rax **stream_entities, uint stream_count, uint full) {
+	rax *entities = raxNew();
+	AR_EXP_CollectEntities(exp, entities);
+	uint mask = _streams_mask(entities, stream_entities, stream_count, full);
+	raxFree(entities);
+	return mask;
+}
+
+// Returns true if a filter references streams of both a and b, and no others.
+static bool _connected(const JoinFilter *filters, uint filter_count, uint a, uint b) {
+	for(uint i = 0; i < filter_count; i++) {
+		uint mask = filters[i].mask;
+		if((mask & ~(a | b)) == 0 && (mask & a) && (mask & b)) return true;
+	}
+	return false;
+}
+
+// Returns true if a, b are joined by an equality predicate both sides of which they each resolve.
+static bool _equi_joined(const JoinFilter *filters, uint filter_count, uint a, uint b) {
+	for(uint i = 0; i < filter_count; i++) {
+		uint lhs = filters[i].lhs_mask;
+		uint rhs = filters[i].rhs_mask;
+		if(lhs == 0 || rhs == 0) continue;
+		if(((lhs & ~a) == 0 && (rhs & ~b) == 0) || ((lhs & ~b) == 0 && (rhs & ~a) == 0)) return true;
+	}
+	return false;
+}
+
+/* Builds the join of the streams in set, placing every filter assigned to set above it,
+ * returns the root of the join. */
+static OpBase *_build_join(OpBase *cp, OpBase **streams, uint *split, JoinFilter *filters,
+						   uint filter_count, uint set) {
+	OpBase *root;
+	if((set & (set - 1)) == 0) {
+		root = streams[__builtin_ctz(set)];
+	} else {
+		root = NewCartesianProductOp(cp->plan);
+		ExecutionPlan_AddOp(root, _build_join(cp, streams, split, filters, filter_count, split[set]));
+		ExecutionPlan_AddOp(root, _build_join(cp, streams, split, filters, filter_count,
+											  set & ~split[set]));
+	}
+
+	for(uint i = 0; i < filter_count; i++) {
+		if(filters[i].node != set) continue;
+		OpBase *filter = (OpBase *)filters[i].filter;
+		ExecutionPlan_AddOp(filter, root);
+		root = filter;
+	}
+	return root;
+}
+
+/* Plans the order in which the streams of a Cartesian Product are joined.
+ * Every way of joining subsets of streams is considered, bottom up, each set of streams
+ * keeping its cheapest join. Joins of streams no filter connects are avoided where possible,
+ * among the rest a join costs the records it produces, and in addition the records it computes:
+ * both inputs when an equality predicate allows for a hash join, their product otherwise.
+ * Filters are placed above the smallest join resolving them.
+ * Returns false if the Cartesian Product has too many streams to be planned. */
+static bool _plan_join_order(ExecutionPlan *plan, OpBase *cp) {
+	uint stream_count = cp->childCount;
+	if(stream_count > JOIN_ORDER_MAX_STREAMS) return false;
+	uint full = (1 << stream_count) - 1;
+
+	rax *stream_entities[stream_count];
+	double stream_estimates[stream_count];
+	OpBase *streams[stream_count];
+	for(uint i = 0; i < stream_count; i++) {
+		streams[i] = cp->children[i];
+		stream_entities[i] = raxNew();
+		ExecutionPlan_BoundVariables(streams[i], stream_entities[i]);
+		stream_estimates[i] = Cardinality_Estimate(streams[i]);
+	}
+
+	// Describe the filters located upstream from the Cartesian Product.
+	JoinFilter *filters = array_new(JoinFilter, 0);
+	OpBase *parent = cp->parent;
+	while(parent && parent->type == OPType_FILTER) {
+		OpFilter *filter_op = (OpFilter *)parent;
+		const FT_FilterNode *tree = filter_op->filterTree;
+		JoinFilter f = {.filter = filter_op, .lhs_mask = 0, .rhs_mask = 0, .node = full};
+		rax *entities = FilterTree_CollectModified(tree);
+		f.mask = _streams_mask(entities, stream_entities, stream_count, full);
+		raxFree(entities);
+		if(f.mask == 0) f.mask = full;
+		if(tree->t == FT_N_PRED && tree->pred.op == OP_EQUAL) {
+			f.lhs_mask = _exp_mask(tree->pred.lhs, stream_entities, stream_count, full);
+			f.rhs_mask = _exp_mask(tree->pred.rhs, stream_entities, stream_count, full);
+		}
+		f.selectivity = FilterTree_Selectivity(tree, plan->query_graph);
+		filters = array_append(filters, f);
+		parent = parent->parent;
+	}
+	uint filter_count = array_len(filters);
+
+	/* Estimated records and cost of joining each set of streams, with its cheapest split
+	 * and the number of unconnected joins it performs. */
+	double *records = rm_malloc(sizeof(double) * (full + 1));
+	double *cost = rm_malloc(sizeof(double) * (full + 1));
+	uint *cross = rm_malloc(sizeof(uint) * (full + 1));
+	uint *split = rm_calloc(full + 1, sizeof(uint));
+	for(uint set = 1; set <= full; set++) {
+		records[set] = 1;
+		for(uint i = 0; i < stream_count; i++) {
+			if(set & (1 << i)) records[set] *= stream_estimates[i];
+		}
+		for(uint i = 0; i < filter_count; i++) {
+			if((filters[i].mask & ~set) == 0) records[set] *= filters[i].selectivity;
+		}
+
+		cost[set] = 0;
+		cross[set] = 0;
+		if((set & (set - 1)) == 0) continue;
+
+		// Splits are enumerated once, the part holding the lowest stream first.
+		uint lowest = set & -set;
+		bool found = false;
+		for(uint a = (set - 1) & set; a > 0; a = (a - 1) & set) {
+			if(!(a & lowest)) continue;
+			uint b = set & ~a;
+			uint x = cross[a] + cross[b] + !_connected(filters, filter_count, a, b);
+			double work = _equi_joined(filters, filter_count, a, b) ?
+						  records[a] + records[b] : records[a] * records[b];
+			double c = cost[a] + cost[b] + work + records[set];
+			if(!found || x < cross[set] || (x == cross[set] && c < cost[set])) {
+				found = true;
+				cross[set] = x;
+				cost[set] = c;
+				split[set] = a;
+			}
+		}
+	}
+
+	// Assign each filter to the smallest join containing the streams it references.
+	for(uint i = 0; i < filter_count; i++) {
+		uint node = full;
+		uint mask = filters[i].mask;
+		while(node & (node - 1)) {
+			uint a = split[node];
+			uint b = node & ~a;
+			if((mask & ~a) == 0) node = a;
+			else if((mask & ~b) == 0) node = b;
+			else break;
+		}
+		filters[i].node = node;
+	}
+
+	/* Rebuild the Cartesian Product's streams, filters resolved by the entire product remain in place.
+	 * Filters were collected bottom up, the ones closest to the product are placed first. */
+	for(uint i = 0; i < filter_count; i++) {
+		if(filters[i].node != full) ExecutionPlan_RemoveOp(plan, (OpBase *)filters[i].filter);
+	}
+	for(uint i = 0; i < stream_count; i++) ExecutionPlan_DetachOp(streams[i]);
+	ExecutionPlan_AddOp(cp, _build_join(cp, streams, split, filters, filter_count, split[full]));
+	ExecutionPlan_AddOp(cp, _build_join(cp, streams, split, filters, filter_count,
+										full & ~split[full]));
+
+	for(uint i = 0; i < stream_count; i++) raxFree(stream_entities[i]);
+	rm_free(records);
+	rm_free(cost);
+	rm_free(cross);
+	rm_free(split);
+	array_free(filters);
+	return true;
+}
+
 void reduceCartesianProductStreamCount(ExecutionPlan *plan) {
 	OpBase **cps = ExecutionPlan_CollectOps(plan->root, OPType_CARTESIAN_PRODUCT);
 	uint cp_count = array_len(cps);
 
 	for(uint i = 0; i < cp_count ; i++) {
 		OpBase *cp = cps[i];
-		if(cp->childCount > 2) _optimize_cartesian_product(plan, cp);
+		if(cp->childCount > 2 && !_plan_join_order(plan, cp)) _optimize_cartesian_product(plan, cp);
 	}
 	array_free(cps);
 }
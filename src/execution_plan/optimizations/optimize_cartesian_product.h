@@ -24,5 +24,8 @@
  * the original cartesian product and place the filter operation is a new branch.
  * Creating nested cartesian products operations and re-positioning the filter op will:
  * 1. Potentially reduce memory consumption (storing only f records instead n^x) in each phase.
- * 2. Reduce the overall filter runtime by potentially order(s) of magnitude. */
+ * 2. Reduce the overall filter runtime by potentially order(s) of magnitude.
+ * The order in which streams are combined is planned by estimated cost, such that filters,
+ * and equality predicates later turned into hash joins, reduce the intermediate results early.
+ * Cartesian Products with too many streams to plan exhaustively are split greedily. */
 void reduceCartesianProductStreamCount(ExecutionPlan *plan);
@@ -7,8 +7,32 @@
 #include "./optimizer.h"
 #include "./optimizations.h"
 #include "../../query_ctx.h"
+#include "../../util/rmalloc.h"
+#include <string.h>
+
+typedef void (*OptimizerRuleFunc)(ExecutionPlan *plan);
+
+/* Apply rule if it is enabled, marking it as applied
+ * if tracked and the shape of the plan changed. */
+static void _applyRule(ExecutionPlan *plan, OptimizerRuleFunc func, OptimizerRule rule, uint rules,
+					   bool track, uint *applied) {
+	if(!(rules & rule)) return;
+	if(!track) {
+		func(plan);
+		return;
+	}
+
+	char *before = ExecutionPlan_Shape(plan);
+	func(plan);
+	char *after = ExecutionPlan_Shape(plan);
+	if(strcmp(before, after) != 0) *applied |= rule;
+	rm_free(before);
+	rm_free(after);
+}
+
+uint _optimizePlan(ExecutionPlan *plan, uint rules, bool track) {
+	uint applied = 0;
 
-void _optimizePlan(ExecutionPlan *plan) {
 	// Tries to compact filter trees, and remove redundant filters.
 	compactFilters(plan);
 
@@ -20,39 +44,73 @@ void _optimizePlan(ExecutionPlan *plan) {
 
 	/* When possible, replace label scan and filter ops
 	 * with index scans. */
-	utilizeIndices(plan);
+	_applyRule(plan, utilizeIndices, OPT_UTILIZE_INDICES, rules, track, &applied);
 
 	// Try to reduce SCAN + FILTER to a node seek operation.
-	seekByID(plan);
+	_applyRule(plan, seekByID, OPT_SEEK_BY_ID, rules, track, &applied);
 
 	/* Remove redundant SCAN operations. */
-	reduceScans(plan);
+	_applyRule(plan, reduceScans, OPT_REDUCE_SCANS, rules, track, &applied);
+
+	/* When possible, replace label scan and sort ops
+	 * with an index order scan. */
+	_applyRule(plan, sortByIndex, OPT_SORT_BY_INDEX, rules, track, &applied);
 
 	/* Try to optimize cartesian product */
-	reduceCartesianProductStreamCount(plan);
+	_applyRule(plan, reduceCartesianProductStreamCount, OPT_REDUCE_CARTESIAN_PRODUCT, rules, track, &applied);
 
 	/* Try to match disjoint entities by applying a join */
-	applyJoin(plan);
+	_applyRule(plan, applyJoin, OPT_APPLY_JOIN, rules, track, &applied);
 
 	/* Try to reduce a number of filters into a single filter op. */
-	reduceFilters(plan);
+	_applyRule(plan, reduceFilters, OPT_REDUCE_FILTERS, rules, track, &applied);
 
 	/* reduce traversals where both src and dest nodes are already resolved
 	 * into an expand into operation. */
-	reduceTraversal(plan);
+	_applyRule(plan, reduceTraversal, OPT_REDUCE_TRAVERSAL, rules, track, &applied);
+
+	/* Resolve nodes closing a cycle by intersecting
+	 * the adjacency rows of their resolved neighbors. */
+	_applyRule(plan, intersectTraversals, OPT_INTERSECT_TRAVERSALS, rules, track, &applied);
 
 	/* Try to reduce distinct if it follows aggregation. */
-	reduceDistinct(plan);
+	_applyRule(plan, reduceDistinct, OPT_REDUCE_DISTINCT, rules, track, &applied);
+
+	/* Produce distinct destinations of variable length traversals
+	 * when only reachability matters. */
+	_applyRule(plan, distinctTraversals, OPT_DISTINCT_TRAVERSALS, rules, track, &applied);
 
 	/* Try to reduce execution plan incase it perform node or edge counting. */
-	reduceCount(plan);
+	_applyRule(plan, reduceCount, OPT_REDUCE_COUNT, rules, track, &applied);
+
+	/* Try to evaluate aggregations over a scan using the columnar property store. */
+	_applyRule(plan, columnarAggregate, OPT_COLUMNAR_AGGREGATE, rules, track, &applied);
+
+	/* Try to read projected attributes from the index rather than from nodes. */
+	_applyRule(plan, coverIndexScans, OPT_COVER_INDEX_SCANS, rules, track, &applied);
+
+	/* Bound the records produced by procedure calls feeding a limit. */
+	_applyRule(plan, pushdownProcLimit, OPT_PUSHDOWN_PROC_LIMIT, rules, track, &applied);
+
+	/* Compute function calls shared by a filter and its projection once. */
+	shareExpressions(plan);
+
+	return applied;
 }
 
 void optimizePlan(ExecutionPlan *plan) {
+	optimizePlanWithRules(plan, OPT_ALL_RULES, false);
+}
+
+uint optimizePlanWithRules(ExecutionPlan *plan, uint rules, bool track) {
+	uint applied = 0;
 	/* Handle UNION of execution plans. */
 	if(plan->is_union) {
-		for(uint i = 0; i < plan->segment_count; i++) _optimizePlan(plan->segments[i]);
+		for(uint i = 0; i < plan->segment_count; i++) {
+			applied |= _optimizePlan(plan->segments[i], rules, track);
+		}
 	} else {
-		_optimizePlan(plan);
+		applied = _optimizePlan(plan, rules, track);
 	}
+	return applied;
 }
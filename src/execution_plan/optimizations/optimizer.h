@@ -8,6 +8,35 @@
 
 #include "../execution_plan.h"
 
+/* Optimizations restricted by pinned plans, each identified by a bit.
+ * Bits are persisted and must not be renumbered, new optimizations take new bits,
+ * such that optimizations introduced after a plan was pinned are not applied to it.
+ * Filter compaction and expression sharing only rewrite the expressions
+ * evaluated by operations, they are always applied. */
+typedef enum {
+	OPT_UTILIZE_INDICES = 1 << 0,
+	OPT_SEEK_BY_ID = 1 << 1,
+	OPT_REDUCE_SCANS = 1 << 2,
+	OPT_SORT_BY_INDEX = 1 << 3,
+	OPT_REDUCE_CARTESIAN_PRODUCT = 1 << 4,
+	OPT_APPLY_JOIN = 1 << 5,
+	OPT_REDUCE_FILTERS = 1 << 6,
+	OPT_REDUCE_TRAVERSAL = 1 << 7,
+	OPT_INTERSECT_TRAVERSALS = 1 << 8,
+	OPT_REDUCE_DISTINCT = 1 << 9,
+	OPT_DISTINCT_TRAVERSALS = 1 << 10,
+	OPT_REDUCE_COUNT = 1 << 11,
+	OPT_COLUMNAR_AGGREGATE = 1 << 12,
+	OPT_COVER_INDEX_SCANS = 1 << 13,
+	OPT_PUSHDOWN_PROC_LIMIT = 1 << 14,
+} OptimizerRule;
+
+#define OPT_ALL_RULES ((1 << 15) - 1)
+
 /* Try to optimize an execution plan segment. */
 void optimizePlan(ExecutionPlan *plan);
 
+/* Optimize an execution plan applying only the given rules.
+ * If track is set, returns the rules which modified the plan's shape, otherwise 0. */
+uint optimizePlanWithRules(ExecutionPlan *plan, uint rules, bool track);
+
@@ -0,0 +1,37 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "pushdown_proc_limit.h"
+#include "../ops/ops.h"
+#include "../../util/arr.h"
+
+static void _pushdownProcLimit(OpLimit *limit) {
+	uint64_t bound = limit->limit;
+	OpBase *op = limit->op.children[0];
+
+	// Projections and skips map records one to one (skips discard a prefix).
+	while(op->childCount == 1) {
+		if(op->type == OPType_SKIP) bound += ((OpSkip *)op)->rec_to_skip;
+		else if(op->type != OPType_PROJECT) break;
+		op = op->children[0];
+	}
+
+	if(op->type != OPType_PROC_CALL) return;
+	OpProcCall *call = (OpProcCall *)op;
+	// Procedures modifying the graph must run to completion.
+	if(!call->procedure->readOnly) return;
+	if(call->limit == 0 || bound < call->limit) ProcCallOp_SetLimit(call, bound);
+}
+
+void pushdownProcLimit(ExecutionPlan *plan) {
+	OpBase **limit_ops = ExecutionPlan_CollectOps(plan->root, OPType_LIMIT);
+
+	for(uint i = 0; i < array_len(limit_ops); i++) {
+		_pushdownProcLimit((OpLimit *)limit_ops[i]);
+	}
+
+	array_free(limit_ops);
+}
@@ -0,0 +1,15 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../execution_plan.h"
+
+/* A read-only procedure call feeding a limit through projections only
+ * need not produce more records than the limit (and any skip) consumes,
+ * this optimization hands the bound to the procedure such that
+ * procedures computing their output lazily stop early. */
+void pushdownProcLimit(ExecutionPlan *plan);
@@ -8,6 +8,7 @@
 #include "../ops/ops.h"
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
+#include "../../graph/entities/multi_edge.h"
 
 static GrB_UnaryOp countMultipleEdges = NULL;
 
@@ -101,6 +102,10 @@ bool _reduceNodeCount(ExecutionPlan *plan) {
 		nodeCount = SI_LongVal(Graph_NodeCount(gc->g));
 	}
 
+	/* The count is folded into the plan, which makes
+	 * the plan valid for the current graph state only. */
+	QueryCtx_SetPlanUnreusable();
+
 	/* Construct a constant expression, used by a new
 	 * projection operation. */
 	AR_ExpNode *exp = AR_EXP_NewConstOperandNode(nodeCount);
@@ -122,10 +127,17 @@ bool _reduceNodeCount(ExecutionPlan *plan) {
 	return true;
 }
 
-/* Checks if execution plan solely performs edge count */
+// Returns true if n is unlabeled or carries a single label.
+static inline bool _singlyLabeled(const QGNode *n) {
+	return n->labels == NULL || array_len(n->labels) <= 1;
+}
+
+/* Checks if execution plan solely performs edge count,
+ * sets e to the counted edge, connecting two distinct nodes with at most a label each. */
 static int _identifyEdgeCountPattern(OpBase *root, OpResult **opResult, OpAggregate **opAggregate,
-									 OpBase **opTraverse, OpBase **opScan) {
+									 OpBase **opTraverse, OpBase **opScan, const QGEdge **e) {
 	// Reset.
+	*e = NULL;
 	*opScan = NULL;
 	*opTraverse = NULL;
 	*opResult = NULL;
@@ -138,11 +150,22 @@ static int _identifyEdgeCountPattern(OpBase *root, OpResult **opResult, OpAggreg
 	*opTraverse = op;
 	op = op->children[0];
 
-	// Only a full node scan can be converted, as a labeled source acts as a filter
-	// that may invalidate some of the edges.
-	if(op->type != OPType_ALL_NODE_SCAN || op->childCount != 0) return 0;
+	// Either a full node or label scan, the edges' endpoints are restricted by their labels.
+	if((op->type != OPType_ALL_NODE_SCAN &&
+		op->type != OPType_NODE_BY_LABEL_SCAN) ||
+	   op->childCount != 0) {
+		return 0;
+	}
 	*opScan = op;
 
+	// The pattern is a single directed edge between two nodes.
+	const QueryGraph *qg = op->plan->query_graph;
+	if(QueryGraph_NodeCount(qg) != 2 || QueryGraph_EdgeCount(qg) != 1) return 0;
+	const QGEdge *edge = qg->edges[0];
+	if(edge->bidirectional || edge->minHops != 1 || edge->maxHops != 1) return 0;
+	if(edge->src == edge->dest || !_singlyLabeled(edge->src) || !_singlyLabeled(edge->dest)) return 0;
+	*e = edge;
+
 	return 1;
 }
 
@@ -152,12 +175,15 @@ void _countEdges(void *z, const void *x) {
 		*(uint64_t *)z = 1;
 	} else {
 		// Multiple edges
-		EdgeID *ids = (EdgeID *)(*entry);
-		*(uint64_t *)z = array_len(ids);
+		const MultiEdge *me = (const MultiEdge *)(*entry);
+		*(uint64_t *)z = me->count;
 	}
 }
 
-uint64_t _countRelationshipEdges(GrB_Matrix M) {
+/* Counts the edges held by relation matrix M whose source is in src
+ * and whose destination is in dest, label matrices which may be NULL.
+ * If pairs is set, every pair of connected nodes counts once. */
+uint64_t _countRelationshipEdges(GrB_Matrix M, GrB_Matrix src, GrB_Matrix dest, bool pairs) {
 	// Create Unary operation only once.
 	if(!countMultipleEdges) {
 		GrB_UnaryOp_new(&countMultipleEdges, _countEdges, GrB_UINT64, GrB_UINT64);
@@ -182,7 +208,11 @@ uint64_t _countRelationshipEdges(GrB_Matrix M) {
 
 	// A[i,j] = # of edges in M[i,j].
 	GrB_Matrix_apply(A, GrB_NULL, GrB_NULL,
-					 countMultipleEdges, M, GrB_NULL);
+					 pairs ? GxB_ONE_UINT64 : countMultipleEdges, M, GrB_NULL);
+
+	// Keep the rows of labeled sources and the columns of labeled destinations.
+	if(src) GrB_mxm(A, GrB_NULL, GrB_NULL, GxB_PLUS_TIMES_UINT64, src, A, GrB_NULL);
+	if(dest) GrB_mxm(A, GrB_NULL, GrB_NULL, GxB_PLUS_TIMES_UINT64, A, dest, GrB_NULL);
 
 	uint64_t edges = 0;
 	// Sum(A)
@@ -193,48 +223,76 @@ uint64_t _countRelationshipEdges(GrB_Matrix M) {
 	return edges;
 }
 
+/* Retrieves the label matrix restricting n, sets it to NULL if n is unlabeled.
+ * Returns false if n's label doesn't exist. */
+static bool _endpointMatrix(Graph *g, const QGNode *n, GrB_Matrix *m) {
+	*m = NULL;
+	if(n->label == NULL) return true;
+	if(n->labelID == GRAPH_NO_LABEL) return false;
+	*m = Graph_GetLabelMatrix(g, n->labelID);
+	return true;
+}
+
 void _reduceEdgeCount(ExecutionPlan *plan) {
 	/* We'll only modify execution plan if it is structured as follows:
-	 * "Full Scan -> Conditional Traverse -> Aggregate -> Results" */
+	 * "Scan -> Conditional Traverse -> Aggregate -> Results" */
 	OpBase *opScan;
 	OpBase *opTraverse;
 	OpResult *opResult;
 	OpAggregate *opAggregate;
+	const QGEdge *e;
 
 	/* See if execution-plan matches the pattern:
-	 * "Full Scan -> Conditional Traverse -> Aggregate -> Results".
+	 * "Scan -> Conditional Traverse -> Aggregate -> Results".
 	 * if that's not the case, simply return without making any modifications. */
-	if(!_identifyEdgeCountPattern(plan->root, &opResult, &opAggregate, &opTraverse, &opScan)) return;
+	if(!_identifyEdgeCountPattern(plan->root, &opResult, &opAggregate, &opTraverse, &opScan, &e)) {
+		return;
+	}
 
-	/* User is trying to count edges (either in total or of specific types) in the graph.
-	 * Optimize by skipping Scan, Traverse and Aggregate. */
+	/* User is trying to count edges (either in total or of specific types, between
+	 * labeled endpoints) in the graph. Optimize by skipping Scan, Traverse and Aggregate. */
 	SIValue edgeCount = SI_LongVal(0);
 	Graph *g = QueryCtx_GetGraph();
 
-	// If type is specified, count only labeled entities.
-	CondTraverse *condTraverse = (CondTraverse *)opTraverse;
-	int edgeRelationCount = condTraverse->edgeRelationCount;
+	GrB_Matrix src;
+	GrB_Matrix dest;
+	bool endpoints_exist = _endpointMatrix(g, e->src, &src) && _endpointMatrix(g, e->dest, &dest);
 
-	// The traversal op doesn't contain information about the traversed edge, cannot apply optimization.
-	if(edgeRelationCount == 0) return;
+	/* Traversals of unreferenced edges produce each pair of connected nodes once,
+	 * pairs connected by several types are only counted once on the adjacency matrix. */
+	bool pairs = ((CondTraverse *)opTraverse)->edgeRelationCount == 0;
+	uint relation_count = array_len(e->reltypeIDs);
+	if(pairs && relation_count > 1) return;
 
 	uint64_t edges = 0;
-	for(int i = 0; i < edgeRelationCount; i++) {
-		int relType = condTraverse->edgeRelationTypes[i];
-		switch(relType) {
-		case GRAPH_NO_RELATION:
-			// Should be the only relationship type mentioned, -[]->
+	if(!endpoints_exist) {
+		// A specified label doesn't exist, no edges match.
+	} else if(relation_count == 0) {
+		// -[]->, count edges of every type.
+		if(pairs) {
+			edges = _countRelationshipEdges(Graph_GetAdjacencyMatrix(g), src, dest, true);
+		} else if(src == NULL && dest == NULL) {
 			edges = Graph_EdgeCount(g);
-			break;
-		case GRAPH_UNKNOWN_RELATION:
+		} else {
+			int type_count = Graph_RelationTypeCount(g);
+			for(int r = 0; r < type_count; r++) {
+				edges += _countRelationshipEdges(Graph_GetRelationMatrix(g, r), src, dest, false);
+			}
+		}
+	} else {
+		for(uint i = 0; i < relation_count; i++) {
+			int relType = e->reltypeIDs[i];
 			// No change to current count, -[:none_existing]->
-			break;
-		default:
-			edges += _countRelationshipEdges(Graph_GetRelationMatrix(g, relType));
+			if(relType == GRAPH_UNKNOWN_RELATION) continue;
+			edges += _countRelationshipEdges(Graph_GetRelationMatrix(g, relType), src, dest, pairs);
 		}
 	}
 	edgeCount = SI_LongVal(edges);
 
+	/* The count is folded into the plan, which makes
+	 * the plan valid for the current graph state only. */
+	QueryCtx_SetPlanUnreusable();
+
 	/* Construct a constant expression, used by a new
 	 * projection operation. */
 	AR_ExpNode *exp = AR_EXP_NewConstOperandNode(edgeCount);
@@ -6,6 +6,7 @@
 
 #include "seek_by_id.h"
 #include "../../util/arr.h"
+#include "../../datatypes/array.h"
 #include "../ops/op_filter.h"
 #include "../ops/op_index_scan.h"
 #include "../ops/op_all_node_scan.h"
@@ -19,7 +20,7 @@ static bool _idFilter(FT_FilterNode *f, AST_Operator *rel, EntityID *id, bool *r
 	if(f->pred.op == OP_NEQUAL) return false;
 
 	AR_OpNode *op;
-	AR_OperandNode *operand;
+	AR_ExpNode *operand;
 	AR_ExpNode *lhs = f->pred.lhs;
 	AR_ExpNode *rhs = f->pred.rhs;
 	*rel = f->pred.op;
@@ -29,34 +30,80 @@ static bool _idFilter(FT_FilterNode *f, AST_Operator *rel, EntityID *id, bool *r
 	 * const compare ID(N) */
 	if(lhs->type == AR_EXP_OPERAND && rhs->type == AR_EXP_OP) {
 		op = &rhs->op;
-		operand = &lhs->operand;
+		operand = lhs;
 		*reverse = true;
 	} else if(lhs->type == AR_EXP_OP && rhs->type == AR_EXP_OPERAND) {
 		op = &lhs->op;
-		operand = &rhs->operand;
+		operand = rhs;
 		*reverse = false;
 	} else {
 		return false;
 	}
 
-	// Make sure ID is compared to a constant.
-	if(operand->type != AR_EXP_CONSTANT) return false;
-	if(SI_TYPE(operand->constant) != T_INT64) return false;
-	*id = SI_GET_NUMERIC(operand->constant);
-
 	// Make sure applied function is ID.
 	if(strcasecmp(op->func_name, "id")) return false;
 
+	// Make sure ID is compared to a constant or a parameter.
+	if(!AR_EXP_IsConstant(operand) && !AR_EXP_IsParameter(operand)) return false;
+	SIValue id_val = AR_EXP_Evaluate(operand, NULL);
+	if(SI_TYPE(id_val) != T_INT64) return false;
+	*id = SI_GET_NUMERIC(id_val);
+
+	return true;
+}
+
+/* Checks for a filter of the form
+ * ID(n) IN X
+ * where X is a constant or a parameter list of integers,
+ * populating ids with the listed IDs. */
+static bool _idListFilter(FT_FilterNode *f, const char *alias, NodeID **ids) {
+	if(f->t != FT_N_EXP) return false;
+	AR_ExpNode *exp = f->exp.exp;
+	if(exp->type != AR_EXP_OP || strcasecmp(exp->op.func_name, "in")) return false;
+	if(exp->op.child_count != 2) return false;
+
+	// Make sure the looked up value is the ID of the scanned node.
+	AR_ExpNode *lhs = exp->op.children[0];
+	if(lhs->type != AR_EXP_OP || strcasecmp(lhs->op.func_name, "id")) return false;
+	if(lhs->op.child_count != 1) return false;
+	AR_ExpNode *entity = lhs->op.children[0];
+	if(entity->type != AR_EXP_OPERAND || entity->operand.type != AR_EXP_VARIADIC) return false;
+	if(entity->operand.variadic.entity_prop != NULL) return false;
+	if(strcmp(entity->operand.variadic.entity_alias, alias)) return false;
+
+	// Make sure IDs are looked up in a constant or a parameter.
+	AR_ExpNode *rhs = exp->op.children[1];
+	if(!AR_EXP_IsConstant(rhs) && !AR_EXP_IsParameter(rhs)) return false;
+	SIValue list = AR_EXP_Evaluate(rhs, NULL);
+	if(SI_TYPE(list) != T_ARRAY) return false;
+
+	/* Only integers are compared against IDs here, other elements,
+	 * e.g. doubles equal to an ID, leave the filter in place. */
+	uint len = SIArray_Length(list);
+	for(uint i = 0; i < len; i++) {
+		if(SI_TYPE(SIArray_Get(list, i)) != T_INT64) return false;
+	}
+
+	*ids = array_new(NodeID, len);
+	for(uint i = 0; i < len; i++) {
+		int64_t id = SIArray_Get(list, i).longval;
+		// Negative IDs never match.
+		if(id >= 0) *ids = array_append(*ids, (NodeID)id);
+	}
 	return true;
 }
 
 static void _UseIdOptimization(ExecutionPlan *plan, OpBase *scan_op) {
 	/* See if there's a filter of the form
 	 * ID(n) op X
-	 * where X is a constant and op in [EQ, GE, LE, GT, LT] */
+	 * where X is a constant and op in [EQ, GE, LE, GT, LT]
+	 * or of the form ID(n) IN X where X is a list of constants. */
 	OpBase *parent = scan_op->parent;
 	OpBase *grandparent;
 	UnsignedRange *id_range = NULL;
+	NodeID *ids = NULL;
+	const char *alias = (scan_op->type == OPType_NODE_BY_LABEL_SCAN) ?
+						((NodeByLabelScan *)scan_op)->n->alias : ((AllNodeScan *)scan_op)->n->alias;
 	while(parent && parent->type == OPType_FILTER) {
 		grandparent = parent->parent; // Track the next op to visit in case we free parent.
 		OpFilter *filter = (OpFilter *)parent;
@@ -65,6 +112,7 @@ static void _UseIdOptimization(ExecutionPlan *plan, OpBase *scan_op) {
 		AST_Operator op;
 		EntityID id;
 		bool reverse;
+		NodeID *listed;
 		if(_idFilter(f, &op, &id, &reverse)) {
 			if(!id_range) id_range = UnsignedRange_New();
 			if(reverse) op = ArithmeticOp_ReverseOp(op);
@@ -73,6 +121,30 @@ static void _UseIdOptimization(ExecutionPlan *plan, OpBase *scan_op) {
 			// Free replaced operations.
 			ExecutionPlan_RemoveOp(plan, (OpBase *)filter);
 			OpBase_Free((OpBase *)filter);
+		} else if(!ids && _idListFilter(f, alias, &listed)) {
+			if(scan_op->type == OPType_NODE_BY_LABEL_SCAN) {
+				/* Label scans are only bounded by the listed IDs,
+				 * the filter remains in place. */
+				uint count = array_len(listed);
+				if(count > 0) {
+					NodeID min = listed[0];
+					NodeID max = listed[0];
+					for(uint i = 1; i < count; i++) {
+						min = MIN(min, listed[i]);
+						max = MAX(max, listed[i]);
+					}
+					if(!id_range) id_range = UnsignedRange_New();
+					UnsignedRange_TightenRange(id_range, OP_GE, min);
+					UnsignedRange_TightenRange(id_range, OP_LE, max);
+				}
+				array_free(listed);
+			} else {
+				if(!id_range) id_range = UnsignedRange_New();
+				ids = listed;
+				// Free replaced operations.
+				ExecutionPlan_RemoveOp(plan, (OpBase *)filter);
+				OpBase_Free((OpBase *)filter);
+			}
 		}
 		// Advance.
 		parent = grandparent;
@@ -88,6 +160,7 @@ static void _UseIdOptimization(ExecutionPlan *plan, OpBase *scan_op) {
 		} else {
 			const QGNode *node = ((AllNodeScan *)scan_op)->n;
 			OpBase *opNodeByIdSeek = NewNodeByIdSeekOp(scan_op->plan, node, id_range);
+			if(ids) NodeByIdSeekOp_SetIDs((NodeByIdSeek *)opNodeByIdSeek, ids);
 
 			// Managed to reduce!
 			ExecutionPlan_ReplaceOp(plan, scan_op, opNodeByIdSeek);
@@ -0,0 +1,239 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "share_expressions.h"
+#include "../ops/ops.h"
+#include "../../util/arr.h"
+#include "../../query_ctx.h"
+#include "../../util/rmalloc.h"
+#include <string.h>
+#include <strings.h>
+
+// Operations passing records from a filter to the projection as they arrive.
+static const OPType STREAMING_OPS[] = {
+	OPType_FILTER, OPType_CONDITIONAL_TRAVERSE, OPType_CONDITIONAL_VAR_LEN_TRAVERSE,
+	OPType_CONDITIONAL_VAR_LEN_TRAVERSE_EXPAND_INTO, OPType_EXPAND_INTO, OPType_EXPAND_INTERSECT
+};
+#define STREAMING_OP_COUNT 6
+
+static inline bool _IsFunctionCall(const AR_ExpNode *exp) {
+	return exp->type == AR_EXP_OP && exp->op.type == AR_OP_FUNC;
+}
+
+/* Returns true if exp yields the same value whenever evaluated against a record,
+ * variable is set if exp refers to a record entry. */
+static bool _Shareable(const AR_ExpNode *exp, bool *variable) {
+	if(exp->type == AR_EXP_OPERAND) {
+		if(exp->operand.type == AR_EXP_VARIADIC) *variable = true;
+		return true;
+	}
+	if(exp->op.type == AR_OP_AGGREGATE) return false;
+
+	const char *func = exp->op.func_name;
+	if(!strcasecmp(func, "rand") || !strcasecmp(func, "randomUUID") ||
+	   !strcasecmp(func, "timestamp")) return false;
+
+	for(int i = 0; i < exp->op.child_count; i++) {
+		if(!_Shareable(exp->op.children[i], variable)) return false;
+	}
+	return true;
+}
+
+static bool _Equal(const AR_ExpNode *a, const AR_ExpNode *b) {
+	if(a->type != b->type) return false;
+
+	if(a->type == AR_EXP_OP) {
+		if(a->op.type != b->op.type || a->op.child_count != b->op.child_count ||
+		   strcasecmp(a->op.func_name, b->op.func_name)) return false;
+		for(int i = 0; i < a->op.child_count; i++) {
+			if(!_Equal(a->op.children[i], b->op.children[i])) return false;
+		}
+		return true;
+	}
+
+	if(a->operand.type != b->operand.type) return false;
+	switch(a->operand.type) {
+	case AR_EXP_CONSTANT:
+		return (SI_TYPE(a->operand.constant) == SI_TYPE(b->operand.constant) &&
+				SIValue_Compare(a->operand.constant, b->operand.constant, NULL) == 0);
+	case AR_EXP_VARIADIC:
+		if(strcmp(a->operand.variadic.entity_alias, b->operand.variadic.entity_alias)) return false;
+		if(a->operand.variadic.entity_prop == NULL || b->operand.variadic.entity_prop == NULL) {
+			return a->operand.variadic.entity_prop == b->operand.variadic.entity_prop;
+		}
+		return !strcmp(a->operand.variadic.entity_prop, b->operand.variadic.entity_prop);
+	case AR_EXP_PARAM:
+		return !strcmp(a->operand.param_name, b->operand.param_name);
+	default:
+		return false;
+	}
+}
+
+// Collect every shareable function call within exp.
+static void _CollectCandidates(AR_ExpNode *exp, AR_ExpNode ***candidates) {
+	if(!_IsFunctionCall(exp)) return;
+
+	bool variable = false;
+	if(_Shareable(exp, &variable) && variable) *candidates = array_append(*candidates, exp);
+	for(int i = 0; i < exp->op.child_count; i++) {
+		_CollectCandidates(exp->op.children[i], candidates);
+	}
+}
+
+// Collect the addresses of the expressions within a filter tree.
+static void _CollectFilterExps(FT_FilterNode *tree, AR_ExpNode ****exps) {
+	switch(tree->t) {
+	case FT_N_COND:
+		_CollectFilterExps(tree->cond.left, exps);
+		_CollectFilterExps(tree->cond.right, exps);
+		break;
+	case FT_N_PRED:
+		*exps = array_append(*exps, &tree->pred.lhs);
+		*exps = array_append(*exps, &tree->pred.rhs);
+		break;
+	case FT_N_EXP:
+		*exps = array_append(*exps, &tree->exp.exp);
+		break;
+	default:
+		assert(false);
+	}
+}
+
+// Replace exp with a read of alias.
+static void _ReadShared(AR_ExpNode **exp, const char *alias) {
+	AR_ExpNode *read = AR_EXP_NewVariableOperandNode(alias, NULL);
+	read->resolved_name = (*exp)->resolved_name;
+	AR_EXP_Free(*exp);
+	*exp = read;
+}
+
+/* Replace the outermost calls within exp which are equal to a shared expression,
+ * sharing calls equal to a candidate through the filter. */
+static void _Share(AR_ExpNode **exp, AR_ExpNode **candidates, FilterSharedExp **shared,
+				   OpFilter *filter) {
+	if(!_IsFunctionCall(*exp)) return;
+
+	uint shared_count = array_len(*shared);
+	for(uint i = 0; i < shared_count; i++) {
+		if(_Equal(*exp, (*shared)[i].exp)) {
+			_ReadShared(exp, (*shared)[i].alias);
+			return;
+		}
+	}
+
+	uint candidate_count = candidates ? array_len(candidates) : 0;
+	for(uint i = 0; i < candidate_count; i++) {
+		if(!_Equal(*exp, candidates[i])) continue;
+
+		// Name the shared value after the expression, names are owned by the AST.
+		AST *ast = QueryCtx_GetAST();
+		char *name = AR_EXP_BuildResolvedName(*exp);
+		size_t len = strlen(name) + sizeof(" (shared)");
+		char *alias = rm_malloc(len);
+		snprintf(alias, len, "%s (shared)", name);
+		rm_free(name);
+
+		// Expressions printed alike yet differing can't share a record slot.
+		rax *mapping = ExecutionPlan_GetMappings(filter->op.plan);
+		if(raxFind(mapping, (unsigned char *)alias, strlen(alias)) != raxNotFound) {
+			rm_free(alias);
+			break;
+		}
+		char *canonical = raxFind(ast->canonical_entity_names, (unsigned char *)alias,
+								  strlen(alias));
+		if(canonical == raxNotFound) {
+			raxInsert(ast->canonical_entity_names, (unsigned char *)alias, strlen(alias), alias, NULL);
+		} else {
+			rm_free(alias);
+			alias = canonical;
+		}
+
+		FilterSharedExp s = {.exp = AR_EXP_Clone(*exp), .alias = alias};
+		*shared = array_append(*shared, s);
+		_ReadShared(exp, alias);
+		return;
+	}
+
+	for(int i = 0; i < (*exp)->op.child_count; i++) {
+		_Share((*exp)->op.children + i, candidates, shared, filter);
+	}
+}
+
+static void _ShareExps(AR_ExpNode **exps, uint count, AR_ExpNode **candidates,
+					   FilterSharedExp **shared, OpFilter *filter) {
+	for(uint i = 0; i < count; i++) _Share(exps + i, candidates, shared, filter);
+}
+
+// Locate the projection fed by filter, through operations streaming records.
+static OpBase *_LocateProjection(OpFilter *filter) {
+	OpBase *op = filter->op.parent;
+	while(op && op->plan == filter->op.plan && op->childCount == 1) {
+		if(op->type == OPType_PROJECT || op->type == OPType_AGGREGATE) return op;
+		bool streaming = false;
+		for(uint i = 0; i < STREAMING_OP_COUNT; i++) {
+			if(op->type == STREAMING_OPS[i]) streaming = true;
+		}
+		if(!streaming) return NULL;
+		op = op->parent;
+	}
+	return NULL;
+}
+
+static void _shareFilterExpressions(OpFilter *filter) {
+	OpBase *projection = _LocateProjection(filter);
+	if(projection == NULL) return;
+
+	AR_ExpNode ***filter_exps = array_new(AR_ExpNode **, 2);
+	_CollectFilterExps(filter->filterTree, &filter_exps);
+	uint filter_exp_count = array_len(filter_exps);
+
+	/* Only the first predicate is evaluated for every record,
+	 * computing calls evaluated conditionally ahead of the filter tree
+	 * might add work or raise errors for records the tree rejects. */
+	FT_FilterNode *first = filter->filterTree;
+	while(first->t == FT_N_COND) first = first->cond.left;
+	AR_ExpNode ***first_exps = array_new(AR_ExpNode **, 2);
+	_CollectFilterExps(first, &first_exps);
+
+	AR_ExpNode **candidates = array_new(AR_ExpNode *, 1);
+	for(uint i = 0; i < array_len(first_exps); i++) _CollectCandidates(*first_exps[i], &candidates);
+	array_free(first_exps);
+
+	FilterSharedExp *shared = array_new(FilterSharedExp, 0);
+	if(array_len(candidates) > 0) {
+		// Share the calls the projection has in common with the filter.
+		if(projection->type == OPType_PROJECT) {
+			OpProject *project = (OpProject *)projection;
+			_ShareExps(project->exps, project->exp_count, candidates, &shared, filter);
+		} else {
+			OpAggregate *aggregate = (OpAggregate *)projection;
+			_ShareExps(aggregate->key_exps, aggregate->key_count, candidates, &shared, filter);
+			_ShareExps(aggregate->aggregate_exps, aggregate->aggregate_count, candidates, &shared,
+					   filter);
+		}
+	}
+	array_free(candidates);
+
+	// The filter tree reads the shared values as well.
+	for(uint i = 0; i < filter_exp_count; i++) _Share(filter_exps[i], NULL, &shared, filter);
+	array_free(filter_exps);
+
+	uint shared_count = array_len(shared);
+	for(uint i = 0; i < shared_count; i++) {
+		FilterOp_ShareExpression(filter, shared[i].exp, shared[i].alias);
+	}
+	array_free(shared);
+}
+
+void shareExpressions(ExecutionPlan *plan) {
+	OpBase **filters = ExecutionPlan_CollectOps(plan->root, OPType_FILTER);
+
+	for(uint i = 0; i < array_len(filters); i++) {
+		_shareFilterExpressions((OpFilter *)filters[i]);
+	}
+
+	array_free(filters);
+}
@@ -0,0 +1,16 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../execution_plan.h"
+
+/* The shareExpressions optimization will look for function calls
+ * evaluated by a filter and again by the projection it feeds, e.g.
+ * MATCH (p:Person) WHERE toLower(p.name) STARTS WITH 'a' RETURN toLower(p.name)
+ * In which case the filter computes the call into a record slot once,
+ * and both the filter tree and the projection read the value from that slot. */
+void shareExpressions(ExecutionPlan *plan);
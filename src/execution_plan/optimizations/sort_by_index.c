@@ -0,0 +1,79 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "sort_by_index.h"
+#include "../ops/ops.h"
+#include "../../util/arr.h"
+#include "../../query_ctx.h"
+#include "../../ast/ast_build_op_contexts.h"
+#include <string.h>
+
+// Retrieves the projection computing the value named name.
+static const AR_ExpNode *_GetProjection(const OpProject *project, const char *name) {
+	for(uint i = 0; i < project->exp_count; i++) {
+		const AR_ExpNode *exp = project->exps[i];
+		if(!strcmp(exp->resolved_name, name)) return exp;
+	}
+	return NULL;
+}
+
+/* Locates the label scan feeding sort, only operations preserving
+ * their input order may reside between the two, sets exp to the
+ * projection sort orders records by. */
+static NodeByLabelScan *_identifyPattern(OpSort *sort, const AR_ExpNode **exp) {
+	// Sort must obey a limit and order records by a single expression.
+	if(sort->limit == 0 || array_len(sort->exps) != 1) return NULL;
+
+	OpBase *op = sort->op.children[0];
+	if(op->type == OPType_DISTINCT) op = op->children[0];
+	if(op->type != OPType_PROJECT || op->childCount != 1) return NULL;
+	*exp = _GetProjection((OpProject *)op, sort->exps[0]->resolved_name);
+	if(*exp == NULL) return NULL;
+
+	op = op->children[0];
+	while(op->type == OPType_FILTER && op->childCount == 1) op = op->children[0];
+
+	if(op->type != OPType_NODE_BY_LABEL_SCAN || op->childCount != 0) return NULL;
+	NodeByLabelScan *scan = (NodeByLabelScan *)op;
+	// Additional labels are verified by a filter.
+	if(QGNode_LabelCount(scan->n) > 1) return NULL;
+	return scan;
+}
+
+static void _sortByIndex(ExecutionPlan *plan, OpSort *sort) {
+	const AR_ExpNode *exp;
+	NodeByLabelScan *scan = _identifyPattern(sort, &exp);
+	if(scan == NULL) return;
+
+	// Records must be ordered by an attribute of the scanned node.
+	if(exp->type != AR_EXP_OPERAND ||
+	   exp->operand.type != AR_EXP_VARIADIC ||
+	   exp->operand.variadic.entity_prop == NULL ||
+	   strcmp(exp->operand.variadic.entity_alias, scan->n->alias)) return;
+
+	const char *attribute = exp->operand.variadic.entity_prop;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	if(!GraphContext_GetIndex(gc, scan->n->label, attribute, IDX_EXACT_MATCH)) return;
+
+	/* Whether the index orders every labeled node is resolved once the
+	 * scan is initialized, as such the plan remains valid for later graph states. */
+	bool descending = (sort->directions[0] == DIR_DESC);
+	OpBase *order_scan = NewIndexOrderScanOp(scan->op.plan, scan->n, attribute, descending);
+	ExecutionPlan_ReplaceOp(plan, (OpBase *)scan, order_scan);
+	OpBase_Free((OpBase *)scan);
+
+	SortOp_SetPresorted(sort);
+}
+
+void sortByIndex(ExecutionPlan *plan) {
+	OpBase **sort_ops = ExecutionPlan_CollectOps(plan->root, OPType_SORT);
+
+	for(uint i = 0; i < array_len(sort_ops); i++) {
+		_sortByIndex(plan, (OpSort *)sort_ops[i]);
+	}
+
+	array_free(sort_ops);
+}
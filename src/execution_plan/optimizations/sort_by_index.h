@@ -0,0 +1,17 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../execution_plan.h"
+
+/* The sortByIndex optimization will look for execution plans
+ * sorting a label scan by an indexed attribute with a limit, e.g.
+ * MATCH (p:Product) RETURN p ORDER BY p.price DESC LIMIT 20
+ * In which case the label scan is replaced by an index order scan,
+ * producing nodes in attribute order, such that sort only needs to
+ * stream the first records through rather than sorting every record. */
+void sortByIndex(ExecutionPlan *plan);
@@ -9,6 +9,8 @@
 #include "../../util/strcmp.h"
 #include "../../util/vector.h"
 #include "../../util/rmalloc.h"
+#include "../cardinality.h"
+#include "../../graph/degree_stats.h"
 #include <assert.h>
 
 #define T 1           // Transpose penalty.
@@ -16,6 +18,9 @@
 #define F 4 * T       // Filter score.
 #define B 8 * F       // Bound variable bonus.
 
+// A direction is preferred once its fan-out is smaller by this factor.
+#define FANOUT_RATIO 2
+
 typedef AlgebraicExpression **Arrangement;
 
 // Create a new arrangement.
@@ -47,6 +52,24 @@ static inline void _Arrangement_Free(Arrangement arrangement) {
 	rm_free(arrangement);
 }
 
+/* Returns true if evaluating exp from its destination, or from its source
+ * if backward is false, reaches considerably fewer nodes than the opposite direction. */
+static bool _fanout_smaller(GraphContext *gc, const AlgebraicExpression *exp, bool backward) {
+	double forward_fanout = Cardinality_ExpressionFanout(gc, exp, false);
+	double backward_fanout = Cardinality_ExpressionFanout(gc, exp, true);
+	if(forward_fanout < 0 || backward_fanout < 0) return false;
+	if(backward) return backward_fanout * FANOUT_RATIO < forward_fanout;
+	return forward_fanout * FANOUT_RATIO < backward_fanout;
+}
+
+// Number of nodes a scan resolving n visits.
+static double _scan_size(GraphContext *gc, const QGNode *n) {
+	if(!n->label) return Graph_NodeCount(gc->g);
+	// Unknown label, no nodes are scanned.
+	if(n->labelID == GRAPH_NO_LABEL) return 0;
+	return Graph_LabeledNodeCount(gc->g, n->labelID);
+}
+
 // Computes x!
 static inline unsigned long _factorial(uint x) {
 	unsigned long res = 1;
@@ -136,7 +159,7 @@ static bool _valid_arrangement(const Arrangement arrangement, uint exps_count, Q
 	return true;
 }
 
-static int _penalty_arrangement(Arrangement arrangement, uint exp_count) {
+static int _penalty_arrangement(Arrangement arrangement, uint exp_count, GraphContext *gc) {
 	int penalty = 0;
 	AlgebraicExpression *exp;
 
@@ -164,11 +187,14 @@ static int _penalty_arrangement(Arrangement arrangement, uint exp_count) {
 			// Count how many transposes are performed.
 			transpose_count = AlgebraicExpression_OperationCount(exp, AL_EXP_TRANSPOSE);
 			penalty += transpose_count * T;
+			// Penalize traversing from the higher fan-out side.
+			if(_fanout_smaller(gc, exp, true)) penalty += T;
 		} else {
 			// Count how many transposes we require to perform.
 			transpose_count = AlgebraicExpression_OperationCount(exp, AL_EXP_TRANSPOSE);
 			uint operand_count = AlgebraicExpression_OperandCount(exp);
 			penalty += (operand_count - transpose_count) * T;
+			if(_fanout_smaller(gc, exp, false)) penalty += T;
 		}
 	}
 
@@ -217,9 +243,9 @@ static int _reward_arrangement(Arrangement arrangement, uint exp_count, QueryGra
 }
 
 static int _score_arrangement(Arrangement arrangement, uint exp_count, QueryGraph *qg,
-							  rax *filtered_entities, rax *bound_vars) {
+							  rax *filtered_entities, rax *bound_vars, GraphContext *gc) {
 	int score = 0;
-	int penalty = _penalty_arrangement(arrangement, exp_count);
+	int penalty = _penalty_arrangement(arrangement, exp_count, gc);
 	int reward = _reward_arrangement(arrangement, exp_count, qg, filtered_entities, bound_vars);
 	score -= penalty;
 	score += reward;
@@ -251,9 +277,11 @@ static void _resolve_winning_sequence(AlgebraicExpression **exps, uint exp_count
  * If the source is bounded, we will not transpose, if only the destination is bounded, we will.
  * If neither are bounded, we fall back to label and filter heuristics.
  * We'll choose to transpose if the destination is filtered and the source is not, or
- * if neither is filtered, if the destination is labeled and the source is not. */
+ * if neither is filtered, if the destination is labeled and the source is not.
+ * When both ends are alike, degree statistics decide whether the destination scan
+ * followed by the backward traversal reaches considerably fewer nodes. */
 static void _select_entry_point(QueryGraph *qg, AlgebraicExpression *ae, rax *filtered_entities,
-								rax *bound_vars) {
+								rax *bound_vars, GraphContext *gc) {
 	if(AlgebraicExpression_OperandCount(ae) == 1 &&
 	   !RG_STRCMP(AlgebraicExpression_Source(ae), AlgebraicExpression_Destination(ae))) return;
 
@@ -292,13 +320,19 @@ static void _select_entry_point(QueryGraph *qg, AlgebraicExpression *ae, rax *fi
 	 * do not use label scan if for every node N such that
 	 * (N)-[relation]->(T) N is of the same type T, and type of
 	 * either source or destination node is T. */
-	if(srcLabeled) {
-		// Neither end is filtered and the source is labeled, making the current order most appealing.
-		return;
-	} else if(destLabeled) {
+	if(srcLabeled != destLabeled) {
 		// The destination is labeled and the source is not, transpose.
-		AlgebraicExpression_Transpose(ae);
+		if(destLabeled) AlgebraicExpression_Transpose(ae);
+		return;
 	}
+
+	// Compare the number of nodes reached starting from either end.
+	double forward = Cardinality_ExpressionFanout(gc, ae, false);
+	double backward = Cardinality_ExpressionFanout(gc, ae, true);
+	if(forward < 0 || backward < 0) return;
+	forward *= _scan_size(gc, src);
+	backward *= _scan_size(gc, dest);
+	if(backward * FANOUT_RATIO < forward) AlgebraicExpression_Transpose(ae);
 }
 
 /* Given a set of algebraic expressions representing a graph traversal
@@ -306,7 +340,7 @@ static void _select_entry_point(QueryGraph *qg, AlgebraicExpression *ae, rax *fi
  * taking into account filters and transposes.
  * exps will reordered. */
 void orderExpressions(QueryGraph *qg, AlgebraicExpression **exps, uint exp_count,
-					  const FT_FilterNode *filters, rax *bound_vars) {
+					  const FT_FilterNode *filters, rax *bound_vars, GraphContext *gc) {
 	assert(exps && exp_count > 0);
 
 	/* Return early if we only have one expression that represents a scan rather than a traversal.
@@ -342,7 +376,8 @@ void orderExpressions(QueryGraph *qg, AlgebraicExpression **exps, uint exp_count
 
 	for(uint i = 0; i < valid_arrangement_count; i++) {
 		Arrangement arrangement = valid_arrangements[i];
-		int score = _score_arrangement(arrangement, exp_count, qg, filtered_entities, bound_vars);
+		int score = _score_arrangement(arrangement, exp_count, qg, filtered_entities, bound_vars,
+									   gc);
 		// printf("score: %d\n", score);
 		// _Arrangement_Print(arrangement, exp_count);
 		if(max_score < score) {
@@ -362,7 +397,7 @@ void orderExpressions(QueryGraph *qg, AlgebraicExpression **exps, uint exp_count
 
 select_entry_point:
 	// Transpose the winning expression if the destination node is a more efficient starting place.
-	_select_entry_point(qg, exps[0], filtered_entities, bound_vars);
+	_select_entry_point(qg, exps[0], filtered_entities, bound_vars, gc);
 
 	raxFree(filtered_entities);
 	for(uint i = 0; i < arrangement_count; i++) _Arrangement_Free(arrangements[i]);
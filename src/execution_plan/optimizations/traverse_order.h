@@ -7,6 +7,7 @@
 #pragma once
 
 #include "../execution_plan.h"
+#include "../../graph/graphcontext.h"
 #include "../../filter_tree/filter_tree.h"
 #include "../../arithmetic/algebraic_expression.h"
 
@@ -21,6 +22,7 @@ void orderExpressions(
 	AlgebraicExpression **exps,     // Expressions to order.
 	uint exps_count,                // Number of expressions.
 	const FT_FilterNode *filters,   // Filters.
-	rax *bound_vars                 // Previously-bound variables.
+	rax *bound_vars,                // Previously-bound variables.
+	GraphContext *gc                // Graph whose degree statistics guide the order, optional.
 );
 
@@ -3,10 +3,12 @@
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
 #include "../ops/op_index_scan.h"
+#include "../ops/op_edge_index_scan.h"
 #include "../../ast/ast_shared.h"
 #include "../../util/range/string_range.h"
 #include "../../util/range/numeric_range.h"
 #include "../../datatypes/array.h"
+#include "../../datatypes/point.h"
 #include "../../arithmetic/arithmetic_op.h"
 
 static void _transformInToOrSequence(FT_FilterNode **filter) {
@@ -321,6 +323,38 @@ cleanup:
 	return res;
 }
 
+/* Replace query parameters within the expression with their current values,
+ * this ties the plan to the given parameters and marks it as unreusable. */
+static void _resolveParams(AR_ExpNode *exp) {
+	if(exp->type == AR_EXP_OP) {
+		for(int i = 0; i < exp->op.child_count; i++) _resolveParams(exp->op.children[i]);
+	} else if(AR_EXP_IsParameter(exp)) {
+		SIValue v = AR_EXP_Evaluate(exp, NULL);
+		exp->operand.type = AR_EXP_CONSTANT;
+		exp->operand.constant = SI_CloneValue(v);
+	}
+}
+
+/* Resolve query parameters within a filter tree, such that filters
+ * over parameters e.g. n.v = $p can be utilized by the index. */
+static void _resolveFilterParams(FT_FilterNode *filter) {
+	switch(filter->t) {
+	case FT_N_PRED:
+		_resolveParams(filter->pred.lhs);
+		_resolveParams(filter->pred.rhs);
+		break;
+	case FT_N_EXP:
+		_resolveParams(filter->exp.exp);
+		break;
+	case FT_N_COND:
+		_resolveFilterParams(filter->cond.left);
+		_resolveFilterParams(filter->cond.right);
+		break;
+	default:
+		assert(false);
+	}
+}
+
 /* Returns an array of filter operation which can be
  * reduced into a single index scan operation. */
 OpFilter **_applicableFilters(NodeByLabelScan *scanOp, Index *idx) {
@@ -332,6 +366,7 @@ OpFilter **_applicableFilters(NodeByLabelScan *scanOp, Index *idx) {
 	while(current->type == OPType_FILTER) {
 		OpFilter *filter = (OpFilter *)current;
 
+		_resolveFilterParams(filter->filterTree);
 		if(_applicableFilter(idx, &filter->filterTree)) {
 			// Make sure all predicates are of type n.v = CONST.
 			filters = array_append(filters, filter);
@@ -377,12 +412,356 @@ void _predicateTreeToRange(const FT_FilterNode *tree, rax *string_ranges, rax *n
 	}
 }
 
+/* Create an ordered index iterator out of a single range object,
+ * returns NULL if the range is invalid. */
+static OrderedIndexIter *_rangeToOrderedIndexIter(GraphContext *gc, const Index *idx,
+												  rax *string_ranges, rax *numeric_ranges) {
+	raxIterator it;
+	OrderedIndexIter *iter = NULL;
+	bool numeric = raxSize(numeric_ranges) == 1;
+	raxStart(&it, numeric ? numeric_ranges : string_ranges);
+	raxSeek(&it, "^", NULL, 0);
+	raxNext(&it);
+
+	char field[1024];
+	sprintf(field, "%.*s", (int)it.key_len, (char *)it.key);
+	Attribute_ID attr = GraphContext_GetAttributeID(gc, field);
+	if(numeric) {
+		NumericRange *nr = it.data;
+		if(NumericRange_IsValid(nr)) iter = OrderedIndex_IterateNumericRange(idx->ordered, attr, nr);
+	} else {
+		StringRange *sr = it.data;
+		if(StringRange_IsValid(sr)) iter = OrderedIndex_IterateStringRange(idx->ordered, attr, sr);
+	}
+	raxStop(&it);
+	return iter;
+}
+
+// Create a stream of the nodes within range of attr.
+static IDStream *_rangeToIDStream(const Index *idx, Attribute_ID attr, void *range, bool numeric) {
+	OrderedIndexIter *iter;
+	if(numeric) {
+		if(!NumericRange_IsValid(range)) return IDStream_NewEmpty();
+		iter = OrderedIndex_IterateNumericRange(idx->ordered, attr, range);
+	} else {
+		if(!StringRange_IsValid(range)) return IDStream_NewEmpty();
+		iter = OrderedIndex_IterateStringRange(idx->ordered, attr, range);
+	}
+
+	// Entries of a single value are ordered by node ID, and don't require sorting.
+	if(OrderedIndexIter_SingleValue(iter)) return IDStream_NewValue(iter);
+	return IDStream_NewRange(iter);
+}
+
+/* Append a stream per ranged attribute to streams,
+ * an attribute ranged over both numerics and strings matches no node. */
+static void _rangesToIDStreams(GraphContext *gc, const Index *idx, rax *string_ranges,
+							   rax *numeric_ranges, IDStream ***streams) {
+	raxIterator it;
+	char field[1024];
+
+	raxStart(&it, numeric_ranges);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		IDStream *s;
+		if(raxFind(string_ranges, it.key, it.key_len) != raxNotFound) {
+			s = IDStream_NewEmpty();
+		} else {
+			sprintf(field, "%.*s", (int)it.key_len, (char *)it.key);
+			s = _rangeToIDStream(idx, GraphContext_GetAttributeID(gc, field), it.data, true);
+		}
+		*streams = array_append(*streams, s);
+	}
+	raxStop(&it);
+
+	raxStart(&it, string_ranges);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		if(raxFind(numeric_ranges, it.key, it.key_len) != raxNotFound) continue;
+		sprintf(field, "%.*s", (int)it.key_len, (char *)it.key);
+		IDStream *s = _rangeToIDStream(idx, GraphContext_GetAttributeID(gc, field), it.data, false);
+		*streams = array_append(*streams, s);
+	}
+	raxStop(&it);
+}
+
+// Create a stream out of given filter tree, as _filterTreeToQueryNode does a query node.
+static IDStream *_filterTreeToIDStream(GraphContext *gc, const Index *idx,
+									   const FT_FilterNode *filter) {
+	switch(filter->t) {
+	case FT_N_COND: {
+		assert(filter->cond.op == OP_OR || filter->cond.op == OP_AND);
+		IDStream **children = array_new(IDStream *, 2);
+		children = array_append(children, _filterTreeToIDStream(gc, idx, filter->cond.left));
+		children = array_append(children, _filterTreeToIDStream(gc, idx, filter->cond.right));
+		if(filter->cond.op == OP_OR) return IDStream_NewUnion(children);
+		return IDStream_NewIntersection(children);
+	}
+	case FT_N_PRED: {
+		rax *string_ranges = raxNew();
+		rax *numeric_ranges = raxNew();
+		IDStream **streams = array_new(IDStream *, 1);
+		_predicateTreeToRange(filter, string_ranges, numeric_ranges);
+		_rangesToIDStreams(gc, idx, string_ranges, numeric_ranges, &streams);
+		raxFreeWithCallback(string_ranges, (void(*)(void *))StringRange_Free);
+		raxFreeWithCallback(numeric_ranges, (void(*)(void *))NumericRange_Free);
+		IDStream *s = streams[0];
+		array_free(streams);
+		return s;
+	}
+	case FT_N_EXP:
+		// Special case: "WHERE a.v in []"
+		return IDStream_NewEmpty();
+	default:
+		assert(false && "unknown filter tree node type");
+		return NULL;
+	}
+}
+
+/* Create a stream of the nodes satisfying every filter, intersecting
+ * the ranges of each attribute and the filter trees by node ID. */
+static IDStream *_filtersToIDStream(GraphContext *gc, const Index *idx, OpFilter **filters,
+									rax *string_ranges, rax *numeric_ranges) {
+	IDStream **streams = array_new(IDStream *, 1);
+	_rangesToIDStreams(gc, idx, string_ranges, numeric_ranges, &streams);
+
+	uint filters_count = array_len(filters);
+	for(uint i = 0; i < filters_count; i++) {
+		const FT_FilterNode *filter_tree = filters[i]->filterTree;
+		if(filter_tree->t == FT_N_PRED) continue;
+		streams = array_append(streams, _filterTreeToIDStream(gc, idx, filter_tree));
+	}
+
+	assert(array_len(streams) > 0);
+	if(array_len(streams) == 1) {
+		IDStream *s = streams[0];
+		array_free(streams);
+		return s;
+	}
+	return IDStream_NewIntersection(streams);
+}
+
+// Estimated fraction of nodes passing every filter in filters.
+static double _filtersSelectivity(OpFilter **filters, uint count, const QueryGraph *qg) {
+	double selectivity = 1;
+	for(uint i = 0; i < count; i++) {
+		selectivity *= FilterTree_Selectivity(filters[i]->filterTree, qg);
+	}
+	return selectivity;
+}
+
+// Returns the first filter in filters over attribute field.
+static OpFilter *_equalityFilterOnField(OpFilter **filters, const char *field) {
+	uint filter_count = array_len(filters);
+	for(uint i = 0; i < filter_count; i++) {
+		const char *prop = filters[i]->filterTree->pred.lhs->operand.variadic.entity_prop;
+		if(strcmp(prop, field) == 0) return filters[i];
+	}
+	return NULL;
+}
+
+/* Try to replace given Label Scan operation and the equality filters over
+ * leading fields of a composite index with a single Index Scan operation.
+ * Returns true if the scan was replaced. */
+static bool _reduceScanToComposite(ExecutionPlan *plan, NodeByLabelScan *scan, Index *idx) {
+	uint composite_count = Index_CompositeCount(idx);
+	if(composite_count == 0 || idx->ordered == NULL) return false;
+
+	// Collect equality filters of the form n.v = CONST.
+	OpFilter **filters = array_new(OpFilter *, 0);
+	OpBase *current = scan->op.parent;
+	while(current && current->type == OPType_FILTER) {
+		OpFilter *filter = (OpFilter *)current;
+		_resolveFilterParams(filter->filterTree);
+		if(filter->filterTree->t == FT_N_PRED && _simple_predicates(filter->filterTree)) {
+			_normalize_filter(&filter->filterTree);
+			const FT_FilterNode *tree = filter->filterTree;
+			if(tree->pred.op == OP_EQUAL && tree->pred.lhs->operand.type == AR_EXP_VARIADIC &&
+			   tree->pred.lhs->operand.variadic.entity_prop &&
+			   strcmp(tree->pred.lhs->operand.variadic.entity_alias, scan->n->alias) == 0) {
+				filters = array_append(filters, filter);
+			}
+		}
+		current = current->parent;
+	}
+
+	// Pick the composite index whose longest prefix of fields is filtered.
+	uint best = 0;
+	uint best_len = 0;
+	for(uint i = 0; i < composite_count; i++) {
+		const IndexComposite *c = idx->composites + i;
+		uint len = 0;
+		while(len < c->fields_count && _equalityFilterOnField(filters, c->fields[len])) len++;
+		if(len > best_len) {
+			best = i;
+			best_len = len;
+		}
+	}
+
+	/* A single filtered field is better served by the field's own index,
+	 * in case the field is indexed. */
+	const IndexComposite *c = idx->composites + best;
+	if(best_len == 0 || (best_len == 1 && Index_ContainsField(idx, c->fields[0]))) {
+		array_free(filters);
+		return false;
+	}
+
+	SIValue values[best_len];
+	OpFilter *consumed[best_len];
+	OpBase *last_filter = NULL;
+	for(uint i = 0; i < best_len; i++) {
+		consumed[i] = _equalityFilterOnField(filters, c->fields[i]);
+		values[i] = consumed[i]->filterTree->pred.rhs->operand.constant;
+	}
+	// The filter highest in the op tree is the last one collected.
+	for(int i = array_len(filters) - 1; i >= 0 && !last_filter; i--) {
+		for(uint j = 0; j < best_len; j++) {
+			if(filters[i] == consumed[j]) last_filter = (OpBase *)filters[i];
+		}
+	}
+
+	OrderedIndexIter *iter = OrderedIndex_IterateTuplePrefix(idx->ordered, best, values, best_len);
+	OpBase *indexOp = NewIndexRangeScanOp(scan->op.plan, scan->g, scan->n, iter);
+	((IndexScan *)indexOp)->selectivity = _filtersSelectivity(consumed, best_len,
+															  plan->query_graph);
+	// In place, replace the highest redundant filter with the new scan op.
+	ExecutionPlan_ReplaceOp(plan, last_filter, indexOp);
+	OpBase_Free(last_filter);
+
+	// Free the remaining redundant filters and the scan op.
+	for(uint i = 0; i < best_len; i++) {
+		if((OpBase *)consumed[i] == last_filter) continue;
+		ExecutionPlan_RemoveOp(plan, (OpBase *)consumed[i]);
+		OpBase_Free((OpBase *)consumed[i]);
+	}
+	ExecutionPlan_RemoveOp(plan, (OpBase *)scan);
+	OpBase_Free((OpBase *)scan);
+
+	array_free(filters);
+	return true;
+}
+
+// Returns true if exp is the node's attribute alias.prop.
+static inline bool _isAttribute(const AR_ExpNode *exp, const char *alias) {
+	return (exp->type == AR_EXP_OPERAND && exp->operand.type == AR_EXP_VARIADIC &&
+			exp->operand.variadic.entity_prop &&
+			strcmp(exp->operand.variadic.entity_alias, alias) == 0);
+}
+
+/* Sets point to the value of exp, a constant point or point() over constants,
+ * returns false if exp is neither. */
+static bool _constantPoint(const AR_ExpNode *exp, SIValue *point) {
+	if(AR_EXP_IsConstant(exp)) {
+		*point = exp->operand.constant;
+		return SI_TYPE(*point) == T_POINT;
+	}
+
+	if(exp->type != AR_EXP_OP || strcasecmp(exp->op.func_name, "point") != 0 ||
+	   exp->op.child_count != 2) return false;
+	const AR_ExpNode *lat = exp->op.children[0];
+	const AR_ExpNode *lon = exp->op.children[1];
+	if(!AR_EXP_IsConstant(lat) || !AR_EXP_IsConstant(lon) ||
+	   !(SI_TYPE(lat->operand.constant) & SI_NUMERIC) ||
+	   !(SI_TYPE(lon->operand.constant) & SI_NUMERIC)) return false;
+
+	double latitude = SI_GET_NUMERIC(lat->operand.constant);
+	double longitude = SI_GET_NUMERIC(lon->operand.constant);
+	// Invalid coordinates are reported once the filter is evaluated.
+	if(!Point_ValidCoordinates(latitude, longitude)) return false;
+	*point = SI_Point(latitude, longitude);
+	return true;
+}
+
+/* Returns true if filter bounds the distance of an indexed point attribute
+ * from a constant point, e.g. distance(n.loc, point(32.07, 34.78)) < 1000,
+ * sets field, center and radius accordingly. */
+static bool _pointRadiusFilter(OpFilter *filter, const Index *idx, const char *alias,
+							   const char **field, SIValue *center, double *radius) {
+	_resolveFilterParams(filter->filterTree);
+	const FT_FilterNode *tree = filter->filterTree;
+	if(tree->t != FT_N_PRED) return false;
+
+	// Distance must be bounded from above, e.g. distance(...) < r or r > distance(...).
+	const AR_ExpNode *distance = tree->pred.lhs;
+	const AR_ExpNode *bound = tree->pred.rhs;
+	int op = tree->pred.op;
+	if(distance->type != AR_EXP_OP) {
+		distance = tree->pred.rhs;
+		bound = tree->pred.lhs;
+		op = ArithmeticOp_ReverseOp(op);
+	}
+	if(op != OP_LT && op != OP_LE) return false;
+	if(!AR_EXP_IsConstant(bound) || !(SI_TYPE(bound->operand.constant) & SI_NUMERIC)) return false;
+	if(distance->type != AR_EXP_OP || strcasecmp(distance->op.func_name, "distance") != 0 ||
+	   distance->op.child_count != 2) return false;
+
+	// Either argument may be the attribute.
+	const AR_ExpNode *attr = distance->op.children[0];
+	const AR_ExpNode *point = distance->op.children[1];
+	if(!_isAttribute(attr, alias)) {
+		attr = distance->op.children[1];
+		point = distance->op.children[0];
+	}
+	if(!_isAttribute(attr, alias) || !Index_ContainsField(idx, attr->operand.variadic.entity_prop)) {
+		return false;
+	}
+	if(!_constantPoint(point, center)) return false;
+
+	*field = attr->operand.variadic.entity_prop;
+	*radius = SI_GET_NUMERIC(bound->operand.constant);
+	return true;
+}
+
+// Create a stream of the nodes whose attr point may lie within radius meters of center.
+static IDStream *_pointRadiusToIDStream(const Index *idx, Attribute_ID attr, SIValue center,
+										double radius) {
+	if(radius < 0) return IDStream_NewEmpty();
+
+	PointBox boxes[2];
+	uint box_count = Point_RadiusBoxes(center, radius, boxes);
+	IDStream **children = array_new(IDStream *, 4);
+	for(uint i = 0; i < box_count; i++) {
+		OrderedIndexIter **iters = OrderedIndex_IteratePointBox(idx->ordered, attr, boxes + i);
+		uint iter_count = array_len(iters);
+		for(uint j = 0; j < iter_count; j++) children = array_append(children, IDStream_NewRange(iters[j]));
+		array_free(iters);
+	}
+	return IDStream_NewUnion(children);
+}
+
+/* Try to replace given Label Scan operation with an Index Scan over the
+ * geohash cells covering a radius filter over an indexed point attribute.
+ * Cells extend past the radius, the filter remains in place and is applied
+ * to the scanned nodes. */
+static void _reduceScanToPointRadius(ExecutionPlan *plan, NodeByLabelScan *scan, Index *idx) {
+	if(idx->ordered == NULL) return;
+
+	OpBase *current = scan->op.parent;
+	while(current && current->type == OPType_FILTER) {
+		const char *field;
+		SIValue center;
+		double radius;
+		if(_pointRadiusFilter((OpFilter *)current, idx, scan->n->alias, &field, &center, &radius)) {
+			GraphContext *gc = QueryCtx_GetGraphCtx();
+			Attribute_ID attr = GraphContext_GetAttributeID(gc, field);
+			IDStream *stream = _pointRadiusToIDStream(idx, attr, center, radius);
+			OpBase *indexOp = NewIndexIDStreamScanOp(scan->op.plan, scan->g, scan->n, stream);
+			ExecutionPlan_ReplaceOp(plan, (OpBase *)scan, indexOp);
+			OpBase_Free((OpBase *)scan);
+			return;
+		}
+		current = current->parent;
+	}
+}
+
 /* Try to replace given Label Scan operation and a set of Filter operations with
  * a single Index Scan operation. */
 void reduce_scan_op(ExecutionPlan *plan, NodeByLabelScan *scan) {
 	RSQNode *root = NULL;
 	uint rsqnode_count = 0;
 	RSQNode **rsqnodes = NULL;
+	OrderedIndexIter *range_iter = NULL;
+	IDStream *id_stream = NULL;
 	rax *string_ranges = NULL;
 	rax *numeric_ranges = NULL;
 
@@ -390,15 +769,22 @@ void reduce_scan_op(ExecutionPlan *plan, NodeByLabelScan *scan) {
 	const char *label = scan->n->label;
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	Index *idx = GraphContext_GetIndex(gc, label, NULL, IDX_EXACT_MATCH);
-	if(idx == NULL) return;
+	// Indices under construction don't serve queries.
+	if(idx == NULL || !Index_IsOperational(idx)) return;
+
+	// Equality over leading composite index fields.
+	if(_reduceScanToComposite(plan, scan, idx)) return;
 
 	// Get all applicable filter for index.
 	RSIndex *rs_idx = idx->idx;
 	OpFilter **filters = _applicableFilters(scan, idx);
 
-	// No filters, return.
+	// No filters, try bounding a point attribute's distance instead.
 	uint filters_count = array_len(filters);
-	if(filters_count == 0) goto cleanup;
+	if(filters_count == 0) {
+		_reduceScanToPointRadius(plan, scan, idx);
+		goto cleanup;
+	}
 
 	/* Reduce filters into ranges.
 	* we differentiate between between numeric filters
@@ -408,19 +794,38 @@ void reduce_scan_op(ExecutionPlan *plan, NodeByLabelScan *scan) {
 	string_ranges = raxNew();
 	numeric_ranges = raxNew();
 
+	uint tree_count = 0;
 	for(uint i = 0; i < filters_count; i++) {
-		OpFilter *filter = filters[i];
-		FT_FilterNode *filter_tree = filter->filterTree;
-
+		FT_FilterNode *filter_tree = filters[i]->filterTree;
 		if(filter_tree->t == FT_N_PRED) {
 			_predicateTreeToRange(filter_tree, string_ranges, numeric_ranges);
 		} else {
-			// OR trees are directly converted into RSQnodes.
-			RSQNode *rsqnode = _filterTreeToQueryNode(filter_tree, rs_idx);
-			rsqnodes = array_append(rsqnodes, rsqnode);
+			tree_count++;
 		}
 	}
 
+	if(idx->ordered) {
+		/* A single range over a single attribute, e.g. n.v = $x or n.v > 1 AND n.v < 5
+		 * is resolved by the ordered index without issuing a RediSearch query. */
+		if(tree_count == 0 && raxSize(string_ranges) + raxSize(numeric_ranges) == 1) {
+			range_iter = _rangeToOrderedIndexIter(gc, idx, string_ranges, numeric_ranges);
+			if(range_iter) goto cleanup;
+		}
+
+		/* Otherwise the ordered index lookups of each attribute and OR tree
+		 * are intersected and united by node ID. */
+		id_stream = _filtersToIDStream(gc, idx, filters, string_ranges, numeric_ranges);
+		goto cleanup;
+	}
+
+	// OR trees are directly converted into RSQnodes.
+	for(uint i = 0; i < filters_count; i++) {
+		FT_FilterNode *filter_tree = filters[i]->filterTree;
+		if(filter_tree->t == FT_N_PRED) continue;
+		RSQNode *rsqnode = _filterTreeToQueryNode(filter_tree, rs_idx);
+		rsqnodes = array_append(rsqnodes, rsqnode);
+	}
+
 	/* Build RediSearch query tree
 	 * Convert each range object to RediSearch query node. */
 	raxIterator it;
@@ -491,12 +896,21 @@ cleanup:
 	if(numeric_ranges) raxFreeWithCallback(numeric_ranges, (void(*)(void *))NumericRange_Free);
 	if(rsqnodes) array_free(rsqnodes);
 
-	if(root) {
-		/* We've successfully created a RediSearch query node that may be used to populate an Index Scan.
-		 * Pass ownership of the root node to the iterator. */
-		RSResultsIterator *iter = RediSearch_GetResultsIterator(root, rs_idx);
-		// Build the Index Scan.
-		OpBase *indexOp = NewIndexScanOp(scan->op.plan, scan->g, scan->n, rs_idx, iter);
+	if(root || range_iter || id_stream) {
+		OpBase *indexOp;
+		if(range_iter) {
+			indexOp = NewIndexRangeScanOp(scan->op.plan, scan->g, scan->n, range_iter);
+		} else if(id_stream) {
+			indexOp = NewIndexIDStreamScanOp(scan->op.plan, scan->g, scan->n, id_stream);
+		} else {
+			/* We've successfully created a RediSearch query node that may be used to populate an Index Scan.
+			 * Pass ownership of the root node to the iterator. */
+			RSResultsIterator *iter = RediSearch_GetResultsIterator(root, rs_idx);
+			// Build the Index Scan.
+			indexOp = NewIndexScanOp(scan->op.plan, scan->g, scan->n, rs_idx, iter);
+		}
+		((IndexScan *)indexOp)->selectivity = _filtersSelectivity(filters, filters_count,
+																  plan->query_graph);
 		/* In place, replace the last redundant filter (highest in the op tree) with the new scan op.
 		 * This ensures that the children array of the scan's parent op does not get shuffled,
 		 * avoiding problems with stream-sensitive ops like SemiApply. */
@@ -518,6 +932,122 @@ cleanup:
 	array_free(filters);
 }
 
+// Returns true if filter is a simple predicate over an indexed attribute of alias.
+static bool _edgeIndexFilter(OpFilter *filter, Index *idx, const char *alias) {
+	_resolveFilterParams(filter->filterTree);
+	if(filter->filterTree->t != FT_N_PRED || !_simple_predicates(filter->filterTree)) return false;
+	_normalize_filter(&filter->filterTree);
+
+	const FT_FilterNode *tree = filter->filterTree;
+	if(tree->pred.op == OP_NEQUAL || tree->pred.lhs->operand.type != AR_EXP_VARIADIC) return false;
+	const char *prop = tree->pred.lhs->operand.variadic.entity_prop;
+	return prop && strcmp(tree->pred.lhs->operand.variadic.entity_alias, alias) == 0 &&
+		   Index_ContainsField(idx, prop);
+}
+
+static inline bool _numericFilter(const OpFilter *filter) {
+	SIValue c = filter->filterTree->pred.rhs->operand.constant;
+	return SI_TYPE(c) & (SI_NUMERIC | T_BOOL);
+}
+
+/* Try to replace a scan of the traversal's source, the traversal and the
+ * filters over an indexed attribute of the traversed edge with a single
+ * Edge Index Scan operation.
+ * The rewrite applies when the source is a label or all node scan which is
+ * not resolved by an index, in which case the edge predicate is the most
+ * selective access path the plan holds. */
+static void _reduceTraversalToEdgeIndex(ExecutionPlan *plan, CondTraverse *traverse) {
+	if(!traverse->setEdge || traverse->op.childCount != 1) return;
+
+	// Source must be introduced by a plain scan.
+	OpBase *scan = traverse->op.children[0];
+	const QGNode *scanned;
+	if(scan->type == OPType_NODE_BY_LABEL_SCAN) scanned = ((NodeByLabelScan *)scan)->n;
+	else if(scan->type == OPType_ALL_NODE_SCAN) scanned = ((AllNodeScan *)scan)->n;
+	else return;
+	if(scan->childCount != 0) return;
+	if(strcmp(scanned->alias, AlgebraicExpression_Source(traverse->ae)) != 0) return;
+
+	// Traversed edge must be a directed single hop of a single indexed relationship type.
+	const char *alias = AlgebraicExpression_Edge(traverse->ae);
+	const QGEdge *e = QueryGraph_GetEdgeByAlias(traverse->op.plan->query_graph, alias);
+	if(e == NULL || e->bidirectional || QGEdge_VariableLength(e)) return;
+	if(array_len(e->reltypeIDs) != 1 || e->reltypeIDs[0] == GRAPH_UNKNOWN_RELATION) return;
+	if(e->src == e->dest) return;
+	// The expression must cover no more than the edge.
+	const char *dest = AlgebraicExpression_Destination(traverse->ae);
+	if(!((strcmp(scanned->alias, e->src->alias) == 0 && strcmp(dest, e->dest->alias) == 0) ||
+		 (strcmp(scanned->alias, e->dest->alias) == 0 && strcmp(dest, e->src->alias) == 0))) return;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Index *idx = GraphContext_GetEdgeIndex(gc, e->reltypes[0], NULL);
+	if(idx == NULL || idx->ordered == NULL || !Index_IsOperational(idx)) return;
+
+	// Collect filters over indexed attributes of the edge.
+	OpFilter **filters = array_new(OpFilter *, 0);
+	OpBase *current = traverse->op.parent;
+	while(current && current->type == OPType_FILTER) {
+		OpFilter *filter = (OpFilter *)current;
+		if(_edgeIndexFilter(filter, idx, alias)) filters = array_append(filters, filter);
+		current = current->parent;
+	}
+	uint filter_count = array_len(filters);
+	if(filter_count == 0) {
+		array_free(filters);
+		return;
+	}
+
+	/* Resolve a single attribute through the index, preferring equality,
+	 * remaining filters are applied to the scanned edges. */
+	OpFilter *chosen = filters[0];
+	for(uint i = 0; i < filter_count; i++) {
+		if(filters[i]->filterTree->pred.op == OP_EQUAL) {
+			chosen = filters[i];
+			break;
+		}
+	}
+	const char *field = chosen->filterTree->pred.lhs->operand.variadic.entity_prop;
+	bool numeric = _numericFilter(chosen);
+
+	rax *string_ranges = raxNew();
+	rax *numeric_ranges = raxNew();
+	OpFilter **consumed = array_new(OpFilter *, 1);
+	for(uint i = 0; i < filter_count; i++) {
+		const FT_FilterNode *tree = filters[i]->filterTree;
+		if(strcmp(tree->pred.lhs->operand.variadic.entity_prop, field) != 0) continue;
+		if(_numericFilter(filters[i]) != numeric) continue;
+		_predicateTreeToRange(tree, string_ranges, numeric_ranges);
+		consumed = array_append(consumed, filters[i]);
+	}
+
+	OrderedIndexIter *iter = _rangeToOrderedIndexIter(gc, idx, string_ranges, numeric_ranges);
+	raxFreeWithCallback(string_ranges, (void(*)(void *))StringRange_Free);
+	raxFreeWithCallback(numeric_ranges, (void(*)(void *))NumericRange_Free);
+
+	if(iter) {
+		OpBase *indexOp = NewEdgeIndexScanOp(traverse->op.plan, traverse->graph, e,
+											 e->reltypeIDs[0], iter);
+		// In place, replace the highest consumed filter with the new scan op.
+		OpBase *last_filter = (OpBase *)array_pop(consumed);
+		ExecutionPlan_ReplaceOp(plan, last_filter, indexOp);
+		OpBase_Free(last_filter);
+
+		// Free the remaining consumed filters, the traversal and the scan op.
+		uint consumed_count = array_len(consumed);
+		for(uint i = 0; i < consumed_count; i++) {
+			ExecutionPlan_RemoveOp(plan, (OpBase *)consumed[i]);
+			OpBase_Free((OpBase *)consumed[i]);
+		}
+		ExecutionPlan_RemoveOp(plan, (OpBase *)traverse);
+		OpBase_Free((OpBase *)traverse);
+		ExecutionPlan_RemoveOp(plan, scan);
+		OpBase_Free(scan);
+	}
+
+	array_free(consumed);
+	array_free(filters);
+}
+
 void utilizeIndices(ExecutionPlan *plan) {
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	// Return immediately if the graph has no indices
@@ -533,7 +1063,15 @@ void utilizeIndices(ExecutionPlan *plan) {
 		reduce_scan_op(plan, scanOp);
 	}
 
+	// Try to resolve traversals through relationship type indices.
+	OpBase **traverseOps = ExecutionPlan_CollectOps(plan->root, OPType_CONDITIONAL_TRAVERSE);
+	uint traverseOpCount = array_len(traverseOps);
+	for(uint i = 0; i < traverseOpCount; i++) {
+		_reduceTraversalToEdgeIndex(plan, (CondTraverse *)traverseOps[i]);
+	}
+
 	// Cleanup
 	array_free(scanOps);
+	array_free(traverseOps);
 }
 
@@ -0,0 +1,330 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "plan_cache.h"
+#include "../util/rmalloc.h"
+#include "../util/rax_extensions.h"
+#include "../ast/cypher_whitelist.h"
+#include "../datatypes/array.h"
+#include "../arithmetic/arithmetic_expression.h"
+#include <ctype.h>
+#include <assert.h>
+#include <strings.h>
+
+// Types of parameter values plans may be specialized for.
+#define PLAN_PARAM_TYPES (SI_NUMERIC | T_STRING | T_BOOL | T_NULL | T_ARRAY)
+
+// Collect the names of all parameters referenced within the AST subtree.
+static void _CollectParamNames(const cypher_astnode_t *root, rax *names) {
+	if(cypher_astnode_type(root) == CYPHER_AST_PARAMETER) {
+		const char *name = cypher_ast_parameter_get_name(root);
+		raxInsert(names, (unsigned char *)name, strlen(name), NULL, NULL);
+		return;
+	}
+	uint child_count = cypher_astnode_nchildren(root);
+	for(uint i = 0; i < child_count; i++) {
+		_CollectParamNames(cypher_astnode_get_child(root, i), names);
+	}
+}
+
+static void _FreeParamValues(SIValue *values) {
+	uint count = array_len(values);
+	for(uint i = 0; i < count; i++) SIValue_Free(values[i]);
+	array_free(values);
+}
+
+Cache *PlanCache_New(void) {
+	return Cache_New(PLAN_CACHE_CAPACITY, CachedPlan_Retain, CachedPlan_Release);
+}
+
+CachedPlan *CachedPlan_New(cypher_parse_result_t *parse_result, AST *ast,
+						   ExecutionPlan *plan, bool readonly) {
+	CachedPlan *cached_plan = rm_malloc(sizeof(CachedPlan));
+	cached_plan->parse_result = parse_result;
+	cached_plan->ast = ast;
+	cached_plan->plan = plan;
+	cached_plan->readonly = readonly;
+	cached_plan->ref_count = 1;
+	cached_plan->plan_params = NULL;
+	cached_plan->param_values = NULL;
+	cached_plan->variant_count = 0;
+	cached_plan->fingerprint = ExecutionPlan_Fingerprint(plan);
+	cached_plan->params = raxNew();
+	_CollectParamNames(ast->root, cached_plan->params);
+	return cached_plan;
+}
+
+void *CachedPlan_Retain(void *cached_plan) {
+	CachedPlan *entry = cached_plan;
+	__atomic_fetch_add(&entry->ref_count, 1, __ATOMIC_RELAXED);
+	return entry;
+}
+
+void CachedPlan_Release(void *cached_plan) {
+	CachedPlan *entry = cached_plan;
+	if(__atomic_sub_fetch(&entry->ref_count, 1, __ATOMIC_RELAXED) > 0) return;
+
+	// The plan references the AST, which references the parse result.
+	ExecutionPlan_Free(entry->plan);
+	AST_Free(entry->ast);
+	parse_result_free(entry->parse_result);
+	raxFree(entry->params);
+	if(entry->plan_params) raxFree(entry->plan_params);
+	if(entry->param_values) _FreeParamValues(entry->param_values);
+	rm_free(entry);
+}
+
+static bool _KeyableValue(SIValue v) {
+	if(!(SI_TYPE(v) & PLAN_PARAM_TYPES)) return false;
+	if(SI_TYPE(v) == T_ARRAY) {
+		uint len = SIArray_Length(v);
+		for(uint i = 0; i < len; i++) {
+			if(!_KeyableValue(SIArray_Get(v, i))) return false;
+		}
+	}
+	return true;
+}
+
+// Values are distinguished by type, a plan specialized for 1 doesn't serve 1.0.
+static uint64_t _HashValue(SIValue v) {
+	uint64_t hash = SI_TYPE(v);
+	if(SI_TYPE(v) == T_ARRAY) {
+		uint len = SIArray_Length(v);
+		for(uint i = 0; i < len; i++) hash = hash * 31 + _HashValue(SIArray_Get(v, i));
+	} else {
+		hash = hash * 31 + SIValue_HashCode(v);
+	}
+	return hash;
+}
+
+static bool _ValuesEqual(SIValue a, SIValue b) {
+	if(SI_TYPE(a) != SI_TYPE(b)) return false;
+	if(SI_TYPE(a) == T_NULL) return true;
+	if(SI_TYPE(a) == T_ARRAY) {
+		uint len = SIArray_Length(a);
+		if(len != SIArray_Length(b)) return false;
+		for(uint i = 0; i < len; i++) {
+			if(!_ValuesEqual(SIArray_Get(a, i), SIArray_Get(b, i))) return false;
+		}
+		return true;
+	}
+	return SIValue_Compare(a, b, NULL) == 0;
+}
+
+/* Evaluate the current query's values of the named parameters, ordered by name.
+ * Returns NULL if a parameter is missing or its value can't key a plan. */
+static SIValue *_EvaluateParams(rax *names) {
+	rax *params = QueryCtx_GetParams();
+	SIValue *values = array_new(SIValue, raxSize(names));
+
+	raxIterator it;
+	raxStart(&it, names);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		AR_ExpNode *exp = raxFind(params, it.key, it.key_len);
+		if(exp == raxNotFound) goto invalid;
+		// Parameter values are constant expressions, values outlive the params parse result.
+		SIValue v = AR_EXP_Evaluate(exp, NULL);
+		values = array_append(values, SI_CloneValue(v));
+		SIValue_Free(v);
+		if(!_KeyableValue(values[array_len(values) - 1])) goto invalid;
+	}
+	raxStop(&it);
+	return values;
+
+invalid:
+	raxStop(&it);
+	_FreeParamValues(values);
+	return NULL;
+}
+
+// Variants are keyed by the query body followed by a hash of their parameter values.
+static char *_VariantKey(const char *body, size_t body_len, const SIValue *values,
+						 size_t *key_len) {
+	uint64_t hash = 0;
+	uint count = array_len(values);
+	for(uint i = 0; i < count; i++) hash = hash * 31 + _HashValue(values[i]);
+
+	*key_len = body_len + 1 + sizeof(hash);
+	char *key = rm_malloc(*key_len);
+	memcpy(key, body, body_len);
+	key[body_len] = '\0';
+	memcpy(key + body_len + 1, &hash, sizeof(hash));
+	return key;
+}
+
+static bool _ParamValuesMatch(const CachedPlan *cached_plan, rax *names, const SIValue *values) {
+	if(raxSize(names) != raxSize(cached_plan->plan_params)) return false;
+	if(!raxIsSubset(names, cached_plan->plan_params)) return false;
+	uint count = array_len(values);
+	for(uint i = 0; i < count; i++) {
+		if(!_ValuesEqual(values[i], cached_plan->param_values[i])) return false;
+	}
+	return true;
+}
+
+bool PlanCache_Add(Cache *cache, const char *body, size_t body_len, CachedPlan *cached_plan,
+				   rax *plan_params) {
+	if(plan_params == NULL) {
+		Cache_SetValue(cache, body, body_len, cached_plan);
+		return true;
+	}
+
+	SIValue *values = _EvaluateParams(plan_params);
+	if(values == NULL) return false;
+
+	CachedPlan *base = Cache_GetValue(cache, body, body_len);
+	if(base) {
+		// Either a generic plan was cached concurrently, or the body has enough variants.
+		bool full = (base->plan_params == NULL) ||
+					__atomic_fetch_add(&base->variant_count, 1, __ATOMIC_RELAXED) >= PLAN_CACHE_MAX_VARIANTS;
+		CachedPlan_Release(base);
+		if(full) {
+			_FreeParamValues(values);
+			return false;
+		}
+	}
+
+	cached_plan->plan_params = raxClone(plan_params);
+	cached_plan->param_values = values;
+
+	// The first variant is also cached under the body, indicating the plans are specialized.
+	if(base == NULL) {
+		cached_plan->variant_count = 1;
+		Cache_SetValue(cache, body, body_len, cached_plan);
+	}
+
+	size_t key_len;
+	char *key = _VariantKey(body, body_len, values, &key_len);
+	Cache_SetValue(cache, key, key_len, cached_plan);
+	rm_free(key);
+	return true;
+}
+
+CachedPlan *PlanCache_GetVariant(Cache *cache, CachedPlan *cached_plan, const char *body,
+								 size_t body_len) {
+	CachedPlan *variant = NULL;
+	SIValue *values = _EvaluateParams(cached_plan->plan_params);
+	if(values == NULL) goto cleanup;
+
+	if(_ParamValuesMatch(cached_plan, cached_plan->plan_params, values)) {
+		variant = CachedPlan_Retain(cached_plan);
+		goto cleanup;
+	}
+
+	size_t key_len;
+	char *key = _VariantKey(body, body_len, values, &key_len);
+	variant = Cache_GetValue(cache, key, key_len);
+	rm_free(key);
+	// Guard against hash collisions.
+	if(variant && !_ParamValuesMatch(variant, cached_plan->plan_params, values)) {
+		CachedPlan_Release(variant);
+		variant = NULL;
+	}
+
+cleanup:
+	if(values) _FreeParamValues(values);
+	CachedPlan_Release(cached_plan);
+	return variant;
+}
+
+static inline const char *_SkipSpaces(const char *s) {
+	while(isspace(*s)) s++;
+	return s;
+}
+
+/* Advance over a single parameter value, respecting quoted strings and nested
+ * lists and maps. Returns NULL if the value isn't terminated. */
+static const char *_SkipParamValue(const char *s) {
+	int depth = 0;
+	while(*s) {
+		char c = *s;
+		if(c == '\'' || c == '"' || c == '`') {
+			// Advance to the closing quote.
+			s++;
+			while(*s && *s != c) {
+				if(*s == '\\' && s[1]) s++;
+				s++;
+			}
+			if(*s == '\0') return NULL;
+		} else if(c == '(' || c == '[' || c == '{') {
+			depth++;
+		} else if(c == ')' || c == ']' || c == '}') {
+			if(--depth < 0) return NULL;
+		} else if(isspace(c) && depth == 0) {
+			break;
+		}
+		s++;
+	}
+	return (depth == 0) ? s : NULL;
+}
+
+bool PlanCache_QueryBodyOffset(const char *query, size_t *offset) {
+	const char *pos = _SkipSpaces(query);
+
+	// Statement options of the form CYPHER name=value name=value ...
+	while(strncasecmp(pos, "CYPHER", 6) == 0 && isspace(pos[6])) {
+		pos = _SkipSpaces(pos + 6);
+		while(isalpha(*pos) || *pos == '_') {
+			const char *end = pos;
+			while(isalnum(*end) || *end == '_') end++;
+			end = _SkipSpaces(end);
+			// Not a parameter, this is the start of the query body.
+			if(*end != '=') break;
+			pos = _SkipParamValue(_SkipSpaces(end + 1));
+			if(pos == NULL) return false;
+			pos = _SkipSpaces(pos);
+		}
+	}
+
+	*offset = pos - query;
+	return true;
+}
+
+bool PlanCache_ParseParams(const CachedPlan *cached_plan, const char *params, size_t len,
+						   cypher_parse_result_t **params_parse_result) {
+	*params_parse_result = NULL;
+	// The query doesn't specify any parameters.
+	if(len == 0) return raxSize(cached_plan->params) == 0;
+
+	cypher_parse_result_t *parse_result = parse_params(params, len);
+	if(parse_result == NULL) return false;
+	if(AST_ContainsErrors(parse_result)) goto invalid;
+
+	const cypher_astnode_t *statement = cypher_parse_result_get_root(parse_result, 0);
+	if(statement == NULL || cypher_astnode_type(statement) != CYPHER_AST_STATEMENT) goto invalid;
+
+	char *reason;
+	if(CypherWhitelist_ValidateQuery(statement, &reason) != AST_VALID) {
+		free(reason);
+		goto invalid;
+	}
+
+	// Make sure parameters are unique and that all referenced parameters are given.
+	bool valid = true;
+	rax *given = raxNew();
+	uint noptions = cypher_ast_statement_noptions(statement);
+	for(uint i = 0; i < noptions && valid; i++) {
+		const cypher_astnode_t *option = cypher_ast_statement_get_option(statement, i);
+		uint nparams = cypher_ast_cypher_option_nparams(option);
+		for(uint j = 0; j < nparams && valid; j++) {
+			const cypher_astnode_t *param = cypher_ast_cypher_option_get_param(option, j);
+			const char *name = cypher_ast_string_get_value(cypher_ast_cypher_option_param_get_name(param));
+			valid = raxInsert(given, (unsigned char *)name, strlen(name), NULL, NULL);
+		}
+	}
+	valid = valid && raxIsSubset(given, cached_plan->params);
+	raxFree(given);
+	if(!valid) goto invalid;
+
+	AST_ExtractParams(parse_result);
+	*params_parse_result = parse_result;
+	return true;
+
+invalid:
+	parse_result_free(parse_result);
+	return false;
+}
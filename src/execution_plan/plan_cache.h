@@ -0,0 +1,72 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "execution_plan.h"
+#include "../ast/ast.h"
+#include "../util/cache/cache.h"
+
+// Maximum number of execution plans cached per graph.
+#define PLAN_CACHE_CAPACITY 25
+
+// Maximum number of plans specialized for parameter values cached per query body.
+#define PLAN_CACHE_MAX_VARIANTS 4
+
+/* A prepared execution plan alongside the AST it was built from.
+ * The cached plan is a template which is never executed directly,
+ * each execution operates on a clone of it. */
+typedef struct {
+	cypher_parse_result_t *parse_result;    // Parse result owning the AST nodes.
+	AST *ast;                               // Master AST of the query.
+	ExecutionPlan *plan;                    // Template execution plan.
+	rax *params;                            // Names of the parameters referenced by the query.
+	rax *plan_params;                       // Parameters the plan is specialized for, NULL for a generic plan.
+	SIValue *param_values;                  // Values of plan_params the plan is specialized for, ordered by name.
+	uint variant_count;                     // Number of specialized plans cached under this plan's query body.
+	uint64_t fingerprint;                   // Fingerprint of the plan, shared by its executions.
+	bool readonly;                          // Query doesn't modify the graph.
+	uint ref_count;                         // Number of references to this entry.
+} CachedPlan;
+
+// Create a new execution plan cache.
+Cache *PlanCache_New(void);
+
+/* Create a cached plan, taking ownership of the parse result, AST and plan.
+ * The returned entry holds a single reference. */
+CachedPlan *CachedPlan_New(cypher_parse_result_t *parse_result, AST *ast,
+						   ExecutionPlan *plan, bool readonly);
+
+/* Cache a plan for a query body. A plan specialized for the values of plan_params
+ * is only reused by queries passing the same values, a few such plans are cached per body.
+ * Returns false if the plan wasn't cached. */
+bool PlanCache_Add(Cache *cache, const char *body, size_t body_len, CachedPlan *cached_plan,
+				   rax *plan_params);
+
+/* Retrieve the plan cached for a query body specialized for the current query's
+ * parameter values, given the plan cached under the body itself, whose reference is consumed.
+ * The current query's parameters must have been parsed.
+ * Returns NULL if no plan is specialized for these values. */
+CachedPlan *PlanCache_GetVariant(Cache *cache, CachedPlan *cached_plan, const char *body,
+								 size_t body_len);
+
+// Acquire an additional reference to a cached plan.
+void *CachedPlan_Retain(void *cached_plan);
+
+// Release a reference to a cached plan, freeing it once no references remain.
+void CachedPlan_Release(void *cached_plan);
+
+/* Locate the query body within the query string, skipping the parameters prefix.
+ * Returns false if the prefix couldn't be scanned. */
+bool PlanCache_QueryBodyOffset(const char *query, size_t *offset);
+
+/* Parse the parameters prefix of a query which is about to reuse a cached plan,
+ * storing the parameters in the query context.
+ * The params parse result, if any, must be freed once the query is done.
+ * Returns false if the parameters are invalid,
+ * in which case the query should be processed without the cache. */
+bool PlanCache_ParseParams(const CachedPlan *cached_plan, const char *params, size_t len,
+						   cypher_parse_result_t **params_parse_result);
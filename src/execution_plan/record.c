@@ -84,6 +84,16 @@ void Record_TransferEntries(Record *to, Record from) {
 	}
 }
 
+void Record_Inherit(Record a, const Record b) {
+	uint len = Record_length(b);
+	for(uint i = 0; i < len; i++) {
+		if(a->entries[i].type != REC_TYPE_UNKNOWN) continue;
+		if(b->entries[i].type == REC_TYPE_UNKNOWN) continue;
+		a->entries[i] = b->entries[i];
+		if(a->entries[i].type == REC_TYPE_SCALAR) SIValue_MakeVolatile(&a->entries[i].value.s);
+	}
+}
+
 RecordEntryType Record_GetType(const Record r, int idx) {
 	return r->entries[idx].type;
 }
@@ -169,6 +179,13 @@ void Record_PersistScalars(Record r) {
 	}
 }
 
+void Record_PersistBorrowedScalars(Record r) {
+	uint len = Record_length(r);
+	for(uint i = 0; i < len; i++) {
+		if(r->entries[i].type == REC_TYPE_SCALAR) SIValue_PersistBorrowed(&r->entries[i].value.s);
+	}
+}
+
 size_t Record_ToString(const Record r, char **buf, size_t *buf_cap) {
 	uint rLen = Record_length(r);
 	SIValue values[rLen];
@@ -246,6 +263,11 @@ unsigned long long Record_Hash64(const Record r) {
 				len = sizeof(si.doubleval);
 				break;
 
+			case T_POINT:
+				data = &si.point;
+				len = sizeof(si.point);
+				break;
+
 			default:
 				assert(false);
 			}
@@ -52,6 +52,9 @@ void Record_Merge(Record *a, const Record b);
 // Merge record b into a, transfer value ownership from b to a.
 void Record_TransferEntries(Record *to, Record from);
 
+// Set the entries of a which are unset to those of b, a borrows rather than owns b's scalars.
+void Record_Inherit(Record a, const Record b);
+
 // Returns number of entries record can hold.
 uint Record_length(const Record r);
 
@@ -91,6 +94,9 @@ void Record_AddEdge(Record r, int idx, Edge edge);
 // Ensure that all scalar values in record are access-safe.
 void Record_PersistScalars(Record r);
 
+// Ensure that scalar values borrowed from graph entities outlive modifications to the graph.
+void Record_PersistBorrowedScalars(Record r);
+
 // String representation of record.
 size_t Record_ToString(const Record r, char **buf, size_t *buf_cap);
 
@@ -0,0 +1,57 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "record_pool.h"
+#include "record.h"
+#include <assert.h>
+
+// Number of entries a record of size class c holds.
+#define CLASS_ENTRIES(c) (4u << (c))
+
+typedef struct {
+	ObjectPool *pools[RECORD_POOL_IDLE_CAP];    // Released pools.
+	uint count;                                 // Number of released pools.
+} RecordPoolClass;
+
+static __thread RecordPoolClass _idle[RECORD_POOL_CLASSES];
+
+// Returns the size class of records holding entries_count entries, -1 if unpooled.
+static int _RecordPool_Class(uint entries_count) {
+	for(int c = 0; c < RECORD_POOL_CLASSES; c++) {
+		if(entries_count <= CLASS_ENTRIES(c)) return c;
+	}
+	return -1;
+}
+
+ObjectPool *RecordPool_Acquire(uint entries_count) {
+	int c = _RecordPool_Class(entries_count);
+	if(c < 0) {
+		return ObjectPool_New(256, sizeof(_Record) + (sizeof(Entry) * entries_count),
+							  (void (*)(void *))Record_FreeEntries);
+	}
+
+	RecordPoolClass *cls = _idle + c;
+	if(cls->count > 0) return cls->pools[--cls->count];
+	return ObjectPool_New(256, sizeof(_Record) + (sizeof(Entry) * CLASS_ENTRIES(c)),
+						  (void (*)(void *))Record_FreeEntries);
+}
+
+void RecordPool_Release(ObjectPool *pool) {
+	assert(pool);
+	uint entries_count = (ObjectPool_ItemSize(pool) - sizeof(_Record)) / sizeof(Entry);
+	int c = _RecordPool_Class(entries_count);
+	RecordPoolClass *cls = (c < 0) ? NULL : _idle + c;
+
+	// Records outliving their plan keep their pool from being reused.
+	if(cls == NULL || cls->count == RECORD_POOL_IDLE_CAP || pool->itemCount > 0) {
+		ObjectPool_Free(pool);
+		return;
+	}
+
+	// Bound the memory retained after a query that produced many records at once.
+	ObjectPool_Trim(pool, RECORD_POOL_TRIM_CAP);
+	cls->pools[cls->count++] = pool;
+}
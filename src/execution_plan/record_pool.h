@@ -0,0 +1,27 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../util/object_pool/object_pool.h"
+
+// Number of record size classes, holding up to 4, 8, 16, 32 and 64 entries.
+#define RECORD_POOL_CLASSES 5
+// Number of released pools retained per size class by each thread.
+#define RECORD_POOL_IDLE_CAP 4
+// Number of records a released pool retains room for, blocks beyond are freed.
+#define RECORD_POOL_TRIM_CAP 1024
+
+/* Record pools are retained by the thread which released them, for reuse by
+ * the thread's following queries, sparing short queries the setup and teardown
+ * of a pool per execution plan. A pool is used by a single execution plan at a time,
+ * and as such may be released by a thread other than the one which acquired it. */
+
+// Acquire a pool of records holding entries_count entries.
+ObjectPool *RecordPool_Acquire(uint entries_count);
+
+// Release a pool acquired by RecordPool_Acquire, pools still holding records are freed.
+void RecordPool_Release(ObjectPool *pool);
@@ -0,0 +1,318 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "expiry.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/temporal_value.h"
+#include "../change_feed/change_feed.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <pthread.h>
+
+// Global array tracking all extant GraphContexts (defined in module.c)
+extern GraphContext **graphs_in_keyspace;
+
+// A sweep over the expiring schemas of a graph, resumed by each step.
+typedef struct {
+	GraphContext *gc;   // Swept graph.
+	int64_t now;        // Time the sweep started at, in milliseconds since epoch.
+	uint schema;        // Swept schema, node schemas followed by relation schemas.
+	EntityID cursor;    // Node, or source node of the edges, the schema's scan resumes at.
+	uint64_t scanned;   // Number of entities examined by the current step.
+	Node *nodes;        // Expired nodes collected by the current step.
+	Edge *edges;        // Expired edges collected by the current step.
+	uint *expiring;     // Schemas the current step collected expired entities of, in sweep order.
+	int replicated;     // Last schema whose deletion was replicated, -1 if none.
+	bool partial;       // The current step ended in the midst of a schema.
+} ExpirySweep;
+
+static inline bool _Expiry_StepFull(const ExpirySweep *sweep) {
+	return (sweep->scanned >= EXPIRY_SCAN_LIMIT ||
+			array_len(sweep->nodes) + array_len(sweep->edges) >= EXPIRY_BATCH_SIZE);
+}
+
+// Entities expire once the timestamp under attr is no later than cutoff.
+static inline bool _Expiry_Expired(const GraphEntity *e, Attribute_ID attr, int64_t cutoff) {
+	SIValue *v = GraphEntity_GetProperty(e, attr);
+	if(v == PROPERTY_NOTFOUND || !(SI_TYPE(*v) & SI_NUMERIC)) return false;
+	return SI_GET_NUMERIC(*v) <= cutoff;
+}
+
+// Records the swept schema as holding expired entities collected by the current step.
+static inline void _Expiry_MarkExpiring(ExpirySweep *sweep) {
+	uint count = array_len(sweep->expiring);
+	if(count > 0 && sweep->expiring[count - 1] == sweep->schema) return;
+	sweep->expiring = array_append(sweep->expiring, sweep->schema);
+}
+
+/* Collects the expired nodes of schema, resuming past the last examined node.
+ * Returns true once the schema's nodes were scanned through. */
+static bool _Expiry_CollectNodes(ExpirySweep *sweep, const Schema *s, Attribute_ID attr,
+								 int64_t cutoff) {
+	Graph *g = sweep->gc->g;
+	Node node;
+	NodeID node_id;
+	bool depleted = false;
+	IDSetIterator it;
+	IDSet_IterateRange(Graph_GetLabelIDs(g, s->id), &it, sweep->cursor, UINT64_MAX);
+	while(!_Expiry_StepFull(sweep)) {
+		depleted = !IDSetIterator_Next(&it, &node_id);
+		if(depleted) break;
+
+		Graph_GetNode(g, node_id, &node);
+		if(_Expiry_Expired((GraphEntity *)&node, attr, cutoff)) {
+			_Expiry_MarkExpiring(sweep);
+			sweep->nodes = array_append(sweep->nodes, node);
+		}
+		sweep->cursor = node_id + 1;
+		sweep->scanned++;
+	}
+	return depleted;
+}
+
+/* Collects the expired edges of schema, resuming at the first pair of the cursor's row.
+ * Steps end in between rows, such that the edges of a row are examined by a single step.
+ * Returns true once the schema's edges were scanned through. */
+static bool _Expiry_CollectEdges(ExpirySweep *sweep, const Schema *s, Attribute_ID attr,
+								 int64_t cutoff) {
+	Graph *g = sweep->gc->g;
+	GrB_Index nrows;
+	GrB_Matrix relation_matrix = Graph_GetRelationMatrix(g, s->id);
+	GrB_Matrix_nrows(&nrows, relation_matrix);
+	if(sweep->cursor >= nrows) return true;
+
+	NodeID src_id;
+	NodeID dest_id;
+	bool depleted = false;
+	Edge *connecting = array_new(Edge, 1);
+	GxB_MatrixTupleIter *it;
+	GxB_MatrixTupleIter_new(&it, relation_matrix);
+	GxB_MatrixTupleIter_iterate_range(it, sweep->cursor, nrows - 1);
+	while(true) {
+		GxB_MatrixTupleIter_next(it, &src_id, &dest_id, &depleted);
+		if(depleted) break;
+		if(src_id != sweep->cursor) {
+			sweep->cursor = src_id;
+			if(_Expiry_StepFull(sweep)) break;
+		}
+
+		Graph_GetEdgesConnectingNodes(g, src_id, dest_id, s->id, &connecting);
+		uint edge_count = array_len(connecting);
+		for(uint i = 0; i < edge_count; i++) {
+			Edge *e = connecting + i;
+			if(_Expiry_Expired((GraphEntity *)e, attr, cutoff)) {
+				_Expiry_MarkExpiring(sweep);
+				sweep->edges = array_append(sweep->edges, *e);
+			}
+		}
+		sweep->scanned += edge_count;
+		array_clear(connecting);
+	}
+	GxB_MatrixTupleIter_free(it);
+	array_free(connecting);
+	return depleted;
+}
+
+/* Collects expired entities until either the step is full or every schema was scanned through.
+ * Returns true once the sweep is done, expects the read lock. */
+static bool _Expiry_Collect(ExpirySweep *sweep) {
+	GraphContext *gc = sweep->gc;
+	uint label_count = array_len(gc->node_schemas);
+	uint schema_count = label_count + array_len(gc->relation_schemas);
+	sweep->scanned = 0;
+
+	while(sweep->schema < schema_count && !_Expiry_StepFull(sweep)) {
+		bool node_schema = (sweep->schema < label_count);
+		Schema *s = (node_schema) ? gc->node_schemas[sweep->schema] :
+					gc->relation_schemas[sweep->schema - label_count];
+
+		bool depleted = true;
+		Attribute_ID attr = (Schema_HasExpiry(s)) ?
+							GraphContext_GetAttributeID(gc, s->ttl_attribute) : ATTRIBUTE_NOTFOUND;
+		if(attr != ATTRIBUTE_NOTFOUND) {
+			int64_t cutoff = sweep->now - (int64_t)s->ttl * 1000;
+			depleted = (node_schema) ? _Expiry_CollectNodes(sweep, s, attr, cutoff) :
+					   _Expiry_CollectEdges(sweep, s, attr, cutoff);
+		}
+
+		if(depleted) {
+			sweep->schema++;
+			sweep->cursor = 0;
+		}
+		sweep->partial = !depleted;
+	}
+
+	return sweep->schema >= schema_count;
+}
+
+/* Replicates the deletion of the expired entities of the schemas the current step collected from,
+ * as queries selecting entities by their schema's timestamp attribute and the sweep's cutoff.
+ * Entity IDs aren't replicated, as they differ between a master and its replicas once
+ * the graph is compacted by persistence. Each schema is replicated once per sweep, ahead of
+ * the first deletion from it, such that replicas delete all of the schema's expired entities
+ * at once, while the master deletes them step by step. No other writer enters the graph
+ * before the master is done with the schema, the entities deleted are the same.
+ * The write version advances per replicated query, as it does on replicas applying them. */
+static void _Expiry_Replicate(RedisModuleCtx *ctx, ExpirySweep *sweep) {
+	GraphContext *gc = sweep->gc;
+	uint label_count = array_len(gc->node_schemas);
+	uint expiring_count = array_len(sweep->expiring);
+	for(uint i = 0; i < expiring_count; i++) {
+		uint schema = sweep->expiring[i];
+		if((int)schema <= sweep->replicated) continue;
+		sweep->replicated = schema;
+
+		bool node_schema = (schema < label_count);
+		Schema *s = (node_schema) ? gc->node_schemas[schema] :
+					gc->relation_schemas[schema - label_count];
+		long long cutoff = sweep->now - (int64_t)s->ttl * 1000;
+		char *query;
+		if(node_schema) {
+			asprintf(&query, "MATCH (n:`%s`) WHERE n.`%s` <= %lld DETACH DELETE n", s->name,
+					 s->ttl_attribute, cutoff);
+		} else {
+			asprintf(&query, "MATCH ()-[e:`%s`]->() WHERE e.`%s` <= %lld DELETE e", s->name,
+					 s->ttl_attribute, cutoff);
+		}
+		RedisModule_Replicate(ctx, "GRAPH.QUERY", "cc!", gc->graph_name, query);
+		GraphContext_AdvanceWriteVersion(gc);
+		free(query);
+	}
+}
+
+// Deletes the collected entities, expects the write lock.
+static void _Expiry_Delete(RedisModuleCtx *ctx, ExpirySweep *sweep) {
+	GraphContext *gc = sweep->gc;
+
+	// A node carrying several expiring labels is collected once per label.
+	uint node_count = array_len(sweep->nodes);
+#define is_node_lt(a, b) (ENTITY_GET_ID((a)) < ENTITY_GET_ID((b)))
+	QSORT(Node, sweep->nodes, node_count, is_node_lt);
+	uint unique = 0;
+	for(uint i = 0; i < node_count; i++) {
+		if(unique > 0 && ENTITY_GET_ID(sweep->nodes + i) == ENTITY_GET_ID(sweep->nodes + unique - 1)) {
+			continue;
+		}
+		sweep->nodes[unique++] = sweep->nodes[i];
+	}
+	node_count = unique;
+	uint edge_count = array_len(sweep->edges);
+
+	if(GraphContext_HasIndices(gc)) {
+		for(uint i = 0; i < node_count; i++) GraphContext_DeleteNodeFromIndices(gc, sweep->nodes + i);
+		for(uint i = 0; i < edge_count; i++) GraphContext_DeleteEdgeFromIndices(gc, sweep->edges + i);
+	}
+	for(uint i = 0; i < node_count; i++) GraphContext_RemoveNodeFromStatistics(gc, sweep->nodes + i);
+
+	_Expiry_Replicate(ctx, sweep);
+	if(gc->changes) {
+		for(uint i = 0; i < edge_count; i++) ChangeFeed_EdgeDeleted(sweep->edges + i);
+		for(uint i = 0; i < node_count; i++) ChangeFeed_NodeDeleted(sweep->nodes + i);
+		ChangeFeed_Commit(ctx, gc->changes, GraphContext_GetWriteVersion(gc));
+	}
+
+	uint node_deleted = 0;
+	uint edge_deleted = 0;
+	Graph_BulkDelete(gc->g, sweep->nodes, node_count, sweep->edges, edge_count, &node_deleted,
+					 &edge_deleted);
+}
+
+// Graphs are swept by masters only, replicas apply the replicated deletions.
+static inline bool _Expiry_Enabled(RedisModuleCtx *ctx) {
+	int flags = RedisModule_GetContextFlags(ctx);
+	return !(flags & (REDISMODULE_CTX_FLAGS_SLAVE | REDISMODULE_CTX_FLAGS_LOADING));
+}
+
+void Expiry_Reap(void *arg) {
+	GraphContext *gc = arg;
+	Graph *g = gc->g;
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	QueryCtx_SetGraphCtx(gc);
+
+	ExpirySweep sweep = {
+		.gc = gc,
+		.now = TemporalValue_NewTimestamp(),
+		.schema = 0,
+		.cursor = 0,
+		.scanned = 0,
+		.nodes = array_new(Node, 32),
+		.edges = array_new(Edge, 32),
+		.expiring = array_new(uint, 4),
+		.replicated = -1,
+		.partial = false,
+	};
+
+	// Clear flag prior to sweeping, the reaper reschedules the graph once the sweep is done.
+	__atomic_store_n(&gc->expiry_scheduled, false, __ATOMIC_RELAXED);
+
+	bool done = false;
+	while(!done) {
+		/* Entities collected under the read lock remain valid as long as no other writer enters.
+		 * Writers are held off until a schema is swept through, as its deletion is replicated at once. */
+		if(!sweep.partial) Graph_WriterEnter(g);
+		Graph_AcquireReadLock(g);
+		Graph_SetMatrixPolicy(g, SYNC_AND_MINIMIZE_SPACE);
+		done = _Expiry_Collect(&sweep);
+		Graph_ReleaseLock(g);
+
+		if(array_len(sweep.nodes) + array_len(sweep.edges) > 0) {
+			RedisModule_ThreadSafeContextLock(ctx);
+			// Stop once the graph is deleted, or the server turned into a replica.
+			if(!GraphContext_InKeyspace(gc) || !_Expiry_Enabled(ctx)) {
+				done = true;
+			} else {
+				Graph_AcquireWriteLock(g);
+				_Expiry_Delete(ctx, &sweep);
+				Graph_ReleaseLock(g);
+				GraphContext_ScheduleSynchronization(gc);
+				GraphContext_ScheduleChangeFeed(gc);
+			}
+			RedisModule_ThreadSafeContextUnlock(ctx);
+			array_clear(sweep.nodes);
+			array_clear(sweep.edges);
+			array_clear(sweep.expiring);
+		}
+		if(done || !sweep.partial) Graph_WriterLeave(g);
+	}
+
+	array_free(sweep.nodes);
+	array_free(sweep.edges);
+	array_free(sweep.expiring);
+	RedisModule_FreeThreadSafeContext(ctx);
+	QueryCtx_Free();
+	GraphContext_Release(gc);
+}
+
+// Runs on a dedicated thread, schedules a sweep of every graph holding expiring entities.
+static void *_Expiry_Reaper(void *arg) {
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	while(true) {
+		sleep(EXPIRY_INTERVAL);
+		RedisModule_ThreadSafeContextLock(ctx);
+		if(_Expiry_Enabled(ctx)) {
+			uint graph_count = array_len(graphs_in_keyspace);
+			for(uint i = 0; i < graph_count; i++) {
+				GraphContext *gc = graphs_in_keyspace[i];
+				if(GraphContext_HasExpiry(gc)) GraphContext_ScheduleExpiry(gc);
+			}
+		}
+		RedisModule_ThreadSafeContextUnlock(ctx);
+	}
+	return NULL;
+}
+
+bool Expiry_StartReaper(void) {
+	pthread_t thread;
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	int res = pthread_create(&thread, &attr, _Expiry_Reaper, NULL);
+	pthread_attr_destroy(&attr);
+	return res == 0;
+}
@@ -0,0 +1,27 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include "../graph/graphcontext.h"
+
+// Seconds between consecutive sweeps of the graphs holding expiring entities.
+#define EXPIRY_INTERVAL 1
+// Maximum number of entities examined by a single reaping step.
+#define EXPIRY_SCAN_LIMIT 16384
+// Maximum number of expired entities deleted by a single reaping step.
+#define EXPIRY_BATCH_SIZE 1000
+
+/* Spawns the reaper, a thread which periodically schedules the graphs holding
+ * expiring entities to be swept, replicas rely on their master's sweeps.
+ * Returns false if the thread couldn't be spawned. */
+bool Expiry_StartReaper(void);
+
+/* Runs on a thread pool thread, deletes the graph's expired entities in steps.
+ * Each step scans a bounded number of entities under the read lock and deletes
+ * the expired ones under the write lock, readers and writers proceed in between steps. */
+void Expiry_Reap(void *arg);
@@ -221,6 +221,155 @@ int FilterTree_applyFilters(const FT_FilterNode *root, const Record r) {
 	return 0;
 }
 
+/* Compares a column of integers against an integer,
+ * consistent with SIValue_Compare. */
+static void _applyIntegerColumn(const SIValue *col, int64_t v, AST_Operator op, uint8_t *pass,
+								uint count) {
+	switch(op) {
+	case OP_EQUAL:
+		for(uint i = 0; i < count; i++) pass[i] = (col[i].longval - v) == 0;
+		break;
+	case OP_NEQUAL:
+		for(uint i = 0; i < count; i++) pass[i] = (col[i].longval - v) != 0;
+		break;
+	case OP_GT:
+		for(uint i = 0; i < count; i++) pass[i] = (col[i].longval - v) > 0;
+		break;
+	case OP_GE:
+		for(uint i = 0; i < count; i++) pass[i] = (col[i].longval - v) >= 0;
+		break;
+	case OP_LT:
+		for(uint i = 0; i < count; i++) pass[i] = (col[i].longval - v) < 0;
+		break;
+	case OP_LE:
+		for(uint i = 0; i < count; i++) pass[i] = (col[i].longval - v) <= 0;
+		break;
+	default:
+		assert(0);
+	}
+}
+
+/* Compares a column of doubles against a number,
+ * consistent with SIValue_Compare. */
+static void _applyDoubleColumn(const SIValue *col, double v, AST_Operator op, uint8_t *pass,
+							   uint count) {
+	switch(op) {
+	case OP_EQUAL:
+		for(uint i = 0; i < count; i++) pass[i] = !((col[i].doubleval - v) > 0 || (col[i].doubleval - v) < 0);
+		break;
+	case OP_NEQUAL:
+		for(uint i = 0; i < count; i++) pass[i] = (col[i].doubleval - v) > 0 || (col[i].doubleval - v) < 0;
+		break;
+	case OP_GT:
+		for(uint i = 0; i < count; i++) pass[i] = (col[i].doubleval - v) > 0;
+		break;
+	case OP_GE:
+		for(uint i = 0; i < count; i++) pass[i] = !((col[i].doubleval - v) < 0);
+		break;
+	case OP_LT:
+		for(uint i = 0; i < count; i++) pass[i] = (col[i].doubleval - v) < 0;
+		break;
+	case OP_LE:
+		for(uint i = 0; i < count; i++) pass[i] = !((col[i].doubleval - v) > 0);
+		break;
+	default:
+		assert(0);
+	}
+}
+
+/* Evaluates a predicate over a batch, the left hand-side is extracted into a column,
+ * when compared against a constant number, columns of a single numeric type
+ * are compared in a tight loop. */
+static uint _applyPredicateBatch(const FT_FilterNode *root, const Record *records, uint *sel,
+								 uint count) {
+	SIValue lhs[count];
+	uint8_t pass[count];
+	bool constant = AR_EXP_IsConstant(root->pred.rhs);
+	SIValue rhs = constant ? root->pred.rhs->operand.constant : SI_NullVal();
+
+	SIType types = 0;
+	for(uint i = 0; i < count; i++) {
+		lhs[i] = AR_EXP_Evaluate(root->pred.lhs, records[sel[i]]);
+		types |= SI_TYPE(lhs[i]);
+	}
+
+	if(constant && types == T_INT64 && SI_TYPE(rhs) == T_INT64) {
+		_applyIntegerColumn(lhs, rhs.longval, root->pred.op, pass, count);
+	} else if(constant && types == T_DOUBLE && (SI_TYPE(rhs) & SI_NUMERIC)) {
+		_applyDoubleColumn(lhs, SI_GET_NUMERIC(rhs), root->pred.op, pass, count);
+	} else {
+		for(uint i = 0; i < count; i++) {
+			SIValue v = constant ? rhs : AR_EXP_Evaluate(root->pred.rhs, records[sel[i]]);
+			pass[i] = _applyFilter(lhs + i, &v, root->pred.op);
+			if(!constant) SIValue_Free(v);
+		}
+	}
+
+	// Compact the selection.
+	uint n = 0;
+	for(uint i = 0; i < count; i++) {
+		SIValue_Free(lhs[i]);
+		sel[n] = sel[i];
+		n += pass[i];
+	}
+	return n;
+}
+
+uint FilterTree_applyBatchFilters(const FT_FilterNode *root, const Record *records, uint *sel,
+								  uint count) {
+	if(count == 0) return 0;
+
+	switch(root->t) {
+	case FT_N_COND: {
+		if(root->cond.op == OP_AND) {
+			// Only records passing the left subtree visit the right subtree.
+			uint n = FilterTree_applyBatchFilters(LeftChild(root), records, sel, count);
+			return FilterTree_applyBatchFilters(RightChild(root), records, sel, n);
+		}
+
+		assert(root->cond.op == OP_OR);
+		// Only records failing the left subtree visit the right subtree.
+		uint left[count];
+		uint right[count];
+		memcpy(left, sel, sizeof(uint) * count);
+		uint left_count = FilterTree_applyBatchFilters(LeftChild(root), records, left, count);
+		uint right_count = 0;
+		for(uint i = 0, j = 0; i < count; i++) {
+			if(j < left_count && left[j] == sel[i]) j++;
+			else right[right_count++] = sel[i];
+		}
+		right_count = FilterTree_applyBatchFilters(RightChild(root), records, right, right_count);
+
+		// Merge both passing sets, which are ordered subsets of sel.
+		uint n = 0;
+		for(uint i = 0, j = 0, k = 0; i < count; i++) {
+			if(j < left_count && left[j] == sel[i]) {
+				sel[n++] = left[j++];
+			} else if(k < right_count && right[k] == sel[i]) {
+				sel[n++] = right[k++];
+			}
+		}
+		return n;
+	}
+	case FT_N_PRED:
+		return _applyPredicateBatch(root, records, sel, count);
+	case FT_N_EXP: {
+		uint n = 0;
+		for(uint i = 0; i < count; i++) {
+			uint idx = sel[i];
+			sel[n] = idx;
+			n += FilterTree_applyFilters(root, records[idx]);
+		}
+		return n;
+	}
+	default:
+		assert(false);
+	}
+
+	// We shouldn't be here.
+	return 0;
+}
+
 void _FilterTree_CollectModified(const FT_FilterNode *root, rax *modified) {
 	if(root == NULL) return;
 
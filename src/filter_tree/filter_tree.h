@@ -11,6 +11,7 @@
 #include "../ast/ast_shared.h"
 #include "rax.h"
 #include "../execution_plan/record.h"
+#include "../graph/query_graph.h"
 #include "../arithmetic/arithmetic_expression.h"
 
 #define FILTER_FAIL 0
@@ -85,6 +86,36 @@ FT_FilterNode *FilterTree_CreateConditionFilter(AST_Operator op);
 /* Runs val through the filter tree. */
 int FilterTree_applyFilters(const FT_FilterNode *root, const Record r);
 
+/* Runs a batch of records through the filter tree, a predicate at a time.
+ * sel holds the indices within records of the count records to evaluate,
+ * on return it holds the indices of the passing records, in order,
+ * and their number is returned. */
+uint FilterTree_applyBatchFilters(const FT_FilterNode *root, const Record *records, uint *sel,
+								  uint count);
+
+/* filter_tree_order.c
+ * Estimates and ordering of filter tree operands. */
+
+/* Estimates the fraction of records passing the tree,
+ * node attributes are estimated by their label statistics when qg is given. */
+double FilterTree_Selectivity(const FT_FilterNode *root, const QueryGraph *qg);
+
+/* Estimates the cost of running a record through the tree,
+ * in units of a property access. */
+double FilterTree_Cost(const FT_FilterNode *root, const QueryGraph *qg);
+
+/* Ranks an operand of an op condition, operands of lower rank
+ * should be evaluated first. */
+double FilterTree_Rank(double cost, double pass_rate, AST_Operator op);
+
+/* Reorders the operands of every AND and OR chain within the tree
+ * such that cheap operands likely to decide the condition are evaluated first. */
+void FilterTree_Reorder(FT_FilterNode *root, const QueryGraph *qg);
+
+/* Returns the operands of the AND chain rooted at root, in evaluation order,
+ * root itself when it isn't an AND condition. */
+FT_FilterNode **FilterTree_Conjuncts(FT_FilterNode *root);
+
 /* Extract every modified record ID mentioned in the tree
  * without duplications. */
 rax *FilterTree_CollectModified(const FT_FilterNode *root);
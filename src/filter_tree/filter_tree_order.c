@@ -0,0 +1,265 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "filter_tree.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../schema/schema.h"
+#include "../graph/graphcontext.h"
+#include <math.h>
+#include <string.h>
+#include <strings.h>
+#include <assert.h>
+
+// Selectivities assumed in the absence of statistics.
+#define SELECTIVITY_EQUAL 0.1
+#define SELECTIVITY_RANGE 0.33
+#define SELECTIVITY_DEFAULT 0.5
+#define SELECTIVITY_STRING 0.2
+// Number of histogram buckets consulted for range predicates.
+#define SELECTIVITY_BUCKETS 16
+
+// Cost of a function call, in units of a property access.
+static double _FuncCost(const AR_ExpNode *exp) {
+	const char *func = exp->op.func_name;
+	// Pattern predicates evaluate a traversal.
+	if(!strcasecmp(func, "path_filter")) return 1000;
+	if(!strcasecmp(func, "in")) {
+		// Membership scans the list.
+		const AR_ExpNode *list = exp->op.children[1];
+		if(AR_EXP_IsConstant(list) && SI_TYPE(list->operand.constant) == T_ARRAY) {
+			return 2 + SIArray_Length(list->operand.constant);
+		}
+		return 16;
+	}
+	if(!strcasecmp(func, "contains") || !strcasecmp(func, "starts with") ||
+	   !strcasecmp(func, "ends with") || !strcasecmp(func, "toLower") ||
+	   !strcasecmp(func, "toUpper") || !strcasecmp(func, "replace") ||
+	   !strcasecmp(func, "split") || !strcasecmp(func, "substring")) return 4;
+	return 1;
+}
+
+static double _ExpCost(const AR_ExpNode *exp) {
+	if(exp->type == AR_EXP_OPERAND) {
+		if(exp->operand.type == AR_EXP_VARIADIC && exp->operand.variadic.entity_prop) return 1;
+		return 0;
+	}
+
+	double cost = (exp->op.type == AR_OP_FUNC) ? _FuncCost(exp) : 1;
+	for(int i = 0; i < exp->op.child_count; i++) cost += _ExpCost(exp->op.children[i]);
+	return cost;
+}
+
+/* Returns the statistics of the attribute exp accesses when exp is a property
+ * of a labeled node in qg with valid statistics, sets the fraction of the label's
+ * nodes holding the attribute, numerically if numeric is set. */
+static const AttributeStats *_AttributeStats(const AR_ExpNode *exp, const QueryGraph *qg,
+											 bool numeric, double *fraction) {
+	if(qg == NULL || exp->type != AR_EXP_OPERAND || exp->operand.type != AR_EXP_VARIADIC ||
+	   exp->operand.variadic.entity_prop == NULL) return NULL;
+
+	QGNode *n = QueryGraph_GetNodeByAlias(qg, exp->operand.variadic.entity_alias);
+	if(n == NULL || n->label == NULL) return NULL;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchema(gc, n->label, SCHEMA_NODE);
+	if(s == NULL || !s->stats->valid) return NULL;
+
+	Attribute_ID attr = GraphContext_GetAttributeID(gc, exp->operand.variadic.entity_prop);
+	if(attr == ATTRIBUTE_NOTFOUND) return NULL;
+	const AttributeStats *stats = SchemaStats_GetAttribute(s->stats, attr);
+	size_t label_count = Graph_LabeledNodeCount(gc->g, s->id);
+	if(stats == NULL || label_count == 0) return NULL;
+
+	*fraction = MIN(1.0, (double)(numeric ? stats->numeric_count : stats->count) / label_count);
+	return stats;
+}
+
+// Mirror a comparison operator, such that a op b === b op' a.
+static AST_Operator _MirrorOperator(AST_Operator op) {
+	switch(op) {
+	case OP_LT:
+		return OP_GT;
+	case OP_LE:
+		return OP_GE;
+	case OP_GT:
+		return OP_LT;
+	case OP_GE:
+		return OP_LE;
+	default:
+		return op;
+	}
+}
+
+static double _PredicateSelectivity(const FT_FilterNode *root, const QueryGraph *qg) {
+	const AR_ExpNode *prop = root->pred.lhs;
+	const AR_ExpNode *value = root->pred.rhs;
+	AST_Operator op = root->pred.op;
+	if(!AR_EXP_IsConstant(value)) {
+		prop = root->pred.rhs;
+		value = root->pred.lhs;
+		op = _MirrorOperator(op);
+	}
+	bool constant = AR_EXP_IsConstant(value);
+	bool range = (op == OP_LT || op == OP_LE || op == OP_GT || op == OP_GE);
+	double fraction;
+
+	if(op == OP_EQUAL || op == OP_NEQUAL) {
+		const AttributeStats *stats = constant ? _AttributeStats(prop, qg, false, &fraction) : NULL;
+		if(stats == NULL) return op == OP_EQUAL ? SELECTIVITY_EQUAL : 1 - SELECTIVITY_EQUAL;
+		double distinct = MAX(1, AttributeStats_DistinctCount(stats));
+		return op == OP_EQUAL ? fraction / distinct : fraction * (1 - 1 / distinct);
+	}
+
+	assert(range);
+	const AttributeStats *stats = NULL;
+	if(constant && (SI_TYPE(value->operand.constant) & SI_NUMERIC)) {
+		stats = _AttributeStats(prop, qg, true, &fraction);
+	}
+	if(stats == NULL) return SELECTIVITY_RANGE;
+
+	double bounds[SELECTIVITY_BUCKETS];
+	uint buckets = AttributeStats_Histogram(stats, bounds, SELECTIVITY_BUCKETS);
+	if(buckets == 0) return SELECTIVITY_RANGE;
+
+	// Fraction of the buckets below the value.
+	double v = SI_GET_NUMERIC(value->operand.constant);
+	uint below = 0;
+	while(below < buckets && bounds[below] < v) below++;
+	double lower = (below + 0.5) / (buckets + 1);
+	return fraction * ((op == OP_LT || op == OP_LE) ? lower : 1 - lower);
+}
+
+static double _ExpSelectivity(const AR_ExpNode *exp) {
+	if(AR_EXP_IsConstant(exp)) {
+		SIValue v = exp->operand.constant;
+		if(SIValue_IsNull(v)) return 0;
+		if(SI_TYPE(v) & (SI_NUMERIC | T_BOOL)) return SI_GET_NUMERIC(v) == 0 ? 0 : 1;
+		return 1;
+	}
+	if(exp->type == AR_EXP_OP && exp->op.type == AR_OP_FUNC) {
+		const char *func = exp->op.func_name;
+		if(!strcasecmp(func, "in") || !strcasecmp(func, "contains") ||
+		   !strcasecmp(func, "starts with") || !strcasecmp(func, "ends with")) {
+			return SELECTIVITY_STRING;
+		}
+	}
+	return SELECTIVITY_DEFAULT;
+}
+
+double FilterTree_Selectivity(const FT_FilterNode *root, const QueryGraph *qg) {
+	switch(root->t) {
+	case FT_N_COND: {
+		double left = FilterTree_Selectivity(root->cond.left, qg);
+		double right = FilterTree_Selectivity(root->cond.right, qg);
+		if(root->cond.op == OP_AND) return left * right;
+		return left + right - left * right;
+	}
+	case FT_N_PRED:
+		return _PredicateSelectivity(root, qg);
+	case FT_N_EXP:
+		return _ExpSelectivity(root->exp.exp);
+	default:
+		assert(false);
+	}
+	return SELECTIVITY_DEFAULT;
+}
+
+double FilterTree_Cost(const FT_FilterNode *root, const QueryGraph *qg) {
+	switch(root->t) {
+	case FT_N_COND: {
+		// The right subtree is only evaluated when the left one doesn't decide.
+		double left = FilterTree_Cost(root->cond.left, qg);
+		double right = FilterTree_Cost(root->cond.right, qg);
+		double pass = FilterTree_Selectivity(root->cond.left, qg);
+		return left + (root->cond.op == OP_AND ? pass : 1 - pass) * right;
+	}
+	case FT_N_PRED:
+		return _ExpCost(root->pred.lhs) + _ExpCost(root->pred.rhs) + 1;
+	case FT_N_EXP:
+		return _ExpCost(root->exp.exp);
+	default:
+		assert(false);
+	}
+	return 1;
+}
+
+double FilterTree_Rank(double cost, double pass_rate, AST_Operator op) {
+	// Operands most likely to decide the condition per unit of cost come first.
+	double decisive = (op == OP_AND) ? 1 - pass_rate : pass_rate;
+	return cost / MAX(decisive, 1e-6);
+}
+
+// Collect the operands of the chain of op conditions rooted at root.
+static void _CollectChain(FT_FilterNode *root, AST_Operator op, FT_FilterNode ***operands,
+						  FT_FilterNode ***conds) {
+	if(root->t != FT_N_COND || root->cond.op != op) {
+		*operands = array_append(*operands, root);
+		return;
+	}
+	*conds = array_append(*conds, root);
+	_CollectChain(root->cond.left, op, operands, conds);
+	_CollectChain(root->cond.right, op, operands, conds);
+}
+
+FT_FilterNode **FilterTree_Conjuncts(FT_FilterNode *root) {
+	FT_FilterNode **operands = array_new(FT_FilterNode *, 2);
+	FT_FilterNode **conds = array_new(FT_FilterNode *, 1);
+	_CollectChain(root, OP_AND, &operands, &conds);
+	array_free(conds);
+	return operands;
+}
+
+void FilterTree_Reorder(FT_FilterNode *root, const QueryGraph *qg) {
+	if(root->t != FT_N_COND) return;
+
+	AST_Operator op = root->cond.op;
+	if(op != OP_AND && op != OP_OR) {
+		if(root->cond.left) FilterTree_Reorder(root->cond.left, qg);
+		if(root->cond.right) FilterTree_Reorder(root->cond.right, qg);
+		return;
+	}
+
+	FT_FilterNode **operands = array_new(FT_FilterNode *, 2);
+	FT_FilterNode **conds = array_new(FT_FilterNode *, 1);
+	_CollectChain(root, op, &operands, &conds);
+	uint count = array_len(operands);
+
+	double ranks[count];
+	for(uint i = 0; i < count; i++) {
+		FilterTree_Reorder(operands[i], qg);
+		double cost = FilterTree_Cost(operands[i], qg);
+		ranks[i] = FilterTree_Rank(cost, FilterTree_Selectivity(operands[i], qg), op);
+	}
+
+	// Stable insertion sort, operands of equal rank keep their written order.
+	for(uint i = 1; i < count; i++) {
+		FT_FilterNode *operand = operands[i];
+		double rank = ranks[i];
+		uint j = i;
+		for(; j > 0 && ranks[j - 1] > rank; j--) {
+			operands[j] = operands[j - 1];
+			ranks[j] = ranks[j - 1];
+		}
+		operands[j] = operand;
+		ranks[j] = rank;
+	}
+
+	// Rebuild a left deep chain, root remains the chain's top condition.
+	uint cond_count = array_len(conds);
+	assert(cond_count == count - 1 && conds[0] == root);
+	conds[0] = conds[cond_count - 1];
+	conds[cond_count - 1] = root;
+	conds[0]->cond.left = operands[0];
+	conds[0]->cond.right = operands[1];
+	for(uint i = 1; i < cond_count; i++) {
+		conds[i]->cond.left = conds[i - 1];
+		conds[i]->cond.right = operands[i + 1];
+	}
+
+	array_free(operands);
+	array_free(conds);
+}
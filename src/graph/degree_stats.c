@@ -0,0 +1,137 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "degree_stats.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+static int _DegreeStats_Compare(const void *a, const void *b) {
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+// Records node as a supernode, keeping supernodes sorted by descending degree.
+static void _DegreeSummary_AddSupernode(DegreeSummary *s, uint64_t *degrees, NodeID id,
+										uint64_t degree) {
+	uint i = s->supernodeCount;
+	if(i == DEGREE_STATS_SUPERNODE_CAP) {
+		if(degrees[i - 1] >= degree) return;
+		i--;
+	} else {
+		s->supernodeCount++;
+	}
+
+	for(; i > 0 && degrees[i - 1] < degree; i--) {
+		s->supernodes[i] = s->supernodes[i - 1];
+		degrees[i] = degrees[i - 1];
+	}
+	s->supernodes[i] = id;
+	degrees[i] = degree;
+}
+
+static void _DegreeSummary_Build(Graph *g, GrB_Matrix M, GrB_Index entries, GRAPH_EDGE_DIR dir,
+								 DegreeSummary *s) {
+	memset(s, 0, sizeof(DegreeSummary));
+	s->entries = entries;
+	if(entries == 0) return;
+
+	// Count the entries of each row, or of each column for in-degrees.
+	GrB_Index n;
+	GrB_Matrix_nrows(&n, M);
+	GrB_Vector ones;
+	GrB_Vector degree;
+	GrB_Vector_new(&ones, GrB_UINT64, n);
+	GrB_Vector_new(&degree, GrB_UINT64, n);
+	GrB_Vector_assign_UINT64(ones, GrB_NULL, GrB_NULL, 1, GrB_ALL, n, GrB_NULL);
+	GrB_Descriptor desc = (dir == GRAPH_EDGE_DIR_INCOMING) ? GrB_DESC_T0 : GrB_NULL;
+	GrB_Info info = GrB_mxv(degree, GrB_NULL, GrB_NULL, GxB_PLUS_PAIR_UINT64, M, ones, desc);
+	assert(info == GrB_SUCCESS);
+
+	GrB_Index nvals;
+	GrB_Vector_nvals(&nvals, degree);
+	GrB_Index *ids = rm_malloc(sizeof(GrB_Index) * nvals);
+	uint64_t *degrees = rm_malloc(sizeof(uint64_t) * nvals);
+	GrB_Vector_extractTuples_UINT64(ids, degrees, &nvals, degree);
+
+	uint64_t total = 0;
+	for(GrB_Index i = 0; i < nvals; i++) total += degrees[i];
+	s->nodes = nvals;
+	s->avg = (double)total / nvals;
+
+	uint64_t supernode_degrees[DEGREE_STATS_SUPERNODE_CAP];
+	double threshold = s->avg * DEGREE_STATS_SUPERNODE_FACTOR;
+	for(GrB_Index i = 0; i < nvals; i++) {
+		if(degrees[i] >= threshold) {
+			_DegreeSummary_AddSupernode(s, supernode_degrees, ids[i], degrees[i]);
+		}
+	}
+
+	qsort(degrees, nvals, sizeof(uint64_t), _DegreeStats_Compare);
+	GrB_Index rank = (GrB_Index)ceil(nvals * 0.99);
+	s->p99 = degrees[rank - 1];
+	s->max = degrees[nvals - 1];
+
+	rm_free(ids);
+	rm_free(degrees);
+	GrB_free(&ones);
+	GrB_free(&degree);
+}
+
+DegreeStats *DegreeStats_New(void) {
+	DegreeStats *stats = rm_malloc(sizeof(DegreeStats));
+	stats->out = array_new(DegreeSummary *, 1);
+	stats->in = array_new(DegreeSummary *, 1);
+	int res = pthread_mutex_init(&stats->lock, NULL);
+	assert(res == 0);
+	return stats;
+}
+
+void DegreeStats_Get(Graph *g, int relation, GRAPH_EDGE_DIR dir, DegreeSummary *summary) {
+	assert(g && summary && relation != GRAPH_UNKNOWN_RELATION && dir != GRAPH_EDGE_DIR_BOTH);
+	DegreeStats *stats = g->_degrees;
+
+	GrB_Matrix M = (relation == GRAPH_NO_RELATION) ? Graph_GetAdjacencyMatrix(g) :
+				   Graph_GetRelationMatrix(g, relation);
+	GrB_Index entries;
+	GrB_Matrix_nvals(&entries, M);
+
+	pthread_mutex_lock(&stats->lock);
+
+	DegreeSummary ***summaries = (dir == GRAPH_EDGE_DIR_INCOMING) ? &stats->in : &stats->out;
+	uint idx = relation + 1;
+	while(array_len(*summaries) <= idx) *summaries = array_append(*summaries, NULL);
+
+	DegreeSummary *s = (*summaries)[idx];
+	if(s == NULL) {
+		s = rm_malloc(sizeof(DegreeSummary));
+		(*summaries)[idx] = s;
+		_DegreeSummary_Build(g, M, entries, dir, s);
+	} else {
+		// Rebuild once the relation drifted away from the summarized entries.
+		GrB_Index drift = (entries > s->entries) ? entries - s->entries : s->entries - entries;
+		if(drift * DEGREE_STATS_DRIFT > s->entries) _DegreeSummary_Build(g, M, entries, dir, s);
+	}
+	*summary = *s;
+
+	pthread_mutex_unlock(&stats->lock);
+}
+
+void DegreeStats_Free(DegreeStats *stats) {
+	if(stats == NULL) return;
+	uint count = array_len(stats->out);
+	for(uint i = 0; i < count; i++) if(stats->out[i]) rm_free(stats->out[i]);
+	count = array_len(stats->in);
+	for(uint i = 0; i < count; i++) if(stats->in[i]) rm_free(stats->in[i]);
+	array_free(stats->out);
+	array_free(stats->in);
+	pthread_mutex_destroy(&stats->lock);
+	rm_free(stats);
+}
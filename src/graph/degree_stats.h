@@ -0,0 +1,51 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "graph.h"
+
+// Maximum number of supernodes tracked per summary.
+#define DEGREE_STATS_SUPERNODE_CAP 8
+// A supernode's degree is at least this many times the average degree.
+#define DEGREE_STATS_SUPERNODE_FACTOR 10
+// Summaries are rebuilt once their relation's entry count drifts by more than 1/DRIFT.
+#define DEGREE_STATS_DRIFT 8
+
+/* Degree distribution of a relation in a single direction,
+ * computed from the row counts of its matrix.
+ * Parallel edges connecting the same pair of nodes are counted once. */
+typedef struct {
+	GrB_Index entries;      // Matrix entries at the time the summary was built.
+	uint64_t nodes;         // Number of nodes with at least one neighbor.
+	double avg;             // Average degree of nodes with at least one neighbor.
+	uint64_t p99;           // 99th percentile degree of nodes with at least one neighbor.
+	uint64_t max;           // Maximal degree.
+	uint supernodeCount;    // Number of supernodes.
+	NodeID supernodes[DEGREE_STATS_SUPERNODE_CAP];  // Highest degree nodes, in descending degree.
+} DegreeSummary;
+
+// Collection of summaries maintained for a graph.
+typedef struct DegreeStats {
+	DegreeSummary **out;    // Out-degree summaries, indexed by relation ID + 1.
+	DegreeSummary **in;     // In-degree summaries, indexed by relation ID + 1.
+	pthread_mutex_t lock;   // Guards summaries, concurrent readers may build summaries.
+} DegreeStats;
+
+// Create an empty summary collection.
+DegreeStats *DegreeStats_New(void);
+
+/* Retrieves the degree summary of relation, GRAPH_NO_RELATION for all relations,
+ * in direction dir, either incoming or outgoing, into summary.
+ * Summaries are rebuilt lazily once the relation changed considerably since they were built.
+ * Caller is expected to hold the graph's read lock. */
+void DegreeStats_Get(Graph *g, int relation, GRAPH_EDGE_DIR dir, DegreeSummary *summary);
+
+// Free summary collection.
+void DegreeStats_Free(DegreeStats *stats);
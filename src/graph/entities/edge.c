@@ -28,43 +28,13 @@ int Edge_GetRelationID(const Edge *edge) {
 	return edge->relationID;
 }
 
-Node *Edge_GetSrcNode(Edge *e) {
-	assert(e);
-	return e->src;
-}
-
-Node *Edge_GetDestNode(Edge *e) {
-	assert(e);
-	return e->dest;
-}
-
-GrB_Matrix Edge_GetMatrix(Edge *e) {
-	assert(e);
-
-	// Retrieve matrix from graph if edge matrix isn't set.
-	if(!e->mat) {
-		Graph *g = QueryCtx_GetGraph();
-
-		// Get relation matrix.
-		if(e->relationID == GRAPH_UNKNOWN_RELATION) {
-			e->mat = Graph_GetZeroMatrix(g);
-		} else {
-			e->mat = Graph_GetRelationMatrix(g, e->relationID);
-		}
-	}
-
-	return e->mat;
-}
-
-void Edge_SetSrcNode(Edge *e, Node *src) {
+void Edge_SetSrcNode(Edge *e, const Node *src) {
 	assert(e && src);
-	e->src = src;
 	e->srcNodeID = ENTITY_GET_ID(src);
 }
 
-void Edge_SetDestNode(Edge *e, Node *dest) {
+void Edge_SetDestNode(Edge *e, const Node *dest) {
 	assert(e && dest);
-	e->dest = dest;
 	e->destNodeID = ENTITY_GET_ID(dest);
 }
 
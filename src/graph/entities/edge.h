@@ -14,17 +14,14 @@
 
 #define EDGE_LENGTH_INF UINT_MAX - 2
 
-/* TODO: note it is possible to get into an inconsistency
- * if we set src and srcNodeID to different nodes. */
+/* Edges are copied by value into every record and path holding them,
+ * endpoints are referred to by ID only, their entities are retrieved on demand. */
 struct Edge {
 	Entity *entity;           /* MUST be the first property of Edge. */
 	const char *relationship; /* Label attached to edge. */
 	int relationID;           /* Relation ID. */
-	Node *src;                /* Pointer to source node. */
-	Node *dest;               /* Pointer to destination node. */
 	NodeID srcNodeID;         /* Source node ID. */
 	NodeID destNodeID;        /* Destination node ID. */
-	GrB_Matrix mat;           /* Adjacency matrix, associated with edge. */
 };
 
 typedef struct Edge Edge;
@@ -41,20 +38,11 @@ NodeID Edge_GetDestNodeID(const Edge *edge); // graph.c, serializer, all_paths,
 // Retrieve edge relation ID.
 int Edge_GetRelationID(const Edge *edge); // graph.c, replies
 
-// Retrieve edge source node.
-Node *Edge_GetSrcNode(Edge *e); // opcreate
+// Sets edge source node ID to that of src, INVALID_ENTITY_ID if src isn't created yet.
+void Edge_SetSrcNode(Edge *e, const Node *src); // opcreate
 
-// Retrieve edge destination node. // opcreate
-Node *Edge_GetDestNode(Edge *e);
-
-// Retrieves edge matrix.
-GrB_Matrix Edge_GetMatrix(Edge *e); // AE
-
-// Sets edge source node.
-void Edge_SetSrcNode(Edge *e, Node *src); // QG
-
-// Sets edge destination node.
-void Edge_SetDestNode(Edge *e, Node *dest); // QG
+// Sets edge destination node ID to that of dest, INVALID_ENTITY_ID if dest isn't created yet.
+void Edge_SetDestNode(Edge *e, const Node *dest); // opcreate
 
 // Sets edge relation type.
 void Edge_SetRelationID(Edge *e, int relationID); // QG, graph.c
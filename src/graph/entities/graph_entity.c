@@ -6,9 +6,15 @@
 
 #include <stdio.h>
 #include <assert.h>
+#include <string.h>
 #include "graph_entity.h"
 #include "../../query_ctx.h"
 #include "../../util/rmalloc.h"
+#include "../../util/string_pool.h"
+#include "../../util/string_arena.h"
+#include "../../datatypes/array.h"
+#include "property_pack.h"
+#include "property_slab.h"
 #include "../graphcontext.h"
 #include "node.h"
 #include "edge.h"
@@ -17,12 +23,189 @@ SIValue *PROPERTY_NOTFOUND = &(SIValue) {
 	.longval = 0, .type = T_NULL
 };
 
+/* Position at which each attribute was last found within an entity's properties.
+ * Entities of the same kind are usually created with their properties in the same order,
+ * e.g. by bulk insertion or by the same CREATE clause, such that an attribute tends to
+ * occupy the same position across entities and lookups avoid scanning.
+ * Hints are shared by all graphs and threads, a stale hint merely costs a scan. */
+static uint16_t _property_hints[ATTRIBUTE_NOTFOUND];
+
+// Number of entity modifications made so far, see GraphEntity_Modifications.
+static uint64_t _modifications = 0;
+
+static inline void _GraphEntity_Modified(void) {
+	__atomic_fetch_add(&_modifications, 1, __ATOMIC_RELAXED);
+}
+
+uint64_t GraphEntity_Modifications(void) {
+	return __atomic_load_n(&_modifications, __ATOMIC_RELAXED);
+}
+
+/* Entity properties are either an array of EntityProperty or, once packed by Entity_Pack,
+ * a compact property pack tagged by ENTITY_PACKED. Packed properties are expanded on access,
+ * possibly by concurrent readers, in which case the expanded array retains the pack in an
+ * additional trailing slot, tagged by ENTITY_EXPANDED, as other readers might still be
+ * decoding it. The pack is released by the entity's next modification, made under the
+ * graph's write lock. */
+#define ENTITY_PACKED 0x1
+#define ENTITY_EXPANDED 0x2
+#define ENTITY_TAGS (ENTITY_PACKED | ENTITY_EXPANDED)
+
+static inline EntityProperty *_Entity_Untag(uintptr_t properties) {
+	return (EntityProperty *)(properties & ~(uintptr_t)ENTITY_TAGS);
+}
+
+// Decodes packed properties, returns the expanded array.
+static EntityProperty *_Entity_Expand(Entity *e, EntityProperty *packed) {
+	void *pack = _Entity_Untag((uintptr_t)packed);
+	int prop_count = e->prop_count;
+	EntityProperty *properties = PropertySlab_Alloc(prop_count + 1);
+	PropertyPack_Unpack(pack, prop_count, properties);
+	properties[prop_count].id = ATTRIBUTE_NOTFOUND;
+	properties[prop_count].value = SI_PtrVal(pack);
+
+	EntityProperty *expanded = (EntityProperty *)((uintptr_t)properties | ENTITY_EXPANDED);
+	if(__atomic_compare_exchange_n(&e->properties, &packed, expanded, false, __ATOMIC_ACQ_REL,
+								   __ATOMIC_ACQUIRE)) {
+		return properties;
+	}
+
+	// Another reader expanded the properties first, packed now holds its array.
+	for(int i = 0; i < prop_count; i++) SIValue_Free(properties[i].value);
+	PropertySlab_Free(properties, prop_count + 1);
+	return _Entity_Untag((uintptr_t)packed);
+}
+
+EntityProperty *Entity_Properties(Entity *e) {
+	EntityProperty *properties = __atomic_load_n(&e->properties, __ATOMIC_ACQUIRE);
+	if((uintptr_t)properties & ENTITY_PACKED) return _Entity_Expand(e, properties);
+	return _Entity_Untag((uintptr_t)properties);
+}
+
+/* Prepares entity properties for modification, releasing the pack retained by
+ * expanded properties, must be called under the graph's write lock. */
+static EntityProperty *_Entity_Settle(Entity *e) {
+	EntityProperty *properties = Entity_Properties(e);
+	if((uintptr_t)e->properties & ENTITY_EXPANDED) {
+		PropertyPack_Free(properties[e->prop_count].value.ptrval);
+		properties = PropertySlab_Realloc(properties, e->prop_count + 1, e->prop_count);
+		e->properties = properties;
+	}
+	return properties;
+}
+
+bool Entity_Pack(Entity *e) {
+	if(e->prop_count == 0 || ((uintptr_t)e->properties & ENTITY_PACKED)) return false;
+
+	// Entity was accessed since last packed, keep its properties expanded.
+	if((uintptr_t)e->properties & ENTITY_EXPANDED) {
+		_Entity_Settle(e);
+		return false;
+	}
+
+	// Interned strings are shared with other entities, packing would duplicate them.
+	EntityProperty *properties = e->properties;
+	for(int i = 0; i < e->prop_count; i++) {
+		if(properties[i].value.allocation == M_INTERNED) return false;
+	}
+
+	void *pack = PropertyPack_New(properties, e->prop_count);
+	for(int i = 0; i < e->prop_count; i++) SIValue_Free(properties[i].value);
+	PropertySlab_Free(properties, e->prop_count);
+	e->properties = (EntityProperty *)((uintptr_t)pack | ENTITY_PACKED);
+	return true;
+}
+
+uint Entity_Relocate(Entity *e, EntityRelocateFunc relocate, void *arg) {
+	uintptr_t properties = (uintptr_t)e->properties;
+	if(properties == 0) return 0;
+
+	void *moved;
+	if(properties & ENTITY_PACKED) {
+		moved = relocate(_Entity_Untag(properties), arg);
+		if(moved == NULL) return 0;
+		e->properties = (EntityProperty *)((uintptr_t)moved | ENTITY_PACKED);
+		return 1;
+	}
+	// Concurrent readers might still be decoding the pack retained by expanded properties.
+	if(properties & ENTITY_EXPANDED) return 0;
+
+	uint relocated = 0;
+	if(PropertySlab_Capacity(e->prop_count) > PROPERTY_SLAB_MAX_COUNT) {
+		moved = relocate(e->properties, arg);
+		if(moved) {
+			e->properties = moved;
+			relocated++;
+		}
+	}
+
+	// Interned and arena strings are shared, only strings owned by a single property move.
+	for(int i = 0; i < e->prop_count; i++) {
+		SIValue *v = &e->properties[i].value;
+		if(SI_TYPE(*v) != T_STRING || v->allocation != M_SELF) continue;
+		moved = relocate(v->stringval, arg);
+		if(moved) {
+			v->stringval = moved;
+			relocated++;
+		}
+	}
+	return relocated;
+}
+
+// Bytes owned by value beyond the SIValue itself, interned strings are owned by their pool.
+static size_t _SIValue_MemoryUsage(SIValue v) {
+	if(SI_TYPE(v) == T_STRING) {
+		return (v.allocation == M_SELF || v.allocation == M_ARENA) ? strlen(v.stringval) + 1 : 0;
+	}
+	if(SI_TYPE(v) != T_ARRAY) return 0;
+	u_int32_t len = SIArray_Length(v);
+	size_t size = len * sizeof(SIValue);
+	for(u_int32_t i = 0; i < len; i++) size += _SIValue_MemoryUsage(SIArray_Get(v, i));
+	return size;
+}
+
+size_t Entity_MemoryUsage(const Entity *e) {
+	uintptr_t properties = (uintptr_t)__atomic_load_n(&e->properties, __ATOMIC_ACQUIRE);
+	if(properties == 0) return 0;
+	if(properties & ENTITY_PACKED) return PropertyPack_Size(_Entity_Untag(properties));
+
+	EntityProperty *props = _Entity_Untag(properties);
+	int count = e->prop_count;
+	size_t size = 0;
+	if(properties & ENTITY_EXPANDED) {
+		// The expanded array retains the pack in its trailing slot.
+		size += PropertyPack_Size(props[count].value.ptrval);
+		count++;
+	}
+	size += PropertySlab_Capacity(count) * sizeof(EntityProperty);
+	for(int i = 0; i < e->prop_count; i++) size += _SIValue_MemoryUsage(props[i].value);
+	return size;
+}
+
+/* Copies value into entity's properties,
+ * an interned string is shared with the pool rather than duplicated. */
+static inline SIValue _GraphEntity_CopyValue(SIValue value) {
+	if(value.allocation == M_INTERNED) {
+		StringPool_Retain(value.stringval);
+		return value;
+	}
+	return SI_CloneValue(value);
+}
+
+// Returns true if value is a string to be held by an entity's string arena.
+static inline bool _GraphEntity_ArenaString(SIValue value) {
+	return SI_TYPE(value) == T_STRING && value.allocation != M_INTERNED &&
+		   strlen(value.stringval) <= STRING_ARENA_MAX_LEN;
+}
+
 /* Removes entity's property. */
 static void _GraphEntity_RemoveProperty(const GraphEntity *e, Attribute_ID attr_id) {
 	// Quick return if attribute is missing.
 	if(GraphEntity_GetProperty(e, attr_id) == PROPERTY_NOTFOUND) return;
 
 	// Locate attribute position.
+	_GraphEntity_Modified();
+	_Entity_Settle(e->entity);
 	int prop_count = e->entity->prop_count;
 	for(int i = 0; i < prop_count; i++) {
 		if(attr_id == e->entity->properties[i].id) {
@@ -31,14 +214,14 @@ static void _GraphEntity_RemoveProperty(const GraphEntity *e, Attribute_ID attr_
 
 			if(e->entity->prop_count == 0) {
 				/* Only attribute removed, free properties bag. */
-				rm_free(e->entity->properties);
+				PropertySlab_Free(e->entity->properties, prop_count);
 				e->entity->properties = NULL;
 			} else {
 				/* Overwrite deleted attribute with the last
 				 * attribute and shrink properties bag. */
 				e->entity->properties[i] = e->entity->properties[prop_count - 1];
-				e->entity->properties = rm_realloc(e->entity->properties,
-												   sizeof(EntityProperty) * e->entity->prop_count);
+				e->entity->properties = PropertySlab_Realloc(e->entity->properties, prop_count,
+															 e->entity->prop_count);
 			}
 
 			break;
@@ -48,28 +231,65 @@ static void _GraphEntity_RemoveProperty(const GraphEntity *e, Attribute_ID attr_
 
 /* Add a new property to entity */
 SIValue *GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value) {
-	if(e->entity->properties == NULL) {
-		e->entity->properties = rm_malloc(sizeof(EntityProperty));
-	} else {
-		e->entity->properties = rm_realloc(e->entity->properties,
-										   sizeof(EntityProperty) * (e->entity->prop_count + 1));
-	}
+	_GraphEntity_Modified();
+	_Entity_Settle(e->entity);
+	e->entity->properties = PropertySlab_Realloc(e->entity->properties, e->entity->prop_count,
+												 e->entity->prop_count + 1);
 
 	int prop_idx = e->entity->prop_count;
 	e->entity->properties[prop_idx].id = attr_id;
-	e->entity->properties[prop_idx].value = SI_CloneValue(value);
+	e->entity->properties[prop_idx].value = _GraphEntity_CopyValue(value);
 	e->entity->prop_count++;
 
 	return &(e->entity->properties[prop_idx].value);
 }
 
+void GraphEntity_AddProperties(GraphEntity *e, uint count, const Attribute_ID *attr_ids,
+							   const SIValue *values) {
+	if(count == 0) return;
+
+	Entity *entity = e->entity;
+	_GraphEntity_Modified();
+	_Entity_Settle(entity);
+	entity->properties = PropertySlab_Realloc(entity->properties, entity->prop_count,
+											  entity->prop_count + count);
+
+	// Collect short strings, an arena is only worthwhile when there are several.
+	uint arena_count = 0;
+	const char *arena_strings[count];
+	for(uint i = 0; i < count; i++) {
+		if(_GraphEntity_ArenaString(values[i])) arena_strings[arena_count++] = values[i].stringval;
+	}
+	if(arena_count > 1) StringArena_New(arena_strings, arena_count, (char **)arena_strings);
+	else arena_count = 0;
+
+	EntityProperty *properties = entity->properties + entity->prop_count;
+	for(uint i = 0, j = 0; i < count; i++) {
+		properties[i].id = attr_ids[i];
+		if(arena_count > 0 && _GraphEntity_ArenaString(values[i])) {
+			properties[i].value = SI_ArenaStringVal((char *)arena_strings[j++]);
+		} else {
+			properties[i].value = _GraphEntity_CopyValue(values[i]);
+		}
+	}
+	entity->prop_count += count;
+}
+
 SIValue *GraphEntity_GetProperty(const GraphEntity *e, Attribute_ID attr_id) {
 	if(attr_id == ATTRIBUTE_NOTFOUND) return PROPERTY_NOTFOUND;
 
-	for(int i = 0; i < e->entity->prop_count; i++) {
-		if(attr_id == e->entity->properties[i].id) {
+	int prop_count = e->entity->prop_count;
+	EntityProperty *properties = Entity_Properties(e->entity);
+
+	// Try the attribute's last known position.
+	uint16_t hint = __atomic_load_n(&_property_hints[attr_id], __ATOMIC_RELAXED);
+	if(hint < prop_count && properties[hint].id == attr_id) return &(properties[hint].value);
+
+	for(int i = 0; i < prop_count; i++) {
+		if(attr_id == properties[i].id) {
+			if(i <= UINT16_MAX) __atomic_store_n(&_property_hints[attr_id], i, __ATOMIC_RELAXED);
 			// Note, unsafe as entity properties can get reallocated.
-			return &(e->entity->properties[i].value);
+			return &(properties[i].value);
 		}
 	}
 
@@ -87,8 +307,11 @@ void GraphEntity_SetProperty(const GraphEntity *e, Attribute_ID attr_id, SIValue
 
 	SIValue *prop = GraphEntity_GetProperty(e, attr_id);
 	assert(prop != PROPERTY_NOTFOUND);
+	_GraphEntity_Modified();
+	// Acquire the new value prior to releasing the old one, both might be the same pooled string.
+	SIValue new_value = _GraphEntity_CopyValue(value);
 	SIValue_Free(*prop);
-	*prop = SI_CloneValue(value);
+	*prop = new_value;
 }
 
 size_t GraphEntity_PropertiesToString(const GraphEntity *e, char **buffer, size_t *bufferLen,
@@ -205,9 +428,18 @@ void GraphEntity_ToString(const GraphEntity *e, char **buffer, size_t *bufferLen
 
 void FreeEntity(Entity *e) {
 	assert(e);
+	// Entity IDs are reused, a deleted entity's ID might refer to a new entity.
+	_GraphEntity_Modified();
+	if((uintptr_t)e->properties & ENTITY_PACKED) {
+		PropertyPack_Free(_Entity_Untag((uintptr_t)e->properties));
+		e->properties = NULL;
+		return;
+	}
+
 	if(e->properties != NULL) {
-		for(int i = 0; i < e->prop_count; i++) SIValue_Free(e->properties[i].value);
-		rm_free(e->properties);
+		EntityProperty *properties = _Entity_Settle(e);
+		for(int i = 0; i < e->prop_count; i++) SIValue_Free(properties[i].value);
+		PropertySlab_Free(properties, e->prop_count);
 		e->properties = NULL;
 	}
 }
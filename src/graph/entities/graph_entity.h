@@ -17,7 +17,7 @@
 
 #define ENTITY_GET_ID(graphEntity) ((graphEntity)->entity ? (graphEntity)->entity->id : INVALID_ENTITY_ID)
 #define ENTITY_PROP_COUNT(graphEntity) ((graphEntity)->entity->prop_count)
-#define ENTITY_PROPS(graphEntity) ((graphEntity)->entity->properties)
+#define ENTITY_PROPS(graphEntity) (Entity_Properties((graphEntity)->entity))
 
 // Defined in graph_entity.c
 extern SIValue *PROPERTY_NOTFOUND;
@@ -53,6 +53,7 @@ typedef struct {
 typedef struct {
 	EntityID id;                // Unique id
 	int prop_count;             // Number of properties.
+	int label;                  // Node label ID, occupies padding, unused by edges.
 	EntityProperty *properties; // Key value pair of attributes.
 } Entity;
 
@@ -65,6 +66,11 @@ typedef struct {
  * returns - reference to newly added property. */
 SIValue *GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value);
 
+/* Adds count properties to entity, short string values are copied
+ * into a single arena rather than allocated individually. */
+void GraphEntity_AddProperties(GraphEntity *e, uint count, const Attribute_ID *attr_ids,
+							   const SIValue *values);
+
 /* Retrieves entity's property
  * NOTE: If the key does not exist, we return the special
  * constant value PROPERTY_NOTFOUND. */
@@ -78,6 +84,32 @@ void GraphEntity_ToString(const GraphEntity *e, char **buffer, size_t *bufferLen
 						  size_t *bytesWritten,
 						  GraphEntityStringFromat format, GraphEntityType entityType);
 
+// Moves allocation ptr, returns its new address or NULL if it wasn't moved.
+typedef void *(*EntityRelocateFunc)(void *ptr, void *arg);
+
+/* Moves the heap allocations held by entity through relocate, reducing fragmentation:
+ * packed properties, property arrays not served by slabs and string values owned by the entity.
+ * Must be called while the graph is held exclusively, returns the number of moved allocations. */
+uint Entity_Relocate(Entity *e, EntityRelocateFunc relocate, void *arg);
+
+/* Returns the number of bytes held by entity's properties and the values they own,
+ * packed properties are measured without being expanded. */
+size_t Entity_MemoryUsage(const Entity *e);
+
+/* Returns entity's properties, expanding packed properties.
+ * Safe to call concurrently by readers. */
+EntityProperty *Entity_Properties(Entity *e);
+
+/* Packs entity's properties into a compact form, expanded once accessed.
+ * Entities accessed since last packed are considered hot and left expanded.
+ * Must be called under the graph's write lock, returns true if entity was packed. */
+bool Entity_Pack(Entity *e);
+
+/* Returns the number of entity modifications made so far, across all graphs.
+ * Adding, updating or removing a property and freeing an entity advance the count,
+ * values derived from entities remain current as long as the count holds. */
+uint64_t GraphEntity_Modifications(void);
+
 /* Release all memory allocated by entity */
 void FreeEntity(Entity *e);
 
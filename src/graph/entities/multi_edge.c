@@ -0,0 +1,155 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "multi_edge.h"
+#include "../../util/rmalloc.h"
+#include "../../util/object_pool/object_pool.h"
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+// Smallest list capacity, a list is created once a pair is connected by two edges.
+#define MULTI_EDGE_MIN_CAP 2
+// Number of pooled capacity classes, capacities are powers of 2.
+#define MULTI_EDGE_CLASS_COUNT 4
+// Largest pooled list capacity.
+#define MULTI_EDGE_MAX_POOLED_CAP (MULTI_EDGE_MIN_CAP << (MULTI_EDGE_CLASS_COUNT - 1))
+// Size in bytes of a list of given capacity.
+#define MULTI_EDGE_SIZE(cap) (sizeof(MultiEdge) + (cap) * sizeof(EdgeID))
+
+// Pool per capacity class, shared by all graphs.
+static ObjectPool *_pools[MULTI_EDGE_CLASS_COUNT] = {NULL};
+// Guards pools.
+static pthread_mutex_t _pools_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Maps a pooled capacity to its class.
+static inline uint _MultiEdge_Class(uint32_t cap) {
+	return __builtin_ctz(cap) - __builtin_ctz(MULTI_EDGE_MIN_CAP);
+}
+
+static MultiEdge *_MultiEdge_Alloc(uint32_t cap) {
+	MultiEdge *me;
+	if(cap <= MULTI_EDGE_MAX_POOLED_CAP) {
+		uint c = _MultiEdge_Class(cap);
+		pthread_mutex_lock(&_pools_lock);
+		if(_pools[c] == NULL) _pools[c] = ObjectPool_New(POOL_BLOCK_CAP, MULTI_EDGE_SIZE(cap), NULL);
+		me = ObjectPool_NewItem(_pools[c]);
+		pthread_mutex_unlock(&_pools_lock);
+	} else {
+		me = rm_malloc(MULTI_EDGE_SIZE(cap));
+	}
+
+	me->count = 0;
+	me->cap = cap;
+	return me;
+}
+
+static void _MultiEdge_Release(MultiEdge *me) {
+	if(me->cap <= MULTI_EDGE_MAX_POOLED_CAP) {
+		pthread_mutex_lock(&_pools_lock);
+		ObjectPool_DeleteItem(_pools[_MultiEdge_Class(me->cap)], me);
+		pthread_mutex_unlock(&_pools_lock);
+	} else {
+		rm_free(me);
+	}
+}
+
+// Move list into a list of given capacity.
+static MultiEdge *_MultiEdge_Resize(MultiEdge *me, uint32_t cap) {
+	assert(me->count <= cap);
+
+	// Heap allocated lists are simply reallocated.
+	if(me->cap > MULTI_EDGE_MAX_POOLED_CAP && cap > MULTI_EDGE_MAX_POOLED_CAP) {
+		me = rm_realloc(me, MULTI_EDGE_SIZE(cap));
+		me->cap = cap;
+		return me;
+	}
+
+	MultiEdge *resized = _MultiEdge_Alloc(cap);
+	resized->count = me->count;
+	memcpy(resized->ids, me->ids, me->count * sizeof(EdgeID));
+	_MultiEdge_Release(me);
+	return resized;
+}
+
+MultiEdge *MultiEdge_New(EdgeID a, EdgeID b) {
+	MultiEdge *me = _MultiEdge_Alloc(MULTI_EDGE_MIN_CAP);
+	me->ids[0] = a;
+	me->ids[1] = b;
+	me->count = 2;
+	return me;
+}
+
+MultiEdge *MultiEdge_Add(MultiEdge *me, EdgeID id) {
+	assert(me);
+	if(me->count == me->cap) me = _MultiEdge_Resize(me, me->cap * 2);
+	me->ids[me->count++] = id;
+	return me;
+}
+
+MultiEdge *MultiEdge_Clone(const MultiEdge *me) {
+	assert(me);
+	MultiEdge *clone = _MultiEdge_Alloc(me->cap);
+	clone->count = me->count;
+	memcpy(clone->ids, me->ids, me->count * sizeof(EdgeID));
+	return clone;
+}
+
+MultiEdge *MultiEdge_Remove(MultiEdge *me, uint32_t idx) {
+	assert(me && idx < me->count);
+	// Migrate last edge ID into the vacant position.
+	me->ids[idx] = me->ids[--me->count];
+	// Shrink list once no more than a quarter of it is in use.
+	if(me->cap > MULTI_EDGE_MIN_CAP && me->count <= me->cap / 4) {
+		me = _MultiEdge_Resize(me, me->cap / 2);
+	}
+	return me;
+}
+
+// Returns true if sorted ids hold id.
+static bool _MultiEdge_Contains(const EdgeID *ids, uint32_t n, EdgeID id) {
+	uint32_t lo = 0;
+	uint32_t hi = n;
+	while(lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if(ids[mid] == id) return true;
+		if(ids[mid] < id) lo = mid + 1;
+		else hi = mid;
+	}
+	return false;
+}
+
+MultiEdge *MultiEdge_RemoveMany(MultiEdge *me, const EdgeID *ids, uint32_t n) {
+	assert(me && n <= me->count);
+	uint32_t count = 0;
+	for(uint32_t i = 0; i < me->count; i++) {
+		if(!_MultiEdge_Contains(ids, n, me->ids[i])) me->ids[count++] = me->ids[i];
+	}
+	assert(count == me->count - n);
+	me->count = count;
+
+	if(count == 0) {
+		_MultiEdge_Release(me);
+		return NULL;
+	}
+	// Shrink list until more than a quarter of it is in use.
+	uint32_t cap = me->cap;
+	while(cap > MULTI_EDGE_MIN_CAP && count <= cap / 4) cap /= 2;
+	if(cap != me->cap) me = _MultiEdge_Resize(me, cap);
+	return me;
+}
+
+uint32_t MultiEdge_Find(const MultiEdge *me, EdgeID id) {
+	assert(me);
+	uint32_t i = 0;
+	for(; i < me->count; i++) if(me->ids[i] == id) break;
+	return i;
+}
+
+void MultiEdge_Free(MultiEdge *me) {
+	if(me == NULL) return;
+	_MultiEdge_Release(me);
+}
@@ -0,0 +1,45 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "graph_entity.h"
+#include <stdint.h>
+
+/* IDs of the edges of a single relationship type connecting a source node to a destination node.
+ * A relation matrix entry holds either a single edge ID, marked by its most significant bit,
+ * or a pointer to a MultiEdge.
+ * MultiEdges are carved out of pools of contiguous blocks, one pool per capacity class,
+ * sparing an allocation per connected pair, lists outgrowing the largest class are heap allocated.
+ * All functions are thread-safe, as relation matrices may accumulate pending edges
+ * while being synchronized by readers. */
+typedef struct {
+	uint32_t count;     // Number of edge IDs.
+	uint32_t cap;       // Number of edge IDs list can hold.
+	EdgeID ids[];       // Edge IDs, MUST BE LAST MEMBER OF THE STRUCT!
+} MultiEdge;
+
+// Create a new list holding edges a and b.
+MultiEdge *MultiEdge_New(EdgeID a, EdgeID b);
+
+// Add edge to list, returns the list which might have been relocated.
+MultiEdge *MultiEdge_Add(MultiEdge *me, EdgeID id);
+
+// Create a copy of list.
+MultiEdge *MultiEdge_Clone(const MultiEdge *me);
+
+// Remove the edge at position idx, returns the list which might have been relocated.
+MultiEdge *MultiEdge_Remove(MultiEdge *me, uint32_t idx);
+
+/* Remove the edges in sorted ids, all of which must be in list, in a single pass,
+ * returns the list which might have been relocated, or NULL if no edge remains. */
+MultiEdge *MultiEdge_RemoveMany(MultiEdge *me, const EdgeID *ids, uint32_t n);
+
+// Returns the position of edge within list, list count if edge is missing.
+uint32_t MultiEdge_Find(const MultiEdge *me, EdgeID id);
+
+// Free list.
+void MultiEdge_Free(MultiEdge *me);
@@ -15,7 +15,6 @@ typedef struct {
 	Entity *entity;    /* MUST be the first property of Edge. */
 	const char *label; /* Label attached to node */
 	int labelID;       /* Label ID. */
-	GrB_Matrix mat;    /* Label matrix, associated with node. */
 } Node;
 
 /* Creates a new node. */
@@ -24,9 +23,6 @@ Node *Node_New(const char *label);
 /* Sets node relation type. */
 void Node_SetLabelID(Node *n, int labelID); // QG only
 
-/* Retrieves node matrix. */
-GrB_Matrix Node_GetMatrix(Node *n); // AE
-
 /* Clones given node. */
 Node *Node_Clone(const Node *n); // QG
 
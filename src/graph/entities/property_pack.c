@@ -0,0 +1,198 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "property_pack.h"
+#include "../../util/rmalloc.h"
+#include "../../datatypes/array.h"
+#include <assert.h>
+#include <string.h>
+
+/* Format:
+ * pack size (uint32)
+ * (varint attribute ID, value) X count
+ * where a value is a tag byte followed by:
+ * integer: zigzag varint
+ * double: 8 bytes
+ * string: varint length, bytes
+ * array: varint length, value X length
+ * point: float latitude, float longitude */
+
+typedef enum {
+	PACK_NULL,
+	PACK_INT,
+	PACK_DOUBLE,
+	PACK_FALSE,
+	PACK_TRUE,
+	PACK_STRING,
+	PACK_ARRAY,
+	PACK_POINT,
+} PackTag;
+
+typedef struct {
+	unsigned char *buf;   // Pack being written.
+	size_t len;           // Number of bytes written.
+	size_t cap;           // Buffer capacity.
+} PackWriter;
+
+static void _PackWriter_Reserve(PackWriter *w, size_t n) {
+	if(w->len + n <= w->cap) return;
+	while(w->len + n > w->cap) w->cap *= 2;
+	w->buf = rm_realloc(w->buf, w->cap);
+}
+
+static inline void _PackWriter_Byte(PackWriter *w, unsigned char b) {
+	_PackWriter_Reserve(w, 1);
+	w->buf[w->len++] = b;
+}
+
+static void _PackWriter_Varint(PackWriter *w, uint64_t v) {
+	_PackWriter_Reserve(w, 10);
+	while(v >= 0x80) {
+		w->buf[w->len++] = (v & 0x7F) | 0x80;
+		v >>= 7;
+	}
+	w->buf[w->len++] = v;
+}
+
+static void _PackWriter_Bytes(PackWriter *w, const void *src, size_t n) {
+	_PackWriter_Reserve(w, n);
+	memcpy(w->buf + w->len, src, n);
+	w->len += n;
+}
+
+static void _PackWriter_Value(PackWriter *w, SIValue v) {
+	switch(SI_TYPE(v)) {
+	case T_NULL:
+		_PackWriter_Byte(w, PACK_NULL);
+		return;
+	case T_INT64:
+		_PackWriter_Byte(w, PACK_INT);
+		// Zigzag encoding keeps small negative values short.
+		_PackWriter_Varint(w, ((uint64_t)v.longval << 1) ^ (uint64_t)(v.longval >> 63));
+		return;
+	case T_DOUBLE:
+		_PackWriter_Byte(w, PACK_DOUBLE);
+		_PackWriter_Bytes(w, &v.doubleval, sizeof(double));
+		return;
+	case T_BOOL:
+		_PackWriter_Byte(w, v.longval ? PACK_TRUE : PACK_FALSE);
+		return;
+	case T_STRING: {
+		size_t len = strlen(v.stringval);
+		_PackWriter_Byte(w, PACK_STRING);
+		_PackWriter_Varint(w, len);
+		_PackWriter_Bytes(w, v.stringval, len);
+		return;
+	}
+	case T_ARRAY: {
+		uint32_t len = SIArray_Length(v);
+		_PackWriter_Byte(w, PACK_ARRAY);
+		_PackWriter_Varint(w, len);
+		for(uint32_t i = 0; i < len; i++) _PackWriter_Value(w, SIArray_Get(v, i));
+		return;
+	}
+	case T_POINT:
+		_PackWriter_Byte(w, PACK_POINT);
+		_PackWriter_Bytes(w, &v.point, sizeof(v.point));
+		return;
+	default:
+		assert(false && "Encountered unexpected property type");
+	}
+}
+
+static uint64_t _PackReader_Varint(const unsigned char **pos) {
+	uint64_t v = 0;
+	int shift = 0;
+	unsigned char b;
+	do {
+		b = *(*pos)++;
+		v |= (uint64_t)(b & 0x7F) << shift;
+		shift += 7;
+	} while(b & 0x80);
+	return v;
+}
+
+static SIValue _PackReader_Value(const unsigned char **pos) {
+	PackTag tag = *(*pos)++;
+	switch(tag) {
+	case PACK_NULL:
+		return SI_NullVal();
+	case PACK_INT: {
+		uint64_t z = _PackReader_Varint(pos);
+		return SI_LongVal((int64_t)(z >> 1) ^ -(int64_t)(z & 1));
+	}
+	case PACK_DOUBLE: {
+		double d;
+		memcpy(&d, *pos, sizeof(double));
+		*pos += sizeof(double);
+		return SI_DoubleVal(d);
+	}
+	case PACK_FALSE:
+		return SI_BoolVal(false);
+	case PACK_TRUE:
+		return SI_BoolVal(true);
+	case PACK_STRING: {
+		size_t len = _PackReader_Varint(pos);
+		char *s = rm_malloc(len + 1);
+		memcpy(s, *pos, len);
+		s[len] = '\0';
+		*pos += len;
+		return SI_TransferStringVal(s);
+	}
+	case PACK_ARRAY: {
+		uint32_t len = _PackReader_Varint(pos);
+		SIValue list = SI_Array(len);
+		for(uint32_t i = 0; i < len; i++) {
+			SIValue elem = _PackReader_Value(pos);
+			SIArray_Append(&list, elem);
+			SIValue_Free(elem);
+		}
+		// Cloning restores the typed representation of homogeneous arrays.
+		SIValue clone = SI_CloneValue(list);
+		SIValue_Free(list);
+		return clone;
+	}
+	case PACK_POINT: {
+		SIValue p = SI_Point(0, 0);
+		memcpy(&p.point, *pos, sizeof(p.point));
+		*pos += sizeof(p.point);
+		return p;
+	}
+	default:
+		assert(false && "Encountered corrupted property pack");
+		return SI_NullVal();
+	}
+}
+
+void *PropertyPack_New(const EntityProperty *properties, int count) {
+	PackWriter w = {.buf = rm_malloc(64), .len = sizeof(uint32_t), .cap = 64};
+	for(int i = 0; i < count; i++) {
+		_PackWriter_Varint(&w, properties[i].id);
+		_PackWriter_Value(&w, properties[i].value);
+	}
+
+	uint32_t size = w.len;
+	memcpy(w.buf, &size, sizeof(uint32_t));
+	return rm_realloc(w.buf, w.len);
+}
+
+void PropertyPack_Unpack(const void *pack, int count, EntityProperty *properties) {
+	const unsigned char *pos = (const unsigned char *)pack + sizeof(uint32_t);
+	for(int i = 0; i < count; i++) {
+		properties[i].id = _PackReader_Varint(&pos);
+		properties[i].value = _PackReader_Value(&pos);
+	}
+}
+
+size_t PropertyPack_Size(const void *pack) {
+	uint32_t size;
+	memcpy(&size, pack, sizeof(uint32_t));
+	return size;
+}
+
+void PropertyPack_Free(void *pack) {
+	rm_free(pack);
+}
@@ -0,0 +1,25 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "graph_entity.h"
+
+/* A property pack serializes an entity's properties into a single compact buffer,
+ * attribute IDs and integers are varint encoded and strings are stored inline.
+ * Packs hold scalars and arrays of scalars, the value types entities may hold. */
+
+// Packs count properties into a newly allocated buffer.
+void *PropertyPack_New(const EntityProperty *properties, int count);
+
+// Decodes a pack of count properties into properties, values are allocated.
+void PropertyPack_Unpack(const void *pack, int count, EntityProperty *properties);
+
+// Returns the pack size in bytes.
+size_t PropertyPack_Size(const void *pack);
+
+// Free pack.
+void PropertyPack_Free(void *pack);
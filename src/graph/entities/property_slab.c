@@ -0,0 +1,127 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "property_slab.h"
+#include "../../util/rmalloc.h"
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+
+// Slab, arrays are carved out of slots.
+typedef struct PropertySlabBlock {
+	struct PropertySlabBlock *next; // Previously allocated slab.
+	EntityProperty slots[];         // PROPERTY_SLAB_CAP arrays of the class capacity.
+} PropertySlabBlock;
+
+// A freed array, reused by the next allocation of its class.
+typedef struct PropertySlabFree {
+	struct PropertySlabFree *next;
+} PropertySlabFree;
+
+typedef struct {
+	pthread_mutex_t lock;       // Guards the class.
+	PropertySlabBlock *slabs;   // Slabs of the class, most recent first.
+	uint carved;                // Number of arrays carved out of the most recent slab.
+	PropertySlabFree *free;     // Freed arrays.
+	uint64_t in_use;            // Number of arrays allocated.
+	uint64_t slab_count;        // Number of slabs.
+} PropertySlabClass;
+
+// Number of properties held by the arrays of each class.
+static const uint _class_caps[PROPERTY_SLAB_CLASSES] = {1, 2, 3, 4, 6, 8, 12, 16};
+
+static PropertySlabClass _classes[PROPERTY_SLAB_CLASSES] = {
+	[0 ... PROPERTY_SLAB_CLASSES - 1] = {.lock = PTHREAD_MUTEX_INITIALIZER}
+};
+
+// Maps a property count to its class, counts beyond PROPERTY_SLAB_MAX_COUNT map to -1.
+static inline int _PropertySlab_Class(uint count) {
+	if(count > PROPERTY_SLAB_MAX_COUNT) return -1;
+	int c = 0;
+	while(_class_caps[c] < count) c++;
+	return c;
+}
+
+uint PropertySlab_Capacity(uint count) {
+	int c = _PropertySlab_Class(count);
+	return (c < 0) ? count : _class_caps[c];
+}
+
+EntityProperty *PropertySlab_Alloc(uint count) {
+	assert(count > 0);
+	int c = _PropertySlab_Class(count);
+	if(c < 0) return rm_malloc(sizeof(EntityProperty) * count);
+
+	PropertySlabClass *cls = _classes + c;
+	uint cap = _class_caps[c];
+	EntityProperty *properties;
+
+	pthread_mutex_lock(&cls->lock);
+	if(cls->free) {
+		properties = (EntityProperty *)cls->free;
+		cls->free = cls->free->next;
+	} else {
+		if(cls->slabs == NULL || cls->carved == PROPERTY_SLAB_CAP) {
+			PropertySlabBlock *slab = rm_malloc(sizeof(PropertySlabBlock) +
+												sizeof(EntityProperty) * cap * PROPERTY_SLAB_CAP);
+			slab->next = cls->slabs;
+			cls->slabs = slab;
+			cls->carved = 0;
+			cls->slab_count++;
+		}
+		properties = cls->slabs->slots + (size_t)cls->carved * cap;
+		cls->carved++;
+	}
+	cls->in_use++;
+	pthread_mutex_unlock(&cls->lock);
+
+	return properties;
+}
+
+EntityProperty *PropertySlab_Realloc(EntityProperty *properties, uint count, uint new_count) {
+	if(properties == NULL) return PropertySlab_Alloc(new_count);
+	int c = _PropertySlab_Class(count);
+	int new_c = _PropertySlab_Class(new_count);
+	if(c == new_c) {
+		if(c >= 0) return properties;
+		return rm_realloc(properties, sizeof(EntityProperty) * new_count);
+	}
+
+	EntityProperty *moved = PropertySlab_Alloc(new_count);
+	memcpy(moved, properties, sizeof(EntityProperty) * ((count < new_count) ? count : new_count));
+	PropertySlab_Free(properties, count);
+	return moved;
+}
+
+void PropertySlab_Free(EntityProperty *properties, uint count) {
+	if(properties == NULL) return;
+	int c = _PropertySlab_Class(count);
+	if(c < 0) {
+		rm_free(properties);
+		return;
+	}
+
+	PropertySlabClass *cls = _classes + c;
+	PropertySlabFree *freed = (PropertySlabFree *)properties;
+	pthread_mutex_lock(&cls->lock);
+	freed->next = cls->free;
+	cls->free = freed;
+	cls->in_use--;
+	pthread_mutex_unlock(&cls->lock);
+}
+
+void PropertySlab_Stats(size_t *allocated, size_t *used) {
+	*allocated = 0;
+	*used = 0;
+	for(int c = 0; c < PROPERTY_SLAB_CLASSES; c++) {
+		PropertySlabClass *cls = _classes + c;
+		size_t array_size = sizeof(EntityProperty) * _class_caps[c];
+		pthread_mutex_lock(&cls->lock);
+		*allocated += cls->slab_count * (sizeof(PropertySlabBlock) + array_size * PROPERTY_SLAB_CAP);
+		*used += cls->in_use * array_size;
+		pthread_mutex_unlock(&cls->lock);
+	}
+}
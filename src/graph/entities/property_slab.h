@@ -0,0 +1,40 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "graph_entity.h"
+
+/* Entity property arrays are carved out of slabs, large blocks holding arrays of
+ * a single size class, rather than allocated individually. Arrays are rounded up
+ * to their class capacity, such that adding a property to an entity seldom moves
+ * its array, and freed arrays are reused by later arrays of the same class.
+ * Arrays of more than PROPERTY_SLAB_MAX_COUNT properties are heap allocated.
+ * All routines are thread-safe, readers allocate arrays when expanding packed properties. */
+
+// Number of size classes.
+#define PROPERTY_SLAB_CLASSES 8
+// Maximum number of properties of an array served by a slab.
+#define PROPERTY_SLAB_MAX_COUNT 16
+// Number of arrays held by a single slab.
+#define PROPERTY_SLAB_CAP 512
+
+// Returns the number of properties an array allocated for count properties can hold.
+uint PropertySlab_Capacity(uint count);
+
+// Allocates an array of count properties, count must be positive.
+EntityProperty *PropertySlab_Alloc(uint count);
+
+/* Resizes an array allocated for count properties to hold new_count properties,
+ * the array is moved only if new_count belongs to a different size class. */
+EntityProperty *PropertySlab_Realloc(EntityProperty *properties, uint count, uint new_count);
+
+// Releases an array allocated for count properties.
+void PropertySlab_Free(EntityProperty *properties, uint count);
+
+/* Reports the number of bytes held by slabs and the number
+ * of bytes taken by arrays allocated out of them. */
+void PropertySlab_Stats(size_t *allocated, size_t *used);
@@ -20,6 +20,7 @@ QGEdge *QGEdge_New(QGNode *src, QGNode *dest, const char *relationship, const ch
 	e->minHops = 1;
 	e->maxHops = 1;
 	e->bidirectional = false;
+	e->paths = QG_EDGE_PATHS_ALL;
 
 	return e;
 }
@@ -34,13 +35,14 @@ QGEdge *QGEdge_Clone(const QGEdge *orig) {
 	e->src = NULL;
 	e->dest = NULL;
 	e->bidirectional = orig->bidirectional;
+	e->paths = orig->paths;
 
 	return e;
 }
 
 bool QGEdge_VariableLength(const QGEdge *e) {
 	assert(e);
-	return (e->minHops != e->maxHops);
+	return (e->minHops != e->maxHops || e->paths != QG_EDGE_PATHS_ALL);
 }
 
 void QGEdge_Reverse(QGEdge *e) {
@@ -11,6 +11,13 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/* Paths an edge matches. */
+typedef enum {
+	QG_EDGE_PATHS_ALL,           /* Every path, within hop limits. */
+	QG_EDGE_PATHS_SHORTEST,      /* A single shortest path, shortestPath(). */
+	QG_EDGE_PATHS_ALL_SHORTEST,  /* Every shortest path, allShortestPaths(). */
+} QGEdgePaths;
+
 struct QGEdge {
 	const char *alias;      /* User-provided alias attached to edge. */
 	const char **reltypes;  /* Relationship type strings */
@@ -20,6 +27,7 @@ struct QGEdge {
 	uint minHops;           /* Minimum number of hops this edge represents. */
 	uint maxHops;           /* Maximum number of hops this edge represents. */
     bool bidirectional;     /* Edge doesn't have a direction. */
+	QGEdgePaths paths;      /* Paths matched by this edge. */
 };
 
 typedef struct QGEdge QGEdge;
@@ -30,7 +38,8 @@ QGEdge *QGEdge_New(QGNode *src, QGNode *dest, const char *relationship, const ch
 /* Create a duplicate of an edge containing all of the original's data. */
 QGEdge *QGEdge_Clone(const QGEdge *orig);
 
-/* Determine whether this is a variable length edge. */
+/* Determine whether this is a variable length edge.
+ * Shortest paths edges are always of variable length. */
 bool QGEdge_VariableLength(const QGEdge *e);
 
 /* Reverse edge direction. */
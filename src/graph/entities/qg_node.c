@@ -9,6 +9,7 @@
 #include "../graph.h"
 #include "../../util/arr.h"
 #include <assert.h>
+#include <string.h>
 
 static void _QGNode_RemoveEdge(QGEdge **edges, QGEdge *e) {
 	uint edge_count = array_len(edges);
@@ -26,11 +27,26 @@ QGNode *QGNode_New(const char *label, const char *alias) {
 	n->labelID = GRAPH_NO_LABEL;
 	n->label = label;
 	n->alias = alias;
+	n->labels = array_new(const char *, 0);
+	n->labelsID = array_new(int, 0);
 	n->incoming_edges = array_new(QGEdge *, 0);
 	n->outgoing_edges = array_new(QGEdge *, 0);
 	return n;
 }
 
+void QGNode_AddLabel(QGNode *n, const char *label, int label_id) {
+	uint label_count = array_len(n->labels);
+	for(uint i = 0; i < label_count; i++) {
+		if(strcmp(n->labels[i], label) == 0) return;
+	}
+	n->labels = array_append(n->labels, label);
+	n->labelsID = array_append(n->labelsID, label_id);
+}
+
+uint QGNode_LabelCount(const QGNode *n) {
+	return array_len(n->labels);
+}
+
 int QGNode_IncomeDegree(const QGNode *n) {
 	return array_len(n->incoming_edges);
 }
@@ -61,6 +77,8 @@ QGNode *QGNode_Clone(const QGNode *orig) {
 	n->label = orig->label;
 	n->labelID = orig->labelID;
 	n->alias = orig->alias;
+	array_clone(n->labels, orig->labels);
+	array_clone(n->labelsID, orig->labelsID);
 	// Don't save edges when duplicating a node
 	n->incoming_edges = array_new(QGEdge *, 0);
 	n->outgoing_edges = array_new(QGEdge *, 0);
@@ -74,7 +92,14 @@ int QGNode_ToString(const QGNode *n, char *buff, int buff_len) {
 	int offset = 0;
 	offset += snprintf(buff + offset, buff_len - offset, "(");
 	if(n->alias) offset += snprintf(buff + offset, buff_len - offset, "%s", n->alias);
-	if(n->label) offset += snprintf(buff + offset, buff_len - offset, ":%s", n->label);
+	uint label_count = QGNode_LabelCount(n);
+	if(label_count > 0) {
+		for(uint i = 0; i < label_count; i++) {
+			offset += snprintf(buff + offset, buff_len - offset, ":%s", n->labels[i]);
+		}
+	} else if(n->label) {
+		offset += snprintf(buff + offset, buff_len - offset, ":%s", n->label);
+	}
 	offset += snprintf(buff + offset, buff_len - offset, ")");
 	return offset;
 }
@@ -84,6 +109,8 @@ void QGNode_Free(QGNode *node) {
 
 	if(node->outgoing_edges) array_free(node->outgoing_edges);
 	if(node->incoming_edges) array_free(node->incoming_edges);
+	if(node->labels) array_free(node->labels);
+	if(node->labelsID) array_free(node->labelsID);
 
 	rm_free(node);
 }
\ No newline at end of file
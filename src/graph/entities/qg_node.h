@@ -16,6 +16,8 @@ struct QGEdge;
 typedef struct {
 	int labelID;               /* Label ID */
 	const char *label;         /* Label string */
+	const char **labels;       /* All labels specified for node, including label */
+	int *labelsID;             /* IDs of all labels specified for node */
 	const char *alias;         /* User-provided alias associated with this node */
 	struct QGEdge **outgoing_edges;   /* Array of incoming edges (ME)<-(SRC) */
 	struct QGEdge **incoming_edges;   /* Array of outgoing edges (ME)->(DEST) */
@@ -24,6 +26,12 @@ typedef struct {
 /* Creates a new node. */
 QGNode *QGNode_New(const char *label, const char *alias);
 
+/* Adds a label to node, ignored if node is already labeled as such. */
+void QGNode_AddLabel(QGNode *n, const char *label, int label_id);
+
+/* Returns number of labels specified for node. */
+uint QGNode_LabelCount(const QGNode *n);
+
 /* Returns number of edges pointing into node. */
 int QGNode_IncomeDegree(const QGNode *n);
 
@@ -11,8 +11,16 @@
 #include "../util/qsort.h"
 #include "../GraphBLASExt/GxB_Delete.h"
 #include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
+#include "entities/multi_edge.h"
+#include "property_columns.h"
+#include "weight_matrices.h"
+#include "../index/interval_index.h"
+#include "degree_stats.h"
 
 static GrB_BinaryOp _graph_edge_accum = NULL;
+static GrB_BinaryOp _graph_edge_merge = NULL;
+static GrB_UnaryOp _graph_edge_clone = NULL;
 // GraphBLAS Select operator to free edge arrays and delete edges.
 static GxB_SelectOp _select_delete_edges = NULL;
 
@@ -26,23 +34,45 @@ void _edge_accum(void *_z, const void *_x, const void *_y) {
 	const EdgeID *x = (const EdgeID *)_x;
 	const EdgeID *y = (const EdgeID *)_y;
 
-	EdgeID *ids;
+	MultiEdge *me;
 	/* Single edge ID,
 	 * switching from single edge ID to multiple IDs. */
 	if(SINGLE_EDGE(*x)) {
-		ids = array_new(EdgeID, 2);
-		ids = array_append(ids, SINGLE_EDGE_ID(*x));
-		ids = array_append(ids, SINGLE_EDGE_ID(*y));
-		// TODO: Make sure MSB of ids isn't on.
-		*z = (EdgeID)ids;
+		me = MultiEdge_New(SINGLE_EDGE_ID(*x), SINGLE_EDGE_ID(*y));
+		*z = (EdgeID)me;
 	} else {
 		// Multiple edges, adding another edge.
-		ids = (EdgeID *)(*x);
-		ids = array_append(ids, SINGLE_EDGE_ID(*y));
-		*z = (EdgeID)ids;
+		me = (MultiEdge *)(*x);
+		me = MultiEdge_Add(me, SINGLE_EDGE_ID(*y));
+		*z = (EdgeID)me;
 	}
 }
 
+/* Merges the edges of y into x, y might list multiple edges
+ * in which case its list is consumed. */
+void _edge_merge(void *_z, const void *_x, const void *_y) {
+	const EdgeID *y = (const EdgeID *)_y;
+	if(SINGLE_EDGE(*y)) {
+		_edge_accum(_z, _x, _y);
+		return;
+	}
+
+	EdgeID z = *(const EdgeID *)_x;
+	MultiEdge *me = (MultiEdge *)(*y);
+	for(uint32_t i = 0; i < me->count; i++) {
+		EdgeID id = SET_MSB(me->ids[i]);
+		_edge_accum(&z, &z, &id);
+	}
+	MultiEdge_Free(me);
+	*(EdgeID *)_z = z;
+}
+
+// Duplicates relation matrix entry x, edge lists are copied.
+void _edge_clone(void *_z, const void *_x) {
+	EdgeID x = *(const EdgeID *)_x;
+	*(EdgeID *)_z = (SINGLE_EDGE(x)) ? x : (EdgeID)MultiEdge_Clone((const MultiEdge *)x);
+}
+
 /* GxB_select_function which delete edges and free edge arrays. */
 bool _select_op_free_edge(GrB_Index i, GrB_Index j, GrB_Index nrows, GrB_Index ncols, const void *x,
 						  const void *thunk) {
@@ -64,20 +94,19 @@ bool _select_op_free_edge(GrB_Index i, GrB_Index j, GrB_Index nrows, GrB_Index n
 		 *
 		 * To avoid double freeing we'll place a marker on the first pass:
 		 * ids[0] = INVALID_ENTITY_ID
-		 * to be picked up by the second pass, on which the array will be freed. */
-		EdgeID *ids = (EdgeID *)(*id);
+		 * to be picked up by the second pass, on which the list will be freed. */
+		MultiEdge *me = (MultiEdge *)(*id);
 
 		// Check for first pass marker.
-		if(ids[0] != INVALID_ENTITY_ID) {
-			uint id_count = array_len(ids);
-			for(uint i = 0; i < id_count; i++) {
-				DataBlock_DeleteItem(g->edges, ids[i]);
+		if(me->ids[0] != INVALID_ENTITY_ID) {
+			for(uint i = 0; i < me->count; i++) {
+				DataBlock_DeleteItem(g->edges, me->ids[i]);
 			}
 			// Place first pass marker for second pass to pick up on.
-			ids[0] = INVALID_ENTITY_ID;
+			me->ids[0] = INVALID_ENTITY_ID;
 		} else {
-			// Second pass, simply free the array.
-			array_free(ids);
+			// Second pass, simply free the list.
+			MultiEdge_Free(me);
 		}
 	}
 
@@ -96,6 +125,16 @@ static RG_Matrix RG_Matrix_New(GrB_Type data_type, GrB_Index nrows, GrB_Index nc
 	return matrix;
 }
 
+// Creates a new matrix holding a copy of m.
+static RG_Matrix RG_Matrix_Dup(GrB_Matrix m) {
+	RG_Matrix matrix = rm_calloc(1, sizeof(_RG_Matrix));
+	GrB_Info matrix_res = GrB_Matrix_dup(&matrix->grb_matrix, m);
+	assert(matrix_res == GrB_SUCCESS);
+	int mutex_res = pthread_mutex_init(&matrix->mutex, NULL);
+	assert(mutex_res == 0);
+	return matrix;
+}
+
 // Returns underlying GraphBLAS matrix.
 static inline GrB_Matrix RG_Matrix_Get_GrB_Matrix(RG_Matrix matrix) {
 	return matrix->grb_matrix;
@@ -121,14 +160,35 @@ static void RG_Matrix_Free(RG_Matrix matrix) {
 /* ========================= Synchronization functions ========================= */
 
 /* Acquire a lock that does not restrict access from additional reader threads */
+// Lock waits are only timed once the lock couldn't be acquired right away.
 void Graph_AcquireReadLock(Graph *g) {
+	if(pthread_rwlock_tryrdlock(&g->_rwlock) == 0) {
+		Graph_RecordLatency(g, GRAPH_LATENCY_READ_LOCK_WAIT, 0);
+		return;
+	}
+	double tic[2];
+	simple_tic(tic);
 	pthread_rwlock_rdlock(&g->_rwlock);
+	Graph_RecordLatency(g, GRAPH_LATENCY_READ_LOCK_WAIT, simple_toc(tic) * 1000);
+}
+
+bool Graph_TryAcquireReadLock(Graph *g) {
+	return pthread_rwlock_tryrdlock(&g->_rwlock) == 0;
 }
 
 /* Acquire a lock for exclusive access to this graph's data */
 void Graph_AcquireWriteLock(Graph *g) {
-	pthread_rwlock_wrlock(&g->_rwlock);
+	if(pthread_rwlock_trywrlock(&g->_rwlock) == 0) {
+		Graph_RecordLatency(g, GRAPH_LATENCY_WRITE_LOCK_WAIT, 0);
+	} else {
+		double tic[2];
+		simple_tic(tic);
+		pthread_rwlock_wrlock(&g->_rwlock);
+		Graph_RecordLatency(g, GRAPH_LATENCY_WRITE_LOCK_WAIT, simple_toc(tic) * 1000);
+	}
 	g->_writelocked = true;
+	// The writer might modify the graph, invalidating columns of the current version.
+	g->version++;
 }
 
 /* Release the held lock */
@@ -144,9 +204,31 @@ void Graph_ReleaseLock(Graph *g) {
 	pthread_rwlock_unlock(&g->_rwlock);
 }
 
+bool Graph_TryAcquireExclusive(Graph *g) {
+	if(pthread_mutex_trylock(&g->_writers_mutex) != 0) return false;
+	if(pthread_rwlock_trywrlock(&g->_rwlock) != 0) {
+		pthread_mutex_unlock(&g->_writers_mutex);
+		return false;
+	}
+	g->_writelocked = true;
+	return true;
+}
+
+void Graph_ReleaseExclusive(Graph *g) {
+	Graph_ReleaseLock(g);
+	pthread_mutex_unlock(&g->_writers_mutex);
+}
+
 /* Writer request access to graph. */
 void Graph_WriterEnter(Graph *g) {
+	if(pthread_mutex_trylock(&g->_writers_mutex) == 0) {
+		Graph_RecordLatency(g, GRAPH_LATENCY_WRITER_WAIT, 0);
+		return;
+	}
+	double tic[2];
+	simple_tic(tic);
 	pthread_mutex_lock(&g->_writers_mutex);
+	Graph_RecordLatency(g, GRAPH_LATENCY_WRITER_WAIT, simple_toc(tic) * 1000);
 }
 
 /* Writer release access to graph. */
@@ -170,6 +252,25 @@ static GrB_Matrix _Graph_Get_Transposed_AdjacencyMatrix(const Graph *g) {
 	return RG_Matrix_Get_GrB_Matrix(_t_adjacency_matrix);
 }
 
+// Get relation r transposed matrix, GrB_NULL if it was never requested.
+static GrB_Matrix _Graph_GetMaterializedTransposedRelation(const Graph *g, int r) {
+	assert(g && r >= 0 && r < Graph_RelationTypeCount(g));
+	RG_Matrix m = __atomic_load_n(g->_t_relations + r, __ATOMIC_ACQUIRE);
+	if(m == NULL) return GrB_NULL;
+	g->SynchronizeMatrix(g, m);
+	return RG_Matrix_Get_GrB_Matrix(m);
+}
+
+/* Rounds n up to a granule, the largest power of two no greater than an eighth of n
+ * and no smaller than GRAPH_DEFAULT_NODE_CAP,
+ * such that dimensions grow geometrically, changing once the number of node slots
+ * grows by an eighth rather than with every node. */
+static inline size_t _Graph_MatrixDim(size_t n) {
+	size_t granule = GRAPH_DEFAULT_NODE_CAP;
+	while(granule * 8 <= n) granule *= 2;
+	return ((n + granule - 1) / granule) * granule;
+}
+
 // Return number of nodes graph can contain.
 size_t _Graph_NodeCap(const Graph *g) {
 	return g->nodes->itemCap;
@@ -180,17 +281,39 @@ size_t _Graph_EdgeCap(const Graph *g) {
 	return g->edges->itemCap;
 }
 
+/* Collects the edges of relation matrix entry, connecting src to dest.
+ * Edges held by a relation matrix are never deleted, their entities are located
+ * without being read, such that an edge whose ID and attributes are never
+ * accessed downstream costs no access to the edges' storage. */
+static inline void _Graph_CollectEdges(const Graph *g, NodeID src, NodeID dest, int r,
+									   EdgeID entry, Edge **edges) {
+	Edge e;
+	e.relationID = r;
+	e.srcNodeID = src;
+	e.destNodeID = dest;
+
+	if(SINGLE_EDGE(entry)) {
+		// Discard most significate bit.
+		entry = SINGLE_EDGE_ID(entry);
+		e.entity = DataBlock_GetLiveItem(g->edges, entry);
+		*edges = array_append(*edges, e);
+	} else {
+		/* Multiple edges connecting src to dest,
+		 * entry is a pointer to a contiguous list of edge IDs. */
+		const MultiEdge *me = (const MultiEdge *)entry;
+		for(uint32_t i = 0; i < me->count; i++) {
+			e.entity = DataBlock_GetLiveItem(g->edges, me->ids[i]);
+			*edges = array_append(*edges, e);
+		}
+	}
+}
+
 // Locates edges connecting src to destination.
 void _Graph_GetEdgesConnectingNodes(const Graph *g, NodeID src, NodeID dest, int r, Edge **edges) {
 	assert(g && src < Graph_RequiredMatrixDim(g) && dest < Graph_RequiredMatrixDim(g) &&
 		   r < Graph_RelationTypeCount(g));
 
-	Edge e;
 	EdgeID edgeId;
-	e.relationID = r;
-	e.srcNodeID = src;
-	e.destNodeID = dest;
-
 	// relation map, maps (src, dest, r) to edge IDs.
 	GrB_Matrix relation = Graph_GetRelationMatrix(g, r);
 	GrB_Info res = GrB_Matrix_extractElement_UINT64(&edgeId, relation, src, dest);
@@ -198,25 +321,7 @@ void _Graph_GetEdgesConnectingNodes(const Graph *g, NodeID src, NodeID dest, int
 	// No entry at [dest, src], src is not connected to dest with relation R.
 	if(res == GrB_NO_VALUE) return;
 
-	if(SINGLE_EDGE(edgeId)) {
-		// Discard most significate bit.
-		edgeId = SINGLE_EDGE_ID(edgeId);
-		e.entity = DataBlock_GetItem(g->edges, edgeId);
-		assert(e.entity);
-		*edges = array_append(*edges, e);
-	} else {
-		/* Multiple edges connecting src to dest,
-		 * entry is a pointer to an array of edge IDs. */
-		EdgeID *edgeIds = (EdgeID *)edgeId;
-		int edgeCount = array_len(edgeIds);
-
-		for(int i = 0; i < edgeCount; i++) {
-			edgeId = edgeIds[i];
-			e.entity = DataBlock_GetItem(g->edges, edgeId);
-			assert(e.entity);
-			*edges = array_append(*edges, e);
-		}
-	}
+	_Graph_CollectEdges(g, src, dest, r, edgeId, edges);
 }
 
 // Tests if there's an edge of type r between src and dest nodes.
@@ -234,6 +339,9 @@ static inline Entity *_Graph_GetEntity(const DataBlock *entities, EntityID id) {
 
 /* ============= Matrix synchronization and resizing functions =============== */
 
+// Milliseconds the thread spent synchronizing matrices, charged to the queries it runs.
+static __thread double _thread_sync_time = 0;
+
 /* Resize given matrix, such that its number of row and columns
  * matches the number of nodes in the graph. Also, synchronize
  * matrix to execute any pending operations. */
@@ -254,7 +362,9 @@ void _MatrixSynchronize(const Graph *g, RG_Matrix rg_matrix) {
 		// Writer under write lock, no need to flush pending changes.
 		return;
 	}
-	// Lock the matrix.
+	// Lock the matrix, waiting for a concurrent synchronization counts towards its time.
+	double tic[2];
+	simple_tic(tic);
 	RG_Matrix_Lock(rg_matrix);
 
 	bool pending = false;
@@ -272,9 +382,15 @@ void _MatrixSynchronize(const Graph *g, RG_Matrix rg_matrix) {
 		}
 		// Flush changes to matrix.
 		_Graph_ApplyPending(m);
+		Graph_RecordLatency(g, GRAPH_LATENCY_MATRIX_SYNC, simple_toc(tic) * 1000);
 	}
 	// Unlock matrix mutex.
 	_RG_Matrix_Unlock(rg_matrix);
+	_thread_sync_time += simple_toc(tic) * 1000;
+}
+
+double Graph_ThreadSyncTime(void) {
+	return _thread_sync_time;
 }
 
 /* Resize matrix to node capacity. */
@@ -284,7 +400,7 @@ void _MatrixResizeToCapacity(const Graph *g, RG_Matrix matrix) {
 	GrB_Index ncols;
 	GrB_Matrix_ncols(&ncols, m);
 	GrB_Matrix_nrows(&nrows, m);
-	GrB_Index cap = _Graph_NodeCap(g);
+	GrB_Index cap = _Graph_MatrixDim(_Graph_NodeCap(g));
 
 	// This policy should only be used in a thread-safe context, so no locking is required.
 	if(ncols != cap || nrows != cap) {
@@ -298,6 +414,26 @@ void _MatrixNOP(const Graph *g, RG_Matrix matrix) {
 }
 
 /* Define the current behavior for matrix creations and retrievals on this graph. */
+static const char *_latency_names[GRAPH_LATENCY_COUNT] = {
+	"read_query", "write_query", "queue_wait", "read_lock_wait", "writer_wait",
+	"write_lock_wait", "matrix_sync"
+};
+
+void Graph_RecordLatency(const Graph *g, GraphLatency latency, double ms) {
+	assert(latency < GRAPH_LATENCY_COUNT);
+	LatencyHistogram_Record(g->latencies + latency, ms);
+}
+
+const LatencyHistogram *Graph_GetLatency(const Graph *g, GraphLatency latency) {
+	assert(latency < GRAPH_LATENCY_COUNT);
+	return g->latencies + latency;
+}
+
+const char *Graph_LatencyName(GraphLatency latency) {
+	assert(latency < GRAPH_LATENCY_COUNT);
+	return _latency_names[latency];
+}
+
 void Graph_SetMatrixPolicy(Graph *g, MATRIX_POLICY policy) {
 	switch(policy) {
 	case SYNC_AND_MINIMIZE_SPACE:
@@ -323,27 +459,34 @@ void Graph_SetMatrixPolicy(Graph *g, MATRIX_POLICY policy) {
 void Graph_ApplyAllPending(Graph *g) {
 	RG_Matrix M;
 
+	g->SynchronizeMatrix(g, g->adjacency_matrix);
+	g->SynchronizeMatrix(g, g->_t_adjacency_matrix);
+
 	for(int i = 0; i < array_len(g->labels); i ++) {
 		M = g->labels[i];
-		g->SynchronizeMatrix(g, M);
+		if(M) g->SynchronizeMatrix(g, M);
 	}
 
 	for(int i = 0; i < array_len(g->relations); i ++) {
 		M = g->relations[i];
 		g->SynchronizeMatrix(g, M);
+		M = g->_t_relations[i];
+		if(M) g->SynchronizeMatrix(g, M);
 	}
 }
 
 /* ================================ Graph API ================================ */
 Graph *Graph_New(size_t node_cap, size_t edge_cap) {
 	node_cap = MAX(node_cap, GRAPH_DEFAULT_NODE_CAP);
-	edge_cap = MAX(node_cap, GRAPH_DEFAULT_EDGE_CAP);
+	edge_cap = MAX(edge_cap, GRAPH_DEFAULT_EDGE_CAP);
 
 	Graph *g = rm_malloc(sizeof(Graph));
 	g->nodes = DataBlock_New(node_cap, sizeof(Entity), (fpDestructor)FreeEntity);
 	g->edges = DataBlock_New(edge_cap, sizeof(Entity), (fpDestructor)FreeEntity);
+	g->label_ids = array_new(IDSet *, GRAPH_DEFAULT_LABEL_CAP);
 	g->labels = array_new(RG_Matrix, GRAPH_DEFAULT_LABEL_CAP);
 	g->relations = array_new(RG_Matrix, GRAPH_DEFAULT_RELATION_TYPE_CAP);
+	g->_t_relations = array_new(RG_Matrix, GRAPH_DEFAULT_RELATION_TYPE_CAP);
 	g->adjacency_matrix = RG_Matrix_New(GrB_BOOL, node_cap, node_cap);
 	g->_t_adjacency_matrix = RG_Matrix_New(GrB_BOOL, node_cap, node_cap);
 	g->_zero_matrix = RG_Matrix_New(GrB_BOOL, node_cap, node_cap);
@@ -351,29 +494,114 @@ Graph *Graph_New(size_t node_cap, size_t edge_cap) {
 	// Initialize a read-write lock scoped to the individual graph
 	assert(pthread_rwlock_init(&g->_rwlock, NULL) == 0);
 	g->_writelocked = false;
+	g->secondary_labels = 0;
+	g->version = 0;
+	g->_columns = PropertyColumns_New();
+	g->_degrees = DegreeStats_New();
+	g->_weights = WeightMatrices_New();
+	g->_intervals = array_new(struct IntervalIndex *, 0);
+	g->latencies = rm_calloc(GRAPH_LATENCY_COUNT, sizeof(LatencyHistogram));
 
 	// Force GraphBLAS updates and resize matrices to node count by default
 	Graph_SetMatrixPolicy(g, SYNC_AND_MINIMIZE_SPACE);
 
 	// Synchronization objects initialization.
 	assert(pthread_mutex_init(&g->_writers_mutex, NULL) == 0);
+	int res = pthread_mutex_init(&g->_labels_mutex, NULL);
+	assert(res == 0);
 
 	// Create edge accumulator binary function
 	if(!_graph_edge_accum) {
 		GrB_Info info;
 		info = GrB_BinaryOp_new(&_graph_edge_accum, _edge_accum, GrB_UINT64, GrB_UINT64, GrB_UINT64);
 		assert(info == GrB_SUCCESS);
+		info = GrB_BinaryOp_new(&_graph_edge_merge, _edge_merge, GrB_UINT64, GrB_UINT64, GrB_UINT64);
+		assert(info == GrB_SUCCESS);
+		info = GrB_UnaryOp_new(&_graph_edge_clone, _edge_clone, GrB_UINT64, GrB_UINT64);
+		assert(info == GrB_SUCCESS);
 	}
 
 	return g;
 }
 
+// Synchronizes matrix and returns a copy of it.
+static RG_Matrix _Graph_DupMatrix(const Graph *g, RG_Matrix m) {
+	g->SynchronizeMatrix(g, m);
+	return RG_Matrix_Dup(RG_Matrix_Get_GrB_Matrix(m));
+}
+
+Graph *Graph_Clone(const Graph *g, fpItemClone clone_entity, void *arg) {
+	assert(g);
+	Graph *clone = rm_malloc(sizeof(Graph));
+	clone->nodes = DataBlock_Clone(g->nodes, clone_entity, arg);
+	clone->edges = DataBlock_Clone(g->edges, clone_entity, arg);
+
+	clone->adjacency_matrix = _Graph_DupMatrix(g, g->adjacency_matrix);
+	clone->_t_adjacency_matrix = _Graph_DupMatrix(g, g->_t_adjacency_matrix);
+	g->SynchronizeMatrix(g, g->_zero_matrix);
+	GrB_Index dim;
+	GrB_Matrix_nrows(&dim, RG_Matrix_Get_GrB_Matrix(g->_zero_matrix));
+	clone->_zero_matrix = RG_Matrix_New(GrB_BOOL, dim, dim);
+
+	uint label_count = array_len(g->labels);
+	clone->label_ids = array_new(IDSet *, label_count);
+	clone->labels = array_new(RG_Matrix, label_count);
+	for(uint i = 0; i < label_count; i++) {
+		IDSet *ids = IDSet_New();
+		IDSet_Union(ids, g->label_ids[i]);
+		clone->label_ids = array_append(clone->label_ids, ids);
+		RG_Matrix L = __atomic_load_n(g->labels + i, __ATOMIC_ACQUIRE);
+		clone->labels = array_append(clone->labels, (L) ? _Graph_DupMatrix(g, L) : NULL);
+	}
+
+	// Relation matrices own their edge lists, entries are cloned rather than copied.
+	uint relation_count = array_len(g->relations);
+	clone->relations = array_new(RG_Matrix, relation_count);
+	clone->_t_relations = array_new(RG_Matrix, relation_count);
+	for(uint i = 0; i < relation_count; i++) {
+		GrB_Index nrows;
+		GrB_Index ncols;
+		GrB_Matrix R = Graph_GetRelationMatrix(g, i);
+		GrB_Matrix_nrows(&nrows, R);
+		GrB_Matrix_ncols(&ncols, R);
+		RG_Matrix M = RG_Matrix_New(GrB_UINT64, nrows, ncols);
+		GrB_Info info = GrB_Matrix_apply(RG_Matrix_Get_GrB_Matrix(M), GrB_NULL, GrB_NULL,
+										 _graph_edge_clone, R, GrB_NULL);
+		assert(info == GrB_SUCCESS);
+		clone->relations = array_append(clone->relations, M);
+
+		RG_Matrix T = __atomic_load_n(g->_t_relations + i, __ATOMIC_ACQUIRE);
+		clone->_t_relations = array_append(clone->_t_relations, (T) ? _Graph_DupMatrix(g, T) : NULL);
+	}
+
+	int res = pthread_rwlock_init(&clone->_rwlock, NULL);
+	assert(res == 0);
+	clone->_writelocked = false;
+	clone->secondary_labels = g->secondary_labels;
+	clone->version = 0;
+	clone->_columns = PropertyColumns_New();
+	clone->_degrees = DegreeStats_New();
+	clone->_weights = WeightMatrices_New();
+	// Interval indices are registered by the clone's schemas.
+	clone->_intervals = array_new(struct IntervalIndex *, 0);
+	clone->latencies = rm_calloc(GRAPH_LATENCY_COUNT, sizeof(LatencyHistogram));
+	Graph_SetMatrixPolicy(clone, SYNC_AND_MINIMIZE_SPACE);
+	res = pthread_mutex_init(&clone->_writers_mutex, NULL);
+	assert(res == 0);
+	res = pthread_mutex_init(&clone->_labels_mutex, NULL);
+	assert(res == 0);
+
+	return clone;
+}
+
 // All graph matrices are required to be squared NXN
 // where N is Graph_RequiredMatrixDim.
 size_t Graph_RequiredMatrixDim(const Graph *g) {
 	// Matrix dimensions should be at least:
 	// Number of nodes + number of deleted nodes.
-	return g->nodes->itemCount + array_len(g->nodes->deletedIdx);
+	// Matrices are resized lazily once accessed, headroom spares resizing each of them
+	// as nodes are introduced one at a time.
+	return _Graph_MatrixDim(g->nodes->itemCount + array_len(g->nodes->deletedIdx));
 }
 
 size_t Graph_NodeCount(const Graph *g) {
@@ -382,10 +610,7 @@ size_t Graph_NodeCount(const Graph *g) {
 }
 
 size_t Graph_LabeledNodeCount(const Graph *g, int label) {
-	GrB_Index nvals = 0;
-	GrB_Matrix m = Graph_GetLabelMatrix(g, label);
-	if(m) GrB_Matrix_nvals(&nvals, m);
-	return nvals;
+	return IDSet_Cardinality(Graph_GetLabelIDs(g, label));
 }
 
 size_t Graph_EdgeCount(const Graph *g) {
@@ -418,25 +643,51 @@ int Graph_GetNode(const Graph *g, NodeID id, Node *n) {
 }
 
 int Graph_GetEdge(const Graph *g, EdgeID id, Edge *e) {
-	assert(g && id < _Graph_EdgeCap(g));
+	assert(g);
 	e->entity = _Graph_GetEntity(g->edges, id);
 	return (e->entity != NULL);
 }
 
 int Graph_GetNodeLabel(const Graph *g, NodeID nodeID) {
 	assert(g);
-	int label = GRAPH_NO_LABEL;
-	for(int i = 0; i < array_len(g->labels); i++) {
-		bool x = false;
-		GrB_Matrix M = Graph_GetLabelMatrix(g, i);
-		GrB_Info res = GrB_Matrix_extractElement_BOOL(&x, M, nodeID, nodeID);
-		if(res == GrB_SUCCESS && x == true) {
-			label = i;
-			break;
-		}
+	/* Label is recorded on the node entity at creation,
+	 * sparing a lookup in each of the label matrices. */
+	Entity *en = _Graph_GetEntity(g->nodes, nodeID);
+	if(en == NULL) return GRAPH_NO_LABEL;
+	return en->label;
+}
+
+bool Graph_IsNodeLabeled(const Graph *g, NodeID nodeID, int label) {
+	assert(g);
+	if(label < 0 || label >= Graph_LabelTypeCount(g)) return false;
+
+	Entity *en = _Graph_GetEntity(g->nodes, nodeID);
+	if(en == NULL) return false;
+	if(en->label == label) return true;
+	// Only nodes labeled more than once can hold a label other than their primary.
+	if(en->label == GRAPH_NO_LABEL || g->secondary_labels == 0) return false;
+	return IDSet_Contains(g->label_ids[label], nodeID);
+}
+
+uint Graph_GetNodeLabels(const Graph *g, NodeID nodeID, int *labels, uint cap) {
+	assert(g && (labels || cap == 0));
+	int primary = Graph_GetNodeLabel(g, nodeID);
+	if(primary == GRAPH_NO_LABEL) return 0;
+
+	uint count = 0;
+	if(count < cap) labels[count] = primary;
+	count++;
+
+	// Scan labels only if some node holds more than a single label.
+	if(g->secondary_labels == 0) return count;
+	int label_count = Graph_LabelTypeCount(g);
+	for(int i = 0; i < label_count; i++) {
+		if(i == primary || !Graph_IsNodeLabeled(g, nodeID, i)) continue;
+		if(count < cap) labels[count] = i;
+		count++;
 	}
 
-	return label;
+	return count;
 }
 
 int Graph_GetEdgeRelation(const Graph *g, Edge *e) {
@@ -463,13 +714,10 @@ int Graph_GetEdgeRelation(const Graph *g, Edge *e) {
 		} else {
 			/* Multiple edges exists between src and dest
 			 * see if given edge is one of them. */
-			EdgeID *edges = (EdgeID *)edgeId;
-			int edge_count = array_len(edges);
-			for(int j = 0; j < edge_count; j++) {
-				if(edges[j] == id) {
-					Edge_SetRelationID(e, i);
-					return i;
-				}
+			const MultiEdge *me = (const MultiEdge *)edgeId;
+			if(MultiEdge_Find(me, id) < me->count) {
+				Edge_SetRelationID(e, i);
+				return i;
 			}
 		}
 	}
@@ -487,11 +735,6 @@ void Graph_GetEdgesConnectingNodes(const Graph *g, NodeID srcID, NodeID destID,
 	// MATCH ()-[:real_type|fake_type]->()
 	if(r == GRAPH_UNKNOWN_RELATION) return;
 
-	Node srcNode;
-	Node destNode;
-	assert(Graph_GetNode(g, srcID, &srcNode));
-	assert(Graph_GetNode(g, destID, &destNode));
-
 	if(r != GRAPH_NO_RELATION) {
 		_Graph_GetEdgesConnectingNodes(g, srcID, destID, r, edges);
 	} else {
@@ -503,6 +746,21 @@ void Graph_GetEdgesConnectingNodes(const Graph *g, NodeID srcID, NodeID destID,
 	}
 }
 
+// Sets [id, id] in label's matrix, if materialized.
+static void _Graph_SetLabelEntry(Graph *g, int label, NodeID id) {
+	RG_Matrix matrix = g->labels[label];
+	if(matrix == NULL) return;
+
+	// Try to set matrix at position [id, id]
+	// incase of a failure, scale matrix.
+	GrB_Matrix m = RG_Matrix_Get_GrB_Matrix(matrix);
+	GrB_Info res = GrB_Matrix_setElement_BOOL(m, true, id, id);
+	if(res != GrB_SUCCESS) {
+		_MatrixResizeToCapacity(g, matrix);
+		assert(GrB_Matrix_setElement_BOOL(m, true, id, id) == GrB_SUCCESS);
+	}
+}
+
 void Graph_CreateNode(Graph *g, int label, Node *n) {
 	assert(g);
 
@@ -510,48 +768,228 @@ void Graph_CreateNode(Graph *g, int label, Node *n) {
 	Entity *en = DataBlock_AllocateItem(g->nodes, &id);
 	en->id = id;
 	en->prop_count = 0;
+	en->label = label;
 	en->properties = NULL;
 	n->entity = en;
 
 	if(label != GRAPH_NO_LABEL) {
-		// Try to set matrix at position [id, id]
-		// incase of a failure, scale matrix.
-		RG_Matrix matrix = g->labels[label];
-		GrB_Matrix m = RG_Matrix_Get_GrB_Matrix(matrix);
-		GrB_Info res = GrB_Matrix_setElement_BOOL(m, true, id, id);
-		if(res != GrB_SUCCESS) {
-			_MatrixResizeToCapacity(g, matrix);
-			assert(GrB_Matrix_setElement_BOOL(m, true, id, id) == GrB_SUCCESS);
-		}
+		IDSet_Add(g->label_ids[label], id);
+		_Graph_SetLabelEntry(g, label, id);
 	}
 }
 
-int Graph_ConnectNodes(Graph *g, NodeID src, NodeID dest, int r, Edge *e) {
-	GrB_Info info;
-	Node srcNode;
-	Node destNode;
+void Graph_ReserveNodes(Graph *g, uint64_t n, NodeID *ids) {
+	assert(g);
+	DataBlock_AllocateItems(g->nodes, n, ids);
+}
 
-	assert(Graph_GetNode(g, src, &srcNode));
-	assert(Graph_GetNode(g, dest, &destNode));
+void Graph_StageNode(Graph *g, NodeID id, Node *n) {
+	assert(g);
+	Entity *en = DataBlock_GetItem(g->nodes, id);
+	assert(en);
+	en->id = id;
+	en->prop_count = 0;
+	en->label = GRAPH_NO_LABEL;
+	en->properties = NULL;
+	n->entity = en;
+}
+
+void Graph_LabelNode(Graph *g, NodeID id, int label) {
+	assert(g && label >= 0 && label < Graph_LabelTypeCount(g));
+	Entity *en = _Graph_GetEntity(g->nodes, id);
+	assert(en);
+
+	if(en->label == label) return;
+	if(en->label == GRAPH_NO_LABEL) en->label = label;
+	else g->secondary_labels++;
+
+	IDSet_Add(g->label_ids[label], id);
+	_Graph_SetLabelEntry(g, label, id);
+}
+
+void Graph_CreateEdge(Graph *g, NodeID src, NodeID dest, int r, Edge *e) {
 	assert(g && r < Graph_RelationTypeCount(g));
 
 	EdgeID id;
 	Entity *en = DataBlock_AllocateItem(g->edges, &id);
 	en->id = id;
 	en->prop_count = 0;
+	en->label = GRAPH_NO_LABEL;
 	en->properties = NULL;
 	e->entity = en;
 	e->relationID = r;
 	e->srcNodeID = src;
 	e->destNodeID = dest;
+}
+
+/* Notes the pair written under relation r, GRAPH_NO_RELATION notes it under every relation,
+ * maintained weight matrices and interval indices resync the pair once retrieved. */
+static void _Graph_TouchPair(Graph *g, int r, NodeID src, NodeID dest) {
+	WeightMatrices_Touch(g, r, ATTRIBUTE_NOTFOUND, src, dest);
+	uint count = array_len(g->_intervals);
+	for(uint i = 0; i < count; i++) {
+		if(g->_intervals[i] == NULL || (r != GRAPH_NO_RELATION && (int)i != r)) continue;
+		IntervalIndex_Touch(g->_intervals[i], ATTRIBUTE_NOTFOUND, src, dest);
+	}
+}
+
+// Drops the entries of relation r's interval index, GRAPH_NO_RELATION drops every index.
+static void _Graph_InvalidateIntervals(Graph *g, int r) {
+	uint count = array_len(g->_intervals);
+	for(uint i = 0; i < count; i++) {
+		if(g->_intervals[i] == NULL || (r != GRAPH_NO_RELATION && (int)i != r)) continue;
+		IntervalIndex_Invalidate(g->_intervals[i]);
+	}
+}
+
+void Graph_BuildRelation(Graph *g, int r, const GrB_Index *src, const GrB_Index *dest,
+						 EdgeID *ids, GrB_Index n) {
+	assert(g && r < Graph_RelationTypeCount(g));
+	if(n == 0) return;
+
+	GrB_Info info;
+	GrB_Index nvals;
+	GrB_Matrix relationMat = Graph_GetRelationMatrix(g, r);
+	GrB_Matrix_nvals(&nvals, relationMat);
+	assert(nvals == 0);
+
+	// Edges connecting the same pair of nodes are merged by the edge accumulator.
+	for(GrB_Index i = 0; i < n; i++) ids[i] = SET_MSB(ids[i]);
+	info = GrB_Matrix_build_UINT64(relationMat, src, dest, ids, n, _graph_edge_accum);
+	assert(info == GrB_SUCCESS);
+
+	GrB_Matrix trelationMat = _Graph_GetMaterializedTransposedRelation(g, r);
+	if(trelationMat != GrB_NULL) {
+		info = GrB_transpose(trelationMat, GrB_NULL, GrB_LOR, relationMat, GrB_NULL);
+		assert(info == GrB_SUCCESS);
+	}
+
+	// Maintained weights and interval indices are rebuilt rather than patched per edge.
+	WeightMatrices_Invalidate(g, r);
+	_Graph_InvalidateIntervals(g, r);
+}
+
+void Graph_AdjacencyAddRelation(Graph *g, int r) {
+	assert(g && r < Graph_RelationTypeCount(g));
+
+	GrB_Info info;
+	GrB_Index nvals;
+	GrB_Matrix relationMat = Graph_GetRelationMatrix(g, r);
+	GrB_Matrix_nvals(&nvals, relationMat);
+	if(nvals == 0) return;
+
+	// Introduce the relation's connections to the adjacency matrices.
+	GrB_Matrix adj = Graph_GetAdjacencyMatrix(g);
+	GrB_Matrix tadj = _Graph_Get_Transposed_AdjacencyMatrix(g);
+	info = GrB_Matrix_apply(adj, GrB_NULL, GrB_LOR, GrB_IDENTITY_BOOL, relationMat, GrB_NULL);
+	assert(info == GrB_SUCCESS);
+	info = GrB_transpose(tadj, GrB_NULL, GrB_LOR, relationMat, GrB_NULL);
+	assert(info == GrB_SUCCESS);
+}
+
+void Graph_MergeRelation(Graph *g, int r, const GrB_Index *src, const GrB_Index *dest,
+						 EdgeID *ids, GrB_Index n) {
+	assert(g && r < Graph_RelationTypeCount(g));
+	if(n == 0) return;
+
+	GrB_Info info;
+	GrB_Index dim;
+	GrB_Index nvals;
+	GrB_Matrix batch;
+	GrB_Matrix relationMat = Graph_GetRelationMatrix(g, r);
+	GrB_Matrix_nvals(&nvals, relationMat);
+	if(nvals == 0) {
+		Graph_BuildRelation(g, r, src, dest, ids, n);
+		return;
+	}
+
+	// Sort the batch into a matrix of its own, merging edges connecting the same pair of nodes.
+	GrB_Matrix_nrows(&dim, relationMat);
+	info = GrB_Matrix_new(&batch, GrB_UINT64, dim, dim);
+	assert(info == GrB_SUCCESS);
+	for(GrB_Index i = 0; i < n; i++) ids[i] = SET_MSB(ids[i]);
+	info = GrB_Matrix_build_UINT64(batch, src, dest, ids, n, _graph_edge_accum);
+	assert(info == GrB_SUCCESS);
+
+	// Merge batch into the relation, pairs already connected accumulate the batch's edges.
+	info = GrB_Matrix_apply(relationMat, GrB_NULL, _graph_edge_merge, GrB_IDENTITY_UINT64, batch,
+							GrB_NULL);
+	assert(info == GrB_SUCCESS);
+
+	GrB_Matrix trelationMat = _Graph_GetMaterializedTransposedRelation(g, r);
+	if(trelationMat != GrB_NULL) {
+		info = GrB_transpose(trelationMat, GrB_NULL, GrB_LOR, batch, GrB_NULL);
+		assert(info == GrB_SUCCESS);
+	}
+
+	GrB_free(&batch);
+	WeightMatrices_Invalidate(g, r);
+	_Graph_InvalidateIntervals(g, r);
+}
+
+// Connections of each relation, merged concurrently.
+typedef struct {
+	Graph *g;               // Graph being populated.
+	uint relation_count;    // Number of relations.
+	uint next;              // Next relation to merge.
+	GrB_Index **src;        // Source node IDs, per relation.
+	GrB_Index **dest;       // Destination node IDs, per relation.
+	EdgeID **ids;           // Edge IDs, per relation.
+} _RelationsMergeCtx;
+
+// Merges relations until none remain, relations are claimed one at a time.
+static void *_Graph_MergeRelationsWorker(void *arg) {
+	_RelationsMergeCtx *ctx = arg;
+	uint r;
+	while((r = __atomic_fetch_add(&ctx->next, 1, __ATOMIC_RELAXED)) < ctx->relation_count) {
+		Graph_MergeRelation(ctx->g, r, ctx->src[r], ctx->dest[r], ctx->ids[r],
+							array_len(ctx->ids[r]));
+	}
+	return NULL;
+}
+
+void Graph_MergeRelations(Graph *g, GrB_Index **src, GrB_Index **dest, EdgeID **ids,
+						  uint relation_count, uint thread_count) {
+	assert(g && relation_count <= Graph_RelationTypeCount(g));
+	if(thread_count > relation_count) thread_count = relation_count;
+	if(thread_count == 0) thread_count = 1;
+
+	_RelationsMergeCtx ctx = {g, relation_count, 0, src, dest, ids};
+	pthread_t threads[thread_count];
+	uint spawned = 0;
+	for(; spawned + 1 < thread_count; spawned++) {
+		if(pthread_create(threads + spawned, NULL, _Graph_MergeRelationsWorker, &ctx) != 0) break;
+	}
+	// Calling thread participates as well.
+	_Graph_MergeRelationsWorker(&ctx);
+	for(uint i = 0; i < spawned; i++) pthread_join(threads[i], NULL);
+
+	// Adjacency matrices are shared by all relations.
+	for(uint r = 0; r < relation_count; r++) {
+		if(array_len(ids[r]) > 0) Graph_AdjacencyAddRelation(g, r);
+	}
+}
+
+int Graph_ConnectNodes(Graph *g, NodeID src, NodeID dest, int r, Edge *e) {
+	GrB_Info info;
+	Node srcNode;
+	Node destNode;
+
+	assert(Graph_GetNode(g, src, &srcNode));
+	assert(Graph_GetNode(g, dest, &destNode));
+
+	Graph_CreateEdge(g, src, dest, r, e);
+	EdgeID id = ENTITY_GET_ID(e);
 
 	GrB_Matrix adj = Graph_GetAdjacencyMatrix(g);
 	GrB_Matrix relationMat = Graph_GetRelationMatrix(g, r);
 	GrB_Matrix tadj = _Graph_Get_Transposed_AdjacencyMatrix(g);
+	GrB_Matrix trelationMat = _Graph_GetMaterializedTransposedRelation(g, r);
 
 	// Rows represent source nodes, columns represent destination nodes.
 	GrB_Matrix_setElement_BOOL(adj, true, src, dest);
 	GrB_Matrix_setElement_BOOL(tadj, true, dest, src);
+	if(trelationMat != GrB_NULL) GrB_Matrix_setElement_BOOL(trelationMat, true, dest, src);
 	GrB_Index I = src;
 	GrB_Index J = dest;
 	id = SET_MSB(id);
@@ -568,6 +1006,7 @@ int Graph_ConnectNodes(Graph *g, NodeID src, NodeID dest, int r, Edge *e) {
 			   GrB_NULL             // descriptor for C(I,J) and Mask
 		   );
 	assert(info == GrB_SUCCESS);
+	_Graph_TouchPair(g, r, src, dest);
 
 	return 1;
 }
@@ -592,25 +1031,38 @@ void Graph_GetNodeEdges(const Graph *g, const Node *n, GRAPH_EDGE_DIR dir, int e
 		else M = Graph_GetRelationMatrix(g, edgeType);
 
 		/* Construct an iterator to traverse the source node's row, which contains
-		 * all outgoing edges. */
+		 * all outgoing edges, a contiguous slice at a time. */
 		GxB_MatrixTupleIter_new(&tupleIter, M);
 		srcNodeID = ENTITY_GET_ID(n);
 		GxB_MatrixTupleIter_iterate_row(tupleIter, srcNodeID);
 		while(true) {
 			bool depleted = false;
-			GxB_MatrixTupleIter_next(tupleIter, NULL, &destNodeID, &depleted);
+			GrB_Index count;
+			const GrB_Index *dests;
+			const void *entries;
+			GxB_MatrixTupleIter_next_row(tupleIter, NULL, &dests, &entries, &count, &depleted);
 			if(depleted) break;
-			// Collect all edges connecting this source node to each of its destinations.
-			Graph_GetEdgesConnectingNodes(g, srcNodeID, destNodeID, edgeType, edges);
+			if(edgeType == GRAPH_NO_RELATION) {
+				// Collect all edges connecting this source node to each of its destinations.
+				for(GrB_Index i = 0; i < count; i++) {
+					Graph_GetEdgesConnectingNodes(g, srcNodeID, dests[i], edgeType, edges);
+				}
+			} else {
+				// The relation matrix row holds the edges themselves, no need to look them up.
+				const EdgeID *ids = (const EdgeID *)entries;
+				for(GrB_Index i = 0; i < count; i++) {
+					_Graph_CollectEdges(g, srcNodeID, dests[i], edgeType, ids[i], edges);
+				}
+			}
 		}
 		GxB_MatrixTupleIter_free(tupleIter);
 	}
 
 	// Incoming.
 	if(dir == GRAPH_EDGE_DIR_INCOMING || dir == GRAPH_EDGE_DIR_BOTH) {
-		/* Retrieve the transposed adjacency matrix, regardless of whether or not
-		 * a relationship type is specified. */
-		M = _Graph_Get_Transposed_AdjacencyMatrix(g);
+		/* Retrieve the transposed relation matrix, or the transposed adjacency matrix
+		 * if a relationship type is not specified. */
+		M = Graph_GetTransposedRelationMatrix(g, edgeType);
 
 		/* Construct an iterator to traverse the node's row, which in the transposed
 		 * adjacency matrix contains all incoming edges. */
@@ -620,12 +1072,16 @@ void Graph_GetNodeEdges(const Graph *g, const Node *n, GRAPH_EDGE_DIR dir, int e
 
 		while(true) {
 			bool depleted = false;
-			GxB_MatrixTupleIter_next(tupleIter, NULL, &srcNodeID, &depleted);
+			GrB_Index count;
+			const GrB_Index *srcs;
+			GxB_MatrixTupleIter_next_row(tupleIter, NULL, &srcs, NULL, &count, &depleted);
 			if(depleted) break;
 			/* Collect all edges connecting this destination node to each of its sources.
 			 * This call will only collect edges of the appropriate relationship type,
 			 * if one is specified. */
-			Graph_GetEdgesConnectingNodes(g, srcNodeID, destNodeID, edgeType, edges);
+			for(GrB_Index i = 0; i < count; i++) {
+				Graph_GetEdgesConnectingNodes(g, srcs[i], destNodeID, edgeType, edges);
+			}
 		}
 
 		// Clean up
@@ -633,6 +1089,75 @@ void Graph_GetNodeEdges(const Graph *g, const Node *n, GRAPH_EDGE_DIR dir, int e
 	}
 }
 
+// Number of edges held by a relation matrix entry.
+static inline uint64_t _Graph_EntryEdgeCount(EdgeID entry) {
+	if(SINGLE_EDGE(entry)) return 1;
+	return ((const MultiEdge *)entry)->count;
+}
+
+static uint64_t _Graph_GetNodeRelationDegree(const Graph *g, NodeID id, GRAPH_EDGE_DIR dir,
+											 int edgeType) {
+	GrB_Matrix R = Graph_GetRelationMatrix(g, edgeType);
+	/* Outgoing edges are held by the node's row of the relation matrix,
+	 * incoming edges are located through the transposed matrix. */
+	GrB_Matrix M = (dir == GRAPH_EDGE_DIR_OUTGOING) ? R :
+				   Graph_GetTransposedRelationMatrix(g, edgeType);
+
+	uint64_t degree = 0;
+	GxB_MatrixTupleIter *tupleIter;
+	GxB_MatrixTupleIter_new(&tupleIter, M);
+	GxB_MatrixTupleIter_iterate_row(tupleIter, id);
+	while(true) {
+		bool depleted = false;
+		GrB_Index count;
+		const GrB_Index *cols;
+		const void *entries;
+		GxB_MatrixTupleIter_next_row(tupleIter, NULL, &cols, &entries, &count, &depleted);
+		if(depleted) break;
+		for(GrB_Index i = 0; i < count; i++) {
+			EdgeID entry;
+			if(dir == GRAPH_EDGE_DIR_OUTGOING) {
+				entry = ((const EdgeID *)entries)[i];
+			} else {
+				GrB_Matrix_extractElement_UINT64(&entry, R, cols[i], id);
+			}
+			degree += _Graph_EntryEdgeCount(entry);
+		}
+	}
+	GxB_MatrixTupleIter_free(tupleIter);
+	return degree;
+}
+
+uint64_t Graph_GetNodeDegree(const Graph *g, NodeID id, GRAPH_EDGE_DIR dir, int edgeType) {
+	assert(g && (dir == GRAPH_EDGE_DIR_OUTGOING || dir == GRAPH_EDGE_DIR_INCOMING));
+	if(edgeType == GRAPH_UNKNOWN_RELATION) return 0;
+	if(edgeType != GRAPH_NO_RELATION) return _Graph_GetNodeRelationDegree(g, id, dir, edgeType);
+
+	uint64_t degree = 0;
+	int relation_count = Graph_RelationTypeCount(g);
+	for(int r = 0; r < relation_count; r++) degree += _Graph_GetNodeRelationDegree(g, id, dir, r);
+	return degree;
+}
+
+/* Removes edge from the list of edges connecting src to dest,
+ * reverting back from a list to a single edge ID
+ * incase we're left with a single edge connecting src to dest. */
+static void _Graph_RemoveFromMultiEdge(GrB_Matrix R, NodeID src_id, NodeID dest_id,
+									   MultiEdge *me, EdgeID id) {
+	uint32_t i = MultiEdge_Find(me, id);
+	assert(i < me->count);
+
+	MultiEdge *updated = MultiEdge_Remove(me, i);
+	if(updated->count == 1) {
+		EdgeID edge_id = updated->ids[0];
+		MultiEdge_Free(updated);
+		GrB_Matrix_setElement(R, SET_MSB(edge_id), src_id, dest_id);
+	} else if(updated != me) {
+		// List was relocated.
+		GrB_Matrix_setElement(R, (EdgeID)updated, src_id, dest_id);
+	}
+}
+
 /* Removes an edge from Graph and updates graph relevent matrices. */
 int Graph_DeleteEdge(Graph *g, Edge *e) {
 	uint64_t x;
@@ -653,6 +1178,8 @@ int Graph_DeleteEdge(Graph *g, Edge *e) {
 	if(SINGLE_EDGE(edge_id)) {
 		// Single edge of type R connecting src to dest, delete entry.
 		assert(GxB_Matrix_Delete(R, src_id, dest_id) == GrB_SUCCESS);
+		M = _Graph_GetMaterializedTransposedRelation(g, r);
+		if(M != GrB_NULL) assert(GxB_Matrix_Delete(M, dest_id, src_id) == GrB_SUCCESS);
 
 		// See if source is connected to destination with additional edges.
 		bool connected = false;
@@ -677,53 +1204,43 @@ int Graph_DeleteEdge(Graph *g, Edge *e) {
 			assert(GxB_Matrix_Delete(M, dest_id, src_id) == GrB_SUCCESS);
 		}
 	} else {
-		/* Multiple edges connecting src to dest
-		 * locate specific edge and remove it
-		 * revert back from array representation to edge ID
-		 * incase we're left with a single edge connecting src to dest. */
-
-		int i = 0;
-		EdgeID id = ENTITY_GET_ID(e);
-		EdgeID *edges = (EdgeID *)edge_id;
-		int edge_count = array_len(edges);
-
-		// Locate edge within edge array.
-		for(; i < edge_count; i++) if(edges[i] == id) break;
-		assert(i < edge_count);
-
-		/* Remove edge from edge array
-		 * migrate last edge ID and reduce array size.
-		 * TODO: reallocate array of size / capacity ratio is high. */
-		edges[i] = edges[edge_count - 1];
-		array_pop(edges);
-
-		/* Incase we're left with a single edge connecting src to dest
-		 * revert back from array to scalar. */
-		if(array_len(edges) == 1) {
-			edge_id = edges[0];
-			array_free(edges);
-			GrB_Matrix_setElement(R, SET_MSB(edge_id), src_id, dest_id);
-		}
+		_Graph_RemoveFromMultiEdge(R, src_id, dest_id, (MultiEdge *)edge_id, ENTITY_GET_ID(e));
 	}
+	_Graph_TouchPair(g, r, src_id, dest_id);
 
 	// Free and remove edges from datablock.
 	DataBlock_DeleteItem(g->edges, ENTITY_GET_ID(e));
 	return 1;
 }
 
+// Removes id from label, returns false if node id doesn't hold label.
+static bool _Graph_RemoveLabelEntry(Graph *g, int label, NodeID id) {
+	if(!IDSet_Remove(g->label_ids[label], id)) return false;
+	RG_Matrix matrix = g->labels[label];
+	if(matrix) GxB_Matrix_Delete(RG_Matrix_Get_GrB_Matrix(matrix), id, id);
+	return true;
+}
+
+/* Removes node from each of its labels prior to the node's deletion,
+ * discounting the labels it holds beyond its first label. */
+static void _Graph_UnlabelNode(Graph *g, NodeID id) {
+	int primary = Graph_GetNodeLabel(g, id);
+	if(primary == GRAPH_NO_LABEL) return;
+	_Graph_RemoveLabelEntry(g, primary, id);
+
+	// Look for other labels only if some node holds more than a single label.
+	int label_count = (g->secondary_labels > 0) ? Graph_LabelTypeCount(g) : 0;
+	for(int i = 0; i < label_count; i++) {
+		if(i != primary && _Graph_RemoveLabelEntry(g, i, id)) g->secondary_labels--;
+	}
+}
+
 void Graph_DeleteNode(Graph *g, Node *n) {
 	/* Assumption, node is completely detected,
 	 * there are no incoming nor outgoing edges
 	 * leading to / from node. */
 	assert(g && n);
-
-	// Clear label matrix at position node ID.
-	uint32_t label_count = array_len(g->labels);
-	for(int i = 0; i < label_count; i++) {
-		GrB_Matrix M = Graph_GetLabelMatrix(g, i);
-		GxB_Matrix_Delete(M, ENTITY_GET_ID(n), ENTITY_GET_ID(n));
-	}
-
+	_Graph_UnlabelNode(g, ENTITY_GET_ID(n));
 	DataBlock_DeleteItem(g->nodes, ENTITY_GET_ID(n));
 }
 
@@ -751,208 +1268,278 @@ static void _Graph_FreeRelationMatrices(Graph *g) {
 	GrB_free(&thunk);
 }
 
-static void _BulkDeleteNodes(Graph *g, Node *nodes, uint node_count,
-							 uint *node_deleted, uint *edge_deleted) {
-	assert(g && g->_writelocked && nodes && node_count > 0);
-
-	if(!_select_delete_edges) {
-		// The select operator has not yet been constructed; build it now.
-		GrB_Info res;
-		res = GxB_SelectOp_new(&_select_delete_edges, _select_op_free_edge, GrB_UINT64, GrB_UINT64);
-		assert(res == GrB_SUCCESS);
+// Free the edges held by a relation matrix entry, returns the number of edges freed.
+static uint64_t _Graph_FreeEntryEdges(Graph *g, EdgeID entry) {
+	uint64_t count = _Graph_EntryEdgeCount(entry);
+	if(SINGLE_EDGE(entry)) {
+		DataBlock_DeleteItem(g->edges, SINGLE_EDGE_ID(entry));
+	} else {
+		MultiEdge *me = (MultiEdge *)entry;
+		for(uint32_t i = 0; i < me->count; i++) DataBlock_DeleteItem(g->edges, me->ids[i]);
+		MultiEdge_Free(me);
 	}
+	return count;
+}
 
-	/* Create a matrix M where M[j,i] = 1 where:
-	 * Node i is connected to node j. */
-
-	GrB_Matrix A;                       // A = R(M) masked relation matrix.
-	GrB_Index nvals;                    // Number of elements in mask.
-	GrB_Matrix Mask;                    // Mask noteing all implicitly deleted edges.
-	GrB_Matrix Nodes;                   // Mask noteing each node marked for deletion.
-	GrB_Matrix adj;                     // Adjacency matrix.
-	GrB_Matrix tadj;                    // Transposed adjacency matrix.
-	GrB_Descriptor desc;                // GraphBLAS descriptor.
-	GxB_MatrixTupleIter *adj_iter;      // iterator over the adjacency matrix.
-	GxB_MatrixTupleIter *tadj_iter;     // iterator over the transposed adjacency matrix.
-
-	GrB_Descriptor_new(&desc);
-	adj = Graph_GetAdjacencyMatrix(g);
-	tadj = _Graph_Get_Transposed_AdjacencyMatrix(g);
-	GxB_MatrixTupleIter_new(&adj_iter, adj);
-	GxB_MatrixTupleIter_new(&tadj_iter, tadj);
-	GrB_Matrix_new(&A, GrB_UINT64, Graph_RequiredMatrixDim(g), Graph_RequiredMatrixDim(g));
-	GrB_Matrix_new(&Mask, GrB_BOOL, Graph_RequiredMatrixDim(g), Graph_RequiredMatrixDim(g));
-	GrB_Matrix_new(&Nodes, GrB_BOOL, Graph_RequiredMatrixDim(g), Graph_RequiredMatrixDim(g));
-
-	/* For user-defined select operators,
-	 * If Thunk is not NULL, it must be a valid GxB_Scalar. If it has no entry,
-	 * it is treated as if it had a single entry equal to zero, for built-in types (not
-	 * user-defined types).
-	 * For user-defined select operators, the entry is passed to the user-defined
-	 * select operator, with no typecasting. Its type must be identical to 'ttype' of
-	 * the select operator. */
-	GxB_Scalar thunk;
-	GxB_Scalar_new(&thunk, GrB_UINT64);
-	GxB_Scalar_setElement_UINT64(thunk, (uint64_t)g);
-
-	// Populate mask with implicit edges, take note of deleted nodes.
-	for(uint i = 0; i < node_count; i++) {
-		GrB_Index src;
-		GrB_Index dest;
-		Node *n = nodes + i;
-		bool depleted = false;
-		NodeID ID = ENTITY_GET_ID(n);
+// Returns true if sorted ids hold id.
+static bool _Graph_IDsContain(const GrB_Index *ids, uint count, GrB_Index id) {
+	uint lo = 0;
+	uint hi = count;
+	while(lo < hi) {
+		uint mid = lo + (hi - lo) / 2;
+		if(ids[mid] == id) return true;
+		if(ids[mid] < id) lo = mid + 1;
+		else hi = mid;
+	}
+	return false;
+}
 
-		// Outgoing edges.
-		GxB_MatrixTupleIter_iterate_row(adj_iter, ID);
+/* Collect the pairs connecting the nodes of rows ids of M to nodes other than ids,
+ * appending each pair as (ids[i], column) to rows and cols. */
+static void _Graph_CollectRowPairs(GxB_MatrixTupleIter *iter, GrB_Matrix M, const GrB_Index *ids,
+								   uint id_count, GrB_Index **rows, GrB_Index **cols) {
+	GxB_MatrixTupleIter_reuse(iter, M);
+	for(uint i = 0; i < id_count; i++) {
+		GxB_MatrixTupleIter_iterate_row(iter, ids[i]);
 		while(true) {
-			GxB_MatrixTupleIter_next(adj_iter, NULL,  &dest, &depleted);
+			bool depleted = false;
+			GrB_Index count;
+			const GrB_Index *row_cols;
+			GxB_MatrixTupleIter_next_row(iter, NULL, &row_cols, NULL, &count, &depleted);
 			if(depleted) break;
-			GrB_Matrix_setElement_BOOL(Mask, true, ID, dest);
+			for(GrB_Index j = 0; j < count; j++) {
+				if(_Graph_IDsContain(ids, id_count, row_cols[j])) continue;
+				*rows = array_append(*rows, ids[i]);
+				*cols = array_append(*cols, row_cols[j]);
+			}
 		}
+	}
+}
 
-		depleted = false;
-
-		// Incoming edges.
-		GxB_MatrixTupleIter_iterate_row(tadj_iter, ID);
-		while(true) {
-			GxB_MatrixTupleIter_next(tadj_iter, NULL, &src, &depleted);
-			if(depleted) break;
-			GrB_Matrix_setElement_BOOL(Mask, true, src, ID);
-		}
+/* Removes nodes and every edge connected to them from graph.
+ * Rather than masking entire matrices, the deleted nodes' rows are cleared at once
+ * and the entries of their columns are located through the transposed adjacency matrix,
+ * such that the work is proportional to the deleted nodes' degrees.
+ * Edges are freed as their entries are encountered. */
+static void _BulkDeleteNodes(Graph *g, Node *nodes, uint node_count,
+							 uint *node_deleted, uint *edge_deleted) {
+	assert(g && g->_writelocked && nodes && node_count > 0);
 
-		GrB_Matrix_setElement_BOOL(Nodes, true, ID, ID);
+	// Sorted, distinct IDs of the deleted nodes.
+	GrB_Index *ids = rm_malloc(sizeof(GrB_Index) * node_count);
+	for(uint i = 0; i < node_count; i++) ids[i] = ENTITY_GET_ID(nodes + i);
+#define is_id_lt(a, b) (*(a) < *(b))
+	QSORT(GrB_Index, ids, node_count, is_id_lt);
+	uint id_count = 0;
+	for(uint i = 0; i < node_count; i++) {
+		if(id_count == 0 || ids[id_count - 1] != ids[i]) ids[id_count++] = ids[i];
 	}
+	*node_deleted += id_count;
 
-	GrB_Matrix_nvals(&nvals, Nodes);
-	*node_deleted += nvals;
+	GrB_Index dim = Graph_RequiredMatrixDim(g);
+	GrB_Matrix adj = Graph_GetAdjacencyMatrix(g);
+	GrB_Matrix tadj = _Graph_Get_Transposed_AdjacencyMatrix(g);
 
-	GrB_Matrix_nvals(&nvals, Mask);
-	*edge_deleted += nvals;
+	/* Pairs connecting deleted nodes to the rest of the graph, in either direction,
+	 * collected before any matrix is modified, as iterators expect settled matrices.
+	 * out_srcs[i] -> out_dests[i] and in_srcs[i] -> in_dests[i], where
+	 * out_srcs and in_dests are deleted nodes. */
+	GrB_Index *out_srcs = array_new(GrB_Index, 0);
+	GrB_Index *out_dests = array_new(GrB_Index, 0);
+	GrB_Index *in_srcs = array_new(GrB_Index, 0);
+	GrB_Index *in_dests = array_new(GrB_Index, 0);
+	GxB_MatrixTupleIter *iter;
+	GxB_MatrixTupleIter_new(&iter, adj);
+	_Graph_CollectRowPairs(iter, adj, ids, id_count, &out_srcs, &out_dests);
+	_Graph_CollectRowPairs(iter, tadj, ids, id_count, &in_dests, &in_srcs);
+	uint in_count = array_len(in_srcs);
+	uint out_count = array_len(out_srcs);
+	// Maintained weights and interval entries of the disconnected pairs are resynced once retrieved.
+	for(uint i = 0; i < out_count; i++) {
+		_Graph_TouchPair(g, GRAPH_NO_RELATION, out_srcs[i], out_dests[i]);
+	}
+	for(uint i = 0; i < in_count; i++) {
+		_Graph_TouchPair(g, GRAPH_NO_RELATION, in_srcs[i], in_dests[i]);
+	}
 
-	// Clear updated output matrix before assignment.
-	GrB_Descriptor_set(desc, GrB_OUTP, GrB_REPLACE);
+	// Empty matrix, assigned to the deleted nodes' rows.
+	GrB_Matrix Z;
+	GrB_Matrix_new(&Z, GrB_BOOL, id_count, dim);
+	// Rows of the deleted nodes within a relation matrix.
+	GrB_Matrix O;
+	GrB_Matrix_new(&O, GrB_UINT64, id_count, dim);
+	// Relation matrix entries of the incoming pairs, 0 if the pair isn't connected by the relation.
+	EdgeID *in_entries = rm_malloc(sizeof(EdgeID) * (in_count + 1));
 
-	// Free and remove implicit edges from relation matrices.
 	int relation_count = Graph_RelationTypeCount(g);
-	for(int i = 0; i < relation_count; i++) {
-		GrB_Matrix R = Graph_GetRelationMatrix(g, i);
-
-		// Reset mask descriptor.
-		GrB_Descriptor_set(desc, GrB_MASK, GxB_DEFAULT);
-
-		/* Isolate implicit edges.
-		 * A will contain all implicitly deleted edges from R. */
-		GrB_Matrix_apply(A, Mask, GrB_NULL, GrB_IDENTITY_UINT64, R, desc);
+	for(int r = 0; r < relation_count; r++) {
+		GrB_Matrix R = Graph_GetRelationMatrix(g, r);
+		GrB_Matrix T = _Graph_GetMaterializedTransposedRelation(g, r);
+
+		// Read the deleted nodes' outgoing and incoming entries prior to modifying R.
+		GrB_Matrix_extract(O, GrB_NULL, GrB_NULL, R, ids, id_count, GrB_ALL, dim, GrB_NULL);
+		for(uint i = 0; i < in_count; i++) {
+			in_entries[i] = 0;
+			GrB_Matrix_extractElement_UINT64(in_entries + i, R, in_srcs[i], in_dests[i]);
+		}
 
-		/* Free each multi edge array entry in A
-		 * Call _select_op_free_edge on each entry of A. */
-		GxB_select(A, GrB_NULL, GrB_NULL, _select_delete_edges, A, thunk, GrB_NULL);
+		// Outgoing edges.
+		GxB_MatrixTupleIter_reuse(iter, O);
+		while(true) {
+			bool depleted = false;
+			GrB_Index row;
+			GrB_Index count;
+			const GrB_Index *dests;
+			const void *entries;
+			GxB_MatrixTupleIter_next_row(iter, &row, &dests, &entries, &count, &depleted);
+			if(depleted) break;
+			for(GrB_Index i = 0; i < count; i++) {
+				*edge_deleted += _Graph_FreeEntryEdges(g, ((const EdgeID *)entries)[i]);
+				// Rows of deleted nodes are cleared below.
+				if(T != GrB_NULL && !_Graph_IDsContain(ids, id_count, dests[i])) {
+					GxB_Matrix_Delete(T, dests[i], ids[row]);
+				}
+			}
+		}
 
-		// Clear the relation matrix.
-		GrB_Descriptor_set(desc, GrB_MASK, GrB_COMP);
+		// Incoming edges from nodes which aren't deleted.
+		for(uint i = 0; i < in_count; i++) {
+			if(in_entries[i] == 0) continue;
+			*edge_deleted += _Graph_FreeEntryEdges(g, in_entries[i]);
+			GxB_Matrix_Delete(R, in_srcs[i], in_dests[i]);
+		}
 
-		// Remove every entry of R marked by Mask.
-		GrB_Matrix_apply(R, Mask, GrB_NULL, GrB_IDENTITY_UINT64, R, desc);
+		// Clear the deleted nodes' rows.
+		GxB_Matrix_subassign(R, GrB_NULL, GrB_NULL, Z, ids, id_count, GrB_ALL, dim, GrB_NULL);
+		if(T != GrB_NULL) {
+			GxB_Matrix_subassign(T, GrB_NULL, GrB_NULL, Z, ids, id_count, GrB_ALL, dim, GrB_NULL);
+		}
 	}
 
-
-	/* Descriptor:
-	 * GrB_MASK, GrB_COMP */
-	GrB_Descriptor_set(desc, GrB_MASK, GrB_COMP);
-	// Update the adjacency matrix to remove deleted entries.
-	GrB_Matrix_apply(adj, Mask, GrB_NULL, GrB_IDENTITY_BOOL, adj, desc);
-
-	// Transpose the mask so that it will match the transposed adjacency matrix.
-	GrB_transpose(Mask, GrB_NULL,  GrB_NULL, Mask, GrB_NULL);
-
-	// Update the transposed adjacency matrix.
-	GrB_Matrix_apply(tadj, Mask, GrB_NULL, GrB_IDENTITY_BOOL, tadj, desc);
+	// Update the adjacency matrices.
+	GxB_Matrix_subassign(adj, GrB_NULL, GrB_NULL, Z, ids, id_count, GrB_ALL, dim, GrB_NULL);
+	GxB_Matrix_subassign(tadj, GrB_NULL, GrB_NULL, Z, ids, id_count, GrB_ALL, dim, GrB_NULL);
+	for(uint i = 0; i < out_count; i++) GxB_Matrix_Delete(tadj, out_dests[i], out_srcs[i]);
+	for(uint i = 0; i < in_count; i++) GxB_Matrix_Delete(adj, in_srcs[i], in_dests[i]);
 
 	/* Delete nodes
-	 * All nodes marked for deleteion are detected, no incoming / outgoing edges. */
-	int node_type_count = Graph_LabelTypeCount(g);
-	for(int i = 0; i < node_type_count; i++) {
-		GrB_Matrix L = Graph_GetLabelMatrix(g, i);
-		GrB_Matrix_apply(L, Nodes, GrB_NULL, GrB_IDENTITY_BOOL, L, desc);
-	}
-
-	for(uint i = 0; i < node_count; i++) {
-		Node *n = nodes + i;
-		DataBlock_DeleteItem(g->nodes, ENTITY_GET_ID(n));
+	 * All nodes marked for deletion are detached, no incoming / outgoing edges. */
+	for(uint i = 0; i < id_count; i++) {
+		_Graph_UnlabelNode(g, ids[i]);
+		DataBlock_DeleteItem(g->nodes, ids[i]);
 	}
 
 	// Clean up.
-	GrB_free(&A);
-	GrB_free(&desc);
-	GrB_free(&Mask);
-	GrB_free(&thunk);
-	GrB_free(&Nodes);
-	GxB_MatrixTupleIter_free(adj_iter);
-	GxB_MatrixTupleIter_free(tadj_iter);
+	GrB_free(&Z);
+	GrB_free(&O);
+	rm_free(in_entries);
+	rm_free(ids);
+	array_free(out_srcs);
+	array_free(out_dests);
+	array_free(in_srcs);
+	array_free(in_dests);
+	GxB_MatrixTupleIter_free(iter);
 }
 
+// Orders edges by relation type, source, destination and ID.
+static inline bool _Edge_PairLessThan(const Edge *a, const Edge *b) {
+	int ra = Edge_GetRelationID(a);
+	int rb = Edge_GetRelationID(b);
+	if(ra != rb) return ra < rb;
+	if(Edge_GetSrcNodeID(a) != Edge_GetSrcNodeID(b)) return Edge_GetSrcNodeID(a) < Edge_GetSrcNodeID(b);
+	if(Edge_GetDestNodeID(a) != Edge_GetDestNodeID(b)) return Edge_GetDestNodeID(a) < Edge_GetDestNodeID(b);
+	return ENTITY_GET_ID(a) < ENTITY_GET_ID(b);
+}
+
+static inline bool _Edge_SamePair(const Edge *a, const Edge *b) {
+	return Edge_GetRelationID(a) == Edge_GetRelationID(b) &&
+		   Edge_GetSrcNodeID(a) == Edge_GetSrcNodeID(b) &&
+		   Edge_GetDestNodeID(a) == Edge_GetDestNodeID(b);
+}
+
+/* Removes distinct edges, sorted by _Edge_PairLessThan, from the graph.
+ * The edges connecting a pair are removed from its multi-edge list in a single pass,
+ * pairs left disconnected are collected into a mask per relation type,
+ * built at once and cleared from the relation matrices by a single masked apply. */
 static void _BulkDeleteEdges(Graph *g, Edge *edges, size_t edge_count) {
 	assert(g && g->_writelocked && edges && edge_count > 0);
 
 	int relationCount = Graph_RelationTypeCount(g);
+	GrB_Index dim = Graph_RequiredMatrixDim(g);
 	GrB_Matrix masks[relationCount];
 	for(int i = 0; i < relationCount; i++) masks[i] = NULL;
 	bool update_adj_matrices = false;
 
-	for(int i = 0; i < edge_count; i++) {
+	// Pairs disconnected through the current relation type.
+	GrB_Index *srcs = array_new(GrB_Index, 0);
+	GrB_Index *dests = array_new(GrB_Index, 0);
+	bool *marks = array_new(bool, 0);
+	// IDs of the deleted edges connecting the current pair.
+	EdgeID *ids = array_new(EdgeID, 0);
+
+	size_t i = 0;
+	while(i < edge_count) {
 		Edge *e = edges + i;
 		int r = Edge_GetRelationID(e);
 		NodeID src_id = Edge_GetSrcNodeID(e);
 		NodeID dest_id = Edge_GetDestNodeID(e);
+
+		// Free and remove the pair's edges from datablock.
+		array_clear(ids);
+		for(; i < edge_count && _Edge_SamePair(e, edges + i); i++) {
+			EdgeID id = ENTITY_GET_ID(edges + i);
+			ids = array_append(ids, id);
+			DataBlock_DeleteItem(g->edges, id);
+		}
+
+		_Graph_TouchPair(g, r, src_id, dest_id);
+
 		EdgeID edge_id;
 		GrB_Matrix R = Graph_GetRelationMatrix(g, r);  // Relation matrix.
 		GrB_Matrix_extractElement(&edge_id, R, src_id, dest_id);
 
-		if(SINGLE_EDGE(edge_id)) {
-			update_adj_matrices = true;
-			GrB_Matrix mask = masks[r];    // mask noteing all deleted edges.
-			// Get mask of this relation type.
-			if(mask == NULL) {
-				GrB_Matrix_new(&mask, GrB_BOOL, Graph_RequiredMatrixDim(g), Graph_RequiredMatrixDim(g));
-				masks[r] = mask;
-			}
-			// Update mask.
-			GrB_Matrix_setElement_BOOL(mask, true, src_id, dest_id);
-		} else {
-			/* Multiple edges connecting src to dest
-			 * locate specific edge and remove it
-			 * revert back from array representation to edge ID
-			 * incase we're left with a single edge connecting src to dest. */
-
-			int i = 0;
-			EdgeID id = ENTITY_GET_ID(e);
-			EdgeID *multi_edges = (EdgeID *)edge_id;
-			int multi_edge_count = array_len(multi_edges);
-
-			// Locate edge within edge array.
-			for(; i < multi_edge_count; i++) if(multi_edges[i] == id) break;
-			assert(i < multi_edge_count);
-
-			/* Remove edge from edge array
-			 * migrate last edge ID and reduce array size.
-			 * TODO: reallocate array of size / capacity ratio is high. */
-			multi_edges[i] = multi_edges[multi_edge_count - 1];
-			array_pop(multi_edges);
-
-			/* Incase we're left with a single edge connecting src to dest
-			 * revert back from array to scalar. */
-			if(array_len(multi_edges) == 1) {
-				edge_id = multi_edges[0];
-				array_free(multi_edges);
-				GrB_Matrix_setElement(R, SET_MSB(edge_id), src_id, dest_id);
+		bool disconnected = SINGLE_EDGE(edge_id);
+		if(!disconnected) {
+			MultiEdge *me = (MultiEdge *)edge_id;
+			MultiEdge *updated = MultiEdge_RemoveMany(me, ids, array_len(ids));
+			if(updated == NULL) {
+				disconnected = true;
+			} else if(updated->count == 1) {
+				// Revert back to a single edge ID.
+				EdgeID remaining = updated->ids[0];
+				MultiEdge_Free(updated);
+				GrB_Matrix_setElement(R, SET_MSB(remaining), src_id, dest_id);
+			} else if(updated != me) {
+				// List was relocated.
+				GrB_Matrix_setElement(R, (EdgeID)updated, src_id, dest_id);
 			}
 		}
 
-		// Free and remove edges from datablock.
-		DataBlock_DeleteItem(g->edges, ENTITY_GET_ID(e));
+		if(disconnected) {
+			srcs = array_append(srcs, src_id);
+			dests = array_append(dests, dest_id);
+			marks = array_append(marks, true);
+		}
+
+		// Build the mask noting all pairs disconnected through relation r.
+		bool last_of_relation = (i == edge_count || Edge_GetRelationID(edges + i) != r);
+		if(last_of_relation && array_len(srcs) > 0) {
+			update_adj_matrices = true;
+			GrB_Matrix_new(masks + r, GrB_BOOL, dim, dim);
+			GrB_Info res = GrB_Matrix_build_BOOL(masks[r], srcs, dests, marks, array_len(srcs),
+												 GrB_LOR);
+			assert(res == GrB_SUCCESS);
+			array_clear(srcs);
+			array_clear(dests);
+			array_clear(marks);
+		}
 	}
 
+	array_free(srcs);
+	array_free(dests);
+	array_free(marks);
+	array_free(ids);
+
 	if(update_adj_matrices) {
 		GrB_Matrix remaining_mask;
 		GrB_Matrix_new(&remaining_mask, GrB_BOOL, Graph_RequiredMatrixDim(g), Graph_RequiredMatrixDim(g));
@@ -972,6 +1559,12 @@ static void _BulkDeleteEdges(Graph *g, Edge *edges, size_t edge_count) {
 				// Desc: GrB_MASK = GrB_COMP,  GrB_OUTP = GrB_REPLACE.
 				// R = R & !mask.
 				GrB_Matrix_apply(R, mask, GrB_NULL, GrB_IDENTITY_UINT64, R, desc);
+				GrB_Matrix T = _Graph_GetMaterializedTransposedRelation(g, r);
+				if(T != GrB_NULL) {
+					// T = T & !transpose(mask).
+					GrB_transpose(mask, GrB_NULL,  GrB_NULL, mask, GrB_NULL);
+					GrB_Matrix_apply(T, mask, GrB_NULL, GrB_IDENTITY_BOOL, T, desc);
+				}
 				GrB_free(&mask);
 			}
 			// Collect remaining edges. remaining_mask = remaining_mask + R.
@@ -1029,9 +1622,9 @@ void Graph_BulkDelete(Graph *g, Node *nodes, uint node_count, Edge *edges, uint
 		 * due to implicit edge deletion. */
 		if(edge_count == 0) return;
 
-		// Removing duplicates.
-#define is_edge_lt(a, b) (ENTITY_GET_ID((a)) < ENTITY_GET_ID((b)))
-		QSORT(Edge, edges, edge_count, is_edge_lt);
+		/* Removing duplicates, edges are ordered such that
+		 * the edges connecting the same pair are adjacent. */
+		QSORT(Edge, edges, edge_count, _Edge_PairLessThan);
 
 		size_t uniqueIdx = 0;
 		for(int i = 0; i < edge_count; i++) {
@@ -1049,6 +1642,144 @@ void Graph_BulkDelete(Graph *g, Node *nodes, uint node_count, Edge *edges, uint
 	*edge_deleted += edge_count;
 }
 
+/* Renumbers matrix rows and columns according to node_map,
+ * and relation matrix edge IDs according to edge_map,
+ * either mapping is optional. */
+static void _Graph_CompactMatrix(RG_Matrix m, GrB_Index dim, const uint64_t *node_map,
+								 const uint64_t *edge_map) {
+	GrB_Index nvals;
+	GrB_Matrix M = RG_Matrix_Get_GrB_Matrix(m);
+	GrB_Matrix_nvals(&nvals, M);
+
+	if(nvals == 0) {
+		assert(GxB_Matrix_resize(M, dim, dim) == GrB_SUCCESS);
+		return;
+	}
+
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * nvals);
+	GrB_Index *J = rm_malloc(sizeof(GrB_Index) * nvals);
+	uint64_t *X = rm_malloc(sizeof(uint64_t) * nvals);
+	GrB_Info info = GrB_Matrix_extractTuples_UINT64(I, J, X, &nvals, M);
+	assert(info == GrB_SUCCESS);
+
+	for(GrB_Index k = 0; k < nvals; k++) {
+		if(node_map) {
+			I[k] = node_map[I[k]];
+			J[k] = node_map[J[k]];
+		}
+		if(edge_map) {
+			if(SINGLE_EDGE(X[k])) {
+				X[k] = SET_MSB(edge_map[SINGLE_EDGE_ID(X[k])]);
+			} else {
+				// Multiple edges, list is updated in place.
+				MultiEdge *me = (MultiEdge *)X[k];
+				for(uint32_t i = 0; i < me->count; i++) me->ids[i] = edge_map[me->ids[i]];
+			}
+		}
+	}
+
+	// Rebuild matrix at its new dimension.
+	assert(GrB_Matrix_clear(M) == GrB_SUCCESS);
+	assert(GxB_Matrix_resize(M, dim, dim) == GrB_SUCCESS);
+	info = GrB_Matrix_build_UINT64(M, I, J, X, nvals, GrB_FIRST_UINT64);
+	assert(info == GrB_SUCCESS);
+
+	rm_free(I);
+	rm_free(J);
+	rm_free(X);
+}
+
+// Renumbers the IDs held by set through map.
+static void _Graph_RemapIDSet(IDSet **set, const uint64_t *map) {
+	uint64_t id;
+	IDSetIterator it;
+	IDSet *remapped = IDSet_New();
+	IDSet_Iterate(*set, &it);
+	while(IDSetIterator_Next(&it, &id)) IDSet_Add(remapped, map[id]);
+	IDSet_Free(*set);
+	*set = remapped;
+}
+
+void Graph_Defragment(Graph *g, uint64_t *nodes_reclaimed, uint64_t *edges_reclaimed) {
+	assert(g && g->_writelocked);
+
+	*nodes_reclaimed = array_len(g->nodes->deletedIdx);
+	*edges_reclaimed = array_len(g->edges->deletedIdx);
+	if(*nodes_reclaimed == 0 && *edges_reclaimed == 0) return;
+
+	/* Move entities to the lowest available IDs, each entity's ID
+	 * is reduced by the number of deleted IDs preceding it,
+	 * matching the renumbering performed when the graph is persisted. */
+	uint64_t *node_map = DataBlock_Compact(g->nodes);
+	uint64_t *edge_map = DataBlock_Compact(g->edges);
+
+	Entity *en;
+	DataBlockIterator *it;
+	EntityID id = 0;
+	it = Graph_ScanNodes(g);
+	while((en = (Entity *)DataBlockIterator_Next(it)) != NULL) en->id = id++;
+	DataBlockIterator_Free(it);
+
+	id = 0;
+	it = Graph_ScanEdges(g);
+	while((en = (Entity *)DataBlockIterator_Next(it)) != NULL) en->id = id++;
+	DataBlockIterator_Free(it);
+
+	GrB_Index dim = Graph_RequiredMatrixDim(g);
+	_Graph_CompactMatrix(g->adjacency_matrix, dim, node_map, NULL);
+	_Graph_CompactMatrix(g->_t_adjacency_matrix, dim, node_map, NULL);
+	_Graph_CompactMatrix(g->_zero_matrix, dim, NULL, NULL);
+
+	uint label_count = Graph_LabelTypeCount(g);
+	for(uint i = 0; i < label_count; i++) {
+		if(node_map) _Graph_RemapIDSet(g->label_ids + i, node_map);
+		if(g->labels[i]) _Graph_CompactMatrix(g->labels[i], dim, node_map, NULL);
+	}
+
+	uint relation_count = Graph_RelationTypeCount(g);
+	for(uint i = 0; i < relation_count; i++) {
+		_Graph_CompactMatrix(g->relations[i], dim, node_map, edge_map);
+		if(g->_t_relations[i]) _Graph_CompactMatrix(g->_t_relations[i], dim, node_map, NULL);
+	}
+
+	if(node_map) rm_free(node_map);
+	if(edge_map) rm_free(edge_map);
+	// Interval entries refer to the previous IDs.
+	_Graph_InvalidateIntervals(g, GRAPH_NO_RELATION);
+}
+
+void Graph_PermuteNodes(Graph *g, const uint64_t *perm) {
+	assert(g && perm && g->_writelocked);
+	assert(array_len(g->nodes->deletedIdx) == 0);
+
+	DataBlock_Permute(g->nodes, perm);
+
+	Entity *en;
+	EntityID id = 0;
+	DataBlockIterator *it = Graph_ScanNodes(g);
+	while((en = (Entity *)DataBlockIterator_Next(it)) != NULL) en->id = id++;
+	DataBlockIterator_Free(it);
+
+	// Edge IDs are unaffected.
+	GrB_Index dim = Graph_RequiredMatrixDim(g);
+	_Graph_CompactMatrix(g->adjacency_matrix, dim, perm, NULL);
+	_Graph_CompactMatrix(g->_t_adjacency_matrix, dim, perm, NULL);
+
+	uint label_count = Graph_LabelTypeCount(g);
+	for(uint i = 0; i < label_count; i++) {
+		_Graph_RemapIDSet(g->label_ids + i, perm);
+		if(g->labels[i]) _Graph_CompactMatrix(g->labels[i], dim, perm, NULL);
+	}
+
+	uint relation_count = Graph_RelationTypeCount(g);
+	for(uint i = 0; i < relation_count; i++) {
+		_Graph_CompactMatrix(g->relations[i], dim, perm, NULL);
+		if(g->_t_relations[i]) _Graph_CompactMatrix(g->_t_relations[i], dim, perm, NULL);
+	}
+	// Interval entries refer to the previous node IDs.
+	_Graph_InvalidateIntervals(g, GRAPH_NO_RELATION);
+}
+
 DataBlockIterator *Graph_ScanNodes(const Graph *g) {
 	assert(g);
 	return DataBlock_Scan(g->nodes);
@@ -1059,10 +1790,19 @@ DataBlockIterator *Graph_ScanEdges(const Graph *g) {
 	return DataBlock_Scan(g->edges);
 }
 
+/* Label and relation matrices are usually far sparser than the adjacency matrix,
+ * let GraphBLAS switch them to hypersparse format once most of their rows are empty,
+ * avoiding a row pointer per node. */
+static inline void _RG_Matrix_AllowHypersparse(RG_Matrix m) {
+	GrB_Matrix M = RG_Matrix_Get_GrB_Matrix(m);
+	assert(GxB_Matrix_Option_set(M, GxB_HYPER, GxB_HYPER_DEFAULT) == GrB_SUCCESS);
+}
+
 int Graph_AddLabel(Graph *g) {
 	assert(g);
-	RG_Matrix m = RG_Matrix_New(GrB_BOOL, Graph_RequiredMatrixDim(g), Graph_RequiredMatrixDim(g));
-	array_append(g->labels, m);
+	g->label_ids = array_append(g->label_ids, IDSet_New());
+	// Label matrix is built on first request.
+	g->labels = array_append(g->labels, NULL);
 	return array_len(g->labels) - 1;
 }
 
@@ -1070,12 +1810,23 @@ int Graph_AddRelationType(Graph *g) {
 	assert(g);
 
 	RG_Matrix m = RG_Matrix_New(GrB_UINT64, Graph_RequiredMatrixDim(g), Graph_RequiredMatrixDim(g));
+	_RG_Matrix_AllowHypersparse(m);
 	g->relations = array_append(g->relations, m);
+	// Transposed relation matrix is built on first request.
+	g->_t_relations = array_append(g->_t_relations, NULL);
 
 	int relationID = Graph_RelationTypeCount(g) - 1;
 	return relationID;
 }
 
+void Graph_SetIntervalIndex(Graph *g, int r, IntervalIndex *idx) {
+	assert(g && r < Graph_RelationTypeCount(g));
+	while(array_len(g->_intervals) <= (uint)r) {
+		g->_intervals = array_append(g->_intervals, (IntervalIndex *)NULL);
+	}
+	g->_intervals[r] = idx;
+}
+
 GrB_Matrix Graph_GetAdjacencyMatrix(const Graph *g) {
 	assert(g);
 	RG_Matrix m = g->adjacency_matrix;
@@ -1083,13 +1834,60 @@ GrB_Matrix Graph_GetAdjacencyMatrix(const Graph *g) {
 	return RG_Matrix_Get_GrB_Matrix(m);
 }
 
+// Builds label's diagonal matrix from the label's node IDs.
+static RG_Matrix _Graph_BuildLabelMatrix(const Graph *g, int label) {
+	GrB_Index dim = Graph_RequiredMatrixDim(g);
+	RG_Matrix m = RG_Matrix_New(GrB_BOOL, dim, dim);
+	_RG_Matrix_AllowHypersparse(m);
+
+	const IDSet *ids = g->label_ids[label];
+	GrB_Index n = IDSet_Cardinality(ids);
+	if(n == 0) return m;
+
+	uint64_t id;
+	GrB_Index k = 0;
+	IDSetIterator it;
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * n);
+	bool *X = rm_malloc(sizeof(bool) * n);
+	IDSet_Iterate(ids, &it);
+	while(IDSetIterator_Next(&it, &id)) {
+		I[k] = id;
+		X[k] = true;
+		k++;
+	}
+
+	GrB_Info info = GrB_Matrix_build_BOOL(RG_Matrix_Get_GrB_Matrix(m), I, I, X, n, GrB_FIRST_BOOL);
+	assert(info == GrB_SUCCESS);
+	rm_free(I);
+	rm_free(X);
+	return m;
+}
+
 GrB_Matrix Graph_GetLabelMatrix(const Graph *g, int label_idx) {
 	assert(g && label_idx < array_len(g->labels));
-	RG_Matrix m = g->labels[label_idx];
+	RG_Matrix m = __atomic_load_n(g->labels + label_idx, __ATOMIC_ACQUIRE);
+	if(m == NULL) {
+		/* First request, concurrent readers are serialized on the labels lock.
+		 * Once built the matrix is maintained alongside the label's node IDs. */
+		pthread_mutex_t *lock = (pthread_mutex_t *)&g->_labels_mutex;
+		pthread_mutex_lock(lock);
+		m = g->labels[label_idx];
+		if(m == NULL) {
+			m = _Graph_BuildLabelMatrix(g, label_idx);
+			__atomic_store_n(g->labels + label_idx, m, __ATOMIC_RELEASE);
+		}
+		pthread_mutex_unlock(lock);
+	}
+
 	g->SynchronizeMatrix(g, m);
 	return RG_Matrix_Get_GrB_Matrix(m);
 }
 
+const IDSet *Graph_GetLabelIDs(const Graph *g, int label) {
+	assert(g && label >= 0 && label < array_len(g->label_ids));
+	return g->label_ids[label];
+}
+
 GrB_Matrix Graph_GetRelationMatrix(const Graph *g, int relation_idx) {
 	assert(g && (relation_idx == GRAPH_NO_RELATION || relation_idx < Graph_RelationTypeCount(g)));
 
@@ -1102,6 +1900,36 @@ GrB_Matrix Graph_GetRelationMatrix(const Graph *g, int relation_idx) {
 	}
 }
 
+GrB_Matrix Graph_GetTransposedRelationMatrix(const Graph *g, int relation_idx) {
+	assert(g && (relation_idx == GRAPH_NO_RELATION || relation_idx < Graph_RelationTypeCount(g)));
+
+	if(relation_idx == GRAPH_NO_RELATION) return _Graph_Get_Transposed_AdjacencyMatrix(g);
+
+	GrB_Matrix T = _Graph_GetMaterializedTransposedRelation(g, relation_idx);
+	if(T != GrB_NULL) return T;
+
+	/* First request, build transposed matrix from the relation matrix,
+	 * concurrent readers are serialized on the relation matrix lock. */
+	GrB_Matrix R = Graph_GetRelationMatrix(g, relation_idx);
+	RG_Matrix rg_relation = g->relations[relation_idx];
+	RG_Matrix_Lock(rg_relation);
+
+	RG_Matrix t = g->_t_relations[relation_idx];
+	if(t == NULL) {
+		GrB_Index dims;
+		GrB_Matrix_nrows(&dims, R);
+		t = RG_Matrix_New(GrB_BOOL, dims, dims);
+		_RG_Matrix_AllowHypersparse(t);
+		GrB_Info info = GrB_transpose(RG_Matrix_Get_GrB_Matrix(t), GrB_NULL, GrB_NULL, R, GrB_NULL);
+		assert(info == GrB_SUCCESS);
+		__atomic_store_n(g->_t_relations + relation_idx, t, __ATOMIC_RELEASE);
+	}
+
+	_RG_Matrix_Unlock(rg_relation);
+	g->SynchronizeMatrix(g, t);
+	return RG_Matrix_Get_GrB_Matrix(t);
+}
+
 GrB_Matrix Graph_GetZeroMatrix(const Graph *g) {
 	GrB_Index nvals;
 	RG_Matrix z = g->_zero_matrix;
@@ -1114,11 +1942,61 @@ GrB_Matrix Graph_GetZeroMatrix(const Graph *g) {
 	return grb_z;
 }
 
-void Graph_Free(Graph *g) {
+/* Estimates the bytes held by matrix: entries with their indices and values,
+ * and vector pointers, one per row, or per non-empty row of a hypersparse matrix.
+ * Edge ID arrays of multi-edge entries aren't accounted for. */
+static size_t _Graph_MatrixMemoryUsage(const Graph *g, RG_Matrix m) {
+	if(m == NULL) return 0;
+	g->SynchronizeMatrix(g, m);
+
+	GrB_Type type;
+	size_t type_size;
+	bool hyper;
+	GrB_Index nrows;
+	GrB_Index nvals;
+	// Counting entries of a matrix with pending changes applies them.
+	RG_Matrix_Lock(m);
+	GrB_Matrix M = RG_Matrix_Get_GrB_Matrix(m);
+	GrB_Matrix_nrows(&nrows, M);
+	GrB_Matrix_nvals(&nvals, M);
+	GxB_Matrix_type(&type, M);
+	GxB_Type_size(&type_size, type);
+	GxB_Matrix_Option_get(M, GxB_IS_HYPER, &hyper);
+	_RG_Matrix_Unlock(m);
+
+	size_t vectors = (hyper) ? 2 * ((nvals < nrows) ? nvals : nrows) : nrows + 1;
+	return sizeof(_RG_Matrix) + nvals * (sizeof(GrB_Index) + type_size) +
+		   vectors * sizeof(GrB_Index);
+}
+
+size_t Graph_MatricesMemoryUsage(const Graph *g, size_t *labels, size_t *relations) {
+	assert(g);
+	int label_count = Graph_LabelTypeCount(g);
+	for(int i = 0; i < label_count; i++) {
+		RG_Matrix l = __atomic_load_n(g->labels + i, __ATOMIC_ACQUIRE);
+		labels[i] = IDSet_MemoryUsage(g->label_ids[i]) + _Graph_MatrixMemoryUsage(g, l);
+	}
+
+	int relation_count = Graph_RelationTypeCount(g);
+	for(int i = 0; i < relation_count; i++) {
+		RG_Matrix t = __atomic_load_n(g->_t_relations + i, __ATOMIC_ACQUIRE);
+		relations[i] = _Graph_MatrixMemoryUsage(g, g->relations[i]) + _Graph_MatrixMemoryUsage(g, t);
+	}
+
+	return _Graph_MatrixMemoryUsage(g, g->adjacency_matrix) +
+		   _Graph_MatrixMemoryUsage(g, g->_t_adjacency_matrix) +
+		   _Graph_MatrixMemoryUsage(g, g->_zero_matrix);
+}
+
+struct GraphRelease {
+	Graph *g;               // Graph being released.
+	DataBlockIterator *it;  // Scans the entities yet to be freed, NULL once all are freed.
+	bool edges;             // Edges are being freed, nodes are freed first.
+};
+
+GraphRelease *Graph_BeginFree(Graph *g) {
 	assert(g);
 	// Free matrices.
-	Entity *en;
-	DataBlockIterator *it;
 	RG_Matrix_Free(g->_zero_matrix);
 	RG_Matrix_Free(g->adjacency_matrix);
 	RG_Matrix_Free(g->_t_adjacency_matrix);
@@ -1126,33 +2004,68 @@ void Graph_Free(Graph *g) {
 	_Graph_FreeRelationMatrices(g);
 	array_free(g->relations);
 
+	uint32_t relationCount = array_len(g->_t_relations);
+	for(int i = 0; i < relationCount; i++) {
+		if(g->_t_relations[i]) RG_Matrix_Free(g->_t_relations[i]);
+	}
+	array_free(g->_t_relations);
+
 	uint32_t labelCount = array_len(g->labels);
 	for(int i = 0; i < labelCount; i++) {
-		RG_Matrix_Free(g->labels[i]);
+		if(g->labels[i]) RG_Matrix_Free(g->labels[i]);
+		IDSet_Free(g->label_ids[i]);
 	}
 	array_free(g->labels);
+	array_free(g->label_ids);
+	PropertyColumns_Free(g->_columns);
+	DegreeStats_Free(g->_degrees);
+	WeightMatrices_Free(g->_weights);
+	// Interval indices are freed by their schemas.
+	array_free(g->_intervals);
+	rm_free(g->latencies);
+
+	GraphRelease *release = rm_malloc(sizeof(GraphRelease));
+	release->g = g;
+	release->it = Graph_ScanNodes(g);
+	release->edges = false;
+	return release;
+}
 
-	it = Graph_ScanNodes(g);
-	while((en = (Entity *)DataBlockIterator_Next(it)) != NULL)
-		FreeEntity(en);
-
-	DataBlockIterator_Free(it);
-
-	it = Graph_ScanEdges(g);
-	while((en = DataBlockIterator_Next(it)) != NULL)
-		FreeEntity(en);
+bool Graph_FreeStep(GraphRelease *release, uint64_t count) {
+	assert(release);
+	Graph *g = release->g;
+	Entity *en;
 
-	DataBlockIterator_Free(it);
+	while(release->it && count > 0) {
+		if((en = DataBlockIterator_Next(release->it)) != NULL) {
+			FreeEntity(en);
+			count--;
+			continue;
+		}
+		// Scan depleted, edges follow nodes.
+		DataBlockIterator_Free(release->it);
+		release->it = (release->edges) ? NULL : Graph_ScanEdges(g);
+		release->edges = true;
+	}
+	if(release->it) return false;
 
 	// Free blocks.
 	DataBlock_Free(g->nodes);
 	DataBlock_Free(g->edges);
 
 	assert(pthread_mutex_destroy(&g->_writers_mutex) == 0);
+	pthread_mutex_destroy(&g->_labels_mutex);
 
 	if(g->_writelocked) Graph_ReleaseLock(g);
 	assert(pthread_rwlock_destroy(&g->_rwlock) == 0);
 
 	rm_free(g);
+	rm_free(release);
+	return true;
+}
+
+void Graph_Free(Graph *g) {
+	GraphRelease *release = Graph_BeginFree(g);
+	while(!Graph_FreeStep(release, UINT64_MAX));
 }
 
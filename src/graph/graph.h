@@ -14,11 +14,13 @@
 #include "../redismodule.h"
 #include "rax.h"
 #include "../util/datablock/datablock.h"
+#include "../util/id_set.h"
+#include "../util/latency_histogram.h"
 #include "../util/datablock/datablock_iterator.h"
 #include "../../deps/GraphBLAS/Include/GraphBLAS.h"
 
-#define GRAPH_DEFAULT_NODE_CAP 16384            // Default number of nodes a graph can hold before resizing.
-#define GRAPH_DEFAULT_EDGE_CAP 16384            // Default number of edges a graph can hold before resizing.
+#define GRAPH_DEFAULT_NODE_CAP 64               // Default number of nodes a graph can hold before resizing.
+#define GRAPH_DEFAULT_EDGE_CAP 64               // Default number of edges a graph can hold before resizing.
 #define GRAPH_DEFAULT_RELATION_TYPE_CAP 16      // Default number of different relationship types a graph can hold before resizing.
 #define GRAPH_DEFAULT_LABEL_CAP 16              // Default number of different labels a graph can hold before resizing.
 #define GRAPH_NO_LABEL -1                       // Labels are numbered [0-N], -1 represents no label.
@@ -51,6 +53,18 @@ typedef enum {
 	DISABLED,
 } MATRIX_POLICY;
 
+// Latency distributions tracked per graph.
+typedef enum {
+	GRAPH_LATENCY_READ_QUERY,       // Execution of read-only queries.
+	GRAPH_LATENCY_WRITE_QUERY,      // Execution of queries which may modify the graph.
+	GRAPH_LATENCY_QUEUE_WAIT,       // Time queries waited for a thread.
+	GRAPH_LATENCY_READ_LOCK_WAIT,   // Time readers waited for the read-write lock.
+	GRAPH_LATENCY_WRITER_WAIT,      // Time writers waited for preceding writers.
+	GRAPH_LATENCY_WRITE_LOCK_WAIT,  // Time writers waited for the read-write lock.
+	GRAPH_LATENCY_MATRIX_SYNC,      // Time spent applying pending matrix changes.
+	GRAPH_LATENCY_COUNT
+} GraphLatency;
+
 // Forward declaration of RG_Matrix type. Internal to graph.
 typedef struct {
 	GrB_Matrix grb_matrix;              // Underlying GrB_Matrix.
@@ -60,6 +74,14 @@ typedef _RG_Matrix *RG_Matrix;
 
 // Forward declaration of Graph struct
 typedef struct Graph Graph;
+// Forward declaration of the columnar property store.
+struct PropertyColumns;
+// Forward declaration of the degree statistics.
+struct DegreeStats;
+// Forward declaration of the weight matrices.
+struct WeightMatrices;
+// Forward declaration of the interval index.
+struct IntervalIndex;
 // typedef for synchronization function pointer
 typedef void (*SyncMatrixFunc)(const Graph *, RG_Matrix);
 
@@ -68,13 +90,23 @@ struct Graph {
 	DataBlock *edges;                   // Graph edges stored in blocks.
 	RG_Matrix adjacency_matrix;         // Adjacency matrix, holds all graph connections.
 	RG_Matrix _t_adjacency_matrix;      // Transposed Adjacency matrix.
-	RG_Matrix *labels;                  // Label matrices.
+	IDSet **label_ids;                  // IDs of the nodes holding each label.
+	RG_Matrix *labels;                  // Label matrices, NULL until first requested.
 	RG_Matrix *relations;               // Relation matrices.
+	RG_Matrix *_t_relations;            // Transposed relation matrices, NULL until first requested.
 	RG_Matrix _zero_matrix;             // Zero matrix.
 	pthread_mutex_t _writers_mutex;     // Mutex restrict single writer.
+	pthread_mutex_t _labels_mutex;      // Serializes label matrices materialization.
 	pthread_rwlock_t _rwlock;           // Read-write lock scoped to this specific graph
 	bool _writelocked;                  // true if the read-write lock was acquired by a writer
+	uint64_t secondary_labels;          // Number of label assignments beyond nodes' first label.
+	uint64_t version;                   // Incremented whenever a writer acquires the graph.
+	struct PropertyColumns *_columns;   // Columnar copies of node attributes, valid for the current version.
+	struct DegreeStats *_degrees;       // Per relation degree summaries.
+	struct WeightMatrices *_weights;    // Weighted relation matrices, valid for the current version.
+	struct IntervalIndex **_intervals;  // Interval indices kept in sync with edge writes, per relation.
 	SyncMatrixFunc SynchronizeMatrix;   // Function pointer to matrix synchronization routine.
+	LatencyHistogram *latencies;        // Latency distribution per GraphLatency.
 };
 
 /* Graph synchronization functions
@@ -83,6 +115,9 @@ struct Graph {
 /* Acquire a lock that does not restrict access from additional reader threads */
 void Graph_AcquireReadLock(Graph *g);
 
+/* Attempt to acquire the read lock without blocking, returns false if a writer holds it. */
+bool Graph_TryAcquireReadLock(Graph *g);
+
 /* Acquire a lock for exclusive access to this graph's data */
 void Graph_AcquireWriteLock(Graph *g);
 
@@ -95,6 +130,27 @@ void Graph_WriterLeave(Graph *g);
 /* Release the held lock */
 void Graph_ReleaseLock(Graph *g);
 
+/* Attempt to hold the graph exclusively without blocking, excluding readers
+ * as well as writers executing ahead of their commit. Returns false if the graph
+ * is in use, otherwise the graph is released by Graph_ReleaseExclusive. */
+bool Graph_TryAcquireExclusive(Graph *g);
+
+/* Release the graph held by Graph_TryAcquireExclusive. */
+void Graph_ReleaseExclusive(Graph *g);
+
+/* Record a latency of ms milliseconds, latencies are recorded without holding the graph. */
+void Graph_RecordLatency(const Graph *g, GraphLatency latency, double ms);
+
+/* Returns the number of milliseconds the calling thread spent synchronizing matrices,
+ * waiting for concurrent synchronizations included, since the thread started. */
+double Graph_ThreadSyncTime(void);
+
+/* Returns the latency distribution of the graph, which may be recorded into concurrently. */
+const LatencyHistogram *Graph_GetLatency(const Graph *g, GraphLatency latency);
+
+/* Returns the name of latency, as reported by GRAPH.STATS. */
+const char *Graph_LatencyName(GraphLatency latency);
+
 /* Choose the current matrix synchronization policy. */
 void Graph_SetMatrixPolicy(Graph *g, MATRIX_POLICY policy);
 
@@ -107,6 +163,14 @@ Graph *Graph_New(
 	size_t edge_cap     // Allocation size for edge datablocks.
 );
 
+/* Creates a copy of graph, clone_entity duplicates the properties of each copied entity.
+ * Caller is expected to hold the graph's read lock. */
+Graph *Graph_Clone(
+	const Graph *g,             // Graph to copy.
+	fpItemClone clone_entity,   // Entity content clone routine.
+	void *arg                   // Passed to clone_entity.
+);
+
 // Creates a new label matrix, returns id given to label.
 int Graph_AddLabel(
 	Graph *g
@@ -117,6 +181,14 @@ int Graph_AddRelationType(
 	Graph *g
 );
 
+/* Keep idx in sync with the edge writes of relation r, NULL stops syncing.
+ * The index is owned by the relation's schema. Expects the write lock. */
+void Graph_SetIntervalIndex(
+	Graph *g,
+	int r,
+	struct IntervalIndex *idx
+);
+
 // Make sure graph can hold an additional N nodes.
 void Graph_AllocateNodes(
 	Graph *g,               // Graph for which nodes will be added.
@@ -137,6 +209,30 @@ void Graph_CreateNode(
 	Node *n
 );
 
+// Reserves n node IDs at once, reserved nodes are introduced via Graph_StageNode.
+void Graph_ReserveNodes(
+	Graph *g,
+	uint64_t n,             // Number of nodes to reserve.
+	NodeID *ids             // [output] reserved IDs, holds n entries.
+);
+
+// Initializes the unlabeled node at reserved position id.
+// Distinct reserved nodes can be staged concurrently,
+// labeling them via Graph_LabelNode must be serialized.
+void Graph_StageNode(
+	Graph *g,
+	NodeID id,
+	Node *n
+);
+
+// Adds an additional label to an existing node.
+// The first label assigned to a node remains its primary label.
+void Graph_LabelNode(
+	Graph *g,
+	NodeID id,
+	int label
+);
+
 // Connects source node to destination node.
 // Returns 1 if connection is formed, 0 otherwise.
 int Graph_ConnectNodes(
@@ -147,6 +243,63 @@ int Graph_ConnectNodes(
 	Edge *e
 );
 
+/* Creates an edge of type r connecting source node to destination node,
+ * without introducing the connection to the graph's matrices,
+ * these are populated in bulk by Graph_BuildRelation. */
+void Graph_CreateEdge(
+	Graph *g,           // Graph on which to operate.
+	NodeID src,         // Source node ID.
+	NodeID dest,        // Destination node ID.
+	int r,              // Edge type.
+	Edge *e
+);
+
+/* Populates the matrices of relation r with n edges, where edge ids[i]
+ * connects src[i] to dest[i], the relation matrix is expected to be empty.
+ * ids is modified by this call. Relations can be built concurrently,
+ * the connections are introduced to the adjacency matrices by Graph_AdjacencyAddRelation. */
+void Graph_BuildRelation(
+	Graph *g,               // Graph on which to operate.
+	int r,                  // Edge type.
+	const GrB_Index *src,   // Source node IDs.
+	const GrB_Index *dest,  // Destination node IDs.
+	EdgeID *ids,            // Edge IDs.
+	GrB_Index n             // Number of edges.
+);
+
+/* Merges n edges into the matrices of relation r, where edge ids[i] connects src[i] to dest[i],
+ * the relation might already hold edges. ids is modified by this call.
+ * Relations can be merged concurrently, the connections are introduced
+ * to the adjacency matrices by Graph_AdjacencyAddRelation. */
+void Graph_MergeRelation(
+	Graph *g,               // Graph on which to operate.
+	int r,                  // Edge type.
+	const GrB_Index *src,   // Source node IDs.
+	const GrB_Index *dest,  // Destination node IDs.
+	EdgeID *ids,            // Edge IDs.
+	GrB_Index n             // Number of edges.
+);
+
+/* Merges the edges of relations [0, relation_count) using up to thread_count threads,
+ * src[r], dest[r] and ids[r] are arr.h arrays holding the edges of relation r,
+ * the adjacency matrices are updated once all relations are merged.
+ * Dedicated threads are spawned, as the thread pools might be occupied by queries
+ * waiting on a lock held by the caller. */
+void Graph_MergeRelations(
+	Graph *g,               // Graph on which to operate.
+	GrB_Index **src,        // Source node IDs, per relation.
+	GrB_Index **dest,       // Destination node IDs, per relation.
+	EdgeID **ids,           // Edge IDs, per relation, modified by this call.
+	uint relation_count,    // Number of relations.
+	uint thread_count       // Maximum number of threads.
+);
+
+// Introduces the connections of relation r to the adjacency matrices.
+void Graph_AdjacencyAddRelation(
+	Graph *g,               // Graph on which to operate.
+	int r                   // Edge type.
+);
+
 // Removes node and all of its connections within the graph.
 void Graph_DeleteNode(
 	Graph *g,
@@ -170,8 +323,25 @@ void Graph_BulkDelete(
 	uint *edge_deleted  // Number of edges removed.
 );
 
+// Renumbers nodes and edges densely, preserving their relative order,
+// and rebuilds graph matrices at the reduced dimension.
+// Reports the number of reclaimed node and edge IDs.
+void Graph_Defragment(
+	Graph *g,                   // Graph to compact.
+	uint64_t *nodes_reclaimed,  // Number of node IDs reclaimed.
+	uint64_t *edges_reclaimed   // Number of edge IDs reclaimed.
+);
+
+// Renumbers nodes, node i is assigned ID perm[i], graph must not contain deleted nodes.
+// Simply a relabeling, the graph's structure is unaffected.
+void Graph_PermuteNodes(
+	Graph *g,                   // Graph to reorder.
+	const uint64_t *perm        // Permutation of node IDs.
+);
+
 // All graph matrices are required to be squared NXN
-// where N is Graph_RequiredMatrixDim.
+// where N is Graph_RequiredMatrixDim, the number of node slots rounded up
+// to leave headroom for new nodes.
 size_t Graph_RequiredMatrixDim(
 	const Graph *g
 );
@@ -229,8 +399,24 @@ int Graph_GetNodeLabel(
 	NodeID nodeID
 );
 
+// Retrieves node labels, primary label first,
+// writes up to cap labels and returns the total number of node labels.
+uint Graph_GetNodeLabels(
+	const Graph *g,
+	NodeID nodeID,
+	int *labels,
+	uint cap
+);
+
+// Checks if node is labeled as label.
+bool Graph_IsNodeLabeled(
+	const Graph *g,
+	NodeID nodeID,
+	int label
+);
+
 // Retrieves edge with given id from graph,
-// Returns NULL if edge wasn't found.
+// Returns NULL if edge wasn't found, including IDs past the graph's capacity.
 int Graph_GetEdge(
 	const Graph *g,
 	EdgeID id,
@@ -274,19 +460,34 @@ void Graph_GetNodeEdges(
 	Edge **edges            // array_t incoming/outgoing edges.
 );
 
+// Counts node's edges in direction dir, without retrieving them.
+uint64_t Graph_GetNodeDegree(
+	const Graph *g,         // Graph to count edges in.
+	NodeID id,              // Node whose edges are counted.
+	GRAPH_EDGE_DIR dir,     // Edge direction, either incoming or outgoing.
+	int edgeType            // Relation type, GRAPH_NO_RELATION counts every type.
+);
+
 // Retrieves the adjacency matrix.
 // Matrix is resized if its size doesn't match graph's node count.
 GrB_Matrix Graph_GetAdjacencyMatrix(
 	const Graph *g
 );
 
-// Retrieves a label matrix.
+// Retrieves a label matrix, built from the label's node IDs on first request.
 // Matrix is resized if its size doesn't match graph's node count.
 GrB_Matrix Graph_GetLabelMatrix(
 	const Graph *g,     // Graph from which to get adjacency matrix.
 	int label           // Label described by matrix.
 );
 
+// Retrieves the IDs of the nodes holding label,
+// cheaper than the label matrix for scans and membership tests.
+const IDSet *Graph_GetLabelIDs(
+	const Graph *g,
+	int label
+);
+
 // Retrieves a typed adjacency matrix.
 // Matrix is resized if its size doesn't match graph's node count.
 GrB_Matrix Graph_GetRelationMatrix(
@@ -294,14 +495,49 @@ GrB_Matrix Graph_GetRelationMatrix(
 	int relation        // Relation described by matrix.
 );
 
+// Retrieves a transposed typed adjacency matrix.
+// Matrix is built on first request and maintained by subsequent writes,
+// GRAPH_NO_RELATION retrieves the transposed adjacency matrix.
+// Matrix is resized if its size doesn't match graph's node count.
+GrB_Matrix Graph_GetTransposedRelationMatrix(
+	const Graph *g,     // Graph from which to get adjacency matrix.
+	int relation        // Relation described by matrix.
+);
+
 // Retrieves the zero matrix.
 // The function will resize it to match all other
 // internal matrices, caller mustn't modify it in any way.
 GrB_Matrix Graph_GetZeroMatrix(const Graph *g);
 
+/* Estimates the bytes held by the graph's matrices, sets labels[i] to label i's node IDs
+ * and matrix, once materialized, and relations[i] to relation i's matrix, including its transpose once materialized.
+ * Returns the bytes held by the adjacency matrix, its transpose and the zero matrix.
+ * Caller is expected to hold the graph's read lock. */
+size_t Graph_MatricesMemoryUsage(
+	const Graph *g,     // Graph to inspect.
+	size_t *labels,     // Per label matrix usage, Graph_LabelTypeCount entries.
+	size_t *relations   // Per relation matrix usage, Graph_RelationTypeCount entries.
+);
+
 // Free graph.
 void Graph_Free(
 	Graph *g
 );
 
+// Graph being freed in steps.
+typedef struct GraphRelease GraphRelease;
+
+/* Frees the graph's matrices, its entities are freed by subsequent calls to Graph_FreeStep,
+ * such that freeing a large graph can be spread over time. */
+GraphRelease *Graph_BeginFree(
+	Graph *g
+);
+
+/* Frees up to count entities of the graph being released, nodes followed by edges,
+ * returns true once the graph is entirely freed, along with release. */
+bool Graph_FreeStep(
+	GraphRelease *release,  // Graph being released.
+	uint64_t count          // Maximum number of entities freed.
+);
+
 #endif
@@ -0,0 +1,77 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "graph_memory.h"
+#include "../util/arr.h"
+#include <assert.h>
+
+// Bytes held by the properties of the entities stored in datablock.
+static size_t _GraphMemory_Properties(const DataBlock *datablock, uint64_t samples) {
+	// Positions past the last allocated item are never occupied.
+	uint64_t positions = datablock->itemCount + array_len(datablock->deletedIdx);
+	if(positions == 0) return 0;
+
+	size_t size = 0;
+	if(samples == 0 || samples >= positions) {
+		for(uint64_t i = 0; i < positions; i++) {
+			Entity *e = DataBlock_GetItem(datablock, i);
+			if(e) size += Entity_MemoryUsage(e);
+		}
+		return size;
+	}
+
+	uint64_t sampled = 0;
+	for(uint64_t i = 0; i < samples; i++) {
+		Entity *e = DataBlock_GetItem(datablock, i * positions / samples);
+		if(e == NULL) continue;
+		size += Entity_MemoryUsage(e);
+		sampled++;
+	}
+	if(sampled == 0) return 0;
+	return (size_t)((double)size / sampled * datablock->itemCount);
+}
+
+static size_t _GraphMemory_Indices(const Schema *s) {
+	size_t size = 0;
+	if(s->index && s->index->ordered) size += OrderedIndex_MemoryUsage(s->index->ordered);
+	uint vector_count = array_len(s->vectorIndices);
+	for(uint i = 0; i < vector_count; i++) size += VectorIndex_MemoryUsage(s->vectorIndices[i]);
+	return size;
+}
+
+void GraphMemory_Measure(GraphContext *gc, uint64_t samples, GraphMemory *mem) {
+	assert(gc && mem);
+	Graph *g = gc->g;
+
+	mem->nodes = DataBlock_MemoryUsage(g->nodes);
+	mem->edges = DataBlock_MemoryUsage(g->edges);
+	mem->node_properties = _GraphMemory_Properties(g->nodes, samples);
+	mem->edge_properties = _GraphMemory_Properties(g->edges, samples);
+
+	int label_count = Graph_LabelTypeCount(g);
+	int relation_count = Graph_RelationTypeCount(g);
+	mem->labels = array_newlen(size_t, label_count);
+	mem->relations = array_newlen(size_t, relation_count);
+	mem->adjacency = Graph_MatricesMemoryUsage(g, mem->labels, mem->relations);
+
+	mem->indices = 0;
+	uint node_schemas = array_len(gc->node_schemas);
+	for(uint i = 0; i < node_schemas; i++) mem->indices += _GraphMemory_Indices(gc->node_schemas[i]);
+	uint relation_schemas = array_len(gc->relation_schemas);
+	for(uint i = 0; i < relation_schemas; i++) {
+		mem->indices += _GraphMemory_Indices(gc->relation_schemas[i]);
+	}
+
+	mem->total = mem->nodes + mem->edges + mem->node_properties + mem->edge_properties +
+				 mem->adjacency + mem->indices;
+	for(int i = 0; i < label_count; i++) mem->total += mem->labels[i];
+	for(int i = 0; i < relation_count; i++) mem->total += mem->relations[i];
+}
+
+void GraphMemory_Free(GraphMemory *mem) {
+	array_free(mem->labels);
+	array_free(mem->relations);
+}
@@ -0,0 +1,35 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "graphcontext.h"
+
+// Default number of entities sampled per datablock when estimating property usage.
+#define GRAPH_MEMORY_DEFAULT_SAMPLES 1024
+
+/* Breakdown of the memory held by a graph, in bytes.
+ * Matrix usage is derived from each matrix's entries and format,
+ * RediSearch indices don't expose their usage and aren't accounted for. */
+typedef struct {
+	size_t nodes;             // Node storage blocks.
+	size_t edges;             // Edge storage blocks.
+	size_t node_properties;   // Node properties and the values they own.
+	size_t edge_properties;   // Edge properties and the values they own.
+	size_t adjacency;         // Adjacency matrix, its transpose and the zero matrix.
+	size_t *labels;           // Label matrix per label ID.
+	size_t *relations;        // Relation matrix and its transpose per relation ID.
+	size_t indices;           // In-process exact-match and vector indices.
+	size_t total;             // Sum of all of the above.
+} GraphMemory;
+
+/* Measures the memory held by gc, properties are measured over at most samples
+ * entities of each datablock, evenly spaced, and extrapolated to all entities,
+ * 0 measures every entity. Caller is expected to hold the graph's read lock. */
+void GraphMemory_Measure(GraphContext *gc, uint64_t samples, GraphMemory *mem);
+
+// Free the per label and relation breakdown of mem.
+void GraphMemory_Free(GraphMemory *mem);
@@ -0,0 +1,90 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "graph_partition.h"
+#include "entities/multi_edge.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include <assert.h>
+
+GraphPartition GraphPartition_New(const Graph *g, PartitionScheme scheme, uint64_t index,
+								  uint64_t count) {
+	assert(count > 0 && index < count);
+	GraphPartition p = {
+		.scheme = scheme,
+		.index = index,
+		.count = count,
+		// Node IDs are allocated below the sum of live and deleted nodes.
+		.id_bound = g->nodes->itemCount + array_len(g->nodes->deletedIdx)
+	};
+	return p;
+}
+
+uint64_t GraphPartition_Owner(const GraphPartition *p, NodeID id) {
+	if(p->scheme == PARTITION_RANGE) {
+		if(id >= p->id_bound) return p->count - 1;
+		return (uint64_t)((__uint128_t)id * p->count / p->id_bound);
+	}
+
+	// splitmix64 finalizer, consecutive IDs are spread evenly.
+	uint64_t x = id + 0x9e3779b97f4a7c15ULL;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return x % p->count;
+}
+
+NodeID *GraphPartition_Nodes(const GraphPartition *p, Graph *g, uint64_t *edge_count) {
+	NodeID *ids = array_new(NodeID, 1024);
+	*edge_count = 0;
+
+	// Owned nodes.
+	Entity *e;
+	DataBlockIterator *iter = Graph_ScanNodes(g);
+	while((e = (Entity *)DataBlockIterator_Next(iter))) {
+		if(GraphPartition_Owns(p, e->id)) ids = array_append(ids, e->id);
+	}
+	DataBlockIterator_Free(iter);
+
+	// Boundary nodes, connected to an owned node.
+	uint relationship_count = Graph_RelationTypeCount(g);
+	for(uint r = 0; r < relationship_count; r++) {
+		NodeID src;
+		NodeID dest;
+		EdgeID edgeID;
+		GrB_Matrix M = Graph_GetRelationMatrix(g, r);
+		GxB_MatrixTupleIter *it;
+		GxB_MatrixTupleIter_new(&it, M);
+		bool depleted = false;
+
+		while(true) {
+			GxB_MatrixTupleIter_next(it, &src, &dest, &depleted);
+			if(depleted) break;
+
+			bool src_owned = GraphPartition_Owns(p, src);
+			bool dest_owned = GraphPartition_Owns(p, dest);
+			if(!src_owned && !dest_owned) continue;
+			if(!src_owned) ids = array_append(ids, src);
+			if(!dest_owned) ids = array_append(ids, dest);
+
+			GrB_Matrix_extractElement_UINT64(&edgeID, M, src, dest);
+			if(SINGLE_EDGE(edgeID)) *edge_count += 1;
+			else *edge_count += ((const MultiEdge *)edgeID)->count;
+		}
+
+		GxB_MatrixTupleIter_free(it);
+	}
+
+	// Sort, dropping boundary nodes connected by multiple edges.
+	uint count = array_len(ids);
+	QSORT(NodeID, ids, count, ENTITY_ID_ISLT);
+	uint unique = 0;
+	for(uint i = 0; i < count; i++) {
+		if(unique == 0 || ids[unique - 1] != ids[i]) ids[unique++] = ids[i];
+	}
+	ids = array_trimm_len(ids, unique);
+	return ids;
+}
@@ -0,0 +1,49 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "graph.h"
+
+// Attribute holding a node's ID in the partitioned graph, set on every exported node.
+#define PARTITION_GID_ATTRIBUTE "_gid"
+
+// Assignment of nodes to partitions.
+typedef enum {
+	PARTITION_HASH,     // Nodes are assigned by a hash of their ID.
+	PARTITION_RANGE,    // Nodes are assigned by contiguous, equally sized, ID ranges.
+} PartitionScheme;
+
+/* A single partition of a graph's nodes, the partition holds the nodes it owns,
+ * and a replica of each node connected to an owned node by an edge (a boundary node).
+ * Edges connecting an owned node are held, such that edges crossing partitions
+ * are replicated in both partitions. */
+typedef struct {
+	PartitionScheme scheme;     // Assignment of nodes to partitions.
+	uint64_t index;             // Partition, within [0, count).
+	uint64_t count;             // Number of partitions.
+	uint64_t id_bound;          // Node IDs are below id_bound, split into ranges by PARTITION_RANGE.
+} GraphPartition;
+
+// Describe partition index of count partitions of g's nodes.
+GraphPartition GraphPartition_New(const Graph *g, PartitionScheme scheme, uint64_t index,
+								  uint64_t count);
+
+// Returns the partition owning node id.
+uint64_t GraphPartition_Owner(const GraphPartition *p, NodeID id);
+
+// Returns true if node id is owned by partition.
+static inline bool GraphPartition_Owns(const GraphPartition *p, NodeID id) {
+	return GraphPartition_Owner(p, id) == p->index;
+}
+
+/* Collects the IDs of the nodes held by partition, owned and boundary nodes,
+ * in ascending order, and sets edge_count to the number of edges it holds.
+ * The returned array is freed with array_free.
+ * Expects the graph not to be modified while collecting. */
+NodeID *GraphPartition_Nodes(const GraphPartition *p, Graph *g, uint64_t *edge_count);
@@ -11,49 +11,95 @@
 #include "../query_ctx.h"
 #include "../redismodule.h"
 #include "../util/rmalloc.h"
-#include "../util/thpool/thpool.h"
+#include "../util/thpool/pools.h"
+#include "../expiry/expiry.h"
+#include "../util/reclaimer.h"
+#include "weight_matrices.h"
 #include "serializers/graphcontext_type.h"
+#include "../execution_plan/plan_cache.h"
 
 // Global array tracking all extant GraphContexts (defined in module.c)
-extern threadpool _thpool;
 extern GraphContext **graphs_in_keyspace;
+// Names of attributes whose string values are interned (defined in module.c)
+extern rax *interned_attributes;
+// Number of nodes indexed per background index construction step (defined in module.c)
+extern long long index_chunk_size;
+
+// Number of graph entities freed per step of a deleted graph's release.
+#define GRAPHCONTEXT_FREE_STEP_SIZE 65536
+
+// A deleted graph being freed by the reclaimer.
+typedef struct {
+	GraphContext *gc;       // Graph being freed.
+	GraphRelease *graph;    // Release of the graph's entities, NULL until begun.
+} GraphContextRelease;
 
 // Forward declarations.
-static void _GraphContext_Free(void *arg);
+static bool _GraphContext_FreeStep(void *arg);
 
 static inline void _GraphContext_IncreaseRefCount(GraphContext *gc) {
 	__atomic_fetch_add(&gc->ref_count, 1, __ATOMIC_RELAXED);
 }
 
 static inline void _GraphContext_DecreaseRefCount(GraphContext *gc) {
-	// If the reference count is less than 0, the graph has been marked for deletion and no queries are active - free the graph.
-	if(__atomic_sub_fetch(&gc->ref_count, 1, __ATOMIC_RELAXED) < 0)
-		thpool_add_work(_thpool, _GraphContext_Free, gc);
+	/* If the reference count is less than 0, the graph has been marked for deletion and no queries are active,
+	 * hand the graph over to the reclaimer which frees it in the background.
+	 * The handover never drops the graph, the reclaimer's queue is unbounded,
+	 * and the graph is freed synchronously by the calling thread if the reclaimer isn't running. */
+	if(__atomic_sub_fetch(&gc->ref_count, 1, __ATOMIC_RELAXED) < 0) {
+		GraphContextRelease *release = rm_malloc(sizeof(GraphContextRelease));
+		release->gc = gc;
+		release->graph = NULL;
+		Reclaimer_Add(_GraphContext_FreeStep, release);
+	}
+}
+
+// Returns true if string values of the named attribute should be interned.
+static inline bool _GraphContext_InternAttribute(const char *attribute) {
+	if(interned_attributes == NULL) return false;
+	return raxFind(interned_attributes, (unsigned char *)attribute, strlen(attribute)) != raxNotFound;
 }
 
 //------------------------------------------------------------------------------
 // GraphContext API
 //------------------------------------------------------------------------------
 
-// Creates and initializes a graph context struct.
-static GraphContext *_GraphContext_New(const char *graph_name, size_t node_cap, size_t edge_cap) {
+// Creates and initializes a graph context struct, hosting graph g.
+static GraphContext *_GraphContext_New(const char *graph_name, Graph *g) {
 	GraphContext *gc = rm_malloc(sizeof(GraphContext));
 
 	gc->ref_count = 0;      // No refences.
 	gc->index_count = 0;    // No indicies.
 
-	// Initialize the graph's matrices and datablock storage
-	gc->g = Graph_New(node_cap, edge_cap);
+	// The graph's matrices and datablock storage
+	gc->g = g;
 	gc->graph_name = rm_strdup(graph_name);
 	// Allocate the default space for schemas and indices
 	gc->node_schemas = array_new(Schema *, GRAPH_DEFAULT_LABEL_CAP);
 	gc->relation_schemas = array_new(Schema *, GRAPH_DEFAULT_RELATION_TYPE_CAP);
 
 	gc->string_mapping = array_new(char *, 64);
+	gc->interned_attributes = array_new(bool, 64);
+	gc->string_pool = StringPool_New();
 	gc->attributes = raxNew();
 	gc->slowlog = SlowLog_New();
+	gc->query_stats = QueryStats_New();
+	gc->access_stats = AccessStats_New();
+	gc->changes = ChangeFeed_New();
+	gc->cache = PlanCache_New();
+	gc->sync_scheduled = false;
+	gc->index_updates_scheduled = false;
+	gc->expiry_scheduled = false;
+	gc->memory_usage = 0;
+	gc->write_version = 0;
+	gc->prepared_statements = PreparedStatements_New();
+	gc->views = MaterializedViews_New();
+	gc->projections = Projections_New();
+	gc->pins = PlanPins_New();
+	gc->cursors = Cursors_New();
+	gc->results = ResultCache_New();
+	gc->commit_group = CommitGroup_New();
 
-	Graph_SetMatrixPolicy(gc->g, SYNC_AND_MINIMIZE_SPACE);
 	QueryCtx_SetGraphCtx(gc);
 
 	return gc;
@@ -65,7 +111,7 @@ static GraphContext *_GraphContext_New(const char *graph_name, size_t node_cap,
 static GraphContext *_GraphContext_Create(RedisModuleCtx *ctx, const char *graph_name,
 										  size_t node_cap, size_t edge_cap) {
 	// Create and initialize a graph context.
-	GraphContext *gc = _GraphContext_New(graph_name, node_cap, edge_cap);
+	GraphContext *gc = _GraphContext_New(graph_name, Graph_New(node_cap, edge_cap));
 	RedisModuleString *graphID = RedisModule_CreateString(ctx, graph_name, strlen(graph_name));
 
 	RedisModuleKey *key = RedisModule_OpenKey(ctx, graphID, REDISMODULE_WRITE);
@@ -101,25 +147,226 @@ GraphContext *GraphContext_Retrieve(RedisModuleCtx *ctx, RedisModuleString *grap
 	return gc;
 }
 
+// Clones the properties of entity src into its copy dst, interning strings in the copy's pool.
+static void _GraphContext_CloneEntity(void *dst, const void *src, void *arg) {
+	GraphContext *gc = arg;
+	Entity *clone = dst;
+	Entity *e = (Entity *)src;
+	int prop_count = e->prop_count;
+	clone->prop_count = 0;
+	clone->properties = NULL;
+	if(prop_count == 0) return;
+
+	Attribute_ID attrs[prop_count];
+	SIValue values[prop_count];
+	EntityProperty *properties = Entity_Properties(e);
+	for(int i = 0; i < prop_count; i++) {
+		SIValue v = properties[i].value;
+		// Interned strings are owned by the source's pool.
+		if(v.allocation == M_INTERNED) v = SI_ConstStringVal(v.stringval);
+		attrs[i] = properties[i].id;
+		values[i] = GraphContext_InternValue(gc, attrs[i], v);
+	}
+
+	GraphEntity ge = {.entity = clone};
+	GraphEntity_AddProperties(&ge, prop_count, attrs, values);
+}
+
+GraphContext *GraphContext_Clone(const GraphContext *gc, const char *graph_name) {
+	assert(gc && graph_name);
+	GraphContext *clone = _GraphContext_New(graph_name, NULL);
+
+	// Attributes are introduced in ID order, preserving their IDs.
+	uint attribute_count = array_len(gc->string_mapping);
+	for(uint i = 0; i < attribute_count; i++) {
+		GraphContext_FindOrAddAttribute(clone, gc->string_mapping[i]);
+	}
+
+	clone->g = Graph_Clone(gc->g, _GraphContext_CloneEntity, clone);
+
+	uint relation_count = array_len(gc->relation_schemas);
+	for(uint i = 0; i < relation_count; i++) {
+		Schema *src = gc->relation_schemas[i];
+		Schema *s = Schema_New(src->name, i, SCHEMA_EDGE);
+		clone->relation_schemas = array_append(clone->relation_schemas, s);
+		if(Schema_HasExpiry(src)) Schema_SetExpiry(s, src->ttl_attribute, src->ttl);
+		if(src->intervals) {
+			Schema_SetIntervals(s, src->intervals->from_attribute, src->intervals->to_attribute);
+			Graph_SetIntervalIndex(clone->g, i, s->intervals);
+		}
+		uint weight_count = array_len(src->weights);
+		for(uint j = 0; j < weight_count; j++) {
+			Schema_SetWeights(s, src->weights[j], true);
+			Attribute_ID attr = GraphContext_GetAttributeID(clone, src->weights[j]);
+			WeightMatrices_Maintain(clone->g, i, attr, true);
+		}
+
+		if(src->index == NULL) continue;
+		Index *idx = NULL;
+		for(uint k = 0; k < src->index->fields_count; k++) {
+			Schema_AddIndex(&idx, s, src->index->fields[k], IDX_EXACT_MATCH);
+		}
+		Index_Construct(idx);
+	}
+
+	// Indices are rebuilt over the copied nodes.
+	uint label_count = array_len(gc->node_schemas);
+	for(uint i = 0; i < label_count; i++) {
+		Schema *src = gc->node_schemas[i];
+		Schema *s = Schema_New(src->name, i, SCHEMA_NODE);
+		clone->node_schemas = array_append(clone->node_schemas, s);
+		if(Schema_HasExpiry(src)) Schema_SetExpiry(s, src->ttl_attribute, src->ttl);
+
+		Index *indices[2] = {src->index, src->fulltextIdx};
+		for(uint j = 0; j < 2; j++) {
+			if(indices[j] == NULL) continue;
+			Index *idx = NULL;
+			for(uint k = 0; k < indices[j]->fields_count; k++) {
+				Schema_AddIndex(&idx, s, indices[j]->fields[k], indices[j]->type);
+			}
+			uint composite_count = Index_CompositeCount(indices[j]);
+			for(uint k = 0; k < composite_count; k++) {
+				IndexComposite *c = indices[j]->composites + k;
+				Schema_AddCompositeIndex(&idx, s, (const char **)c->fields, c->fields_count);
+			}
+			for(uint k = 0; k < indices[j]->fields_count; k++) {
+				if(!Index_IsUnique(indices[j], indices[j]->fields_ids[k])) continue;
+				Schema_AddUniqueConstraint(s, indices[j]->fields[k]);
+			}
+			Index_Construct(idx);
+			if(Index_IsAsync(indices[j])) Index_SetAsync(idx, true);
+		}
+
+		uint vector_count = array_len(src->vectorIndices);
+		for(uint j = 0; j < vector_count; j++) {
+			VectorIndex *src_idx = src->vectorIndices[j];
+			VectorIndex *idx = NULL;
+			Schema_AddVectorIndex(&idx, s, src_idx->field, src_idx->dim, src_idx->metric);
+			VectorIndex_Construct(idx);
+		}
+	}
+	clone->index_count = gc->index_count;
+
+	return clone;
+}
+
 void GraphContext_Release(GraphContext *gc) {
 	assert(gc);
 	_GraphContext_DecreaseRefCount(gc);
 }
 
-void GraphContext_MarkWriter(RedisModuleCtx *ctx, GraphContext *gc) {
-	RedisModuleString *graphID = RedisModule_CreateString(ctx, gc->graph_name, strlen(gc->graph_name));
+// Runs on a thread pool thread, applies all pending matrix changes.
+static void _GraphContext_Synchronize(void *arg) {
+	GraphContext *gc = arg;
+	Graph *g = gc->g;
 
-	// Reopen only if key exists (do not re-create) make sure key still exists.
-	RedisModuleKey *key = RedisModule_OpenKey(ctx, graphID, REDISMODULE_READ);
-	if(RedisModule_KeyType(key) == REDISMODULE_KEYTYPE_EMPTY) goto cleanup;
-	RedisModule_CloseKey(key);
+	// Clear flag prior to synchronizing, changes committed from here on reschedule.
+	__atomic_store_n(&gc->sync_scheduled, false, __ATOMIC_RELAXED);
 
-	// Mark as writer.
-	key = RedisModule_OpenKey(ctx, graphID, REDISMODULE_WRITE);
-	RedisModule_CloseKey(key);
+	// Matrices are synchronized under a read lock, just as a reader would.
+	Graph_AcquireReadLock(g);
+	Graph_SetMatrixPolicy(g, SYNC_AND_MINIMIZE_SPACE);
+	Graph_ApplyAllPending(g);
+	Graph_ReleaseLock(g);
 
-cleanup:
-	RedisModule_FreeString(ctx, graphID);
+	GraphContext_Release(gc);
+}
+
+void GraphContext_ScheduleSynchronization(GraphContext *gc) {
+	// Synchronization is already scheduled.
+	bool scheduled = false;
+	if(!__atomic_compare_exchange_n(&gc->sync_scheduled, &scheduled, true, false,
+									__ATOMIC_RELAXED, __ATOMIC_RELAXED)) return;
+
+	// Retain graph context until synchronization is done.
+	_GraphContext_IncreaseRefCount(gc);
+	if(ThreadPools_AddWork(THPOOL_LANE_LONG_READ, _GraphContext_Synchronize, gc) != 0) {
+		// Queue is full, the next reader will apply pending changes.
+		__atomic_store_n(&gc->sync_scheduled, false, __ATOMIC_RELAXED);
+		_GraphContext_DecreaseRefCount(gc);
+	}
+}
+
+void GraphContext_ApplyIndexUpdates(GraphContext *gc) {
+	uint label_count = array_len(gc->node_schemas);
+	for(uint i = 0; i < label_count; i++) {
+		Index *idx = gc->node_schemas[i]->fulltextIdx;
+		if(idx) Index_ApplyPending(idx);
+	}
+}
+
+// Runs on a thread pool thread, applies the pending updates of asynchronous indices.
+static void _GraphContext_ApplyIndexUpdates(void *arg) {
+	GraphContext *gc = arg;
+	Graph *g = gc->g;
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	QueryCtx_SetGraphCtx(gc);
+
+	// Updates are applied holding the graph exclusively, just as a writer committing would.
+	Graph_WriterEnter(g);
+	// Clear flag prior to applying, updates committed from here on reschedule.
+	__atomic_store_n(&gc->index_updates_scheduled, false, __ATOMIC_RELAXED);
+	RedisModule_ThreadSafeContextLock(ctx);
+	Graph_AcquireWriteLock(g);
+	GraphContext_ApplyIndexUpdates(gc);
+	Graph_ReleaseLock(g);
+	RedisModule_ThreadSafeContextUnlock(ctx);
+	Graph_WriterLeave(g);
+
+	RedisModule_FreeThreadSafeContext(ctx);
+	QueryCtx_Free();
+	GraphContext_Release(gc);
+}
+
+void GraphContext_ScheduleIndexUpdates(GraphContext *gc) {
+	bool pending = false;
+	uint label_count = array_len(gc->node_schemas);
+	for(uint i = 0; i < label_count && !pending; i++) {
+		Index *idx = gc->node_schemas[i]->fulltextIdx;
+		pending = (idx && Index_PendingCount(idx) > 0);
+	}
+	if(!pending) return;
+
+	// Updates are already scheduled.
+	bool scheduled = false;
+	if(!__atomic_compare_exchange_n(&gc->index_updates_scheduled, &scheduled, true, false,
+									__ATOMIC_RELAXED, __ATOMIC_RELAXED)) return;
+
+	// Retain graph context until updates are applied.
+	_GraphContext_IncreaseRefCount(gc);
+	if(ThreadPools_AddWork(THPOOL_LANE_WRITER, _GraphContext_ApplyIndexUpdates, gc) != 0) {
+		// Queue is full, the next writer reschedules.
+		__atomic_store_n(&gc->index_updates_scheduled, false, __ATOMIC_RELAXED);
+		_GraphContext_DecreaseRefCount(gc);
+	}
+}
+
+void GraphContext_ScheduleChangeFeed(GraphContext *gc) {
+	// Nothing to append, or changes are already being appended.
+	if(gc->changes == NULL || !ChangeFeed_BeginEmit(gc->changes)) return;
+
+	// Retain graph context until changes are appended.
+	_GraphContext_IncreaseRefCount(gc);
+	if(ThreadPools_AddWork(THPOOL_LANE_LONG_READ, ChangeFeed_Emit, gc) != 0) {
+		// Queue is full, the next writer reschedules.
+		__atomic_store_n(&gc->changes->emitting, false, __ATOMIC_RELAXED);
+		_GraphContext_DecreaseRefCount(gc);
+	}
+}
+
+void GraphContext_ScheduleExpiry(GraphContext *gc) {
+	// Expiry is already scheduled.
+	bool scheduled = false;
+	if(!__atomic_compare_exchange_n(&gc->expiry_scheduled, &scheduled, true, false,
+									__ATOMIC_RELAXED, __ATOMIC_RELAXED)) return;
+
+	// Retain graph context until expired entities are deleted.
+	_GraphContext_IncreaseRefCount(gc);
+	if(ThreadPools_AddWork(THPOOL_LANE_WRITER, Expiry_Reap, gc) != 0) {
+		// Queue is full, the reaper reschedules.
+		__atomic_store_n(&gc->expiry_scheduled, false, __ATOMIC_RELAXED);
+		_GraphContext_DecreaseRefCount(gc);
+	}
 }
 
 void GraphContext_Delete(GraphContext *gc) {
@@ -139,6 +386,20 @@ void GraphContext_Rename(GraphContext *gc, const char *name) {
 	gc->graph_name = rm_strdup(name);
 }
 
+//------------------------------------------------------------------------------
+// Write version API
+//------------------------------------------------------------------------------
+// Readers wait on the version without holding the graph's lock.
+uint64_t GraphContext_GetWriteVersion(const GraphContext *gc) {
+	assert(gc);
+	return __atomic_load_n(&gc->write_version, __ATOMIC_ACQUIRE);
+}
+
+uint64_t GraphContext_AdvanceWriteVersion(GraphContext *gc) {
+	assert(gc);
+	return __atomic_add_fetch(&gc->write_version, 1, __ATOMIC_RELEASE);
+}
+
 //------------------------------------------------------------------------------
 // Schema API
 //------------------------------------------------------------------------------
@@ -177,14 +438,18 @@ Schema *GraphContext_AddSchema(GraphContext *gc, const char *label, SchemaType t
 
 	if(t == SCHEMA_NODE) {
 		label_id = Graph_AddLabel(gc->g);
-		schema = Schema_New(label, label_id);
+		schema = Schema_New(label, label_id, SCHEMA_NODE);
+		// A new label holds no nodes, its statistics are trivially valid.
+		SchemaStats_Reset(schema->stats);
 		gc->node_schemas = array_append(gc->node_schemas, schema);
 	} else {
 		label_id = Graph_AddRelationType(gc->g);
-		schema = Schema_New(label, label_id);
+		schema = Schema_New(label, label_id, SCHEMA_EDGE);
 		gc->relation_schemas = array_append(gc->relation_schemas, schema);
 	}
 
+	// Cached plans might have resolved the label as missing.
+	GraphContext_InvalidateCache(gc);
 	return schema;
 }
 
@@ -220,11 +485,22 @@ Attribute_ID GraphContext_FindOrAddAttribute(GraphContext *gc, const char *attri
 				  pAttribute_id,
 				  NULL);
 		gc->string_mapping = array_append(gc->string_mapping, rm_strdup(attribute));
+		gc->interned_attributes = array_append(gc->interned_attributes,
+											   _GraphContext_InternAttribute(attribute));
+		// Cached plans might have resolved the attribute as missing.
+		GraphContext_InvalidateCache(gc);
 	}
 
 	return attribute_id;
 }
 
+SIValue GraphContext_InternValue(GraphContext *gc, Attribute_ID id, SIValue v) {
+	if(SI_TYPE(v) != T_STRING || v.allocation == M_INTERNED) return v;
+	assert(id < array_len(gc->interned_attributes));
+	if(!gc->interned_attributes[id]) return v;
+	return SI_InternedStringVal(StringPool_Intern(gc->string_pool, v.stringval));
+}
+
 const char *GraphContext_GetAttributeString(const GraphContext *gc, Attribute_ID id) {
 	assert(id < array_len(gc->string_mapping));
 	return gc->string_mapping[id];
@@ -244,6 +520,19 @@ bool GraphContext_HasIndices(GraphContext *gc) {
 	for(uint i = 0; i < schema_count; i++) {
 		if(Schema_HasIndices(gc->node_schemas[i])) return true;
 	}
+	schema_count = array_len(gc->relation_schemas);
+	for(uint i = 0; i < schema_count; i++) {
+		if(Schema_HasIndices(gc->relation_schemas[i])) return true;
+	}
+	return false;
+}
+
+// Returns true if any relationship type is indexed.
+static bool _GraphContext_HasEdgeIndices(const GraphContext *gc) {
+	uint schema_count = array_len(gc->relation_schemas);
+	for(uint i = 0; i < schema_count; i++) {
+		if(gc->relation_schemas[i]->index) return true;
+	}
 	return false;
 }
 
@@ -264,6 +553,7 @@ int GraphContext_AddIndex(Index **idx, GraphContext *gc, const char *label, cons
 	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
 	if(s == NULL) s = GraphContext_AddSchema(gc, label, SCHEMA_NODE);
 	int res = Schema_AddIndex(idx, s, field, type);
+	if(res == INDEX_OK) GraphContext_InvalidateCache(gc);
 	ResultSet *result_set = QueryCtx_GetResultSet();
 	ResultSet_IndexCreated(result_set, res);
 	return res;
@@ -275,6 +565,259 @@ int GraphContext_DeleteIndex(GraphContext *gc, const char *label, const char *fi
 	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
 	int res = INDEX_FAIL;
 	if(s != NULL) res = Schema_RemoveIndex(s, field, type);
+	if(res == INDEX_OK) GraphContext_InvalidateCache(gc);
+	ResultSet *result_set = QueryCtx_GetResultSet();
+	ResultSet_IndexDeleted(result_set, res);
+	return res;
+}
+
+// Background index construction.
+typedef struct {
+	GraphContext *gc;       // Graph holding the index.
+	char *label;            // Indexed label.
+	uint64_t construction;  // Construction carried out.
+} IndexConstruction;
+
+bool GraphContext_InKeyspace(const GraphContext *gc) {
+	uint graph_count = array_len(graphs_in_keyspace);
+	for(uint i = 0; i < graph_count; i++) {
+		if(graphs_in_keyspace[i] == gc) return true;
+	}
+	return false;
+}
+
+/* Runs on a dedicated thread, constructs the index in steps.
+ * Each step holds the graph exclusively, just as a writer committing would,
+ * readers and writers proceed in between steps. */
+static void *_GraphContext_ConstructIndex(void *arg) {
+	IndexConstruction *job = arg;
+	GraphContext *gc = job->gc;
+	Graph *g = gc->g;
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	QueryCtx_SetGraphCtx(gc);
+
+	bool done = false;
+	while(!done) {
+		Graph_WriterEnter(g);
+		RedisModule_ThreadSafeContextLock(ctx);
+		Graph_AcquireWriteLock(g);
+
+		// Stop once the graph is deleted, or the index is dropped or reconstructed.
+		Schema *s = GraphContext_GetSchema(gc, job->label, SCHEMA_NODE);
+		Index *idx = (s) ? s->index : NULL;
+		if(!GraphContext_InKeyspace(gc) || idx == NULL ||
+		   idx->construction != job->construction) {
+			done = true;
+		} else {
+			Graph_SetMatrixPolicy(g, SYNC_AND_MINIMIZE_SPACE);
+			done = Index_ConstructStep(idx, index_chunk_size);
+			// Plans compiled during construction don't utilize the index.
+			if(done) GraphContext_InvalidateCache(gc);
+		}
+
+		Graph_ReleaseLock(g);
+		RedisModule_ThreadSafeContextUnlock(ctx);
+		Graph_WriterLeave(g);
+	}
+
+	RedisModule_FreeThreadSafeContext(ctx);
+	QueryCtx_Free();
+	rm_free(job->label);
+	rm_free(job);
+	GraphContext_Release(gc);
+	return NULL;
+}
+
+void GraphContext_ConstructIndex(GraphContext *gc, Index *idx) {
+	assert(gc && idx);
+
+	/* Edge indices, indices backing unique constraints and indices
+	 * of labels fitting within a single step are constructed in place. */
+	Schema *s = GraphContext_GetSchema(gc, idx->label, SCHEMA_NODE);
+	if(idx->entity_type != GETYPE_NODE || s == NULL || Index_UniqueConstraintCount(idx) > 0 ||
+	   Graph_LabeledNodeCount(gc->g, s->id) <= (size_t)index_chunk_size) {
+		Index_Construct(idx);
+		return;
+	}
+
+	Index_BeginConstruction(idx);
+
+	IndexConstruction *job = rm_malloc(sizeof(IndexConstruction));
+	job->gc = gc;
+	job->label = rm_strdup(idx->label);
+	job->construction = idx->construction;
+
+	// Retain graph context until construction is done.
+	_GraphContext_IncreaseRefCount(gc);
+	pthread_t thread;
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	int res = pthread_create(&thread, &attr, _GraphContext_ConstructIndex, job);
+	pthread_attr_destroy(&attr);
+	if(res != 0) {
+		// Unable to spawn a thread, construct in place.
+		_GraphContext_DecreaseRefCount(gc);
+		rm_free(job->label);
+		rm_free(job);
+		Index_ConstructStep(idx, UINT64_MAX);
+	}
+}
+
+void GraphContext_SetExpiry(GraphContext *gc, const char *label, SchemaType t,
+							const char *attribute, uint64_t ttl) {
+	assert(gc && label && attribute);
+
+	Schema *s = GraphContext_GetSchema(gc, label, t);
+	if(s == NULL) {
+		// Nothing to disable.
+		if(ttl == 0) return;
+		s = GraphContext_AddSchema(gc, label, t);
+	}
+	Schema_SetExpiry(s, attribute, ttl);
+}
+
+void GraphContext_SetIntervals(GraphContext *gc, const char *relation, const char *from_attribute,
+							   const char *to_attribute) {
+	assert(gc && relation);
+
+	Schema *s = GraphContext_GetSchema(gc, relation, SCHEMA_EDGE);
+	if(s == NULL) {
+		// Nothing to drop.
+		if(from_attribute == NULL) return;
+		s = GraphContext_AddSchema(gc, relation, SCHEMA_EDGE);
+	}
+	Schema_SetIntervals(s, from_attribute, to_attribute);
+	// Edge writes keep the index in sync.
+	Graph_SetIntervalIndex(gc->g, s->id, s->intervals);
+}
+
+bool GraphContext_MaintainWeights(GraphContext *gc, const char *relation, const char *attribute,
+								   bool maintain) {
+	assert(gc && relation && attribute);
+
+	Schema *s = GraphContext_GetSchema(gc, relation, SCHEMA_EDGE);
+	if(s == NULL) {
+		// Nothing to stop maintaining.
+		if(!maintain) return false;
+		s = GraphContext_AddSchema(gc, relation, SCHEMA_EDGE);
+	}
+	if(!Schema_SetWeights(s, attribute, maintain)) return false;
+
+	Attribute_ID attr = GraphContext_FindOrAddAttribute(gc, attribute);
+	WeightMatrices_Maintain(gc->g, s->id, attr, maintain);
+	return true;
+}
+
+bool GraphContext_HasExpiry(const GraphContext *gc) {
+	uint label_count = array_len(gc->node_schemas);
+	for(uint i = 0; i < label_count; i++) {
+		if(Schema_HasExpiry(gc->node_schemas[i])) return true;
+	}
+	uint relation_count = array_len(gc->relation_schemas);
+	for(uint i = 0; i < relation_count; i++) {
+		if(Schema_HasExpiry(gc->relation_schemas[i])) return true;
+	}
+	return false;
+}
+
+int GraphContext_AddUniqueConstraint(GraphContext *gc, const char *label, const char *field) {
+	assert(gc && label && field);
+
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	if(s == NULL) return INDEX_FAIL;
+	return Schema_AddUniqueConstraint(s, field);
+}
+
+int GraphContext_DeleteUniqueConstraint(GraphContext *gc, const char *label, const char *field) {
+	assert(gc && label && field);
+
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	if(s == NULL) return INDEX_FAIL;
+	return Schema_RemoveUniqueConstraint(s, field);
+}
+
+Index *GraphContext_GetEdgeIndex(const GraphContext *gc, const char *relation, const char *field) {
+	// Retrieve the schema for this relationship type
+	Schema *schema = GraphContext_GetSchema(gc, relation, SCHEMA_EDGE);
+	if(schema == NULL) return NULL;
+
+	return Schema_GetIndex(schema, field, IDX_EXACT_MATCH);
+}
+
+int GraphContext_AddEdgeIndex(Index **idx, GraphContext *gc, const char *relation,
+							  const char *field) {
+	assert(idx && gc && relation && field);
+
+	// Retrieve the schema for this relationship type
+	Schema *s = GraphContext_GetSchema(gc, relation, SCHEMA_EDGE);
+	if(s == NULL) s = GraphContext_AddSchema(gc, relation, SCHEMA_EDGE);
+	int res = Schema_AddIndex(idx, s, field, IDX_EXACT_MATCH);
+	if(res == INDEX_OK) GraphContext_InvalidateCache(gc);
+	ResultSet *result_set = QueryCtx_GetResultSet();
+	ResultSet_IndexCreated(result_set, res);
+	return res;
+}
+
+int GraphContext_DeleteEdgeIndex(GraphContext *gc, const char *relation, const char *field) {
+	// Retrieve the schema for this relationship type
+	Schema *s = GraphContext_GetSchema(gc, relation, SCHEMA_EDGE);
+	int res = INDEX_FAIL;
+	if(s != NULL) res = Schema_RemoveIndex(s, field, IDX_EXACT_MATCH);
+	if(res == INDEX_OK) GraphContext_InvalidateCache(gc);
+	ResultSet *result_set = QueryCtx_GetResultSet();
+	ResultSet_IndexDeleted(result_set, res);
+	return res;
+}
+
+int GraphContext_AddCompositeIndex(Index **idx, GraphContext *gc, const char *label,
+								   const char **fields, uint fields_count) {
+	assert(idx && gc && label && fields);
+
+	// Retrieve the schema for this label
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	if(s == NULL) s = GraphContext_AddSchema(gc, label, SCHEMA_NODE);
+	int res = Schema_AddCompositeIndex(idx, s, fields, fields_count);
+	if(res == INDEX_OK) GraphContext_InvalidateCache(gc);
+	ResultSet *result_set = QueryCtx_GetResultSet();
+	ResultSet_IndexCreated(result_set, res);
+	return res;
+}
+
+int GraphContext_DeleteCompositeIndex(GraphContext *gc, const char *label, const char **fields,
+									  uint fields_count) {
+	// Retrieve the schema for this label
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	int res = INDEX_FAIL;
+	if(s != NULL) res = Schema_RemoveCompositeIndex(s, fields, fields_count);
+	if(res == INDEX_OK) {
+		// Remaining composite indices are identified by position, rebuild their entries.
+		if(s->index) Index_Construct(s->index);
+		GraphContext_InvalidateCache(gc);
+	}
+	ResultSet *result_set = QueryCtx_GetResultSet();
+	ResultSet_IndexDeleted(result_set, res);
+	return res;
+}
+
+int GraphContext_AddVectorIndex(VectorIndex **idx, GraphContext *gc, const char *label,
+								const char *field, uint32_t dim, VectorMetric metric) {
+	assert(idx && gc && label && field);
+
+	// Retrieve the schema for this label
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	if(s == NULL) s = GraphContext_AddSchema(gc, label, SCHEMA_NODE);
+	int res = Schema_AddVectorIndex(idx, s, field, dim, metric);
+	ResultSet *result_set = QueryCtx_GetResultSet();
+	ResultSet_IndexCreated(result_set, res);
+	return res;
+}
+
+int GraphContext_DeleteVectorIndex(GraphContext *gc, const char *label, const char *field) {
+	// Retrieve the schema for this label
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	int res = INDEX_FAIL;
+	if(s != NULL) res = Schema_RemoveVectorIndex(s, field);
 	ResultSet *result_set = QueryCtx_GetResultSet();
 	ResultSet_IndexDeleted(result_set, res);
 	return res;
@@ -282,25 +825,133 @@ int GraphContext_DeleteIndex(GraphContext *gc, const char *label, const char *fi
 
 // Delete all references to a node from any indices built upon its properties
 void GraphContext_DeleteNodeFromIndices(GraphContext *gc, Node *n) {
-	Schema *s = NULL;
+	// Edges connected to the node are deleted along with it.
+	if(_GraphContext_HasEdgeIndices(gc)) {
+		Edge *edges = array_new(Edge, 0);
+		Graph_GetNodeEdges(gc->g, n, GRAPH_EDGE_DIR_BOTH, GRAPH_NO_RELATION, &edges);
+		uint edge_count = array_len(edges);
+		for(uint i = 0; i < edge_count; i++) GraphContext_DeleteEdgeFromIndices(gc, edges + i);
+		array_free(edges);
+	}
 
-	if(n->label) {
-		// Node will have a label string if one was specified in the query MATCH clause
-		s = GraphContext_GetSchema(gc, n->label, SCHEMA_NODE);
-	} else {
-		EntityID node_id = ENTITY_GET_ID(n);
-		// Otherwise, look up the offset of the matching label (if any)
-		int schema_id = Graph_GetNodeLabel(gc->g, node_id);
-		// Do nothing if node had no label
-		if(schema_id == GRAPH_NO_LABEL) return;
-		s = GraphContext_GetSchemaByID(gc, schema_id, SCHEMA_NODE);
+	EntityID node_id = ENTITY_GET_ID(n);
+	// Look up the labels of the node, do nothing if node has no label.
+	uint label_count = Graph_GetNodeLabels(gc->g, node_id, NULL, 0);
+	if(label_count == 0) return;
+
+	int labels[label_count];
+	Graph_GetNodeLabels(gc->g, node_id, labels, label_count);
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		// Update any indices this entity is represented in
+		Index *idx = Schema_GetIndex(s, NULL, IDX_FULLTEXT);
+		if(idx) Index_RemoveNode(idx, n);
+		idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
+		if(idx) Index_RemoveNode(idx, n);
+		uint vector_count = array_len(s->vectorIndices);
+		for(uint j = 0; j < vector_count; j++) VectorIndex_RemoveNode(s->vectorIndices[j], node_id);
 	}
+}
+
+void GraphContext_DeleteEdgeFromIndices(GraphContext *gc, Edge *e) {
+	int relation_id = Edge_GetRelationID(e);
+	if(relation_id == GRAPH_NO_RELATION) relation_id = Graph_GetEdgeRelation(gc->g, e);
+	if(relation_id == GRAPH_NO_RELATION) return;
 
-	// Update any indices this entity is represented in
-	Index *idx = Schema_GetIndex(s, NULL, IDX_FULLTEXT);
-	if(idx) Index_RemoveNode(idx, n);
-	idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
-	if(idx) Index_RemoveNode(idx, n);
+	Schema *s = GraphContext_GetSchemaByID(gc, relation_id, SCHEMA_EDGE);
+	if(s->index) Index_RemoveEdge(s->index, e);
+}
+
+//------------------------------------------------------------------------------
+// Statistics API
+//------------------------------------------------------------------------------
+
+// Serializes the construction of statistics by concurrent readers.
+static pthread_mutex_t _stats_build_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void GraphContext_AddNodeToStatistics(GraphContext *gc, Node *n) {
+	EntityID node_id = ENTITY_GET_ID(n);
+	uint label_count = Graph_GetNodeLabels(gc->g, node_id, NULL, 0);
+	if(label_count == 0) return;
+
+	int labels[label_count];
+	Graph_GetNodeLabels(gc->g, node_id, labels, label_count);
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		SchemaStats_AddEntity(s->stats, (GraphEntity *)n);
+	}
+}
+
+void GraphContext_RemoveNodeFromStatistics(GraphContext *gc, Node *n) {
+	EntityID node_id = ENTITY_GET_ID(n);
+	uint label_count = Graph_GetNodeLabels(gc->g, node_id, NULL, 0);
+	if(label_count == 0) return;
+
+	int labels[label_count];
+	Graph_GetNodeLabels(gc->g, node_id, labels, label_count);
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		SchemaStats_RemoveEntity(s->stats, (GraphEntity *)n);
+	}
+}
+
+void GraphContext_UpdateNodeStatistics(GraphContext *gc, Node *n, Attribute_ID attr,
+									   SIValue old_value, SIValue new_value) {
+	EntityID node_id = ENTITY_GET_ID(n);
+	uint label_count = Graph_GetNodeLabels(gc->g, node_id, NULL, 0);
+	if(label_count == 0) return;
+
+	int labels[label_count];
+	Graph_GetNodeLabels(gc->g, node_id, labels, label_count);
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		SchemaStats_UpdateProperty(s->stats, attr, old_value, new_value);
+	}
+}
+
+void GraphContext_BuildStatistics(GraphContext *gc) {
+	uint schema_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
+	if(schema_count == 0) return;
+	pthread_mutex_lock(&_stats_build_lock);
+
+	// Statistics are built aside, published once complete.
+	SchemaStats *stats[schema_count];
+	bool build = false;
+	for(uint i = 0; i < schema_count; i++) {
+		stats[i] = NULL;
+		if(gc->node_schemas[i]->stats->valid) continue;
+		stats[i] = SchemaStats_New();
+		SchemaStats_Reset(stats[i]);
+		build = true;
+	}
+
+	if(build) {
+		Node n;
+		Entity *e;
+		DataBlockIterator *iter = Graph_ScanNodes(gc->g);
+		while((e = DataBlockIterator_Next(iter))) {
+			n.entity = e;
+			uint label_count = Graph_GetNodeLabels(gc->g, e->id, NULL, 0);
+			if(label_count == 0) continue;
+
+			int labels[label_count];
+			Graph_GetNodeLabels(gc->g, e->id, labels, label_count);
+			for(uint i = 0; i < label_count; i++) {
+				if(stats[labels[i]]) SchemaStats_AddEntity(stats[labels[i]], (GraphEntity *)&n);
+			}
+		}
+		DataBlockIterator_Free(iter);
+
+		for(uint i = 0; i < schema_count; i++) {
+			if(stats[i] == NULL) continue;
+			Schema *s = gc->node_schemas[i];
+			SchemaStats *prev = s->stats;
+			__atomic_store_n(&s->stats, stats[i], __ATOMIC_RELEASE);
+			SchemaStats_Free(prev);
+		}
+	}
+
+	pthread_mutex_unlock(&_stats_build_lock);
 }
 
 //------------------------------------------------------------------------------
@@ -312,6 +963,18 @@ void GraphContext_RegisterWithModule(GraphContext *gc) {
 	graphs_in_keyspace = array_append(graphs_in_keyspace, gc);
 }
 
+void GraphContext_Warmup(GraphContext *gc) {
+	assert(gc);
+	// Queries are rejected while loading, the loading thread has the graph to itself.
+	QueryCtx_SetGraphCtx(gc);
+	uint node_schemas_count = array_len(gc->node_schemas);
+	for(uint i = 0; i < node_schemas_count; i++) {
+		Schema *s = gc->node_schemas[i];
+		if(s->index) GraphContext_ConstructIndex(gc, s->index);
+	}
+	QueryCtx_Free();
+}
+
 // Delete a GraphContext reference from the global array
 void GraphContext_RemoveFromRegistry(GraphContext *gc) {
 	uint graph_count = array_len(graphs_in_keyspace);
@@ -333,19 +996,116 @@ SlowLog *GraphContext_GetSlowLog(const GraphContext *gc) {
 	return gc->slowlog;
 }
 
+QueryStats *GraphContext_GetQueryStats(const GraphContext *gc) {
+	assert(gc);
+	return gc->query_stats;
+}
+
+AccessStats *GraphContext_GetAccessStats(const GraphContext *gc) {
+	assert(gc);
+	return gc->access_stats;
+}
+
+//------------------------------------------------------------------------------
+// Cache API
+//------------------------------------------------------------------------------
+
+// Return execution plan cache associated with graph context.
+Cache *GraphContext_GetCache(const GraphContext *gc) {
+	assert(gc);
+	return gc->cache;
+}
+
+void GraphContext_InvalidateCache(GraphContext *gc) {
+	if(gc->cache) Cache_Clear(gc->cache);
+}
+
+Cache *GraphContext_GetResultCache(const GraphContext *gc) {
+	assert(gc);
+	return gc->results;
+}
+
+//------------------------------------------------------------------------------
+// Prepared statements API
+//------------------------------------------------------------------------------
+
+// Return prepared statements registry associated with graph context.
+PreparedStatements *GraphContext_GetPreparedStatements(const GraphContext *gc) {
+	assert(gc);
+	return gc->prepared_statements;
+}
+
+//------------------------------------------------------------------------------
+// Materialized views API
+//------------------------------------------------------------------------------
+
+// Return materialized views registry associated with graph context.
+MaterializedViews *GraphContext_GetMaterializedViews(const GraphContext *gc) {
+	assert(gc);
+	return gc->views;
+}
+
+//------------------------------------------------------------------------------
+// Projections API
+//------------------------------------------------------------------------------
+
+// Return projections registry associated with graph context.
+Projections *GraphContext_GetProjections(const GraphContext *gc) {
+	assert(gc);
+	return gc->projections;
+}
+
+//------------------------------------------------------------------------------
+// Pinned plans API
+//------------------------------------------------------------------------------
+
+// Return pinned plans registry associated with graph context.
+PlanPins *GraphContext_GetPlanPins(const GraphContext *gc) {
+	assert(gc);
+	return gc->pins;
+}
+
+//------------------------------------------------------------------------------
+// Cursors API
+//------------------------------------------------------------------------------
+
+// Return cursors registry associated with graph context.
+Cursors *GraphContext_GetCursors(const GraphContext *gc) {
+	assert(gc);
+	return gc->cursors;
+}
+
+//------------------------------------------------------------------------------
+// Commit group API
+//------------------------------------------------------------------------------
+
+// Return the commit group coalescing the graph's writers.
+CommitGroup *GraphContext_GetCommitGroup(const GraphContext *gc) {
+	assert(gc);
+	return gc->commit_group;
+}
+
 //------------------------------------------------------------------------------
 // Free routine
 //------------------------------------------------------------------------------
 
-// Free all data associated with graph
-static void _GraphContext_Free(void *arg) {
-	GraphContext *gc = (GraphContext *)arg;
+// Frees the graph's entities a chunk at a time, once those are freed the remaining data is freed at once.
+static bool _GraphContext_FreeStep(void *arg) {
+	GraphContextRelease *release = (GraphContextRelease *)arg;
+	GraphContext *gc = release->gc;
 	uint len;
-	rm_free(gc->graph_name);
 
-	// Disable matrix synchronization for graph deletion.
-	Graph_SetMatrixPolicy(gc->g, DISABLED);
-	Graph_Free(gc->g);
+	if(release->graph == NULL) {
+		// Suspended queries reference the graph and its schemas.
+		Cursors_Free(gc->cursors);
+		// Disable matrix synchronization for graph deletion.
+		Graph_SetMatrixPolicy(gc->g, DISABLED);
+		release->graph = Graph_BeginFree(gc->g);
+		return false;
+	}
+
+	if(!Graph_FreeStep(release->graph, GRAPHCONTEXT_FREE_STEP_SIZE)) return false;
+	rm_free(gc->graph_name);
 
 	// Free all node schemas
 	if(gc->node_schemas) {
@@ -374,8 +1134,23 @@ static void _GraphContext_Free(void *arg) {
 		}
 		array_free(gc->string_mapping);
 	}
+	if(gc->interned_attributes) array_free(gc->interned_attributes);
+	// Interned values are released along with the graph entities.
+	StringPool_Free(gc->string_pool);
 
 	if(gc->slowlog) SlowLog_Free(gc->slowlog);
+	QueryStats_Free(gc->query_stats);
+	AccessStats_Free(gc->access_stats);
+	ChangeFeed_Free(gc->changes);
+	if(gc->cache) Cache_Free(gc->cache);
+	if(gc->results) Cache_Free(gc->results);
+	PreparedStatements_Free(gc->prepared_statements);
+	MaterializedViews_Free(gc->views);
+	Projections_Free(gc->projections);
+	PlanPins_Free(gc->pins);
+	CommitGroup_Free(gc->commit_group);
 
 	rm_free(gc);
+	rm_free(release);
+	return true;
 }
@@ -12,6 +12,18 @@
 #include "../index/index.h"
 #include "../schema/schema.h"
 #include "../slow_log/slow_log.h"
+#include "../query_stats/query_stats.h"
+#include "../access_stats/access_stats.h"
+#include "../util/cache/cache.h"
+#include "../util/string_pool.h"
+#include "../prepared_statements/prepared_statements.h"
+#include "../materialized_views/materialized_views.h"
+#include "../projections/projections.h"
+#include "../plan_pins/plan_pins.h"
+#include "../cursors/cursors.h"
+#include "../commit_group/commit_group.h"
+#include "../result_cache/result_cache.h"
+#include "../change_feed/change_feed.h"
 #include "graph.h"
 
 typedef struct {
@@ -20,10 +32,28 @@ typedef struct {
 	rax *attributes;            // From strings to attribute IDs
 	char *graph_name;           // String associated with graph
 	char **string_mapping;      // From attribute IDs to strings
+	bool *interned_attributes;  // Per attribute ID, true if attribute string values are interned
+	StringPool *string_pool;    // Interned string values
 	Schema **node_schemas;      // Array of schemas for each node label
 	Schema **relation_schemas;  // Array of schemas for each relation type
 	unsigned short index_count; // Number of indicies.
     SlowLog *slowlog;           // Slowlog associated with graph.
+	QueryStats *query_stats;    // Execution statistics per plan fingerprint.
+	AccessStats *access_stats;  // Sampled entity accesses, NULL if accesses aren't sampled.
+	ChangeFeed *changes;        // Mutations awaiting the graph's change stream, NULL if changes aren't captured.
+	Cache *cache;               // Execution plan cache.
+	PreparedStatements *prepared_statements; // Queries prepared for execution by handle.
+	MaterializedViews *views;   // Materialized views defined over the graph.
+	Projections *projections;   // Subgraph projections graph algorithms run on.
+	PlanPins *pins;             // Execution plans pinned per query.
+	Cursors *cursors;           // Suspended queries, read through GRAPH.CURSOR.
+	Cache *results;             // Results of read-only queries, NULL if results aren't cached.
+	CommitGroup *commit_group;  // Concurrent writers committed together.
+	bool sync_scheduled;        // Pending matrix changes are about to be applied in the background.
+	bool index_updates_scheduled; // Pending index updates are about to be applied in the background.
+	bool expiry_scheduled;      // Expired entities are about to be deleted in the background.
+	size_t memory_usage;        // Bytes held by the graph as last measured, 0 until measured.
+	uint64_t write_version;     // Number of replicated writes applied to the graph, persisted.
 } GraphContext;
 
 /* GraphContext API */
@@ -33,8 +63,25 @@ GraphContext *GraphContext_Retrieve(RedisModuleCtx *ctx, RedisModuleString *grap
 									bool shouldCreate);
 // GraphContext_Retrieve counterpart, releases a retrieved GraphContext.
 void GraphContext_Release(GraphContext *gc);
-// Mark graph key as "dirty" for Redis to pick up on.
-void GraphContext_MarkWriter(RedisModuleCtx *ctx, GraphContext *gc);
+/* Apply pending matrix changes on a background thread,
+ * sparing the next reader the cost of flushing them. */
+void GraphContext_ScheduleSynchronization(GraphContext *gc);
+// Apply the pending updates of asynchronous indices, expects the graph to be held exclusively.
+void GraphContext_ApplyIndexUpdates(GraphContext *gc);
+/* Schedules the pending updates of asynchronous indices to be applied in the background,
+ * expects the caller to have entered the graph as a writer. */
+void GraphContext_ScheduleIndexUpdates(GraphContext *gc);
+/* Schedules the graph's committed changes to be appended to its change stream
+ * in the background, expects the caller to have released the graph's write lock. */
+void GraphContext_ScheduleChangeFeed(GraphContext *gc);
+/* Schedules the graph's expired entities to be deleted in the background,
+ * expects the GIL. */
+void GraphContext_ScheduleExpiry(GraphContext *gc);
+// Returns true if graph context is still stored in the keyspace, expects the GIL.
+bool GraphContext_InKeyspace(const GraphContext *gc);
+/* Creates a copy of graph context named graph_name, the copy isn't stored in the keyspace.
+ * Caller is expected to hold the graph's read lock. */
+GraphContext *GraphContext_Clone(const GraphContext *gc, const char *graph_name);
 // Mark graph as deleted, reduce graph reference count by 1.
 void GraphContext_Delete(GraphContext *gc);
 
@@ -59,6 +106,9 @@ Attribute_ID GraphContext_FindOrAddAttribute(GraphContext *gc, const char *attri
 const char *GraphContext_GetAttributeString(const GraphContext *gc, Attribute_ID id);
 // Retrieve an attribute ID given a string, or ATTRIBUTE_NOTFOUND if attribute doesn't exist.
 Attribute_ID GraphContext_GetAttributeID(const GraphContext *gc, const char *str);
+// Retrieve the value to store as an entity attribute, interning strings of interned attributes.
+// Interned values are borrowed from the pool, storing them as an entity property acquires a reference.
+SIValue GraphContext_InternValue(GraphContext *gc, Attribute_ID id, SIValue v);
 
 /* Index API */
 bool GraphContext_HasIndices(GraphContext *gc);
@@ -71,19 +121,119 @@ int GraphContext_AddIndex(Index **idx, GraphContext *gc, const char *label, cons
 // Remove and free an index
 int GraphContext_DeleteIndex(GraphContext *gc, const char *label, const char *field,
 							 IndexType type);
-// Remove a single node from all indices that refer to it
+// Create a composite index over the given label and ordered attributes
+int GraphContext_AddCompositeIndex(Index **idx, GraphContext *gc, const char *label,
+								   const char **fields, uint fields_count);
+// Remove a composite index, rebuilding the label's remaining composite indices
+int GraphContext_DeleteCompositeIndex(GraphContext *gc, const char *label, const char **fields,
+									  uint fields_count);
+/* Construct a label's index, with the exception of small labels the index is
+ * constructed in the background and becomes operational once constructed.
+ * Expects the graph write lock. */
+void GraphContext_ConstructIndex(GraphContext *gc, Index *idx);
+// Constrain the values of an indexed label attribute to be unique
+int GraphContext_AddUniqueConstraint(GraphContext *gc, const char *label, const char *field);
+// Remove a unique constraint, keeping the attribute's index
+int GraphContext_DeleteUniqueConstraint(GraphContext *gc, const char *label, const char *field);
+// Create a vector similarity index over the given label and attribute
+int GraphContext_AddVectorIndex(VectorIndex **idx, GraphContext *gc, const char *label,
+								const char *field, uint32_t dim, VectorMetric metric);
+// Remove the vector similarity index over the given label and attribute
+int GraphContext_DeleteVectorIndex(GraphContext *gc, const char *label, const char *field);
+// Attempt to retrieve an index on the given relationship type and attribute
+Index *GraphContext_GetEdgeIndex(const GraphContext *gc, const char *relation, const char *field);
+// Create an index for the given relationship type and attribute
+int GraphContext_AddEdgeIndex(Index **idx, GraphContext *gc, const char *relation,
+							  const char *field);
+// Remove an attribute from a relationship type's index
+int GraphContext_DeleteEdgeIndex(GraphContext *gc, const char *relation, const char *field);
+// Expire the entities of a label or relationship type ttl seconds past their timestamp attribute
+void GraphContext_SetExpiry(GraphContext *gc, const char *label, SchemaType t,
+							const char *attribute, uint64_t ttl);
+// Index the validity intervals of a relationship type's edges, a NULL from attribute drops the index
+void GraphContext_SetIntervals(GraphContext *gc, const char *relation, const char *from_attribute,
+							   const char *to_attribute);
+// Keep the weight matrix of a relationship type by attribute in sync with edge writes, or stop doing so
+// Returns false if the setting is unchanged
+bool GraphContext_MaintainWeights(GraphContext *gc, const char *relation, const char *attribute,
+								  bool maintain);
+// Returns true if the entities of any label or relationship type expire
+bool GraphContext_HasExpiry(const GraphContext *gc);
+// Remove a single node, and the edges its deletion implies, from all indices that refer to them
 void GraphContext_DeleteNodeFromIndices(GraphContext *gc, Node *n);
+// Remove a single edge from its relationship type's index
+void GraphContext_DeleteEdgeFromIndices(GraphContext *gc, Edge *e);
+
+/* Statistics API */
+// Account for a newly created node in the statistics of its labels
+void GraphContext_AddNodeToStatistics(GraphContext *gc, Node *n);
+// Account for the deletion of a node in the statistics of its labels
+void GraphContext_RemoveNodeFromStatistics(GraphContext *gc, Node *n);
+// Account for a node's attribute changing from old_value to new_value
+void GraphContext_UpdateNodeStatistics(GraphContext *gc, Node *n, Attribute_ID attr,
+									   SIValue old_value, SIValue new_value);
+// Rebuild invalid label statistics by scanning the graph's nodes, expects a read lock
+void GraphContext_BuildStatistics(GraphContext *gc);
 
 // Add GraphContext to global array
 void GraphContext_RegisterWithModule(GraphContext *gc);
+
+/* Post-load phase of a decoded graph registered with the module, constructs its label indices,
+ * such that the indices of large labels are constructed in the background.
+ * Until constructed, queries scan the label rather than utilize the index. */
+void GraphContext_Warmup(GraphContext *gc);
 // Remove GraphContext from global array
 void GraphContext_RemoveFromRegistry(GraphContext *gc);
 
 // Rename a graph context.
 void GraphContext_Rename(GraphContext *gc, const char *name);
 
+/* Write version API */
+/* Return the number of replicated writes applied to the graph.
+ * Replicas apply the same writes and so reach the same version as their master. */
+uint64_t GraphContext_GetWriteVersion(const GraphContext *gc);
+// Advance the write version once a replicated write is applied, returns the new version.
+uint64_t GraphContext_AdvanceWriteVersion(GraphContext *gc);
+
 /* Slowlog API */
 SlowLog* GraphContext_GetSlowLog(const GraphContext *gc);
+// Return query execution statistics associated with graph context.
+QueryStats *GraphContext_GetQueryStats(const GraphContext *gc);
+// Return sampled entity accesses of graph context, NULL if accesses aren't sampled.
+AccessStats *GraphContext_GetAccessStats(const GraphContext *gc);
+
+/* Cache API */
+// Return the execution plan cache associated with graph.
+Cache *GraphContext_GetCache(const GraphContext *gc);
+// Drop all cached execution plans, called whenever the graph schema changes.
+void GraphContext_InvalidateCache(GraphContext *gc);
+
+// Return the query result cache associated with graph, NULL if results aren't cached.
+Cache *GraphContext_GetResultCache(const GraphContext *gc);
+
+/* Prepared statements API */
+// Return the prepared statements registry associated with graph.
+PreparedStatements *GraphContext_GetPreparedStatements(const GraphContext *gc);
+
+/* Materialized views API */
+// Return materialized views registry associated with graph context.
+MaterializedViews *GraphContext_GetMaterializedViews(const GraphContext *gc);
+
+/* Projections API */
+// Return projections registry associated with graph context.
+Projections *GraphContext_GetProjections(const GraphContext *gc);
+
+/* Pinned plans API */
+// Return pinned plans registry associated with graph context.
+PlanPins *GraphContext_GetPlanPins(const GraphContext *gc);
+
+/* Cursors API */
+// Return cursors registry associated with graph context.
+Cursors *GraphContext_GetCursors(const GraphContext *gc);
+
+/* Commit group API */
+// Return the commit group coalescing the graph's writers.
+CommitGroup *GraphContext_GetCommitGroup(const GraphContext *gc);
 
 #endif
 
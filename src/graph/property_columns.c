@@ -0,0 +1,136 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "property_columns.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include <math.h>
+#include <stdlib.h>
+#include <assert.h>
+
+// Integers beyond 2^53 can't be represented exactly by a double.
+#define PROPERTY_COLUMN_MAX_EXACT_INT (1LL << 53)
+
+static void _PropertyColumn_Free(PropertyColumn *c) {
+	rm_free(c->valid);
+	rm_free(c->values);
+	rm_free(c);
+}
+
+// Copy entity's attribute value into column, returns false if value can't be represented.
+static bool _PropertyColumn_Set(PropertyColumn *c, const Entity *en) {
+	GraphEntity ge = { .entity = (Entity *)en };
+	SIValue *v = GraphEntity_GetProperty(&ge, c->attr);
+	if(v == PROPERTY_NOTFOUND) return true;
+
+	double d;
+	SIType t = SI_TYPE(*v);
+	if(t == T_INT64) {
+		if(llabs(v->longval) >= PROPERTY_COLUMN_MAX_EXACT_INT) return false;
+		d = v->longval;
+	} else if(t == T_DOUBLE) {
+		if(isnan(v->doubleval)) return false;
+		d = v->doubleval;
+	} else {
+		return false;
+	}
+
+	EntityID id = en->id;
+	c->types |= t;
+	c->values[id] = d;
+	c->valid[id / PROPERTY_COLUMN_WORD_BITS] |= 1UL << (id % PROPERTY_COLUMN_WORD_BITS);
+	return true;
+}
+
+static PropertyColumn *_PropertyColumn_Build(Graph *g, int label, Attribute_ID attr,
+											 uint64_t version) {
+	PropertyColumn *c = rm_malloc(sizeof(PropertyColumn));
+	c->label = label;
+	c->attr = attr;
+	c->version = version;
+	c->len = Graph_RequiredMatrixDim(g);
+	c->types = 0;
+	c->usable = true;
+	c->valid = rm_calloc(PropertyColumn_WordCount(c), sizeof(uint64_t));
+	c->values = rm_calloc(c->len, sizeof(double));
+
+	if(label == GRAPH_NO_LABEL) {
+		Entity *en;
+		DataBlockIterator *it = Graph_ScanNodes(g);
+		while(c->usable && (en = DataBlockIterator_Next(it)) != NULL) {
+			c->usable = _PropertyColumn_Set(c, en);
+		}
+		DataBlockIterator_Free(it);
+	} else {
+		Node n;
+		uint64_t id;
+		IDSetIterator it;
+		IDSet_Iterate(Graph_GetLabelIDs(g, label), &it);
+		while(c->usable && IDSetIterator_Next(&it, &id)) {
+			Graph_GetNode(g, id, &n);
+			c->usable = _PropertyColumn_Set(c, n.entity);
+		}
+	}
+
+	// Release memory held by an unusable column, keeping it as a marker.
+	if(!c->usable) {
+		rm_free(c->valid);
+		rm_free(c->values);
+		c->valid = NULL;
+		c->values = NULL;
+	}
+	return c;
+}
+
+PropertyColumns *PropertyColumns_New(void) {
+	PropertyColumns *columns = rm_malloc(sizeof(PropertyColumns));
+	columns->columns = array_new(PropertyColumn *, 0);
+	int res = pthread_mutex_init(&columns->lock, NULL);
+	assert(res == 0);
+	return columns;
+}
+
+const PropertyColumn *PropertyColumns_Get(Graph *g, int label, Attribute_ID attr) {
+	assert(g && attr != ATTRIBUTE_NOTFOUND);
+	PropertyColumns *columns = g->_columns;
+	PropertyColumn *c = NULL;
+
+	pthread_mutex_lock(&columns->lock);
+
+	/* Drop columns built at an earlier version, these are no longer referenced,
+	 * as readers only access columns of the current version. */
+	uint count = array_len(columns->columns);
+	for(uint i = 0; i < count;) {
+		PropertyColumn *col = columns->columns[i];
+		if(col->version == g->version) {
+			if(col->label == label && col->attr == attr) c = col;
+			i++;
+			continue;
+		}
+		_PropertyColumn_Free(col);
+		columns->columns[i] = columns->columns[--count];
+		array_pop(columns->columns);
+	}
+
+	if(c == NULL && count < PROPERTY_COLUMNS_CAP) {
+		c = _PropertyColumn_Build(g, label, attr, g->version);
+		columns->columns = array_append(columns->columns, c);
+	}
+
+	pthread_mutex_unlock(&columns->lock);
+
+	if(c == NULL || !c->usable) return NULL;
+	return c;
+}
+
+void PropertyColumns_Free(PropertyColumns *columns) {
+	if(columns == NULL) return;
+	uint count = array_len(columns->columns);
+	for(uint i = 0; i < count; i++) _PropertyColumn_Free(columns->columns[i]);
+	array_free(columns->columns);
+	pthread_mutex_destroy(&columns->lock);
+	rm_free(columns);
+}
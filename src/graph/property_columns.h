@@ -0,0 +1,63 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "graph.h"
+#include "../value.h"
+
+// Maximum number of columns a graph maintains.
+#define PROPERTY_COLUMNS_CAP 32
+// Number of node IDs covered by a single bitmap word.
+#define PROPERTY_COLUMN_WORD_BITS 64
+
+/* Columnar copy of a single node attribute, restricted to a label.
+ * Values are stored contiguously, indexed by node ID, alongside a bitmap
+ * marking which nodes hold the attribute, allowing analytical scans to
+ * sweep through memory sequentially instead of visiting every entity.
+ * Columns are built on demand from the entities' properties and are valid
+ * for the graph version they were built at, any write invalidates them. */
+typedef struct {
+	int label;          // Label ID, GRAPH_NO_LABEL covers all nodes.
+	Attribute_ID attr;  // Attribute ID.
+	uint64_t version;   // Graph version column was built at.
+	uint64_t len;       // Number of node IDs covered by column.
+	SIType types;       // Types of values held by column.
+	bool usable;        // False if a value can't be represented by column.
+	uint64_t *valid;    // Bit i is set if node i holds an attribute value.
+	double *values;     // Attribute values indexed by node ID.
+} PropertyColumn;
+
+// Collection of columns built for a graph.
+typedef struct PropertyColumns {
+	PropertyColumn **columns;   // Built columns.
+	pthread_mutex_t lock;       // Guards columns, concurrent readers may build columns.
+} PropertyColumns;
+
+// Create an empty column collection.
+PropertyColumns *PropertyColumns_New(void);
+
+/* Retrieves column of attr over nodes labeled as label, building it if required.
+ * Returns NULL if the attribute values can't be held by a column, i.e. non numeric values,
+ * or the collection is at capacity.
+ * Caller is expected to hold the graph's read lock while accessing the column. */
+const PropertyColumn *PropertyColumns_Get(Graph *g, int label, Attribute_ID attr);
+
+// Returns number of bitmap words required to cover column.
+static inline uint64_t PropertyColumn_WordCount(const PropertyColumn *c) {
+	return (c->len + PROPERTY_COLUMN_WORD_BITS - 1) / PROPERTY_COLUMN_WORD_BITS;
+}
+
+// Returns true if all column values share the same type.
+static inline bool PropertyColumn_Homogeneous(const PropertyColumn *c) {
+	return (c->types & (c->types - 1)) == 0;
+}
+
+// Free column collection.
+void PropertyColumns_Free(PropertyColumns *columns);
@@ -29,27 +29,33 @@ static void _BuildQueryGraphAddNode(QueryGraph *qg, const cypher_astnode_t *ast_
 
 	// Retrieve node labels from the AST entity.
 	uint nlabels = cypher_ast_node_pattern_nlabels(ast_entity);
-	// We currently only support 0 or 1 labels per node, so if any are specified just select the first.
-	const char *label = (nlabels > 0) ? cypher_ast_label_get_name(cypher_ast_node_pattern_get_label(
-																	  ast_entity, 0)) : NULL;
-
-	// Set node label ID if one has not already been set.
-	if(n->labelID == GRAPH_NO_LABEL) {
-		if(label) {
-			Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
-			uint label_id = GRAPH_UNKNOWN_LABEL;
-			// If a schema is found, the AST refers to a real label.
-			if(s) label_id = s->id;
-			n->label = label;
-			n->labelID = label_id;
-		} else {
-			n->labelID = GRAPH_NO_LABEL;
+	for(uint i = 0; i < nlabels; i++) {
+		const char *label = cypher_ast_label_get_name(cypher_ast_node_pattern_get_label(ast_entity, i));
+		Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+		// If a schema is found, the AST refers to a real label.
+		int label_id = (s) ? s->id : GRAPH_UNKNOWN_LABEL;
+		QGNode_AddLabel(n, label, label_id);
+	}
+
+	/* Select the label node scans and label filters operate on.
+	 * Nodes holding multiple labels must be members of all of them,
+	 * so prefer a missing label, otherwise the least populated one. */
+	uint label_count = QGNode_LabelCount(n);
+	for(uint i = 0; i < label_count; i++) {
+		int label_id = n->labelsID[i];
+		if(n->labelID != GRAPH_NO_LABEL) {
+			if(n->labelID == GRAPH_UNKNOWN_LABEL) break;
+			if(label_id != GRAPH_UNKNOWN_LABEL &&
+			   Graph_LabeledNodeCount(gc->g, label_id) >=
+			   Graph_LabeledNodeCount(gc->g, n->labelID)) continue;
 		}
+		n->label = n->labels[i];
+		n->labelID = label_id;
 	}
 }
 
 static void _BuildQueryGraphAddEdge(QueryGraph *qg, const cypher_astnode_t *ast_entity,
-									QGNode *src, QGNode *dest) {
+									QGNode *src, QGNode *dest, QGEdgePaths paths) {
 
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	AST *ast = QueryCtx_GetAST();
@@ -61,6 +67,7 @@ static void _BuildQueryGraphAddEdge(QueryGraph *qg, const cypher_astnode_t *ast_
 
 	QGEdge *edge = QGEdge_New(NULL, NULL, NULL, alias);
 	edge->bidirectional = (dir == CYPHER_REL_BIDIRECTIONAL);
+	edge->paths = paths;
 
 	// Add the IDs of all reltype matrixes
 	uint nreltypes = cypher_ast_rel_pattern_nreltypes(ast_entity);
@@ -123,6 +130,14 @@ void QueryGraph_AddPath(QueryGraph *qg, const GraphContext *gc, const cypher_ast
 
 	AST *ast = QueryCtx_GetAST();
 
+	// Edges of shortestPath and allShortestPaths patterns only match shortest paths.
+	QGEdgePaths paths = QG_EDGE_PATHS_ALL;
+	const cypher_astnode_t *shortest_path = AST_GetShortestPath(path);
+	if(shortest_path) {
+		paths = cypher_ast_shortest_path_is_single(shortest_path) ? QG_EDGE_PATHS_SHORTEST :
+				QG_EDGE_PATHS_ALL_SHORTEST;
+	}
+
 	/* Every odd offset corresponds to an edge in a path. */
 	for(uint i = 1; i < nelems; i += 2) {
 		// Retrieve the QGNode corresponding to the node left of this edge.
@@ -137,7 +152,7 @@ void QueryGraph_AddPath(QueryGraph *qg, const GraphContext *gc, const cypher_ast
 
 		// Retrieve the AST reference to this edge.
 		const cypher_astnode_t *edge = cypher_ast_pattern_path_get_element(path, i);
-		_BuildQueryGraphAddEdge(qg, edge, left, right);
+		_BuildQueryGraphAddEdge(qg, edge, left, right, paths);
 	}
 }
 
@@ -8,6 +8,8 @@
 #include "decode_graph.h"
 #include "../../graph.h"
 #include "../../../datatypes/array.h"
+#include "../../../util/arr.h"
+#include "../../../util/thpool/pools.h"
 
 // Forward declerations.
 SIValue _RdbLoadSIArray(RedisModuleIO *rdb);
@@ -31,6 +33,11 @@ SIValue _RdbLoadSIValue(RedisModuleIO *rdb) {
 		return SI_BoolVal(RedisModule_LoadSigned(rdb));
 	case T_ARRAY:
 		return _RdbLoadSIArray(rdb);
+	case T_POINT: {
+		double latitude = RedisModule_LoadDouble(rdb);
+		double longitude = RedisModule_LoadDouble(rdb);
+		return SI_Point(latitude, longitude);
+	}
 	case T_NULL:
 	default: // currently impossible
 		return SI_NullVal();
@@ -57,20 +64,25 @@ SIValue _RdbLoadSIArray(RedisModuleIO *rdb) {
 void _RdbLoadEntity(RedisModuleIO *rdb, GraphContext *gc, GraphEntity *e) {
 	/* Format:
 	 * #properties N
-	 * (name, value type, value) X N
+	 * (attribute ID, value type, value) X N
 	*/
 	uint64_t propCount = RedisModule_LoadUnsigned(rdb);
 	if(!propCount) return;
 
+	// Properties are added at once, allowing short strings to share an allocation.
+	Attribute_ID attr_ids[propCount];
+	SIValue attr_values[propCount];
+	SIValue values[propCount];
 	for(int i = 0; i < propCount; i++) {
-		char *attr_name = RedisModule_LoadStringBuffer(rdb, NULL);
-		SIValue attr_value = _RdbLoadSIValue(rdb);
-		Attribute_ID attr_id = GraphContext_GetAttributeID(gc, attr_name);
-		assert(attr_id != ATTRIBUTE_NOTFOUND);
-		GraphEntity_AddProperty(e, attr_id, attr_value);
-		SIValue_Free(attr_value);
-		RedisModule_Free(attr_name);
+		// Attribute keys were loaded in ID order, IDs are preserved.
+		attr_ids[i] = RedisModule_LoadUnsigned(rdb);
+		assert(attr_ids[i] < GraphContext_AttributeCount(gc));
+		attr_values[i] = _RdbLoadSIValue(rdb);
+		values[i] = GraphContext_InternValue(gc, attr_ids[i], attr_values[i]);
 	}
+
+	GraphEntity_AddProperties(e, propCount, attr_ids, values);
+	for(int i = 0; i < propCount; i++) SIValue_Free(attr_values[i]);
 }
 
 void _RdbLoadNodes(RedisModuleIO *rdb, GraphContext *gc) {
@@ -79,7 +91,7 @@ void _RdbLoadNodes(RedisModuleIO *rdb, GraphContext *gc) {
 	 *      #labels M
 	 *      (labels) X M
 	 *      #properties N
-	 *      (name, value type, value) X N
+	 *      (attribute ID, value type, value) X N
 	*/
 
 	uint64_t nodeCount = RedisModule_LoadUnsigned(rdb);
@@ -89,14 +101,16 @@ void _RdbLoadNodes(RedisModuleIO *rdb, GraphContext *gc) {
 	for(uint64_t i = 0; i < nodeCount; i++) {
 		Node n;
 
-		// Extend this logic when multi-label support is added.
 		// #labels M
 		uint64_t nodeLabelCount = RedisModule_LoadUnsigned(rdb);
 
 		// * (labels) x M
-		// M will currently always be 0 or 1
+		// The first label is the node's primary label.
 		uint64_t l = (nodeLabelCount) ? RedisModule_LoadUnsigned(rdb) : GRAPH_NO_LABEL;
 		Graph_CreateNode(gc->g, l, &n);
+		for(uint64_t j = 1; j < nodeLabelCount; j++) {
+			Graph_LabelNode(gc->g, ENTITY_GET_ID(&n), RedisModule_LoadUnsigned(rdb));
+		}
 
 		_RdbLoadEntity(rdb, gc, (GraphEntity *)&n);
 	}
@@ -116,15 +130,41 @@ void _RdbLoadEdges(RedisModuleIO *rdb, GraphContext *gc) {
 	if(edgeCount == 0) return;
 
 	Graph_AllocateEdges(gc->g, edgeCount);
-	// Construct connections.
-	for(int i = 0; i < edgeCount; i++) {
+
+	/* Rather than connecting edges one by one, collect each relation's
+	 * connections and populate its matrices at once. */
+	uint relation_count = Graph_RelationTypeCount(gc->g);
+	GrB_Index *src[relation_count];
+	GrB_Index *dest[relation_count];
+	EdgeID *ids[relation_count];
+	for(uint r = 0; r < relation_count; r++) {
+		src[r] = array_new(GrB_Index, 0);
+		dest[r] = array_new(GrB_Index, 0);
+		ids[r] = array_new(EdgeID, 0);
+	}
+
+	for(uint64_t i = 0; i < edgeCount; i++) {
 		Edge e;
 		NodeID srcId = RedisModule_LoadUnsigned(rdb);
 		NodeID destId = RedisModule_LoadUnsigned(rdb);
 		uint64_t relation = RedisModule_LoadUnsigned(rdb);
-		assert(Graph_ConnectNodes(gc->g, srcId, destId, relation, &e));
+		assert(relation < relation_count);
+		Graph_CreateEdge(gc->g, srcId, destId, relation, &e);
+		src[relation] = array_append(src[relation], srcId);
+		dest[relation] = array_append(dest[relation], destId);
+		ids[relation] = array_append(ids[relation], ENTITY_GET_ID(&e));
 		_RdbLoadEntity(rdb, gc, (GraphEntity *)&e);
 	}
+
+	/* Relation matrices are independent of one another and are built concurrently,
+	 * by as many threads as serve queries. */
+	Graph_MergeRelations(gc->g, src, dest, ids, relation_count, ThreadPools_ThreadCount());
+
+	for(uint r = 0; r < relation_count; r++) {
+		array_free(src[r]);
+		array_free(dest[r]);
+		array_free(ids[r]);
+	}
 }
 
 void RdbLoadGraph(RedisModuleIO *rdb, GraphContext *gc) {
@@ -133,14 +173,14 @@ void RdbLoadGraph(RedisModuleIO *rdb, GraphContext *gc) {
 	 *      #labels M
 	 *      (labels) X M
 	 *      #properties N
-	 *      (name, value type, value) X N
+	 *      (attribute ID, value type, value) X N
 	 *
 	 * #edges
 	 *      relation type
 	 *      source node ID
 	 *      destination node ID
 	 *      #properties N
-	 *      (name, value type, value) X N
+	 *      (attribute ID, value type, value) X N
 	 */
 
 	// While loading the graph, minimize matrix realloc and synchronization calls.
@@ -11,7 +11,9 @@
 #include "../../../util/arr.h"
 #include "../../../query_ctx.h"
 #include "../../../util/rmalloc.h"
+#include "../../weight_matrices.h"
 #include "../../../slow_log/slow_log.h"
+#include "../../../execution_plan/plan_cache.h"
 
 static void _RdbLoadAttributeKeys(RedisModuleIO *rdb, GraphContext *gc) {
 	/* Format:
@@ -27,7 +29,27 @@ static void _RdbLoadAttributeKeys(RedisModuleIO *rdb, GraphContext *gc) {
 	}
 }
 
-GraphContext *RdbLoadGraphContext(RedisModuleIO *rdb) {
+static void _RdbLoadPlanPins(RedisModuleIO *rdb, GraphContext *gc) {
+	/* Format:
+	 * #pinned plans
+	 * (query, rules, shape) X #pinned plans
+	 */
+
+	uint64_t count = RedisModule_LoadUnsigned(rdb);
+	for(uint64_t i = 0; i < count; i++) {
+		size_t len;
+		char *buf = RedisModule_LoadStringBuffer(rdb, &len);
+		char *query = rm_strndup(buf, len);
+		RedisModule_Free(buf);
+		uint rules = RedisModule_LoadUnsigned(rdb);
+		char *shape = RedisModule_LoadStringBuffer(rdb, NULL);
+		PlanPins_Set(gc->pins, query, rules, shape);
+		RedisModule_Free(shape);
+		rm_free(query);
+	}
+}
+
+GraphContext *RdbLoadGraphContext(RedisModuleIO *rdb, int encver) {
 	/* Format:
 	 * graph name
 	 * attribute keys (unified schema)
@@ -37,6 +59,8 @@ GraphContext *RdbLoadGraphContext(RedisModuleIO *rdb) {
 	 * unified relation schema
 	 * relation schema X #relation schemas
 	 * graph object
+	 * pinned plans, from version 8 on
+	 * write version, from version 9 on
 	*/
 
 	GraphContext *gc = rm_calloc(1, sizeof(GraphContext));
@@ -44,8 +68,25 @@ GraphContext *RdbLoadGraphContext(RedisModuleIO *rdb) {
 	gc->index_count = 0;
 	gc->attributes = raxNew();
 	gc->string_mapping = array_new(char *, 64);
+	gc->interned_attributes = array_new(bool, 64);
+	gc->string_pool = StringPool_New();
 	gc->g = Graph_New(GRAPH_DEFAULT_NODE_CAP, GRAPH_DEFAULT_EDGE_CAP);
 	gc->slowlog = SlowLog_New();
+	gc->cache = PlanCache_New();
+	gc->sync_scheduled = false;
+	gc->index_updates_scheduled = false;
+	gc->expiry_scheduled = false;
+	gc->memory_usage = 0;
+	gc->prepared_statements = PreparedStatements_New();
+	gc->views = MaterializedViews_New();
+	gc->projections = Projections_New();
+	gc->pins = PlanPins_New();
+	gc->cursors = Cursors_New();
+	gc->query_stats = QueryStats_New();
+	gc->access_stats = AccessStats_New();
+	gc->changes = ChangeFeed_New();
+	gc->results = ResultCache_New();
+	gc->commit_group = CommitGroup_New();
 
 	// Set the thread-local GraphContext, as it will be accessed if we're decoding indexes.
 	QueryCtx_SetGraphCtx(gc);
@@ -79,11 +120,33 @@ GraphContext *RdbLoadGraphContext(RedisModuleIO *rdb) {
 	// Graph object.
 	RdbLoadGraph(rdb, gc);
 
+	// Pinned plans.
+	if(encver >= 8) _RdbLoadPlanPins(rdb, gc);
+
+	// Write version, graphs saved by earlier versions count writes from 0.
+	if(encver >= 9) gc->write_version = RedisModule_LoadUnsigned(rdb);
+
 	uint node_schemas_count = array_len(gc->node_schemas);
 	for(uint i = 0; i < node_schemas_count; i++) {
 		Schema *s = gc->node_schemas[i];
-		if(s->index) Index_Construct(s->index);
+		// Exact-match indices are constructed once the graph is loaded, see GraphContext_Warmup.
 		if(s->fulltextIdx) Index_Construct(s->fulltextIdx);
+		uint vector_count = array_len(s->vectorIndices);
+		for(uint j = 0; j < vector_count; j++) VectorIndex_Construct(s->vectorIndices[j]);
+	}
+
+	uint relation_schemas_count = array_len(gc->relation_schemas);
+	for(uint i = 0; i < relation_schemas_count; i++) {
+		Schema *s = gc->relation_schemas[i];
+		if(s->index) Index_Construct(s->index);
+		// Interval entries are collected once first looked up.
+		if(s->intervals) Graph_SetIntervalIndex(gc->g, s->id, s->intervals);
+		// Maintained weight matrices are built once first retrieved.
+		uint weight_count = array_len(s->weights);
+		for(uint j = 0; j < weight_count; j++) {
+			Attribute_ID attr = GraphContext_GetAttributeID(gc, s->weights[j]);
+			WeightMatrices_Maintain(gc->g, s->id, attr, true);
+		}
 	}
 
 	QueryCtx_Free(); // Release thread-local varaibles.
@@ -11,18 +11,72 @@ Schema *RdbLoadSchema(RedisModuleIO *rdb, SchemaType type) {
 	 * id
 	 * name
 	 * #indices
-	 * (index type, indexed property) X M */
+	 * (index type, indexed property) X M
+	 * (composite tag, #properties, properties) X C
+	 * (unique tag, constrained property) X U
+	 * (async tag, label) X A
+	 * (vector tag, indexed property, dimension, metric) X V
+	 * (ttl tag, timestamp property, ttl) X T
+	 * (interval tag, from property, to property) X I
+	 * (weight tag, weight property) X W */
 
 	int id = RedisModule_LoadUnsigned(rdb);
 	char *name = RedisModule_LoadStringBuffer(rdb, NULL);
-	Schema *s = Schema_New(name, id);
+	Schema *s = Schema_New(name, id, type);
 	RedisModule_Free(name);
 
 	Index *idx = NULL;
 	uint index_count = RedisModule_LoadUnsigned(rdb);
 	for(uint i = 0; i < index_count; i++) {
 		IndexType type = RedisModule_LoadUnsigned(rdb);
+		if(type == IDX_COMPOSITE_TAG) {
+			uint field_count = RedisModule_LoadUnsigned(rdb);
+			char *fields[field_count];
+			for(uint j = 0; j < field_count; j++) fields[j] = RedisModule_LoadStringBuffer(rdb, NULL);
+			Schema_AddCompositeIndex(&idx, s, (const char **)fields, field_count);
+			for(uint j = 0; j < field_count; j++) RedisModule_Free(fields[j]);
+			continue;
+		}
 		char *field = RedisModule_LoadStringBuffer(rdb, NULL);
+		if(type == IDX_UNIQUE_TAG) {
+			// Constrained fields are loaded prior to their constraints.
+			Schema_AddUniqueConstraint(s, field);
+			RedisModule_Free(field);
+			continue;
+		}
+		if(type == IDX_ASYNC_TAG) {
+			// Loaded following the fulltext index fields.
+			Index_SetAsync(s->fulltextIdx, true);
+			RedisModule_Free(field);
+			continue;
+		}
+		if(type == IDX_TTL_TAG) {
+			uint64_t ttl = RedisModule_LoadUnsigned(rdb);
+			Schema_SetExpiry(s, field, ttl);
+			RedisModule_Free(field);
+			continue;
+		}
+		if(type == IDX_INTERVAL_TAG) {
+			char *to = RedisModule_LoadStringBuffer(rdb, NULL);
+			Schema_SetIntervals(s, field, to);
+			RedisModule_Free(field);
+			RedisModule_Free(to);
+			continue;
+		}
+		if(type == IDX_WEIGHT_TAG) {
+			// Matrices are registered with the graph once it is loaded.
+			Schema_SetWeights(s, field, true);
+			RedisModule_Free(field);
+			continue;
+		}
+		if(type == IDX_VECTOR_TAG) {
+			uint32_t dim = RedisModule_LoadUnsigned(rdb);
+			VectorMetric metric = RedisModule_LoadUnsigned(rdb);
+			VectorIndex *vector_idx;
+			Schema_AddVectorIndex(&vector_idx, s, field, dim, metric);
+			RedisModule_Free(field);
+			continue;
+		}
 
 		Schema_AddIndex(&idx, s, field, type);
 		RedisModule_Free(field);
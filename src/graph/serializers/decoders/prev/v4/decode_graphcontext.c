@@ -8,6 +8,7 @@
 #include "../../../../../query_ctx.h"
 #include "../../../../../util/arr.h"
 #include "../../../../../util/rmalloc.h"
+#include "../../../../../execution_plan/plan_cache.h"
 
 /* Deserialize unified schema */
 static void _RdbLoadAttributeKeys(RedisModuleIO *rdb, GraphContext *gc) {
@@ -74,10 +75,27 @@ GraphContext *RdbLoadGraphContext_v4(RedisModuleIO *rdb) {
 	// Graph name.
 	gc->graph_name = RedisModule_LoadStringBuffer(rdb, NULL);
 	gc->g = Graph_New(GRAPH_DEFAULT_NODE_CAP, GRAPH_DEFAULT_EDGE_CAP);
+	gc->cache = PlanCache_New();
+	gc->sync_scheduled = false;
+	gc->index_updates_scheduled = false;
+	gc->expiry_scheduled = false;
+	gc->memory_usage = 0;
+	gc->prepared_statements = PreparedStatements_New();
+	gc->views = MaterializedViews_New();
+	gc->projections = Projections_New();
+	gc->pins = PlanPins_New();
+	gc->cursors = Cursors_New();
+	gc->query_stats = QueryStats_New();
+	gc->access_stats = AccessStats_New();
+	gc->changes = ChangeFeed_New();
+	gc->results = ResultCache_New();
+	gc->commit_group = CommitGroup_New();
 
 	// Initialize property mappings.
 	gc->attributes = raxNew();
 	gc->string_mapping = array_new(char *, 64);
+	gc->interned_attributes = array_new(bool, 64);
+	gc->string_pool = StringPool_New();
 
 	// #Node schemas
 	uint32_t schema_count = RedisModule_LoadUnsigned(rdb);
@@ -89,7 +107,7 @@ GraphContext *RdbLoadGraphContext_v4(RedisModuleIO *rdb) {
 	// Load each node schema
 	gc->node_schemas = array_new(Schema *, schema_count);
 	for(uint32_t i = 0; i < schema_count; i ++) {
-		gc->node_schemas = array_append(gc->node_schemas, RdbLoadSchema_v4(rdb));
+		gc->node_schemas = array_append(gc->node_schemas, RdbLoadSchema_v4(rdb, SCHEMA_NODE));
 		Graph_AddLabel(gc->g);
 	}
 
@@ -103,7 +121,7 @@ GraphContext *RdbLoadGraphContext_v4(RedisModuleIO *rdb) {
 	// Load each edge schema
 	gc->relation_schemas = array_new(Schema *, schema_count);
 	for(uint32_t i = 0; i < schema_count; i ++) {
-		array_append(gc->relation_schemas, RdbLoadSchema_v4(rdb));
+		array_append(gc->relation_schemas, RdbLoadSchema_v4(rdb, SCHEMA_EDGE));
 		Graph_AddRelationType(gc->g);
 	}
 
@@ -117,15 +135,7 @@ GraphContext *RdbLoadGraphContext_v4(RedisModuleIO *rdb) {
 		RdbLoadIndex_v4(rdb, gc);
 	}
 
-	/* Build indices
-	 * only node schemas have indices. */
-	schema_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
-	for(unsigned short i = 0; i < schema_count; i++) {
-		Schema *s = GraphContext_GetSchemaByID(gc, i, SCHEMA_NODE);
-		assert(s);
-		Index *idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
-		if(idx) Index_Construct(idx);
-	}
+	// Indices are constructed once the graph is loaded, see GraphContext_Warmup.
 
 	return gc;
 }
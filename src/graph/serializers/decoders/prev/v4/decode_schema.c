@@ -9,7 +9,7 @@
 #include "../../../../../util/arr.h"
 #include "../../../../../util/rmalloc.h"
 
-Schema *RdbLoadSchema_v4(RedisModuleIO *rdb) {
+Schema *RdbLoadSchema_v4(RedisModuleIO *rdb, SchemaType type) {
 	/* Format:
 	 * id
 	 * name
@@ -19,7 +19,7 @@ Schema *RdbLoadSchema_v4(RedisModuleIO *rdb) {
 
 	int id = RedisModule_LoadUnsigned(rdb);
 	char *name = RedisModule_LoadStringBuffer(rdb, NULL);
-	Schema *s = Schema_New(name, id);
+	Schema *s = Schema_New(name, id, type);
 
 	uint64_t attrCount = RedisModule_LoadUnsigned(rdb);
 
@@ -14,4 +14,4 @@
 GraphContext *RdbLoadGraphContext_v4(RedisModuleIO *rdb);
 void RdbLoadGraph_v4(RedisModuleIO *rdb, GraphContext *gc);
 Index *RdbLoadIndex_v4(RedisModuleIO *rdb, GraphContext *gc);
-Schema *RdbLoadSchema_v4(RedisModuleIO *rdb);
+Schema *RdbLoadSchema_v4(RedisModuleIO *rdb, SchemaType type);
@@ -74,7 +74,7 @@ static void _RdbLoadEntity(RedisModuleIO *rdb, GraphContext *gc, GraphEntity *e)
 		SIValue attr_value = _RdbLoadSIValue(rdb);
 		Attribute_ID attr_id = GraphContext_GetAttributeID(gc, attr_name);
 		assert(attr_id != ATTRIBUTE_NOTFOUND);
-		GraphEntity_AddProperty(e, attr_id, attr_value);
+		GraphEntity_AddProperty(e, attr_id, GraphContext_InternValue(gc, attr_id, attr_value));
 		RedisModule_Free(attr_name);
 	}
 }
@@ -8,6 +8,7 @@
 #include "../../../../../query_ctx.h"
 #include "../../../../../util/arr.h"
 #include "../../../../../util/rmalloc.h"
+#include "../../../../../execution_plan/plan_cache.h"
 
 /* Thread local storage graph context key. */
 extern pthread_key_t _tlsGCKey;
@@ -42,7 +43,24 @@ GraphContext *RdbLoadGraphContext_v5(RedisModuleIO *rdb) {
 	gc->index_count = 0;
 	gc->attributes = raxNew();
 	gc->string_mapping = array_new(char *, 64);
+	gc->interned_attributes = array_new(bool, 64);
+	gc->string_pool = StringPool_New();
 	gc->g = Graph_New(GRAPH_DEFAULT_NODE_CAP, GRAPH_DEFAULT_EDGE_CAP);
+	gc->cache = PlanCache_New();
+	gc->sync_scheduled = false;
+	gc->index_updates_scheduled = false;
+	gc->expiry_scheduled = false;
+	gc->memory_usage = 0;
+	gc->prepared_statements = PreparedStatements_New();
+	gc->views = MaterializedViews_New();
+	gc->projections = Projections_New();
+	gc->pins = PlanPins_New();
+	gc->cursors = Cursors_New();
+	gc->query_stats = QueryStats_New();
+	gc->access_stats = AccessStats_New();
+	gc->changes = ChangeFeed_New();
+	gc->results = ResultCache_New();
+	gc->commit_group = CommitGroup_New();
 
 	// Set the thread-local GraphContext, as it will be accessed if we're decoding indexes.
 	QueryCtx_SetGraphCtx(gc);
@@ -79,7 +97,6 @@ GraphContext *RdbLoadGraphContext_v5(RedisModuleIO *rdb) {
 	uint node_schemas_count = array_len(gc->node_schemas);
 	for(uint i = 0; i < node_schemas_count; i++) {
 		Schema *s = gc->node_schemas[i];
-		if(s->index) Index_Construct(s->index);
 		if(s->fulltextIdx) Index_Construct(s->fulltextIdx);
 	}
 
@@ -0,0 +1,107 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "decode_v6.h"
+#include "../../../../../util/arr.h"
+#include "../../../../../query_ctx.h"
+#include "../../../../../util/rmalloc.h"
+#include "../../../../../slow_log/slow_log.h"
+#include "../../../../../execution_plan/plan_cache.h"
+
+static void _RdbLoadAttributeKeys(RedisModuleIO *rdb, GraphContext *gc) {
+	/* Format:
+	 * #attribute keys
+	 * attribute keys
+	 */
+
+	uint count = RedisModule_LoadUnsigned(rdb);
+	for(uint i = 0; i < count; i ++) {
+		char *attr = RedisModule_LoadStringBuffer(rdb, NULL);
+		GraphContext_FindOrAddAttribute(gc, attr);
+		RedisModule_Free(attr);
+	}
+}
+
+GraphContext *RdbLoadGraphContext_v6(RedisModuleIO *rdb) {
+	/* Format:
+	 * graph name
+	 * attribute keys (unified schema)
+	 * #node schemas
+	 * node schema X #node schemas
+	 * #relation schemas
+	 * unified relation schema
+	 * relation schema X #relation schemas
+	 * graph object
+	*/
+
+	GraphContext *gc = rm_calloc(1, sizeof(GraphContext));
+	// Graph context defaults
+	gc->index_count = 0;
+	gc->attributes = raxNew();
+	gc->string_mapping = array_new(char *, 64);
+	gc->interned_attributes = array_new(bool, 64);
+	gc->string_pool = StringPool_New();
+	gc->g = Graph_New(GRAPH_DEFAULT_NODE_CAP, GRAPH_DEFAULT_EDGE_CAP);
+	gc->slowlog = SlowLog_New();
+	gc->cache = PlanCache_New();
+	gc->sync_scheduled = false;
+	gc->index_updates_scheduled = false;
+	gc->expiry_scheduled = false;
+	gc->memory_usage = 0;
+	gc->prepared_statements = PreparedStatements_New();
+	gc->views = MaterializedViews_New();
+	gc->projections = Projections_New();
+	gc->pins = PlanPins_New();
+	gc->cursors = Cursors_New();
+	gc->query_stats = QueryStats_New();
+	gc->access_stats = AccessStats_New();
+	gc->changes = ChangeFeed_New();
+	gc->results = ResultCache_New();
+	gc->commit_group = CommitGroup_New();
+
+	// Set the thread-local GraphContext, as it will be accessed if we're decoding indexes.
+	QueryCtx_SetGraphCtx(gc);
+
+	// Graph name
+	gc->graph_name = RedisModule_LoadStringBuffer(rdb, NULL);
+
+	// Attributes, Load the full attribute mapping.
+	_RdbLoadAttributeKeys(rdb, gc);
+
+	// #Node schemas
+	uint schema_count = RedisModule_LoadUnsigned(rdb);
+
+	// Load each node schema
+	gc->node_schemas = array_new(Schema *, schema_count);
+	for(uint i = 0; i < schema_count; i ++) {
+		gc->node_schemas = array_append(gc->node_schemas, RdbLoadSchema_v6(rdb, SCHEMA_NODE));
+		Graph_AddLabel(gc->g);
+	}
+
+	// #Edge schemas
+	schema_count = RedisModule_LoadUnsigned(rdb);
+
+	// Load each edge schema
+	gc->relation_schemas = array_new(Schema *, schema_count);
+	for(uint i = 0; i < schema_count; i ++) {
+		gc->relation_schemas = array_append(gc->relation_schemas, RdbLoadSchema_v6(rdb, SCHEMA_EDGE));
+		Graph_AddRelationType(gc->g);
+	}
+
+	// Graph object.
+	RdbLoadGraph_v6(rdb, gc);
+
+	uint node_schemas_count = array_len(gc->node_schemas);
+	for(uint i = 0; i < node_schemas_count; i++) {
+		Schema *s = gc->node_schemas[i];
+		if(s->fulltextIdx) Index_Construct(s->fulltextIdx);
+	}
+
+	QueryCtx_Free(); // Release thread-local varaibles.
+
+	return gc;
+}
+
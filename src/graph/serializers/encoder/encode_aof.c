@@ -0,0 +1,488 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "encode_aof.h"
+#include "encode_graph.h"
+#include "../../graph.h"
+#include "../../entities/multi_edge.h"
+#include "../../../util/arr.h"
+#include "../../../util/qsort.h"
+#include "../../../util/rmalloc.h"
+#include "../../../bulk_insert/bulk_insert.h"
+#include "../../../datatypes/array.h"
+
+#define AOF_BATCH_CAP (8 * 1024 * 1024) // Batch size in bytes after which it is emitted.
+
+/* Accumulates entities sharing labels or relationship type and attributes
+ * into a GRAPH.BULK binary token, see bulk_insert.c for the binary format. */
+typedef struct {
+	GraphContext *gc;           // Graph being encoded.
+	BulkTokenFunc emit;         // Invoked per token.
+	void *privdata;             // Passed to emit.
+	size_t token_cap;           // Token size in bytes after which it is emitted.
+	uint64_t *deleted;          // Sorted deleted node IDs.
+	const GraphPartition *partition; // Partition encoded, NULL if the entire graph is encoded.
+	NodeID *nodes;              // Sorted IDs of the partition's nodes, their encoded IDs are their positions.
+	bool *labels_encoded;       // Per label, set once a node of the label is encoded.
+	bool *relations_encoded;    // Per relationship type, set once an edge of the type is encoded.
+	bool open;                  // Batch holds a header.
+	bool is_node;               // Batch holds nodes.
+	int *labels;                // Labels or relationship type of batched entities.
+	Attribute_ID *attrs;        // Attributes of batched entities.
+	char *buf;                  // Batch binary token.
+	size_t len;                 // Batch length.
+	size_t cap;                 // Batch capacity.
+} AofBatch;
+
+static void _AofBatch_Write(AofBatch *b, const void *data, size_t len) {
+	if(b->len + len > b->cap) {
+		b->cap = MAX(b->cap * 2, b->len + len);
+		b->buf = rm_realloc(b->buf, b->cap);
+	}
+	memcpy(b->buf + b->len, data, len);
+	b->len += len;
+}
+
+static inline void _AofBatch_WriteString(AofBatch *b, const char *s) {
+	_AofBatch_Write(b, s, strlen(s) + 1);
+}
+
+static inline void _AofBatch_WriteUint32(AofBatch *b, unsigned int v) {
+	_AofBatch_Write(b, &v, sizeof(unsigned int));
+}
+
+static void _AofBatch_WriteValue(AofBatch *b, SIValue v) {
+	char t;
+	switch(SI_TYPE(v)) {
+	case T_BOOL: {
+		t = BI_BOOL;
+		char val = v.longval;
+		_AofBatch_Write(b, &t, 1);
+		_AofBatch_Write(b, &val, 1);
+		return;
+	}
+	case T_INT64:
+		t = BI_LONG;
+		_AofBatch_Write(b, &t, 1);
+		_AofBatch_Write(b, &v.longval, sizeof(int64_t));
+		return;
+	case T_DOUBLE:
+		t = BI_DOUBLE;
+		_AofBatch_Write(b, &t, 1);
+		_AofBatch_Write(b, &v.doubleval, sizeof(double));
+		return;
+	case T_STRING:
+		t = BI_STRING;
+		_AofBatch_Write(b, &t, 1);
+		_AofBatch_WriteString(b, v.stringval);
+		return;
+	case T_ARRAY: {
+		t = BI_ARRAY;
+		uint64_t len = SIArray_Length(v);
+		_AofBatch_Write(b, &t, 1);
+		_AofBatch_Write(b, &len, sizeof(uint64_t));
+		for(uint64_t i = 0; i < len; i++) _AofBatch_WriteValue(b, SIArray_Get(v, i));
+		return;
+	}
+	case T_POINT: {
+		t = BI_POINT;
+		double coords[2] = {v.point.latitude, v.point.longitude};
+		_AofBatch_Write(b, &t, 1);
+		_AofBatch_Write(b, coords, sizeof(coords));
+		return;
+	}
+	default:
+		t = BI_NULL;
+		_AofBatch_Write(b, &t, 1);
+		return;
+	}
+}
+
+// Emit batch as a token.
+static void _AofBatch_Flush(AofBatch *b) {
+	if(!b->open) return;
+	b->emit(b->buf, b->len, b->is_node, b->privdata);
+	b->open = false;
+	b->len = 0;
+}
+
+// Returns true if entity can be appended to the current batch.
+static bool _AofBatch_Matches(const AofBatch *b, bool is_node, const int *labels,
+							  uint label_count, const EntityProperty *props, uint prop_count) {
+	if(!b->open || b->is_node != is_node || b->len >= b->token_cap) return false;
+	if(array_len(b->labels) != label_count || array_len(b->attrs) != prop_count) return false;
+	for(uint i = 0; i < label_count; i++) if(b->labels[i] != labels[i]) return false;
+	for(uint i = 0; i < prop_count; i++) if(b->attrs[i] != props[i].id) return false;
+	return true;
+}
+
+// Start a new batch, writing its header.
+static void _AofBatch_Begin(AofBatch *b, bool is_node, const int *labels, uint label_count,
+							const EntityProperty *props, uint prop_count) {
+	_AofBatch_Flush(b);
+	GraphContext *gc = b->gc;
+	SchemaType t = is_node ? SCHEMA_NODE : SCHEMA_EDGE;
+
+	array_clear(b->labels);
+	array_clear(b->attrs);
+	for(uint i = 0; i < label_count; i++) b->labels = array_append(b->labels, labels[i]);
+	for(uint i = 0; i < prop_count; i++) b->attrs = array_append(b->attrs, props[i].id);
+
+	// Nodes with no label or multiple labels are headed by an empty name and a list of labels.
+	if(!is_node || label_count == 1) {
+		_AofBatch_WriteString(b, Schema_GetName(GraphContext_GetSchemaByID(gc, labels[0], t)));
+	} else {
+		_AofBatch_WriteString(b, "");
+		_AofBatch_WriteUint32(b, label_count);
+		for(uint i = 0; i < label_count; i++) {
+			_AofBatch_WriteString(b, Schema_GetName(GraphContext_GetSchemaByID(gc, labels[i], t)));
+		}
+	}
+
+	// Partitioned nodes are followed by their ID in the partitioned graph.
+	bool gid = (b->partition && is_node);
+	_AofBatch_WriteUint32(b, prop_count + gid);
+	for(uint i = 0; i < prop_count; i++) {
+		_AofBatch_WriteString(b, GraphContext_GetAttributeString(gc, props[i].id));
+	}
+	if(gid) _AofBatch_WriteString(b, PARTITION_GID_ATTRIBUTE);
+
+	b->is_node = is_node;
+	b->open = true;
+}
+
+// Ensure the current batch can hold entity, starting a new batch if it can't.
+static void _AofBatch_Prepare(AofBatch *b, bool is_node, const int *labels, uint label_count,
+							  Entity *e) {
+	EntityProperty *props = Entity_Properties(e);
+	if(!_AofBatch_Matches(b, is_node, labels, label_count, props, e->prop_count)) {
+		_AofBatch_Begin(b, is_node, labels, label_count, props, e->prop_count);
+	}
+}
+
+static void _AofBatch_WriteProperties(AofBatch *b, Entity *e) {
+	EntityProperty *props = Entity_Properties(e);
+	for(uint i = 0; i < e->prop_count; i++) _AofBatch_WriteValue(b, props[i].value);
+}
+
+static void _AofRewriteNodes(AofBatch *b) {
+	Graph *g = b->gc->g;
+	Entity *e;
+	uint max_labels = Graph_LabelTypeCount(g);
+	int labels[max_labels + 1];
+	uint next = 0;  // Position of the next partition node.
+	DataBlockIterator *iter = Graph_ScanNodes(g);
+	// Nodes are recreated in ID order, deleted IDs are compacted.
+	while((e = (Entity *)DataBlockIterator_Next(iter))) {
+		if(b->partition) {
+			// Skip nodes outside of the partition.
+			if(next == array_len(b->nodes)) break;
+			if(b->nodes[next] != e->id) continue;
+			next++;
+		}
+
+		uint label_count = Graph_GetNodeLabels(g, e->id, labels, max_labels);
+		_AofBatch_Prepare(b, true, labels, label_count, e);
+		_AofBatch_WriteProperties(b, e);
+		if(b->partition) {
+			_AofBatch_WriteValue(b, SI_LongVal(e->id));
+			for(uint i = 0; i < label_count; i++) b->labels_encoded[labels[i]] = true;
+		}
+	}
+	DataBlockIterator_Free(iter);
+}
+
+// Returns the position of node id within the partition's sorted nodes.
+static NodeID _AofBatch_PartitionID(const AofBatch *b, NodeID id) {
+	uint lo = 0;
+	uint hi = array_len(b->nodes);
+	while(lo < hi) {
+		uint mid = lo + (hi - lo) / 2;
+		if(b->nodes[mid] < id) lo = mid + 1;
+		else hi = mid;
+	}
+	assert(lo < array_len(b->nodes) && b->nodes[lo] == id);
+	return lo;
+}
+
+static void _AofRewriteEdge(AofBatch *b, const Graph *g, int r, NodeID src, NodeID dest,
+							EdgeID id) {
+	Edge e;
+	Graph_GetEdge(g, id, &e);
+	_AofBatch_Prepare(b, false, &r, 1, e.entity);
+
+	// Endpoints refer to the compacted IDs nodes are recreated with.
+	if(b->partition) {
+		src = _AofBatch_PartitionID(b, src);
+		dest = _AofBatch_PartitionID(b, dest);
+		b->relations_encoded[r] = true;
+	} else {
+		src = _updatedID(b->deleted, src);
+		dest = _updatedID(b->deleted, dest);
+	}
+	_AofBatch_Write(b, &src, sizeof(NodeID));
+	_AofBatch_Write(b, &dest, sizeof(NodeID));
+	_AofBatch_WriteProperties(b, e.entity);
+}
+
+static void _AofRewriteEdges(AofBatch *b) {
+	Graph *g = b->gc->g;
+	uint relationship_count = Graph_RelationTypeCount(g);
+	for(uint r = 0; r < relationship_count; r++) {
+		NodeID src;
+		NodeID dest;
+		EdgeID edgeID;
+		GrB_Matrix M = Graph_GetRelationMatrix(g, r);
+		GxB_MatrixTupleIter *it;
+		GxB_MatrixTupleIter_new(&it, M);
+		bool depleted = false;
+
+		while(true) {
+			GxB_MatrixTupleIter_next(it, &src, &dest, &depleted);
+			if(depleted) break;
+			// A partition holds the edges connecting the nodes it owns.
+			if(b->partition && !GraphPartition_Owns(b->partition, src) &&
+			   !GraphPartition_Owns(b->partition, dest)) continue;
+
+			GrB_Matrix_extractElement_UINT64(&edgeID, M, src, dest);
+			if(SINGLE_EDGE(edgeID)) {
+				_AofRewriteEdge(b, g, r, src, dest, SINGLE_EDGE_ID(edgeID));
+			} else {
+				const MultiEdge *me = (const MultiEdge *)edgeID;
+				for(uint32_t i = 0; i < me->count; i++) {
+					_AofRewriteEdge(b, g, r, src, dest, me->ids[i]);
+				}
+			}
+		}
+
+		GxB_MatrixTupleIter_free(it);
+	}
+}
+
+// Labels without nodes are recreated by header only tokens.
+static void _AofRewriteEmptyLabels(AofBatch *b) {
+	GraphContext *gc = b->gc;
+	uint label_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
+	for(int l = 0; l < label_count; l++) {
+		if(b->partition && b->labels_encoded[l]) continue;
+		if(!b->partition && Graph_LabeledNodeCount(gc->g, l) > 0) continue;
+		_AofBatch_Begin(b, true, &l, 1, NULL, 0);
+	}
+	_AofBatch_Flush(b);
+}
+
+// Relationship types without edges are recreated by header only tokens.
+static void _AofRewriteEmptyRelations(AofBatch *b) {
+	GraphContext *gc = b->gc;
+	uint relation_count = GraphContext_SchemaCount(gc, SCHEMA_EDGE);
+	for(int r = 0; r < relation_count; r++) {
+		if(b->partition) {
+			if(b->relations_encoded[r]) continue;
+		} else {
+			GrB_Index nvals;
+			GrB_Matrix_nvals(&nvals, Graph_GetRelationMatrix(gc->g, r));
+			if(nvals > 0) continue;
+		}
+		_AofBatch_Begin(b, false, &r, 1, NULL, 0);
+	}
+	_AofBatch_Flush(b);
+}
+
+static void _BulkEncode(AofBatch *b) {
+	b->labels = array_new(int, 1);
+	b->attrs = array_new(Attribute_ID, 8);
+
+	// Node tokens precede relation tokens.
+	_AofRewriteNodes(b);
+	_AofRewriteEmptyLabels(b);
+	_AofRewriteEdges(b);
+	_AofRewriteEmptyRelations(b);
+
+	array_free(b->labels);
+	array_free(b->attrs);
+	rm_free(b->buf);
+}
+
+void BulkEncodeGraph(GraphContext *gc, size_t token_cap, BulkTokenFunc emit, void *privdata) {
+	AofBatch b = {0};
+	b.gc = gc;
+	b.emit = emit;
+	b.privdata = privdata;
+	b.token_cap = token_cap;
+	// Deleted IDs are sorted on a copy, the graph might be read concurrently.
+	array_clone(b.deleted, gc->g->nodes->deletedIdx);
+	QSORT(NodeID, b.deleted, array_len(b.deleted), ENTITY_ID_ISLT);
+
+	_BulkEncode(&b);
+	array_free(b.deleted);
+}
+
+void BulkEncodePartition(GraphContext *gc, const GraphPartition *partition, const NodeID *nodes,
+						 size_t token_cap, BulkTokenFunc emit, void *privdata) {
+	AofBatch b = {0};
+	b.gc = gc;
+	b.emit = emit;
+	b.privdata = privdata;
+	b.token_cap = token_cap;
+	b.partition = partition;
+	b.nodes = (NodeID *)nodes;
+	b.labels_encoded = rm_calloc(GraphContext_SchemaCount(gc, SCHEMA_NODE) + 1, sizeof(bool));
+	b.relations_encoded = rm_calloc(GraphContext_SchemaCount(gc, SCHEMA_EDGE) + 1, sizeof(bool));
+
+	_BulkEncode(&b);
+	rm_free(b.labels_encoded);
+	rm_free(b.relations_encoded);
+}
+
+// Commands reconstructing a graph in a rewritten AOF.
+typedef struct {
+	RedisModuleIO *aof;         // AOF being rewritten.
+	RedisModuleString *key;     // Graph key.
+	GraphContext *gc;           // Graph being rewritten.
+	bool begun;                 // Graph creating command was emitted.
+} AofRewrite;
+
+// Emit token as a GRAPH.BULK command, the first command creates the graph.
+static void _AofRewriteToken(const char *token, size_t len, bool is_node, void *privdata) {
+	AofRewrite *w = privdata;
+	long long node_tokens = is_node ? 1 : 0;
+	long long relation_tokens = is_node ? 0 : 1;
+	if(!w->begun) {
+		Graph *g = w->gc->g;
+		RedisModule_EmitAOF(w->aof, "GRAPH.BULK", "scllllb", w->key, "BEGIN",
+							(long long)Graph_NodeCount(g), (long long)Graph_EdgeCount(g),
+							node_tokens, relation_tokens, token, len);
+		w->begun = true;
+	} else {
+		RedisModule_EmitAOF(w->aof, "GRAPH.BULK", "sllllb", w->key, 0LL, 0LL,
+							node_tokens, relation_tokens, token, len);
+	}
+}
+
+// Appends s to buf as a single quoted Cypher string literal.
+static void _AofQuote(char **buf, const char *s) {
+	size_t len = strlen(*buf);
+	*buf = rm_realloc(*buf, len + strlen(s) * 2 + 3);
+	char *p = *buf + len;
+	*p++ = '\'';
+	for(; *s; s++) {
+		if(*s == '\'' || *s == '\\') *p++ = '\\';
+		*p++ = *s;
+	}
+	*p++ = '\'';
+	*p = '\0';
+}
+
+static void _AofAppend(char **buf, const char *s) {
+	size_t len = strlen(*buf);
+	*buf = rm_realloc(*buf, len + strlen(s) + 1);
+	memcpy(*buf + len, s, strlen(s) + 1);
+}
+
+static void _AofRewriteIndices(AofRewrite *b) {
+	GraphContext *gc = b->gc;
+	uint schema_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
+	for(uint i = 0; i < schema_count; i++) {
+		Schema *s = gc->node_schemas[i];
+		Index *idx = s->index;
+		for(uint j = 0; idx && j < idx->fields_count; j++) {
+			char *query;
+			asprintf(&query, "CREATE INDEX ON :`%s`(`%s`)", idx->label, idx->fields[j]);
+			RedisModule_EmitAOF(b->aof, "GRAPH.QUERY", "sc", b->key, query);
+			free(query);
+		}
+
+		// Constraints are introduced once their fields are indexed.
+		for(uint j = 0; idx && j < idx->fields_count; j++) {
+			if(!Index_IsUnique(idx, idx->fields_ids[j])) continue;
+			char *query;
+			asprintf(&query, "CREATE CONSTRAINT ON (n:`%s`) ASSERT n.`%s` IS UNIQUE", idx->label,
+					 idx->fields[j]);
+			RedisModule_EmitAOF(b->aof, "GRAPH.QUERY", "sc", b->key, query);
+			free(query);
+		}
+
+		uint composite_count = (idx) ? Index_CompositeCount(idx) : 0;
+		for(uint j = 0; j < composite_count; j++) {
+			IndexComposite *c = idx->composites + j;
+			char *query = rm_strdup("CREATE INDEX ON :`");
+			_AofAppend(&query, idx->label);
+			_AofAppend(&query, "`(");
+			for(uint k = 0; k < c->fields_count; k++) {
+				if(k > 0) _AofAppend(&query, ", ");
+				_AofAppend(&query, "`");
+				_AofAppend(&query, c->fields[k]);
+				_AofAppend(&query, "`");
+			}
+			_AofAppend(&query, ")");
+			RedisModule_EmitAOF(b->aof, "GRAPH.QUERY", "sc", b->key, query);
+			rm_free(query);
+		}
+
+		uint vector_count = array_len(s->vectorIndices);
+		for(uint j = 0; j < vector_count; j++) {
+			VectorIndex *vector_idx = s->vectorIndices[j];
+			char *query = rm_strdup("CALL db.idx.vector.createIndex(");
+			_AofQuote(&query, vector_idx->label);
+			_AofAppend(&query, ", ");
+			_AofQuote(&query, vector_idx->field);
+			char dim[32];
+			snprintf(dim, sizeof(dim), ", %u, ", vector_idx->dim);
+			_AofAppend(&query, dim);
+			_AofQuote(&query, VectorIndex_MetricName(vector_idx->metric));
+			_AofAppend(&query, ")");
+			RedisModule_EmitAOF(b->aof, "GRAPH.QUERY", "sc", b->key, query);
+			rm_free(query);
+		}
+
+		idx = s->fulltextIdx;
+		if(idx == NULL || idx->fields_count == 0) continue;
+		char *query = rm_strdup("CALL db.idx.fulltext.createNodeIndex(");
+		_AofQuote(&query, idx->label);
+		for(uint j = 0; j < idx->fields_count; j++) {
+			_AofAppend(&query, ", ");
+			_AofQuote(&query, idx->fields[j]);
+		}
+		_AofAppend(&query, ")");
+		RedisModule_EmitAOF(b->aof, "GRAPH.QUERY", "sc", b->key, query);
+		rm_free(query);
+	}
+
+	schema_count = GraphContext_SchemaCount(gc, SCHEMA_EDGE);
+	for(uint i = 0; i < schema_count; i++) {
+		Index *idx = gc->relation_schemas[i]->index;
+		if(idx == NULL || idx->fields_count == 0) continue;
+		char *query = rm_strdup("CALL db.idx.edge.createIndex(");
+		_AofQuote(&query, idx->label);
+		for(uint j = 0; j < idx->fields_count; j++) {
+			_AofAppend(&query, ", ");
+			_AofQuote(&query, idx->fields[j]);
+		}
+		_AofAppend(&query, ")");
+		RedisModule_EmitAOF(b->aof, "GRAPH.QUERY", "sc", b->key, query);
+		rm_free(query);
+	}
+}
+
+static void _AofRewritePlanPin(const char *query, size_t len, const PlanPin *pin, void *privdata) {
+	AofRewrite *b = privdata;
+	RedisModule_EmitAOF(b->aof, "GRAPH.PLAN", "scblc", b->key, "RESTORE", query, len,
+						(long long)pin->rules, pin->shape);
+}
+
+void AofRewriteGraphContext(RedisModuleIO *aof, RedisModuleString *key, GraphContext *gc) {
+	AofRewrite w = {.aof = aof, .key = key, .gc = gc, .begun = false};
+	BulkEncodeGraph(gc, AOF_BATCH_CAP, _AofRewriteToken, &w);
+
+	// Graph holds no schemas nor entities, create it empty.
+	if(!w.begun) RedisModule_EmitAOF(aof, "GRAPH.BULK", "scllll", key, "BEGIN", 0LL, 0LL, 0LL, 0LL);
+
+	_AofRewriteIndices(&w);
+	PlanPins_ForEach(GraphContext_GetPlanPins(gc), _AofRewritePlanPin, &w, false);
+}
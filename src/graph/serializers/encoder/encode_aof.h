@@ -0,0 +1,31 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../graphcontext.h"
+#include "../../graph_partition.h"
+#include "../../../redismodule.h"
+
+// Invoked per GRAPH.BULK binary token, is_node is set for node tokens.
+typedef void (*BulkTokenFunc)(const char *token, size_t len, bool is_node, void *privdata);
+
+/* Encodes the graph's entities into GRAPH.BULK binary tokens, see bulk_insert.c,
+ * each closed once it exceeds token_cap bytes. Node tokens are emitted first.
+ * Node IDs are compacted, as GRAPH.BULK assigns IDs consecutively.
+ * Expects the graph not to be modified while encoding. */
+void BulkEncodeGraph(GraphContext *gc, size_t token_cap, BulkTokenFunc emit, void *privdata);
+
+/* Encodes the nodes and edges held by partition, as BulkEncodeGraph does, nodes is the
+ * partition's sorted node IDs as collected by GraphPartition_Nodes.
+ * Node IDs are compacted to positions within nodes, each node is encoded along with
+ * its ID in the partitioned graph as its PARTITION_GID_ATTRIBUTE attribute. */
+void BulkEncodePartition(GraphContext *gc, const GraphPartition *partition, const NodeID *nodes,
+						 size_t token_cap, BulkTokenFunc emit, void *privdata);
+
+/* Emits the commands reconstructing the graph into the rewritten AOF,
+ * entities are emitted as GRAPH.BULK batches, indices as GRAPH.QUERY commands. */
+void AofRewriteGraphContext(RedisModuleIO *aof, RedisModuleString *key, GraphContext *gc);
@@ -8,6 +8,7 @@
 #include "encode_graph.h"
 
 #include "../../graph.h"
+#include "../../entities/multi_edge.h"
 #include "../../../util/arr.h"
 #include "../../../util/qsort.h"
 #include "../../../../deps/GraphBLAS/Include/GraphBLAS.h"
@@ -35,7 +36,7 @@ static uint64_t shiftCount(uint64_t *array, NodeID id) {
 	return left;
 }
 
-static NodeID _updatedID(uint64_t *array, NodeID id) {
+NodeID _updatedID(uint64_t *array, NodeID id) {
 	uint32_t itemCount = array_len(array);
 	if(itemCount == 0) {
 		// No deleted elements; don't modify ID
@@ -71,6 +72,10 @@ void _RdbSaveSIValue(RedisModuleIO *rdb, const SIValue *v) {
 	case T_ARRAY:
 		_RdbSaveSIArray(rdb, *v);
 		return;
+	case T_POINT:
+		RedisModule_SaveDouble(rdb, v->point.latitude);
+		RedisModule_SaveDouble(rdb, v->point.longitude);
+		return;
 	case T_NULL:
 		return; // No data beyond the type needs to be encoded for a NULL value.
 	default:
@@ -96,54 +101,54 @@ void _RdbSaveSIArray(RedisModuleIO *rdb, const SIValue list) {
 
 }
 
-void _RdbSaveEntity(RedisModuleIO *rdb, const Entity *e,  char **attr_map) {
+void _RdbSaveEntity(RedisModuleIO *rdb, const Entity *e) {
 	/* Format:
 	 * #attributes N
-	 * (name, value type, value) X N  */
+	 * (attribute ID, value type, value) X N
+	 * Attribute IDs index the attribute keys saved with the graph context. */
 
 	RedisModule_SaveUnsigned(rdb, e->prop_count);
 
+	EntityProperty *properties = Entity_Properties((Entity *)e);
 	for(int i = 0; i < e->prop_count; i++) {
-		EntityProperty attr = e->properties[i];
-		const char *attr_name = attr_map[attr.id];
-		RedisModule_SaveStringBuffer(rdb, attr_name, strlen(attr_name) + 1);
+		EntityProperty attr = properties[i];
+		RedisModule_SaveUnsigned(rdb, attr.id);
 		_RdbSaveSIValue(rdb, &attr.value);
 	}
 }
 
-void _RdbSaveNodes(RedisModuleIO *rdb, const Graph *g,  char **string_mapping) {
+void _RdbSaveNodes(RedisModuleIO *rdb, const Graph *g) {
 	/* Format:
 	 * #nodes
 	 *      #labels M
 	 *      (labels) X M
 	 *      #properties N
-	 *      (name, value type, value) X N */
+	 *      (attribute ID, value type, value) X N */
 
 	// #Nodes
 	RedisModule_SaveUnsigned(rdb, Graph_NodeCount(g));
 
 	Entity *e;
+	uint max_labels = Graph_LabelTypeCount(g);
+	int labels[max_labels + 1];
 	DataBlockIterator *iter = Graph_ScanNodes(g);
 	while((e = (Entity *)DataBlockIterator_Next(iter))) {
-		int l = Graph_GetNodeLabel(g, e->id);
-
-		// #labels, currently only one label per node.
-		int label_count = (l == GRAPH_NO_LABEL) ? 0 : 1;
+		// #labels M
+		uint label_count = Graph_GetNodeLabels(g, e->id, labels, max_labels);
 		RedisModule_SaveUnsigned(rdb, label_count);
 
-		// (label)
-		if(label_count) RedisModule_SaveUnsigned(rdb, l);
+		// (labels) X M
+		for(uint i = 0; i < label_count; i++) RedisModule_SaveUnsigned(rdb, labels[i]);
 
 		// properties N
-		// (name, value type, value) X N
-		_RdbSaveEntity(rdb, e, string_mapping);
+		// (attribute ID, value type, value) X N
+		_RdbSaveEntity(rdb, e);
 	}
 
 	DataBlockIterator_Free(iter);
 }
 
-void _RdbSaveEdge(RedisModuleIO *rdb, const Graph *g, const Edge *e,
-				  int r, char **string_mapping) {
+void _RdbSaveEdge(RedisModuleIO *rdb, const Graph *g, const Edge *e, int r) {
 
 	/* Format:
 	* edge
@@ -169,10 +174,10 @@ void _RdbSaveEdge(RedisModuleIO *rdb, const Graph *g, const Edge *e,
 	RedisModule_SaveUnsigned(rdb, r);
 
 	// Edge properties.
-	_RdbSaveEntity(rdb, e->entity, string_mapping);
+	_RdbSaveEntity(rdb, e->entity);
 }
 
-void _RdbSaveEdges(RedisModuleIO *rdb, const Graph *g, char **string_mapping) {
+void _RdbSaveEdges(RedisModuleIO *rdb, const Graph *g) {
 	/* Format:
 	 * #edges (N)
 	 * {
@@ -210,14 +215,12 @@ void _RdbSaveEdges(RedisModuleIO *rdb, const Graph *g, char **string_mapping) {
 			if(SINGLE_EDGE(edgeID)) {
 				edgeID = SINGLE_EDGE_ID(edgeID);
 				Graph_GetEdge(g, edgeID, &e);
-				_RdbSaveEdge(rdb, g, &e, r, string_mapping);
+				_RdbSaveEdge(rdb, g, &e, r);
 			} else {
-				EdgeID *edgeIDs = (EdgeID *)edgeID;
-				int edgeCount = array_len(edgeIDs);
-				for(int i = 0; i < edgeCount; i++) {
-					edgeID = edgeIDs[i];
-					Graph_GetEdge(g, edgeID, &e);
-					_RdbSaveEdge(rdb, g, &e, r, string_mapping);
+				const MultiEdge *me = (const MultiEdge *)edgeID;
+				for(uint32_t i = 0; i < me->count; i++) {
+					Graph_GetEdge(g, me->ids[i], &e);
+					_RdbSaveEdge(rdb, g, &e, r);
 				}
 			}
 		}
@@ -232,19 +235,19 @@ void RdbSaveGraph(RedisModuleIO *rdb, GraphContext *gc) {
 	 *      #labels M
 	 *      (labels) X M
 	 *      #properties N
-	 *      (name, value type, value) X N
+	 *      (attribute ID, value type, value) X N
 	 *
 	 * #edges
 	 *      relation type
 	 *      source node ID
 	 *      destination node ID
 	 *      #properties N
-	 *      (name, value type, value) X N
+	 *      (attribute ID, value type, value) X N
 	 */
 
 	// Dump nodes.
-	_RdbSaveNodes(rdb, gc->g, gc->string_mapping);
+	_RdbSaveNodes(rdb, gc->g);
 
 	// Dump edges.
-	_RdbSaveEdges(rdb, gc->g, gc->string_mapping);
+	_RdbSaveEdges(rdb, gc->g);
 }
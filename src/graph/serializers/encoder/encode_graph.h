@@ -12,4 +12,8 @@
 
 void RdbSaveGraph(RedisModuleIO *rdb, GraphContext *gc);
 
+/* Maps a node ID to its serialized ID, serialized IDs are compacted
+ * by skipping the sorted deleted IDs array. */
+NodeID _updatedID(uint64_t *array, NodeID id);
+
 #endif
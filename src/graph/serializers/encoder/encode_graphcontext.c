@@ -30,6 +30,23 @@ static void _RdbSaveAttributeKeys(RedisModuleIO *rdb, GraphContext *gc) {
 	}
 }
 
+static void _RdbSavePlanPin(const char *query, size_t len, const PlanPin *pin, void *rdb) {
+	RedisModule_SaveStringBuffer(rdb, query, len);
+	RedisModule_SaveUnsigned(rdb, pin->rules);
+	RedisModule_SaveStringBuffer(rdb, pin->shape, strlen(pin->shape) + 1);
+}
+
+static void _RdbSavePlanPins(RedisModuleIO *rdb, GraphContext *gc) {
+	/* Format:
+	 * #pinned plans
+	 * (query, rules, shape) X #pinned plans
+	*/
+
+	PlanPins *pins = GraphContext_GetPlanPins(gc);
+	RedisModule_SaveUnsigned(rdb, PlanPins_Count(pins));
+	PlanPins_ForEach(pins, _RdbSavePlanPin, rdb, _shouldAcquireLocks());
+}
+
 void RdbSaveGraphContext(RedisModuleIO *rdb, void *value) {
 	/* Format:
 	 * graph name
@@ -40,6 +57,8 @@ void RdbSaveGraphContext(RedisModuleIO *rdb, void *value) {
 	 * unified relation schema
 	 * relation schema X #relation schemas
 	 * graph object
+	 * pinned plans
+	 * write version
 	*/
 
 	GraphContext *gc = value;
@@ -76,6 +95,12 @@ void RdbSaveGraphContext(RedisModuleIO *rdb, void *value) {
 	// Serialize graph object
 	RdbSaveGraph(rdb, gc);
 
+	// Serialize pinned plans
+	_RdbSavePlanPins(rdb, gc);
+
+	// Write version, such that replicas synchronized from the RDB resume counting from it.
+	RedisModule_SaveUnsigned(rdb, GraphContext_GetWriteVersion(gc));
+
 	// If a lock was acquired, release it.
 	if(_shouldAcquireLocks()) Graph_ReleaseLock(gc->g);
 }
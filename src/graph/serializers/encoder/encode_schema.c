@@ -17,6 +17,27 @@ static inline void _RdbSaveIndexData(RedisModuleIO *rdb, Index *idx) {
 		// Indexed property
 		RedisModule_SaveStringBuffer(rdb, idx->fields[i], strlen(idx->fields[i]) + 1);
 	}
+
+	uint composite_count = Index_CompositeCount(idx);
+	for(uint i = 0; i < composite_count; i++) {
+		IndexComposite *c = idx->composites + i;
+		// Composite tag
+		RedisModule_SaveUnsigned(rdb, IDX_COMPOSITE_TAG);
+		// Indexed properties
+		RedisModule_SaveUnsigned(rdb, c->fields_count);
+		for(uint j = 0; j < c->fields_count; j++) {
+			RedisModule_SaveStringBuffer(rdb, c->fields[j], strlen(c->fields[j]) + 1);
+		}
+	}
+
+	// Unique constraints follow the indexed fields they constrain.
+	for(uint i = 0; i < idx->fields_count; i++) {
+		if(!Index_IsUnique(idx, idx->fields_ids[i])) continue;
+		// Unique tag
+		RedisModule_SaveUnsigned(rdb, IDX_UNIQUE_TAG);
+		// Constrained property
+		RedisModule_SaveStringBuffer(rdb, idx->fields[i], strlen(idx->fields[i]) + 1);
+	}
 }
 
 void RdbSaveSchema(RedisModuleIO *rdb, Schema *s) {
@@ -24,7 +45,14 @@ void RdbSaveSchema(RedisModuleIO *rdb, Schema *s) {
 	 * id
 	 * name
 	 * #indices
-	 * (index type, indexed property) X M */
+	 * (index type, indexed property) X M
+	 * (composite tag, #properties, properties) X C
+	 * (unique tag, constrained property) X U
+	 * (async tag, label) X A
+	 * (vector tag, indexed property, dimension, metric) X V
+	 * (ttl tag, timestamp property, ttl) X T
+	 * (interval tag, from property, to property) X I
+	 * (weight tag, weight property) X W */
 
 	// Schema ID.
 	RedisModule_SaveUnsigned(rdb, s->id);
@@ -40,4 +68,48 @@ void RdbSaveSchema(RedisModuleIO *rdb, Schema *s) {
 
 	// Fulltext indices.
 	_RdbSaveIndexData(rdb, s->fulltextIdx);
+	if(s->fulltextIdx && Index_IsAsync(s->fulltextIdx)) {
+		// Async tag, follows the fulltext index fields.
+		RedisModule_SaveUnsigned(rdb, IDX_ASYNC_TAG);
+		RedisModule_SaveStringBuffer(rdb, s->fulltextIdx->label, strlen(s->fulltextIdx->label) + 1);
+	}
+
+	// Vector indices.
+	uint vector_count = array_len(s->vectorIndices);
+	for(uint i = 0; i < vector_count; i++) {
+		VectorIndex *idx = s->vectorIndices[i];
+		// Vector tag
+		RedisModule_SaveUnsigned(rdb, IDX_VECTOR_TAG);
+		// Indexed property
+		RedisModule_SaveStringBuffer(rdb, idx->field, strlen(idx->field) + 1);
+		RedisModule_SaveUnsigned(rdb, idx->dim);
+		RedisModule_SaveUnsigned(rdb, idx->metric);
+	}
+
+	// Expiry.
+	if(Schema_HasExpiry(s)) {
+		// TTL tag
+		RedisModule_SaveUnsigned(rdb, IDX_TTL_TAG);
+		// Timestamp property
+		RedisModule_SaveStringBuffer(rdb, s->ttl_attribute, strlen(s->ttl_attribute) + 1);
+		RedisModule_SaveUnsigned(rdb, s->ttl);
+	}
+
+	// Validity intervals.
+	if(s->intervals) {
+		IntervalIndex *idx = s->intervals;
+		// Interval tag
+		RedisModule_SaveUnsigned(rdb, IDX_INTERVAL_TAG);
+		// Interval bound properties
+		RedisModule_SaveStringBuffer(rdb, idx->from_attribute, strlen(idx->from_attribute) + 1);
+		RedisModule_SaveStringBuffer(rdb, idx->to_attribute, strlen(idx->to_attribute) + 1);
+	}
+	// Maintained weight matrices.
+	uint weight_count = array_len(s->weights);
+	for(uint i = 0; i < weight_count; i++) {
+		// Weight tag
+		RedisModule_SaveUnsigned(rdb, IDX_WEIGHT_TAG);
+		// Weight property
+		RedisModule_SaveStringBuffer(rdb, s->weights[i], strlen(s->weights[i]) + 1);
+	}
 }
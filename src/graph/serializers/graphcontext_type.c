@@ -5,19 +5,22 @@
 */
 
 #include "../../version.h"
+#include "../../defrag/defrag.h"
 #include "../graphcontext.h"
+#include "../graph_memory.h"
 #include "graphcontext_type.h"
 #include "encoder/encode_graphcontext.h"
+#include "encoder/encode_aof.h"
 #include "decoders/decode_graphcontext.h"
 #include "decoders/prev/decode_previous.h"
 
 /* Declaration of the type for redis registration. */
 RedisModuleType *GraphContextRedisModuleType;
 
-#define GRAPHCONTEXT_TYPE_ENCODING_VERSION 6 // Current RDB encoding version
+#define GRAPHCONTEXT_TYPE_ENCODING_VERSION 9 // Current RDB encoding version
 
-#define DECODER_SUPPORT_MAX_V 6      // Highest RDB version that can be decoded.
-#define DECODER_SUPPORT_MIN_V 6      // Lowest version that can be decoded using the latest routine.
+#define DECODER_SUPPORT_MAX_V 9      // Highest RDB version that can be decoded.
+#define DECODER_SUPPORT_MIN_V 7      // Lowest version that can be decoded using the latest routine.
 #define PREV_DECODER_SUPPORT_MIN_V 4 // Lowest version that has backwards-compatibility decoding routines.
 
 void *GraphContextType_RdbLoad(RedisModuleIO *rdb, int encver) {
@@ -29,7 +32,7 @@ void *GraphContextType_RdbLoad(RedisModuleIO *rdb, int encver) {
 			   REDISGRAPH_MODULE_VERSION);
 		return NULL;
 	} else if(encver >= DECODER_SUPPORT_MIN_V && encver <= DECODER_SUPPORT_MAX_V) {
-		gc = RdbLoadGraphContext(rdb);
+		gc = RdbLoadGraphContext(rdb, encver);
 	} else if(encver >= PREV_DECODER_SUPPORT_MIN_V) {
 		gc = Decode_Previous(rdb, encver);
 	} else {
@@ -40,6 +43,8 @@ void *GraphContextType_RdbLoad(RedisModuleIO *rdb, int encver) {
 
 	// Add GraphContext to global array of graphs.
 	GraphContext_RegisterWithModule(gc);
+	// Pending matrix changes are applied by the decoders, indices are constructed from here on.
+	GraphContext_Warmup(gc);
 
 	return gc;
 }
@@ -49,7 +54,7 @@ void GraphContextType_RdbSave(RedisModuleIO *rdb, void *value) {
 }
 
 void GraphContextType_AofRewrite(RedisModuleIO *aof, RedisModuleString *key, void *value) {
-	// TODO: implement.
+	AofRewriteGraphContext(aof, key, value);
 }
 
 void GraphContextType_Free(void *value) {
@@ -57,12 +62,42 @@ void GraphContextType_Free(void *value) {
 	GraphContext_Delete(gc);
 }
 
+/* Invoked by MEMORY USAGE on Redis main thread, which mustn't wait for a writer,
+ * a graph held by a writer reports its last measured usage.
+ * Properties are estimated from a sample of entities, see GRAPH.MEMORY for an exact breakdown. */
+size_t GraphContextType_MemUsage(const void *value) {
+	GraphContext *gc = (GraphContext *)value;
+	if(!Graph_TryAcquireReadLock(gc->g)) return __atomic_load_n(&gc->memory_usage, __ATOMIC_RELAXED);
+
+	GraphMemory mem;
+	GraphMemory_Measure(gc, GRAPH_MEMORY_DEFAULT_SAMPLES, &mem);
+	Graph_ReleaseLock(gc->g);
+	GraphMemory_Free(&mem);
+
+	__atomic_store_n(&gc->memory_usage, mem.total, __ATOMIC_RELAXED);
+	return mem.total;
+}
+
+/* Graphs whose effort exceeds the server's active-defrag-max-scan-fields
+ * are defragmented over several calls, in bounded time slices. */
+size_t GraphContextType_FreeEffort(RedisModuleString *key, const void *value) {
+	return Defrag_Effort(value);
+}
+
+int GraphContextType_Defrag(RedisModuleDefragCtx *ctx, RedisModuleString *key, void **value) {
+	// The GraphContext is referenced by queries and the module, only its contents move.
+	return Defrag_Graph(ctx, *value);
+}
+
 int GraphContextType_Register(RedisModuleCtx *ctx) {
 	RedisModuleTypeMethods tm = {.version = REDISMODULE_TYPE_METHOD_VERSION,
 								 .rdb_load = GraphContextType_RdbLoad,
 								 .rdb_save = GraphContextType_RdbSave,
 								 .aof_rewrite = GraphContextType_AofRewrite,
-								 .free = GraphContextType_Free
+								 .free = GraphContextType_Free,
+								 .mem_usage = GraphContextType_MemUsage,
+								 .free_effort = GraphContextType_FreeEffort,
+								 .defrag = GraphContextType_Defrag
 								};
 
 	GraphContextRedisModuleType = RedisModule_CreateDataType(ctx, "graphdata",
@@ -17,5 +17,8 @@ void *GraphContextType_RdbLoad(RedisModuleIO *rdb, int encver);
 void GraphContextType_RdbSave(RedisModuleIO *rdb, void *value);
 void GraphContextType_AofRewrite(RedisModuleIO *aof, RedisModuleString *key, void *value);
 void GraphContextType_Free(void *value);
+size_t GraphContextType_MemUsage(const void *value);
+size_t GraphContextType_FreeEffort(RedisModuleString *key, const void *value);
+int GraphContextType_Defrag(RedisModuleDefragCtx *ctx, RedisModuleString *key, void **value);
 
 #endif
@@ -0,0 +1,299 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "weight_matrices.h"
+#include "entities/multi_edge.h"
+#include "../util/arr.h"
+#include "../GraphBLASExt/GxB_Delete.h"
+#include "../util/rmalloc.h"
+#include <assert.h>
+
+static void _WeightMatrix_Free(WeightMatrix *m) {
+	if(m->W) GrB_free(&m->W);
+	if(m->touched) array_free(m->touched);
+	rm_free(m);
+}
+
+// Appends the weight of edge id to the matrix tuples, if the edge holds a numeric weight.
+static void _WeightMatrix_Collect(WeightMatrix *m, Graph *g, EdgeID id, GrB_Index src,
+								  GrB_Index dest, GrB_Index **I, GrB_Index **J, double **X) {
+	Edge e;
+	assert(Graph_GetEdge(g, id, &e));
+	SIValue *v = GraphEntity_GetProperty((GraphEntity *)&e, m->attr);
+	if(v == PROPERTY_NOTFOUND || !(SI_TYPE(*v) & SI_NUMERIC)) return;
+
+	double w = SI_GET_NUMERIC(*v);
+	if(w < 0) m->negative = true;
+	*I = array_append(*I, src);
+	*J = array_append(*J, dest);
+	*X = array_append(*X, w);
+}
+
+// Populates the weight matrix from the relation's edges.
+static void _WeightMatrix_Populate(WeightMatrix *m, Graph *g) {
+	m->negative = false;
+
+	GrB_Index n = Graph_RequiredMatrixDim(g);
+	GrB_Matrix R = Graph_GetRelationMatrix(g, m->relation);
+	GrB_Index nvals;
+	assert(GrB_Matrix_nvals(&nvals, R) == GrB_SUCCESS);
+	GrB_Index *rows = rm_malloc(sizeof(GrB_Index) * (nvals + 1));
+	GrB_Index *cols = rm_malloc(sizeof(GrB_Index) * (nvals + 1));
+	EdgeID *entries = rm_malloc(sizeof(EdgeID) * (nvals + 1));
+	assert(GrB_Matrix_extractTuples_UINT64(rows, cols, entries, &nvals, R) == GrB_SUCCESS);
+
+	// Collect the weight of every edge, parallel edges keep their smallest weight.
+	GrB_Index *I = array_new(GrB_Index, nvals);
+	GrB_Index *J = array_new(GrB_Index, nvals);
+	double *X = array_new(double, nvals);
+	for(GrB_Index k = 0; k < nvals; k++) {
+		EdgeID entry = entries[k];
+		if(SINGLE_EDGE(entry)) {
+			_WeightMatrix_Collect(m, g, SINGLE_EDGE_ID(entry), rows[k], cols[k], &I, &J, &X);
+		} else {
+			const MultiEdge *me = (const MultiEdge *)entry;
+			for(uint32_t i = 0; i < me->count; i++) {
+				_WeightMatrix_Collect(m, g, me->ids[i], rows[k], cols[k], &I, &J, &X);
+			}
+		}
+	}
+
+	assert(GrB_Matrix_new(&m->W, GrB_FP64, n, n) == GrB_SUCCESS);
+	assert(GrB_Matrix_build_FP64(m->W, I, J, X, array_len(X), GrB_MIN_FP64) == GrB_SUCCESS);
+
+	// Maintained matrices count their negative entries, as entries turn negative and back.
+	m->negatives = 0;
+	if(m->maintained && m->negative) {
+		GrB_Matrix N;
+		assert(GrB_Matrix_new(&N, GrB_FP64, n, n) == GrB_SUCCESS);
+		assert(GxB_Matrix_select(N, GrB_NULL, GrB_NULL, GxB_LT_ZERO, m->W, GrB_NULL,
+								 GrB_NULL) == GrB_SUCCESS);
+		assert(GrB_Matrix_nvals(&m->negatives, N) == GrB_SUCCESS);
+		GrB_free(&N);
+	}
+
+	rm_free(rows);
+	rm_free(cols);
+	rm_free(entries);
+	array_free(I);
+	array_free(J);
+	array_free(X);
+}
+
+static WeightMatrix *_WeightMatrix_New(int relation, Attribute_ID attr, uint64_t version,
+									   bool maintained) {
+	WeightMatrix *m = rm_malloc(sizeof(WeightMatrix));
+	m->relation = relation;
+	m->attr = attr;
+	m->version = version;
+	m->cached = true;
+	m->maintained = maintained;
+	m->negative = false;
+	m->negatives = 0;
+	m->touched = (maintained) ? array_new(GrB_Index, 0) : NULL;
+	m->W = NULL;
+	return m;
+}
+
+static WeightMatrix *_WeightMatrix_Build(Graph *g, int relation, Attribute_ID attr,
+										 uint64_t version) {
+	WeightMatrix *m = _WeightMatrix_New(relation, attr, version, false);
+	_WeightMatrix_Populate(m, g);
+	return m;
+}
+
+// Recomputes the entry of a pair written since the matrix was last synced.
+static void _WeightMatrix_SyncPair(WeightMatrix *m, Graph *g, GrB_Index src, GrB_Index dest,
+								   Edge **edges) {
+	double w;
+	if(GrB_Matrix_extractElement_FP64(&w, m->W, src, dest) == GrB_SUCCESS && w < 0) {
+		m->negatives--;
+	}
+
+	array_clear(*edges);
+	Graph_GetEdgesConnectingNodes(g, src, dest, m->relation, edges);
+	bool weighted = false;
+	uint edge_count = array_len(*edges);
+	for(uint i = 0; i < edge_count; i++) {
+		SIValue *v = GraphEntity_GetProperty((GraphEntity *)(*edges + i), m->attr);
+		if(v == PROPERTY_NOTFOUND || !(SI_TYPE(*v) & SI_NUMERIC)) continue;
+		double x = SI_GET_NUMERIC(*v);
+		if(!weighted || x < w) w = x;
+		weighted = true;
+	}
+
+	if(weighted) {
+		if(w < 0) m->negatives++;
+		GrB_Matrix_setElement_FP64(m->W, w, src, dest);
+	} else {
+		GxB_Matrix_Delete(m->W, src, dest);
+	}
+}
+
+/* Brings a maintained matrix up to date, building it if it was never retrieved
+ * or was invalidated, otherwise recomputing the entries of the written pairs. */
+static void _WeightMatrix_Sync(WeightMatrix *m, Graph *g) {
+	uint touched_count = array_len(m->touched);
+	array_clear(m->touched);
+	if(m->W == NULL) {
+		_WeightMatrix_Populate(m, g);
+		return;
+	}
+
+	// Nodes created since the last retrieval extend the matrix.
+	GrB_Index n = Graph_RequiredMatrixDim(g);
+	GrB_Index nrows;
+	GrB_Matrix_nrows(&nrows, m->W);
+	if(nrows != n) assert(GxB_Matrix_resize(m->W, n, n) == GrB_SUCCESS);
+	if(touched_count == 0) return;
+
+	Edge *edges = array_new(Edge, 1);
+	for(uint i = 0; i < touched_count; i += 2) {
+		_WeightMatrix_SyncPair(m, g, m->touched[i], m->touched[i + 1], &edges);
+	}
+	array_free(edges);
+	m->negative = (m->negatives > 0);
+
+	// Readers share the matrix, settle pending entries while it is exclusively held.
+	GrB_Index nvals;
+	GrB_Matrix_nvals(&nvals, m->W);
+}
+
+WeightMatrices *WeightMatrices_New(void) {
+	WeightMatrices *matrices = rm_malloc(sizeof(WeightMatrices));
+	matrices->matrices = array_new(WeightMatrix *, 0);
+	matrices->maintained = 0;
+	int res = pthread_mutex_init(&matrices->lock, NULL);
+	assert(res == 0);
+	return matrices;
+}
+
+const WeightMatrix *WeightMatrices_Get(Graph *g, int relation, Attribute_ID attr) {
+	assert(g && attr != ATTRIBUTE_NOTFOUND);
+	WeightMatrices *matrices = g->_weights;
+	WeightMatrix *m = NULL;
+
+	pthread_mutex_lock(&matrices->lock);
+
+	/* Drop matrices built at an earlier version, these are no longer referenced,
+	 * as readers only access matrices of the current version.
+	 * Maintained matrices are kept, and don't count towards the cap. */
+	uint count = array_len(matrices->matrices);
+	uint cached = 0;
+	for(uint i = 0; i < count;) {
+		WeightMatrix *wm = matrices->matrices[i];
+		if(wm->maintained || wm->version == g->version) {
+			if(wm->relation == relation && wm->attr == attr) m = wm;
+			if(!wm->maintained) cached++;
+			i++;
+			continue;
+		}
+		_WeightMatrix_Free(wm);
+		matrices->matrices[i] = matrices->matrices[--count];
+		array_pop(matrices->matrices);
+	}
+
+	if(m && m->maintained) _WeightMatrix_Sync(m, g);
+
+	if(m == NULL && cached < WEIGHT_MATRICES_CAP) {
+		m = _WeightMatrix_Build(g, relation, attr, g->version);
+		matrices->matrices = array_append(matrices->matrices, m);
+	}
+
+	pthread_mutex_unlock(&matrices->lock);
+
+	// At capacity, cached matrices may be in use, build a private matrix.
+	if(m == NULL) {
+		m = _WeightMatrix_Build(g, relation, attr, g->version);
+		m->cached = false;
+	}
+	return m;
+}
+
+// Returns the maintained matrix of relation by attr, NULL if it isn't maintained.
+static WeightMatrix *_WeightMatrices_GetMaintained(WeightMatrices *matrices, int relation,
+												   Attribute_ID attr, uint *idx) {
+	uint count = array_len(matrices->matrices);
+	for(uint i = 0; i < count; i++) {
+		WeightMatrix *wm = matrices->matrices[i];
+		if(wm->maintained && wm->relation == relation && wm->attr == attr) {
+			if(idx) *idx = i;
+			return wm;
+		}
+	}
+	return NULL;
+}
+
+void WeightMatrices_Maintain(Graph *g, int relation, Attribute_ID attr, bool maintain) {
+	assert(g && attr != ATTRIBUTE_NOTFOUND);
+	WeightMatrices *matrices = g->_weights;
+	pthread_mutex_lock(&matrices->lock);
+
+	uint idx;
+	WeightMatrix *m = _WeightMatrices_GetMaintained(matrices, relation, attr, &idx);
+	if(maintain && m == NULL) {
+		m = _WeightMatrix_New(relation, attr, g->version, true);
+		matrices->matrices = array_append(matrices->matrices, m);
+		matrices->maintained++;
+	} else if(!maintain && m != NULL) {
+		// Schema changes lock readers out, the matrix isn't referenced.
+		uint count = array_len(matrices->matrices);
+		matrices->matrices[idx] = matrices->matrices[count - 1];
+		array_pop(matrices->matrices);
+		matrices->maintained--;
+		_WeightMatrix_Free(m);
+	}
+
+	pthread_mutex_unlock(&matrices->lock);
+}
+
+void WeightMatrices_Touch(Graph *g, int relation, Attribute_ID attr, NodeID src, NodeID dest) {
+	WeightMatrices *matrices = g->_weights;
+	// Writers exclude readers, the number of maintained matrices is stable.
+	if(matrices->maintained == 0) return;
+
+	pthread_mutex_lock(&matrices->lock);
+	uint count = array_len(matrices->matrices);
+	for(uint i = 0; i < count; i++) {
+		WeightMatrix *wm = matrices->matrices[i];
+		// Matrices which weren't built yet are populated in full.
+		if(!wm->maintained || wm->W == NULL) continue;
+		if(relation != GRAPH_NO_RELATION && wm->relation != relation) continue;
+		if(attr != ATTRIBUTE_NOTFOUND && wm->attr != attr) continue;
+		wm->touched = array_append(wm->touched, src);
+		wm->touched = array_append(wm->touched, dest);
+	}
+	pthread_mutex_unlock(&matrices->lock);
+}
+
+void WeightMatrices_Invalidate(Graph *g, int relation) {
+	WeightMatrices *matrices = g->_weights;
+	if(matrices->maintained == 0) return;
+
+	pthread_mutex_lock(&matrices->lock);
+	uint count = array_len(matrices->matrices);
+	for(uint i = 0; i < count; i++) {
+		WeightMatrix *wm = matrices->matrices[i];
+		if(!wm->maintained || wm->relation != relation || wm->W == NULL) continue;
+		GrB_free(&wm->W);
+		wm->W = NULL;
+		array_clear(wm->touched);
+	}
+	pthread_mutex_unlock(&matrices->lock);
+}
+
+void WeightMatrix_Release(const WeightMatrix *m) {
+	if(!m->cached) _WeightMatrix_Free((WeightMatrix *)m);
+}
+
+void WeightMatrices_Free(WeightMatrices *matrices) {
+	if(matrices == NULL) return;
+	uint count = array_len(matrices->matrices);
+	for(uint i = 0; i < count; i++) _WeightMatrix_Free(matrices->matrices[i]);
+	array_free(matrices->matrices);
+	pthread_mutex_destroy(&matrices->lock);
+	rm_free(matrices);
+}
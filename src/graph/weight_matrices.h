@@ -0,0 +1,69 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "graph.h"
+#include "../value.h"
+
+// Maximum number of weight matrices a graph maintains.
+#define WEIGHT_MATRICES_CAP 8
+
+/* Weighted copy of a relation matrix, entry [src, dest] holds the smallest
+ * numeric value of attr amongst the edges of the relation connecting src to dest,
+ * edges lacking a numeric value are omitted.
+ * Matrices are built on demand and are valid for the graph version they were
+ * built at, any write invalidates them.
+ * Maintained matrices outlive writes instead, writers note the pairs whose edges
+ * they created, deleted or reweighted, and the next retrieval recomputes the
+ * entries of these pairs alone. */
+typedef struct {
+	int relation;       // Relation ID.
+	Attribute_ID attr;  // Attribute ID.
+	uint64_t version;   // Graph version matrix was built at.
+	bool cached;        // False if the matrix is owned by its requester.
+	bool maintained;    // True if the matrix is kept in sync with edge writes.
+	bool negative;      // True if a weight is negative.
+	uint64_t negatives; // Number of negative entries, tracked by maintained matrices.
+	GrB_Index *touched; // Pairs written since the last retrieval, source followed by destination.
+	GrB_Matrix W;       // FP64 weight matrix, NULL until a maintained matrix is first retrieved.
+} WeightMatrix;
+
+// Collection of weight matrices built for a graph.
+typedef struct WeightMatrices {
+	WeightMatrix **matrices;    // Built matrices.
+	uint maintained;            // Number of maintained matrices.
+	pthread_mutex_t lock;       // Guards matrices, concurrent readers may build matrices.
+} WeightMatrices;
+
+// Create an empty weight matrix collection.
+WeightMatrices *WeightMatrices_New(void);
+
+/* Retrieves the weight matrix of relation by attr, building it if required.
+ * Caller is expected to hold the graph's read lock while accessing the matrix,
+ * must not modify it and releases it via WeightMatrix_Release. */
+const WeightMatrix *WeightMatrices_Get(Graph *g, int relation, Attribute_ID attr);
+
+/* Keep the weight matrix of relation by attr in sync with edge writes,
+ * or stop maintaining it. The matrix is built by its first retrieval. */
+void WeightMatrices_Maintain(Graph *g, int relation, Attribute_ID attr, bool maintain);
+
+/* Note the edges of relation connecting src to dest were written, attr is the
+ * attribute written, ATTRIBUTE_NOTFOUND if edges were created or deleted.
+ * GRAPH_NO_RELATION notes the pair under every relation. Expects the write lock. */
+void WeightMatrices_Touch(Graph *g, int relation, Attribute_ID attr, NodeID src, NodeID dest);
+
+// Drop the maintained matrices of relation, to be rebuilt by their next retrieval.
+void WeightMatrices_Invalidate(Graph *g, int relation);
+
+// Release a retrieved matrix, frees it unless the collection holds it.
+void WeightMatrix_Release(const WeightMatrix *m);
+
+// Free weight matrix collection.
+void WeightMatrices_Free(WeightMatrices *matrices);
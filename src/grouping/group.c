@@ -9,43 +9,41 @@
 #include "../redismodule.h"
 #include "../util/arr.h"
 #include "../util/rmalloc.h"
+#include "../datatypes/path/sipath.h"
 #include "../execution_plan/ops/op.h"
 
-// Creates a new group
+// Initializes a group in place,
 // arguments specify group's key.
-Group *NewGroup(SIValue *keys, uint key_count, AR_ExpNode **funcs, uint func_count, Record r) {
-	Group *g = rm_malloc(sizeof(Group));
+void Group_Init(Group *g, SIValue *keys, uint key_count, AR_ExpNode **funcs, uint func_count, Record r) {
 	g->keys = keys;
 	g->aggregationFunctions = funcs;
 	g->key_count = key_count;
 	g->func_count = func_count;
 	g->r = (r) ? OpBase_CloneRecord(r) : NULL;
-	return g;
 }
 
-void Group_KeyStr(const Group *g, char **group_key) {
-	if(g->key_count == 0) {
-		*group_key = rm_strdup("SINGLE_GROUP");
-		return;
+static inline bool _key_values_match(SIValue a, SIValue b) {
+	// Paths aren't handled by SIValue_Compare.
+	if(SI_TYPE(a) == T_PATH || SI_TYPE(b) == T_PATH) {
+		return SI_TYPE(a) == SI_TYPE(b) && SIPath_Compare(a, b) == 0;
 	}
+	/* Values of different types are never equal, while nulls compare equal to one another,
+	 * within arrays as well, such that they form a single group. */
+	return SIValue_Compare(a, b, NULL) == 0;
+}
 
-	// Determine required size for group key string representation.
-	size_t group_len_key = SIValue_StringJoinLen(g->keys, g->key_count, ",");
-	*group_key = rm_malloc(sizeof(char) * group_len_key);
-	size_t bytesWritten = 0;
-	SIValue_StringJoin(g->keys, g->key_count, ",", group_key, &group_len_key, &bytesWritten);
+bool Group_KeysMatch(const Group *g, const SIValue *keys) {
+	for(uint i = 0; i < g->key_count; i++) {
+		if(!_key_values_match(g->keys[i], keys[i])) return false;
+	}
+	return true;
 }
 
-void FreeGroup(Group *g) {
+void Group_FreeEntries(Group *g) {
 	if(g == NULL) return;
 	if(g->r) Record_FreeEntries(g->r);  // Will be freed by Record owner.
-	if(g->keys) {
-		for(int i = 0; i < g->key_count; i ++) SIValue_Free(g->keys[i]);
-		rm_free(g->keys);
-	}
+	for(uint i = 0; i < g->key_count; i ++) SIValue_Free(g->keys[i]);
 
 	for(uint i = 0; i < g->func_count; i++) AR_EXP_Free(g->aggregationFunctions[i]);
 	rm_free(g->aggregationFunctions);
-	rm_free(g);
 }
-
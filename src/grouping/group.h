@@ -10,19 +10,20 @@
 #include "../arithmetic/arithmetic_expression.h"
 
 typedef struct {
-	SIValue *keys;                       /* SIValues that form the key associated with each group. */
+	SIValue *keys;                       /* SIValues that form the key associated with each group, owned by the group cache. */
 	AR_ExpNode **aggregationFunctions;   /* Nodes containing aggregate functions to be evaluated. */
 	uint key_count;                      /* Number of SIValues in the key. */
 	uint func_count;                     /* Number of aggregation function values. */
 	Record r;   /* Representative record for all aggregated records in group. */
 } Group;
 
-/* Creates a new group */
-Group *NewGroup(SIValue *keys, uint key_count, AR_ExpNode **funcs, uint func_count, Record r);
+/* Initializes a group in place, keys must hold key_count persisted values. */
+void Group_Init(Group *g, SIValue *keys, uint key_count, AR_ExpNode **funcs, uint func_count, Record r);
 
-/* Compute group key string representation, it is the callers
- * responsibility to free returned string. */
-void Group_KeyStr(const Group *g, char **group_key);
+/* Returns true if the group is associated with the given key values.
+ * Null key values match one another. */
+bool Group_KeysMatch(const Group *g, const SIValue *keys);
 
-void FreeGroup(Group *group);
+/* Frees the group's content, the group itself is owned by the group cache. */
+void Group_FreeEntries(Group *group);
 
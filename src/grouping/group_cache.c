@@ -5,51 +5,135 @@
 */
 
 #include "group_cache.h"
+#include "../util/arr.h"
 #include "../util/rmalloc.h"
+#include <assert.h>
 
-CacheGroup *CacheGroupNew() {
-	return raxNew();
+// Initial number of buckets. Should always be a power of 2.
+#define GROUP_CACHE_INITIAL_BUCKETS 16
+
+// Returns the group at position idx.
+static inline Group *_CacheGroup_GetItem(const CacheGroup *groups, uint64_t idx) {
+	Block *block = groups->blocks[idx / GROUP_BLOCK_CAP];
+	return (Group *)(block->data + (idx % GROUP_BLOCK_CAP) * groups->item_size);
+}
+
+// Locates the bucket of the group associated with keys,
+// or the empty bucket such a group would be placed in.
+static GroupBucket *_CacheGroup_Locate(const CacheGroup *groups, const SIValue *keys, uint64_t hash) {
+	uint64_t pos = hash & groups->bucket_mask;
+	while(true) {
+		GroupBucket *bucket = groups->buckets + pos;
+		if(bucket->group == 0) return bucket;
+		if(bucket->hash == hash &&
+		   Group_KeysMatch(_CacheGroup_GetItem(groups, bucket->group - 1), keys)) return bucket;
+		pos = (pos + 1) & groups->bucket_mask;
+	}
+}
+
+// Doubles the number of buckets, groups are placed by their cached hash codes.
+static void _CacheGroup_Grow(CacheGroup *groups) {
+	GroupBucket *old_buckets = groups->buckets;
+	uint64_t old_count = groups->bucket_mask + 1;
+	uint64_t bucket_count = old_count * 2;
+	groups->buckets = rm_calloc(bucket_count, sizeof(GroupBucket));
+	groups->bucket_mask = bucket_count - 1;
+
+	for(uint64_t i = 0; i < old_count; i++) {
+		GroupBucket *old = old_buckets + i;
+		if(old->group == 0) continue;
+		uint64_t pos = old->hash & groups->bucket_mask;
+		while(groups->buckets[pos].group != 0) pos = (pos + 1) & groups->bucket_mask;
+		groups->buckets[pos] = *old;
+	}
+
+	rm_free(old_buckets);
 }
 
-void CacheGroupAdd(CacheGroup *groups, char *key, Group *group) {
-	raxInsert(groups, (unsigned char *)key, strlen(key), group, NULL);
+CacheGroup *CacheGroupNew(uint key_count) {
+	CacheGroup *groups = rm_malloc(sizeof(CacheGroup));
+	groups->key_count = key_count;
+	groups->item_size = sizeof(Group) + key_count * sizeof(SIValue);
+	groups->group_count = 0;
+	groups->blocks = array_new(Block *, 1);
+	groups->buckets = rm_calloc(GROUP_CACHE_INITIAL_BUCKETS, sizeof(GroupBucket));
+	groups->bucket_mask = GROUP_CACHE_INITIAL_BUCKETS - 1;
+	return groups;
+}
+
+uint64_t CacheGroup_HashKeys(const SIValue *keys, uint key_count) {
+	uint64_t hash = 0;
+	for(uint i = 0; i < key_count; i++) {
+		// Mix each value's hash code with its position.
+		hash ^= SIValue_HashCode(keys[i]) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+	}
+	return hash;
 }
 
-// Retrives a group,
-// Sets group to NULL if key is missing.
-Group *CacheGroupGet(CacheGroup *groups, char *key) {
-	Group *g = raxFind(groups, (unsigned char *)key, strlen(key));
-	if(g == raxNotFound) return NULL;
+Group *CacheGroupGet(const CacheGroup *groups, const SIValue *keys, uint64_t hash) {
+	GroupBucket *bucket = _CacheGroup_Locate(groups, keys, hash);
+	if(bucket->group == 0) return NULL;
+	return _CacheGroup_GetItem(groups, bucket->group - 1);
+}
+
+Group *CacheGroupAdd(CacheGroup *groups, const SIValue *keys, uint64_t hash,
+					 AR_ExpNode **funcs, uint func_count, Record r) {
+	// Keep the load factor below 1/2.
+	if((groups->group_count + 1) * 2 > groups->bucket_mask + 1) _CacheGroup_Grow(groups);
+
+	GroupBucket *bucket = _CacheGroup_Locate(groups, keys, hash);
+	assert(bucket->group == 0);
+
+	uint64_t idx = groups->group_count;
+	if(idx % GROUP_BLOCK_CAP == 0) {
+		groups->blocks = array_append(groups->blocks, Block_New(groups->item_size, GROUP_BLOCK_CAP));
+	}
+	groups->group_count++;
+
+	// Key values are stored right after the group.
+	Group *g = _CacheGroup_GetItem(groups, idx);
+	SIValue *group_keys = (SIValue *)(g + 1);
+	for(uint i = 0; i < groups->key_count; i++) {
+		group_keys[i] = keys[i];
+		SIValue_Persist(group_keys + i);
+	}
+	Group_Init(g, group_keys, groups->key_count, funcs, func_count, r);
+
+	bucket->hash = hash;
+	bucket->group = idx + 1;
 	return g;
 }
 
 void FreeGroupCache(CacheGroup *groups) {
-	raxFreeWithCallback(groups, (void (*)(void *))FreeGroup);
+	if(groups == NULL) return;
+	for(uint64_t i = 0; i < groups->group_count; i++) Group_FreeEntries(_CacheGroup_GetItem(groups, i));
+
+	uint block_count = array_len(groups->blocks);
+	for(uint i = 0; i < block_count; i++) Block_Free(groups->blocks[i]);
+	array_free(groups->blocks);
+	rm_free(groups->buckets);
+	rm_free(groups);
 }
 
 // Populates an iterator to scan entire group cache
-CacheGroupIterator *CacheGroupIter(CacheGroup *groups) {
+CacheGroupIterator *CacheGroupIter(const CacheGroup *groups) {
 	CacheGroupIterator *iter = rm_malloc(sizeof(CacheGroupIterator));
-
-	raxStart(iter, groups);
-	raxSeek(iter, "^", NULL, 0);
-
+	iter->groups = groups;
+	iter->idx = 0;
 	return iter;
 }
 
-// Advance iterator and returns key & value in current position.
-int CacheGroupIterNext(CacheGroupIterator *iter, char **key, Group **group) {
-	int res = raxNext(iter);
-	if(res == 0) {
+// Advance iterator and returns group in current position.
+int CacheGroupIterNext(CacheGroupIterator *iter, Group **group) {
+	if(iter->idx >= iter->groups->group_count) {
 		*group = NULL;
-	} else {
-		*group = iter->data; // TODO revisit this to fix up
+		return 0;
 	}
-	return res;
+	*group = _CacheGroup_GetItem(iter->groups, iter->idx++);
+	return 1;
 }
 
 void CacheGroupIterator_Free(CacheGroupIterator *iter) {
 	if(iter == NULL) return;
-	raxStop(iter);
 	rm_free(iter);
 }
@@ -8,27 +8,57 @@
 #define GROUP_CACHE_H_
 
 #include "group.h"
-#include "rax.h"
+#include "../util/block.h"
 
-typedef raxIterator CacheGroupIterator;
-typedef rax CacheGroup;
+// Number of groups in a block. Should always be a power of 2.
+#define GROUP_BLOCK_CAP 1024
 
-CacheGroup *CacheGroupNew();
+typedef struct {
+	uint64_t hash;      // Hash of the group's key values.
+	uint64_t group;     // Group position + 1, 0 marks an empty bucket.
+} GroupBucket;
 
-void CacheGroupAdd(CacheGroup *groups, char *key, Group *group);
+/* The group cache maps tuples of key values to groups.
+ * Groups are stored alongside their key values in fixed size blocks,
+ * in the order they were created, such that group pointers remain valid
+ * as the cache grows. Lookups go through an open addressing table over
+ * the keys' hash codes, which is probed linearly. */
+typedef struct {
+	uint key_count;         // Number of values in a group key.
+	uint item_size;         // Size of a group and its key values in bytes.
+	uint64_t group_count;   // Number of groups in cache.
+	Block **blocks;         // Array of blocks holding groups.
+	GroupBucket *buckets;   // Hash table over groups.
+	uint64_t bucket_mask;   // Number of buckets - 1.
+} CacheGroup;
 
-// Retrives a group,
-// Sets group to NULL if key is missing.
-Group *CacheGroupGet(CacheGroup *groups, char *key);
+typedef struct {
+	const CacheGroup *groups;   // Scanned cache.
+	uint64_t idx;               // Position of the next group.
+} CacheGroupIterator;
+
+CacheGroup *CacheGroupNew(uint key_count);
+
+// Hashes a tuple of key values.
+uint64_t CacheGroup_HashKeys(const SIValue *keys, uint key_count);
+
+// Retrives the group associated with keys, hash must be the keys' hash code.
+// Returns NULL if keys are missing.
+Group *CacheGroupGet(const CacheGroup *groups, const SIValue *keys, uint64_t hash);
+
+// Creates a new group associated with keys, which must be missing from the cache.
+// Key values are persisted within the cache, funcs are owned by the group.
+Group *CacheGroupAdd(CacheGroup *groups, const SIValue *keys, uint64_t hash,
+					 AR_ExpNode **funcs, uint func_count, Record r);
 
 void FreeGroupCache(CacheGroup *groups);
 
-// Populates an iterator to scan group cache
-CacheGroupIterator *CacheGroupIter(CacheGroup *groups);
+// Populates an iterator to scan group cache, groups are visited in creation order.
+CacheGroupIterator *CacheGroupIter(const CacheGroup *groups);
 
-// Advance iterator and returns key & value in current position.
-int CacheGroupIterNext(CacheGroupIterator *iter, char **key, Group **group);
+// Advance iterator and returns group in current position.
+int CacheGroupIterNext(CacheGroupIterator *iter, Group **group);
 
 void CacheGroupIterator_Free(CacheGroupIterator *iter);
 
-#endif
\ No newline at end of file
+#endif
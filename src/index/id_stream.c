@@ -0,0 +1,216 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "id_stream.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
+#include <assert.h>
+
+static IDStream *_IDStream_New(IDStreamType type, OrderedIndexIter *iter, IDStream **children) {
+	IDStream *s = rm_malloc(sizeof(IDStream));
+	s->type = type;
+	s->iter = iter;
+	s->ids = NULL;
+	s->pos = 0;
+	s->children = children;
+	s->current = 0;
+	s->positioned = false;
+	s->depleted = false;
+	return s;
+}
+
+IDStream *IDStream_NewValue(OrderedIndexIter *iter) {
+	assert(iter && OrderedIndexIter_SingleValue(iter));
+	return _IDStream_New(ID_STREAM_VALUE, iter, NULL);
+}
+
+IDStream *IDStream_NewRange(OrderedIndexIter *iter) {
+	assert(iter);
+	return _IDStream_New(ID_STREAM_RANGE, iter, NULL);
+}
+
+IDStream *IDStream_NewIntersection(IDStream **children) {
+	assert(children && array_len(children) > 0);
+	return _IDStream_New(ID_STREAM_INTERSECTION, NULL, children);
+}
+
+IDStream *IDStream_NewUnion(IDStream **children) {
+	assert(children);
+	return _IDStream_New(ID_STREAM_UNION, NULL, children);
+}
+
+IDStream *IDStream_NewEmpty(void) {
+	return IDStream_NewUnion(array_new(IDStream *, 0));
+}
+
+#define ID_LT(a, b) (*(a) < *(b))
+
+// Collect and sort the IDs of a range stream's entries.
+static void _IDStream_CollectRange(IDStream *s) {
+	NodeID id;
+	s->ids = array_new(NodeID, 0);
+	while(OrderedIndexIter_Next(s->iter, &id)) s->ids = array_append(s->ids, id);
+	QSORT(NodeID, s->ids, array_len(s->ids), ID_LT);
+	s->pos = 0;
+}
+
+/* Sets s to the first ID shared by all children, starting with candidate
+ * which the first child is positioned on. */
+static bool _IDStream_Intersect(IDStream *s, NodeID candidate) {
+	uint count = array_len(s->children);
+	uint agreed = 1;
+	uint i = 1 % count;
+	while(agreed < count) {
+		NodeID id;
+		if(!IDStream_SkipTo(s->children[i], candidate, &id)) return false;
+		if(id == candidate) {
+			agreed++;
+		} else {
+			candidate = id;
+			agreed = 1;
+		}
+		i = (i + 1) % count;
+	}
+	s->current = candidate;
+	return true;
+}
+
+// Sets s to the smallest ID among children which aren't depleted.
+static bool _IDStream_UnionMin(IDStream *s) {
+	bool found = false;
+	uint count = array_len(s->children);
+	for(uint i = 0; i < count; i++) {
+		const IDStream *child = s->children[i];
+		if(child->depleted || !child->positioned) continue;
+		if(!found || child->current < s->current) s->current = child->current;
+		found = true;
+	}
+	return found;
+}
+
+// Advance s past its current ID.
+static bool _IDStream_Advance(IDStream *s) {
+	NodeID id;
+	switch(s->type) {
+	case ID_STREAM_VALUE:
+		if(!OrderedIndexIter_Next(s->iter, &id)) return false;
+		s->current = id;
+		return true;
+	case ID_STREAM_RANGE:
+		if(s->ids == NULL) _IDStream_CollectRange(s);
+		if(s->pos == array_len(s->ids)) return false;
+		s->current = s->ids[s->pos++];
+		return true;
+	case ID_STREAM_INTERSECTION:
+		if(!IDStream_Next(s->children[0], &id)) return false;
+		return _IDStream_Intersect(s, id);
+	case ID_STREAM_UNION: {
+		// Advance children positioned on the current ID.
+		uint count = array_len(s->children);
+		for(uint i = 0; i < count; i++) {
+			IDStream *child = s->children[i];
+			if(!child->positioned || child->current == s->current) IDStream_Next(child, &id);
+		}
+		return _IDStream_UnionMin(s);
+	}
+	default:
+		assert(false);
+		return false;
+	}
+}
+
+// Advance s to its first ID which is at least target.
+static bool _IDStream_Seek(IDStream *s, NodeID target) {
+	NodeID id;
+	switch(s->type) {
+	case ID_STREAM_VALUE:
+		if(!OrderedIndexIter_SkipTo(s->iter, target, &id)) return false;
+		s->current = id;
+		return true;
+	case ID_STREAM_RANGE: {
+		if(s->ids == NULL) _IDStream_CollectRange(s);
+		// Binary search for the first remaining ID which is at least target.
+		uint64_t lo = s->pos;
+		uint64_t hi = array_len(s->ids);
+		while(lo < hi) {
+			uint64_t mid = lo + (hi - lo) / 2;
+			if(s->ids[mid] < target) lo = mid + 1;
+			else hi = mid;
+		}
+		if(lo == array_len(s->ids)) return false;
+		s->current = s->ids[lo];
+		s->pos = lo + 1;
+		return true;
+	}
+	case ID_STREAM_INTERSECTION:
+		if(!IDStream_SkipTo(s->children[0], target, &id)) return false;
+		return _IDStream_Intersect(s, id);
+	case ID_STREAM_UNION: {
+		uint count = array_len(s->children);
+		for(uint i = 0; i < count; i++) IDStream_SkipTo(s->children[i], target, &id);
+		return _IDStream_UnionMin(s);
+	}
+	default:
+		assert(false);
+		return false;
+	}
+}
+
+bool IDStream_Next(IDStream *s, NodeID *id) {
+	assert(s && id);
+	if(s->depleted) return false;
+	if(!_IDStream_Advance(s)) {
+		s->depleted = true;
+		return false;
+	}
+	s->positioned = true;
+	*id = s->current;
+	return true;
+}
+
+bool IDStream_SkipTo(IDStream *s, NodeID target, NodeID *id) {
+	assert(s && id);
+	if(s->depleted) return false;
+	if(!s->positioned || s->current < target) {
+		if(!_IDStream_Seek(s, target)) {
+			s->depleted = true;
+			return false;
+		}
+		s->positioned = true;
+	}
+	*id = s->current;
+	return true;
+}
+
+void IDStream_Reset(IDStream *s) {
+	assert(s);
+	s->positioned = false;
+	s->depleted = false;
+	s->pos = 0;
+	if(s->iter) OrderedIndexIter_Reset(s->iter);
+	// Ranges are collected again, reflecting modifications of the index.
+	if(s->ids) {
+		array_free(s->ids);
+		s->ids = NULL;
+	}
+	if(s->children) {
+		uint count = array_len(s->children);
+		for(uint i = 0; i < count; i++) IDStream_Reset(s->children[i]);
+	}
+}
+
+void IDStream_Free(IDStream *s) {
+	if(s == NULL) return;
+	if(s->iter) OrderedIndexIter_Free(s->iter);
+	if(s->ids) array_free(s->ids);
+	if(s->children) {
+		uint count = array_len(s->children);
+		for(uint i = 0; i < count; i++) IDStream_Free(s->children[i]);
+		array_free(s->children);
+	}
+	rm_free(s);
+}
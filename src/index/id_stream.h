@@ -0,0 +1,90 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "ordered_index.h"
+
+/* Streams of node IDs in ascending order, resolved by ordered index lookups
+ * and combined lazily by intersection and union, such that predicates over
+ * multiple indexed attributes are resolved without fetching nodes.
+ * Entries of a single value are ordered by node ID and are streamed directly,
+ * entries of a range of values are sorted by ID once first read. */
+
+typedef enum {
+	ID_STREAM_VALUE,        // Entries of a single value.
+	ID_STREAM_RANGE,        // Entries of a range of values.
+	ID_STREAM_INTERSECTION, // IDs produced by every child stream.
+	ID_STREAM_UNION,        // IDs produced by any child stream.
+} IDStreamType;
+
+typedef struct IDStream IDStream;
+
+struct IDStream {
+	IDStreamType type;
+	OrderedIndexIter *iter;     // Iterated entries, value and range streams.
+	NodeID *ids;                // Range stream IDs, in ascending order.
+	uint64_t pos;               // Position within ids.
+	IDStream **children;        // Combined streams.
+	NodeID current;             // Last ID produced.
+	bool positioned;            // The stream produced an ID.
+	bool depleted;              // No more IDs.
+};
+
+// Create a stream over the entries of iter, which spans a single value.
+IDStream *IDStream_NewValue
+(
+	OrderedIndexIter *iter
+);
+
+// Create a stream over the entries of iter, which spans a range of values.
+IDStream *IDStream_NewRange
+(
+	OrderedIndexIter *iter
+);
+
+// Create a stream of IDs produced by every child, takes ownership of children.
+IDStream *IDStream_NewIntersection
+(
+	IDStream **children
+);
+
+// Create a stream of IDs produced by any child, takes ownership of children.
+IDStream *IDStream_NewUnion
+(
+	IDStream **children
+);
+
+// Create a stream producing no IDs.
+IDStream *IDStream_NewEmpty(void);
+
+// Advance stream, returns false once depleted.
+bool IDStream_Next
+(
+	IDStream *s,
+	NodeID *id
+);
+
+/* Advance stream to the first ID which is at least target,
+ * the last ID produced is produced again if it is, returns false once depleted. */
+bool IDStream_SkipTo
+(
+	IDStream *s,
+	NodeID target,
+	NodeID *id
+);
+
+// Rewind stream to its first ID.
+void IDStream_Reset
+(
+	IDStream *s
+);
+
+// Free stream.
+void IDStream_Free
+(
+	IDStream *s
+);
@@ -2,6 +2,7 @@
 #include "../value.h"
 #include "../util/arr.h"
 #include "../query_ctx.h"
+#include "../util/qsort.h"
 #include "../util/rmalloc.h"
 #include "../graph/graphcontext.h"
 #include "../graph/entities/node.h"
@@ -32,49 +33,69 @@ static int _getNodeAttribute(void *ctx, const char *fieldName, const void *id, c
 	return ret;
 }
 
-static void _populateIndex
+// Index every edge of the indexed relationship type.
+static void _populateEdgeIndex
 (
 	Index *idx
 ) {
 	GraphContext *gc = QueryCtx_GetGraphCtx();
-	Schema *s = GraphContext_GetSchema(gc, idx->label, SCHEMA_NODE);
+	Schema *s = GraphContext_GetSchema(gc, idx->label, SCHEMA_EDGE);
 
-	// Label doesn't exists.
+	// Relationship type doesn't exists.
 	if(s == NULL) return;
 
-	Node node;
-	NodeID node_id;
 	Graph *g = gc->g;
-	int label_id = s->id;
+	NodeID src_id;
+	NodeID dest_id;
 	GxB_MatrixTupleIter *it;
-	const GrB_Matrix label_matrix = Graph_GetLabelMatrix(g, label_id);
-	GxB_MatrixTupleIter_new(&it, label_matrix);
+	Edge *edges = array_new(Edge, 1);
+	const GrB_Matrix relation_matrix = Graph_GetRelationMatrix(g, s->id);
+	GxB_MatrixTupleIter_new(&it, relation_matrix);
 
-	// Iterate over each labeled node.
+	// Iterate over each connected pair, collecting the edges connecting it.
 	while(true) {
 		bool depleted = false;
-		GxB_MatrixTupleIter_next(it, NULL, &node_id, &depleted);
+		GxB_MatrixTupleIter_next(it, &src_id, &dest_id, &depleted);
 		if(depleted) break;
 
-		Graph_GetNode(g, node_id, &node);
-		Index_IndexNode(idx, &node);
+		Graph_GetEdgesConnectingNodes(g, src_id, dest_id, s->id, &edges);
+		uint edge_count = array_len(edges);
+		for(uint i = 0; i < edge_count; i++) Index_IndexEdge(idx, edges + i);
+		array_clear(edges);
 	}
 	GxB_MatrixTupleIter_free(it);
+	array_free(edges);
 }
 
+// Identifies index constructions, such that a superseded construction is detected.
+static uint64_t _constructions = 0;
+
+static void _Index_IndexNode(Index *idx, const Node *n);
+
 // Create a new index.
 Index *Index_New
 (
-	const char *label,  // Indexed label
-	IndexType type    // Index type exact-match / fulltext.
+	const char *label,              // Indexed label or relationship type
+	IndexType type,                 // Index type exact-match / fulltext.
+	GraphEntityType entity_type     // Indexed entities, nodes or edges
 ) {
+	assert(entity_type == GETYPE_NODE || type == IDX_EXACT_MATCH);
 	Index *idx = rm_malloc(sizeof(Index));
 	idx->idx = NULL;
+	idx->ordered = NULL;
+	idx->composites = array_new(IndexComposite, 0);
+	idx->unique = array_new(Attribute_ID, 0);
 	idx->fields_count = 0;
 	idx->type = type;
+	idx->entity_type = entity_type;
 	idx->label = rm_strdup(label);
 	idx->fields = array_new(char *, 0);
 	idx->fields_ids = array_new(Attribute_ID, 0);
+	idx->constructed = 0;
+	idx->construction = 0;
+	idx->operational = false;
+	idx->async = false;
+	idx->pending = array_new(NodeID, 0);
 	return idx;
 }
 
@@ -106,6 +127,8 @@ void Index_RemoveField
 
 	for(uint i = 0; i < idx->fields_count; i++) {
 		if(strcmp(idx->fields[i], field) == 0) {
+			if(idx->ordered) OrderedIndex_RemoveAttribute(idx->ordered, idx->fields_ids[i]);
+			Index_RemoveUniqueConstraint(idx, field);
 			idx->fields_count--;
 			rm_free(idx->fields[i]);
 			array_del_fast(idx->fields, i);
@@ -115,7 +138,209 @@ void Index_RemoveField
 	}
 }
 
-void Index_IndexNode
+// Locate composite index over fields, returns -1 if not found.
+static int _Index_FindComposite
+(
+	const Index *idx,
+	const char **fields,
+	uint fields_count
+) {
+	uint composite_count = array_len(idx->composites);
+	for(uint i = 0; i < composite_count; i++) {
+		IndexComposite *c = idx->composites + i;
+		if(c->fields_count != fields_count) continue;
+		uint j = 0;
+		while(j < fields_count && strcmp(c->fields[j], fields[j]) == 0) j++;
+		if(j == fields_count) return i;
+	}
+	return -1;
+}
+
+bool Index_AddComposite
+(
+	Index *idx,
+	const char **fields,
+	uint fields_count
+) {
+	assert(idx && idx->type == IDX_EXACT_MATCH && idx->entity_type == GETYPE_NODE &&
+		   fields_count > 1);
+	if(_Index_FindComposite(idx, fields, fields_count) != -1) return false;
+
+	// Each field appears once.
+	for(uint i = 0; i < fields_count; i++) {
+		for(uint j = i + 1; j < fields_count; j++) {
+			if(strcmp(fields[i], fields[j]) == 0) return false;
+		}
+	}
+
+	IndexComposite c;
+	c.fields_count = fields_count;
+	c.fields = array_new(char *, fields_count);
+	c.fields_ids = array_new(Attribute_ID, fields_count);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	for(uint i = 0; i < fields_count; i++) {
+		c.fields = array_append(c.fields, rm_strdup(fields[i]));
+		c.fields_ids = array_append(c.fields_ids, GraphContext_FindOrAddAttribute(gc, fields[i]));
+	}
+
+	idx->composites = array_append(idx->composites, c);
+	return true;
+}
+
+static void _IndexComposite_Free
+(
+	IndexComposite *c
+) {
+	for(uint i = 0; i < c->fields_count; i++) rm_free(c->fields[i]);
+	array_free(c->fields);
+	array_free(c->fields_ids);
+}
+
+bool Index_RemoveComposite
+(
+	Index *idx,
+	const char **fields,
+	uint fields_count
+) {
+	assert(idx);
+	int i = _Index_FindComposite(idx, fields, fields_count);
+	if(i == -1) return false;
+
+	_IndexComposite_Free(idx->composites + i);
+	// Composites are identified by position, entries are rebuilt by Index_Construct.
+	uint composite_count = array_len(idx->composites);
+	memmove(idx->composites + i, idx->composites + i + 1,
+			(composite_count - i - 1) * sizeof(IndexComposite));
+	array_pop(idx->composites);
+	return true;
+}
+
+uint Index_CompositeCount
+(
+	const Index *idx
+) {
+	assert(idx);
+	return array_len(idx->composites);
+}
+
+// Returns the ID of an indexed field, ATTRIBUTE_NOTFOUND if field isn't indexed.
+static Attribute_ID _Index_FieldID
+(
+	const Index *idx,
+	const char *field
+) {
+	for(uint i = 0; i < idx->fields_count; i++) {
+		if(strcmp(idx->fields[i], field) == 0) return idx->fields_ids[i];
+	}
+	return ATTRIBUTE_NOTFOUND;
+}
+
+// Locate unique constraint over attribute, returns -1 if not found.
+static int _Index_FindUnique
+(
+	const Index *idx,
+	Attribute_ID attr
+) {
+	uint unique_count = array_len(idx->unique);
+	for(uint i = 0; i < unique_count; i++) {
+		if(idx->unique[i] == attr) return i;
+	}
+	return -1;
+}
+
+bool Index_AddUniqueConstraint
+(
+	Index *idx,
+	const char *field
+) {
+	assert(idx && idx->type == IDX_EXACT_MATCH);
+
+	Attribute_ID attr = _Index_FieldID(idx, field);
+	assert(attr != ATTRIBUTE_NOTFOUND && "unique constraints require an indexed field");
+	if(_Index_FindUnique(idx, attr) != -1) return false;
+
+	idx->unique = array_append(idx->unique, attr);
+	return true;
+}
+
+bool Index_RemoveUniqueConstraint
+(
+	Index *idx,
+	const char *field
+) {
+	assert(idx && field);
+
+	int i = _Index_FindUnique(idx, _Index_FieldID(idx, field));
+	if(i == -1) return false;
+
+	array_del_fast(idx->unique, i);
+	return true;
+}
+
+uint Index_UniqueConstraintCount
+(
+	const Index *idx
+) {
+	assert(idx);
+	return array_len(idx->unique);
+}
+
+bool Index_IsUnique
+(
+	const Index *idx,
+	Attribute_ID attr
+) {
+	assert(idx);
+	return _Index_FindUnique(idx, attr) != -1;
+}
+
+bool Index_UniqueLookup
+(
+	const Index *idx,
+	Attribute_ID attr,
+	SIValue v,
+	EntityID exclude,
+	EntityID *id
+) {
+	assert(idx && id);
+	if(idx->ordered == NULL) return false;
+	return OrderedIndex_Lookup(idx->ordered, attr, v, exclude, id);
+}
+
+bool Index_HasDuplicates
+(
+	const Index *idx,
+	Attribute_ID attr
+) {
+	assert(idx && idx->ordered);
+	return OrderedIndex_HasDuplicates(idx->ordered, attr);
+}
+
+// Index node under each composite index holding at least its first field.
+static void _Index_IndexNodeComposites
+(
+	Index *idx,
+	const Node *n
+) {
+	NodeID node_id = ENTITY_GET_ID(n);
+	uint composite_count = array_len(idx->composites);
+	for(uint i = 0; i < composite_count; i++) {
+		IndexComposite *c = idx->composites + i;
+		SIValue values[c->fields_count];
+		uint count = 0;
+		// Entries hold the leading indexable values, such that prefix lookups find the node.
+		for(; count < c->fields_count; count++) {
+			SIValue *v = GraphEntity_GetProperty((GraphEntity *)n, c->fields_ids[count]);
+			if(v == PROPERTY_NOTFOUND) break;
+			if(!(SI_TYPE(*v) & (SI_NUMERIC | T_STRING | T_BOOL))) break;
+			values[count] = *v;
+		}
+		if(count > 0) OrderedIndex_InsertTuple(idx->ordered, node_id, i, values, count);
+	}
+}
+
+static void _Index_IndexNode
 (
 	Index *idx,
 	const Node *n
@@ -145,6 +370,7 @@ void Index_IndexNode
 												  RSFLDTYPE_FULLTEXT);
 			}
 		} else {
+			OrderedIndex_Insert(idx->ordered, node_id, idx->fields_ids[i], *v);
 			if(SI_TYPE(*v) == T_STRING) {
 				RediSearch_DocumentAddFieldString(doc, idx->fields[i], v->stringval, strlen(v->stringval),
 												  RSFLDTYPE_TAG);
@@ -159,6 +385,34 @@ void Index_IndexNode
 
 	if(doc_field_count > 0) RediSearch_SpecAddDocument(rsIdx, doc);
 	else RediSearch_FreeDocument(doc);
+
+	if(idx->type == IDX_EXACT_MATCH) _Index_IndexNodeComposites(idx, n);
+}
+
+/* Returns true if node is yet to be reached by the index construction,
+ * in which case the construction indexes the node's current state. */
+static inline bool _Index_Unreached
+(
+	const Index *idx,
+	NodeID node_id
+) {
+	return (!idx->operational && node_id >= idx->constructed);
+}
+
+void Index_IndexNode
+(
+	Index *idx,
+	const Node *n
+) {
+	assert(idx && n);
+	NodeID node_id = ENTITY_GET_ID(n);
+	if(_Index_Unreached(idx, node_id)) return;
+	// The document is updated in the background, according to the node's state by then.
+	if(idx->async) {
+		idx->pending = array_append(idx->pending, node_id);
+		return;
+	}
+	_Index_IndexNode(idx, n);
 }
 
 void Index_RemoveNode
@@ -168,11 +422,42 @@ void Index_RemoveNode
 ) {
 	assert(idx && n);
 	NodeID node_id = ENTITY_GET_ID(n);
+	if(_Index_Unreached(idx, node_id)) return;
+	if(idx->async) {
+		idx->pending = array_append(idx->pending, node_id);
+		return;
+	}
 	RediSearch_DeleteDocument(idx->idx, &node_id, sizeof(EntityID));
+	if(idx->ordered) OrderedIndex_RemoveNode(idx->ordered, node_id);
 }
 
-// Constructs index.
-void Index_Construct
+void Index_IndexEdge
+(
+	Index *idx,
+	const Edge *e
+) {
+	assert(idx && e && idx->entity_type == GETYPE_EDGE);
+	EdgeID edge_id = ENTITY_GET_ID(e);
+	NodeID src_id = Edge_GetSrcNodeID(e);
+	NodeID dest_id = Edge_GetDestNodeID(e);
+
+	for(uint i = 0; i < idx->fields_count; i++) {
+		SIValue *v = GraphEntity_GetProperty((GraphEntity *)e, idx->fields_ids[i]);
+		if(v == PROPERTY_NOTFOUND) continue;
+		OrderedIndex_InsertEdge(idx->ordered, edge_id, src_id, dest_id, idx->fields_ids[i], *v);
+	}
+}
+
+void Index_RemoveEdge
+(
+	Index *idx,
+	const Edge *e
+) {
+	assert(idx && e && idx->entity_type == GETYPE_EDGE);
+	if(idx->ordered) OrderedIndex_RemoveNode(idx->ordered, ENTITY_GET_ID(e));
+}
+
+void Index_BeginConstruction
 (
 	Index *idx
 ) {
@@ -184,6 +469,22 @@ void Index_Construct
 		RediSearch_DropIndex(idx->idx);
 		idx->idx = NULL;
 	}
+	if(idx->ordered) {
+		OrderedIndex_Free(idx->ordered);
+		idx->ordered = NULL;
+	}
+
+	// The construction indexes every node's current state.
+	array_clear(idx->pending);
+	idx->constructed = 0;
+	idx->operational = false;
+	idx->construction = __atomic_add_fetch(&_constructions, 1, __ATOMIC_RELAXED);
+
+	// Edges are indexed by the ordered index alone.
+	if(idx->entity_type == GETYPE_EDGE) {
+		idx->ordered = OrderedIndex_NewEdgeIndex();
+		return;
+	}
 
 	RSIndex *rsIdx = NULL;
 	GraphContext *gc = QueryCtx_GetGraphCtx();
@@ -207,10 +508,121 @@ void Index_Construct
 			RediSearch_TagFieldSetSeparator(rsIdx, fieldID, '\0');
 			RediSearch_TagFieldSetCaseSensitive(rsIdx, fieldID, 1);
 		}
+		// Point and range lookups are resolved by the ordered index.
+		idx->ordered = OrderedIndex_New();
 	}
 
 	idx->idx = rsIdx;
-	_populateIndex(idx);
+}
+
+bool Index_ConstructStep
+(
+	Index *idx,
+	uint64_t limit
+) {
+	assert(idx && idx->entity_type == GETYPE_NODE);
+	if(idx->operational) return true;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchema(gc, idx->label, SCHEMA_NODE);
+	Graph *g = gc->g;
+	// Label doesn't exists.
+	bool depleted = (s == NULL);
+	if(!depleted) {
+		Node node;
+		NodeID node_id;
+		IDSetIterator it;
+		IDSet_IterateRange(Graph_GetLabelIDs(g, s->id), &it, idx->constructed, UINT64_MAX);
+
+		// Iterate over labeled nodes, resuming past the last indexed node.
+		for(uint64_t indexed = 0; indexed < limit; indexed++) {
+			depleted = !IDSetIterator_Next(&it, &node_id);
+			if(depleted) break;
+
+			Graph_GetNode(g, node_id, &node);
+			_Index_IndexNode(idx, &node);
+			idx->constructed = node_id + 1;
+		}
+	}
+
+	if(depleted) idx->operational = true;
+	return idx->operational;
+}
+
+// Constructs index.
+void Index_Construct
+(
+	Index *idx
+) {
+	Index_BeginConstruction(idx);
+	if(idx->entity_type == GETYPE_EDGE) {
+		_populateEdgeIndex(idx);
+		idx->operational = true;
+	} else {
+		Index_ConstructStep(idx, UINT64_MAX);
+	}
+}
+
+bool Index_IsOperational
+(
+	const Index *idx
+) {
+	assert(idx);
+	return idx->operational;
+}
+
+void Index_SetAsync
+(
+	Index *idx,
+	bool async
+) {
+	assert(idx && idx->type == IDX_FULLTEXT);
+	if(!async) Index_ApplyPending(idx);
+	idx->async = async;
+}
+
+bool Index_IsAsync
+(
+	const Index *idx
+) {
+	assert(idx);
+	return idx->async;
+}
+
+uint64_t Index_PendingCount
+(
+	const Index *idx
+) {
+	assert(idx);
+	return array_len(idx->pending);
+}
+
+void Index_ApplyPending
+(
+	Index *idx
+) {
+	assert(idx);
+	uint count = array_len(idx->pending);
+	if(count == 0) return;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchema(gc, idx->label, SCHEMA_NODE);
+	Graph *g = gc->g;
+
+	// Nodes modified multiple times are indexed once.
+	QSORT(NodeID, idx->pending, count, ENTITY_ID_ISLT);
+	for(uint i = 0; i < count; i++) {
+		NodeID node_id = idx->pending[i];
+		if(i > 0 && node_id == idx->pending[i - 1]) continue;
+
+		RediSearch_DeleteDocument(idx->idx, &node_id, sizeof(EntityID));
+		// Deleted nodes, and nodes whose ID was reused by a node of another label, are left out.
+		Node n;
+		if(s && Graph_IsNodeLabeled(g, node_id, s->id) && Graph_GetNode(g, node_id, &n)) {
+			_Index_IndexNode(idx, &n);
+		}
+	}
+	array_clear(idx->pending);
 }
 
 // Query index.
@@ -266,6 +678,28 @@ bool Index_ContainsField
 	return false;
 }
 
+bool Index_ContainsAttribute
+(
+	const Index *idx,
+	Attribute_ID attr
+) {
+	assert(idx);
+
+	for(uint i = 0; i < idx->fields_count; i++) {
+		if(idx->fields_ids[i] == attr) return true;
+	}
+
+	uint composite_count = array_len(idx->composites);
+	for(uint i = 0; i < composite_count; i++) {
+		const IndexComposite *c = idx->composites + i;
+		for(uint j = 0; j < c->fields_count; j++) {
+			if(c->fields_ids[j] == attr) return true;
+		}
+	}
+
+	return false;
+}
+
 // Free index.
 void Index_Free
 (
@@ -273,6 +707,7 @@ void Index_Free
 ) {
 	assert(idx);
 	if(idx->idx) RediSearch_DropIndex(idx->idx);
+	if(idx->ordered) OrderedIndex_Free(idx->ordered);
 
 	rm_free(idx->label);
 
@@ -283,6 +718,12 @@ void Index_Free
 	array_free(idx->fields);
 	array_free(idx->fields_ids);
 
+	uint composite_count = array_len(idx->composites);
+	for(uint i = 0; i < composite_count; i++) _IndexComposite_Free(idx->composites + i);
+	array_free(idx->composites);
+	array_free(idx->unique);
+	array_free(idx->pending);
+
 	rm_free(idx);
 }
 
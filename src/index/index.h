@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include "ordered_index.h"
 #include "../graph/entities/node.h"
+#include "../graph/entities/edge.h"
 #include "../graph/entities/graph_entity.h"
 #include "redisearch_api.h"
 
@@ -18,20 +20,53 @@ typedef enum {
 	IDX_FULLTEXT,
 } IndexType;
 
+// Tags composite indices when persisted along the IndexType of each indexed field.
+#define IDX_COMPOSITE_TAG 2
+// Tags unique constraints when persisted along the IndexType of each indexed field.
+#define IDX_UNIQUE_TAG 3
+// Tags vector indices when persisted along the IndexType of each indexed field.
+#define IDX_VECTOR_TAG 4
+// Tags asynchronous fulltext indices when persisted along the IndexType of each indexed field.
+#define IDX_ASYNC_TAG 5
+// Tags the expiry of a schema's entities when persisted along the IndexType of each indexed field.
+#define IDX_TTL_TAG 6
+// Tags the interval index of a relation's edges when persisted along the IndexType of each indexed field.
+#define IDX_INTERVAL_TAG 7
+// Tags maintained weight matrices when persisted along the IndexType of each indexed field.
+#define IDX_WEIGHT_TAG 8
+
+// Composite exact-match index over an ordered list of fields.
+typedef struct {
+	char **fields;              // Indexed fields, in key order.
+	Attribute_ID *fields_ids;   // Indexed field IDs.
+	uint fields_count;          // Number of fields.
+} IndexComposite;
+
 typedef struct {
-	char *label;                // Indexed label.
+	char *label;                // Indexed label or relationship type.
 	char **fields;              // Indexed fields.
 	Attribute_ID *fields_ids;   // Indexed field IDs.
 	uint fields_count;          // Number of fields.
-	RSIndex *idx;               // RediSearch index.
+	RSIndex *idx;               // RediSearch index, node indices only.
+	OrderedIndex *ordered;      // In-process ordered index, exact-match indices only.
+	IndexComposite *composites; // Composite indices, exact-match indices only.
+	Attribute_ID *unique;       // Fields constrained to hold unique values, exact-match indices only.
 	IndexType type;             // Index type exact-match / fulltext.
+	GraphEntityType entity_type;// Indexed entities, nodes or edges.
+	NodeID constructed;         // While under construction, nodes with a lower ID are indexed.
+	uint64_t construction;      // Identifies the index's latest construction.
+	bool operational;           // Index is fully constructed and may serve queries.
+	bool async;                 // Documents are updated in the background, fulltext indices only.
+	NodeID *pending;            // Nodes whose documents are yet to be updated, async indices only.
 } Index;
 
-// Create a new FullText index.
+/* Create a new index, edge indices are exact-match indices
+ * resolved by the ordered index alone. */
 Index *Index_New
 (
-	const char *label,  // Indexed label
-	IndexType type      // Index is a fulltext index
+	const char *label,              // Indexed label or relationship type
+	IndexType type,                 // Index is a fulltext index
+	GraphEntityType entity_type     // Indexed entities, nodes or edges
 );
 
 // Adds field to index.
@@ -48,6 +83,78 @@ void Index_RemoveField
 	const char *field
 );
 
+/* Adds composite index over fields, in order.
+ * Returns false if an identical composite index exists. */
+bool Index_AddComposite
+(
+	Index *idx,
+	const char **fields,
+	uint fields_count
+);
+
+/* Removes composite index over fields.
+ * Returns false if no such composite index exists. */
+bool Index_RemoveComposite
+(
+	Index *idx,
+	const char **fields,
+	uint fields_count
+);
+
+// Returns number of composite indices.
+uint Index_CompositeCount
+(
+	const Index *idx
+);
+
+/* Constrains values of an indexed field to be unique.
+ * Returns false if field is already constrained. */
+bool Index_AddUniqueConstraint
+(
+	Index *idx,
+	const char *field
+);
+
+/* Removes unique constraint over field.
+ * Returns false if field isn't constrained. */
+bool Index_RemoveUniqueConstraint
+(
+	Index *idx,
+	const char *field
+);
+
+// Returns number of unique constraints.
+uint Index_UniqueConstraintCount
+(
+	const Index *idx
+);
+
+// Returns true if values of attribute are constrained to be unique.
+bool Index_IsUnique
+(
+	const Index *idx,
+	Attribute_ID attr
+);
+
+/* Sets id to an entity other than exclude holding v under attribute,
+ * returns false if there's none. */
+bool Index_UniqueLookup
+(
+	const Index *idx,
+	Attribute_ID attr,
+	SIValue v,
+	EntityID exclude,
+	EntityID *id
+);
+
+/* Returns true if multiple indexed entities hold an equal value
+ * under attribute, the index must be constructed. */
+bool Index_HasDuplicates
+(
+	const Index *idx,
+	Attribute_ID attr
+);
+
 // Index node.
 void Index_IndexNode
 (
@@ -62,12 +169,75 @@ void Index_RemoveNode
 	const Node *n   // Node to remove
 );
 
+// Index edge.
+void Index_IndexEdge
+(
+	Index *idx,     // Index to use
+	const Edge *e   // Edge to index
+);
+
+// Remove edge from index.
+void Index_RemoveEdge
+(
+	Index *idx,     // Index to use
+	const Edge *e   // Edge to remove
+);
+
 // Constructs index.
 void Index_Construct
 (
 	Index *idx
 );
 
+/* Clears index, such that it is constructed in steps by Index_ConstructStep.
+ * Until constructed the index isn't operational, node updates are applied
+ * only to nodes the construction has already reached. */
+void Index_BeginConstruction
+(
+	Index *idx
+);
+
+/* Indexes up to limit labeled nodes the construction hasn't reached yet,
+ * returns true once the index is fully constructed and operational. */
+bool Index_ConstructStep
+(
+	Index *idx,
+	uint64_t limit
+);
+
+// Returns true if index is fully constructed and may serve queries.
+bool Index_IsOperational
+(
+	const Index *idx
+);
+
+/* Sets whether the documents of a fulltext index are updated in the background,
+ * disabling background updates applies pending updates. */
+void Index_SetAsync
+(
+	Index *idx,
+	bool async
+);
+
+// Returns true if index documents are updated in the background.
+bool Index_IsAsync
+(
+	const Index *idx
+);
+
+// Returns number of nodes whose documents are yet to be updated.
+uint64_t Index_PendingCount
+(
+	const Index *idx
+);
+
+/* Updates the documents of nodes modified since the last call, according to their
+ * current state, expects the graph to be held exclusively. */
+void Index_ApplyPending
+(
+	Index *idx
+);
+
 // Query index.
 RSResultsIterator *Index_Query
 (
@@ -101,6 +271,13 @@ bool Index_ContainsField
 	const char *field
 );
 
+// Checks if attribute is indexed, by either a field or a composite index.
+bool Index_ContainsAttribute
+(
+	const Index *idx,
+	Attribute_ID attr
+);
+
 // Free fulltext index.
 void Index_Free
 (
@@ -0,0 +1,315 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "interval_index.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
+#include "../graph/entities/multi_edge.h"
+#include <math.h>
+#include <assert.h>
+
+// Entries are recollected once a pair in INTERVAL_STALE_RATIO is superseded.
+#define INTERVAL_STALE_RATIO 8
+// Number of pairs superseded before entries are recollected, however few the entries.
+#define INTERVAL_STALE_MIN 128
+
+#define INTERVAL_START_LT(a, b) ((a)->from < (b)->from || ((a)->from == (b)->from && (a)->id < (b)->id))
+#define INTERVAL_SOURCE_LT(a, b) ((a)->src < (b)->src || ((a)->src == (b)->src && \
+	((a)->dest < (b)->dest || ((a)->dest == (b)->dest && (a)->id < (b)->id))))
+#define INTERVAL_PAIR_LT(a, b) ((a)->src < (b)->src || ((a)->src == (b)->src && (a)->dest < (b)->dest))
+
+/* Reads the bound held by attr, timestamps are whole milliseconds,
+ * such that fractional bounds are rounded up. */
+static int64_t _IntervalIndex_Bound(const Edge *e, Attribute_ID attr, int64_t unbounded) {
+	if(attr == ATTRIBUTE_NOTFOUND) return unbounded;
+	SIValue *v = GraphEntity_GetProperty((GraphEntity *)e, attr);
+	if(v == PROPERTY_NOTFOUND || !(SI_TYPE(*v) & SI_NUMERIC)) return unbounded;
+	if(SI_TYPE(*v) & T_INT64) return v->longval;
+	double bound = ceil(v->doubleval);
+	if(bound <= (double)INT64_MIN) return INT64_MIN;
+	if(bound >= (double)INT64_MAX) return INT64_MAX;
+	return (int64_t)bound;
+}
+
+// Appends the interval of edge e to entries, edges whose interval is empty are never valid.
+static void _IntervalIndex_Append(IntervalEntry **entries, const Edge *e, Attribute_ID from,
+								  Attribute_ID to, NodeID src, NodeID dest) {
+	IntervalEntry entry = {
+		.from = _IntervalIndex_Bound(e, from, INT64_MIN),
+		.to = _IntervalIndex_Bound(e, to, INT64_MAX),
+		.src = src,
+		.dest = dest,
+		.id = ENTITY_GET_ID(e),
+	};
+	if(entry.from < entry.to) *entries = array_append(*entries, entry);
+}
+
+static void _IntervalIndex_Collect(IntervalIndex *idx, Graph *g, Attribute_ID from,
+								   Attribute_ID to, EdgeID id, NodeID src, NodeID dest) {
+	Edge e;
+	assert(Graph_GetEdge(g, id, &e));
+	_IntervalIndex_Append(&idx->entries, &e, from, to, src, dest);
+}
+
+// Annotates the subtree spanning entries [lo, hi) with its latest interval end.
+static int64_t _IntervalIndex_Annotate(IntervalIndex *idx, uint64_t lo, uint64_t hi) {
+	if(lo >= hi) return INT64_MIN;
+	uint64_t mid = lo + (hi - lo) / 2;
+	int64_t max_to = idx->entries[mid].to;
+	int64_t left = _IntervalIndex_Annotate(idx, lo, mid);
+	int64_t right = _IntervalIndex_Annotate(idx, mid + 1, hi);
+	if(left > max_to) max_to = left;
+	if(right > max_to) max_to = right;
+	idx->max_to[mid] = max_to;
+	return max_to;
+}
+
+static void _IntervalIndex_Build(IntervalIndex *idx, Graph *g, int relation, Attribute_ID from,
+								 Attribute_ID to) {
+	GrB_Matrix R = Graph_GetRelationMatrix(g, relation);
+	GrB_Index nvals;
+	assert(GrB_Matrix_nvals(&nvals, R) == GrB_SUCCESS);
+	GrB_Index *rows = rm_malloc(sizeof(GrB_Index) * (nvals + 1));
+	GrB_Index *cols = rm_malloc(sizeof(GrB_Index) * (nvals + 1));
+	EdgeID *values = rm_malloc(sizeof(EdgeID) * (nvals + 1));
+	assert(GrB_Matrix_extractTuples_UINT64(rows, cols, values, &nvals, R) == GrB_SUCCESS);
+
+	idx->entries = array_new(IntervalEntry, nvals);
+	for(GrB_Index k = 0; k < nvals; k++) {
+		EdgeID value = values[k];
+		if(SINGLE_EDGE(value)) {
+			_IntervalIndex_Collect(idx, g, from, to, SINGLE_EDGE_ID(value), rows[k], cols[k]);
+		} else {
+			const MultiEdge *me = (const MultiEdge *)value;
+			for(uint32_t i = 0; i < me->count; i++) {
+				_IntervalIndex_Collect(idx, g, from, to, me->ids[i], rows[k], cols[k]);
+			}
+		}
+	}
+
+	uint64_t count = array_len(idx->entries);
+	QSORT(IntervalEntry, idx->entries, count, INTERVAL_START_LT);
+	idx->max_to = rm_malloc(sizeof(int64_t) * (count + 1));
+	_IntervalIndex_Annotate(idx, 0, count);
+	idx->from = from;
+	idx->to = to;
+
+	rm_free(rows);
+	rm_free(cols);
+	rm_free(values);
+}
+
+static void _IntervalIndex_Clear(IntervalIndex *idx) {
+	if(idx->entries) array_free(idx->entries);
+	if(idx->valid) array_free(idx->valid);
+	if(idx->max_to) rm_free(idx->max_to);
+	idx->entries = NULL;
+	idx->valid = NULL;
+	idx->max_to = NULL;
+	// Recollected entries reflect every write.
+	array_clear(idx->touched);
+	array_clear(idx->stale);
+	array_clear(idx->pending);
+}
+
+// Binary search for pair within the ordered pairs.
+static bool _IntervalIndex_ContainsPair(const IntervalPair *pairs, uint64_t count, NodeID src,
+										NodeID dest) {
+	IntervalPair pair = {src, dest};
+	uint64_t lo = 0;
+	uint64_t hi = count;
+	while(lo < hi) {
+		uint64_t mid = lo + (hi - lo) / 2;
+		if(INTERVAL_PAIR_LT(pairs + mid, &pair)) lo = mid + 1;
+		else hi = mid;
+	}
+	return (lo < count && pairs[lo].src == src && pairs[lo].dest == dest);
+}
+
+/* Brings entries up to date, collecting them if they were never collected or
+ * were invalidated, otherwise superseding the entries of the written pairs. */
+static void _IntervalIndex_Sync(IntervalIndex *idx, Graph *g, int relation, Attribute_ID from,
+								Attribute_ID to) {
+	// Attributes created since entries were collected may be held by any edge.
+	if(idx->entries && (idx->from != from || idx->to != to)) _IntervalIndex_Clear(idx);
+	if(idx->entries == NULL) {
+		_IntervalIndex_Build(idx, g, relation, from, to);
+		return;
+	}
+
+	uint64_t touched_count = array_len(idx->touched);
+	if(touched_count == 0) return;
+
+	// Order and deduplicate the written pairs.
+	IntervalPair *touched = idx->touched;
+	QSORT(IntervalPair, touched, touched_count, INTERVAL_PAIR_LT);
+	uint64_t unique = 0;
+	for(uint64_t i = 0; i < touched_count; i++) {
+		if(unique > 0 && touched[unique - 1].src == touched[i].src &&
+		   touched[unique - 1].dest == touched[i].dest) continue;
+		touched[unique++] = touched[i];
+	}
+	touched_count = unique;
+
+	// Merge the written pairs into the stale pairs.
+	uint64_t stale_count = array_len(idx->stale);
+	IntervalPair *stale = array_new(IntervalPair, stale_count + touched_count);
+	uint64_t i = 0;
+	uint64_t j = 0;
+	while(i < stale_count || j < touched_count) {
+		if(j == touched_count || (i < stale_count && INTERVAL_PAIR_LT(idx->stale + i, touched + j))) {
+			stale = array_append(stale, idx->stale[i++]);
+		} else {
+			if(i < stale_count && !INTERVAL_PAIR_LT(touched + j, idx->stale + i)) i++;
+			stale = array_append(stale, touched[j++]);
+		}
+	}
+	array_free(idx->stale);
+	idx->stale = stale;
+
+	if(array_len(stale) * INTERVAL_STALE_RATIO > array_len(idx->entries) &&
+	   array_len(stale) > INTERVAL_STALE_MIN) {
+		_IntervalIndex_Clear(idx);
+		_IntervalIndex_Build(idx, g, relation, from, to);
+		return;
+	}
+
+	// Drop the pending entries of the written pairs, then reread the pairs' edges.
+	uint64_t pending_count = array_len(idx->pending);
+	uint64_t kept = 0;
+	for(uint64_t k = 0; k < pending_count; k++) {
+		const IntervalEntry *entry = idx->pending + k;
+		if(_IntervalIndex_ContainsPair(touched, touched_count, entry->src, entry->dest)) continue;
+		idx->pending[kept++] = *entry;
+	}
+	idx->pending = array_trimm_len(idx->pending, kept);
+
+	Edge *edges = array_new(Edge, 1);
+	for(uint64_t k = 0; k < touched_count; k++) {
+		NodeID src = touched[k].src;
+		NodeID dest = touched[k].dest;
+		array_clear(edges);
+		Graph_GetEdgesConnectingNodes(g, src, dest, relation, &edges);
+		uint edge_count = array_len(edges);
+		for(uint n = 0; n < edge_count; n++) {
+			_IntervalIndex_Append(&idx->pending, edges + n, from, to, src, dest);
+		}
+	}
+	array_free(edges);
+	array_clear(idx->touched);
+
+	// Edges valid at the cached time may have changed.
+	if(idx->valid) array_free(idx->valid);
+	idx->valid = NULL;
+}
+
+/* Appends the entries of the subtree spanning [lo, hi) which are valid at time t,
+ * subtrees ending no later than t are skipped, as are entries starting past t. */
+static void _IntervalIndex_Stab(const IntervalIndex *idx, uint64_t lo, uint64_t hi, int64_t t,
+								IntervalEntry **valid) {
+	while(lo < hi) {
+		uint64_t mid = lo + (hi - lo) / 2;
+		if(idx->max_to[mid] <= t) return;
+		_IntervalIndex_Stab(idx, lo, mid, t, valid);
+		const IntervalEntry *entry = idx->entries + mid;
+		if(entry->from > t) return;
+		// Entries of stale pairs are superseded by pending entries.
+		if(entry->to > t && !_IntervalIndex_ContainsPair(idx->stale, array_len(idx->stale),
+														 entry->src, entry->dest)) {
+			*valid = array_append(*valid, *entry);
+		}
+		lo = mid + 1;
+	}
+}
+
+IntervalIndex *IntervalIndex_New(const char *from_attribute, const char *to_attribute) {
+	assert(from_attribute && to_attribute);
+	IntervalIndex *idx = rm_malloc(sizeof(IntervalIndex));
+	idx->from_attribute = rm_strdup(from_attribute);
+	idx->to_attribute = rm_strdup(to_attribute);
+	idx->from = ATTRIBUTE_NOTFOUND;
+	idx->to = ATTRIBUTE_NOTFOUND;
+	idx->entries = NULL;
+	idx->max_to = NULL;
+	idx->touched = array_new(IntervalPair, 0);
+	idx->stale = array_new(IntervalPair, 0);
+	idx->pending = array_new(IntervalEntry, 0);
+	idx->valid = NULL;
+	idx->asof = 0;
+	int res = pthread_mutex_init(&idx->lock, NULL);
+	assert(res == 0);
+	return idx;
+}
+
+void IntervalIndex_ValidEdges(IntervalIndex *idx, Graph *g, int relation, Attribute_ID from,
+							  Attribute_ID to, NodeID src, int64_t t, IntervalEntry **edges) {
+	assert(idx && g && edges);
+
+	pthread_mutex_lock(&idx->lock);
+
+	_IntervalIndex_Sync(idx, g, relation, from, to);
+
+	if(idx->valid == NULL || idx->asof != t) {
+		if(idx->valid) array_clear(idx->valid);
+		else idx->valid = array_new(IntervalEntry, 32);
+		_IntervalIndex_Stab(idx, 0, array_len(idx->entries), t, &idx->valid);
+		uint64_t pending_count = array_len(idx->pending);
+		for(uint64_t i = 0; i < pending_count; i++) {
+			const IntervalEntry *entry = idx->pending + i;
+			if(entry->from <= t && entry->to > t) idx->valid = array_append(idx->valid, *entry);
+		}
+		QSORT(IntervalEntry, idx->valid, array_len(idx->valid), INTERVAL_SOURCE_LT);
+		idx->asof = t;
+	}
+
+	// Binary search for the first valid edge leaving src.
+	uint64_t lo = 0;
+	uint64_t hi = array_len(idx->valid);
+	while(lo < hi) {
+		uint64_t mid = lo + (hi - lo) / 2;
+		if(idx->valid[mid].src < src) lo = mid + 1;
+		else hi = mid;
+	}
+	uint64_t count = array_len(idx->valid);
+	for(; lo < count && idx->valid[lo].src == src; lo++) {
+		*edges = array_append(*edges, idx->valid[lo]);
+	}
+
+	pthread_mutex_unlock(&idx->lock);
+}
+
+void IntervalIndex_Touch(IntervalIndex *idx, Attribute_ID attr, NodeID src, NodeID dest) {
+	assert(idx);
+	if(attr != ATTRIBUTE_NOTFOUND && attr != idx->from && attr != idx->to) return;
+
+	pthread_mutex_lock(&idx->lock);
+	// Entries which weren't collected yet are collected in full.
+	if(idx->entries) {
+		IntervalPair pair = {src, dest};
+		idx->touched = array_append(idx->touched, pair);
+	}
+	pthread_mutex_unlock(&idx->lock);
+}
+
+void IntervalIndex_Invalidate(IntervalIndex *idx) {
+	assert(idx);
+	pthread_mutex_lock(&idx->lock);
+	_IntervalIndex_Clear(idx);
+	pthread_mutex_unlock(&idx->lock);
+}
+
+void IntervalIndex_Free(IntervalIndex *idx) {
+	if(idx == NULL) return;
+	_IntervalIndex_Clear(idx);
+	array_free(idx->touched);
+	array_free(idx->stale);
+	array_free(idx->pending);
+	rm_free(idx->from_attribute);
+	rm_free(idx->to_attribute);
+	pthread_mutex_destroy(&idx->lock);
+	rm_free(idx);
+}
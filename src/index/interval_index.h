@@ -0,0 +1,73 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "../graph/graph.h"
+
+// An edge valid throughout [from, to).
+typedef struct {
+	int64_t from;   // Start of the validity interval, inclusive.
+	int64_t to;     // End of the validity interval, exclusive.
+	NodeID src;     // Source node ID.
+	NodeID dest;    // Destination node ID.
+	EdgeID id;      // Edge ID.
+} IntervalEntry;
+
+// A pair of nodes connected by edges of the relation.
+typedef struct {
+	NodeID src;     // Source node ID.
+	NodeID dest;    // Destination node ID.
+} IntervalPair;
+
+/* Validity intervals of the edges of a relation, read from a pair of attributes
+ * holding millisecond timestamps, edges lacking a numeric bound are unbounded on that side.
+ * Entries are ordered by interval start and form an implicit balanced search tree,
+ * each subtree annotated with its latest interval end, such that the k edges valid
+ * at a given time are found in O(k log n) without fetching edge properties.
+ * Edges valid at the most recently requested time are kept ordered by source,
+ * such that traversals from many sources at the same time share a single lookup.
+ * Entries are collected on demand and outlive writes, writers note the pairs whose
+ * edges they created, deleted or retimed, and the next lookup supersedes the entries
+ * of these pairs with pending entries read from the pairs' current edges.
+ * Once superseded pairs amount to a fraction of the entries, entries are recollected. */
+typedef struct IntervalIndex {
+	char *from_attribute;   // Attribute holding the start of each edge's validity interval.
+	char *to_attribute;     // Attribute holding the end of each edge's validity interval.
+	Attribute_ID from;      // ID of from_attribute entries were collected by.
+	Attribute_ID to;        // ID of to_attribute entries were collected by.
+	IntervalEntry *entries; // Edges ordered by interval start, NULL until collected.
+	int64_t *max_to;        // Latest interval end within the subtree rooted at each entry.
+	IntervalPair *touched;  // Pairs written since the last lookup.
+	IntervalPair *stale;    // Pairs whose entries are superseded, ordered.
+	IntervalEntry *pending; // Current edges of the stale pairs, unordered.
+	IntervalEntry *valid;   // Edges valid at time asof ordered by source, NULL if not cached.
+	int64_t asof;           // Time the valid edges were looked up at.
+	pthread_mutex_t lock;   // Guards entries, concurrent readers may collect entries.
+} IntervalIndex;
+
+// Create an interval index over the given pair of attributes, entries are collected on demand.
+IntervalIndex *IntervalIndex_New(const char *from_attribute, const char *to_attribute);
+
+/* Appends to edges the edges of relation leaving src which are valid at time t,
+ * ordered by destination, collecting the relation's entries if required.
+ * Caller is expected to hold the graph's read lock. */
+void IntervalIndex_ValidEdges(IntervalIndex *idx, Graph *g, int relation, Attribute_ID from,
+							  Attribute_ID to, NodeID src, int64_t t, IntervalEntry **edges);
+
+/* Note the edges of the pair src, dest were written, attr is the attribute written,
+ * ATTRIBUTE_NOTFOUND if edges were created or deleted. Expects the write lock. */
+void IntervalIndex_Touch(IntervalIndex *idx, Attribute_ID attr, NodeID src, NodeID dest);
+
+/* Drop collected entries, to be recollected by the next lookup.
+ * Required once edges are written in bulk or entities are renumbered. */
+void IntervalIndex_Invalidate(IntervalIndex *idx);
+
+// Free interval index.
+void IntervalIndex_Free(IntervalIndex *idx);
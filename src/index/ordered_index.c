@@ -0,0 +1,771 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "ordered_index.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../util/rax_extensions.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+// Entry type tags, numerics and booleans share a tag as booleans are indexed as numerics.
+#define KEY_NUMERIC 1
+#define KEY_STRING 2
+#define KEY_POINT 3
+
+/* Points are encoded as their geohash, latitude and longitude quantized to 32 bits
+ * and interleaved, followed by their exact coordinates, such that points
+ * within a geohash cell are adjacent. */
+#define GEOHASH_STEPS 32
+#define POINT_LEN (sizeof(uint64_t) + 2 * sizeof(float))
+
+// Attribute ID followed by type tag.
+#define KEY_PREFIX_LEN (sizeof(Attribute_ID) + 1)
+
+/* Composite keys start with an attribute ID no attribute is assigned,
+ * followed by the composite index ID. */
+#define TUPLE_HEADER_LEN (sizeof(Attribute_ID) + sizeof(uint16_t))
+
+// Ends a composite key's values, ordering keys of fewer values first.
+#define TUPLE_END 0
+
+// Integers beyond 2^53 aren't restored exactly from their double encoding.
+#define KEY_MAX_EXACT_INT (1LL << 53)
+
+// Flags a node key's length, set for keys of boolean values.
+#define NODE_KEY_BOOLEAN (1U << 31)
+
+// Keys a node is indexed under, each preceded by its length.
+typedef struct {
+	uint32_t len;           // Number of bytes used.
+	unsigned char data[];   // Length prefixed keys.
+} _NodeKeys;
+
+static inline void _EncodeUInt64(unsigned char *buf, uint64_t v) {
+	for(int i = 7; i >= 0; i--) {
+		buf[i] = v & 0xFF;
+		v >>= 8;
+	}
+}
+
+static inline uint64_t _DecodeUInt64(const unsigned char *buf) {
+	uint64_t v = 0;
+	for(int i = 0; i < 8; i++) v = (v << 8) | buf[i];
+	return v;
+}
+
+/* Encode d such that the byte order of encoded values matches the order of values,
+ * positive values have their sign bit flipped, negative values have all bits flipped. */
+static inline void _EncodeDouble(unsigned char *buf, double d) {
+	if(d == 0) d = 0; // -0 and 0 are equal.
+	uint64_t bits;
+	memcpy(&bits, &d, sizeof(bits));
+	bits = (bits >> 63) ? ~bits : bits | (1ULL << 63);
+	_EncodeUInt64(buf, bits);
+}
+
+// Inverse of _EncodeDouble.
+static inline double _DecodeDouble(const unsigned char *buf) {
+	uint64_t bits = _DecodeUInt64(buf);
+	bits = (bits >> 63) ? bits & ~(1ULL << 63) : ~bits;
+	double d;
+	memcpy(&d, &bits, sizeof(d));
+	return d;
+}
+
+// Quantize coordinate within [min, max] to GEOHASH_STEPS bits.
+static inline uint64_t _QuantizeCoordinate(double v, double min, double max) {
+	double scaled = (v - min) / (max - min) * (double)(1ULL << GEOHASH_STEPS);
+	if(scaled < 0) return 0;
+	if(scaled >= (double)(1ULL << GEOHASH_STEPS)) return (1ULL << GEOHASH_STEPS) - 1;
+	return (uint64_t)scaled;
+}
+
+// Spread the lower 32 bits of v to the even bits of the result.
+static inline uint64_t _Spread(uint64_t v) {
+	v &= 0xFFFFFFFFULL;
+	v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+	v = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+	v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	v = (v | (v << 2)) & 0x3333333333333333ULL;
+	v = (v | (v << 1)) & 0x5555555555555555ULL;
+	return v;
+}
+
+// Interleave quantized coordinates, longitude bits lead.
+static inline uint64_t _Geohash(uint64_t lat, uint64_t lon) {
+	return (_Spread(lon) << 1) | _Spread(lat);
+}
+
+static inline void _EncodePoint(unsigned char *buf, SIValue v) {
+	// -0 and 0 are equal.
+	float coords[2] = {v.point.latitude + 0.0f, v.point.longitude + 0.0f};
+	uint64_t lat = _QuantizeCoordinate(coords[0], -90, 90);
+	uint64_t lon = _QuantizeCoordinate(coords[1], -180, 180);
+	_EncodeUInt64(buf, _Geohash(lat, lon));
+	for(int i = 0; i < 2; i++) {
+		uint32_t bits;
+		memcpy(&bits, coords + i, sizeof(bits));
+		unsigned char *dst = buf + sizeof(uint64_t) + i * sizeof(float);
+		dst[0] = bits >> 24;
+		dst[1] = (bits >> 16) & 0xFF;
+		dst[2] = (bits >> 8) & 0xFF;
+		dst[3] = bits & 0xFF;
+	}
+}
+
+// Inverse of _EncodePoint.
+static inline SIValue _DecodePoint(const unsigned char *buf) {
+	float coords[2];
+	for(int i = 0; i < 2; i++) {
+		const unsigned char *src = buf + sizeof(uint64_t) + i * sizeof(float);
+		uint32_t bits = ((uint32_t)src[0] << 24) | ((uint32_t)src[1] << 16) |
+						((uint32_t)src[2] << 8) | src[3];
+		memcpy(coords + i, &bits, sizeof(bits));
+	}
+	return SI_Point(coords[0], coords[1]);
+}
+
+/* Returns the type tag of v and sets the length of its encoding,
+ * returns 0 if v can't be indexed. */
+static inline unsigned char _ValueType(SIValue v, size_t *len) {
+	if(SI_TYPE(v) == T_STRING) {
+		*len = strlen(v.stringval) + 1; // Terminator orders prefixes first.
+		return KEY_STRING;
+	} else if(SI_TYPE(v) & (SI_NUMERIC | T_BOOL)) {
+		*len = sizeof(double);
+		return KEY_NUMERIC;
+	} else if(SI_TYPE(v) == T_POINT) {
+		*len = POINT_LEN;
+		return KEY_POINT;
+	}
+	return 0;
+}
+
+static inline void _EncodeValue(unsigned char *buf, unsigned char type, SIValue v, size_t len) {
+	if(type == KEY_STRING) memcpy(buf, v.stringval, len);
+	else if(type == KEY_POINT) _EncodePoint(buf, v);
+	else _EncodeDouble(buf, SI_GET_NUMERIC(v));
+}
+
+/* Build key prefix followed by the encoded value, allocating extra bytes past the key.
+ * Returns NULL if value can't be indexed. */
+static unsigned char *_BuildKey(Attribute_ID attr, SIValue v, size_t extra, size_t *len) {
+	size_t value_len;
+	unsigned char type = _ValueType(v, &value_len);
+	if(type == 0) return NULL;
+
+	*len = KEY_PREFIX_LEN + value_len;
+	unsigned char *key = rm_malloc(*len + extra);
+	key[0] = attr >> 8;
+	key[1] = attr & 0xFF;
+	key[2] = type;
+	_EncodeValue(key + KEY_PREFIX_LEN, type, v, value_len);
+	return key;
+}
+
+/* Build composite key header followed by each value's type tag and encoding,
+ * allocating extra bytes past the key. Returns NULL if a value can't be indexed. */
+static unsigned char *_BuildTupleKey(uint16_t composite, const SIValue *values, uint count,
+									 size_t extra, size_t *len) {
+	*len = TUPLE_HEADER_LEN;
+	for(uint i = 0; i < count; i++) {
+		size_t value_len;
+		if(_ValueType(values[i], &value_len) == 0) return NULL;
+		*len += 1 + value_len;
+	}
+
+	unsigned char *key = rm_malloc(*len + extra);
+	key[0] = ATTRIBUTE_NOTFOUND >> 8;
+	key[1] = ATTRIBUTE_NOTFOUND & 0xFF;
+	key[2] = composite >> 8;
+	key[3] = composite & 0xFF;
+	size_t offset = TUPLE_HEADER_LEN;
+	for(uint i = 0; i < count; i++) {
+		size_t value_len;
+		unsigned char type = _ValueType(values[i], &value_len);
+		key[offset++] = type;
+		_EncodeValue(key + offset, type, values[i], value_len);
+		offset += value_len;
+	}
+	return key;
+}
+
+static unsigned char *_BuildPrefix(Attribute_ID attr, unsigned char type) {
+	unsigned char *prefix = rm_malloc(KEY_PREFIX_LEN);
+	prefix[0] = attr >> 8;
+	prefix[1] = attr & 0xFF;
+	prefix[2] = type;
+	return prefix;
+}
+
+static inline int _CompareKeys(const unsigned char *a, size_t a_len, const unsigned char *b,
+							   size_t b_len) {
+	int c = memcmp(a, b, (a_len < b_len) ? a_len : b_len);
+	if(c != 0) return c;
+	return (a_len > b_len) - (a_len < b_len);
+}
+
+// Length of the data following an entry's value, the entity ID and edge endpoints.
+static inline size_t _SuffixLen(const OrderedIndex *idx) {
+	return (idx->edges) ? 3 * sizeof(NodeID) : sizeof(NodeID);
+}
+
+OrderedIndex *OrderedIndex_New(void) {
+	OrderedIndex *idx = rm_malloc(sizeof(OrderedIndex));
+	idx->entries = raxNew();
+	idx->nodes = raxNew();
+	idx->counts = array_new(uint64_t, 0);
+	idx->booleans = array_new(uint64_t, 0);
+	idx->version = 0;
+	idx->key_bytes = 0;
+	idx->edges = false;
+	return idx;
+}
+
+OrderedIndex *OrderedIndex_NewEdgeIndex(void) {
+	OrderedIndex *idx = OrderedIndex_New();
+	idx->edges = true;
+	return idx;
+}
+
+// Attribute an entry key belongs to, ATTRIBUTE_NOTFOUND for composite keys.
+static inline Attribute_ID _KeyAttribute(const unsigned char *key) {
+	return (key[0] << 8) | key[1];
+}
+
+/* Account for an added or removed entry of a single attribute,
+ * points are left uncounted as they aren't iterated in value order. */
+static void _OrderedIndex_Count(OrderedIndex *idx, const unsigned char *key, bool boolean,
+								int delta) {
+	Attribute_ID attr = _KeyAttribute(key);
+	if(attr == ATTRIBUTE_NOTFOUND || key[2] == KEY_POINT) return;
+	while(array_len(idx->counts) <= attr) {
+		idx->counts = array_append(idx->counts, 0);
+		idx->booleans = array_append(idx->booleans, 0);
+	}
+	idx->counts[attr] += delta;
+	if(boolean) idx->booleans[attr] += delta;
+}
+
+/* Type of v as restored from its entry, T_NULL if v can't be restored exactly,
+ * the entry then only orders v. */
+static SIType _CoveredType(SIValue v) {
+	SIType t = SI_TYPE(v);
+	if(t == T_INT64 && llabs(v.longval) > KEY_MAX_EXACT_INT) return T_NULL;
+	// -0 is indexed as 0.
+	if(t == T_DOUBLE && v.doubleval == 0 && signbit(v.doubleval)) return T_NULL;
+	if(t == T_POINT && ((v.point.latitude == 0 && signbit(v.point.latitude)) ||
+						(v.point.longitude == 0 && signbit(v.point.longitude)))) return T_NULL;
+	return t;
+}
+
+/* Add entry key, which is followed by room for the entity ID
+ * and for edge indices, the edge endpoints.
+ * The entry's data holds the type its value is restored as, NULL if it can't be. */
+static void _OrderedIndex_AddEntry(OrderedIndex *idx, NodeID id, const NodeID *endpoints,
+								   unsigned char *key, size_t len, SIType covered) {
+	bool boolean = (covered == T_BOOL);
+	void *data = (covered == T_NULL) ? NULL : (void *)(uintptr_t)covered;
+	_EncodeUInt64(key + len, id);
+	len += sizeof(NodeID);
+	if(idx->edges) {
+		_EncodeUInt64(key + len, endpoints[0]);
+		_EncodeUInt64(key + len + sizeof(NodeID), endpoints[1]);
+		len += 2 * sizeof(NodeID);
+	}
+	if(raxInsert(idx->entries, key, len, data, NULL)) _OrderedIndex_Count(idx, key, boolean, 1);
+	idx->version++;
+
+	// Track key such that the node's entries can be removed.
+	unsigned char node_key[sizeof(NodeID)];
+	_EncodeUInt64(node_key, id);
+	_NodeKeys *keys = raxFind(idx->nodes, node_key, sizeof(node_key));
+	if(keys == raxNotFound) keys = NULL;
+	uint32_t used = (keys) ? keys->len : 0;
+	uint32_t flagged_len = (boolean) ? (len | NODE_KEY_BOOLEAN) : len;
+	_NodeKeys *grown = rm_realloc(keys, sizeof(_NodeKeys) + used + sizeof(uint32_t) + len);
+	idx->key_bytes += ((keys) ? 0 : sizeof(_NodeKeys)) + sizeof(uint32_t) + len;
+	grown->len = used + sizeof(uint32_t) + len;
+	memcpy(grown->data + used, &flagged_len, sizeof(uint32_t));
+	memcpy(grown->data + used + sizeof(uint32_t), key, len);
+	if(grown != keys) raxInsert(idx->nodes, node_key, sizeof(node_key), grown, NULL);
+}
+
+void OrderedIndex_Insert(OrderedIndex *idx, NodeID id, Attribute_ID attr, SIValue v) {
+	assert(idx && !idx->edges);
+
+	size_t len;
+	unsigned char *key = _BuildKey(attr, v, sizeof(NodeID), &len);
+	if(key == NULL) return; // Value can't be indexed.
+
+	_OrderedIndex_AddEntry(idx, id, NULL, key, len, _CoveredType(v));
+	rm_free(key);
+}
+
+void OrderedIndex_InsertEdge(OrderedIndex *idx, EdgeID id, NodeID src, NodeID dest,
+							 Attribute_ID attr, SIValue v) {
+	assert(idx && idx->edges);
+
+	size_t len;
+	unsigned char *key = _BuildKey(attr, v, _SuffixLen(idx), &len);
+	if(key == NULL) return; // Value can't be indexed.
+
+	NodeID endpoints[2] = {src, dest};
+	_OrderedIndex_AddEntry(idx, id, endpoints, key, len, _CoveredType(v));
+	rm_free(key);
+}
+
+void OrderedIndex_InsertTuple(OrderedIndex *idx, NodeID id, uint16_t composite,
+							  const SIValue *values, uint count) {
+	assert(idx && !idx->edges && count > 0);
+
+	size_t len;
+	unsigned char *key = _BuildTupleKey(composite, values, count, 1 + sizeof(NodeID), &len);
+	if(key == NULL) return; // Value can't be indexed.
+
+	key[len++] = TUPLE_END;
+	_OrderedIndex_AddEntry(idx, id, NULL, key, len, T_NULL);
+	rm_free(key);
+}
+
+void OrderedIndex_RemoveNode(OrderedIndex *idx, NodeID id) {
+	assert(idx);
+
+	unsigned char node_key[sizeof(NodeID)];
+	_EncodeUInt64(node_key, id);
+	_NodeKeys *keys = NULL;
+	if(!raxRemove(idx->nodes, node_key, sizeof(node_key), (void **)&keys)) return;
+
+	uint32_t offset = 0;
+	while(offset < keys->len) {
+		uint32_t len;
+		memcpy(&len, keys->data + offset, sizeof(uint32_t));
+		offset += sizeof(uint32_t);
+		bool boolean = (len & NODE_KEY_BOOLEAN);
+		len &= ~NODE_KEY_BOOLEAN;
+		const unsigned char *key = keys->data + offset;
+		if(raxRemove(idx->entries, (unsigned char *)key, len, NULL)) {
+			_OrderedIndex_Count(idx, key, boolean, -1);
+		}
+		offset += len;
+	}
+	idx->version++;
+	idx->key_bytes -= sizeof(_NodeKeys) + keys->len;
+	rm_free(keys);
+}
+
+void OrderedIndex_RemoveAttribute(OrderedIndex *idx, Attribute_ID attr) {
+	assert(idx);
+
+	unsigned char prefix[sizeof(Attribute_ID)] = {attr >> 8, attr & 0xFF};
+	unsigned char **keys = array_new(unsigned char *, 0);
+	size_t *lens = array_new(size_t, 0);
+
+	// Collect attribute entries, the rax can't be modified while iterated.
+	raxIterator it;
+	raxStart(&it, idx->entries);
+	raxSeek(&it, ">=", prefix, sizeof(prefix));
+	while(raxNext(&it)) {
+		if(it.key_len < sizeof(prefix) || memcmp(it.key, prefix, sizeof(prefix)) != 0) break;
+		unsigned char *key = rm_malloc(it.key_len);
+		memcpy(key, it.key, it.key_len);
+		keys = array_append(keys, key);
+		lens = array_append(lens, it.key_len);
+	}
+	raxStop(&it);
+
+	// Entries remain listed under their nodes, removing them again is a no-op.
+	uint count = array_len(keys);
+	for(uint i = 0; i < count; i++) {
+		raxRemove(idx->entries, keys[i], lens[i], NULL);
+		rm_free(keys[i]);
+	}
+	if(count > 0) idx->version++;
+	if(attr < array_len(idx->counts)) {
+		idx->counts[attr] = 0;
+		idx->booleans[attr] = 0;
+	}
+
+	array_free(keys);
+	array_free(lens);
+}
+
+uint64_t OrderedIndex_EntryCount(const OrderedIndex *idx) {
+	assert(idx);
+	return raxSize(idx->entries);
+}
+
+size_t OrderedIndex_MemoryUsage(const OrderedIndex *idx) {
+	assert(idx);
+	return sizeof(OrderedIndex) + raxMemoryUsage(idx->entries) + raxMemoryUsage(idx->nodes) +
+		   idx->key_bytes + array_sizeof(array_hdr(idx->counts)) +
+		   array_sizeof(array_hdr(idx->booleans));
+}
+
+uint64_t OrderedIndex_AttributeEntryCount(const OrderedIndex *idx, Attribute_ID attr,
+										  uint64_t *booleans) {
+	assert(idx && booleans);
+	if(attr >= array_len(idx->counts)) {
+		*booleans = 0;
+		return 0;
+	}
+	*booleans = idx->booleans[attr];
+	return idx->counts[attr];
+}
+
+bool OrderedIndex_Lookup(const OrderedIndex *idx, Attribute_ID attr, SIValue v, NodeID exclude,
+						 NodeID *id) {
+	assert(idx && id);
+
+	size_t len;
+	unsigned char *key = _BuildKey(attr, v, 0, &len);
+	if(key == NULL) return false; // Value can't be indexed.
+
+	bool found = false;
+	size_t suffix_len = _SuffixLen(idx);
+	raxIterator it;
+	raxStart(&it, idx->entries);
+	raxSeek(&it, ">=", key, len);
+	while(!found && raxNext(&it)) {
+		// Entries of the value are adjacent, stop once past them.
+		if(it.key_len != len + suffix_len || memcmp(it.key, key, len) != 0) break;
+		*id = _DecodeUInt64(it.key + len);
+		found = (*id != exclude);
+	}
+	raxStop(&it);
+	rm_free(key);
+	return found;
+}
+
+bool OrderedIndex_HasDuplicates(const OrderedIndex *idx, Attribute_ID attr) {
+	assert(idx);
+
+	unsigned char prefix[sizeof(Attribute_ID)] = {attr >> 8, attr & 0xFF};
+	size_t suffix_len = _SuffixLen(idx);
+	unsigned char *prev = NULL;
+	size_t prev_len = 0;
+	bool duplicates = false;
+
+	// Entries are ordered by value, equal values are adjacent.
+	raxIterator it;
+	raxStart(&it, idx->entries);
+	raxSeek(&it, ">=", prefix, sizeof(prefix));
+	while(!duplicates && raxNext(&it)) {
+		if(it.key_len < sizeof(prefix) || memcmp(it.key, prefix, sizeof(prefix)) != 0) break;
+		size_t value_len = it.key_len - suffix_len;
+		duplicates = (prev && _CompareKeys(prev, prev_len, it.key, value_len) == 0);
+		prev = rm_realloc(prev, value_len);
+		memcpy(prev, it.key, value_len);
+		prev_len = value_len;
+	}
+	raxStop(&it);
+	if(prev) rm_free(prev);
+	return duplicates;
+}
+
+static OrderedIndexIter *_OrderedIndexIter_New(const OrderedIndex *idx, unsigned char *min,
+											   size_t min_len, bool include_min, unsigned char *max, size_t max_len,
+											   bool include_max) {
+	OrderedIndexIter *iter = rm_malloc(sizeof(OrderedIndexIter));
+	iter->idx = idx;
+	iter->min = min;
+	iter->min_len = min_len;
+	iter->include_min = include_min;
+	iter->max = max;
+	iter->max_len = max_len;
+	iter->include_max = include_max;
+	iter->prefix_len = KEY_PREFIX_LEN;
+	iter->last = NULL;
+	iter->last_len = 0;
+	iter->last_cap = 0;
+	iter->version = 0;
+	iter->started = false;
+	iter->depleted = false;
+	iter->reverse = false;
+	iter->covered = T_NULL;
+	raxStart(&iter->it, idx->entries);
+	return iter;
+}
+
+OrderedIndexIter *OrderedIndex_IterateNumericRange(const OrderedIndex *idx, Attribute_ID attr,
+												   const NumericRange *range) {
+	assert(idx && range);
+
+	size_t min_len = KEY_PREFIX_LEN;
+	size_t max_len = 0;
+	unsigned char *min = NULL;
+	unsigned char *max = NULL;
+	bool include_min = range->include_min;
+
+	if(range->min == -INFINITY) {
+		min = _BuildPrefix(attr, KEY_NUMERIC);
+		include_min = true;
+	} else {
+		min = _BuildKey(attr, SI_DoubleVal(range->min), 0, &min_len);
+	}
+	if(range->max != INFINITY) max = _BuildKey(attr, SI_DoubleVal(range->max), 0, &max_len);
+
+	return _OrderedIndexIter_New(idx, min, min_len, include_min, max, max_len, range->include_max);
+}
+
+OrderedIndexIter *OrderedIndex_IterateStringRange(const OrderedIndex *idx, Attribute_ID attr,
+												  const StringRange *range) {
+	assert(idx && range);
+
+	size_t min_len = KEY_PREFIX_LEN;
+	size_t max_len = 0;
+	unsigned char *min = NULL;
+	unsigned char *max = NULL;
+	bool include_min = range->include_min;
+
+	if(range->min == NULL) {
+		min = _BuildPrefix(attr, KEY_STRING);
+		include_min = true;
+	} else {
+		min = _BuildKey(attr, SI_ConstStringVal(range->min), 0, &min_len);
+	}
+	if(range->max) max = _BuildKey(attr, SI_ConstStringVal(range->max), 0, &max_len);
+
+	return _OrderedIndexIter_New(idx, min, min_len, include_min, max, max_len, range->include_max);
+}
+
+OrderedIndexIter *OrderedIndex_IterateAttribute(const OrderedIndex *idx, Attribute_ID attr,
+												SIType t, bool reverse) {
+	assert(idx && (t == T_STRING || t & SI_NUMERIC));
+
+	unsigned char type = (t == T_STRING) ? KEY_STRING : KEY_NUMERIC;
+	OrderedIndexIter *iter = _OrderedIndexIter_New(idx, _BuildPrefix(attr, type), KEY_PREFIX_LEN,
+												   true, NULL, 0, false);
+	iter->reverse = reverse;
+	return iter;
+}
+
+OrderedIndexIter **OrderedIndex_IteratePointBox(const OrderedIndex *idx, Attribute_ID attr,
+												 const PointBox *box) {
+	assert(idx && box && box->min_lat <= box->max_lat && box->min_lon <= box->max_lon);
+
+	uint64_t min_lat = _QuantizeCoordinate(box->min_lat, -90, 90);
+	uint64_t max_lat = _QuantizeCoordinate(box->max_lat, -90, 90);
+	uint64_t min_lon = _QuantizeCoordinate(box->min_lon, -180, 180);
+	uint64_t max_lon = _QuantizeCoordinate(box->max_lon, -180, 180);
+
+	// Finest cells such that the box spans at most two cells along each axis.
+	uint steps = GEOHASH_STEPS;
+	while(steps > 0) {
+		uint shift = GEOHASH_STEPS - steps;
+		if((max_lat >> shift) - (min_lat >> shift) <= 1 &&
+		   (max_lon >> shift) - (min_lon >> shift) <= 1) break;
+		steps--;
+	}
+
+	// Each cell is a contiguous geohash range.
+	uint shift = GEOHASH_STEPS - steps;
+	uint free_bits = 2 * shift;
+	uint64_t span = (free_bits == 64) ? ~0ULL : (1ULL << free_bits) - 1;
+	OrderedIndexIter **iters = array_new(OrderedIndexIter *, 4);
+	for(uint64_t lat = min_lat >> shift; lat <= max_lat >> shift; lat++) {
+		for(uint64_t lon = min_lon >> shift; lon <= max_lon >> shift; lon++) {
+			uint64_t first = (free_bits == 64) ? 0 : _Geohash(lat, lon) << free_bits;
+			size_t min_len = KEY_PREFIX_LEN + sizeof(uint64_t);
+			size_t max_len = KEY_PREFIX_LEN + POINT_LEN;
+			unsigned char *min = rm_malloc(min_len);
+			unsigned char *max = rm_malloc(max_len);
+			min[0] = max[0] = attr >> 8;
+			min[1] = max[1] = attr & 0xFF;
+			min[2] = max[2] = KEY_POINT;
+			_EncodeUInt64(min + KEY_PREFIX_LEN, first);
+			_EncodeUInt64(max + KEY_PREFIX_LEN, first | span);
+			// Bound past the coordinates of the cell's last geohash.
+			memset(max + KEY_PREFIX_LEN + sizeof(uint64_t), 0xFF, 2 * sizeof(float));
+			iters = array_append(iters, _OrderedIndexIter_New(idx, min, min_len, true, max,
+															  max_len, true));
+		}
+	}
+	return iters;
+}
+
+OrderedIndexIter *OrderedIndex_IterateTuplePrefix(const OrderedIndex *idx, uint16_t composite,
+												  const SIValue *values, uint count) {
+	assert(idx && values && count > 0);
+
+	size_t len;
+	unsigned char *prefix = _BuildTupleKey(composite, values, count, 0, &len);
+	assert(prefix && "composite index values must be strings, numerics or booleans");
+
+	OrderedIndexIter *iter = _OrderedIndexIter_New(idx, prefix, len, true, NULL, 0, false);
+	iter->prefix_len = len;
+	return iter;
+}
+
+/* Advance iterator, sets suffix to the entity ID following the entry's value.
+ * Returns false once depleted. */
+static bool _OrderedIndexIter_Next(OrderedIndexIter *iter, const unsigned char **suffix) {
+	if(iter->depleted) return false;
+
+	if(!iter->started) {
+		if(iter->reverse) {
+			// Position past the last entry sharing the prefix.
+			unsigned char end[iter->prefix_len];
+			memcpy(end, iter->min, iter->prefix_len);
+			int i = iter->prefix_len - 1;
+			while(i >= 0 && end[i] == 0xFF) end[i--] = 0;
+			if(i >= 0) {
+				end[i]++;
+				raxSeek(&iter->it, "<", end, iter->prefix_len);
+			} else {
+				raxSeek(&iter->it, "$", NULL, 0);
+			}
+		} else {
+			raxSeek(&iter->it, (iter->include_min) ? ">=" : ">", iter->min, iter->min_len);
+		}
+		iter->version = iter->idx->version;
+		iter->started = true;
+	} else if(iter->version != iter->idx->version) {
+		// Index modified since last call, resume past the last returned entry.
+		raxSeek(&iter->it, (iter->reverse) ? "<" : ">", iter->last, iter->last_len);
+		iter->version = iter->idx->version;
+	}
+
+	size_t suffix_len = _SuffixLen(iter->idx);
+	while((iter->reverse) ? raxPrev(&iter->it) : raxNext(&iter->it)) {
+		const unsigned char *key = iter->it.key;
+		size_t len = iter->it.key_len;
+
+		// Past the attribute and type entries.
+		if(len < iter->prefix_len + suffix_len ||
+		   memcmp(key, iter->min, iter->prefix_len) != 0) break;
+
+		size_t value_len = len - suffix_len;
+		// Exclusive lower bound, skip equal values.
+		if(!iter->include_min &&
+		   _CompareKeys(key, value_len, iter->min, iter->min_len) == 0) continue;
+
+		if(iter->max) {
+			int c = _CompareKeys(key, value_len, iter->max, iter->max_len);
+			if(c > 0 || (c == 0 && !iter->include_max)) break;
+		}
+
+		if(len > iter->last_cap) {
+			iter->last_cap = len;
+			iter->last = rm_realloc(iter->last, len);
+		}
+		memcpy(iter->last, key, len);
+		iter->last_len = len;
+		iter->covered = (iter->it.data) ? (SIType)(uintptr_t)iter->it.data : T_NULL;
+
+		*suffix = iter->last + value_len;
+		return true;
+	}
+
+	iter->depleted = true;
+	return false;
+}
+
+bool OrderedIndexIter_Next(OrderedIndexIter *iter, NodeID *id) {
+	assert(iter && id);
+
+	const unsigned char *suffix;
+	if(!_OrderedIndexIter_Next(iter, &suffix)) return false;
+	*id = _DecodeUInt64(suffix);
+	return true;
+}
+
+bool OrderedIndexIter_SingleValue(const OrderedIndexIter *iter) {
+	assert(iter);
+	return (iter->prefix_len == KEY_PREFIX_LEN && iter->max && iter->include_min &&
+			iter->include_max && iter->min_len == iter->max_len &&
+			memcmp(iter->min, iter->max, iter->min_len) == 0);
+}
+
+bool OrderedIndexIter_SkipTo(OrderedIndexIter *iter, NodeID target, NodeID *id) {
+	assert(iter && id && !iter->reverse && !iter->idx->edges && OrderedIndexIter_SingleValue(iter));
+
+	// Entries of a single value are ordered by ID, position on the value followed by target.
+	unsigned char key[iter->min_len + sizeof(NodeID)];
+	memcpy(key, iter->min, iter->min_len);
+	_EncodeUInt64(key + iter->min_len, target);
+	raxSeek(&iter->it, ">=", key, sizeof(key));
+	iter->version = iter->idx->version;
+	iter->started = true;
+	iter->depleted = false;
+
+	return OrderedIndexIter_Next(iter, id);
+}
+
+bool OrderedIndexIter_NextValue(OrderedIndexIter *iter, NodeID *id, SIValue *v) {
+	assert(iter && id && v && !iter->idx->edges && iter->prefix_len == KEY_PREFIX_LEN);
+
+	const unsigned char *suffix;
+	if(!_OrderedIndexIter_Next(iter, &suffix)) return false;
+	*id = _DecodeUInt64(suffix);
+
+	const unsigned char *value = iter->last + KEY_PREFIX_LEN;
+	switch(iter->covered) {
+	case T_STRING:
+		*v = SI_ConstStringVal((char *)value);
+		break;
+	case T_DOUBLE:
+		*v = SI_DoubleVal(_DecodeDouble(value));
+		break;
+	case T_INT64:
+		*v = SI_LongVal((int64_t)_DecodeDouble(value));
+		break;
+	case T_BOOL:
+		*v = SI_BoolVal(_DecodeDouble(value) != 0);
+		break;
+	case T_POINT:
+		*v = _DecodePoint(value);
+		break;
+	default:
+		*v = SI_NullVal();
+		break;
+	}
+	return true;
+}
+
+Attribute_ID OrderedIndexIter_Attribute(const OrderedIndexIter *iter) {
+	assert(iter);
+	if(iter->prefix_len != KEY_PREFIX_LEN) return ATTRIBUTE_NOTFOUND;
+	return _KeyAttribute(iter->min);
+}
+
+bool OrderedIndexIter_NextEdge(OrderedIndexIter *iter, EdgeID *id, NodeID *src, NodeID *dest) {
+	assert(iter && iter->idx->edges && id && src && dest);
+
+	const unsigned char *suffix;
+	if(!_OrderedIndexIter_Next(iter, &suffix)) return false;
+	*id = _DecodeUInt64(suffix);
+	*src = _DecodeUInt64(suffix + sizeof(NodeID));
+	*dest = _DecodeUInt64(suffix + 2 * sizeof(NodeID));
+	return true;
+}
+
+void OrderedIndexIter_Reset(OrderedIndexIter *iter) {
+	assert(iter);
+	iter->started = false;
+	iter->depleted = false;
+}
+
+void OrderedIndexIter_Free(OrderedIndexIter *iter) {
+	assert(iter);
+	raxStop(&iter->it);
+	rm_free(iter->min);
+	if(iter->max) rm_free(iter->max);
+	if(iter->last) rm_free(iter->last);
+	rm_free(iter);
+}
+
+void OrderedIndex_Free(OrderedIndex *idx) {
+	assert(idx);
+	raxFreeWithCallback(idx->nodes, rm_free);
+	raxFree(idx->entries);
+	array_free(idx->counts);
+	array_free(idx->booleans);
+	rm_free(idx);
+}
@@ -0,0 +1,261 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "rax.h"
+#include "../value.h"
+#include "../graph/entities/node.h"
+#include "../graph/entities/edge.h"
+#include "../util/range/string_range.h"
+#include "../util/range/numeric_range.h"
+#include "../datatypes/point.h"
+
+/* In-process ordered index mapping attribute values to node IDs,
+ * resolving point and range lookups without going through RediSearch.
+ * Entries are rax keys composed of the attribute ID, the value's type,
+ * the value encoded such that byte order matches value order and the node ID,
+ * such that entries of a value are adjacent and ordered by node ID.
+ * Composite entries hold the values of several attributes in order,
+ * such that entries sharing leading values are adjacent.
+ * Entries of an edge index are followed by the edge's endpoints,
+ * such that lookups resolve edges without accessing the relation matrices.
+ * Points are ordered by geohash, such that points within an area are adjacent. */
+typedef struct {
+	rax *entries;       // Ordered (attribute, value, entity ID) keys.
+	rax *nodes;         // Entity ID to the keys the entity is indexed under.
+	uint64_t *counts;   // Number of non-point entries per attribute ID.
+	uint64_t *booleans; // Number of boolean entries per attribute ID.
+	uint64_t version;   // Incremented on each modification.
+	size_t key_bytes;   // Bytes held by the keys listed per entity.
+	bool edges;         // Index entities are edges.
+} OrderedIndex;
+
+typedef struct {
+	const OrderedIndex *idx;    // Iterated index.
+	raxIterator it;             // Position within the index entries.
+	unsigned char *min;         // Lower bound, attribute and type prefix when unbounded.
+	size_t min_len;             // Lower bound length.
+	bool include_min;           // Lower bound is inclusive.
+	unsigned char *max;         // Upper bound, NULL when unbounded.
+	size_t max_len;             // Upper bound length.
+	bool include_max;           // Upper bound is inclusive.
+	size_t prefix_len;          // Length of the attribute and type prefix.
+	unsigned char *last;        // Last entry returned, to resume from once the index changes.
+	size_t last_len;            // Last entry length.
+	size_t last_cap;            // Last entry buffer capacity.
+	uint64_t version;           // Index version the iterator is positioned on.
+	bool started;               // The iterator was positioned.
+	bool depleted;              // No more entries within range.
+	bool reverse;               // Entries are iterated in descending order.
+	SIType covered;             // Type the last entry's value is restored as, T_NULL if it can't be.
+} OrderedIndexIter;
+
+// Create a new, empty ordered index.
+OrderedIndex *OrderedIndex_New(void);
+
+// Create a new, empty ordered index of edges.
+OrderedIndex *OrderedIndex_NewEdgeIndex(void);
+
+// Index node under attr's value, strings, numerics, booleans and points are indexed.
+void OrderedIndex_Insert
+(
+	OrderedIndex *idx,
+	NodeID id,
+	Attribute_ID attr,
+	SIValue v
+);
+
+/* Index edge connecting src to dest under attr's value,
+ * strings, numerics, booleans and points are indexed. */
+void OrderedIndex_InsertEdge
+(
+	OrderedIndex *idx,
+	EdgeID id,
+	NodeID src,
+	NodeID dest,
+	Attribute_ID attr,
+	SIValue v
+);
+
+/* Index node under the leading count values of a composite index,
+ * values must be strings, numerics or booleans. */
+void OrderedIndex_InsertTuple
+(
+	OrderedIndex *idx,
+	NodeID id,
+	uint16_t composite,
+	const SIValue *values,
+	uint count
+);
+
+// Remove every entry of node, or of edge for edge indices.
+void OrderedIndex_RemoveNode
+(
+	OrderedIndex *idx,
+	NodeID id
+);
+
+// Remove every entry of attribute.
+void OrderedIndex_RemoveAttribute
+(
+	OrderedIndex *idx,
+	Attribute_ID attr
+);
+
+// Number of entries in index.
+uint64_t OrderedIndex_EntryCount
+(
+	const OrderedIndex *idx
+);
+
+// Estimated number of bytes held by index.
+size_t OrderedIndex_MemoryUsage
+(
+	const OrderedIndex *idx
+);
+
+/* Sets id to an entity other than exclude indexed under attr's value,
+ * returns false if there's none. */
+bool OrderedIndex_Lookup
+(
+	const OrderedIndex *idx,
+	Attribute_ID attr,
+	SIValue v,
+	NodeID exclude,
+	NodeID *id
+);
+
+/* Number of entries indexing attr values other than points, at most one per entity,
+ * sets booleans to the number of boolean values among them. */
+uint64_t OrderedIndex_AttributeEntryCount
+(
+	const OrderedIndex *idx,
+	Attribute_ID attr,
+	uint64_t *booleans
+);
+
+// Returns true if multiple entities are indexed under an equal attr value.
+bool OrderedIndex_HasDuplicates
+(
+	const OrderedIndex *idx,
+	Attribute_ID attr
+);
+
+// Iterate over nodes whose numeric or boolean attr value is within range.
+OrderedIndexIter *OrderedIndex_IterateNumericRange
+(
+	const OrderedIndex *idx,
+	Attribute_ID attr,
+	const NumericRange *range
+);
+
+// Iterate over nodes whose string attr value is within range.
+OrderedIndexIter *OrderedIndex_IterateStringRange
+(
+	const OrderedIndex *idx,
+	Attribute_ID attr,
+	const StringRange *range
+);
+
+/* Iterate over all nodes indexed under attr values of type t,
+ * strings or numerics, in ascending or descending value order. */
+OrderedIndexIter *OrderedIndex_IterateAttribute
+(
+	const OrderedIndex *idx,
+	Attribute_ID attr,
+	SIType t,
+	bool reverse
+);
+
+/* Iterate over nodes whose point attr value lies within box, returns an array
+ * of iterators, one per geohash cell covering box, which together produce every
+ * such node once. Cells extend past box, their nodes must be filtered. */
+OrderedIndexIter **OrderedIndex_IteratePointBox
+(
+	const OrderedIndex *idx,
+	Attribute_ID attr,
+	const PointBox *box
+);
+
+/* Iterate over nodes indexed by composite whose leading values equal values,
+ * values must be strings, numerics or booleans. */
+OrderedIndexIter *OrderedIndex_IterateTuplePrefix
+(
+	const OrderedIndex *idx,
+	uint16_t composite,
+	const SIValue *values,
+	uint count
+);
+
+/* Advance iterator, returns false once depleted.
+ * Modifications of the index while iterating are tolerated,
+ * iteration resumes past the last returned entry. */
+bool OrderedIndexIter_Next
+(
+	OrderedIndexIter *it,
+	NodeID *id
+);
+
+/* Returns true if iterator spans the entries of a single value,
+ * which are ordered by entity ID. */
+bool OrderedIndexIter_SingleValue
+(
+	const OrderedIndexIter *it
+);
+
+/* Position single value iterator on the first entity whose ID is at least target,
+ * sets id to that entity, returns false if there's none. */
+bool OrderedIndexIter_SkipTo
+(
+	OrderedIndexIter *it,
+	NodeID target,
+	NodeID *id
+);
+
+/* Advance iterator over a single attribute, sets v to the entry's value,
+ * restored from the entry without accessing the entity, and NULL
+ * for values the entry doesn't restore exactly, such as integers beyond 2^53.
+ * String values remain valid until the iterator advances. */
+bool OrderedIndexIter_NextValue
+(
+	OrderedIndexIter *it,
+	NodeID *id,
+	SIValue *v
+);
+
+// Attribute iterated entries index, ATTRIBUTE_NOTFOUND for composite entries.
+Attribute_ID OrderedIndexIter_Attribute
+(
+	const OrderedIndexIter *it
+);
+
+// Advance edge index iterator, returns false once depleted.
+bool OrderedIndexIter_NextEdge
+(
+	OrderedIndexIter *it,
+	EdgeID *id,
+	NodeID *src,
+	NodeID *dest
+);
+
+// Rewind iterator to the start of its range.
+void OrderedIndexIter_Reset
+(
+	OrderedIndexIter *it
+);
+
+// Free iterator.
+void OrderedIndexIter_Free
+(
+	OrderedIndexIter *it
+);
+
+// Free ordered index.
+void OrderedIndex_Free
+(
+	OrderedIndex *idx
+);
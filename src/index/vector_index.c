@@ -0,0 +1,499 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "vector_index.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
+#include "../util/rax_extensions.h"
+#include "../datatypes/array.h"
+#include "../graph/graphcontext.h"
+#include <math.h>
+#include <string.h>
+#include <strings.h>
+#include <assert.h>
+
+/* Distance kernels process 8 components at a time using GCC vector extensions,
+ * which the compiler lowers to the widest SIMD registers the target offers. */
+typedef float v8sf __attribute__((vector_size(8 * sizeof(float))));
+#define LANES (sizeof(v8sf) / sizeof(float))
+
+// A vector and its distance to the vector searched for.
+typedef struct {
+	float dist;
+	uint32_t slot;
+} Candidate;
+
+#define CANDIDATE_LT(a, b) ((a)->dist < (b)->dist)
+
+//------------------------------------------------------------------------------
+// Distance kernels
+//------------------------------------------------------------------------------
+
+static inline v8sf _Load(const float *p) {
+	v8sf v;
+	memcpy(&v, p, sizeof(v)); // Unaligned load.
+	return v;
+}
+
+static inline float _Sum(const v8sf *v) {
+	float sum = 0;
+	for(uint i = 0; i < LANES; i++) sum += (*v)[i];
+	return sum;
+}
+
+// Squared euclidean distance.
+static float _L2(const float *a, const float *b, uint32_t dim) {
+	v8sf acc = {0};
+	uint32_t i = 0;
+	for(; i + LANES <= dim; i += LANES) {
+		v8sf d = _Load(a + i) - _Load(b + i);
+		acc += d * d;
+	}
+	float sum = _Sum(&acc);
+	for(; i < dim; i++) sum += (a[i] - b[i]) * (a[i] - b[i]);
+	return sum;
+}
+
+static float _Dot(const float *a, const float *b, uint32_t dim) {
+	v8sf acc = {0};
+	uint32_t i = 0;
+	for(; i + LANES <= dim; i += LANES) acc += _Load(a + i) * _Load(b + i);
+	float sum = _Sum(&acc);
+	for(; i < dim; i++) sum += a[i] * b[i];
+	return sum;
+}
+
+// Scales vec to unit length, returns false for zero vectors.
+static bool _Normalize(float *vec, uint32_t dim) {
+	float norm = sqrtf(_Dot(vec, vec, dim));
+	if(norm == 0 || !isfinite(norm)) return false;
+	for(uint32_t i = 0; i < dim; i++) vec[i] /= norm;
+	return true;
+}
+
+// Distance used for ranking, cosine vectors are normalized.
+static inline float _Distance(const VectorIndex *idx, const float *a, const float *b) {
+	if(idx->metric == VECTOR_METRIC_COSINE) return 1 - _Dot(a, b, idx->dim);
+	return _L2(a, b, idx->dim);
+}
+
+static inline const float *_Vector(const VectorIndex *idx, uint32_t slot) {
+	return idx->vectors + (size_t)slot * idx->dim;
+}
+
+//------------------------------------------------------------------------------
+// Candidate heaps
+//------------------------------------------------------------------------------
+
+// Heaps are ordered by ascending distance, or descending when max is set.
+static inline bool _HeapBefore(const Candidate *a, const Candidate *b, bool max) {
+	return max ? (a->dist > b->dist) : (a->dist < b->dist);
+}
+
+static Candidate *_HeapPush(Candidate *heap, Candidate c, bool max) {
+	heap = array_append(heap, c);
+	uint32_t i = array_len(heap) - 1;
+	while(i > 0) {
+		uint32_t parent = (i - 1) / 2;
+		if(!_HeapBefore(heap + i, heap + parent, max)) break;
+		Candidate tmp = heap[i];
+		heap[i] = heap[parent];
+		heap[parent] = tmp;
+		i = parent;
+	}
+	return heap;
+}
+
+static Candidate _HeapPop(Candidate *heap, bool max) {
+	Candidate top = heap[0];
+	Candidate last = array_pop(heap);
+	uint32_t len = array_len(heap);
+	if(len == 0) return top;
+
+	heap[0] = last;
+	uint32_t i = 0;
+	while(true) {
+		uint32_t first = i;
+		uint32_t l = 2 * i + 1;
+		uint32_t r = l + 1;
+		if(l < len && _HeapBefore(heap + l, heap + first, max)) first = l;
+		if(r < len && _HeapBefore(heap + r, heap + first, max)) first = r;
+		if(first == i) break;
+		Candidate tmp = heap[i];
+		heap[i] = heap[first];
+		heap[first] = tmp;
+		i = first;
+	}
+	return top;
+}
+
+//------------------------------------------------------------------------------
+// Graph levels
+//------------------------------------------------------------------------------
+
+static inline uint32_t _MaxLinks(int level) {
+	return (level == 0) ? VECTOR_INDEX_M0 : VECTOR_INDEX_M;
+}
+
+/* Neighbor list of slot on level, its first element is the number of neighbors.
+ * The bottom level list is followed by the lists of upper levels. */
+static inline uint32_t *_Links(const VectorIndex *idx, uint32_t slot, int level) {
+	size_t offset = (level == 0) ? 0 :
+					(VECTOR_INDEX_M0 + 1) + (size_t)(level - 1) * (VECTOR_INDEX_M + 1);
+	return idx->links[slot] + offset;
+}
+
+// Draws a level from an exponentially decaying distribution.
+static int _RandomLevel(VectorIndex *idx) {
+	// xorshift64*
+	idx->seed ^= idx->seed >> 12;
+	idx->seed ^= idx->seed << 25;
+	idx->seed ^= idx->seed >> 27;
+	uint64_t r = idx->seed * 0x2545F4914F6CDD1DULL;
+	double u = ((r >> 11) + 1) * (1.0 / 9007199254740993.0);
+	int level = (int)(-log(u) / log(VECTOR_INDEX_M));
+	return (level < VECTOR_INDEX_MAX_LEVEL) ? level : VECTOR_INDEX_MAX_LEVEL - 1;
+}
+
+static inline bool _Visit(uint64_t *visited, uint32_t slot) {
+	uint64_t bit = 1ULL << (slot % 64);
+	if(visited[slot / 64] & bit) return false;
+	visited[slot / 64] |= bit;
+	return true;
+}
+
+// Moves ep to the slot closest to q on level, following neighbors greedily.
+static Candidate _SearchGreedy(const VectorIndex *idx, const float *q, Candidate ep, int level) {
+	bool improved = true;
+	while(improved) {
+		improved = false;
+		const uint32_t *links = _Links(idx, ep.slot, level);
+		for(uint32_t i = 0; i < links[0]; i++) {
+			uint32_t n = links[1 + i];
+			float d = _Distance(idx, q, _Vector(idx, n));
+			if(d < ep.dist) {
+				ep.dist = d;
+				ep.slot = n;
+				improved = true;
+			}
+		}
+	}
+	return ep;
+}
+
+/* Collects the ef slots closest to q on level, reachable from ep,
+ * returns them in ascending distance. */
+static Candidate *_SearchLevel(const VectorIndex *idx, const float *q, Candidate ep, uint32_t ef,
+							   int level, uint64_t *visited) {
+	memset(visited, 0, sizeof(uint64_t) * ((idx->slot_count + 63) / 64));
+	Candidate *candidates = array_new(Candidate, ef);   // Closest first.
+	Candidate *results = array_new(Candidate, ef + 1);  // Furthest first.
+	candidates = _HeapPush(candidates, ep, false);
+	results = _HeapPush(results, ep, true);
+	_Visit(visited, ep.slot);
+
+	while(array_len(candidates) > 0) {
+		Candidate c = _HeapPop(candidates, false);
+		// Every remaining candidate is further than the collected slots.
+		if(c.dist > results[0].dist && array_len(results) >= ef) break;
+
+		const uint32_t *links = _Links(idx, c.slot, level);
+		for(uint32_t i = 0; i < links[0]; i++) {
+			uint32_t n = links[1 + i];
+			if(!_Visit(visited, n)) continue;
+			float d = _Distance(idx, q, _Vector(idx, n));
+			if(array_len(results) >= ef && d >= results[0].dist) continue;
+			Candidate next = {d, n};
+			candidates = _HeapPush(candidates, next, false);
+			results = _HeapPush(results, next, true);
+			if(array_len(results) > ef) _HeapPop(results, true);
+		}
+	}
+
+	array_free(candidates);
+	QSORT(Candidate, results, array_len(results), CANDIDATE_LT);
+	return results;
+}
+
+/* Selects up to m of candidates, in ascending distance to base, as base's neighbors.
+ * Candidates closer to a selected neighbor than to base are skipped,
+ * such that neighbors span different directions, and fill remaining links last,
+ * along with removed slots. */
+static uint32_t _SelectNeighbors(const VectorIndex *idx, const Candidate *candidates,
+								 uint32_t count, uint32_t m, uint32_t *selected) {
+	uint32_t n = 0;
+	uint32_t *skipped = array_new(uint32_t, count);
+	for(uint32_t i = 0; i < count && n < m; i++) {
+		const Candidate *c = candidates + i;
+		bool diverse = !idx->removed[c->slot];
+		for(uint32_t j = 0; diverse && j < n; j++) {
+			float d = _Distance(idx, _Vector(idx, c->slot), _Vector(idx, selected[j]));
+			if(d < c->dist) diverse = false;
+		}
+		if(diverse) selected[n++] = c->slot;
+		else skipped = array_append(skipped, c->slot);
+	}
+
+	uint32_t skipped_count = array_len(skipped);
+	for(uint32_t i = 0; i < skipped_count && n < m; i++) selected[n++] = skipped[i];
+	array_free(skipped);
+	return n;
+}
+
+// Links slot to n on level, pruning n's neighbors once it has too many.
+static void _Connect(VectorIndex *idx, uint32_t n, uint32_t slot, int level) {
+	uint32_t *links = _Links(idx, n, level);
+	uint32_t max = _MaxLinks(level);
+	if(links[0] < max) {
+		links[1 + links[0]++] = slot;
+		return;
+	}
+
+	const float *base = _Vector(idx, n);
+	Candidate candidates[VECTOR_INDEX_M0 + 1];
+	for(uint32_t i = 0; i < links[0]; i++) {
+		candidates[i].slot = links[1 + i];
+		candidates[i].dist = _Distance(idx, base, _Vector(idx, links[1 + i]));
+	}
+	candidates[max].slot = slot;
+	candidates[max].dist = _Distance(idx, base, _Vector(idx, slot));
+	QSORT(Candidate, candidates, max + 1, CANDIDATE_LT);
+	links[0] = _SelectNeighbors(idx, candidates, max + 1, max, links + 1);
+}
+
+// Allocates a slot holding vec, links are allocated for each of the slot's levels.
+static uint32_t _NewSlot(VectorIndex *idx, NodeID id, const float *vec, int level) {
+	if(idx->slot_count == idx->slot_cap) {
+		idx->slot_cap = (idx->slot_cap == 0) ? 64 : idx->slot_cap * 2;
+		idx->vectors = rm_realloc(idx->vectors, sizeof(float) * idx->dim * idx->slot_cap);
+		idx->ids = rm_realloc(idx->ids, sizeof(NodeID) * idx->slot_cap);
+		idx->links = rm_realloc(idx->links, sizeof(uint32_t *) * idx->slot_cap);
+		idx->levels = rm_realloc(idx->levels, sizeof(uint8_t) * idx->slot_cap);
+		idx->removed = rm_realloc(idx->removed, sizeof(bool) * idx->slot_cap);
+	}
+
+	uint32_t slot = idx->slot_count++;
+	memcpy(idx->vectors + (size_t)slot * idx->dim, vec, sizeof(float) * idx->dim);
+	idx->ids[slot] = id;
+	idx->levels[slot] = level;
+	idx->removed[slot] = false;
+	size_t links = (VECTOR_INDEX_M0 + 1) + (size_t)level * (VECTOR_INDEX_M + 1);
+	idx->links[slot] = rm_calloc(links, sizeof(uint32_t));
+	return slot;
+}
+
+//------------------------------------------------------------------------------
+// Vector index API
+//------------------------------------------------------------------------------
+
+VectorIndex *VectorIndex_New(const char *label, const char *field, Attribute_ID attr,
+							 uint32_t dim, VectorMetric metric) {
+	assert(label && field && dim > 0);
+	VectorIndex *idx = rm_calloc(1, sizeof(VectorIndex));
+	idx->label = rm_strdup(label);
+	idx->field = rm_strdup(field);
+	idx->attr = attr;
+	idx->dim = dim;
+	idx->metric = metric;
+	idx->slots = raxNew();
+	idx->top_level = -1;
+	idx->seed = 0x9E3779B97F4A7C15ULL;
+	return idx;
+}
+
+bool VectorIndex_ParseMetric(const char *name, VectorMetric *metric) {
+	if(strcasecmp(name, "euclidean") == 0) *metric = VECTOR_METRIC_EUCLIDEAN;
+	else if(strcasecmp(name, "cosine") == 0) *metric = VECTOR_METRIC_COSINE;
+	else return false;
+	return true;
+}
+
+const char *VectorIndex_MetricName(VectorMetric metric) {
+	return (metric == VECTOR_METRIC_COSINE) ? "cosine" : "euclidean";
+}
+
+bool VectorIndex_ReadVector(SIValue v, uint32_t dim, float *vec) {
+	if(SI_TYPE(v) != T_ARRAY || SIArray_Length(v) != dim) return false;
+	for(uint32_t i = 0; i < dim; i++) {
+		SIValue elem = SIArray_Get(v, i);
+		if(!(SI_TYPE(elem) & SI_NUMERIC)) return false;
+		vec[i] = SI_GET_NUMERIC(elem);
+		if(!isfinite(vec[i])) return false;
+	}
+	return true;
+}
+
+void VectorIndex_Insert(VectorIndex *idx, NodeID id, const float *vec) {
+	assert(idx && vec);
+	VectorIndex_RemoveNode(idx, id);
+
+	float normalized[idx->dim];
+	if(idx->metric == VECTOR_METRIC_COSINE) {
+		memcpy(normalized, vec, sizeof(float) * idx->dim);
+		if(!_Normalize(normalized, idx->dim)) return;
+		vec = normalized;
+	}
+
+	int level = _RandomLevel(idx);
+	uint32_t slot = _NewSlot(idx, id, vec, level);
+	raxInsert(idx->slots, (unsigned char *)&id, sizeof(id), (void *)(uintptr_t)slot, NULL);
+	idx->count++;
+
+	// First vector, it is the entry point of every level.
+	if(idx->top_level < 0) {
+		idx->entry = slot;
+		idx->top_level = level;
+		return;
+	}
+
+	vec = _Vector(idx, slot);
+	Candidate ep = {_Distance(idx, vec, _Vector(idx, idx->entry)), idx->entry};
+	for(int l = idx->top_level; l > level; l--) ep = _SearchGreedy(idx, vec, ep, l);
+
+	uint64_t *visited = rm_malloc(sizeof(uint64_t) * ((idx->slot_count + 63) / 64));
+	int bottom = (level < idx->top_level) ? level : idx->top_level;
+	for(int l = bottom; l >= 0; l--) {
+		Candidate *results = _SearchLevel(idx, vec, ep, VECTOR_INDEX_EF_CONSTRUCTION, l, visited);
+		uint32_t *links = _Links(idx, slot, l);
+		links[0] = _SelectNeighbors(idx, results, array_len(results), _MaxLinks(l), links + 1);
+		for(uint32_t i = 0; i < links[0]; i++) _Connect(idx, links[1 + i], slot, l);
+		ep = results[0];
+		array_free(results);
+	}
+	rm_free(visited);
+
+	if(level > idx->top_level) {
+		idx->entry = slot;
+		idx->top_level = level;
+	}
+}
+
+void VectorIndex_IndexNode(VectorIndex *idx, const Node *n) {
+	assert(idx && n);
+	NodeID id = ENTITY_GET_ID(n);
+	SIValue *v = GraphEntity_GetProperty((GraphEntity *)n, idx->attr);
+	float vec[idx->dim];
+	if(v != PROPERTY_NOTFOUND && VectorIndex_ReadVector(*v, idx->dim, vec)) {
+		VectorIndex_Insert(idx, id, vec);
+	} else {
+		VectorIndex_RemoveNode(idx, id);
+	}
+}
+
+void VectorIndex_RemoveNode(VectorIndex *idx, NodeID id) {
+	assert(idx);
+	void *slot;
+	if(!raxRemove(idx->slots, (unsigned char *)&id, sizeof(id), &slot)) return;
+	idx->removed[(uintptr_t)slot] = true;
+	// Drop tombstones once there's nothing left to route to.
+	if(--idx->count == 0) VectorIndex_Clear(idx);
+}
+
+uint64_t VectorIndex_Count(const VectorIndex *idx) {
+	assert(idx);
+	return idx->count;
+}
+
+size_t VectorIndex_MemoryUsage(const VectorIndex *idx) {
+	assert(idx);
+	size_t slot_size = sizeof(float) * idx->dim + sizeof(NodeID) + sizeof(uint32_t *) +
+					   sizeof(uint8_t) + sizeof(bool);
+	size_t size = sizeof(VectorIndex) + slot_size * idx->slot_cap + raxMemoryUsage(idx->slots);
+	for(uint32_t i = 0; i < idx->slot_count; i++) {
+		size += sizeof(uint32_t) * ((VECTOR_INDEX_M0 + 1) + (size_t)idx->levels[i] * (VECTOR_INDEX_M + 1));
+	}
+	return size;
+}
+
+uint32_t VectorIndex_Query(const VectorIndex *idx, const float *query, uint32_t k, NodeID *ids,
+						   double *distances) {
+	assert(idx && query);
+	if(idx->top_level < 0 || k == 0) return 0;
+
+	float normalized[idx->dim];
+	if(idx->metric == VECTOR_METRIC_COSINE) {
+		memcpy(normalized, query, sizeof(float) * idx->dim);
+		if(!_Normalize(normalized, idx->dim)) return 0;
+		query = normalized;
+	}
+
+	Candidate ep = {_Distance(idx, query, _Vector(idx, idx->entry)), idx->entry};
+	for(int l = idx->top_level; l > 0; l--) ep = _SearchGreedy(idx, query, ep, l);
+
+	// Removed slots are collected but not reported, consider additional candidates.
+	uint32_t ef = (k > VECTOR_INDEX_EF_SEARCH) ? k : VECTOR_INDEX_EF_SEARCH;
+	uint32_t removed = idx->slot_count - idx->count;
+	ef += (removed < ef) ? removed : ef;
+
+	uint64_t *visited = rm_malloc(sizeof(uint64_t) * ((idx->slot_count + 63) / 64));
+	Candidate *results = _SearchLevel(idx, query, ep, ef, 0, visited);
+	rm_free(visited);
+
+	uint32_t n = 0;
+	uint32_t result_count = array_len(results);
+	for(uint32_t i = 0; i < result_count && n < k; i++) {
+		const Candidate *c = results + i;
+		if(idx->removed[c->slot]) continue;
+		ids[n] = idx->ids[c->slot];
+		if(idx->metric == VECTOR_METRIC_EUCLIDEAN) distances[n] = sqrt(c->dist);
+		else distances[n] = (c->dist > 0) ? c->dist : 0;
+		n++;
+	}
+	array_free(results);
+	return n;
+}
+
+void VectorIndex_Clear(VectorIndex *idx) {
+	assert(idx);
+	for(uint32_t i = 0; i < idx->slot_count; i++) rm_free(idx->links[i]);
+	rm_free(idx->vectors);
+	rm_free(idx->ids);
+	rm_free(idx->links);
+	rm_free(idx->levels);
+	rm_free(idx->removed);
+	idx->vectors = NULL;
+	idx->ids = NULL;
+	idx->links = NULL;
+	idx->levels = NULL;
+	idx->removed = NULL;
+	idx->slot_count = 0;
+	idx->slot_cap = 0;
+	idx->count = 0;
+	idx->top_level = -1;
+	idx->seed = 0x9E3779B97F4A7C15ULL;
+	raxFree(idx->slots);
+	idx->slots = raxNew();
+}
+
+void VectorIndex_Construct(VectorIndex *idx) {
+	assert(idx);
+	VectorIndex_Clear(idx);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchema(gc, idx->label, SCHEMA_NODE);
+	// Label doesn't exists.
+	if(s == NULL) return;
+
+	Node node;
+	NodeID node_id;
+	IDSetIterator it;
+	IDSet_Iterate(Graph_GetLabelIDs(gc->g, s->id), &it);
+	while(IDSetIterator_Next(&it, &node_id)) {
+		Graph_GetNode(gc->g, node_id, &node);
+		VectorIndex_IndexNode(idx, &node);
+	}
+}
+
+void VectorIndex_Free(VectorIndex *idx) {
+	if(idx == NULL) return;
+	VectorIndex_Clear(idx);
+	raxFree(idx->slots);
+	rm_free(idx->label);
+	rm_free(idx->field);
+	rm_free(idx);
+}
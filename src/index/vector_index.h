@@ -0,0 +1,156 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "rax.h"
+#include "../value.h"
+#include "../graph/entities/node.h"
+
+/* Approximate nearest-neighbor index over fixed-length numeric list properties,
+ * a hierarchical navigable small world (HNSW) graph.
+ * Each vector is linked to its nearest neighbors on its own level and every level
+ * beneath it, upper levels are sparse such that searches descend greedily towards
+ * the query before exploring the dense bottom level.
+ * Removed nodes remain in the graph as tombstones, routing searches
+ * without being reported, until the index is constructed again. */
+
+// Maximum number of neighbors per vector on levels above the bottom level.
+#define VECTOR_INDEX_M 16
+// Maximum number of neighbors per vector on the bottom level.
+#define VECTOR_INDEX_M0 32
+// Number of candidates considered when linking a new vector.
+#define VECTOR_INDEX_EF_CONSTRUCTION 200
+// Minimal number of candidates considered by a query.
+#define VECTOR_INDEX_EF_SEARCH 64
+// Maximal number of levels.
+#define VECTOR_INDEX_MAX_LEVEL 16
+// Maximal number of vector components.
+#define VECTOR_INDEX_MAX_DIM 4096
+
+typedef enum {
+	VECTOR_METRIC_EUCLIDEAN,    // Euclidean distance.
+	VECTOR_METRIC_COSINE,       // One minus cosine similarity.
+} VectorMetric;
+
+typedef struct {
+	char *label;                // Indexed label.
+	char *field;                // Indexed field.
+	Attribute_ID attr;          // Indexed field ID.
+	uint32_t dim;               // Number of vector components.
+	VectorMetric metric;        // Distance metric.
+	float *vectors;             // Vector components, dim per slot, normalized by the cosine metric.
+	NodeID *ids;                // Node ID per slot.
+	uint32_t **links;           // Neighbor lists per slot, for each of the slot's levels.
+	uint8_t *levels;            // Top level per slot.
+	bool *removed;              // Removed slots, retained to route searches.
+	uint32_t slot_count;        // Number of slots.
+	uint32_t slot_cap;          // Allocated slots.
+	uint64_t count;             // Number of indexed nodes.
+	rax *slots;                 // Node ID to slot.
+	uint32_t entry;             // Slot searches start from.
+	int top_level;              // Entry slot level, -1 while the index is empty.
+	uint64_t seed;              // Level generator state.
+} VectorIndex;
+
+// Create a new, empty vector index over label's field.
+VectorIndex *VectorIndex_New
+(
+	const char *label,
+	const char *field,
+	Attribute_ID attr,
+	uint32_t dim,
+	VectorMetric metric
+);
+
+/* Parses metric name, case insensitive,
+ * returns false if name isn't a supported metric. */
+bool VectorIndex_ParseMetric
+(
+	const char *name,
+	VectorMetric *metric
+);
+
+// Returns metric's name.
+const char *VectorIndex_MetricName
+(
+	VectorMetric metric
+);
+
+/* Sets vec to the dim components of v, a list of numerics.
+ * Returns false if v is of a different type or length. */
+bool VectorIndex_ReadVector
+(
+	SIValue v,
+	uint32_t dim,
+	float *vec
+);
+
+/* Index node under vec, replacing its previous vector,
+ * zero vectors are not indexed by the cosine metric. */
+void VectorIndex_Insert
+(
+	VectorIndex *idx,
+	NodeID id,
+	const float *vec
+);
+
+/* Index node under its field's value, the node is removed from index
+ * if the value is not a list of dim numerics. */
+void VectorIndex_IndexNode
+(
+	VectorIndex *idx,
+	const Node *n
+);
+
+// Remove node from index.
+void VectorIndex_RemoveNode
+(
+	VectorIndex *idx,
+	NodeID id
+);
+
+// Number of nodes in index.
+uint64_t VectorIndex_Count
+(
+	const VectorIndex *idx
+);
+
+// Number of bytes held by index, its vectors and neighbor lists.
+size_t VectorIndex_MemoryUsage
+(
+	const VectorIndex *idx
+);
+
+/* Retrieves up to k indexed nodes nearest to query, closest first,
+ * sets ids and distances and returns the number of nodes retrieved.
+ * Safe to call concurrently with other queries. */
+uint32_t VectorIndex_Query
+(
+	const VectorIndex *idx,
+	const float *query,
+	uint32_t k,
+	NodeID *ids,
+	double *distances
+);
+
+// Remove every node from index.
+void VectorIndex_Clear
+(
+	VectorIndex *idx
+);
+
+// Index every node of the indexed label.
+void VectorIndex_Construct
+(
+	VectorIndex *idx
+);
+
+// Free index.
+void VectorIndex_Free
+(
+	VectorIndex *idx
+);
@@ -0,0 +1,161 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "materialized_views.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include <string.h>
+#include <assert.h>
+
+static void _MaterializedView_Free(MaterializedView *view) {
+	rm_free(view->name);
+	rm_free(view->query);
+	if(view->ids) rm_free(view->ids);
+	rm_free(view);
+}
+
+// Returns the position of view name, -1 if no such view exists, expects the lock to be held.
+static int _MaterializedViews_Find(const MaterializedViews *views, const char *name) {
+	uint count = array_len(views->views);
+	for(uint i = 0; i < count; i++) {
+		if(strcmp(views->views[i]->name, name) == 0) return i;
+	}
+	return -1;
+}
+
+MaterializedViews *MaterializedViews_New(void) {
+	MaterializedViews *views = rm_malloc(sizeof(MaterializedViews));
+	views->views = array_new(MaterializedView *, 0);
+	int res = pthread_mutex_init(&views->lock, NULL);
+	assert(res == 0);
+	res = pthread_mutex_init(&views->refresh, NULL);
+	assert(res == 0);
+	return views;
+}
+
+bool MaterializedViews_Set(MaterializedViews *views, const char *name, const char *query,
+						   NodeID *ids, uint64_t count) {
+	pthread_mutex_lock(&views->lock);
+	int i = _MaterializedViews_Find(views, name);
+	if(i < 0 && array_len(views->views) >= MATERIALIZED_VIEWS_MAX) {
+		pthread_mutex_unlock(&views->lock);
+		if(ids) rm_free(ids);
+		return false;
+	}
+
+	MaterializedView *view = rm_malloc(sizeof(MaterializedView));
+	view->name = rm_strdup(name);
+	view->query = rm_strdup(query);
+	view->ids = ids;
+	view->count = count;
+	view->stale = false;
+
+	if(i < 0) {
+		views->views = array_append(views->views, view);
+	} else {
+		_MaterializedView_Free(views->views[i]);
+		views->views[i] = view;
+	}
+	pthread_mutex_unlock(&views->lock);
+	return true;
+}
+
+bool MaterializedViews_Remove(MaterializedViews *views, const char *name) {
+	pthread_mutex_lock(&views->lock);
+	int i = _MaterializedViews_Find(views, name);
+	if(i >= 0) {
+		_MaterializedView_Free(views->views[i]);
+		array_del(views->views, i);
+	}
+	pthread_mutex_unlock(&views->lock);
+	return (i >= 0);
+}
+
+bool MaterializedViews_GetIDs(MaterializedViews *views, const char *name, NodeID **ids,
+							  uint64_t *count) {
+	pthread_mutex_lock(&views->lock);
+	int i = _MaterializedViews_Find(views, name);
+	if(i >= 0) {
+		MaterializedView *view = views->views[i];
+		*count = view->count;
+		*ids = rm_malloc(sizeof(NodeID) * (view->count + 1));
+		if(view->count > 0) memcpy(*ids, view->ids, sizeof(NodeID) * view->count);
+	}
+	pthread_mutex_unlock(&views->lock);
+	return (i >= 0);
+}
+
+void MaterializedViews_Invalidate(MaterializedViews *views) {
+	pthread_mutex_lock(&views->lock);
+	uint count = array_len(views->views);
+	for(uint i = 0; i < count; i++) views->views[i]->stale = true;
+	pthread_mutex_unlock(&views->lock);
+}
+
+bool MaterializedViews_NextStale(MaterializedViews *views, char **name, char **query) {
+	bool found = false;
+	pthread_mutex_lock(&views->lock);
+	uint count = array_len(views->views);
+	for(uint i = 0; i < count; i++) {
+		MaterializedView *view = views->views[i];
+		if(!view->stale) continue;
+		view->stale = false;
+		*name = rm_strdup(view->name);
+		*query = rm_strdup(view->query);
+		found = true;
+		break;
+	}
+	pthread_mutex_unlock(&views->lock);
+	return found;
+}
+
+void MaterializedViews_Refresh(MaterializedViews *views, const char *name, const char *query,
+							   NodeID *ids, uint64_t count) {
+	pthread_mutex_lock(&views->lock);
+	int i = _MaterializedViews_Find(views, name);
+	// The view might have been dropped or redefined while refreshing.
+	if(i >= 0 && strcmp(views->views[i]->query, query) == 0) {
+		MaterializedView *view = views->views[i];
+		if(view->ids) rm_free(view->ids);
+		view->ids = ids;
+		view->count = count;
+		ids = NULL;
+	}
+	pthread_mutex_unlock(&views->lock);
+	if(ids) rm_free(ids);
+}
+
+uint MaterializedViews_Count(MaterializedViews *views) {
+	pthread_mutex_lock(&views->lock);
+	uint count = array_len(views->views);
+	pthread_mutex_unlock(&views->lock);
+	return count;
+}
+
+bool MaterializedViews_Get(MaterializedViews *views, uint i, char **name, char **query,
+						   uint64_t *count) {
+	bool found = false;
+	pthread_mutex_lock(&views->lock);
+	if(i < array_len(views->views)) {
+		MaterializedView *view = views->views[i];
+		*name = rm_strdup(view->name);
+		*query = rm_strdup(view->query);
+		*count = view->count;
+		found = true;
+	}
+	pthread_mutex_unlock(&views->lock);
+	return found;
+}
+
+void MaterializedViews_Free(MaterializedViews *views) {
+	if(views == NULL) return;
+	uint count = array_len(views->views);
+	for(uint i = 0; i < count; i++) _MaterializedView_Free(views->views[i]);
+	array_free(views->views);
+	pthread_mutex_destroy(&views->lock);
+	pthread_mutex_destroy(&views->refresh);
+	rm_free(views);
+}
@@ -0,0 +1,71 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "../graph/entities/graph_entity.h"
+
+// Maximum number of views defined over a graph.
+#define MATERIALIZED_VIEWS_MAX 64
+
+// A read-only query whose returned nodes are stored as a set of node IDs.
+typedef struct {
+	char *name;         // View name.
+	char *query;        // Query producing the view's nodes.
+	NodeID *ids;        // Sorted, distinct IDs of the view's nodes.
+	uint64_t count;     // Number of IDs.
+	bool stale;         // The graph was modified since the IDs were computed.
+} MaterializedView;
+
+// Registry of materialized views defined over a graph.
+typedef struct {
+	MaterializedView **views;   // Defined views.
+	pthread_mutex_t lock;       // Guards registry state.
+	pthread_mutex_t refresh;    // Serializes view computations, the latest computation is retained.
+} MaterializedViews;
+
+// Create a new materialized views registry.
+MaterializedViews *MaterializedViews_New(void);
+
+/* Define a view named name over query, holding the given sorted, distinct IDs.
+ * Takes ownership of ids, an existing view of the same name is replaced.
+ * Returns false if the maximum number of views is reached. */
+bool MaterializedViews_Set(MaterializedViews *views, const char *name, const char *query,
+						   NodeID *ids, uint64_t count);
+
+// Remove view, returns false if no such view exists.
+bool MaterializedViews_Remove(MaterializedViews *views, const char *name);
+
+/* Retrieve a copy of the view's IDs, the returned array must be freed by the caller.
+ * Returns false if no such view exists. */
+bool MaterializedViews_GetIDs(MaterializedViews *views, const char *name, NodeID **ids,
+							  uint64_t *count);
+
+// Mark every view as stale, following a modification of the graph.
+void MaterializedViews_Invalidate(MaterializedViews *views);
+
+/* Retrieve a copy of the name and query of a stale view, clearing its stale mark.
+ * Returns false if all views are up to date, the strings must be freed by the caller. */
+bool MaterializedViews_NextStale(MaterializedViews *views, char **name, char **query);
+
+/* Replace the IDs of view name, if it still holds query.
+ * Takes ownership of ids. */
+void MaterializedViews_Refresh(MaterializedViews *views, const char *name, const char *query,
+							   NodeID *ids, uint64_t count);
+
+// Retrieve the number of defined views.
+uint MaterializedViews_Count(MaterializedViews *views);
+
+/* Retrieve a copy of the name and query of the view at position i,
+ * returns false if i is out of range, the strings must be freed by the caller. */
+bool MaterializedViews_Get(MaterializedViews *views, uint i, char **name, char **query,
+						   uint64_t *count);
+
+// Free registry and all views.
+void MaterializedViews_Free(MaterializedViews *views);
@@ -11,13 +11,18 @@
 #include "config.h"
 #include "version.h"
 #include "util/arr.h"
+#include "util/numa.h"
 #include "query_ctx.h"
 #include "arithmetic/funcs.h"
 #include "commands/commands.h"
-#include "util/thpool/thpool.h"
+#include "util/thpool/pools.h"
+#include "util/graphblas_threads.h"
+#include "expiry/expiry.h"
+#include "util/reclaimer.h"
 #include "graph/graphcontext.h"
 #include "ast/cypher_whitelist.h"
 #include "arithmetic/agg_funcs.h"
+#include "arithmetic/udf.h"
 #include "procedures/procedure.h"
 #include "arithmetic/arithmetic_expression.h"
 #include "graph/serializers/graphcontext_type.h"
@@ -28,21 +33,55 @@
 //------------------------------------------------------------------------------
 GraphContext **graphs_in_keyspace; // Global array tracking all extant GraphContexts.
 bool process_is_child;             // Flag indicating whether the running process is a child.
-
-//------------------------------------------------------------------------------
-// Thread pool variables
-//------------------------------------------------------------------------------
-threadpool _thpool = NULL;
-
-/* Set up thread pool,
- * number of threads within pool should be
+long long default_query_timeout;   // Default query timeout in milliseconds, 0 for no timeout.
+rax *interned_attributes;          // Names of attributes whose string values are interned, NULL for none.
+bool flush_before_fork;            // Apply pending matrix changes prior to forking.
+long long index_chunk_size;        // Number of nodes indexed per background index construction step.
+long long sort_spill_threshold;    // Number of bytes buffered by a sort before spilling, 0 never spills.
+long long distinct_spill_threshold; // Number of bytes of distinct fingerprints before spilling, 0 never spills.
+long long result_cache_size;       // Number of bytes of read-only query results cached per graph, 0 disables caching.
+long long query_mem_capacity;      // Number of bytes a single query may allocate, 0 for unlimited.
+long long slowlog_size;            // Number of queries retained by each graph's slowlog.
+long long slowlog_threshold;       // Number of milliseconds a query runs for before it is logged.
+long long trace_buffer_size;       // Number of trace spans retained until drained.
+long long access_sample_rate;      // One in access_sample_rate entity accesses is sampled, 0 disables sampling.
+long long min_version_wait;        // Number of milliseconds a query waits for its graph to reach MIN_VERSION.
+long long change_feed_maxlen;      // Approximate number of entries retained by each graph's change stream, 0 disables the feed.
+
+/* Set up thread pools, one per lane.
+ * number of threads serving short reads should be
  * the number of available hyperthreads.
- * Returns 1 if thread pool initialized, 0 otherwise. */
-static int _Setup_ThreadPOOL(int threadCount) {
-	// Create thread pool.
-	_thpool = thpool_init(threadCount);
-	if(_thpool == NULL) return 0;
+ * Returns 1 if thread pools initialized, 0 otherwise. */
+static int _Setup_ThreadPOOL(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	long long threadCounts[THPOOL_LANE_COUNT];
+	threadCounts[THPOOL_LANE_WRITER] = Config_GetWriterThreadCount(ctx, argv, argc);
+	threadCounts[THPOOL_LANE_SHORT_READ] = Config_GetThreadCount(ctx, argv, argc);
+	threadCounts[THPOOL_LANE_LONG_READ] = Config_GetLongReadThreadCount(ctx, argv, argc);
+
+	long long maxQueued = Config_GetMaxQueuedQueries(ctx, argv, argc);
+
+	// Create thread pools.
+	if(!ThreadPools_Init(threadCounts, maxQueued)) return 0;
+
+	RedisModule_Log(ctx, "notice",
+					"Thread pools created, using %lld writer, %lld short read and %lld long read threads.",
+					threadCounts[THPOOL_LANE_WRITER], threadCounts[THPOOL_LANE_SHORT_READ],
+					threadCounts[THPOOL_LANE_LONG_READ]);
+	if(maxQueued > 0) {
+		RedisModule_Log(ctx, "notice", "Up to %lld queries may wait on each thread pool.", maxQueued);
+	}
+
+	// Matrix operations of long reads share these threads, others use a single thread.
+	long long graphblasThreads = Config_GetGraphBLASThreadCount(ctx, argv, argc);
+	GraphBLASThreads_Init(graphblasThreads);
+	RedisModule_Log(ctx, "notice", "Long read matrix operations share %lld threads.", graphblasThreads);
 
+	// Keep each thread's memory on its own node, allocations are interleaved.
+	if(NUMA_InterleaveEnabled()) {
+		int pinned = ThreadPools_PinToNUMANodes();
+		RedisModule_Log(ctx, "notice", "%d threads pinned across %d NUMA nodes.", pinned,
+						NUMA_NodeCount());
+	}
 	return 1;
 }
 
@@ -70,7 +109,16 @@ static void RG_ForkPrepare() {
 	uint graph_count = array_len(graphs_in_keyspace);
 	for(uint i = 0; i < graph_count; i++) {
 		// Acquire each read-write lock as a reader to guarantee that no graph is being modified.
-		Graph_AcquireReadLock(graphs_in_keyspace[i]->g);
+		Graph *g = graphs_in_keyspace[i]->g;
+		Graph_AcquireReadLock(g);
+
+		/* Fold pending tuples and zombies into the matrices while the pages are still private.
+		 * Otherwise the parent rebuilds the matrices after forking, while the child
+		 * duplicates them again when serializing, both holding copies of the same data. */
+		if(flush_before_fork) {
+			Graph_SetMatrixPolicy(g, SYNC_AND_MINIMIZE_SPACE);
+			Graph_ApplyAllPending(g);
+		}
 	}
 }
 
@@ -127,10 +175,12 @@ static void RegisterForkHooks(RedisModuleCtx *ctx) {
 }
 
 int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
-	/* TODO: when module unloads call GrB_finalize. */
-	assert(GxB_init(GrB_NONBLOCKING, rm_malloc, rm_calloc, rm_realloc, rm_free, true) == GrB_SUCCESS);
+	/* TODO: when module unloads call GrB_finalize.
+	 * Large matrix arrays are interleaved across NUMA nodes once enabled. */
+	assert(GxB_init(GrB_NONBLOCKING, NUMA_Malloc, NUMA_Calloc, NUMA_Realloc, NUMA_Free,
+					true) == GrB_SUCCESS);
 	GxB_set(GxB_FORMAT, GxB_BY_ROW); // all matrices in CSR format
-	GxB_set(GxB_HYPER, GxB_NEVER_HYPER); // matrices are never hypersparse
+	GxB_set(GxB_HYPER, GxB_NEVER_HYPER); // matrices are never hypersparse unless set per matrix
 
 	if(RedisModule_Init(ctx, "graph", REDISGRAPH_MODULE_VERSION,
 						REDISMODULE_APIVER_1) == REDISMODULE_ERR) {
@@ -151,12 +201,113 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 	// Create thread local storage key.
 	if(!QueryCtx_Init()) return REDISMODULE_ERR;
 
-	long long threadCount = Config_GetThreadCount(ctx, argv, argc);
-	if(!_Setup_ThreadPOOL(threadCount)) return REDISMODULE_ERR;
-	RedisModule_Log(ctx, "notice", "Thread pool created, using %d threads.", threadCount);
+	bool interleave = Config_GetNUMAInterleave(ctx, argv, argc);
+	NUMA_Init(interleave);
+	if(interleave && !NUMA_InterleaveEnabled()) {
+		RedisModule_Log(ctx, "warning", "%s ignored, host has a single NUMA node.", NUMA_INTERLEAVE);
+	}
+
+	if(!_Setup_ThreadPOOL(ctx, argv, argc)) return REDISMODULE_ERR;
+
+	default_query_timeout = Config_GetTimeout(ctx, argv, argc);
+	if(default_query_timeout > 0) {
+		RedisModule_Log(ctx, "notice", "Query timeout set to %lld milliseconds.", default_query_timeout);
+	}
+
+	interned_attributes = Config_GetInternedAttributes(ctx, argv, argc);
+	if(interned_attributes) {
+		RedisModule_Log(ctx, "notice", "Interning string values of %llu attributes.",
+						(unsigned long long)raxSize(interned_attributes));
+	}
+
+	flush_before_fork = Config_GetFlushBeforeFork(ctx, argv, argc);
+	if(flush_before_fork) {
+		RedisModule_Log(ctx, "notice", "Pending matrix changes are applied prior to forking.");
+	}
+
+	index_chunk_size = Config_GetIndexChunkSize(ctx, argv, argc);
+
+	sort_spill_threshold = Config_GetSortSpillThreshold(ctx, argv, argc);
+	if(sort_spill_threshold == 0) {
+		RedisModule_Log(ctx, "notice", "Sorted records are never spilled to disk.");
+	}
+
+	distinct_spill_threshold = Config_GetDistinctSpillThreshold(ctx, argv, argc);
+	if(distinct_spill_threshold == 0) {
+		RedisModule_Log(ctx, "notice", "Distinct records are never spilled to disk.");
+	}
+
+	result_cache_size = Config_GetResultCacheSize(ctx, argv, argc);
+	if(result_cache_size > 0) {
+		RedisModule_Log(ctx, "notice", "Caching up to %lld bytes of query results per graph.",
+						result_cache_size);
+	}
+
+	query_mem_capacity = Config_GetQueryMemCapacity(ctx, argv, argc);
+	if(query_mem_capacity > 0) {
+		if(Alloc_AccountingSupported()) {
+			RedisModule_Log(ctx, "notice", "Queries are limited to %lld bytes of memory.", query_mem_capacity);
+		} else {
+			RedisModule_Log(ctx, "warning", "%s requires a server reporting allocation sizes, ignored.",
+							QUERY_MEM_CAPACITY);
+			query_mem_capacity = 0;
+		}
+	}
+
+	slowlog_size = Config_GetSlowLogSize(ctx, argv, argc);
+	slowlog_threshold = Config_GetSlowLogThreshold(ctx, argv, argc);
+	if(slowlog_threshold > 0) {
+		RedisModule_Log(ctx, "notice", "Logging queries running for %lld milliseconds or more.",
+						slowlog_threshold);
+	}
+
+	trace_buffer_size = Config_GetTraceBufferSize(ctx, argv, argc);
+	Trace_Init();
+	if(trace_buffer_size == 0) RedisModule_Log(ctx, "notice", "Query tracing is disabled.");
+
+	access_sample_rate = Config_GetAccessSampleRate(ctx, argv, argc);
+	if(access_sample_rate > 0) {
+		RedisModule_Log(ctx, "notice", "Sampling one in %lld entity accesses.", access_sample_rate);
+	}
+
+	min_version_wait = Config_GetMinVersionWait(ctx, argv, argc);
+
+	change_feed_maxlen = Config_GetChangeFeedMaxLen(ctx, argv, argc);
+	if(change_feed_maxlen > 0) {
+		RedisModule_Log(ctx, "notice", "Streaming graph changes, retaining about %lld entries per graph.",
+						change_feed_maxlen);
+	}
+
+	const char **udf_libraries = Config_GetUDFLibraries(ctx, argv, argc);
+	if(udf_libraries) {
+		// Plug-in functions are registered prior to serving any query.
+		for(uint i = 0; i < array_len(udf_libraries); i++) {
+			char *err = NULL;
+			if(!UDF_Load(udf_libraries[i], &err)) {
+				RedisModule_Log(ctx, "warning", "%s", err);
+				free(err);
+				array_free(udf_libraries);
+				return REDISMODULE_ERR;
+			}
+			RedisModule_Log(ctx, "notice", "Loaded user-defined functions from %s.", udf_libraries[i]);
+		}
+		array_free(udf_libraries);
+	}
 
 	if(_RegisterDataTypes(ctx) != REDISMODULE_OK) return REDISMODULE_ERR;
 
+	// Expired entities are deleted in the background.
+	if(!Expiry_StartReaper()) {
+		RedisModule_Log(ctx, "warning", "Failed to spawn the expiry reaper.");
+		return REDISMODULE_ERR;
+	}
+
+	// Deleted graphs are freed in the background.
+	if(!Reclaimer_Start()) {
+		RedisModule_Log(ctx, "warning", "Failed to spawn the graph reclaimer.");
+		return REDISMODULE_ERR;
+	}
+
 	if(RedisModule_CreateCommand(ctx, "graph.QUERY", CommandDispatch, "write deny-oom", 1, 1,
 								 1) == REDISMODULE_ERR) {
 		return REDISMODULE_ERR;
@@ -187,5 +338,75 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 		return REDISMODULE_ERR;
 	}
 
+	if(RedisModule_CreateCommand(ctx, "graph.PREPARE", CommandDispatch, "write", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.EXECUTE", CommandDispatch, "write deny-oom", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.BATCH", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.RO_QUERY", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.COMPACT", CommandDispatch, "write", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.COPY", CommandDispatch, "write deny-oom", 1, 2,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.VIEW", CommandDispatch, "write", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.PLAN", CommandDispatch, "write", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.CURSOR", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.FETCH", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.EXPORT", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.MEMORY", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.STATS", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.TRACE", MGraph_Trace, "readonly", 0, 0,
+								 0) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
 	return REDISMODULE_OK;
 }
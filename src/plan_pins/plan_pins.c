@@ -0,0 +1,88 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "plan_pins.h"
+#include "../util/rmalloc.h"
+#include <string.h>
+#include <assert.h>
+
+static void _PlanPin_Free(void *pin) {
+	rm_free(((PlanPin *)pin)->shape);
+	rm_free(pin);
+}
+
+PlanPins *PlanPins_New(void) {
+	PlanPins *pins = rm_malloc(sizeof(PlanPins));
+	pins->pins = raxNew();
+	int res = pthread_mutex_init(&pins->lock, NULL);
+	assert(res == 0);
+	return pins;
+}
+
+void PlanPins_Set(PlanPins *pins, const char *query, uint rules, const char *shape) {
+	PlanPin *pin = rm_malloc(sizeof(PlanPin));
+	pin->rules = rules;
+	pin->shape = rm_strdup(shape);
+	pin->mismatches = 0;
+
+	PlanPin *old = NULL;
+	pthread_mutex_lock(&pins->lock);
+	raxInsert(pins->pins, (unsigned char *)query, strlen(query), pin, (void **)&old);
+	pthread_mutex_unlock(&pins->lock);
+	if(old) _PlanPin_Free(old);
+}
+
+bool PlanPins_Remove(PlanPins *pins, const char *query) {
+	PlanPin *old = NULL;
+	pthread_mutex_lock(&pins->lock);
+	int removed = raxRemove(pins->pins, (unsigned char *)query, strlen(query), (void **)&old);
+	pthread_mutex_unlock(&pins->lock);
+	if(removed) _PlanPin_Free(old);
+	return removed;
+}
+
+bool PlanPins_Get(PlanPins *pins, const char *query, size_t len, uint *rules, char **shape) {
+	pthread_mutex_lock(&pins->lock);
+	PlanPin *pin = raxFind(pins->pins, (unsigned char *)query, len);
+	bool found = (pin != raxNotFound);
+	if(found) {
+		*rules = pin->rules;
+		*shape = rm_strdup(pin->shape);
+	}
+	pthread_mutex_unlock(&pins->lock);
+	return found;
+}
+
+void PlanPins_ReportMismatch(PlanPins *pins, const char *query, size_t len) {
+	pthread_mutex_lock(&pins->lock);
+	PlanPin *pin = raxFind(pins->pins, (unsigned char *)query, len);
+	if(pin != raxNotFound) pin->mismatches++;
+	pthread_mutex_unlock(&pins->lock);
+}
+
+uint64_t PlanPins_Count(PlanPins *pins) {
+	pthread_mutex_lock(&pins->lock);
+	uint64_t count = raxSize(pins->pins);
+	pthread_mutex_unlock(&pins->lock);
+	return count;
+}
+
+void PlanPins_ForEach(PlanPins *pins, PlanPinsVisitor visit, void *privdata, bool lock) {
+	if(lock) pthread_mutex_lock(&pins->lock);
+	raxIterator it;
+	raxStart(&it, pins->pins);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) visit((const char *)it.key, it.key_len, it.data, privdata);
+	raxStop(&it);
+	if(lock) pthread_mutex_unlock(&pins->lock);
+}
+
+void PlanPins_Free(PlanPins *pins) {
+	if(pins == NULL) return;
+	raxFreeWithCallback(pins->pins, _PlanPin_Free);
+	pthread_mutex_destroy(&pins->lock);
+	rm_free(pins);
+}
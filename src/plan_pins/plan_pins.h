@@ -0,0 +1,55 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include "../../deps/rax/rax.h"
+
+// An execution plan pinned for a query body.
+typedef struct {
+	uint rules;             // Optimizer rules applied to the pinned plan, see optimizer.h.
+	char *shape;            // Shape of the pinned plan, see ExecutionPlan_Shape.
+	uint64_t mismatches;    // Number of plans built since pinning which didn't match shape.
+} PlanPin;
+
+// Registry of pinned plans, mapping query bodies to pins.
+typedef struct {
+	rax *pins;              // Mapping between query bodies and pins.
+	pthread_mutex_t lock;   // Guards registry state.
+} PlanPins;
+
+// Visits a pinned plan, invoked with the registry locked.
+typedef void (*PlanPinsVisitor)(const char *query, size_t len, const PlanPin *pin, void *privdata);
+
+// Create a new pinned plans registry.
+PlanPins *PlanPins_New(void);
+
+// Pin a plan for query, replacing any plan pinned for it.
+void PlanPins_Set(PlanPins *pins, const char *query, uint rules, const char *shape);
+
+// Unpin the plan of query, returns false if no plan is pinned for it.
+bool PlanPins_Remove(PlanPins *pins, const char *query);
+
+/* Retrieve the rules and a copy of the shape of the plan pinned for query,
+ * the shape must be freed by the caller. Returns false if no plan is pinned for it. */
+bool PlanPins_Get(PlanPins *pins, const char *query, size_t len, uint *rules, char **shape);
+
+// Count a plan built for query which didn't match its pinned shape.
+void PlanPins_ReportMismatch(PlanPins *pins, const char *query, size_t len);
+
+// Retrieve the number of pinned plans.
+uint64_t PlanPins_Count(PlanPins *pins);
+
+/* Visit every pinned plan in query order.
+ * The registry is not locked if lock is false, e.g. within a forked process. */
+void PlanPins_ForEach(PlanPins *pins, PlanPinsVisitor visit, void *privdata, bool lock);
+
+// Free registry and all pinned plans.
+void PlanPins_Free(PlanPins *pins);
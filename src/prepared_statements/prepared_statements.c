@@ -0,0 +1,70 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "prepared_statements.h"
+#include "../util/rmalloc.h"
+#include <string.h>
+#include <assert.h>
+
+// Cached queries are handed out as copies, outliving their eviction.
+static void *_CopyQuery(void *query) {
+	return rm_strdup(query);
+}
+
+// Handles are cached as values rather than references, handles start at 1.
+static void *_RefHandle(void *handle) {
+	return handle;
+}
+
+static void _FreeHandle(void *handle) {
+}
+
+PreparedStatements *PreparedStatements_New(void) {
+	PreparedStatements *statements = rm_malloc(sizeof(PreparedStatements));
+	statements->next_handle = 1;
+	statements->queries = Cache_New(PREPARED_STATEMENTS_CAPACITY, _CopyQuery, rm_free);
+	statements->handles = Cache_New(PREPARED_STATEMENTS_CAPACITY, _RefHandle, _FreeHandle);
+	int res = pthread_mutex_init(&statements->lock, NULL);
+	assert(res == 0);
+	return statements;
+}
+
+uint64_t PreparedStatements_Add(PreparedStatements *statements, const char *query) {
+	size_t len = strlen(query);
+
+	pthread_mutex_lock(&statements->lock);
+	uint64_t handle = (uint64_t)(uintptr_t)Cache_GetValue(statements->handles, query, len);
+	// The query's handle is reused only as long as it is recognized, which also marks it as used.
+	char *prepared = NULL;
+	if(handle) prepared = Cache_GetValue(statements->queries, (const char *)&handle, sizeof(uint64_t));
+	if(prepared == NULL) {
+		// Drop the query's stale handle, if any, in favour of a new one.
+		if(handle) Cache_RemoveValue(statements->handles, query, len);
+		handle = statements->next_handle++;
+		Cache_SetValue(statements->queries, (const char *)&handle, sizeof(uint64_t), (void *)query);
+		Cache_SetValue(statements->handles, query, len, (void *)(uintptr_t)handle);
+	}
+	pthread_mutex_unlock(&statements->lock);
+
+	rm_free(prepared);
+	return handle;
+}
+
+char *PreparedStatements_GetQuery(PreparedStatements *statements, uint64_t handle) {
+	return Cache_GetValue(statements->queries, (const char *)&handle, sizeof(uint64_t));
+}
+
+uint64_t PreparedStatements_Count(PreparedStatements *statements) {
+	return Cache_Size(statements->queries);
+}
+
+void PreparedStatements_Free(PreparedStatements *statements) {
+	if(statements == NULL) return;
+	Cache_Free(statements->queries);
+	Cache_Free(statements->handles);
+	pthread_mutex_destroy(&statements->lock);
+	rm_free(statements);
+}
@@ -0,0 +1,43 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "../util/cache/cache.h"
+
+// Maximum number of prepared queries held per graph.
+#define PREPARED_STATEMENTS_CAPACITY 512
+
+/* Registry of prepared queries, mapping handles to query text.
+ * Holds up to PREPARED_STATEMENTS_CAPACITY queries, once full the least recently
+ * prepared or executed query is evicted and its handle is no longer recognized. */
+typedef struct {
+	uint64_t next_handle;   // Handle assigned to the next prepared query.
+	Cache *queries;         // Mapping between handles and query text.
+	Cache *handles;         // Mapping between query text and handles.
+	pthread_mutex_t lock;   // Keeps both mappings in agreement.
+} PreparedStatements;
+
+// Create a new prepared statements registry.
+PreparedStatements *PreparedStatements_New(void);
+
+/* Register query, returning its handle.
+ * Preparing the same query multiple times returns the same handle,
+ * unless the query was evicted in between. */
+uint64_t PreparedStatements_Add(PreparedStatements *statements, const char *query);
+
+/* Retrieve a copy of the query associated with handle, NULL if handle is unknown.
+ * The returned string must be freed by the caller. */
+char *PreparedStatements_GetQuery(PreparedStatements *statements, uint64_t handle);
+
+// Retrieve the number of prepared queries.
+uint64_t PreparedStatements_Count(PreparedStatements *statements);
+
+// Free registry and all prepared queries.
+void PreparedStatements_Free(PreparedStatements *statements);
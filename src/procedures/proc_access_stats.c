@@ -0,0 +1,132 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_access_stats.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+// CALL db.accessStats()
+
+#define OUTPUT_COUNT 4
+
+// Access type names, by AccessType.
+static const char *_type_names[ACCESS_TYPE_COUNT] = {"node", "label", "relationship", "index"};
+
+typedef struct {
+	AccessType type;    // Type of accessed entity.
+	uint64_t id;        // Entity ID.
+	uint64_t accesses;  // Estimated number of accesses.
+} AccessStatsRow;
+
+typedef struct {
+	uint idx;               // Position of the next row to emit.
+	AccessStatsRow *rows;   // Most accessed entities of each access type.
+	SIValue *output;        // Output stats.
+} AccessStatsContext;
+
+ProcedureResult Proc_AccessStatsInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 0) return PROCEDURE_ERR;
+
+	AccessStatsContext *pdata = rm_malloc(sizeof(AccessStatsContext));
+	pdata->idx = 0;
+	pdata->rows = array_new(AccessStatsRow, 0);
+	pdata->output = array_new(SIValue, OUTPUT_COUNT * 2);
+	for(uint i = 0; i < OUTPUT_COUNT; i++) {
+		pdata->output = array_append(pdata->output, SI_ConstStringVal(ctx->output[i]->name));
+		pdata->output = array_append(pdata->output, SI_NullVal()); // Place holder.
+	}
+
+	// Nothing is yielded unless accesses are sampled.
+	AccessStats *stats = GraphContext_GetAccessStats(QueryCtx_GetGraphCtx());
+	if(stats) {
+		for(int t = 0; t < ACCESS_TYPE_COUNT; t++) {
+			uint count;
+			AccessCandidate *top = AccessStats_Top(stats, t, &count);
+			for(uint i = 0; i < count; i++) {
+				AccessStatsRow row = {.type = t, .id = top[i].id, .accesses = top[i].accesses};
+				pdata->rows = array_append(pdata->rows, row);
+			}
+			rm_free(top);
+		}
+	}
+
+	ctx->privateData = pdata;
+	return PROCEDURE_OK;
+}
+
+// Returns the name of an accessed label, relationship type or index, NULL for nodes.
+static const char *_EntityName(AccessType type, uint64_t id) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = NULL;
+	switch(type) {
+	case ACCESS_LABEL:
+	case ACCESS_INDEX:
+		// Indexes are named by the label they index.
+		s = GraphContext_GetSchemaByID(gc, id, SCHEMA_NODE);
+		break;
+	case ACCESS_RELATION:
+		s = GraphContext_GetSchemaByID(gc, id, SCHEMA_EDGE);
+		break;
+	default:
+		break;
+	}
+	return (s) ? s->name : NULL;
+}
+
+SIValue *Proc_AccessStatsStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+
+	AccessStatsContext *pdata = (AccessStatsContext *)ctx->privateData;
+
+	// Depleted?
+	if(pdata->idx >= array_len(pdata->rows)) return NULL;
+
+	AccessStatsRow *row = pdata->rows + pdata->idx++;
+	const char *name = _EntityName(row->type, row->id);
+	pdata->output[1] = SI_ConstStringVal((char *)_type_names[row->type]);
+	pdata->output[3] = SI_LongVal(row->id);
+	pdata->output[5] = (name) ? SI_ConstStringVal((char *)name) : SI_NullVal();
+	pdata->output[7] = SI_LongVal(row->accesses);
+	return pdata->output;
+}
+
+ProcedureResult Proc_AccessStatsFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		AccessStatsContext *pdata = ctx->privateData;
+		array_free(pdata->rows);
+		array_free(pdata->output);
+		rm_free(ctx->privateData);
+	}
+
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_AccessStatsCtx() {
+	void *privateData = NULL;
+	char *names[OUTPUT_COUNT] = {"type", "id", "name", "accesses"};
+	SIType types[OUTPUT_COUNT] = {T_STRING, T_INT64, T_STRING | T_NULL, T_INT64};
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, OUTPUT_COUNT);
+	for(int i = 0; i < OUTPUT_COUNT; i++) {
+		ProcedureOutput *output = rm_malloc(sizeof(ProcedureOutput));
+		output->name = names[i];
+		output->type = types[i];
+		outputs = array_append(outputs, output);
+	}
+
+	ProcedureCtx *ctx = ProcCtxNew("db.accessStats",
+								   0,
+								   outputs,
+								   Proc_AccessStatsStep,
+								   Proc_AccessStatsInvoke,
+								   Proc_AccessStatsFree,
+								   privateData,
+								   true);
+	return ctx;
+}
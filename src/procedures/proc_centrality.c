@@ -0,0 +1,154 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_centrality.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+#include "../algorithms/centrality.h"
+#include "../algorithms/subgraph_matrix.h"
+
+// CALL algo.betweenness(label, relationships, [sampleSize], [threads]) YIELD node, centrality
+// CALL algo.closeness(label, relationships, [sampleSize], [threads]) YIELD node, centrality
+// CALL algo.betweenness('Person', 'KNOWS', 1000, 8) YIELD node, centrality
+// A NULL label considers every node, NULL relationships consider every relationship type.
+// Searches start from sampleSize sources picked at random, every node when omitted, NULL or 0.
+// threads bounds the number of threads GraphBLAS computes with, its default when omitted, NULL or 0.
+
+typedef double *(*CentralityFunc)(GrB_Matrix A, const GrB_Index *sources,
+								  GrB_Index source_count, int nthreads);
+
+typedef struct {
+	Graph *g;                   // Graph.
+	Node node;                  // Node.
+	GrB_Index n;                // Number of considered nodes.
+	GrB_Index i;                // Next node to return.
+	GrB_Index *mappings;        // Mappings between matrix rows and node ids, NULL for identity.
+	double *scores;             // Centrality of each matrix row.
+	SIValue *output;            // Yielded values.
+} CentralityContext;
+
+static void _RaiseError(char *error) {
+	QueryCtx_SetError(error);
+	/* Raise the exception, we expect an exception handler to be set.
+	 * as procedure invocation is done at runtime. */
+	QueryCtx_RaiseRuntimeException();
+}
+
+// Optional arguments may be omitted or NULL.
+static inline bool _OptionalArg(const SIValue *args, uint arg_count, uint i) {
+	return (i < arg_count && SI_TYPE(args[i]) != T_NULL);
+}
+
+static ProcedureResult _CentralityInvoke(ProcedureCtx *ctx, const SIValue *args,
+										 CentralityFunc func) {
+	uint arg_count = array_len((SIValue *)args);
+	if(arg_count < 2 || arg_count > 4) return PROCEDURE_ERR;
+	if(!SubgraphMatrix_ValidArgs(args[0], args[1])) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, 2) && !(SI_TYPE(args[2]) & T_INT64)) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, 3) && !(SI_TYPE(args[3]) & T_INT64)) return PROCEDURE_ERR;
+
+	int64_t sample = _OptionalArg(args, arg_count, 2) ? args[2].longval : 0;
+	int64_t nthreads = _OptionalArg(args, arg_count, 3) ? args[3].longval : 0;
+	if(sample < 0 || nthreads < 0 || nthreads > INT32_MAX) {
+		char *error;
+		asprintf(&error, "%s sample size and thread count must be non-negative", ctx->name);
+		_RaiseError(error);
+	}
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	CentralityContext *pdata = rm_malloc(sizeof(CentralityContext));
+	pdata->g = gc->g;
+	pdata->n = 0;
+	pdata->i = 0;
+	pdata->mappings = NULL;
+	pdata->scores = NULL;
+	pdata->output = array_new(SIValue, 4);
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("node"));
+	pdata->output = array_append(pdata->output, SI_Node(NULL)); // Place holder.
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("centrality"));
+	pdata->output = array_append(pdata->output, SI_DoubleVal(0)); // Place holder.
+	ctx->privateData = pdata;
+
+	GrB_Matrix A = SubgraphMatrix_FromArgs(gc, args[0], args[1], &pdata->mappings, &pdata->n);
+	if(A != GrB_NULL) {
+		GrB_Index source_count;
+		GrB_Index *sources = Centrality_SampleSources(pdata->n, sample, &source_count);
+		pdata->scores = func(A, sources, source_count, nthreads);
+		rm_free(sources);
+		GrB_free(&A);
+		// Aborted, the query's error is set.
+		if(!pdata->scores) {
+			QueryCtx_RaiseRuntimeException();
+			return PROCEDURE_ERR;
+		}
+	}
+	return PROCEDURE_OK;
+}
+
+ProcedureResult Proc_BetweennessInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _CentralityInvoke(ctx, args, BetweennessCentrality);
+}
+
+ProcedureResult Proc_ClosenessInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _CentralityInvoke(ctx, args, ClosenessCentrality);
+}
+
+SIValue *Proc_CentralityStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+	CentralityContext *pdata = ctx->privateData;
+
+	// Depleted?
+	if(pdata->i >= pdata->n) return NULL;
+
+	GrB_Index i = pdata->i++;
+	NodeID id = (pdata->mappings) ? pdata->mappings[i] : i;
+	Graph_GetNode(pdata->g, id, &pdata->node);
+	pdata->output[1] = SI_Node(&pdata->node);
+	pdata->output[3] = SI_DoubleVal(pdata->scores[i]);
+	return pdata->output;
+}
+
+ProcedureResult Proc_CentralityFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		CentralityContext *pdata = ctx->privateData;
+		if(pdata->output) array_free(pdata->output);
+		if(pdata->mappings) rm_free(pdata->mappings);
+		if(pdata->scores) rm_free(pdata->scores);
+		rm_free(pdata);
+	}
+	return PROCEDURE_OK;
+}
+
+static ProcedureOutput **_Outputs(void) {
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, 2);
+	ProcedureOutput *output_node = rm_malloc(sizeof(ProcedureOutput));
+	ProcedureOutput *output_centrality = rm_malloc(sizeof(ProcedureOutput));
+	output_node->name = "node";
+	output_node->type = T_NODE;
+	output_centrality->name = "centrality";
+	output_centrality->type = T_DOUBLE;
+	outputs = array_append(outputs, output_node);
+	outputs = array_append(outputs, output_centrality);
+	return outputs;
+}
+
+ProcedureCtx *Proc_BetweennessGen() {
+	void *privateData = NULL;
+	return ProcCtxNew("algo.betweenness", PROCEDURE_VARIABLE_ARG_COUNT, _Outputs(),
+					  Proc_CentralityStep, Proc_BetweennessInvoke, Proc_CentralityFree,
+					  privateData, true);
+}
+
+ProcedureCtx *Proc_ClosenessGen() {
+	void *privateData = NULL;
+	return ProcCtxNew("algo.closeness", PROCEDURE_VARIABLE_ARG_COUNT, _Outputs(),
+					  Proc_CentralityStep, Proc_ClosenessInvoke, Proc_CentralityFree,
+					  privateData, true);
+}
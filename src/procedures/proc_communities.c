@@ -0,0 +1,254 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_communities.h"
+#include "proc_write_back.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+#include "../algorithms/communities.h"
+#include "../algorithms/subgraph_matrix.h"
+
+// CALL algo.labelPropagation(label, relationships, [maxIterations]) YIELD node, communityId
+// CALL algo.labelPropagation.write(label, relationships, property, [maxIterations]) YIELD nodes, communities, iterations
+// CALL algo.louvain(label, relationships, [maxIterations], [tolerance]) YIELD node, communityId
+// CALL algo.louvain.write(label, relationships, property, [maxIterations], [tolerance]) YIELD nodes, communities, modularity
+// CALL algo.louvain('Person', ['KNOWS', 'WORKS_WITH'], 10, 0.0001) YIELD node, communityId
+// A NULL label considers every node, NULL relationships consider every relationship type,
+// omitted or NULL optional arguments take their defaults.
+// Each community is identified by the smallest ID of its nodes.
+
+#define LABEL_PROPAGATION_ITERMAX 20
+#define LOUVAIN_ITERMAX 20
+#define LOUVAIN_TOLERANCE 1e-6
+
+typedef enum {
+	COMMUNITIES_LABEL_PROPAGATION,
+	COMMUNITIES_LOUVAIN,
+} CommunitiesAlgorithm;
+
+typedef struct {
+	Graph *g;                   // Graph.
+	Node node;                  // Node.
+	GrB_Index n;                // Number of considered nodes.
+	GrB_Index i;                // Next node to return.
+	GrB_Index *mappings;        // Mappings between matrix rows and node ids, NULL for identity.
+	GrB_Index *communities;     // Community of each matrix row.
+	SIValue *output;            // Yielded values.
+} CommunitiesContext;
+
+static void _RaiseError(char *error) {
+	QueryCtx_SetError(error);
+	/* Raise the exception, we expect an exception handler to be set.
+	 * as procedure invocation is done at runtime. */
+	QueryCtx_RaiseRuntimeException();
+}
+
+// Optional arguments may be omitted or NULL.
+static inline bool _OptionalArg(const SIValue *args, uint arg_count, uint i) {
+	return (i < arg_count && SI_TYPE(args[i]) != T_NULL);
+}
+
+static inline NodeID _NodeID(const CommunitiesContext *pdata, GrB_Index i) {
+	return (pdata->mappings) ? pdata->mappings[i] : i;
+}
+
+static ProcedureResult _CommunitiesInvoke(ProcedureCtx *ctx, const SIValue *args,
+										  CommunitiesAlgorithm algorithm, bool write) {
+	// Optional arguments follow the written property.
+	uint opt = (write) ? 3 : 2;
+	uint opt_count = (algorithm == COMMUNITIES_LOUVAIN) ? 2 : 1;
+	uint arg_count = array_len((SIValue *)args);
+	if(arg_count < opt || arg_count > opt + opt_count) return PROCEDURE_ERR;
+	if(!SubgraphMatrix_ValidArgs(args[0], args[1])) return PROCEDURE_ERR;
+	if(write && !(SI_TYPE(args[2]) & T_STRING)) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, opt) && !(SI_TYPE(args[opt]) & T_INT64)) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, opt + 1) &&
+	   !(SI_TYPE(args[opt + 1]) & SI_NUMERIC)) return PROCEDURE_ERR;
+
+	int64_t max_iterations = (algorithm == COMMUNITIES_LOUVAIN) ?
+							 LOUVAIN_ITERMAX : LABEL_PROPAGATION_ITERMAX;
+	double tolerance = LOUVAIN_TOLERANCE;
+	if(_OptionalArg(args, arg_count, opt)) max_iterations = args[opt].longval;
+	if(_OptionalArg(args, arg_count, opt + 1)) tolerance = SI_GET_NUMERIC(args[opt + 1]);
+	if(max_iterations <= 0 || max_iterations > UINT32_MAX || tolerance < 0) {
+		char *error;
+		asprintf(&error, "%s expects a positive number of iterations and a non-negative tolerance",
+				 ctx->name);
+		_RaiseError(error);
+	}
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	const char *property = (write) ? args[2].stringval : NULL;
+	if(property) ProcWriteBack_ValidateProperty(gc, property, "communities");
+
+	// Setup context.
+	CommunitiesContext *pdata = rm_calloc(1, sizeof(CommunitiesContext));
+	pdata->g = gc->g;
+	pdata->output = array_new(SIValue, 6);
+	if(write) {
+		pdata->output = array_append(pdata->output, SI_ConstStringVal("nodes"));
+		pdata->output = array_append(pdata->output, SI_LongVal(0)); // Place holder.
+		pdata->output = array_append(pdata->output, SI_ConstStringVal("communities"));
+		pdata->output = array_append(pdata->output, SI_LongVal(0)); // Place holder.
+		if(algorithm == COMMUNITIES_LOUVAIN) {
+			pdata->output = array_append(pdata->output, SI_ConstStringVal("modularity"));
+			pdata->output = array_append(pdata->output, SI_DoubleVal(0)); // Place holder.
+		} else {
+			pdata->output = array_append(pdata->output, SI_ConstStringVal("iterations"));
+			pdata->output = array_append(pdata->output, SI_LongVal(0)); // Place holder.
+		}
+	} else {
+		pdata->output = array_append(pdata->output, SI_ConstStringVal("node"));
+		pdata->output = array_append(pdata->output, SI_Node(NULL)); // Place holder.
+		pdata->output = array_append(pdata->output, SI_ConstStringVal("communityId"));
+		pdata->output = array_append(pdata->output, SI_LongVal(0)); // Place holder.
+	}
+	ctx->privateData = pdata;
+
+	uint iterations = 0;
+	double modularity = 0;
+	GrB_Matrix A = SubgraphMatrix_FromArgs(gc, args[0], args[1], &pdata->mappings, &pdata->n);
+	if(A != GrB_NULL) {
+		if(algorithm == COMMUNITIES_LOUVAIN) {
+			pdata->communities = Louvain(A, max_iterations, tolerance, &modularity);
+		} else {
+			pdata->communities = LabelPropagation(A, max_iterations, &iterations);
+		}
+		GrB_free(&A);
+		// Aborted, the query's error is set.
+		if(!pdata->communities) {
+			QueryCtx_RaiseRuntimeException();
+			return PROCEDURE_ERR;
+		}
+	}
+	if(!write) return PROCEDURE_OK;
+
+	// Write mode, yields a single summary record.
+	int64_t community_count = 0;
+	for(GrB_Index i = 0; i < pdata->n; i++) community_count += (pdata->communities[i] == i);
+	if(pdata->n > 0) {
+		int64_t *values = rm_malloc(sizeof(int64_t) * pdata->n);
+		for(GrB_Index i = 0; i < pdata->n; i++) values[i] = _NodeID(pdata, pdata->communities[i]);
+		QueryCtx_LockForCommit();
+		ProcWriteBack_Nodes(gc, GraphContext_FindOrAddAttribute(gc, property), pdata->mappings,
+							values, pdata->n);
+		rm_free(values);
+	}
+	pdata->output[1] = SI_LongVal(pdata->n);
+	pdata->output[3] = SI_LongVal(community_count);
+	pdata->output[5] = (algorithm == COMMUNITIES_LOUVAIN) ? SI_DoubleVal(modularity) :
+					   SI_LongVal(iterations);
+	return PROCEDURE_OK;
+}
+
+ProcedureResult Proc_LabelPropagationInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _CommunitiesInvoke(ctx, args, COMMUNITIES_LABEL_PROPAGATION, false);
+}
+
+ProcedureResult Proc_LabelPropagationWriteInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _CommunitiesInvoke(ctx, args, COMMUNITIES_LABEL_PROPAGATION, true);
+}
+
+ProcedureResult Proc_LouvainInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _CommunitiesInvoke(ctx, args, COMMUNITIES_LOUVAIN, false);
+}
+
+ProcedureResult Proc_LouvainWriteInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _CommunitiesInvoke(ctx, args, COMMUNITIES_LOUVAIN, true);
+}
+
+SIValue *Proc_CommunitiesStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+	CommunitiesContext *pdata = ctx->privateData;
+
+	// Depleted?
+	if(pdata->i >= pdata->n) return NULL;
+
+	GrB_Index i = pdata->i++;
+	Graph_GetNode(pdata->g, _NodeID(pdata, i), &pdata->node);
+	pdata->output[1] = SI_Node(&pdata->node);
+	pdata->output[3] = SI_LongVal(_NodeID(pdata, pdata->communities[i]));
+	return pdata->output;
+}
+
+SIValue *Proc_CommunitiesWriteStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+	CommunitiesContext *pdata = ctx->privateData;
+
+	// A single summary record.
+	if(pdata->i > 0) return NULL;
+	pdata->i = 1;
+	return pdata->output;
+}
+
+ProcedureResult Proc_CommunitiesFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		CommunitiesContext *pdata = ctx->privateData;
+		if(pdata->output) array_free(pdata->output);
+		if(pdata->mappings) rm_free(pdata->mappings);
+		if(pdata->communities) rm_free(pdata->communities);
+		rm_free(pdata);
+	}
+	return PROCEDURE_OK;
+}
+
+static ProcedureOutput *_Output(const char *name, SIType type) {
+	ProcedureOutput *output = rm_malloc(sizeof(ProcedureOutput));
+	output->name = (char *)name;
+	output->type = type;
+	return output;
+}
+
+static ProcedureOutput **_StreamOutputs(void) {
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, 2);
+	outputs = array_append(outputs, _Output("node", T_NODE));
+	outputs = array_append(outputs, _Output("communityId", T_INT64));
+	return outputs;
+}
+
+static ProcedureOutput **_WriteOutputs(CommunitiesAlgorithm algorithm) {
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, 3);
+	outputs = array_append(outputs, _Output("nodes", T_INT64));
+	outputs = array_append(outputs, _Output("communities", T_INT64));
+	if(algorithm == COMMUNITIES_LOUVAIN) {
+		outputs = array_append(outputs, _Output("modularity", T_DOUBLE));
+	} else {
+		outputs = array_append(outputs, _Output("iterations", T_INT64));
+	}
+	return outputs;
+}
+
+ProcedureCtx *Proc_LabelPropagationGen() {
+	void *privateData = NULL;
+	return ProcCtxNew("algo.labelPropagation", PROCEDURE_VARIABLE_ARG_COUNT, _StreamOutputs(),
+					  Proc_CommunitiesStep, Proc_LabelPropagationInvoke, Proc_CommunitiesFree,
+					  privateData, true);
+}
+
+ProcedureCtx *Proc_LabelPropagationWriteGen() {
+	void *privateData = NULL;
+	return ProcCtxNew("algo.labelPropagation.write", PROCEDURE_VARIABLE_ARG_COUNT,
+					  _WriteOutputs(COMMUNITIES_LABEL_PROPAGATION), Proc_CommunitiesWriteStep,
+					  Proc_LabelPropagationWriteInvoke, Proc_CommunitiesFree, privateData, false);
+}
+
+ProcedureCtx *Proc_LouvainGen() {
+	void *privateData = NULL;
+	return ProcCtxNew("algo.louvain", PROCEDURE_VARIABLE_ARG_COUNT, _StreamOutputs(),
+					  Proc_CommunitiesStep, Proc_LouvainInvoke, Proc_CommunitiesFree,
+					  privateData, true);
+}
+
+ProcedureCtx *Proc_LouvainWriteGen() {
+	void *privateData = NULL;
+	return ProcCtxNew("algo.louvain.write", PROCEDURE_VARIABLE_ARG_COUNT,
+					  _WriteOutputs(COMMUNITIES_LOUVAIN), Proc_CommunitiesWriteStep,
+					  Proc_LouvainWriteInvoke, Proc_CommunitiesFree, privateData, false);
+}
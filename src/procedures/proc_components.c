@@ -0,0 +1,201 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_components.h"
+#include "proc_write_back.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+#include "../algorithms/components.h"
+#include "../algorithms/subgraph_matrix.h"
+
+// CALL algo.wcc(label, relationships) YIELD node, componentId
+// CALL algo.scc(label, relationships) YIELD node, componentId
+// CALL algo.wcc.write(label, relationships, property) YIELD nodes, components
+// CALL algo.scc.write(label, relationships, property) YIELD nodes, components
+// CALL algo.wcc('Person', ['KNOWS', 'WORKS_WITH']) YIELD node, componentId
+// A NULL label considers every node, NULL relationships consider every relationship type.
+// Each component is identified by the smallest ID of its nodes.
+
+typedef GrB_Index *(*ComponentsFunc)(GrB_Matrix A);
+
+typedef struct {
+	Graph *g;                   // Graph.
+	Node node;                  // Node.
+	GrB_Index n;                // Number of considered nodes.
+	GrB_Index i;                // Next node to return.
+	GrB_Index *mappings;        // Mappings between matrix rows and node ids, NULL for identity.
+	GrB_Index *components;      // Component of each matrix row.
+	SIValue *output;            // Yielded values.
+} ComponentsContext;
+
+static inline NodeID _NodeID(const ComponentsContext *pdata, GrB_Index i) {
+	return (pdata->mappings) ? pdata->mappings[i] : i;
+}
+
+// Sets attribute of each considered node to its component.
+static void _WriteComponents(GraphContext *gc, ComponentsContext *pdata, Attribute_ID attr) {
+	int64_t *values = rm_malloc(sizeof(int64_t) * pdata->n);
+	for(GrB_Index i = 0; i < pdata->n; i++) values[i] = _NodeID(pdata, pdata->components[i]);
+	ProcWriteBack_Nodes(gc, attr, pdata->mappings, values, pdata->n);
+	rm_free(values);
+}
+
+static ProcedureResult _ComponentsInvoke(ProcedureCtx *ctx, const SIValue *args,
+										 ComponentsFunc func, bool write) {
+	uint arg_count = array_len((SIValue *)args);
+	if(arg_count != (write ? 3 : 2)) return PROCEDURE_ERR;
+	if(!SubgraphMatrix_ValidArgs(args[0], args[1])) return PROCEDURE_ERR;
+	if(write && !(SI_TYPE(args[2]) & T_STRING)) return PROCEDURE_ERR;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	const char *property = (write) ? args[2].stringval : NULL;
+	if(property) ProcWriteBack_ValidateProperty(gc, property, "components");
+
+	// Setup context.
+	ComponentsContext *pdata = rm_calloc(1, sizeof(ComponentsContext));
+	pdata->g = gc->g;
+	pdata->output = array_new(SIValue, 4);
+	if(write) {
+		pdata->output = array_append(pdata->output, SI_ConstStringVal("nodes"));
+		pdata->output = array_append(pdata->output, SI_LongVal(0)); // Place holder.
+		pdata->output = array_append(pdata->output, SI_ConstStringVal("components"));
+		pdata->output = array_append(pdata->output, SI_LongVal(0)); // Place holder.
+	} else {
+		pdata->output = array_append(pdata->output, SI_ConstStringVal("node"));
+		pdata->output = array_append(pdata->output, SI_Node(NULL)); // Place holder.
+		pdata->output = array_append(pdata->output, SI_ConstStringVal("componentId"));
+		pdata->output = array_append(pdata->output, SI_LongVal(0)); // Place holder.
+	}
+	ctx->privateData = pdata;
+
+	GrB_Matrix A = SubgraphMatrix_FromArgs(gc, args[0], args[1], &pdata->mappings, &pdata->n);
+	if(A != GrB_NULL) {
+		pdata->components = func(A);
+		GrB_free(&A);
+		// Aborted, the query's error is set.
+		if(!pdata->components) {
+			QueryCtx_RaiseRuntimeException();
+			return PROCEDURE_ERR;
+		}
+	}
+	if(!write) return PROCEDURE_OK;
+
+	// Write mode, yields a single summary record.
+	int64_t component_count = 0;
+	for(GrB_Index i = 0; i < pdata->n; i++) component_count += (pdata->components[i] == i);
+	if(pdata->n > 0) {
+		QueryCtx_LockForCommit();
+		_WriteComponents(gc, pdata, GraphContext_FindOrAddAttribute(gc, property));
+	}
+	pdata->output[1] = SI_LongVal(pdata->n);
+	pdata->output[3] = SI_LongVal(component_count);
+	return PROCEDURE_OK;
+}
+
+ProcedureResult Proc_WCCInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _ComponentsInvoke(ctx, args, WeaklyConnectedComponents, false);
+}
+
+ProcedureResult Proc_SCCInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _ComponentsInvoke(ctx, args, StronglyConnectedComponents, false);
+}
+
+ProcedureResult Proc_WCCWriteInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _ComponentsInvoke(ctx, args, WeaklyConnectedComponents, true);
+}
+
+ProcedureResult Proc_SCCWriteInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _ComponentsInvoke(ctx, args, StronglyConnectedComponents, true);
+}
+
+SIValue *Proc_ComponentsStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+	ComponentsContext *pdata = ctx->privateData;
+
+	// Depleted?
+	if(pdata->i >= pdata->n) return NULL;
+
+	GrB_Index i = pdata->i++;
+	Graph_GetNode(pdata->g, _NodeID(pdata, i), &pdata->node);
+	pdata->output[1] = SI_Node(&pdata->node);
+	pdata->output[3] = SI_LongVal(_NodeID(pdata, pdata->components[i]));
+	return pdata->output;
+}
+
+SIValue *Proc_ComponentsWriteStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+	ComponentsContext *pdata = ctx->privateData;
+
+	// A single summary record.
+	if(pdata->i > 0) return NULL;
+	pdata->i = 1;
+	return pdata->output;
+}
+
+ProcedureResult Proc_ComponentsFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		ComponentsContext *pdata = ctx->privateData;
+		if(pdata->output) array_free(pdata->output);
+		if(pdata->mappings) rm_free(pdata->mappings);
+		if(pdata->components) rm_free(pdata->components);
+		rm_free(pdata);
+	}
+	return PROCEDURE_OK;
+}
+
+static ProcedureOutput **_StreamOutputs(void) {
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, 2);
+	ProcedureOutput *output_node = rm_malloc(sizeof(ProcedureOutput));
+	ProcedureOutput *output_component = rm_malloc(sizeof(ProcedureOutput));
+	output_node->name = "node";
+	output_node->type = T_NODE;
+	output_component->name = "componentId";
+	output_component->type = T_INT64;
+	outputs = array_append(outputs, output_node);
+	outputs = array_append(outputs, output_component);
+	return outputs;
+}
+
+static ProcedureOutput **_WriteOutputs(void) {
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, 2);
+	ProcedureOutput *output_nodes = rm_malloc(sizeof(ProcedureOutput));
+	ProcedureOutput *output_components = rm_malloc(sizeof(ProcedureOutput));
+	output_nodes->name = "nodes";
+	output_nodes->type = T_INT64;
+	output_components->name = "components";
+	output_components->type = T_INT64;
+	outputs = array_append(outputs, output_nodes);
+	outputs = array_append(outputs, output_components);
+	return outputs;
+}
+
+ProcedureCtx *Proc_WCCGen() {
+	void *privateData = NULL;
+	return ProcCtxNew("algo.wcc", 2, _StreamOutputs(), Proc_ComponentsStep, Proc_WCCInvoke,
+					  Proc_ComponentsFree, privateData, true);
+}
+
+ProcedureCtx *Proc_SCCGen() {
+	void *privateData = NULL;
+	return ProcCtxNew("algo.scc", 2, _StreamOutputs(), Proc_ComponentsStep, Proc_SCCInvoke,
+					  Proc_ComponentsFree, privateData, true);
+}
+
+ProcedureCtx *Proc_WCCWriteGen() {
+	void *privateData = NULL;
+	return ProcCtxNew("algo.wcc.write", 3, _WriteOutputs(), Proc_ComponentsWriteStep,
+					  Proc_WCCWriteInvoke, Proc_ComponentsFree, privateData, false);
+}
+
+ProcedureCtx *Proc_SCCWriteGen() {
+	void *privateData = NULL;
+	return ProcCtxNew("algo.scc.write", 3, _WriteOutputs(), Proc_ComponentsWriteStep,
+					  Proc_SCCWriteInvoke, Proc_ComponentsFree, privateData, false);
+}
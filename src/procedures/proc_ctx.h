@@ -53,6 +53,9 @@ struct ProcedureCtx {
 	ProcInvoke Invoke;          //
 	ProcFree Free;              //
 	bool readOnly;              // Indicates if the procedure is able to mutate the graph.
+	bool *yields;               // Outputs consumed by the caller, NULL if all are.
+	uint64_t limit;             // Maximum number of records to produce, 0 for unbounded.
+	uint64_t produced;          // Number of records produced so far.
 };
 typedef struct ProcedureCtx ProcedureCtx;
 
@@ -0,0 +1,55 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_edge_drop_index.h"
+#include "../query_ctx.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// edge drop index
+//------------------------------------------------------------------------------
+
+// CALL db.idx.edge.drop(relationship, field)
+// CALL db.idx.edge.drop('TRANSFER', 'ts')
+
+ProcedureResult Proc_EdgeDropIdxInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 2) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING) || !(SI_TYPE(args[1]) & T_STRING)) return PROCEDURE_ERR;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	if(GraphContext_DeleteEdgeIndex(gc, args[0].stringval, args[1].stringval) == INDEX_FAIL) {
+		return PROCEDURE_ERR;
+	}
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_EdgeDropIdxStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_EdgeDropIdxFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_EdgeDropIdxGen() {
+	void *privateData = NULL;
+	ProcedureOutput **output = array_new(ProcedureOutput *, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.idx.edge.drop",
+								   2,
+								   output,
+								   Proc_EdgeDropIdxStep,
+								   Proc_EdgeDropIdxInvoke,
+								   Proc_EdgeDropIdxFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
@@ -0,0 +1,63 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_edge_ttl_set.h"
+#include "../query_ctx.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// ttl.edge.set
+//------------------------------------------------------------------------------
+
+// CALL db.ttl.edge.set(relationship, attribute, seconds)
+// CALL db.ttl.edge.set('VISITED', 'ts', 86400)
+// Expires the relationship type's edges seconds past the millisecond timestamp held by attribute,
+// 0 seconds disables expiry.
+
+ProcedureResult Proc_EdgeTTLSetInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 3) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING) || !(SI_TYPE(args[1]) & T_STRING) ||
+	   !(SI_TYPE(args[2]) & T_INT64) || args[2].longval < 0) return PROCEDURE_ERR;
+
+	const char *relation = args[0].stringval;
+	const char *attribute = args[1].stringval;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	// Schemas are read by the reaper, readers are locked out.
+	QueryCtx_LockForCommit();
+	GraphContext_SetExpiry(gc, relation, SCHEMA_EDGE, attribute, args[2].longval);
+	// Replicated, such that a promoted replica keeps expiring entities.
+	QueryCtx_GetResultSetStatistics()->schemas_modified++;
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_EdgeTTLSetStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_EdgeTTLSetFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_EdgeTTLSetGen() {
+	void *privateData = NULL;
+	ProcedureOutput **output = array_new(ProcedureOutput *, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.ttl.edge.set",
+								   3,
+								   output,
+								   Proc_EdgeTTLSetStep,
+								   Proc_EdgeTTLSetInvoke,
+								   Proc_EdgeTTLSetFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
@@ -0,0 +1,59 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_fulltext_set_async.h"
+#include "../query_ctx.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// fulltext setAsync
+//------------------------------------------------------------------------------
+
+// CALL db.idx.fulltext.setAsync(label, enabled)
+// CALL db.idx.fulltext.setAsync('books', true)
+
+ProcedureResult Proc_FulltextSetAsyncInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 2) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING) || !(SI_TYPE(args[1]) & T_BOOL)) return PROCEDURE_ERR;
+
+	const char *label = args[0].stringval;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Index *idx = GraphContext_GetIndex(gc, label, NULL, IDX_FULLTEXT);
+	if(idx == NULL) return PROCEDURE_ERR;
+
+	// Disabling background updates applies pending updates, readers are locked out.
+	QueryCtx_LockForCommit();
+	Index_SetAsync(idx, args[1].longval);
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_FulltextSetAsyncStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_FulltextSetAsyncFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_FulltextSetAsyncGen() {
+	void *privateData = NULL;
+	ProcedureOutput **output = array_new(ProcedureOutput *, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.idx.fulltext.setAsync",
+								   2,
+								   output,
+								   Proc_FulltextSetAsyncStep,
+								   Proc_FulltextSetAsyncInvoke,
+								   Proc_FulltextSetAsyncFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
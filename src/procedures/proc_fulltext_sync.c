@@ -0,0 +1,63 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_fulltext_sync.h"
+#include "../query_ctx.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// fulltext sync
+//------------------------------------------------------------------------------
+
+/* Applies the pending updates of an asynchronous fulltext index,
+ * such that following queries observe all committed writes.
+ * CALL db.idx.fulltext.sync(label)
+ * CALL db.idx.fulltext.sync('books') */
+
+ProcedureResult Proc_FulltextSyncInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 1) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING)) return PROCEDURE_ERR;
+
+	const char *label = args[0].stringval;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Index *idx = GraphContext_GetIndex(gc, label, NULL, IDX_FULLTEXT);
+	if(idx == NULL) return PROCEDURE_ERR;
+
+	if(Index_PendingCount(idx) > 0) {
+		// Readers are locked out while documents are updated.
+		QueryCtx_LockForCommit();
+		Index_ApplyPending(idx);
+	}
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_FulltextSyncStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_FulltextSyncFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_FulltextSyncGen() {
+	void *privateData = NULL;
+	ProcedureOutput **output = array_new(ProcedureOutput *, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.idx.fulltext.sync",
+								   1,
+								   output,
+								   Proc_FulltextSyncStep,
+								   Proc_FulltextSyncInvoke,
+								   Proc_FulltextSyncFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
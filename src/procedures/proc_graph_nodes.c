@@ -0,0 +1,155 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_graph_nodes.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// db.graph.nodes
+//------------------------------------------------------------------------------
+
+// CALL db.graph.nodes(graph, label, [property, ...]) YIELD id, values
+
+typedef struct {
+	GraphContext *gc;           // Scanned graph, NULL once released.
+	bool locked;                // Whether the scanned graph's read lock is held.
+	IDSetIterator iter;         // Iterator over the label's nodes, set is NULL if the label doesn't exist.
+	Attribute_ID *attrs;        // Attributes of the produced property values.
+	bool yield_values;          // Whether property values are produced.
+	SIValue *output;            // Output pairs.
+} GraphNodesContext;
+
+/* Release the scanned graph, values produced so far were copied,
+ * such that they outlive the graph's read lock. */
+static void _GraphNodes_Release(GraphNodesContext *pdata) {
+	if(!pdata->gc) return;
+	pdata->iter.set = NULL;
+	if(pdata->locked) Graph_ReleaseLock(pdata->gc->g);
+	GraphContext_Release(pdata->gc);
+	pdata->gc = NULL;
+}
+
+ProcedureResult Proc_GraphNodesInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 3) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING)) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[1]) & T_STRING)) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[2]) & T_ARRAY)) return PROCEDURE_ERR;
+	uint prop_count = SIArray_Length(args[2]);
+	for(uint i = 0; i < prop_count; i++) {
+		if(!(SI_TYPE(SIArray_Get(args[2], i)) & T_STRING)) return PROCEDURE_ERR;
+	}
+
+	ctx->privateData = NULL;
+	const char *graph_name = args[0].stringval;
+	GraphContext *gc = QueryCtx_RetrieveGraph(graph_name);
+	if(!gc) {
+		char *error;
+		asprintf(&error, "Graph %s does not exist", graph_name);
+		QueryCtx_SetError(error);
+		// Procedure invocation is done at runtime, we expect an exception handler to be set.
+		QueryCtx_RaiseRuntimeException();
+	}
+
+	ctx->privateData = rm_malloc(sizeof(GraphNodesContext));
+	GraphNodesContext *pdata = ctx->privateData;
+	pdata->gc = gc;
+	pdata->iter.set = NULL;
+	pdata->yield_values = Proc_Yields(ctx, "values");
+
+	/* The scanned graph is read locked until the scan is depleted,
+	 * the query's own graph is already locked by the query. */
+	pdata->locked = (gc != QueryCtx_GetGraphCtx());
+	if(pdata->locked) Graph_AcquireReadLock(gc->g);
+
+	// Attributes are resolved against the scanned graph.
+	pdata->attrs = array_new(Attribute_ID, prop_count);
+	for(uint i = 0; i < prop_count; i++) {
+		const char *prop = SIArray_Get(args[2], i).stringval;
+		pdata->attrs = array_append(pdata->attrs, GraphContext_GetAttributeID(gc, prop));
+	}
+
+	Schema *s = GraphContext_GetSchema(gc, args[1].stringval, SCHEMA_NODE);
+	if(s) IDSet_Iterate(Graph_GetLabelIDs(gc->g, s->id), &pdata->iter);
+
+	pdata->output = array_new(SIValue, 4);
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("id"));
+	pdata->output = array_append(pdata->output, SI_NullVal()); // Place holder.
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("values"));
+	pdata->output = array_append(pdata->output, SI_NullVal()); // Place holder.
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_GraphNodesStep(ProcedureCtx *ctx) {
+	GraphNodesContext *pdata = (GraphNodesContext *)ctx->privateData;
+	if(!pdata || !pdata->iter.set) return NULL;
+
+	GrB_Index id;
+	if(!IDSetIterator_Next(&pdata->iter, &id)) {
+		// Writers of the scanned graph aren't held back until the query completes.
+		_GraphNodes_Release(pdata);
+		return NULL;
+	}
+
+	pdata->output[1] = SI_LongVal(id);
+	if(pdata->yield_values) {
+		Node n;
+		Graph_GetNode(pdata->gc->g, id, &n);
+		uint prop_count = array_len(pdata->attrs);
+		// The values are owned by the record they're yielded into.
+		SIValue values = SIArray_New(prop_count);
+		for(uint i = 0; i < prop_count; i++) {
+			SIValue *v = PROPERTY_NOTFOUND;
+			if(pdata->attrs[i] != ATTRIBUTE_NOTFOUND) {
+				v = GraphEntity_GetProperty((GraphEntity *)&n, pdata->attrs[i]);
+			}
+			SIArray_Append(&values, (v == PROPERTY_NOTFOUND) ? SI_NullVal() : *v);
+		}
+		pdata->output[3] = values;
+	}
+	return pdata->output;
+}
+
+ProcedureResult Proc_GraphNodesFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(!ctx->privateData) return PROCEDURE_OK;
+
+	GraphNodesContext *pdata = ctx->privateData;
+	_GraphNodes_Release(pdata);
+	array_free(pdata->attrs);
+	array_free(pdata->output);
+	rm_free(pdata);
+
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_GraphNodesGen() {
+	void *privateData = NULL;
+	ProcedureOutput **output = array_new(ProcedureOutput *, 2);
+	ProcedureOutput *out_id = rm_malloc(sizeof(ProcedureOutput));
+	out_id->name = "id";
+	out_id->type = T_INT64;
+	ProcedureOutput *out_values = rm_malloc(sizeof(ProcedureOutput));
+	out_values->name = "values";
+	out_values->type = T_ARRAY;
+
+	output = array_append(output, out_id);
+	output = array_append(output, out_values);
+	ProcedureCtx *ctx = ProcCtxNew("db.graph.nodes",
+								   3,
+								   output,
+								   Proc_GraphNodesStep,
+								   Proc_GraphNodesInvoke,
+								   Proc_GraphNodesFree,
+								   privateData,
+								   true);
+	return ctx;
+}
@@ -0,0 +1,146 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_khop.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+#include "../graph/graphcontext.h"
+#include "../algorithms/reachable_nodes.h"
+#include "../algorithms/subgraph_matrix.h"
+#include <strings.h>
+
+// CALL algo.kHop(node, k, [relationships], [direction], [limit]) YIELD node, distance
+// MATCH (a:Person {name: 'Alice'}) CALL algo.kHop(a, 3, 'KNOWS', 'BOTH', 1000) YIELD node, distance
+// Yields the distinct nodes within k hops of node, closest first, alongside their distance.
+// NULL relationships consider every relationship type, direction is one of
+// 'OUTGOING' (default), 'INCOMING' or 'BOTH', limit bounds the number of yielded nodes.
+// Levels are expanded as their nodes are consumed.
+
+typedef struct {
+	Graph *g;                   // Graph.
+	Node node;                  // Node.
+	ReachableNodesIter *iter;   // Reached nodes iterator, NULL if nothing is reachable.
+	int *relations;             // Traversed relation IDs.
+	uint64_t limit;             // Maximum number of nodes to yield, 0 for unbounded.
+	uint64_t yielded;           // Number of nodes yielded so far.
+	SIValue *output;            // Array with 4 entries ["node", node, "distance", distance].
+} KHopContext;
+
+static void _RaiseError(char *error) {
+	QueryCtx_SetError(error);
+	/* Raise the exception, we expect an exception handler to be set.
+	 * as procedure invocation is done at runtime. */
+	QueryCtx_RaiseRuntimeException();
+}
+
+// Optional arguments may be omitted or NULL.
+static inline bool _OptionalArg(const SIValue *args, uint arg_count, uint i) {
+	return (i < arg_count && SI_TYPE(args[i]) != T_NULL);
+}
+
+ProcedureResult Proc_KHopInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	uint arg_count = array_len((SIValue *)args);
+	if(arg_count < 2 || arg_count > 5) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_NODE)) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[1]) & T_INT64)) return PROCEDURE_ERR;
+	SIValue relations = (arg_count > 2) ? args[2] : SI_NullVal();
+	if(!SubgraphMatrix_ValidArgs(SI_NullVal(), relations)) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, 3) && !(SI_TYPE(args[3]) & T_STRING)) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, 4) && !(SI_TYPE(args[4]) & T_INT64)) return PROCEDURE_ERR;
+
+	int64_t k = args[1].longval;
+	int64_t limit = _OptionalArg(args, arg_count, 4) ? args[4].longval : 0;
+	GRAPH_EDGE_DIR dir = GRAPH_EDGE_DIR_OUTGOING;
+	char *error = NULL;
+	if(_OptionalArg(args, arg_count, 3)) {
+		const char *direction = args[3].stringval;
+		if(strcasecmp(direction, "OUTGOING") == 0) dir = GRAPH_EDGE_DIR_OUTGOING;
+		else if(strcasecmp(direction, "INCOMING") == 0) dir = GRAPH_EDGE_DIR_INCOMING;
+		else if(strcasecmp(direction, "BOTH") == 0) dir = GRAPH_EDGE_DIR_BOTH;
+		else asprintf(&error, "kHop direction must be 'OUTGOING', 'INCOMING' or 'BOTH'");
+	}
+	if(k < 0 || k > UINT32_MAX) asprintf(&error, "kHop k must be non-negative");
+	else if(limit < 0) asprintf(&error, "kHop limit must be non-negative");
+	if(error) _RaiseError(error);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	KHopContext *pdata = rm_malloc(sizeof(KHopContext));
+	pdata->g = gc->g;
+	pdata->iter = NULL;
+	pdata->relations = NULL;
+	pdata->yielded = 0;
+	pdata->limit = limit;
+	pdata->output = array_new(SIValue, 4);
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("node"));
+	pdata->output = array_append(pdata->output, SI_Node(NULL)); // Place holder.
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("distance"));
+	pdata->output = array_append(pdata->output, SI_LongVal(0)); // Place holder.
+	ctx->privateData = pdata;
+
+	int label;
+	assert(SubgraphMatrix_ResolveArgs(gc, SI_NullVal(), relations, &label, &pdata->relations));
+	if(pdata->relations == NULL) {
+		// Traverse every relationship type.
+		int relation_count = Graph_RelationTypeCount(gc->g);
+		pdata->relations = array_new(int, relation_count);
+		for(int i = 0; i < relation_count; i++) pdata->relations = array_append(pdata->relations, i);
+	}
+
+	if(array_len(pdata->relations) == 0) return PROCEDURE_OK;
+	NodeID src = ENTITY_GET_ID((Node *)args[0].ptrval);
+	pdata->iter = ReachableNodesIter_New(gc->g, src, pdata->relations,
+										 array_len(pdata->relations), dir, k);
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_KHopStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+	KHopContext *pdata = ctx->privateData;
+
+	// Depleted?
+	if(!pdata->iter) return NULL;
+	if(pdata->limit && pdata->yielded >= pdata->limit) return NULL;
+
+	NodeID id;
+	unsigned int distance;
+	if(!ReachableNodesIter_Next(pdata->iter, &id, &distance)) return NULL;
+	pdata->yielded++;
+
+	Graph_GetNode(pdata->g, id, &pdata->node);
+	pdata->output[1] = SI_Node(&pdata->node);
+	pdata->output[3] = SI_LongVal(distance);
+	return pdata->output;
+}
+
+ProcedureResult Proc_KHopFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		KHopContext *pdata = ctx->privateData;
+		if(pdata->iter) ReachableNodesIter_Free(pdata->iter);
+		if(pdata->relations) array_free(pdata->relations);
+		array_free(pdata->output);
+		rm_free(pdata);
+	}
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_KHopGen() {
+	void *privateData = NULL;
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, 2);
+	ProcedureOutput *output_node = rm_malloc(sizeof(ProcedureOutput));
+	ProcedureOutput *output_distance = rm_malloc(sizeof(ProcedureOutput));
+	output_node->name = "node";
+	output_node->type = T_NODE;
+	output_distance->name = "distance";
+	output_distance->type = T_INT64;
+	outputs = array_append(outputs, output_node);
+	outputs = array_append(outputs, output_distance);
+	return ProcCtxNew("algo.kHop", PROCEDURE_VARIABLE_ARG_COUNT, outputs, Proc_KHopStep,
+					  Proc_KHopInvoke, Proc_KHopFree, privateData, true);
+}
@@ -0,0 +1,127 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_matrix_stats.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+// CALL db.matrixStats()
+
+#define OUTPUT_COUNT 5
+
+typedef struct {
+	uint label_idx;     // Current label matrix.
+	uint relation_idx;  // Current relation matrix.
+	GraphContext *gc;   // Graph context.
+	SIValue *output;    // Output matrix stats.
+} MatrixStatsContext;
+
+ProcedureResult Proc_MatrixStatsInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 0) return PROCEDURE_ERR;
+
+	MatrixStatsContext *pdata = rm_malloc(sizeof(MatrixStatsContext));
+	pdata->label_idx = 0;
+	pdata->relation_idx = 0;
+	pdata->gc = QueryCtx_GetGraphCtx();
+	pdata->output = array_new(SIValue, OUTPUT_COUNT * 2);
+	for(uint i = 0; i < OUTPUT_COUNT; i++) {
+		pdata->output = array_append(pdata->output, SI_ConstStringVal(ctx->output[i]->name));
+		pdata->output = array_append(pdata->output, SI_NullVal()); // Place holder.
+	}
+
+	ctx->privateData = pdata;
+	return PROCEDURE_OK;
+}
+
+/* Memory saved by the matrix row pointers layout, compared to
+ * allocating a row pointer for every row. */
+static int64_t _SavedBytes(GrB_Matrix m, bool *is_hyper) {
+	GrB_Index nrows;
+	GrB_Index plen;
+	GrB_Matrix_nrows(&nrows, m);
+	GxB_Matrix_Hyper_Info(m, is_hyper, &plen);
+	if(!*is_hyper) return 0;
+
+	// Hypersparse matrices hold a row pointer and a row index per populated row.
+	int64_t full = (nrows + 1) * sizeof(int64_t);
+	int64_t hyper = (plen + 1) * sizeof(int64_t) + plen * sizeof(int64_t);
+	return full - hyper;
+}
+
+SIValue *Proc_MatrixStatsStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+
+	MatrixStatsContext *pdata = (MatrixStatsContext *)ctx->privateData;
+	GraphContext *gc = pdata->gc;
+	Graph *g = gc->g;
+
+	GrB_Matrix m;
+	Schema *s;
+	const char *type;
+	if(pdata->label_idx < Graph_LabelTypeCount(g)) {
+		int id = pdata->label_idx++;
+		m = Graph_GetLabelMatrix(g, id);
+		s = GraphContext_GetSchemaByID(gc, id, SCHEMA_NODE);
+		type = "label";
+	} else if(pdata->relation_idx < Graph_RelationTypeCount(g)) {
+		int id = pdata->relation_idx++;
+		m = Graph_GetRelationMatrix(g, id);
+		s = GraphContext_GetSchemaByID(gc, id, SCHEMA_EDGE);
+		type = "relationship";
+	} else {
+		// Depleted.
+		return NULL;
+	}
+
+	bool is_hyper;
+	GrB_Index nvals;
+	GrB_Matrix_nvals(&nvals, m);
+	int64_t saved = _SavedBytes(m, &is_hyper);
+
+	pdata->output[1] = SI_ConstStringVal((char *)Schema_GetName(s));
+	pdata->output[3] = SI_ConstStringVal((char *)type);
+	pdata->output[5] = SI_LongVal(nvals);
+	pdata->output[7] = SI_BoolVal(is_hyper);
+	pdata->output[9] = SI_LongVal(saved);
+	return pdata->output;
+}
+
+ProcedureResult Proc_MatrixStatsFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		MatrixStatsContext *pdata = ctx->privateData;
+		array_free(pdata->output);
+		rm_free(ctx->privateData);
+	}
+
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_MatrixStatsCtx() {
+	void *privateData = NULL;
+	char *names[OUTPUT_COUNT] = {"name", "type", "entries", "hypersparse", "saved_bytes"};
+	SIType types[OUTPUT_COUNT] = {T_STRING, T_STRING, T_INT64, T_BOOL, T_INT64};
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, OUTPUT_COUNT);
+	for(int i = 0; i < OUTPUT_COUNT; i++) {
+		ProcedureOutput *output = rm_malloc(sizeof(ProcedureOutput));
+		output->name = names[i];
+		output->type = types[i];
+		outputs = array_append(outputs, output);
+	}
+
+	ProcedureCtx *ctx = ProcCtxNew("db.matrixStats",
+								   0,
+								   outputs,
+								   Proc_MatrixStatsStep,
+								   Proc_MatrixStatsInvoke,
+								   Proc_MatrixStatsFree,
+								   privateData,
+								   true);
+	return ctx;
+}
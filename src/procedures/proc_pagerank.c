@@ -5,37 +5,100 @@
 */
 
 #include "proc_pagerank.h"
+#include "procedure.h"
 #include "../value.h"
 #include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
+#include "../datatypes/array.h"
 #include "../graph/graphcontext.h"
 #include "../algorithms/pagerank.h"
+#include "../algorithms/subgraph_matrix.h"
 
-// CALL algo.pageRank('Page', 'LINKS', {iterations: 20, dampingFactor: 0.85}) YIELD node, score
+// CALL algo.pageRank(label, relationships, [dampingFactor], [tolerance], [topK], [seedProperty])
 // CALL algo.pageRank('Page', 'LINKS') YIELD node, score
+// CALL algo.pageRank('Page', ['LINKS', 'CITES'], 0.85, 0.0001, 10, 'rank') YIELD node, score
+
+#define PAGERANK_DAMPING 0.85
+#define PAGERANK_TOLERANCE 1e-4
+#define PAGERANK_ITERMAX 100
 
 typedef struct {
 	int n;                          // Number of nodes to rank.
 	int i;                          // Current node to return.
 	Graph *g;                       // Graph.
 	Node node;                      // Node.
+	bool yield_node;                // Whether the ranked node is yielded.
 	GrB_Index *mappings;            // Mappings between extracted matrix rows and node ids.
 	LAGraph_PageRank *rankings;     // Nodes rankings.
 	SIValue *output;                // Array with 4 entries ["node", node, "score", score].
 } PagerankContext;
 
+static void _RaiseError(char *error) {
+	QueryCtx_SetError(error);
+	/* Raise the exception, we expect an exception handler to be set.
+	 * as procedure invocation is done at runtime. */
+	QueryCtx_RaiseRuntimeException();
+}
+
+// Optional arguments may be omitted or NULL.
+static inline bool _OptionalArg(const SIValue *args, uint arg_count, uint i) {
+	return (i < arg_count && SI_TYPE(args[i]) != T_NULL);
+}
+
+// Collects the initial ranks of nodes from their seed property, -1 for unseeded nodes.
+static float *_Pagerank_Seed(Graph *g, Attribute_ID attr, const GrB_Index *mappings,
+							 GrB_Index n) {
+	float *seed = rm_malloc(sizeof(float) * n);
+	for(GrB_Index i = 0; i < n; i++) {
+		Node node;
+		seed[i] = -1;
+		NodeID id = (mappings) ? mappings[i] : i;
+		if(attr == ATTRIBUTE_NOTFOUND || !Graph_GetNode(g, id, &node)) continue;
+		SIValue *v = GraphEntity_GetProperty((GraphEntity *)&node, attr);
+		if(v != PROPERTY_NOTFOUND && (SI_TYPE(*v) & SI_NUMERIC)) seed[i] = SI_GET_NUMERIC(*v);
+	}
+	return seed;
+}
+
 ProcedureResult Proc_PagerankInvoke(ProcedureCtx *ctx, const SIValue *args) {
-	if(array_len((SIValue *)args) != 2) return PROCEDURE_ERR;
-	if(!(SI_TYPE(args[0]) & SI_TYPE(args[1]) & T_STRING)) return PROCEDURE_ERR;
+	uint arg_count = array_len((SIValue *)args);
+	if(arg_count < 2 || arg_count > 6) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING)) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[1]) & (T_STRING | T_ARRAY))) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, 2) && !(SI_TYPE(args[2]) & SI_NUMERIC)) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, 3) && !(SI_TYPE(args[3]) & SI_NUMERIC)) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, 4) && !(SI_TYPE(args[4]) & T_INT64)) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, 5) && !(SI_TYPE(args[5]) & T_STRING)) return PROCEDURE_ERR;
 
 	const char *label = args[0].stringval;
-	const char *relation = args[1].stringval;
+	SIValue relations = args[1];
+	uint relation_count = (SI_TYPE(relations) & T_ARRAY) ? SIArray_Length(relations) : 1;
+	for(uint i = 0; i < relation_count; i++) {
+		if((SI_TYPE(relations) & T_ARRAY) &&
+		   !(SI_TYPE(SIArray_Get(relations, i)) & T_STRING)) return PROCEDURE_ERR;
+	}
+
+	double damping = PAGERANK_DAMPING;
+	double tol = PAGERANK_TOLERANCE;
+	GrB_Index topk = 0;
+	const char *seed_property = NULL;
+	if(_OptionalArg(args, arg_count, 2)) damping = SI_GET_NUMERIC(args[2]);
+	if(_OptionalArg(args, arg_count, 3)) tol = SI_GET_NUMERIC(args[3]);
+	if(_OptionalArg(args, arg_count, 5)) seed_property = args[5].stringval;
+
+	char *error = NULL;
+	if(damping < 0 || damping >= 1) {
+		asprintf(&error, "PageRank damping factor must be within [0, 1)");
+	} else if(tol <= 0) {
+		asprintf(&error, "PageRank tolerance must be positive");
+	} else if(_OptionalArg(args, arg_count, 4)) {
+		if(args[4].longval < 0) asprintf(&error, "PageRank topK must be non-negative");
+		else topk = args[4].longval;
+	}
+	if(error) _RaiseError(error);
 
 	GrB_Index n = 0;
-	Schema *s = NULL;
-	GrB_Matrix l = NULL;
-	GrB_Matrix r = NULL;
 	GrB_Index *mappings = NULL; // Mappings, array for returning row indices of tuples.
 	GrB_Matrix reduced = GrB_NULL;
 	Graph *g = QueryCtx_GetGraph();
@@ -47,6 +110,7 @@ ProcedureResult Proc_PagerankInvoke(ProcedureCtx *ctx, const SIValue *args) {
 	pdata->n = n;
 	pdata->i = 0;
 	pdata->g = g;
+	pdata->yield_node = Proc_Yields(ctx, "node");
 	pdata->mappings = mappings;
 	pdata->rankings = rankings;
 	pdata->output = array_new(SIValue, 4);
@@ -56,48 +120,42 @@ ProcedureResult Proc_PagerankInvoke(ProcedureCtx *ctx, const SIValue *args) {
 	pdata->output = array_append(pdata->output, SI_DoubleVal(0.0)); // Place holder.
 	ctx->privateData = pdata;
 
-	// Get label matrix.
-	s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
-	if(!s) return PROCEDURE_OK;
-	l = Graph_GetLabelMatrix(g, s->id);
-
-	// Get relation matrix.
-	s = GraphContext_GetSchema(gc, relation, SCHEMA_EDGE);
-	if(!s) return PROCEDURE_OK;
-	r = Graph_GetRelationMatrix(g, s->id);
-
-	GrB_Index rows = Graph_RequiredMatrixDim(g);
-	GrB_Index cols = rows;
-	assert(GrB_Matrix_nvals(&n, l) == GrB_SUCCESS);
-	assert(GrB_Matrix_new(&reduced, GrB_BOOL, n, n) == GrB_SUCCESS);
-
-	if(n != rows) {
-		mappings = rm_malloc(sizeof(GrB_Index) * n);
-		assert(GrB_Matrix_extractTuples_BOOL(mappings, GrB_NULL, GrB_NULL, &n, l) == GrB_SUCCESS);
-		assert(GrB_extract(reduced, GrB_NULL, GrB_NULL, r, mappings, n, mappings, n,
-						   GrB_NULL) == GrB_SUCCESS);
-	} else {
-		/* There no need to perform extraction as `r` dimension NxN
-		 * is the same as the number of entries in `l` which means
-		 * all connections described in `r` connect nodes of type `l`
-		 * Unfortunately we still need to type cast `r` into a boolean matrix. */
-		GrB_Descriptor desc;
-		GrB_Descriptor_new(&desc);
-		GrB_Descriptor_set(desc, GrB_INP0, GrB_TRAN);
-		assert(GrB_transpose(reduced, GrB_NULL, GrB_NULL, r, desc) == GrB_SUCCESS);
-		GrB_free(&desc);
+	// Label and at least one of the relationship types must exist.
+	if(!GraphContext_GetSchema(gc, label, SCHEMA_NODE)) return PROCEDURE_OK;
+	uint relations_found = 0;
+	for(uint i = 0; i < relation_count; i++) {
+		const char *relation = (SI_TYPE(relations) & T_ARRAY) ?
+							   SIArray_Get(relations, i).stringval : relations.stringval;
+		if(GraphContext_GetSchema(gc, relation, SCHEMA_EDGE)) relations_found++;
 	}
+	if(relations_found == 0) return PROCEDURE_OK;
 
+	/* Connections of any of the given types count once, whatever the number
+	 * of edges connecting two nodes, rows are reduced to the labeled nodes. */
+	reduced = SubgraphMatrix_FromArgs(gc, args[0], relations, &mappings, &n);
+	pdata->mappings = mappings;
+	if(reduced == GrB_NULL) return PROCEDURE_OK;
+
+	// Warm start from the ranks stored by a previous run.
+	float *seed = NULL;
+	if(seed_property) {
+		seed = _Pagerank_Seed(g, GraphContext_GetAttributeID(gc, seed_property), mappings, n);
+	}
 
-	double tol = 1e-4;
-	int iters, itermax = 100;
-	assert(Pagerank(&rankings, reduced, itermax, tol, &iters) == GrB_SUCCESS);
+	// Records beyond the caller's limit are never consumed, rank only the top ones.
+	GrB_Index limit = Proc_Limit(ctx);
+	if(limit && (topk == 0 || limit < topk)) topk = limit;
+
+	int iters;
+	assert(Pagerank(&rankings, &topk, reduced, seed, damping, PAGERANK_ITERMAX, tol,
+					&iters) == GrB_SUCCESS);
 
 	// Clean up.
+	if(seed) rm_free(seed);
 	GrB_free(&reduced);
 
 	// Update context.
-	pdata->n = n;
+	pdata->n = topk;
 	pdata->mappings = mappings;
 	pdata->rankings = rankings;
 	return PROCEDURE_OK;
@@ -112,10 +170,11 @@ SIValue *Proc_PagerankStep(ProcedureCtx *ctx) {
 	if(pdata->i >= pdata->n) return NULL;
 
 	LAGraph_PageRank rank = pdata->rankings[pdata->i++];
-	NodeID node_id = (pdata->mappings) ? pdata->mappings[rank.page] : rank.page;
-
-	Graph_GetNode(pdata->g, node_id, &pdata->node);
-	pdata->output[1] = SI_Node(&pdata->node);
+	if(pdata->yield_node) {
+		NodeID node_id = (pdata->mappings) ? pdata->mappings[rank.page] : rank.page;
+		Graph_GetNode(pdata->g, node_id, &pdata->node);
+		pdata->output[1] = SI_Node(&pdata->node);
+	}
 	pdata->output[3] = SI_DoubleVal(rank.pagerank);
 
 	return pdata->output;
@@ -147,7 +206,7 @@ ProcedureCtx *Proc_PagerankCtx() {
 	outputs = array_append(outputs, output_node);
 	outputs = array_append(outputs, output_score);
 	ProcedureCtx *ctx = ProcCtxNew("algo.pageRank",
-								   2,
+								   PROCEDURE_VARIABLE_ARG_COUNT,
 								   outputs,
 								   Proc_PagerankStep,
 								   Proc_PagerankInvoke,
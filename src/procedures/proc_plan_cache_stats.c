@@ -0,0 +1,113 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_plan_cache_stats.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+// CALL db.planCacheStats()
+// CALL db.resultCacheStats()
+
+#define OUTPUT_COUNT 6
+
+typedef struct {
+	bool depleted;      // Stats have been emitted.
+	Cache *cache;       // Reported cache, NULL if the cache is disabled.
+	SIValue *output;    // Output stats.
+} PlanCacheStatsContext;
+
+static ProcedureResult _CacheStatsInvoke(ProcedureCtx *ctx, const SIValue *args, Cache *cache) {
+	if(array_len((SIValue *)args) != 0) return PROCEDURE_ERR;
+
+	PlanCacheStatsContext *pdata = rm_malloc(sizeof(PlanCacheStatsContext));
+	pdata->depleted = false;
+	pdata->cache = cache;
+	pdata->output = array_new(SIValue, OUTPUT_COUNT * 2);
+	for(uint i = 0; i < OUTPUT_COUNT; i++) {
+		pdata->output = array_append(pdata->output, SI_ConstStringVal(ctx->output[i]->name));
+		pdata->output = array_append(pdata->output, SI_LongVal(0)); // Place holder.
+	}
+	pdata->output[11] = SI_DoubleVal(0);
+
+	ctx->privateData = pdata;
+	return PROCEDURE_OK;
+}
+
+ProcedureResult Proc_PlanCacheStatsInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _CacheStatsInvoke(ctx, args, GraphContext_GetCache(QueryCtx_GetGraphCtx()));
+}
+
+ProcedureResult Proc_ResultCacheStatsInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _CacheStatsInvoke(ctx, args, GraphContext_GetResultCache(QueryCtx_GetGraphCtx()));
+}
+
+SIValue *Proc_PlanCacheStatsStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+
+	PlanCacheStatsContext *pdata = (PlanCacheStatsContext *)ctx->privateData;
+
+	// Depleted?
+	if(pdata->depleted) return NULL;
+	pdata->depleted = true;
+
+	// A disabled cache reports zeros.
+	if(pdata->cache == NULL) return pdata->output;
+
+	CacheStats stats = Cache_GetStats(pdata->cache);
+	pdata->output[1] = SI_LongVal(stats.size);
+	pdata->output[3] = SI_LongVal(stats.hits);
+	pdata->output[5] = SI_LongVal(stats.misses);
+	pdata->output[7] = SI_LongVal(stats.evictions);
+	pdata->output[9] = SI_LongVal(stats.bytes);
+	uint64_t lookups = stats.hits + stats.misses;
+	pdata->output[11] = SI_DoubleVal((lookups > 0) ? (double)stats.hits / lookups : 0);
+	return pdata->output;
+}
+
+ProcedureResult Proc_PlanCacheStatsFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		PlanCacheStatsContext *pdata = ctx->privateData;
+		array_free(pdata->output);
+		rm_free(ctx->privateData);
+	}
+
+	return PROCEDURE_OK;
+}
+
+static ProcedureCtx *_CacheStatsCtx(const char *name, ProcInvoke invoke) {
+	void *privateData = NULL;
+	char *names[OUTPUT_COUNT] = {"size", "hits", "misses", "evictions", "bytes", "hit_rate"};
+	SIType types[OUTPUT_COUNT] = {T_INT64, T_INT64, T_INT64, T_INT64, T_INT64, T_DOUBLE};
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, OUTPUT_COUNT);
+	for(int i = 0; i < OUTPUT_COUNT; i++) {
+		ProcedureOutput *output = rm_malloc(sizeof(ProcedureOutput));
+		output->name = names[i];
+		output->type = types[i];
+		outputs = array_append(outputs, output);
+	}
+
+	ProcedureCtx *ctx = ProcCtxNew(name,
+								   0,
+								   outputs,
+								   Proc_PlanCacheStatsStep,
+								   invoke,
+								   Proc_PlanCacheStatsFree,
+								   privateData,
+								   true);
+	return ctx;
+}
+
+ProcedureCtx *Proc_PlanCacheStatsCtx() {
+	return _CacheStatsCtx("db.planCacheStats", Proc_PlanCacheStatsInvoke);
+}
+
+ProcedureCtx *Proc_ResultCacheStatsCtx() {
+	return _CacheStatsCtx("db.resultCacheStats", Proc_ResultCacheStatsInvoke);
+}
@@ -0,0 +1,12 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "proc_ctx.h"
+
+ProcedureCtx *Proc_PlanCacheStatsCtx();
+ProcedureCtx *Proc_ResultCacheStatsCtx();
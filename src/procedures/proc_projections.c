@@ -0,0 +1,211 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_projections.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+#include "../algorithms/subgraph_matrix.h"
+
+// CALL algo.project(name, label, relationships, [weightProperty]) YIELD name, nodes, relationships
+// CALL algo.project('social', 'Person', ['KNOWS', 'FOLLOWS'], 'weight')
+// CALL algo.project.drop(name)
+// CALL algo.projections() YIELD name, nodes, relationships, builds, hits
+// Algorithms over the label and relationship types of a projection run on its matrices.
+
+typedef struct {
+	uint i;                     // Next projection to return.
+	Projections *projections;   // Projections registry.
+	char *name;                 // Name of the last returned projection.
+	SIValue *output;            // Yielded values.
+} ProjectionsContext;
+
+static void _RaiseError(char *error) {
+	QueryCtx_SetError(error);
+	/* Raise the exception, we expect an exception handler to be set.
+	 * as procedure invocation is done at runtime. */
+	QueryCtx_RaiseRuntimeException();
+}
+
+static ProjectionsContext *_NewContext(Projections *projections) {
+	ProjectionsContext *pdata = rm_malloc(sizeof(ProjectionsContext));
+	pdata->i = 0;
+	pdata->projections = projections;
+	pdata->name = NULL;
+	pdata->output = array_new(SIValue, 10);
+	return pdata;
+}
+
+// Fills output with the description of projection i, returns false if i is out of range.
+static bool _DescribeProjection(ProjectionsContext *pdata, uint i) {
+	GrB_Index nodes;
+	GrB_Index edges;
+	uint64_t builds;
+	uint64_t hits;
+	if(pdata->name) rm_free(pdata->name);
+	pdata->name = NULL;
+	if(!Projections_Get(pdata->projections, i, &pdata->name, &nodes, &edges, &builds, &hits)) {
+		return false;
+	}
+
+	array_clear(pdata->output);
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("name"));
+	pdata->output = array_append(pdata->output, SI_ConstStringVal(pdata->name));
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("nodes"));
+	pdata->output = array_append(pdata->output, SI_LongVal(nodes));
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("relationships"));
+	pdata->output = array_append(pdata->output, SI_LongVal(edges));
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("builds"));
+	pdata->output = array_append(pdata->output, SI_LongVal(builds));
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("hits"));
+	pdata->output = array_append(pdata->output, SI_LongVal(hits));
+	return true;
+}
+
+ProcedureResult Proc_ProjectInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	uint arg_count = array_len((SIValue *)args);
+	if(arg_count < 3 || arg_count > 4) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING)) return PROCEDURE_ERR;
+	if(!SubgraphMatrix_ValidArgs(args[1], args[2])) return PROCEDURE_ERR;
+	if(arg_count == 4 && !(SI_TYPE(args[3]) & (T_STRING | T_NULL))) return PROCEDURE_ERR;
+
+	const char *name = args[0].stringval;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Projections *projections = GraphContext_GetProjections(gc);
+
+	int label;
+	int *relations;
+	if(!SubgraphMatrix_ResolveArgs(gc, args[1], args[2], &label, &relations)) {
+		char *error;
+		asprintf(&error, "Projection %s refers to unknown label %s", name, args[1].stringval);
+		_RaiseError(error);
+	}
+
+	Attribute_ID weight = ATTRIBUTE_NOTFOUND;
+	if(arg_count == 4 && (SI_TYPE(args[3]) & T_STRING)) {
+		weight = GraphContext_GetAttributeID(gc, args[3].stringval);
+		if(weight == ATTRIBUTE_NOTFOUND) {
+			if(relations) array_free(relations);
+			char *error;
+			asprintf(&error, "Projection %s refers to unknown property %s", name, args[3].stringval);
+			_RaiseError(error);
+		}
+	}
+
+	uint relation_count = (relations) ? array_len(relations) : 0;
+	bool defined = Projections_Set(projections, gc->g, name, label, relations, relation_count,
+								   weight);
+	if(relations) array_free(relations);
+	if(!defined) {
+		char *error;
+		asprintf(&error, "Maximum number of projections (%d) reached", PROJECTIONS_MAX);
+		_RaiseError(error);
+	}
+
+	// Yield the new projection, which is the last or replaced one.
+	ProjectionsContext *pdata = _NewContext(projections);
+	ctx->privateData = pdata;
+	uint count = Projections_Count(projections);
+	for(uint i = 0; i < count; i++) {
+		if(!_DescribeProjection(pdata, i)) break;
+		if(strcmp(pdata->name, name) == 0) break;
+	}
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_ProjectStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+	ProjectionsContext *pdata = ctx->privateData;
+
+	// A single record describing the projection.
+	if(pdata->i > 0 || pdata->name == NULL) return NULL;
+	pdata->i = 1;
+	return pdata->output;
+}
+
+ProcedureResult Proc_ProjectDropInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 1) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING)) return PROCEDURE_ERR;
+
+	const char *name = args[0].stringval;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	if(!Projections_Remove(GraphContext_GetProjections(gc), name)) {
+		char *error;
+		asprintf(&error, "Projection %s does not exist", name);
+		_RaiseError(error);
+	}
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_ProjectDropStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_ProjectionsInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 0) return PROCEDURE_ERR;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	ctx->privateData = _NewContext(GraphContext_GetProjections(gc));
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_ProjectionsStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+	ProjectionsContext *pdata = ctx->privateData;
+
+	// Depleted?
+	if(!_DescribeProjection(pdata, pdata->i)) return NULL;
+	pdata->i++;
+	return pdata->output;
+}
+
+ProcedureResult Proc_ProjectionsFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		ProjectionsContext *pdata = ctx->privateData;
+		if(pdata->name) rm_free(pdata->name);
+		array_free(pdata->output);
+		rm_free(pdata);
+	}
+	return PROCEDURE_OK;
+}
+
+static ProcedureOutput *_Output(const char *name, SIType type) {
+	ProcedureOutput *output = rm_malloc(sizeof(ProcedureOutput));
+	output->name = (char *)name;
+	output->type = type;
+	return output;
+}
+
+ProcedureCtx *Proc_ProjectGen() {
+	void *privateData = NULL;
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, 3);
+	outputs = array_append(outputs, _Output("name", T_STRING));
+	outputs = array_append(outputs, _Output("nodes", T_INT64));
+	outputs = array_append(outputs, _Output("relationships", T_INT64));
+	return ProcCtxNew("algo.project", PROCEDURE_VARIABLE_ARG_COUNT, outputs, Proc_ProjectStep,
+					  Proc_ProjectInvoke, Proc_ProjectionsFree, privateData, true);
+}
+
+ProcedureCtx *Proc_ProjectDropGen() {
+	void *privateData = NULL;
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, 0);
+	return ProcCtxNew("algo.project.drop", 1, outputs, Proc_ProjectDropStep,
+					  Proc_ProjectDropInvoke, Proc_ProjectionsFree, privateData, true);
+}
+
+ProcedureCtx *Proc_ProjectionsGen() {
+	void *privateData = NULL;
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, 5);
+	outputs = array_append(outputs, _Output("name", T_STRING));
+	outputs = array_append(outputs, _Output("nodes", T_INT64));
+	outputs = array_append(outputs, _Output("relationships", T_INT64));
+	outputs = array_append(outputs, _Output("builds", T_INT64));
+	outputs = array_append(outputs, _Output("hits", T_INT64));
+	return ProcCtxNew("algo.projections", 0, outputs, Proc_ProjectionsStep,
+					  Proc_ProjectionsInvoke, Proc_ProjectionsFree, privateData, true);
+}
@@ -0,0 +1,13 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "proc_ctx.h"
+
+ProcedureCtx *Proc_ProjectGen();
+ProcedureCtx *Proc_ProjectDropGen();
+ProcedureCtx *Proc_ProjectionsGen();
@@ -0,0 +1,146 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_property_stats.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+// CALL db.propertyStats()
+
+#define OUTPUT_COUNT 8
+#define HISTOGRAM_BUCKETS 10
+
+typedef struct {
+	uint label_idx;     // Current label.
+	uint attr_idx;      // Current attribute.
+	GraphContext *gc;   // Graph context.
+	SIValue *output;    // Output property stats.
+} PropertyStatsContext;
+
+ProcedureResult Proc_PropertyStatsInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 0) return PROCEDURE_ERR;
+
+	PropertyStatsContext *pdata = rm_malloc(sizeof(PropertyStatsContext));
+	pdata->label_idx = 0;
+	pdata->attr_idx = 0;
+	pdata->gc = QueryCtx_GetGraphCtx();
+	pdata->output = array_new(SIValue, OUTPUT_COUNT * 2);
+	for(uint i = 0; i < OUTPUT_COUNT; i++) {
+		pdata->output = array_append(pdata->output, SI_ConstStringVal(ctx->output[i]->name));
+		pdata->output = array_append(pdata->output, SI_NullVal()); // Place holder.
+	}
+
+	// Rebuild statistics which no longer reflect their label's nodes.
+	GraphContext_BuildStatistics(pdata->gc);
+
+	ctx->privateData = pdata;
+	return PROCEDURE_OK;
+}
+
+// Advance to the next label attribute held by at least one node.
+static const AttributeStats *_NextAttribute(PropertyStatsContext *pdata, Schema **s,
+											Attribute_ID *attr) {
+	GraphContext *gc = pdata->gc;
+	uint label_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
+	uint attr_count = GraphContext_AttributeCount(gc);
+
+	while(pdata->label_idx < label_count) {
+		*s = GraphContext_GetSchemaByID(gc, pdata->label_idx, SCHEMA_NODE);
+		while(pdata->attr_idx < attr_count) {
+			*attr = pdata->attr_idx++;
+			const AttributeStats *a = SchemaStats_GetAttribute((*s)->stats, *attr);
+			if(a && a->count > 0) return a;
+		}
+		pdata->label_idx++;
+		pdata->attr_idx = 0;
+	}
+
+	return NULL;
+}
+
+SIValue *Proc_PropertyStatsStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+
+	PropertyStatsContext *pdata = (PropertyStatsContext *)ctx->privateData;
+	GraphContext *gc = pdata->gc;
+
+	// Free previous histogram.
+	SIValue_Free(pdata->output[15]);
+	pdata->output[15] = SI_NullVal();
+
+	Schema *s;
+	Attribute_ID attr;
+	const AttributeStats *a = _NextAttribute(pdata, &s, &attr);
+	if(a == NULL) return NULL; // Depleted.
+
+	size_t node_count = Graph_LabeledNodeCount(gc->g, s->id);
+	double null_fraction = 0;
+	if(node_count > a->count) null_fraction = 1 - ((double)a->count / node_count);
+
+	pdata->output[1] = SI_ConstStringVal((char *)Schema_GetName(s));
+	pdata->output[3] = SI_ConstStringVal((char *)GraphContext_GetAttributeString(gc, attr));
+	pdata->output[5] = SI_LongVal(a->count);
+	pdata->output[7] = SI_DoubleVal(null_fraction);
+	pdata->output[9] = SI_LongVal(AttributeStats_DistinctCount(a));
+
+	if(a->numeric_count == 0) {
+		pdata->output[11] = SI_NullVal();
+		pdata->output[13] = SI_NullVal();
+		return pdata->output;
+	}
+
+	double bounds[HISTOGRAM_BUCKETS];
+	uint bucket_count = AttributeStats_Histogram(a, bounds, HISTOGRAM_BUCKETS);
+	SIValue histogram = SI_Array(bucket_count);
+	for(uint i = 0; i < bucket_count; i++) SIArray_Append(&histogram, SI_DoubleVal(bounds[i]));
+
+	pdata->output[11] = SI_DoubleVal(a->min);
+	pdata->output[13] = SI_DoubleVal(a->max);
+	pdata->output[15] = histogram;
+	return pdata->output;
+}
+
+ProcedureResult Proc_PropertyStatsFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		PropertyStatsContext *pdata = ctx->privateData;
+		SIValue_Free(pdata->output[15]);
+		array_free(pdata->output);
+		rm_free(ctx->privateData);
+	}
+
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_PropertyStatsCtx() {
+	void *privateData = NULL;
+	char *names[OUTPUT_COUNT] = {"label", "property", "count", "nullFraction", "distinct",
+								 "min", "max", "histogram"
+								};
+	SIType types[OUTPUT_COUNT] = {T_STRING, T_STRING, T_INT64, T_DOUBLE, T_INT64,
+								  T_DOUBLE | T_NULL, T_DOUBLE | T_NULL, T_ARRAY | T_NULL
+								 };
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, OUTPUT_COUNT);
+	for(int i = 0; i < OUTPUT_COUNT; i++) {
+		ProcedureOutput *output = rm_malloc(sizeof(ProcedureOutput));
+		output->name = names[i];
+		output->type = types[i];
+		outputs = array_append(outputs, output);
+	}
+
+	ProcedureCtx *ctx = ProcCtxNew("db.propertyStats",
+								   0,
+								   outputs,
+								   Proc_PropertyStatsStep,
+								   Proc_PropertyStatsInvoke,
+								   Proc_PropertyStatsFree,
+								   privateData,
+								   true);
+	return ctx;
+}
@@ -0,0 +1,102 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_query_stats.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+#include <stdio.h>
+
+// CALL db.queryStats()
+
+#define OUTPUT_COUNT 8
+
+typedef struct {
+	uint idx;                       // Position of the next entry to emit.
+	QueryStatsSnapshot *entries;    // Snapshot of the graph's query stats.
+	char fingerprint[17];           // Current entry's fingerprint, as hex.
+	SIValue *output;                // Output stats.
+} QueryStatsContext;
+
+ProcedureResult Proc_QueryStatsInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 0) return PROCEDURE_ERR;
+
+	QueryStatsContext *pdata = rm_malloc(sizeof(QueryStatsContext));
+	pdata->idx = 0;
+	pdata->entries = QueryStats_Snapshot(GraphContext_GetQueryStats(QueryCtx_GetGraphCtx()));
+	pdata->output = array_new(SIValue, OUTPUT_COUNT * 2);
+	for(uint i = 0; i < OUTPUT_COUNT; i++) {
+		pdata->output = array_append(pdata->output, SI_ConstStringVal(ctx->output[i]->name));
+		pdata->output = array_append(pdata->output, SI_NullVal()); // Place holder.
+	}
+
+	ctx->privateData = pdata;
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_QueryStatsStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+
+	QueryStatsContext *pdata = (QueryStatsContext *)ctx->privateData;
+
+	// Depleted?
+	if(pdata->idx >= array_len(pdata->entries)) return NULL;
+
+	QueryStatsSnapshot *entry = pdata->entries + pdata->idx++;
+	// Fingerprints are emitted as hex strings, as they don't fit within a signed integer.
+	snprintf(pdata->fingerprint, sizeof(pdata->fingerprint), "%016llx",
+			 (unsigned long long)entry->fingerprint);
+	pdata->output[1] = SI_ConstStringVal(pdata->fingerprint);
+	pdata->output[3] = SI_ConstStringVal(entry->query);
+	pdata->output[5] = SI_LongVal(entry->latency.count);
+	pdata->output[7] = SI_LongVal(entry->errors);
+	pdata->output[9] = SI_DoubleVal(entry->latency.mean);
+	pdata->output[11] = SI_DoubleVal(entry->latency.p50);
+	pdata->output[13] = SI_DoubleVal(entry->latency.p99);
+	pdata->output[15] = SI_DoubleVal(entry->latency.max);
+	return pdata->output;
+}
+
+ProcedureResult Proc_QueryStatsFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		QueryStatsContext *pdata = ctx->privateData;
+		QueryStats_FreeSnapshot(pdata->entries);
+		array_free(pdata->output);
+		rm_free(ctx->privateData);
+	}
+
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_QueryStatsCtx() {
+	void *privateData = NULL;
+	char *names[OUTPUT_COUNT] = {"fingerprint", "query", "executions", "errors",
+								 "mean", "p50", "p99", "max"
+								};
+	SIType types[OUTPUT_COUNT] = {T_STRING, T_STRING, T_INT64, T_INT64,
+								  T_DOUBLE, T_DOUBLE, T_DOUBLE, T_DOUBLE
+								 };
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, OUTPUT_COUNT);
+	for(int i = 0; i < OUTPUT_COUNT; i++) {
+		ProcedureOutput *output = rm_malloc(sizeof(ProcedureOutput));
+		output->name = names[i];
+		output->type = types[i];
+		outputs = array_append(outputs, output);
+	}
+
+	ProcedureCtx *ctx = ProcCtxNew("db.queryStats",
+								   0,
+								   outputs,
+								   Proc_QueryStatsStep,
+								   Proc_QueryStatsInvoke,
+								   Proc_QueryStatsFree,
+								   privateData,
+								   true);
+	return ctx;
+}
@@ -0,0 +1,190 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_random_walk.h"
+#include "procedure.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+#include "../graph/graphcontext.h"
+#include "../algorithms/random_walk.h"
+#include "../algorithms/subgraph_matrix.h"
+
+// CALL algo.randomWalk(startNodes, length, walksPerNode, relationships, [p], [q], [seed], [threads]) YIELD walk
+// MATCH (n:Person) WITH collect(n) AS people CALL algo.randomWalk(people, 80, 10, 'KNOWS') YIELD walk RETURN walk
+// startNodes is a node, a list of nodes or NULL for every node, NULL relationships consider every relationship type.
+// Walks follow outgoing edges and are yielded as lists of node IDs, in start node order.
+// p and q bias walks as in node2vec and default to 1, unbiased, seed defaults to a random seed,
+// threads bounds the number of threads sampling walks, GraphBLAS's thread count when omitted, NULL or 0.
+
+typedef struct {
+	RandomWalker *walker;       // Walks sampler, NULL if there are no walks.
+	GrB_Index *mappings;        // Mappings between matrix rows and node ids, NULL for identity.
+	bool yield_walk;            // Whether walks are yielded.
+	SIValue *output;            // Array with 2 entries ["walk", walk].
+} RandomWalkContext;
+
+static void _RaiseError(char *error) {
+	QueryCtx_SetError(error);
+	/* Raise the exception, we expect an exception handler to be set.
+	 * as procedure invocation is done at runtime. */
+	QueryCtx_RaiseRuntimeException();
+}
+
+// Optional arguments may be omitted or NULL.
+static inline bool _OptionalArg(const SIValue *args, uint arg_count, uint i) {
+	return (i < arg_count && SI_TYPE(args[i]) != T_NULL);
+}
+
+// Returns the row of node id, mappings are ascending, -1 if the node isn't considered.
+static int64_t _NodeRow(const GrB_Index *mappings, GrB_Index n, NodeID id) {
+	if(mappings == NULL) return (id < n) ? (int64_t)id : -1;
+	GrB_Index lo = 0;
+	GrB_Index hi = n;
+	while(lo < hi) {
+		GrB_Index mid = lo + (hi - lo) / 2;
+		if(mappings[mid] == id) return mid;
+		if(mappings[mid] < id) lo = mid + 1;
+		else hi = mid;
+	}
+	return -1;
+}
+
+// Collects the rows walks start from.
+static GrB_Index *_Sources(SIValue start, const GrB_Index *mappings, GrB_Index n,
+						   GrB_Index *count) {
+	*count = 0;
+	if(SI_TYPE(start) & T_NULL) {
+		GrB_Index *sources = rm_malloc(sizeof(GrB_Index) * (n + 1));
+		for(GrB_Index i = 0; i < n; i++) sources[i] = i;
+		*count = n;
+		return sources;
+	}
+
+	uint len = (SI_TYPE(start) & T_ARRAY) ? SIArray_Length(start) : 1;
+	GrB_Index *sources = rm_malloc(sizeof(GrB_Index) * (len + 1));
+	for(uint i = 0; i < len; i++) {
+		SIValue v = (SI_TYPE(start) & T_ARRAY) ? SIArray_Get(start, i) : start;
+		int64_t row = _NodeRow(mappings, n, ENTITY_GET_ID((Node *)v.ptrval));
+		if(row >= 0) sources[(*count)++] = row;
+	}
+	return sources;
+}
+
+static bool _ValidStartNodes(SIValue start) {
+	if(SI_TYPE(start) & (T_NODE | T_NULL)) return true;
+	if(!(SI_TYPE(start) & T_ARRAY)) return false;
+	uint len = SIArray_Length(start);
+	for(uint i = 0; i < len; i++) {
+		if(!(SI_TYPE(SIArray_Get(start, i)) & T_NODE)) return false;
+	}
+	return true;
+}
+
+ProcedureResult Proc_RandomWalkInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	uint arg_count = array_len((SIValue *)args);
+	if(arg_count < 4 || arg_count > 8) return PROCEDURE_ERR;
+	if(!_ValidStartNodes(args[0])) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[1]) & SI_TYPE(args[2]) & T_INT64)) return PROCEDURE_ERR;
+	if(!SubgraphMatrix_ValidArgs(SI_NullVal(), args[3])) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, 4) && !(SI_TYPE(args[4]) & SI_NUMERIC)) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, 5) && !(SI_TYPE(args[5]) & SI_NUMERIC)) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, 6) && !(SI_TYPE(args[6]) & T_INT64)) return PROCEDURE_ERR;
+	if(_OptionalArg(args, arg_count, 7) && !(SI_TYPE(args[7]) & T_INT64)) return PROCEDURE_ERR;
+
+	int64_t length = args[1].longval;
+	int64_t walks_per_node = args[2].longval;
+	double p = _OptionalArg(args, arg_count, 4) ? SI_GET_NUMERIC(args[4]) : 1;
+	double q = _OptionalArg(args, arg_count, 5) ? SI_GET_NUMERIC(args[5]) : 1;
+	uint64_t seed = _OptionalArg(args, arg_count, 6) ? (uint64_t)args[6].longval : (uint64_t)rand();
+	int64_t nthreads = _OptionalArg(args, arg_count, 7) ? args[7].longval : 0;
+
+	char *error = NULL;
+	if(length < 0 || length > UINT16_MAX) {
+		asprintf(&error, "Random walk length must be within [0, %d]", UINT16_MAX);
+	} else if(walks_per_node < 1 || walks_per_node > UINT32_MAX) {
+		asprintf(&error, "Random walk count per node must be positive");
+	} else if(p <= 0 || q <= 0) {
+		asprintf(&error, "Random walk p and q must be positive");
+	} else if(nthreads < 0 || nthreads > INT16_MAX) {
+		asprintf(&error, "Random walk thread count must be non-negative");
+	}
+	if(error) _RaiseError(error);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	RandomWalkContext *pdata = rm_malloc(sizeof(RandomWalkContext));
+	pdata->walker = NULL;
+	pdata->mappings = NULL;
+	pdata->yield_walk = Proc_Yields(ctx, "walk");
+	pdata->output = array_new(SIValue, 2);
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("walk"));
+	pdata->output = array_append(pdata->output, SI_NullVal()); // Place holder.
+	ctx->privateData = pdata;
+
+	GrB_Index n;
+	GrB_Matrix A = SubgraphMatrix_FromArgs(gc, SI_NullVal(), args[3], &pdata->mappings, &n);
+	if(A == GrB_NULL) return PROCEDURE_OK;
+
+	GrB_Index source_count;
+	GrB_Index *sources = _Sources(args[0], pdata->mappings, n, &source_count);
+	pdata->walker = RandomWalker_New(A, sources, source_count, length, walks_per_node, p, q,
+									 seed, nthreads);
+	GrB_free(&A);
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_RandomWalkStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+	RandomWalkContext *pdata = ctx->privateData;
+
+	uint len;
+	const GrB_Index *rows;
+	if(!pdata->walker) return NULL;
+	if(!RandomWalker_Next(pdata->walker, &rows, &len)) {
+		// Aborted, the query's error is set.
+		if(QueryCtx_EncounteredError()) QueryCtx_RaiseRuntimeException();
+		return NULL;
+	}
+
+	/* The walk is owned by the record it is yielded into,
+	 * walks which aren't yielded are not materialized. */
+	pdata->output[1] = SI_NullVal();
+	if(pdata->yield_walk) {
+		SIValue walk = SI_Array(len);
+		for(uint i = 0; i < len; i++) {
+			NodeID id = (pdata->mappings) ? pdata->mappings[rows[i]] : rows[i];
+			SIArray_Append(&walk, SI_LongVal(id));
+		}
+		pdata->output[1] = walk;
+	}
+	return pdata->output;
+}
+
+ProcedureResult Proc_RandomWalkFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		RandomWalkContext *pdata = ctx->privateData;
+		if(pdata->walker) RandomWalker_Free(pdata->walker);
+		if(pdata->mappings) rm_free(pdata->mappings);
+		array_free(pdata->output);
+		rm_free(pdata);
+	}
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_RandomWalkGen() {
+	void *privateData = NULL;
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, 1);
+	ProcedureOutput *output_walk = rm_malloc(sizeof(ProcedureOutput));
+	output_walk->name = "walk";
+	output_walk->type = T_ARRAY;
+	outputs = array_append(outputs, output_walk);
+	return ProcCtxNew("algo.randomWalk", PROCEDURE_VARIABLE_ARG_COUNT, outputs,
+					  Proc_RandomWalkStep, Proc_RandomWalkInvoke, Proc_RandomWalkFree,
+					  privateData, true);
+}
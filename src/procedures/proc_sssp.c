@@ -0,0 +1,176 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_sssp.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
+#include "../algorithms/sssp.h"
+#include "../graph/graphcontext.h"
+#include "../graph/weight_matrices.h"
+
+// CALL algo.SSSP(source, relationship, weightProperty, [delta]) YIELD node, distance
+// CALL algo.SSSP(s, 'ROAD', 'km') YIELD node, distance
+// Yields every node reachable from source through edges of given type which hold
+// a numeric weight, closest first. Delta defaults to the average edge weight.
+
+typedef struct {
+	NodeID id;          // Reached node.
+	double distance;    // Distance from source.
+} SSSPReach;
+
+typedef struct {
+	Graph *g;           // Graph.
+	Node node;          // Node.
+	SSSPReach *reached; // Reached nodes, closest first.
+	GrB_Index n;        // Number of reached nodes.
+	GrB_Index i;        // Next node to return.
+	SIValue *output;    // Array with 4 entries ["node", node, "distance", distance].
+} SSSPContext;
+
+static void _RaiseError(char *error) {
+	QueryCtx_SetError(error);
+	/* Raise the exception, we expect an exception handler to be set.
+	 * as procedure invocation is done at runtime. */
+	QueryCtx_RaiseRuntimeException();
+}
+
+#define reach_lt(a, b) ((a)->distance < (b)->distance || \
+						((a)->distance == (b)->distance && (a)->id < (b)->id))
+
+// Returns the average weight of W, 1 if W holds no positive weights.
+static double _AverageWeight(GrB_Matrix W) {
+	double sum = 0;
+	GrB_Index nvals;
+	assert(GrB_Matrix_nvals(&nvals, W) == GrB_SUCCESS);
+	assert(GrB_reduce(&sum, GrB_NULL, GxB_PLUS_FP64_MONOID, W, GrB_NULL) == GrB_SUCCESS);
+	if(nvals == 0 || sum <= 0) return 1;
+	return sum / nvals;
+}
+
+ProcedureResult Proc_SSSPInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	uint arg_count = array_len((SIValue *)args);
+	if(arg_count < 3 || arg_count > 4) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_NODE)) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[1]) & SI_TYPE(args[2]) & T_STRING)) return PROCEDURE_ERR;
+	if(arg_count == 4 && !(SI_TYPE(args[3]) & SI_NUMERIC)) return PROCEDURE_ERR;
+	if(arg_count == 4 && SI_GET_NUMERIC(args[3]) <= 0) {
+		char *error;
+		asprintf(&error, "SSSP delta must be positive");
+		_RaiseError(error);
+	}
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	NodeID src = ENTITY_GET_ID((Node *)args[0].ptrval);
+	const char *relation = args[1].stringval;
+	const char *property = args[2].stringval;
+
+	// Setup context, the source itself is reached at distance 0.
+	SSSPContext *pdata = rm_malloc(sizeof(SSSPContext));
+	pdata->g = gc->g;
+	pdata->i = 0;
+	pdata->n = 1;
+	pdata->reached = rm_malloc(sizeof(SSSPReach));
+	pdata->reached[0].id = src;
+	pdata->reached[0].distance = 0;
+	pdata->output = array_new(SIValue, 4);
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("node"));
+	pdata->output = array_append(pdata->output, SI_Node(NULL)); // Place holder.
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("distance"));
+	pdata->output = array_append(pdata->output, SI_DoubleVal(0.0)); // Place holder.
+	ctx->privateData = pdata;
+
+	Schema *s = GraphContext_GetSchema(gc, relation, SCHEMA_EDGE);
+	Attribute_ID attr = GraphContext_GetAttributeID(gc, property);
+	if(!s || attr == ATTRIBUTE_NOTFOUND) return PROCEDURE_OK;
+
+	/* Weight matrices are cached per relation and attribute until the graph is modified,
+	 * maintained matrices are patched by writes instead. */
+	const WeightMatrix *wm = WeightMatrices_Get(gc->g, s->id, attr);
+	if(wm->negative) {
+		WeightMatrix_Release(wm);
+		char *error;
+		asprintf(&error, "SSSP does not support negative weights, found under '%s'", property);
+		_RaiseError(error);
+	}
+
+	double delta = (arg_count == 4) ? SI_GET_NUMERIC(args[3]) : _AverageWeight(wm->W);
+	GrB_Vector t = SSSP_DeltaStepping(wm->W, src, delta);
+	WeightMatrix_Release(wm);
+	// Aborted, the query's error is set.
+	if(t == GrB_NULL) {
+		QueryCtx_RaiseRuntimeException();
+		return PROCEDURE_ERR;
+	}
+
+	GrB_Index n;
+	assert(GrB_Vector_nvals(&n, t) == GrB_SUCCESS);
+	GrB_Index *ids = rm_malloc(sizeof(GrB_Index) * n);
+	double *distances = rm_malloc(sizeof(double) * n);
+	assert(GrB_Vector_extractTuples_FP64(ids, distances, &n, t) == GrB_SUCCESS);
+	GrB_free(&t);
+
+	pdata->n = n;
+	pdata->reached = rm_realloc(pdata->reached, sizeof(SSSPReach) * n);
+	for(GrB_Index i = 0; i < n; i++) {
+		pdata->reached[i].id = ids[i];
+		pdata->reached[i].distance = distances[i];
+	}
+	QSORT(SSSPReach, pdata->reached, n, reach_lt);
+
+	rm_free(ids);
+	rm_free(distances);
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_SSSPStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+	SSSPContext *pdata = ctx->privateData;
+
+	// Depleted?
+	if(pdata->i >= pdata->n) return NULL;
+
+	SSSPReach *reach = pdata->reached + pdata->i++;
+	Graph_GetNode(pdata->g, reach->id, &pdata->node);
+	pdata->output[1] = SI_Node(&pdata->node);
+	pdata->output[3] = SI_DoubleVal(reach->distance);
+	return pdata->output;
+}
+
+ProcedureResult Proc_SSSPFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		SSSPContext *pdata = ctx->privateData;
+		if(pdata->output) array_free(pdata->output);
+		if(pdata->reached) rm_free(pdata->reached);
+		rm_free(pdata);
+	}
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_SSSPGen() {
+	void *privateData = NULL;
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, 2);
+	ProcedureOutput *output_node = rm_malloc(sizeof(ProcedureOutput));
+	ProcedureOutput *output_distance = rm_malloc(sizeof(ProcedureOutput));
+	output_node->name = "node";
+	output_node->type = T_NODE;
+	output_distance->name = "distance";
+	output_distance->type = T_DOUBLE;
+	outputs = array_append(outputs, output_node);
+	outputs = array_append(outputs, output_distance);
+
+	return ProcCtxNew("algo.SSSP",
+					  PROCEDURE_VARIABLE_ARG_COUNT,
+					  outputs,
+					  Proc_SSSPStep,
+					  Proc_SSSPInvoke,
+					  Proc_SSSPFree,
+					  privateData,
+					  true);
+}
@@ -0,0 +1,67 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_temporal_edge_set.h"
+#include "../query_ctx.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// temporal.edge.set
+//------------------------------------------------------------------------------
+
+// CALL db.temporal.edge.set(relationship, from, to)
+// CALL db.temporal.edge.set('EMPLOYED', 'since', 'until')
+// Indexes the relationship type's edges as valid from the millisecond timestamp held by from,
+// inclusive, up to the one held by to, exclusive. NULL attributes drop the index.
+
+ProcedureResult Proc_TemporalEdgeSetInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 3) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING)) return PROCEDURE_ERR;
+	bool drop = (SI_TYPE(args[1]) == T_NULL && SI_TYPE(args[2]) == T_NULL);
+	if(!drop && (!(SI_TYPE(args[1]) & T_STRING) || !(SI_TYPE(args[2]) & T_STRING))) {
+		return PROCEDURE_ERR;
+	}
+
+	const char *relation = args[0].stringval;
+	const char *from = (drop) ? NULL : args[1].stringval;
+	const char *to = (drop) ? NULL : args[2].stringval;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	// Schemas are read by concurrent traversals, readers are locked out.
+	QueryCtx_LockForCommit();
+	GraphContext_SetIntervals(gc, relation, from, to);
+	// Replicated, such that replicas traverse the same intervals.
+	QueryCtx_GetResultSetStatistics()->schemas_modified++;
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_TemporalEdgeSetStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_TemporalEdgeSetFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_TemporalEdgeSetGen() {
+	void *privateData = NULL;
+	ProcedureOutput **output = array_new(ProcedureOutput *, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.temporal.edge.set",
+								   3,
+								   output,
+								   Proc_TemporalEdgeSetStep,
+								   Proc_TemporalEdgeSetInvoke,
+								   Proc_TemporalEdgeSetFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
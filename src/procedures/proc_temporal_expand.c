@@ -0,0 +1,122 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_temporal_expand.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+#include "../index/interval_index.h"
+
+//------------------------------------------------------------------------------
+// db.temporal.expand
+//------------------------------------------------------------------------------
+
+// CALL db.temporal.expand(node, relationship, time) YIELD edge, node
+// MATCH (p:Person) CALL db.temporal.expand(p, 'EMPLOYED', 1577836800000) YIELD node RETURN p, node
+// Yields the outgoing edges of the given relationship type which are valid at the given
+// millisecond timestamp, alongside their destination, as resolved by the relationship
+// type's interval index without fetching the properties of invalid edges.
+
+typedef struct {
+	Graph *g;                   // Graph.
+	int relation;               // Traversed relation ID.
+	IntervalEntry *edges;       // Valid edges.
+	uint64_t next;              // Next edge to yield.
+	Edge edge;                  // Yielded edge.
+	Node node;                  // Yielded destination.
+	bool yield_node;            // Whether destinations are produced.
+	SIValue *output;            // Array with 4 entries ["edge", edge, "node", node].
+} TemporalExpandContext;
+
+ProcedureResult Proc_TemporalExpandInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 3) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_NODE)) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[1]) & T_STRING)) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[2]) & T_INT64)) return PROCEDURE_ERR;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	const char *relationship = args[1].stringval;
+	Schema *s = GraphContext_GetSchema(gc, relationship, SCHEMA_EDGE);
+	if(s && !s->intervals) {
+		char *error;
+		asprintf(&error, "Relationship type %s has no interval index, see db.temporal.edge.set",
+				 relationship);
+		QueryCtx_SetError(error);
+		// Procedure invocation is done at runtime, we expect an exception handler to be set.
+		QueryCtx_RaiseRuntimeException();
+	}
+
+	TemporalExpandContext *pdata = rm_malloc(sizeof(TemporalExpandContext));
+	pdata->g = gc->g;
+	pdata->relation = (s) ? s->id : GRAPH_UNKNOWN_RELATION;
+	pdata->edges = array_new(IntervalEntry, 0);
+	pdata->next = 0;
+	pdata->yield_node = Proc_Yields(ctx, "node");
+	pdata->output = array_new(SIValue, 4);
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("edge"));
+	pdata->output = array_append(pdata->output, SI_Edge(NULL)); // Place holder.
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("node"));
+	pdata->output = array_append(pdata->output, SI_Node(NULL)); // Place holder.
+	ctx->privateData = pdata;
+
+	// Unknown relationship types have no edges.
+	if(s == NULL) return PROCEDURE_OK;
+
+	IntervalIndex *idx = s->intervals;
+	NodeID src = ENTITY_GET_ID((Node *)args[0].ptrval);
+	Attribute_ID from = GraphContext_GetAttributeID(gc, idx->from_attribute);
+	Attribute_ID to = GraphContext_GetAttributeID(gc, idx->to_attribute);
+	IntervalIndex_ValidEdges(idx, gc->g, s->id, from, to, src, args[2].longval, &pdata->edges);
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_TemporalExpandStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+	TemporalExpandContext *pdata = ctx->privateData;
+
+	// Depleted?
+	if(pdata->next >= array_len(pdata->edges)) return NULL;
+	const IntervalEntry *entry = pdata->edges + pdata->next++;
+
+	assert(Graph_GetEdge(pdata->g, entry->id, &pdata->edge));
+	pdata->edge.relationID = pdata->relation;
+	pdata->edge.srcNodeID = entry->src;
+	pdata->edge.destNodeID = entry->dest;
+	pdata->output[1] = SI_Edge(&pdata->edge);
+	if(pdata->yield_node) {
+		Graph_GetNode(pdata->g, entry->dest, &pdata->node);
+		pdata->output[3] = SI_Node(&pdata->node);
+	}
+	return pdata->output;
+}
+
+ProcedureResult Proc_TemporalExpandFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		TemporalExpandContext *pdata = ctx->privateData;
+		array_free(pdata->edges);
+		array_free(pdata->output);
+		rm_free(pdata);
+	}
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_TemporalExpandGen() {
+	void *privateData = NULL;
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, 2);
+	ProcedureOutput *output_edge = rm_malloc(sizeof(ProcedureOutput));
+	ProcedureOutput *output_node = rm_malloc(sizeof(ProcedureOutput));
+	output_edge->name = "edge";
+	output_edge->type = T_EDGE;
+	output_node->name = "node";
+	output_node->type = T_NODE;
+	outputs = array_append(outputs, output_edge);
+	outputs = array_append(outputs, output_node);
+	return ProcCtxNew("db.temporal.expand", 3, outputs, Proc_TemporalExpandStep,
+					  Proc_TemporalExpandInvoke, Proc_TemporalExpandFree, privateData, true);
+}
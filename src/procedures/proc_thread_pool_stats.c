@@ -0,0 +1,94 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_thread_pool_stats.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../util/thpool/pools.h"
+
+// CALL db.threadPoolStats()
+
+#define OUTPUT_COUNT 8
+
+typedef struct {
+	uint lane;          // Current lane.
+	SIValue *output;    // Output stats.
+} ThreadPoolStatsContext;
+
+ProcedureResult Proc_ThreadPoolStatsInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 0) return PROCEDURE_ERR;
+
+	ThreadPoolStatsContext *pdata = rm_malloc(sizeof(ThreadPoolStatsContext));
+	pdata->lane = 0;
+	pdata->output = array_new(SIValue, OUTPUT_COUNT * 2);
+	for(uint i = 0; i < OUTPUT_COUNT; i++) {
+		pdata->output = array_append(pdata->output, SI_ConstStringVal(ctx->output[i]->name));
+		pdata->output = array_append(pdata->output, SI_NullVal()); // Place holder.
+	}
+
+	ctx->privateData = pdata;
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_ThreadPoolStatsStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+
+	ThreadPoolStatsContext *pdata = (ThreadPoolStatsContext *)ctx->privateData;
+
+	// Depleted?
+	if(pdata->lane >= THPOOL_LANE_COUNT) return NULL;
+
+	ThreadPoolLane lane = pdata->lane++;
+	ThreadPoolLaneStats stats = ThreadPools_GetLaneStats(lane);
+	pdata->output[1] = SI_ConstStringVal((char *)ThreadPools_LaneName(lane));
+	pdata->output[3] = SI_LongVal(stats.pending);
+	pdata->output[5] = SI_LongVal(stats.max_pending);
+	pdata->output[7] = SI_LongVal(stats.scheduled);
+	pdata->output[9] = SI_LongVal(stats.rejected);
+	pdata->output[11] = SI_DoubleVal(stats.wait_p50);
+	pdata->output[13] = SI_DoubleVal(stats.wait_p99);
+	pdata->output[15] = SI_DoubleVal(stats.wait_max);
+	return pdata->output;
+}
+
+ProcedureResult Proc_ThreadPoolStatsFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		ThreadPoolStatsContext *pdata = ctx->privateData;
+		array_free(pdata->output);
+		rm_free(ctx->privateData);
+	}
+
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_ThreadPoolStatsCtx() {
+	void *privateData = NULL;
+	char *names[OUTPUT_COUNT] = {"lane", "pending", "max_pending", "scheduled", "rejected",
+								 "wait_p50", "wait_p99", "wait_max"
+								};
+	SIType types[OUTPUT_COUNT] = {T_STRING, T_INT64, T_INT64, T_INT64, T_INT64,
+								  T_DOUBLE, T_DOUBLE, T_DOUBLE
+								 };
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, OUTPUT_COUNT);
+	for(int i = 0; i < OUTPUT_COUNT; i++) {
+		ProcedureOutput *output = rm_malloc(sizeof(ProcedureOutput));
+		output->name = names[i];
+		output->type = types[i];
+		outputs = array_append(outputs, output);
+	}
+
+	ProcedureCtx *ctx = ProcCtxNew("db.threadPoolStats",
+								   0,
+								   outputs,
+								   Proc_ThreadPoolStatsStep,
+								   Proc_ThreadPoolStatsInvoke,
+								   Proc_ThreadPoolStatsFree,
+								   privateData,
+								   true);
+	return ctx;
+}
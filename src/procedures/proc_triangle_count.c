@@ -0,0 +1,154 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_triangle_count.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+#include "../algorithms/triangles.h"
+#include "../algorithms/subgraph_matrix.h"
+
+// CALL algo.triangleCount(label, relationships) YIELD node, triangles, coefficient
+// CALL algo.triangleCount.global(label, relationships) YIELD nodes, triangles, coefficient
+// CALL algo.triangleCount('Person', ['KNOWS', 'WORKS_WITH']) YIELD node, triangles, coefficient
+// A NULL label considers every node, NULL relationships consider every relationship type.
+// Edge directions are ignored, a node's coefficient is the local clustering coefficient,
+// the global coefficient is the ratio of closed triples among connected triples.
+
+typedef struct {
+	Graph *g;                   // Graph.
+	Node node;                  // Node.
+	GrB_Index n;                // Number of considered nodes.
+	GrB_Index i;                // Next node to return.
+	GrB_Index *mappings;        // Mappings between matrix rows and node ids, NULL for identity.
+	uint64_t *triangles;        // Triangles of each matrix row.
+	uint64_t *degrees;          // Neighbors of each matrix row.
+	SIValue *output;            // Yielded values.
+} TriangleCountContext;
+
+static inline NodeID _NodeID(const TriangleCountContext *pdata, GrB_Index i) {
+	return (pdata->mappings) ? pdata->mappings[i] : i;
+}
+
+static ProcedureResult _TriangleCountInvoke(ProcedureCtx *ctx, const SIValue *args, bool global) {
+	if(array_len((SIValue *)args) != 2) return PROCEDURE_ERR;
+	if(!SubgraphMatrix_ValidArgs(args[0], args[1])) return PROCEDURE_ERR;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	TriangleCountContext *pdata = rm_malloc(sizeof(TriangleCountContext));
+	pdata->g = gc->g;
+	pdata->n = 0;
+	pdata->i = 0;
+	pdata->mappings = NULL;
+	pdata->triangles = NULL;
+	pdata->degrees = NULL;
+	pdata->output = array_new(SIValue, 6);
+	pdata->output = array_append(pdata->output, SI_ConstStringVal(global ? "nodes" : "node"));
+	pdata->output = array_append(pdata->output, SI_LongVal(0)); // Place holder.
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("triangles"));
+	pdata->output = array_append(pdata->output, SI_LongVal(0)); // Place holder.
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("coefficient"));
+	pdata->output = array_append(pdata->output, SI_DoubleVal(0)); // Place holder.
+	ctx->privateData = pdata;
+
+	uint64_t triangles = 0;
+	uint64_t triples = 0;
+	GrB_Matrix A = SubgraphMatrix_FromArgs(gc, args[0], args[1], &pdata->mappings, &pdata->n);
+	if(A != GrB_NULL) {
+		if(global) triangles = TriangleCount(A, &triples);
+		else pdata->triangles = TriangleCount_PerNode(A, &pdata->degrees);
+		GrB_free(&A);
+	}
+
+	if(global) {
+		// Each triangle closes three triples.
+		pdata->output[1] = SI_LongVal(pdata->n);
+		pdata->output[3] = SI_LongVal(triangles);
+		pdata->output[5] = SI_DoubleVal((triples > 0) ? (3.0 * triangles) / triples : 0);
+	}
+	return PROCEDURE_OK;
+}
+
+ProcedureResult Proc_TriangleCountInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _TriangleCountInvoke(ctx, args, false);
+}
+
+ProcedureResult Proc_TriangleCountGlobalInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	return _TriangleCountInvoke(ctx, args, true);
+}
+
+SIValue *Proc_TriangleCountStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+	TriangleCountContext *pdata = ctx->privateData;
+
+	// Depleted?
+	if(pdata->i >= pdata->n) return NULL;
+
+	GrB_Index i = pdata->i++;
+	uint64_t triangles = pdata->triangles[i];
+	uint64_t degree = pdata->degrees[i];
+	// A node of degree d takes part in at most d(d-1)/2 triangles.
+	double coefficient = (degree > 1) ? (2.0 * triangles) / (degree * (degree - 1)) : 0;
+	Graph_GetNode(pdata->g, _NodeID(pdata, i), &pdata->node);
+	pdata->output[1] = SI_Node(&pdata->node);
+	pdata->output[3] = SI_LongVal(triangles);
+	pdata->output[5] = SI_DoubleVal(coefficient);
+	return pdata->output;
+}
+
+SIValue *Proc_TriangleCountGlobalStep(ProcedureCtx *ctx) {
+	assert(ctx->privateData);
+	TriangleCountContext *pdata = ctx->privateData;
+
+	// A single summary record.
+	if(pdata->i > 0) return NULL;
+	pdata->i = 1;
+	return pdata->output;
+}
+
+ProcedureResult Proc_TriangleCountFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(ctx->privateData) {
+		TriangleCountContext *pdata = ctx->privateData;
+		if(pdata->output) array_free(pdata->output);
+		if(pdata->mappings) rm_free(pdata->mappings);
+		if(pdata->triangles) rm_free(pdata->triangles);
+		if(pdata->degrees) rm_free(pdata->degrees);
+		rm_free(pdata);
+	}
+	return PROCEDURE_OK;
+}
+
+static ProcedureOutput **_Outputs(bool global) {
+	ProcedureOutput **outputs = array_new(ProcedureOutput *, 3);
+	ProcedureOutput *output_node = rm_malloc(sizeof(ProcedureOutput));
+	ProcedureOutput *output_triangles = rm_malloc(sizeof(ProcedureOutput));
+	ProcedureOutput *output_coefficient = rm_malloc(sizeof(ProcedureOutput));
+	output_node->name = (global) ? "nodes" : "node";
+	output_node->type = (global) ? T_INT64 : T_NODE;
+	output_triangles->name = "triangles";
+	output_triangles->type = T_INT64;
+	output_coefficient->name = "coefficient";
+	output_coefficient->type = T_DOUBLE;
+	outputs = array_append(outputs, output_node);
+	outputs = array_append(outputs, output_triangles);
+	outputs = array_append(outputs, output_coefficient);
+	return outputs;
+}
+
+ProcedureCtx *Proc_TriangleCountGen() {
+	void *privateData = NULL;
+	return ProcCtxNew("algo.triangleCount", 2, _Outputs(false), Proc_TriangleCountStep,
+					  Proc_TriangleCountInvoke, Proc_TriangleCountFree, privateData, true);
+}
+
+ProcedureCtx *Proc_TriangleCountGlobalGen() {
+	void *privateData = NULL;
+	return ProcCtxNew("algo.triangleCount.global", 2, _Outputs(true), Proc_TriangleCountGlobalStep,
+					  Proc_TriangleCountGlobalInvoke, Proc_TriangleCountFree, privateData, true);
+}
@@ -0,0 +1,63 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_ttl_set.h"
+#include "../query_ctx.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// ttl.set
+//------------------------------------------------------------------------------
+
+// CALL db.ttl.set(label, attribute, seconds)
+// CALL db.ttl.set('Event', 'ts', 2592000)
+// Expires the label's nodes seconds past the millisecond timestamp held by attribute,
+// 0 seconds disables expiry.
+
+ProcedureResult Proc_TTLSetInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 3) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING) || !(SI_TYPE(args[1]) & T_STRING) ||
+	   !(SI_TYPE(args[2]) & T_INT64) || args[2].longval < 0) return PROCEDURE_ERR;
+
+	const char *label = args[0].stringval;
+	const char *attribute = args[1].stringval;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	// Schemas are read by the reaper, readers are locked out.
+	QueryCtx_LockForCommit();
+	GraphContext_SetExpiry(gc, label, SCHEMA_NODE, attribute, args[2].longval);
+	// Replicated, such that a promoted replica keeps expiring entities.
+	QueryCtx_GetResultSetStatistics()->schemas_modified++;
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_TTLSetStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_TTLSetFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_TTLSetGen() {
+	void *privateData = NULL;
+	ProcedureOutput **output = array_new(ProcedureOutput *, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.ttl.set",
+								   3,
+								   output,
+								   Proc_TTLSetStep,
+								   Proc_TTLSetInvoke,
+								   Proc_TTLSetFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
@@ -0,0 +1,80 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_vector_create_index.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+#include "../index/vector_index.h"
+
+//------------------------------------------------------------------------------
+// vector createIndex
+//------------------------------------------------------------------------------
+
+// CALL db.idx.vector.createIndex(label, field, dimension, [metric])
+// CALL db.idx.vector.createIndex('Document', 'embedding', 384, 'cosine')
+ProcedureResult Proc_VectorCreateIdxInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	uint arg_count = array_len((SIValue *)args);
+	if(arg_count < 3 || arg_count > 4) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & SI_TYPE(args[1]) & T_STRING)) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[2]) & T_INT64)) return PROCEDURE_ERR;
+	if(arg_count == 4 && !(SI_TYPE(args[3]) & T_STRING)) return PROCEDURE_ERR;
+
+	const char *label = args[0].stringval;
+	const char *field = args[1].stringval;
+	int64_t dim = args[2].longval;
+	VectorMetric metric = VECTOR_METRIC_EUCLIDEAN;
+
+	char *error = NULL;
+	if(dim <= 0 || dim > VECTOR_INDEX_MAX_DIM) {
+		asprintf(&error, "Vector index dimension must be between 1 and %d", VECTOR_INDEX_MAX_DIM);
+	} else if(arg_count == 4 && !VectorIndex_ParseMetric(args[3].stringval, &metric)) {
+		asprintf(&error, "Unknown vector index metric '%s', expecting 'euclidean' or 'cosine'",
+				 args[3].stringval);
+	}
+	if(error) {
+		QueryCtx_SetError(error);
+		/* Raise the exception, we expect an exception handler to be set.
+		 * as procedure invocation is done at runtime. */
+		QueryCtx_RaiseRuntimeException();
+	}
+
+	// Already indexed fields are left as is.
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	VectorIndex *idx = NULL;
+	if(GraphContext_AddVectorIndex(&idx, gc, label, field, dim, metric) == INDEX_OK) {
+		// Build index.
+		VectorIndex_Construct(idx);
+	}
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_VectorCreateIdxStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_VectorCreateIdxFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_VectorCreateIdxGen() {
+	void *privateData = NULL;
+	ProcedureOutput **output = array_new(ProcedureOutput *, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.idx.vector.createIndex",
+								   PROCEDURE_VARIABLE_ARG_COUNT,
+								   output,
+								   Proc_VectorCreateIdxStep,
+								   Proc_VectorCreateIdxInvoke,
+								   Proc_VectorCreateIdxFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
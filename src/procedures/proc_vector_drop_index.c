@@ -0,0 +1,50 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_vector_drop_index.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// vector drop
+//------------------------------------------------------------------------------
+
+// CALL db.idx.vector.drop(label, field)
+// CALL db.idx.vector.drop('Document', 'embedding')
+ProcedureResult Proc_VectorDropIdxInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 2) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & SI_TYPE(args[1]) & T_STRING)) return PROCEDURE_ERR;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	GraphContext_DeleteVectorIndex(gc, args[0].stringval, args[1].stringval);
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_VectorDropIdxStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_VectorDropIdxFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_VectorDropIdxGen() {
+	void *privateData = NULL;
+	ProcedureOutput **output = array_new(ProcedureOutput *, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.idx.vector.drop",
+								   2,
+								   output,
+								   Proc_VectorDropIdxStep,
+								   Proc_VectorDropIdxInvoke,
+								   Proc_VectorDropIdxFree,
+								   privateData,
+								   false);
+	return ctx;
+}
@@ -0,0 +1,143 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_vector_query.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+#include "../index/vector_index.h"
+
+//------------------------------------------------------------------------------
+// vector queryNodes
+//------------------------------------------------------------------------------
+
+// CALL db.idx.vector.queryNodes(label, field, vector, k)
+
+typedef struct {
+	Node n;
+	Graph *g;
+	SIValue *output;
+	NodeID *ids;        // Nearest nodes, closest first.
+	double *distances;  // Distance of each node to the queried vector.
+	uint32_t count;     // Number of nodes retrieved.
+	uint32_t pos;       // Next node to yield.
+} QueryVectorContext;
+
+static void _RaiseError(char *error) {
+	QueryCtx_SetError(error);
+	/* Raise the exception, we expect an exception handler to be set.
+	 * as procedure invocation is done at runtime. */
+	QueryCtx_RaiseRuntimeException();
+}
+
+ProcedureResult Proc_VectorQueryNodeInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 4) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & SI_TYPE(args[1]) & T_STRING)) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[2]) & T_ARRAY) || !(SI_TYPE(args[3]) & T_INT64)) return PROCEDURE_ERR;
+
+	ctx->privateData = NULL;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	char *error = NULL;
+	const char *label = args[0].stringval;
+	const char *field = args[1].stringval;
+	int64_t k = args[3].longval;
+
+	// Get vector index from schema, there's nothing to retrieve from a missing label.
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	if(s == NULL) return PROCEDURE_OK;
+	VectorIndex *idx = Schema_GetVectorIndex(s, field);
+	if(idx == NULL) {
+		asprintf(&error, "No vector index on :%s(%s)", label, field);
+		_RaiseError(error);
+	}
+
+	float query[idx->dim];
+	if(!VectorIndex_ReadVector(args[2], idx->dim, query)) {
+		asprintf(&error, "Expecting a list of %u numerics to query :%s(%s) by", idx->dim, label,
+				 field);
+		_RaiseError(error);
+	}
+	if(k <= 0) {
+		asprintf(&error, "Number of nodes to retrieve must be positive");
+		_RaiseError(error);
+	}
+
+	// Indexed nodes are all retrieved once k exceeds their count.
+	uint64_t count = VectorIndex_Count(idx);
+	if((uint64_t)k > count) k = count;
+
+	ctx->privateData = rm_malloc(sizeof(QueryVectorContext));
+	QueryVectorContext *pdata = ctx->privateData;
+	pdata->g = gc->g;
+	pdata->pos = 0;
+	pdata->ids = rm_malloc(sizeof(NodeID) * k);
+	pdata->distances = rm_malloc(sizeof(double) * k);
+	pdata->count = VectorIndex_Query(idx, query, k, pdata->ids, pdata->distances);
+	pdata->output = array_new(SIValue, 4);
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("node"));
+	pdata->output = array_append(pdata->output, SI_Node(&pdata->n));
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("score"));
+	pdata->output = array_append(pdata->output, SI_DoubleVal(0.0));
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_VectorQueryNodeStep(ProcedureCtx *ctx) {
+	if(!ctx->privateData) return NULL; // No index was attached to this procedure.
+
+	QueryVectorContext *pdata = (QueryVectorContext *)ctx->privateData;
+
+	// Depleted.
+	if(pdata->pos == pdata->count) return NULL;
+
+	// Get Node.
+	Node *n = &pdata->n;
+	Graph_GetNode(pdata->g, pdata->ids[pdata->pos], n);
+
+	pdata->output[1] = SI_Node(n);
+	pdata->output[3] = SI_DoubleVal(pdata->distances[pdata->pos]);
+	pdata->pos++;
+	return pdata->output;
+}
+
+ProcedureResult Proc_VectorQueryNodeFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(!ctx->privateData) return PROCEDURE_OK;
+
+	QueryVectorContext *pdata = ctx->privateData;
+	array_free(pdata->output);
+	rm_free(pdata->ids);
+	rm_free(pdata->distances);
+	rm_free(pdata);
+
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_VectorQueryNodeGen() {
+	void *privateData = NULL;
+	ProcedureOutput **output = array_new(ProcedureOutput *, 2);
+	ProcedureOutput *out_node = rm_malloc(sizeof(ProcedureOutput));
+	out_node->name = "node";
+	out_node->type = T_NODE;
+	ProcedureOutput *out_score = rm_malloc(sizeof(ProcedureOutput));
+	out_score->name = "score";
+	out_score->type = T_DOUBLE;
+
+	output = array_append(output, out_node);
+	output = array_append(output, out_score);
+	ProcedureCtx *ctx = ProcCtxNew("db.idx.vector.queryNodes",
+								   4,
+								   output,
+								   Proc_VectorQueryNodeStep,
+								   Proc_VectorQueryNodeInvoke,
+								   Proc_VectorQueryNodeFree,
+								   privateData,
+								   true);
+	return ctx;
+}
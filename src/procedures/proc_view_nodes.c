@@ -0,0 +1,107 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_view_nodes.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// db.view.nodes
+//------------------------------------------------------------------------------
+
+// CALL db.view.nodes(name) YIELD node
+
+typedef struct {
+	Node n;
+	Graph *g;
+	SIValue *output;
+	NodeID *ids;        // Snapshot of the view's node IDs.
+	uint64_t count;     // Number of IDs.
+	uint64_t pos;       // Next ID to produce.
+} ViewNodesContext;
+
+ProcedureResult Proc_ViewNodesInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 1) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING)) return PROCEDURE_ERR;
+
+	ctx->privateData = NULL;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	const char *name = args[0].stringval;
+
+	NodeID *ids;
+	uint64_t count;
+	if(!MaterializedViews_GetIDs(GraphContext_GetMaterializedViews(gc), name, &ids, &count)) {
+		char *error;
+		asprintf(&error, "Materialized view %s does not exist", name);
+		QueryCtx_SetError(error);
+		// Procedure invocation is done at runtime, we expect an exception handler to be set.
+		QueryCtx_RaiseRuntimeException();
+	}
+
+	ctx->privateData = rm_malloc(sizeof(ViewNodesContext));
+	ViewNodesContext *pdata = ctx->privateData;
+	pdata->g = gc->g;
+	pdata->ids = ids;
+	pdata->count = count;
+	pdata->pos = 0;
+	pdata->output = array_new(SIValue, 2);
+	pdata->output = array_append(pdata->output, SI_ConstStringVal("node"));
+	pdata->output = array_append(pdata->output, SI_Node(&pdata->n));
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_ViewNodesStep(ProcedureCtx *ctx) {
+	ViewNodesContext *pdata = (ViewNodesContext *)ctx->privateData;
+	if(!pdata) return NULL;
+
+	/* Views are refreshed once a modifying command completes,
+	 * skip nodes deleted in the meantime. */
+	size_t dim = Graph_RequiredMatrixDim(pdata->g);
+	while(pdata->pos < pdata->count) {
+		NodeID id = pdata->ids[pdata->pos++];
+		if(id >= dim || !Graph_GetNode(pdata->g, id, &pdata->n)) continue;
+		pdata->output[1] = SI_Node(&pdata->n);
+		return pdata->output;
+	}
+
+	// Depleted.
+	return NULL;
+}
+
+ProcedureResult Proc_ViewNodesFree(ProcedureCtx *ctx) {
+	// Clean up.
+	if(!ctx->privateData) return PROCEDURE_OK;
+
+	ViewNodesContext *pdata = ctx->privateData;
+	array_free(pdata->output);
+	rm_free(pdata->ids);
+	rm_free(pdata);
+
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_ViewNodesGen() {
+	void *privateData = NULL;
+	ProcedureOutput **output = array_new(ProcedureOutput *, 1);
+	ProcedureOutput *out_node = rm_malloc(sizeof(ProcedureOutput));
+	out_node->name = "node";
+	out_node->type = T_NODE;
+
+	output = array_append(output, out_node);
+	ProcedureCtx *ctx = ProcCtxNew("db.view.nodes",
+								   1,
+								   output,
+								   Proc_ViewNodesStep,
+								   Proc_ViewNodesInvoke,
+								   Proc_ViewNodesFree,
+								   privateData,
+								   true);
+	return ctx;
+}
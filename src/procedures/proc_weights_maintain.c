@@ -0,0 +1,64 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_weights_maintain.h"
+#include "../query_ctx.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// weights.maintain
+//------------------------------------------------------------------------------
+
+// CALL db.weights.maintain(relationship, property, maintain)
+// CALL db.weights.maintain('ROAD', 'km', true)
+// Keeps the weight matrix of the relationship type by property in sync with edge writes,
+// such that weighted algorithms don't rebuild it following each write. false stops doing so.
+
+ProcedureResult Proc_WeightsMaintainInvoke(ProcedureCtx *ctx, const SIValue *args) {
+	if(array_len((SIValue *)args) != 3) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & T_STRING) || !(SI_TYPE(args[1]) & T_STRING) ||
+	   !(SI_TYPE(args[2]) & T_BOOL)) return PROCEDURE_ERR;
+
+	const char *relation = args[0].stringval;
+	const char *attribute = args[1].stringval;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	// Weight matrices are read by concurrent algorithms, readers are locked out.
+	QueryCtx_LockForCommit();
+	if(GraphContext_MaintainWeights(gc, relation, attribute, args[2].longval)) {
+		// Replicated, such that replicas maintain the same matrices.
+		QueryCtx_GetResultSetStatistics()->schemas_modified++;
+	}
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_WeightsMaintainStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_WeightsMaintainFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_WeightsMaintainGen() {
+	void *privateData = NULL;
+	ProcedureOutput **output = array_new(ProcedureOutput *, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.weights.maintain",
+								   3,
+								   output,
+								   Proc_WeightsMaintainStep,
+								   Proc_WeightsMaintainInvoke,
+								   Proc_WeightsMaintainFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
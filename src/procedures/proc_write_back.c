@@ -0,0 +1,61 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_write_back.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include <assert.h>
+
+void ProcWriteBack_ValidateProperty(GraphContext *gc, const char *property, const char *what) {
+	Attribute_ID attr = GraphContext_GetAttributeID(gc, property);
+	if(attr == ATTRIBUTE_NOTFOUND) return;
+	uint schema_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
+	for(uint i = 0; i < schema_count; i++) {
+		if(!Schema_IsUnique(GraphContext_GetSchemaByID(gc, i, SCHEMA_NODE), attr)) continue;
+		char *error;
+		asprintf(&error, "Can't write %s to uniquely constrained property '%s'", what, property);
+		QueryCtx_SetError(error);
+		/* Raise the exception, we expect an exception handler to be set.
+		 * as procedure invocation is done at runtime. */
+		QueryCtx_RaiseRuntimeException();
+	}
+}
+
+void ProcWriteBack_Nodes(GraphContext *gc, Attribute_ID attr, const GrB_Index *mappings,
+						 const int64_t *values, GrB_Index n) {
+	// Nodes holding an indexed attribute are reindexed per primary label.
+	Graph *g = gc->g;
+	uint schema_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
+	Node **reindex = rm_calloc(schema_count, sizeof(Node *));
+
+	for(GrB_Index i = 0; i < n; i++) {
+		Node node;
+		assert(Graph_GetNode(g, (mappings) ? mappings[i] : i, &node));
+		SIValue v = SI_LongVal(values[i]);
+
+		SIValue *old_value = GraphEntity_GetProperty((GraphEntity *)&node, attr);
+		GraphContext_UpdateNodeStatistics(gc, &node, attr, *old_value, v);
+		if(old_value == PROPERTY_NOTFOUND) GraphEntity_AddProperty((GraphEntity *)&node, attr, v);
+		else GraphEntity_SetProperty((GraphEntity *)&node, attr, v);
+
+		int label_id = Graph_GetNodeLabel(g, ENTITY_GET_ID(&node));
+		if(label_id == GRAPH_NO_LABEL) continue;
+		Schema *s = GraphContext_GetSchemaByID(gc, label_id, SCHEMA_NODE);
+		if(!Schema_IndexesAttribute(s, attr)) continue;
+		if(!reindex[label_id]) reindex[label_id] = array_new(Node, 1);
+		reindex[label_id] = array_append(reindex[label_id], node);
+	}
+
+	for(uint i = 0; i < schema_count; i++) {
+		if(!reindex[i]) continue;
+		Schema *s = GraphContext_GetSchemaByID(gc, i, SCHEMA_NODE);
+		Schema_ReindexNodes(s, reindex[i], array_len(reindex[i]));
+		array_free(reindex[i]);
+	}
+	rm_free(reindex);
+	QueryCtx_GetResultSetStatistics()->properties_set += n;
+}
@@ -0,0 +1,28 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../graph/graphcontext.h"
+
+/* Raises an error if property is uniquely constrained under any label,
+ * algorithm results are shared by many nodes. */
+void ProcWriteBack_ValidateProperty(
+	GraphContext *gc,           // Graph context.
+	const char *property,       // Property written.
+	const char *what            // Written values, e.g. "components".
+);
+
+/* Sets attr of n nodes, node mappings[i] or i if mappings is NULL, to values[i].
+ * Nodes holding an indexed attribute are reindexed in batches, per primary label.
+ * Expects the graph to be locked for commit. */
+void ProcWriteBack_Nodes(
+	GraphContext *gc,           // Graph context.
+	Attribute_ID attr,          // Attribute to set.
+	const GrB_Index *mappings,  // Node of each value, NULL for identity.
+	const int64_t *values,      // Values to set.
+	GrB_Index n                 // Number of nodes to write.
+);
@@ -23,14 +23,67 @@ void Proc_Register() {
 	_procRegister("db.labels", Proc_LabelsCtx);
 	_procRegister("db.propertyKeys", Proc_PropKeysCtx);
 	_procRegister("db.relationshipTypes", Proc_RelationsCtx);
+	_procRegister("db.planCacheStats", Proc_PlanCacheStatsCtx);
+	_procRegister("db.resultCacheStats", Proc_ResultCacheStatsCtx);
+	_procRegister("db.threadPoolStats", Proc_ThreadPoolStatsCtx);
+	_procRegister("db.queryStats", Proc_QueryStatsCtx);
+	_procRegister("db.accessStats", Proc_AccessStatsCtx);
+	_procRegister("db.matrixStats", Proc_MatrixStatsCtx);
+	_procRegister("db.propertyStats", Proc_PropertyStatsCtx);
 
 	// Register graph algorithms.
 	_procRegister("algo.pageRank", Proc_PagerankCtx);
+	_procRegister("algo.wcc", Proc_WCCGen);
+	_procRegister("algo.scc", Proc_SCCGen);
+	_procRegister("algo.wcc.write", Proc_WCCWriteGen);
+	_procRegister("algo.scc.write", Proc_SCCWriteGen);
+	_procRegister("algo.SSSP", Proc_SSSPGen);
+	_procRegister("algo.triangleCount", Proc_TriangleCountGen);
+	_procRegister("algo.triangleCount.global", Proc_TriangleCountGlobalGen);
+	_procRegister("algo.betweenness", Proc_BetweennessGen);
+	_procRegister("algo.closeness", Proc_ClosenessGen);
+	_procRegister("algo.labelPropagation", Proc_LabelPropagationGen);
+	_procRegister("algo.labelPropagation.write", Proc_LabelPropagationWriteGen);
+	_procRegister("algo.louvain", Proc_LouvainGen);
+	_procRegister("algo.louvain.write", Proc_LouvainWriteGen);
+	_procRegister("algo.randomWalk", Proc_RandomWalkGen);
+	_procRegister("algo.kHop", Proc_KHopGen);
+	_procRegister("algo.project", Proc_ProjectGen);
+	_procRegister("algo.project.drop", Proc_ProjectDropGen);
+	_procRegister("algo.projections", Proc_ProjectionsGen);
 
 	// Register FullText Search generator.
 	_procRegister("db.idx.fulltext.drop", Proc_FulltextDropIdxGen);
 	_procRegister("db.idx.fulltext.queryNodes", Proc_FulltextQueryNodeGen);
 	_procRegister("db.idx.fulltext.createNodeIndex", Proc_FulltextCreateNodeIdxGen);
+	_procRegister("db.idx.fulltext.setAsync", Proc_FulltextSetAsyncGen);
+	_procRegister("db.idx.fulltext.sync", Proc_FulltextSyncGen);
+
+	// Register relationship index generators.
+	_procRegister("db.idx.edge.createIndex", Proc_EdgeCreateIdxGen);
+	_procRegister("db.idx.edge.drop", Proc_EdgeDropIdxGen);
+
+	// Register vector index generators.
+	_procRegister("db.idx.vector.drop", Proc_VectorDropIdxGen);
+	_procRegister("db.idx.vector.queryNodes", Proc_VectorQueryNodeGen);
+	_procRegister("db.idx.vector.createIndex", Proc_VectorCreateIdxGen);
+
+	// Register materialized view scans.
+	_procRegister("db.view.nodes", Proc_ViewNodesGen);
+
+	// Register scans of other graphs.
+	_procRegister("db.graph.nodes", Proc_GraphNodesGen);
+
+	// Register entity expiry.
+	_procRegister("db.ttl.set", Proc_TTLSetGen);
+	_procRegister("db.ttl.edge.set", Proc_EdgeTTLSetGen);
+
+	// Register temporal edges.
+	_procRegister("db.temporal.edge.set", Proc_TemporalEdgeSetGen);
+	_procRegister("db.temporal.expand", Proc_TemporalExpandGen);
+
+	// Register maintained weight matrices.
+	_procRegister("db.weights.maintain", Proc_WeightsMaintainGen);
 }
 
 ProcedureCtx *ProcCtxNew(const char *name,
@@ -51,6 +104,9 @@ ProcedureCtx *ProcCtxNew(const char *name,
 	ctx->Free = fFree;
 	ctx->privateData = privateData;
 	ctx->readOnly = readOnly;
+	ctx->yields = NULL;
+	ctx->limit = 0;
+	ctx->produced = 0;
 	return ctx;
 }
 
@@ -87,10 +143,13 @@ SIValue *Proc_Step(ProcedureCtx *proc) {
 	// Validate procedure state, can only consumed if state is initialized.
 	if(proc->state != PROCEDURE_INIT) return NULL;
 
-	SIValue *val = proc->Step(proc);
+	// Stop stepping once the caller is known to discard any further records.
+	SIValue *val = NULL;
+	if(proc->limit == 0 || proc->produced < proc->limit) val = proc->Step(proc);
 	/* Set procedure state to depleted if NULL is returned.
 	 * NOTE: we might have errored. */
 	if(val == NULL) proc->state = PROCEDURE_DEPLETED;
+	else proc->produced++;
 	return val;
 }
 
@@ -118,6 +177,41 @@ bool Procedure_ContainsOutput(const ProcedureCtx *proc, const char *output) {
 	return false;
 }
 
+void Proc_SetYields(ProcedureCtx *proc, const char **yields, uint yield_count) {
+	assert(proc && proc->state == PROCEDURE_NOT_INIT);
+	uint output_count = array_len(proc->output);
+	if(!proc->yields) proc->yields = rm_malloc(sizeof(bool) * output_count);
+	for(uint i = 0; i < output_count; i++) {
+		proc->yields[i] = false;
+		for(uint j = 0; j < yield_count; j++) {
+			if(strcmp(proc->output[i]->name, yields[j]) == 0) {
+				proc->yields[i] = true;
+				break;
+			}
+		}
+	}
+}
+
+bool Proc_Yields(const ProcedureCtx *proc, const char *output) {
+	assert(proc && output);
+	if(!proc->yields) return true;
+	uint output_count = array_len(proc->output);
+	for(uint i = 0; i < output_count; i++) {
+		if(strcmp(proc->output[i]->name, output) == 0) return proc->yields[i];
+	}
+	return false;
+}
+
+void Proc_SetLimit(ProcedureCtx *proc, uint64_t limit) {
+	assert(proc && proc->state == PROCEDURE_NOT_INIT);
+	proc->limit = limit;
+}
+
+uint64_t Proc_Limit(const ProcedureCtx *proc) {
+	assert(proc);
+	return proc->limit;
+}
+
 bool Proc_ReadOnly(const char *proc_name) {
 	assert(__procedures);
 	ProcGenerator gen = raxFind(__procedures, (unsigned char *)proc_name, strlen(proc_name));
@@ -139,6 +233,7 @@ void Proc_Free(ProcedureCtx *proc) {
 		array_free(proc->output);
 	}
 
+	if(proc->yields) rm_free(proc->yields);
 	rm_free(proc);
 }
 
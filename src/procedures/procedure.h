@@ -41,6 +41,20 @@ const char *Procedure_GetOutput(const ProcedureCtx *proc, uint output_idx);
 /* Returns true if given output can be yield by procedure */
 bool Procedure_ContainsOutput(const ProcedureCtx *proc, const char *output);
 
+/* Informs the procedure which of its outputs are yielded, must be called
+ * prior to invocation, outputs which are not yielded need not be computed. */
+void Proc_SetYields(ProcedureCtx *proc, const char **yields, uint yield_count);
+
+/* Returns true if output is consumed by the procedure's caller. */
+bool Proc_Yields(const ProcedureCtx *proc, const char *output);
+
+/* Bounds the number of records the procedure produces, 0 for unbounded.
+ * Must be called prior to invocation. */
+void Proc_SetLimit(ProcedureCtx *proc, uint64_t limit);
+
+/* Returns the number of records the procedure is bounded by, 0 if unbounded. */
+uint64_t Proc_Limit(const ProcedureCtx *proc);
+
 /* Returns true if procedure is read-only. */
 bool Proc_ReadOnly(const char *proc_name);
 
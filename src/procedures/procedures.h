@@ -6,8 +6,36 @@
 
 #include "proc_labels.h"
 #include "proc_pagerank.h"
+#include "proc_components.h"
+#include "proc_sssp.h"
+#include "proc_triangle_count.h"
+#include "proc_centrality.h"
+#include "proc_communities.h"
+#include "proc_projections.h"
+#include "proc_random_walk.h"
+#include "proc_khop.h"
 #include "proc_relations.h"
 #include "proc_property_keys.h"
+#include "proc_plan_cache_stats.h"
+#include "proc_thread_pool_stats.h"
+#include "proc_matrix_stats.h"
+#include "proc_query_stats.h"
+#include "proc_access_stats.h"
+#include "proc_property_stats.h"
 #include "proc_fulltext_query.h"
 #include "proc_fulltext_drop_index.h"
 #include "proc_fulltext_create_index.h"
+#include "proc_fulltext_set_async.h"
+#include "proc_fulltext_sync.h"
+#include "proc_edge_create_index.h"
+#include "proc_edge_drop_index.h"
+#include "proc_vector_query.h"
+#include "proc_vector_drop_index.h"
+#include "proc_vector_create_index.h"
+#include "proc_view_nodes.h"
+#include "proc_graph_nodes.h"
+#include "proc_ttl_set.h"
+#include "proc_edge_ttl_set.h"
+#include "proc_temporal_edge_set.h"
+#include "proc_temporal_expand.h"
+#include "proc_weights_maintain.h"
@@ -0,0 +1,229 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "projections.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/weight_matrices.h"
+#include "../algorithms/subgraph_matrix.h"
+#include <string.h>
+#include <assert.h>
+
+static int _cmp_relation(const void *a, const void *b) {
+	return *(const int *)a - *(const int *)b;
+}
+
+static void _Projection_FreeMatrices(Projection *p) {
+	if(p->A) GrB_free(&p->A);
+	if(p->W) GrB_free(&p->W);
+	if(p->mappings) rm_free(p->mappings);
+	p->A = GrB_NULL;
+	p->W = GrB_NULL;
+	p->mappings = NULL;
+	p->n = 0;
+	p->built = false;
+}
+
+static void _Projection_Free(Projection *p) {
+	_Projection_FreeMatrices(p);
+	if(p->relations) array_free(p->relations);
+	rm_free(p->name);
+	rm_free(p);
+}
+
+// Builds the smallest weight of the edges connecting every pair of considered nodes.
+static GrB_Matrix _Projection_BuildWeights(const Projection *p, Graph *g) {
+	GrB_Index dim = Graph_RequiredMatrixDim(g);
+	uint relation_count = (p->relations) ? array_len(p->relations) : Graph_RelationTypeCount(g);
+
+	GrB_Matrix W;
+	assert(GrB_Matrix_new(&W, GrB_FP64, dim, dim) == GrB_SUCCESS);
+	for(uint i = 0; i < relation_count; i++) {
+		int relation = (p->relations) ? p->relations[i] : (int)i;
+		const WeightMatrix *wm = WeightMatrices_Get(g, relation, p->weight);
+		assert(GrB_eWiseAdd(W, GrB_NULL, GrB_NULL, GrB_MIN_FP64, W, wm->W,
+							GrB_NULL) == GrB_SUCCESS);
+		WeightMatrix_Release(wm);
+	}
+
+	if(p->mappings == NULL) return W;
+
+	GrB_Matrix reduced;
+	assert(GrB_Matrix_new(&reduced, GrB_FP64, p->n, p->n) == GrB_SUCCESS);
+	assert(GrB_extract(reduced, GrB_NULL, GrB_NULL, W, p->mappings, p->n, p->mappings, p->n,
+					   GrB_NULL) == GrB_SUCCESS);
+	GrB_free(&W);
+	return reduced;
+}
+
+// (Re)builds the projection's matrices at the current graph version, expects the lock to be held.
+static void _Projection_Build(Projection *p, Graph *g) {
+	_Projection_FreeMatrices(p);
+	uint relation_count = (p->relations) ? array_len(p->relations) : 0;
+	p->A = SubgraphMatrix(g, p->label, p->relations, relation_count, &p->mappings, &p->n);
+	if(p->A != GrB_NULL && p->weight != ATTRIBUTE_NOTFOUND) {
+		p->W = _Projection_BuildWeights(p, g);
+	}
+	p->version = g->version;
+	p->built = true;
+	p->builds++;
+}
+
+// Returns the position of projection name, -1 if no such projection exists, expects the lock to be held.
+static int _Projections_Find(const Projections *projections, const char *name) {
+	uint count = array_len(projections->projections);
+	for(uint i = 0; i < count; i++) {
+		if(strcmp(projections->projections[i]->name, name) == 0) return i;
+	}
+	return -1;
+}
+
+// Returns true if p considers label and the sorted relations.
+static bool _Projection_Matches(const Projection *p, int label, const int *relations,
+								uint relation_count) {
+	if(p->label != label) return false;
+	if(p->relations == NULL || relations == NULL) return p->relations == relations;
+	if(array_len(p->relations) != relation_count) return false;
+	return memcmp(p->relations, relations, sizeof(int) * relation_count) == 0;
+}
+
+Projections *Projections_New(void) {
+	Projections *projections = rm_malloc(sizeof(Projections));
+	projections->projections = array_new(Projection *, 0);
+	int res = pthread_mutex_init(&projections->lock, NULL);
+	assert(res == 0);
+	return projections;
+}
+
+bool Projections_Set(Projections *projections, Graph *g, const char *name, int label,
+					 const int *relations, uint relation_count, Attribute_ID weight) {
+	Projection *p = rm_malloc(sizeof(Projection));
+	p->name = rm_strdup(name);
+	p->label = label;
+	p->relations = NULL;
+	p->weight = weight;
+	p->version = 0;
+	p->built = false;
+	p->A = GrB_NULL;
+	p->W = GrB_NULL;
+	p->mappings = NULL;
+	p->n = 0;
+	p->builds = 0;
+	p->hits = 0;
+	if(relations) {
+		p->relations = array_new(int, relation_count);
+		for(uint i = 0; i < relation_count; i++) p->relations = array_append(p->relations, relations[i]);
+		qsort(p->relations, relation_count, sizeof(int), _cmp_relation);
+	}
+
+	pthread_mutex_lock(&projections->lock);
+	int i = _Projections_Find(projections, name);
+	if(i < 0 && array_len(projections->projections) >= PROJECTIONS_MAX) {
+		pthread_mutex_unlock(&projections->lock);
+		_Projection_Free(p);
+		return false;
+	}
+
+	_Projection_Build(p, g);
+	if(i < 0) {
+		projections->projections = array_append(projections->projections, p);
+	} else {
+		_Projection_Free(projections->projections[i]);
+		projections->projections[i] = p;
+	}
+	pthread_mutex_unlock(&projections->lock);
+	return true;
+}
+
+bool Projections_Remove(Projections *projections, const char *name) {
+	pthread_mutex_lock(&projections->lock);
+	int i = _Projections_Find(projections, name);
+	if(i >= 0) {
+		_Projection_Free(projections->projections[i]);
+		array_del_fast(projections->projections, i);
+	}
+	pthread_mutex_unlock(&projections->lock);
+	return i >= 0;
+}
+
+bool Projections_Lookup(Projections *projections, Graph *g, int label, const int *relations,
+						uint relation_count, Attribute_ID weight, GrB_Matrix *A, GrB_Matrix *W,
+						GrB_Index **mappings, GrB_Index *n) {
+	int sorted[relation_count + 1];
+	if(relations) {
+		memcpy(sorted, relations, sizeof(int) * relation_count);
+		qsort(sorted, relation_count, sizeof(int), _cmp_relation);
+	}
+
+	pthread_mutex_lock(&projections->lock);
+	Projection *p = NULL;
+	uint count = array_len(projections->projections);
+	for(uint i = 0; i < count; i++) {
+		Projection *candidate = projections->projections[i];
+		if(W && candidate->weight != weight) continue;
+		if(_Projection_Matches(candidate, label, relations ? sorted : NULL, relation_count)) {
+			p = candidate;
+			break;
+		}
+	}
+
+	if(p == NULL) {
+		pthread_mutex_unlock(&projections->lock);
+		return false;
+	}
+
+	// A write invalidated the projection, rebuild it.
+	if(!p->built || p->version != g->version) _Projection_Build(p, g);
+	p->hits++;
+
+	*n = p->n;
+	*A = GrB_NULL;
+	*mappings = NULL;
+	if(W) *W = GrB_NULL;
+	if(p->A != GrB_NULL) {
+		assert(GrB_Matrix_dup(A, p->A) == GrB_SUCCESS);
+		if(W) assert(GrB_Matrix_dup(W, p->W) == GrB_SUCCESS);
+		if(p->mappings) {
+			*mappings = rm_malloc(sizeof(GrB_Index) * (p->n + 1));
+			memcpy(*mappings, p->mappings, sizeof(GrB_Index) * p->n);
+		}
+	}
+	pthread_mutex_unlock(&projections->lock);
+	return true;
+}
+
+uint Projections_Count(Projections *projections) {
+	pthread_mutex_lock(&projections->lock);
+	uint count = array_len(projections->projections);
+	pthread_mutex_unlock(&projections->lock);
+	return count;
+}
+
+bool Projections_Get(Projections *projections, uint i, char **name, GrB_Index *nodes,
+					 GrB_Index *edges, uint64_t *builds, uint64_t *hits) {
+	pthread_mutex_lock(&projections->lock);
+	bool found = i < array_len(projections->projections);
+	if(found) {
+		Projection *p = projections->projections[i];
+		*name = rm_strdup(p->name);
+		*nodes = p->n;
+		*edges = 0;
+		if(p->A != GrB_NULL) assert(GrB_Matrix_nvals(edges, p->A) == GrB_SUCCESS);
+		*builds = p->builds;
+		*hits = p->hits;
+	}
+	pthread_mutex_unlock(&projections->lock);
+	return found;
+}
+
+void Projections_Free(Projections *projections) {
+	if(projections == NULL) return;
+	uint count = array_len(projections->projections);
+	for(uint i = 0; i < count; i++) _Projection_Free(projections->projections[i]);
+	array_free(projections->projections);
+	pthread_mutex_destroy(&projections->lock);
+	rm_free(projections);
+}
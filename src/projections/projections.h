@@ -0,0 +1,73 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "../graph/graph.h"
+
+// Maximum number of projections defined over a graph.
+#define PROJECTIONS_MAX 32
+
+/* Named subgraph over the nodes of a label and edges of relationship types,
+ * holding the matrices graph algorithms run on, such that repeated runs over
+ * the same subgraph skip rebuilding them. Matrices are valid for the graph
+ * version they were built at and are rebuilt by the first run following a write. */
+typedef struct {
+	char *name;             // Projection name.
+	int label;              // Label ID, GRAPH_NO_LABEL for every node.
+	int *relations;         // Sorted relation IDs, NULL for every relationship type.
+	Attribute_ID weight;    // Weight attribute, ATTRIBUTE_NOTFOUND if unweighted.
+	uint64_t version;       // Graph version matrices were built at.
+	bool built;             // False if matrices were never built.
+	GrB_Matrix A;           // Boolean adjacency between considered nodes, GrB_NULL if none.
+	GrB_Matrix W;           // FP64 smallest edge weights, GrB_NULL if unweighted.
+	GrB_Index *mappings;    // Node ID of each row, NULL if rows correspond to node IDs.
+	GrB_Index n;            // Number of rows.
+	uint64_t builds;        // Number of times matrices were built.
+	uint64_t hits;          // Number of algorithm runs served.
+} Projection;
+
+// Registry of projections defined over a graph.
+typedef struct {
+	Projection **projections;   // Defined projections.
+	pthread_mutex_t lock;       // Guards registry state, concurrent readers may rebuild projections.
+} Projections;
+
+// Create a new projections registry.
+Projections *Projections_New(void);
+
+/* Define a projection named name and build its matrices, an existing projection
+ * of the same name is replaced. Relations of NULL consider every relationship type.
+ * Expects the graph's read lock, returns false if the maximum number of projections is reached. */
+bool Projections_Set(Projections *projections, Graph *g, const char *name, int label,
+					 const int *relations, uint relation_count, Attribute_ID weight);
+
+// Remove projection, returns false if no such projection exists.
+bool Projections_Remove(Projections *projections, const char *name);
+
+/* Retrieve copies of the matrices of a projection over label and relations,
+ * rebuilding them if the graph was modified since they were built.
+ * W may be NULL if weights aren't required, otherwise the projection must weigh edges by weight.
+ * Returns false if no projection matches, A is set to GrB_NULL if the projection holds no nodes.
+ * Expects the graph's read lock, the caller owns the returned matrices and mappings. */
+bool Projections_Lookup(Projections *projections, Graph *g, int label, const int *relations,
+						uint relation_count, Attribute_ID weight, GrB_Matrix *A, GrB_Matrix *W,
+						GrB_Index **mappings, GrB_Index *n);
+
+// Retrieve the number of defined projections.
+uint Projections_Count(Projections *projections);
+
+/* Retrieve a copy of the name of the projection at position i, alongside its
+ * dimensions as of its last build and usage counters. Returns false if i is
+ * out of range, name must be freed by the caller. */
+bool Projections_Get(Projections *projections, uint i, char **name, GrB_Index *nodes,
+					 GrB_Index *edges, uint64_t *builds, uint64_t *hits);
+
+// Free registry and all projections.
+void Projections_Free(Projections *projections);
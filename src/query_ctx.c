@@ -12,6 +12,8 @@
 
 pthread_key_t _tlsQueryCtxKey;  // Thread local storage query context key.
 
+extern long long query_mem_capacity; // Number of bytes a single query may allocate, 0 for unlimited.
+
 static inline QueryCtx *_QueryCtx_GetCtx(void) {
 	QueryCtx *ctx = pthread_getspecific(_tlsQueryCtxKey);
 	if(!ctx) {
@@ -50,6 +52,18 @@ void QueryCtx_Finalize(void) {
 void QueryCtx_BeginTimer(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx(); // Attempt to retrieve the QueryCtx.
 	simple_tic(ctx->internal_exec_ctx.timer); // Start the execution timer.
+	ctx->internal_exec_ctx.lock_wait = 0;
+	ctx->internal_exec_ctx.queue_wait = 0;
+	ctx->internal_exec_ctx.sync_start = Graph_ThreadSyncTime();
+	ctx->internal_exec_ctx.trace = NULL;
+
+	// Charge the thread's allocations to the query, resumed queries are accounted per resumption.
+	MemAccount *account = &ctx->internal_exec_ctx.mem_account;
+	account->allocated = 0;
+	account->peak = 0;
+	account->capacity = query_mem_capacity;
+	account->exceeded = false;
+	Alloc_SetAccount(account);
 }
 
 /* An error was encountered during evaluation, and has already been set in the QueryCtx.
@@ -77,6 +91,16 @@ void QueryCtx_SetGlobalExecutionCtx(CommandCtx *cmd_ctx) {
 	ctx->global_exec_ctx.bc = CommandCtx_GetBlockingClient(cmd_ctx);
 	ctx->global_exec_ctx.redis_ctx = CommandCtx_GetRedisCtx(cmd_ctx);
 	ctx->global_exec_ctx.command_name = CommandCtx_GetCommandName(cmd_ctx);
+	ctx->global_exec_ctx.progress = &cmd_ctx->progress;
+}
+
+void QueryCtx_SetResumedExecutionCtx(CommandCtx *cmd_ctx) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	assert(ctx->gc == CommandCtx_GetGraphContext(cmd_ctx));
+	ctx->global_exec_ctx.bc = CommandCtx_GetBlockingClient(cmd_ctx);
+	ctx->global_exec_ctx.redis_ctx = CommandCtx_GetRedisCtx(cmd_ctx);
+	ctx->global_exec_ctx.command_name = CommandCtx_GetCommandName(cmd_ctx);
+	ctx->global_exec_ctx.progress = &cmd_ctx->progress;
 }
 
 void QueryCtx_SetAST(AST *ast) {
@@ -107,6 +131,42 @@ void QueryCtx_SetLastWriter(OpBase *last_writer) {
 	ctx->internal_exec_ctx.last_writer = last_writer;
 }
 
+void QueryCtx_SetTimeout(double timeout) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	ctx->internal_exec_ctx.timeout = timeout;
+}
+
+void QueryCtx_SetTrace(Trace *trace) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	ctx->internal_exec_ctx.trace = trace;
+}
+
+void QueryCtx_SetPlanUnreusable(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	ctx->internal_exec_ctx.plan_unreusable = true;
+}
+
+void QueryCtx_SetPlanParam(const char *name) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	if(ctx->internal_exec_ctx.plan_built) return;
+	rax **plan_params = &ctx->internal_exec_ctx.plan_params;
+	if(*plan_params == NULL) *plan_params = raxNew();
+	raxInsert(*plan_params, (unsigned char *)name, strlen(name), NULL, NULL);
+}
+
+void QueryCtx_SetPlanBuilt(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	ctx->internal_exec_ctx.plan_built = true;
+}
+
+void QueryCtx_ClearParams(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	if(ctx->query_data.params) {
+		raxFreeWithCallback(ctx->query_data.params, _ParameterFreeCallback);
+		ctx->query_data.params = NULL;
+	}
+}
+
 AST *QueryCtx_GetAST(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
 	assert(ctx->query_data.ast);
@@ -119,6 +179,16 @@ rax *QueryCtx_GetParams(void) {
 	return ctx->query_data.params;
 }
 
+bool QueryCtx_IsPlanReusable(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	return !ctx->internal_exec_ctx.plan_unreusable;
+}
+
+rax *QueryCtx_GetPlanParams(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	return ctx->internal_exec_ctx.plan_params;
+}
+
 GraphContext *QueryCtx_GetGraphCtx(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
 	assert(ctx->gc);
@@ -145,6 +215,24 @@ ResultSetStatistics *QueryCtx_GetResultSetStatistics(void) {
 	return &ctx->internal_exec_ctx.result_set->stats;
 }
 
+OpBase *QueryCtx_GetLastWriter(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	return ctx->internal_exec_ctx.last_writer;
+}
+
+SIValue QueryCtx_NewTransientString(size_t len, char **str) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	// Only queries release their arena.
+	if(ctx->query_data.query) {
+		BumpArena **arena = &ctx->internal_exec_ctx.transient_arena;
+		if(*arena == NULL) *arena = BumpArena_New(QUERY_TRANSIENT_ARENA_LIMIT);
+		*str = BumpArena_Alloc(*arena, len + 1);
+		if(*str) return SI_TransientStringVal(*str);
+	}
+	*str = rm_malloc(len + 1);
+	return SI_TransferStringVal(*str);
+}
+
 void QueryCtx_PrintQuery(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
 	printf("%s\n", ctx->query_data.query);
@@ -161,12 +249,16 @@ static void _QueryCtx_ThreadSafeContextUnlock(QueryCtx *ctx) {
 bool QueryCtx_LockForCommit(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
 	if(ctx->internal_exec_ctx.locked_for_commit) return true;
-	// Lock GIL.
 	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
 	GraphContext *gc = ctx->gc;
 	RedisModuleString *graphID = RedisModule_CreateString(redis_ctx, gc->graph_name,
 														  strlen(gc->graph_name));
 	char *error;
+	double wait_timer[2];
+	simple_tic(wait_timer);
+	Trace *trace = ctx->internal_exec_ctx.trace;
+	int64_t span_start = Trace_Now(trace);
+	// Lock GIL.
 	_QueryCtx_ThreadSafeContextLock(ctx);
 	// Open key and verify.
 	RedisModuleKey *key = RedisModule_OpenKey(redis_ctx, graphID, REDISMODULE_WRITE);
@@ -194,7 +286,10 @@ bool QueryCtx_LockForCommit(void) {
 	ctx->internal_exec_ctx.key = key;
 	// Acquire graph write lock.
 	Graph_AcquireWriteLock(gc->g);
+	ctx->internal_exec_ctx.lock_wait += simple_toc(wait_timer) * 1000;
+	Trace_EndSpan(trace, "commit_lock_wait", Trace_Root(trace), span_start, 0);
 	ctx->internal_exec_ctx.locked_for_commit = true;
+	ctx->internal_exec_ctx.committed = true;
 
 	return true;
 
@@ -209,17 +304,21 @@ clean_up:
 
 }
 
-void QueryCtx_UnlockCommit(OpBase *writer_op) {
-	QueryCtx *ctx = _QueryCtx_GetCtx();
-	// Check that the writer_op is entitled to release the lock.
-	if(ctx->internal_exec_ctx.last_writer != writer_op) return;
-	if(!ctx->internal_exec_ctx.locked_for_commit) return;
+/* Replicate the query if it modified the graph and release the commit locks.
+ * Work following the commits of a commit group's window is deferred to the window's end.
+ * Returns true if the caller should schedule the work following the commit. */
+static bool _QueryCtx_ReleaseCommit(QueryCtx *ctx, bool modified) {
 	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
 	GraphContext *gc = ctx->gc;
-	if(ResultSetStat_IndicateModification(ctx->internal_exec_ctx.result_set->stats))
+	if(modified) {
 		// Replicate only in case of changes.
 		RedisModule_Replicate(redis_ctx, ctx->global_exec_ctx.command_name, "cc!", gc->graph_name,
 							  ctx->query_data.query);
+		// Replicas advance their version as they apply the replicated query.
+		ctx->internal_exec_ctx.result_set->version = GraphContext_AdvanceWriteVersion(gc);
+	}
+	// Captured changes are stamped with the version they committed at.
+	ChangeFeed_Commit(redis_ctx, gc->changes, GraphContext_GetWriteVersion(gc));
 	ctx->internal_exec_ctx.locked_for_commit = false;
 	// Release graph R/W lock.
 	Graph_ReleaseLock(gc->g);
@@ -227,27 +326,64 @@ void QueryCtx_UnlockCommit(OpBase *writer_op) {
 	RedisModule_CloseKey(ctx->internal_exec_ctx.key);
 	// Unlock GIL.
 	_QueryCtx_ThreadSafeContextUnlock(ctx);
+	CommitGroup *group = GraphContext_GetCommitGroup(gc);
+	if(CommitGroup_IsLeader(group)) {
+		group->modified |= modified;
+		return false;
+	}
+	return true;
 }
 
-void QueryCtx_ForceUnlockCommit() {
+void QueryCtx_UnlockCommit(OpBase *writer_op) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
+	// Check that the writer_op is entitled to release the lock.
+	if(ctx->internal_exec_ctx.last_writer != writer_op) return;
 	if(!ctx->internal_exec_ctx.locked_for_commit) return;
-	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
 	GraphContext *gc = ctx->gc;
-	RedisModule_Log(redis_ctx, "warning",
+	bool modified = ResultSetStat_IndicateModification(ctx->internal_exec_ctx.result_set->stats);
+	if(_QueryCtx_ReleaseCommit(ctx, modified) && modified) {
+		// Fold committed changes into the graph matrices and asynchronous indices off the read path.
+		GraphContext_ScheduleSynchronization(gc);
+		GraphContext_ScheduleIndexUpdates(gc);
+		GraphContext_ScheduleChangeFeed(gc);
+	}
+}
+
+void QueryCtx_ForceUnlockCommit() {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	if(!ctx->internal_exec_ctx.locked_for_commit) return;
+	RedisModule_Log(ctx->global_exec_ctx.redis_ctx, "warning",
 					"RedisGraph used forced unlocking commit flow for the query %s",
 					ctx->query_data.query);
-	if(ResultSetStat_IndicateModification(ctx->internal_exec_ctx.result_set->stats))
-		// Replicate only in case of changes.
-		RedisModule_Replicate(redis_ctx, ctx->global_exec_ctx.command_name, "cc!", gc->graph_name,
-							  ctx->query_data.query);
-	ctx->internal_exec_ctx.locked_for_commit = false;
-	// Release graph R/W lock.
-	Graph_ReleaseLock(gc->g);
-	// Close Key.
-	RedisModule_CloseKey(ctx->internal_exec_ctx.key);
-	// Unlock GIL.
-	_QueryCtx_ThreadSafeContextUnlock(ctx);
+	if(_QueryCtx_ReleaseCommit(ctx,
+							   ResultSetStat_IndicateModification(ctx->internal_exec_ctx.result_set->stats))) {
+		GraphContext_ScheduleChangeFeed(ctx->gc);
+	}
+}
+
+bool QueryCtx_EndCommitWindow(GraphContext *gc) {
+	CommitGroup *group = GraphContext_GetCommitGroup(gc);
+	bool modified = group->modified;
+	group->modified = false;
+	if(modified) {
+		GraphContext_ScheduleSynchronization(gc);
+		GraphContext_ScheduleIndexUpdates(gc);
+		GraphContext_ScheduleChangeFeed(gc);
+	}
+	return modified;
+}
+
+GraphContext *QueryCtx_RetrieveGraph(const char *graph_name) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
+	// Committing writers hold the GIL.
+	bool acquire = !ctx->internal_exec_ctx.locked_for_commit;
+	if(acquire) _QueryCtx_ThreadSafeContextLock(ctx);
+	RedisModuleString *graphID = RedisModule_CreateString(redis_ctx, graph_name, strlen(graph_name));
+	GraphContext *gc = GraphContext_Retrieve(redis_ctx, graphID, true, false);
+	RedisModule_FreeString(redis_ctx, graphID);
+	if(acquire) _QueryCtx_ThreadSafeContextUnlock(ctx);
+	return gc;
 }
 
 inline bool QueryCtx_EncounteredError(void) {
@@ -260,8 +396,81 @@ double QueryCtx_GetExecutionTime(void) {
 	return simple_toc(ctx->internal_exec_ctx.timer) * 1000;
 }
 
+size_t QueryCtx_GetPeakMemory(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	return ctx->internal_exec_ctx.mem_account.peak;
+}
+
+double QueryCtx_GetLockWait(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	return ctx->internal_exec_ctx.lock_wait;
+}
+
+void QueryCtx_AddLockWait(double ms) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	ctx->internal_exec_ctx.lock_wait += ms;
+}
+
+double QueryCtx_GetQueueWait(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	return ctx->internal_exec_ctx.queue_wait;
+}
+
+void QueryCtx_SetQueueWait(double ms) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	ctx->internal_exec_ctx.queue_wait = ms;
+}
+
+double QueryCtx_GetMatrixSync(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	return Graph_ThreadSyncTime() - ctx->internal_exec_ctx.sync_start;
+}
+
+// Number of timeout checks between consecutive clock reads.
+#define TIMEOUT_CHECK_INTERVAL 1024
+
+bool QueryCtx_PollTimeout(const OpBase *op) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	QueryCtx_InternalExecCtx *exec_ctx = &ctx->internal_exec_ctx;
+	MemAccount *account = &exec_ctx->mem_account;
+	/* Once a query commits, its changes are replicated and visible to other queries,
+	 * it is no longer aborted, neither while committing nor while its trailing operations run. */
+	if(account->exceeded && !exec_ctx->committed) {
+		// Disable further checks, the query is being aborted.
+		account->capacity = 0;
+		account->exceeded = false;
+		QueryCtx_SetError(strdup("Query's memory consumption exceeded capacity"));
+		return true;
+	}
+	if(exec_ctx->timeout == 0) return false;
+	// Avoid reading the clock on every check.
+	if(++exec_ctx->timeout_checks % TIMEOUT_CHECK_INTERVAL != 0) return false;
+
+	// Publish progress, read by the main thread if the client times out.
+	QueryProgress *progress = ctx->global_exec_ctx.progress;
+	if(progress) {
+		ResultSet *set = exec_ctx->result_set;
+		__atomic_store_n(&progress->records, (set) ? set->recordCount : 0, __ATOMIC_RELAXED);
+		if(op) __atomic_store_n(&progress->op, op->name, __ATOMIC_RELAXED);
+	}
+
+	if(exec_ctx->committed) return false;
+	bool cancelled = progress && __atomic_load_n(&progress->cancelled, __ATOMIC_RELAXED);
+	if(!cancelled && simple_toc(exec_ctx->timer) * 1000 < exec_ctx->timeout) return false;
+
+	// Disable further checks, the query is being aborted.
+	exec_ctx->timeout = 0;
+	QueryCtx_SetError(strdup("Query timed out"));
+	return true;
+}
+
+void QueryCtx_CheckTimeout(const OpBase *op) {
+	if(QueryCtx_PollTimeout(op)) QueryCtx_RaiseRuntimeException();
+}
+
 void QueryCtx_Free(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
+	Alloc_SetAccount(NULL);
 
 	if(ctx->internal_exec_ctx.error) {
 		free(ctx->internal_exec_ctx.error);
@@ -273,12 +482,32 @@ void QueryCtx_Free(void) {
 		ctx->internal_exec_ctx.breakpoint = NULL;
 	}
 
-	if(ctx->query_data.params) {
-		raxFreeWithCallback(ctx->query_data.params, _ParameterFreeCallback);
-		ctx->query_data.params = NULL;
+	QueryCtx_ClearParams();
+
+	if(ctx->internal_exec_ctx.plan_params) {
+		raxFree(ctx->internal_exec_ctx.plan_params);
+		ctx->internal_exec_ctx.plan_params = NULL;
+	}
+
+	if(ctx->internal_exec_ctx.transient_arena) {
+		BumpArena_Free(ctx->internal_exec_ctx.transient_arena);
+		ctx->internal_exec_ctx.transient_arena = NULL;
 	}
 
 	rm_free(ctx);
 	// NULL-set the context for reuse the next time this thread receives a query
 	pthread_setspecific(_tlsQueryCtxKey, NULL);
 }
+
+QueryCtx *QueryCtx_Detach(void) {
+	QueryCtx *ctx = pthread_getspecific(_tlsQueryCtxKey);
+	pthread_setspecific(_tlsQueryCtxKey, NULL);
+	Alloc_SetAccount(NULL);
+	return ctx;
+}
+
+void QueryCtx_Attach(QueryCtx *ctx) {
+	assert(pthread_getspecific(_tlsQueryCtxKey) == NULL);
+	pthread_setspecific(_tlsQueryCtxKey, ctx);
+	Alloc_SetAccount(&ctx->internal_exec_ctx.mem_account);
+}
@@ -15,6 +15,11 @@
 #include "commands/cmd_context.h"
 #include "resultset/resultset.h"
 #include "execution_plan/ops/op.h"
+#include "util/bump_arena.h"
+#include "tracing/trace.h"
+
+// Maximum size of a query's transient arena, further transient strings are heap allocated.
+#define QUERY_TRANSIENT_ARENA_LIMIT (64 * 1024 * 1024)
 
 extern pthread_key_t _tlsQueryCtxKey;  // Thread local storage query context key.
 
@@ -31,13 +36,26 @@ typedef struct {
 	RedisModuleKey *key;        // Saves an open key value, for later extraction and closing.
 	ResultSet *result_set;      // Save the execution result set.
 	bool locked_for_commit;     // Indicates if a call for QueryCtx_LockForCommit issued before.
+	bool committed;             // Indicates the query started committing changes, never reset.
 	OpBase *last_writer;        // The last writer operation which indicates the need for commit.
+	bool plan_unreusable;       // Indicates the execution plan was specialized for this query's data.
+	bool plan_built;            // Indicates the execution plan is built and being executed.
+	rax *plan_params;           // Names of the parameters the execution plan was specialized for.
+	double timeout;             // Maximum query execution time in milliseconds, 0 for unlimited.
+	uint timeout_checks;        // Number of timeout checks performed.
+	BumpArena *transient_arena; // Intermediate values released with the query.
+	MemAccount mem_account;     // Memory allocated by the query's thread while executing it.
+	double lock_wait;           // Milliseconds spent waiting for the graph's and Redis' locks.
+	double queue_wait;          // Milliseconds the query waited in a thread pool queue.
+	double sync_start;          // The thread's matrix synchronization time as the query started.
+	Trace *trace;               // Spans of the query, NULL if the query isn't traced.
 } QueryCtx_InternalExecCtx;
 
 typedef struct {
 	RedisModuleCtx *redis_ctx;      // The Redis module context.
 	RedisModuleBlockedClient *bc;   // Blocked client.
 	const char *command_name;       // Command name.
+	QueryProgress *progress;        // Progress reported to the command's client.
 } QueryCtx_GlobalExecCtx;
 
 typedef struct {
@@ -60,7 +78,7 @@ typedef struct {
 bool QueryCtx_Init(void);
 /* Free the thread-local QueryCtx variable (unused). */
 void QueryCtx_Finalize(void);
-/* Start timing query execution. */
+/* Start timing query execution and accounting the memory it allocates. */
 void QueryCtx_BeginTimer(void);
 
 /* Jump to a runtime exception breakpoint if one has been set. */
@@ -71,6 +89,8 @@ void QueryCtx_EmitException(void);
 /* Setters */
 /* Sets the global execution context */
 void QueryCtx_SetGlobalExecutionCtx(CommandCtx *cmd_ctx);
+/* Sets the global execution context of a resumed query, retaining the query it was issued with. */
+void QueryCtx_SetResumedExecutionCtx(CommandCtx *cmd_ctx);
 /* Set the provided AST for access through the QueryCtx. */
 void QueryCtx_SetAST(AST *ast);
 /* Set the error message for this query. */
@@ -84,11 +104,38 @@ void QueryCtx_SetResultSet(ResultSet *result_set);
 /* Set the last writer which needs to commit */
 void QueryCtx_SetLastWriter(OpBase *op);
 
+/* Set the maximum execution time of the query in milliseconds, 0 for unlimited. */
+void QueryCtx_SetTimeout(double timeout);
+
+/* Set the trace collecting the query's spans, owned by the caller. */
+void QueryCtx_SetTrace(Trace *trace);
+
+/* Mark the execution plan as dependent on the current query's data,
+ * such a plan must not be reused by later queries. */
+void QueryCtx_SetPlanUnreusable(void);
+
+/* Mark the execution plan as dependent on the value of parameter name,
+ * such a plan may only be reused by queries passing the same value.
+ * Has no effect once the plan is being executed. */
+void QueryCtx_SetPlanParam(const char *name);
+
+/* Mark the execution plan as built, parameters evaluated from
+ * now on are evaluated per record and don't specialize the plan. */
+void QueryCtx_SetPlanBuilt(void);
+
+/* Free the query parameters, allowing them to be extracted again. */
+void QueryCtx_ClearParams(void);
+
 /* Getters */
 /* Retrieve the AST. */
 AST *QueryCtx_GetAST(void);
 /* Retrive the query parameters values map. */
 rax *QueryCtx_GetParams(void);
+
+/* Returns true if the execution plan built for this query may be reused. */
+bool QueryCtx_IsPlanReusable(void);
+/* Retrieve the names of the parameters the execution plan was specialized for, NULL if none. */
+rax *QueryCtx_GetPlanParams(void);
 /* Retrieve the Graph object. */
 Graph *QueryCtx_GetGraph(void);
 /* Retrieve the GraphCtx. */
@@ -99,6 +146,25 @@ RedisModuleCtx *QueryCtx_GetRedisModuleCtx(void);
 ResultSet *QueryCtx_GetResultSet(void);
 /* Retrive the resultset statistics. */
 ResultSetStatistics *QueryCtx_GetResultSetStatistics(void);
+/* Retrieve the last writer of the executed plan, NULL if the plan doesn't write. */
+OpBase *QueryCtx_GetLastWriter(void);
+
+/* Abort the query through the runtime exception breakpoint if it exceeded its timeout,
+ * its memory capacity, or its client was released. Queries which started committing changes are never aborted.
+ * Queries with a timeout periodically publish their progress, op is the operation
+ * being executed, if known. */
+void QueryCtx_CheckTimeout(const OpBase *op);
+
+/* Same checks as QueryCtx_CheckTimeout, but returns true instead of raising once the query
+ * is to be aborted, its error already set. Lets long running computations free
+ * their intermediate state before raising through QueryCtx_RaiseRuntimeException. */
+bool QueryCtx_PollTimeout(const OpBase *op);
+
+/* Create a string of len characters, excluding its terminating NULL, scoped to the
+ * current query, str is set to the string's buffer. The string is served by the query's
+ * transient arena and released at once by QueryCtx_Free, outside of queries
+ * or once the arena is exhausted the string is allocated from the heap. */
+SIValue QueryCtx_NewTransientString(size_t len, char **str);
 
 /* Print the current query. */
 void QueryCtx_PrintQuery(void);
@@ -112,7 +178,9 @@ void QueryCtx_PrintQuery(void);
  * locks in this call or a previous call. In case that the locks are already locked, there will
  * be no attempt to lock them again.
  * This method returns false if the key has changed from the current graph,
- * and sets the relevant error message. */
+ * and sets the relevant error message.
+ * Writers run by a commit group's leader acquire and release the locks like any other writer,
+ * only the work following their commits is deferred to QueryCtx_EndCommitWindow. */
 bool QueryCtx_LockForCommit(void);
 
 /* Starts an ulocking flow and notifies Redis after commiting changes in the graph and Redis keyspace.
@@ -133,10 +201,40 @@ void QueryCtx_UnlockCommit(OpBase *writer_op);
  * some reason the last writer op has not invoked QueryCtx_UnlockCommit and Redis is locked.*/
 void QueryCtx_ForceUnlockCommit(void);
 
+/* Ends the current window of the commit group led by the calling thread,
+ * scheduling the synchronization of the graph's matrices once for all of the window's writers.
+ * Returns true if a writer of the window modified the graph. */
+bool QueryCtx_EndCommitWindow(GraphContext *gc);
+
+/* Retrieve another graph read by the query alongside its own graph, acquiring the GIL
+ * for the keyspace lookup unless the query already holds it.
+ * Returns NULL if no graph is named graph_name, the caller releases the returned graph. */
+GraphContext *QueryCtx_RetrieveGraph(const char *graph_name);
+
 /* Compute and return elapsed query execution time. */
 double QueryCtx_GetExecutionTime(void);
+/* Returns the maximum number of bytes the query had allocated at once,
+ * 0 if allocations aren't accounted. */
+size_t QueryCtx_GetPeakMemory(void);
+/* Returns the number of milliseconds the query waited for locks. */
+double QueryCtx_GetLockWait(void);
+/* Charge ms milliseconds spent waiting for a lock to the query. */
+void QueryCtx_AddLockWait(double ms);
+/* Returns the number of milliseconds the query waited in a thread pool queue. */
+double QueryCtx_GetQueueWait(void);
+/* Set the number of milliseconds the query waited in a thread pool queue. */
+void QueryCtx_SetQueueWait(double ms);
+/* Returns the number of milliseconds the query spent synchronizing the graph's matrices,
+ * including waiting for concurrent synchronizations of pending changes made by writers. */
+double QueryCtx_GetMatrixSync(void);
 /* Returns true if this query has caused an error. */
 bool QueryCtx_EncounteredError(void);
 /* Free the allocations within the QueryCtx and reset it for the next query. */
 void QueryCtx_Free(void);
 
+/* Detach the QueryCtx from the current thread, such that a suspended query
+ * may later resume on any thread, returns NULL if the thread has no QueryCtx. */
+QueryCtx *QueryCtx_Detach(void);
+/* Attach a detached QueryCtx to the current thread, which must not have a QueryCtx. */
+void QueryCtx_Attach(QueryCtx *ctx);
+
@@ -0,0 +1,105 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "query_stats.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include <assert.h>
+
+static QueryStatsEntry *_QueryStatsEntry_New(uint64_t fingerprint, const char *query) {
+	QueryStatsEntry *entry = rm_malloc(sizeof(QueryStatsEntry));
+	entry->fingerprint = fingerprint;
+	entry->query = rm_strdup(query);
+	entry->errors = 0;
+	entry->latency = LatencyHistogram_New();
+	return entry;
+}
+
+static void _QueryStatsEntry_Free(QueryStatsEntry *entry) {
+	rm_free(entry->query);
+	LatencyHistogram_Free(entry->latency);
+	rm_free(entry);
+}
+
+// Replace the least executed entry, returns its position.
+static uint _QueryStats_Evict(QueryStats *stats) {
+	uint count = array_len(stats->entries);
+	uint victim = 0;
+	for(uint i = 1; i < count; i++) {
+		if(stats->entries[i]->latency->count < stats->entries[victim]->latency->count) victim = i;
+	}
+
+	QueryStatsEntry *entry = stats->entries[victim];
+	raxRemove(stats->lookup, (unsigned char *)&entry->fingerprint, sizeof(uint64_t), NULL);
+	_QueryStatsEntry_Free(entry);
+	return victim;
+}
+
+QueryStats *QueryStats_New(void) {
+	QueryStats *stats = rm_malloc(sizeof(QueryStats));
+	stats->lookup = raxNew();
+	stats->entries = array_new(QueryStatsEntry *, 16);
+	int res = pthread_mutex_init(&stats->lock, NULL);
+	assert(res == 0);
+	return stats;
+}
+
+void QueryStats_Record(QueryStats *stats, uint64_t fingerprint, const char *query, double latency,
+					   bool failed) {
+	assert(stats && query);
+
+	pthread_mutex_lock(&stats->lock);
+	QueryStatsEntry *entry = raxFind(stats->lookup, (unsigned char *)&fingerprint, sizeof(uint64_t));
+	if(entry == raxNotFound) {
+		entry = _QueryStatsEntry_New(fingerprint, query);
+		if(array_len(stats->entries) < QUERY_STATS_CAPACITY) {
+			stats->entries = array_append(stats->entries, entry);
+		} else {
+			stats->entries[_QueryStats_Evict(stats)] = entry;
+		}
+		raxInsert(stats->lookup, (unsigned char *)&fingerprint, sizeof(uint64_t), entry, NULL);
+	}
+	LatencyHistogram_Record(entry->latency, latency);
+	if(failed) entry->errors++;
+	pthread_mutex_unlock(&stats->lock);
+}
+
+QueryStatsSnapshot *QueryStats_Snapshot(QueryStats *stats) {
+	assert(stats);
+
+	pthread_mutex_lock(&stats->lock);
+	uint count = array_len(stats->entries);
+	QueryStatsSnapshot *snapshot = array_new(QueryStatsSnapshot, count);
+	for(uint i = 0; i < count; i++) {
+		QueryStatsEntry *entry = stats->entries[i];
+		QueryStatsSnapshot item = {
+			.fingerprint = entry->fingerprint,
+			.query = rm_strdup(entry->query),
+			.errors = entry->errors,
+			.latency = LatencyHistogram_Summarize(entry->latency)
+		};
+		snapshot = array_append(snapshot, item);
+	}
+	pthread_mutex_unlock(&stats->lock);
+
+	return snapshot;
+}
+
+void QueryStats_FreeSnapshot(QueryStatsSnapshot *snapshot) {
+	uint count = array_len(snapshot);
+	for(uint i = 0; i < count; i++) rm_free(snapshot[i].query);
+	array_free(snapshot);
+}
+
+void QueryStats_Free(QueryStats *stats) {
+	if(stats == NULL) return;
+	uint count = array_len(stats->entries);
+	for(uint i = 0; i < count; i++) _QueryStatsEntry_Free(stats->entries[i]);
+	array_free(stats->entries);
+	raxFree(stats->lookup);
+	pthread_mutex_destroy(&stats->lock);
+	rm_free(stats);
+}
@@ -0,0 +1,59 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "../util/latency_histogram.h"
+#include "rax.h"
+
+// Maximum number of plan fingerprints tracked per graph.
+#define QUERY_STATS_CAPACITY 256
+
+// Executions of queries sharing an execution plan fingerprint.
+typedef struct {
+	uint64_t fingerprint;           // Fingerprint of the executed plan.
+	char *query;                    // Body of the first query executed by the plan.
+	uint64_t errors;                // Number of failed executions.
+	LatencyHistogram *latency;      // Latency distribution, counting all executions.
+} QueryStatsEntry;
+
+// Snapshot of a QueryStatsEntry, latencies in milliseconds.
+typedef struct {
+	uint64_t fingerprint;   // Fingerprint of the executed plan.
+	char *query;            // Body of the first query executed by the plan.
+	uint64_t errors;        // Number of failed executions.
+	LatencySummary latency; // Summary of the latency distribution.
+} QueryStatsSnapshot;
+
+/* Execution statistics of a graph's queries, aggregated by plan fingerprint.
+ * Up to QUERY_STATS_CAPACITY fingerprints are tracked, once full a new fingerprint
+ * replaces the least executed one. */
+typedef struct {
+	rax *lookup;                // Entries keyed by fingerprint.
+	QueryStatsEntry **entries;  // Tracked entries.
+	pthread_mutex_t lock;       // Guards all state.
+} QueryStats;
+
+// Create an empty query stats registry.
+QueryStats *QueryStats_New(void);
+
+/* Record an execution of the plan identified by fingerprint,
+ * query is the query's body, copied if the fingerprint isn't tracked yet. */
+void QueryStats_Record(QueryStats *stats, uint64_t fingerprint, const char *query, double latency,
+					   bool failed);
+
+/* Snapshot all tracked entries, the returned array and its queries
+ * are freed with QueryStats_FreeSnapshot. */
+QueryStatsSnapshot *QueryStats_Snapshot(QueryStats *stats);
+
+// Free a snapshot returned by QueryStats_Snapshot.
+void QueryStats_FreeSnapshot(QueryStatsSnapshot *snapshot);
+
+// Free query stats.
+void QueryStats_Free(QueryStats *stats);
@@ -164,6 +164,7 @@ typedef struct RedisModuleDict RedisModuleDict;
 typedef struct RedisModuleDictIter RedisModuleDictIter;
 typedef struct RedisModuleCommandFilterCtx RedisModuleCommandFilterCtx;
 typedef struct RedisModuleCommandFilter RedisModuleCommandFilter;
+typedef struct RedisModuleDefragCtx RedisModuleDefragCtx;
 
 typedef int (*RedisModuleCmdFunc)(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 typedef void (*RedisModuleDisconnectFunc)(RedisModuleCtx *ctx, RedisModuleBlockedClient *bc);
@@ -182,8 +183,16 @@ typedef void (*RedisModuleClusterMessageReceiver)(RedisModuleCtx *ctx, const cha
 												  uint8_t type, const unsigned char *payload, uint32_t len);
 typedef void (*RedisModuleTimerProc)(RedisModuleCtx *ctx, void *data);
 typedef void (*RedisModuleCommandFilterFunc)(RedisModuleCommandFilterCtx *filter);
-
-#define REDISMODULE_TYPE_METHOD_VERSION 2
+typedef size_t (*RedisModuleTypeFreeEffortFunc)(RedisModuleString *key, const void *value);
+typedef void (*RedisModuleTypeUnlinkFunc)(RedisModuleString *key, const void *value);
+typedef void *(*RedisModuleTypeCopyFunc)(RedisModuleString *fromkey, RedisModuleString *tokey,
+										 const void *value);
+typedef int (*RedisModuleTypeDefragFunc)(RedisModuleDefragCtx *ctx, RedisModuleString *key,
+										 void **value);
+
+/* Servers predating a method version read the methods of the versions they know,
+ * ignoring the rest. */
+#define REDISMODULE_TYPE_METHOD_VERSION 3
 typedef struct RedisModuleTypeMethods {
 	uint64_t version;
 	RedisModuleTypeLoadFunc rdb_load;
@@ -195,6 +204,10 @@ typedef struct RedisModuleTypeMethods {
 	RedisModuleTypeAuxLoadFunc aux_load;
 	RedisModuleTypeAuxSaveFunc aux_save;
 	int aux_save_triggers;
+	RedisModuleTypeFreeEffortFunc free_effort;
+	RedisModuleTypeUnlinkFunc unlink;
+	RedisModuleTypeCopyFunc copy;
+	RedisModuleTypeDefragFunc defrag;
 } RedisModuleTypeMethods;
 
 #define REDISMODULE_GET_API(name) \
@@ -208,6 +221,13 @@ void *REDISMODULE_API_FUNC(RedisModule_Realloc)(void *ptr, size_t bytes);
 void REDISMODULE_API_FUNC(RedisModule_Free)(void *ptr);
 void *REDISMODULE_API_FUNC(RedisModule_Calloc)(size_t nmemb, size_t size);
 char *REDISMODULE_API_FUNC(RedisModule_Strdup)(const char *str);
+size_t REDISMODULE_API_FUNC(RedisModule_MallocSize)(void *ptr);
+void *REDISMODULE_API_FUNC(RedisModule_DefragAlloc)(RedisModuleDefragCtx *ctx, void *ptr);
+int REDISMODULE_API_FUNC(RedisModule_DefragShouldStop)(RedisModuleDefragCtx *ctx);
+int REDISMODULE_API_FUNC(RedisModule_DefragCursorSet)(RedisModuleDefragCtx *ctx,
+													  unsigned long cursor);
+int REDISMODULE_API_FUNC(RedisModule_DefragCursorGet)(RedisModuleDefragCtx *ctx,
+													  unsigned long *cursor);
 int REDISMODULE_API_FUNC(RedisModule_GetApi)(const char *, void *);
 int REDISMODULE_API_FUNC(RedisModule_CreateCommand)(RedisModuleCtx *ctx, const char *name,
 													RedisModuleCmdFunc cmdfunc, const char *strflags, int firstkey, int lastkey, int keystep);
@@ -461,6 +481,11 @@ static int RedisModule_Init(RedisModuleCtx *ctx, const char *name, int ver, int
 	REDISMODULE_GET_API(Free);
 	REDISMODULE_GET_API(Realloc);
 	REDISMODULE_GET_API(Strdup);
+	REDISMODULE_GET_API(MallocSize);
+	REDISMODULE_GET_API(DefragAlloc);
+	REDISMODULE_GET_API(DefragShouldStop);
+	REDISMODULE_GET_API(DefragCursorSet);
+	REDISMODULE_GET_API(DefragCursorGet);
 	REDISMODULE_GET_API(CreateCommand);
 	REDISMODULE_GET_API(SetModuleAttribs);
 	REDISMODULE_GET_API(IsModuleNameBusy);
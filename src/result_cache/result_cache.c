@@ -0,0 +1,104 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "result_cache.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../execution_plan/ops/shared/record_spill.h"
+#include <string.h>
+#include <assert.h>
+
+extern long long result_cache_size;
+
+Cache *ResultCache_New(void) {
+	if(result_cache_size <= 0) return NULL;
+	Cache *cache = Cache_New(RESULT_CACHE_CAPACITY, CachedResult_Retain, CachedResult_Release);
+	Cache_SetMaxBytes(cache, result_cache_size);
+	return cache;
+}
+
+CachedResult *ResultCache_Get(Cache *cache, const char *key, size_t key_len, uint64_t version) {
+	CachedResult *result = Cache_GetValue(cache, key, key_len);
+	if(result == NULL) return NULL;
+	if(result->version == version) return result;
+
+	// The graph was modified since the result was produced.
+	CachedResult_Release(result);
+	Cache_RemoveValue(cache, key, key_len);
+	return NULL;
+}
+
+void ResultCache_Add(Cache *cache, const char *key, size_t key_len, CachedResult *result) {
+	if(result->overflow) return;
+	Cache_SetSizedValue(cache, key, key_len, result, result->size);
+}
+
+CachedResult *CachedResult_New(const char **columns, uint column_count, uint64_t version) {
+	CachedResult *result = rm_malloc(sizeof(CachedResult));
+	result->mapping = raxNew();
+	for(uint i = 0; i < column_count; i++) {
+		raxInsert(result->mapping, (unsigned char *)columns[i], strlen(columns[i]),
+				  (void *)(intptr_t)i, NULL);
+	}
+	result->records = array_new(Record, 16);
+	result->version = version;
+	result->size = sizeof(CachedResult);
+	// A single result may take up to a quarter of the cache.
+	result->max_size = result_cache_size / 4;
+	result->overflow = false;
+	result->ref_count = 1;
+	return result;
+}
+
+void CachedResult_AddRecord(CachedResult *result, const Record r, const uint *col_rec_map) {
+	if(result->overflow) return;
+
+	Record clone = Record_New(result->mapping);
+	uint column_count = raxSize(result->mapping);
+	for(uint i = 0; i < column_count; i++) {
+		uint idx = col_rec_map[i];
+		switch(Record_GetType(r, idx)) {
+		case REC_TYPE_NODE:
+			Record_AddNode(clone, i, *Record_GetNode(r, idx));
+			break;
+		case REC_TYPE_EDGE:
+			Record_AddEdge(clone, i, *Record_GetEdge(r, idx));
+			break;
+		case REC_TYPE_SCALAR:
+			Record_AddScalar(clone, i, SI_CloneValue(Record_GetScalar(r, idx)));
+			break;
+		default:
+			Record_AddScalar(clone, i, SI_NullVal());
+		}
+	}
+
+	result->records = array_append(result->records, clone);
+	result->size += RecordSpill_Footprint(clone) + sizeof(Record);
+	if(result->size > result->max_size) {
+		// The result is too large to be cached, stop collecting its records.
+		result->overflow = true;
+		uint count = array_len(result->records);
+		for(uint i = 0; i < count; i++) Record_Free(result->records[i]);
+		array_clear(result->records);
+	}
+}
+
+void *CachedResult_Retain(void *result) {
+	CachedResult *r = result;
+	__atomic_fetch_add(&r->ref_count, 1, __ATOMIC_RELAXED);
+	return r;
+}
+
+void CachedResult_Release(void *result) {
+	CachedResult *r = result;
+	if(__atomic_sub_fetch(&r->ref_count, 1, __ATOMIC_RELAXED) > 0) return;
+
+	uint count = array_len(r->records);
+	for(uint i = 0; i < count; i++) Record_Free(r->records[i]);
+	array_free(r->records);
+	raxFree(r->mapping);
+	rm_free(r);
+}
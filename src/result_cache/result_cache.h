@@ -0,0 +1,53 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rax.h"
+#include "../execution_plan/record.h"
+#include "../util/cache/cache.h"
+
+// Maximum number of results cached per graph.
+#define RESULT_CACHE_CAPACITY 1024
+
+/* Records replied by a read-only query, valid as long as the graph version
+ * they were produced at is current. Graph entities are held by reference,
+ * the graph's read lock must be held while replaying them. */
+typedef struct {
+	rax *mapping;       // Maps column names to record entries.
+	Record *records;    // Replied records, holding the replied columns only.
+	uint64_t version;   // Graph version the records were produced at.
+	size_t size;        // Approximate memory footprint in bytes.
+	size_t max_size;    // Footprint past which the result isn't cached.
+	bool overflow;      // The footprint exceeded max_size, records are no longer collected.
+	uint ref_count;     // Number of references to this result.
+} CachedResult;
+
+/* Create a new result cache, bounded by the RESULT_CACHE_SIZE configuration.
+ * Returns NULL if results aren't cached. */
+Cache *ResultCache_New(void);
+
+/* Retrieve the result cached under key, if it was produced at the given graph version.
+ * Results of earlier versions are dropped. The returned result must be released. */
+CachedResult *ResultCache_Get(Cache *cache, const char *key, size_t key_len, uint64_t version);
+
+// Cache result under key, unless its records overflowed.
+void ResultCache_Add(Cache *cache, const char *key, size_t key_len, CachedResult *result);
+
+// Create an empty result for the given columns, produced at graph version.
+CachedResult *CachedResult_New(const char **columns, uint column_count, uint64_t version);
+
+/* Collect the replied columns of record r, col_rec_map maps columns to record entries.
+ * Scalars are copied, graph entities are referenced. */
+void CachedResult_AddRecord(CachedResult *result, const Record r, const uint *col_rec_map);
+
+// Acquire an additional reference to a cached result.
+void *CachedResult_Retain(void *result);
+
+// Release a reference to a cached result, freeing it once no references remain.
+void CachedResult_Release(void *result);
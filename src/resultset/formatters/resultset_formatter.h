@@ -28,18 +28,34 @@ typedef enum {
 	VALUE_ARRAY = 6,
 	VALUE_EDGE = 7,
 	VALUE_NODE = 8,
-	VALUE_PATH = 9
+	VALUE_PATH = 9,
+	VALUE_POINT = 10,
+	VALUE_STRING_DEF = 11,  // String entered into the reply's dictionary, see "--compact-dict".
+	VALUE_STRING_REF = 12   // Dictionary index of a previously defined string.
 } ValueType;
 
 // Typedef for header formatters.
 typedef void (*EmitHeaderFunc)(RedisModuleCtx *ctx, const char **columns, const Record r, uint *col_rec_map);
 
-// Typedef for record formatters.
-typedef void (*EmitRecordFunc)(RedisModuleCtx *ctx, GraphContext *gc, const Record r, uint numcols, uint *col_rec_map);
+// Typedef for record formatters, state is the formatter's state, if any.
+typedef void (*EmitRecordFunc)(RedisModuleCtx *ctx, GraphContext *gc, const Record r, uint numcols, uint *col_rec_map, void *state);
+
+// Typedef for formatter state constructors, invoked once per result-set.
+typedef void *(*NewStateFunc)(uint numcols);
+
+// Typedef for formatters buffering records, emits buffered records
+// and returns the number of elements emitted since the previous flush.
+typedef uint64_t (*FlushFunc)(RedisModuleCtx *ctx, void *state);
+
+// Typedef for formatter state destructors.
+typedef void (*FreeStateFunc)(void *state);
 
 typedef struct {
 	EmitRecordFunc EmitRecord;
 	EmitHeaderFunc EmitHeader;
+	NewStateFunc NewState;      // Optional, formatters without state emit each record once added.
+	FlushFunc Flush;            // Optional, emits the records buffered in state.
+	FreeStateFunc FreeState;    // Optional, frees state.
 } ResultSetFormatter;
 
 /* Redis prints doubles with up to 17 digits of precision, which captures
@@ -47,12 +63,22 @@ typedef struct {
  * By using the %g format and a precision of 15 significant digits, we avoid many
  * awkward representations like RETURN 0.1 emitting "0.10000000000000001",
  * though we're still subject to many of the typical issues with floating-point error. */
+static inline int _ResultSet_FormatRoundedDouble(char str[32], double d) {
+	// 15 significant digits, sign, point and exponent fit within the buffer,
+	// the number is formatted in a single pass.
+	return snprintf(str, 32, "%.15g", d);
+}
+
 static inline void _ResultSet_ReplyWithRoundedDouble(RedisModuleCtx *ctx, double d) {
-	// Get length required to print number
-	int len = snprintf(NULL, 0, "%.15g", d);
-	char str[len + 1]; // TODO a reusable buffer would be far preferable
-	sprintf(str, "%.15g", d);
+	char str[32];
+	int len = _ResultSet_FormatRoundedDouble(str, d);
 	// Output string-formatted number
 	RedisModule_ReplyWithStringBuffer(ctx, str, len);
 }
 
+/* Retrieve the labels of node id in a single pass,
+ * labels must hold Graph_LabelTypeCount(g) entries, returns the node's label count. */
+static inline uint _ResultSet_GetNodeLabels(const Graph *g, NodeID id, int *labels) {
+	return Graph_GetNodeLabels(g, id, labels, Graph_LabelTypeCount(g));
+}
+
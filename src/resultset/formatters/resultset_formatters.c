@@ -18,6 +18,18 @@ ResultSetFormatter *ResultSetFormatter_GetFormatter(ResultSetFormatterType t) {
 	case FORMATTER_COMPACT:
 		formatter = &ResultSetFormatterCompact;
 		break;
+	case FORMATTER_BINARY:
+		formatter = &ResultSetFormatterBinary;
+		break;
+	case FORMATTER_COMPACT_IDS:
+		formatter = &ResultSetFormatterCompactIDs;
+		break;
+	case FORMATTER_COMPACT_DICT:
+		formatter = &ResultSetFormatterCompactDict;
+		break;
+	case FORMATTER_BINARY_LZ4:
+		formatter = &ResultSetFormatterBinaryLZ4;
+		break;
 	default:
 		assert(false && "Unknown formater");
 	}
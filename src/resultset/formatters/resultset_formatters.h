@@ -10,11 +10,16 @@
 #include "resultset_replynop.h"
 #include "resultset_replycompact.h"
 #include "resultset_replyverbose.h"
+#include "resultset_replybinary.h"
 
 typedef enum {
 	FORMATTER_NOP = 0,
 	FORMATTER_VERBOSE = 1,
 	FORMATTER_COMPACT = 2,
+	FORMATTER_BINARY = 3,
+	FORMATTER_COMPACT_IDS = 4,
+	FORMATTER_COMPACT_DICT = 5,
+	FORMATTER_BINARY_LZ4 = 6,
 } ResultSetFormatterType;
 
 /* Retrieves result-set formatter.
@@ -34,8 +39,45 @@ static ResultSetFormatter ResultSetFormatterCompact __attribute__((used)) = {
 	.EmitHeader = ResultSet_ReplyWithCompactHeader
 };
 
+/* Compact reply formatter replying with graph entities' IDs, without their properties. */
+static ResultSetFormatter ResultSetFormatterCompactIDs __attribute__((used)) = {
+	.EmitRecord = ResultSet_EmitCompactIDsRecord,
+	.EmitHeader = ResultSet_ReplyWithCompactHeader
+};
+
+/* Compact reply formatter deduplicating strings, a stateful formatter
+ * whose records are emitted once added. */
+static ResultSetFormatter ResultSetFormatterCompactDict __attribute__((used)) = {
+	.EmitRecord = ResultSet_EmitCompactDictRecord,
+	.EmitHeader = ResultSet_ReplyWithCompactHeader,
+	.NewState = ResultSet_NewCompactDictState,
+	.Flush = ResultSet_FlushCompactDict,
+	.FreeState = ResultSet_FreeCompactDictState
+};
+
 /* Verbose reply formatter, used when querying via CLI. */
 static ResultSetFormatter ResultSetFormatterVerbose __attribute__((used)) = {
 	.EmitRecord = ResultSet_EmitVerboseRecord,
-	.EmitHeader = ResultSet_ReplyWithVerboseHeader
+	.EmitHeader = ResultSet_ReplyWithVerboseHeader,
+	.NewState = ResultSet_NewVerboseState,
+	.FreeState = ResultSet_FreeVerboseState
+};
+
+/* Binary reply formatter, packs records into column batches,
+ * its header is the compact header. */
+static ResultSetFormatter ResultSetFormatterBinary __attribute__((used)) = {
+	.EmitRecord = ResultSet_EmitBinaryRecord,
+	.EmitHeader = ResultSet_ReplyWithCompactHeader,
+	.NewState = ResultSet_NewBinaryState,
+	.Flush = ResultSet_FlushBinary,
+	.FreeState = ResultSet_FreeBinaryState
+};
+
+/* Binary reply formatter compressing each batch, see "--compress". */
+static ResultSetFormatter ResultSetFormatterBinaryLZ4 __attribute__((used)) = {
+	.EmitRecord = ResultSet_EmitBinaryRecord,
+	.EmitHeader = ResultSet_ReplyWithCompactHeader,
+	.NewState = ResultSet_NewBinaryLZ4State,
+	.Flush = ResultSet_FlushBinary,
+	.FreeState = ResultSet_FreeBinaryState
 };
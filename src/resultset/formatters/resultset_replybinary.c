@@ -0,0 +1,289 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "resultset_formatters.h"
+#include "../../util/arr.h"
+#include "../../util/lz4.h"
+#include "../../util/rmalloc.h"
+#include "../../datatypes/array.h"
+#include "../../datatypes/path/sipath.h"
+
+/* Binary reply format, see docs/result_structure.md.
+ * Records are buffered column by column and emitted as batches,
+ * each batch is a single bulk string:
+ * [uint32 row count][uint32 column count]
+ * for every column: [uint8 value type X row count][uint32 payload length][payload]
+ * the payload holds the column's values in row order.
+ * Numbers are little-endian, values encode as follows:
+ * NULL     nothing
+ * STRING   uint32 length, bytes
+ * INTEGER  int64
+ * BOOLEAN  uint8
+ * DOUBLE   float64
+ * POINT    float64 latitude, float64 longitude
+ * ARRAY    uint32 length, [uint8 value type, value] X length
+ * NODE     int64 ID, uint32 label count, int32 label X count, properties
+ * EDGE     int64 ID, int32 relation type, int64 source ID, int64 destination ID, properties
+ * PATH     nodes ARRAY, edges ARRAY
+ * properties are encoded as uint32 count, [int32 attribute ID, uint8 value type, value] X count.
+ * Compressed batches are encoded as [uint32 batch length][LZ4 block of the batch]. */
+
+typedef struct {
+	uint numcols;           // Number of columns.
+	char **tags;            // Per column value types, one per buffered record.
+	char **payloads;        // Per column values.
+	uint rows;              // Number of buffered records.
+	size_t bytes;           // Size of buffered payloads.
+	uint64_t batches;       // Number of batches emitted since the last flush.
+	bool compress;          // Batches are LZ4 compressed.
+} BinaryState;
+
+static inline void _Put(char **buf, const void *src, size_t n) {
+	array_ensure_append(*buf, src, n, char);
+}
+
+static inline void _PutU8(char **buf, uint8_t v) {
+	_Put(buf, &v, 1);
+}
+
+static inline void _PutU32(char **buf, uint32_t v) {
+	uint8_t b[4];
+	for(int i = 0; i < 4; i++) b[i] = (v >> (8 * i)) & 0xFF;
+	_Put(buf, b, 4);
+}
+
+static inline void _PutU64(char **buf, uint64_t v) {
+	uint8_t b[8];
+	for(int i = 0; i < 8; i++) b[i] = (v >> (8 * i)) & 0xFF;
+	_Put(buf, b, 8);
+}
+
+static inline void _PutDouble(char **buf, double d) {
+	uint64_t v;
+	memcpy(&v, &d, sizeof(v));
+	_PutU64(buf, v);
+}
+
+static inline ValueType _BinaryValueType(const SIValue v) {
+	switch(SI_TYPE(v)) {
+	case T_NULL:
+		return VALUE_NULL;
+	case T_STRING:
+		return VALUE_STRING;
+	case T_INT64:
+		return VALUE_INTEGER;
+	case T_BOOL:
+		return VALUE_BOOLEAN;
+	case T_DOUBLE:
+		return VALUE_DOUBLE;
+	case T_ARRAY:
+		return VALUE_ARRAY;
+	case T_NODE:
+		return VALUE_NODE;
+	case T_EDGE:
+		return VALUE_EDGE;
+	case T_PATH:
+		return VALUE_PATH;
+	case T_POINT:
+		return VALUE_POINT;
+	default:
+		assert("Unhandled value type" && false);
+		return VALUE_UNKNOWN;
+	}
+}
+
+// Forward declarations.
+static void _EncodeValue(char **buf, GraphContext *gc, SIValue v);
+
+// Encode v preceded by its value type, as held by arrays and properties.
+static void _EncodeTaggedValue(char **buf, GraphContext *gc, SIValue v) {
+	_PutU8(buf, _BinaryValueType(v));
+	_EncodeValue(buf, gc, v);
+}
+
+static void _EncodeProperties(char **buf, GraphContext *gc, const GraphEntity *e) {
+	int prop_count = ENTITY_PROP_COUNT(e);
+	_PutU32(buf, prop_count);
+	for(int i = 0; i < prop_count; i++) {
+		EntityProperty prop = ENTITY_PROPS(e)[i];
+		_PutU32(buf, prop.id);
+		_EncodeTaggedValue(buf, gc, prop.value);
+	}
+}
+
+static void _EncodeNode(char **buf, GraphContext *gc, Node *n) {
+	EntityID id = ENTITY_GET_ID(n);
+	_PutU64(buf, id);
+
+	int labels[Graph_LabelTypeCount(gc->g) + 1];
+	uint label_count = _ResultSet_GetNodeLabels(gc->g, id, labels);
+	_PutU32(buf, label_count);
+	for(uint i = 0; i < label_count; i++) _PutU32(buf, labels[i]);
+
+	_EncodeProperties(buf, gc, (GraphEntity *)n);
+}
+
+static void _EncodeEdge(char **buf, GraphContext *gc, Edge *e) {
+	_PutU64(buf, ENTITY_GET_ID(e));
+	int reltype_id = Graph_GetEdgeRelation(gc->g, e);
+	assert(reltype_id != GRAPH_NO_RELATION);
+	_PutU32(buf, reltype_id);
+	_PutU64(buf, Edge_GetSrcNodeID(e));
+	_PutU64(buf, Edge_GetDestNodeID(e));
+	_EncodeProperties(buf, gc, (GraphEntity *)e);
+}
+
+static void _EncodeArray(char **buf, GraphContext *gc, SIValue array) {
+	uint len = SIArray_Length(array);
+	_PutU32(buf, len);
+	for(uint i = 0; i < len; i++) _EncodeTaggedValue(buf, gc, SIArray_Get(array, i));
+}
+
+static void _EncodeValue(char **buf, GraphContext *gc, SIValue v) {
+	switch(SI_TYPE(v)) {
+	case T_NULL:
+		return;
+	case T_STRING: {
+		uint32_t len = strlen(v.stringval);
+		_PutU32(buf, len);
+		_Put(buf, v.stringval, len);
+		return;
+	}
+	case T_INT64:
+		_PutU64(buf, v.longval);
+		return;
+	case T_BOOL:
+		_PutU8(buf, v.longval != 0);
+		return;
+	case T_DOUBLE:
+		_PutDouble(buf, v.doubleval);
+		return;
+	case T_POINT:
+		_PutDouble(buf, v.point.latitude);
+		_PutDouble(buf, v.point.longitude);
+		return;
+	case T_ARRAY:
+		_EncodeArray(buf, gc, v);
+		return;
+	case T_NODE:
+		_EncodeNode(buf, gc, v.ptrval);
+		return;
+	case T_EDGE:
+		_EncodeEdge(buf, gc, v.ptrval);
+		return;
+	case T_PATH: {
+		SIValue nodes = SIPath_Nodes(v);
+		_EncodeArray(buf, gc, nodes);
+		SIValue_Free(nodes);
+		SIValue relationships = SIPath_Relationships(v);
+		_EncodeArray(buf, gc, relationships);
+		SIValue_Free(relationships);
+		return;
+	}
+	default:
+		assert("Unhandled value type" && false);
+	}
+}
+
+// Emit the buffered records as a single batch.
+static void _EmitBatch(RedisModuleCtx *ctx, BinaryState *state) {
+	char *batch = array_new(char, 8 + state->bytes + (state->rows + 4) * state->numcols);
+	_PutU32(&batch, state->rows);
+	_PutU32(&batch, state->numcols);
+	for(uint i = 0; i < state->numcols; i++) {
+		uint32_t len = array_len(state->payloads[i]);
+		_Put(&batch, state->tags[i], state->rows);
+		_PutU32(&batch, len);
+		_Put(&batch, state->payloads[i], len);
+		array_clear(state->tags[i]);
+		array_clear(state->payloads[i]);
+	}
+	uint32_t batch_len = array_len(batch);
+	if(state->compress) {
+		// Prefixed by the batch length, for clients to size the decompressed batch.
+		char *compressed = rm_malloc(4 + LZ4_COMPRESS_BOUND(batch_len));
+		for(int i = 0; i < 4; i++) compressed[i] = (batch_len >> (8 * i)) & 0xFF;
+		size_t compressed_len = 4 + LZ4_Compress(batch, batch_len, compressed + 4);
+		RedisModule_ReplyWithStringBuffer(ctx, compressed, compressed_len);
+		rm_free(compressed);
+	} else {
+		RedisModule_ReplyWithStringBuffer(ctx, batch, batch_len);
+	}
+	array_free(batch);
+
+	state->rows = 0;
+	state->bytes = 0;
+	state->batches++;
+}
+
+void ResultSet_EmitBinaryRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r,
+								uint numcols, uint *col_rec_map, void *state) {
+	BinaryState *s = state;
+	for(uint i = 0; i < numcols; i++) {
+		uint idx = col_rec_map[i];
+		size_t len = array_len(s->payloads[i]);
+		switch(Record_GetType(r, idx)) {
+		case REC_TYPE_NODE:
+			_PutU8(&s->tags[i], VALUE_NODE);
+			_EncodeNode(&s->payloads[i], gc, Record_GetNode(r, idx));
+			break;
+		case REC_TYPE_EDGE:
+			_PutU8(&s->tags[i], VALUE_EDGE);
+			_EncodeEdge(&s->payloads[i], gc, Record_GetEdge(r, idx));
+			break;
+		default: {
+			SIValue v = Record_GetScalar(r, idx);
+			_PutU8(&s->tags[i], _BinaryValueType(v));
+			_EncodeValue(&s->payloads[i], gc, v);
+		}
+		}
+		s->bytes += array_len(s->payloads[i]) - len;
+	}
+
+	s->rows++;
+	if(s->rows == BINARY_BATCH_ROWS || s->bytes >= BINARY_BATCH_BYTES) _EmitBatch(ctx, s);
+}
+
+void *ResultSet_NewBinaryState(uint numcols) {
+	BinaryState *state = rm_malloc(sizeof(BinaryState));
+	state->numcols = numcols;
+	state->rows = 0;
+	state->bytes = 0;
+	state->batches = 0;
+	state->compress = false;
+	state->tags = rm_malloc(sizeof(char *) * numcols);
+	state->payloads = rm_malloc(sizeof(char *) * numcols);
+	for(uint i = 0; i < numcols; i++) {
+		state->tags[i] = array_new(char, BINARY_BATCH_ROWS);
+		state->payloads[i] = array_new(char, 1024);
+	}
+	return state;
+}
+
+void *ResultSet_NewBinaryLZ4State(uint numcols) {
+	BinaryState *state = ResultSet_NewBinaryState(numcols);
+	state->compress = true;
+	return state;
+}
+
+uint64_t ResultSet_FlushBinary(RedisModuleCtx *ctx, void *state) {
+	BinaryState *s = state;
+	if(s->rows > 0) _EmitBatch(ctx, s);
+	uint64_t batches = s->batches;
+	s->batches = 0;
+	return batches;
+}
+
+void ResultSet_FreeBinaryState(void *state) {
+	BinaryState *s = state;
+	for(uint i = 0; i < s->numcols; i++) {
+		array_free(s->tags[i]);
+		array_free(s->payloads[i]);
+	}
+	rm_free(s->tags);
+	rm_free(s->payloads);
+	rm_free(s);
+}
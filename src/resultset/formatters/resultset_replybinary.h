@@ -0,0 +1,21 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+// Maximum number of records packed into a single batch.
+#define BINARY_BATCH_ROWS 1024
+// Payload size in bytes past which a batch is emitted.
+#define BINARY_BATCH_BYTES (1024 * 1024)
+
+// Formatter for binary columnar replies, records are packed into column batches.
+void ResultSet_EmitBinaryRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r,
+								uint numcols, uint *col_rec_map, void *state);
+void *ResultSet_NewBinaryState(uint numcols);
+// State of binary replies whose batches are LZ4 compressed.
+void *ResultSet_NewBinaryLZ4State(uint numcols);
+uint64_t ResultSet_FlushBinary(RedisModuleCtx *ctx, void *state);
+void ResultSet_FreeBinaryState(void *state);
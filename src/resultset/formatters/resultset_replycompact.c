@@ -6,15 +6,26 @@
 
 #include "resultset_formatters.h"
 #include "../../util/arr.h"
+#include "../../util/rmalloc.h"
+#include "../../../deps/rax/rax.h"
 #include "../../datatypes/array.h"
 #include "../../datatypes/path/sipath.h"
 
+// Compact reply options, shared by the compact formatters.
+typedef struct {
+	bool props;     // Emit the properties of graph entities, otherwise entities are emitted by ID.
+	rax *strings;   // Dictionary mapping emitted strings to their index, NULL if strings are emitted in full.
+} CompactOpts;
+
 // Forward declarations.
-static void _ResultSet_CompactReplyWithNode(RedisModuleCtx *ctx, GraphContext *gc, Node *n);
-static void _ResultSet_CompactReplyWithEdge(RedisModuleCtx *ctx, GraphContext *gc, Edge *e);
+static void _ResultSet_CompactReplyWithNode(RedisModuleCtx *ctx, GraphContext *gc, Node *n,
+											CompactOpts *opts);
+static void _ResultSet_CompactReplyWithEdge(RedisModuleCtx *ctx, GraphContext *gc, Edge *e,
+											CompactOpts *opts);
 static void _ResultSet_CompactReplyWithSIArray(RedisModuleCtx *ctx, GraphContext *gc,
-											   SIValue array);
-static void _ResultSet_CompactReplyWithPath(RedisModuleCtx *ctx, GraphContext *gc, SIValue path);
+											   SIValue array, CompactOpts *opts);
+static void _ResultSet_CompactReplyWithPath(RedisModuleCtx *ctx, GraphContext *gc, SIValue path,
+											CompactOpts *opts);
 
 static inline ValueType _mapValueType(const SIValue v) {
 	switch(SI_TYPE(v)) {
@@ -36,6 +47,8 @@ static inline ValueType _mapValueType(const SIValue v) {
 		return VALUE_EDGE;
 	case T_PATH:
 		return VALUE_PATH;
+	case T_POINT:
+		return VALUE_POINT;
 	default:
 		return VALUE_UNKNOWN;
 	}
@@ -45,8 +58,35 @@ static inline void _ResultSet_ReplyWithValueType(RedisModuleCtx *ctx, const SIVa
 	RedisModule_ReplyWithLongLong(ctx, _mapValueType(v));
 }
 
+/* Emit v in compact form, see CompactOpts. */
+/* Emit str as a reference to its dictionary entry, adding str to the dictionary
+ * on its first occurrence. Returns false if str is emitted in full. */
+static bool _ResultSet_CompactReplyWithStringRef(RedisModuleCtx *ctx, CompactOpts *opts,
+												 const char *str) {
+	size_t len = strlen(str);
+	if(len < COMPACT_DICT_MIN_LEN) return false;
+
+	void *idx = raxFind(opts->strings, (unsigned char *)str, len);
+	if(idx != raxNotFound) {
+		RedisModule_ReplyWithLongLong(ctx, VALUE_STRING_REF);
+		RedisModule_ReplyWithLongLong(ctx, (uintptr_t)idx);
+		return true;
+	}
+	// Once the dictionary is full, strings are emitted in full.
+	uint64_t size = raxSize(opts->strings);
+	if(size >= COMPACT_DICT_MAX_ENTRIES) return false;
+
+	raxInsert(opts->strings, (unsigned char *)str, len, (void *)(uintptr_t)size, NULL);
+	RedisModule_ReplyWithLongLong(ctx, VALUE_STRING_DEF);
+	RedisModule_ReplyWithStringBuffer(ctx, str, len);
+	return true;
+}
+
 static void _ResultSet_CompactReplyWithSIValue(RedisModuleCtx *ctx, GraphContext *gc,
-											   const SIValue v) {
+											   const SIValue v, CompactOpts *opts) {
+	if(SI_TYPE(v) == T_STRING && opts->strings &&
+	   _ResultSet_CompactReplyWithStringRef(ctx, opts, v.stringval)) return;
+
 	// Emit the value type, then the actual value (to facilitate client-side parsing)
 	_ResultSet_ReplyWithValueType(ctx, v);
 
@@ -65,73 +105,90 @@ static void _ResultSet_CompactReplyWithSIValue(RedisModuleCtx *ctx, GraphContext
 		else RedisModule_ReplyWithStringBuffer(ctx, "false", 5);
 		return;
 	case T_ARRAY:
-		_ResultSet_CompactReplyWithSIArray(ctx, gc, v);
+		_ResultSet_CompactReplyWithSIArray(ctx, gc, v, opts);
 		break;
 	case T_NULL:
 		RedisModule_ReplyWithNull(ctx);
 		return;
 	case T_NODE:
-		_ResultSet_CompactReplyWithNode(ctx, gc, v.ptrval);
+		_ResultSet_CompactReplyWithNode(ctx, gc, v.ptrval, opts);
 		return;
 	case T_EDGE:
-		_ResultSet_CompactReplyWithEdge(ctx, gc, v.ptrval);
+		_ResultSet_CompactReplyWithEdge(ctx, gc, v.ptrval, opts);
 		return;
 	case T_PATH:
-		_ResultSet_CompactReplyWithPath(ctx, gc, v);
+		_ResultSet_CompactReplyWithPath(ctx, gc, v, opts);
+		return;
+	case T_POINT:
+		// Points are emitted as [latitude, longitude].
+		RedisModule_ReplyWithArray(ctx, 2);
+		_ResultSet_ReplyWithRoundedDouble(ctx, v.point.latitude);
+		_ResultSet_ReplyWithRoundedDouble(ctx, v.point.longitude);
 		return;
 	default:
 		assert("Unhandled value type" && false);
 	}
 }
 
+static inline bool _ResultSet_AttributeRequested(Attribute_ID id, const Attribute_ID *attrs,
+												 uint attr_count) {
+	for(uint i = 0; i < attr_count; i++) if(attrs[i] == id) return true;
+	return false;
+}
+
+/* Emit the properties of e, restricted to the attr_count attributes of attrs
+ * unless attrs is NULL. */
 static void _ResultSet_CompactReplyWithProperties(RedisModuleCtx *ctx, GraphContext *gc,
-												  const GraphEntity *e) {
+												  const GraphEntity *e, const Attribute_ID *attrs,
+												  uint attr_count, CompactOpts *opts) {
 	int prop_count = ENTITY_PROP_COUNT(e);
-	RedisModule_ReplyWithArray(ctx, prop_count);
+	int emitted = 0;
+	RedisModule_ReplyWithArray(ctx, (attrs) ? REDISMODULE_POSTPONED_ARRAY_LEN : prop_count);
 	// Iterate over all properties stored on entity
 	for(int i = 0; i < prop_count; i ++) {
+		if(attrs && !_ResultSet_AttributeRequested(ENTITY_PROPS(e)[i].id, attrs, attr_count)) continue;
+		emitted++;
 		// Compact replies include the value's type; verbose replies do not
 		RedisModule_ReplyWithArray(ctx, 3);
 		EntityProperty prop = ENTITY_PROPS(e)[i];
 		// Emit the string index
 		RedisModule_ReplyWithLongLong(ctx, prop.id);
 		// Emit the value
-		_ResultSet_CompactReplyWithSIValue(ctx, gc, prop.value);
+		_ResultSet_CompactReplyWithSIValue(ctx, gc, prop.value, opts);
 	}
+	if(attrs) RedisModule_ReplySetArrayLength(ctx, emitted);
 }
 
-static void _ResultSet_CompactReplyWithNode(RedisModuleCtx *ctx, GraphContext *gc, Node *n) {
+static void _ResultSet_CompactReplyWithNode(RedisModuleCtx *ctx, GraphContext *gc, Node *n,
+											CompactOpts *opts) {
 	/*  Compact node reply format:
 	 *  [
 	 *      Node ID (integer),
 	        [label string index (integer)],
 	 *      [[name, value, value type] X N]
 	 *  ]
+	 *  Properties are omitted unless opts->props is set.
 	 */
 	// 3 top-level entities in node reply
-	RedisModule_ReplyWithArray(ctx, 3);
+	RedisModule_ReplyWithArray(ctx, (opts->props) ? 3 : 2);
 
 	// id (integer)
 	EntityID id = ENTITY_GET_ID(n);
 	RedisModule_ReplyWithLongLong(ctx, id);
 
-	// [label string index]
-	// Print label in nested array for multi-label support
-	// Retrieve label
-	int label_id = Graph_GetNodeLabel(gc->g, id);
-	if(label_id == GRAPH_NO_LABEL) {
-		// Emit an empty array for unlabeled nodes
-		RedisModule_ReplyWithArray(ctx, 0);
-	} else {
-		RedisModule_ReplyWithArray(ctx, 1);
-		RedisModule_ReplyWithLongLong(ctx, label_id);
-	}
+	// [label string index X M]
+	// Unlabeled nodes emit an empty array.
+	int labels[Graph_LabelTypeCount(gc->g) + 1];
+	uint label_count = _ResultSet_GetNodeLabels(gc->g, id, labels);
+	RedisModule_ReplyWithArray(ctx, label_count);
+	for(uint i = 0; i < label_count; i++) RedisModule_ReplyWithLongLong(ctx, labels[i]);
 
 	// [properties]
-	_ResultSet_CompactReplyWithProperties(ctx, gc, (GraphEntity *)n);
+	if(opts->props) _ResultSet_CompactReplyWithProperties(ctx, gc, (GraphEntity *)n, NULL, 0, opts);
 }
 
-static void _ResultSet_CompactReplyWithEdge(RedisModuleCtx *ctx, GraphContext *gc, Edge *e) {
+static void _ResultSet_CompactReplyWithEdge(RedisModuleCtx *ctx, GraphContext *gc, Edge *e,
+											CompactOpts *opts) {
 	/*  Compact edge reply format:
 	 *  [
 	 *      Edge ID (integer),
@@ -140,9 +197,10 @@ static void _ResultSet_CompactReplyWithEdge(RedisModuleCtx *ctx, GraphContext *g
 	        dest node ID (integer),
 	 *      [[name, value, value type] X N]
 	 *  ]
+	 *  Properties are omitted unless opts->props is set.
 	 */
 	// 5 top-level entities in edge reply
-	RedisModule_ReplyWithArray(ctx, 5);
+	RedisModule_ReplyWithArray(ctx, (opts->props) ? 5 : 4);
 
 	// id (integer)
 	EntityID id = ENTITY_GET_ID(e);
@@ -160,11 +218,11 @@ static void _ResultSet_CompactReplyWithEdge(RedisModuleCtx *ctx, GraphContext *g
 	RedisModule_ReplyWithLongLong(ctx, Edge_GetDestNodeID(e));
 
 	// [properties]
-	_ResultSet_CompactReplyWithProperties(ctx, gc, (GraphEntity *)e);
+	if(opts->props) _ResultSet_CompactReplyWithProperties(ctx, gc, (GraphEntity *)e, NULL, 0, opts);
 }
 
 static void _ResultSet_CompactReplyWithSIArray(RedisModuleCtx *ctx, GraphContext *gc,
-											   SIValue array) {
+											   SIValue array, CompactOpts *opts) {
 
 	/*  Compact array reply format:
 	 *  [
@@ -180,11 +238,12 @@ static void _ResultSet_CompactReplyWithSIArray(RedisModuleCtx *ctx, GraphContext
 	RedisModule_ReplyWithArray(ctx, arrayLen);
 	for(uint i = 0; i < arrayLen; i++) {
 		RedisModule_ReplyWithArray(ctx, 2); // Reply with array with space for type and value
-		_ResultSet_CompactReplyWithSIValue(ctx, gc, SIArray_Get(array, i));
+		_ResultSet_CompactReplyWithSIValue(ctx, gc, SIArray_Get(array, i), opts);
 	}
 }
 
-static void _ResultSet_CompactReplyWithPath(RedisModuleCtx *ctx, GraphContext *gc, SIValue path) {
+static void _ResultSet_CompactReplyWithPath(RedisModuleCtx *ctx, GraphContext *gc, SIValue path,
+											CompactOpts *opts) {
 	/* Path will return as an array of two SIArrays, the first is path nodes and the second is edges,
 	* see array compact format.
 	* Compact path reply:
@@ -213,17 +272,17 @@ static void _ResultSet_CompactReplyWithPath(RedisModuleCtx *ctx, GraphContext *g
 	// First array type and value.
 	RedisModule_ReplyWithArray(ctx, 2);
 	SIValue nodes = SIPath_Nodes(path);
-	_ResultSet_CompactReplyWithSIValue(ctx, gc, nodes);
+	_ResultSet_CompactReplyWithSIValue(ctx, gc, nodes, opts);
 	SIValue_Free(nodes);
 	// Second array type and value.
 	RedisModule_ReplyWithArray(ctx, 2);
 	SIValue relationships = SIPath_Relationships(path);
-	_ResultSet_CompactReplyWithSIValue(ctx, gc, relationships);
+	_ResultSet_CompactReplyWithSIValue(ctx, gc, relationships, opts);
 	SIValue_Free(relationships);
 }
 
-void ResultSet_EmitCompactRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r,
-								 uint numcols, uint *col_rec_map) {
+static void _ResultSet_EmitCompactRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r,
+										 uint numcols, uint *col_rec_map, CompactOpts *opts) {
 	// Prepare return array sized to the number of RETURN entities
 	RedisModule_ReplyWithArray(ctx, numcols);
 
@@ -231,18 +290,74 @@ void ResultSet_EmitCompactRecord(RedisModuleCtx *ctx, GraphContext *gc, const Re
 		uint idx = col_rec_map[i];
 		switch(Record_GetType(r, idx)) {
 		case REC_TYPE_NODE:
-			_ResultSet_CompactReplyWithNode(ctx, gc, Record_GetNode(r, idx));
+			_ResultSet_CompactReplyWithNode(ctx, gc, Record_GetNode(r, idx), opts);
 			break;
 		case REC_TYPE_EDGE:
-			_ResultSet_CompactReplyWithEdge(ctx, gc, Record_GetEdge(r, idx));
+			_ResultSet_CompactReplyWithEdge(ctx, gc, Record_GetEdge(r, idx), opts);
 			break;
 		default:
 			RedisModule_ReplyWithArray(ctx, 2); // Reply with array with space for type and value
-			_ResultSet_CompactReplyWithSIValue(ctx, gc, Record_GetScalar(r, idx));
+			_ResultSet_CompactReplyWithSIValue(ctx, gc, Record_GetScalar(r, idx), opts);
 		}
 	}
 }
 
+void ResultSet_EmitCompactRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r,
+								 uint numcols, uint *col_rec_map, void *state) {
+	CompactOpts opts = {.props = true, .strings = NULL};
+	_ResultSet_EmitCompactRecord(ctx, gc, r, numcols, col_rec_map, &opts);
+}
+
+void ResultSet_EmitCompactIDsRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r,
+									uint numcols, uint *col_rec_map, void *state) {
+	CompactOpts opts = {.props = false, .strings = NULL};
+	_ResultSet_EmitCompactRecord(ctx, gc, r, numcols, col_rec_map, &opts);
+}
+
+// State of the dictionary formatter, the dictionary spans a single response.
+typedef struct {
+	rax *strings;       // Strings emitted since the last flush, mapped to their index.
+	uint64_t records;   // Number of records emitted since the last flush.
+} CompactDictState;
+
+void ResultSet_EmitCompactDictRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r,
+									 uint numcols, uint *col_rec_map, void *state) {
+	CompactDictState *s = state;
+	CompactOpts opts = {.props = true, .strings = s->strings};
+	_ResultSet_EmitCompactRecord(ctx, gc, r, numcols, col_rec_map, &opts);
+	s->records++;
+}
+
+void *ResultSet_NewCompactDictState(uint numcols) {
+	CompactDictState *state = rm_malloc(sizeof(CompactDictState));
+	state->strings = raxNew();
+	state->records = 0;
+	return state;
+}
+
+uint64_t ResultSet_FlushCompactDict(RedisModuleCtx *ctx, void *state) {
+	CompactDictState *s = state;
+	uint64_t records = s->records;
+	// Every response defines its own dictionary, cursor reads included.
+	raxFree(s->strings);
+	s->strings = raxNew();
+	s->records = 0;
+	return records;
+}
+
+void ResultSet_FreeCompactDictState(void *state) {
+	CompactDictState *s = state;
+	raxFree(s->strings);
+	rm_free(s);
+}
+
+void ResultSet_ReplyWithCompactProperties(RedisModuleCtx *ctx, GraphContext *gc,
+										  const GraphEntity *e, const Attribute_ID *attrs,
+										  uint attr_count) {
+	CompactOpts opts = {.props = true, .strings = NULL};
+	_ResultSet_CompactReplyWithProperties(ctx, gc, e, attrs, attr_count, &opts);
+}
+
 // For every column in the header, emit a 2-array that specifies
 // the column alias followed by an enum denoting what type
 // (scalar, node, or relation) it holds.
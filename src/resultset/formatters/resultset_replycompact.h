@@ -6,8 +6,29 @@
 
 #pragma once
 
+// Minimal length of strings entered into the dictionary of "--compact-dict" replies.
+#define COMPACT_DICT_MIN_LEN 4
+// Maximal number of dictionary entries per reply, further strings are emitted in full.
+#define COMPACT_DICT_MAX_ENTRIES 65536
+
 // Formatter for compact (client-parsed) replies
 void ResultSet_EmitCompactRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r,
-								 uint numcols, uint *col_rec_map);
+								 uint numcols, uint *col_rec_map, void *state);
+/* Compact formatter omitting the properties of nodes and edges,
+ * which are fetched on demand through GRAPH.FETCH. */
+void ResultSet_EmitCompactIDsRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r,
+									uint numcols, uint *col_rec_map, void *state);
+/* Compact formatter referencing repeated strings through a per-reply dictionary,
+ * a string's first occurrence defines its entry. */
+void ResultSet_EmitCompactDictRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r,
+									 uint numcols, uint *col_rec_map, void *state);
+void *ResultSet_NewCompactDictState(uint numcols);
+uint64_t ResultSet_FlushCompactDict(RedisModuleCtx *ctx, void *state);
+void ResultSet_FreeCompactDictState(void *state);
 void ResultSet_ReplyWithCompactHeader(RedisModuleCtx *ctx, const char **columns, const Record r, uint *col_rec_map);
 
+/* Emit the compact properties of e, [[attribute ID, value type, value] X N],
+ * restricted to the attr_count attributes of attrs unless attrs is NULL. */
+void ResultSet_ReplyWithCompactProperties(RedisModuleCtx *ctx, GraphContext *gc,
+										  const GraphEntity *e, const Attribute_ID *attrs,
+										  uint attr_count);
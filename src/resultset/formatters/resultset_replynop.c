@@ -12,6 +12,6 @@ void ResultSet_EmitNOPHeader(RedisModuleCtx *ctx, const char **columns,
 
 }
 void ResultSet_EmitNOPRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r, uint numcols,
-							 uint *col_rec_map) {
+							 uint *col_rec_map, void *state) {
 
 }
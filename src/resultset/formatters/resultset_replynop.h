@@ -8,4 +8,4 @@
 
 // Formatter for compact (client-parsed) replies
 void ResultSet_EmitNOPHeader(RedisModuleCtx *ctx, const char **columns, const Record r, uint *col_rec_map);
-void ResultSet_EmitNOPRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r, uint numcols, uint *col_rec_map);
+void ResultSet_EmitNOPRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r, uint numcols, uint *col_rec_map, void *state);
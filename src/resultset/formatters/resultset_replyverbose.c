@@ -6,71 +6,155 @@
 
 #include "resultset_formatters.h"
 #include "../../util/arr.h"
+#include "../../util/rmalloc.h"
 #include "../../datatypes/path/sipath.h"
 
-// Forward declarations.
-static void _ResultSet_VerboseReplyWithNode(RedisModuleCtx *ctx, GraphContext *gc, Node *n);
-static void _ResultSet_VerboseReplyWithEdge(RedisModuleCtx *ctx, GraphContext *gc, Edge *e);
-static void _ResultSet_VerboseReplyWithArray(RedisModuleCtx *ctx, SIValue array);
-static void _ResultSet_VerboseReplyWithPath(RedisModuleCtx *ctx, SIValue path);
+#define VERBOSE_FRAGMENT_SLOTS 256 // Number of entity fragments retained per reply, a power of 2.
 
-/* This function has handling for all SIValue scalar types.
- * The current RESP protocol only has unique support for strings, 8-byte integers,
- * and NULL values. */
-static void _ResultSet_VerboseReplyWithSIValue(RedisModuleCtx *ctx, GraphContext *gc,
-											   const SIValue v) {
-	// Emit the actual value, then the value type (to facilitate client-side parsing)
+/* Elements of a preformatted reply fragment, each a tag followed by its payload:
+ * ARRAY   uint32 length
+ * STRING  uint32 length, bytes
+ * LONG    int64
+ * NULL    nothing */
+typedef enum {
+	FRAGMENT_ARRAY,
+	FRAGMENT_STRING,
+	FRAGMENT_LONG,
+	FRAGMENT_NULL,
+} FragmentElement;
+
+// Preformatted reply of a node or an edge.
+typedef struct {
+	EntityID id;                // Entity replied by the fragment.
+	uint64_t modifications;     // Entity modifications count the fragment was formatted at.
+	char *buf;                  // Encoded reply elements, NULL if unused.
+} VerboseFragment;
+
+/* Entities returned repeatedly within a reply, e.g. the start node of each matched path,
+ * are formatted once and replayed from their fragment. A fragment is stale once any
+ * entity is modified, as a write query might update an entity between records. */
+typedef struct {
+	VerboseFragment nodes[VERBOSE_FRAGMENT_SLOTS];  // Node fragments, slotted by node ID.
+	VerboseFragment edges[VERBOSE_FRAGMENT_SLOTS];  // Edge fragments, slotted by edge ID.
+} VerboseState;
+
+static inline void _Fragment_Put(char **buf, const void *src, size_t n) {
+	array_ensure_append(*buf, src, n, char);
+}
+
+static inline void _Fragment_Array(char **buf, uint32_t len) {
+	char tag = FRAGMENT_ARRAY;
+	_Fragment_Put(buf, &tag, 1);
+	_Fragment_Put(buf, &len, sizeof(len));
+}
+
+static inline void _Fragment_String(char **buf, const char *str, uint32_t len) {
+	char tag = FRAGMENT_STRING;
+	_Fragment_Put(buf, &tag, 1);
+	_Fragment_Put(buf, &len, sizeof(len));
+	_Fragment_Put(buf, str, len);
+}
+
+static inline void _Fragment_Long(char **buf, int64_t v) {
+	char tag = FRAGMENT_LONG;
+	_Fragment_Put(buf, &tag, 1);
+	_Fragment_Put(buf, &v, sizeof(v));
+}
+
+static inline void _Fragment_Null(char **buf) {
+	char tag = FRAGMENT_NULL;
+	_Fragment_Put(buf, &tag, 1);
+}
+
+// Reply with the elements of a fragment.
+static void _Fragment_Reply(RedisModuleCtx *ctx, const char *buf) {
+	const char *p = buf;
+	const char *end = buf + array_len(buf);
+	while(p < end) {
+		uint32_t len;
+		int64_t v;
+		switch(*p++) {
+		case FRAGMENT_ARRAY:
+			memcpy(&len, p, sizeof(len));
+			p += sizeof(len);
+			RedisModule_ReplyWithArray(ctx, len);
+			break;
+		case FRAGMENT_STRING:
+			memcpy(&len, p, sizeof(len));
+			p += sizeof(len);
+			RedisModule_ReplyWithStringBuffer(ctx, p, len);
+			p += len;
+			break;
+		case FRAGMENT_LONG:
+			memcpy(&v, p, sizeof(v));
+			p += sizeof(v);
+			RedisModule_ReplyWithLongLong(ctx, v);
+			break;
+		case FRAGMENT_NULL:
+			RedisModule_ReplyWithNull(ctx);
+			break;
+		default:
+			assert("Unknown fragment element" && false);
+		}
+	}
+}
+
+// Format value in its string representation, as arrays are.
+static void _Fragment_ValueString(char **buf, SIValue v) {
+	size_t bufferLen = 512;
+	char *str = rm_calloc(bufferLen, sizeof(char));
+	size_t bytesWrriten = 0;
+	SIValue_ToString(v, &str, &bufferLen, &bytesWrriten);
+	_Fragment_String(buf, str, bytesWrriten);
+	rm_free(str);
+}
+
+/* Formats a property value, the current RESP protocol only has unique support
+ * for strings, 8-byte integers, and NULL values. */
+static void _Fragment_Value(char **buf, const SIValue v) {
+	char str[32];
 	switch(SI_TYPE(v)) {
 	case T_STRING:
-		RedisModule_ReplyWithStringBuffer(ctx, v.stringval, strlen(v.stringval));
+		_Fragment_String(buf, v.stringval, strlen(v.stringval));
 		return;
 	case T_INT64:
-		RedisModule_ReplyWithLongLong(ctx, v.longval);
+		_Fragment_Long(buf, v.longval);
 		return;
 	case T_DOUBLE:
-		_ResultSet_ReplyWithRoundedDouble(ctx, v.doubleval);
+		_Fragment_String(buf, str, _ResultSet_FormatRoundedDouble(str, v.doubleval));
 		return;
 	case T_BOOL:
-		if(v.longval != 0) RedisModule_ReplyWithStringBuffer(ctx, "true", 4);
-		else RedisModule_ReplyWithStringBuffer(ctx, "false", 5);
+		if(v.longval != 0) _Fragment_String(buf, "true", 4);
+		else _Fragment_String(buf, "false", 5);
 		return;
 	case T_NULL:
-		RedisModule_ReplyWithNull(ctx);
-		return;
-	case T_NODE:
-		_ResultSet_VerboseReplyWithNode(ctx, gc, v.ptrval);
-		return;
-	case T_EDGE:
-		_ResultSet_VerboseReplyWithEdge(ctx, gc, v.ptrval);
+		_Fragment_Null(buf);
 		return;
 	case T_ARRAY:
-		_ResultSet_VerboseReplyWithArray(ctx, v);
-		return;
-	case T_PATH:
-		_ResultSet_VerboseReplyWithPath(ctx, v);
+	case T_POINT:
+		_Fragment_ValueString(buf, v);
 		return;
 	default:
-		assert("Unhandled value type" && false);
+		assert("Unhandled property type" && false);
 	}
 }
 
-static void _ResultSet_VerboseReplyWithProperties(RedisModuleCtx *ctx, GraphContext *gc,
-												  const GraphEntity *e) {
+static void _Fragment_Properties(char **buf, GraphContext *gc, const GraphEntity *e) {
 	int prop_count = ENTITY_PROP_COUNT(e);
-	RedisModule_ReplyWithArray(ctx, prop_count);
+	_Fragment_Array(buf, prop_count);
 	// Iterate over all properties stored on entity
 	for(int i = 0; i < prop_count; i ++) {
-		RedisModule_ReplyWithArray(ctx, 2);
+		_Fragment_Array(buf, 2);
 		EntityProperty prop = ENTITY_PROPS(e)[i];
 		// Emit the actual string
 		const char *prop_str = GraphContext_GetAttributeString(gc, prop.id);
-		RedisModule_ReplyWithStringBuffer(ctx, prop_str, strlen(prop_str));
+		_Fragment_String(buf, prop_str, strlen(prop_str));
 		// Emit the value
-		_ResultSet_VerboseReplyWithSIValue(ctx, gc, prop.value);
+		_Fragment_Value(buf, prop.value);
 	}
 }
 
-static void _ResultSet_VerboseReplyWithNode(RedisModuleCtx *ctx, GraphContext *gc, Node *n) {
+static void _Fragment_Node(char **buf, GraphContext *gc, Node *n) {
 	/*  Verbose node reply format:
 	 *  [
 	 *      ["id", Node ID (integer)]
@@ -79,36 +163,33 @@ static void _ResultSet_VerboseReplyWithNode(RedisModuleCtx *ctx, GraphContext *g
 	 *  ]
 	 */
 	// 3 top-level entities in node reply
-	RedisModule_ReplyWithArray(ctx, 3);
+	_Fragment_Array(buf, 3);
 
 	// ["id", id (integer)]
 	EntityID id = ENTITY_GET_ID(n);
-	RedisModule_ReplyWithArray(ctx, 2);
-	RedisModule_ReplyWithStringBuffer(ctx, "id", 2);
-	RedisModule_ReplyWithLongLong(ctx, id);
+	_Fragment_Array(buf, 2);
+	_Fragment_String(buf, "id", 2);
+	_Fragment_Long(buf, id);
 
 	// ["labels", [label (string)]]
-	RedisModule_ReplyWithArray(ctx, 2);
-	RedisModule_ReplyWithStringBuffer(ctx, "labels", 6);
-	// Print label in nested array for multi-label support
-	// Retrieve label
-	// TODO Make a more efficient lookup for this string
-	const char *label = GraphContext_GetNodeLabel(gc, n);
-	if(label == NULL) {
-		// Emit an empty array for unlabeled nodes
-		RedisModule_ReplyWithArray(ctx, 0);
-	} else {
-		RedisModule_ReplyWithArray(ctx, 1);
-		RedisModule_ReplyWithStringBuffer(ctx, label, strlen(label));
+	_Fragment_Array(buf, 2);
+	_Fragment_String(buf, "labels", 6);
+	// Unlabeled nodes emit an empty array.
+	int labels[Graph_LabelTypeCount(gc->g) + 1];
+	uint label_count = _ResultSet_GetNodeLabels(gc->g, id, labels);
+	_Fragment_Array(buf, label_count);
+	for(uint i = 0; i < label_count; i++) {
+		const char *label = gc->node_schemas[labels[i]]->name;
+		_Fragment_String(buf, label, strlen(label));
 	}
 
 	// [properties, [properties]]
-	RedisModule_ReplyWithArray(ctx, 2);
-	RedisModule_ReplyWithStringBuffer(ctx, "properties", 10);
-	_ResultSet_VerboseReplyWithProperties(ctx, gc, (GraphEntity *)n);
+	_Fragment_Array(buf, 2);
+	_Fragment_String(buf, "properties", 10);
+	_Fragment_Properties(buf, gc, (GraphEntity *)n);
 }
 
-static void _ResultSet_VerboseReplyWithEdge(RedisModuleCtx *ctx, GraphContext *gc, Edge *e) {
+static void _Fragment_Edge(char **buf, GraphContext *gc, Edge *e) {
 	/*  Edge reply format:
 	 *  [
 	 *      ["id", Edge ID (integer)]
@@ -119,35 +200,54 @@ static void _ResultSet_VerboseReplyWithEdge(RedisModuleCtx *ctx, GraphContext *g
 	 *  ]
 	 */
 	// 5 top-level entities in edge reply
-	RedisModule_ReplyWithArray(ctx, 5);
+	_Fragment_Array(buf, 5);
 
 	// ["id", id (integer)]
-	RedisModule_ReplyWithArray(ctx, 2);
-	RedisModule_ReplyWithStringBuffer(ctx, "id", 2);
-	RedisModule_ReplyWithLongLong(ctx, ENTITY_GET_ID(e));
+	_Fragment_Array(buf, 2);
+	_Fragment_String(buf, "id", 2);
+	_Fragment_Long(buf, ENTITY_GET_ID(e));
 
 	// ["type", type (string)]
-	RedisModule_ReplyWithArray(ctx, 2);
-	RedisModule_ReplyWithStringBuffer(ctx, "type", 4);
+	_Fragment_Array(buf, 2);
+	_Fragment_String(buf, "type", 4);
 	// Retrieve relation type
 	Schema *s = GraphContext_GetSchemaByID(gc, Edge_GetRelationID(e), SCHEMA_EDGE);
 	const char *reltype = Schema_GetName(s);
-	RedisModule_ReplyWithStringBuffer(ctx, reltype, strlen(reltype));
+	_Fragment_String(buf, reltype, strlen(reltype));
 
 	// ["src_node", srcNodeID (integer)]
-	RedisModule_ReplyWithArray(ctx, 2);
-	RedisModule_ReplyWithStringBuffer(ctx, "src_node", 8);
-	RedisModule_ReplyWithLongLong(ctx, Edge_GetSrcNodeID(e));
+	_Fragment_Array(buf, 2);
+	_Fragment_String(buf, "src_node", 8);
+	_Fragment_Long(buf, Edge_GetSrcNodeID(e));
 
 	// ["dest_node", destNodeID (integer)]
-	RedisModule_ReplyWithArray(ctx, 2);
-	RedisModule_ReplyWithStringBuffer(ctx, "dest_node", 9);
-	RedisModule_ReplyWithLongLong(ctx, Edge_GetDestNodeID(e));
+	_Fragment_Array(buf, 2);
+	_Fragment_String(buf, "dest_node", 9);
+	_Fragment_Long(buf, Edge_GetDestNodeID(e));
 
 	// [properties, [properties]]
-	RedisModule_ReplyWithArray(ctx, 2);
-	RedisModule_ReplyWithStringBuffer(ctx, "properties", 10);
-	_ResultSet_VerboseReplyWithProperties(ctx, gc, (GraphEntity *)e);
+	_Fragment_Array(buf, 2);
+	_Fragment_String(buf, "properties", 10);
+	_Fragment_Properties(buf, gc, (GraphEntity *)e);
+}
+
+/* Reply with a node or an edge, replaying its fragment if the entity
+ * was replied earlier and no entity was modified since. */
+static void _ResultSet_VerboseReplyWithEntity(RedisModuleCtx *ctx, GraphContext *gc,
+											  VerboseState *state, GraphEntity *e, bool is_node) {
+	EntityID id = ENTITY_GET_ID(e);
+	uint64_t modifications = GraphEntity_Modifications();
+	VerboseFragment *slots = (is_node) ? state->nodes : state->edges;
+	VerboseFragment *fragment = slots + (id & (VERBOSE_FRAGMENT_SLOTS - 1));
+	if(fragment->buf == NULL || fragment->id != id || fragment->modifications != modifications) {
+		if(fragment->buf == NULL) fragment->buf = array_new(char, 256);
+		else array_clear(fragment->buf);
+		if(is_node) _Fragment_Node(&fragment->buf, gc, (Node *)e);
+		else _Fragment_Edge(&fragment->buf, gc, (Edge *)e);
+		fragment->id = id;
+		fragment->modifications = modifications;
+	}
+	_Fragment_Reply(ctx, fragment->buf);
 }
 
 static void _ResultSet_VerboseReplyWithArray(RedisModuleCtx *ctx, SIValue array) {
@@ -165,8 +265,52 @@ static void _ResultSet_VerboseReplyWithPath(RedisModuleCtx *ctx, SIValue path) {
 	SIValue_Free(path_array);
 }
 
+/* This function has handling for all SIValue scalar types.
+ * The current RESP protocol only has unique support for strings, 8-byte integers,
+ * and NULL values. */
+static void _ResultSet_VerboseReplyWithSIValue(RedisModuleCtx *ctx, GraphContext *gc,
+											   VerboseState *state, const SIValue v) {
+	// Emit the actual value, then the value type (to facilitate client-side parsing)
+	switch(SI_TYPE(v)) {
+	case T_STRING:
+		RedisModule_ReplyWithStringBuffer(ctx, v.stringval, strlen(v.stringval));
+		return;
+	case T_INT64:
+		RedisModule_ReplyWithLongLong(ctx, v.longval);
+		return;
+	case T_DOUBLE:
+		_ResultSet_ReplyWithRoundedDouble(ctx, v.doubleval);
+		return;
+	case T_BOOL:
+		if(v.longval != 0) RedisModule_ReplyWithStringBuffer(ctx, "true", 4);
+		else RedisModule_ReplyWithStringBuffer(ctx, "false", 5);
+		return;
+	case T_NULL:
+		RedisModule_ReplyWithNull(ctx);
+		return;
+	case T_NODE:
+		_ResultSet_VerboseReplyWithEntity(ctx, gc, state, v.ptrval, true);
+		return;
+	case T_EDGE:
+		_ResultSet_VerboseReplyWithEntity(ctx, gc, state, v.ptrval, false);
+		return;
+	case T_ARRAY:
+		_ResultSet_VerboseReplyWithArray(ctx, v);
+		return;
+	case T_PATH:
+		_ResultSet_VerboseReplyWithPath(ctx, v);
+		return;
+	case T_POINT:
+		// Points are emitted in their string representation, as arrays are.
+		_ResultSet_VerboseReplyWithArray(ctx, v);
+		return;
+	default:
+		assert("Unhandled value type" && false);
+	}
+}
+
 void ResultSet_EmitVerboseRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r,
-								 uint numcols, uint *col_rec_map) {
+								 uint numcols, uint *col_rec_map, void *state) {
 	// Prepare return array sized to the number of RETURN entities
 	RedisModule_ReplyWithArray(ctx, numcols);
 
@@ -174,17 +318,33 @@ void ResultSet_EmitVerboseRecord(RedisModuleCtx *ctx, GraphContext *gc, const Re
 		uint idx = col_rec_map[i];
 		switch(Record_GetType(r, idx)) {
 		case REC_TYPE_NODE:
-			_ResultSet_VerboseReplyWithNode(ctx, gc, Record_GetNode(r, idx));
+			_ResultSet_VerboseReplyWithEntity(ctx, gc, state, (GraphEntity *)Record_GetNode(r, idx),
+											  true);
 			break;
 		case REC_TYPE_EDGE:
-			_ResultSet_VerboseReplyWithEdge(ctx, gc, Record_GetEdge(r, idx));
+			_ResultSet_VerboseReplyWithEntity(ctx, gc, state, (GraphEntity *)Record_GetEdge(r, idx),
+											  false);
 			break;
 		default:
-			_ResultSet_VerboseReplyWithSIValue(ctx, gc, Record_GetScalar(r, idx));
+			_ResultSet_VerboseReplyWithSIValue(ctx, gc, state, Record_GetScalar(r, idx));
 		}
 	}
 }
 
+void *ResultSet_NewVerboseState(uint numcols) {
+	// Fragments are allocated once used.
+	return rm_calloc(1, sizeof(VerboseState));
+}
+
+void ResultSet_FreeVerboseState(void *state) {
+	VerboseState *s = state;
+	for(uint i = 0; i < VERBOSE_FRAGMENT_SLOTS; i++) {
+		if(s->nodes[i].buf) array_free(s->nodes[i].buf);
+		if(s->edges[i].buf) array_free(s->edges[i].buf);
+	}
+	rm_free(s);
+}
+
 // Emit the alias or descriptor for each column in the header.
 void ResultSet_ReplyWithVerboseHeader(RedisModuleCtx *ctx, const char **columns,
 									  const Record unused, uint *col_rec_map) {
@@ -8,5 +8,8 @@
 
 // Formatter for verbose (human-readable) replies
 void ResultSet_EmitVerboseRecord(RedisModuleCtx *ctx, GraphContext *gc, const Record r,
-								 uint numcols, uint *col_rec_map);
+								 uint numcols, uint *col_rec_map, void *state);
+// Verbose replies retain the preformatted replies of recently replied entities.
+void *ResultSet_NewVerboseState(uint numcols);
+void ResultSet_FreeVerboseState(void *state);
 void ResultSet_ReplyWithVerboseHeader(RedisModuleCtx *ctx, const char **columns, const Record r, uint *col_rec_map);
@@ -25,6 +25,9 @@ static void _ResultSet_ReplayStats(RedisModuleCtx *ctx, ResultSet *set) {
 	if(set->stats.relationships_deleted > 0) resultset_size++;
 	if(set->stats.indices_created != STAT_NOT_SET) resultset_size++;
 	if(set->stats.indices_deleted != STAT_NOT_SET) resultset_size++;
+	if(set->stats.cached != STAT_NOT_SET) resultset_size++;
+	if(set->cursor != RESULTSET_NO_CURSOR) resultset_size++;
+	if(set->version > 0) resultset_size++;
 
 	RedisModule_ReplyWithArray(ctx, resultset_size);
 
@@ -68,6 +71,21 @@ static void _ResultSet_ReplayStats(RedisModuleCtx *ctx, ResultSet *set) {
 		RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
 	}
 
+	if(set->stats.cached != STAT_NOT_SET) {
+		buflen = sprintf(buff, "Cached execution: %d", set->stats.cached);
+		RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
+	}
+
+	if(set->cursor != RESULTSET_NO_CURSOR) {
+		buflen = sprintf(buff, "Cursor: %lld", set->cursor);
+		RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
+	}
+
+	if(set->version > 0) {
+		buflen = sprintf(buff, "Graph version: %llu", (unsigned long long)set->version);
+		RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
+	}
+
 	// Emit query execution time.
 	ResultSet_ReportQueryRuntime(ctx);
 }
@@ -134,6 +152,10 @@ ResultSet *NewResultSet(RedisModuleCtx *ctx, ResultSetFormatterType format) {
 	set->column_count = 0;
 	set->header_emitted = false;
 	set->columns_record_map = NULL;
+	set->cursor = RESULTSET_NO_CURSOR;
+	set->version = 0;
+	set->formatter_state = NULL;
+	set->capture = NULL;
 
 	set->stats.labels_added = 0;
 	set->stats.nodes_created = 0;
@@ -143,8 +165,11 @@ ResultSet *NewResultSet(RedisModuleCtx *ctx, ResultSetFormatterType format) {
 	set->stats.relationships_deleted = 0;
 	set->stats.indices_created = STAT_NOT_SET;
 	set->stats.indices_deleted = STAT_NOT_SET;
+	set->stats.cached = STAT_NOT_SET;
+	set->stats.schemas_modified = 0;
 
 	_ResultSet_SetColumns(set);
+	if(set->formatter->NewState) set->formatter_state = set->formatter->NewState(set->column_count);
 
 	return set;
 }
@@ -155,8 +180,8 @@ int ResultSet_AddRecord(ResultSet *set, Record r) {
 
 	// If this is the first Record encountered
 	if(set->header_emitted == false) {
-		// Map columns to record indices.
-		_ResultSet_SetColToRecMap(set, r);
+		// Map columns to record indices, the mapping is retained across cursor reads.
+		if(set->columns_record_map == NULL) _ResultSet_SetColToRecMap(set, r);
 		// Prepare response arrays and emit the header.
 		_ResultSet_ReplyWithPreamble(set, r);
 	}
@@ -164,7 +189,9 @@ int ResultSet_AddRecord(ResultSet *set, Record r) {
 	set->recordCount++;
 
 	// Output the current record using the defined formatter
-	set->formatter->EmitRecord(set->ctx, set->gc, r, set->column_count, set->columns_record_map);
+	set->formatter->EmitRecord(set->ctx, set->gc, r, set->column_count, set->columns_record_map,
+							   set->formatter_state);
+	if(set->capture) CachedResult_AddRecord(set->capture, r, set->columns_record_map);
 
 	return RESULTSET_OK;
 }
@@ -196,7 +223,10 @@ void ResultSet_IndexDeleted(ResultSet *set, int status_code) {
 void ResultSet_Reply(ResultSet *set) {
 	if(set->header_emitted) {
 		// If we have emitted a header, set the number of elements in the preceding array.
-		RedisModule_ReplySetArrayLength(set->ctx, set->recordCount);
+		// Buffering formatters emit their remaining records, reporting the elements emitted.
+		size_t len = set->recordCount;
+		if(set->formatter->Flush) len = set->formatter->Flush(set->ctx, set->formatter_state);
+		RedisModule_ReplySetArrayLength(set->ctx, len);
 	} else if(set->header_emitted == false && set->columns != NULL) {
 		assert(set->recordCount == 0);
 		// Handle the edge case in which the query was intended to return results, but none were created.
@@ -213,6 +243,23 @@ void ResultSet_Reply(ResultSet *set) {
 	else _ResultSet_ReplayStats(set->ctx, set); // Otherwise, the last response is query statistics.
 }
 
+void ResultSet_Rebind(ResultSet *set, RedisModuleCtx *ctx) {
+	// Each read replies with a result set of its own, header included.
+	set->ctx = ctx;
+	set->recordCount = 0;
+	set->header_emitted = false;
+}
+
+void ResultSet_CaptureRecords(ResultSet *set, CachedResult *result) {
+	assert(set->capture == NULL);
+	set->capture = result;
+}
+
+void ResultSet_AddCachedRecords(ResultSet *set, const CachedResult *result) {
+	uint count = array_len(result->records);
+	for(uint i = 0; i < count; i++) ResultSet_AddRecord(set, result->records[i]);
+}
+
 /* Report execution timing. */
 void ResultSet_ReportQueryRuntime(RedisModuleCtx *ctx) {
 	char *strElapsed;
@@ -227,6 +274,8 @@ void ResultSet_Free(ResultSet *set) {
 
 	if(set->columns) array_free(set->columns);
 	if(set->columns_record_map) rm_free(set->columns_record_map);
+	if(set->formatter_state) set->formatter->FreeState(set->formatter_state);
+	if(set->capture) CachedResult_Release(set->capture);
 
 	rm_free(set);
 }
@@ -11,10 +11,12 @@
 #include "../execution_plan/record.h"
 #include "rax.h"
 #include "./formatters/resultset_formatters.h"
+#include "../result_cache/result_cache.h"
 
 #define RESULTSET_UNLIMITED UINT_MAX
 #define RESULTSET_OK 1
 #define RESULTSET_FULL 0
+#define RESULTSET_NO_CURSOR -1
 
 typedef struct {
 	RedisModuleCtx *ctx;            /* Redis context. */
@@ -28,6 +30,10 @@ typedef struct {
 	ResultSetStatistics stats;      /* ResultSet statistics. */
     ResultSetFormatterType format;  /* Result-set format; compact/verbose/nop. */
 	ResultSetFormatter *formatter;  /* ResultSet data formatter. */
+	void *formatter_state;          /* State of formatters buffering records, NULL otherwise. */
+	long long cursor;               /* Cursor reading the remaining records, 0 once depleted, RESULTSET_NO_CURSOR unless read through a cursor. */
+	CachedResult *capture;          /* Collects the replied records for the result cache, NULL otherwise. */
+	uint64_t version;               /* Graph write version reached by the query's changes, 0 if the graph wasn't modified. */
 } ResultSet;
 
 ResultSet *NewResultSet(RedisModuleCtx *ctx, ResultSetFormatterType format);
@@ -40,6 +46,18 @@ void ResultSet_IndexDeleted(ResultSet *set, int status_code);
 
 void ResultSet_Reply(ResultSet *set);
 
+/* Prepare the set for replying with the next records read through its cursor,
+ * the records are replied through ctx. */
+void ResultSet_Rebind(ResultSet *set, RedisModuleCtx *ctx);
+
+/* Collect replied records into result, the set takes ownership of the reference.
+ * The result is released along with the set. */
+void ResultSet_CaptureRecords(ResultSet *set, CachedResult *result);
+
+/* Reply with the records of a cached result, in place of executing its query.
+ * The graph's read lock must be held. */
+void ResultSet_AddCachedRecords(ResultSet *set, const CachedResult *result);
+
 void ResultSet_ReportQueryRuntime(RedisModuleCtx *ctx);
 
 void ResultSet_Free(ResultSet *set);
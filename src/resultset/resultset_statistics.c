@@ -14,5 +14,6 @@ bool ResultSetStat_IndicateModification(ResultSetStatistics stats) {
 			|| stats.nodes_deleted > 0
 			|| stats.relationships_deleted > 0
 			|| stats.indices_created > 0
-			|| stats.indices_deleted > 0);
+			|| stats.indices_deleted > 0
+			|| stats.schemas_modified > 0);
 }
@@ -19,6 +19,8 @@ typedef struct {
 	int relationships_deleted;  /* Number of edges removed as part of a delete query.*/
 	int indices_created;       /* Number of indices created. */
 	int indices_deleted;       /* Number of indices deleted. */
+	int cached;                 /* Whether the query was executed using a cached execution plan. */
+	int schemas_modified;       /* Number of schema settings changed, not reported. */
 } ResultSetStatistics;
 
 /* Checks to see if resultset-statistics indicate that a modification was made. */
@@ -9,14 +9,22 @@
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
 #include "../graph/graphcontext.h"
+#include <string.h>
 #include <assert.h>
 
-Schema *Schema_New(const char *name, int id) {
+Schema *Schema_New(const char *name, int id, SchemaType type) {
 	Schema *schema = rm_malloc(sizeof(Schema));
 	schema->id = id;
+	schema->type = type;
 	schema->index = NULL;
 	schema->fulltextIdx = NULL;
+	schema->vectorIndices = array_new(VectorIndex *, 0);
+	schema->stats = SchemaStats_New();
 	schema->name = rm_strdup(name);
+	schema->ttl_attribute = NULL;
+	schema->ttl = 0;
+	schema->intervals = NULL;
+	schema->weights = array_new(char *, 0);
 	return schema;
 }
 
@@ -25,17 +33,32 @@ const char *Schema_GetName(const Schema *s) {
 	return s->name;
 }
 
+GraphEntityType Schema_EntityType(const Schema *s) {
+	assert(s);
+	return (s->type == SCHEMA_NODE) ? GETYPE_NODE : GETYPE_EDGE;
+}
+
 bool Schema_HasIndices(const Schema *s) {
 	assert(s);
-	return (s->fulltextIdx || s->index);
+	return (s->fulltextIdx || s->index || array_len(s->vectorIndices) > 0);
 }
 
 unsigned short Schema_IndexCount(const Schema *s) {
 	assert(s);
 	unsigned short n = 0;
 
-	if(s->index) n += Index_FieldsCount(s->index);
-	if(s->fulltextIdx) n += Index_FieldsCount(s->fulltextIdx);
+	if(s->index) {
+		n += Index_FieldsCount(s->index) + Index_CompositeCount(s->index) +
+			 Index_UniqueConstraintCount(s->index);
+	}
+	if(s->fulltextIdx) {
+		n += Index_FieldsCount(s->fulltextIdx) + Index_IsAsync(s->fulltextIdx);
+	}
+	n += array_len(s->vectorIndices);
+	// Expiry is persisted along the indices.
+	n += Schema_HasExpiry(s);
+	n += (s->intervals != NULL);
+	n += array_len(s->weights);
 
 	return n;
 }
@@ -69,7 +92,7 @@ int Schema_AddIndex(Index **idx, Schema *s, const char *field, IndexType type) {
 
 	// Index doesn't exists, create it.
 	if(!_idx) {
-		_idx = Index_New(s->name, type);
+		_idx = Index_New(s->name, type, Schema_EntityType(s));
 		if(type == IDX_FULLTEXT) s->fulltextIdx = _idx;
 		else s->index = _idx;
 	}
@@ -80,6 +103,39 @@ int Schema_AddIndex(Index **idx, Schema *s, const char *field, IndexType type) {
 	return INDEX_OK;
 }
 
+int Schema_AddCompositeIndex(Index **idx, Schema *s, const char **fields, uint fields_count) {
+	assert(fields && fields_count > 1);
+
+	*idx = NULL;
+	Index *_idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
+
+	// Index doesn't exists, create it.
+	bool created = (_idx == NULL);
+	if(created) _idx = Index_New(s->name, IDX_EXACT_MATCH, Schema_EntityType(s));
+
+	if(!Index_AddComposite(_idx, fields, fields_count)) {
+		if(created) Index_Free(_idx);
+		return INDEX_FAIL;
+	}
+
+	s->index = _idx;
+	*idx = _idx;
+	return INDEX_OK;
+}
+
+int Schema_RemoveCompositeIndex(Schema *s, const char **fields, uint fields_count) {
+	Index *idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
+	if(idx == NULL || !Index_RemoveComposite(idx, fields, fields_count)) return INDEX_FAIL;
+
+	// Remove index from schema once it indexes nothing.
+	if(Index_FieldsCount(idx) == 0 && Index_CompositeCount(idx) == 0) {
+		Index_Free(idx);
+		s->index = NULL;
+	}
+
+	return INDEX_OK;
+}
+
 int Schema_RemoveIndex(Schema *s, const char *field, IndexType type) {
 	Index *idx = Schema_GetIndex(s, field, type);
 	if(idx == NULL) return INDEX_FAIL;
@@ -97,7 +153,7 @@ int Schema_RemoveIndex(Schema *s, const char *field, IndexType type) {
 
 	/* If index field count dropped to 0
 	 * remove index from schema. */
-	if(Index_FieldsCount(idx) == 0) {
+	if(Index_FieldsCount(idx) == 0 && Index_CompositeCount(idx) == 0) {
 		Index_Free(idx);
 		switch(type) {
 		case IDX_EXACT_MATCH:
@@ -112,6 +168,67 @@ int Schema_RemoveIndex(Schema *s, const char *field, IndexType type) {
 	return INDEX_OK;
 }
 
+VectorIndex *Schema_GetVectorIndex(const Schema *s, const char *field) {
+	assert(s && field);
+	uint count = array_len(s->vectorIndices);
+	for(uint i = 0; i < count; i++) {
+		if(strcmp(s->vectorIndices[i]->field, field) == 0) return s->vectorIndices[i];
+	}
+	return NULL;
+}
+
+int Schema_AddVectorIndex(VectorIndex **idx, Schema *s, const char *field, uint32_t dim,
+						  VectorMetric metric) {
+	assert(idx && s && field);
+
+	*idx = NULL;
+	if(Schema_GetVectorIndex(s, field) != NULL) return INDEX_FAIL;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Attribute_ID attr = GraphContext_FindOrAddAttribute(gc, field);
+	*idx = VectorIndex_New(s->name, field, attr, dim, metric);
+	s->vectorIndices = array_append(s->vectorIndices, *idx);
+	return INDEX_OK;
+}
+
+int Schema_RemoveVectorIndex(Schema *s, const char *field) {
+	uint count = array_len(s->vectorIndices);
+	for(uint i = 0; i < count; i++) {
+		VectorIndex *idx = s->vectorIndices[i];
+		if(strcmp(idx->field, field) != 0) continue;
+		VectorIndex_Free(idx);
+		array_del(s->vectorIndices, i);
+		return INDEX_OK;
+	}
+	return INDEX_FAIL;
+}
+
+int Schema_AddUniqueConstraint(Schema *s, const char *field) {
+	Index *idx = Schema_GetIndex(s, field, IDX_EXACT_MATCH);
+	if(idx == NULL || !Index_AddUniqueConstraint(idx, field)) return INDEX_FAIL;
+	return INDEX_OK;
+}
+
+int Schema_RemoveUniqueConstraint(Schema *s, const char *field) {
+	Index *idx = Schema_GetIndex(s, field, IDX_EXACT_MATCH);
+	if(idx == NULL || !Index_RemoveUniqueConstraint(idx, field)) return INDEX_FAIL;
+	return INDEX_OK;
+}
+
+bool Schema_HasUniqueConstraints(const Schema *s) {
+	return (s && s->index && Index_UniqueConstraintCount(s->index) > 0);
+}
+
+bool Schema_IsUnique(const Schema *s, Attribute_ID attr) {
+	return (s && s->index && Index_IsUnique(s->index, attr));
+}
+
+bool Schema_UniqueValueTaken(const Schema *s, Attribute_ID attr, SIValue v, EntityID exclude) {
+	if(!Schema_IsUnique(s, attr)) return false;
+	EntityID id;
+	return Index_UniqueLookup(s->index, attr, v, exclude, &id);
+}
+
 // Index node under all shcema indicies.
 void Schema_AddNodeToIndices(const Schema *s, const Node *n, bool update) {
 	if(!s) return;
@@ -122,6 +239,10 @@ void Schema_AddNodeToIndices(const Schema *s, const Node *n, bool update) {
 		Index_IndexNode(idx, n);
 	}
 
+	// Vector indices replace the node's previous vector.
+	uint vector_count = array_len(s->vectorIndices);
+	for(uint i = 0; i < vector_count; i++) VectorIndex_IndexNode(s->vectorIndices[i], n);
+
 	idx = s->index;
 	if(!idx) return;
 
@@ -129,12 +250,102 @@ void Schema_AddNodeToIndices(const Schema *s, const Node *n, bool update) {
 	Index_IndexNode(idx, n);
 }
 
+// Index edge under the schema's index.
+void Schema_AddEdgeToIndices(const Schema *s, const Edge *e, bool update) {
+	if(!s) return;
+
+	Index *idx = s->index;
+	if(!idx) return;
+
+	if(update) Index_RemoveEdge(idx, e);
+	Index_IndexEdge(idx, e);
+}
+
+bool Schema_IndexesAttribute(const Schema *s, Attribute_ID attr) {
+	if(!s) return false;
+	if(s->index && Index_ContainsAttribute(s->index, attr)) return true;
+	if(s->fulltextIdx && Index_ContainsAttribute(s->fulltextIdx, attr)) return true;
+	uint vector_count = array_len(s->vectorIndices);
+	for(uint i = 0; i < vector_count; i++) {
+		if(s->vectorIndices[i]->attr == attr) return true;
+	}
+	return false;
+}
+
+void Schema_ReindexNodes(const Schema *s, const Node *nodes, uint count) {
+	if(!s) return;
+
+	Index *indices[2] = {s->fulltextIdx, s->index};
+	for(int i = 0; i < 2; i++) {
+		Index *idx = indices[i];
+		if(!idx) continue;
+		for(uint j = 0; j < count; j++) Index_RemoveNode(idx, nodes + j);
+		for(uint j = 0; j < count; j++) Index_IndexNode(idx, nodes + j);
+	}
+
+	// Vector indices replace the node's previous vector.
+	uint vector_count = array_len(s->vectorIndices);
+	for(uint i = 0; i < vector_count; i++) {
+		for(uint j = 0; j < count; j++) VectorIndex_IndexNode(s->vectorIndices[i], nodes + j);
+	}
+}
+
+void Schema_ReindexEdges(const Schema *s, const Edge *edges, uint count) {
+	if(!s || !s->index) return;
+
+	for(uint i = 0; i < count; i++) Index_RemoveEdge(s->index, edges + i);
+	for(uint i = 0; i < count; i++) Index_IndexEdge(s->index, edges + i);
+}
+
+void Schema_SetExpiry(Schema *s, const char *attribute, uint64_t ttl) {
+	assert(s && attribute);
+	if(s->ttl_attribute) rm_free(s->ttl_attribute);
+	s->ttl_attribute = (ttl > 0) ? rm_strdup(attribute) : NULL;
+	s->ttl = ttl;
+}
+
+bool Schema_HasExpiry(const Schema *s) {
+	assert(s);
+	return s->ttl_attribute != NULL;
+}
+
+void Schema_SetIntervals(Schema *s, const char *from_attribute, const char *to_attribute) {
+	assert(s && s->type == SCHEMA_EDGE);
+	if(s->intervals) IntervalIndex_Free(s->intervals);
+	s->intervals = (from_attribute) ? IntervalIndex_New(from_attribute, to_attribute) : NULL;
+}
+
+bool Schema_SetWeights(Schema *s, const char *attribute, bool maintain) {
+	assert(s && s->type == SCHEMA_EDGE && attribute);
+	uint count = array_len(s->weights);
+	for(uint i = 0; i < count; i++) {
+		if(strcmp(s->weights[i], attribute) != 0) continue;
+		if(maintain) return false;
+		rm_free(s->weights[i]);
+		array_del(s->weights, i);
+		return true;
+	}
+
+	if(!maintain) return false;
+	s->weights = array_append(s->weights, rm_strdup(attribute));
+	return true;
+}
+
 void Schema_Free(Schema *schema) {
 	if(schema->name) rm_free(schema->name);
+	if(schema->ttl_attribute) rm_free(schema->ttl_attribute);
+	IntervalIndex_Free(schema->intervals);
+	uint weight_count = array_len(schema->weights);
+	for(uint i = 0; i < weight_count; i++) rm_free(schema->weights[i]);
+	array_free(schema->weights);
 
 	// Free indicies.
 	if(schema->index) Index_Free(schema->index);
 	if(schema->fulltextIdx) Index_Free(schema->fulltextIdx);
+	uint vector_count = array_len(schema->vectorIndices);
+	for(uint i = 0; i < vector_count; i++) VectorIndex_Free(schema->vectorIndices[i]);
+	array_free(schema->vectorIndices);
+	SchemaStats_Free(schema->stats);
 	rm_free(schema);
 }
 
@@ -8,8 +8,11 @@
 
 #include "../redismodule.h"
 #include "../index/index.h"
+#include "../index/vector_index.h"
+#include "../index/interval_index.h"
 #include "rax.h"
 #include "redisearch_api.h"
+#include "schema_stats.h"
 #include "../graph/entities/graph_entity.h"
 
 typedef enum {
@@ -22,17 +25,27 @@ typedef enum {
  * of attributes we've encountered overtime as entities were created or updated. */
 typedef struct {
 	int id;               // Internal ID to a matrix within the graph.
+	SchemaType type;      // Node label or relationship type.
 	char *name;           // Schema name.
 	Index *index;         // Exact match index.
 	Index *fulltextIdx;   // Full-text index.
+	VectorIndex **vectorIndices; // Vector similarity indices, one per field.
+	SchemaStats *stats;   // Attribute statistics, maintained for node schemas.
+	char *ttl_attribute;  // Attribute holding each entity's timestamp, NULL if entities don't expire.
+	uint64_t ttl;         // Seconds past its timestamp an entity expires at.
+	IntervalIndex *intervals; // Validity intervals of the relation's edges, NULL if edges aren't temporal.
+	char **weights;       // Attributes whose weight matrices are kept in sync with edge writes.
 } Schema;
 
 /* Creates a new schema. */
-Schema *Schema_New(const char *label, int id);
+Schema *Schema_New(const char *label, int id, SchemaType type);
 
 const char *Schema_GetName(const Schema *s);
 
-/* Returns true if schema has either a full-text or exact-match index. */
+/* Returns the type of entities described by schema. */
+GraphEntityType Schema_EntityType(const Schema *s);
+
+/* Returns true if schema has either a full-text, exact-match or vector index. */
 bool Schema_HasIndices(const Schema *s);
 
 /* Returns number of indices in schema. */
@@ -46,12 +59,77 @@ Index *Schema_GetIndex(const Schema *s, const char *field, IndexType type);
  * attribute must already exists and not associated with an index. */
 int Schema_AddIndex(Index **idx, Schema *s, const char *field, IndexType type);
 
+/* Assign a new composite index over fields, in order
+ * the same ordered fields must not already be indexed together. */
+int Schema_AddCompositeIndex(Index **idx, Schema *s, const char **fields, uint fields_count);
+
+/* Removes composite index over fields, the remaining
+ * composite indices must be reconstructed. */
+int Schema_RemoveCompositeIndex(Schema *s, const char **fields, uint fields_count);
+
 /* Removes index. */
 int Schema_RemoveIndex(Schema *s, const char *field, IndexType type);
 
+/* Retrieves field's vector index.
+ * Returns NULL if field has no vector index. */
+VectorIndex *Schema_GetVectorIndex(const Schema *s, const char *field);
+
+/* Assign a new vector index to field
+ * field must not already be associated with a vector index. */
+int Schema_AddVectorIndex(VectorIndex **idx, Schema *s, const char *field, uint32_t dim,
+						  VectorMetric metric);
+
+/* Removes field's vector index. */
+int Schema_RemoveVectorIndex(Schema *s, const char *field);
+
+/* Constrains values of an indexed field to be unique.
+ * Returns INDEX_FAIL if field isn't indexed or is already constrained. */
+int Schema_AddUniqueConstraint(Schema *s, const char *field);
+
+/* Removes unique constraint over field, keeping the field's index. */
+int Schema_RemoveUniqueConstraint(Schema *s, const char *field);
+
+/* Returns true if schema constrains any attribute to hold unique values. */
+bool Schema_HasUniqueConstraints(const Schema *s);
+
+/* Returns true if values of attribute are constrained to be unique. */
+bool Schema_IsUnique(const Schema *s, Attribute_ID attr);
+
+/* Returns true if an entity other than exclude holds v under a uniquely
+ * constrained attribute. */
+bool Schema_UniqueValueTaken(const Schema *s, Attribute_ID attr, SIValue v, EntityID exclude);
+
+/* Expire entities ttl seconds past the millisecond timestamp held by attribute,
+ * a ttl of 0 disables expiry. */
+void Schema_SetExpiry(Schema *s, const char *attribute, uint64_t ttl);
+
+/* Returns true if the schema's entities expire. */
+bool Schema_HasExpiry(const Schema *s);
+
+/* Index the validity intervals of the relation's edges, bounded by the millisecond
+ * timestamps held by the from and to attributes, a NULL from attribute drops the index. */
+void Schema_SetIntervals(Schema *s, const char *from_attribute, const char *to_attribute);
+
+/* Note the weight matrix of the relation by attribute is kept in sync with edge writes,
+ * or stop noting it. Returns false if the setting is unchanged. */
+bool Schema_SetWeights(Schema *s, const char *attribute, bool maintain);
+
 /* Introduce node schema indicies */
 void Schema_AddNodeToIndices(const Schema *s, const Node *n, bool update);
 
+/* Introduce edge to relationship schema index */
+void Schema_AddEdgeToIndices(const Schema *s, const Edge *e, bool update);
+
+// Returns true if attribute is indexed by any of the schema's indices.
+bool Schema_IndexesAttribute(const Schema *s, Attribute_ID attr);
+
+/* Reindex updated nodes under all schema indices,
+ * each index drops every node prior to introducing them back. */
+void Schema_ReindexNodes(const Schema *s, const Node *nodes, uint count);
+
+/* Reindex updated edges under the relationship schema index. */
+void Schema_ReindexEdges(const Schema *s, const Edge *edges, uint count);
+
 /* Free schema. */
 void Schema_Free(Schema *s);
 
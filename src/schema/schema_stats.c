@@ -0,0 +1,172 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "schema_stats.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
+#include <math.h>
+#include <assert.h>
+
+static inline uint64_t _SchemaStats_Random(SchemaStats *stats) {
+	// xorshift64*
+	stats->seed ^= stats->seed >> 12;
+	stats->seed ^= stats->seed << 25;
+	stats->seed ^= stats->seed >> 27;
+	return stats->seed * 0x2545F4914F6CDD1DULL;
+}
+
+static AttributeStats *_SchemaStats_Attribute(SchemaStats *stats, Attribute_ID attr) {
+	while(array_len(stats->attributes) <= attr) {
+		stats->attributes = array_append(stats->attributes, NULL);
+	}
+
+	AttributeStats *a = stats->attributes[attr];
+	if(a == NULL) {
+		a = rm_calloc(1, sizeof(AttributeStats));
+		a->min = INFINITY;
+		a->max = -INFINITY;
+		a->sample = array_new(double, 16);
+		stats->attributes[attr] = a;
+	}
+	return a;
+}
+
+static void _AttributeStats_Observe(SchemaStats *stats, AttributeStats *a, SIValue v) {
+	// HyperLogLog, the leading hash bits select a register,
+	// which retains the longest run of leading zeros among the remaining bits.
+	uint64_t hash = SIValue_HashCode(v);
+	uint idx = hash >> (64 - STATS_HLL_PRECISION);
+	uint64_t w = (hash << STATS_HLL_PRECISION) | (1ULL << (STATS_HLL_PRECISION - 1));
+	uint8_t rank = __builtin_clzll(w) + 1;
+	if(rank > a->hll[idx]) a->hll[idx] = rank;
+
+	if(!(SI_TYPE(v) & SI_NUMERIC)) return;
+
+	double d = SI_GET_NUMERIC(v);
+	a->numeric_count++;
+	if(d < a->min) a->min = d;
+	if(d > a->max) a->max = d;
+
+	// Reservoir sampling, each observed value is sampled with equal probability.
+	if(array_len(a->sample) < STATS_SAMPLE_CAP) {
+		a->sample = array_append(a->sample, d);
+	} else {
+		uint64_t j = _SchemaStats_Random(stats) % a->numeric_count;
+		if(j < STATS_SAMPLE_CAP) a->sample[j] = d;
+	}
+}
+
+SchemaStats *SchemaStats_New(void) {
+	SchemaStats *stats = rm_malloc(sizeof(SchemaStats));
+	stats->valid = false;
+	stats->seed = 0x9E3779B97F4A7C15ULL;
+	stats->attributes = array_new(AttributeStats *, 0);
+	return stats;
+}
+
+static void _SchemaStats_Clear(SchemaStats *stats) {
+	uint count = array_len(stats->attributes);
+	for(uint i = 0; i < count; i++) {
+		AttributeStats *a = stats->attributes[i];
+		if(a == NULL) continue;
+		array_free(a->sample);
+		rm_free(a);
+	}
+	array_clear(stats->attributes);
+}
+
+void SchemaStats_Reset(SchemaStats *stats) {
+	assert(stats);
+	_SchemaStats_Clear(stats);
+	stats->valid = true;
+}
+
+void SchemaStats_Invalidate(SchemaStats *stats) {
+	assert(stats);
+	_SchemaStats_Clear(stats);
+	stats->valid = false;
+}
+
+void SchemaStats_AddEntity(SchemaStats *stats, const GraphEntity *e) {
+	if(!stats->valid) return;
+
+	int prop_count = ENTITY_PROP_COUNT(e);
+	EntityProperty *properties = ENTITY_PROPS(e);
+	for(int i = 0; i < prop_count; i++) {
+		AttributeStats *a = _SchemaStats_Attribute(stats, properties[i].id);
+		a->count++;
+		_AttributeStats_Observe(stats, a, properties[i].value);
+	}
+}
+
+void SchemaStats_RemoveEntity(SchemaStats *stats, const GraphEntity *e) {
+	if(!stats->valid) return;
+
+	int prop_count = ENTITY_PROP_COUNT(e);
+	EntityProperty *properties = ENTITY_PROPS(e);
+	for(int i = 0; i < prop_count; i++) {
+		AttributeStats *a = _SchemaStats_Attribute(stats, properties[i].id);
+		if(a->count > 0) a->count--;
+	}
+}
+
+void SchemaStats_UpdateProperty(SchemaStats *stats, Attribute_ID attr, SIValue old_value,
+								SIValue new_value) {
+	if(!stats->valid) return;
+
+	AttributeStats *a = _SchemaStats_Attribute(stats, attr);
+	bool had_value = !SIValue_IsNull(old_value);
+	bool has_value = !SIValue_IsNull(new_value);
+	if(!had_value && has_value) a->count++;
+	if(had_value && !has_value && a->count > 0) a->count--;
+	if(has_value) _AttributeStats_Observe(stats, a, new_value);
+}
+
+const AttributeStats *SchemaStats_GetAttribute(const SchemaStats *stats, Attribute_ID attr) {
+	if(attr >= array_len(stats->attributes)) return NULL;
+	return stats->attributes[attr];
+}
+
+uint64_t AttributeStats_DistinctCount(const AttributeStats *a) {
+	double m = STATS_HLL_REGISTERS;
+	double sum = 0;
+	uint zeros = 0;
+	for(uint i = 0; i < STATS_HLL_REGISTERS; i++) {
+		sum += ldexp(1.0, -a->hll[i]);
+		if(a->hll[i] == 0) zeros++;
+	}
+
+	double estimate = (0.7213 / (1 + 1.079 / m)) * m * m / sum;
+	// Small cardinalities are better estimated by linear counting.
+	if(estimate <= 2.5 * m && zeros > 0) estimate = m * log(m / zeros);
+	return (uint64_t)llround(estimate);
+}
+
+uint AttributeStats_Histogram(const AttributeStats *a, double *bounds, uint bucket_count) {
+	uint n = array_len(a->sample);
+	if(n == 0 || bucket_count == 0) return 0;
+	if(bucket_count > n) bucket_count = n;
+
+	double *sorted = rm_malloc(sizeof(double) * n);
+	memcpy(sorted, a->sample, sizeof(double) * n);
+#define double_lt(a, b) (*(a) < *(b))
+	QSORT(double, sorted, n, double_lt);
+
+	// Each bucket holds an equal share of the sampled values.
+	for(uint i = 0; i < bucket_count; i++) {
+		bounds[i] = sorted[((uint64_t)(i + 1) * n) / bucket_count - 1];
+	}
+	rm_free(sorted);
+	return bucket_count;
+}
+
+void SchemaStats_Free(SchemaStats *stats) {
+	if(stats == NULL) return;
+	_SchemaStats_Clear(stats);
+	array_free(stats->attributes);
+	rm_free(stats);
+}
@@ -0,0 +1,72 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../value.h"
+#include "../graph/entities/graph_entity.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define STATS_HLL_PRECISION 10                          // Log2 of HyperLogLog registers.
+#define STATS_HLL_REGISTERS (1 << STATS_HLL_PRECISION)  // Number of HyperLogLog registers.
+#define STATS_SAMPLE_CAP 256                            // Numeric values sampled per attribute.
+
+/* Statistics of a single attribute across a schema's entities.
+ * The count of entities holding the attribute is exact, the distinct value
+ * estimate, numeric bounds and sample reflect every value the attribute
+ * has been assigned, values removed by updates and deletions are not retracted. */
+typedef struct {
+	uint64_t count;                         // Number of entities holding attribute.
+	uint64_t numeric_count;                 // Number of numeric values observed.
+	double min;                             // Smallest numeric value observed.
+	double max;                             // Largest numeric value observed.
+	uint8_t hll[STATS_HLL_REGISTERS];       // HyperLogLog registers.
+	double *sample;                         // Reservoir sample of numeric values.
+} AttributeStats;
+
+/* Per attribute statistics of a schema, maintained incrementally by writers.
+ * Statistics which are invalid, e.g. those of a schema loaded from RDB,
+ * are ignored by updates and expected to be rebuilt by a full scan. */
+typedef struct {
+	bool valid;                             // Statistics reflect the schema's entities.
+	AttributeStats **attributes;            // Statistics indexed by attribute ID.
+	uint64_t seed;                          // Reservoir sampling random state.
+} SchemaStats;
+
+// Creates new, invalid, statistics.
+SchemaStats *SchemaStats_New(void);
+
+// Discards all statistics, marking them valid for an empty schema.
+void SchemaStats_Reset(SchemaStats *stats);
+
+// Marks statistics as no longer reflecting the schema's entities.
+void SchemaStats_Invalidate(SchemaStats *stats);
+
+// Accounts for the properties of an entity added to the schema.
+void SchemaStats_AddEntity(SchemaStats *stats, const GraphEntity *e);
+
+// Accounts for the removal of an entity from the schema.
+void SchemaStats_RemoveEntity(SchemaStats *stats, const GraphEntity *e);
+
+// Accounts for an entity's attribute changing from old_value to new_value,
+// either may be NULL to indicate an added or removed attribute.
+void SchemaStats_UpdateProperty(SchemaStats *stats, Attribute_ID attr, SIValue old_value,
+								SIValue new_value);
+
+// Returns attribute statistics, NULL if no entity holds the attribute.
+const AttributeStats *SchemaStats_GetAttribute(const SchemaStats *stats, Attribute_ID attr);
+
+// Returns an estimate of the number of distinct values assigned to attribute.
+uint64_t AttributeStats_DistinctCount(const AttributeStats *a);
+
+/* Computes an equi-depth histogram of the attribute's numeric values,
+ * bounds[i] is set to the upper bound of the i'th bucket,
+ * returns the number of buckets written, at most bucket_count. */
+uint AttributeStats_Histogram(const AttributeStats *a, double *bounds, uint bucket_count);
+
+// Free statistics.
+void SchemaStats_Free(SchemaStats *stats);
@@ -9,17 +9,20 @@
 #include <unistd.h>
 
 #include "./slow_log.h"
+#include "xxhash.h"
 #include "../util/arr.h"
-#include "../query_ctx.h"
+#include "../util/qsort.h"
 #include "../util/rmalloc.h"
-#include "../util/thpool/thpool.h"
+#include "../util/thpool/pools.h"
+#include "../execution_plan/plan_cache.h"
 
-static int get_thread_id() {
-	extern threadpool _thpool;  // Declared in module.c
+extern long long slowlog_size;      // Number of queries retained by each graph's slowlog.
+extern long long slowlog_threshold; // Number of milliseconds a query runs for before it is logged.
 
-	/* thpool_get_thread_id returns -1 if pthread_self isn't in the thread pool
+static int get_thread_id() {
+	/* ThreadPools_GetThreadID returns -1 if pthread_self isn't in any of the thread pools
 	 * most likely Redis main thread */
-	int thread_id = thpool_get_thread_id(_thpool, pthread_self());
+	int thread_id = ThreadPools_GetThreadID();
 	thread_id += 1; // +1 to compensate for Redis main thread.
 	return thread_id;
 }
@@ -38,189 +41,227 @@ static inline void _ReplyWithRoundedDouble(RedisModuleCtx *ctx, double d) {
 	RedisModule_ReplyWithStringBuffer(ctx, str, len);
 }
 
-static SlowLogItem *_SlowLogItem_New(const char *cmd, const char *query, double latency) {
+// Hashes are replied as hex strings, as they don't fit within a signed integer.
+static inline void _ReplyWithHash(RedisModuleCtx *ctx, uint64_t hash) {
+	char str[17];
+	int len = snprintf(str, sizeof(str), "%016llx", (unsigned long long)hash);
+	RedisModule_ReplyWithStringBuffer(ctx, str, len);
+}
+
+static SlowLogItem *_SlowLogItem_New(const char *cmd, const char *query, size_t body_offset,
+									 const SlowLogStats *stats) {
 	SlowLogItem *item = rm_malloc(sizeof(SlowLogItem));
 	item->cmd = rm_strdup(cmd);
 	item->query = rm_strdup(query);
-	item->latency = latency;
+	item->body_offset = body_offset;
+	item->params_hash = (body_offset > 0) ? XXH64(query, body_offset, 0) : 0;
+	item->stats = *stats;
+	item->refcount = 1;
 	time(&(item->time));
 	return item;
 }
 
-static void _SlowLog_Item_Free(SlowLogItem *item) {
+static inline SlowLogItem *_SlowLogItem_Retain(SlowLogItem *item) {
+	__atomic_fetch_add(&item->refcount, 1, __ATOMIC_RELAXED);
+	return item;
+}
+
+static void _SlowLogItem_Release(SlowLogItem *item) {
 	assert(item);
+	if(__atomic_sub_fetch(&item->refcount, 1, __ATOMIC_ACQ_REL) > 0) return;
 	rm_free(item->cmd);
 	rm_free(item->query);
 	rm_free(item);
 }
 
-// Compares two heap record nodes.
-static int _slowlog_elem_compare(const void *A, const void *B, const void *udata) {
-	SlowLogItem *a = (SlowLogItem *)A;
-	SlowLogItem *b = (SlowLogItem *)B;
-	return b->latency - a->latency;
-}
-
-static inline size_t _compute_key(char **s, const char *cmd, const char *query) {
-	return asprintf(s, "%s %s", cmd, query);
+// Items are keyed by their command and query body, such that parameters don't matter.
+static inline size_t _compute_key(char **s, const char *cmd, const char *body) {
+	return asprintf(s, "%s %s", cmd, body);
 }
 
 static size_t _SlowLogItem_ToString(const SlowLogItem *item, char **s) {
 	assert(item);
-	return _compute_key(s, item->cmd, item->query);
+	return _compute_key(s, item->cmd, item->query + item->body_offset);
 }
 
-static void _SlowLog_RemoveItemFromLookup(SlowLog *slowlog, int t_id, const SlowLogItem *item) {
-	char *key;
-	rax *lookup = slowlog->lookup[t_id];
-	size_t key_len = _SlowLogItem_ToString(item, &key);
-	assert(raxRemove(lookup, (unsigned char *)key, key_len, NULL) == 1);
-	free(key);
+// Locate the item with the lowest latency.
+static void _SlowLogShard_UpdateFastest(SlowLogShard *shard) {
+	uint count = array_len(shard->items);
+	shard->fastest = 0;
+	for(uint i = 1; i < count; i++) {
+		if(shard->items[i]->stats.latency < shard->items[shard->fastest]->stats.latency) {
+			shard->fastest = i;
+		}
+	}
 }
 
-static bool _SlowLog_Contains(const SlowLog *slowlog, int t_id, const char *cmd, const char *query,
-							  char **key, SlowLogItem **item) {
-	size_t len = _compute_key(key, cmd, query);
-	rax *lookup = slowlog->lookup[t_id];
-	*item = (SlowLogItem *)raxFind(lookup, (unsigned char *)*key, len);
-	if(*item == raxNotFound) *item = NULL;
-	return (*item != NULL);
+// Replace the item at position pos with item, releasing the replaced item.
+static void _SlowLogShard_Replace(SlowLogShard *shard, uint pos, SlowLogItem *item) {
+	char *key;
+	SlowLogItem *replaced = shard->items[pos];
+	size_t key_len = _SlowLogItem_ToString(replaced, &key);
+	assert(raxRemove(shard->lookup, (unsigned char *)key, key_len, NULL) == 1);
+	free(key);
+	_SlowLogItem_Release(replaced);
+	shard->items[pos] = item;
 }
 
 SlowLog *SlowLog_New() {
 	SlowLog *slowlog = rm_malloc(sizeof(SlowLog));
 
-	extern threadpool _thpool;  // Declared in module.c
-	int thread_count = thpool_num_threads(_thpool);
+	int thread_count = ThreadPools_ThreadCount();
 	thread_count += 1;  // Redis main thread.
 
 	slowlog->count = thread_count;
-	slowlog->lookup = rm_malloc(sizeof(rax *) * thread_count);
-	slowlog->min_heap = rm_malloc(sizeof(heap_t *) * thread_count);
-	slowlog->locks = rm_malloc(sizeof(pthread_mutex_t) * thread_count);
+	slowlog->shards = rm_malloc(sizeof(SlowLogShard) * thread_count);
 
 	for(int i = 0; i < thread_count; i++) {
-		slowlog->lookup[i] = raxNew();
-		slowlog->min_heap[i] = heap_new(_slowlog_elem_compare, NULL);
-		assert(pthread_mutex_init(slowlog->locks + i, NULL) == 0);
+		SlowLogShard *shard = slowlog->shards + i;
+		shard->lookup = raxNew();
+		shard->items = array_new(SlowLogItem *, 1);
+		shard->fastest = 0;
+		int res = pthread_mutex_init(&shard->lock, NULL);
+		assert(res == 0);
 	}
 
 	return slowlog;
 }
 
-void SlowLog_Add(SlowLog *slowlog, const char *cmd, const char *query,
-				 double latency) {
-	assert(slowlog && cmd && query && latency >= 0);
+inline bool SlowLog_Considers(double latency) {
+	return latency >= slowlog_threshold;
+}
+
+void SlowLog_Add(SlowLog *slowlog, const char *cmd, const char *query, const SlowLogStats *stats) {
+	assert(slowlog && cmd && query && stats && stats->latency >= 0);
+	if(!SlowLog_Considers(stats->latency)) return;
+
+	// Queries whose parameters can't be scanned are keyed as a whole.
+	size_t body_offset;
+	if(!PlanCache_QueryBodyOffset(query, &body_offset)) body_offset = 0;
 
 	char *key;
-	SlowLogItem *existing_item;
-	int t_id = get_thread_id();
-	rax *lookup = slowlog->lookup[t_id];
-	heap_t *heap = slowlog->min_heap[t_id];
-	pthread_mutex_t *lock = slowlog->locks + t_id;
+	size_t key_len = _compute_key(&key, cmd, query + body_offset);
+	SlowLogShard *shard = slowlog->shards + get_thread_id();
 
-	if(pthread_mutex_lock(lock) != 0) {
+	if(pthread_mutex_lock(&shard->lock) != 0) {
 		// Failed to lock, skip logging.
+		free(key);
 		return;
 	}
 
 	{
 		// In critical section..
-		bool exists = _SlowLog_Contains(slowlog, t_id, cmd, query, &key, &existing_item);
-		size_t key_len = strlen(key);
-
-		if(exists) {
-			// A similar item already exists, see if we need to update its latency.
-			if(existing_item->latency < latency) existing_item->latency = latency;
+		uint count = array_len(shard->items);
+		SlowLogItem *existing_item = raxFind(shard->lookup, (unsigned char *)key, key_len);
+
+		if(existing_item != raxNotFound) {
+			// A similar item already exists, replace it if this execution is slower.
+			if(existing_item->stats.latency >= stats->latency) goto cleanup;
+			uint pos = 0;
+			while(shard->items[pos] != existing_item) pos++;
+			SlowLogItem *item = _SlowLogItem_New(cmd, query, body_offset, stats);
+			_SlowLogShard_Replace(shard, pos, item);
+			raxInsert(shard->lookup, (unsigned char *)key, key_len, item, NULL);
+			if(pos == shard->fastest) _SlowLogShard_UpdateFastest(shard);
 			goto cleanup;
 		}
 
 		/* Similar item does not exist in the log.
 		 * Check if there's enough room to store item. */
-		int introduce_item = 0;
-		if(heap_count(heap) < SLOW_LOG_SIZE) {
-			introduce_item = 1;
-		} else {
-			// Not enough room, see if item should be tracked.
-			SlowLogItem *top = heap_peek(heap);
-			if(top->latency < latency) {
-				top = heap_poll(heap);
-				_SlowLog_RemoveItemFromLookup(slowlog, t_id, top);
-				_SlowLog_Item_Free(top);
-				introduce_item = 1;
+		if(count < slowlog_size) {
+			SlowLogItem *item = _SlowLogItem_New(cmd, query, body_offset, stats);
+			shard->items = array_append(shard->items, item);
+			raxInsert(shard->lookup, (unsigned char *)key, key_len, item, NULL);
+			if(item->stats.latency < shard->items[shard->fastest]->stats.latency) {
+				shard->fastest = count;
 			}
-		}
-
-		if(introduce_item) {
-			SlowLogItem *item = _SlowLogItem_New(cmd, query, latency);
-			heap_offer(slowlog->min_heap + t_id, item);
-			raxInsert(lookup, (unsigned char *)key, key_len, item, NULL);
+		} else if(shard->items[shard->fastest]->stats.latency < stats->latency) {
+			// Not enough room, evict the fastest item.
+			SlowLogItem *item = _SlowLogItem_New(cmd, query, body_offset, stats);
+			_SlowLogShard_Replace(shard, shard->fastest, item);
+			raxInsert(shard->lookup, (unsigned char *)key, key_len, item, NULL);
+			_SlowLogShard_UpdateFastest(shard);
 		}
 	}   // End of critical section.
 cleanup:
-	assert(pthread_mutex_unlock(lock) == 0);
+	int res = pthread_mutex_unlock(&shard->lock);
+	assert(res == 0);
 	free(key);
 }
 
-void SlowLog_Replay(const SlowLog *slowlog, RedisModuleCtx *ctx) {
-	SlowLog *aggregated_slowlog = SlowLog_New();
-	int my_t_id = get_thread_id();
+#define SLOWER(a, b) ((*a)->stats.latency > (*b)->stats.latency)
 
-	for(int t_id = 0; t_id < slowlog->count; t_id++) {
-		// Don't lock ourselves.
-		if(my_t_id != t_id) pthread_mutex_lock(slowlog->locks + t_id);
+void SlowLog_Replay(const SlowLog *slowlog, RedisModuleCtx *ctx) {
+	/* Reference the items of every shard, shards are locked one at a time
+	 * and only while their items are referenced, items are immutable. */
+	SlowLogItem **items = array_new(SlowLogItem *, slowlog_size);
+	for(uint t_id = 0; t_id < slowlog->count; t_id++) {
+		SlowLogShard *shard = slowlog->shards + t_id;
+		pthread_mutex_lock(&shard->lock);
 		{
 			// Critical section.
-			rax *lookup = slowlog->lookup[t_id];
-			raxIterator iter;
-			raxStart(&iter, lookup);
-			raxSeek(&iter, "^", NULL, 0);
-			while(raxNext(&iter)) {
-				SlowLogItem *item = iter.data;
-				SlowLog_Add(aggregated_slowlog, item->cmd, item->query, item->latency);
+			uint count = array_len(shard->items);
+			for(uint i = 0; i < count; i++) {
+				items = array_append(items, _SlowLogItem_Retain(shard->items[i]));
 			}
-			raxStop(&iter);
 			// End of critical section.
 		}
-		if(my_t_id != t_id) pthread_mutex_unlock(slowlog->locks + t_id);
+		pthread_mutex_unlock(&shard->lock);
 	}
 
-	heap_t *heap = aggregated_slowlog->min_heap[my_t_id];
-	RedisModule_ReplyWithArray(ctx, heap_count(heap));
-
-	while(heap_count(heap)) {
-		SlowLogItem *item = heap_poll(heap);
-		RedisModule_ReplyWithArray(ctx, 4);
+	// Report the slowest execution of each query among all shards.
+	uint count = array_len(items);
+	QSORT(SlowLogItem *, items, count, SLOWER);
+
+	uint reported = 0;
+	rax *seen = raxNew();
+	for(uint i = 0; i < count; i++) {
+		char *key;
+		size_t key_len = _SlowLogItem_ToString(items[i], &key);
+		bool first = raxTryInsert(seen, (unsigned char *)key, key_len, NULL, NULL);
+		free(key);
+		if(first && reported < slowlog_size) items[reported++] = items[i];
+		else _SlowLogItem_Release(items[i]);
+	}
+	raxFree(seen);
+
+	RedisModule_ReplyWithArray(ctx, reported);
+	for(uint i = 0; i < reported; i++) {
+		SlowLogItem *item = items[i];
+		// Execution is the remainder of the latency, parsing and planning included.
+		const SlowLogStats *stats = &item->stats;
+		double execution = stats->latency - stats->lock_wait - stats->matrix_sync - stats->reply;
+		RedisModule_ReplyWithArray(ctx, 13);
 		RedisModule_ReplyWithDouble(ctx, item->time);
 		RedisModule_ReplyWithStringBuffer(ctx, (const char *)item->cmd, strlen(item->cmd));
 		RedisModule_ReplyWithStringBuffer(ctx, (const char *)item->query, strlen(item->query));
-		_ReplyWithRoundedDouble(ctx, item->latency);
+		_ReplyWithRoundedDouble(ctx, item->stats.latency);
+		RedisModule_ReplyWithLongLong(ctx, item->stats.peak_memory);
+		_ReplyWithRoundedDouble(ctx, item->stats.lock_wait);
+		RedisModule_ReplyWithLongLong(ctx, item->stats.rows);
+		_ReplyWithHash(ctx, item->params_hash);
+		_ReplyWithHash(ctx, item->stats.plan_fingerprint);
+		_ReplyWithRoundedDouble(ctx, stats->queue_wait);
+		_ReplyWithRoundedDouble(ctx, stats->matrix_sync);
+		_ReplyWithRoundedDouble(ctx, (execution > 0) ? execution : 0);
+		_ReplyWithRoundedDouble(ctx, stats->reply);
+		_SlowLogItem_Release(item);
 	}
 
-	SlowLog_Free(aggregated_slowlog);
+	array_free(items);
 }
 
 void SlowLog_Free(SlowLog *slowlog) {
 	for(int i = 0; i < slowlog->count; i++) {
-		rax *lookup = slowlog->lookup[i];
-		heap_t *heap = slowlog->min_heap[i];
-
-		raxIterator iter;
-		raxStart(&iter, lookup);
-		raxSeek(&iter, "^", NULL, 0);
-		while(raxNext(&iter)) {
-			SlowLogItem *item = iter.data;
-			_SlowLog_Item_Free(item);
-		}
-		raxStop(&iter);
-
-		raxFree(lookup);
-		heap_free(heap);
-		assert(pthread_mutex_destroy(slowlog->locks + i) == 0);
+		SlowLogShard *shard = slowlog->shards + i;
+		uint count = array_len(shard->items);
+		for(uint j = 0; j < count; j++) _SlowLogItem_Release(shard->items[j]);
+		array_free(shard->items);
+		raxFree(shard->lookup);
+		int res = pthread_mutex_destroy(&shard->lock);
+		assert(res == 0);
 	}
 
-	rm_free(slowlog->locks);
-	rm_free(slowlog->lookup);
-	rm_free(slowlog->min_heap);
+	rm_free(slowlog->shards);
 	rm_free(slowlog);
 }
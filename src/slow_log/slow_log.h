@@ -6,35 +6,63 @@
 
 #pragma once
 
-#define SLOW_LOG_SIZE 10
-
 #include <pthread.h>
+#include <stdint.h>
+#include <stdbool.h>
 
-#include "../util/heap.h"
 #include "../redismodule.h"
 #include "../../deps/rax/rax.h"
 
-// Slowlog item.
+// Measurements of a single query execution.
+typedef struct {
+	double latency;             // How much time query was processed, in milliseconds.
+	double lock_wait;           // Time spent waiting for locks, in milliseconds.
+	double queue_wait;          // Time spent queued before processing began, in milliseconds.
+	double matrix_sync;         // Time spent synchronizing the graph's matrices, in milliseconds.
+	double reply;               // Time spent replying with the results, in milliseconds.
+	uint64_t rows;              // Number of records replied with.
+	uint64_t plan_fingerprint;  // Fingerprint of the executed plan, 0 if no plan was executed.
+	size_t peak_memory;         // Maximum number of bytes the query had allocated at once.
+} SlowLogStats;
+
+/* Slowlog item, describing the slowest execution of a query body.
+ * Items are immutable once logged and shared with readers by reference. */
 typedef struct {
-    char *cmd;          // Redis command.
-    time_t time;        // Item creation time.
-	char *query;        // Query.
-	double latency;     // How much time query was processed.
+	char *cmd;              // Redis command.
+	char *query;            // Query, parameters included.
+	size_t body_offset;     // Offset of the query body, past its parameters.
+	time_t time;            // Item creation time.
+	uint64_t params_hash;   // Hash of the query's parameters, 0 if it has none.
+	SlowLogStats stats;     // Measurements of the execution.
+	uint refcount;          // Number of holders of the item.
 } SlowLogItem;
 
-// Slowlog, maintains N slowest queries.
+// Items logged by a single thread.
 typedef struct {
-     uint count;                // Length of lookup, min_heap and locks arrays.
-     rax **lookup;              // Array of item lookup table.
-     heap_t **min_heap;         // Array of minimum heap of items.
-     pthread_mutex_t *locks;    // Array of locks.
+	rax *lookup;            // Items keyed by command and query body.
+	SlowLogItem **items;    // Logged items.
+	uint fastest;           // Position of the item with the lowest latency.
+	pthread_mutex_t lock;   // Guards the shard against concurrent readers.
+} SlowLogShard;
+
+/* Slowlog, maintains the N slowest queries, N is set by the SLOWLOG_SIZE
+ * configuration parameter. Each thread logs to a shard of its own,
+ * such that writers contend only with readers, which hold a shard's
+ * lock just long enough to reference its items. */
+typedef struct {
+	uint count;             // Number of shards.
+	SlowLogShard *shards;   // Shard per thread, Redis main thread included.
 } SlowLog;
 
 // Create a new slowlog.
 SlowLog *SlowLog_New();
 
-// Introduce item to slow log.
-void SlowLog_Add(SlowLog *slowlog, const char *cmd, const char *query, double latency);
+// Returns true if a query executed in latency milliseconds is considered for logging.
+bool SlowLog_Considers(double latency);
+
+/* Introduce item to slow log, executions of the same command and query body,
+ * parameters aside, share a single item describing the slowest one. */
+void SlowLog_Add(SlowLog *slowlog, const char *cmd, const char *query, const SlowLogStats *stats);
 
 // Replies with slow log content.
 void SlowLog_Replay(const SlowLog *slowlog, RedisModuleCtx *ctx);
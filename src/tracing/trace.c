@@ -0,0 +1,221 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "trace.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include <time.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+extern long long trace_buffer_size; // Number of spans retained until drained.
+
+/* Spans published by traced queries, drained by a collector.
+ * Once full, publishing a span overwrites the oldest one. */
+typedef struct {
+	TraceSpan *spans;       // Circular buffer of trace_buffer_size spans.
+	uint64_t head;          // Number of spans ever published.
+	uint64_t tail;          // Number of spans ever drained or overwritten.
+	uint64_t dropped;       // Number of spans overwritten before being drained.
+	pthread_mutex_t lock;   // Guards the buffer.
+} SpanBuffer;
+
+static SpanBuffer *_buffer = NULL;
+static uint64_t _span_seq = 0;   // Sequence from which span IDs are derived.
+
+void Trace_Init(void) {
+	if(trace_buffer_size == 0) return;
+	_buffer = rm_calloc(1, sizeof(SpanBuffer));
+	_buffer->spans = rm_malloc(sizeof(TraceSpan) * trace_buffer_size);
+	int res = pthread_mutex_init(&_buffer->lock, NULL);
+	assert(res == 0);
+	// Span IDs of different server runs shouldn't collide.
+	_span_seq = (uint64_t)time(NULL) << 32;
+}
+
+// Derive a unique, non-zero, span ID from a sequence number (splitmix64 finalizer).
+static uint64_t _NewSpanID(void) {
+	uint64_t x = __atomic_add_fetch(&_span_seq, 1, __ATOMIC_RELAXED);
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return (x) ? x : 1;
+}
+
+// Returns true if the first len characters of s are lowercase or uppercase hex digits, not all 0.
+static bool _valid_hex(const char *s, size_t len) {
+	bool zero = true;
+	for(size_t i = 0; i < len; i++) {
+		if(!isxdigit((unsigned char)s[i])) return false;
+		if(s[i] != '0') zero = false;
+	}
+	return !zero;
+}
+
+Trace *Trace_New(const char *trace_context, bool *valid) {
+	*valid = true;
+	if(_buffer == NULL) return NULL;
+
+	const char *trace_id = trace_context;
+	uint64_t parent_id = 0;
+	size_t len = strlen(trace_context);
+	if(len == 55 && trace_context[2] == '-' && trace_context[35] == '-' && trace_context[52] == '-') {
+		// W3C traceparent: version-trace_id-parent_id-flags.
+		trace_id = trace_context + 3;
+		if(!_valid_hex(trace_context + 36, 16)) {
+			*valid = false;
+			return NULL;
+		}
+		char parent[17];
+		memcpy(parent, trace_context + 36, 16);
+		parent[16] = '\0';
+		parent_id = strtoull(parent, NULL, 16);
+	} else if(len != TRACE_ID_LEN) {
+		*valid = false;
+		return NULL;
+	}
+
+	if(!_valid_hex(trace_id, TRACE_ID_LEN)) {
+		*valid = false;
+		return NULL;
+	}
+
+	Trace *trace = rm_malloc(sizeof(Trace));
+	for(int i = 0; i < TRACE_ID_LEN; i++) trace->trace_id[i] = tolower((unsigned char)trace_id[i]);
+	trace->trace_id[TRACE_ID_LEN] = '\0';
+	trace->parent_id = parent_id;
+	trace->root_id = _NewSpanID();
+	trace->start = Trace_Now(trace);
+	trace->spans = array_new(TraceSpan, 16);
+	return trace;
+}
+
+int64_t Trace_Now(const Trace *trace) {
+	if(trace == NULL) return 0;
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint64_t Trace_Root(const Trace *trace) {
+	return (trace) ? trace->root_id : 0;
+}
+
+static uint64_t _Trace_AddSpan(Trace *trace, uint64_t span_id, const char *name,
+							   uint64_t parent_id, int64_t start, double duration, uint64_t records) {
+	TraceSpan span = {
+		.span_id = span_id,
+		.parent_id = parent_id,
+		.name = name,
+		.start = start,
+		.duration = duration,
+		.records = records
+	};
+	memcpy(span.trace_id, trace->trace_id, sizeof(span.trace_id));
+	trace->spans = array_append(trace->spans, span);
+	return span_id;
+}
+
+uint64_t Trace_AddSpan(Trace *trace, const char *name, uint64_t parent_id, int64_t start,
+					   double duration, uint64_t records) {
+	if(trace == NULL) return 0;
+	return _Trace_AddSpan(trace, _NewSpanID(), name, parent_id, start, duration, records);
+}
+
+uint64_t Trace_EndSpan(Trace *trace, const char *name, uint64_t parent_id, int64_t start,
+					   uint64_t records) {
+	if(trace == NULL) return 0;
+	double duration = (double)(Trace_Now(trace) - start) / 1000;
+	return Trace_AddSpan(trace, name, parent_id, start, duration, records);
+}
+
+void Trace_Publish(Trace *trace, uint64_t records) {
+	if(trace == NULL) return;
+	double duration = (double)(Trace_Now(trace) - trace->start) / 1000;
+	_Trace_AddSpan(trace, trace->root_id, "query", trace->parent_id, trace->start, duration, records);
+
+	uint count = array_len(trace->spans);
+	pthread_mutex_lock(&_buffer->lock);
+	{
+		// Critical section.
+		for(uint i = 0; i < count; i++) {
+			if(_buffer->head - _buffer->tail == (uint64_t)trace_buffer_size) {
+				// Buffer is full, overwrite the oldest span.
+				_buffer->tail++;
+				_buffer->dropped++;
+			}
+			_buffer->spans[_buffer->head++ % trace_buffer_size] = trace->spans[i];
+		}
+		// End of critical section.
+	}
+	pthread_mutex_unlock(&_buffer->lock);
+
+	array_free(trace->spans);
+	rm_free(trace);
+}
+
+// Span IDs are replied as hex strings, as they don't fit within a signed integer.
+static inline void _ReplyWithSpanID(RedisModuleCtx *ctx, uint64_t id) {
+	char str[17];
+	int len = snprintf(str, sizeof(str), "%016llx", (unsigned long long)id);
+	RedisModule_ReplyWithStringBuffer(ctx, str, len);
+}
+
+void Trace_Drain(RedisModuleCtx *ctx, uint64_t count) {
+	if(_buffer == NULL) {
+		RedisModule_ReplyWithArray(ctx, 0);
+		return;
+	}
+
+	// Copy the drained spans, replying while holding the lock would block publishers.
+	pthread_mutex_lock(&_buffer->lock);
+	uint64_t buffered = _buffer->head - _buffer->tail;
+	if(count == 0 || count > buffered) count = buffered;
+	TraceSpan *spans = rm_malloc(sizeof(TraceSpan) * (count + 1));
+	for(uint64_t i = 0; i < count; i++) {
+		spans[i] = _buffer->spans[_buffer->tail++ % trace_buffer_size];
+	}
+	pthread_mutex_unlock(&_buffer->lock);
+
+	RedisModule_ReplyWithArray(ctx, count);
+	for(uint64_t i = 0; i < count; i++) {
+		TraceSpan *span = spans + i;
+		char duration[32];
+		int duration_len = snprintf(duration, sizeof(duration), "%.3f", span->duration);
+		RedisModule_ReplyWithArray(ctx, 7);
+		RedisModule_ReplyWithStringBuffer(ctx, span->trace_id, TRACE_ID_LEN);
+		_ReplyWithSpanID(ctx, span->span_id);
+		if(span->parent_id) _ReplyWithSpanID(ctx, span->parent_id);
+		else RedisModule_ReplyWithNull(ctx);
+		RedisModule_ReplyWithStringBuffer(ctx, span->name, strlen(span->name));
+		RedisModule_ReplyWithLongLong(ctx, span->start);
+		RedisModule_ReplyWithStringBuffer(ctx, duration, duration_len);
+		RedisModule_ReplyWithLongLong(ctx, span->records);
+	}
+	rm_free(spans);
+}
+
+void Trace_ReplyStats(RedisModuleCtx *ctx) {
+	uint64_t buffered = 0;
+	uint64_t dropped = 0;
+	if(_buffer) {
+		pthread_mutex_lock(&_buffer->lock);
+		buffered = _buffer->head - _buffer->tail;
+		dropped = _buffer->dropped;
+		pthread_mutex_unlock(&_buffer->lock);
+	}
+
+	RedisModule_ReplyWithArray(ctx, 6);
+	RedisModule_ReplyWithSimpleString(ctx, "capacity");
+	RedisModule_ReplyWithLongLong(ctx, trace_buffer_size);
+	RedisModule_ReplyWithSimpleString(ctx, "buffered");
+	RedisModule_ReplyWithLongLong(ctx, buffered);
+	RedisModule_ReplyWithSimpleString(ctx, "dropped");
+	RedisModule_ReplyWithLongLong(ctx, dropped);
+}
@@ -0,0 +1,72 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../redismodule.h"
+
+// Number of hex digits in a trace ID, as in W3C trace context.
+#define TRACE_ID_LEN 32
+
+/* A timed phase of a traced query, modeled after OpenTelemetry spans.
+ * Span names are static strings. */
+typedef struct {
+	char trace_id[TRACE_ID_LEN + 1];    // Trace the span belongs to, lowercase hex.
+	uint64_t span_id;                   // Span ID, unique within the trace.
+	uint64_t parent_id;                 // Parent span ID, 0 if the span is a root span.
+	const char *name;                   // Phase name.
+	int64_t start;                      // Start time, microseconds since the Unix epoch.
+	double duration;                    // Duration in milliseconds.
+	uint64_t records;                   // Number of records produced, 0 if not applicable.
+} TraceSpan;
+
+/* Spans of a single query, spans are collected privately by the query
+ * and published to the module's span buffer once the query completes. */
+typedef struct {
+	char trace_id[TRACE_ID_LEN + 1];    // Trace ID passed along with the query.
+	uint64_t parent_id;                 // Caller's span, parent of the query's root span.
+	uint64_t root_id;                   // The query's root span.
+	int64_t start;                      // Query start time.
+	TraceSpan *spans;                   // Collected spans.
+} Trace;
+
+/* Allocate the module's span buffer, retaining up to TRACE_BUFFER_SIZE spans.
+ * Tracing is disabled if the buffer size is 0. */
+void Trace_Init(void);
+
+/* Begin tracing a query, trace_context is either a 32 hex digit trace ID
+ * or a W3C traceparent header, "00-<trace ID>-<parent span ID>-<flags>".
+ * Returns NULL if tracing is disabled or the context is invalid, in which case
+ * valid is set to false. */
+Trace *Trace_New(const char *trace_context, bool *valid);
+
+// Returns the current time in microseconds since the Unix epoch, 0 if trace is NULL.
+int64_t Trace_Now(const Trace *trace);
+
+// Returns the ID of the query's root span, 0 if trace is NULL.
+uint64_t Trace_Root(const Trace *trace);
+
+/* Record a span of trace which began at start and lasted duration milliseconds,
+ * returns the span's ID. A NULL trace records nothing. */
+uint64_t Trace_AddSpan(Trace *trace, const char *name, uint64_t parent_id, int64_t start,
+					   double duration, uint64_t records);
+
+// Record a span of trace which began at start, measured with Trace_Now, and ends now.
+uint64_t Trace_EndSpan(Trace *trace, const char *name, uint64_t parent_id, int64_t start,
+					   uint64_t records);
+
+/* End the query's root span, publish the trace's spans to the span buffer
+ * and free the trace. */
+void Trace_Publish(Trace *trace, uint64_t records);
+
+/* Reply with, and remove, up to count of the oldest buffered spans,
+ * all buffered spans if count is 0. */
+void Trace_Drain(RedisModuleCtx *ctx, uint64_t count);
+
+// Reply with the span buffer's capacity, number of buffered spans and number of dropped spans.
+void Trace_ReplyStats(RedisModuleCtx *ctx);
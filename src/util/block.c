@@ -5,13 +5,18 @@
  */
 
 #include "block.h"
+#include "numa.h"
 #include "rmalloc.h"
 #include <assert.h>
 
 Block *Block_New(uint itemSize, uint capacity) {
 	assert(itemSize > 0);
-	Block *block = rm_calloc(1, sizeof(Block) + (capacity * itemSize));
+	size_t size = sizeof(Block) + ((size_t)capacity * itemSize);
+	Block *block = rm_calloc(1, size);
+	// Spread large blocks across NUMA nodes, as they're scanned by all threads.
+	NUMA_Interleave(block, size);
 	block->itemSize = itemSize;
+	block->capacity = capacity;
 	return block;
 }
 
@@ -13,6 +13,7 @@
  * Each block has a next pointer to another block, or NULL if this is the last block. */
 typedef struct Block {
 	size_t itemSize;        // Size of a single item in bytes.
+	uint capacity;          // Number of items block can hold.
 	struct Block *next;     // Pointer to next block.
 	unsigned char data[];   // Item array. MUST BE LAST MEMBER OF THE STRUCT!
 } Block;
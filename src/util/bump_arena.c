@@ -0,0 +1,63 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "bump_arena.h"
+#include "rmalloc.h"
+
+#define BUMP_ARENA_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+struct BumpArenaBlock {
+	BumpArenaBlock *next;   // Previously allocated block.
+	size_t used;            // Bytes served from this block.
+	size_t cap;             // Capacity of data.
+	char data[];            // Served allocations.
+};
+
+BumpArena *BumpArena_New(size_t limit) {
+	BumpArena *arena = rm_malloc(sizeof(BumpArena));
+	arena->blocks = NULL;
+	arena->size = 0;
+	arena->limit = limit;
+	return arena;
+}
+
+void *BumpArena_Alloc(BumpArena *arena, size_t size) {
+	size = BUMP_ARENA_ALIGN(size);
+	BumpArenaBlock *block = arena->blocks;
+
+	if(block == NULL || block->cap - block->used < size) {
+		size_t cap = (size > BUMP_ARENA_BLOCK_SIZE) ? size : BUMP_ARENA_BLOCK_SIZE;
+		if(arena->size + cap > arena->limit) return NULL;
+
+		block = rm_malloc(sizeof(BumpArenaBlock) + cap);
+		block->used = 0;
+		block->cap = cap;
+		arena->size += cap;
+
+		if(cap > BUMP_ARENA_BLOCK_SIZE && arena->blocks) {
+			// Keep serving from the current block, which may have room left.
+			block->next = arena->blocks->next;
+			arena->blocks->next = block;
+		} else {
+			block->next = arena->blocks;
+			arena->blocks = block;
+		}
+	}
+
+	void *ptr = block->data + block->used;
+	block->used += size;
+	return ptr;
+}
+
+void BumpArena_Free(BumpArena *arena) {
+	BumpArenaBlock *block = arena->blocks;
+	while(block) {
+		BumpArenaBlock *next = block->next;
+		rm_free(block);
+		block = next;
+	}
+	rm_free(arena);
+}
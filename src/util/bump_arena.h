@@ -0,0 +1,33 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stddef.h>
+
+// Size of the blocks allocations are carved from, larger allocations get a block of their own.
+#define BUMP_ARENA_BLOCK_SIZE 65536
+
+typedef struct BumpArenaBlock BumpArenaBlock;
+
+/* A bump arena serves allocations by advancing through large blocks,
+ * allocations are never freed individually, the entire arena is released at once.
+ * This suits short lived values sharing a common lifetime, e.g. a query. */
+typedef struct {
+	BumpArenaBlock *blocks;  // Allocated blocks, the current block first.
+	size_t size;             // Total size of allocated blocks.
+	size_t limit;            // Maximum total size of blocks.
+} BumpArena;
+
+// Create a new arena whose blocks won't exceed limit bytes.
+BumpArena *BumpArena_New(size_t limit);
+
+/* Allocate size bytes, aligned to 8 bytes.
+ * Returns NULL if the allocation would exceed the arena's limit. */
+void *BumpArena_Alloc(BumpArena *arena, size_t size);
+
+// Free arena and every allocation it served.
+void BumpArena_Free(BumpArena *arena);
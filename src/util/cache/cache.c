@@ -0,0 +1,161 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cache.h"
+#include "../rmalloc.h"
+#include <string.h>
+#include <assert.h>
+
+// Detach entry from the usage list.
+static void _Cache_Unlink(Cache *cache, CacheEntry *entry) {
+	if(entry->prev) entry->prev->next = entry->next;
+	else cache->head = entry->next;
+	if(entry->next) entry->next->prev = entry->prev;
+	else cache->tail = entry->prev;
+	entry->prev = NULL;
+	entry->next = NULL;
+}
+
+// Place entry at the head of the usage list, marking it as most recently used.
+static void _Cache_PushFront(Cache *cache, CacheEntry *entry) {
+	entry->prev = NULL;
+	entry->next = cache->head;
+	if(cache->head) cache->head->prev = entry;
+	cache->head = entry;
+	if(cache->tail == NULL) cache->tail = entry;
+}
+
+// Remove entry from the cache and release its value.
+static void _Cache_RemoveEntry(Cache *cache, CacheEntry *entry) {
+	_Cache_Unlink(cache, entry);
+	raxRemove(cache->lookup, entry->key, entry->key_len, NULL);
+	cache->bytes -= entry->size;
+	cache->free_value(entry->value);
+	rm_free(entry->key);
+	rm_free(entry);
+}
+
+Cache *Cache_New(uint cap, CacheValueRefFunc ref_value, CacheValueFreeFunc free_value) {
+	assert(cap > 0 && ref_value && free_value);
+
+	Cache *cache = rm_malloc(sizeof(Cache));
+	cache->cap = cap;
+	cache->bytes = 0;
+	cache->max_bytes = 0;
+	cache->lookup = raxNew();
+	cache->head = NULL;
+	cache->tail = NULL;
+	cache->ref_value = ref_value;
+	cache->free_value = free_value;
+	cache->hits = 0;
+	cache->misses = 0;
+	cache->evictions = 0;
+	int res = pthread_mutex_init(&cache->lock, NULL);
+	assert(res == 0);
+	return cache;
+}
+
+void *Cache_GetValue(Cache *cache, const char *key, size_t key_len) {
+	void *value = NULL;
+
+	pthread_mutex_lock(&cache->lock);
+	CacheEntry *entry = raxFind(cache->lookup, (unsigned char *)key, key_len);
+	if(entry != raxNotFound) {
+		cache->hits++;
+		// Mark entry as most recently used.
+		_Cache_Unlink(cache, entry);
+		_Cache_PushFront(cache, entry);
+		// Reference is acquired under lock, the entry might be evicted right after.
+		value = cache->ref_value(entry->value);
+	} else {
+		cache->misses++;
+	}
+	pthread_mutex_unlock(&cache->lock);
+
+	return value;
+}
+
+void Cache_SetValue(Cache *cache, const char *key, size_t key_len, void *value) {
+	Cache_SetSizedValue(cache, key, key_len, value, 0);
+}
+
+void Cache_SetSizedValue(Cache *cache, const char *key, size_t key_len, void *value,
+						 size_t size) {
+	pthread_mutex_lock(&cache->lock);
+
+	// Key is already cached, keep the existing value.
+	if(raxFind(cache->lookup, (unsigned char *)key, key_len) != raxNotFound) goto cleanup;
+	if(cache->max_bytes > 0 && size > cache->max_bytes) goto cleanup;
+
+	// Make room for the new entry.
+	while(cache->tail && (raxSize(cache->lookup) >= cache->cap ||
+						  (cache->max_bytes > 0 && cache->bytes + size > cache->max_bytes))) {
+		_Cache_RemoveEntry(cache, cache->tail);
+		cache->evictions++;
+	}
+
+	CacheEntry *entry = rm_malloc(sizeof(CacheEntry));
+	entry->key = rm_malloc(key_len);
+	memcpy(entry->key, key, key_len);
+	entry->key_len = key_len;
+	entry->size = size;
+	cache->bytes += size;
+	entry->value = cache->ref_value(value);
+	raxInsert(cache->lookup, entry->key, key_len, entry, NULL);
+	_Cache_PushFront(cache, entry);
+
+cleanup:
+	pthread_mutex_unlock(&cache->lock);
+}
+
+void Cache_SetMaxBytes(Cache *cache, size_t max_bytes) {
+	pthread_mutex_lock(&cache->lock);
+	cache->max_bytes = max_bytes;
+	pthread_mutex_unlock(&cache->lock);
+}
+
+bool Cache_RemoveValue(Cache *cache, const char *key, size_t key_len) {
+	pthread_mutex_lock(&cache->lock);
+	CacheEntry *entry = raxFind(cache->lookup, (unsigned char *)key, key_len);
+	bool found = (entry != raxNotFound);
+	if(found) _Cache_RemoveEntry(cache, entry);
+	pthread_mutex_unlock(&cache->lock);
+	return found;
+}
+
+uint Cache_Size(Cache *cache) {
+	pthread_mutex_lock(&cache->lock);
+	uint size = raxSize(cache->lookup);
+	pthread_mutex_unlock(&cache->lock);
+	return size;
+}
+
+CacheStats Cache_GetStats(Cache *cache) {
+	pthread_mutex_lock(&cache->lock);
+	CacheStats stats = {
+		.size = raxSize(cache->lookup),
+		.hits = cache->hits,
+		.misses = cache->misses,
+		.evictions = cache->evictions,
+		.bytes = cache->bytes
+	};
+	pthread_mutex_unlock(&cache->lock);
+	return stats;
+}
+
+void Cache_Clear(Cache *cache) {
+	pthread_mutex_lock(&cache->lock);
+	while(cache->head) _Cache_RemoveEntry(cache, cache->head);
+	pthread_mutex_unlock(&cache->lock);
+}
+
+void Cache_Free(Cache *cache) {
+	if(cache == NULL) return;
+	Cache_Clear(cache);
+	raxFree(cache->lookup);
+	pthread_mutex_destroy(&cache->lock);
+	rm_free(cache);
+}
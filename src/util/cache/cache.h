@@ -0,0 +1,93 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "rax.h"
+#include <stdint.h>
+#include <sys/types.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+// Acquires a reference to a cached value, returning the reference handed to the caller.
+typedef void *(*CacheValueRefFunc)(void *value);
+// Releases a reference to a cached value.
+typedef void (*CacheValueFreeFunc)(void *value);
+
+typedef struct CacheEntry CacheEntry;
+
+// Cache usage counters.
+typedef struct {
+	uint size;              // Number of cached entries.
+	uint64_t hits;          // Number of successful lookups.
+	uint64_t misses;        // Number of failed lookups.
+	uint64_t evictions;     // Number of evicted entries.
+	size_t bytes;           // Memory footprint of the cached values, 0 for values cached without a size.
+} CacheStats;
+
+struct CacheEntry {
+	unsigned char *key;     // Entry key.
+	size_t key_len;         // Key length in bytes.
+	size_t size;            // Memory footprint of the value, as reported when it was cached.
+	void *value;            // Reference to the cached value.
+	CacheEntry *prev;       // More recently used entry.
+	CacheEntry *next;       // Less recently used entry.
+};
+
+/* Thread-safe, fixed capacity cache with least recently used eviction.
+ * Values are reference counted by the caller supplied callbacks, the cache holds
+ * a single reference to each value and hands out additional references on lookup.
+ * The cache may also be bounded by the memory footprint of its values. */
+typedef struct {
+	uint cap;                       // Maximum number of entries.
+	size_t bytes;                   // Memory footprint of the cached values.
+	size_t max_bytes;               // Maximum memory footprint of the cached values, 0 for unbounded.
+	rax *lookup;                    // Mapping between keys and entries.
+	CacheEntry *head;               // Most recently used entry.
+	CacheEntry *tail;               // Least recently used entry.
+	CacheValueRefFunc ref_value;    // Acquires a reference to a value.
+	CacheValueFreeFunc free_value;  // Releases a reference to a value.
+	uint64_t hits;                  // Number of successful lookups.
+	uint64_t misses;                // Number of failed lookups.
+	uint64_t evictions;             // Number of entries evicted to make room for new ones.
+	pthread_mutex_t lock;           // Guards all cache state.
+} Cache;
+
+// Create a new cache holding up to cap entries.
+Cache *Cache_New(uint cap, CacheValueRefFunc ref_value, CacheValueFreeFunc free_value);
+
+/* Retrieve the value associated with key, NULL if key is not cached.
+ * The returned value is a new reference which must be released by the caller. */
+void *Cache_GetValue(Cache *cache, const char *key, size_t key_len);
+
+/* Associate value with key, evicting the least recently used entry if the cache is full.
+ * The cache acquires its own reference to value, if key is already cached
+ * the existing value is retained. */
+void Cache_SetValue(Cache *cache, const char *key, size_t key_len, void *value);
+
+/* Associate value with key, accounting for size bytes of memory,
+ * evicting least recently used entries until both the entry count and
+ * the memory footprint fit. Values larger than the memory bound aren't cached. */
+void Cache_SetSizedValue(Cache *cache, const char *key, size_t key_len, void *value,
+						 size_t size);
+
+// Bound the memory footprint of the cached values, 0 for unbounded.
+void Cache_SetMaxBytes(Cache *cache, size_t max_bytes);
+
+// Remove key from the cache, releasing its value, returns false if key is not cached.
+bool Cache_RemoveValue(Cache *cache, const char *key, size_t key_len);
+
+// Retrieve the number of cached entries.
+uint Cache_Size(Cache *cache);
+
+// Retrieve a snapshot of the cache usage counters.
+CacheStats Cache_GetStats(Cache *cache);
+
+// Remove all entries from the cache, releasing their values.
+void Cache_Clear(Cache *cache);
+
+// Free cache and release all cached values.
+void Cache_Free(Cache *cache);
@@ -0,0 +1,46 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cms.h"
+#include "rmalloc.h"
+
+/* Column of hash in row, each row is indexed by a distinct 16 bit slice of the hash
+ * such that rows are independent of each other. */
+static inline uint32_t _Column(uint64_t hash, uint32_t row) {
+	return (hash >> (row * 16)) & (CMS_WIDTH - 1);
+}
+
+CMS *CMS_New(void) {
+	return rm_calloc(1, sizeof(CMS));
+}
+
+uint64_t CMS_Add(CMS *cms, uint64_t hash, uint64_t count) {
+	uint64_t estimate = UINT64_MAX;
+	for(uint32_t row = 0; row < CMS_DEPTH; row++) {
+		uint64_t c = __atomic_add_fetch(&cms->counters[row][_Column(hash, row)], count,
+										__ATOMIC_RELAXED);
+		if(c < estimate) estimate = c;
+	}
+	__atomic_fetch_add(&cms->total, count, __ATOMIC_RELAXED);
+	return estimate;
+}
+
+uint64_t CMS_Estimate(const CMS *cms, uint64_t hash) {
+	uint64_t estimate = UINT64_MAX;
+	for(uint32_t row = 0; row < CMS_DEPTH; row++) {
+		uint64_t c = __atomic_load_n(&cms->counters[row][_Column(hash, row)], __ATOMIC_RELAXED);
+		if(c < estimate) estimate = c;
+	}
+	return estimate;
+}
+
+uint64_t CMS_Total(const CMS *cms) {
+	return __atomic_load_n(&cms->total, __ATOMIC_RELAXED);
+}
+
+void CMS_Free(CMS *cms) {
+	rm_free(cms);
+}
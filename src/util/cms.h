@@ -0,0 +1,39 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// Number of rows, each hashing items independently.
+#define CMS_DEPTH 4
+// Number of counters per row, a power of 2 of at most 2^16.
+#define CMS_WIDTH 1024
+
+/* Count-min sketch estimates how often items were added to it within fixed memory.
+ * Estimates never undercount, and overcount by at most e / CMS_WIDTH of the total count
+ * with probability 1 - e^-CMS_DEPTH.
+ * Items are added by their 64 bit hash codes, which must be uniformly distributed.
+ * Counters are updated atomically, so items may be added concurrently. */
+typedef struct {
+	uint64_t total;                             // Sum of all increments.
+	uint64_t counters[CMS_DEPTH][CMS_WIDTH];    // Per row counters.
+} CMS;
+
+// Create a new, empty, sketch.
+CMS *CMS_New(void);
+
+// Add count occurrences of an item by its hash code, returns the item's updated estimate.
+uint64_t CMS_Add(CMS *cms, uint64_t hash, uint64_t count);
+
+// Estimate the number of occurrences of an item.
+uint64_t CMS_Estimate(const CMS *cms, uint64_t hash);
+
+// Returns the number of occurrences of all items added.
+uint64_t CMS_Total(const CMS *cms);
+
+// Free sketch.
+void CMS_Free(CMS *cms);
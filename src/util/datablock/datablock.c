@@ -8,25 +8,69 @@
 #include "datablock_iterator.h"
 #include "../arr.h"
 #include "../rmalloc.h"
-#include <math.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <string.h>
 
-// Computes the number of blocks required to accommodate n items.
-#define ITEM_COUNT_TO_BLOCK_COUNT(n) \
-    ceil((double)n / DATABLOCK_BLOCK_CAP)
+// Returns the position of the most significant set bit of n.
+#define MSB_POSITION(n) (63 - __builtin_clzll(n))
+
+/* Blocks 1 to DataBlock_GrowthBlocks are of geometrically increasing capacity,
+ * the last of which holds DATABLOCK_MAX_BLOCK_CAP items. */
+static inline uint _DataBlock_GrowthBlocks(const DataBlock *dataBlock) {
+	return __builtin_ctzll(DATABLOCK_MAX_BLOCK_CAP) - __builtin_ctzll(dataBlock->blockCap) + 1;
+}
+
+// Computes the capacity of the block at position blockIdx.
+static uint64_t _DataBlock_BlockCap(const DataBlock *dataBlock, uint blockIdx) {
+	if(blockIdx == 0) return dataBlock->blockCap;
+	if(blockIdx <= _DataBlock_GrowthBlocks(dataBlock)) return dataBlock->blockCap << (blockIdx - 1);
+	return DATABLOCK_MAX_BLOCK_CAP;
+}
+
+// Computes the number of items blockCount blocks can hold.
+static uint64_t _DataBlock_Capacity(const DataBlock *dataBlock, uint blockCount) {
+	if(blockCount == 0) return 0;
+	uint growth = _DataBlock_GrowthBlocks(dataBlock);
+	if(blockCount <= growth + 1) return dataBlock->blockCap << (blockCount - 1);
+	return (uint64_t)DATABLOCK_MAX_BLOCK_CAP * (blockCount - growth + 1);
+}
 
-// Computes block index from item index.
-#define ITEM_INDEX_TO_BLOCK_INDEX(idx) \
-    (idx / DATABLOCK_BLOCK_CAP)
+// Computes the number of blocks required to accommodate n items.
+static uint _DataBlock_BlocksRequired(const DataBlock *dataBlock, uint64_t n) {
+	if(n == 0) return 0;
+	if(n <= dataBlock->blockCap) return 1;
+	if(n <= DATABLOCK_MAX_BLOCK_CAP * 2) {
+		return MSB_POSITION(n - 1) - __builtin_ctzll(dataBlock->blockCap) + 2;
+	}
+	uint64_t remaining = n - DATABLOCK_MAX_BLOCK_CAP * 2;
+	return _DataBlock_GrowthBlocks(dataBlock) + 1 +
+		   (remaining + DATABLOCK_MAX_BLOCK_CAP - 1) / DATABLOCK_MAX_BLOCK_CAP;
+}
 
-// Computes item position within a block.
-#define ITEM_POSITION_WITHIN_BLOCK(idx) \
-    (idx % DATABLOCK_BLOCK_CAP)
+// Locates the block in which item with index resides, and the item's position within it.
+static inline Block *_DataBlock_LocateItem(const DataBlock *dataBlock, uint64_t idx,
+										   uint64_t *pos) {
+	if(idx < dataBlock->blockCap) {
+		*pos = idx;
+		return dataBlock->blocks[0];
+	}
+	if(idx < DATABLOCK_MAX_BLOCK_CAP * 2) {
+		// Block k starts at blockCap * 2^(k-1).
+		uint msb = MSB_POSITION(idx);
+		*pos = idx - (1ULL << msb);
+		return dataBlock->blocks[msb - __builtin_ctzll(dataBlock->blockCap) + 1];
+	}
+	*pos = idx % DATABLOCK_MAX_BLOCK_CAP;
+	return dataBlock->blocks[idx / DATABLOCK_MAX_BLOCK_CAP + _DataBlock_GrowthBlocks(dataBlock) - 1];
+}
 
-// Retrieves block in which item with index resides.
-#define GET_ITEM_BLOCK(dataBlock, idx) \
-    dataBlock->blocks[ITEM_INDEX_TO_BLOCK_INDEX(idx)]
+// Returns the header of the item at position idx.
+static inline DataBlockItemHeader *_DataBlock_ItemHeader(const DataBlock *dataBlock, uint64_t idx) {
+	uint64_t pos;
+	Block *block = _DataBlock_LocateItem(dataBlock, idx, &pos);
+	return (DataBlockItemHeader *)block->data + (pos * block->itemSize);
+}
 
 static void _DataBlock_AddBlocks(DataBlock *dataBlock, uint blockCount) {
 	assert(dataBlock && blockCount > 0);
@@ -40,12 +84,20 @@ static void _DataBlock_AddBlocks(DataBlock *dataBlock, uint blockCount) {
 
 	uint i;
 	for(i = prevBlockCount; i < dataBlock->blockCount; i++) {
-		dataBlock->blocks[i] = Block_New(dataBlock->itemSize, DATABLOCK_BLOCK_CAP);
+		dataBlock->blocks[i] = Block_New(dataBlock->itemSize, _DataBlock_BlockCap(dataBlock, i));
 		if(i > 0) dataBlock->blocks[i - 1]->next = dataBlock->blocks[i];
 	}
 	dataBlock->blocks[i - 1]->next = NULL;
 
-	dataBlock->itemCap = dataBlock->blockCount * DATABLOCK_BLOCK_CAP;
+	dataBlock->itemCap = _DataBlock_Capacity(dataBlock, dataBlock->blockCount);
+}
+
+// Picks first block capacity suitable for itemCap items.
+static uint64_t _DataBlock_ChooseBlockCap(uint64_t itemCap) {
+	if(itemCap <= DATABLOCK_MIN_BLOCK_CAP) return DATABLOCK_MIN_BLOCK_CAP;
+	if(itemCap >= DATABLOCK_MAX_BLOCK_CAP) return DATABLOCK_MAX_BLOCK_CAP;
+	// Round up to a power of 2.
+	return 1ULL << (MSB_POSITION(itemCap - 1) + 1);
 }
 
 // Checks to see if idx is within global array bounds
@@ -62,13 +114,47 @@ DataBlock *DataBlock_New(uint64_t itemCap, uint itemSize, fpDestructor fp) {
 	dataBlock->itemSize = itemSize + ITEM_HEADER_SIZE;
 	dataBlock->blockCount = 0;
 	dataBlock->blocks = NULL;
+	dataBlock->blockCap = _DataBlock_ChooseBlockCap(itemCap);
 	dataBlock->deletedIdx = array_new(uint64_t, 128);
 	dataBlock->destructor = fp;
 	assert(pthread_mutex_init(&dataBlock->mutex, NULL) == 0);
-	_DataBlock_AddBlocks(dataBlock, ITEM_COUNT_TO_BLOCK_COUNT(itemCap));
+	uint blockCount = _DataBlock_BlocksRequired(dataBlock, itemCap);
+	_DataBlock_AddBlocks(dataBlock, (blockCount > 0) ? blockCount : 1);
 	return dataBlock;
 }
 
+DataBlock *DataBlock_Clone(const DataBlock *dataBlock, fpItemClone clone, void *arg) {
+	assert(dataBlock);
+	DataBlock *clone_block = rm_malloc(sizeof(DataBlock));
+	clone_block->itemCount = dataBlock->itemCount;
+	clone_block->itemSize = dataBlock->itemSize;
+	clone_block->blockCount = 0;
+	clone_block->blocks = NULL;
+	clone_block->blockCap = dataBlock->blockCap;
+	array_clone(clone_block->deletedIdx, dataBlock->deletedIdx);
+	clone_block->destructor = dataBlock->destructor;
+	int res = pthread_mutex_init(&clone_block->mutex, NULL);
+	assert(res == 0);
+	_DataBlock_AddBlocks(clone_block, dataBlock->blockCount);
+
+	// Copy items alongside their headers, deleted items remain deleted.
+	for(uint i = 0; i < dataBlock->blockCount; i++) {
+		const Block *src = dataBlock->blocks[i];
+		memcpy(clone_block->blocks[i]->data, src->data, src->capacity * src->itemSize);
+	}
+
+	if(clone) {
+		uint64_t end = dataBlock->itemCount + array_len(dataBlock->deletedIdx);
+		for(uint64_t idx = 0; idx < end; idx++) {
+			DataBlockItemHeader *header = _DataBlock_ItemHeader(dataBlock, idx);
+			if(IS_ITEM_DELETED(header)) continue;
+			clone(ITEM_DATA(_DataBlock_ItemHeader(clone_block, idx)), ITEM_DATA(header), arg);
+		}
+	}
+
+	return clone_block;
+}
+
 DataBlockIterator *DataBlock_Scan(const DataBlock *dataBlock) {
 	assert(dataBlock);
 	Block *startBlock = dataBlock->blocks[0];
@@ -85,10 +171,24 @@ void DataBlock_Accommodate(DataBlock *dataBlock, int64_t k) {
 	int64_t freeSlotsCount = dataBlock->itemCap - dataBlock->itemCount;
 	int64_t additionalItems = k - freeSlotsCount;
 
-	if(additionalItems > 0) {
-		int64_t additionalBlocks = ITEM_COUNT_TO_BLOCK_COUNT(additionalItems);
-		_DataBlock_AddBlocks(dataBlock, additionalBlocks);
+	if(additionalItems <= 0) return;
+
+	// Empty datablock, pick block sizes suitable for k items, e.g. bulk insertion.
+	if(dataBlock->itemCount == 0 && array_len(dataBlock->deletedIdx) == 0) {
+		uint64_t blockCap = _DataBlock_ChooseBlockCap(k);
+		if(blockCap > dataBlock->blockCap) {
+			for(uint i = 0; i < dataBlock->blockCount; i++) Block_Free(dataBlock->blocks[i]);
+			rm_free(dataBlock->blocks);
+			dataBlock->blocks = NULL;
+			dataBlock->blockCount = 0;
+			dataBlock->blockCap = blockCap;
+			_DataBlock_AddBlocks(dataBlock, _DataBlock_BlocksRequired(dataBlock, k));
+			return;
+		}
 	}
+
+	uint requiredBlocks = _DataBlock_BlocksRequired(dataBlock, dataBlock->itemCap + additionalItems);
+	_DataBlock_AddBlocks(dataBlock, requiredBlocks - dataBlock->blockCount);
 }
 
 void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx) {
@@ -96,10 +196,7 @@ void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx) {
 
 	if(_DataBlock_IndexOutOfBounds(dataBlock, idx)) return NULL;
 
-	Block *block = GET_ITEM_BLOCK(dataBlock, idx);
-	idx = ITEM_POSITION_WITHIN_BLOCK(idx);
-
-	DataBlockItemHeader *item_header = (DataBlockItemHeader *)block->data + (idx * block->itemSize);
+	DataBlockItemHeader *item_header = _DataBlock_ItemHeader(dataBlock, idx);
 
 	// Incase item is marked as deleted, return NULL.
 	if(IS_ITEM_DELETED(item_header)) return NULL;
@@ -107,18 +204,23 @@ void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx) {
 	return ITEM_DATA(item_header);
 }
 
+void *DataBlock_GetLiveItem(const DataBlock *dataBlock, uint64_t idx) {
+	assert(dataBlock && !_DataBlock_IndexOutOfBounds(dataBlock, idx));
+	return ITEM_DATA(_DataBlock_ItemHeader(dataBlock, idx));
+}
+
 void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx) {
 	// Make sure we've got room for items.
 	if(dataBlock->itemCount >= dataBlock->itemCap) {
 		// Allocate twice as much items then we currently hold.
-		uint newCap = dataBlock->itemCount * 2;
-		uint requiredAdditionalBlocks = ITEM_COUNT_TO_BLOCK_COUNT(newCap) - dataBlock->blockCount;
+		uint64_t newCap = dataBlock->itemCount * 2;
+		uint requiredAdditionalBlocks = _DataBlock_BlocksRequired(dataBlock, newCap) - dataBlock->blockCount;
 		_DataBlock_AddBlocks(dataBlock, requiredAdditionalBlocks);
 	}
 
 	// Get index into which to store item,
 	// prefer reusing free indicies.
-	uint pos = dataBlock->itemCount;
+	uint64_t pos = dataBlock->itemCount;
 	if(array_len(dataBlock->deletedIdx) > 0) {
 		pos = array_pop(dataBlock->deletedIdx);
 	}
@@ -126,28 +228,40 @@ void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx) {
 
 	if(idx) *idx = pos;
 
-	Block *block = GET_ITEM_BLOCK(dataBlock, pos);
-	pos = ITEM_POSITION_WITHIN_BLOCK(pos);
-
-	DataBlockItemHeader *item_header = (DataBlockItemHeader *)block->data + (pos * block->itemSize);
+	DataBlockItemHeader *item_header = _DataBlock_ItemHeader(dataBlock, pos);
 	MARK_HEADER_AS_NOT_DELETED(item_header);
 
 	return ITEM_DATA(item_header);
 }
 
+void DataBlock_AllocateItems(DataBlock *dataBlock, uint64_t n, uint64_t *idx) {
+	assert(dataBlock && idx);
+	// Free indicies are reused first, remaining items are appended.
+	uint64_t reused = array_len(dataBlock->deletedIdx);
+	if(reused > n) reused = n;
+	for(uint64_t i = 0; i < reused; i++) idx[i] = array_pop(dataBlock->deletedIdx);
+
+	uint64_t pos = dataBlock->itemCount + array_len(dataBlock->deletedIdx) + reused;
+	uint64_t end = pos + n - reused;
+	if(end > dataBlock->itemCap) {
+		uint requiredBlocks = _DataBlock_BlocksRequired(dataBlock, end);
+		_DataBlock_AddBlocks(dataBlock, requiredBlocks - dataBlock->blockCount);
+	}
+	for(uint64_t i = reused; i < n; i++) idx[i] = pos++;
+	dataBlock->itemCount += n;
+
+	for(uint64_t i = 0; i < n; i++) {
+		DataBlockItemHeader *item_header = _DataBlock_ItemHeader(dataBlock, idx[i]);
+		MARK_HEADER_AS_NOT_DELETED(item_header);
+	}
+}
+
 void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx) {
 	assert(dataBlock);
 	if(_DataBlock_IndexOutOfBounds(dataBlock, idx)) return;
 
-	// Get block.
-	uint blockIdx = ITEM_INDEX_TO_BLOCK_INDEX(idx);
-	Block *block = dataBlock->blocks[blockIdx];
-
-	uint blockPos = ITEM_POSITION_WITHIN_BLOCK(idx);
-	uint offset = blockPos * block->itemSize;
-
 	// Return if item already deleted.
-	DataBlockItemHeader *item_header = (DataBlockItemHeader *)block->data + offset;
+	DataBlockItemHeader *item_header = _DataBlock_ItemHeader(dataBlock, idx);
 	if(IS_ITEM_DELETED(item_header)) return;
 
 	// Call item destructor.
@@ -172,6 +286,103 @@ void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx) {
 	pthread_mutex_unlock(&dataBlock->mutex);
 }
 
+uint64_t *DataBlock_Compact(DataBlock *dataBlock) {
+	assert(dataBlock);
+
+	uint64_t deletedCount = array_len(dataBlock->deletedIdx);
+	if(deletedCount == 0) return NULL;
+
+	// Each live item moves left by the number of deleted items preceding it.
+	uint64_t len = dataBlock->itemCount + deletedCount;
+	uint64_t *mapping = rm_malloc(sizeof(uint64_t) * len);
+	uint64_t pos = 0;
+	for(uint64_t i = 0; i < len; i++) {
+		DataBlockItemHeader *src = _DataBlock_ItemHeader(dataBlock, i);
+		// Deleted positions are mapped to the following item's new position.
+		mapping[i] = pos;
+		if(IS_ITEM_DELETED(src)) continue;
+
+		if(pos != i) {
+			DataBlockItemHeader *dest = _DataBlock_ItemHeader(dataBlock, pos);
+			memcpy(dest, src, dataBlock->itemSize);
+			MARK_HEADER_AS_DELETED(src);
+		}
+		pos++;
+	}
+	assert(pos == dataBlock->itemCount);
+
+	// Drop free indices, the array might have grown considerably.
+	array_free(dataBlock->deletedIdx);
+	dataBlock->deletedIdx = array_new(uint64_t, 128);
+
+	// Free blocks left empty, retaining at least a single block.
+	uint blockCount = _DataBlock_BlocksRequired(dataBlock, dataBlock->itemCount);
+	if(blockCount == 0) blockCount = 1;
+	if(blockCount < dataBlock->blockCount) {
+		for(uint i = blockCount; i < dataBlock->blockCount; i++) Block_Free(dataBlock->blocks[i]);
+		dataBlock->blockCount = blockCount;
+		dataBlock->blocks = rm_realloc(dataBlock->blocks, sizeof(Block *) * blockCount);
+		dataBlock->blocks[blockCount - 1]->next = NULL;
+		dataBlock->itemCap = _DataBlock_Capacity(dataBlock, blockCount);
+	}
+
+	return mapping;
+}
+
+bool DataBlock_RelocateBlock(DataBlock *dataBlock, uint idx, void *(*relocate)(void *ptr, void *arg),
+							 void *arg) {
+	assert(idx < dataBlock->blockCount);
+	Block *moved = relocate(dataBlock->blocks[idx], arg);
+	if(moved == NULL) return false;
+
+	dataBlock->blocks[idx] = moved;
+	if(idx > 0) dataBlock->blocks[idx - 1]->next = moved;
+	return true;
+}
+
+void DataBlock_Permute(DataBlock *dataBlock, const uint64_t *perm) {
+	assert(dataBlock && perm);
+	assert(array_len(dataBlock->deletedIdx) == 0);
+
+	uint64_t len = dataBlock->itemCount;
+	uint itemSize = dataBlock->itemSize;
+	bool *placed = rm_calloc(len, sizeof(bool));
+	unsigned char *carry = rm_malloc(itemSize);
+	unsigned char *tmp = rm_malloc(itemSize);
+
+	// Follow each cycle of the permutation, carrying the displaced item along.
+	for(uint64_t i = 0; i < len; i++) {
+		if(placed[i]) continue;
+		memcpy(carry, _DataBlock_ItemHeader(dataBlock, i), itemSize);
+		uint64_t j = i;
+		do {
+			j = perm[j];
+			assert(j < len && !placed[j]);
+			DataBlockItemHeader *dest = _DataBlock_ItemHeader(dataBlock, j);
+			memcpy(tmp, dest, itemSize);
+			memcpy(dest, carry, itemSize);
+			placed[j] = true;
+			unsigned char *swap = carry;
+			carry = tmp;
+			tmp = swap;
+		} while(j != i);
+	}
+
+	rm_free(placed);
+	rm_free(carry);
+	rm_free(tmp);
+}
+
+size_t DataBlock_MemoryUsage(const DataBlock *dataBlock) {
+	size_t size = sizeof(DataBlock) + sizeof(Block *) * dataBlock->blockCount;
+	for(uint i = 0; i < dataBlock->blockCount; i++) {
+		const Block *block = dataBlock->blocks[i];
+		size += sizeof(Block) + (size_t)block->capacity * block->itemSize;
+	}
+	size += array_sizeof(array_hdr(dataBlock->deletedIdx));
+	return size;
+}
+
 void DataBlock_Free(DataBlock *dataBlock) {
 	for(uint i = 0; i < dataBlock->blockCount; i++) Block_Free(dataBlock->blocks[i]);
 
@@ -7,14 +7,18 @@
 #pragma once
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include <pthread.h>
 #include "../block.h"
 #include "./datablock_iterator.h"
 
 typedef void (*fpDestructor)(void *);
+// Clones the content of item src into dst, dst is a bitwise copy of src.
+typedef void (*fpItemClone)(void *dst, const void *src, void *arg);
 
-// Number of items in a block. Should always be a power of 2.
-#define DATABLOCK_BLOCK_CAP 16384
+// Bounds of a datablock's first block capacity. Should always be powers of 2.
+#define DATABLOCK_MIN_BLOCK_CAP 64
+#define DATABLOCK_MAX_BLOCK_CAP 1048576
 
 // Returns the item header size.
 #define ITEM_HEADER_SIZE 1
@@ -38,10 +42,15 @@ typedef void (*fpDestructor)(void *);
 /* The DataBlock is a container structure for holding arbitrary items of a uniform type
  * in order to reduce the number of alloc/free calls and improve locality of reference.
  * Item deletions are thread-safe, and a DataBlockIterator can be used to traverse a
- * range within the block. */
+ * range within the block.
+ * The first block's capacity is derived from the initial capacity hint,
+ * the second block matches it and each following block doubles the accumulated capacity,
+ * until blocks reach DATABLOCK_MAX_BLOCK_CAP items, from there on blocks are of uniform size.
+ * Such that small datablocks remain small while large ones are made of few blocks. */
 typedef struct {
 	uint64_t itemCount;         // Number of items stored in datablock.
 	uint64_t itemCap;           // Number of items datablock can hold.
+	uint64_t blockCap;          // Number of items the first block can hold.
 	uint blockCount;            // Number of blocks in datablock.
 	uint itemSize;              // Size of a single item in bytes.
 	Block **blocks;             // Array of blocks.
@@ -62,7 +71,12 @@ typedef struct {
 // fp - destructor routine for freeing items.
 DataBlock *DataBlock_New(uint64_t itemCap, uint itemSize, fpDestructor fp);
 
+// Creates a copy of datablock, items are copied block-wise, preserving their positions,
+// clone is invoked for each copied item, allowing for the duplication of owned content.
+DataBlock *DataBlock_Clone(const DataBlock *dataBlock, fpItemClone clone, void *arg);
+
 // Make sure datablock can accommodate at least k items.
+// An empty datablock adapts its block sizes to k.
 void DataBlock_Accommodate(DataBlock *dataBlock, int64_t k);
 
 // Returns an iterator which scans entire datablock.
@@ -71,13 +85,41 @@ DataBlockIterator *DataBlock_Scan(const DataBlock *dataBlock);
 // Get item at position idx
 void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx);
 
+// Get item at position idx, which is known to hold an item that isn't deleted.
+// The item's memory isn't accessed, sparing a cache miss until the item is read.
+void *DataBlock_GetLiveItem(const DataBlock *dataBlock, uint64_t idx);
+
 // Allocate a new item within given dataBlock,
 // if idx is not NULL, idx will contain item position
 // return a pointer to the newly allocated item.
 void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx);
 
+// Allocate n items within given dataBlock, positions are written to idx,
+// items are retrieved via DataBlock_GetItem.
+// Once allocated, distinct items can be initialized concurrently.
+void DataBlock_AllocateItems(DataBlock *dataBlock, uint64_t n, uint64_t *idx);
+
 // Removes item at position idx.
 void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx);
 
+// Moves items to the lowest positions, preserving their order, and frees blocks left empty.
+// Returns an array mapping each item's previous position to its new position,
+// NULL if there are no deleted items. Caller is responsible for freeing the mapping.
+uint64_t *DataBlock_Compact(DataBlock *dataBlock);
+
+// Moves each item from position i to position perm[i], perm must be a permutation
+// of the datablock's positions, datablock must not contain deleted items.
+void DataBlock_Permute(DataBlock *dataBlock, const uint64_t *perm);
+
+/* Moves the idx block through relocate, which returns the block's new address
+ * or NULL if the block wasn't moved. Pointers to the block's items are invalidated.
+ * Returns true if the block moved. */
+bool DataBlock_RelocateBlock(DataBlock *dataBlock, uint idx, void *(*relocate)(void *ptr, void *arg),
+							 void *arg);
+
+// Returns the number of bytes held by datablock, its blocks and free list,
+// excluding memory owned by its items.
+size_t DataBlock_MemoryUsage(const DataBlock *dataBlock);
+
 // Free block.
 void DataBlock_Free(DataBlock *block);
@@ -14,10 +14,18 @@
 DataBlockIterator *DataBlockIterator_New(Block *block, uint start_pos, uint end_pos, uint step) {
 	assert(block && start_pos >= 0 && end_pos >= start_pos && step >= 1);
 
+	// Advance to the block in which start position resides, blocks vary in size.
+	uint block_pos = start_pos;
+	while(block && block_pos >= block->capacity) {
+		block_pos -= block->capacity;
+		block = block->next;
+	}
+
 	DataBlockIterator *iter = rm_malloc(sizeof(DataBlockIterator));
 	iter->_start_block = block;
 	iter->_current_block = block;
-	iter->_block_pos = start_pos % DATABLOCK_BLOCK_CAP;
+	iter->_start_block_pos = block_pos;
+	iter->_block_pos = block_pos;
 	iter->_start_pos = start_pos;
 	iter->_current_pos = iter->_start_pos;
 	iter->_end_pos = end_pos;
@@ -26,7 +34,10 @@ DataBlockIterator *DataBlockIterator_New(Block *block, uint start_pos, uint end_
 }
 
 DataBlockIterator *DataBlockIterator_Clone(const DataBlockIterator *it) {
-	return DataBlockIterator_New(it->_start_block, it->_start_pos, it->_end_pos, it->_step);
+	DataBlockIterator *clone = rm_malloc(sizeof(DataBlockIterator));
+	*clone = *it;
+	DataBlockIterator_Reset(clone);
+	return clone;
 }
 
 void *DataBlockIterator_Next(DataBlockIterator *iter) {
@@ -46,8 +57,8 @@ void *DataBlockIterator_Next(DataBlockIterator *iter) {
 		iter->_current_pos += iter->_step;
 
 		// Advance to next block if current block consumed.
-		if(iter->_block_pos >= DATABLOCK_BLOCK_CAP) {
-			iter->_block_pos -= DATABLOCK_BLOCK_CAP;
+		while(iter->_current_block && iter->_block_pos >= iter->_current_block->capacity) {
+			iter->_block_pos -= iter->_current_block->capacity;
 			iter->_current_block = iter->_current_block->next;
 		}
 
@@ -61,7 +72,7 @@ void *DataBlockIterator_Next(DataBlockIterator *iter) {
 
 void DataBlockIterator_Reset(DataBlockIterator *iter) {
 	assert(iter);
-	iter->_block_pos = iter->_start_pos % DATABLOCK_BLOCK_CAP;
+	iter->_block_pos = iter->_start_block_pos;
 	iter->_current_block = iter->_start_block;
 	iter->_current_pos = iter->_start_pos;
 }
@@ -16,6 +16,7 @@ typedef struct {
 	Block *_current_block;       // Current block.
 	uint _start_pos;             // Iterator initial position.
 	uint _current_pos;           // Iterator current position.
+	uint _start_block_pos;       // Initial position within start block.
 	uint _block_pos;             // Position within a block.
 	uint _end_pos;               // Iterator won't pass end position.
 	uint _step;                  // Increase current_pos by step each iteration.
@@ -23,7 +24,7 @@ typedef struct {
 
 // Creates a new datablock iterator.
 DataBlockIterator *DataBlockIterator_New(
-	Block *block,       // Block from which iteration begins.
+	Block *block,       // First block of the datablock.
 	uint start_pos,     // Iteration starts here.
 	uint end_pos,       // Iteration stops here.
 	uint step           // To scan entire range, set step to 1.
@@ -0,0 +1,32 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "graphblas_threads.h"
+#include "thpool/pools.h"
+#include <assert.h>
+
+// Threads shared by long reads, a single thread until initialized.
+static int _long_read_threads = 1;
+
+void GraphBLASThreads_Init(int thread_count) {
+	assert(thread_count > 0);
+	_long_read_threads = thread_count;
+}
+
+int GraphBLASThreads_Budget(void) {
+	// Queries executing on Redis main thread, short reads and writes.
+	if(ThreadPools_CurrentLane() != THPOOL_LANE_LONG_READ) return 1;
+
+	uint64_t running = ThreadPools_LaneRunning(THPOOL_LANE_LONG_READ);
+	if(running <= 1) return _long_read_threads;
+	int budget = _long_read_threads / running;
+	return (budget > 0) ? budget : 1;
+}
+
+void GraphBLASThreads_SetDescriptor(GrB_Descriptor desc) {
+	assert(desc);
+	GxB_Desc_set(desc, GxB_NTHREADS, GraphBLASThreads_Budget());
+}
@@ -0,0 +1,25 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+/* GraphBLAS operations are budgeted threads according to the lane of the
+ * query issuing them. Short reads and writes, expected to operate on few entries,
+ * run each operation on their own thread, sparing the cores for other queries.
+ * Long reads share a fixed number of threads evenly among those running,
+ * such that an analytic query alone runs its multiplications in parallel,
+ * while concurrent ones don't oversubscribe the cores. */
+
+// Set the number of threads shared by the operations of concurrent long reads.
+void GraphBLASThreads_Init(int thread_count);
+
+// Returns the number of threads an operation issued by the calling thread may use.
+int GraphBLASThreads_Budget(void);
+
+// Restrict the operations performed with desc to the calling thread's budget.
+void GraphBLASThreads_SetDescriptor(GrB_Descriptor desc);
@@ -0,0 +1,49 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "hll.h"
+#include "rmalloc.h"
+#include <math.h>
+
+HLL *HLL_New(void) {
+	return rm_calloc(1, sizeof(HLL));
+}
+
+void HLL_Add(HLL *hll, uint64_t hash) {
+	// The high bits select a register, the rest determine the rank.
+	uint32_t idx = hash >> (64 - HLL_PRECISION);
+	// Guard bit bounds the rank when the remaining bits are all zero.
+	uint64_t w = (hash << HLL_PRECISION) | (1ULL << (HLL_PRECISION - 1));
+	uint8_t rank = __builtin_clzll(w) + 1;
+	if(rank > hll->registers[idx]) hll->registers[idx] = rank;
+}
+
+void HLL_Merge(HLL *dst, const HLL *src) {
+	for(uint32_t i = 0; i < HLL_REGISTERS; i++) {
+		if(src->registers[i] > dst->registers[i]) dst->registers[i] = src->registers[i];
+	}
+}
+
+uint64_t HLL_Count(const HLL *hll) {
+	const double m = HLL_REGISTERS;
+	double sum = 0;
+	uint32_t zeros = 0;
+	for(uint32_t i = 0; i < HLL_REGISTERS; i++) {
+		sum += ldexp(1.0, -hll->registers[i]);
+		if(hll->registers[i] == 0) zeros++;
+	}
+
+	double alpha = 0.7213 / (1 + 1.079 / m);
+	double estimate = alpha * m * m / sum;
+	// Small cardinalities are estimated by the fraction of empty registers.
+	if(estimate <= 2.5 * m && zeros > 0) estimate = m * log(m / zeros);
+
+	return (uint64_t)llround(estimate);
+}
+
+void HLL_Free(HLL *hll) {
+	rm_free(hll);
+}
@@ -0,0 +1,37 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// Number of hash bits selecting a register.
+#define HLL_PRECISION 12
+// Number of registers, each a single byte.
+#define HLL_REGISTERS (1 << HLL_PRECISION)
+
+/* HyperLogLog estimates the number of distinct items added to it within fixed memory,
+ * with a standard error of 1.04 / sqrt(HLL_REGISTERS), about 1.6%.
+ * Items are added by their 64 bit hash codes, which must be uniformly distributed.
+ * Sketches built over different parts of the input merge into a sketch of the whole input. */
+typedef struct {
+	uint8_t registers[HLL_REGISTERS];   // Longest run of leading zeros observed per register, + 1.
+} HLL;
+
+// Create a new, empty, sketch.
+HLL *HLL_New(void);
+
+// Add an item by its hash code.
+void HLL_Add(HLL *hll, uint64_t hash);
+
+// Merge src into dst, dst then estimates the items added to either sketch.
+void HLL_Merge(HLL *dst, const HLL *src);
+
+// Estimate the number of distinct items added.
+uint64_t HLL_Count(const HLL *hll);
+
+// Free sketch.
+void HLL_Free(HLL *hll);
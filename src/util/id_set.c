@@ -0,0 +1,392 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "id_set.h"
+#include "rmalloc.h"
+#include <string.h>
+#include <assert.h>
+
+// Number of 64 bit words in a bitmap container.
+#define BITMAP_WORDS 1024
+
+#define CONTAINER_KEY(id) ((id) >> 16)
+#define CONTAINER_LOW(id) ((uint16_t)((id) & 0xFFFF))
+
+typedef struct {
+	uint64_t key;           // Upper 48 bits shared by the container's IDs.
+	uint32_t cardinality;   // Number of IDs held.
+	uint32_t cap;           // Array capacity, 0 for bitmap containers.
+	union {
+		uint16_t *array;    // Sorted lower 16 bits of each ID.
+		uint64_t *bitmap;   // Bit per lower 16 bits value.
+	};
+} Container;
+
+struct IDSet {
+	Container *containers;  // Containers sorted by key.
+	uint32_t count;         // Number of containers.
+	uint32_t cap;           // Allocated containers.
+	uint64_t cardinality;   // Number of IDs held.
+};
+
+static inline bool _IsBitmap(const Container *c) {
+	return c->cap == 0;
+}
+
+static void _Container_Free(Container *c) {
+	if(_IsBitmap(c)) rm_free(c->bitmap);
+	else rm_free(c->array);
+}
+
+// Returns the position of low within array container c, or where it belongs if missing.
+static uint32_t _Array_Search(const Container *c, uint16_t low, bool *found) {
+	uint32_t lo = 0;
+	uint32_t hi = c->cardinality;
+	while(lo < hi) {
+		uint32_t mid = (lo + hi) / 2;
+		if(c->array[mid] < low) lo = mid + 1;
+		else hi = mid;
+	}
+	*found = (lo < c->cardinality && c->array[lo] == low);
+	return lo;
+}
+
+static bool _Container_Contains(const Container *c, uint16_t low) {
+	if(_IsBitmap(c)) return c->bitmap[low >> 6] & (1ULL << (low & 63));
+	bool found;
+	_Array_Search(c, low, &found);
+	return found;
+}
+
+static void _Container_ToBitmap(Container *c) {
+	uint64_t *bitmap = rm_calloc(BITMAP_WORDS, sizeof(uint64_t));
+	for(uint32_t i = 0; i < c->cardinality; i++) {
+		bitmap[c->array[i] >> 6] |= 1ULL << (c->array[i] & 63);
+	}
+	rm_free(c->array);
+	c->bitmap = bitmap;
+	c->cap = 0;
+}
+
+static void _Container_ToArray(Container *c) {
+	uint32_t cap = (c->cardinality > 0) ? c->cardinality : 1;
+	uint16_t *array = rm_malloc(sizeof(uint16_t) * cap);
+	uint32_t n = 0;
+	for(uint32_t w = 0; w < BITMAP_WORDS; w++) {
+		uint64_t word = c->bitmap[w];
+		while(word) {
+			array[n++] = (w << 6) + __builtin_ctzll(word);
+			word &= word - 1;
+		}
+	}
+	rm_free(c->bitmap);
+	c->array = array;
+	c->cap = cap;
+}
+
+// Adds low to c, returns false if c already holds it.
+static bool _Container_Add(Container *c, uint16_t low) {
+	if(_IsBitmap(c)) {
+		uint64_t bit = 1ULL << (low & 63);
+		if(c->bitmap[low >> 6] & bit) return false;
+		c->bitmap[low >> 6] |= bit;
+		c->cardinality++;
+		return true;
+	}
+
+	// IDs are commonly added in ascending order, check for an append first.
+	bool found = false;
+	uint32_t pos = c->cardinality;
+	if(pos > 0 && c->array[pos - 1] >= low) pos = _Array_Search(c, low, &found);
+	if(found) return false;
+
+	if(c->cardinality == ID_SET_ARRAY_MAX) {
+		_Container_ToBitmap(c);
+		return _Container_Add(c, low);
+	}
+	if(c->cardinality == c->cap) {
+		c->cap = (c->cap * 2 < ID_SET_ARRAY_MAX) ? c->cap * 2 : ID_SET_ARRAY_MAX;
+		c->array = rm_realloc(c->array, sizeof(uint16_t) * c->cap);
+	}
+	memmove(c->array + pos + 1, c->array + pos, sizeof(uint16_t) * (c->cardinality - pos));
+	c->array[pos] = low;
+	c->cardinality++;
+	return true;
+}
+
+// Removes low from c, returns false if c doesn't hold it.
+static bool _Container_Remove(Container *c, uint16_t low) {
+	if(_IsBitmap(c)) {
+		uint64_t bit = 1ULL << (low & 63);
+		if(!(c->bitmap[low >> 6] & bit)) return false;
+		c->bitmap[low >> 6] &= ~bit;
+		c->cardinality--;
+		// Convert back well below the array limit, such that alternating
+		// additions and removals around it don't convert on every call.
+		if(c->cardinality <= ID_SET_ARRAY_MAX / 2) _Container_ToArray(c);
+		return true;
+	}
+
+	bool found;
+	uint32_t pos = _Array_Search(c, low, &found);
+	if(!found) return false;
+	memmove(c->array + pos, c->array + pos + 1, sizeof(uint16_t) * (c->cardinality - pos - 1));
+	c->cardinality--;
+	return true;
+}
+
+// Returns the position of the container keyed key, or where it belongs if missing.
+static uint32_t _IDSet_Search(const IDSet *set, uint64_t key, bool *found) {
+	// IDs are commonly added in ascending order, check the last container first.
+	if(set->count > 0 && set->containers[set->count - 1].key <= key) {
+		*found = (set->containers[set->count - 1].key == key);
+		return (*found) ? set->count - 1 : set->count;
+	}
+
+	uint32_t lo = 0;
+	uint32_t hi = set->count;
+	while(lo < hi) {
+		uint32_t mid = (lo + hi) / 2;
+		if(set->containers[mid].key < key) lo = mid + 1;
+		else hi = mid;
+	}
+	*found = (lo < set->count && set->containers[lo].key == key);
+	return lo;
+}
+
+// Inserts an empty array container keyed key at position pos.
+static Container *_IDSet_InsertContainer(IDSet *set, uint32_t pos, uint64_t key) {
+	if(set->count == set->cap) {
+		set->cap = (set->cap) ? set->cap * 2 : 4;
+		set->containers = rm_realloc(set->containers, sizeof(Container) * set->cap);
+	}
+	memmove(set->containers + pos + 1, set->containers + pos,
+			sizeof(Container) * (set->count - pos));
+	set->count++;
+
+	Container *c = set->containers + pos;
+	c->key = key;
+	c->cardinality = 0;
+	c->cap = 4;
+	c->array = rm_malloc(sizeof(uint16_t) * c->cap);
+	return c;
+}
+
+static void _IDSet_RemoveContainer(IDSet *set, uint32_t pos) {
+	_Container_Free(set->containers + pos);
+	memmove(set->containers + pos, set->containers + pos + 1,
+			sizeof(Container) * (set->count - pos - 1));
+	set->count--;
+}
+
+IDSet *IDSet_New(void) {
+	return rm_calloc(1, sizeof(IDSet));
+}
+
+bool IDSet_Add(IDSet *set, uint64_t id) {
+	assert(set);
+	bool found;
+	uint64_t key = CONTAINER_KEY(id);
+	uint32_t pos = _IDSet_Search(set, key, &found);
+	Container *c = (found) ? set->containers + pos : _IDSet_InsertContainer(set, pos, key);
+	if(!_Container_Add(c, CONTAINER_LOW(id))) return false;
+	set->cardinality++;
+	return true;
+}
+
+bool IDSet_Remove(IDSet *set, uint64_t id) {
+	assert(set);
+	bool found;
+	uint32_t pos = _IDSet_Search(set, CONTAINER_KEY(id), &found);
+	if(!found) return false;
+	Container *c = set->containers + pos;
+	if(!_Container_Remove(c, CONTAINER_LOW(id))) return false;
+	if(c->cardinality == 0) _IDSet_RemoveContainer(set, pos);
+	set->cardinality--;
+	return true;
+}
+
+bool IDSet_Contains(const IDSet *set, uint64_t id) {
+	assert(set);
+	bool found;
+	uint32_t pos = _IDSet_Search(set, CONTAINER_KEY(id), &found);
+	return found && _Container_Contains(set->containers + pos, CONTAINER_LOW(id));
+}
+
+uint64_t IDSet_Cardinality(const IDSet *set) {
+	assert(set);
+	return set->cardinality;
+}
+
+// Adds the IDs of src to dst, containers sharing a key.
+static void _Container_Union(Container *dst, const Container *src) {
+	if(!_IsBitmap(src)) {
+		for(uint32_t i = 0; i < src->cardinality; i++) _Container_Add(dst, src->array[i]);
+		return;
+	}
+
+	if(!_IsBitmap(dst)) _Container_ToBitmap(dst);
+	uint32_t cardinality = 0;
+	for(uint32_t w = 0; w < BITMAP_WORDS; w++) {
+		dst->bitmap[w] |= src->bitmap[w];
+		cardinality += __builtin_popcountll(dst->bitmap[w]);
+	}
+	dst->cardinality = cardinality;
+}
+
+void IDSet_Union(IDSet *dst, const IDSet *src) {
+	assert(dst && src);
+	for(uint32_t i = 0; i < src->count; i++) {
+		const Container *s = src->containers + i;
+		bool found;
+		uint32_t pos = _IDSet_Search(dst, s->key, &found);
+		Container *d = (found) ? dst->containers + pos : _IDSet_InsertContainer(dst, pos, s->key);
+		dst->cardinality -= d->cardinality;
+		_Container_Union(d, s);
+		dst->cardinality += d->cardinality;
+	}
+}
+
+// Removes the IDs of dst missing from src, containers sharing a key.
+static void _Container_Intersect(Container *dst, const Container *src) {
+	if(_IsBitmap(dst) && _IsBitmap(src)) {
+		uint32_t cardinality = 0;
+		for(uint32_t w = 0; w < BITMAP_WORDS; w++) {
+			dst->bitmap[w] &= src->bitmap[w];
+			cardinality += __builtin_popcountll(dst->bitmap[w]);
+		}
+		dst->cardinality = cardinality;
+		if(cardinality <= ID_SET_ARRAY_MAX) _Container_ToArray(dst);
+		return;
+	}
+
+	// Keep src's IDs held by dst, preserving their order.
+	if(_IsBitmap(dst)) {
+		uint16_t *array = rm_malloc(sizeof(uint16_t) * src->cardinality);
+		uint32_t n = 0;
+		for(uint32_t i = 0; i < src->cardinality; i++) {
+			if(_Container_Contains(dst, src->array[i])) array[n++] = src->array[i];
+		}
+		rm_free(dst->bitmap);
+		dst->array = array;
+		dst->cardinality = n;
+		dst->cap = (src->cardinality > 0) ? src->cardinality : 1;
+		return;
+	}
+
+	uint32_t n = 0;
+	for(uint32_t i = 0; i < dst->cardinality; i++) {
+		if(_Container_Contains(src, dst->array[i])) dst->array[n++] = dst->array[i];
+	}
+	dst->cardinality = n;
+}
+
+void IDSet_Intersect(IDSet *dst, const IDSet *src) {
+	assert(dst && src);
+	uint32_t i = 0;
+	dst->cardinality = 0;
+	while(i < dst->count) {
+		Container *d = dst->containers + i;
+		bool found;
+		uint32_t pos = _IDSet_Search(src, d->key, &found);
+		if(found) _Container_Intersect(d, src->containers + pos);
+		if(!found || d->cardinality == 0) {
+			_IDSet_RemoveContainer(dst, i);
+			continue;
+		}
+		dst->cardinality += d->cardinality;
+		i++;
+	}
+}
+
+size_t IDSet_MemoryUsage(const IDSet *set) {
+	assert(set);
+	size_t size = sizeof(IDSet) + sizeof(Container) * set->cap;
+	for(uint32_t i = 0; i < set->count; i++) {
+		const Container *c = set->containers + i;
+		size += (_IsBitmap(c)) ? BITMAP_WORDS * sizeof(uint64_t) : c->cap * sizeof(uint16_t);
+	}
+	return size;
+}
+
+void IDSet_Clear(IDSet *set) {
+	assert(set);
+	for(uint32_t i = 0; i < set->count; i++) _Container_Free(set->containers + i);
+	set->count = 0;
+	set->cardinality = 0;
+}
+
+void IDSet_Free(IDSet *set) {
+	if(set == NULL) return;
+	IDSet_Clear(set);
+	rm_free(set->containers);
+	rm_free(set);
+}
+
+void IDSet_Iterate(const IDSet *set, IDSetIterator *it) {
+	assert(set && it);
+	it->set = set;
+	it->container = 0;
+	it->pos = 0;
+	it->max = UINT64_MAX;
+}
+
+void IDSet_IterateRange(const IDSet *set, IDSetIterator *it, uint64_t min, uint64_t max) {
+	assert(set && it);
+	bool found;
+	it->set = set;
+	it->max = max;
+	it->pos = 0;
+	it->container = _IDSet_Search(set, CONTAINER_KEY(min), &found);
+	if(!found) return;
+
+	// Skip the container's IDs below min.
+	const Container *c = set->containers + it->container;
+	if(_IsBitmap(c)) it->pos = CONTAINER_LOW(min);
+	else it->pos = _Array_Search(c, CONTAINER_LOW(min), &found);
+}
+
+// Sets low to the next ID of c from the iterator's position, returns false once c is depleted.
+static bool _Container_Next(const Container *c, IDSetIterator *it, uint32_t *low) {
+	if(!_IsBitmap(c)) {
+		if(it->pos >= c->cardinality) return false;
+		*low = c->array[it->pos++];
+		return true;
+	}
+
+	// pos is the next bit to inspect.
+	while(it->pos < BITMAP_WORDS * 64) {
+		uint64_t word = c->bitmap[it->pos >> 6] >> (it->pos & 63);
+		if(word == 0) {
+			it->pos = ((it->pos >> 6) + 1) << 6;
+			continue;
+		}
+		*low = it->pos + __builtin_ctzll(word);
+		it->pos = *low + 1;
+		return true;
+	}
+	return false;
+}
+
+bool IDSetIterator_Next(IDSetIterator *it, uint64_t *id) {
+	assert(it && id);
+	const IDSet *set = it->set;
+	while(it->container < set->count) {
+		const Container *c = set->containers + it->container;
+		uint32_t low;
+		if(_Container_Next(c, it, &low)) {
+			uint64_t next = (c->key << 16) | low;
+			if(next > it->max) break;
+			*id = next;
+			return true;
+		}
+		it->container++;
+		it->pos = 0;
+	}
+	// Depleted, keep reporting so.
+	it->container = set->count;
+	return false;
+}
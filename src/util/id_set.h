@@ -0,0 +1,68 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Number of IDs an array container holds before it is converted to a bitmap.
+#define ID_SET_ARRAY_MAX 4096
+
+/* IDSet is a compressed set of 64 bit IDs, such as node IDs.
+ * IDs are partitioned by their upper 48 bits into containers of up to 2^16 IDs,
+ * a container holding few IDs keeps their lower 16 bits in a sorted array,
+ * a denser container keeps a 2^16 bit bitmap, such that a set costs at most
+ * about 2 bytes per ID, and as little as a bit per ID for dense ranges.
+ * IDs are iterated in ascending order. A set is not thread-safe. */
+typedef struct IDSet IDSet;
+
+typedef struct {
+	const IDSet *set;   // Iterated set.
+	uint32_t container; // Current container.
+	uint32_t pos;       // Position within the current container.
+	uint64_t max;       // Last ID to report.
+} IDSetIterator;
+
+// Create a new, empty set.
+IDSet *IDSet_New(void);
+
+// Adds id to set, returns false if set already holds id.
+bool IDSet_Add(IDSet *set, uint64_t id);
+
+// Removes id from set, returns false if set doesn't hold id.
+bool IDSet_Remove(IDSet *set, uint64_t id);
+
+// Returns true if set holds id.
+bool IDSet_Contains(const IDSet *set, uint64_t id);
+
+// Returns the number of IDs in set.
+uint64_t IDSet_Cardinality(const IDSet *set);
+
+// Adds every ID of src to dst.
+void IDSet_Union(IDSet *dst, const IDSet *src);
+
+// Removes the IDs of dst missing from src.
+void IDSet_Intersect(IDSet *dst, const IDSet *src);
+
+// Returns the number of bytes held by set.
+size_t IDSet_MemoryUsage(const IDSet *set);
+
+// Removes every ID from set.
+void IDSet_Clear(IDSet *set);
+
+// Free set.
+void IDSet_Free(IDSet *set);
+
+// Position iterator on the first ID of set, set mustn't be modified while iterated.
+void IDSet_Iterate(const IDSet *set, IDSetIterator *it);
+
+// Position iterator on the first ID of set within [min, max].
+void IDSet_IterateRange(const IDSet *set, IDSetIterator *it, uint64_t min, uint64_t max);
+
+// Sets id to the next ID in ascending order, returns false once depleted.
+bool IDSetIterator_Next(IDSetIterator *it, uint64_t *id);
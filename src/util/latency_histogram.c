@@ -0,0 +1,108 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "latency_histogram.h"
+#include "rmalloc.h"
+#include <assert.h>
+
+// log2 of LATENCY_HISTOGRAM_SUB_BUCKETS.
+#define SUB_BUCKET_BITS 3
+
+/* Latencies below LATENCY_HISTOGRAM_SUB_BUCKETS microseconds are counted exactly,
+ * a latency within [2^m, 2^(m+1)) is counted in one of the sub-buckets of magnitude m,
+ * each spanning 2^(m - SUB_BUCKET_BITS) microseconds. */
+static uint _Bucket(uint64_t usec) {
+	if(usec < LATENCY_HISTOGRAM_SUB_BUCKETS) return usec;
+	uint magnitude = 63 - __builtin_clzll(usec);
+	uint bucket = (magnitude - SUB_BUCKET_BITS + 1) * LATENCY_HISTOGRAM_SUB_BUCKETS +
+				  (usec >> (magnitude - SUB_BUCKET_BITS)) - LATENCY_HISTOGRAM_SUB_BUCKETS;
+	return (bucket < LATENCY_HISTOGRAM_BUCKETS) ? bucket : LATENCY_HISTOGRAM_BUCKETS - 1;
+}
+
+// Returns the highest latency, in microseconds, counted by bucket.
+static uint64_t _BucketUpperBound(uint bucket) {
+	if(bucket < LATENCY_HISTOGRAM_SUB_BUCKETS) return bucket;
+	uint magnitude = bucket / LATENCY_HISTOGRAM_SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+	uint64_t sub = bucket % LATENCY_HISTOGRAM_SUB_BUCKETS + LATENCY_HISTOGRAM_SUB_BUCKETS;
+	return ((sub + 1) << (magnitude - SUB_BUCKET_BITS)) - 1;
+}
+
+LatencyHistogram *LatencyHistogram_New(void) {
+	return rm_calloc(1, sizeof(LatencyHistogram));
+}
+
+void LatencyHistogram_Record(LatencyHistogram *h, double ms) {
+	assert(h);
+	uint64_t usec = (ms > 0) ? ms * 1000 : 0;
+
+	__atomic_fetch_add(&h->buckets[_Bucket(usec)], 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&h->sum, usec, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&h->count, 1, __ATOMIC_RELAXED);
+
+	uint64_t max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+	while(usec > max &&
+		  !__atomic_compare_exchange_n(&h->max, &max, usec, true,
+									   __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+// Percentile of a snapshot of the histogram's buckets, in microseconds.
+static uint64_t _Percentile(const uint64_t *buckets, uint64_t total, uint64_t max,
+							double percentile) {
+	if(total == 0) return 0;
+	uint64_t rank = total * percentile;
+	uint64_t seen = 0;
+	for(uint i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+		seen += buckets[i];
+		if(seen > rank) {
+			// The last bucket is unbounded.
+			if(i == LATENCY_HISTOGRAM_BUCKETS - 1) return max;
+			uint64_t bound = _BucketUpperBound(i);
+			return (bound < max) ? bound : max;
+		}
+	}
+	return max;
+}
+
+// Snapshot the histogram's buckets, returns the number of latencies they count.
+static uint64_t _Snapshot(const LatencyHistogram *h, uint64_t *buckets) {
+	uint64_t total = 0;
+	for(uint i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+		buckets[i] = __atomic_load_n(&h->buckets[i], __ATOMIC_RELAXED);
+		total += buckets[i];
+	}
+	return total;
+}
+
+double LatencyHistogram_Percentile(const LatencyHistogram *h, double percentile) {
+	assert(h);
+	uint64_t buckets[LATENCY_HISTOGRAM_BUCKETS];
+	uint64_t total = _Snapshot(h, buckets);
+	uint64_t max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+	return (double)_Percentile(buckets, total, max, percentile) / 1000;
+}
+
+LatencySummary LatencyHistogram_Summarize(const LatencyHistogram *h) {
+	assert(h);
+	uint64_t buckets[LATENCY_HISTOGRAM_BUCKETS];
+	uint64_t total = _Snapshot(h, buckets);
+	uint64_t max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+	uint64_t sum = __atomic_load_n(&h->sum, __ATOMIC_RELAXED);
+
+	LatencySummary summary = {
+		.count = total,
+		.mean = (total > 0) ? (double)sum / total / 1000 : 0,
+		.p50 = (double)_Percentile(buckets, total, max, 0.5) / 1000,
+		.p90 = (double)_Percentile(buckets, total, max, 0.9) / 1000,
+		.p99 = (double)_Percentile(buckets, total, max, 0.99) / 1000,
+		.p999 = (double)_Percentile(buckets, total, max, 0.999) / 1000,
+		.max = (double)max / 1000
+	};
+	return summary;
+}
+
+void LatencyHistogram_Free(LatencyHistogram *h) {
+	rm_free(h);
+}
@@ -0,0 +1,53 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// Number of linear sub-buckets per power of 2, bounding the relative error to 1/8.
+#define LATENCY_HISTOGRAM_SUB_BUCKETS 8
+// Number of powers of 2 tracked, latencies of 2^36 microseconds, about 19 hours, or more share a bucket.
+#define LATENCY_HISTOGRAM_MAGNITUDES 34
+#define LATENCY_HISTOGRAM_BUCKETS (LATENCY_HISTOGRAM_MAGNITUDES * LATENCY_HISTOGRAM_SUB_BUCKETS)
+
+/* LatencyHistogram counts latencies in microsecond resolution within fixed memory,
+ * in the manner of HdrHistogram: each power of 2 is split into equal sub-buckets,
+ * such that any percentile is reported within 12.5% of its actual value.
+ * Latencies are recorded with relaxed atomics, recording never blocks and
+ * a histogram may be summarized while being recorded into. */
+typedef struct {
+	uint64_t count;                                 // Number of recorded latencies.
+	uint64_t sum;                                   // Sum of recorded latencies in microseconds.
+	uint64_t max;                                   // Longest recorded latency in microseconds.
+	uint64_t buckets[LATENCY_HISTOGRAM_BUCKETS];    // Latency counts.
+} LatencyHistogram;
+
+// Summary of a histogram's distribution, latencies in milliseconds.
+typedef struct {
+	uint64_t count; // Number of recorded latencies.
+	double mean;    // Mean latency.
+	double p50;     // Median latency.
+	double p90;     // 90th percentile latency.
+	double p99;     // 99th percentile latency.
+	double p999;    // 99.9th percentile latency.
+	double max;     // Longest latency.
+} LatencySummary;
+
+// Create a new, empty, histogram.
+LatencyHistogram *LatencyHistogram_New(void);
+
+// Record a latency of ms milliseconds.
+void LatencyHistogram_Record(LatencyHistogram *h, double ms);
+
+// Returns the latency in milliseconds below which the given fraction of latencies fall.
+double LatencyHistogram_Percentile(const LatencyHistogram *h, double percentile);
+
+// Summarize the recorded latencies.
+LatencySummary LatencyHistogram_Summarize(const LatencyHistogram *h);
+
+// Free histogram.
+void LatencyHistogram_Free(LatencyHistogram *h);
@@ -0,0 +1,144 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "lz4.h"
+#include <string.h>
+#include <stdbool.h>
+
+#define LZ4_MIN_MATCH 4         // Shortest match encoded.
+#define LZ4_LAST_LITERALS 5     // A block ends with at least that many literals.
+#define LZ4_MF_LIMIT 12         // The last match starts at least that many bytes before the end.
+#define LZ4_MAX_OFFSET 65535    // Farthest match distance.
+#define LZ4_HASH_LOG 12         // Log2 of the number of hash table entries.
+#define LZ4_SKIP_TRIGGER 6      // Log2 of the number of misses past which the search step grows.
+
+static inline uint32_t _LZ4_Read32(const uint8_t *p) {
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint32_t _LZ4_Hash(uint32_t v) {
+	return (v * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+// Write the remainder of a length exceeding its token's 4 bits.
+static inline uint8_t *_LZ4_WriteLength(uint8_t *op, size_t len) {
+	for(; len >= 255; len -= 255) *op++ = 255;
+	*op++ = (uint8_t)len;
+	return op;
+}
+
+// Write a token and its literals, returns the token for the match length to be set.
+static inline uint8_t *_LZ4_WriteLiterals(uint8_t **op, const uint8_t *literals, size_t len) {
+	uint8_t *token = (*op)++;
+	if(len >= 15) {
+		*token = 15 << 4;
+		*op = _LZ4_WriteLength(*op, len - 15);
+	} else {
+		*token = len << 4;
+	}
+	memcpy(*op, literals, len);
+	*op += len;
+	return token;
+}
+
+size_t LZ4_Compress(const char *src, size_t len, char *dst) {
+	const uint8_t *base = (const uint8_t *)src;
+	const uint8_t *ip = base;
+	const uint8_t *anchor = base;
+	const uint8_t *end = base + len;
+	uint8_t *op = (uint8_t *)dst;
+
+	if(len > LZ4_MF_LIMIT) {
+		// Position of the last sequence seen per hash, relative to base.
+		uint32_t table[1 << LZ4_HASH_LOG] = {0};
+		const uint8_t *match_limit = end - LZ4_MF_LIMIT;
+		const uint8_t *match_end_limit = end - LZ4_LAST_LITERALS;
+
+		while(ip <= match_limit) {
+			uint32_t seq = _LZ4_Read32(ip);
+			uint32_t h = _LZ4_Hash(seq);
+			const uint8_t *ref = base + table[h];
+			table[h] = ip - base;
+			if(ref >= ip || ip - ref > LZ4_MAX_OFFSET || _LZ4_Read32(ref) != seq) {
+				// Incompressible regions are scanned with a growing step.
+				ip += 1 + ((ip - anchor) >> LZ4_SKIP_TRIGGER);
+				continue;
+			}
+
+			const uint8_t *mp = ip + LZ4_MIN_MATCH;
+			const uint8_t *mr = ref + LZ4_MIN_MATCH;
+			while(mp < match_end_limit && *mp == *mr) {
+				mp++;
+				mr++;
+			}
+
+			uint8_t *token = _LZ4_WriteLiterals(&op, anchor, ip - anchor);
+			uint16_t offset = ip - ref;
+			*op++ = offset & 0xFF;
+			*op++ = offset >> 8;
+			size_t match_len = mp - ip - LZ4_MIN_MATCH;
+			if(match_len >= 15) {
+				*token |= 15;
+				op = _LZ4_WriteLength(op, match_len - 15);
+			} else {
+				*token |= match_len;
+			}
+			ip = mp;
+			anchor = ip;
+		}
+	}
+
+	// The block ends with the remaining literals.
+	_LZ4_WriteLiterals(&op, anchor, end - anchor);
+	return op - (uint8_t *)dst;
+}
+
+// Read the remainder of a length exceeding its token's 4 bits.
+static inline bool _LZ4_ReadLength(const uint8_t **ip, const uint8_t *end, size_t *len) {
+	uint8_t b;
+	do {
+		if(*ip >= end) return false;
+		b = *(*ip)++;
+		*len += b;
+	} while(b == 255);
+	return true;
+}
+
+int64_t LZ4_Decompress(const char *src, size_t len, char *dst, size_t capacity) {
+	const uint8_t *ip = (const uint8_t *)src;
+	const uint8_t *end = ip + len;
+	uint8_t *op = (uint8_t *)dst;
+	uint8_t *op_end = op + capacity;
+
+	while(ip < end) {
+		uint8_t token = *ip++;
+		size_t lit_len = token >> 4;
+		if(lit_len == 15 && !_LZ4_ReadLength(&ip, end, &lit_len)) return -1;
+		if((size_t)(end - ip) < lit_len || (size_t)(op_end - op) < lit_len) return -1;
+		memcpy(op, ip, lit_len);
+		ip += lit_len;
+		op += lit_len;
+		// The last sequence holds literals only.
+		if(ip == end) break;
+
+		if(end - ip < 2) return -1;
+		size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if(offset == 0 || offset > (size_t)(op - (uint8_t *)dst)) return -1;
+		size_t match_len = token & 15;
+		if(match_len == 15 && !_LZ4_ReadLength(&ip, end, &match_len)) return -1;
+		match_len += LZ4_MIN_MATCH;
+		if((size_t)(op_end - op) < match_len) return -1;
+		// Matches may overlap their own output, copy byte by byte.
+		const uint8_t *mr = op - offset;
+		for(size_t i = 0; i < match_len; i++) op[i] = mr[i];
+		op += match_len;
+	}
+
+	return op - (uint8_t *)dst;
+}
@@ -0,0 +1,26 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Compression of buffers into the LZ4 block format, readable by any LZ4 implementation
+ * decompressing raw blocks, e.g. LZ4_decompress_safe or lz4.block.decompress.
+ * Matches are located through a single probe hash table, trading compression
+ * ratio for speed, as replies are compressed on the query's thread. */
+
+// Maximum size of the compressed form of a len bytes buffer.
+#define LZ4_COMPRESS_BOUND(len) ((len) + (len) / 255 + 16)
+
+/* Compress the len bytes of src into dst, which must hold LZ4_COMPRESS_BOUND(len) bytes.
+ * Returns the compressed size. */
+size_t LZ4_Compress(const char *src, size_t len, char *dst);
+
+/* Decompress the len bytes block src into dst, holding up to capacity bytes.
+ * Returns the decompressed size, -1 if the block is malformed or exceeds capacity. */
+int64_t LZ4_Decompress(const char *src, size_t len, char *dst, size_t capacity);
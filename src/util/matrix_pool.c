@@ -0,0 +1,69 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "matrix_pool.h"
+#include <assert.h>
+
+typedef struct {
+	GrB_Matrix m;       // Cleared matrix.
+	GrB_Index nrows;    // Number of rows.
+	GrB_Index ncols;    // Number of columns.
+} PooledMatrix;
+
+static __thread PooledMatrix _idle[MATRIX_POOL_CAP];
+static __thread uint _idle_count = 0;
+
+// Position of n's most significant bit.
+static inline int _MatrixPool_RowClass(GrB_Index n) {
+	return (n == 0) ? -1 : 63 - __builtin_clzll(n);
+}
+
+// Removes the idx retained matrix, returns it.
+static GrB_Matrix _MatrixPool_Take(uint idx) {
+	GrB_Matrix m = _idle[idx].m;
+	_idle[idx] = _idle[--_idle_count];
+	return m;
+}
+
+GrB_Matrix MatrixPool_Acquire(GrB_Index nrows, GrB_Index ncols) {
+	// Prefer a matrix of equal dimensions, most recently released first.
+	for(int i = _idle_count - 1; i >= 0; i--) {
+		if(_idle[i].nrows == nrows && _idle[i].ncols == ncols) return _MatrixPool_Take(i);
+	}
+
+	int row_class = _MatrixPool_RowClass(nrows);
+	for(int i = _idle_count - 1; i >= 0; i--) {
+		if(_MatrixPool_RowClass(_idle[i].nrows) != row_class) continue;
+		GrB_Matrix m = _MatrixPool_Take(i);
+		// Resizing an empty matrix only reallocates its row pointers.
+		GrB_Info info = GxB_Matrix_resize(m, nrows, ncols);
+		assert(info == GrB_SUCCESS);
+		return m;
+	}
+
+	GrB_Matrix m;
+	GrB_Info info = GrB_Matrix_new(&m, GrB_BOOL, nrows, ncols);
+	assert(info == GrB_SUCCESS);
+	return m;
+}
+
+void MatrixPool_Release(GrB_Matrix *m) {
+	assert(m);
+	if(*m == GrB_NULL) return;
+
+	if(_idle_count == MATRIX_POOL_CAP) {
+		GrB_Matrix_free(m);
+		*m = GrB_NULL;
+		return;
+	}
+
+	PooledMatrix *pooled = _idle + _idle_count++;
+	GrB_Matrix_clear(*m);
+	GrB_Matrix_nrows(&pooled->nrows, *m);
+	GrB_Matrix_ncols(&pooled->ncols, *m);
+	pooled->m = *m;
+	*m = GrB_NULL;
+}
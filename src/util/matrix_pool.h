@@ -0,0 +1,24 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// Number of released matrices retained by each thread.
+#define MATRIX_POOL_CAP 8
+
+/* Boolean matrices used as temporaries, such as traversal filter and result matrices,
+ * are retained, cleared, by the thread which released them, for reuse by the
+ * thread's following operations. A retained matrix is reused for matrices of equal
+ * dimensions, or resized for matrices whose row count is of the same power of two,
+ * such that the memory of an empty matrix, proportional to its rows, is retained. */
+
+// Retrieve an empty boolean matrix of nrows by ncols.
+GrB_Matrix MatrixPool_Acquire(GrB_Index nrows, GrB_Index ncols);
+
+// Release a matrix retrieved by MatrixPool_Acquire, sets m to GrB_NULL.
+void MatrixPool_Release(GrB_Matrix *m);
@@ -0,0 +1,148 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "numa.h"
+#include "rmalloc.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <assert.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+// Memory policy, interleave pages across nodes, see set_mempolicy(2).
+#define NUMA_MPOL_INTERLEAVE 3
+// mbind(2) flag, migrate pages already in use.
+#define NUMA_MPOL_MF_MOVE (1 << 1)
+
+static int _node_count = 1;                 // Number of NUMA nodes.
+static bool _interleave = false;            // Interleave large allocations.
+static unsigned long _node_mask = 1;        // Bitmask of online nodes.
+#if defined(__linux__)
+static cpu_set_t _node_cpus[NUMA_MAX_NODES]; // CPUs of each node.
+#endif
+
+/* Parses a sysfs list such as "0-3,8-11", setting the bit of each listed id.
+ * Returns the number of ids parsed, -1 if the list couldn't be read. */
+static int _NUMA_ParseList(const char *path, void (*set)(int id, void *ctx), void *ctx) {
+	FILE *f = fopen(path, "r");
+	if(f == NULL) return -1;
+
+	int count = 0;
+	int from;
+	int to;
+	char sep;
+	while(fscanf(f, "%d", &from) == 1) {
+		to = from;
+		sep = fgetc(f);
+		if(sep == '-') {
+			if(fscanf(f, "%d", &to) != 1) break;
+			sep = fgetc(f);
+		}
+		for(int id = from; id <= to; id++) {
+			set(id, ctx);
+			count++;
+		}
+		if(sep != ',') break;
+	}
+
+	fclose(f);
+	return count;
+}
+
+#if defined(__linux__)
+static void _NUMA_SetNode(int id, void *ctx) {
+	if(id < NUMA_MAX_NODES) *(unsigned long *)ctx |= (1UL << id);
+}
+
+static void _NUMA_SetCPU(int id, void *ctx) {
+	if(id < CPU_SETSIZE) CPU_SET(id, (cpu_set_t *)ctx);
+}
+#endif
+
+int NUMA_Init(bool interleave) {
+	_interleave = false;
+#if defined(__linux__)
+	unsigned long mask = 0;
+	if(_NUMA_ParseList("/sys/devices/system/node/online", _NUMA_SetNode, &mask) <= 0) return 1;
+
+	// Nodes are expected to be numbered densely.
+	int node_count = 0;
+	while(node_count < NUMA_MAX_NODES && (mask & (1UL << node_count))) {
+		char path[64];
+		snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node_count);
+		CPU_ZERO(&_node_cpus[node_count]);
+		if(_NUMA_ParseList(path, _NUMA_SetCPU, &_node_cpus[node_count]) <= 0) break;
+		node_count++;
+	}
+	if(node_count == 0) return 1;
+
+	_node_count = node_count;
+	_node_mask = (node_count == NUMA_MAX_NODES) ? ~0UL : (1UL << node_count) - 1;
+	_interleave = interleave && node_count > 1;
+#endif
+	return _node_count;
+}
+
+int NUMA_NodeCount(void) {
+	return _node_count;
+}
+
+bool NUMA_InterleaveEnabled(void) {
+	return _interleave;
+}
+
+bool NUMA_PinThread(pthread_t thread, int node) {
+#if defined(__linux__)
+	if(_node_count < 2) return false;
+	assert(node >= 0 && node < _node_count);
+	return pthread_setaffinity_np(thread, sizeof(cpu_set_t), &_node_cpus[node]) == 0;
+#else
+	return false;
+#endif
+}
+
+void NUMA_Interleave(void *addr, size_t size) {
+#if defined(__linux__) && defined(SYS_mbind)
+	if(!_interleave || size < NUMA_INTERLEAVE_THRESHOLD) return;
+
+	// Policy applies to whole pages, restrict to the pages contained within the region
+	// such that neighboring allocations are unaffected.
+	uintptr_t page_size = sysconf(_SC_PAGESIZE);
+	uintptr_t start = ((uintptr_t)addr + page_size - 1) & ~(page_size - 1);
+	uintptr_t end = ((uintptr_t)addr + size) & ~(page_size - 1);
+	if(end <= start) return;
+
+	// Best effort, allocation is usable regardless of placement.
+	syscall(SYS_mbind, start, end - start, NUMA_MPOL_INTERLEAVE, &_node_mask,
+			NUMA_MAX_NODES + 1, NUMA_MPOL_MF_MOVE);
+#endif
+}
+
+void *NUMA_Malloc(size_t size) {
+	void *p = rm_malloc(size);
+	if(p) NUMA_Interleave(p, size);
+	return p;
+}
+
+void *NUMA_Calloc(size_t nelem, size_t elemsz) {
+	void *p = rm_calloc(nelem, elemsz);
+	if(p) NUMA_Interleave(p, nelem * elemsz);
+	return p;
+}
+
+void *NUMA_Realloc(void *p, size_t size) {
+	p = rm_realloc(p, size);
+	if(p) NUMA_Interleave(p, size);
+	return p;
+}
+
+void NUMA_Free(void *p) {
+	rm_free(p);
+}
@@ -0,0 +1,45 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+// Maximum number of NUMA nodes supported.
+#define NUMA_MAX_NODES 64
+
+// Allocations of at least this many bytes are interleaved across NUMA nodes.
+#define NUMA_INTERLEAVE_THRESHOLD (2 * 1024 * 1024)
+
+/* Discovers the host's NUMA topology and, if enabled and the host has
+ * multiple NUMA nodes, turns on interleaving of large allocations.
+ * Returns the number of NUMA nodes, 1 if topology is unavailable. */
+int NUMA_Init(bool interleave);
+
+// Returns the number of NUMA nodes, 1 if topology is unavailable.
+int NUMA_NodeCount(void);
+
+// Returns true if large allocations are interleaved across NUMA nodes.
+bool NUMA_InterleaveEnabled(void);
+
+/* Restricts thread to the CPUs of the given NUMA node,
+ * such that its memory is first touched on its own node.
+ * Returns false if the thread's affinity couldn't be set. */
+bool NUMA_PinThread(pthread_t thread, int node);
+
+/* Spreads the pages of the given memory region across all NUMA nodes,
+ * only performed for regions of at least NUMA_INTERLEAVE_THRESHOLD bytes
+ * and when interleaving is enabled. Pages already touched are migrated. */
+void NUMA_Interleave(void *addr, size_t size);
+
+/* Allocation routines interleaving large allocations,
+ * handed to GraphBLAS such that matrix arrays are spread across nodes. */
+void *NUMA_Malloc(size_t size);
+void *NUMA_Calloc(size_t nelem, size_t elemsz);
+void *NUMA_Realloc(void *p, size_t size);
+void NUMA_Free(void *p);
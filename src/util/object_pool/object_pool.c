@@ -129,6 +129,32 @@ void ObjectPool_DeleteItem(ObjectPool *pool, void *item) {
 	pool->itemCount--;
 }
 
+uint ObjectPool_ItemSize(const ObjectPool *pool) {
+	return pool->itemSize - HEADER_SIZE;
+}
+
+void ObjectPool_Trim(ObjectPool *pool, uint64_t itemCap) {
+	assert(pool && pool->itemCount == 0);
+	uint blockCount = ITEM_COUNT_TO_BLOCK_COUNT(itemCap);
+	if(blockCount == 0) blockCount = 1;
+	if(pool->blockCount <= blockCount) return;
+
+	for(uint i = blockCount; i < pool->blockCount; i++) Block_Free(pool->blocks[i]);
+	pool->blockCount = blockCount;
+	pool->blocks = rm_realloc(pool->blocks, sizeof(Block *) * blockCount);
+	pool->blocks[blockCount - 1]->next = NULL;
+	pool->itemCap = blockCount * POOL_BLOCK_CAP;
+
+	/* Forget the released items. Items are first allocated in index order,
+	 * the retained ones remain a prefix of the indices, free for reuse. */
+	uint32_t kept = 0;
+	uint32_t deleted = array_len(pool->deletedIdx);
+	for(uint32_t i = 0; i < deleted; i++) {
+		if(pool->deletedIdx[i] < pool->itemCap) pool->deletedIdx[kept++] = pool->deletedIdx[i];
+	}
+	array_trimm_len(pool->deletedIdx, kept);
+}
+
 void ObjectPool_Free(ObjectPool *pool) {
 	for(uint i = 0; i < pool->blockCount; i++) Block_Free(pool->blocks[i]);
 
@@ -40,6 +40,13 @@ void *ObjectPool_NewItem(ObjectPool *pool);
 // Removes item from pool.
 void ObjectPool_DeleteItem(ObjectPool *pool, void *item);
 
+// Returns the size of a single item in bytes.
+uint ObjectPool_ItemSize(const ObjectPool *pool);
+
+// Releases the blocks beyond those required to hold itemCap items,
+// pool must not hold any items.
+void ObjectPool_Trim(ObjectPool *pool, uint64_t itemCap);
+
 // Free pool.
 void ObjectPool_Free(ObjectPool *pool);
 
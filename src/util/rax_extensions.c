@@ -54,3 +54,10 @@ void **raxValues(rax *rax) {
 	return values;
 }
 
+
+size_t raxMemoryUsage(const rax *rax) {
+	/* Each node holds a header, its edge characters padded to a pointer boundary
+	 * and a child pointer per edge, key nodes hold a value pointer as well. */
+	size_t node_size = sizeof(raxNode) + sizeof(void *) + sizeof(raxNode *);
+	return sizeof(*rax) + rax->numnodes * node_size + rax->numele * sizeof(void *);
+}
@@ -20,3 +20,6 @@ rax *raxClone(rax *orig);
 // This function assumes that each value is a pointer (or at least an 8-byte payload).
 void **raxValues(rax *rax);
 
+
+// Estimates the bytes held by a rax's nodes, excluding memory referenced by its values.
+size_t raxMemoryUsage(const rax *rax);
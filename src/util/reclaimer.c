@@ -0,0 +1,74 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "reclaimer.h"
+#include "arr.h"
+#include <assert.h>
+#include <pthread.h>
+
+// An object being reclaimed.
+typedef struct {
+	ReclaimStep step;   // Frees part of the object.
+	void *arg;          // The object.
+} ReclaimJob;
+
+static bool running = false;                    // The reclaimer thread is running.
+static ReclaimJob *jobs = NULL;                 // Objects being reclaimed, guarded by lock.
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pending = PTHREAD_COND_INITIALIZER;  // Signaled as objects are handed over.
+
+// Runs on a dedicated thread, frees the objects handed over to it round robin, a step at a time.
+static void *_Reclaimer_Run(void *arg) {
+	uint next = 0;
+	while(true) {
+		pthread_mutex_lock(&lock);
+		while(array_len(jobs) == 0) pthread_cond_wait(&pending, &lock);
+		if(next >= array_len(jobs)) next = 0;
+		// Jobs are only removed by this thread, next refers to the same job once the lock is released.
+		ReclaimJob job = jobs[next];
+		pthread_mutex_unlock(&lock);
+
+		bool done = job.step(job.arg);
+
+		pthread_mutex_lock(&lock);
+		if(done) {
+			jobs[next] = jobs[array_len(jobs) - 1];
+			array_pop(jobs);
+		} else {
+			next++;
+		}
+		pthread_mutex_unlock(&lock);
+	}
+	return NULL;
+}
+
+bool Reclaimer_Start(void) {
+	assert(!running);
+	jobs = array_new(ReclaimJob, 4);
+
+	pthread_t thread;
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	int res = pthread_create(&thread, &attr, _Reclaimer_Run, NULL);
+	pthread_attr_destroy(&attr);
+	running = (res == 0);
+	return running;
+}
+
+void Reclaimer_Add(ReclaimStep step, void *arg) {
+	assert(step);
+	if(!running) {
+		while(!step(arg));
+		return;
+	}
+
+	ReclaimJob job = {.step = step, .arg = arg};
+	pthread_mutex_lock(&lock);
+	jobs = array_append(jobs, job);
+	pthread_cond_signal(&pending);
+	pthread_mutex_unlock(&lock);
+}
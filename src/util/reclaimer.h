@@ -0,0 +1,21 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdbool.h>
+
+// Frees part of an object, returns true once the object is entirely freed.
+typedef bool (*ReclaimStep)(void *arg);
+
+/* Spawns the reclaimer, a thread freeing the objects handed over to it in steps,
+ * objects reclaimed at the same time take turns, a step at a time.
+ * Returns false if the thread couldn't be spawned. */
+bool Reclaimer_Start(void);
+
+/* Hands an object over to the reclaimer, step is invoked with arg until it returns true.
+ * If the reclaimer isn't running the object is freed by the calling thread. */
+void Reclaimer_Add(ReclaimStep step, void *arg);
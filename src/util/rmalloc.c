@@ -1,5 +1,7 @@
 #include "rmalloc.h"
 
+__thread MemAccount *rm_account = NULL;
+
 /* Redefine the allocator functions to use the malloc family.
  * Only to be used when running module code from a non-Redis
  * context, such as unit tests. */
@@ -9,4 +11,16 @@ void Alloc_Reset() {
   RedisModule_Calloc = calloc;
   RedisModule_Free = free;
   RedisModule_Strdup = strdup;
+  // Sizes of allocations aren't known, allocations aren't accounted.
+  RedisModule_MallocSize = NULL;
+}
+
+bool Alloc_AccountingSupported(void) {
+  // Servers predating RedisModule_MallocSize leave it unset.
+  return RedisModule_MallocSize != NULL;
+}
+
+void Alloc_SetAccount(MemAccount *account) {
+  if(!Alloc_AccountingSupported()) return;
+  rm_account = account;
 }
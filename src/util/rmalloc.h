@@ -3,24 +3,60 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include "../redismodule.h"
 
+// Memory allocated through the rm_* routines by a single thread, such as a query's.
+typedef struct {
+	int64_t allocated;  // Bytes currently allocated, frees of earlier allocations may drive it negative.
+	int64_t peak;       // Maximum number of bytes allocated at once.
+	int64_t capacity;   // Bytes allocated beyond which exceeded is set, 0 for unlimited.
+	bool exceeded;      // Set once allocated went beyond capacity.
+} MemAccount;
+
+// The account charged for the calling thread's allocations, NULL if not accounting.
+extern __thread MemAccount *rm_account;
+
 #ifdef REDIS_MODULE_TARGET /* Set this when compiling your code as a module */
 
+static inline void _rm_charge(void *p, int64_t sign) {
+	MemAccount *account = rm_account;
+	account->allocated += sign * (int64_t)RedisModule_MallocSize(p);
+	if(account->allocated > account->peak) {
+		account->peak = account->allocated;
+		if(account->capacity && account->peak > account->capacity) account->exceeded = true;
+	}
+}
+
 static inline void *rm_malloc(size_t n) {
-	return RedisModule_Alloc(n);
+	void *p = RedisModule_Alloc(n);
+	if(rm_account && p) _rm_charge(p, 1);
+	return p;
 }
 static inline void *rm_calloc(size_t nelem, size_t elemsz) {
-	return RedisModule_Calloc(nelem, elemsz);
+	void *p = RedisModule_Calloc(nelem, elemsz);
+	if(rm_account && p) _rm_charge(p, 1);
+	return p;
 }
 static inline void *rm_realloc(void *p, size_t n) {
-	return RedisModule_Realloc(p, n);
+	if(rm_account == NULL) return RedisModule_Realloc(p, n);
+	size_t size = (p) ? RedisModule_MallocSize(p) : 0;
+	void *q = RedisModule_Realloc(p, n);
+	if(q) {
+		rm_account->allocated -= size;
+		_rm_charge(q, 1);
+	}
+	return q;
 }
 static inline void rm_free(void *p) {
+	if(rm_account && p) _rm_charge(p, -1);
 	RedisModule_Free(p);
 }
 static inline char *rm_strdup(const char *s) {
-	return RedisModule_Strdup(s);
+	char *p = RedisModule_Strdup(s);
+	if(rm_account && p) _rm_charge(p, 1);
+	return p;
 }
 
 static inline char *rm_strndup(const char *s, size_t n) {
@@ -52,5 +88,13 @@ static inline char *rm_strndup(const char *s, size_t n) {
  * contexts like unit tests. */
 void Alloc_Reset(void);
 
+/* Returns true if allocations can be accounted, which requires
+ * the allocator to report the size of allocations. */
+bool Alloc_AccountingSupported(void);
+
+/* Charge the calling thread's following allocations to account,
+ * a NULL account stops accounting. Has no effect if accounting isn't supported. */
+void Alloc_SetAccount(MemAccount *account);
+
 #endif
 
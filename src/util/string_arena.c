@@ -0,0 +1,53 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "string_arena.h"
+#include "rmalloc.h"
+#include <assert.h>
+#include <string.h>
+
+/* An arena starts with the number of strings it holds which are yet to be released,
+ * each string is prefixed by its offset from the start of the arena. */
+typedef uint32_t ArenaOffset;
+
+void StringArena_New(const char **strings, uint32_t count, char **copies) {
+	assert(strings && copies && count > 0);
+
+	size_t size = sizeof(uint32_t);
+	for(uint32_t i = 0; i < count; i++) {
+		assert(strlen(strings[i]) <= STRING_ARENA_MAX_LEN);
+		size += sizeof(ArenaOffset) + strlen(strings[i]) + 1;
+	}
+
+	char *arena = rm_malloc(size);
+	memcpy(arena, &count, sizeof(uint32_t));
+
+	char *pos = arena + sizeof(uint32_t);
+	for(uint32_t i = 0; i < count; i++) {
+		size_t len = strlen(strings[i]);
+		ArenaOffset offset = (pos - arena) + sizeof(ArenaOffset);
+		memcpy(pos, &offset, sizeof(ArenaOffset));
+		pos += sizeof(ArenaOffset);
+		memcpy(pos, strings[i], len + 1);
+		copies[i] = pos;
+		pos += len + 1;
+	}
+}
+
+void StringArena_Release(char *s) {
+	ArenaOffset offset;
+	memcpy(&offset, s - sizeof(ArenaOffset), sizeof(ArenaOffset));
+	char *arena = s - offset;
+
+	uint32_t refcount;
+	memcpy(&refcount, arena, sizeof(uint32_t));
+	assert(refcount > 0);
+	if(--refcount == 0) {
+		rm_free(arena);
+		return;
+	}
+	memcpy(arena, &refcount, sizeof(uint32_t));
+}
@@ -0,0 +1,25 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// Longest string, excluding its terminating NULL, held by an arena.
+#define STRING_ARENA_MAX_LEN 63
+
+/* A string arena holds copies of several short strings within a single allocation,
+ * such that values created together, e.g. the string properties of a new entity,
+ * are laid out next to one another and cost a single allocation.
+ * Each string held by an arena acquires a reference to it, the arena is freed
+ * once all of its strings are released. Arena strings are immutable. */
+
+/* Copies count strings, each no longer than STRING_ARENA_MAX_LEN,
+ * into a new arena, copies[i] is set to the arena's copy of strings[i]. */
+void StringArena_New(const char **strings, uint32_t count, char **copies);
+
+// Release an arena string, the arena is freed once all its strings are released.
+void StringArena_Release(char *s);
@@ -0,0 +1,69 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "string_matcher.h"
+#include "rmalloc.h"
+#include <string.h>
+
+StringMatcher *StringMatcher_New(const char *pattern, StringMatchMode mode) {
+	StringMatcher *matcher = rm_malloc(sizeof(StringMatcher));
+	matcher->mode = mode;
+	matcher->len = strlen(pattern);
+	matcher->pattern = rm_strdup(pattern);
+
+	if(mode == STRING_MATCH_CONTAINS) {
+		/* Once the window's last character mismatches, the window advances
+		 * until that character aligns with its last occurrence in the pattern,
+		 * excluding the pattern's final character. */
+		for(uint32_t c = 0; c < 256; c++) matcher->skip[c] = matcher->len;
+		for(uint32_t i = 0; i + 1 < matcher->len; i++) {
+			matcher->skip[(unsigned char)pattern[i]] = matcher->len - 1 - i;
+		}
+	}
+
+	return matcher;
+}
+
+static bool _StringMatcher_Contains(const StringMatcher *matcher, const char *str) {
+	uint32_t len = matcher->len;
+	if(len == 0) return true;
+	if(len == 1) return strchr(str, matcher->pattern[0]) != NULL;
+
+	size_t str_len = strlen(str);
+	if(str_len < len) return false;
+
+	const char *pattern = matcher->pattern;
+	unsigned char last = pattern[len - 1];
+	size_t end = str_len - len;
+	for(size_t i = 0; i <= end;) {
+		unsigned char c = str[i + len - 1];
+		if(c == last && memcmp(str + i, pattern, len - 1) == 0) return true;
+		i += matcher->skip[c];
+	}
+	return false;
+}
+
+bool StringMatcher_Match(const StringMatcher *matcher, const char *str) {
+	switch(matcher->mode) {
+	case STRING_MATCH_CONTAINS:
+		return _StringMatcher_Contains(matcher, str);
+	case STRING_MATCH_PREFIX:
+		// Stops at the end of str, which can't match the pattern's characters.
+		return strncmp(str, matcher->pattern, matcher->len) == 0;
+	case STRING_MATCH_SUFFIX: {
+		size_t str_len = strlen(str);
+		if(str_len < matcher->len) return false;
+		return memcmp(str + str_len - matcher->len, matcher->pattern, matcher->len) == 0;
+	}
+	default:
+		return false;
+	}
+}
+
+void StringMatcher_Free(StringMatcher *matcher) {
+	rm_free(matcher->pattern);
+	rm_free(matcher);
+}
@@ -0,0 +1,36 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+	STRING_MATCH_CONTAINS,  // Pattern occurs anywhere within the string.
+	STRING_MATCH_PREFIX,    // String starts with pattern.
+	STRING_MATCH_SUFFIX,    // String ends with pattern.
+} StringMatchMode;
+
+/* A string matcher tests strings against a fixed pattern, preprocessing the
+ * pattern once such that testing many strings, e.g. a constant predicate
+ * evaluated per record, doesn't repeat the work.
+ * Substring search uses the Boyer-Moore-Horspool skip table. */
+typedef struct {
+	StringMatchMode mode;   // Kind of match performed.
+	char *pattern;          // Copy of the pattern.
+	uint32_t len;           // Pattern length, excluding its terminating NULL.
+	uint32_t skip[256];     // Shift per last window character, substring search only.
+} StringMatcher;
+
+// Create a new matcher of pattern, the pattern is copied.
+StringMatcher *StringMatcher_New(const char *pattern, StringMatchMode mode);
+
+// Returns true if str matches the matcher's pattern.
+bool StringMatcher_Match(const StringMatcher *matcher, const char *str);
+
+// Free matcher.
+void StringMatcher_Free(StringMatcher *matcher);
@@ -0,0 +1,71 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "string_pool.h"
+#include "rmalloc.h"
+#include "rax.h"
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+struct StringPool {
+	rax *strings;           // Maps string content to its pooled entry.
+};
+
+// A pooled string, prefixed by the pool owning it and its reference count.
+typedef struct {
+	StringPool *pool;       // Pool holding string.
+	uint64_t refcount;      // Number of references to string.
+	char str[];             // String content, MUST BE LAST MEMBER OF THE STRUCT!
+} PooledString;
+
+// Maps a pooled string to its entry.
+static inline PooledString *_StringPool_Entry(char *s) {
+	return (PooledString *)(s - offsetof(PooledString, str));
+}
+
+StringPool *StringPool_New(void) {
+	StringPool *pool = rm_malloc(sizeof(StringPool));
+	pool->strings = raxNew();
+	return pool;
+}
+
+char *StringPool_Intern(StringPool *pool, const char *s) {
+	assert(pool && s);
+	size_t len = strlen(s);
+	PooledString *entry = raxFind(pool->strings, (unsigned char *)s, len);
+	if(entry != raxNotFound) return entry->str;
+
+	entry = rm_malloc(sizeof(PooledString) + len + 1);
+	entry->pool = pool;
+	entry->refcount = 0;
+	memcpy(entry->str, s, len + 1);
+	raxInsert(pool->strings, (unsigned char *)entry->str, len, entry, NULL);
+	return entry->str;
+}
+
+void StringPool_Retain(char *s) {
+	_StringPool_Entry(s)->refcount++;
+}
+
+void StringPool_Release(char *s) {
+	PooledString *entry = _StringPool_Entry(s);
+	assert(entry->refcount > 0);
+	if(--entry->refcount > 0) return;
+
+	raxRemove(entry->pool->strings, (unsigned char *)entry->str, strlen(entry->str), NULL);
+	rm_free(entry);
+}
+
+uint64_t StringPool_Count(const StringPool *pool) {
+	return raxSize(pool->strings);
+}
+
+void StringPool_Free(StringPool *pool) {
+	if(pool == NULL) return;
+	raxFreeWithCallback(pool->strings, rm_free);
+	rm_free(pool);
+}
@@ -0,0 +1,36 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/* StringPool holds a single, reference counted, copy of each distinct string
+ * introduced to it, allowing entities sharing a value to share its allocation.
+ * Pooled strings are immutable, identical strings interned with the same pool
+ * share the same address.
+ * A pool is not thread-safe, it is expected to be accessed by its graph's writer. */
+typedef struct StringPool StringPool;
+
+// Create a new, empty, pool.
+StringPool *StringPool_New(void);
+
+/* Returns the pooled copy of s, introducing s to the pool if it's missing.
+ * The returned string is borrowed, a reference should be acquired
+ * using StringPool_Retain by whoever stores it. */
+char *StringPool_Intern(StringPool *pool, const char *s);
+
+// Acquire a reference to a pooled string.
+void StringPool_Retain(char *s);
+
+// Release a reference to a pooled string, the string is freed once unreferenced.
+void StringPool_Release(char *s);
+
+// Returns number of distinct strings held by pool.
+uint64_t StringPool_Count(const StringPool *pool);
+
+// Free pool and all strings it holds.
+void StringPool_Free(StringPool *pool);
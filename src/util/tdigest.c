@@ -0,0 +1,158 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "tdigest.h"
+#include "qsort.h"
+#include "rmalloc.h"
+#include <math.h>
+#include <float.h>
+#include <assert.h>
+
+// Initial number of centroids a digest can hold.
+#define TDIGEST_INITIAL_CAP 16
+
+#define CENTROID_LT(a, b) ((a)->mean < (b)->mean)
+
+// Scale function, maps quantile q to the centroid index space,
+// centroids may span at most a single unit of it.
+static inline double _k(double q) {
+	return TDIGEST_COMPRESSION / (2 * M_PI) * asin(2 * q - 1);
+}
+
+// Inverse of the scale function.
+static inline double _k_inverse(double k) {
+	if(k >= TDIGEST_COMPRESSION / 4.0) return 1;
+	return (sin(k * 2 * M_PI / TDIGEST_COMPRESSION) + 1) / 2;
+}
+
+// Merges buffered values into the centroids.
+static void _TDigest_Compress(TDigest *td) {
+	if(td->buffered == 0) return;
+
+	uint32_t n = td->merged + td->buffered;
+	TDigestCentroid *c = td->centroids;
+	QSORT(TDigestCentroid, c, n, CENTROID_LT);
+
+	// Greedily grow each centroid while its weight fits a single unit of the scale.
+	uint32_t out = 0;
+	double so_far = 0;
+	double q_limit = _k_inverse(_k(0) + 1);
+	TDigestCentroid cur = c[0];
+	for(uint32_t i = 1; i < n; i++) {
+		double proposed = cur.weight + c[i].weight;
+		if((so_far + proposed) / td->total <= q_limit) {
+			cur.mean += (c[i].mean - cur.mean) * c[i].weight / proposed;
+			cur.weight = proposed;
+		} else {
+			so_far += cur.weight;
+			c[out++] = cur;
+			q_limit = _k_inverse(_k(so_far / td->total) + 1);
+			cur = c[i];
+		}
+	}
+	c[out++] = cur;
+
+	td->merged = out;
+	td->buffered = 0;
+}
+
+// Buffers a weighted value, merging the buffer once the digest is full.
+static void _TDigest_AddWeighted(TDigest *td, double mean, double weight) {
+	if(td->merged + td->buffered == td->cap) {
+		if(td->cap < TDIGEST_CAPACITY) {
+			td->cap *= 2;
+			if(td->cap > TDIGEST_CAPACITY) td->cap = TDIGEST_CAPACITY;
+			td->centroids = rm_realloc(td->centroids, sizeof(TDigestCentroid) * td->cap);
+		} else {
+			_TDigest_Compress(td);
+		}
+	}
+
+	TDigestCentroid *c = td->centroids + td->merged + td->buffered;
+	c->mean = mean;
+	c->weight = weight;
+	td->buffered++;
+	td->total += weight;
+}
+
+TDigest *TDigest_New(void) {
+	TDigest *td = rm_malloc(sizeof(TDigest));
+	td->merged = 0;
+	td->buffered = 0;
+	td->cap = TDIGEST_INITIAL_CAP;
+	td->total = 0;
+	td->min = DBL_MAX;
+	td->max = -DBL_MAX;
+	td->centroids = rm_malloc(sizeof(TDigestCentroid) * td->cap);
+	return td;
+}
+
+void TDigest_Add(TDigest *td, double value) {
+	if(value < td->min) td->min = value;
+	if(value > td->max) td->max = value;
+	_TDigest_AddWeighted(td, value, 1);
+}
+
+void TDigest_Merge(TDigest *dst, TDigest *src) {
+	if(src->total == 0) return;
+	_TDigest_Compress(src);
+	if(src->min < dst->min) dst->min = src->min;
+	if(src->max > dst->max) dst->max = src->max;
+	for(uint32_t i = 0; i < src->merged; i++) {
+		_TDigest_AddWeighted(dst, src->centroids[i].mean, src->centroids[i].weight);
+	}
+}
+
+double TDigest_Quantile(TDigest *td, double q) {
+	assert(td->total > 0 && q >= 0 && q <= 1);
+	_TDigest_Compress(td);
+
+	const TDigestCentroid *c = td->centroids;
+	uint32_t n = td->merged;
+	if(n == 1 || q == 0 || q == 1) {
+		if(q == 0) return td->min;
+		if(q == 1) return td->max;
+		return c[0].mean;
+	}
+
+	// While every centroid holds a single value, interpolate between the values
+	// exactly as percentileCont does.
+	if(n == td->total) {
+		double idx = q * (n - 1);
+		uint32_t lower = (uint32_t)idx;
+		if(lower == n - 1) return c[lower].mean;
+		return c[lower].mean + (c[lower + 1].mean - c[lower].mean) * (idx - lower);
+	}
+
+	// Each centroid's mean is placed at the middle of its weight,
+	// the extremes bound the first and last halves.
+	double target = q * td->total;
+	double center = c[0].weight / 2;
+	if(target < center) {
+		return td->min + (c[0].mean - td->min) * target / center;
+	}
+
+	for(uint32_t i = 0; i < n - 1; i++) {
+		double next = center + (c[i].weight + c[i + 1].weight) / 2;
+		if(target < next) {
+			double fraction = (target - center) / (next - center);
+			return c[i].mean + (c[i + 1].mean - c[i].mean) * fraction;
+		}
+		center = next;
+	}
+
+	double tail = td->total - center;
+	return c[n - 1].mean + (td->max - c[n - 1].mean) * (target - center) / tail;
+}
+
+uint64_t TDigest_Count(const TDigest *td) {
+	return (uint64_t)td->total;
+}
+
+void TDigest_Free(TDigest *td) {
+	rm_free(td->centroids);
+	rm_free(td);
+}
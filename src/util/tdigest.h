@@ -0,0 +1,54 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// Compression, bounds the number of centroids, higher values are more accurate.
+#define TDIGEST_COMPRESSION 100
+// Maximum number of centroids, merged and buffered, held by a digest.
+#define TDIGEST_CAPACITY (6 * TDIGEST_COMPRESSION)
+
+typedef struct {
+	double mean;    // Mean of the values summarized by the centroid.
+	double weight;  // Number of values summarized by the centroid.
+} TDigestCentroid;
+
+/* A merging t-digest approximates the distribution of the values added to it
+ * within fixed memory. Values are summarized by centroids, which are small near
+ * the distribution's tails and larger around its median, such that extreme quantiles
+ * remain accurate. Added values are buffered and merged into the centroids once
+ * the buffer fills up. Digests built over different parts of the input merge into
+ * a digest of the whole input. */
+typedef struct {
+	uint32_t merged;            // Number of merged centroids.
+	uint32_t buffered;          // Number of buffered values, following the merged centroids.
+	uint32_t cap;               // Number of centroids the centroids array can hold.
+	double total;               // Total weight, including buffered values.
+	double min;                 // Smallest value added.
+	double max;                 // Largest value added.
+	TDigestCentroid *centroids; // Merged centroids, sorted by mean, followed by buffered values.
+} TDigest;
+
+// Create a new, empty, digest.
+TDigest *TDigest_New(void);
+
+// Add a value.
+void TDigest_Add(TDigest *td, double value);
+
+// Merge src into dst, dst then approximates the values added to either digest.
+void TDigest_Merge(TDigest *dst, TDigest *src);
+
+// Approximate the value at quantile q, within [0, 1], of the values added,
+// values between centroids are interpolated. The digest must not be empty.
+double TDigest_Quantile(TDigest *td, double q);
+
+// Returns the number of values added.
+uint64_t TDigest_Count(const TDigest *td);
+
+// Free digest.
+void TDigest_Free(TDigest *td);
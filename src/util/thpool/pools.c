@@ -0,0 +1,181 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "pools.h"
+#include "../numa.h"
+#include "../rmalloc.h"
+#include "../simple_timer.h"
+#include "../latency_histogram.h"
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+typedef struct {
+	threadpool pool;                            // Threads serving the lane.
+	uint64_t max_pending;                       // Maximum number of waiting jobs, 0 if unbounded.
+	uint64_t pending;                           // Number of jobs waiting for a thread.
+	uint64_t running;                           // Number of jobs executing.
+	uint64_t scheduled;                         // Number of jobs admitted.
+	uint64_t rejected;                          // Number of jobs rejected due to a full queue.
+	LatencyHistogram wait;                      // Time jobs spent waiting in queue.
+} Lane;
+
+// Job wrapper, tracking the time spent waiting in queue.
+typedef struct {
+	void (*function)(void *);   // Job function.
+	void *arg;                  // Job argument.
+	Lane *lane;                 // Lane the job was scheduled on.
+	double tic[2];              // Time at which the job was queued.
+} LaneJob;
+
+static Lane _lanes[THPOOL_LANE_COUNT];
+static __thread ThreadPoolLane _current_lane = THPOOL_LANE_COUNT;
+static __thread double _current_wait = 0;   // Milliseconds the executing job waited in queue.
+static const char *_lane_names[THPOOL_LANE_COUNT] = {"writer", "short_read", "long_read"};
+
+/* Reserve a slot in the lane's queue, all counters are updated atomically,
+ * admission never blocks. Returns false if the queue is full. */
+static bool _Lane_Admit(Lane *lane) {
+	uint64_t pending = __atomic_load_n(&lane->pending, __ATOMIC_RELAXED);
+	do {
+		if(lane->max_pending != 0 && pending >= lane->max_pending) {
+			__atomic_fetch_add(&lane->rejected, 1, __ATOMIC_RELAXED);
+			return false;
+		}
+	} while(!__atomic_compare_exchange_n(&lane->pending, &pending, pending + 1, true,
+										 __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+	__atomic_fetch_add(&lane->scheduled, 1, __ATOMIC_RELAXED);
+	return true;
+}
+
+// Runs on a pool thread, releases the job's queue slot and executes it.
+static void _LaneJob_Run(void *arg) {
+	LaneJob job = *(LaneJob *)arg;
+	rm_free(arg);
+
+	__atomic_fetch_sub(&job.lane->pending, 1, __ATOMIC_RELAXED);
+	_current_wait = simple_toc(job.tic) * 1000;
+	LatencyHistogram_Record(&job.lane->wait, _current_wait);
+
+	__atomic_fetch_add(&job.lane->running, 1, __ATOMIC_RELAXED);
+	_current_lane = job.lane - _lanes;
+	job.function(job.arg);
+	_current_lane = THPOOL_LANE_COUNT;
+	_current_wait = 0;
+	__atomic_fetch_sub(&job.lane->running, 1, __ATOMIC_RELAXED);
+}
+
+int ThreadPools_Init(const long long thread_counts[THPOOL_LANE_COUNT], uint64_t max_pending) {
+	for(int i = 0; i < THPOOL_LANE_COUNT; i++) {
+		Lane *lane = _lanes + i;
+		assert(lane->pool == NULL && thread_counts[i] > 0);
+		memset(lane, 0, sizeof(Lane));
+		lane->max_pending = max_pending;
+		lane->pool = thpool_init(thread_counts[i]);
+		if(lane->pool == NULL) return 0;
+	}
+	return 1;
+}
+
+int ThreadPools_AddWork(ThreadPoolLane lane, void (*function_p)(void *), void *arg_p) {
+	assert(lane < THPOOL_LANE_COUNT);
+	Lane *l = _lanes + lane;
+	if(!_Lane_Admit(l)) return -1;
+
+	LaneJob *job = rm_malloc(sizeof(LaneJob));
+	job->function = function_p;
+	job->arg = arg_p;
+	job->lane = l;
+	simple_tic(job->tic);
+
+	if(thpool_add_work(l->pool, _LaneJob_Run, job) != 0) {
+		__atomic_fetch_sub(&l->pending, 1, __ATOMIC_RELAXED);
+		rm_free(job);
+		return -1;
+	}
+	return 0;
+}
+
+int ThreadPools_LaneThreadCount(ThreadPoolLane lane) {
+	assert(lane < THPOOL_LANE_COUNT);
+	return thpool_num_threads(_lanes[lane].pool);
+}
+
+int ThreadPools_ThreadCount(void) {
+	int count = 0;
+	for(int lane = 0; lane < THPOOL_LANE_COUNT; lane++) {
+		count += thpool_num_threads(_lanes[lane].pool);
+	}
+	return count;
+}
+
+int ThreadPools_GetThreadID(void) {
+	pthread_t self = pthread_self();
+	// Offset each pool's ids by the number of threads in the preceding lanes.
+	int offset = 0;
+	for(int lane = 0; lane < THPOOL_LANE_COUNT; lane++) {
+		threadpool pool = _lanes[lane].pool;
+		int id = thpool_get_thread_id(pool, self);
+		if(id != -1) return offset + id;
+		offset += thpool_num_threads(pool);
+	}
+
+	// Could not locate thread, most likely Redis main thread.
+	return -1;
+}
+
+int ThreadPools_PinToNUMANodes(void) {
+	int node_count = NUMA_NodeCount();
+	if(node_count < 2) return 0;
+
+	// Each lane is spread across nodes independently.
+	int pinned = 0;
+	for(int lane = 0; lane < THPOOL_LANE_COUNT; lane++) {
+		threadpool pool = _lanes[lane].pool;
+		int thread_count = thpool_num_threads(pool);
+		for(int i = 0; i < thread_count; i++) {
+			if(NUMA_PinThread(thpool_get_thread(pool, i), i % node_count)) pinned++;
+		}
+	}
+	return pinned;
+}
+
+ThreadPoolLane ThreadPools_CurrentLane(void) {
+	return _current_lane;
+}
+
+double ThreadPools_CurrentWait(void) {
+	return _current_wait;
+}
+
+uint64_t ThreadPools_LaneRunning(ThreadPoolLane lane) {
+	assert(lane < THPOOL_LANE_COUNT);
+	return __atomic_load_n(&_lanes[lane].running, __ATOMIC_RELAXED);
+}
+
+const char *ThreadPools_LaneName(ThreadPoolLane lane) {
+	assert(lane < THPOOL_LANE_COUNT);
+	return _lane_names[lane];
+}
+
+ThreadPoolLaneStats ThreadPools_GetLaneStats(ThreadPoolLane lane) {
+	assert(lane < THPOOL_LANE_COUNT);
+	Lane *l = _lanes + lane;
+	LatencySummary wait = LatencyHistogram_Summarize(&l->wait);
+
+	ThreadPoolLaneStats stats = {
+		.pending = __atomic_load_n(&l->pending, __ATOMIC_RELAXED),
+		.max_pending = l->max_pending,
+		.scheduled = __atomic_load_n(&l->scheduled, __ATOMIC_RELAXED),
+		.rejected = __atomic_load_n(&l->rejected, __ATOMIC_RELAXED),
+		.wait_p50 = wait.p50,
+		.wait_p99 = wait.p99,
+		.wait_max = wait.max
+	};
+	return stats;
+}
@@ -0,0 +1,71 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <pthread.h>
+#include "thpool.h"
+
+/* Work is scheduled onto one of several lanes, each served by its own
+ * thread pool, such that a backlog in one lane doesn't delay work in another. */
+typedef enum {
+	THPOOL_LANE_WRITER,      // Queries which modify the graph.
+	THPOOL_LANE_SHORT_READ,  // Read-only queries expected to complete quickly.
+	THPOOL_LANE_LONG_READ,   // Read-only queries expected to be expensive.
+	THPOOL_LANE_COUNT
+} ThreadPoolLane;
+
+// Lane usage counters.
+typedef struct {
+	uint64_t pending;       // Number of jobs waiting for a thread.
+	uint64_t max_pending;   // Maximum number of waiting jobs, 0 if unbounded.
+	uint64_t scheduled;     // Number of jobs admitted.
+	uint64_t rejected;      // Number of jobs rejected due to a full queue.
+	double wait_p50;        // Median queue wait time in milliseconds.
+	double wait_p99;        // 99th percentile queue wait time in milliseconds.
+	double wait_max;        // Longest queue wait time in milliseconds.
+} ThreadPoolLaneStats;
+
+/* Create a thread pool for each lane, thread_counts specifies the number of
+ * threads serving each lane, max_pending bounds the number of jobs waiting
+ * on each lane, 0 for no bound. Returns 1 if all pools initialized, 0 otherwise. */
+int ThreadPools_Init(const long long thread_counts[THPOOL_LANE_COUNT], uint64_t max_pending);
+
+/* Schedule work on the specified lane.
+ * Returns 0 on success, -1 if the lane's queue is full or work couldn't be added. */
+int ThreadPools_AddWork(ThreadPoolLane lane, void (*function_p)(void *), void *arg_p);
+
+// Returns the number of threads serving the specified lane.
+int ThreadPools_LaneThreadCount(ThreadPoolLane lane);
+
+// Returns the total number of threads across all lanes.
+int ThreadPools_ThreadCount(void);
+
+/* Returns a friendly id in the range [0, ThreadPools_ThreadCount()) which is
+ * unique across all lanes, -1 if the calling thread doesn't belong to any pool. */
+int ThreadPools_GetThreadID(void);
+
+/* Distributes pool threads across NUMA nodes round robin, restricting each thread
+ * to the CPUs of its node. Returns the number of threads pinned. */
+int ThreadPools_PinToNUMANodes(void);
+
+/* Returns the lane of the job executing on the calling thread,
+ * THPOOL_LANE_COUNT if the calling thread isn't executing a pool job. */
+ThreadPoolLane ThreadPools_CurrentLane(void);
+
+/* Returns the number of milliseconds the job executing on the calling thread
+ * waited in queue, 0 if the calling thread isn't executing a pool job. */
+double ThreadPools_CurrentWait(void);
+
+// Returns the number of jobs currently executing on the specified lane.
+uint64_t ThreadPools_LaneRunning(ThreadPoolLane lane);
+
+// Returns the name of the specified lane.
+const char *ThreadPools_LaneName(ThreadPoolLane lane);
+
+// Retrieve a snapshot of the lane's usage counters.
+ThreadPoolLaneStats ThreadPools_GetLaneStats(ThreadPoolLane lane);
@@ -259,6 +259,11 @@ int thpool_get_thread_id(thpool_* thpool_p, pthread_t pthread) {
 	return -1;
 }
 
+pthread_t thpool_get_thread(thpool_* thpool_p, int id) {
+	assert(id >= 0 && id < thpool_p->num_threads_alive);
+	return thpool_p->threads[id]->pthread;
+}
+
 /* ============================ THREAD ============================== */
 
 /* Initialize a thread in the thread pool
@@ -200,6 +200,16 @@ int thpool_num_threads(threadpool);
  */
 int thpool_get_thread_id(threadpool, pthread_t);
 
+
+/**
+ * @brief Returns the thread associated with friendly id.
+ *
+ * @param threadpool    the threadpool of interest
+ * @param id            friendly thread id
+ * @return pthread_t    the thread of interest
+ */
+pthread_t thpool_get_thread(threadpool, int id);
+
 #ifdef __cplusplus
 }
 #endif
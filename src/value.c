@@ -15,6 +15,8 @@
 #include <sys/param.h>
 #include <assert.h>
 #include "util/rmalloc.h"
+#include "util/string_pool.h"
+#include "util/string_arena.h"
 #include "datatypes/array.h"
 #include "datatypes/path/sipath.h"
 
@@ -83,6 +85,12 @@ SIValue SI_EmptyArray() {
 	return SIArray_New(0);
 }
 
+SIValue SI_Point(float latitude, float longitude) {
+	return (SIValue) {
+		.point = {.latitude = latitude, .longitude = longitude}, .type = T_POINT
+	};
+}
+
 SIValue SI_DuplicateStringVal(const char *s) {
 	return (SIValue) {
 		.stringval = rm_strdup(s), .type = T_STRING, .allocation = M_SELF
@@ -101,13 +109,33 @@ SIValue SI_TransferStringVal(char *s) {
 	};
 }
 
+SIValue SI_InternedStringVal(char *s) {
+	return (SIValue) {
+		.stringval = s, .type = T_STRING, .allocation = M_INTERNED
+	};
+}
+
+SIValue SI_ArenaStringVal(char *s) {
+	return (SIValue) {
+		.stringval = s, .type = T_STRING, .allocation = M_ARENA
+	};
+}
+
+SIValue SI_TransientStringVal(char *s) {
+	return (SIValue) {
+		.stringval = s, .type = T_STRING, .allocation = M_TRANSIENT
+	};
+}
+
 /* Make an SIValue that reuses the original's allocations, if any.
  * The returned value is not responsible for freeing any allocations,
  * and is not guaranteed that these allocations will remain in scope. */
 SIValue SI_ShareValue(const SIValue v) {
 	SIValue dup = v;
 	// If the original value owns an allocation, mark that the duplicate shares it.
-	if(v.allocation == M_SELF) dup.allocation = M_VOLATILE;
+	if(v.allocation == M_SELF || v.allocation == M_INTERNED || v.allocation == M_ARENA) {
+		dup.allocation = M_VOLATILE;
+	}
 	return dup;
 }
 
@@ -162,7 +190,9 @@ SIValue SI_ConstValue(const SIValue v) {
  * with no responsibility for freeing or guarantee regarding scope.
  * This is used in cases like performing shallow copies of scalars in Record entries. */
 void SIValue_MakeVolatile(SIValue *v) {
-	if(v->allocation == M_SELF) v->allocation = M_VOLATILE;
+	if(v->allocation == M_SELF || v->allocation == M_INTERNED || v->allocation == M_ARENA) {
+		v->allocation = M_VOLATILE;
+	}
 }
 
 /* Ensure that any allocation held by the given SIValue is guaranteed to not go out
@@ -177,6 +207,14 @@ void SIValue_Persist(SIValue *v) {
 	*v = SI_CloneValue(*v);
 }
 
+/* Graph entity properties are read as constants, safe to access as long as the
+ * graph is not modified, which holds throughout read queries.
+ * Copy these before a write query updates or deletes the entities they belong to. */
+void SIValue_PersistBorrowed(SIValue *v) {
+	if(v->allocation != M_CONST) return;
+	*v = SI_CloneValue(*v);
+}
+
 inline bool SIValue_IsNull(SIValue v) {
 	return v.type == T_NULL;
 }
@@ -214,6 +252,8 @@ const char *SIType_ToString(SIType t) {
 		return "List";
 	} else if(t & T_PATH) {
 		return "Path";
+	} else if(t & T_POINT) {
+		return "Point";
 	} else if(t & T_NULL) {
 		return "Null";
 	} else {
@@ -255,6 +295,10 @@ void SIValue_ToString(SIValue v, char **buf, size_t *bufferLen, size_t *bytesWri
 	case T_PATH:
 		SIPath_ToString(v, buf, bufferLen, bytesWritten);
 		break;
+	case T_POINT:
+		*bytesWritten += snprintf(*buf + *bytesWritten, *bufferLen,
+								  "point({latitude: %f, longitude: %f})", v.point.latitude, v.point.longitude);
+		break;
 	case T_NULL:
 		*bytesWritten += snprintf(*buf + *bytesWritten, *bufferLen, "NULL");
 		break;
@@ -477,12 +521,20 @@ int SIValue_Compare(const SIValue a, const SIValue b, int *disjointOrNull) {
 		case T_DOUBLE:
 			return SAFE_COMPARISON_RESULT(a.doubleval - b.doubleval);
 		case T_STRING:
+			// Interned strings of equal content share an address.
+			if(a.stringval == b.stringval) return 0;
 			return strcmp(a.stringval, b.stringval);
 		case T_NODE:
 		case T_EDGE:
 			return ENTITY_GET_ID((GraphEntity *)a.ptrval) - ENTITY_GET_ID((GraphEntity *)b.ptrval);
 		case T_ARRAY:
 			return SIArray_Compare(a, b, disjointOrNull);
+		case T_POINT:
+			// Points are ordered by latitude, then by longitude.
+			if(a.point.latitude != b.point.latitude) {
+				return SAFE_COMPARISON_RESULT(a.point.latitude - b.point.latitude);
+			}
+			return SAFE_COMPARISON_RESULT(a.point.longitude - b.point.longitude);
 		case T_NULL:
 			break;
 		default:
@@ -588,6 +640,13 @@ XXH64_hash_t SIValue_HashCode(SIValue v) {
 		else XXH64_update(&state, &casted, sizeof(casted));
 		break;
 	}
+	case T_POINT: {
+		XXH64_update(&state, &t, sizeof(t));
+		// -0 and 0 are equal.
+		float coords[2] = {v.point.latitude + 0.0f, v.point.longitude + 0.0f};
+		XXH64_update(&state, coords, sizeof(coords));
+		break;
+	}
 	case T_EDGE:
 		return SIEdge_HashCode(v);
 	case T_NODE:
@@ -605,6 +664,18 @@ XXH64_hash_t SIValue_HashCode(SIValue v) {
 }
 
 void SIValue_Free(SIValue v) {
+	// Release the value's reference to a pooled string.
+	if(v.allocation == M_INTERNED) {
+		StringPool_Release(v.stringval);
+		return;
+	}
+
+	// Release the value's string from its arena.
+	if(v.allocation == M_ARENA) {
+		StringArena_Release(v.stringval);
+		return;
+	}
+
 	// The free routine only performs work if it owns a heap allocation.
 	if(v.allocation != M_SELF) return;
 
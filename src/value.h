@@ -36,19 +36,23 @@ typedef enum {
 	T_DOUBLE = (1 << 14),
 	T_NULL = (1 << 15),
 	T_PTR = (1 << 16),
+	T_POINT = (1 << 17), // Appended, as types are persisted.
 } SIType;
 
 typedef enum {
 	M_NONE = 0,       // SIValue is not heap-allocated
 	M_SELF = 0x1,     // SIValue is responsible for freeing its reference
 	M_VOLATILE = 0x2, // SIValue does not own its reference and may go out of scope
-	M_CONST = 0x4     // SIValue does not own its allocation, but its access is safe
+	M_CONST = 0x4,    // SIValue borrows an allocation that is safe to access, e.g. a constant or a graph property
+	M_INTERNED = 0x8, // SIValue holds a reference to a string pooled by a StringPool
+	M_ARENA = 0x10,   // SIValue holds a string within a StringArena, releasing it once freed
+	M_TRANSIENT = 0x20 // SIValue holds a string within the query's transient arena, released with the query
 } SIAllocation;
 
 #define SI_TYPE(value) (value).type
 #define SI_NUMERIC (T_INT64 | T_DOUBLE)
 #define SI_GRAPHENTITY (T_NODE | T_EDGE)
-#define SI_ALL (T_MAP | T_NODE | T_EDGE | T_ARRAY | T_PATH | T_DATETIME | T_LOCALDATETIME | T_DATE | T_TIME | T_LOCALTIME | T_DURATION | T_STRING | T_BOOL | T_INT64 | T_DOUBLE | T_NULL | T_PTR)
+#define SI_ALL (T_MAP | T_NODE | T_EDGE | T_ARRAY | T_PATH | T_DATETIME | T_LOCALDATETIME | T_DATE | T_TIME | T_LOCALTIME | T_DURATION | T_STRING | T_BOOL | T_INT64 | T_DOUBLE | T_NULL | T_PTR | T_POINT)
 
 /* Any values (except durations) are comparable with other values of the same type.
  * Integer and floating-point values are also comparable with each other. */
@@ -78,6 +82,10 @@ typedef struct SIValue {
 		char *stringval;
 		void *ptrval;
 		struct SIValue *array;
+		struct {
+			float latitude;
+			float longitude;
+		} point;
 	};
 	SIType type;
 	SIAllocation allocation;
@@ -94,6 +102,8 @@ SIValue SI_Edge(void *e);
 SIValue SI_Path(void *p);
 SIValue SI_Array(u_int64_t initialCapacity);
 SIValue SI_EmptyArray();
+// Geographic point, in degrees.
+SIValue SI_Point(float latitude, float longitude);
 
 // Duplicate and ultimately free the input string.
 SIValue SI_DuplicateStringVal(const char *s);
@@ -101,6 +111,13 @@ SIValue SI_DuplicateStringVal(const char *s);
 SIValue SI_ConstStringVal(char *s);
 // Don't duplicate input string, but assume ownership.
 SIValue SI_TransferStringVal(char *s);
+// Neither duplicate nor acquire a reference to a pooled string,
+// the value acquires a reference once stored as an entity property.
+SIValue SI_InternedStringVal(char *s);
+// Take ownership of a string held by a StringArena.
+SIValue SI_ArenaStringVal(char *s);
+// Reference a string within the query's transient arena, valid until the query is done.
+SIValue SI_TransientStringVal(char *s);
 
 /* Functions for copying and guaranteeing memory safety for SIValues. */
 // SI_ShareValue creates an SIValue that shares all of the original's allocations.
@@ -118,6 +135,10 @@ void SIValue_MakeVolatile(SIValue *v);
 // SIValue_Persist updates an SIValue to duplicate any allocations that may go out of scope in the lifetime of this query.
 void SIValue_Persist(SIValue *v);
 
+/* SIValue_PersistBorrowed updates an SIValue to duplicate borrowed allocations,
+ * which are only guaranteed to remain valid while the entities they were read from are unmodified. */
+void SIValue_PersistBorrowed(SIValue *v);
+
 bool SIValue_IsNull(SIValue v);
 bool SIValue_IsNullPtr(SIValue *v);
 bool SIValue_IsFalse(SIValue v);
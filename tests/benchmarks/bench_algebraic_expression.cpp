@@ -0,0 +1,104 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "benchmark/benchmark.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include "../../src/util/rmalloc.h"
+#include "../../src/arithmetic/algebraic_expression.h"
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// Number of entries per row of the generated matrices.
+#define ROW_DEGREE 4
+
+// Creates a dim X dim boolean matrix with ROW_DEGREE random entries per row.
+static GrB_Matrix _RandomMatrix(GrB_Index dim) {
+	GrB_Matrix m;
+	GrB_Matrix_new(&m, GrB_BOOL, dim, dim);
+	for(GrB_Index i = 0; i < dim; i++) {
+		for(int j = 0; j < ROW_DEGREE; j++) GrB_Matrix_setElement_BOOL(m, true, i, rand() % dim);
+	}
+	GrB_wait();
+	return m;
+}
+
+// Evaluate expression over random matrices of the benchmarked dimension.
+static void _BenchEval(benchmark::State &state, const char *expression) {
+	GrB_Index dim = state.range(0);
+	srand(0);
+
+	GrB_Matrix A = _RandomMatrix(dim);
+	GrB_Matrix B = _RandomMatrix(dim);
+	GrB_Matrix C = _RandomMatrix(dim);
+	rax *matrices = raxNew();
+	raxInsert(matrices, (unsigned char *)"A", 1, A, NULL);
+	raxInsert(matrices, (unsigned char *)"B", 1, B, NULL);
+	raxInsert(matrices, (unsigned char *)"C", 1, C, NULL);
+	AlgebraicExpression *exp = AlgebraicExpression_FromString(expression, matrices);
+
+	GrB_Matrix res;
+	GrB_Matrix_new(&res, GrB_BOOL, dim, dim);
+	for(auto _ : state) {
+		AlgebraicExpression_Eval(exp, res);
+		GrB_wait();
+	}
+	state.SetItemsProcessed(state.iterations() * dim);
+
+	AlgebraicExpression_Free(exp);
+	raxFree(matrices);
+	GrB_Matrix_free(&A);
+	GrB_Matrix_free(&B);
+	GrB_Matrix_free(&C);
+	GrB_Matrix_free(&res);
+}
+
+// Two hop traversal.
+static void BM_AlgebraicExpression_Eval_Mul(benchmark::State &state) {
+	_BenchEval(state, "A*B");
+}
+BENCHMARK(BM_AlgebraicExpression_Eval_Mul)->RangeMultiplier(4)->Range(1 << 10, 1 << 16);
+
+// Three hop traversal, evaluated with an intermediate matrix.
+static void BM_AlgebraicExpression_Eval_MulChain(benchmark::State &state) {
+	_BenchEval(state, "A*B*C");
+}
+BENCHMARK(BM_AlgebraicExpression_Eval_MulChain)->RangeMultiplier(4)->Range(1 << 10, 1 << 16);
+
+// Traversal over either of two relationship types.
+static void BM_AlgebraicExpression_Eval_Add(benchmark::State &state) {
+	_BenchEval(state, "A*(B+C)");
+}
+BENCHMARK(BM_AlgebraicExpression_Eval_Add)->RangeMultiplier(4)->Range(1 << 10, 1 << 16);
+
+// Traversal against the direction of the edges.
+static void BM_AlgebraicExpression_Eval_Transpose(benchmark::State &state) {
+	_BenchEval(state, "A*T(B)");
+}
+BENCHMARK(BM_AlgebraicExpression_Eval_Transpose)->RangeMultiplier(4)->Range(1 << 10, 1 << 16);
+
+int main(int argc, char **argv) {
+	// Use the malloc family for allocations
+	Alloc_Reset();
+
+	// Initialize GraphBLAS.
+	GrB_init(GrB_NONBLOCKING);
+	GxB_Global_Option_set(GxB_FORMAT, GxB_BY_ROW); // all matrices in CSR format
+	GxB_Global_Option_set(GxB_HYPER, GxB_NEVER_HYPER); // matrices are never hypersparse
+
+	benchmark::Initialize(&argc, argv);
+	benchmark::RunSpecifiedBenchmarks();
+
+	GrB_finalize();
+	return 0;
+}
@@ -0,0 +1,108 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "benchmark/benchmark.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/query_ctx.h"
+#include "../../src/arithmetic/funcs.h"
+#include "../../src/arithmetic/agg_funcs.h"
+#include "../../src/arithmetic/arithmetic_expression.h"
+#include "../../src/execution_plan/record.h"
+#include "../../src/util/rmalloc.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// Evaluate a constant expression: 1 + 2 * 3
+static void BM_AR_EXP_Evaluate_Constant(benchmark::State &state) {
+	AR_ExpNode *mul = AR_EXP_NewOpNode("mul", 2);
+	mul->op.children[0] = AR_EXP_NewConstOperandNode(SI_LongVal(2));
+	mul->op.children[1] = AR_EXP_NewConstOperandNode(SI_LongVal(3));
+	AR_ExpNode *add = AR_EXP_NewOpNode("add", 2);
+	add->op.children[0] = AR_EXP_NewConstOperandNode(SI_LongVal(1));
+	add->op.children[1] = mul;
+
+	for(auto _ : state) {
+		SIValue v = AR_EXP_Evaluate(add, NULL);
+		benchmark::DoNotOptimize(v);
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	AR_EXP_Free(add);
+}
+BENCHMARK(BM_AR_EXP_Evaluate_Constant);
+
+// Evaluate an expression over record entries: a + b * 2
+static void BM_AR_EXP_Evaluate_Variadic(benchmark::State &state) {
+	rax *mapping = raxNew();
+	raxInsert(mapping, (unsigned char *)"a", 1, (void *)0, NULL);
+	raxInsert(mapping, (unsigned char *)"b", 1, (void *)1, NULL);
+	Record r = Record_New(mapping);
+	Record_AddScalar(r, 0, SI_LongVal(1));
+	Record_AddScalar(r, 1, SI_DoubleVal(0.5));
+
+	AR_ExpNode *mul = AR_EXP_NewOpNode("mul", 2);
+	mul->op.children[0] = AR_EXP_NewVariableOperandNode("b", NULL);
+	mul->op.children[1] = AR_EXP_NewConstOperandNode(SI_LongVal(2));
+	AR_ExpNode *add = AR_EXP_NewOpNode("add", 2);
+	add->op.children[0] = AR_EXP_NewVariableOperandNode("a", NULL);
+	add->op.children[1] = mul;
+
+	for(auto _ : state) {
+		SIValue v = AR_EXP_Evaluate(add, r);
+		benchmark::DoNotOptimize(v);
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	AR_EXP_Free(add);
+	Record_Free(r);
+	raxFree(mapping);
+}
+BENCHMARK(BM_AR_EXP_Evaluate_Variadic);
+
+// Evaluate a string function, allocating its result: toUpper(a)
+static void BM_AR_EXP_Evaluate_String(benchmark::State &state) {
+	rax *mapping = raxNew();
+	raxInsert(mapping, (unsigned char *)"a", 1, (void *)0, NULL);
+	Record r = Record_New(mapping);
+	Record_AddScalar(r, 0, SI_ConstStringVal((char *)"benchmark"));
+
+	AR_ExpNode *upper = AR_EXP_NewOpNode("toUpper", 1);
+	upper->op.children[0] = AR_EXP_NewVariableOperandNode("a", NULL);
+
+	for(auto _ : state) {
+		SIValue v = AR_EXP_Evaluate(upper, r);
+		SIValue_Free(v);
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	AR_EXP_Free(upper);
+	Record_Free(r);
+	raxFree(mapping);
+}
+BENCHMARK(BM_AR_EXP_Evaluate_String);
+
+int main(int argc, char **argv) {
+	// Use the malloc family for allocations
+	Alloc_Reset();
+
+	// Prepare thread-local variables
+	QueryCtx_Init();
+
+	// Register functions
+	AR_RegisterFuncs();
+	Agg_RegisterFuncs();
+
+	benchmark::Initialize(&argc, argv);
+	benchmark::RunSpecifiedBenchmarks();
+	return 0;
+}
@@ -0,0 +1,83 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "benchmark/benchmark.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/datablock/datablock.h"
+#include "../../src/util/datablock/datablock_iterator.h"
+#include "../../src/util/rmalloc.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// Allocate N items in an empty datablock.
+static void BM_DataBlock_Allocate(benchmark::State &state) {
+	int64_t n = state.range(0);
+	for(auto _ : state) {
+		DataBlock *dataBlock = DataBlock_New(1024, sizeof(int64_t), NULL);
+		for(int64_t i = 0; i < n; i++) {
+			int64_t *item = (int64_t *)DataBlock_AllocateItem(dataBlock, NULL);
+			*item = i;
+		}
+		DataBlock_Free(dataBlock);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_DataBlock_Allocate)->Range(1 << 10, 1 << 20);
+
+// Reuse the slots of deleted items.
+static void BM_DataBlock_AllocateDeleted(benchmark::State &state) {
+	int64_t n = state.range(0);
+	DataBlock *dataBlock = DataBlock_New(n, sizeof(int64_t), NULL);
+	for(int64_t i = 0; i < n; i++) DataBlock_AllocateItem(dataBlock, NULL);
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		for(int64_t i = 0; i < n; i += 2) DataBlock_DeleteItem(dataBlock, i);
+		state.ResumeTiming();
+		for(int64_t i = 0; i < n; i += 2) DataBlock_AllocateItem(dataBlock, NULL);
+	}
+	state.SetItemsProcessed(state.iterations() * (n / 2));
+	DataBlock_Free(dataBlock);
+}
+BENCHMARK(BM_DataBlock_AllocateDeleted)->Range(1 << 10, 1 << 20);
+
+// Scan a datablock in which every other item is deleted.
+static void BM_DataBlock_Scan(benchmark::State &state) {
+	int64_t n = state.range(0);
+	DataBlock *dataBlock = DataBlock_New(n, sizeof(int64_t), NULL);
+	for(int64_t i = 0; i < n; i++) {
+		int64_t *item = (int64_t *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+	for(int64_t i = 0; i < n; i += 2) DataBlock_DeleteItem(dataBlock, i);
+
+	for(auto _ : state) {
+		int64_t sum = 0;
+		int64_t *item;
+		DataBlockIterator *it = DataBlock_Scan(dataBlock);
+		while((item = (int64_t *)DataBlockIterator_Next(it))) sum += *item;
+		DataBlockIterator_Free(it);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * (n / 2));
+	DataBlock_Free(dataBlock);
+}
+BENCHMARK(BM_DataBlock_Scan)->Range(1 << 10, 1 << 20);
+
+int main(int argc, char **argv) {
+	// Use the malloc family for allocations
+	Alloc_Reset();
+
+	benchmark::Initialize(&argc, argv);
+	benchmark::RunSpecifiedBenchmarks();
+	return 0;
+}
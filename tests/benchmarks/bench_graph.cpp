@@ -0,0 +1,107 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "benchmark/benchmark.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include "../../src/graph/graph.h"
+#include "../../src/util/rmalloc.h"
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#define NODE_COUNT 100000
+#define RELATION_COUNT 3
+
+// Creates a graph of NODE_COUNT unlabeled nodes and RELATION_COUNT relation types.
+static Graph *_BuildGraph(void) {
+	Node n;
+	Graph *g = Graph_New(NODE_COUNT, NODE_COUNT);
+	Graph_AcquireWriteLock(g);
+	for(int i = 0; i < RELATION_COUNT; i++) Graph_AddRelationType(g);
+	Graph_AllocateNodes(g, NODE_COUNT);
+	for(int i = 0; i < NODE_COUNT; i++) Graph_CreateNode(g, GRAPH_NO_LABEL, &n);
+	Graph_ApplyAllPending(g);
+	return g;
+}
+
+static void _FreeGraph(Graph *g) {
+	Graph_ReleaseLock(g);
+	Graph_Free(g);
+}
+
+// Form N random connections, matrices are synchronized as edges are read.
+static void BM_Graph_ConnectNodes(benchmark::State &state) {
+	int64_t n = state.range(0);
+	srand(0);
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		Edge e;
+		Graph *g = _BuildGraph();
+		Graph_AllocateEdges(g, n);
+		state.ResumeTiming();
+
+		for(int64_t i = 0; i < n; i++) {
+			Graph_ConnectNodes(g, rand() % NODE_COUNT, rand() % NODE_COUNT, i % RELATION_COUNT, &e);
+		}
+
+		state.PauseTiming();
+		_FreeGraph(g);
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_Graph_ConnectNodes)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMillisecond);
+
+// Flush N pending connections into the graph's matrices.
+static void BM_Graph_MatrixSync(benchmark::State &state) {
+	int64_t n = state.range(0);
+	srand(0);
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		Edge e;
+		Graph *g = _BuildGraph();
+		Graph_AllocateEdges(g, n);
+		Graph_SetMatrixPolicy(g, RESIZE_TO_CAPACITY);
+		for(int64_t i = 0; i < n; i++) {
+			Graph_ConnectNodes(g, rand() % NODE_COUNT, rand() % NODE_COUNT, i % RELATION_COUNT, &e);
+		}
+		Graph_SetMatrixPolicy(g, SYNC_AND_MINIMIZE_SPACE);
+		state.ResumeTiming();
+
+		Graph_ApplyAllPending(g);
+
+		state.PauseTiming();
+		_FreeGraph(g);
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_Graph_MatrixSync)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char **argv) {
+	// Use the malloc family for allocations
+	Alloc_Reset();
+
+	// Initialize GraphBLAS.
+	GrB_init(GrB_NONBLOCKING);
+	GxB_Global_Option_set(GxB_FORMAT, GxB_BY_ROW); // all matrices in CSR format
+	GxB_Global_Option_set(GxB_HYPER, GxB_NEVER_HYPER); // matrices are never hypersparse
+
+	benchmark::Initialize(&argc, argv);
+	benchmark::RunSpecifiedBenchmarks();
+
+	GrB_finalize();
+	return 0;
+}
@@ -0,0 +1,72 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "benchmark/benchmark.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/grouping/group_cache.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// Insert N distinct groups, each keyed by an integer and a string.
+static void BM_GroupCache_Add(benchmark::State &state) {
+	int64_t n = state.range(0);
+	char **names = (char **)rm_malloc(sizeof(char *) * n);
+	for(int64_t i = 0; i < n; i++) asprintf(names + i, "group_%ld", i);
+
+	for(auto _ : state) {
+		CacheGroup *groups = CacheGroupNew(2);
+		for(int64_t i = 0; i < n; i++) {
+			SIValue keys[2] = {SI_LongVal(i), SI_ConstStringVal(names[i])};
+			uint64_t hash = CacheGroup_HashKeys(keys, 2);
+			if(CacheGroupGet(groups, keys, hash) == NULL) {
+				CacheGroupAdd(groups, keys, hash, NULL, 0, NULL);
+			}
+		}
+		FreeGroupCache(groups);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+
+	for(int64_t i = 0; i < n; i++) free(names[i]);
+	rm_free(names);
+}
+BENCHMARK(BM_GroupCache_Add)->Range(1 << 8, 1 << 18);
+
+// Look up existing groups, as aggregating records into few groups does.
+static void BM_GroupCache_Get(benchmark::State &state) {
+	int64_t n = state.range(0);
+	CacheGroup *groups = CacheGroupNew(1);
+	for(int64_t i = 0; i < n; i++) {
+		SIValue key = SI_LongVal(i);
+		CacheGroupAdd(groups, &key, CacheGroup_HashKeys(&key, 1), NULL, 0, NULL);
+	}
+
+	int64_t i = 0;
+	for(auto _ : state) {
+		SIValue key = SI_LongVal(i++ % n);
+		benchmark::DoNotOptimize(CacheGroupGet(groups, &key, CacheGroup_HashKeys(&key, 1)));
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	FreeGroupCache(groups);
+}
+BENCHMARK(BM_GroupCache_Get)->Range(1 << 4, 1 << 18);
+
+int main(int argc, char **argv) {
+	// Use the malloc family for allocations
+	Alloc_Reset();
+
+	benchmark::Initialize(&argc, argv);
+	benchmark::RunSpecifiedBenchmarks();
+	return 0;
+}
@@ -0,0 +1,63 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "benchmark/benchmark.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/execution_plan/record.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// Builds a mapping of n aliases.
+static rax *_BuildMapping(int n) {
+	rax *mapping = raxNew();
+	for(intptr_t i = 0; i < n; i++) {
+		char alias[16];
+		int len = sprintf(alias, "a%ld", i);
+		raxInsert(mapping, (unsigned char *)alias, len, (void *)i, NULL);
+	}
+	return mapping;
+}
+
+// Clone a record of N scalars, half of which are heap allocated strings.
+static void BM_Record_Clone(benchmark::State &state) {
+	int n = state.range(0);
+	rax *mapping = _BuildMapping(n);
+	Record r = Record_New(mapping);
+	for(int i = 0; i < n; i++) {
+		SIValue v = (i % 2) ? SI_DuplicateStringVal("value") : SI_LongVal(i);
+		Record_AddScalar(r, i, v);
+	}
+	Record clone = Record_New(mapping);
+
+	for(auto _ : state) {
+		Record_Clone(r, clone);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	rm_free(clone);
+	Record_Free(r);
+	raxFree(mapping);
+}
+BENCHMARK(BM_Record_Clone)->RangeMultiplier(4)->Range(4, 64);
+
+int main(int argc, char **argv) {
+	// Use the malloc family for allocations
+	Alloc_Reset();
+
+	benchmark::Initialize(&argc, argv);
+	benchmark::RunSpecifiedBenchmarks();
+	return 0;
+}
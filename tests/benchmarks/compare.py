@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+
+"""
+Compares two Google Benchmark JSON result directories, as written by `make run`,
+reporting the change in CPU time of every benchmark both runs share.
+Exits with a non-zero status if any benchmark regressed beyond the threshold.
+
+Usage: compare.py <baseline dir> <contender dir> [threshold percent]
+"""
+
+import os
+import sys
+import json
+
+
+def load_results(path):
+    results = {}
+    for filename in sorted(os.listdir(path)):
+        if not filename.endswith('.json'):
+            continue
+        with open(os.path.join(path, filename)) as f:
+            report = json.load(f)
+        for bench in report['benchmarks']:
+            # When repeated, compare the median of the repetitions.
+            if bench.get('run_type') == 'aggregate' and bench.get('aggregate_name') != 'median':
+                continue
+            name = bench.get('run_name', bench['name'])
+            results[name] = bench['cpu_time']
+    return results
+
+
+def main():
+    if len(sys.argv) < 3:
+        print(__doc__)
+        return 2
+
+    baseline = load_results(sys.argv[1])
+    contender = load_results(sys.argv[2])
+    threshold = float(sys.argv[3]) if len(sys.argv) > 3 else 10.0
+
+    regressions = 0
+    width = max([len(name) for name in baseline] + [len('Benchmark')])
+    print('%-*s %14s %14s %9s' % (width, 'Benchmark', 'Baseline', 'Contender', 'Change'))
+    for name, base_time in baseline.items():
+        if name not in contender:
+            continue
+        change = (contender[name] - base_time) / base_time * 100 if base_time > 0 else 0
+        marker = ''
+        if change > threshold:
+            marker = ' REGRESSION'
+            regressions += 1
+        print('%-*s %14.1f %14.1f %+8.1f%%%s' % (width, name, base_time, contender[name], change, marker))
+
+    if regressions > 0:
+        print('%d benchmark(s) regressed by more than %.1f%%' % (regressions, threshold))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,68 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "access_stats"
+redis_con = None
+redis_graph = None
+
+class testAccessStats(FlowTestsBase):
+    def __init__(self):
+        # Sample every access, such that counts are exact barring sketch collisions.
+        self.env = Env(moduleArgs="ACCESS_SAMPLE_RATE 1")
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("""UNWIND range(0, 9) AS x CREATE (:Person {name: toString(x)})""")
+        redis_graph.query("""MATCH (a:Person), (b:Person) WHERE b.name = toString((toInteger(a.name) + 1) % 10)
+                             CREATE (a)-[:KNOWS]->(b), (a)-[:LIKES]->(:Movie)""")
+        redis_graph.query("CREATE INDEX ON :Person(name)")
+
+    # Returns the accesses of each reported entity of type, keyed by name, or by ID for nodes.
+    def access_stats(self, access_type):
+        res = redis_graph.query("CALL db.accessStats()")
+        stats = {}
+        for row in res.result_set:
+            if row[0] == access_type:
+                stats[row[1] if row[2] is None else row[2]] = row[3]
+        return stats
+
+    def test01_label_scans(self):
+        before = self.access_stats("label").get("Person", 0)
+        for _ in range(5):
+            redis_graph.query("MATCH (p:Person) RETURN count(p)")
+        self.env.assertGreaterEqual(self.access_stats("label")["Person"], before + 5)
+
+    def test02_relationship_traversals(self):
+        for _ in range(10):
+            redis_graph.query("MATCH (:Person)-[:KNOWS]->(b) RETURN count(b)")
+        relations = self.access_stats("relationship")
+        # Each of the 10 sources traverses KNOWS on each query.
+        self.env.assertGreaterEqual(relations["KNOWS"], 100)
+        self.env.assertGreater(relations["KNOWS"], relations.get("LIKES", 0))
+
+    def test03_index_lookups(self):
+        before = self.access_stats("index").get("Person", 0)
+        for _ in range(3):
+            res = redis_graph.query("MATCH (p:Person) WHERE p.name = '3' RETURN p.name")
+            self.env.assertEquals(res.result_set, [['3']])
+        self.env.assertGreaterEqual(self.access_stats("index")["Person"], before + 3)
+
+    def test04_hot_node(self):
+        res = redis_graph.query("MATCH (p:Person {name: '7'}) RETURN id(p)")
+        node_id = res.result_set[0][0]
+        for _ in range(50):
+            redis_graph.query("MATCH (n) WHERE id(n) = %d RETURN n" % node_id)
+        nodes = self.access_stats("node")
+        # The repeatedly sought node is the most accessed one.
+        self.env.assertEquals(max(nodes, key=nodes.get), node_id)
+        self.env.assertGreaterEqual(nodes[node_id], 50)
+
+    def test05_ordering(self):
+        # Entities of each type are reported by descending access count.
+        res = redis_graph.query("CALL db.accessStats()")
+        for access_type in ["node", "label", "relationship", "index"]:
+            counts = [row[3] for row in res.result_set if row[0] == access_type]
+            self.env.assertLessEqual(len(counts), 16)
+            self.env.assertEquals(counts, sorted(counts, reverse=True))
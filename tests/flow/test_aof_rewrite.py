@@ -0,0 +1,63 @@
+import time
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "aof_rewrite"
+redis_con = None
+redis_graph = None
+
+class testAofRewrite(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(useAof=True)
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        # Rewrite the AOF as commands rather than an RDB preamble.
+        redis_con.execute_command("CONFIG", "SET", "aof-use-rdb-preamble", "no")
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:P {v: x, name: 'p' + toString(x), tags: [x, 'tag', [x % 2 = 0]]})")
+        redis_graph.query("CREATE (:P:Q {v: 100, score: 1.5}), ({v: 101}), (:Q)")
+        redis_graph.query("MATCH (a:P), (b:P) WHERE b.v = a.v + 1 CREATE (a)-[:NEXT {w: a.v}]->(b)")
+        redis_graph.query("MATCH (a:P {v: 0}), (b:P {v: 1}) CREATE (a)-[:NEXT]->(b), (a)-[:NEXT]->(b)")
+        # Deleted nodes leave gaps in node IDs.
+        redis_graph.query("MATCH (p:P) WHERE p.v >= 40 AND p.v < 50 DELETE p")
+        redis_graph.query("CREATE (:Empty)-[:GONE]->(:Empty)")
+        redis_graph.query("MATCH (e:Empty) DELETE e")
+        redis_graph.query("CREATE INDEX ON :P(v)")
+        redis_graph.query("CALL db.idx.fulltext.createNodeIndex('P', 'name')")
+
+    def _rewrite_and_reload(self):
+        redis_con.execute_command("BGREWRITEAOF")
+        while redis_con.info("persistence")["aof_rewrite_in_progress"]:
+            time.sleep(0.1)
+        redis_con.execute_command("DEBUG", "LOADAOF")
+
+    def test01_graph_restored_from_rewritten_aof(self):
+        queries = ["MATCH (n) RETURN labels(n), n.v, n.name, n.tags, n.score ORDER BY n.v",
+                   "MATCH (a)-[e]->(b) RETURN type(e), a.v, b.v, e.w ORDER BY a.v, b.v, e.w",
+                   "MATCH (q:Q) RETURN count(q)",
+                   "CALL db.labels()",
+                   "CALL db.relationshipTypes()"]
+        expected = [redis_graph.query(q).result_set for q in queries]
+
+        self._rewrite_and_reload()
+
+        for q, e in zip(queries, expected):
+            self.env.assertEquals(redis_graph.query(q).result_set, e)
+
+    def test02_indices_restored_from_rewritten_aof(self):
+        plan = redis_graph.execution_plan("MATCH (p:P) WHERE p.v = 5 RETURN p")
+        self.env.assertIn("Index Scan", plan)
+        res = redis_graph.query("CALL db.idx.fulltext.queryNodes('P', 'p7') YIELD node RETURN node.v")
+        self.env.assertEquals(res.result_set, [[7]])
+
+    def test03_empty_graph(self):
+        graph = Graph("aof_empty", redis_con)
+        graph.query("CREATE (n) DELETE n")
+        self._rewrite_and_reload()
+        self.env.assertEquals(redis_con.exists("aof_empty"), 1)
+        self.env.assertEquals(graph.query("MATCH (n) RETURN count(n)").result_set, [[0]])
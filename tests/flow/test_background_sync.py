@@ -0,0 +1,32 @@
+import time
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "background_sync"
+redis_graph = None
+
+class testBackgroundSync(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def test01_reads_after_writes(self):
+        # Interleave small writes with reads, pending changes are applied
+        # either in the background or by the reader, results must match.
+        redis_graph.query("CREATE (:A {v:0})")
+        for i in range(1, 50):
+            redis_graph.query("MATCH (a:A {v:%d}) CREATE (a)-[:R]->(:A {v:%d})" % (i - 1, i))
+            res = redis_graph.query("MATCH (:A)-[:R]->(b:A) RETURN count(b)")
+            self.env.assertEquals(res.result_set[0][0], i)
+
+    def test02_reads_after_background_sync(self):
+        redis_graph.query("UNWIND range(0, 999) AS x CREATE (:B {v:x})-[:S]->(:C)")
+        # Give the background synchronization a chance to run.
+        time.sleep(0.5)
+        res = redis_graph.query("MATCH (b:B)-[:S]->(c:C) RETURN count(c)")
+        self.env.assertEquals(res.result_set[0][0], 1000)
+        res = redis_graph.query("MATCH (c:C)<-[:S]-(b:B) RETURN count(b)")
+        self.env.assertEquals(res.result_set[0][0], 1000)
@@ -0,0 +1,44 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "batch"
+redis_con = None
+redis_graph = None
+
+class testBatch(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("CREATE (:Person {v:1}), (:Person {v:2}), (:City {v:3})")
+
+    def test01_batch(self):
+        res = redis_con.execute_command("GRAPH.BATCH", GRAPH_ID,
+                                        "MATCH (p:Person) RETURN count(p)",
+                                        "MATCH (c:City) RETURN c.v",
+                                        "CYPHER v=2 MATCH (p:Person {v:$v}) RETURN p.v")
+        self.env.assertEquals(len(res), 3)
+        self.env.assertEquals(res[0][1], [[2]])
+        self.env.assertEquals(res[1][1], [[3]])
+        self.env.assertEquals(res[2][1], [[2]])
+
+    def test02_batch_rejects_writes(self):
+        res = redis_con.execute_command("GRAPH.BATCH", GRAPH_ID,
+                                        "CREATE (:Person {v:4})",
+                                        "MATCH (p:Person) RETURN count(p)")
+        self.env.assertEquals(len(res), 2)
+        self.env.assertIn("only supports read-only queries", str(res[0]))
+        # Graph wasn't modified.
+        self.env.assertEquals(res[1][1], [[2]])
+
+    def test03_batch_errors(self):
+        # Errors are reported per query.
+        res = redis_con.execute_command("GRAPH.BATCH", GRAPH_ID,
+                                        "MATCH (p:Person RETURN p",
+                                        "RETURN 1")
+        self.env.assertEquals(len(res), 2)
+        self.env.assertTrue(isinstance(res[0], Exception))
+        self.env.assertEquals(res[1][1], [[1]])
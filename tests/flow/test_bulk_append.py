@@ -0,0 +1,129 @@
+import struct
+import redis
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "bulk_append"
+redis_con = None
+redis_graph = None
+
+# Bulk insert binary format, see src/bulk_insert/bulk_insert.c
+BI_STRING = 3
+BI_LONG = 4
+
+def header(name, props):
+    buf = name.encode() + b'\0' + struct.pack('<I', len(props))
+    for prop in props:
+        buf += prop.encode() + b'\0'
+    return buf
+
+def long_val(v):
+    return struct.pack('<BQ', BI_LONG, v)
+
+def string_val(v):
+    return struct.pack('<B', BI_STRING) + v.encode() + b'\0'
+
+def relation_by_id(src, dest, *props):
+    return struct.pack('<QQ', src, dest) + b''.join(props)
+
+class testBulkAppend(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:Person {name: 'p' + toString(x), v: x})")
+        redis_graph.query("MATCH (a:Person {v: 0}), (b:Person {v: 1}) CREATE (a)-[:KNOWS {since: 1}]->(b)")
+        redis_graph.query("CREATE INDEX ON :Person(name)")
+
+    def bulk(self, *args):
+        return redis_con.execute_command("GRAPH.BULK", GRAPH_ID, *args)
+
+    def test01_append_by_id(self):
+        ids = redis_graph.query("MATCH (p:Person) RETURN ID(p) ORDER BY p.v").result_set
+        ids = [row[0] for row in ids]
+        # Connect existing nodes, including an additional edge between an already connected pair.
+        token = header("KNOWS", ["since"])
+        token += relation_by_id(ids[0], ids[1], long_val(2))
+        token += relation_by_id(ids[1], ids[2], long_val(3))
+        token += relation_by_id(ids[1], ids[2], long_val(4))
+        res = self.bulk("0", "3", "0", "1", token)
+        self.env.assertEquals(res, b"0 nodes created, 3 edges created")
+
+        res = redis_graph.query("MATCH (a:Person)-[e:KNOWS]->(b:Person) RETURN a.v, b.v, e.since ORDER BY e.since")
+        self.env.assertEquals(res.result_set, [[0, 1, 1], [0, 1, 2], [1, 2, 3], [1, 2, 4]])
+        res = redis_graph.query("MATCH (a:Person)<-[:KNOWS]-(b:Person) RETURN a.v, count(b) ORDER BY a.v")
+        self.env.assertEquals(res.result_set, [[1, 2], [2, 2]])
+
+    def test02_append_by_key(self):
+        token = header("LIKES", [])
+        token += string_val("p3") + string_val("p4")
+        token += string_val("p4") + string_val("p5")
+        res = self.bulk("0", "2", "KEY", "Person", "name", "0", "1", token)
+        self.env.assertEquals(res, b"0 nodes created, 2 edges created")
+
+        res = redis_graph.query("MATCH (a:Person)-[:LIKES]->(b:Person) RETURN a.name, b.name ORDER BY a.name")
+        self.env.assertEquals(res.result_set, [["p3", "p4"], ["p4", "p5"]])
+
+    def test03_appended_nodes_indexed(self):
+        nodes = header("Person", ["name"]) + string_val("p10")
+        res = self.bulk("1", "0", "1", "0", nodes)
+        self.env.assertEquals(res, b"1 nodes created, 0 edges created")
+
+        token = header("LIKES", []) + string_val("p10") + string_val("p0")
+        self.bulk("0", "1", "KEY", "Person", "name", "0", "1", token)
+        res = redis_graph.query("MATCH (a:Person)-[:LIKES]->(b:Person {name: 'p0'}) RETURN a.name")
+        self.env.assertEquals(res.result_set, [["p10"]])
+
+    def test04_invalid_endpoints(self):
+        edges = redis_graph.query("MATCH ()-[e]->() RETURN count(e)").result_set[0][0]
+
+        # Unknown key, no relation of the batch is introduced.
+        token = header("LIKES", []) + string_val("p0") + string_val("p1")
+        token += string_val("p0") + string_val("missing")
+        try:
+            self.bulk("0", "2", "KEY", "Person", "name", "0", "1", token)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("does not match any node", str(e))
+
+        # Missing node ID.
+        token = header("LIKES", []) + relation_by_id(0, 1000)
+        try:
+            self.bulk("0", "1", "0", "1", token)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("does not refer to an existing node", str(e))
+
+        # Key attribute must be indexed.
+        token = header("LIKES", []) + long_val(0) + long_val(1)
+        try:
+            self.bulk("0", "1", "KEY", "Person", "v", "0", "1", token)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("requires an exact-match index", str(e))
+
+        # Graph remains intact.
+        self.env.assertEquals(redis_con.exists(GRAPH_ID), 1)
+        res = redis_graph.query("MATCH ()-[e]->() RETURN count(e)")
+        self.env.assertEquals(res.result_set[0][0], edges)
+
+    def test05_relations_across_tokens(self):
+        ids = redis_graph.query("MATCH (p:Person) WHERE p.v < 4 RETURN ID(p) ORDER BY p.v").result_set
+        ids = [row[0] for row in ids]
+        # A relation spread over multiple tokens, interleaved with another relation.
+        follows_a = header("FOLLOWS", []) + relation_by_id(ids[0], ids[1]) + relation_by_id(ids[0], ids[1])
+        blocks = header("BLOCKS", []) + relation_by_id(ids[2], ids[3])
+        follows_b = header("FOLLOWS", []) + relation_by_id(ids[0], ids[1]) + relation_by_id(ids[1], ids[0])
+        res = self.bulk("0", "6", "0", "3", follows_a, blocks, follows_b)
+        self.env.assertEquals(res, b"0 nodes created, 6 edges created")
+
+        res = redis_graph.query("MATCH (a:Person)-[:FOLLOWS]->(b:Person) RETURN a.v, b.v, count(*) ORDER BY a.v")
+        self.env.assertEquals(res.result_set, [[0, 1, 3], [1, 0, 1]])
+        res = redis_graph.query("MATCH (a:Person)<-[:BLOCKS]-(b:Person) RETURN a.v, b.v")
+        self.env.assertEquals(res.result_set, [[3, 2]])
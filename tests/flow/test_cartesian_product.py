@@ -0,0 +1,50 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "cartesian_product"
+redis_graph = None
+
+class testCartesianProduct(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 99) AS i CREATE (:A {v: i})")
+        redis_graph.query("UNWIND range(0, 9) AS i CREATE (:B {v: i})")
+        redis_graph.query("UNWIND range(0, 2) AS i CREATE (:C {v: i})")
+
+    def test01_two_branches(self):
+        # Either branch may be replayed from memory, every combination is produced once.
+        for query in ["MATCH (a:A), (b:B) RETURN a.v, b.v", "MATCH (b:B), (a:A) RETURN a.v, b.v"]:
+            result = redis_graph.query(query).result_set
+            expected = [[a, b] for a in range(100) for b in range(10)]
+            self.env.assertEquals(sorted(result), expected)
+
+    def test02_three_branches(self):
+        query = "MATCH (b:B), (a:A), (c:C) RETURN a.v, b.v, c.v"
+        result = redis_graph.query(query).result_set
+        expected = [[a, b, c] for a in range(100) for b in range(10) for c in range(3)]
+        self.env.assertEquals(sorted(result), expected)
+
+        query = "MATCH (c:C), (b:B), (a:A) RETURN sum(a.v * 100 + b.v * 10 + c.v), count(*)"
+        result = redis_graph.query(query).result_set
+        total = sum(a * 100 + b * 10 + c for a in range(100) for b in range(10) for c in range(3))
+        self.env.assertEquals(result, [[total, 3000]])
+
+    def test03_scalar_branches(self):
+        # Replayed scalars remain valid for downstream operations buffering records.
+        query = "MATCH (c:C), (b:B) WITH c, b, 'c' + toString(c.v) AS s MATCH (x:C) RETURN s, b.v, x.v ORDER BY s, b.v, x.v"
+        result = redis_graph.query(query).result_set
+        expected = [['c' + str(c), b, x] for c in range(3) for b in range(10) for x in range(3)]
+        self.env.assertEquals(result, expected)
+
+    def test04_empty_branch(self):
+        query = "MATCH (a:A), (m:Missing) RETURN count(*)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[0]])
+        query = "MATCH (m:Missing), (a:A), (b:B) RETURN count(*)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[0]])
@@ -0,0 +1,65 @@
+import os
+import sys
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "centrality"
+redis_con = None
+redis_graph = None
+
+class testCentralityFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        # Path p1 -> p2 -> p3 -> p4 and diamond a -> b -> d, a -> c -> d.
+        redis_graph.query("""CREATE (:P {v:'p1'})-[:R]->(:P {v:'p2'})-[:R]->(:P {v:'p3'})-[:R]->(:P {v:'p4'}),
+                             (a:D {v:'a'})-[:R]->(b:D {v:'b'})-[:R]->(d:D {v:'d'}),
+                             (a)-[:R]->(c:D {v:'c'})-[:R]->(d)""")
+
+    def centrality(self, query):
+        return [[v, round(c, 6)] for v, c in redis_graph.query(query).result_set]
+
+    def test01_betweenness(self):
+        q = """CALL algo.betweenness('P', 'R') YIELD node, centrality
+               RETURN node.v, centrality ORDER BY node.v"""
+        self.env.assertEqual(self.centrality(q), [['p1', 0], ['p2', 2], ['p3', 2], ['p4', 0]])
+
+        # Shortest paths from a to d split between b and c.
+        q = """CALL algo.betweenness('D', 'R', NULL, 2) YIELD node, centrality
+               RETURN node.v, centrality ORDER BY node.v"""
+        self.env.assertEqual(self.centrality(q), [['a', 0], ['b', 0.5], ['c', 0.5], ['d', 0]])
+
+        # A sample covering every node is exact.
+        q = """CALL algo.betweenness(NULL, NULL, 100) YIELD node, centrality
+               RETURN node.v, centrality ORDER BY node.v"""
+        self.env.assertEqual(self.centrality(q), [['a', 0], ['b', 0.5], ['c', 0.5], ['d', 0],
+                                                  ['p1', 0], ['p2', 2], ['p3', 2], ['p4', 0]])
+
+    def test02_closeness(self):
+        q = """CALL algo.closeness('P', 'R') YIELD node, centrality
+               RETURN node.v, centrality ORDER BY node.v"""
+        self.env.assertEqual(self.centrality(q), [['p1', 0.5], ['p2', round(2.0 / 3, 6)], ['p3', 1], ['p4', 0]])
+
+        q = """CALL algo.closeness('D', 'R', 0, 1) YIELD node, centrality
+               RETURN node.v, centrality ORDER BY node.v"""
+        self.env.assertEqual(self.centrality(q), [['a', round(3.0 / 4, 6)], ['b', 1], ['c', 1], ['d', 0]])
+
+    def test03_sampled(self):
+        for proc in ['algo.betweenness', 'algo.closeness']:
+            q = "CALL %s(NULL, 'R', 3) YIELD node, centrality RETURN count(node), min(centrality) >= 0" % proc
+            self.env.assertEqual(redis_graph.query(q).result_set, [[8, True]])
+
+    def test04_invalid_arguments(self):
+        try:
+            redis_graph.query("CALL algo.betweenness('P', 'R', -1) YIELD node RETURN node")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("non-negative", str(e))
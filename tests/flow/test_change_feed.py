@@ -0,0 +1,93 @@
+import time
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "change_feed"
+STREAM = GRAPH_ID + ":changes"
+redis_con = None
+redis_graph = None
+
+
+def _decode(v):
+    return v.decode() if isinstance(v, bytes) else v
+
+
+class testChangeFeed(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(moduleArgs="CHANGE_FEED_MAXLEN 1000")
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.seen = 0
+
+    # Waits for count changes to be appended past the ones already read, returns them as dicts.
+    def changes(self, count):
+        entries = []
+        for _ in range(100):
+            entries = redis_con.execute_command("XRANGE", STREAM, "-", "+")
+            if len(entries) >= self.seen + count:
+                break
+            time.sleep(0.05)
+        self.env.assertEqual(len(entries), self.seen + count)
+        changes = []
+        for _, fields in entries[self.seen:]:
+            fields = [_decode(f) for f in fields]
+            changes.append(dict(zip(fields[0::2], fields[1::2])))
+        self.seen = len(entries)
+        return changes
+
+    def test01_created(self):
+        redis_graph.query("CREATE (:Person:Employee {name: 'Ann', age: 30})-[:KNOWS {since: 2010}]->(:Person {name: 'O\\'Hara'})")
+        changes = self.changes(3)
+        self.env.assertEqual([c['op'] for c in changes], ['node_created', 'node_created', 'edge_created'])
+        ann, ohara, knows = changes
+        self.env.assertEqual(ann['labels'], 'Person:Employee')
+        self.env.assertEqual(ann['.name'], "'Ann'")
+        self.env.assertEqual(ann['.age'], '30')
+        self.env.assertEqual(ohara['.name'], "'O\\'Hara'")
+        self.env.assertEqual(knows['type'], 'KNOWS')
+        self.env.assertEqual(knows['src'], ann['id'])
+        self.env.assertEqual(knows['dest'], ohara['id'])
+        self.env.assertEqual(knows['.since'], '2010')
+        # Changes of a single write share its version.
+        self.env.assertEqual(len(set(c['version'] for c in changes)), 1)
+
+    def test02_updated(self):
+        redis_graph.query("MATCH (p:Person {name: 'Ann'}) SET p.tags = ['a', 'b'], p.age = NULL")
+        redis_graph.query("MATCH ()-[k:KNOWS]->() SET k.since = 2.5")
+        redis_graph.query("MERGE (p:Person {name: 'Ann'}) ON MATCH SET p.age = 31")
+        changes = self.changes(4)
+        self.env.assertEqual([c['op'] for c in changes], ['node_updated', 'node_updated', 'edge_updated', 'node_updated'])
+        self.env.assertEqual(changes[0]['.tags'], "['a', 'b']")
+        self.env.assertEqual(changes[1]['.age'], 'NULL')
+        self.env.assertEqual(changes[2]['.since'], '2.500000')
+        self.env.assertEqual(changes[3]['.age'], '31')
+        # Versions advance with each write.
+        versions = [int(c['version']) for c in changes]
+        self.env.assertEqual(versions, sorted(versions))
+        self.env.assertEqual(len(set(versions)), 3)
+
+    def test03_deleted(self):
+        redis_graph.query("MATCH ()-[k:KNOWS]-() DELETE k")
+        changes = self.changes(1)
+        self.env.assertEqual(changes[0]['op'], 'edge_deleted')
+        self.env.assertEqual(changes[0]['type'], 'KNOWS')
+
+        redis_graph.query("MATCH (p:Person) DETACH DELETE p")
+        changes = self.changes(2)
+        self.env.assertEqual([c['op'] for c in changes], ['node_deleted', 'node_deleted'])
+
+    def test04_trimmed(self):
+        redis_graph.query("UNWIND range(1, 3000) AS x CREATE (:N {x: x})")
+        for _ in range(100):
+            info = redis_con.execute_command("XINFO", "STREAM", STREAM)
+            info = dict(zip([_decode(k) for k in info[0::2]], info[1::2]))
+            last = info['last-entry'][1]
+            if _decode(last[-1]) == '3000':
+                break
+            time.sleep(0.05)
+        self.env.assertEqual(_decode(last[-1]), '3000')
+        # Trimming is approximate.
+        self.env.assertLess(info['length'], 2000)
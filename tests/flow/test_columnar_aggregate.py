@@ -0,0 +1,75 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "columnar_aggregate"
+redis_con = None
+redis_graph = None
+
+class testColumnarAggregate(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 199) AS x CREATE (:P {age: x % 50, height: toFloat(x) / 4})")
+        # Nodes missing attributes, and nodes of a different label.
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:P {height: x})")
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:Q {age: 1000})")
+
+    # Validates query is reduced to a projection, producing the same results
+    # as the non-optimized form, in which a projection separates scan from aggregation.
+    def _assert_columnar(self, match, ret, optimized=True):
+        query = "%s RETURN %s" % (match, ret)
+        plan = redis_graph.execution_plan(query)
+        if optimized:
+            self.env.assertNotIn("Aggregate", plan)
+            self.env.assertNotIn("Scan", plan)
+        else:
+            self.env.assertIn("Aggregate", plan)
+        actual = redis_graph.query(query).result_set
+        alias = match.split("(")[1].split(":")[0].split(")")[0]
+        expected = redis_graph.query("%s WITH %s RETURN %s" % (match, alias, ret)).result_set
+        self.env.assertEquals(actual, expected)
+        return actual
+
+    def test01_label_aggregations(self):
+        res = self._assert_columnar("MATCH (p:P)", "count(p), count(p.age), sum(p.age), avg(p.age), min(p.age), max(p.age)")
+        self.env.assertEquals(res, [[210, 200, 4900.0, 24.5, 0, 49]])
+        self._assert_columnar("MATCH (p:P)", "sum(p.height), avg(p.height), min(p.height), max(p.height)", optimized=False)
+
+    def test02_all_nodes_aggregations(self):
+        res = self._assert_columnar("MATCH (n)", "count(n), max(n.age), sum(n.age)")
+        self.env.assertEquals(res, [[220, 1000, 14900.0]])
+
+    def test03_filtered_aggregations(self):
+        res = self._assert_columnar("MATCH (p:P) WHERE p.age > 40", "count(p), avg(p.age), max(p.age)")
+        self.env.assertEquals(res, [[36, 45.0, 49]])
+        self._assert_columnar("MATCH (p:P) WHERE 10 >= p.age AND p.age <> 5", "count(p), sum(p.age)")
+        self._assert_columnar("MATCH (p:P) WHERE p.age = 1 OR p.height < 2.5", "count(p), count(p.age), min(p.age)")
+        self._assert_columnar("MATCH (p:P {age: 7})", "count(p), sum(p.age)")
+
+    def test04_unsupported(self):
+        # Grouping keys, distinct aggregations and non numeric comparisons are not optimized.
+        self._assert_columnar("MATCH (p:P)", "p.age, count(p)", optimized=False)
+        self._assert_columnar("MATCH (p:P)", "count(DISTINCT p.age)", optimized=False)
+        self._assert_columnar("MATCH (p:P) WHERE p.age > p.height", "count(p)", optimized=False)
+        # No records match, Aggregate emits no records.
+        self._assert_columnar("MATCH (p:P) WHERE p.age > 100", "count(p)", optimized=False)
+
+    def test05_columns_invalidated_by_writes(self):
+        self._assert_columnar("MATCH (p:P)", "sum(p.age)")
+        redis_graph.query("MATCH (p:P {age: 49}) SET p.age = 100")
+        res = self._assert_columnar("MATCH (p:P)", "sum(p.age), max(p.age)")
+        self.env.assertEquals(res, [[5104.0, 100]])
+        redis_graph.query("MATCH (p:P {age: 0}) DELETE p")
+        res = self._assert_columnar("MATCH (p:P)", "count(p), count(p.age), min(p.age)")
+        self.env.assertEquals(res, [[206, 196, 1]])
+
+        # Non numeric values can't be held by a column.
+        redis_graph.query("MATCH (p:P {age: 1}) WITH p LIMIT 1 SET p.age = 'one'")
+        self._assert_columnar("MATCH (p:P)", "count(p.age)", optimized=False)
@@ -0,0 +1,66 @@
+import os
+import sys
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "communities"
+redis_con = None
+redis_graph = None
+
+class testCommunitiesFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        # Cliques abcd and efgh bridged by d -> e, isolated i.
+        redis_graph.query("""CREATE (a:L {v:'a'}), (b:L {v:'b'}), (c:L {v:'c'}), (d:L {v:'d'}),
+                             (e:L {v:'e'}), (f:L {v:'f'}), (g:L {v:'g'}), (h:L {v:'h'}), (:L {v:'i'}),
+                             (a)-[:R]->(b), (a)-[:R]->(c), (a)-[:R]->(d), (b)-[:R]->(c), (b)-[:R]->(d), (c)-[:R]->(d),
+                             (e)-[:R]->(f), (e)-[:R]->(g), (e)-[:R]->(h), (f)-[:R]->(g), (f)-[:R]->(h), (g)-[:R]->(h),
+                             (d)-[:R]->(e)""")
+
+    # Returns the node groups sharing a community.
+    def communities(self, query):
+        groups = {}
+        for v, community in redis_graph.query(query).result_set:
+            groups.setdefault(community, []).append(v)
+        return sorted(sorted(group) for group in groups.values())
+
+    def test01_label_propagation(self):
+        q = "CALL algo.labelPropagation('L', 'R') YIELD node, communityId RETURN node.v, communityId"
+        expected = [['a', 'b', 'c', 'd'], ['e', 'f', 'g', 'h'], ['i']]
+        self.env.assertEqual(self.communities(q), expected)
+
+    def test02_louvain(self):
+        q = "CALL algo.louvain('L', 'R', NULL, 0.0001) YIELD node, communityId RETURN node.v, communityId"
+        expected = [['a', 'b', 'c', 'd'], ['e', 'f', 'g', 'h'], ['i']]
+        self.env.assertEqual(self.communities(q), expected)
+
+    def test03_write(self):
+        res = redis_graph.query("CALL algo.louvain.write('L', 'R', 'community')")
+        self.env.assertEqual(res.result_set[0][:2], [9, 3])
+        # 2 * (12 / 26 - (13 / 26)^2)
+        self.env.assertAlmostEqual(res.result_set[0][2], 0.423077, 1e-4)
+        self.env.assertEqual(res.properties_set, 9)
+
+        q = "MATCH (n:L) RETURN n.v, n.community"
+        self.env.assertEqual(self.communities(q), [['a', 'b', 'c', 'd'], ['e', 'f', 'g', 'h'], ['i']])
+
+        res = redis_graph.query("CALL algo.labelPropagation.write('L', 'R', 'lpa', 10)")
+        self.env.assertEqual(res.result_set[0][:2], [9, 3])
+        res = redis_graph.query("MATCH (d:L {v:'d'}), (e:L {v:'e'}) RETURN d.lpa = e.lpa")
+        self.env.assertEqual(res.result_set, [[False]])
+
+    def test04_invalid_arguments(self):
+        try:
+            redis_graph.query("CALL algo.louvain('L', 'R', 0) YIELD node RETURN node")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("positive number of iterations", str(e))
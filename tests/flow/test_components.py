@@ -0,0 +1,83 @@
+import os
+import sys
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "components"
+redis_con = None
+redis_graph = None
+
+class testComponentsFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        # Cycle a -> b -> c -> a, tail c -> d, e <-> f of another type, isolated g.
+        redis_graph.query("""CREATE (a:L {v:'a'})-[:R]->(b:L {v:'b'})-[:R]->(c:L {v:'c'})-[:R]->(a),
+                             (c)-[:R]->(d:L {v:'d'}), (e:L {v:'e'})-[:S]->(f:L {v:'f'})-[:S]->(e),
+                             (g:L {v:'g'}), (:X {v:'x'})-[:R]->(a)""")
+
+    # Returns the node groups sharing a component, ordered by their smallest member.
+    def components(self, query):
+        groups = {}
+        for v, component in redis_graph.query(query).result_set:
+            groups.setdefault(component, []).append(v)
+        return sorted(sorted(group) for group in groups.values())
+
+    def test01_wcc(self):
+        q = "CALL algo.wcc('L', 'R') YIELD node, componentId RETURN node.v, componentId"
+        self.env.assertEqual(self.components(q), [['a', 'b', 'c', 'd'], ['e'], ['f'], ['g']])
+
+        q = "CALL algo.wcc('L', ['R', 'S']) YIELD node, componentId RETURN node.v, componentId"
+        self.env.assertEqual(self.components(q), [['a', 'b', 'c', 'd'], ['e', 'f'], ['g']])
+
+        # Every node and relationship type.
+        q = "CALL algo.wcc(NULL, NULL) YIELD node, componentId RETURN node.v, componentId"
+        self.env.assertEqual(self.components(q), [['a', 'b', 'c', 'd', 'x'], ['e', 'f'], ['g']])
+
+        # Components are identified by their smallest node ID.
+        q = """CALL algo.wcc('L', ['R', 'S']) YIELD node, componentId
+               WITH componentId, min(id(node)) AS smallest RETURN count(*), sum(componentId - smallest)"""
+        self.env.assertEqual(redis_graph.query(q).result_set, [[3, 0]])
+
+    def test02_scc(self):
+        q = "CALL algo.scc('L', ['R', 'S']) YIELD node, componentId RETURN node.v, componentId"
+        self.env.assertEqual(self.components(q), [['a', 'b', 'c'], ['d'], ['e', 'f'], ['g']])
+
+        q = "CALL algo.scc(NULL, 'R') YIELD node, componentId RETURN node.v, componentId"
+        self.env.assertEqual(self.components(q), [['a', 'b', 'c'], ['d'], ['e'], ['f'], ['g'], ['x']])
+
+        # Unknown label.
+        q = "CALL algo.scc('Z', 'R') YIELD node, componentId RETURN node.v, componentId"
+        self.env.assertEqual(redis_graph.query(q).result_set, [])
+
+    def test03_write(self):
+        redis_graph.query("CREATE INDEX ON :L(scc)")
+        q = "CALL algo.scc.write('L', ['R', 'S'], 'scc') YIELD nodes, components RETURN nodes, components"
+        res = redis_graph.query(q)
+        self.env.assertEqual(res.result_set, [[7, 4]])
+        self.env.assertEqual(res.properties_set, 7)
+
+        q = "MATCH (n:L) RETURN n.v, n.scc"
+        self.env.assertEqual(self.components(q), [['a', 'b', 'c'], ['d'], ['e', 'f'], ['g']])
+
+        # Written components are indexed.
+        q = "MATCH (a:L {v:'a'}) MATCH (n:L) WHERE n.scc = a.scc RETURN count(n)"
+        self.env.assertEqual(redis_graph.query(q).result_set, [[3]])
+
+        q = "CALL algo.wcc.write('L', 'R', 'wcc') YIELD nodes, components RETURN nodes, components"
+        self.env.assertEqual(redis_graph.query(q).result_set, [[7, 4]])
+
+        # Writing is rejected by read-only queries.
+        try:
+            redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, "CALL algo.wcc.write('L', 'R', 'wcc')")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
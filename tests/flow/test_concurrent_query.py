@@ -1,5 +1,6 @@
 import os
 import sys
+import time
 import threading
 from RLTest import Env
 from redisgraph import Graph, Node, Edge
@@ -335,3 +336,92 @@ class testConcurrentQueryFlow(FlowTestsBase):
         for i in range(CLIENT_COUNT):
             self.env.assertIsNone(exceptions[i])
             self.env.assertEquals(1000, len(assertions[i].result_set))
+
+    def test_10_concurrent_small_writes(self):
+        # Concurrent writers are committed in groups, each query retains its own result.
+        global assertions
+        global exceptions
+        redis_con = self.env.getConnection()
+        redis_graph = Graph("small_writes", redis_con)
+        redis_graph.query("CREATE (:W {client: -1, i: -1})")
+        assertions = [True] * CLIENT_COUNT
+        exceptions = [None] * CLIENT_COUNT
+
+        def write_many(graph, threadID):
+            global assertions
+            try:
+                for i in range(20):
+                    result = graph.query("CREATE (:W {client: %d, i: %d}) RETURN %d" % (threadID, i, i))
+                    if result.nodes_created != 1 or result.properties_set != 2 or \
+                       result.result_set != [[i]]:
+                        assertions[threadID] = False
+                        break
+            except ResponseError as e:
+                exceptions[threadID] = str(e)
+
+        threads = []
+        for i in range(CLIENT_COUNT):
+            t = threading.Thread(target=write_many, args=(Graph("small_writes", graphs[i].redis_con), i))
+            t.setDaemon(True)
+            threads.append(t)
+            t.start()
+
+        for i in range(CLIENT_COUNT):
+            threads[i].join()
+            self.env.assertIsNone(exceptions[i])
+            self.env.assertTrue(assertions[i])
+
+        result = redis_graph.query("MATCH (w:W) RETURN count(w), count(DISTINCT w.client)")
+        self.env.assertEquals(result.result_set, [[CLIENT_COUNT * 20 + 1, CLIENT_COUNT + 1]])
+        # Every client's writes were committed in order.
+        result = redis_graph.query("MATCH (w:W {client: 3}) RETURN w.i ORDER BY id(w)")
+        self.env.assertEquals([row[0] for row in result.result_set], list(range(20)))
+
+    def test_11_commit_window_does_not_block_server(self):
+        # Writers of a commit window only hold the GIL while committing,
+        # other clients are served while the window's writers execute.
+        global exceptions
+        exceptions = [None] * CLIENT_COUNT
+        redis_con = self.env.getConnection()
+        other_graph = Graph("window_other", redis_con)
+        other_graph.query("CREATE (:O {v: 1})")
+
+        # Each write spends its time matching, creating a single node.
+        query = "UNWIND range(1, 2000000) AS x WITH x WHERE x = 2000000 CREATE (:L {v: x})"
+        writer_count = 4
+
+        def write_slow(graph, threadID):
+            try:
+                for i in range(3):
+                    graph.query(query)
+            except ResponseError as e:
+                exceptions[threadID] = str(e)
+
+        threads = []
+        for i in range(writer_count):
+            t = threading.Thread(target=write_slow, args=(Graph("window_slow", graphs[i].redis_con), i))
+            t.setDaemon(True)
+            threads.append(t)
+            t.start()
+
+        # Probe the server while the window runs.
+        max_ping = 0
+        max_read = 0
+        while any(t.is_alive() for t in threads):
+            start = time.time()
+            redis_con.ping()
+            max_ping = max(max_ping, time.time() - start)
+            start = time.time()
+            result = other_graph.query("MATCH (o:O) RETURN o.v")
+            max_read = max(max_read, time.time() - start)
+            self.env.assertEquals(result.result_set, [[1]])
+            time.sleep(0.05)
+
+        for i in range(writer_count):
+            threads[i].join()
+            self.env.assertIsNone(exceptions[i])
+
+        self.env.assertLess(max_ping, 1)
+        self.env.assertLess(max_read, 1)
+        result = Graph("window_slow", redis_con).query("MATCH (l:L) RETURN count(l)")
+        self.env.assertEquals(result.result_set, [[writer_count * 3]])
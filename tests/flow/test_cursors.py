@@ -0,0 +1,101 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "cursors"
+redis_con = None
+redis_graph = None
+
+class testCursors(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:Person {v: x})")
+
+    def query(self, query, count):
+        return redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, query, "cursor", count)
+
+    def read(self, cursor, *args):
+        return redis_con.execute_command("GRAPH.CURSOR", GRAPH_ID, "READ", cursor, *args)
+
+    def cursor(self, reply):
+        stats = [s.decode() if isinstance(s, bytes) else s for s in reply[-1]]
+        for stat in stats:
+            if stat.startswith("Cursor: "):
+                return int(stat.split(": ")[1])
+        return None
+
+    def values(self, reply):
+        return [row[0] for row in reply[1]]
+
+    def test01_pages(self):
+        query = "MATCH (p:Person) RETURN p.v ORDER BY p.v"
+        reply = self.query(query, 4)
+        self.env.assertEquals(self.values(reply), [1, 2, 3, 4])
+        cursor = self.cursor(reply)
+        self.env.assertGreater(cursor, 0)
+
+        # Each page is a complete result set.
+        reply = self.read(cursor)
+        self.env.assertEquals(len(reply), 3)
+        self.env.assertEquals(self.values(reply), [5, 6, 7, 8])
+        self.env.assertEquals(self.cursor(reply), cursor)
+
+        reply = self.read(cursor, "COUNT", 100)
+        self.env.assertEquals(self.values(reply), [9, 10])
+        self.env.assertEquals(self.cursor(reply), 0)
+
+        # Depleted cursors are discarded.
+        try:
+            self.read(cursor)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("unknown", str(e))
+
+    def test02_single_page(self):
+        reply = self.query("MATCH (p:Person) RETURN count(p)", 5)
+        self.env.assertEquals(self.values(reply), [10])
+        self.env.assertEquals(self.cursor(reply), 0)
+
+    def test03_invalidated_by_write(self):
+        reply = self.query("MATCH (p:Person) RETURN p.v", 3)
+        cursor = self.cursor(reply)
+        self.env.assertGreater(cursor, 0)
+
+        redis_graph.query("CREATE (:Person {v: 11})")
+        try:
+            self.read(cursor)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Cursor invalidated", str(e))
+        redis_graph.query("MATCH (p:Person {v: 11}) DELETE p")
+
+    def test04_delete(self):
+        reply = self.query("MATCH (p:Person) RETURN p.v", 2)
+        cursor = self.cursor(reply)
+        self.env.assertEquals(redis_con.execute_command("GRAPH.CURSOR", GRAPH_ID, "DEL", cursor), "OK")
+        try:
+            self.read(cursor)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("unknown", str(e))
+
+    def test05_invalid(self):
+        try:
+            redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "CREATE (:Person)", "cursor", 2)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("read-only", str(e))
+
+        try:
+            self.query("MATCH (p:Person) RETURN p", 0)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Failed to parse cursor count", str(e))
+
+        # Queries issued without the cursor option don't report a cursor.
+        reply = redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "MATCH (p:Person) RETURN p.v")
+        self.env.assertEquals(self.cursor(reply), None)
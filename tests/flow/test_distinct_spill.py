@@ -0,0 +1,52 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "distinct_spill"
+# Distinct keeps a few dozen fingerprints in memory before spilling.
+MODULE_ARGS = "DISTINCT_SPILL_THRESHOLD 1024"
+NODE_COUNT = 2000
+redis_graph = None
+
+class testDistinctSpill(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(moduleArgs=MODULE_ARGS)
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        query = """UNWIND range(0, %d) AS x CREATE (:N {v: x, g: x %% 500, s: 'name' + toString(x %% 300)})""" % (NODE_COUNT - 1)
+        redis_graph.query(query)
+        redis_graph.query("MATCH (a:N), (b:N) WHERE a.v < 50 AND b.v < 50 AND a.v <> b.v CREATE (a)-[:R]->(b)")
+
+    def test01_scalars(self):
+        query = "MATCH (n:N) RETURN DISTINCT n.g"
+        result = sorted(row[0] for row in redis_graph.query(query).result_set)
+        self.env.assertEquals(result, list(range(500)))
+
+        query = "MATCH (n:N) RETURN DISTINCT n.g % 7, n.s"
+        result = redis_graph.query(query).result_set
+        expected = set((x % 500 % 7, 'name' + str(x % 300)) for x in range(NODE_COUNT))
+        self.env.assertEquals(len(result), len(expected))
+        self.env.assertEquals(set(tuple(row) for row in result), expected)
+
+    def test02_order_by(self):
+        # Ordering expressions aren't part of the distinct projections.
+        query = "MATCH (n:N) RETURN DISTINCT n.g AS g ORDER BY g DESC"
+        result = [row[0] for row in redis_graph.query(query).result_set]
+        self.env.assertEquals(result, list(range(499, -1, -1)))
+
+        query = "MATCH (n:N) WITH DISTINCT n.s AS s RETURN count(s)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[300]])
+
+    def test03_entities(self):
+        query = "MATCH (a:N)-[:R]->(b:N) RETURN DISTINCT a"
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals(sorted(row[0].properties['v'] for row in result), list(range(50)))
+
+    def test04_union(self):
+        query = "MATCH (n:N) RETURN n.g AS g UNION MATCH (n:N) WHERE n.v < 100 RETURN n.v AS g"
+        result = sorted(row[0] for row in redis_graph.query(query).result_set)
+        self.env.assertEquals(result, list(range(500)))
@@ -0,0 +1,88 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "edge_index"
+redis_con = None
+redis_graph = None
+
+class testEdgeIndex(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:Account {v: x})")
+        # Accounts are connected by multiple transfers.
+        redis_graph.query("MATCH (a:Account), (b:Account {v: (a.v + 1) % 10}) CREATE (a)-[:TRANSFER {ts: a.v, kind: 'a'}]->(b), (a)-[:TRANSFER {ts: a.v + 10, kind: 'b'}]->(b)")
+        redis_graph.query("MATCH (a:Account {v: 0}), (b:Account {v: 5}) CREATE (a)-[:OTHER {ts: 1}]->(b)")
+        res = redis_graph.query("CALL db.idx.edge.createIndex('TRANSFER', 'ts', 'kind')")
+        self.env.assertEquals(res.indices_created, 2)
+
+    def test01_edge_index_scan(self):
+        q = "MATCH (a:Account)-[t:TRANSFER]->(b:Account) WHERE t.ts > 15 RETURN a.v, t.ts, b.v ORDER BY t.ts"
+        plan = redis_graph.execution_plan(q)
+        self.env.assertIn("Edge Index Scan", plan)
+        self.env.assertNotIn("Conditional Traverse", plan)
+        res = redis_graph.query(q)
+        self.env.assertEquals(res.result_set, [[6, 16, 7], [7, 17, 8], [8, 18, 9], [9, 19, 0]])
+
+        # Reversed pattern, parameters and residual filters.
+        q = "MATCH (b)<-[t:TRANSFER]-(a) WHERE t.ts >= $from AND t.kind = 'b' AND t.ts < 12 RETURN a.v, b.v ORDER BY a.v"
+        res = redis_graph.query(q, {'from': 5})
+        self.env.assertEquals(res.result_set, [[0, 1], [1, 2]])
+        q = "MATCH (b)<-[t:TRANSFER]-(a) WHERE t.ts >= 5 AND t.kind = 'b' AND t.ts < 12 RETURN a.v, b.v ORDER BY a.v"
+        self.env.assertIn("Edge Index Scan", redis_graph.execution_plan(q))
+
+        # Endpoint labels are validated.
+        res = redis_graph.query("MATCH (a:Missing)-[t:TRANSFER]->(b) WHERE t.ts = 1 RETURN count(t)")
+        self.env.assertEquals(res.result_set, [[0]])
+
+        # Unindexed relationship types are traversed.
+        q = "MATCH (a)-[t:OTHER]->(b) WHERE t.ts = 1 RETURN a.v, b.v"
+        self.env.assertNotIn("Edge Index Scan", redis_graph.execution_plan(q))
+        self.env.assertEquals(redis_graph.query(q).result_set, [[0, 5]])
+
+    def test02_indexed_source_preferred(self):
+        redis_graph.query("CREATE INDEX ON :Account(v)")
+        q = "MATCH (a:Account)-[t:TRANSFER]->(b) WHERE a.v = 3 AND t.ts > 0 RETURN t.ts ORDER BY t.ts"
+        plan = redis_graph.execution_plan(q)
+        self.env.assertNotIn("Edge Index Scan", plan)
+        self.env.assertEquals(redis_graph.query(q).result_set, [[3], [13]])
+
+    def test03_index_maintained(self):
+        q = "MATCH ()-[t:TRANSFER]->() WHERE t.ts = 100 RETURN t.kind ORDER BY t.kind"
+        redis_graph.query("MATCH (a:Account {v: 2})-[t:TRANSFER {ts: 2}]->() SET t.ts = 100")
+        redis_graph.query("MATCH (a:Account {v: 3}), (b:Account {v: 4}) CREATE (a)-[:TRANSFER {ts: 100, kind: 'c'}]->(b)")
+        self.env.assertEquals(redis_graph.query(q).result_set, [['a'], ['c']])
+
+        redis_graph.query("MATCH ()-[t:TRANSFER {kind: 'c'}]->() DELETE t")
+        self.env.assertEquals(redis_graph.query(q).result_set, [['a']])
+
+        # Deleting a node removes its edges from the index.
+        redis_graph.query("MATCH (a:Account {v: 2}) DELETE a")
+        self.env.assertEquals(redis_graph.query(q).result_set, [])
+        res = redis_graph.query("MATCH ()-[t:TRANSFER]->() WHERE t.ts > 10 RETURN count(t)")
+        self.env.assertEquals(res.result_set, [[7]])
+
+    def test04_persistence(self):
+        redis_con.execute_command("DEBUG", "RELOAD")
+        q = "MATCH ()-[t:TRANSFER]->() WHERE t.kind = 'a' RETURN count(t)"
+        self.env.assertIn("Edge Index Scan", redis_graph.execution_plan(q))
+        self.env.assertEquals(redis_graph.query(q).result_set, [[8]])
+
+    def test05_drop_index(self):
+        redis_graph.query("CALL db.idx.edge.drop('TRANSFER', 'kind')")
+        q = "MATCH ()-[t:TRANSFER]->() WHERE t.kind = 'a' RETURN count(t)"
+        self.env.assertNotIn("Edge Index Scan", redis_graph.execution_plan(q))
+        self.env.assertEquals(redis_graph.query(q).result_set, [[8]])
+
+        try:
+            redis_graph.query("CALL db.idx.edge.drop('TRANSFER', 'kind')")
+            self.env.assertTrue(False)
+        except Exception as e:
+            pass
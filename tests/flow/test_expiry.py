@@ -0,0 +1,68 @@
+import time
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "expiry"
+redis_con = None
+redis_graph = None
+
+class testExpiry(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    # Polls query until it yields expected, or the timeout elapses.
+    def wait_for(self, query, expected, timeout=10):
+        deadline = time.time() + timeout
+        actual = redis_graph.query(query).result_set
+        while actual != expected and time.time() < deadline:
+            time.sleep(0.2)
+            actual = redis_graph.query(query).result_set
+        return actual
+
+    def test01_expire_nodes(self):
+        redis_graph.query("CALL db.ttl.set('Event', 'ts', 60)")
+        # 2500 expired events span multiple reaping steps, recent and untimed events are kept.
+        redis_graph.query("UNWIND range(1, 2500) AS x CREATE (:Event {ts: timestamp() - 120000, v: x})-[:AT]->(:Place)")
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:Event {ts: timestamp(), v: x})")
+        redis_graph.query("CREATE (:Event {ts: 'never'}), (:Event)")
+        redis_graph.query("CREATE INDEX ON :Event(v)")
+
+        actual = self.wait_for("MATCH (e:Event) RETURN count(e)", [[12]])
+        self.env.assertEquals(actual, [[12]])
+        # Edges of expired nodes are deleted along.
+        res = redis_graph.query("MATCH ()-[r:AT]->() RETURN count(r)")
+        self.env.assertEquals(res.result_set, [[0]])
+        res = redis_graph.query("MATCH (p:Place) RETURN count(p)")
+        self.env.assertEquals(res.result_set, [[2500]])
+        # Expired nodes are removed from indices.
+        res = redis_graph.query("MATCH (e:Event) WHERE e.v = 1 RETURN count(e)")
+        self.env.assertEquals(res.result_set, [[1]])
+
+    def test02_expire_edges(self):
+        redis_graph.query("CALL db.ttl.edge.set('VISITED', 'ts', 60)")
+        redis_graph.query("CREATE (a:User)-[:VISITED {ts: timestamp() - 120000}]->(p:Page), (a)-[:VISITED {ts: timestamp()}]->(p)")
+
+        actual = self.wait_for("MATCH ()-[v:VISITED]->() RETURN count(v)", [[1]])
+        self.env.assertEquals(actual, [[1]])
+        res = redis_graph.query("MATCH (u:User), (p:Page) RETURN count(u), count(p)")
+        self.env.assertEquals(res.result_set, [[1, 1]])
+
+    def test03_disable_expiry(self):
+        redis_graph.query("CALL db.ttl.set('Event', 'ts', 0)")
+        redis_graph.query("CREATE (:Event {ts: 0})")
+        time.sleep(2)
+        res = redis_graph.query("MATCH (e:Event) RETURN count(e)")
+        self.env.assertEquals(res.result_set, [[13]])
+
+    def test04_persisted(self):
+        redis_graph.query("CALL db.ttl.set('Session', 'ts', 60)")
+        redis_con.execute_command("DEBUG", "RELOAD")
+        redis_graph.query("CREATE (:Session {ts: 0}), (:Session {ts: timestamp()})")
+
+        actual = self.wait_for("MATCH (s:Session) RETURN count(s)", [[1]])
+        self.env.assertEquals(actual, [[1]])
@@ -0,0 +1,45 @@
+import time
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "expiry_replication"
+redis_con = None
+replica_con = None
+
+class testExpiryReplication(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(useSlaves=True)
+        global redis_con
+        global replica_con
+        redis_con = self.env.getConnection()
+        replica_con = self.env.getSlaveConnection()
+
+    def query(self, con, query):
+        return con.execute_command("GRAPH.QUERY", GRAPH_ID, query)[1]
+
+    def test01_replicas_delete_expired_entities(self):
+        # Leave holes in the ID space, which persistence compacts on the replica.
+        self.query(redis_con, "UNWIND range(1, 100) AS x CREATE (:Tmp)-[:TMP]->(:Tmp)")
+        self.query(redis_con, "MATCH (t:Tmp) DELETE t")
+        self.query(redis_con, "UNWIND range(1, 50) AS x CREATE (:Keep {v: x})-[:R {ts: timestamp(), v: x}]->(:Keep {v: x})")
+        self.query(redis_con, "UNWIND range(1, 50) AS x CREATE (:Event {ts: timestamp() - 120000, v: x})-[:R {ts: timestamp() - 120000, v: x}]->(:Keep {v: 100 + x})")
+        redis_con.execute_command("WAIT", 1, 0)
+        # Reloading renumbers the replica's entities, IDs no longer match the master's.
+        replica_con.execute_command("DEBUG", "RELOAD")
+
+        self.query(redis_con, "CALL db.ttl.set('Event', 'ts', 60)")
+        self.query(redis_con, "CALL db.ttl.edge.set('R', 'ts', 60)")
+        deadline = time.time() + 10
+        while time.time() < deadline:
+            if self.query(redis_con, "MATCH (e:Event) RETURN count(e)") == [[0]]:
+                break
+            time.sleep(0.2)
+        redis_con.execute_command("WAIT", 1, 0)
+
+        for query in ["MATCH (e:Event) RETURN count(e)",
+                      "MATCH (k:Keep) RETURN k.v ORDER BY k.v",
+                      "MATCH (a)-[r:R]->(b) RETURN a.v, r.v, b.v ORDER BY r.v"]:
+            self.env.assertEquals(self.query(replica_con, query), self.query(redis_con, query))
+        self.env.assertEquals(self.query(redis_con, "MATCH (e:Event) RETURN count(e)"), [[0]])
+        self.env.assertEquals(self.query(redis_con, "MATCH ()-[r:R]->() RETURN count(r)"), [[50]])
@@ -0,0 +1,102 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "graph_export"
+IMPORT_ID = "graph_export_import"
+redis_con = None
+redis_graph = None
+redis_import = None
+
+class testGraphExport(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        global redis_import
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_import = Graph(IMPORT_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:N {v: x, name: 'n' + toString(x), tags: [x, 'tag'], f: x / 2.0})")
+        redis_graph.query("MATCH (a:N), (b:N {v: a.v + 1}) CREATE (a)-[:R {v: a.v}]->(b), (a)-[:R {v: -a.v}]->(b)")
+        redis_graph.query("CREATE (:M:N {v: 3000, p: point({latitude: 1.5, longitude: 2.5})}), ()")
+        redis_graph.query("CREATE (:Empty)-[:S]->(:Empty)")
+        redis_graph.query("MATCH (e:Empty) DELETE e")
+        # Deleted nodes leave gaps in the node IDs.
+        redis_graph.query("MATCH (a:N) WHERE a.v % 10 = 0 DELETE a")
+
+    def _export(self, graph):
+        return redis_con.execute_command("GRAPH.EXPORT", graph)
+
+    def test01_export_missing_graph(self):
+        try:
+            self._export("missing_graph")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("missing", str(e))
+        self.env.assertEquals(redis_con.exists("missing_graph"), 0)
+
+    def test02_export_import(self):
+        node_count, edge_count, nodes, relations = self._export(GRAPH_ID)
+        self.env.assertEquals(node_count, 92)
+        self.env.assertEquals(edge_count, 160)
+
+        res = redis_con.execute_command("GRAPH.BULK", IMPORT_ID, "BEGIN", node_count, edge_count,
+                                        len(nodes), len(relations), *(nodes + relations))
+        self.env.assertIn(b"92 nodes created, 160 edges created", res)
+
+        queries = ["MATCH (a:N)-[e:R]->(b:N) RETURN a.name, a.tags, a.f, e.v, b.name ORDER BY e.v",
+                   "MATCH (a:N)<-[e:R]-(b:N) RETURN a.v, b.v, count(e) ORDER BY a.v",
+                   "MATCH (a:M:N) RETURN a.v, a.p",
+                   "MATCH (a) RETURN count(a)",
+                   # Labels and relationship types without entities are exported.
+                   "CALL db.labels()",
+                   "CALL db.relationshipTypes()"]
+        for q in queries:
+            self.env.assertEquals(redis_import.query(q).result_set, redis_graph.query(q).result_set)
+
+    def test03_export_empty_graph(self):
+        redis_con.execute_command("GRAPH.BULK", "graph_export_empty", "BEGIN", 0, 0, 0, 0)
+        self.env.assertEquals(self._export("graph_export_empty"), [0, 0, [], []])
+
+    def test04_export_partitions(self):
+        expected_nodes = set(tuple(row) for row in redis_graph.query("MATCH (a) RETURN id(a), a.v").result_set)
+        expected_edges = set(tuple(row) for row in redis_graph.query("MATCH (a)-[e:R]->(b) RETURN id(a), id(b), e.v").result_set)
+        for scheme in ["HASH", "RANGE"]:
+            nodes = set()
+            edges = set()
+            node_total = 0
+            for i in range(3):
+                partition = "graph_export_%s_%d" % (scheme, i)
+                node_count, edge_count, node_tokens, relation_tokens = redis_con.execute_command(
+                    "GRAPH.EXPORT", GRAPH_ID, "PARTITION", i, 3, scheme)
+                redis_con.execute_command("GRAPH.BULK", partition, "BEGIN", node_count, edge_count,
+                                          len(node_tokens), len(relation_tokens), *(node_tokens + relation_tokens))
+                g = Graph(partition, redis_con)
+                # Nodes are identified across partitions by their ID in the exported graph.
+                res = g.query("MATCH (a) RETURN a._gid, a.v").result_set
+                self.env.assertEquals(len(res), node_count)
+                node_total += node_count
+                nodes.update(tuple(row) for row in res)
+                res = g.query("MATCH (a)-[e:R]->(b) RETURN a._gid, b._gid, e.v").result_set
+                self.env.assertEquals(len(res), edge_count)
+                edges.update(tuple(row) for row in res)
+                # Labels and relationship types are exported to every partition.
+                self.env.assertEquals(g.query("CALL db.relationshipTypes()").result_set,
+                                      redis_graph.query("CALL db.relationshipTypes()").result_set)
+            # Every node and edge is held by some partition,
+            # boundary nodes are replicated in the partitions of their neighbors.
+            self.env.assertEquals(nodes, expected_nodes)
+            self.env.assertEquals(edges, expected_edges)
+            self.env.assertGreater(node_total, len(expected_nodes))
+
+    def test05_export_invalid_partition(self):
+        for args in [["PARTITION", 3, 3], ["PARTITION", -1, 3], ["PARTITION", 0, 0], ["PARTITION", 0, 2, "ROUND_ROBIN"]]:
+            try:
+                redis_con.execute_command("GRAPH.EXPORT", GRAPH_ID, *args)
+                self.env.assertTrue(False)
+            except Exception as e:
+                self.env.assertIn("PARTITION" if args[-1] != "ROUND_ROBIN" else "scheme", str(e))
@@ -0,0 +1,57 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "fetch"
+redis_con = None
+redis_graph = None
+
+class testFetch(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("CREATE (:Person {name: 'a', age: 1})-[:KNOWS {since: 2000}]->(:Person {name: 'b', age: 2})")
+
+    def attribute_ids(self):
+        result = redis_graph.query("CALL db.propertyKeys()")
+        return {row[0]: i for i, row in enumerate(result.result_set)}
+
+    def test01_compact_ids(self):
+        reply = redis_con.execute_command("GRAPH.QUERY", GRAPH_ID,
+                                          "MATCH (a)-[e]->(b) RETURN a, e, b, a.name", "--compact-ids")
+        row = reply[1][0]
+        # Nodes and edges are replied without their properties.
+        self.env.assertEquals(row[0], [0, [0]])
+        self.env.assertEquals(row[1], [0, 0, 0, 1])
+        self.env.assertEquals(row[2], [1, [0]])
+        # Scalars are unaffected.
+        self.env.assertEquals(row[3], [2, "a"])
+
+    def test02_fetch_nodes(self):
+        ids = self.attribute_ids()
+        reply = redis_con.execute_command("GRAPH.FETCH", GRAPH_ID, "NODES", 3, 1, 0, 100)
+        self.env.assertEquals(reply[0], [[ids["name"], 2, "b"], [ids["age"], 3, 2]])
+        self.env.assertEquals(reply[1], [[ids["name"], 2, "a"], [ids["age"], 3, 1]])
+        # Missing entities reply with null.
+        self.env.assertEquals(reply[2], None)
+
+    def test03_fetch_properties(self):
+        ids = self.attribute_ids()
+        reply = redis_con.execute_command("GRAPH.FETCH", GRAPH_ID, "NODES", 2, 0, 1,
+                                          "PROPERTIES", 2, "age", "unknown")
+        self.env.assertEquals(reply, [[[ids["age"], 3, 1]], [[ids["age"], 3, 2]]])
+
+        reply = redis_con.execute_command("GRAPH.FETCH", GRAPH_ID, "EDGES", 2, 0, 1)
+        self.env.assertEquals(reply, [[[ids["since"], 3, 2000]], None])
+
+    def test04_invalid_arguments(self):
+        for args in [["NODES", 2, 0], ["VERTICES", 1, 0], ["NODES", 1, -1],
+                     ["NODES", 1, 0, "PROPERTIES", 2, "name"]]:
+            try:
+                redis_con.execute_command("GRAPH.FETCH", GRAPH_ID, *args)
+                self.env.assertTrue(False)
+            except Exception:
+                pass
@@ -0,0 +1,78 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "filter_batch"
+redis_graph = None
+
+class testFilterBatch(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # Integer, floating point, missing and string values.
+        redis_graph.query("UNWIND range(0, 999) AS i CREATE (:N {v: i, d: i / 2.0})")
+        redis_graph.query("UNWIND range(0, 9) AS i CREATE (:N {s: 'str' + toString(i)})")
+
+    def _ids(self, where):
+        query = "MATCH (n:N) WHERE %s RETURN n.v" % where
+        return [row[0] for row in redis_graph.query(query).result_set]
+
+    def test01_numeric_predicates(self):
+        # Records pass in scan order.
+        self.env.assertEquals(self._ids("n.v > 990"), list(range(991, 1000)))
+        self.env.assertEquals(self._ids("n.v <= 3"), [0, 1, 2, 3])
+        self.env.assertEquals(self._ids("n.v = 500"), [500])
+        self.env.assertEquals(len(self._ids("n.v <> 500")), 999)
+        self.env.assertEquals(self._ids("n.d >= 498.5"), [997, 998, 999])
+        self.env.assertEquals(self._ids("n.d < 1"), [0, 1])
+        self.env.assertEquals(self._ids("n.v = 2.0"), [2])
+
+    def test02_conditions(self):
+        self.env.assertEquals(self._ids("n.v > 10 AND n.v < 14"), [11, 12, 13])
+        self.env.assertEquals(self._ids("n.v < 2 OR n.v > 997 OR n.v = 500"), [0, 1, 500, 998, 999])
+        self.env.assertEquals(self._ids("(n.v < 5 OR n.v > 995) AND n.v % 2 = 0"), [0, 2, 4, 996, 998])
+        self.env.assertEquals(self._ids("NOT n.v >= 3"), [0, 1, 2])
+
+    def test03_mixed_values(self):
+        # Missing properties fail comparisons.
+        query = "MATCH (n:N) WHERE n.s >= 'str8' RETURN n.s"
+        self.env.assertEquals(redis_graph.query(query).result_set, [['str8'], ['str9']])
+        query = "MATCH (n:N) WHERE n.v < 1 OR n.s = 'str3' RETURN n.v, n.s"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[0, None], [None, 'str3']])
+
+    def test04_limit(self):
+        query = "MATCH (n:N) WHERE n.v % 3 = 0 RETURN n.v LIMIT 4"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[0], [3], [6], [9]])
+        query = "MATCH (n:N) WHERE n.v >= 0 RETURN count(n)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[1000]])
+
+    def test05_reordered_conditions(self):
+        # Results don't depend on the order in which conditions are evaluated.
+        sevens = [v for v in range(901, 1000) if v % 7 == 0]
+        self.env.assertEquals(self._ids("n.v % 7 = 0 AND n.v > 900 AND n.s IS NULL"), sevens)
+        self.env.assertEquals(self._ids("n.s IS NULL AND n.v > 900 AND n.v % 7 = 0"), sevens)
+        self.env.assertEquals(self._ids("n.v IN [901, 913, 910, 955] AND toString(n.v) CONTAINS '0'"), [901, 910])
+
+        # Conditions are reordered as pass rates are observed over many records.
+        query = "UNWIND range(0, 4999) AS i WITH i WHERE i >= 0 AND i % 1000 = 1 AND i <> 4001 RETURN i"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[1], [1001], [2001], [3001]])
+
+    def test06_list_lookups(self):
+        # Equal numerics of either type match, other types don't.
+        self.env.assertEquals(self._ids("n.v IN [3, 1, 3.0, 'x', true]"), [1, 3])
+        self.env.assertEquals(self._ids("n.v IN []"), [])
+
+        # Null elements and values yield null rather than false.
+        self.env.assertEquals(self._ids("n.v IN [1, null]"), [1])
+        self.env.assertEquals(self._ids("NOT n.v IN [1, null]"), [])
+        self.env.assertEquals(len(self._ids("NOT n.v IN [0, 1]")), 998)
+
+        query = "CYPHER ids=[5, 999, 5, 7] MATCH (n:N) WHERE n.v IN $ids RETURN n.v"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[5], [7], [999]])
+        query = "MATCH (n:N) WHERE n.s IN ['str1', 'str7', 'str'] RETURN n.s"
+        self.env.assertEquals(redis_graph.query(query).result_set, [['str1'], ['str7']])
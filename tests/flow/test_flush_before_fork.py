@@ -0,0 +1,39 @@
+import time
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "flush_before_fork"
+redis_con = None
+redis_graph = None
+
+class testFlushBeforeFork(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(moduleArgs="FLUSH_BEFORE_FORK yes")
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def wait_for_save(self):
+        while redis_con.info("persistence")["rdb_bgsave_in_progress"]:
+            time.sleep(0.1)
+
+    def test01_bgsave_with_pending_changes(self):
+        redis_graph.query("UNWIND range(0, 999) AS x CREATE (:A {v: x})-[:R]->(:B {v: x})")
+        redis_graph.query("MATCH (a:A) WHERE a.v % 2 = 0 DELETE a")
+        redis_con.execute_command("BGSAVE")
+        # Write while the child is saving.
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:A {v: x})")
+        self.wait_for_save()
+        self.env.assertEquals(redis_con.info("persistence")["rdb_last_bgsave_status"], "ok")
+
+        res = redis_graph.query("MATCH (a:A)-[:R]->(b:B) RETURN count(b)")
+        self.env.assertEquals(res.result_set[0][0], 500)
+        res = redis_graph.query("MATCH (a:A) RETURN count(a)")
+        self.env.assertEquals(res.result_set[0][0], 600)
+
+    def test02_reload_saved_graph(self):
+        redis_con.execute_command("DEBUG", "RELOAD")
+        res = redis_graph.query("MATCH (b:B)<-[:R]-(a:A) RETURN count(a)")
+        self.env.assertEquals(res.result_set[0][0], 500)
@@ -0,0 +1,157 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "graph_compact"
+redis_con = None
+redis_graph = None
+
+class testGraphCompact(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:N {v:x})")
+        redis_graph.query("MATCH (a:N), (b:N {v: a.v + 1}) CREATE (a)-[:R {v:a.v}]->(b)")
+        redis_graph.query("MATCH (a:N), (b:N {v: a.v + 1}) CREATE (a)-[:R {v:a.v}]->(b)")
+        redis_graph.query("CREATE INDEX ON :N(v)")
+
+    def _compact(self):
+        return str(redis_con.execute_command("GRAPH.COMPACT", GRAPH_ID))
+
+    def test01_compact_missing_graph(self):
+        try:
+            redis_con.execute_command("GRAPH.COMPACT", "missing_graph")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("missing", str(e))
+        # Graph key isn't created.
+        self.env.assertEquals(redis_con.exists("missing_graph"), 0)
+
+    def test02_compact_without_deletions(self):
+        res = self._compact()
+        self.env.assertIn("Reclaimed 0 node IDs and 0 relationship IDs", res)
+
+    def test03_compact_after_deletions(self):
+        # Delete every odd node, removing all edges.
+        redis_graph.query("MATCH (n:N) WHERE n.v % 2 = 1 DELETE n")
+        res = redis_graph.query("MATCH ()-[e:R]->() RETURN count(e)")
+        self.env.assertEquals(res.result_set[0][0], 0)
+
+        redis_graph.query("MATCH (a:N), (b:N {v: a.v + 2}) CREATE (a)-[:R {v:a.v}]->(b)")
+        redis_graph.query("MATCH (a:N), (b:N {v: a.v + 2}) CREATE (a)-[:R {v:a.v}]->(b)")
+        redis_graph.query("MATCH (:N {v:0})-[e:R]->() WITH e LIMIT 1 DELETE e")
+
+        res = self._compact()
+        self.env.assertIn("Reclaimed 50 node IDs", res)
+
+        # Node IDs are dense.
+        res = redis_graph.query("MATCH (n:N) RETURN min(id(n)), max(id(n)), count(n)")
+        self.env.assertEquals(res.result_set, [[0, 49, 50]])
+        res = redis_graph.query("MATCH ()-[e:R]->() RETURN min(id(e)), max(id(e)), count(e)")
+        self.env.assertEquals(res.result_set, [[0, 96, 97]])
+
+        # Relative order is preserved.
+        res = redis_graph.query("MATCH (n:N) RETURN id(n), n.v ORDER BY id(n) LIMIT 3")
+        self.env.assertEquals(res.result_set, [[0, 0], [1, 2], [2, 4]])
+
+    def test04_traverse_compacted_graph(self):
+        res = redis_graph.query("MATCH (a:N {v:10})-[e:R]->(b) RETURN e.v, b.v")
+        self.env.assertEquals(res.result_set, [[10, 12], [10, 12]])
+        res = redis_graph.query("MATCH (a:N {v:12})<-[e:R]-(b) RETURN e.v, b.v")
+        self.env.assertEquals(res.result_set, [[10, 10], [10, 10]])
+        res = redis_graph.query("MATCH (a:N {v:0})-[:R*]->(b) RETURN max(b.v)")
+        self.env.assertEquals(res.result_set, [[98]])
+
+    def test05_index_rebuilt(self):
+        query = "MATCH (n:N) WHERE n.v = 42 RETURN id(n), n.v"
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Index Scan", plan)
+        res = redis_graph.query(query)
+        self.env.assertEquals(res.result_set, [[21, 42]])
+
+    def test06_compacted_graph_persists(self):
+        redis_graph.query("CREATE (:N {v:1000})")
+        redis_con.execute_command("DEBUG", "RELOAD")
+        res = redis_graph.query("MATCH (n:N {v:1000}) RETURN id(n)")
+        self.env.assertEquals(res.result_set, [[50]])
+        res = redis_graph.query("MATCH (a:N {v:10})-[e:R]->(b) RETURN e.v, b.v")
+        self.env.assertEquals(res.result_set, [[10, 12], [10, 12]])
+
+    def test07_compact_unknown_option(self):
+        try:
+            redis_con.execute_command("GRAPH.COMPACT", GRAPH_ID, "SHUFFLE")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Unknown GRAPH.COMPACT option", str(e))
+
+    def test08_reorder(self):
+        # Chain nodes whose IDs are far apart.
+        redis_graph.query("UNWIND range(0, 49) AS x CREATE (:M {v:x})")
+        redis_graph.query("MATCH (a:M), (b:M) WHERE b.v = (a.v * 7 + 3) % 50 AND a.v <> 27 CREATE (a)-[:C]->(b)")
+        expected = redis_graph.query("MATCH (a:M {v:0})-[:C*]->(b) RETURN b.v ORDER BY b.v").result_set
+
+        res = str(redis_con.execute_command("GRAPH.COMPACT", GRAPH_ID, "REORDER"))
+        self.env.assertIn("before and", res)
+
+        # Structure, properties and indices are intact.
+        res = redis_graph.query("MATCH (a:M {v:0})-[:C*]->(b) RETURN b.v ORDER BY b.v")
+        self.env.assertEquals(res.result_set, expected)
+        res = redis_graph.query("MATCH (a:N {v:10})-[e:R]->(b) RETURN e.v, b.v")
+        self.env.assertEquals(res.result_set, [[10, 12], [10, 12]])
+        res = redis_graph.query("MATCH (n:N) WHERE n.v = 42 RETURN n.v")
+        self.env.assertEquals(res.result_set, [[42]])
+        res = redis_graph.query("MATCH (n) RETURN min(id(n)), max(id(n)), count(n)")
+        self.env.assertEquals(res.result_set, [[0, 100, 101]])
+
+        # Connected nodes are assigned nearby IDs.
+        res = redis_graph.query("MATCH (a:M)-[:C]->(b:M) RETURN avg(abs(id(a) - id(b)))")
+        self.env.assertLess(res.result_set[0][0], 5)
+
+    def test09_pack_properties(self):
+        redis_graph.query("UNWIND range(0, 4) AS x CREATE (:P {i: x - 2, f: x / 2.0, s: 'name' + toString(x), b: x % 2 = 0, l: range(0, x + 3), m: ['a', x]})")
+        query = "MATCH (p:P) RETURN p.i, p.f, p.s, p.b, p.l, p.m, p ORDER BY p.i"
+        expected = redis_graph.query(query).result_set
+
+        res = str(redis_con.execute_command("GRAPH.COMPACT", GRAPH_ID, "PACK"))
+        self.env.assertIn("packed the properties of", res)
+
+        # Packed properties are expanded once accessed.
+        res = redis_graph.query(query)
+        self.env.assertEquals(res.result_set, expected)
+
+        # Accessed entities are left expanded.
+        res = str(redis_con.execute_command("GRAPH.COMPACT", GRAPH_ID, "PACK"))
+        self.env.assertIn("packed the properties of 0 entities", res)
+        res = str(redis_con.execute_command("GRAPH.COMPACT", GRAPH_ID, "PACK"))
+        self.env.assertIn("packed the properties of 5 entities", res)
+
+        # Packed entities can be updated and persisted.
+        redis_graph.query("MATCH (p:P {i: 0}) SET p.s = 'updated', p.n = 1")
+        redis_graph.query("MATCH (p:P {i: 1}) SET p.f = NULL")
+        redis_con.execute_command("GRAPH.COMPACT", GRAPH_ID, "PACK")
+        redis_con.execute_command("DEBUG", "RELOAD")
+        res = redis_graph.query("MATCH (p:P) WHERE p.i >= 0 RETURN p.i, p.s, p.f, p.n ORDER BY p.i")
+        self.env.assertEquals(res.result_set, [[0, "updated", 1.0, 1], [1, "name3", None, None], [2, "name4", 2.0, None]])
+
+    def test10_edge_index_rebuilt_after_edge_deletions(self):
+        # Reclaiming relationship IDs alone renumbers edges, their index is rebuilt.
+        graph = Graph("graph_compact_edges", redis_con)
+        graph.query("UNWIND range(0, 19) AS x CREATE (:A {v: x})-[:T {ts: x}]->(:B {v: x})")
+        graph.query("CALL db.idx.edge.createIndex('T', 'ts')")
+        graph.query("MATCH ()-[t:T]->() WHERE t.ts < 10 DELETE t")
+
+        res = str(redis_con.execute_command("GRAPH.COMPACT", "graph_compact_edges"))
+        self.env.assertIn("Reclaimed 0 node IDs and 10 relationship IDs", res)
+
+        q = "MATCH (a:A)-[t:T]->(b:B) WHERE t.ts >= 0 RETURN a.v, t.ts, b.v ORDER BY t.ts"
+        self.env.assertIn("Edge Index Scan", graph.execution_plan(q))
+        expected = [[x, x, x] for x in range(10, 20)]
+        self.env.assertEquals(graph.query(q).result_set, expected)
+        q = "MATCH (a:A)-[t:T]->(b:B) WHERE t.ts = 15 RETURN a.v, b.v"
+        self.env.assertEquals(graph.query(q).result_set, [[15, 15]])
@@ -0,0 +1,89 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "graph_copy"
+COPY_ID = "graph_copy_clone"
+redis_con = None
+redis_graph = None
+redis_copy = None
+
+class testGraphCopy(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        global redis_copy
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_copy = Graph(COPY_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:N {v: x, name: 'n' + toString(x), tags: [x, 'tag']})")
+        # Multiple edges connecting the same pair of nodes.
+        redis_graph.query("MATCH (a:N), (b:N {v: a.v + 1}) CREATE (a)-[:R {v: a.v}]->(b), (a)-[:R {v: -a.v}]->(b)")
+        redis_graph.query("CREATE (:M:N {v: 3000, name: 'm'})")
+        redis_graph.query("MATCH (a:N) WHERE a.v % 10 = 0 DELETE a")
+        redis_graph.query("CREATE INDEX ON :N(v)")
+
+    def _copy(self, src, dest):
+        return str(redis_con.execute_command("GRAPH.COPY", src, dest))
+
+    def test01_copy_missing_graph(self):
+        try:
+            self._copy("missing_graph", COPY_ID)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("missing", str(e))
+        self.env.assertEquals(redis_con.exists(COPY_ID), 0)
+
+    def test02_copy(self):
+        res = self._copy(GRAPH_ID, COPY_ID)
+        self.env.assertIn("Copied 91 nodes and 160 relationships", res)
+
+        # Entities retain their IDs, properties and connections.
+        q = "MATCH (a:N)-[e:R]->(b:N) RETURN ID(a), a.name, a.tags, ID(e), e.v, ID(b) ORDER BY ID(e)"
+        self.env.assertEquals(redis_copy.query(q).result_set, redis_graph.query(q).result_set)
+        q = "MATCH (a:N)<-[e:R]-(b:N) RETURN ID(a), ID(b), count(e) ORDER BY ID(a)"
+        self.env.assertEquals(redis_copy.query(q).result_set, redis_graph.query(q).result_set)
+
+        q = "MATCH (a:M) RETURN a.v"
+        self.env.assertEquals(redis_copy.query(q).result_set, [[3000]])
+
+        # Index is rebuilt over the copy.
+        plan = redis_copy.execution_plan("MATCH (a:N) WHERE a.v = 5 RETURN a.name")
+        self.env.assertIn("Index Scan", plan)
+        res = redis_copy.query("MATCH (a:N) WHERE a.v = 5 RETURN a.name")
+        self.env.assertEquals(res.result_set, [["n5"]])
+
+    def test03_copies_are_independent(self):
+        redis_copy.query("MATCH (a:N {v: 1})-[e:R]->() DELETE a")
+        redis_copy.query("MATCH (a:N {v: 2}) SET a.name = 'modified'")
+        redis_graph.query("CREATE (:N {v: 1000})")
+
+        res = redis_graph.query("MATCH (a:N) WHERE a.v IN [1, 2] RETURN a.name ORDER BY a.v")
+        self.env.assertEquals(res.result_set, [["n1"], ["n2"]])
+        res = redis_graph.query("MATCH (a:N {v: 1})-[e:R]->() RETURN count(e)")
+        self.env.assertEquals(res.result_set, [[2]])
+        res = redis_copy.query("MATCH (a:N) WHERE a.v IN [1, 2, 1000] RETURN a.name ORDER BY a.v")
+        self.env.assertEquals(res.result_set, [["modified"]])
+
+        # Deleting the source leaves the copy intact.
+        redis_graph.delete()
+        res = redis_copy.query("MATCH (a:N) RETURN count(a)")
+        self.env.assertEquals(res.result_set, [[90]])
+
+    def test04_copy_persists(self):
+        redis_con.execute_command("DEBUG", "RELOAD")
+        res = redis_copy.query("MATCH (a:N)-[e:R]->() RETURN count(e)")
+        self.env.assertEquals(res.result_set, [[158]])
+
+    def test05_destination_exists(self):
+        redis_con.set("occupied", "1")
+        try:
+            self._copy(COPY_ID, "occupied")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("already exists", str(e))
+        self.env.assertEquals(redis_con.get("occupied"), b"1")
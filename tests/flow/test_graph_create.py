@@ -44,3 +44,30 @@ class testGraphCreationFlow(FlowTestsBase):
         self.env.assertEquals(result.nodes_created, 3)
         self.env.assertEquals(result.properties_set, 3)
         self.env.assertEquals(result.result_set, expected_result)
+
+    def test04_create_from_unwind_list(self):
+        # Nodes created directly from the elements of an UNWIND list.
+        rows = [[i, 'r' + str(i), i / 2.0] for i in range(100)]
+        query = """UNWIND $rows AS r CREATE (:row {id: r[0], name: r[1], half: r[2], last: r[-1], missing: r[5], kind: 'batch'})"""
+        result = redis_graph.query(query, {'rows': rows})
+        self.env.assertEquals(result.labels_added, 1)
+        self.env.assertEquals(result.nodes_created, 100)
+
+        query = """MATCH (r:row) RETURN r.id, r.name, r.half, r.last, r.missing, r.kind ORDER BY r.id LIMIT 2"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[0, 'r0', 0, 0, None, 'batch'],
+                                                  [1, 'r1', 0.5, 0.5, None, 'batch']])
+
+        # Multiple nodes per element, each element used as the property value.
+        query = """UNWIND [1, 2, 3] AS x CREATE (:a {v: x}), (:b {v: x})"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.nodes_created, 6)
+        query = """MATCH (a:a), (b:b {v: a.v}) RETURN a.v ORDER BY a.v"""
+        self.env.assertEquals(redis_graph.query(query).result_set, [[1], [2], [3]])
+
+        # Subscripting a value other than a list fails the query.
+        try:
+            redis_graph.query("UNWIND [[1], 2] AS r CREATE (:row {id: r[0]})")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Type mismatch", str(e))
@@ -282,3 +282,60 @@ class testGraphDeletionFlow(FlowTestsBase):
         actual_result = redis_graph.query(query)
         expected_result = [[1]]
         self.env.assertEquals(actual_result.result_set, expected_result)
+
+    def test15_bulk_delete_multi_edges(self):
+        self.env.flush()
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+        # Connect pairs by a varying number of edges, of two relationship types.
+        redis_graph.query("""UNWIND range(0, 9) AS i CREATE (a:A {v: i})-[:R {v: 0}]->(b:B {v: i})
+                             WITH a, b, i UNWIND range(1, i) AS j CREATE (a)-[:R {v: j}]->(b), (a)-[:S {v: j}]->(b)""")
+
+        # Delete some of the edges connecting each pair, disconnecting pairs of a single edge.
+        actual_result = redis_graph.query("MATCH (:A)-[e:R]->(:B) WHERE e.v % 2 = 0 DELETE e")
+        self.env.assertEquals(actual_result.relationships_deleted, 30)
+
+        actual_result = redis_graph.query("MATCH (a:A)-[e:R]->(:B) RETURN a.v, count(e), collect(e.v % 2) ORDER BY a.v")
+        expected_result = [[i, i - i // 2, [1] * (i - i // 2)] for i in range(1, 10)]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        # Delete every remaining edge of both relationship types.
+        actual_result = redis_graph.query("MATCH (:A)-[e]->(:B) DELETE e")
+        self.env.assertEquals(actual_result.relationships_deleted, 25 + 45)
+
+        actual_result = redis_graph.query("MATCH (a)-[e]->(b) RETURN count(e)")
+        self.env.assertEquals(actual_result.result_set, [[0]])
+        actual_result = redis_graph.query("MATCH (a)<--(b) RETURN count(a)")
+        self.env.assertEquals(actual_result.result_set, [[0]])
+
+    def test16_delete_high_degree_node(self):
+        self.env.flush()
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+        # A hub connected in both directions to many nodes, by multiple edges and a self loop.
+        redis_graph.query("""CREATE (h:Hub)-[:R]->(h) WITH h UNWIND range(1, 500) AS i
+                             CREATE (h)-[:R]->(n:N {v: i}), (h)-[:R]->(n), (n)-[:S]->(h)""")
+        redis_graph.query("MATCH (a:N {v: 1}), (b:N {v: 2}) CREATE (a)-[:S]->(b)")
+
+        actual_result = redis_graph.query("MATCH (h:Hub) DELETE h")
+        self.env.assertEquals(actual_result.nodes_deleted, 1)
+        self.env.assertEquals(actual_result.relationships_deleted, 1 + 500 * 3)
+
+        # Only the edge connecting the remaining nodes is left, in either direction.
+        actual_result = redis_graph.query("MATCH (a)-[e]->(b) RETURN a.v, type(e), b.v")
+        self.env.assertEquals(actual_result.result_set, [[1, 'S', 2]])
+        actual_result = redis_graph.query("MATCH (b)<-[e]-(a) RETURN a.v, type(e), b.v")
+        self.env.assertEquals(actual_result.result_set, [[1, 'S', 2]])
+        actual_result = redis_graph.query("MATCH (n) RETURN count(n)")
+        self.env.assertEquals(actual_result.result_set, [[500]])
+        actual_result = redis_graph.query("MATCH (h:Hub) RETURN count(h)")
+        self.env.assertEquals(actual_result.result_set, [[0]])
+
+        # Delete two connected nodes at once.
+        actual_result = redis_graph.query("MATCH (n:N) WHERE n.v <= 2 DELETE n")
+        self.env.assertEquals(actual_result.nodes_deleted, 2)
+        self.env.assertEquals(actual_result.relationships_deleted, 1)
+        actual_result = redis_graph.query("MATCH (n:N) RETURN count(n)")
+        self.env.assertEquals(actual_result.result_set, [[498]])
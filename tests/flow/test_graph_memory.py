@@ -0,0 +1,81 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "graph_memory"
+redis_con = None
+redis_graph = None
+
+class testGraphMemory(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 999) AS x CREATE (:A {v: x, name: 'name of node ' + toString(x)})")
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:B {v: x})")
+        redis_graph.query("MATCH (a:A), (b:B {v: a.v % 100}) CREATE (a)-[:R {w: a.v}]->(b)")
+        redis_graph.query("CREATE INDEX ON :A(v)")
+
+    def _memory(self, *args):
+        reply = redis_con.execute_command("GRAPH.MEMORY", GRAPH_ID, *args)
+        mem = dict(zip([k.decode() for k in reply[0::2]], reply[1::2]))
+        for key in ["labels", "relations"]:
+            pairs = mem[key]
+            mem[key] = dict(zip([k.decode() for k in pairs[0::2]], pairs[1::2]))
+        return mem
+
+    def test01_missing_graph(self):
+        try:
+            redis_con.execute_command("GRAPH.MEMORY", "missing_graph")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("missing", str(e))
+        self.env.assertEquals(redis_con.exists("missing_graph"), 0)
+
+    def test02_breakdown(self):
+        mem = self._memory()
+        self.env.assertEquals(set(mem["labels"].keys()), {"A", "B"})
+        self.env.assertEquals(set(mem["relations"].keys()), {"R"})
+        for key in ["nodes", "node_properties", "edges", "edge_properties", "adjacency", "indices"]:
+            self.env.assertGreater(mem[key], 0)
+        # A holds 10 times as many nodes as B.
+        self.env.assertGreater(mem["labels"]["A"], mem["labels"]["B"])
+        # Node properties include strings.
+        self.env.assertGreater(mem["node_properties"], mem["edge_properties"])
+
+        parts = [mem[k] for k in ["nodes", "node_properties", "edges", "edge_properties", "adjacency", "indices"]]
+        parts += list(mem["labels"].values()) + list(mem["relations"].values())
+        self.env.assertEquals(mem["total"], sum(parts))
+
+    def test03_growth(self):
+        before = self._memory()
+        redis_graph.query("UNWIND range(0, 999) AS x CREATE (:A {v: x, name: 'another node ' + toString(x)})")
+        after = self._memory()
+        self.env.assertGreater(after["node_properties"], before["node_properties"])
+        self.env.assertGreater(after["indices"], before["indices"])
+        self.env.assertGreater(after["total"], before["total"])
+
+    def test04_samples(self):
+        exact = self._memory()
+        sampled = self._memory("SAMPLES", 10)
+        # Entities are uniform, an estimate is within a fraction of the exact measure.
+        self.env.assertLess(abs(sampled["node_properties"] - exact["node_properties"]), exact["node_properties"] / 4)
+        self.env.assertEquals(sampled["nodes"], exact["nodes"])
+        self.env.assertEquals(self._memory("SAMPLES", 0)["total"], exact["total"])
+
+        try:
+            redis_con.execute_command("GRAPH.MEMORY", GRAPH_ID, "SAMPLES", -1)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("SAMPLES", str(e))
+
+    def test05_memory_usage(self):
+        # MEMORY USAGE reports the graph's sampled total.
+        usage = redis_con.execute_command("MEMORY", "USAGE", GRAPH_ID)
+        total = self._memory()["total"]
+        self.env.assertGreater(usage, total / 2)
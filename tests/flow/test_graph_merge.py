@@ -504,3 +504,33 @@ class testGraphMergeFlow(FlowTestsBase):
         self.env.assertEquals(result.nodes_created, 0)
         self.env.assertEquals(result.properties_set, 0)
         self.env.assertEquals(result.relationships_created, 0)
+
+    def test25_merge_preserves_read_values(self):
+        redis_con = self.env.getConnection()
+        graph = Graph("borrowed", redis_con)
+        graph.query("CREATE (:U {name: 'before'})")
+
+        # Values read prior to an update are unaffected by it.
+        result = graph.query("MATCH (u:U) WITH u, u.name AS old SET u.name = 'after' RETURN old, u.name")
+        self.env.assertEquals(result.result_set, [['before', 'after']])
+
+        result = graph.query("MATCH (u:U) WITH u.name AS old MERGE (v:U {name: 'after'}) ON MATCH SET v.name = 'merged' RETURN old, v.name")
+        self.env.assertEquals(result.result_set, [['after', 'merged']])
+
+    def test26_merge_unwind_rows(self):
+        redis_con = self.env.getConnection()
+        graph = Graph("upsert", redis_con)
+        graph.query("CREATE (:User {id: 1, name: 'a'}), (:User {id: 2, name: 'b'}), (:User {name: 'c'})")
+
+        # Existing nodes are matched, duplicate rows create a single node.
+        query = """UNWIND $rows AS r MERGE (u:User {id: r[0]}) RETURN u.id, u.name"""
+        result = graph.query(query, {'rows': [[2], [3], [1], [3], [4.0], [1.0], ['1']]})
+        self.env.assertEquals(result.nodes_created, 3)
+        self.env.assertEquals(result.result_set[:3], [[2, 'b'], [3, None], [1, 'a']])
+        self.env.assertEquals(result.result_set[5], [1, 'a'])
+
+        # Repeating the query modifies nothing.
+        result = graph.query(query, {'rows': [[2], [3], [1], [3], [4], ['1']]})
+        self.env.assertEquals(result.nodes_created, 0)
+        result = graph.query("MATCH (u:User) RETURN u.id ORDER BY u.name, u.id")
+        self.env.assertEquals(len(result.result_set), 6)
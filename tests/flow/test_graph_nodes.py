@@ -0,0 +1,63 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+redis_con = None
+crm = None
+billing = None
+
+
+class testGraphNodes(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global crm
+        global billing
+        redis_con = self.env.getConnection()
+        crm = Graph("crm", redis_con)
+        billing = Graph("billing", redis_con)
+        crm.query("""CREATE (:Customer {name: 'Ann', email: 'ann@x'}),
+                            (:Customer {name: 'Bob', email: 'bob@x'}),
+                            (:Customer {name: 'Cid', email: 'cid@x'})""")
+        billing.query("""CREATE (:Account {email: 'ann@x', balance: 10}),
+                                (:Account {email: 'cid@x', balance: 30}),
+                                (:Account {email: 'dan@x', balance: 40})""")
+
+    def test01_scan(self):
+        query = """CALL db.graph.nodes('billing', 'Account', ['email', 'missing']) YIELD values
+                   RETURN values ORDER BY values[0]"""
+        result = crm.query(query)
+        expected = [[['ann@x', None]], [['cid@x', None]], [['dan@x', None]]]
+        self.env.assertEquals(result.result_set, expected)
+
+        # Unknown labels have no nodes.
+        query = "CALL db.graph.nodes('billing', 'Customer', []) YIELD id RETURN count(id)"
+        self.env.assertEquals(crm.query(query).result_set, [[0]])
+
+    def test02_join(self):
+        query = """CALL db.graph.nodes('billing', 'Account', ['email', 'balance']) YIELD values
+                   MATCH (c:Customer) WHERE c.email = values[0]
+                   RETURN c.name, values[1] ORDER BY c.name"""
+        plan = crm.execution_plan(query)
+        self.env.assertIn("Value Hash Join", plan)
+        self.env.assertNotIn("Cartesian Product", plan)
+        result = crm.query(query)
+        self.env.assertEquals(result.result_set, [['Ann', 10], ['Cid', 30]])
+
+        # The scan is read-only.
+        result = redis_con.execute_command("GRAPH.RO_QUERY", "crm", query)
+        self.env.assertEquals(len(result[1]), 2)
+
+    def test03_own_graph(self):
+        query = """CALL db.graph.nodes('crm', 'Customer', ['name']) YIELD id, values
+                   MATCH (c:Customer) WHERE ID(c) = id
+                   RETURN c.name = values[0]"""
+        result = crm.query(query)
+        self.env.assertEquals(result.result_set, [[True], [True], [True]])
+
+    def test04_unknown_graph(self):
+        try:
+            crm.query("CALL db.graph.nodes('nosuchgraph', 'Account', []) YIELD id RETURN id")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Graph nosuchgraph does not exist", str(e))
@@ -0,0 +1,39 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+redis_con = None
+
+
+class testGraphReclaim(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        redis_con = self.env.getConnection()
+
+    def test01_recreate_deleted(self):
+        # Deleting a graph larger than a single reclaim step returns immediately,
+        # its name can be reused while its memory is released.
+        g = Graph("reclaimed", redis_con)
+        g.query("UNWIND range(1, 200000) AS x CREATE (:N {x: x})-[:R {x: x}]->(:M)")
+        g.delete()
+
+        g = Graph("reclaimed", redis_con)
+        result = g.query("MATCH (n) RETURN count(n)")
+        self.env.assertEqual(result.result_set[0][0], 0)
+        g.query("CREATE (:N {x: 1})")
+        result = g.query("MATCH (n:N) RETURN n.x")
+        self.env.assertEqual(result.result_set, [[1]])
+
+    def test02_interleaved_deletes(self):
+        # Graphs deleted together are freed side by side, unrelated graphs remain queryable.
+        kept = Graph("kept", redis_con)
+        kept.query("CREATE (:K {v: 1})")
+        for i in range(4):
+            g = Graph("deleted_%d" % i, redis_con)
+            g.query("UNWIND range(1, 100000) AS x CREATE (:N {x: x})")
+            g.delete()
+        result = kept.query("MATCH (k:K) RETURN k.v")
+        self.env.assertEqual(result.result_set, [[1]])
+        for i in range(4):
+            self.env.assertEqual(redis_con.exists("deleted_%d" % i), 0)
@@ -0,0 +1,54 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "graph_stats"
+redis_con = None
+redis_graph = None
+
+class testGraphStats(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def _stats(self):
+        def decode(v):
+            return v.decode() if isinstance(v, bytes) else v
+        reply = redis_con.execute_command("GRAPH.STATS", GRAPH_ID)
+        stats = {}
+        for name, summary in zip(reply[0::2], reply[1::2]):
+            summary = [decode(v) for v in summary]
+            stats[decode(name)] = dict(zip(summary[0::2], summary[1::2]))
+        return stats
+
+    def test01_missing_graph(self):
+        try:
+            redis_con.execute_command("GRAPH.STATS", "missing_graph")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("missing", str(e))
+        self.env.assertEquals(redis_con.exists("missing_graph"), 0)
+
+    def test02_latencies(self):
+        redis_graph.query("UNWIND range(1, 100) AS x CREATE (:N {v: x})")
+        for i in range(10):
+            redis_graph.query("MATCH (n:N) WHERE n.v > %d RETURN count(n)" % i)
+
+        stats = self._stats()
+        self.env.assertEquals(set(stats.keys()), set(["read_query", "write_query", "queue_wait",
+                                                      "read_lock_wait", "writer_wait",
+                                                      "write_lock_wait", "matrix_sync"]))
+        self.env.assertEquals(stats["read_query"]["count"], 10)
+        self.env.assertEquals(stats["write_query"]["count"], 1)
+        self.env.assertGreaterEqual(stats["writer_wait"]["count"], 1)
+        self.env.assertGreaterEqual(stats["queue_wait"]["count"], 11)
+        self.env.assertGreaterEqual(stats["read_lock_wait"]["count"], 10)
+
+        for name, summary in stats.items():
+            p50 = float(summary["p50_ms"])
+            p99 = float(summary["p99_ms"])
+            self.env.assertLessEqual(p50, p99)
+            self.env.assertLessEqual(p99, float(summary["max_ms"]))
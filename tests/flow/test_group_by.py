@@ -0,0 +1,83 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "group_by"
+redis_graph = None
+
+class testGroupBy(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 4999) AS x CREATE (:P {id: x, a: x % 1000, b: x % 7})")
+        # Nodes missing attributes.
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:P {b: x % 2})")
+
+    def test01_many_groups(self):
+        # Groups outnumber the cache's initial capacity.
+        query = "MATCH (p:P) WHERE exists(p.a) RETURN p.a, count(p), sum(p.id) ORDER BY p.a"
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals(len(result), 1000)
+        for a, count, total in result:
+            self.env.assertEquals(count, 5)
+            self.env.assertEquals(total, float(sum(a + 1000 * i for i in range(5))))
+
+    def test02_multiple_keys(self):
+        query = "MATCH (p:P) WHERE exists(p.a) WITH p.a % 2 AS x, p.b AS y, count(p) AS c RETURN count(x), sum(c)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[14, 5000]])
+
+        query = "MATCH (p:P) WHERE p.id < 14 RETURN p.id % 2, p.id % 7, count(p) ORDER BY p.id % 2, p.id % 7"
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals(result, [[i % 2, i % 7, 1] for i in sorted(range(14), key=lambda i: (i % 2, i % 7))])
+
+    def test03_null_keys(self):
+        # Missing values form a single group.
+        query = "MATCH (p:P) RETURN p.a % 2, count(p)"
+        result = sorted(redis_graph.query(query).result_set, key=lambda row: row[1])
+        self.env.assertEquals(result, [[None, 10], [0, 2500], [1, 2500]])
+
+        query = "UNWIND [[1, null], [1, null], [null, 2], [1, 2]] AS x RETURN x, count(x) ORDER BY count(x) DESC, x"
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals(result[0], [[1, None], 2])
+        self.env.assertEquals(len(result), 3)
+
+    def test04_key_types(self):
+        # Values of different types are grouped apart.
+        query = "UNWIND ['1', 1, true, '1', [1], [1], 'true'] AS x RETURN x, count(x) ORDER BY count(x) DESC"
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals(len(result), 5)
+        self.env.assertEquals(sorted(row[1] for row in result), [1, 1, 1, 2, 2])
+
+        # Grouping by entities.
+        query = "MATCH (p:P) WHERE p.id < 3 WITH p UNWIND range(1, 3) AS x RETURN p.id, count(x) ORDER BY p.id"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[0, 3], [1, 3], [2, 3]])
+
+    def test05_computed_keys(self):
+        # Keys computed per record are compared by value.
+        query = "UNWIND range(0, 999) AS x RETURN toString(x % 3) + 'k', count(x) ORDER BY toString(x % 3) + 'k'"
+        self.env.assertEquals(redis_graph.query(query).result_set, [['0k', 334], ['1k', 333], ['2k', 333]])
+
+    def test06_approximate_aggregations(self):
+        query = "MATCH (p:P) WHERE exists(p.a) RETURN p.b, approxCountDistinct(p.a), count(DISTINCT p.a) ORDER BY p.b"
+        for row in redis_graph.query(query).result_set:
+            self.env.assertLessEqual(abs(row[1] - row[2]), row[2] * 0.05)
+
+        # Small groups are exact.
+        query = "UNWIND [2, 4, 6, 8, 10, null, 4] AS x RETURN approxCountDistinct(x), approxPercentile(x, 0.5), percentileCont(x, 0.5)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[5, 6.0, 6.0]])
+
+        query = "UNWIND range(1, 100000) AS x RETURN approxPercentile(x, 0.9), approxPercentile(x, 0), approxPercentile(x, 1)"
+        result = redis_graph.query(query).result_set[0]
+        self.env.assertLessEqual(abs(result[0] - 90000), 500)
+        self.env.assertEquals(result[1:], [1.0, 100000.0])
+
+        try:
+            redis_graph.query("UNWIND range(1, 10) AS x RETURN approxPercentile(x, 2)")
+            self.env.assertTrue(False)
+        except Exception:
+            pass
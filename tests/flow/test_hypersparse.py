@@ -0,0 +1,46 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "hypersparse"
+redis_graph = None
+
+class testHypersparse(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        # Many nodes, a dense relationship type and a rare one.
+        redis_graph.query("UNWIND range(0, 9999) AS x CREATE (:N {v:x})")
+        redis_graph.query("MATCH (a:N) WHERE a.v < 9999 MATCH (b:N {v: a.v + 1}) CREATE (a)-[:NEXT]->(b)")
+        redis_graph.query("MATCH (a:N {v:10}), (b:N {v:9000}) CREATE (a)-[:RARE]->(b)")
+        redis_graph.query("CREATE (:Rare {v:-1}), (:Rare {v:5000})")
+
+    def _matrix_stats(self):
+        res = redis_graph.query("CALL db.matrixStats()")
+        header = [h[1] for h in res.header]
+        return {row[0]: dict(zip(header, row)) for row in res.result_set}
+
+    def test01_sparse_matrices_are_hypersparse(self):
+        stats = self._matrix_stats()
+        self.env.assertEquals(stats["RARE"]["type"], "relationship")
+        self.env.assertEquals(stats["RARE"]["entries"], 1)
+        self.env.assertTrue(stats["RARE"]["hypersparse"])
+        self.env.assertGreater(stats["RARE"]["saved_bytes"], 0)
+        # Almost every node has an outgoing NEXT edge.
+        self.env.assertFalse(stats["NEXT"]["hypersparse"])
+        self.env.assertEquals(stats["NEXT"]["saved_bytes"], 0)
+        self.env.assertTrue(stats["Rare"]["hypersparse"])
+
+    def test02_traverse_hypersparse_matrices(self):
+        res = redis_graph.query("MATCH (a)-[:RARE]->(b) RETURN a.v, b.v")
+        self.env.assertEquals(res.result_set, [[10, 9000]])
+        res = redis_graph.query("MATCH (a)<-[:RARE]-(b) RETURN a.v, b.v")
+        self.env.assertEquals(res.result_set, [[9000, 10]])
+        res = redis_graph.query("MATCH (a:N {v:10})-[e]->(b) RETURN type(e), b.v ORDER BY b.v")
+        self.env.assertEquals(res.result_set, [["NEXT", 11], ["RARE", 9000]])
+        res = redis_graph.query("MATCH (r:Rare) RETURN r.v ORDER BY r.v")
+        self.env.assertEquals(res.result_set, [[-1], [5000]])
+        res = redis_graph.query("MATCH (r:Rare) WHERE id(r) > 10000 RETURN count(r)")
+        self.env.assertEquals(res.result_set[0][0], 1)
@@ -0,0 +1,89 @@
+import time
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "index_construction"
+# Labels of more than 100 nodes are indexed in the background, 100 nodes at a time.
+MODULE_ARGS = "INDEX_CHUNK_SIZE 100"
+NODE_COUNT = 20000
+redis_con = None
+redis_graph = None
+
+class testIndexConstruction(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(moduleArgs=MODULE_ARGS)
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, %d) AS x CREATE (:N {v: x})" % (NODE_COUNT - 1))
+        redis_graph.query("CREATE (:Small {v: 1})")
+
+    def wait_for_index(self, query):
+        for _ in range(500):
+            if "Index Scan" in redis_graph.execution_plan(query):
+                return
+            time.sleep(0.01)
+        self.env.assertTrue(False)
+
+    def test01_small_label_indexed_in_place(self):
+        redis_graph.query("CREATE INDEX ON :Small(v)")
+        plan = redis_graph.execution_plan("MATCH (s:Small) WHERE s.v = 1 RETURN s")
+        self.env.assertIn("Index Scan", plan)
+
+    def test02_background_construction(self):
+        res = redis_graph.query("CREATE INDEX ON :N(v)")
+        self.env.assertEquals(res.indices_created, 1)
+
+        # Writes issued while the index is under construction.
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:N {v: x})")
+        redis_graph.query("MATCH (n:N) WHERE n.v >= 19000 AND n.v < 19100 DELETE n")
+        redis_graph.query("MATCH (n:N) WHERE n.v >= 15000 AND n.v < 15100 SET n.v = -n.v")
+        res = redis_graph.query("MATCH (n:N) WHERE n.v = 5 RETURN count(n)")
+        self.env.assertEquals(res.result_set, [[2]])
+
+        self.wait_for_index("MATCH (n:N) WHERE n.v = 5 RETURN n")
+
+        # Index scans agree with label scans.
+        res = redis_graph.query("MATCH (n:N) WHERE n.v = 5 RETURN count(n)")
+        self.env.assertEquals(res.result_set, [[2]])
+        res = redis_graph.query("MATCH (n:N) WHERE n.v >= 19000 AND n.v < 19100 RETURN count(n)")
+        self.env.assertEquals(res.result_set, [[0]])
+        res = redis_graph.query("MATCH (n:N) WHERE n.v > -15100 AND n.v <= -15000 RETURN count(n)")
+        self.env.assertEquals(res.result_set, [[100]])
+        res = redis_graph.query("MATCH (n:N) WHERE n.v >= 0 RETURN count(n)")
+        expected = redis_graph.query("MATCH (n:N) WHERE n.v + 0 >= 0 RETURN count(n)")
+        self.env.assertEquals(res.result_set, expected.result_set)
+        self.env.assertEquals(res.result_set, [[NODE_COUNT - 100]])
+
+    def test03_drop_during_construction(self):
+        redis_graph.query("CREATE INDEX ON :N(w)")
+        redis_graph.query("DROP INDEX ON :N(w)")
+        redis_graph.query("DROP INDEX ON :N(v)")
+        plan = redis_graph.execution_plan("MATCH (n:N) WHERE n.v = 5 RETURN n")
+        self.env.assertNotIn("Index Scan", plan)
+        res = redis_graph.query("MATCH (n:N) WHERE n.v = 5 RETURN count(n)")
+        self.env.assertEquals(res.result_set, [[2]])
+
+    def test04_persisted_under_construction(self):
+        redis_graph.query("CREATE INDEX ON :N(v)")
+        # Indices are reconstructed in the background once loaded, queries scan the label meanwhile.
+        redis_con.execute_command("DEBUG", "RELOAD")
+        res = redis_graph.query("MATCH (n:N) WHERE n.v = 5 RETURN count(n)")
+        self.env.assertEquals(res.result_set, [[2]])
+        self.wait_for_index("MATCH (n:N) WHERE n.v = 5 RETURN n")
+        res = redis_graph.query("MATCH (n:N) WHERE n.v = 5 RETURN count(n)")
+        self.env.assertEquals(res.result_set, [[2]])
+
+    def test05_delete_graph_during_construction(self):
+        redis_graph.query("DROP INDEX ON :N(v)")
+        redis_graph.query("CREATE INDEX ON :N(v)")
+        redis_graph.delete()
+        self.env.assertEquals(redis_con.exists(GRAPH_ID), 0)
+        redis_graph.query("CREATE (:N {v: 1})")
+        res = redis_graph.query("MATCH (n:N) RETURN count(n)")
+        self.env.assertEquals(res.result_set, [[1]])
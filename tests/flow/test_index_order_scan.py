@@ -0,0 +1,73 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "index_order_scan"
+redis_con = None
+redis_graph = None
+
+class testIndexOrderScan(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # Unique prices, such that every ordering is deterministic.
+        redis_graph.query("UNWIND range(0, 999) AS x CREATE (:Product {id: x, price: (x * 37) % 1000 + 0.5})")
+        redis_graph.query("UNWIND range(0, 999) AS x CREATE (:Unindexed {id: x, price: (x * 37) % 1000 + 0.5})")
+        redis_graph.query("CREATE INDEX ON :Product(price)")
+
+    def _records_produced(self, query, op):
+        profile = redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, query)
+        for line in profile:
+            if line.startswith(op):
+                return int(line.split("Records produced: ")[1].split(",")[0])
+        self.env.assertTrue(False)
+
+    def _assert_matches_unindexed(self, query):
+        expected = redis_graph.query(query.replace(":Product", ":Unindexed")).result_set
+        actual = redis_graph.query(query).result_set
+        self.env.assertEquals(actual, expected)
+
+    def test01_plan(self):
+        plan = redis_graph.execution_plan("MATCH (p:Product) RETURN p ORDER BY p.price DESC LIMIT 20")
+        self.env.assertIn("Index Order Scan", plan)
+        self.env.assertNotIn("Node By Label Scan", plan)
+
+        # Without a limit every record is sorted.
+        plan = redis_graph.execution_plan("MATCH (p:Product) RETURN p ORDER BY p.price")
+        self.env.assertNotIn("Index Order Scan", plan)
+        # Unindexed attributes are sorted as usual.
+        plan = redis_graph.execution_plan("MATCH (p:Product) RETURN p ORDER BY p.id LIMIT 5")
+        self.env.assertNotIn("Index Order Scan", plan)
+
+    def test02_top_k(self):
+        for direction in ["ASC", "DESC"]:
+            q = "MATCH (p:Product) RETURN p.id, p.price ORDER BY p.price %s LIMIT 20" % direction
+            self._assert_matches_unindexed(q)
+            # The scan stops once the top records are produced.
+            self.env.assertEquals(self._records_produced(q, "Index Order Scan"), 20)
+
+        self._assert_matches_unindexed("MATCH (p:Product) RETURN p.price AS price ORDER BY price DESC SKIP 5 LIMIT 10")
+        self._assert_matches_unindexed("MATCH (p:Product) WHERE p.id % 3 = 0 RETURN p.id ORDER BY p.price LIMIT 10")
+        self._assert_matches_unindexed("MATCH (p:Product) WITH p ORDER BY p.price DESC LIMIT 3 RETURN p.id")
+
+    def test03_fallback(self):
+        # Nodes missing the attribute are sorted as usual.
+        redis_graph.query("CREATE (:Product {id: 1000}), (:Unindexed {id: 1000})")
+        q = "MATCH (p:Product) RETURN p.id, p.price ORDER BY p.price DESC LIMIT 5"
+        self._assert_matches_unindexed(q)
+        self.env.assertEquals(self._records_produced(q, "Index Order Scan"), 1001)
+        redis_graph.query("MATCH (p) WHERE p.id = 1000 DELETE p")
+
+        # Strings sort before numerics, booleans are sorted as usual.
+        redis_graph.query("CREATE (:Product {id: 1001, price: 'free'}), (:Unindexed {id: 1001, price: 'free'})")
+        for direction in ["ASC", "DESC"]:
+            self._assert_matches_unindexed("MATCH (p:Product) RETURN p.id ORDER BY p.price %s LIMIT 3" % direction)
+        redis_graph.query("CREATE (:Product {id: 1002, price: true}), (:Unindexed {id: 1002, price: true})")
+        for direction in ["ASC", "DESC"]:
+            self._assert_matches_unindexed("MATCH (p:Product) RETURN p.id ORDER BY p.price %s LIMIT 3" % direction)
@@ -234,3 +234,143 @@ class testIndexScanFlow(FlowTestsBase):
         self.env.assertEqual(2, len(query_result.result_set))
         expected_result = [[nodes[7]], [nodes[8]]]
         self.env.assertEquals(expected_result, query_result.result_set)
+
+    # Validate point and range lookups resolved by the ordered index
+    def test08_ordered_index_ranges(self):
+        redis_con = self.env.getConnection()
+        redis_graph = Graph("G", redis_con)
+        redis_graph.query("UNWIND range(-10, 10) AS x CREATE (:N {v: x, s: 'n' + toString(x)})")
+        redis_graph.query("CREATE (:N {v: 2.5, s: 'N'})")
+        redis_graph.query("CREATE INDEX ON :N(v)")
+        redis_graph.query("CREATE INDEX ON :N(s)")
+
+        queries = ["MATCH (n:N) WHERE n.v = 2 RETURN n.v",
+                   "MATCH (n:N) WHERE n.v = -1 RETURN n.s",
+                   "MATCH (n:N) WHERE n.v > 2 AND n.v <= 4 RETURN n.v ORDER BY n.v",
+                   "MATCH (n:N) WHERE n.v < -8 RETURN n.v ORDER BY n.v",
+                   "MATCH (n:N) WHERE n.s = 'N' RETURN n.v",
+                   "MATCH (n:N) WHERE n.s >= 'n8' RETURN n.s ORDER BY n.s",
+                   "MATCH (n:N) WHERE n.v = 100 RETURN n.v"]
+        expected = [[[2]],
+                    [["n-1"]],
+                    [[2.5], [3], [4]],
+                    [[-10], [-9]],
+                    [[2.5]],
+                    [["n8"], ["n9"]],
+                    []]
+        for query, result in zip(queries, expected):
+            plan = redis_graph.execution_plan(query)
+            self.env.assertIn('Index Scan', plan)
+            self.env.assertEquals(redis_graph.query(query).result_set, result)
+
+        # Update indexed values while scanning the index.
+        redis_graph.query("MATCH (n:N) WHERE n.v >= 0 AND n.v < 5 SET n.v = n.v + 100")
+        res = redis_graph.query("MATCH (n:N) WHERE n.v >= 100 RETURN count(n)")
+        self.env.assertEquals(res.result_set, [[6]])
+        res = redis_graph.query("MATCH (n:N) WHERE n.v >= 0 AND n.v < 100 RETURN n.v ORDER BY n.v")
+        self.env.assertEquals(res.result_set, [[5], [6], [7], [8], [9], [10]])
+
+    # Validate lookups resolved by a composite index
+    def test09_composite_index(self):
+        redis_con = self.env.getConnection()
+        redis_graph = Graph("composite", redis_con)
+        redis_graph.query("UNWIND range(0, 19) AS x CREATE (:U {tenant: x % 4, email: 'u' + toString(x), v: x})")
+        # Node missing the trailing property.
+        redis_graph.query("CREATE (:U {tenant: 1, v: 100})")
+        redis_graph.query("CREATE INDEX ON :U(tenant, email)")
+
+        queries = ["MATCH (u:U {tenant: 1, email: 'u5'}) RETURN u.v",
+                   "MATCH (u:U) WHERE u.tenant = 1 AND u.email = 'u6' RETURN u.v",
+                   "MATCH (u:U) WHERE u.tenant = 1 RETURN u.v ORDER BY u.v"]
+        expected = [[[5]],
+                    [],
+                    [[1], [5], [9], [13], [17], [100]]]
+        for query, result in zip(queries, expected):
+            plan = redis_graph.execution_plan(query)
+            self.env.assertIn('Index Scan', plan)
+            self.env.assertEquals(redis_graph.query(query).result_set, result)
+
+        # A trailing property alone does not utilize the index.
+        plan = redis_graph.execution_plan("MATCH (u:U {email: 'u5'}) RETURN u.v")
+        self.env.assertNotIn('Index Scan', plan)
+
+        # Updates are reflected.
+        redis_graph.query("MATCH (u:U {v: 100}) SET u.email = 'late'")
+        res = redis_graph.query("MATCH (u:U {tenant: 1, email: 'late'}) RETURN u.v")
+        self.env.assertEquals(res.result_set, [[100]])
+
+        # Index survives a reload.
+        redis_con.execute_command("DEBUG", "RELOAD")
+        plan = redis_graph.execution_plan(queries[0])
+        self.env.assertIn('Index Scan', plan)
+        self.env.assertEquals(redis_graph.query(queries[0]).result_set, [[5]])
+
+        redis_graph.query("DROP INDEX ON :U(tenant, email)")
+        plan = redis_graph.execution_plan(queries[0])
+        self.env.assertNotIn('Index Scan', plan)
+        self.env.assertEquals(redis_graph.query(queries[0]).result_set, [[5]])
+
+    # Validate projections read from the index entries
+    def test10_covering_index_scan(self):
+        redis_con = self.env.getConnection()
+        redis_graph = Graph("covering", redis_con)
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:P {v: x, d: x + 0.5, email: 'p' + toString(x), flag: x % 2 = 0})")
+        # Integers beyond 2^53 are read from the node.
+        redis_graph.query("CREATE (:P {v: 9007199254740993, email: 'zz'})")
+        for attr in ["v", "d", "email", "flag"]:
+            redis_graph.query("CREATE INDEX ON :P(%s)" % attr)
+
+        queries = ["MATCH (p:P) WHERE p.v >= 8 RETURN p.v ORDER BY p.v",
+                   "MATCH (p:P) WHERE p.d < 2 RETURN p.d * 2 ORDER BY p.d",
+                   "MATCH (p:P) WHERE p.email > 'p7' RETURN toUpper(p.email) AS e ORDER BY e",
+                   "MATCH (p:P) WHERE p.flag = true RETURN p.flag, count(p)",
+                   "MATCH (p:P) WHERE p.v > 3 RETURN count(p)",
+                   "MATCH (p:P) WHERE p.d > 7 RETURN sum(p.d)"]
+        expected = [[[8], [9], [9007199254740993]],
+                    [[1.0], [3.0]],
+                    [["P8"], ["P9"], ["ZZ"]],
+                    [[True, 5]],
+                    [[7]],
+                    [[25.5]]]
+        for query, result in zip(queries, expected):
+            plan = redis_graph.execution_plan(query)
+            self.env.assertIn('Covering Index Scan', plan)
+            self.env.assertEquals(redis_graph.query(query).result_set, result)
+
+        # Nodes are fetched when other properties or the node itself are required.
+        for query in ["MATCH (p:P) WHERE p.v = 1 RETURN p.v, p.email",
+                      "MATCH (p:P) WHERE p.v = 1 RETURN p",
+                      "MATCH (p:P) WHERE p.v > 1 RETURN count(DISTINCT p)",
+                      "MATCH (p:P) WHERE p.email > 'p' RETURN min(p.email)"]:
+            plan = redis_graph.execution_plan(query)
+            self.env.assertIn('Index Scan', plan)
+            self.env.assertNotIn('Covering Index Scan', plan)
+        res = redis_graph.query("MATCH (p:P) WHERE p.email > 'p' RETURN min(p.email)")
+        self.env.assertEquals(res.result_set, [["p0"]])
+
+    # Validate conjunctions and disjunctions over multiple indexed attributes
+    def test11_multiple_indexed_attributes(self):
+        redis_con = self.env.getConnection()
+        redis_graph = Graph("multi_index", redis_con)
+        redis_graph.query("UNWIND range(0, 299) AS x CREATE (:P {id: x, country: ['DE', 'FR', 'US'][x % 3], tier: ['gold', 'silver'][x % 2], score: x % 10})")
+        redis_graph.query("UNWIND range(0, 299) AS x CREATE (:Q {id: x, country: ['DE', 'FR', 'US'][x % 3], tier: ['gold', 'silver'][x % 2], score: x % 10})")
+        for attr in ["country", "tier", "score"]:
+            redis_graph.query("CREATE INDEX ON :P(%s)" % attr)
+
+        queries = ["MATCH (p:P) WHERE p.country = 'DE' AND p.tier = 'gold' RETURN p.id ORDER BY p.id",
+                   "MATCH (p:P) WHERE p.country = 'FR' OR p.tier = 'gold' RETURN count(p)",
+                   "MATCH (p:P) WHERE p.country = 'US' AND p.score > 7 RETURN p.id ORDER BY p.id",
+                   "MATCH (p:P) WHERE p.country IN ['DE', 'US'] AND (p.score = 1 OR p.tier = 'gold') RETURN p.id ORDER BY p.id",
+                   "MATCH (p:P) WHERE p.country = 'DE' AND p.country = 'FR' RETURN p.id",
+                   "MATCH (p:P) WHERE p.score = 3 AND p.tier = 'gold' RETURN p.id"]
+        for query in queries:
+            plan = redis_graph.execution_plan(query)
+            self.env.assertIn('Index Scan', plan)
+            self.env.assertNotIn('Filter', plan)
+            expected = redis_graph.query(query.replace(":P", ":Q")).result_set
+            self.env.assertEquals(redis_graph.query(query).result_set, expected)
+
+        # Modifications are reflected.
+        redis_graph.query("MATCH (p:P {id: 0}) SET p.tier = 'silver'")
+        res = redis_graph.query("MATCH (p:P) WHERE p.country = 'DE' AND p.tier = 'gold' RETURN count(p)")
+        self.env.assertEquals(res.result_set, [[49]])
@@ -139,3 +139,19 @@ class testIndexUpdatesFlow(FlowTestsBase):
         result = redis_graph.query("MATCH (a:label_a) WHERE a.group = 'Group A' DELETE a")
         self.env.assertGreater(result.nodes_deleted, 0)
         self.validate_state()
+
+    # Update multiple properties of each node, some to their current values
+    def test05_multiple_property_update(self):
+        count = redis_graph.query("MATCH (a) RETURN count(a)").result_set[0][0]
+        result = redis_graph.query("MATCH (a) SET a.intval = a.intval + 1, a.group = a.group, a.doubleval = a.doubleval, a.intval = a.intval + 2")
+        self.env.assertEquals(result.properties_set, 4 * count)
+        self.validate_state()
+
+        # Assign a value of a different type to an indexed property.
+        query = "MATCH (a:label_a) WHERE a.group = 1 RETURN a.unique"
+        self.env.assertEquals(redis_graph.query(query).result_set, [])
+        unique = redis_graph.query("MATCH (a:label_a) RETURN a.unique ORDER BY a.unique LIMIT 1").result_set[0][0]
+        redis_graph.query("MATCH (a:label_a) WHERE a.unique = %d SET a.group = 1" % (unique))
+        self.env.assertIn('Index Scan', redis_graph.execution_plan(query))
+        self.env.assertEquals(redis_graph.query(query).result_set, [[unique]])
+        self.validate_state()
@@ -0,0 +1,60 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "intern_strings"
+redis_con = None
+redis_graph = None
+
+# String values of the country and status attributes are interned.
+MODULE_ARGS = "INTERN_STRINGS country,status"
+
+class testInternStrings(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(moduleArgs=MODULE_ARGS)
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:P {v: x, country: CASE x % 3 WHEN 0 THEN 'NL' WHEN 1 THEN 'NO' ELSE 'SE' END, status: 'active', name: 'p' + toString(x)})")
+        redis_graph.query("MATCH (p:P) WHERE p.v < 10 CREATE (p)-[:R {status: 'new'}]->(:C {country: 'NL'})")
+
+    def test01_interned_values(self):
+        res = redis_graph.query("MATCH (p:P) RETURN p.country, count(p) ORDER BY p.country")
+        self.env.assertEquals(res.result_set, [["NL", 34], ["NO", 33], ["SE", 33]])
+        res = redis_graph.query("MATCH (p:P {country: 'NO', v: 1}) RETURN p.status, p.name")
+        self.env.assertEquals(res.result_set, [["active", "p1"]])
+        res = redis_graph.query("MATCH ()-[r:R]->(c:C) RETURN r.status, c.country LIMIT 1")
+        self.env.assertEquals(res.result_set, [["new", "NL"]])
+
+    def test02_compare_interned_values(self):
+        res = redis_graph.query("MATCH (p:P)-[:R]->(c:C) WHERE p.country = c.country RETURN count(p)")
+        self.env.assertEquals(res.result_set, [[4]])
+        res = redis_graph.query("MATCH (a:P {v: 0}), (b:P) WHERE a.country = b.country RETURN count(b)")
+        self.env.assertEquals(res.result_set, [[34]])
+
+    def test03_update_interned_values(self):
+        redis_graph.query("MATCH (p:P) WHERE p.v < 50 SET p.status = 'inactive'")
+        redis_graph.query("MATCH (p:P {v: 99}) SET p.status = p.status")
+        redis_graph.query("MATCH (p:P {v: 98}) SET p.status = NULL")
+        redis_graph.query("MERGE (p:P {v: 97}) ON MATCH SET p.country = 'DK'")
+        redis_graph.query("MATCH (p:P) WHERE p.v >= 90 AND p.v < 95 DELETE p")
+        res = redis_graph.query("MATCH (p:P) RETURN p.status, count(p) ORDER BY p.status")
+        self.env.assertEquals(res.result_set, [["active", 44], ["inactive", 50], [None, 1]])
+        res = redis_graph.query("MATCH (p:P {country: 'DK'}) RETURN p.v")
+        self.env.assertEquals(res.result_set, [[97]])
+
+    def test04_interned_values_persist(self):
+        redis_con.execute_command("DEBUG", "RELOAD")
+        res = redis_graph.query("MATCH (p:P) RETURN p.status, count(p) ORDER BY p.status")
+        self.env.assertEquals(res.result_set, [["active", 44], ["inactive", 50], [None, 1]])
+        redis_graph.query("MATCH (p:P {v: 99}) SET p.status = 'inactive'")
+        res = redis_graph.query("MATCH (p:P {status: 'inactive'}) RETURN count(p)")
+        self.env.assertEquals(res.result_set, [[51]])
+
+    def test05_delete_graph(self):
+        redis_graph.delete()
+        self.env.assertEquals(redis_con.exists(GRAPH_ID), 0)
@@ -0,0 +1,46 @@
+import os
+import sys
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "khop"
+redis_con = None
+redis_graph = None
+
+class testKHopFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        # a -> b -> c -> d, a -> c, diamond paths reach c twice, e -> a of another type.
+        redis_graph.query("""CREATE (a {v:'a'})-[:R]->(b {v:'b'})-[:R]->(c {v:'c'})-[:R]->(d {v:'d'}),
+                             (a)-[:R]->(c), (e {v:'e'})-[:S]->(a)""")
+
+    def khop(self, args):
+        q = "MATCH (a {v:'a'}) CALL algo.kHop(a, %s) YIELD node, distance RETURN node.v, distance" % args
+        return redis_graph.query(q).result_set
+
+    def test01_distinct_nodes_by_distance(self):
+        self.env.assertEqual(self.khop("1"), [['b', 1], ['c', 1]])
+        self.env.assertEqual(self.khop("3, 'R'"), [['b', 1], ['c', 1], ['d', 2]])
+        self.env.assertEqual(self.khop("0"), [])
+
+    def test02_direction(self):
+        self.env.assertEqual(self.khop("2, NULL, 'INCOMING'"), [['e', 1]])
+        self.env.assertEqual(self.khop("1, NULL, 'BOTH'"), [['b', 1], ['c', 1], ['e', 1]])
+        self.env.assertEqual(self.khop("1, 'S', 'BOTH'"), [['e', 1]])
+
+    def test03_limit(self):
+        self.env.assertEqual(len(self.khop("3, 'R', 'OUTGOING', 2")), 2)
+        try:
+            self.khop("1, NULL, 'SIDEWAYS'")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("direction", str(e))
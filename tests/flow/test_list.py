@@ -33,3 +33,16 @@ class testList(FlowTestsBase):
         expected_result = [[0], [1], [2], [3],
                            [4], [5], [6], [7], [8], [9], [10]]
         self.env.assertEquals(result_set, expected_result)
+
+    def test03_homogeneous_list_properties(self):
+        # Homogeneous lists are stored compactly, their values must be unaffected.
+        query = """CREATE (:L {ints: range(0, 99), floats: [x IN range(0, 9) | x / 4.0], flags: [true, false, true, true]})"""
+        redis_graph.query(query)
+        query = """MATCH (l:L) RETURN size(l.ints), l.ints[42], l.floats[2..4], l.flags, l.ints + 'x' = l.ints + ['x']"""
+        result_set = redis_graph.query(query).result_set
+        expected_result = [[100, 42, [0.5, 0.75], [True, False, True, True], True]]
+        self.env.assertEquals(result_set, expected_result)
+
+        query = """MATCH (l:L) UNWIND l.floats AS f RETURN sum(f)"""
+        result_set = redis_graph.query(query).result_set
+        self.env.assertEquals(result_set, [[11.25]])
@@ -0,0 +1,75 @@
+import redis
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "maintained_weights"
+redis_con = None
+redis_graph = None
+
+
+class testMaintainedWeights(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("CALL db.weights.maintain('ROAD', 'km', true)")
+        redis_graph.query("""CREATE (a:City {name:'a'}), (b:City {name:'b'}), (c:City {name:'c'}),
+                             (d:City {name:'d'}),
+                             (a)-[:ROAD {km:1}]->(b), (b)-[:ROAD {km:2}]->(c), (a)-[:ROAD {km:10}]->(c),
+                             (b)-[:ROAD {km:7}]->(d), (b)-[:ROAD {km:4.5}]->(d)""")
+
+    def distances(self):
+        q = """MATCH (a:City {name:'a'}) CALL algo.SSSP(a, 'ROAD', 'km') YIELD node, distance
+               RETURN node.name, distance ORDER BY node.name"""
+        return redis_graph.query(q).result_set
+
+    def test01_built(self):
+        expected = [['a', 0.0], ['b', 1.0], ['c', 3.0], ['d', 5.5]]
+        self.env.assertEqual(self.distances(), expected)
+
+    def test02_created_edges(self):
+        redis_graph.query("MATCH (a:City {name:'a'}), (d:City {name:'d'}) CREATE (a)-[:ROAD {km:2}]->(d)")
+        self.env.assertEqual(self.distances(), [['a', 0.0], ['b', 1.0], ['c', 3.0], ['d', 2.0]])
+
+    def test03_reweighted_edges(self):
+        redis_graph.query("MATCH (:City {name:'a'})-[r:ROAD]->(:City {name:'d'}) SET r.km = 20")
+        redis_graph.query("MATCH (:City {name:'b'})-[r:ROAD {km:2}]->(:City {name:'c'}) SET r.km = 'far'")
+        self.env.assertEqual(self.distances(), [['a', 0.0], ['b', 1.0], ['c', 10.0], ['d', 5.5]])
+        redis_graph.query("MERGE (:City {name:'b'})-[r:ROAD {km:'far'}]->(:City {name:'c'}) ON MATCH SET r.km = 1")
+        self.env.assertEqual(self.distances(), [['a', 0.0], ['b', 1.0], ['c', 2.0], ['d', 5.5]])
+
+    def test04_deleted_edges(self):
+        # Deleting the lighter of the parallel edges falls back to the heavier one.
+        redis_graph.query("MATCH (:City {name:'b'})-[r:ROAD {km:4.5}]->(:City {name:'d'}) DELETE r")
+        self.env.assertEqual(self.distances(), [['a', 0.0], ['b', 1.0], ['c', 2.0], ['d', 8.0]])
+
+    def test05_deleted_nodes(self):
+        redis_graph.query("MATCH (b:City {name:'b'}) DETACH DELETE b")
+        self.env.assertEqual(self.distances(), [['a', 0.0], ['c', 10.0], ['d', 20.0]])
+        # Reused node IDs don't inherit the deleted node's weights.
+        redis_graph.query("CREATE (:City {name:'e'})")
+        self.env.assertEqual(self.distances(), [['a', 0.0], ['c', 10.0], ['d', 20.0]])
+
+    def test06_negative_weights(self):
+        redis_graph.query("MATCH (a:City {name:'a'}), (e:City {name:'e'}) CREATE (a)-[:ROAD {km:-1}]->(e)")
+        try:
+            self.distances()
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("negative weights", str(e))
+        redis_graph.query("MATCH (:City {name:'a'})-[r:ROAD {km:-1}]->() SET r.km = 1")
+        self.env.assertEqual(self.distances(), [['a', 0.0], ['c', 10.0], ['d', 20.0], ['e', 1.0]])
+
+    def test07_persisted(self):
+        redis_con.execute_command("DEBUG", "RELOAD")
+        self.env.assertEqual(self.distances(), [['a', 0.0], ['c', 10.0], ['d', 20.0], ['e', 1.0]])
+        redis_graph.query("MATCH (a:City {name:'a'}), (d:City {name:'d'}) CREATE (a)-[:ROAD {km:3}]->(d)")
+        self.env.assertEqual(self.distances(), [['a', 0.0], ['c', 10.0], ['d', 3.0], ['e', 1.0]])
+
+    def test08_stop_maintaining(self):
+        redis_graph.query("CALL db.weights.maintain('ROAD', 'km', false)")
+        redis_graph.query("MATCH (:City {name:'a'})-[r:ROAD {km:3}]->() DELETE r")
+        self.env.assertEqual(self.distances(), [['a', 0.0], ['c', 10.0], ['d', 20.0], ['e', 1.0]])
@@ -0,0 +1,94 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "materialized_views"
+redis_con = None
+redis_graph = None
+
+class testMaterializedViews(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("CREATE (:Person {name:'a', age:10}), (:Person {name:'b', age:40}), (:Person {name:'c', age:50})")
+
+    def view(self, *args):
+        return redis_con.execute_command("GRAPH.VIEW", GRAPH_ID, *args)
+
+    def view_names(self, name):
+        q = "CALL db.view.nodes('%s') YIELD node RETURN node.name ORDER BY node.name" % name
+        return [row[0] for row in redis_graph.query(q).result_set]
+
+    def test01_create(self):
+        res = self.view("CREATE", "adults", "MATCH (p:Person) WHERE p.age > 18 RETURN p")
+        self.env.assertIn("Materialized 2 nodes", res.decode())
+        self.env.assertEquals(self.view_names("adults"), ['b', 'c'])
+
+        # Nodes returned multiple times are materialized once.
+        res = self.view("CREATE", "dup", "MATCH (p:Person), (q:Person) RETURN p")
+        self.env.assertIn("Materialized 3 nodes", res.decode())
+
+        res = self.view("LIST")
+        self.env.assertEquals(res, [[b'adults', b'MATCH (p:Person) WHERE p.age > 18 RETURN p', 2],
+                                    [b'dup', b'MATCH (p:Person), (q:Person) RETURN p', 3]])
+
+    def test02_refresh_on_write(self):
+        redis_graph.query("CREATE (:Person {name:'d', age:30})")
+        self.env.assertEquals(self.view_names("adults"), ['b', 'c', 'd'])
+
+        redis_graph.query("MATCH (p:Person {name:'a'}) SET p.age = 20")
+        self.env.assertEquals(self.view_names("adults"), ['a', 'b', 'c', 'd'])
+
+        redis_graph.query("MATCH (p:Person {name:'c'}) DELETE p")
+        self.env.assertEquals(self.view_names("adults"), ['a', 'b', 'd'])
+
+        # Read-only queries don't modify views.
+        redis_graph.query("MATCH (p:Person) RETURN p")
+        self.env.assertEquals(self.view_names("adults"), ['a', 'b', 'd'])
+
+    def test03_view_in_query(self):
+        q = "CALL db.view.nodes('adults') YIELD node WHERE node.age > 25 RETURN count(node)"
+        self.env.assertEquals(redis_graph.query(q).result_set, [[2]])
+
+    def test04_drop(self):
+        self.env.assertEquals(self.view("DROP", "dup"), b'OK')
+        self.env.assertEquals(len(self.view("LIST")), 1)
+        try:
+            self.view("DROP", "dup")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("No such materialized view", str(e))
+
+        try:
+            self.view_names("dup")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Materialized view dup does not exist", str(e))
+
+    def test05_errors(self):
+        # Views are defined by read-only queries.
+        try:
+            self.view("CREATE", "w", "CREATE (p:Person) RETURN p")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("read-only", str(e))
+
+        # Views materialize nodes.
+        try:
+            self.view("CREATE", "w", "MATCH (p:Person) RETURN p.name")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("must return nodes", str(e))
+
+        # Views can't be parameterized.
+        try:
+            self.view("CREATE", "w", "CYPHER age=10 MATCH (p:Person) WHERE p.age > $age RETURN p")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("parameters", str(e))
+
+        # Failed definitions aren't registered.
+        self.env.assertEquals(len(self.view("LIST")), 1)
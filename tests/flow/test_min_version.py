@@ -0,0 +1,93 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "min_version"
+redis_con = None
+replica_con = None
+
+
+class testMinVersion(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(useSlaves=True, moduleArgs="MIN_VERSION_WAIT 50")
+        global redis_con
+        global replica_con
+        redis_con = self.env.getConnection()
+        replica_con = self.env.getSlaveConnection()
+
+    def version(self, reply):
+        stats = [s.decode() if isinstance(s, bytes) else s for s in reply[-1]]
+        for stat in stats:
+            if stat.startswith("Graph version: "):
+                return int(stat.split(": ")[1])
+        return None
+
+    def write(self, query):
+        return self.version(redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, query))
+
+    def test01_writes_report_version(self):
+        first = self.write("CREATE (:Person {v: 1})")
+        self.env.assertGreater(first, 0)
+        second = self.write("CREATE (:Person {v: 2})")
+        self.env.assertEquals(second, first + 1)
+
+        # Queries which didn't modify the graph don't advance its version.
+        reply = redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "MATCH (p:Person) RETURN count(p)")
+        self.env.assertEquals(self.version(reply), None)
+        reply = redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "MATCH (p:Person {v: 100}) SET p.v = 0")
+        self.env.assertEquals(self.version(reply), None)
+        self.env.assertEquals(self.write("CREATE (:Person {v: 3})"), second + 1)
+
+    def test02_min_version(self):
+        version = self.write("CREATE (:Person {v: 4})")
+        query = "MATCH (p:Person) RETURN count(p)"
+        reply = redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, query, "min_version", version)
+        self.env.assertEquals(reply[1][0][0], 4)
+
+        try:
+            redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, query, "min_version", version + 1)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("behind the requested minimal version", str(e))
+
+        try:
+            redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, query, "min_version", "latest")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Failed to parse minimal graph version", str(e))
+
+    def test03_replica_reaches_master_version(self):
+        version = self.write("CREATE (:Person {v: 5})")
+        redis_con.execute_command("WAIT", 1, 0)
+        query = "MATCH (p:Person) RETURN max(p.v)"
+        reply = replica_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, query, "min_version", version)
+        self.env.assertEquals(reply[1][0][0], 5)
+
+        try:
+            replica_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, query, "min_version", version + 1)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("behind the requested minimal version", str(e))
+
+    def test04_version_persisted(self):
+        version = self.write("CREATE (:Person {v: 6})")
+        redis_con.execute_command("DEBUG", "RELOAD")
+        self.env.assertEquals(self.write("CREATE (:Person {v: 7})"), version + 1)
+
+    def test05_prepared_min_version(self):
+        # Prepared queries accept a minimal version like any other query.
+        version = self.write("CREATE (:Person {v: 8})")
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "MATCH (p:Person) WHERE p.v > $v RETURN count(p)")
+        reply = redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, "CYPHER v=7", "min_version", version)
+        self.env.assertEquals(reply[1][0][0], 1)
+
+        try:
+            redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, "CYPHER v=7", "min_version", version + 1)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("behind the requested minimal version", str(e))
+
+        # Without parameters the minimal version directly follows the handle.
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "MATCH (p:Person) RETURN max(p.v)")
+        reply = redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, "min_version", version)
+        self.env.assertEquals(reply[1][0][0], 8)
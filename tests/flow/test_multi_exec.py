@@ -127,3 +127,12 @@ class testMultiExecFlow(FlowTestsBase):
         results = redis_con_a.execute_command("EXEC")
 
         self.env.assertNotEqual(results, None)
+
+        # Write query which doesn't modify the graph - transaction OK
+        redis_con_a.execute_command("WATCH", GRAPH_ID)
+        redis_con_a.execute_command("MULTI")
+        redis_con_b.execute_command("GRAPH.QUERY", GRAPH_ID, "MATCH (n:person {name:'Nobody'}) SET n.name = 'Somebody'")
+        redis_con_a.execute_command("GRAPH.QUERY", GRAPH_ID, MATCH_QUERY)
+        results = redis_con_a.execute_command("EXEC")
+
+        self.env.assertNotEqual(results, None)
@@ -0,0 +1,90 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "multi_label"
+redis_con = None
+redis_graph = None
+
+class testMultiLabel(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("CREATE (:Person {name:'a'}), (:Person:Actor {name:'b'}), (:Actor:Person:Director {name:'c'}), (:Director {name:'d'}), ({name:'e'})")
+
+    def test01_match_multiple_labels(self):
+        query = "MATCH (n:Person:Actor) RETURN n.name ORDER BY n.name"
+        res = redis_graph.query(query)
+        self.env.assertEquals(res.result_set, [['b'], ['c']])
+
+        # Label order is irrelevant.
+        query = "MATCH (n:Director:Person) RETURN n.name ORDER BY n.name"
+        res = redis_graph.query(query)
+        self.env.assertEquals(res.result_set, [['c']])
+
+        # Nodes are members of each of their label matrices.
+        query = "MATCH (n:Director) RETURN n.name ORDER BY n.name"
+        res = redis_graph.query(query)
+        self.env.assertEquals(res.result_set, [['c'], ['d']])
+
+        query = "MATCH (n:Person) RETURN count(n)"
+        res = redis_graph.query(query)
+        self.env.assertEquals(res.result_set, [[3]])
+
+        # A missing label matches nothing.
+        query = "MATCH (n:Person:Missing) RETURN n.name"
+        res = redis_graph.query(query)
+        self.env.assertEquals(res.result_set, [])
+
+    def test02_labels_function(self):
+        query = "MATCH (n) RETURN n.name, labels(n) ORDER BY n.name"
+        res = redis_graph.query(query)
+        expected = [['a', 'Person'],
+                    ['b', ['Person', 'Actor']],
+                    ['c', ['Actor', 'Person', 'Director']],
+                    ['d', 'Director'],
+                    ['e', '']]
+        self.env.assertEquals(res.result_set, expected)
+
+    def test03_traverse_multi_labeled_nodes(self):
+        redis_graph.query("MATCH (a {name:'a'}), (c {name:'c'}) CREATE (a)-[:KNOWS]->(c)")
+        query = "MATCH (:Person)-[:KNOWS]->(n:Actor:Director) RETURN n.name"
+        res = redis_graph.query(query)
+        self.env.assertEquals(res.result_set, [['c']])
+
+        query = "MATCH (:Person)-[:KNOWS]->(n:Actor:Person:Missing) RETURN n.name"
+        res = redis_graph.query(query)
+        self.env.assertEquals(res.result_set, [])
+
+    def test04_merge_multiple_labels(self):
+        query = "MERGE (n:Person:Actor {name:'b'}) RETURN n.name"
+        res = redis_graph.query(query)
+        self.env.assertEquals(res.nodes_created, 0)
+
+        query = "MERGE (n:Person:Actor {name:'a'}) RETURN labels(n)"
+        res = redis_graph.query(query)
+        self.env.assertEquals(res.nodes_created, 1)
+        self.env.assertEquals(res.result_set, [[['Person', 'Actor']]])
+
+    def test05_persist_multiple_labels(self):
+        redis_con.execute_command("DEBUG", "RELOAD")
+        query = "MATCH (n:Actor:Person) RETURN n.name, labels(n) ORDER BY n.name"
+        res = redis_graph.query(query)
+        expected = [['a', ['Person', 'Actor']],
+                    ['b', ['Person', 'Actor']],
+                    ['c', ['Actor', 'Person', 'Director']]]
+        self.env.assertEquals(res.result_set, expected)
+
+    def test06_delete_multi_labeled_nodes(self):
+        res = redis_graph.query("MATCH (n:Actor:Director) DELETE n")
+        self.env.assertEquals(res.nodes_deleted, 1)
+        res = redis_graph.query("MATCH (n:Director) RETURN n.name")
+        self.env.assertEquals(res.result_set, [['d']])
+        res = redis_graph.query("MATCH (n:Actor) RETURN n.name ORDER BY n.name")
+        self.env.assertEquals(res.result_set, [['a'], ['b']])
@@ -99,3 +99,32 @@ class testGraphMultipleEdgeFlow(FlowTestsBase):
         actual_result = redis_graph.query(query)
         edge_count = actual_result.result_set[0][0]
         self.env.assertEquals(edge_count, 1)
+
+    # Connect a pair of nodes with many edges, then remove most of them.
+    def test_many_multiple_edges(self):
+        query = """CREATE (a {v:3}), (b {v:4})"""
+        redis_graph.query(query)
+
+        query = """MATCH (a {v:3}), (b {v:4}) UNWIND range(1, 100) AS x CREATE (a)-[:R {v:x}]->(b)"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.relationships_created, 100)
+
+        query = """MATCH (a {v:3})-[e:R]->(b {v:4}) RETURN count(e), sum(e.v)"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set[0], [100, 5050])
+
+        query = """MATCH (a {v:3})-[e:R]->(b {v:4}) WHERE e.v > 3 DELETE e"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.relationships_deleted, 97)
+
+        query = """MATCH (a {v:3})-[e:R]->(b {v:4}) RETURN e.v ORDER BY e.v"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [[1], [2], [3]])
+
+        query = """MATCH (a {v:3})-[e:R]->(b {v:4}) WHERE e.v > 1 DELETE e"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.relationships_deleted, 2)
+
+        query = """MATCH (a {v:3})-[e:R]->(b {v:4}) RETURN e.v"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [[1]])
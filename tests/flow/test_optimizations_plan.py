@@ -119,18 +119,49 @@ class testOptimizationsPlan(FlowTestsBase):
 
     def test07_count_unreferenced_edge(self):
         query = """MATCH ()-[:know]->(b) RETURN COUNT(b)"""
-        # This count in this query cannot be reduced, as the traversal op doesn't store
-        # data about non-referenced edges.
+        # Traversing non-referenced edges produces each pair of connected nodes once,
+        # the count is reduced to the number of connected pairs.
         resultset = graph.query(query).result_set
         executionPlan = graph.execution_plan(query)
-        # Verify that the optimization was not applied.
-        self.env.assertNotIn("Project", executionPlan)
-        self.env.assertIn("Aggregate", executionPlan)
-        self.env.assertIn("All Node Scan", executionPlan)
-        self.env.assertIn("Conditional Traverse", executionPlan)
+        self.env.assertIn("Project", executionPlan)
+        self.env.assertNotIn("Aggregate", executionPlan)
+        self.env.assertNotIn("Conditional Traverse", executionPlan)
         expected = [[12]]
         self.env.assertEqual(resultset, expected)
 
+        # Pairs connected by multiple types are counted once, such counts aren't reduced.
+        query = """MATCH ()-[:know|:works_with]->(b) RETURN COUNT(b)"""
+        resultset = graph.query(query).result_set
+        executionPlan = graph.execution_plan(query)
+        self.env.assertIn("Conditional Traverse", executionPlan)
+        self.env.assertEqual(resultset, [[12]])
+
+    def test07_labeled_endpoints_edge_count(self):
+        queries = [("MATCH (:person)-[r:know]->() RETURN COUNT(r)", 24),
+                   ("MATCH ()-[r:know]->(:person) RETURN COUNT(r)", 24),
+                   ("MATCH (:person)-[r]->(:person) RETURN COUNT(r)", 36),
+                   ("MATCH (:person)-[:works_with]->(b:person) RETURN COUNT(b)", 12),
+                   ("MATCH (:missing)-[r:know]->() RETURN COUNT(r)", 0)]
+        for query, expected in queries:
+            executionPlan = graph.execution_plan(query)
+            self.env.assertNotIn("Conditional Traverse", executionPlan)
+            self.env.assertNotIn("Aggregate", executionPlan)
+            resultset = graph.query(query).result_set
+            self.env.assertEqual(resultset, [[expected]])
+
+        # Degrees are counted off the relation matrices.
+        query = """MATCH (p:person {name: 'Roi'}) RETURN outdegree(p), outdegree(p, 'know'), indegree(p, 'know', 'works_with'), indegree(p, 'missing')"""
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[9, 6, 9, 0]])
+
+        # The size of a node's relationship pattern is its degree, the pattern isn't matched.
+        query = """MATCH (p:person {name: 'Roi'}) RETURN size((p)-[:know]->()), size(()-[:works_with]->(p)), size((p)-->())"""
+        executionPlan = graph.execution_plan(query)
+        self.env.assertNotIn("Apply", executionPlan)
+        self.env.assertNotIn("Conditional Traverse", executionPlan)
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[6, 3, 9]])
+
     def test08_non_labeled_node_count(self):
         query = """MATCH (n) RETURN COUNT(n)"""
         resultset = graph.query(query).result_set
@@ -332,3 +363,136 @@ class testOptimizationsPlan(FlowTestsBase):
         resultset = graph.query(query).result_set
         expected = []
         self.env.assertEqual(resultset, expected)
+
+    def test20_intersect_cycle_closing_traversals(self):
+        # The last node of a triangle is drawn from its neighbors' adjacency intersection.
+        query = "MATCH (a)-[:know]->(b)-[:know]->(c)-[:know]->(a) RETURN count(a)"
+        executionPlan = graph.execution_plan(query)
+        self.env.assertIn("Expand Intersect", executionPlan)
+        self.env.assertNotIn("Expand Into", executionPlan)
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[24]])
+
+        query = "MATCH (a)-[:know]->(b)<-[:know]-(c)-[:know]->(a) RETURN count(a)"
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[24]])
+
+        # Referenced edges are still verified by expand into.
+        query = "MATCH (a)-[:know]->(b)-[:know]->(c)-[e:know]->(a) RETURN count(e)"
+        executionPlan = graph.execution_plan(query)
+        self.env.assertNotIn("Expand Intersect", executionPlan)
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[24]])
+
+        query = "MATCH (a)-[:know]->(b)-[:know]->(c)-[:missing]->(a) RETURN count(a)"
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[0]])
+
+    def test21_value_hash_join_duplicate_and_null_keys(self):
+        # Several records share each join value.
+        query = "MATCH (a:person), (b:person) WHERE a.val % 2 = b.val % 2 RETURN count(a)"
+        executionPlan = graph.execution_plan(query)
+        self.env.assertIn("Value Hash Join", executionPlan)
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[8]])
+
+        # Integers join with equal doubles.
+        query = "MATCH (a:person), (b:person) WHERE a.val = b.val * 1.0 RETURN count(a)"
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[4]])
+
+        # Null values never join.
+        query = "MATCH (a:person), (b:person) WHERE a.missing = b.missing RETURN count(a)"
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[0]])
+
+    def test22_share_filter_and_projection_expressions(self):
+        query = "MATCH (p:person) WHERE toLower(p.name) STARTS WITH 'a' RETURN toLower(p.name), toUpper(toLower(p.name)) ORDER BY toLower(p.name)"
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [['ailon', 'AILON'], ['alon', 'ALON']])
+
+        # Shared through traversals into an aggregation.
+        query = "MATCH (p:person)-[:know]->(q:person) WHERE p.val * 10 > 15 RETURN p.val * 10, count(q) ORDER BY p.val * 10"
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [[20, 3], [30, 3]])
+
+        # Calls evaluated only for records passing earlier predicates are not computed ahead.
+        query = "MATCH (p:person) WITH p, CASE WHEN p.val > 1 THEN p.name ELSE p.val END AS v WHERE v = 'Boaz' OR (v > 5 AND toLower(v) = 'x') RETURN toLower(v)"
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [['boaz']])
+
+    def test23_seek_by_id_list(self):
+        query = "MATCH (p) WHERE id(p) IN [2, 0, 2, -1] RETURN p.name"
+        executionPlan = graph.execution_plan(query)
+        self.env.assertIn("NodeByIdSeek", executionPlan)
+        self.env.assertNotIn("Filter", executionPlan)
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [["Roi"], ["Ailon"]])
+
+        query = "CYPHER ids=[3, 100] MATCH (p) WHERE id(p) IN $ids RETURN p.name"
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [["Boaz"]])
+
+        # Label scans are bounded by the listed IDs, the filter remains in place.
+        query = "MATCH (p:person) WHERE id(p) IN [1, 3] RETURN p.name"
+        executionPlan = graph.execution_plan(query)
+        self.env.assertIn("Node By Label and ID Scan", executionPlan)
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [["Alon"], ["Boaz"]])
+
+    def test24_value_hash_join_switches_misestimated_sides(self):
+        g = Graph("adaptive_join", redis_con)
+        g.query("UNWIND range(1, 2000) AS x CREATE (:A {v: x, w: x})")
+        g.query("UNWIND range(1, 1000) AS x CREATE (:B {v: x * 2})")
+
+        # Filters the estimator can't see through make the A stream appear small.
+        query = """MATCH (a:A), (b:B) WHERE a.v = b.v AND abs(a.w) >= 0 AND abs(a.w) < 100000 AND sign(a.w) >= 0
+                   RETURN count(a), sum(b.v)"""
+        executionPlan = g.execution_plan(query)
+        self.env.assertIn("Value Hash Join", executionPlan)
+        self.env.assertNotIn("Switched sides", executionPlan)
+
+        # Once cached A records exceed the estimate, B is cached in their place.
+        profile = redis_con.execute_command("GRAPH.PROFILE", "adaptive_join", query)
+        join = [x for x in profile if "Value Hash Join" in x][0]
+        self.env.assertIn("Switched sides", join)
+        self.env.assertIn("Records produced: 1000,", join)
+
+        resultset = g.query(query).result_set
+        self.env.assertEqual(resultset, [[1000, 1001000]])
+
+    def test25_join_order_of_multiple_streams(self):
+        g = Graph("join_order", redis_con)
+        g.query("UNWIND range(1, 100) AS x CREATE (:A {x: x})")
+        g.query("UNWIND range(1, 10) AS x CREATE (:B {x: x, v: x}), (:C {v: x})")
+
+        # The small B and C streams are hash joined first, the large A stream joins their result.
+        query = "MATCH (a:A), (b:B), (c:C) WHERE a.x < b.x AND b.v = c.v RETURN count(*)"
+        executionPlan = g.execution_plan(query)
+        self.env.assertEqual(1, executionPlan.count("Cartesian Product"))
+        self.env.assertIn("Value Hash Join", executionPlan)
+        self.env.assertLess(executionPlan.index("Cartesian Product"), executionPlan.index("Value Hash Join"))
+
+        resultset = g.query(query).result_set
+        self.env.assertEqual(resultset, [[45]])
+
+    def test26_unused_traversal_destination(self):
+        # The anonymous destination isn't recorded, each traversed edge still produces a record.
+        query = "MATCH (p:person)-[:know]->(:person) WHERE p.val < 2 RETURN p.name ORDER BY p.name"
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [["Alon"]] * 3 + [["Roi"]] * 3)
+
+        query = "MATCH (p:person {name: 'Roi'}) OPTIONAL MATCH (p)-[:know]->() RETURN p.name, count(*)"
+        resultset = graph.query(query).result_set
+        self.env.assertEqual(resultset, [["Roi", 3]])
+
+        g = Graph("unused_destination", redis_con)
+        g.query("CREATE (:A {v: 1}), (:A {v: 2})")
+        g.query("MATCH (a:A {v: 1}) MERGE (a)-[:R]->(:B)")
+        # The pattern now exists and isn't created again.
+        result = g.query("MATCH (a:A) MERGE (a)-[:R]->(:B)")
+        self.env.assertEqual(result.nodes_created, 1)
+        self.env.assertEqual(result.relationships_created, 1)
+
+        resultset = g.query("MATCH (a:A)-[:R]->() RETURN a.v ORDER BY a.v").result_set
+        self.env.assertEqual(resultset, [[1], [2]])
@@ -35,3 +35,49 @@ class testOrderBy(FlowTestsBase):
         q = """MATCH (n:Person) RETURN n.id, n.name ORDER BY n.id DESC, n.name ASC LIMIT 10"""
         actual_result = redis_graph.query(q)
         self.env.assertEquals(actual_result.result_set, expected)
+
+    def test_order_by_numerics_and_strings(self):
+        # Enough values to sort by normalized keys, integers and floats interleaved.
+        values = [(x * 37) % 200 - 100 for x in range(200)]
+        values = [v if v % 3 else v + 0.5 for v in values]
+        q = """UNWIND %s AS v RETURN v ORDER BY v""" % str(values)
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals([row[0] for row in actual_result.result_set], sorted(values))
+
+        q = """UNWIND %s AS v RETURN v ORDER BY v DESC""" % str(values)
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals([row[0] for row in actual_result.result_set], sorted(values, reverse=True))
+
+        # Strings sharing long prefixes are ordered by their remaining characters.
+        names = ["prefix_shared_%d" % ((x * 53) % 150) for x in range(150)] + ["", "p", "prefix"]
+        q = """UNWIND %s AS s RETURN s ORDER BY s""" % str(names)
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals([row[0] for row in actual_result.result_set], sorted(names))
+
+        # Ties on the first key are ordered by the following keys.
+        q = """UNWIND range(0, 199) AS x RETURN x % 4 AS g, x ORDER BY g DESC, x"""
+        actual_result = redis_graph.query(q)
+        expected = sorted([[x % 4, x] for x in range(200)], key=lambda row: (-row[0], row[1]))
+        self.env.assertEquals(actual_result.result_set, expected)
+
+    def test_order_by_skip_limit(self):
+        # The sort retains the skipped records along with the limited ones.
+        q = """UNWIND range(1, 100) AS x RETURN x ORDER BY x DESC SKIP 5 LIMIT 10"""
+        plan = redis_graph.execution_plan(q)
+        self.env.assertIn("Sort | Top 15", plan)
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals([row[0] for row in actual_result.result_set], list(range(95, 85, -1)))
+
+        # Limits don't restrict traversals feeding a sort or an aggregation.
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:Src {v: x})-[:E]->(:Dst {v: 100 - x})")
+        q = """MATCH (:Src)-[:E]->(d:Dst) RETURN d.v ORDER BY d.v LIMIT 3"""
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals(actual_result.result_set, [[1], [2], [3]])
+
+        q = """MATCH (:Src)-[:E]->(d:Dst) RETURN count(d) LIMIT 1"""
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals(actual_result.result_set, [[100]])
+
+        q = """MATCH (:Src)-[:E]->(d:Dst) RETURN d.v SKIP 90 LIMIT 20"""
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals(len(actual_result.result_set), 10)
@@ -1,5 +1,6 @@
 import os
 import sys
+import redis
 from RLTest import Env
 from redisgraph import Graph, Node, Edge
 
@@ -47,3 +48,88 @@ class testPagerankFlow(FlowTestsBase):
             self.env.assertAlmostEqual(resultset[0][1], 0.777813196182251, 0.0001)
             self.env.assertEqual(resultset[1][0], 1)
             self.env.assertAlmostEqual(resultset[1][1], 0.22218681871891, 0.0001)
+
+    def test_pagerank_multiple_relationships(self):
+        self.env.cmd('flushall')
+        redis_graph.query("CREATE (a:L {v:1})-[:R]->(b:L {v:2}), (b)-[:S]->(c:L {v:3}), (c)-[:T]->(a)")
+
+        # Only connections of the given types are considered.
+        q = """CALL algo.pageRank('L', ['R', 'S']) YIELD node, score RETURN node.v, score"""
+        resultset = redis_graph.query(q).result_set
+        self.env.assertEqual(len(resultset), 3)
+        self.env.assertEqual([row[0] for row in resultset], [3, 2, 1])
+
+        # Considering every type, nodes form a cycle and are ranked equally.
+        q = """CALL algo.pageRank('L', ['R', 'S', 'T']) YIELD node, score RETURN score"""
+        resultset = redis_graph.query(q).result_set
+        self.env.assertEqual(len(resultset), 3)
+        for row in resultset:
+            self.env.assertAlmostEqual(row[0], 1.0 / 3, 0.0001)
+
+    def test_pagerank_top_k(self):
+        self.env.cmd('flushall')
+        redis_graph.query("UNWIND range(1, 50) AS x CREATE (:L {v:x})-[:R]->(:L {v:0})")
+        redis_graph.query("MATCH (a:L {v:1}), (b:L {v:2}) CREATE (a)-[:R]->(b)")
+
+        q = """CALL algo.pageRank('L', 'R') YIELD node, score RETURN node.v, score"""
+        expected = redis_graph.query(q).result_set
+        self.env.assertEqual(len(expected), 100)
+
+        q = """CALL algo.pageRank('L', 'R', NULL, NULL, 3) YIELD node, score RETURN node.v, score"""
+        actual = redis_graph.query(q).result_set
+        self.env.assertEqual(len(actual), 3)
+        for i in range(3):
+            self.env.assertAlmostEqual(actual[i][1], expected[i][1], 0.0001)
+
+    def test_pagerank_damping_and_seed(self):
+        self.env.cmd('flushall')
+        redis_graph.query("CREATE (a:L {v:1})-[:R]->(b:L {v:2})")
+
+        # Without damping every rank is teleported.
+        q = """CALL algo.pageRank('L', 'R', 0.0) YIELD node, score RETURN score"""
+        resultset = redis_graph.query(q).result_set
+        for row in resultset:
+            self.env.assertAlmostEqual(row[0], 0.5, 0.0001)
+
+        # Warm starting from stored ranks converges to the same ranks.
+        q = """CALL algo.pageRank('L', 'R') YIELD node, score RETURN node.v, score"""
+        for row in redis_graph.query(q).result_set:
+            redis_graph.query("MATCH (n:L {v:%d}) SET n.rank = %f" % (row[0], row[1]))
+        q = """CALL algo.pageRank('L', 'R', 0.85, 0.0001, 0, 'rank') YIELD node, score RETURN node.v, score"""
+        resultset = redis_graph.query(q).result_set
+        self.env.assertEqual(resultset[0][0], 2)
+        self.env.assertAlmostEqual(resultset[0][1], 0.777813196182251, 0.0001)
+        self.env.assertEqual(resultset[1][0], 1)
+        self.env.assertAlmostEqual(resultset[1][1], 0.22218681871891, 0.0001)
+
+        # Invalid damping factor.
+        try:
+            redis_graph.query("CALL algo.pageRank('L', 'R', 1.5)")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("damping factor", str(e))
+
+    def test_pagerank_limit_pushdown(self):
+        self.env.cmd('flushall')
+        redis_graph.query("CREATE (a:L {v:1})-[:R]->(b:L {v:2}), (b)-[:R]->(c:L {v:3})")
+
+        # A limit following the call bounds the records the procedure produces.
+        q = """CALL algo.pageRank('L', 'R') YIELD node, score RETURN node.v, score SKIP 1 LIMIT 1"""
+        plan = redis_graph.execution_plan(q)
+        self.env.assertIn("ProcedureCall | Limit 2", plan)
+        expected = redis_graph.query("""CALL algo.pageRank('L', 'R') YIELD node, score RETURN node.v, score""").result_set
+        resultset = redis_graph.query(q).result_set
+        self.env.assertEqual(resultset, expected[1:2])
+
+        # Yielding only the score skips node retrieval.
+        q = """CALL algo.pageRank('L', 'R') YIELD score RETURN score LIMIT 1"""
+        resultset = redis_graph.query(q).result_set
+        self.env.assertEqual(len(resultset), 1)
+        self.env.assertAlmostEqual(resultset[0][0], expected[0][1], 0.0001)
+
+        # Filters must see every record, the limit is not pushed through them.
+        q = """CALL algo.pageRank('L', 'R') YIELD node, score WITH node WHERE node.v = 1 RETURN node.v LIMIT 1"""
+        plan = redis_graph.execution_plan(q)
+        self.env.assertNotIn("ProcedureCall | Limit", plan)
+        resultset = redis_graph.query(q).result_set
+        self.env.assertEqual(resultset, [[1]])
@@ -160,3 +160,25 @@ class testPath(FlowTestsBase):
         query_info = QueryInfo(query = query, description="Tests path with zero length variable length paths", \
                                         expected_result = expected_results)
         self._assert_resultset_and_expected_mutually_included(redis_graph.query(query), query_info)
+
+    def test_path_values(self):
+        # Paths carried through distinct, grouping, collection and sorting
+        # retain their entities, and are materialized once replied.
+        redis_graph.query("CREATE (a:L1 {v: 0})-[:R1 {w: 1}]->(b:L1 {v: 1})-[:R1 {w: 2}]->(c:L1 {v: 2}), (c)-[:R1 {w: 3}]->(a)")
+
+        query = "MATCH p=(:L1 {v: 0})-[:R1*1..2]->() WITH DISTINCT p RETURN length(p) ORDER BY length(p)"
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[1], [2]])
+
+        query = "MATCH p=(a:L1)-[:R1*2]->() WITH a, collect(p) AS paths RETURN a.v, size(paths) ORDER BY a.v"
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[0, 1], [1, 1], [2, 1]])
+
+        query = "MATCH p=(a:L1)-[:R1*2]->(b) RETURN [n IN nodes(p) | n.v], [e IN relationships(p) | e.w] ORDER BY a.v"
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[[0, 1, 2], [1, 2]], [[1, 2, 0], [2, 3]], [[2, 0, 1], [3, 1]]])
+
+        # Incoming traversals.
+        query = "MATCH p=(c:L1 {v: 2})<-[:R1*2]-() RETURN [n IN nodes(p) | n.v], [e IN relationships(p) | e.w]"
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[[2, 1, 0], [2, 1]]])
@@ -222,3 +222,28 @@ class testPathFilter(FlowTestsBase):
         # Each source node should be returned exactly once.
         expected_results = [['a'], ['b']]
         self.env.assertEquals(result_set.result_set, expected_results)
+
+    def test11_repeated_bound_values(self):
+        # Many rows share the same source node, the pattern only references it.
+        redis_graph.query("UNWIND range(0, 9) AS i CREATE (:S {v: i})")
+        redis_graph.query("MATCH (s:S) WHERE s.v % 3 = 0 CREATE (s)-[:R]->(:X)")
+        redis_graph.query("UNWIND range(0, 49) AS i CREATE (:T {v: i})")
+
+        query = "MATCH (s:S), (t:T) WHERE (s)-[:R]->(:X) RETURN s.v, count(t) ORDER BY s.v"
+        result_set = redis_graph.query(query)
+        self.env.assertEquals(result_set.result_set, [[0, 50], [3, 50], [6, 50], [9, 50]])
+
+        query = "MATCH (s:S), (t:T) WHERE NOT (s)-[:R]->(:X) RETURN count(DISTINCT s), count(t)"
+        result_set = redis_graph.query(query)
+        self.env.assertEquals(result_set.result_set, [[6, 300]])
+
+        # Patterns referencing both nodes are evaluated per pair.
+        redis_graph.query("MATCH (s:S {v: 1}), (t:T) WHERE t.v < 5 CREATE (s)-[:R]->(t)")
+        query = "MATCH (s:S), (t:T) WHERE (s)-[:R]->(t) OR (s)-[:R]->(:X) RETURN count(t)"
+        result_set = redis_graph.query(query)
+        self.env.assertEquals(result_set.result_set, [[205]])
+
+        # Bound values filtering pattern properties.
+        query = "MATCH (s:S), (t:T) WITH s.v AS v, t WHERE (:S {v: v})-[:R]->(:X) RETURN count(t)"
+        result_set = redis_graph.query(query)
+        self.env.assertEquals(result_set.result_set, [[200]])
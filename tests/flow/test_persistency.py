@@ -198,3 +198,30 @@ class testGraphPersistency(FlowTestsBase):
         # Verify that the latest edge was properly saved and loaded
         actual_result = g.query(q)
         self.env.assertEquals(actual_result.result_set, expected_result)
+
+    # Verify relation and adjacency matrices rebuilt on load support traversals in both directions.
+    def test05_restore_relations(self):
+        graphname = "restore_relations"
+        g = Graph(graphname, redis_con)
+        g.query("UNWIND range(0, 99) AS x CREATE (:N {v: x})")
+        g.query("MATCH (a:N), (b:N) WHERE b.v = (a.v + 1) % 100 CREATE (a)-[:NEXT]->(b), (a)-[:NEXT]->(b)")
+        g.query("MATCH (a:N), (b:N) WHERE a.v % 10 = 0 AND b.v = a.v + 5 CREATE (a)-[:SKIP {d: 5}]->(b)")
+
+        queries = ["MATCH ()-[e:NEXT]->() RETURN count(e)",
+                   "MATCH (a)-[e:SKIP]->(b) RETURN a.v, e.d, b.v ORDER BY a.v",
+                   "MATCH (a {v: 50})<-[e]-(b) RETURN type(e), b.v ORDER BY type(e), b.v",
+                   "MATCH (a {v: 10})-[]->(b) RETURN b.v ORDER BY b.v",
+                   "MATCH (a {v: 3})-[:NEXT*3]->(b) RETURN DISTINCT b.v"]
+        expected = [g.query(q).result_set for q in queries]
+
+        # Save RDB & Load from RDB
+        redis_con.execute_command("DEBUG", "RELOAD")
+
+        for q, e in zip(queries, expected):
+            self.env.assertEquals(g.query(q).result_set, e)
+
+        # Repeated edges remain individually deletable.
+        result = g.query("MATCH ({v: 0})-[e:NEXT]->({v: 1}) WITH e LIMIT 1 DELETE e")
+        self.env.assertEquals(result.relationships_deleted, 1)
+        result = g.query("MATCH ({v: 0})-[e:NEXT]->({v: 1}) RETURN count(e)")
+        self.env.assertEquals(result.result_set, [[1]])
@@ -0,0 +1,124 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "plan_cache"
+redis_con = None
+redis_graph = None
+
+class testPlanCache(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("CREATE (:Person {name:'a', v:1}), (:Person {name:'b', v:2})")
+
+    # Issues query, returning result records and whether a cached plan was used.
+    def execute(self, query):
+        res = redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, query)
+        stats = [s.decode() if isinstance(s, bytes) else s for s in res[-1]]
+        cached = [s for s in stats if s.startswith("Cached execution")]
+        self.env.assertEquals(len(cached), 1)
+        return res[1] if len(res) == 3 else [], cached[0] == "Cached execution: 1"
+
+    def plan_cache_stats(self):
+        res = redis_graph.query("CALL db.planCacheStats()")
+        return res.result_set[0]
+
+    def test01_cached_execution(self):
+        query = "MATCH (p:Person) RETURN p.name ORDER BY p.name"
+        records, cached = self.execute(query)
+        self.env.assertFalse(cached)
+        self.env.assertEquals(len(records), 2)
+
+        records_cached, cached = self.execute(query)
+        self.env.assertTrue(cached)
+        self.env.assertEquals(records, records_cached)
+
+    def test02_params_across_hits(self):
+        query = "MATCH (p:Person) WHERE p.v = $v RETURN p.name"
+        records, cached = self.execute("CYPHER v=1 " + query)
+        self.env.assertFalse(cached)
+        self.env.assertEquals(records[0][0], b'a')
+
+        # Same query body with a different parameter value reuses the plan.
+        records, cached = self.execute("CYPHER v=2 " + query)
+        self.env.assertTrue(cached)
+        self.env.assertEquals(records[0][0], b'b')
+
+        # Missing parameters are still reported.
+        try:
+            self.execute(query)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Missing parameters", str(e))
+
+    def test03_invalidation(self):
+        query = "MATCH (p:Person) WHERE p.v > 0 RETURN count(p)"
+        self.execute(query)
+        _, cached = self.execute(query)
+        self.env.assertTrue(cached)
+
+        # Creating an index invalidates all cached plans.
+        redis_graph.query("CREATE INDEX ON :Person(v)")
+        _, cached = self.execute(query)
+        self.env.assertFalse(cached)
+        _, cached = self.execute(query)
+        self.env.assertTrue(cached)
+
+        # Introducing a new label invalidates all cached plans.
+        redis_graph.query("CREATE (:City)")
+        _, cached = self.execute(query)
+        self.env.assertFalse(cached)
+
+    def test04_stats(self):
+        before = self.plan_cache_stats()
+        query = "MATCH (p:Person) RETURN p.v"
+        self.execute(query)
+        self.execute(query)
+        after = self.plan_cache_stats()
+        # size, hits, misses, evictions, bytes, hit_rate
+        self.env.assertGreater(after[0], 0)
+        self.env.assertGreater(after[1], before[1])
+        self.env.assertGreater(after[2], before[2])
+        self.env.assertAlmostEqual(after[5], float(after[1]) / (after[1] + after[2]), 0.0001)
+
+    def test05_param_specialized_plans(self):
+        # Seeking by the listed IDs specializes the plan for the parameter's value.
+        query = "MATCH (p:Person) WHERE id(p) IN $ids RETURN p.name ORDER BY p.name"
+        records, cached = self.execute("CYPHER ids=[0] " + query)
+        self.env.assertFalse(cached)
+        self.env.assertEquals(len(records), 1)
+        records, cached = self.execute("CYPHER ids=[0] " + query)
+        self.env.assertTrue(cached)
+        self.env.assertEquals(len(records), 1)
+
+        # A different value builds and caches a plan of its own.
+        records, cached = self.execute("CYPHER ids=[0, 1] " + query)
+        self.env.assertFalse(cached)
+        self.env.assertEquals(len(records), 2)
+        records, cached = self.execute("CYPHER ids=[0, 1] " + query)
+        self.env.assertTrue(cached)
+        self.env.assertEquals(len(records), 2)
+
+        # Both plans remain cached.
+        records, cached = self.execute("CYPHER ids=[0] " + query)
+        self.env.assertTrue(cached)
+        self.env.assertEquals(len(records), 1)
+
+    def test06_query_stats(self):
+        query = "MATCH (p:Person) WHERE p.v > $v RETURN p.name"
+        for v in range(3):
+            self.execute("CYPHER v=%d %s" % (v, query))
+
+        # Executions of the same plan are aggregated under its fingerprint, regardless of parameters.
+        res = redis_graph.query("CALL db.queryStats() YIELD query, executions, errors, mean, p99, max RETURN query, executions, errors, mean, p99, max")
+        entries = [row[1:] for row in res.result_set if row[0] == query]
+        self.env.assertEquals(len(entries), 1)
+        executions, errors, mean, p99, max_latency = entries[0]
+        self.env.assertEquals(executions, 3)
+        self.env.assertEquals(errors, 0)
+        self.env.assertGreaterEqual(p99, 0)
+        self.env.assertLessEqual(mean, max_latency)
@@ -0,0 +1,90 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "plan_pins"
+redis_con = None
+redis_graph = None
+
+class testPlanPins(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:Person {v: x})")
+
+    def plan(self, *args):
+        return redis_con.execute_command("GRAPH.PLAN", GRAPH_ID, *args)
+
+    def test01_pin(self):
+        query = "MATCH (p:Person) WHERE p.v = 1 RETURN p.v"
+        shape = self.plan("PIN", query)
+        self.env.assertIn("Node By Label Scan", shape)
+        self.env.assertNotIn("Index Scan", shape)
+
+        # The pinned plan is built once a new index would otherwise be utilized.
+        redis_graph.query("CREATE INDEX ON :Person(v)")
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Node By Label Scan", plan)
+        self.env.assertNotIn("Index Scan", plan)
+        self.env.assertEquals(redis_graph.query(query).result_set, [[1]])
+
+        # Parameterized queries share the pin of their body.
+        plan = redis_con.execute_command("GRAPH.EXPLAIN", GRAPH_ID, "CYPHER x=1 " + query)
+        self.env.assertNotIn("Index Scan", "\n".join(plan))
+
+        pins = self.plan("LIST")
+        self.env.assertEquals(len(pins), 1)
+        self.env.assertEquals(pins[0][0], query)
+        self.env.assertEquals(pins[0][1], shape)
+        self.env.assertEquals(pins[0][3], 0)
+
+        # Unpinned queries utilize the index.
+        self.env.assertEquals(self.plan("UNPIN", query), "OK")
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Index Scan", plan)
+        self.env.assertEquals(self.plan("LIST"), [])
+
+    def test02_mismatch(self):
+        query = "MATCH (p:Person) WHERE p.v > 5 RETURN p.v"
+        shape = self.plan("PIN", query)
+        self.env.assertIn("Index Scan", shape)
+
+        # Once the index is dropped the pinned shape no longer validates.
+        redis_graph.query("DROP INDEX ON :Person(v)")
+        self.env.assertEquals(len(redis_graph.query(query).result_set), 5)
+        pins = self.plan("LIST")
+        self.env.assertEquals(pins[0][3], 1)
+
+    def test03_persistency(self):
+        pins = self.plan("LIST")
+        self.env.dumpAndReload()
+        self.env.assertEquals(self.plan("LIST")[0][0:3], pins[0][0:3])
+
+    def test04_restore(self):
+        # Exported plans are pinned as is.
+        query = "MATCH (p:Person) RETURN p"
+        self.env.assertEquals(self.plan("RESTORE", query, 0, "Results(Project(Node By Label Scan | (p:Person)))"), "OK")
+        pin = [p for p in self.plan("LIST") if p[0] == query][0]
+        self.env.assertEquals(pin[2], 0)
+
+    def test05_errors(self):
+        try:
+            self.plan("UNPIN", "MATCH (n) RETURN n")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("No plan is pinned for query", str(e))
+
+        try:
+            self.plan("PIN", "CREATE INDEX ON :Person(name)")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Only plans of queries can be pinned", str(e))
+
+        try:
+            self.plan("RESTORE", "MATCH (n) RETURN n", "rules", "")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Invalid optimizer rules", str(e))
@@ -0,0 +1,97 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "point"
+redis_con = None
+redis_graph = None
+
+class testPoint(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # A grid of places a tenth of a degree apart, mirrored by unindexed nodes.
+        for label in ["Place", "Unindexed"]:
+            redis_graph.query("UNWIND range(0, 39) AS i UNWIND range(0, 39) AS j CREATE (:%s {id: i * 40 + j, loc: point(30 + i / 10.0, 30 + j / 10.0)})" % label)
+        redis_graph.query("CREATE INDEX ON :Place(loc)")
+
+    def _assert_matches_unindexed(self, query):
+        expected = redis_graph.query(query.replace(":Place", ":Unindexed")).result_set
+        actual = redis_graph.query(query).result_set
+        self.env.assertEquals(sorted(actual), sorted(expected))
+        return actual
+
+    def test01_functions(self):
+        # London to Paris, in meters.
+        query = "RETURN round(distance(point(51.5074, -0.1278), point(48.8566, 2.3522)) / 1000)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[344]])
+        query = "RETURN distance(point(0, 0), point(0, 0)), distance(point(0, 0), NULL)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[0, None]])
+
+        query = "RETURN tostring(point(1.5, -2.5))"
+        self.env.assertEquals(redis_graph.query(query).result_set, [["point({latitude: 1.500000, longitude: -2.500000})"]])
+
+        # Points are equal if their coordinates are.
+        query = "RETURN point(1, 2) = point(1, 2), point(1, 2) = point(2, 1)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[True, False]])
+
+        try:
+            redis_graph.query("RETURN point(91, 0)")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("latitude", str(e))
+
+    def test02_radius_plan(self):
+        query = "MATCH (p:Place) WHERE distance(p.loc, point(32, 32)) < 5000 RETURN p.id"
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Index Scan", plan)
+        self.env.assertNotIn("Node By Label Scan", plan)
+        # The distance filter is applied to the scanned cells.
+        self.env.assertIn("Filter", plan)
+
+        # Reversed operands and parameterized centers are resolved too.
+        query = "CYPHER lat=32 lon=32 MATCH (p:Place) WHERE 5000 >= distance(point($lat, $lon), p.loc) RETURN p.id"
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Index Scan", plan)
+
+        # Lower bounds aren't resolved by the index.
+        query = "MATCH (p:Place) WHERE distance(p.loc, point(32, 32)) > 5000 RETURN p.id"
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Node By Label Scan", plan)
+
+    def test03_radius_results(self):
+        for radius in [0, 5000, 12000, 50000, 1000000]:
+            query = "MATCH (p:Place) WHERE distance(p.loc, point(32, 32)) <= %d RETURN p.id" % radius
+            self._assert_matches_unindexed(query)
+
+        # A center on a grid point at radius 0 matches that point alone.
+        query = "MATCH (p:Place) WHERE distance(p.loc, point(31, 31)) <= 0 RETURN p.id"
+        self.env.assertEquals(len(self._assert_matches_unindexed(query)), 1)
+
+        # Combined with additional filters.
+        query = "MATCH (p:Place) WHERE distance(p.loc, point(32, 32)) < 20000 AND p.id % 2 = 0 RETURN p.id"
+        self._assert_matches_unindexed(query)
+
+        # Negative radii match nothing.
+        query = "MATCH (p:Place) WHERE distance(p.loc, point(32, 32)) < -1 RETURN p.id"
+        self.env.assertEquals(self._assert_matches_unindexed(query), [])
+
+    def test04_updates(self):
+        # Moved nodes are found at their new location.
+        redis_graph.query("MATCH (p) WHERE p.id = 0 SET p.loc = point(-10, -10)")
+        query = "MATCH (p:Place) WHERE distance(p.loc, point(-10, -10)) < 1000 RETURN p.id"
+        self.env.assertEquals(self._assert_matches_unindexed(query), [[0]])
+        query = "MATCH (p:Place) WHERE distance(p.loc, point(30, 30)) < 1000 RETURN p.id"
+        self.env.assertEquals(self._assert_matches_unindexed(query), [])
+
+    def test05_persistence(self):
+        # Points survive a reload.
+        redis_con.execute_command("DEBUG", "RELOAD")
+        query = "MATCH (p:Place) WHERE distance(p.loc, point(-10, -10)) < 1000 RETURN p.id, tostring(p.loc)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[0, "point({latitude: -10.000000, longitude: -10.000000})"]])
@@ -0,0 +1,111 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "prepared_statements"
+redis_con = None
+redis_graph = None
+
+class testPreparedStatements(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("CREATE (:Person {name:'a', v:1}), (:Person {name:'b', v:2})")
+
+    def execute(self, *args):
+        return redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, *args)
+
+    def test01_prepare_execute(self):
+        query = "MATCH (p:Person) WHERE p.v = $v RETURN p.name"
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, query)
+        # Preparing the same query returns the same handle.
+        self.env.assertEquals(redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, query), handle)
+
+        res = self.execute(handle, "CYPHER v=1")
+        self.env.assertEquals(res[1], [[b'a']])
+        res = self.execute(handle, "CYPHER v=2")
+        self.env.assertEquals(res[1], [[b'b']])
+
+        # Compact replies are supported.
+        res = self.execute(handle, "CYPHER v=1", "--compact")
+        self.env.assertEquals(len(res[1]), 1)
+
+    def test02_prepare_without_params(self):
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "MATCH (p:Person) RETURN count(p)")
+        res = self.execute(handle)
+        self.env.assertEquals(res[1], [[2]])
+
+    def test03_errors(self):
+        # Unknown handle.
+        try:
+            self.execute(1000)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Unknown prepared query handle", str(e))
+
+        # Parameter values can't be prepared.
+        try:
+            redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "CYPHER v=1 RETURN $v")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Prepared queries can't specify parameter values", str(e))
+
+        # Missing parameters are reported on execution.
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "RETURN $v")
+        try:
+            self.execute(handle)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Missing parameters", str(e))
+
+    def test04_prepared_write(self):
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "CREATE (:Person {name:$name, v:$v})")
+        self.execute(handle, "CYPHER name='c' v=3")
+        res = redis_graph.query("MATCH (p:Person {v:3}) RETURN p.name")
+        self.env.assertEquals(res.result_set, [['c']])
+
+    def test05_params_validated(self):
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "MATCH (p:Person) WHERE p.v = $v RETURN p.name")
+        # Parameters must not be followed by a query body.
+        for params in ["CYPHER v=1 MATCH (n) DELETE n", "MATCH (n) DELETE n"]:
+            try:
+                self.execute(handle, params)
+                self.env.assertTrue(False)
+            except Exception as e:
+                self.env.assertIn("Invalid prepared query parameters", str(e))
+        res = redis_graph.query("MATCH (p:Person) RETURN count(p)")
+        self.env.assertGreater(res.result_set[0][0], 0)
+
+        # Options are recognized in place of parameters.
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "MATCH (p:Person {v:1}) RETURN p.name")
+        res = self.execute(handle, "timeout", 1000)
+        self.env.assertEquals(res[1], [[b'a']])
+
+    def test06_bounded_registry(self):
+        # Prepared queries are capped per graph, the least recently used one is evicted.
+        cap = 512
+        first = "RETURN 0 AS v"
+        first_handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, first)
+        recent = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "RETURN 1 AS v")
+        for i in range(2, cap + 1):
+            redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "RETURN %d AS v" % i)
+            # Executing a query keeps it from being evicted.
+            if i == cap // 2:
+                self.execute(recent)
+
+        try:
+            self.execute(first_handle)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Unknown prepared query handle", str(e))
+        res = self.execute(recent)
+        self.env.assertEquals(res[1], [[1]])
+
+        # Preparing an evicted query assigns it a new handle.
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, first)
+        self.env.assertNotEqual(handle, first_handle)
+        res = self.execute(handle)
+        self.env.assertEquals(res[1], [[0]])
@@ -296,3 +296,26 @@ class testProcedures(FlowTestsBase):
         except redis.exceptions.ResponseError:
             # Expecting an error.
             pass
+
+    def test_procedure_fulltext_async(self):
+        # Documents of an asynchronous index are updated in the background.
+        g = Graph("fulltext_async", redis_con)
+        g.query("CREATE (:book {title: 'The Jungle Book'})")
+        g.call_procedure("db.idx.fulltext.createNodeIndex", 'book', 'title')
+        g.query("CALL db.idx.fulltext.setAsync('book', true)")
+
+        g.query("CREATE (:book {title: 'The Book of Life'})")
+        g.query("MATCH (b:book {title: 'The Jungle Book'}) SET b.title = 'The Jungle'")
+        # Once synchronized, queries observe every committed write.
+        g.call_procedure("db.idx.fulltext.sync", 'book')
+        query = "CALL db.idx.fulltext.queryNodes('book', 'Book') YIELD node RETURN node.title"
+        self.env.assertEquals(g.query(query).result_set, [['The Book of Life']])
+        query = "CALL db.idx.fulltext.queryNodes('book', 'Jungle') YIELD node RETURN node.title"
+        self.env.assertEquals(g.query(query).result_set, [['The Jungle']])
+
+        # Disabling background updates applies pending updates.
+        g.query("MATCH (b:book {title: 'The Jungle'}) DELETE b")
+        g.query("CALL db.idx.fulltext.setAsync('book', false)")
+        self.env.assertEquals(g.query(query).result_set, [])
+        g.query("CREATE (:book {title: 'Jungle Tales'})")
+        self.env.assertEquals(g.query(query).result_set, [['Jungle Tales']])
@@ -35,3 +35,133 @@ class testProfile(FlowTestsBase):
         self.env.assertIn("Project | Records produced: 2", profile)
         self.env.assertIn("Filter | Records produced: 2", profile)
         self.env.assertIn("Node By Label Scan | (p:Person) | Records produced: 3", profile)
+
+    def test_profile_estimates(self):
+        redis_con.execute_command("GRAPH.QUERY", "estimates", "UNWIND range(1, 10) AS x CREATE (:E {v: x})")
+
+        # Operations report the number of records they were estimated to produce.
+        q = "MATCH (e:E) RETURN e LIMIT 4"
+        profile = redis_con.execute_command("GRAPH.PROFILE", "estimates", q)
+        scan = [x for x in profile if x.startswith("Node By Label Scan")][0]
+        self.env.assertIn("Estimated records: 10,", scan)
+        limit = [x for x in profile if x.startswith("Limit")][0]
+        self.env.assertIn("Records produced: 4, Estimated records: 4,", limit)
+
+        # Aggregations without keys produce a single record.
+        q = "MATCH (e:E) RETURN count(e)"
+        profile = redis_con.execute_command("GRAPH.PROFILE", "estimates", q)
+        aggregate = [x for x in profile if x.startswith("Aggregate")][0]
+        self.env.assertIn("Records produced: 1, Estimated records: 1,", aggregate)
+
+    def test_traverse_batch_size(self):
+        redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "UNWIND range(1, 1000) AS x CREATE (:A {v: x})-[:R]->(:B)")
+
+        # Batches double while their results stay small.
+        q = "MATCH (a:A)-[:R]->(b:B) RETURN count(b)"
+        profile = redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, q)
+        traverse = [x for x in profile if x.startswith("Conditional Traverse")][0]
+        self.env.assertIn("Batches: 6, Batch size: 16-512", traverse)
+
+        # Batches don't exceed the query's limit.
+        q = "MATCH (a:A)-[:R]->(b:B) RETURN b LIMIT 1"
+        profile = redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, q)
+        traverse = [x for x in profile if x.startswith("Conditional Traverse")][0]
+        self.env.assertIn("Batches: 1, Batch size: 1-1", traverse)
+
+    def test_traverse_expression_reuse(self):
+        redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "UNWIND range(1, 200) AS x CREATE (a:P {v: x}), (a)-[:K]->(:P), (a)-[:K]->(:Q)")
+
+        # Later batches evaluate a cached product of the labeled traversal.
+        q = "MATCH (a:P)-[:K]->(b:P) RETURN count(b)"
+        profile = redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, q)
+        traverse = [x for x in profile if x.startswith("Conditional Traverse")][0]
+        self.env.assertIn("Batches: 5", traverse)
+        self.env.assertEquals(redis_graph.query(q).result_set, [[200]])
+
+        # Writing queries reach the same nodes.
+        q = "MATCH (a:P)-[:K]->(b:P) SET b.reached = true"
+        self.env.assertEquals(redis_graph.query(q).properties_set, 200)
+
+    def test_explain_structured(self):
+        redis_con.execute_command("GRAPH.QUERY", "explain_structured", "UNWIND range(1, 10) AS x CREATE (:E {v: x})")
+
+        def to_dict(op):
+            op = dict(zip(op[0::2], op[1::2]))
+            op["children"] = [to_dict(child) for child in op["children"]]
+            return op
+
+        def find(op, name):
+            if op["operation"] == name:
+                return op
+            for child in op["children"]:
+                found = find(child, name)
+                if found:
+                    return found
+            return None
+
+        q = "MATCH (e:E) RETURN e LIMIT 4"
+        plan = to_dict(redis_con.execute_command("GRAPH.EXPLAIN", "explain_structured", q, "--structured"))
+        self.env.assertEquals(plan["operation"], "Results")
+
+        scan = find(plan, "Node By Label Scan")
+        self.env.assertEquals(scan["description"], "Node By Label Scan | (e:E)")
+        self.env.assertEquals(float(scan["estimated_records"]), 10)
+        self.env.assertEquals(scan["selectivity"], None)
+        self.env.assertEquals(scan["children"], [])
+
+        limit = find(plan, "Limit")
+        self.env.assertEquals(float(limit["estimated_records"]), 4)
+        self.env.assertEquals(float(limit["selectivity"]), 0.4)
+
+        # Operations report the choices made for them.
+        q = "MATCH (e:E)-[:R]->(f) WHERE e.v > 1 RETURN f"
+        plan = to_dict(redis_con.execute_command("GRAPH.EXPLAIN", "explain_structured", q, "--structured"))
+        self.env.assertIn("batch_size", find(plan, "Conditional Traverse"))
+        self.env.assertIn("batch_size", find(plan, "Filter"))
+
+        # The textual plan is unchanged.
+        plan = redis_con.execute_command("GRAPH.EXPLAIN", "explain_structured", q)
+        self.env.assertEquals(plan[0], "Results")
+
+    def test_profile_structured(self):
+        redis_con.execute_command("GRAPH.QUERY", "profile_structured", "UNWIND range(1, 10) AS x CREATE (:E {v: x})-[:R]->(:F)")
+
+        def to_dict(op):
+            op = dict(zip(op[0::2], op[1::2]))
+            op["children"] = [to_dict(child) for child in op["children"]]
+            return op
+
+        def find(op, name):
+            if op["operation"] == name:
+                return op
+            for child in op["children"]:
+                found = find(child, name)
+                if found:
+                    return found
+            return None
+
+        q = "MATCH (e:E)-[:R]->(f:F) RETURN count(f)"
+        plan = to_dict(redis_con.execute_command("GRAPH.PROFILE", "profile_structured", q, "--structured"))
+        self.env.assertIn("peak_memory", plan)
+        for key in ["queue_wait_ms", "lock_wait_ms", "matrix_sync_ms"]:
+            self.env.assertGreaterEqual(float(plan[key]), 0)
+
+        scan = find(plan, "Node By Label Scan")
+        self.env.assertEquals(scan["records_produced"], 10)
+        # Each record produced is a call, as well as the final call depleting the scan.
+        self.env.assertGreaterEqual(scan["calls"], 11)
+        self.env.assertEquals(scan["matrix_operations"], 0)
+
+        # Traversals account the algebraic expressions they evaluate.
+        traverse = find(plan, "Conditional Traverse")
+        self.env.assertEquals(traverse["records_produced"], 10)
+        self.env.assertGreater(traverse["matrix_operations"], 0)
+        self.env.assertGreaterEqual(float(traverse["matrix_time_ms"]), 0)
+        self.env.assertGreaterEqual(float(traverse["execution_time_ms"]), float(traverse["matrix_time_ms"]))
+
+        # Index scans count the IDs retrieved from the index.
+        redis_con.execute_command("GRAPH.QUERY", "profile_structured", "CREATE INDEX ON :E(v)")
+        q = "MATCH (e:E) WHERE e.v > 5 RETURN e"
+        plan = to_dict(redis_con.execute_command("GRAPH.PROFILE", "profile_structured", q, "--structured"))
+        scan = find(plan, "Index Scan")
+        self.env.assertEquals(scan["index_hits"], 5)
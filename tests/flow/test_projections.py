@@ -0,0 +1,69 @@
+import os
+import sys
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "projections"
+redis_con = None
+redis_graph = None
+
+class testProjectionsFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("""CREATE (a:L {v:'a'})-[:R {w:1}]->(b:L {v:'b'})-[:R {w:2}]->(c:L {v:'c'}),
+                             (d:L {v:'d'})-[:S {w:3}]->(e:L {v:'e'})""")
+
+    def components(self):
+        q = "CALL algo.wcc('L', ['R', 'S']) YIELD node, componentId RETURN node.v, componentId"
+        groups = {}
+        for v, component in redis_graph.query(q).result_set:
+            groups.setdefault(component, []).append(v)
+        return sorted(sorted(group) for group in groups.values())
+
+    def projection(self, name):
+        q = "CALL algo.projections() YIELD name, nodes, relationships, builds, hits RETURN name, nodes, relationships, builds, hits"
+        for row in redis_graph.query(q).result_set:
+            if row[0] == name:
+                return row[1:]
+        return None
+
+    def test01_project(self):
+        q = "CALL algo.project('social', 'L', ['S', 'R'], 'w') YIELD name, nodes, relationships RETURN name, nodes, relationships"
+        self.env.assertEqual(redis_graph.query(q).result_set, [['social', 5, 3]])
+
+        # Algorithm runs over the projected subgraph reuse its matrices.
+        expected = [['a', 'b', 'c'], ['d', 'e']]
+        self.env.assertEqual(self.components(), expected)
+        self.env.assertEqual(self.components(), expected)
+        self.env.assertEqual(self.projection('social'), [5, 3, 1, 2])
+
+    def test02_invalidated_on_write(self):
+        redis_graph.query("MATCH (c:L {v:'c'}), (d:L {v:'d'}) CREATE (c)-[:S]->(d)")
+        self.env.assertEqual(self.components(), [['a', 'b', 'c', 'd', 'e']])
+        # The projection was rebuilt once.
+        self.env.assertEqual(self.projection('social')[:3], [5, 4, 2])
+
+    def test03_drop(self):
+        redis_graph.query("CALL algo.project.drop('social')")
+        self.env.assertEqual(self.projection('social'), None)
+
+        try:
+            redis_graph.query("CALL algo.project.drop('social')")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("does not exist", str(e))
+
+        try:
+            redis_graph.query("CALL algo.project('p', 'Unknown', 'R')")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("unknown label", str(e))
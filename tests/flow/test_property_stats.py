@@ -0,0 +1,97 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "property_stats"
+redis_con = None
+redis_graph = None
+
+class testPropertyStats(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 99) AS x CREATE (:P {v: x, name: 'p' + toString(x % 10)})")
+        # Nodes missing the v attribute.
+        redis_graph.query("UNWIND range(0, 19) AS x CREATE (:P {name: 'q'})")
+        redis_graph.query("CREATE (:Q {v: 1.5})")
+
+    def _property_stats(self):
+        res = redis_graph.query("CALL db.propertyStats()")
+        header = [h[1] for h in res.header]
+        return {(row[0], row[1]): dict(zip(header, row)) for row in res.result_set}
+
+    def _assert_distinct(self, actual, expected):
+        # Distinct values are estimated.
+        self.env.assertLessEqual(abs(actual - expected), max(2, expected * 0.05))
+
+    def test01_created_entities(self):
+        stats = self._property_stats()
+        self.env.assertEquals(len(stats), 3)
+
+        v = stats[("P", "v")]
+        self.env.assertEquals(v["count"], 100)
+        self.env.assertAlmostEqual(v["nullFraction"], 20.0 / 120, 0.0001)
+        self._assert_distinct(v["distinct"], 100)
+        self.env.assertEquals(v["min"], 0)
+        self.env.assertEquals(v["max"], 99)
+        self.env.assertEquals([float(b) for b in v["histogram"]], [float(b) for b in range(9, 100, 10)])
+
+        name = stats[("P", "name")]
+        self.env.assertEquals(name["count"], 120)
+        self.env.assertEquals(name["nullFraction"], 0)
+        self._assert_distinct(name["distinct"], 11)
+        # Non numeric attributes have no bounds.
+        self.env.assertEquals(name["min"], None)
+        self.env.assertEquals(name["max"], None)
+        self.env.assertEquals(name["histogram"], None)
+
+        q = stats[("Q", "v")]
+        self.env.assertEquals(q["count"], 1)
+        self.env.assertEquals(q["histogram"], [1.5])
+
+    def test02_updated_entities(self):
+        redis_graph.query("MATCH (p:P) WHERE p.v >= 90 SET p.v = NULL")
+        redis_graph.query("MATCH (p:P {name: 'q'}) SET p.w = 1")
+        redis_graph.query("MERGE (p:P {v: 0}) ON MATCH SET p.name = NULL")
+        stats = self._property_stats()
+        self.env.assertEquals(stats[("P", "v")]["count"], 90)
+        self.env.assertAlmostEqual(stats[("P", "v")]["nullFraction"], 30.0 / 120, 0.0001)
+        self.env.assertEquals(stats[("P", "w")]["count"], 20)
+        self.env.assertEquals(stats[("P", "name")]["count"], 119)
+
+    def test03_deleted_entities(self):
+        # Each deleted node is accounted for once.
+        redis_graph.query("MATCH (p:P), (q:P) WHERE p.v < 10 AND q.v < 2 DELETE p, q")
+        redis_graph.query("MATCH (p:P {name: 'q'}) DELETE p")
+        stats = self._property_stats()
+        self.env.assertEquals(stats[("P", "v")]["count"], 80)
+        self.env.assertAlmostEqual(stats[("P", "v")]["nullFraction"], 10.0 / 90, 0.0001)
+        self.env.assertNotIn(("P", "w"), stats)
+        self.env.assertEquals(stats[("P", "name")]["count"], 90)
+
+    def test04_statistics_rebuilt_after_reload(self):
+        redis_con.execute_command("DEBUG", "RELOAD")
+        stats = self._property_stats()
+        v = stats[("P", "v")]
+        self.env.assertEquals(v["count"], 80)
+        self._assert_distinct(v["distinct"], 80)
+        # Rebuilt statistics no longer reflect removed values.
+        self.env.assertEquals(v["min"], 10)
+        self.env.assertEquals(v["max"], 89)
+        self.env.assertNotIn(("P", "w"), stats)
+
+        # Statistics are maintained once rebuilt.
+        redis_graph.query("CREATE (:P {v: 1000})")
+        stats = self._property_stats()
+        self.env.assertEquals(stats[("P", "v")]["count"], 81)
+        self.env.assertEquals(stats[("P", "v")]["max"], 1000)
+
+    def test05_delete_graph(self):
+        redis_graph.delete()
+        self.env.assertEquals(redis_con.exists(GRAPH_ID), 0)
@@ -0,0 +1,52 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "query_memory"
+# Queries may allocate up to 10MB.
+MODULE_ARGS = "QUERY_MEM_CAPACITY 10000000"
+redis_con = None
+redis_graph = None
+
+class testQueryMemory(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(moduleArgs=MODULE_ARGS)
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("UNWIND range(1, 100) AS x CREATE (:N {v: x})")
+
+    def test01_within_capacity(self):
+        result = redis_graph.query("MATCH (n:N) RETURN collect(n.v)")
+        self.env.assertEquals(len(result.result_set[0][0]), 100)
+
+    def test02_exceeding_capacity(self):
+        # Collecting millions of values exceeds the capacity.
+        try:
+            redis_graph.query("UNWIND range(1, 5000000) AS x RETURN collect(x)")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Query's memory consumption exceeded capacity", str(e))
+
+        # Following queries are unaffected.
+        result = redis_graph.query("MATCH (n:N) RETURN count(n)")
+        self.env.assertEquals(result.result_set[0][0], 100)
+
+    def test03_profile_peak_memory(self):
+        profile = redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, "MATCH (n:N) RETURN collect(n.v)")
+        # The plan's root reports the query's peak memory.
+        self.env.assertIn("Peak memory: ", profile[0])
+        peak = int(profile[0].split("Peak memory: ")[1].split(" ")[0])
+        self.env.assertGreater(peak, 0)
+        for line in profile[1:]:
+            self.env.assertNotIn("Peak memory", line)
+
+    def test04_slowlog_peak_memory(self):
+        slowlog = redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID)
+        self.env.assertGreater(len(slowlog), 0)
+        for item in slowlog:
+            self.env.assertEquals(len(item), 5)
+        # Collecting values allocates memory.
+        item = [x for x in slowlog if x[2] == "MATCH (n:N) RETURN collect(n.v)"][0]
+        self.env.assertGreater(item[4], 0)
@@ -0,0 +1,65 @@
+import threading
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "query_queue"
+redis_graph = None
+
+# A single long read thread, with room for a single waiting query.
+MODULE_ARGS = "LONG_READ_THREAD_COUNT 1 MAX_QUEUED_QUERIES 1"
+LONG_QUERY = "MATCH (a:N)-[*]->(b:N) RETURN count(b)"
+
+class testQueryQueue(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(moduleArgs=MODULE_ARGS)
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        # Build a densely connected graph, variable length traversals over it are expensive.
+        redis_graph.query("UNWIND range(0, 30) AS x CREATE (:N {v:x})")
+        redis_graph.query("MATCH (a:N), (b:N) WHERE a.v <> b.v CREATE (a)-[:R]->(b)")
+
+    def _lane_stats(self, lane):
+        res = redis_graph.query("CALL db.threadPoolStats()")
+        header = [h[1] for h in res.header]
+        for row in res.result_set:
+            stats = dict(zip(header, row))
+            if stats["lane"] == lane:
+                return stats
+        return None
+
+    def test01_stats(self):
+        stats = self._lane_stats("long_read")
+        self.env.assertEquals(stats["max_pending"], 1)
+        self.env.assertEquals(stats["pending"], 0)
+        self.env.assertEquals(stats["rejected"], 0)
+        # All lanes are reported.
+        res = redis_graph.query("CALL db.threadPoolStats() YIELD lane RETURN lane ORDER BY lane")
+        self.env.assertEquals(res.result_set, [["long_read"], ["short_read"], ["writer"]])
+
+    def _run(self, errors):
+        con = self.env.getConnection()
+        try:
+            con.execute_command("GRAPH.QUERY", GRAPH_ID, LONG_QUERY, "timeout", 1000)
+        except Exception as e:
+            errors.append(str(e))
+
+    def test02_overflow_rejected(self):
+        errors = []
+        threads = [threading.Thread(target=self._run, args=(errors,)) for i in range(6)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        # With one executing and one waiting query, excess queries are shed.
+        rejections = [e for e in errors if "Max pending queries exceeded" in e]
+        self.env.assertGreater(len(rejections), 0)
+        stats = self._lane_stats("long_read")
+        self.env.assertEquals(stats["rejected"], len(rejections))
+        self.env.assertGreater(stats["scheduled"], 0)
+
+        # Short queries are unaffected.
+        res = redis_graph.query("MATCH (n:N) RETURN count(n)")
+        self.env.assertEquals(res.result_set[0][0], 31)
@@ -0,0 +1,58 @@
+import os
+import sys
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "random_walk"
+redis_con = None
+redis_graph = None
+
+class testRandomWalkFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        # Cycle a -> b -> c -> a, c -> d, d is a dead end, e reached through S only.
+        redis_graph.query("""CREATE (a:L {v:'a'})-[:R]->(b:L {v:'b'})-[:R]->(c:L {v:'c'})-[:R]->(a),
+                             (c)-[:R]->(d:L {v:'d'}), (d)-[:S]->(e:L {v:'e'})""")
+        self.ids = {}
+        for v, i in redis_graph.query("MATCH (n) RETURN n.v, ID(n)").result_set:
+            self.ids[i] = v
+
+    def walks(self, query):
+        return [[self.ids[i] for i in row[0]] for row in redis_graph.query(query).result_set]
+
+    def test01_walks_follow_edges(self):
+        q = """MATCH (a {v:'a'}) CALL algo.randomWalk(a, 10, 20, 'R', 1, 1, 42) YIELD walk RETURN walk"""
+        walks = self.walks(q)
+        self.env.assertEqual(len(walks), 20)
+        successors = {'a': ['b'], 'b': ['c'], 'c': ['a', 'd'], 'd': []}
+        for walk in walks:
+            self.env.assertEqual(walk[0], 'a')
+            for src, dest in zip(walk, walk[1:]):
+                self.env.assertIn(dest, successors[src])
+            # Walks end after length hops or at the dead end.
+            self.env.assertTrue(len(walk) == 11 or walk[-1] == 'd')
+
+    def test02_seeded_walks_are_reproducible(self):
+        q = """CALL algo.randomWalk(NULL, 5, 3, ['R', 'S'], 0.5, 2.0, 7, %d) YIELD walk RETURN walk"""
+        single = self.walks(q % 1)
+        self.env.assertEqual(len(single), 15)
+        self.env.assertEqual(self.walks(q % 4), single)
+
+    def test03_invalid_arguments(self):
+        for q in ["CALL algo.randomWalk(NULL, -1, 1, 'R')",
+                  "CALL algo.randomWalk(NULL, 1, 0, 'R')",
+                  "CALL algo.randomWalk(NULL, 1, 1, 'R', 0)"]:
+            try:
+                redis_graph.query(q)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError as e:
+                self.env.assertIn("Random walk", str(e))
@@ -0,0 +1,64 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "result_cache"
+redis_con = None
+redis_graph = None
+
+class testResultCache(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(moduleArgs="RESULT_CACHE_SIZE 1048576")
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("CREATE (:Person {name:'a', v:1}), (:Person {name:'b', v:2})")
+
+    # Returns the result cache's size, hits and misses.
+    def result_cache_stats(self):
+        res = redis_graph.query("CALL db.resultCacheStats()")
+        return res.result_set[0][:3]
+
+    def test01_cached_result(self):
+        query = "MATCH (p:Person) RETURN p, p.name ORDER BY p.name"
+        size, hits, misses = self.result_cache_stats()
+        expected = redis_graph.query(query).result_set
+        self.env.assertEquals(len(expected), 2)
+        self.env.assertEquals(self.result_cache_stats(), [size + 1, hits, misses + 1])
+
+        actual = redis_graph.query(query).result_set
+        self.env.assertEquals(actual, expected)
+        self.env.assertEquals(self.result_cache_stats(), [size + 1, hits + 1, misses + 1])
+
+        # Parameters are part of the cached query.
+        query = "MATCH (p:Person) WHERE p.v = $v RETURN p.name"
+        self.env.assertEquals(redis_graph.query(query, {'v': 1}).result_set, [['a']])
+        self.env.assertEquals(redis_graph.query(query, {'v': 2}).result_set, [['b']])
+        self.env.assertEquals(redis_graph.query(query, {'v': 1}).result_set, [['a']])
+
+    def test02_invalidated_by_writes(self):
+        query = "MATCH (p:Person) RETURN count(p)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[2]])
+        self.env.assertEquals(redis_graph.query(query).result_set, [[2]])
+
+        redis_graph.query("CREATE (:Person {name:'c', v:3})")
+        self.env.assertEquals(redis_graph.query(query).result_set, [[3]])
+
+        redis_graph.query("MATCH (p:Person {name:'c'}) SET p.v = 4")
+        query = "MATCH (p:Person {name:'c'}) RETURN p.v"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[4]])
+        redis_graph.query("MATCH (p:Person {name:'c'}) SET p.v = 5")
+        self.env.assertEquals(redis_graph.query(query).result_set, [[5]])
+
+    def test03_nondeterministic_queries(self):
+        stats = self.result_cache_stats()
+        query = "UNWIND range(1, 10) AS x RETURN rand()"
+        first = redis_graph.query(query).result_set
+        second = redis_graph.query(query).result_set
+        self.env.assertNotEqual(first, second)
+
+        redis_graph.query("CALL db.labels()")
+        redis_graph.query("CALL db.labels()")
+        # Neither query looked up the cache.
+        self.env.assertEquals(self.result_cache_stats(), stats)
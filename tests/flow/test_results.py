@@ -1,5 +1,7 @@
 import os
 import sys
+import redis
+import struct
 from RLTest import Env
 from redisgraph import Graph, Node, Edge
 
@@ -173,3 +175,156 @@ class testResultSetFlow(FlowTestsBase):
         query = """MATCH (a) return a.val as x, a.val as x LIMIT 1"""
         result = graph.query(query)
         self.env.assertEqual(result.result_set[0][0], result.result_set[0][1])
+
+    # Test decoding records packed into binary column batches.
+    def test09_binary_format(self):
+        # Binary batches aren't valid UTF-8, read them over a connection which doesn't decode replies.
+        kwargs = dict(redis_con.connection_pool.connection_kwargs)
+        kwargs['decode_responses'] = False
+        raw_con = redis.Redis(**kwargs)
+
+        query = """UNWIND range(1, 2000) AS x RETURN x, 'v' + toString(x), x / 2.0, null"""
+        header, batches, stats = raw_con.execute_command("GRAPH.QUERY", "G", query, "--binary")
+        self.env.assertEqual(len(header), 4)
+        # Batches hold up to 1024 records.
+        self.env.assertEqual(len(batches), 2)
+
+        rows = []
+        for batch in batches:
+            row_count, column_count = struct.unpack_from("<II", batch, 0)
+            self.env.assertEqual(column_count, 4)
+            offset = 8
+            columns = []
+            for c in range(column_count):
+                tags = batch[offset:offset + row_count]
+                offset += row_count
+                payload_len = struct.unpack_from("<I", batch, offset)[0]
+                offset += 4
+                payload = batch[offset:offset + payload_len]
+                offset += payload_len
+                values = []
+                pos = 0
+                for tag in tags:
+                    if tag == 3: # Integer.
+                        values.append(struct.unpack_from("<q", payload, pos)[0])
+                        pos += 8
+                    elif tag == 2: # String.
+                        length = struct.unpack_from("<I", payload, pos)[0]
+                        values.append(payload[pos + 4:pos + 4 + length].decode())
+                        pos += 4 + length
+                    elif tag == 5: # Double.
+                        values.append(struct.unpack_from("<d", payload, pos)[0])
+                        pos += 8
+                    else:
+                        self.env.assertEqual(tag, 1) # Null.
+                        values.append(None)
+                self.env.assertEqual(pos, payload_len)
+                columns.append(values)
+            self.env.assertEqual(offset, len(batch))
+            rows.extend(zip(*columns))
+
+        self.env.assertEqual(len(rows), 2000)
+        for x, row in enumerate(rows, 1):
+            self.env.assertEqual(row, (x, "v%d" % x, x / 2.0, None))
+
+        # Nodes are encoded by ID, label IDs and properties.
+        header, batches, stats = raw_con.execute_command("GRAPH.QUERY", "G", "MATCH (n:person {name: 'Roi'}) RETURN n", "--binary")
+        self.env.assertEqual(len(batches), 1)
+        batch = batches[0]
+        row_count, column_count = struct.unpack_from("<II", batch, 0)
+        self.env.assertEqual((row_count, column_count), (1, 1))
+        self.env.assertEqual(batch[8], 8) # Node.
+        node_id, label_count = struct.unpack_from("<qI", batch, 13)
+        self.env.assertEqual(label_count, 1)
+        prop_count = struct.unpack_from("<I", batch, 25 + 4 * label_count)[0]
+        self.env.assertEqual(prop_count, 2)
+
+    def test10_string_dictionary(self):
+        query = """UNWIND range(0, 5) AS x RETURN ['active', 'closed'][x % 2], 'ab', ['active']"""
+        header, rows, stats = redis_con.execute_command("GRAPH.QUERY", "G", query, "--compact-dict")
+        self.env.assertEqual(len(rows), 6)
+        # First occurrences define dictionary entries, later ones reference them.
+        self.env.assertEqual(rows[0][0], [11, "active"])
+        self.env.assertEqual(rows[1][0], [11, "closed"])
+        self.env.assertEqual(rows[2][0], [12, 0])
+        self.env.assertEqual(rows[3][0], [12, 1])
+        # Short strings are emitted in full.
+        self.env.assertEqual(rows[0][1], [2, "ab"])
+        # Array elements share the dictionary.
+        self.env.assertEqual(rows[0][2], [6, [[12, 0]]])
+
+        # Each reply defines its own dictionary.
+        header, rows, stats = redis_con.execute_command("GRAPH.QUERY", "G", "RETURN 'closed'", "--compact-dict")
+        self.env.assertEqual(rows[0][0], [11, "closed"])
+
+    # Decompress a raw LZ4 block.
+    def lz4_decompress(self, block):
+        out = bytearray()
+        pos = 0
+        while pos < len(block):
+            token = block[pos]
+            pos += 1
+            length = token >> 4
+            if length == 15:
+                while True:
+                    length += block[pos]
+                    pos += 1
+                    if block[pos - 1] != 255:
+                        break
+            out += block[pos:pos + length]
+            pos += length
+            if pos == len(block):
+                break
+            offset = block[pos] | (block[pos + 1] << 8)
+            pos += 2
+            length = token & 15
+            if length == 15:
+                while True:
+                    length += block[pos]
+                    pos += 1
+                    if block[pos - 1] != 255:
+                        break
+            for _ in range(length + 4):
+                out.append(out[-offset])
+        return bytes(out)
+
+    def test11_compressed_batches(self):
+        kwargs = dict(redis_con.connection_pool.connection_kwargs)
+        kwargs['decode_responses'] = False
+        raw_con = redis.Redis(**kwargs)
+
+        query = """UNWIND range(1, 2000) AS x RETURN x, 'status' + toString(x % 3)"""
+        header, batches, stats = raw_con.execute_command("GRAPH.QUERY", "G", query, "--binary")
+        compressed_header, compressed, stats = raw_con.execute_command("GRAPH.QUERY", "G", query, "--compress", "lz4")
+        self.env.assertEqual(compressed_header, header)
+        self.env.assertEqual(len(compressed), len(batches))
+
+        # Each compressed batch is prefixed by its uncompressed length.
+        for batch, data in zip(batches, compressed):
+            length = struct.unpack_from("<I", data, 0)[0]
+            self.env.assertEqual(length, len(batch))
+            self.env.assertLess(len(data), len(batch))
+            self.env.assertEqual(self.lz4_decompress(data[4:]), batch)
+
+        try:
+            redis_con.execute_command("GRAPH.QUERY", "G", query, "--compress", "gzip")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("Unsupported reply compression", str(e))
+
+    def test12_verbose_repeated_entities(self):
+        # Verbose replies replay the formatting of entities returned repeatedly.
+        query = """MATCH (a:person {name: 'Roi'})-[e:know]->(b:person) RETURN a, e, b, a.val ORDER BY b.name"""
+        header, rows, stats = redis_con.execute_command("GRAPH.QUERY", "G", query)
+        self.env.assertEquals(len(rows), 3)
+        for row in rows:
+            self.env.assertEquals(row[0], rows[0][0])
+            self.env.assertEquals(row[0][2], ['properties', [['name', 'Roi'], ['val', 0]]])
+            self.env.assertEquals(row[1][4][1], [])
+        self.env.assertNotEqual(rows[0][2], rows[1][2])
+
+        # Modified entities are formatted anew.
+        query = """MATCH (a:person {name: 'Roi'}) SET a.val = 1.5 RETURN a"""
+        header, rows, stats = redis_con.execute_command("GRAPH.QUERY", "G", query)
+        self.env.assertEquals(rows[0][0][2], ['properties', [['name', 'Roi'], ['val', '1.5']]])
+        graph.query("MATCH (a:person {name: 'Roi'}) SET a.val = 0")
@@ -0,0 +1,45 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "ro_query"
+redis_con = None
+redis_graph = None
+
+class testReadOnlyQuery(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("CREATE (:Person {v:1})")
+
+    def test01_read_only_query(self):
+        res = redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, "MATCH (p:Person) RETURN p.v")
+        self.env.assertEquals(res[1], [[1]])
+
+    def test02_reject_writes(self):
+        queries = ["CREATE (:Person {v:2})",
+                   "MATCH (p:Person) SET p.v = 2",
+                   "MATCH (p:Person) DELETE p",
+                   "CREATE INDEX ON :Person(v)"]
+        for q in queries:
+            try:
+                redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, q)
+                self.env.assertTrue(False)
+            except Exception as e:
+                self.env.assertIn("only supports read-only queries", str(e))
+
+        # Graph wasn't modified.
+        res = redis_graph.query("MATCH (p:Person) RETURN p.v")
+        self.env.assertEquals(res.result_set, [[1]])
+
+    def test03_missing_graph(self):
+        try:
+            redis_con.execute_command("GRAPH.RO_QUERY", "missing_graph", "RETURN 1")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Graph is either missing", str(e))
+        # Graph key wasn't created.
+        self.env.assertEquals(redis_con.exists("missing_graph"), 0)
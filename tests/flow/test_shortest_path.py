@@ -0,0 +1,73 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "shortest_path"
+redis_graph = None
+
+class testShortestPath(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # Two shortest paths from a to e through d, a longer one through x, y and z,
+        # and a direct relationship of a different type.
+        query = """CREATE (a:N {v: 'a'}), (b:N {v: 'b'}), (c:N {v: 'c'}), (d:N {v: 'd'}), (e:N {v: 'e'}),
+                   (x:N {v: 'x'}), (y:N {v: 'y'}), (z:N {v: 'z'}),
+                   (a)-[:R]->(b), (a)-[:R]->(c), (b)-[:R]->(d), (c)-[:R]->(d), (d)-[:R]->(e),
+                   (a)-[:R]->(x), (x)-[:R]->(y), (y)-[:R]->(z), (z)-[:R]->(e), (a)-[:S]->(e)"""
+        redis_graph.query(query)
+
+    def _path_nodes(self, pattern, single=True):
+        func = "shortestPath" if single else "allShortestPaths"
+        query = "MATCH (a:N {v: 'a'}), (e:N {v: 'e'}) MATCH p = %s(%s) RETURN [n IN nodes(p) | n.v]" % (func, pattern)
+        return sorted(row[0] for row in redis_graph.query(query).result_set)
+
+    def test01_shortest_path(self):
+        result = self._path_nodes("(a)-[:R*]->(e)")
+        self.env.assertEquals(len(result), 1)
+        self.env.assertIn(result[0], [['a', 'b', 'd', 'e'], ['a', 'c', 'd', 'e']])
+
+        query = "MATCH (a:N {v: 'a'}), (e:N {v: 'e'}) MATCH p = shortestPath((a)-[:R*]->(e)) RETURN length(p), size(relationships(p))"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[3, 3]])
+
+    def test02_all_shortest_paths(self):
+        result = self._path_nodes("(a)-[:R*]->(e)", single=False)
+        self.env.assertEquals(result, [['a', 'b', 'd', 'e'], ['a', 'c', 'd', 'e']])
+
+    def test03_relationship_types(self):
+        self.env.assertEquals(self._path_nodes("(a)-[:S*]->(e)"), [['a', 'e']])
+        self.env.assertEquals(self._path_nodes("(a)-[*]->(e)", single=False), [['a', 'e']])
+        self.env.assertEquals(self._path_nodes("(a)-[:Missing*]->(e)"), [])
+
+    def test04_direction(self):
+        self.env.assertEquals(self._path_nodes("(e)-[:R*]->(a)"), [])
+        self.env.assertEquals(self._path_nodes("(e)<-[:R*]-(a)", single=False), [['e', 'd', 'b', 'a'], ['e', 'd', 'c', 'a']])
+        self.env.assertEquals(self._path_nodes("(e)-[:R*]-(a)", single=False), [['e', 'd', 'b', 'a'], ['e', 'd', 'c', 'a']])
+
+    def test05_length_limits(self):
+        self.env.assertEquals(self._path_nodes("(a)-[:R*..2]->(e)"), [])
+        self.env.assertEquals(len(self._path_nodes("(a)-[:R*..3]->(e)", single=False)), 2)
+        self.env.assertEquals(self._path_nodes("(a)-[:R*0..]->(a)"), [['a']])
+        self.env.assertEquals(self._path_nodes("(a)-[:R*]->(a)"), [])
+
+    def test06_unbound_destination(self):
+        # Shortest paths lead to every reachable node.
+        query = "MATCH (a:N {v: 'a'}) MATCH p = shortestPath((a)-[:R*]->(n)) RETURN n.v, length(p) ORDER BY n.v"
+        expected = [['b', 1], ['c', 1], ['d', 2], ['e', 3], ['x', 1], ['y', 2], ['z', 3]]
+        self.env.assertEquals(redis_graph.query(query).result_set, expected)
+
+    def test07_invalid_patterns(self):
+        queries = ["MATCH (a:N {v: 'a'}), (e:N {v: 'e'}) MATCH p = shortestPath((a)-[:R*2..]->(e)) RETURN p",
+                   "MATCH (a:N {v: 'a'}), (e:N {v: 'e'}) MATCH p = shortestPath((a)-[:R*]->()-[:R*]->(e)) RETURN p",
+                   "MATCH (a:N {v: 'a'}), (e:N {v: 'e'}) CREATE p = shortestPath((a)-[:R]->(e))"]
+        for query in queries:
+            try:
+                redis_graph.query(query)
+                self.env.assertTrue(False)
+            except Exception:
+                pass
@@ -41,3 +41,39 @@ class testSlowLog(FlowTestsBase):
         B = redis_con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID)
 
         self.env.assertNotEqual(A, B)
+
+    def test_slowlog_entry(self):
+        redis_con.flushall()
+        redis_graph.query("""CREATE (:L {v:1}), (:L {v:2})""")
+
+        # Executions differing only by their parameters share an entry.
+        redis_graph.query("""CYPHER v=1 MATCH (n:L {v:$v}) RETURN n""")
+        redis_graph.query("""CYPHER v=2 MATCH (n:L {v:$v}) RETURN n""")
+        redis_graph.query("""MATCH (n:L) RETURN n""")
+
+        slowlog = redis_con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID)
+        self.env.assertEquals(len(slowlog), 3)
+
+        for item in slowlog:
+            self.env.assertEquals(len(item), 13)
+            item = [v.decode() if isinstance(v, bytes) else v for v in item]
+            query = item[2]
+            lock_wait = float(item[5])
+            rows = item[6]
+            params_hash = item[7]
+            plan_fingerprint = item[8]
+            self.env.assertGreaterEqual(lock_wait, 0)
+            # Latency breakdown, lock wait, matrix sync, execution and reply add up to the latency.
+            latency = float(item[3])
+            breakdown = [float(v) for v in item[9:]]
+            for v in breakdown:
+                self.env.assertGreaterEqual(v, 0)
+            self.env.assertLessEqual(lock_wait + sum(breakdown[1:]), latency * 1.01 + 0.01)
+            if query.startswith("CYPHER"):
+                self.env.assertEquals(rows, 1)
+                self.env.assertNotEqual(params_hash, "0000000000000000")
+                self.env.assertNotEqual(plan_fingerprint, "0000000000000000")
+            elif query.startswith("MATCH"):
+                self.env.assertEquals(rows, 2)
+                self.env.assertEquals(params_hash, "0000000000000000")
+                self.env.assertNotEqual(plan_fingerprint, "0000000000000000")
@@ -0,0 +1,59 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "sort_spill"
+# Sorts spill a run to disk every few kilobytes of buffered records.
+MODULE_ARGS = "SORT_SPILL_THRESHOLD 20000"
+NODE_COUNT = 5000
+redis_graph = None
+
+class testSortSpill(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(moduleArgs=MODULE_ARGS)
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # Values are scrambled so that every run holds a mix of them.
+        query = """UNWIND range(0, %d) AS x
+                   CREATE (:N {v: (x * 7919) %% %d, s: 'name' + toString((x * 104729) %% %d), g: x %% 10})""" % (NODE_COUNT - 1, NODE_COUNT, NODE_COUNT)
+        redis_graph.query(query)
+        redis_graph.query("MATCH (a:N), (b:N) WHERE b.v = a.v + 1 AND a.v < 100 CREATE (a)-[:R {w: a.v}]->(b)")
+
+    def test01_scalars(self):
+        query = "MATCH (n:N) RETURN n.v, n.s ORDER BY n.v DESC"
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals([row[0] for row in result], list(range(NODE_COUNT - 1, -1, -1)))
+
+        query = "MATCH (n:N) RETURN n.s ORDER BY n.s"
+        result = [row[0] for row in redis_graph.query(query).result_set]
+        self.env.assertEquals(result, sorted('name' + str(i) for i in range(NODE_COUNT)))
+
+    def test02_multiple_keys(self):
+        query = "MATCH (n:N) RETURN n.g, n.v ORDER BY n.g DESC, n.v"
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals(len(result), NODE_COUNT)
+        self.env.assertEquals(result, sorted(result, key=lambda row: (-row[0], row[1])))
+
+    def test03_entities(self):
+        # Nodes, relationships, lists and paths survive the round trip.
+        query = "MATCH (n:N) RETURN n, n.v, [n.v, n.s] ORDER BY n.v"
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals([row[1] for row in result], list(range(NODE_COUNT)))
+        for row in result:
+            self.env.assertEquals(row[0].properties['v'], row[1])
+            self.env.assertEquals(row[2], [row[1], row[0].properties['s']])
+
+        query = "MATCH p = (a:N)-[e:R]->(b:N) RETURN e.w, e, b.v, length(p), p ORDER BY e.w DESC"
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals([row[0] for row in result], list(range(99, -1, -1)))
+        for row in result:
+            self.env.assertEquals(row[1].properties['w'], row[0])
+            self.env.assertEquals(row[2], row[0] + 1)
+            self.env.assertEquals(row[3], 1)
+
+        query = "MATCH (n:N) WITH n ORDER BY n.v RETURN collect(n.v)[0..5]"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[[0, 1, 2, 3, 4]]])
@@ -0,0 +1,60 @@
+import os
+import sys
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "sssp"
+redis_graph = None
+
+class testSSSPFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        # a -> b -> c is shorter than a -> c, parallel edges b -> d keep the lightest.
+        redis_graph.query("""CREATE (a:City {name:'a'}), (b:City {name:'b'}), (c:City {name:'c'}),
+                             (d:City {name:'d'}), (e:City {name:'e'}), (f:City {name:'f'}),
+                             (a)-[:ROAD {km:1}]->(b), (b)-[:ROAD {km:2}]->(c), (a)-[:ROAD {km:10}]->(c),
+                             (b)-[:ROAD {km:7}]->(d), (b)-[:ROAD {km:4.5}]->(d), (c)-[:ROAD {km:0}]->(e),
+                             (e)-[:ROAD]->(f), (d)-[:RAIL {km:1}]->(f)""")
+
+    def sssp(self, q):
+        return redis_graph.query(q).result_set
+
+    def test01_distances(self):
+        q = """MATCH (a:City {name:'a'}) CALL algo.SSSP(a, 'ROAD', 'km') YIELD node, distance
+               RETURN node.name, distance"""
+        expected = [['a', 0.0], ['b', 1.0], ['c', 3.0], ['e', 3.0], ['d', 5.5]]
+        self.env.assertEqual(self.sssp(q), expected)
+
+        # Distances don't depend on bucket width.
+        for delta in [0.5, 1, 3, 100]:
+            q = """MATCH (a:City {name:'a'}) CALL algo.SSSP(a, 'ROAD', 'km', %s) YIELD node, distance
+                   RETURN node.name, distance""" % delta
+            self.env.assertEqual(self.sssp(q), expected)
+
+    def test02_unknown_relationship(self):
+        q = """MATCH (a:City {name:'a'}) CALL algo.SSSP(a, 'FLIGHT', 'km') YIELD node, distance
+               RETURN node.name, distance"""
+        self.env.assertEqual(self.sssp(q), [['a', 0.0]])
+
+    def test03_invalidated_by_writes(self):
+        q = """MATCH (a:City {name:'a'}) CALL algo.SSSP(a, 'ROAD', 'km') YIELD node, distance
+               WITH node, distance WHERE node.name = 'd' RETURN distance"""
+        self.env.assertEqual(self.sssp(q), [[5.5]])
+        redis_graph.query("MATCH (a:City {name:'a'}), (d:City {name:'d'}) CREATE (a)-[:ROAD {km:2}]->(d)")
+        self.env.assertEqual(self.sssp(q), [[2.0]])
+
+    def test04_negative_weights(self):
+        redis_graph.query("MATCH (a:City {name:'a'}), (f:City {name:'f'}) CREATE (a)-[:ROAD {km:-1}]->(f)")
+        try:
+            redis_graph.query("MATCH (a:City {name:'a'}) CALL algo.SSSP(a, 'ROAD', 'km') YIELD node RETURN node")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("negative weights", str(e))
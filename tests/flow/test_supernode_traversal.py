@@ -0,0 +1,57 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "supernode_traversal"
+redis_graph = None
+
+# Exceeds the degree from which sources are traversed on their own.
+HUB_DEGREE = 70000
+
+class testSupernodeTraversal(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # A hub connected to every leaf and to a few rare nodes,
+        # and a handful of small nodes each connected to a single leaf.
+        redis_graph.query("CREATE (:Hub {v: 0})")
+        redis_graph.query("UNWIND range(1, %d) AS i CREATE (:Leaf {v: i})" % (HUB_DEGREE - 10))
+        redis_graph.query("UNWIND range(1, 10) AS i CREATE (:Rare {v: i})")
+        redis_graph.query("MATCH (h:Hub), (l:Leaf) CREATE (h)-[:R]->(l)")
+        redis_graph.query("MATCH (h:Hub), (l:Rare) CREATE (h)-[:R]->(l)")
+        redis_graph.query("UNWIND range(1, 5) AS i MATCH (l:Leaf {v: i}) CREATE (:Small {v: i})-[:R]->(l)")
+
+    def test01_hub_neighbors(self):
+        query = "MATCH (:Hub)-[:R]->(l) RETURN count(l)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[HUB_DEGREE]])
+
+        last = HUB_DEGREE - 10
+        query = "MATCH (h:Hub)-[:R]->(l:Leaf) WHERE l.v > %d RETURN l.v ORDER BY l.v" % (last - 3)
+        expected = [[last - 2], [last - 1], [last]]
+        self.env.assertEquals(redis_graph.query(query).result_set, expected)
+
+    def test02_labeled_destinations(self):
+        # The rare label holds fewer nodes than the hub's degree.
+        query = "MATCH (:Hub)-[:R]->(l:Rare) RETURN count(l)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[10]])
+
+        query = "MATCH (:Hub)-[:R]->(l:Missing) RETURN count(l)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[0]])
+
+    def test03_mixed_sources(self):
+        # Hub and small sources share batches.
+        query = "MATCH (s)-[:R]->(l:Leaf) WHERE l.v <= 5 RETURN s.v, count(l) ORDER BY s.v"
+        expected = [[0, 5], [1, 1], [2, 1], [3, 1], [4, 1], [5, 1]]
+        self.env.assertEquals(redis_graph.query(query).result_set, expected)
+
+        query = "MATCH (s)-[e:R]->(l) RETURN count(e)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[HUB_DEGREE + 5]])
+
+    def test04_incoming(self):
+        query = "MATCH (l:Leaf {v: 3})<-[:R]-(s) RETURN count(s)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[2]])
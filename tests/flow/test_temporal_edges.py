@@ -0,0 +1,124 @@
+import random
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "temporal_edges"
+redis_con = None
+redis_graph = None
+
+
+class testTemporalEdges(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("CALL db.temporal.edge.set('WORKS_AT', 'since', 'until')")
+        redis_graph.query("""CREATE (ann:Person {name: 'Ann'}), (bob:Person {name: 'Bob'}),
+                                    (a:Company {name: 'A'}), (b:Company {name: 'B'}), (c:Company {name: 'C'}),
+                                    (ann)-[:WORKS_AT {since: 100, until: 200}]->(a),
+                                    (ann)-[:WORKS_AT {since: 200, until: 300}]->(b),
+                                    (ann)-[:WORKS_AT {since: 250}]->(c),
+                                    (bob)-[:WORKS_AT {until: 150}]->(a),
+                                    (bob)-[:WORKS_AT {since: 120, until: 120}]->(b),
+                                    (bob)-[:WORKS_AT {since: 'unknown', until: 400.5}]->(c)""")
+
+    def expand(self, t):
+        query = """MATCH (p:Person) CALL db.temporal.expand(p, 'WORKS_AT', %d) YIELD node
+                   RETURN p.name, node.name ORDER BY p.name, node.name""" % t
+        return redis_graph.query(query).result_set
+
+    def test01_as_of(self):
+        self.env.assertEquals(self.expand(99), [['Bob', 'A'], ['Bob', 'C']])
+        self.env.assertEquals(self.expand(120), [['Ann', 'A'], ['Bob', 'A'], ['Bob', 'C']])
+        # Intervals include their start and exclude their end.
+        self.env.assertEquals(self.expand(200), [['Ann', 'B'], ['Bob', 'C']])
+        self.env.assertEquals(self.expand(260), [['Ann', 'B'], ['Ann', 'C'], ['Bob', 'C']])
+        # Fractional ends are rounded up.
+        self.env.assertEquals(self.expand(400), [['Ann', 'C'], ['Bob', 'C']])
+        self.env.assertEquals(self.expand(401), [['Ann', 'C']])
+
+    def test02_yields_edges(self):
+        query = """MATCH (p:Person {name: 'Ann'}) CALL db.temporal.expand(p, 'WORKS_AT', 150) YIELD edge
+                   RETURN type(edge), edge.since, endNode(edge).name"""
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [['WORKS_AT', 100, 'A']])
+
+    def test03_writes_invalidate(self):
+        redis_graph.query("MATCH (p:Person {name: 'Bob'}), (b:Company {name: 'B'}) CREATE (p)-[:WORKS_AT {since: 500}]->(b)")
+        self.env.assertEquals(self.expand(500), [['Ann', 'C'], ['Bob', 'B']])
+        redis_graph.query("MATCH (:Person {name: 'Ann'})-[e:WORKS_AT]->(:Company {name: 'C'}) SET e.until = 500")
+        self.env.assertEquals(self.expand(500), [['Bob', 'B']])
+
+    def test04_persisted(self):
+        redis_con.execute_command("DEBUG", "RELOAD")
+        self.env.assertEquals(self.expand(500), [['Bob', 'B']])
+
+    def test05_errors(self):
+        redis_graph.query("CREATE (:Person)-[:KNOWS]->(:Person)")
+        try:
+            redis_graph.query("MATCH (p:Person) CALL db.temporal.expand(p, 'KNOWS', 0) YIELD node RETURN node")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Relationship type KNOWS has no interval index", str(e))
+
+        # Unknown relationship types have no edges.
+        query = "MATCH (p:Person) CALL db.temporal.expand(p, 'NOSUCH', 0) YIELD node RETURN count(node)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[0]])
+
+        # Dropping the index.
+        redis_graph.query("CALL db.temporal.edge.set('WORKS_AT', NULL, NULL)")
+        try:
+            self.expand(500)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("has no interval index", str(e))
+
+    def test06_interleaved_writes(self):
+        # Lookups interleaved with edge writes agree with a full scan of the relation.
+        redis_graph.query("CALL db.temporal.edge.set('MEMBER_OF', 'since', 'until')")
+        redis_graph.query("UNWIND range(0, 19) AS i CREATE (:Member {id: i}), (:Club {id: i})")
+
+        def expand(t):
+            query = """MATCH (p:Member) CALL db.temporal.expand(p, 'MEMBER_OF', %d) YIELD edge, node
+                       RETURN p.id, node.id, ID(edge) ORDER BY p.id, node.id, ID(edge)""" % t
+            return redis_graph.query(query).result_set
+
+        def scan(t):
+            query = """MATCH (p:Member)-[e:MEMBER_OF]->(node:Club)
+                       WHERE (e.since IS NULL OR e.since <= %d) AND (e.until IS NULL OR e.until > %d)
+                       RETURN p.id, node.id, ID(e) ORDER BY p.id, node.id, ID(e)""" % (t, t)
+            return redis_graph.query(query).result_set
+
+        def edge_count():
+            return redis_graph.query("MATCH ()-[e:MEMBER_OF]->() RETURN count(e)").result_set[0][0]
+
+        random.seed(144)
+        for _ in range(300):
+            op = random.randint(0, 9)
+            if op < 5 or edge_count() == 0:
+                # Parallel edges are created as well.
+                since = random.randint(0, 100)
+                until = since + random.randint(1, 50) if random.randint(0, 3) > 0 else None
+                props = "{since: %d, until: %d}" % (since, until) if until else "{since: %d}" % since
+                query = """MATCH (p:Member {id: %d}), (c:Club {id: %d})
+                           CREATE (p)-[:MEMBER_OF %s]->(c)""" % (random.randint(0, 19), random.randint(0, 19), props)
+                redis_graph.query(query)
+            elif op < 7:
+                query = """MATCH ()-[e:MEMBER_OF]->() WITH e ORDER BY ID(e) SKIP %d LIMIT 1
+                           DELETE e""" % random.randint(0, edge_count() - 1)
+                redis_graph.query(query)
+            elif op < 9:
+                query = """MATCH ()-[e:MEMBER_OF]->() WITH e ORDER BY ID(e) SKIP %d LIMIT 1
+                           SET e.until = %d""" % (random.randint(0, edge_count() - 1), random.randint(0, 150))
+                redis_graph.query(query)
+            else:
+                # Deleted members are replaced, reusing their node IDs.
+                member = random.randint(0, 19)
+                redis_graph.query("MATCH (p:Member {id: %d}) DETACH DELETE p" % member)
+                redis_graph.query("CREATE (:Member {id: %d})" % member)
+
+            t = random.randint(0, 150)
+            self.env.assertEquals(expand(t), scan(t))
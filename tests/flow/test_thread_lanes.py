@@ -0,0 +1,105 @@
+import time
+import threading
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "thread_lanes"
+redis_graph = None
+
+# Few threads per lane, an expensive read must not delay queries scheduled on other lanes.
+MODULE_ARGS = "THREAD_COUNT 1 WRITER_THREAD_COUNT 2 LONG_READ_THREAD_COUNT 1"
+
+class testThreadLanes(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(moduleArgs=MODULE_ARGS)
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        # Build a densely connected graph, variable length traversals over it are expensive.
+        redis_graph.query("UNWIND range(0, 30) AS x CREATE (:N {v:x})")
+        redis_graph.query("MATCH (a:N), (b:N) WHERE a.v <> b.v CREATE (a)-[:R]->(b)")
+
+    def _long_read(self):
+        con = self.env.getConnection()
+        try:
+            con.execute_command("GRAPH.QUERY", GRAPH_ID, "MATCH (a:N)-[*]->(b:N) RETURN count(b)", "timeout", 2000)
+        except Exception:
+            pass
+
+    def test01_short_read_not_delayed_by_long_read(self):
+        long_read = threading.Thread(target=self._long_read)
+        long_read.start()
+        # Give the long read a head start.
+        time.sleep(0.2)
+
+        start = time.time()
+        res = redis_graph.query("MATCH (n:N) RETURN count(n)")
+        elapsed = time.time() - start
+        long_read.join()
+
+        self.env.assertEquals(res.result_set[0][0], 31)
+        self.env.assertLess(elapsed, 1.5)
+
+    def test02_writes_and_reads(self):
+        res = redis_graph.query("CREATE (:M {v:1})")
+        self.env.assertEquals(res.nodes_created, 1)
+        res = redis_graph.query("MATCH (m:M) RETURN m.v")
+        self.env.assertEquals(res.result_set[0][0], 1)
+        res = redis_graph.query("MATCH (m:M) SET m.v = 2 RETURN m.v")
+        self.env.assertEquals(res.result_set[0][0], 2)
+
+    def test03_slowlog_tracks_all_lanes(self):
+        # Queries executed on every lane are recorded.
+        con = self.env.getConnection()
+        graph = Graph("thread_lanes_slowlog", con)
+        graph.query("CREATE (:M {v:3})")
+        graph.query("MATCH (n:M)-[*1..2]->(m) RETURN count(m)")
+        graph.query("MATCH (n:M) RETURN n.v")
+        slowlog = con.execute_command("GRAPH.SLOWLOG", "thread_lanes_slowlog")
+        queries = [entry[2] for entry in slowlog]
+        self.env.assertIn("CREATE (:M {v:3})", queries)
+        self.env.assertIn("MATCH (n:M)-[*1..2]->(m) RETURN count(m)", queries)
+        self.env.assertIn("MATCH (n:M) RETURN n.v", queries)
+
+    def test04_concurrent_writers_on_disjoint_graphs(self):
+        # Writers on different graphs run side by side on the writer lane.
+        def write(graph_id):
+            con = self.env.getConnection()
+            graph = Graph(graph_id, con)
+            for i in range(20):
+                graph.query("CREATE (:T {v:%d})" % i)
+
+        graph_ids = ["tenant_%d" % i for i in range(8)]
+        threads = [threading.Thread(target=write, args=(graph_id,)) for graph_id in graph_ids]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        con = self.env.getConnection()
+        for graph_id in graph_ids:
+            res = Graph(graph_id, con).query("MATCH (t:T) RETURN count(t)")
+            self.env.assertEquals(res.result_set[0][0], 20)
+
+    def _writer_scheduled(self):
+        res = redis_graph.query("CALL db.threadPoolStats() YIELD lane, scheduled")
+        return [row[1] for row in res.result_set if row[0] == "writer"][0]
+
+    def test05_procedure_calls_lanes(self):
+        # Calls to procedures which modify the graph are scheduled on the writer lane.
+        scheduled = self._writer_scheduled()
+        redis_graph.query("CALL db.idx.fulltext.createNodeIndex('N', 'name')")
+        self.env.assertEquals(self._writer_scheduled(), scheduled + 1)
+
+        # Unknown procedures are assumed to modify the graph.
+        try:
+            redis_graph.query("CALL db.noSuchProcedure()")
+            self.env.assertTrue(False)
+        except Exception:
+            pass
+        self.env.assertEquals(self._writer_scheduled(), scheduled + 2)
+
+        # Read-only procedures are not.
+        redis_graph.query("CALL db.labels()")
+        self.env.assertEquals(self._writer_scheduled(), scheduled + 2)
@@ -0,0 +1,62 @@
+import time
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "timeout"
+redis_con = None
+redis_graph = None
+
+class testQueryTimeout(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        # Build a densely connected graph, variable length traversals over it are expensive.
+        redis_graph.query("UNWIND range(0, 30) AS x CREATE (:N {v:x})")
+        redis_graph.query("MATCH (a:N), (b:N) WHERE a.v <> b.v CREATE (a)-[:R]->(b)")
+
+    def test01_timeout(self):
+        query = "MATCH (a:N)-[*]->(b:N) RETURN count(b)"
+        try:
+            redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, query, "timeout", 10)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Query timed out", str(e))
+
+    def test02_query_within_timeout(self):
+        res = redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "MATCH (a:N) RETURN count(a)", "timeout", 1000)
+        self.env.assertEquals(res[1], [[31]])
+
+    def test03_invalid_timeout(self):
+        try:
+            redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "RETURN 1", "timeout", "abc")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Failed to parse query timeout", str(e))
+
+    def test04_client_released(self):
+        # The client is released around the timeout, whether the query reached a timeout check or not.
+        query = "MATCH (a:N)-[*]->(b:N) RETURN b.v"
+        start = time.time()
+        try:
+            redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, query, "timeout", 50)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("Query timed out", str(e))
+        self.env.assertLess(time.time() - start, 5)
+
+        # The connection serves further queries.
+        res = redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, "MATCH (a:N) RETURN count(a)")
+        self.env.assertEquals(res[1], [[31]])
+
+    def test05_committed_write_not_timed_out(self):
+        # Operations following a write's commit don't abort the committed write.
+        query = """CREATE (c:Committed {v: 1}) WITH c UNWIND range(1, 3000000) AS x
+                   WITH c, x WHERE x = 3000000 RETURN c.v"""
+        res = redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, query, "timeout", 10)
+        self.env.assertEquals(res[1], [[1]])
+        res = redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "MATCH (c:Committed) RETURN count(c)")
+        self.env.assertEquals(res[1], [[1]])
@@ -0,0 +1,103 @@
+import redis
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "trace_test"
+TRACE_ID = "4bf92f3577b34da6a3ce929d0e0e4736"
+PARENT_ID = "00f067aa0ba902b7"
+redis_con = None
+redis_graph = None
+
+def decode(v):
+    return v.decode() if isinstance(v, bytes) else v
+
+class testTrace(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:N {v: x})")
+
+    def drain(self):
+        spans = redis_con.execute_command("GRAPH.TRACE", "DRAIN")
+        return [[decode(v) for v in span] for span in spans]
+
+    def test01_untraced_query(self):
+        # Queries issued without a trace context record no spans.
+        self.drain()
+        redis_graph.query("MATCH (n:N) RETURN n.v")
+        self.env.assertEquals(self.drain(), [])
+
+    def test02_traced_query(self):
+        redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "MATCH (n:N) WHERE n.v > 5 RETURN n.v", "trace", TRACE_ID)
+        spans = self.drain()
+        names = [span[3] for span in spans]
+        for name in ["query", "parse", "validate", "lock_wait", "plan", "execute", "reply", "Results", "Filter", "Node By Label Scan"]:
+            self.env.assertIn(name, names)
+
+        by_name = {span[3]: span for span in spans}
+        root = by_name["query"]
+        # Root span has no parent and reports the number of replied records.
+        self.env.assertEquals(root[2], None)
+        self.env.assertEquals(root[6], 5)
+
+        for span in spans:
+            self.env.assertEquals(span[0], TRACE_ID)
+            self.env.assertGreaterEqual(float(span[5]), 0)
+
+        # Phases are children of the root span, operations are children of the execution span.
+        for name in ["parse", "validate", "lock_wait", "plan", "execute", "reply"]:
+            self.env.assertEquals(by_name[name][2], root[1])
+        for name in ["Results", "Filter", "Node By Label Scan"]:
+            self.env.assertEquals(by_name[name][2], by_name["execute"][1])
+        self.env.assertEquals(by_name["Filter"][6], 5)
+
+    def test03_traceparent(self):
+        # The root span of a query traced with a traceparent is a child of the caller's span.
+        traceparent = "00-%s-%s-01" % (TRACE_ID, PARENT_ID)
+        redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "CREATE (:N {v: 11})", "trace", traceparent)
+        spans = self.drain()
+        by_name = {span[3]: span for span in spans}
+        self.env.assertEquals(by_name["query"][2], PARENT_ID)
+        self.env.assertIn("commit_lock_wait", by_name)
+
+    def test04_invalid_trace_context(self):
+        for context in ["abc", "0" * 32, "zz" * 16, "00-%s-%s-01" % (TRACE_ID, "0" * 16)]:
+            try:
+                redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "MATCH (n) RETURN n", "trace", context)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError as e:
+                self.env.assertIn("Invalid trace context", str(e))
+
+    def test05_drain_count(self):
+        redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "MATCH (n:N) RETURN count(n)", "trace", TRACE_ID)
+        stats = redis_con.execute_command("GRAPH.TRACE", "STATS")
+        buffered = stats[3]
+        self.env.assertGreater(buffered, 1)
+
+        spans = redis_con.execute_command("GRAPH.TRACE", "DRAIN", 1)
+        self.env.assertEquals(len(spans), 1)
+        self.env.assertEquals(len(self.drain()), buffered - 1)
+
+    def test06_traced_prepared_query(self):
+        # Prepared queries accept a trace context like any other query.
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "MATCH (n:N) WHERE n.v > $v RETURN n.v")
+        self.drain()
+        res = redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, "CYPHER v=8", "trace", TRACE_ID)
+        self.env.assertEquals(len(res[1]), 3)
+        spans = self.drain()
+        names = [span[3] for span in spans]
+        for name in ["query", "execute", "reply", "Filter"]:
+            self.env.assertIn(name, names)
+        for span in spans:
+            self.env.assertEquals(span[0], TRACE_ID)
+
+        # Without parameters the trace context directly follows the handle.
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "MATCH (n:N) RETURN count(n)")
+        redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, "trace", TRACE_ID)
+        names = [span[3] for span in self.drain()]
+        self.env.assertIn("query", names)
@@ -0,0 +1,59 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "transposed_relations"
+redis_con = None
+redis_graph = None
+
+class testTransposedRelations(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # (:A {v:0})<-[:R]-(:B {v:1..5}), (:A)<-[:S]-(:B {v:1})
+        redis_graph.query("CREATE (:A {v:0})")
+        redis_graph.query("UNWIND range(1, 5) AS x MATCH (a:A) CREATE (a)<-[:R]-(:B {v:x})")
+        redis_graph.query("MATCH (a:A), (b:B {v:1}) CREATE (a)<-[:S]-(b)")
+
+    def _incoming(self, reltype):
+        query = "MATCH (a:A)<-[:%s]-(b) RETURN b.v ORDER BY b.v" % reltype
+        return redis_graph.query(query).result_set
+
+    def test01_incoming_traversal(self):
+        self.env.assertEquals(self._incoming("R"), [[1], [2], [3], [4], [5]])
+        self.env.assertEquals(self._incoming("S"), [[1]])
+        self.env.assertEquals(self._incoming("R|S"), [[1], [1], [2], [3], [4], [5]])
+        self.env.assertEquals(self._incoming("Missing"), [])
+
+    def test02_incoming_traversal_after_updates(self):
+        # Transposed matrices are maintained by creations and deletions.
+        redis_graph.query("MATCH (a:A), (b:B {v:5}) CREATE (a)<-[:R]-(b)")
+        redis_graph.query("MATCH (a:A) CREATE (a)<-[:R]-(:B {v:6})")
+        redis_graph.query("MATCH (:A)<-[e:R]-(b:B) WHERE b.v < 3 DELETE e")
+        self.env.assertEquals(self._incoming("R"), [[3], [4], [5], [5], [6]])
+
+        # Remove one of the two edges connecting 5 to a.
+        redis_graph.query("MATCH (:A)<-[e:R]-(:B {v:5}) WITH e LIMIT 1 DELETE e")
+        self.env.assertEquals(self._incoming("R"), [[3], [4], [5], [6]])
+
+        redis_graph.query("MATCH (b:B {v:4}) DELETE b")
+        self.env.assertEquals(self._incoming("R"), [[3], [5], [6]])
+
+        # Incoming edges are reported by edge collecting traversals.
+        query = "MATCH (a:A)<-[e:R]-(b) RETURN type(e), b.v ORDER BY b.v"
+        res = redis_graph.query(query)
+        self.env.assertEquals(res.result_set, [["R", 3], ["R", 5], ["R", 6]])
+
+    def test03_incoming_traversal_after_reload(self):
+        # Transposed matrices are not persisted, rebuilt on demand.
+        redis_con.execute_command("DEBUG", "RELOAD")
+        self.env.assertEquals(self._incoming("R"), [[3], [5], [6]])
+        self.env.assertEquals(self._incoming("S"), [[1]])
+        redis_graph.query("MATCH (a:A) CREATE (a)<-[:S]-(:B {v:7})")
+        self.env.assertEquals(self._incoming("S"), [[1], [7]])
@@ -0,0 +1,54 @@
+import os
+import sys
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "triangles"
+redis_con = None
+redis_graph = None
+
+class testTriangleCountFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        # Triangles abc and abd, parallel and reversed edges, a self loop and an edge of another type.
+        redis_graph.query("""CREATE (a:L {v:'a'})-[:R]->(b:L {v:'b'})-[:R]->(c:L {v:'c'})-[:R]->(a),
+                             (a)-[:R]->(b), (b)-[:R]->(a), (d:L {v:'d'})-[:R]->(a), (b)-[:R]->(d),
+                             (e:L {v:'e'})-[:R]->(e), (e)-[:S]->(a), (e)-[:S]->(b)""")
+
+    def test01_per_node(self):
+        q = """CALL algo.triangleCount('L', 'R') YIELD node, triangles, coefficient
+               RETURN node.v, triangles, coefficient ORDER BY node.v"""
+        actual = redis_graph.query(q).result_set
+        expected = [['a', 2, 2.0 / 3], ['b', 2, 2.0 / 3], ['c', 1, 1.0], ['d', 1, 1.0], ['e', 0, 0.0]]
+        self.env.assertEqual(len(actual), len(expected))
+        for row, expected_row in zip(actual, expected):
+            self.env.assertEqual(row[:2], expected_row[:2])
+            self.env.assertAlmostEqual(row[2], expected_row[2], 1e-6)
+
+        # Every relationship type, e closes abe.
+        q = """CALL algo.triangleCount(NULL, NULL) YIELD node, triangles
+               RETURN node.v, triangles ORDER BY node.v"""
+        actual = redis_graph.query(q).result_set
+        self.env.assertEqual(actual, [['a', 3], ['b', 3], ['c', 1], ['d', 1], ['e', 1]])
+
+    def test02_global(self):
+        q = "CALL algo.triangleCount.global('L', 'R') YIELD nodes, triangles, coefficient"
+        actual = redis_graph.query(q).result_set
+        self.env.assertEqual(actual[0][:2], [5, 2])
+        # 6 closed triples out of 8.
+        self.env.assertAlmostEqual(actual[0][2], 0.75, 1e-6)
+
+    def test03_missing_schemas(self):
+        q = "CALL algo.triangleCount('Missing', 'R') YIELD node RETURN count(node)"
+        self.env.assertEqual(redis_graph.query(q).result_set, [[0]])
+
+        q = "CALL algo.triangleCount.global('L', 'Missing') YIELD nodes, triangles"
+        self.env.assertEqual(redis_graph.query(q).result_set, [[5, 0]])
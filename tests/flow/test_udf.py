@@ -0,0 +1,65 @@
+import os
+import subprocess
+from RLTest import Env
+from redisgraph import Graph
+from redis import ResponseError
+from base import FlowTestsBase
+
+GRAPH_ID = "udf"
+redis_con = None
+redis_graph = None
+
+FLOW_DIR = os.path.dirname(os.path.abspath(__file__))
+UDF_SOURCE = os.path.join(FLOW_DIR, "udf", "example_udf.c")
+UDF_LIBRARY = os.path.join(FLOW_DIR, "udf", "example_udf.so")
+UDF_INCLUDE = os.path.join(FLOW_DIR, "..", "..", "src", "arithmetic")
+
+def build_udf_library():
+    cc = os.environ.get("CC", "cc")
+    subprocess.check_call([cc, "-shared", "-fPIC", "-O2", "-I", UDF_INCLUDE, "-o", UDF_LIBRARY, UDF_SOURCE, "-lm"])
+
+class testUDF(FlowTestsBase):
+    def __init__(self):
+        build_udf_library()
+        self.env = Env(moduleArgs="LOADFUNC " + UDF_LIBRARY)
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(1, 4) AS x CREATE (:P {v: x, name: 'p' + toString(x)})")
+
+    def test01_scalar_functions(self):
+        res = redis_graph.query("RETURN score(3), score(3, 0.5), score(NULL), greet('you')")
+        self.env.assertEquals(res.result_set, [[6.0, 1.5, None, "hello you"]])
+        res = redis_graph.query("MATCH (p:P) WHERE score(p.v) > 5 RETURN greet(p.name) ORDER BY p.v")
+        self.env.assertEquals(res.result_set, [["hello p3"], ["hello p4"]])
+
+    def test02_aggregate_functions(self):
+        res = redis_graph.query("UNWIND [1, 2, 4, NULL] AS x RETURN geoMean(x)")
+        self.env.assertAlmostEqual(res.result_set[0][0], 2.0, 0.0001)
+        res = redis_graph.query("UNWIND [1, 4, 4, 4] AS x RETURN geoMean(DISTINCT x)")
+        self.env.assertAlmostEqual(res.result_set[0][0], 2.0, 0.0001)
+        res = redis_graph.query("MATCH (p:P) RETURN p.v % 2 AS k, geoMean(score(p.v, 1)) ORDER BY k")
+        self.env.assertEquals(len(res.result_set), 2)
+        self.env.assertAlmostEqual(res.result_set[0][1], 2.8284, 0.0001)
+        self.env.assertAlmostEqual(res.result_set[1][1], 1.7320, 0.0001)
+
+    def test03_errors(self):
+        queries = ["RETURN score(1, 'a')",
+                   "RETURN score([1])",
+                   "RETURN score()",
+                   "UNWIND [1, -1] AS x RETURN geoMean(x)",
+                   "UNWIND [[1]] AS x RETURN geoMean(x)"]
+        for q in queries:
+            try:
+                redis_graph.query(q)
+                assert(False)
+            except ResponseError:
+                pass
+
+    def test04_builtins_unchanged(self):
+        res = redis_graph.query("RETURN toUpper('a')")
+        self.env.assertEquals(res.result_set, [["A"]])
@@ -0,0 +1,107 @@
+import redis
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "unique_constraint"
+redis_con = None
+redis_graph = None
+
+class testUniqueConstraint(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:User {id: x, name: 'u' + toString(x)})")
+
+    def expect_error(self, query, msg):
+        try:
+            redis_graph.query(query)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn(msg, str(e))
+
+    def user_count(self):
+        return redis_graph.query("MATCH (u:User) RETURN count(u)").result_set[0][0]
+
+    def test01_create_constraint(self):
+        # Values must be unique once the constraint is introduced.
+        redis_graph.query("CREATE (:User {id: 0})")
+        self.expect_error("CREATE CONSTRAINT ON (u:User) ASSERT u.id IS UNIQUE", "duplicate values")
+        redis_graph.query("MATCH (u:User {id: 0}) WHERE u.name IS NULL DELETE u")
+
+        # The property is indexed along with the constraint.
+        res = redis_graph.query("CREATE CONSTRAINT ON (u:User) ASSERT u.id IS UNIQUE")
+        self.env.assertEquals(res.indices_created, 1)
+        plan = redis_graph.execution_plan("MATCH (u:User) WHERE u.id = 1 RETURN u")
+        self.env.assertIn("Index Scan", plan)
+
+        self.expect_error("CREATE CONSTRAINT ON (u:User) ASSERT exists(u.id)", "Only unique constraints")
+
+    def test02_enforced_on_create(self):
+        self.expect_error("CREATE (:User {id: 3})", "Unique constraint violation")
+        # Duplicates within a single query are rejected, no node is introduced.
+        self.expect_error("UNWIND [100, 101, 100] AS x CREATE (:User {id: x})", "Unique constraint violation")
+        self.env.assertEquals(self.user_count(), 10)
+
+        # Nodes missing the property, or of other labels, are unconstrained.
+        redis_graph.query("CREATE (:User {name: 'anonymous'}), (:User {name: 'anonymous'}), (:Other {id: 3})")
+        self.env.assertEquals(self.user_count(), 12)
+
+    def test03_enforced_on_update(self):
+        self.expect_error("MATCH (u:User {id: 1}) SET u.id = 2", "Unique constraint violation")
+        self.expect_error("MATCH (u:User) WHERE u.id IN [1, 2] SET u.id = 50", "Unique constraint violation")
+        res = redis_graph.query("MATCH (u:User) WHERE u.id IN [1, 2, 50] RETURN u.id ORDER BY u.id")
+        self.env.assertEquals(res.result_set, [[1], [2]])
+
+        # Assigning a node its own value is allowed.
+        redis_graph.query("MATCH (u:User {id: 1}) SET u.id = 1")
+        redis_graph.query("MATCH (u:User {id: 1}) SET u.id = 11")
+        redis_graph.query("MATCH (u:User {id: 11}) SET u.id = 1")
+
+    def test04_merge(self):
+        # Existing nodes are matched through the constraint's index.
+        res = redis_graph.query("MERGE (u:User {id: 4}) ON MATCH SET u.seen = true RETURN u.name")
+        self.env.assertEquals(res.result_set, [["u4"]])
+        self.env.assertEquals(res.nodes_created, 0)
+        self.env.assertEquals(res.properties_set, 1)
+
+        res = redis_graph.query("UNWIND [4, 5, 200, 200] AS x MERGE (u:User {id: x}) RETURN x, u.name ORDER BY x, u.name")
+        self.env.assertEquals(res.result_set, [[4, "u4"], [5, "u5"], [200, None], [200, None]])
+        self.env.assertEquals(res.nodes_created, 1)
+
+        # Bound variables and parameters.
+        res = redis_graph.query("MATCH (o:Other) MERGE (u:User {id: o.id}) RETURN u.name")
+        self.env.assertEquals(res.result_set, [["u3"]])
+        res = redis_graph.query("MERGE (u:User {id: $id}) RETURN u.name", {'id': 6})
+        self.env.assertEquals(res.result_set, [["u6"]])
+
+        # Remaining properties must match, creating a conflicting node fails.
+        res = redis_graph.query("MERGE (u:User {id: 7, name: 'u7'}) RETURN count(u)")
+        self.env.assertEquals(res.nodes_created, 0)
+        self.expect_error("MERGE (u:User {id: 7, name: 'other'})", "Unique constraint violation")
+
+        # ON CREATE updates are constrained as well.
+        self.expect_error("MERGE (u:User {id: 300}) ON CREATE SET u.id = 8", "Unique constraint violation")
+
+    def test05_persistence(self):
+        redis_con.execute_command("DEBUG", "RELOAD")
+        self.expect_error("CREATE (:User {id: 9})", "Unique constraint violation")
+        res = redis_graph.query("MERGE (u:User {id: 9}) RETURN u.name")
+        self.env.assertEquals(res.result_set, [["u9"]])
+
+    def test06_drop_constraint(self):
+        self.expect_error("DROP INDEX ON :User(id)", "backs a unique constraint")
+        redis_graph.query("DROP CONSTRAINT ON (u:User) ASSERT u.id IS UNIQUE")
+        self.expect_error("DROP CONSTRAINT ON (u:User) ASSERT u.id IS UNIQUE", "no such constraint")
+
+        # The index remains, duplicates are allowed.
+        redis_graph.query("CREATE (:User {id: 9})")
+        res = redis_graph.query("MATCH (u:User {id: 9}) RETURN count(u)")
+        self.env.assertEquals(res.result_set, [[2]])
+        redis_graph.query("DROP INDEX ON :User(id)")
@@ -93,3 +93,51 @@ class testVariableLengthTraversals(FlowTestsBase):
         query = """MATCH (a)-[:not_knows*0..1]->(b) RETURN a"""
         actual_result = redis_graph.query(query)
         self.env.assertEquals(len(actual_result.result_set), 4)
+
+    def test08_distinct_destinations(self):
+        # Traversals followed by DISTINCT produce every reachable destination once.
+        queries = ["""MATCH (a)-[*]->(b) RETURN %s a.name, b.name ORDER BY a.name, b.name""",
+                   """MATCH (a)-[*0..2]->(b) RETURN %s a.name, b.name ORDER BY a.name, b.name""",
+                   """MATCH (a)-[*]-(b) RETURN %s a.name, b.name ORDER BY a.name, b.name""",
+                   """MATCH (a {name: 'A'}), (b {name: 'D'}) MATCH (a)-[*]->(b) RETURN %s a.name, b.name ORDER BY a.name, b.name"""]
+        for query in queries:
+            expected = []
+            for row in redis_graph.query(query % "").result_set:
+                if row not in expected:
+                    expected.append(row)
+            actual_result = redis_graph.query(query % "DISTINCT")
+            self.env.assertEquals(actual_result.result_set, expected)
+
+        # Undirected traversals don't lead back to their source by reusing an edge.
+        query = """MATCH (a {name: 'A'})-[*]-(b) RETURN DISTINCT b.name ORDER BY b.name"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [['B'], ['C'], ['D']])
+
+        query = """MATCH (a {name: 'A'})-[*..2]->(b) RETURN DISTINCT b.name ORDER BY b.name"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [['B'], ['C']])
+
+    def test09_inlined_edge_filters(self):
+        # Every traversed edge must match the inlined properties.
+        query = """MATCH (a)-[*1..3 {connects: 'AB'}]->(b) RETURN a.name, b.name ORDER BY a.name, b.name"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [['A', 'B']])
+
+        query = """CYPHER c='BC' MATCH (a)-[*0..2 {connects: $c}]->(b) RETURN a.name, b.name ORDER BY a.name, b.name"""
+        actual_result = redis_graph.query(query)
+        expected_result = [['A', 'A'], ['B', 'B'], ['B', 'C'], ['C', 'C'], ['D', 'D']]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        query = """MATCH (a)-[*1..3 {missing: 1}]->(b) RETURN a.name"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [])
+
+        # Filters must be known before traversing, as well as fixed length.
+        queries = ["""MATCH (a)-[*1..3 {connects: a.name}]->(b) RETURN b""",
+                   """MATCH (a)-[*2 {connects: 'AB'}]->(b) RETURN b"""]
+        for query in queries:
+            try:
+                redis_graph.query(query)
+                self.env.assertTrue(False)
+            except Exception:
+                pass
@@ -0,0 +1,100 @@
+import math
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "vector_index"
+redis_con = None
+redis_graph = None
+
+class testVectorIndex(FlowTestsBase):
+    def __init__(self):
+        self.env = Env()
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # Documents on a 20x20 grid, embedded by their coordinates.
+        redis_graph.query("UNWIND range(0, 19) AS i UNWIND range(0, 19) AS j CREATE (:Doc {id: i * 20 + j, embedding: [i, j]})")
+        result = redis_graph.query("CALL db.idx.vector.createIndex('Doc', 'embedding', 2)")
+        self.env.assertEquals(result.indices_created, 1)
+
+    def _query_ids(self, vector, k):
+        query = "CALL db.idx.vector.queryNodes('Doc', 'embedding', %s, %d) YIELD node, score RETURN node.id, score" % (vector, k)
+        return redis_graph.query(query).result_set
+
+    def test01_query(self):
+        result = self._query_ids("[3.1, 4.2]", 3)
+        self.env.assertEquals([row[0] for row in result], [64, 65, 84])
+        self.env.assertAlmostEqual(result[0][1], math.sqrt(0.1 ** 2 + 0.2 ** 2), 1e-5)
+        for i in range(1, len(result)):
+            self.env.assertLessEqual(result[i - 1][1], result[i][1])
+
+        # Retrieved nodes are matched further.
+        query = "CALL db.idx.vector.queryNodes('Doc', 'embedding', [0, 0], 1) YIELD node MATCH (n:Doc) WHERE n.id = node.id + 1 RETURN n.id"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[1]])
+
+        # Parameterized vectors.
+        query = "CYPHER v=[19, 19] CALL db.idx.vector.queryNodes('Doc', 'embedding', $v, 1) YIELD node RETURN node.id"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[399]])
+
+    def test02_invalid_arguments(self):
+        queries = ["CALL db.idx.vector.queryNodes('Doc', 'embedding', [1, 2, 3], 1)",
+                   "CALL db.idx.vector.queryNodes('Doc', 'embedding', [1, 'a'], 1)",
+                   "CALL db.idx.vector.queryNodes('Doc', 'embedding', [1, 2], 0)",
+                   "CALL db.idx.vector.queryNodes('Doc', 'id', [1, 2], 1)",
+                   "CALL db.idx.vector.createIndex('Doc', 'other', 0)",
+                   "CALL db.idx.vector.createIndex('Doc', 'other', 2, 'manhattan')"]
+        for query in queries:
+            try:
+                redis_graph.query(query)
+                self.env.assertTrue(False)
+            except Exception:
+                pass
+
+        # Missing labels have nothing to retrieve.
+        query = "CALL db.idx.vector.queryNodes('Missing', 'embedding', [1, 2], 1)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [])
+
+    def test03_updates(self):
+        # New, updated and deleted nodes are reflected by the index.
+        redis_graph.query("CREATE (:Doc {id: 1000, embedding: [100.0, 100.0]})")
+        self.env.assertEquals(self._query_ids("[99, 99]", 1)[0][0], 1000)
+
+        redis_graph.query("MATCH (d:Doc {id: 1000}) SET d.embedding = [-100.0, -100.0]")
+        self.env.assertEquals(self._query_ids("[99, 99]", 1)[0][0], 399)
+        self.env.assertEquals(self._query_ids("[-99, -99]", 1)[0][0], 1000)
+
+        # Values which aren't vectors of the index dimension aren't indexed.
+        redis_graph.query("MATCH (d:Doc {id: 1000}) SET d.embedding = 'text'")
+        self.env.assertEquals(self._query_ids("[-99, -99]", 1)[0][0], 0)
+
+        redis_graph.query("MATCH (d:Doc {id: 0}) DELETE d")
+        self.env.assertEquals(self._query_ids("[-99, -98]", 1)[0][0], 1)
+
+    def test04_cosine(self):
+        redis_graph.query("UNWIND [[1, [2, 0]], [2, [1, 1]], [3, [0, 3]], [4, [-1, 1]], [5, [-2, 0]]] AS d CREATE (:Dir {id: d[0], v: d[1]})")
+        redis_graph.query("CALL db.idx.vector.createIndex('Dir', 'v', 2, 'cosine')")
+        # Magnitude doesn't affect distance.
+        query = "CALL db.idx.vector.queryNodes('Dir', 'v', [0, 10], 3) YIELD node, score RETURN node.id, round(score * 1000) / 1000"
+        result = redis_graph.query(query).result_set
+        self.env.assertEquals(result[0], [3, 0])
+        self.env.assertEquals(sorted(row[0] for row in result[1:]), [2, 4])
+        self.env.assertEquals(result[1][1], 0.293)
+
+    def test05_persistency(self):
+        expected = self._query_ids("[5.1, 5.1]", 5)
+        redis_con.execute_command("DEBUG", "RELOAD")
+        self.env.assertEquals(self._query_ids("[5.1, 5.1]", 5), expected)
+
+    def test06_drop(self):
+        result = redis_graph.query("CALL db.idx.vector.drop('Doc', 'embedding')")
+        self.env.assertEquals(result.indices_deleted, 1)
+        try:
+            self._query_ids("[1, 1]", 1)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("No vector index", str(e))
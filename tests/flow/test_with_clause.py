@@ -218,3 +218,23 @@ class testWithClause(FlowTestsBase):
         actual_result = redis_graph.query(query)
         expected = [['scope2']]
         self.env.assertEqual(actual_result.result_set, expected)
+
+    # Verify filters over aggregating segments, which are evaluated in batches.
+    def test10_filter_aggregated_segment(self):
+        query = """UNWIND range(1, 1000) AS x WITH x % 100 AS k, count(x) AS c WHERE k > 49 RETURN count(k), sum(c)"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEqual(actual_result.result_set, [[50, 500]])
+
+        query = """UNWIND range(1, 100) AS x WITH x % 10 AS k, collect(x) AS xs WHERE size(xs) = 10 RETURN k, xs[0] ORDER BY k LIMIT 3"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEqual(actual_result.result_set, [[0, 10], [1, 1], [2, 2]])
+
+    # Verify uncorrelated aggregating segments combined with later patterns.
+    def test11_uncorrelated_aggregated_segment(self):
+        query = """MATCH (a:label_a) WITH count(a) AS c MATCH (b:label_b) RETURN c, count(b)"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEqual(actual_result.result_set, [[6, 6]])
+
+        query = """MATCH (a:label_a) WITH a.a_idx % 2 AS k, count(a) AS c MATCH (b:label_b) WHERE b.b_idx = k RETURN k, c, b.b_idx ORDER BY k"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEqual(actual_result.result_set, [[0, 3, 0], [1, 3, 1]])
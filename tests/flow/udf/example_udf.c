@@ -0,0 +1,101 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+// User-defined function plug-in exercised by test_udf.py.
+
+#include "redisgraph_udf.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static GraphUDFValue _number(const GraphUDFValue *v) {
+	GraphUDFValue res = {.type = GRAPH_UDF_DOUBLE};
+	if(v->type == GRAPH_UDF_INTEGER) res.number = v->integer;
+	else if(v->type == GRAPH_UDF_DOUBLE) res.number = v->number;
+	else res.type = GRAPH_UDF_NULL;
+	return res;
+}
+
+// score(x, w) = x * w, w defaults to 2.
+static GraphUDFValue score(const GraphUDFValue *argv, int argc, void *privdata) {
+	GraphUDFValue x = _number(&argv[0]);
+	if(x.type == GRAPH_UDF_NULL) return x;
+	double w = *(double *)privdata;
+	if(argc == 2) {
+		GraphUDFValue v = _number(&argv[1]);
+		if(v.type == GRAPH_UDF_NULL) {
+			GraphUDFValue err = {.type = GRAPH_UDF_ERROR, .string = "score expects a numeric weight"};
+			return err;
+		}
+		w = v.number;
+	}
+	x.number *= w;
+	return x;
+}
+
+// greet(name) = 'hello ' + name.
+static GraphUDFValue greet(const GraphUDFValue *argv, int argc, void *privdata) {
+	static __thread char buf[256];
+	GraphUDFValue res = {.type = GRAPH_UDF_NULL};
+	if(argv[0].type != GRAPH_UDF_STRING) return res;
+	snprintf(buf, sizeof(buf), "hello %s", argv[0].string);
+	res.type = GRAPH_UDF_STRING;
+	res.string = buf;
+	return res;
+}
+
+// geoMean(x), geometric mean of positive numbers.
+typedef struct {
+	double log_sum;
+	long long count;
+} GeoMean;
+
+static void *geomean_init(void *privdata) {
+	return calloc(1, sizeof(GeoMean));
+}
+
+static int geomean_step(void *state, const GraphUDFValue *argv, int argc, const char **err) {
+	GeoMean *g = state;
+	GraphUDFValue x = _number(&argv[0]);
+	if(x.type == GRAPH_UDF_NULL) return GRAPH_UDF_OK;
+	if(x.number <= 0) {
+		*err = "geoMean expects positive numbers";
+		return GRAPH_UDF_ERR;
+	}
+	g->log_sum += log(x.number);
+	g->count++;
+	return GRAPH_UDF_OK;
+}
+
+static GraphUDFValue geomean_finalize(void *state) {
+	GeoMean *g = state;
+	GraphUDFValue res = {.type = GRAPH_UDF_NULL};
+	if(g->count == 0) return res;
+	res.type = GRAPH_UDF_DOUBLE;
+	res.number = exp(g->log_sum / g->count);
+	return res;
+}
+
+static double default_weight = 2;
+
+int RedisGraph_UDF_OnLoad(const GraphUDFRegistry *registry) {
+	if(registry->version < GRAPH_UDF_API_VERSION) return GRAPH_UDF_ERR;
+
+	if(registry->RegisterScalar("score", score, 1, 2, GRAPH_UDF_DETERMINISTIC,
+								&default_weight) != GRAPH_UDF_OK) return GRAPH_UDF_ERR;
+	if(registry->RegisterScalar("greet", greet, 1, 1, 0, NULL) != GRAPH_UDF_OK) return GRAPH_UDF_ERR;
+
+	// Built-in names can't be taken.
+	if(registry->RegisterScalar("toUpper", greet, 1, 1, 0, NULL) == GRAPH_UDF_OK) return GRAPH_UDF_ERR;
+
+	GraphUDFAggregate geomean = {
+		.init = geomean_init,
+		.step = geomean_step,
+		.finalize = geomean_finalize,
+		.free = free,
+	};
+	return registry->RegisterAggregate("geoMean", &geomean, NULL);
+}
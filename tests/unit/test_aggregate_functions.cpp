@@ -19,6 +19,7 @@ extern "C"
 #include "../../src/execution_plan/execution_plan.h"
 #include "../../src/arithmetic/arithmetic_expression.h"
 #include "../../src/util/arr.h"
+#include "../../src/datatypes/array.h"
 
 // Declaration of used functions not in header files
 extern AR_ExpNode **_BuildReturnExpressions(const cypher_astnode_t *ret_clause, AST *ast);
@@ -254,3 +255,56 @@ TEST_F(AggregateTest, StDevTest) {
 	AR_EXP_Free(stdevp);
 }
 
+// Aggregations computed in parts and merged match a single pass over all values.
+TEST_F(AggregateTest, MergeTest) {
+	const char *funcs[5] = {"count", "sum", "avg", "min", "max"};
+	double expected[5] = {10, 55, 5.5, 1, 10};
+
+	for(int f = 0; f < 5; f++) {
+		AR_ExpNode *parts[2];
+		parts[0] = AR_EXP_NewOpNode(funcs[f], 1);
+		parts[0]->op.children[0] = AR_EXP_NewConstOperandNode(SI_NullVal());
+		ASSERT_TRUE(AR_EXP_Mergeable(parts[0]));
+		parts[1] = AR_EXP_Clone(parts[0]);
+
+		// Values 1..3 are aggregated by the first part, 4..10 by the second.
+		for(int i = 1; i <= 10; i++) {
+			AR_ExpNode *part = parts[i > 3];
+			AR_EXP_Free(part->op.children[0]);
+			part->op.children[0] = AR_EXP_NewConstOperandNode(SI_LongVal(i));
+			AR_EXP_Aggregate(part, NULL);
+		}
+
+		AR_EXP_Merge(parts[0], parts[1]);
+		AR_EXP_Reduce(parts[0]);
+		SIValue result = AR_EXP_Evaluate(parts[0], NULL);
+		double n;
+		ASSERT_TRUE(SIValue_ToDouble(&result, &n));
+		ASSERT_EQ(n, expected[f]);
+
+		AR_EXP_Free(parts[0]);
+		AR_EXP_Free(parts[1]);
+	}
+
+	// Collected values are appended in merge order.
+	AR_ExpNode *collect = AR_EXP_NewOpNode("collect", 1);
+	collect->op.children[0] = AR_EXP_NewConstOperandNode(SI_LongVal(1));
+	AR_ExpNode *other = AR_EXP_Clone(collect);
+	AR_EXP_Free(other->op.children[0]);
+	other->op.children[0] = AR_EXP_NewConstOperandNode(SI_LongVal(2));
+	AR_EXP_Aggregate(collect, NULL);
+	AR_EXP_Aggregate(other, NULL);
+	AR_EXP_Merge(collect, other);
+	AR_EXP_Reduce(collect);
+	SIValue list = AR_EXP_Evaluate(collect, NULL);
+	ASSERT_EQ(SIArray_Length(list), 2);
+	ASSERT_EQ(SIArray_Get(list, 0).longval, 1);
+	ASSERT_EQ(SIArray_Get(list, 1).longval, 2);
+	AR_EXP_Free(collect);
+	AR_EXP_Free(other);
+
+	// Distinct aggregations can't be merged.
+	AR_ExpNode *distinct = _exp_from_query("RETURN count(DISTINCT 1)");
+	ASSERT_FALSE(AR_EXP_Mergeable(distinct));
+	AR_EXP_Free(distinct);
+}
@@ -466,6 +466,132 @@ TEST_F(AlgebraicExpressionTest, Exp_OP_MUL) {
     AlgebraicExpression_Free(exp);
 }
 
+TEST_F(AlgebraicExpressionTest, Exp_OP_MUL_Diagonal) {
+	// Exp = D * A * E, where D and E are diagonal.
+	GrB_Matrix D;
+	GrB_Matrix A;
+	GrB_Matrix E;
+	GrB_Matrix res;
+	GrB_Matrix expected;
+
+	// D
+	// 1 0 0
+	// 0 1 0
+	// 0 0 0
+	GrB_Matrix_new(&D, GrB_BOOL, 3, 3);
+	GrB_Matrix_setElement_BOOL(D, true, 0, 0);
+	GrB_Matrix_setElement_BOOL(D, true, 1, 1);
+
+	// A
+	// 0 1 1
+	// 0 0 1
+	// 1 0 0
+	GrB_Matrix_new(&A, GrB_BOOL, 3, 3);
+	GrB_Matrix_setElement_BOOL(A, true, 0, 1);
+	GrB_Matrix_setElement_BOOL(A, true, 0, 2);
+	GrB_Matrix_setElement_BOOL(A, true, 1, 2);
+	GrB_Matrix_setElement_BOOL(A, true, 2, 0);
+
+	// E
+	// 0 0 0
+	// 0 0 0
+	// 0 0 1
+	GrB_Matrix_new(&E, GrB_BOOL, 3, 3);
+	GrB_Matrix_setElement_BOOL(E, true, 2, 2);
+
+	rax *matrices = raxNew();
+	raxInsert(matrices, (unsigned char *)"D", strlen("D"), D, NULL);
+	raxInsert(matrices, (unsigned char *)"A", strlen("A"), A, NULL);
+	raxInsert(matrices, (unsigned char *)"E", strlen("E"), E, NULL);
+	AlgebraicExpression *exp = AlgebraicExpression_FromString("D*A*E", matrices);
+	ASSERT_EQ(AlgebraicExpression_ChildCount(exp), 3);
+	exp->operation.children[0]->operand.diagonal = true;
+	exp->operation.children[2]->operand.diagonal = true;
+
+	GrB_Matrix_new(&res, GrB_BOOL, 3, 3);
+	AlgebraicExpression_Eval(exp, res);
+
+	// Rows 0 and 1 of A, restricted to column 2.
+	GrB_Matrix_new(&expected, GrB_BOOL, 3, 3);
+	GrB_Matrix_setElement_BOOL(expected, true, 0, 2);
+	GrB_Matrix_setElement_BOOL(expected, true, 1, 2);
+	ASSERT_TRUE(_compare_matrices(res, expected));
+
+	raxFree(matrices);
+	GrB_Matrix_free(&D);
+	GrB_Matrix_free(&A);
+	GrB_Matrix_free(&E);
+	GrB_Matrix_free(&res);
+	GrB_Matrix_free(&expected);
+	AlgebraicExpression_Free(exp);
+}
+
+TEST_F(AlgebraicExpressionTest, Exp_MultiplyTrailingOperands) {
+	// Exp = F * D * A * E, where D and E are diagonal.
+	GrB_Matrix F;
+	GrB_Matrix D;
+	GrB_Matrix A;
+	GrB_Matrix E;
+	GrB_Matrix res;
+	GrB_Matrix expected;
+
+	GrB_Matrix_new(&F, GrB_BOOL, 2, 3);
+	GrB_Matrix_setElement_BOOL(F, true, 0, 0);
+	GrB_Matrix_setElement_BOOL(F, true, 1, 1);
+
+	GrB_Matrix_new(&D, GrB_BOOL, 3, 3);
+	GrB_Matrix_setElement_BOOL(D, true, 0, 0);
+	GrB_Matrix_setElement_BOOL(D, true, 1, 1);
+
+	GrB_Matrix_new(&A, GrB_BOOL, 3, 3);
+	GrB_Matrix_setElement_BOOL(A, true, 0, 1);
+	GrB_Matrix_setElement_BOOL(A, true, 0, 2);
+	GrB_Matrix_setElement_BOOL(A, true, 1, 2);
+
+	GrB_Matrix_new(&E, GrB_BOOL, 3, 3);
+	GrB_Matrix_setElement_BOOL(E, true, 2, 2);
+
+	rax *matrices = raxNew();
+	raxInsert(matrices, (unsigned char *)"F", strlen("F"), F, NULL);
+	raxInsert(matrices, (unsigned char *)"D", strlen("D"), D, NULL);
+	raxInsert(matrices, (unsigned char *)"A", strlen("A"), A, NULL);
+	raxInsert(matrices, (unsigned char *)"E", strlen("E"), E, NULL);
+	AlgebraicExpression *exp = AlgebraicExpression_FromString("F*D*A*E", matrices);
+	ASSERT_EQ(AlgebraicExpression_ChildCount(exp), 4);
+	exp->operation.children[1]->operand.diagonal = true;
+	exp->operation.children[3]->operand.diagonal = true;
+
+	GrB_Matrix_new(&res, GrB_BOOL, 2, 3);
+	AlgebraicExpression_Eval(exp, res);
+	GrB_Matrix_dup(&expected, res);
+
+	// Trailing operands are replaced by their product, evaluating to the same result.
+	GrB_Matrix product = GrB_NULL;
+	ASSERT_TRUE(AlgebraicExpression_MultiplyTrailingOperands(exp, &product));
+	ASSERT_EQ(AlgebraicExpression_ChildCount(exp), 2);
+	GrB_Matrix_clear(res);
+	AlgebraicExpression_Eval(exp, res);
+	ASSERT_TRUE(_compare_matrices(res, expected));
+
+	// More than a single non-diagonal trailing operand isn't multiplied ahead.
+	AlgebraicExpression *other = AlgebraicExpression_FromString("F*A*A", matrices);
+	GrB_Matrix other_product = GrB_NULL;
+	ASSERT_FALSE(AlgebraicExpression_MultiplyTrailingOperands(other, &other_product));
+	ASSERT_EQ(AlgebraicExpression_ChildCount(other), 3);
+	ASSERT_EQ(other_product, GrB_NULL);
+
+	raxFree(matrices);
+	GrB_Matrix_free(&F);
+	GrB_Matrix_free(&D);
+	GrB_Matrix_free(&A);
+	GrB_Matrix_free(&E);
+	GrB_Matrix_free(&res);
+	GrB_Matrix_free(&expected);
+	GrB_Matrix_free(&product);
+	AlgebraicExpression_Free(exp);
+	AlgebraicExpression_Free(other);
+}
+
 TEST_F(AlgebraicExpressionTest, Exp_OP_ADD_Transpose) {
 	// Exp = A + Transpose(A)
 	GrB_Matrix A;
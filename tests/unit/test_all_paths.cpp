@@ -305,3 +305,86 @@ TEST_F(AllPathsTest, DestinationSpecificPaths) {
 	AllPathsCtx_Free(ctx);
 	Graph_Free(g);
 }
+
+TEST_F(AllPathsTest, DestinationPruning) {
+	Graph *g = BuildGraph();
+
+	Node src;
+	Node dst;
+	Path *path = NULL;
+	Graph_GetNode(g, 0, &src);
+	Graph_GetNode(g, 3, &dst);
+	int relationships[] = {GRAPH_NO_RELATION};
+
+	// Searches to a destination skip branches which can't reach it,
+	// producing the same paths as an unrestricted search.
+	for(unsigned int maxLen = 1; maxLen <= 5; maxLen++) {
+		unsigned int expected = 0;
+		AllPathsCtx *ctx = AllPathsCtx_New(&src, NULL, g, relationships, 1, GRAPH_EDGE_DIR_OUTGOING, 1,
+										   maxLen);
+		while((path = AllPathsCtx_NextPath(ctx))) {
+			Node head = Path_Head(path);
+			if(ENTITY_GET_ID(&head) == 3) expected++;
+		}
+		AllPathsCtx_Free(ctx);
+
+		unsigned int pathsCount = 0;
+		ctx = AllPathsCtx_New(&src, &dst, g, relationships, 1, GRAPH_EDGE_DIR_OUTGOING, 1, maxLen);
+		ASSERT_EQ(ctx->withinReach != NULL, maxLen >= ALL_PATHS_PRUNE_MIN_LEN);
+		while((path = AllPathsCtx_NextPath(ctx))) {
+			Node head = Path_Head(path);
+			ASSERT_EQ(ENTITY_GET_ID(&head), 3);
+			pathsCount++;
+		}
+		AllPathsCtx_Free(ctx);
+		ASSERT_EQ(pathsCount, expected);
+	}
+
+	Graph_Free(g);
+}
+
+TEST_F(AllPathsTest, EdgeFilters) {
+	Edge e;
+	Node n;
+	Graph *g = Graph_New(3, 3);
+	int relation = Graph_AddRelationType(g);
+	for(int i = 0; i < 3; i++) Graph_CreateNode(g, GRAPH_NO_LABEL, &n);
+
+	/* Connections:
+	 * 0 -> 1 {w: 1}
+	 * 1 -> 2 {w: 2}
+	 * 0 -> 2 {w: 1} */
+	Attribute_ID w = 0;
+	Graph_ConnectNodes(g, 0, 1, relation, &e);
+	GraphEntity_AddProperty((GraphEntity *)&e, w, SI_LongVal(1));
+	Graph_ConnectNodes(g, 1, 2, relation, &e);
+	GraphEntity_AddProperty((GraphEntity *)&e, w, SI_LongVal(2));
+	Graph_ConnectNodes(g, 0, 2, relation, &e);
+	GraphEntity_AddProperty((GraphEntity *)&e, w, SI_LongVal(1));
+
+	Node src;
+	Graph_GetNode(g, 0, &src);
+	int relationships[] = {relation};
+	AllPathsEdgeFilter filters[1] = {{w, SI_LongVal(1)}};
+
+	// Only edges with w = 1 are followed.
+	AllPathsCtx *ctx = AllPathsCtx_New(&src, NULL, g, relationships, 1, GRAPH_EDGE_DIR_OUTGOING, 1, 2);
+	AllPathsCtx_SetEdgeFilters(ctx, filters, 1);
+	unsigned int pathsCount = 0;
+	Path *path = NULL;
+	while((path = AllPathsCtx_NextPath(ctx))) {
+		ASSERT_EQ(Path_EdgeCount(path), 1);
+		pathsCount++;
+	}
+	ASSERT_EQ(pathsCount, 2);
+	AllPathsCtx_Free(ctx);
+
+	// Without filters 0 -> 1 -> 2 is produced as well.
+	ctx = AllPathsCtx_New(&src, NULL, g, relationships, 1, GRAPH_EDGE_DIR_OUTGOING, 1, 2);
+	pathsCount = 0;
+	while((path = AllPathsCtx_NextPath(ctx))) pathsCount++;
+	ASSERT_EQ(pathsCount, 3);
+	AllPathsCtx_Free(ctx);
+
+	Graph_Free(g);
+}
@@ -1520,3 +1520,66 @@ TEST_F(ArithmeticTest, CoalesceTest) {
 	ASSERT_EQ(AR_EXP_CONSTANT, arExp->operand.type);
 	ASSERT_EQ(0, SIValue_Compare(SI_LongVal(1), arExp->operand.constant, NULL));
 }
+
+TEST_F(ArithmeticTest, RecordEvaluation) {
+	rax *mapping = raxNew();
+	raxInsert(mapping, (unsigned char *)"a", 1, (void *)0, NULL);
+	raxInsert(mapping, (unsigned char *)"b", 1, (void *)1, NULL);
+	Record r = Record_New(mapping);
+	Record_AddScalar(r, 0, SI_LongVal(4));
+	Record_AddScalar(r, 1, SI_DoubleVal(2.5));
+
+	const char *queries[10] = {
+		"RETURN a + b * 2",
+		"RETURN a - 1",
+		"RETURN a * a > b",
+		"RETURN a = 4.0",
+		"RETURN abs(b - a) <= 1.5",
+		"RETURN a < null",
+		// Constant operands on either side.
+		"RETURN 10 - a",
+		"RETURN 3 > a",
+		"RETURN a % 3",
+		"RETURN 9 / a",
+	};
+	SIValue expected[10] = {
+		SI_DoubleVal(9),
+		SI_LongVal(3),
+		SI_BoolVal(true),
+		SI_BoolVal(true),
+		SI_BoolVal(true),
+		SI_NullVal(),
+		SI_LongVal(6),
+		SI_BoolVal(false),
+		SI_LongVal(1),
+		SI_DoubleVal(2.25),
+	};
+
+	for(int i = 0; i < 10; i++) {
+		AR_ExpNode *arExp = _exp_from_query(queries[i]);
+		// Evaluate repeatedly, reusing the compiled form of the expression.
+		for(int j = 0; j < 2; j++) {
+			SIValue result = AR_EXP_Evaluate(arExp, r);
+			ASSERT_EQ(SI_TYPE(expected[i]), SI_TYPE(result));
+			if(SI_TYPE(result) != T_NULL) ASSERT_EQ(0, SIValue_Compare(expected[i], result, NULL));
+		}
+		AR_EXP_Free(arExp);
+	}
+
+	// Operands that aren't numerics are handled by the function itself.
+	AR_ExpNode *arExp = _exp_from_query("RETURN a + 'x'");
+	SIValue result = AR_EXP_Evaluate(arExp, r);
+	ASSERT_STREQ("4x", result.stringval);
+	SIValue_Free(result);
+	AR_EXP_Free(arExp);
+
+	// Constant operands keep their position.
+	arExp = _exp_from_query("RETURN 2 + toString(a)");
+	result = AR_EXP_Evaluate(arExp, r);
+	ASSERT_STREQ("24", result.stringval);
+	SIValue_Free(result);
+	AR_EXP_Free(arExp);
+
+	Record_Free(r);
+	raxFree(mapping);
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/bump_arena.h"
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+class BumpArenaTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(BumpArenaTest, Allocations) {
+	BumpArena *arena = BumpArena_New(4 * BUMP_ARENA_BLOCK_SIZE);
+
+	// Allocations are aligned and don't overlap.
+	char *prev = NULL;
+	for(int i = 0; i < 1000; i++) {
+		char *p = (char *)BumpArena_Alloc(arena, 13);
+		ASSERT_TRUE(p != NULL);
+		ASSERT_EQ((uintptr_t)p % 8, 0);
+		memset(p, i % 128, 13);
+		if(prev) ASSERT_EQ(prev[12], (i - 1) % 128);
+		prev = p;
+	}
+
+	// Large allocations get a block of their own.
+	char *large = (char *)BumpArena_Alloc(arena, 2 * BUMP_ARENA_BLOCK_SIZE);
+	ASSERT_TRUE(large != NULL);
+	memset(large, 1, 2 * BUMP_ARENA_BLOCK_SIZE);
+	ASSERT_TRUE(BumpArena_Alloc(arena, 8) != NULL);
+
+	// Allocations exceeding the limit fail.
+	ASSERT_TRUE(BumpArena_Alloc(arena, 2 * BUMP_ARENA_BLOCK_SIZE) == NULL);
+
+	BumpArena_Free(arena);
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <string.h>
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/cache/cache.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+// Reference counted cache value.
+typedef struct {
+	int id;
+	int ref_count;
+} CacheValue;
+
+static void *_RefValue(void *value) {
+	((CacheValue *)value)->ref_count++;
+	return value;
+}
+
+static void _FreeValue(void *value) {
+	((CacheValue *)value)->ref_count--;
+}
+
+class CacheTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(CacheTest, HitMiss) {
+	Cache *cache = Cache_New(4, _RefValue, _FreeValue);
+	CacheValue v = {1, 0};
+	const char *key = "MATCH (n) RETURN n";
+
+	ASSERT_TRUE(Cache_GetValue(cache, key, strlen(key)) == NULL);
+	Cache_SetValue(cache, key, strlen(key), &v);
+	ASSERT_EQ(v.ref_count, 1);
+	ASSERT_EQ(Cache_Size(cache), 1);
+
+	// Lookups hand out a new reference.
+	CacheValue *res = (CacheValue *)Cache_GetValue(cache, key, strlen(key));
+	ASSERT_EQ(res, &v);
+	ASSERT_EQ(v.ref_count, 2);
+	_FreeValue(res);
+
+	// Re-setting an existing key retains the cached value.
+	CacheValue other = {2, 0};
+	Cache_SetValue(cache, key, strlen(key), &other);
+	ASSERT_EQ(other.ref_count, 0);
+	ASSERT_EQ(Cache_Size(cache), 1);
+
+	CacheStats stats = Cache_GetStats(cache);
+	ASSERT_EQ(stats.hits, 1);
+	ASSERT_EQ(stats.misses, 1);
+	ASSERT_EQ(stats.evictions, 0);
+	// Values cached without a size take no accounted memory.
+	ASSERT_EQ(stats.bytes, 0);
+
+	Cache_Free(cache);
+	ASSERT_EQ(v.ref_count, 0);
+}
+
+TEST_F(CacheTest, LRUEviction) {
+	Cache *cache = Cache_New(2, _RefValue, _FreeValue);
+	CacheValue a = {1, 0};
+	CacheValue b = {2, 0};
+	CacheValue c = {3, 0};
+
+	Cache_SetValue(cache, "a", 1, &a);
+	Cache_SetValue(cache, "b", 1, &b);
+
+	// Mark 'a' as most recently used, 'b' should be evicted.
+	_FreeValue(Cache_GetValue(cache, "a", 1));
+	Cache_SetValue(cache, "c", 1, &c);
+
+	ASSERT_EQ(Cache_Size(cache), 2);
+	ASSERT_EQ(b.ref_count, 0);
+	ASSERT_TRUE(Cache_GetValue(cache, "b", 1) == NULL);
+	ASSERT_EQ(Cache_GetStats(cache).evictions, 1);
+
+	CacheValue *res = (CacheValue *)Cache_GetValue(cache, "a", 1);
+	ASSERT_EQ(res, &a);
+	_FreeValue(res);
+	res = (CacheValue *)Cache_GetValue(cache, "c", 1);
+	ASSERT_EQ(res, &c);
+	_FreeValue(res);
+
+	Cache_Free(cache);
+}
+
+TEST_F(CacheTest, Clear) {
+	Cache *cache = Cache_New(4, _RefValue, _FreeValue);
+	CacheValue a = {1, 0};
+	CacheValue b = {2, 0};
+
+	Cache_SetValue(cache, "a", 1, &a);
+	Cache_SetValue(cache, "b", 1, &b);
+
+	// Outstanding references outlive the cleared entries.
+	CacheValue *res = (CacheValue *)Cache_GetValue(cache, "a", 1);
+	Cache_Clear(cache);
+	ASSERT_EQ(Cache_Size(cache), 0);
+	ASSERT_EQ(a.ref_count, 1);
+	ASSERT_EQ(b.ref_count, 0);
+	_FreeValue(res);
+
+	ASSERT_TRUE(Cache_GetValue(cache, "a", 1) == NULL);
+	Cache_Free(cache);
+}
+
+TEST_F(CacheTest, MemoryBound) {
+	Cache *cache = Cache_New(4, _RefValue, _FreeValue);
+	Cache_SetMaxBytes(cache, 100);
+	CacheValue a = {1, 0};
+	CacheValue b = {2, 0};
+	CacheValue c = {3, 0};
+
+	Cache_SetSizedValue(cache, "a", 1, &a, 60);
+	Cache_SetSizedValue(cache, "b", 1, &b, 30);
+	ASSERT_EQ(Cache_Size(cache), 2);
+
+	// Entries are evicted until the new value fits.
+	Cache_SetSizedValue(cache, "c", 1, &c, 50);
+	ASSERT_EQ(Cache_Size(cache), 2);
+	ASSERT_EQ(a.ref_count, 0);
+	ASSERT_EQ(c.ref_count, 1);
+
+	// Values larger than the bound aren't cached.
+	Cache_SetSizedValue(cache, "a", 1, &a, 101);
+	ASSERT_TRUE(Cache_GetValue(cache, "a", 1) == NULL);
+	ASSERT_EQ(a.ref_count, 0);
+
+	ASSERT_TRUE(Cache_RemoveValue(cache, "b", 1));
+	ASSERT_FALSE(Cache_RemoveValue(cache, "b", 1));
+	ASSERT_EQ(b.ref_count, 0);
+	ASSERT_EQ(cache->bytes, 50);
+
+	Cache_Free(cache);
+	ASSERT_EQ(c.ref_count, 0);
+}
@@ -38,7 +38,8 @@ TEST_F(DataBlockTest, New) {
 	ASSERT_EQ(dataBlock->itemCount, 0);     // No items were added.
 	ASSERT_GE(dataBlock->itemCap, 1024);
 	ASSERT_EQ(dataBlock->itemSize, itemSize + ITEM_HEADER_SIZE);
-	ASSERT_GE(dataBlock->blockCount, 1024 / DATABLOCK_BLOCK_CAP);
+	ASSERT_EQ(dataBlock->blockCap, 1024);
+	ASSERT_EQ(dataBlock->blockCount, 1);
 
 	for(int i = 0; i < dataBlock->blockCount; i++) {
 		Block *block = dataBlock->blocks[i];
@@ -187,3 +188,255 @@ TEST_F(DataBlockTest, RemoveItem) {
 	DataBlock_Free(dataBlock);
 }
 
+
+TEST_F(DataBlockTest, Compact) {
+	// Spread items over four blocks, holding 1024, 1024, 2048 and 4096 items.
+	DataBlock *dataBlock = DataBlock_New(1024, sizeof(int), NULL);
+	uint itemCount = 4096 + 16;
+
+	for(int i = 0 ; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// Nothing to compact.
+	ASSERT_TRUE(DataBlock_Compact(dataBlock) == NULL);
+
+	// Delete all items at odd positions.
+	for(uint i = 1; i < itemCount; i += 2) DataBlock_DeleteItem(dataBlock, i);
+	ASSERT_EQ(dataBlock->blockCount, 4);
+
+	uint64_t *mapping = DataBlock_Compact(dataBlock);
+	ASSERT_TRUE(mapping != NULL);
+	ASSERT_EQ(dataBlock->itemCount, itemCount / 2);
+	ASSERT_EQ(array_len(dataBlock->deletedIdx), 0);
+	// Last block was left empty.
+	ASSERT_EQ(dataBlock->blockCount, 3);
+	ASSERT_EQ(dataBlock->itemCap, 4096);
+
+	// Items retain their order.
+	for(uint i = 0; i < itemCount; i += 2) {
+		ASSERT_EQ(mapping[i], i / 2);
+		int *item = (int *)DataBlock_GetItem(dataBlock, mapping[i]);
+		ASSERT_TRUE(item != NULL);
+		ASSERT_EQ(*item, i);
+	}
+	rm_free(mapping);
+
+	// Positions beyond the compacted items are vacant.
+	ASSERT_TRUE(DataBlock_GetItem(dataBlock, itemCount / 2) == NULL);
+
+	// New items are appended.
+	uint64_t idx;
+	DataBlock_AllocateItem(dataBlock, &idx);
+	ASSERT_EQ(idx, itemCount / 2);
+
+	DataBlockIterator *it = DataBlock_Scan(dataBlock);
+	uint counter = 0;
+	while(DataBlockIterator_Next(it)) counter++;
+	ASSERT_EQ(counter, itemCount / 2 + 1);
+	DataBlockIterator_Free(it);
+
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, Permute) {
+	// Spread items over two blocks.
+	DataBlock *dataBlock = DataBlock_New(1024, sizeof(int), NULL);
+	uint itemCount = 1024 + 16;
+
+	for(int i = 0 ; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// Reverse items, except for the first which stays in place.
+	uint64_t *perm = (uint64_t *)rm_malloc(sizeof(uint64_t) * itemCount);
+	perm[0] = 0;
+	for(uint i = 1; i < itemCount; i++) perm[i] = itemCount - i;
+	DataBlock_Permute(dataBlock, perm);
+
+	ASSERT_EQ(dataBlock->itemCount, itemCount);
+	for(uint i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_GetItem(dataBlock, perm[i]);
+		ASSERT_TRUE(item != NULL);
+		ASSERT_EQ(*item, i);
+	}
+
+	// Rotate items by a single position.
+	for(uint i = 0; i < itemCount; i++) perm[i] = (i + 1) % itemCount;
+	DataBlock_Permute(dataBlock, perm);
+	int *item = (int *)DataBlock_GetItem(dataBlock, 1);
+	ASSERT_EQ(*item, 0);
+	item = (int *)DataBlock_GetItem(dataBlock, 0);
+	ASSERT_EQ(*item, 1);
+
+	rm_free(perm);
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, GeometricGrowth) {
+	// Small datablocks start out with small blocks.
+	DataBlock *dataBlock = DataBlock_New(1, sizeof(uint64_t), NULL);
+	ASSERT_EQ(dataBlock->blockCap, DATABLOCK_MIN_BLOCK_CAP);
+	ASSERT_EQ(dataBlock->itemCap, DATABLOCK_MIN_BLOCK_CAP);
+
+	// Grow past the largest block capacity.
+	uint64_t itemCount = DATABLOCK_MAX_BLOCK_CAP * 3 + 7;
+	for(uint64_t i = 0; i < itemCount; i++) {
+		uint64_t idx;
+		uint64_t *item = (uint64_t *)DataBlock_AllocateItem(dataBlock, &idx);
+		ASSERT_EQ(idx, i);
+		*item = i;
+	}
+
+	// Block capacities double, up to the largest capacity.
+	uint64_t cap = 0;
+	for(uint i = 0; i < dataBlock->blockCount; i++) {
+		Block *block = dataBlock->blocks[i];
+		ASSERT_LE(block->capacity, DATABLOCK_MAX_BLOCK_CAP);
+		if(i > 1 && block->capacity < DATABLOCK_MAX_BLOCK_CAP) ASSERT_EQ(block->capacity, cap);
+		cap += block->capacity;
+	}
+	ASSERT_EQ(cap, dataBlock->itemCap);
+	ASSERT_GE(dataBlock->itemCap, itemCount);
+
+	for(uint64_t i = 0; i < itemCount; i++) {
+		uint64_t *item = (uint64_t *)DataBlock_GetItem(dataBlock, i);
+		ASSERT_EQ(*item, i);
+	}
+
+	// Iterator crosses blocks of different sizes.
+	uint64_t *item;
+	uint64_t counter = 0;
+	DataBlockIterator *it = DataBlock_Scan(dataBlock);
+	while((item = (uint64_t *)DataBlockIterator_Next(it))) {
+		ASSERT_EQ(*item, counter);
+		counter++;
+	}
+	ASSERT_EQ(counter, itemCount);
+	DataBlockIterator_Free(it);
+
+	// Iteration may start midway.
+	it = DataBlockIterator_New(dataBlock->blocks[0], 1000, itemCount, 1000);
+	item = (uint64_t *)DataBlockIterator_Next(it);
+	ASSERT_EQ(*item, 1000);
+	item = (uint64_t *)DataBlockIterator_Next(it);
+	ASSERT_EQ(*item, 2000);
+	DataBlockIterator_Free(it);
+
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, AccommodateEmpty) {
+	// Empty datablock adapts its blocks to the expected number of items.
+	DataBlock *dataBlock = DataBlock_New(1, sizeof(int), NULL);
+	DataBlock_Accommodate(dataBlock, 100000);
+	ASSERT_EQ(dataBlock->blockCap, 131072);
+	ASSERT_EQ(dataBlock->blockCount, 1);
+	ASSERT_GE(dataBlock->itemCap, 100000);
+
+	// Populated datablocks retain their blocks.
+	DataBlock_AllocateItem(dataBlock, NULL);
+	DataBlock_Accommodate(dataBlock, 1000000);
+	ASSERT_EQ(dataBlock->blockCap, 131072);
+	ASSERT_GE(dataBlock->itemCap, 1000000);
+
+	DataBlock_Free(dataBlock);
+}
+
+// Counts cloned items, negating the clone's value.
+static void _negate_item(void *dst, const void *src, void *arg) {
+	*(int *)dst = -*(const int *)src;
+	(*(uint *)arg)++;
+}
+
+TEST_F(DataBlockTest, Clone) {
+	// Spread items over three blocks.
+	DataBlock *dataBlock = DataBlock_New(1024, sizeof(int), NULL);
+	uint itemCount = 2048 + 16;
+	for(int i = 0 ; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+	for(uint i = 0; i < itemCount; i += 3) DataBlock_DeleteItem(dataBlock, i);
+
+	uint cloned = 0;
+	DataBlock *clone = DataBlock_Clone(dataBlock, _negate_item, &cloned);
+	ASSERT_EQ(clone->itemCount, dataBlock->itemCount);
+	ASSERT_EQ(clone->itemCap, dataBlock->itemCap);
+	ASSERT_EQ(clone->blockCount, dataBlock->blockCount);
+	ASSERT_EQ(array_len(clone->deletedIdx), array_len(dataBlock->deletedIdx));
+	ASSERT_EQ(cloned, dataBlock->itemCount);
+
+	// Items retain their positions, deleted items remain deleted.
+	for(uint i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_GetItem(clone, i);
+		if(i % 3 == 0) {
+			ASSERT_TRUE(item == NULL);
+		} else {
+			ASSERT_TRUE(item != NULL);
+			ASSERT_EQ(*item, -(int)i);
+			ASSERT_EQ(*(int *)DataBlock_GetItem(dataBlock, i), i);
+		}
+	}
+
+	// Deleted positions are reused by the clone independently.
+	uint64_t idx;
+	DataBlock_AllocateItem(clone, &idx);
+	ASSERT_EQ(idx % 3, 0);
+	ASSERT_TRUE(DataBlock_GetItem(dataBlock, idx) == NULL);
+
+	DataBlock_Free(clone);
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, AllocateItems) {
+	DataBlock *dataBlock = DataBlock_New(16, sizeof(int), NULL);
+	for(int i = 0; i < 8; i++) DataBlock_AllocateItem(dataBlock, NULL);
+	DataBlock_DeleteItem(dataBlock, 2);
+	DataBlock_DeleteItem(dataBlock, 5);
+
+	// Free positions are reused first, remaining items are appended.
+	uint64_t n = 100;
+	uint64_t idx[100];
+	DataBlock_AllocateItems(dataBlock, n, idx);
+	ASSERT_EQ(dataBlock->itemCount, 106);
+	ASSERT_EQ(array_len(dataBlock->deletedIdx), 0);
+	ASSERT_GE(dataBlock->itemCap, 106);
+	ASSERT_TRUE((idx[0] == 5 && idx[1] == 2) || (idx[0] == 2 && idx[1] == 5));
+	for(uint64_t i = 2; i < n; i++) ASSERT_EQ(idx[i], i + 6);
+
+	// Allocated items are accessible and can be initialized independently.
+	for(uint64_t i = 0; i < n; i++) {
+		int *item = (int *)DataBlock_GetItem(dataBlock, idx[i]);
+		ASSERT_TRUE(item != NULL);
+		*item = i;
+	}
+	for(uint64_t i = 0; i < n; i++) ASSERT_EQ(*(int *)DataBlock_GetItem(dataBlock, idx[i]), i);
+
+	// Following allocations resume past the allocated items.
+	uint64_t next;
+	DataBlock_AllocateItem(dataBlock, &next);
+	ASSERT_EQ(next, 106);
+
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, GetLiveItem) {
+	DataBlock *dataBlock = DataBlock_New(64, sizeof(int), NULL);
+	uint itemCount = 10000;
+	for(int i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// Live items are located at the same address across blocks.
+	for(uint64_t i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_GetLiveItem(dataBlock, i);
+		ASSERT_EQ(item, DataBlock_GetItem(dataBlock, i));
+		ASSERT_EQ(*item, i);
+	}
+
+	DataBlock_Free(dataBlock);
+}
@@ -485,3 +485,35 @@ TEST_F(FilterTreeTest, FilterTree_Compact) {
 	FilterTree_Free(actual);
 	FilterTree_Free(expected);
 }
+
+TEST_F(FilterTreeTest, FilterTree_Reorder) {
+	// The cheap equality is evaluated ahead of the string scan.
+	const char *q = "MATCH (n) WHERE toLower(n.name) CONTAINS 'a' AND n.age = 34 AND n.height > 170 RETURN n";
+	FT_FilterNode *tree = build_tree_from_query(q);
+	FilterTree_Reorder(tree, NULL);
+
+	FT_FilterNode **conjuncts = FilterTree_Conjuncts(tree);
+	ASSERT_EQ(array_len(conjuncts), 3);
+	ASSERT_EQ(conjuncts[0]->t, FT_N_PRED);
+	ASSERT_EQ(conjuncts[0]->pred.op, OP_EQUAL);
+	ASSERT_EQ(conjuncts[1]->t, FT_N_PRED);
+	ASSERT_EQ(conjuncts[1]->pred.op, OP_GT);
+	FT_FilterNode *node;
+	ASSERT_TRUE(FilterTree_ContainsFunc(conjuncts[2], "tolower", &node));
+
+	// Estimates compose over conditions.
+	double eq = FilterTree_Selectivity(conjuncts[0], NULL);
+	array_free(conjuncts);
+	ASSERT_GT(FilterTree_Selectivity(tree, NULL), 0);
+	ASSERT_LT(FilterTree_Selectivity(tree, NULL), eq);
+	ASSERT_GT(FilterTree_Cost(tree, NULL), 0);
+	FilterTree_Free(tree);
+
+	// Disjunctions evaluate operands most likely to pass first.
+	q = "MATCH (n) WHERE n.age = 34 OR n.age <> 30 RETURN n";
+	tree = build_tree_from_query(q);
+	FilterTree_Reorder(tree, NULL);
+	ASSERT_EQ(tree->cond.op, OP_OR);
+	ASSERT_EQ(tree->cond.left->pred.op, OP_NEQUAL);
+	FilterTree_Free(tree);
+}
@@ -17,6 +17,8 @@ extern "C"
 #include "../../deps/GraphBLAS/Include/GraphBLAS.h"
 #include "../../src/util/datablock/datablock_iterator.h"
 #include "../../src/util/rmalloc.h"
+#include "../../src/algorithms/node_ordering.h"
+#include "../../src/graph/degree_stats.h"
 
 #ifdef __cplusplus
 }
@@ -654,6 +656,103 @@ TEST_F(GraphTest, GetNode) {
 	Graph_Free(g);
 }
 
+TEST_F(GraphTest, GetNodeLabel) {
+	/* Create a graph with both labeled and unlabeled nodes,
+	 * Make sure each node reports the label it was created with. */
+
+	Node n;
+	size_t nodeCount = 16;
+	Graph *g = Graph_New(nodeCount, nodeCount);
+	Graph_AcquireWriteLock(g);
+	int labels[3];
+	for(int i = 0; i < 3; i++) labels[i] = Graph_AddLabel(g);
+
+	for(int i = 0; i < nodeCount; i++) {
+		int label = (i % 4 == 3) ? GRAPH_NO_LABEL : labels[i % 4];
+		Graph_CreateNode(g, label, &n);
+	}
+
+	for(NodeID i = 0; i < nodeCount; i++) {
+		int expected = (i % 4 == 3) ? GRAPH_NO_LABEL : labels[i % 4];
+		ASSERT_EQ(Graph_GetNodeLabel(g, i), expected);
+	}
+
+	// Label of a none existing node.
+	ASSERT_EQ(Graph_GetNodeLabel(g, nodeCount), GRAPH_NO_LABEL);
+
+	Graph_ReleaseLock(g);
+	Graph_Free(g);
+}
+
+TEST_F(GraphTest, MultiLabelNode) {
+	/* Create a graph with nodes holding multiple labels,
+	 * Make sure each node is a member of all of its labels. */
+
+	Node n;
+	int labels[3];
+	Graph *g = Graph_New(16, 16);
+	Graph_AcquireWriteLock(g);
+	int A = Graph_AddLabel(g);
+	int B = Graph_AddLabel(g);
+	int C = Graph_AddLabel(g);
+
+	// (:A), (:A:B), (:C:A:B), ()
+	Graph_CreateNode(g, A, &n);
+	Graph_CreateNode(g, A, &n);
+	Graph_LabelNode(g, 1, B);
+	Graph_CreateNode(g, C, &n);
+	Graph_LabelNode(g, 2, A);
+	Graph_LabelNode(g, 2, B);
+	// Labeling a node twice using the same label has no effect.
+	Graph_LabelNode(g, 2, B);
+	Graph_CreateNode(g, GRAPH_NO_LABEL, &n);
+
+	ASSERT_EQ(Graph_GetNodeLabels(g, 0, labels, 3), 1);
+	ASSERT_EQ(labels[0], A);
+
+	ASSERT_EQ(Graph_GetNodeLabels(g, 1, labels, 3), 2);
+	ASSERT_EQ(labels[0], A);
+	ASSERT_EQ(labels[1], B);
+
+	// Primary label is reported first.
+	ASSERT_EQ(Graph_GetNodeLabels(g, 2, labels, 3), 3);
+	ASSERT_EQ(labels[0], C);
+	ASSERT_EQ(labels[1], A);
+	ASSERT_EQ(labels[2], B);
+	ASSERT_EQ(Graph_GetNodeLabel(g, 2), C);
+
+	ASSERT_EQ(Graph_GetNodeLabels(g, 3, labels, 3), 0);
+
+	// Label count is reported even if labels doesn't fit.
+	ASSERT_EQ(Graph_GetNodeLabels(g, 2, NULL, 0), 3);
+
+	ASSERT_TRUE(Graph_IsNodeLabeled(g, 1, B));
+	ASSERT_FALSE(Graph_IsNodeLabeled(g, 1, C));
+	ASSERT_FALSE(Graph_IsNodeLabeled(g, 3, A));
+
+	// Label matrices hold secondary labels.
+	ASSERT_EQ(Graph_LabeledNodeCount(g, A), 3);
+	ASSERT_EQ(Graph_LabeledNodeCount(g, B), 2);
+	ASSERT_EQ(Graph_LabeledNodeCount(g, C), 1);
+
+	// Labels beyond nodes' first label are discounted as nodes are deleted.
+	ASSERT_EQ(g->secondary_labels, 3);
+	Graph_GetNode(g, 2, &n);
+	Graph_DeleteNode(g, &n);
+	ASSERT_EQ(g->secondary_labels, 1);
+
+	uint node_deleted;
+	uint edge_deleted;
+	Node nodes[1];
+	Graph_GetNode(g, 1, nodes);
+	Graph_BulkDelete(g, nodes, 1, NULL, 0, &node_deleted, &edge_deleted);
+	ASSERT_EQ(node_deleted, 1);
+	ASSERT_EQ(g->secondary_labels, 0);
+
+	Graph_ReleaseLock(g);
+	Graph_Free(g);
+}
+
 TEST_F(GraphTest, GetEdge) {
 	/* Create a graph with both nodes and edges.
 	 * Make sure edge retrival works as expected:
@@ -881,3 +980,357 @@ TEST_F(GraphTest, BulkDelete) {
 	// Clean up.
 	Graph_Free(g);
 }
+
+TEST_F(GraphTest, TransposedRelationMatrix) {
+	/* Make sure a relation transposed matrix is built on first request
+	 * and kept up to date as edges are added and removed. */
+	Node n;
+	Edge e[4];
+	bool x;
+	GrB_Index nvals;
+	Graph *g = Graph_New(16, 16);
+
+	Graph_AcquireWriteLock(g);
+	int r = Graph_AddRelationType(g);
+	for(int i = 0; i < 4; i++) Graph_CreateNode(g, GRAPH_NO_LABEL, &n);
+
+	// (0)-[r]->(1), (0)-[r]->(2)
+	Graph_ConnectNodes(g, 0, 1, r, &e[0]);
+	Graph_ConnectNodes(g, 0, 2, r, &e[1]);
+
+	GrB_Matrix T = Graph_GetTransposedRelationMatrix(g, r);
+	GrB_Matrix_nvals(&nvals, T);
+	ASSERT_EQ(nvals, 2);
+	ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, T, 1, 0), GrB_SUCCESS);
+	ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, T, 2, 0), GrB_SUCCESS);
+
+	// Matrix is built only once.
+	ASSERT_EQ(Graph_GetTransposedRelationMatrix(g, r), T);
+
+	// (3)-[r]->(1) twice, incrementally added to the transposed matrix.
+	Graph_ConnectNodes(g, 3, 1, r, &e[2]);
+	Graph_ConnectNodes(g, 3, 1, r, &e[3]);
+	T = Graph_GetTransposedRelationMatrix(g, r);
+	GrB_Matrix_nvals(&nvals, T);
+	ASSERT_EQ(nvals, 3);
+	ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, T, 1, 3), GrB_SUCCESS);
+
+	// Entry remains as long as 3 is connected to 1.
+	Graph_DeleteEdge(g, &e[2]);
+	T = Graph_GetTransposedRelationMatrix(g, r);
+	ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, T, 1, 3), GrB_SUCCESS);
+	Graph_DeleteEdge(g, &e[3]);
+	T = Graph_GetTransposedRelationMatrix(g, r);
+	ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, T, 1, 3), GrB_NO_VALUE);
+
+	// No relation, get the transposed adjacency matrix.
+	GrB_Matrix TA = Graph_GetTransposedRelationMatrix(g, GRAPH_NO_RELATION);
+	ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, TA, 2, 0), GrB_SUCCESS);
+
+	// Deleting node 0 implicitly removes its edges.
+	Node nodes[1];
+	uint node_deleted = 0;
+	uint edge_deleted = 0;
+	Graph_GetNode(g, 0, &nodes[0]);
+	Graph_BulkDelete(g, nodes, 1, NULL, 0, &node_deleted, &edge_deleted);
+	T = Graph_GetTransposedRelationMatrix(g, r);
+	GrB_Matrix_nvals(&nvals, T);
+	ASSERT_EQ(nvals, 0);
+
+	Graph_ReleaseLock(g);
+	Graph_Free(g);
+}
+
+TEST_F(GraphTest, Defragment) {
+	/* Delete a portion of the graph's nodes and edges,
+	 * make sure IDs are reclaimed while the remaining graph is intact. */
+	Node n;
+	Edge e;
+	bool x;
+	EdgeID edge_id;
+	GrB_Index nvals;
+	uint64_t nodes_reclaimed;
+	uint64_t edges_reclaimed;
+	Graph *g = Graph_New(16, 16);
+
+	Graph_AcquireWriteLock(g);
+	int l = Graph_AddLabel(g);
+	int r = Graph_AddRelationType(g);
+
+	// Nothing to reclaim.
+	Graph_CreateNode(g, l, &n);
+	Graph_Defragment(g, &nodes_reclaimed, &edges_reclaimed);
+	ASSERT_EQ(nodes_reclaimed, 0);
+	ASSERT_EQ(edges_reclaimed, 0);
+
+	// Nodes 0-9, (i)-[r]->(i+1), (i)-[r]->(i+2) twice.
+	for(int i = 1; i < 10; i++) Graph_CreateNode(g, (i % 2) ? l : GRAPH_NO_LABEL, &n);
+	for(int i = 0; i < 8; i++) {
+		Graph_ConnectNodes(g, i, i + 1, r, &e);
+		Graph_ConnectNodes(g, i, i + 2, r, &e);
+		Graph_ConnectNodes(g, i, i + 2, r, &e);
+	}
+	// Build transposed relation matrix, such that it is compacted as well.
+	Graph_GetTransposedRelationMatrix(g, r);
+
+	// Delete nodes 0 and 5, along with their edges.
+	Node nodes[2];
+	uint node_deleted = 0;
+	uint edge_deleted = 0;
+	Graph_GetNode(g, 0, &nodes[0]);
+	Graph_GetNode(g, 5, &nodes[1]);
+	Graph_BulkDelete(g, nodes, 2, NULL, 0, &node_deleted, &edge_deleted);
+	size_t edge_count = Graph_EdgeCount(g);
+
+	Graph_Defragment(g, &nodes_reclaimed, &edges_reclaimed);
+	ASSERT_EQ(nodes_reclaimed, 2);
+	ASSERT_EQ(edges_reclaimed, 24 - edge_count);
+	ASSERT_EQ(Graph_NodeCount(g), 8);
+	ASSERT_EQ(Graph_EdgeCount(g), edge_count);
+	ASSERT_EQ(Graph_RequiredMatrixDim(g), 8);
+
+	// Entities are numbered densely.
+	for(NodeID i = 0; i < 8; i++) {
+		ASSERT_TRUE(Graph_GetNode(g, i, &n));
+		ASSERT_EQ(ENTITY_GET_ID(&n), i);
+	}
+	for(EdgeID i = 0; i < edge_count; i++) {
+		ASSERT_TRUE(Graph_GetEdge(g, i, &e));
+		ASSERT_EQ(ENTITY_GET_ID(&e), i);
+	}
+
+	/* Previous node IDs 1-4 are now 0-3, 6-9 are now 4-7.
+	 * Odd nodes were labeled. */
+	GrB_Matrix L = Graph_GetLabelMatrix(g, l);
+	GrB_Matrix_nvals(&nvals, L);
+	ASSERT_EQ(nvals, 4);
+	ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, L, 0, 0), GrB_SUCCESS);
+	ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, L, 5, 5), GrB_SUCCESS);
+	ASSERT_EQ(Graph_GetNodeLabel(g, 5), l);
+
+	// Previous (2)-[r]->(3), (2)-[r]->(4) twice.
+	Edge *edges = array_new(Edge, 2);
+	Graph_GetEdgesConnectingNodes(g, 1, 2, r, &edges);
+	ASSERT_EQ(array_len(edges), 1);
+	array_clear(edges);
+	Graph_GetEdgesConnectingNodes(g, 1, 3, r, &edges);
+	ASSERT_EQ(array_len(edges), 2);
+	for(int i = 0; i < 2; i++) {
+		ASSERT_LT(ENTITY_GET_ID(edges + i), edge_count);
+		ASSERT_EQ(Graph_GetEdgeRelation(g, edges + i), r);
+	}
+	array_free(edges);
+
+	// Previous (4)-[r]->(5) was removed, (4)-[r]->(6) twice became (3)-[r]->(4).
+	GrB_Matrix R = Graph_GetRelationMatrix(g, r);
+	ASSERT_EQ(GrB_Matrix_extractElement_UINT64(&edge_id, R, 3, 4), GrB_SUCCESS);
+	ASSERT_FALSE(SINGLE_EDGE(edge_id));
+	// Previous (6)-[r]->(7) became (4)-[r]->(5).
+	ASSERT_EQ(GrB_Matrix_extractElement_UINT64(&edge_id, R, 4, 5), GrB_SUCCESS);
+	ASSERT_TRUE(SINGLE_EDGE(edge_id));
+	ASSERT_LT(SINGLE_EDGE_ID(edge_id), edge_count);
+
+	GrB_Matrix T = Graph_GetTransposedRelationMatrix(g, r);
+	ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, T, 4, 3), GrB_SUCCESS);
+	ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, T, 5, 4), GrB_SUCCESS);
+	GrB_Matrix_nvals(&nvals, T);
+	GrB_Index relation_nvals;
+	GrB_Matrix_nvals(&relation_nvals, R);
+	ASSERT_EQ(nvals, relation_nvals);
+
+	Graph_ReleaseLock(g);
+	Graph_Free(g);
+}
+
+TEST_F(GraphTest, PermuteNodes) {
+	/* Create a path whose consecutive nodes are assigned distant IDs,
+	 * reorder nodes and make sure the path is laid out contiguously. */
+	Node n;
+	Edge e;
+	bool x;
+	EdgeID edge_id;
+	GrB_Index nvals;
+	const int node_count = 10;
+	NodeID path[node_count] = {0, 5, 1, 6, 2, 7, 3, 8, 4, 9};
+	Graph *g = Graph_New(16, 16);
+
+	Graph_AcquireWriteLock(g);
+	int l = Graph_AddLabel(g);
+	int r = Graph_AddRelationType(g);
+
+	// Only node 5 is labeled.
+	for(int i = 0; i < node_count; i++) Graph_CreateNode(g, (i == 5) ? l : GRAPH_NO_LABEL, &n);
+	for(int i = 0; i < node_count - 1; i++) Graph_ConnectNodes(g, path[i], path[i + 1], r, &e);
+	// Build transposed relation matrix, such that it is reordered as well.
+	Graph_GetTransposedRelationMatrix(g, r);
+
+	GrB_Matrix A = Graph_GetAdjacencyMatrix(g);
+	GrB_Matrix AT = Graph_GetTransposedRelationMatrix(g, GRAPH_NO_RELATION);
+	ASSERT_GT(NodeOrdering_MeanDistance(A), 4);
+
+	GrB_Index *perm = ReverseCuthillMcKee(A, AT);
+	// Permutation is a bijection.
+	bool assigned[node_count] = {false};
+	for(int i = 0; i < node_count; i++) {
+		ASSERT_LT(perm[i], node_count);
+		ASSERT_FALSE(assigned[perm[i]]);
+		assigned[perm[i]] = true;
+	}
+
+	Graph_PermuteNodes(g, perm);
+	ASSERT_EQ(Graph_NodeCount(g), node_count);
+	ASSERT_EQ(Graph_EdgeCount(g), node_count - 1);
+	for(NodeID i = 0; i < node_count; i++) {
+		ASSERT_TRUE(Graph_GetNode(g, i, &n));
+		ASSERT_EQ(ENTITY_GET_ID(&n), i);
+	}
+
+	// Path neighbors are assigned consecutive IDs.
+	A = Graph_GetAdjacencyMatrix(g);
+	ASSERT_EQ(NodeOrdering_MeanDistance(A), 1);
+
+	// Edges follow their endpoints.
+	GrB_Matrix R = Graph_GetRelationMatrix(g, r);
+	GrB_Matrix T = Graph_GetTransposedRelationMatrix(g, r);
+	for(int i = 0; i < node_count - 1; i++) {
+		NodeID src = perm[path[i]];
+		NodeID dest = perm[path[i + 1]];
+		ASSERT_EQ(GrB_Matrix_extractElement_UINT64(&edge_id, R, src, dest), GrB_SUCCESS);
+		ASSERT_EQ(SINGLE_EDGE_ID(edge_id), i);
+		ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, T, dest, src), GrB_SUCCESS);
+		ASSERT_TRUE(Graph_GetEdge(g, i, &e));
+		ASSERT_EQ(Graph_GetEdgeRelation(g, &e), r);
+	}
+
+	// Label follows node.
+	GrB_Matrix L = Graph_GetLabelMatrix(g, l);
+	GrB_Matrix_nvals(&nvals, L);
+	ASSERT_EQ(nvals, 1);
+	ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, L, perm[5], perm[5]), GrB_SUCCESS);
+	ASSERT_EQ(Graph_GetNodeLabel(g, perm[5]), l);
+
+	rm_free(perm);
+	Graph_ReleaseLock(g);
+	Graph_Free(g);
+}
+
+TEST_F(GraphTest, DegreeStats) {
+	Node n;
+	Edge e;
+	DegreeSummary summary;
+	Graph *g = Graph_New(128, 128);
+	Graph_AcquireWriteLock(g);
+	int r = Graph_AddRelationType(g);
+	for(int i = 0; i < 101; i++) Graph_CreateNode(g, GRAPH_NO_LABEL, &n);
+
+	// Node 0 is connected to every other node, which are chained to their successor.
+	for(int i = 1; i < 101; i++) Graph_ConnectNodes(g, 0, i, r, &e);
+	for(int i = 1; i < 100; i++) Graph_ConnectNodes(g, i, i + 1, r, &e);
+	// Parallel edges are counted once.
+	Graph_ConnectNodes(g, 0, 1, r, &e);
+
+	DegreeStats_Get(g, r, GRAPH_EDGE_DIR_OUTGOING, &summary);
+	ASSERT_EQ(summary.nodes, 100);
+	ASSERT_EQ(summary.max, 100);
+	ASSERT_EQ(summary.p99, 1);
+	ASSERT_NEAR(summary.avg, 199.0 / 100, 1e-9);
+	ASSERT_EQ(summary.supernodeCount, 1);
+	ASSERT_EQ(summary.supernodes[0], 0);
+
+	DegreeStats_Get(g, r, GRAPH_EDGE_DIR_INCOMING, &summary);
+	ASSERT_EQ(summary.nodes, 100);
+	ASSERT_EQ(summary.max, 2);
+	ASSERT_EQ(summary.supernodeCount, 0);
+
+	// Summaries are rebuilt once the relation changed considerably.
+	for(int i = 2; i < 101; i++) Graph_ConnectNodes(g, i, 1, r, &e);
+	DegreeStats_Get(g, r, GRAPH_EDGE_DIR_INCOMING, &summary);
+	ASSERT_EQ(summary.max, 100);
+	ASSERT_EQ(summary.supernodes[0], 1);
+
+	// All relations are summarized by the adjacency matrix.
+	DegreeStats_Get(g, GRAPH_NO_RELATION, GRAPH_EDGE_DIR_OUTGOING, &summary);
+	ASSERT_EQ(summary.nodes, 101);
+	ASSERT_EQ(summary.max, 100);
+
+	Graph_ReleaseLock(g);
+	Graph_Free(g);
+}
+
+TEST_F(GraphTest, MatrixDimHeadroom) {
+	Node n;
+	GrB_Index nrows;
+	Graph *g = Graph_New(GRAPH_DEFAULT_NODE_CAP, GRAPH_DEFAULT_EDGE_CAP);
+	Graph_AcquireWriteLock(g);
+	int r = Graph_AddRelationType(g);
+	Graph_GetRelationMatrix(g, r);
+
+	// Dimensions grow geometrically rather than with every node.
+	uint resizes = 0;
+	size_t dim = Graph_RequiredMatrixDim(g);
+	for(uint i = 1; i <= 100000; i++) {
+		Graph_CreateNode(g, GRAPH_NO_LABEL, &n);
+		size_t required = Graph_RequiredMatrixDim(g);
+		ASSERT_GE(required, i);
+		ASSERT_LE(required, i + i / 8 + GRAPH_DEFAULT_NODE_CAP);
+		if(required != dim) resizes++;
+		dim = required;
+	}
+	ASSERT_LT(resizes, 100);
+
+	// Relation matrices are resized once accessed.
+	GrB_Matrix R = g->relations[r]->grb_matrix;
+	GrB_Matrix_nrows(&nrows, R);
+	ASSERT_LT(nrows, dim);
+	R = Graph_GetRelationMatrix(g, r);
+	GrB_Matrix_nrows(&nrows, R);
+	ASSERT_EQ(nrows, dim);
+
+	Graph_ReleaseLock(g);
+	Graph_Free(g);
+}
+
+TEST_F(GraphTest, LazyLabelMatrix) {
+	Node n;
+	bool x;
+	GrB_Index nvals;
+	Graph *g = Graph_New(GRAPH_DEFAULT_NODE_CAP, GRAPH_DEFAULT_EDGE_CAP);
+	Graph_AcquireWriteLock(g);
+	int l = Graph_AddLabel(g);
+	int k = Graph_AddLabel(g);
+
+	// Label every even node, node 4 is labeled twice.
+	for(int i = 0; i < 10; i++) Graph_CreateNode(g, (i % 2 == 0) ? l : GRAPH_NO_LABEL, &n);
+	Graph_LabelNode(g, 4, k);
+
+	// Labels are held as node IDs until their matrix is requested.
+	ASSERT_EQ(g->labels[l], (RG_Matrix)NULL);
+	ASSERT_EQ(Graph_LabeledNodeCount(g, l), 5);
+	ASSERT_TRUE(Graph_IsNodeLabeled(g, 4, k));
+	ASSERT_TRUE(IDSet_Contains(Graph_GetLabelIDs(g, l), 8));
+
+	GrB_Matrix L = Graph_GetLabelMatrix(g, l);
+	GrB_Matrix_nvals(&nvals, L);
+	ASSERT_EQ(nvals, 5);
+	for(GrB_Index i = 0; i < 10; i++) {
+		GrB_Info info = GrB_Matrix_extractElement_BOOL(&x, L, i, i);
+		ASSERT_EQ(info == GrB_SUCCESS, i % 2 == 0);
+	}
+
+	// Once built, the matrix is maintained alongside the node IDs.
+	Graph_CreateNode(g, l, &n);
+	ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, Graph_GetLabelMatrix(g, l), 10, 10), GrB_SUCCESS);
+
+	Graph_GetNode(g, 4, &n);
+	Graph_DeleteNode(g, &n);
+	ASSERT_EQ(Graph_LabeledNodeCount(g, l), 5);
+	ASSERT_EQ(Graph_LabeledNodeCount(g, k), 0);
+	ASSERT_EQ(g->secondary_labels, 0);
+	L = Graph_GetLabelMatrix(g, l);
+	ASSERT_EQ(GrB_Matrix_extractElement_BOOL(&x, L, 4, 4), GrB_NO_VALUE);
+	GrB_Matrix_nvals(&nvals, Graph_GetLabelMatrix(g, k));
+	ASSERT_EQ(nvals, 0);
+
+	Graph_ReleaseLock(g);
+	Graph_Free(g);
+}
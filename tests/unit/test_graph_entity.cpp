@@ -0,0 +1,64 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/graph/entities/graph_entity.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class GraphEntityTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(GraphEntityTest, GetProperty) {
+	// Two entities holding the same attributes in reversed order.
+	const int attr_count = 40;
+	Entity a_entity = {0};
+	Entity b_entity = {0};
+	GraphEntity a = {.entity = &a_entity};
+	GraphEntity b = {.entity = &b_entity};
+	for(int i = 0; i < attr_count; i++) {
+		GraphEntity_AddProperty(&a, i, SI_LongVal(i));
+		GraphEntity_AddProperty(&b, attr_count - 1 - i, SI_LongVal(attr_count - 1 - i));
+	}
+
+	// Alternate lookups, such that attribute positions keep changing.
+	for(int round = 0; round < 2; round++) {
+		for(int i = 0; i < attr_count; i++) {
+			SIValue *v = GraphEntity_GetProperty(&a, i);
+			ASSERT_EQ(v->longval, i);
+			v = GraphEntity_GetProperty(&b, i);
+			ASSERT_EQ(v->longval, i);
+		}
+	}
+
+	// Missing attributes.
+	ASSERT_EQ(GraphEntity_GetProperty(&a, attr_count), PROPERTY_NOTFOUND);
+	ASSERT_EQ(GraphEntity_GetProperty(&a, ATTRIBUTE_NOTFOUND), PROPERTY_NOTFOUND);
+
+	// Removing an attribute relocates the last attribute.
+	GraphEntity_SetProperty(&a, 0, SI_NullVal());
+	ASSERT_EQ(ENTITY_PROP_COUNT(&a), attr_count - 1);
+	ASSERT_EQ(GraphEntity_GetProperty(&a, 0), PROPERTY_NOTFOUND);
+	ASSERT_EQ(GraphEntity_GetProperty(&a, attr_count - 1)->longval, attr_count - 1);
+	ASSERT_EQ(GraphEntity_GetProperty(&b, attr_count - 1)->longval, attr_count - 1);
+
+	rm_free(a_entity.properties);
+	rm_free(b_entity.properties);
+}
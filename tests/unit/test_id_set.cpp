@@ -0,0 +1,159 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/id_set.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class IDSetTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(IDSetTest, AddContains) {
+	IDSet *set = IDSet_New();
+	ASSERT_EQ(IDSet_Cardinality(set), 0);
+
+	ASSERT_TRUE(IDSet_Add(set, 7));
+	ASSERT_TRUE(IDSet_Add(set, 1));
+	ASSERT_TRUE(IDSet_Add(set, 1ULL << 40));
+	// Adding an existing ID is a no-op.
+	ASSERT_FALSE(IDSet_Add(set, 7));
+	ASSERT_EQ(IDSet_Cardinality(set), 3);
+
+	ASSERT_TRUE(IDSet_Contains(set, 1));
+	ASSERT_TRUE(IDSet_Contains(set, 7));
+	ASSERT_TRUE(IDSet_Contains(set, 1ULL << 40));
+	ASSERT_FALSE(IDSet_Contains(set, 0));
+	ASSERT_FALSE(IDSet_Contains(set, (1ULL << 40) + 1));
+
+	IDSet_Clear(set);
+	ASSERT_EQ(IDSet_Cardinality(set), 0);
+	ASSERT_FALSE(IDSet_Contains(set, 7));
+
+	IDSet_Free(set);
+}
+
+TEST_F(IDSetTest, IterateAscending) {
+	IDSet *set = IDSet_New();
+	// Descending insertions spanning several containers.
+	for(int64_t id = 200000; id > 0; id -= 3) IDSet_Add(set, id);
+
+	uint64_t id;
+	uint64_t prev = 0;
+	uint64_t count = 0;
+	IDSetIterator it;
+	IDSet_Iterate(set, &it);
+	while(IDSetIterator_Next(&it, &id)) {
+		if(count > 0) ASSERT_GT(id, prev);
+		ASSERT_EQ(id % 3, 200000 % 3);
+		prev = id;
+		count++;
+	}
+	ASSERT_EQ(count, IDSet_Cardinality(set));
+
+	IDSet_Free(set);
+}
+
+TEST_F(IDSetTest, DenseRange) {
+	IDSet *sparse = IDSet_New();
+	IDSet *dense = IDSet_New();
+	for(uint64_t id = 0; id < 65536; id += 16) IDSet_Add(sparse, id);
+	for(uint64_t id = 0; id < 65536; id++) IDSet_Add(dense, id);
+
+	ASSERT_EQ(IDSet_Cardinality(sparse), 4096);
+	ASSERT_EQ(IDSet_Cardinality(dense), 65536);
+	// A full container costs a bit per ID rather than two bytes.
+	ASSERT_LT(IDSet_MemoryUsage(dense), 65536 / 8 + 1024);
+	for(uint64_t id = 0; id < 65536; id++) {
+		ASSERT_EQ(IDSet_Contains(sparse, id), id % 16 == 0);
+		ASSERT_TRUE(IDSet_Contains(dense, id));
+	}
+
+	IDSet_Free(sparse);
+	IDSet_Free(dense);
+}
+
+TEST_F(IDSetTest, UnionIntersect) {
+	IDSet *a = IDSet_New();
+	IDSet *b = IDSet_New();
+	for(uint64_t id = 0; id < 100000; id += 2) IDSet_Add(a, id);
+	for(uint64_t id = 0; id < 100000; id += 3) IDSet_Add(b, id);
+
+	IDSet *u = IDSet_New();
+	IDSet_Union(u, a);
+	IDSet_Union(u, b);
+	IDSet_Intersect(a, b);
+
+	uint64_t union_count = 0;
+	uint64_t intersect_count = 0;
+	for(uint64_t id = 0; id < 100000; id++) {
+		bool in_union = (id % 2 == 0 || id % 3 == 0);
+		bool in_intersect = (id % 6 == 0);
+		ASSERT_EQ(IDSet_Contains(u, id), in_union);
+		ASSERT_EQ(IDSet_Contains(a, id), in_intersect);
+		union_count += in_union;
+		intersect_count += in_intersect;
+	}
+	ASSERT_EQ(IDSet_Cardinality(u), union_count);
+	ASSERT_EQ(IDSet_Cardinality(a), intersect_count);
+
+	IDSet_Free(a);
+	IDSet_Free(b);
+	IDSet_Free(u);
+}
+
+TEST_F(IDSetTest, Remove) {
+	IDSet *set = IDSet_New();
+	// Dense container, converted back to an array as IDs are removed.
+	for(uint64_t id = 0; id < 10000; id++) IDSet_Add(set, id);
+	IDSet_Add(set, 1000000);
+
+	ASSERT_FALSE(IDSet_Remove(set, 20000));
+	for(uint64_t id = 0; id < 10000; id += 2) ASSERT_TRUE(IDSet_Remove(set, id));
+	ASSERT_FALSE(IDSet_Remove(set, 0));
+	ASSERT_TRUE(IDSet_Remove(set, 1000000));
+	ASSERT_EQ(IDSet_Cardinality(set), 5000);
+
+	for(uint64_t id = 0; id < 10000; id++) ASSERT_EQ(IDSet_Contains(set, id), id % 2 == 1);
+	ASSERT_FALSE(IDSet_Contains(set, 1000000));
+
+	IDSet_Free(set);
+}
+
+TEST_F(IDSetTest, IterateRange) {
+	IDSet *set = IDSet_New();
+	for(uint64_t id = 0; id < 200000; id += 3) IDSet_Add(set, id);
+
+	uint64_t id;
+	uint64_t expected = 70002;
+	IDSetIterator it;
+	IDSet_IterateRange(set, &it, 70001, 140000);
+	while(IDSetIterator_Next(&it, &id)) {
+		ASSERT_EQ(id, expected);
+		expected += 3;
+	}
+	ASSERT_EQ(expected, 140001);
+	ASSERT_FALSE(IDSetIterator_Next(&it, &id));
+
+	// Range past the last ID.
+	IDSet_IterateRange(set, &it, 200000, UINT64_MAX);
+	ASSERT_FALSE(IDSetIterator_Next(&it, &id));
+
+	IDSet_Free(set);
+}
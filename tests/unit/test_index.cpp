@@ -71,7 +71,7 @@ class IndexTest: public ::testing::Test {
 
 TEST_F(IndexTest, Index_New) {
 	const char *l = "Person";
-	Index *idx = Index_New(l, IDX_EXACT_MATCH);
+	Index *idx = Index_New(l, IDX_EXACT_MATCH, GETYPE_NODE);
 
 	// Return indexed label.
 	const char *label = Index_GetLabel(idx);
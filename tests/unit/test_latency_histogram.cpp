@@ -0,0 +1,74 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/latency_histogram.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class LatencyHistogramTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(LatencyHistogramTest, Empty) {
+	LatencyHistogram *h = LatencyHistogram_New();
+	LatencySummary summary = LatencyHistogram_Summarize(h);
+	ASSERT_EQ(summary.count, 0);
+	ASSERT_EQ(summary.mean, 0);
+	ASSERT_EQ(summary.p99, 0);
+	ASSERT_EQ(summary.max, 0);
+	LatencyHistogram_Free(h);
+}
+
+TEST_F(LatencyHistogramTest, Percentiles) {
+	LatencyHistogram *h = LatencyHistogram_New();
+	// Latencies of 1 to 10000 microseconds.
+	for(int usec = 1; usec <= 10000; usec++) LatencyHistogram_Record(h, (double)usec / 1000);
+
+	LatencySummary summary = LatencyHistogram_Summarize(h);
+	ASSERT_EQ(summary.count, 10000);
+	ASSERT_NEAR(summary.mean, 5.0005, 0.001);
+	ASSERT_EQ(summary.max, 10);
+
+	// Percentiles are reported within 12.5% of their actual value, never below it.
+	const double percentiles[4] = {0.5, 0.9, 0.99, 0.999};
+	const double reported[4] = {summary.p50, summary.p90, summary.p99, summary.p999};
+	for(int i = 0; i < 4; i++) {
+		double actual = percentiles[i] * 10;
+		ASSERT_GE(reported[i], actual);
+		ASSERT_LE(reported[i], actual * 1.125);
+		ASSERT_EQ(reported[i], LatencyHistogram_Percentile(h, percentiles[i]));
+	}
+
+	LatencyHistogram_Free(h);
+}
+
+TEST_F(LatencyHistogramTest, Outliers) {
+	LatencyHistogram *h = LatencyHistogram_New();
+	for(int i = 0; i < 999; i++) LatencyHistogram_Record(h, 0.002);
+	// A single day long latency exceeds the tracked range.
+	LatencyHistogram_Record(h, 24 * 60 * 60 * 1000.0);
+
+	LatencySummary summary = LatencyHistogram_Summarize(h);
+	ASSERT_EQ(summary.p50, 0.002);
+	ASSERT_EQ(summary.p99, 0.002);
+	ASSERT_EQ(summary.max, 24 * 60 * 60 * 1000.0);
+	ASSERT_EQ(summary.p999, summary.max);
+
+	LatencyHistogram_Free(h);
+}
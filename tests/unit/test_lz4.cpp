@@ -0,0 +1,75 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/lz4.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+class LZ4Test: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+
+	// Compress len bytes of src, expecting them to decompress back to src.
+	static size_t RoundTrip(const char *src, size_t len) {
+		char *compressed = (char *)malloc(LZ4_COMPRESS_BOUND(len));
+		size_t compressed_len = LZ4_Compress(src, len, compressed);
+		EXPECT_LE(compressed_len, LZ4_COMPRESS_BOUND(len));
+
+		char *decompressed = (char *)malloc(len + 1);
+		EXPECT_EQ(LZ4_Decompress(compressed, compressed_len, decompressed, len), (int64_t)len);
+		EXPECT_EQ(memcmp(src, decompressed, len), 0);
+		free(compressed);
+		free(decompressed);
+		return compressed_len;
+	}
+};
+
+TEST_F(LZ4Test, RoundTrip) {
+	// Short buffers are stored as literals.
+	ASSERT_EQ(RoundTrip("", 0), 1);
+	ASSERT_EQ(RoundTrip("abc", 3), 4);
+
+	// Repetitive buffers compress well.
+	size_t len = 100000;
+	char *buf = (char *)malloc(len);
+	for(size_t i = 0; i < len; i++) buf[i] = "name,age,city;"[i % 14];
+	ASSERT_LT(RoundTrip(buf, len), len / 100);
+
+	// Random buffers don't grow past the bound.
+	srand(0);
+	for(size_t i = 0; i < len; i++) buf[i] = rand();
+	RoundTrip(buf, len);
+
+	// Mixed regions.
+	for(size_t i = 0; i < len; i++) buf[i] = (i % 1000 < 500) ? 'x' : rand() % 4;
+	RoundTrip(buf, len);
+	free(buf);
+}
+
+TEST_F(LZ4Test, MalformedBlocks) {
+	char out[64];
+	// Literals past the end of the block.
+	ASSERT_EQ(LZ4_Decompress("\x50" "ab", 3, out, sizeof(out)), -1);
+	// Match referring to data before the start of the output.
+	ASSERT_EQ(LZ4_Decompress("\x10" "a" "\x05\x00", 4, out, sizeof(out)), -1);
+	// Output exceeding capacity.
+	ASSERT_EQ(LZ4_Decompress("\x10" "a" "\x01\x00", 4, out, 4), -1);
+	ASSERT_EQ(LZ4_Decompress("\x10" "a" "\x01\x00" "\x10" "b", 6, out, sizeof(out)), 6);
+}
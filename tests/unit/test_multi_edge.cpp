@@ -0,0 +1,104 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/rmalloc.h"
+#include "../../src/graph/entities/multi_edge.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class MultiEdgeTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(MultiEdgeTest, New) {
+	MultiEdge *me = MultiEdge_New(3, 7);
+	ASSERT_EQ(me->count, 2);
+	ASSERT_GE(me->cap, 2);
+	ASSERT_EQ(me->ids[0], 3);
+	ASSERT_EQ(me->ids[1], 7);
+	MultiEdge_Free(me);
+}
+
+TEST_F(MultiEdgeTest, GrowAndShrink) {
+	// Grow list beyond the largest pooled capacity.
+	EdgeID edge_count = 100;
+	MultiEdge *me = MultiEdge_New(0, 1);
+	for(EdgeID i = 2; i < edge_count; i++) me = MultiEdge_Add(me, i);
+
+	ASSERT_EQ(me->count, edge_count);
+	ASSERT_GE(me->cap, edge_count);
+	for(EdgeID i = 0; i < edge_count; i++) {
+		ASSERT_EQ(me->ids[i], i);
+		ASSERT_EQ(MultiEdge_Find(me, i), i);
+	}
+	// Missing edge.
+	ASSERT_EQ(MultiEdge_Find(me, edge_count), me->count);
+
+	// Remove all but the last two edges, list capacity shrinks.
+	uint32_t cap = me->cap;
+	for(EdgeID i = 0; i < edge_count - 2; i++) {
+		me = MultiEdge_Remove(me, MultiEdge_Find(me, i));
+		ASSERT_EQ(me->count, edge_count - 1 - i);
+		ASSERT_EQ(MultiEdge_Find(me, i), me->count);
+	}
+	ASSERT_LT(me->cap, cap);
+
+	ASSERT_LT(MultiEdge_Find(me, edge_count - 2), 2);
+	ASSERT_LT(MultiEdge_Find(me, edge_count - 1), 2);
+	MultiEdge_Free(me);
+}
+
+TEST_F(MultiEdgeTest, PooledListsAreIndependent) {
+	// Interleave updates of many lists sharing the same pools.
+	const int list_count = 1000;
+	MultiEdge *lists[list_count];
+	for(int i = 0; i < list_count; i++) lists[i] = MultiEdge_New(i, i);
+	for(int j = 0; j < 10; j++) {
+		for(int i = 0; i < list_count; i++) lists[i] = MultiEdge_Add(lists[i], i);
+	}
+
+	for(int i = 0; i < list_count; i++) {
+		ASSERT_EQ(lists[i]->count, 12);
+		for(uint32_t j = 0; j < lists[i]->count; j++) ASSERT_EQ(lists[i]->ids[j], i);
+		MultiEdge_Free(lists[i]);
+	}
+}
+
+TEST_F(MultiEdgeTest, RemoveMany) {
+	EdgeID edge_count = 100;
+	MultiEdge *me = MultiEdge_New(0, 1);
+	for(EdgeID i = 2; i < edge_count; i++) me = MultiEdge_Add(me, i);
+	uint32_t cap = me->cap;
+
+	// Remove every edge but multiples of 10, list capacity shrinks.
+	EdgeID ids[edge_count];
+	uint32_t n = 0;
+	for(EdgeID i = 0; i < edge_count; i++) if(i % 10 != 0) ids[n++] = i;
+	me = MultiEdge_RemoveMany(me, ids, n);
+	ASSERT_EQ(me->count, 10);
+	ASSERT_LT(me->cap, cap);
+	for(EdgeID i = 0; i < edge_count; i++) {
+		if(i % 10 == 0) ASSERT_LT(MultiEdge_Find(me, i), me->count);
+		else ASSERT_EQ(MultiEdge_Find(me, i), me->count);
+	}
+
+	// Removing the remaining edges frees the list.
+	n = 0;
+	for(EdgeID i = 0; i < edge_count; i += 10) ids[n++] = i;
+	ASSERT_TRUE(MultiEdge_RemoveMany(me, ids, n) == NULL);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/numa.h"
+#include "../../src/util/rmalloc.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class NUMATest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(NUMATest, Topology) {
+	int node_count = NUMA_Init(false);
+	ASSERT_GE(node_count, 1);
+	ASSERT_EQ(NUMA_NodeCount(), node_count);
+	ASSERT_FALSE(NUMA_InterleaveEnabled());
+
+	// Interleaving requires multiple nodes.
+	ASSERT_EQ(NUMA_Init(true), node_count);
+	ASSERT_EQ(NUMA_InterleaveEnabled(), node_count > 1);
+
+	// Threads can only be pinned on multi node hosts.
+	if(node_count == 1) ASSERT_FALSE(NUMA_PinThread(pthread_self(), 0));
+	NUMA_Init(false);
+}
+
+TEST_F(NUMATest, Allocations) {
+	NUMA_Init(true);
+
+	// Large allocations are usable regardless of placement.
+	size_t size = NUMA_INTERLEAVE_THRESHOLD * 2;
+	unsigned char *p = (unsigned char *)NUMA_Calloc(1, size);
+	ASSERT_TRUE(p != NULL);
+	for(size_t i = 0; i < size; i += 4096) ASSERT_EQ(p[i], 0);
+	p[size - 1] = 1;
+
+	p = (unsigned char *)NUMA_Realloc(p, size * 2);
+	ASSERT_EQ(p[size - 1], 1);
+	memset(p, 1, size * 2);
+	NUMA_Free(p);
+
+	// Small allocations are left untouched.
+	int *small = (int *)NUMA_Malloc(sizeof(int));
+	*small = 1;
+	NUMA_Interleave(small, sizeof(int));
+	ASSERT_EQ(*small, 1);
+	NUMA_Free(small);
+
+	NUMA_Init(false);
+}
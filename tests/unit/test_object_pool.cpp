@@ -119,3 +119,38 @@ TEST_F(ObjectPoolTest, RemoveItem) {
 	ObjectPool_Free(object_pool);
 }
 
+
+TEST_F(ObjectPoolTest, Trim) {
+	ObjectPool *object_pool = ObjectPool_New(256, sizeof(uint), NULL);
+	uint item_count = 8 * POOL_BLOCK_CAP;
+	uint *item_pointers[item_count];
+
+	for(uint i = 0; i < item_count; i++) {
+		item_pointers[i] = (uint *)ObjectPool_NewItem(object_pool);
+		*item_pointers[i] = i + 1;
+	}
+	for(uint i = 0; i < item_count; i++) ObjectPool_DeleteItem(object_pool, item_pointers[i]);
+	ASSERT_EQ(object_pool->itemCount, 0);
+
+	// Trim the pool down to 2 blocks, their items remain available for reuse.
+	ObjectPool_Trim(object_pool, 2 * POOL_BLOCK_CAP);
+	ASSERT_EQ(object_pool->blockCount, 2);
+	ASSERT_EQ(object_pool->itemCap, 2 * POOL_BLOCK_CAP);
+	ASSERT_EQ(array_len(object_pool->deletedIdx), 2 * POOL_BLOCK_CAP);
+	ASSERT_TRUE(object_pool->blocks[1]->next == NULL);
+
+	// Trimming a pool smaller than the requested capacity is a no-op.
+	ObjectPool_Trim(object_pool, 4 * POOL_BLOCK_CAP);
+	ASSERT_EQ(object_pool->blockCount, 2);
+
+	// Reused items are zeroed, the pool grows once the retained items are exhausted.
+	for(uint i = 0; i < 3 * POOL_BLOCK_CAP; i++) {
+		uint *item = (uint *)ObjectPool_NewItem(object_pool);
+		if(i < 2 * POOL_BLOCK_CAP) ASSERT_EQ(*item, 0);
+		*item = i;
+	}
+	ASSERT_EQ(object_pool->itemCount, 3 * POOL_BLOCK_CAP);
+	ASSERT_GE(object_pool->itemCap, 3 * POOL_BLOCK_CAP);
+
+	ObjectPool_Free(object_pool);
+}
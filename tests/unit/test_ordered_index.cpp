@@ -0,0 +1,522 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/value.h"
+#include "../../src/util/arr.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/index/id_stream.h"
+#include "../../src/index/ordered_index.h"
+#include <math.h>
+#ifdef __cplusplus
+}
+#endif
+
+class OrderedIndexTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+
+	// Collect iterator's node IDs.
+	static NodeID *_collect(OrderedIndexIter *iter) {
+		NodeID id;
+		NodeID *ids = array_new(NodeID, 0);
+		while(OrderedIndexIter_Next(iter, &id)) ids = array_append(ids, id);
+		return ids;
+	}
+
+	static NodeID *_numeric_range(OrderedIndex *idx, Attribute_ID attr, double min, bool include_min,
+								  double max, bool include_max) {
+		NumericRange range = {min, max, include_min, include_max, true};
+		OrderedIndexIter *iter = OrderedIndex_IterateNumericRange(idx, attr, &range);
+		NodeID *ids = _collect(iter);
+		OrderedIndexIter_Free(iter);
+		return ids;
+	}
+
+	static NodeID *_string_range(OrderedIndex *idx, Attribute_ID attr, const char *min,
+								 bool include_min, const char *max, bool include_max) {
+		StringRange range = {(char *)min, (char *)max, include_min, include_max, true};
+		OrderedIndexIter *iter = OrderedIndex_IterateStringRange(idx, attr, &range);
+		NodeID *ids = _collect(iter);
+		OrderedIndexIter_Free(iter);
+		return ids;
+	}
+
+	static void _assert_ids(NodeID *ids, const NodeID *expected, uint count) {
+		ASSERT_EQ(array_len(ids), count);
+		for(uint i = 0; i < count; i++) ASSERT_EQ(ids[i], expected[i]);
+		array_free(ids);
+	}
+};
+
+TEST_F(OrderedIndexTest, NumericRanges) {
+	OrderedIndex *idx = OrderedIndex_New();
+	// Node i holds value i - 5, negative values included.
+	for(NodeID i = 0; i < 10; i++) OrderedIndex_Insert(idx, i, 0, SI_LongVal((int64_t)i - 5));
+	// Values of another attribute are not visited.
+	OrderedIndex_Insert(idx, 20, 1, SI_LongVal(0));
+	OrderedIndex_Insert(idx, 21, 0, SI_DoubleVal(-0.5));
+	OrderedIndex_Insert(idx, 22, 0, SI_BoolVal(true));
+	ASSERT_EQ(OrderedIndex_EntryCount(idx), 13);
+
+	// v = 0
+	NodeID eq[1] = {5};
+	_assert_ids(_numeric_range(idx, 0, 0, true, 0, true), eq, 1);
+
+	// v = 1, booleans are indexed as numerics.
+	NodeID eq_true[2] = {6, 22};
+	_assert_ids(_numeric_range(idx, 0, 1, true, 1, true), eq_true, 2);
+
+	// -2 < v <= 0
+	NodeID open[3] = {4, 21, 5};
+	_assert_ids(_numeric_range(idx, 0, -2, false, 0, true), open, 3);
+
+	// v < -3
+	NodeID lt[2] = {0, 1};
+	_assert_ids(_numeric_range(idx, 0, -INFINITY, false, -3, false), lt, 2);
+
+	// v >= 3
+	NodeID ge[2] = {8, 9};
+	_assert_ids(_numeric_range(idx, 0, 3, true, INFINITY, false), ge, 2);
+
+	// v = 100
+	_assert_ids(_numeric_range(idx, 0, 100, true, 100, true), NULL, 0);
+
+	// Unbounded, ordered by value.
+	NodeID all[12] = {0, 1, 2, 3, 4, 21, 5, 6, 22, 7, 8, 9};
+	_assert_ids(_numeric_range(idx, 0, -INFINITY, false, INFINITY, false), all, 12);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, StringRanges) {
+	OrderedIndex *idx = OrderedIndex_New();
+	const char *values[6] = {"b", "ab", "a", "abc", "B", ""};
+	for(NodeID i = 0; i < 6; i++) {
+		OrderedIndex_Insert(idx, i, 0, SI_ConstStringVal((char *)values[i]));
+	}
+	// Numeric values of the same attribute are not visited.
+	OrderedIndex_Insert(idx, 10, 0, SI_LongVal(1));
+
+	// Case-sensitive point lookups.
+	NodeID eq[1] = {1};
+	_assert_ids(_string_range(idx, 0, "ab", true, "ab", true), eq, 1);
+	NodeID eq_upper[1] = {4};
+	_assert_ids(_string_range(idx, 0, "B", true, "B", true), eq_upper, 1);
+
+	// Prefixes order first.
+	NodeID all[6] = {5, 4, 2, 1, 3, 0};
+	_assert_ids(_string_range(idx, 0, NULL, false, NULL, false), all, 6);
+
+	// "a" < v < "b"
+	NodeID open[2] = {1, 3};
+	_assert_ids(_string_range(idx, 0, "a", false, "b", false), open, 2);
+
+	// v <= "ab"
+	NodeID le[4] = {5, 4, 2, 1};
+	_assert_ids(_string_range(idx, 0, NULL, false, "ab", true), le, 4);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, RemoveEntries) {
+	OrderedIndex *idx = OrderedIndex_New();
+	for(NodeID i = 0; i < 10; i++) {
+		OrderedIndex_Insert(idx, i, 0, SI_LongVal(i % 2));
+		OrderedIndex_Insert(idx, i, 1, SI_ConstStringVal((char *)"x"));
+	}
+	ASSERT_EQ(OrderedIndex_EntryCount(idx), 20);
+
+	// Removing a node removes its entries of every attribute.
+	OrderedIndex_RemoveNode(idx, 2);
+	OrderedIndex_RemoveNode(idx, 100); // Unknown node.
+	ASSERT_EQ(OrderedIndex_EntryCount(idx), 18);
+	NodeID even[4] = {0, 4, 6, 8};
+	_assert_ids(_numeric_range(idx, 0, 0, true, 0, true), even, 4);
+
+	// Node re-indexed under a new value.
+	OrderedIndex_RemoveNode(idx, 4);
+	OrderedIndex_Insert(idx, 4, 0, SI_LongVal(1));
+	NodeID odd[6] = {1, 3, 4, 5, 7, 9};
+	_assert_ids(_numeric_range(idx, 0, 1, true, 1, true), odd, 6);
+
+	OrderedIndex_RemoveAttribute(idx, 1);
+	ASSERT_EQ(OrderedIndex_EntryCount(idx), 9);
+	_assert_ids(_string_range(idx, 1, "x", true, "x", true), NULL, 0);
+	// Nodes remain removable once an attribute is dropped.
+	OrderedIndex_RemoveNode(idx, 0);
+	ASSERT_EQ(OrderedIndex_EntryCount(idx), 8);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, ModifyWhileIterating) {
+	OrderedIndex *idx = OrderedIndex_New();
+	for(NodeID i = 0; i < 10; i++) OrderedIndex_Insert(idx, i, 0, SI_LongVal(i));
+
+	NodeID id;
+	NodeID *ids = array_new(NodeID, 0);
+	NumericRange range = {0, INFINITY, true, false, true};
+	OrderedIndexIter *iter = OrderedIndex_IterateNumericRange(idx, 0, &range);
+	while(OrderedIndexIter_Next(iter, &id)) {
+		ids = array_append(ids, id);
+		// Move each visited node out of the range, as an update would.
+		OrderedIndex_RemoveNode(idx, id);
+		OrderedIndex_Insert(idx, id, 0, SI_LongVal(-1));
+		// Remove the upcoming node.
+		if(id == 4) OrderedIndex_RemoveNode(idx, 5);
+	}
+	NodeID expected[9] = {0, 1, 2, 3, 4, 6, 7, 8, 9};
+	_assert_ids(ids, expected, 9);
+
+	// Reset rewinds to the start of the range.
+	OrderedIndex_Insert(idx, 5, 0, SI_LongVal(5));
+	OrderedIndexIter_Reset(iter);
+	ASSERT_TRUE(OrderedIndexIter_Next(iter, &id));
+	ASSERT_EQ(id, 5);
+	ASSERT_FALSE(OrderedIndexIter_Next(iter, &id));
+
+	OrderedIndexIter_Free(iter);
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, TuplePrefixes) {
+	OrderedIndex *idx = OrderedIndex_New();
+	// Node i holds (i % 3, "e" + i).
+	char email[8];
+	for(NodeID i = 0; i < 9; i++) {
+		snprintf(email, sizeof(email), "e%llu", (unsigned long long)i);
+		SIValue values[2] = {SI_LongVal(i % 3), SI_ConstStringVal(email)};
+		OrderedIndex_InsertTuple(idx, i, 0, values, 2);
+	}
+	// Node missing its trailing value.
+	SIValue partial[1] = {SI_LongVal(1)};
+	OrderedIndex_InsertTuple(idx, 20, 0, partial, 1);
+	// Entries of another composite are not visited.
+	SIValue other[2] = {SI_LongVal(1), SI_ConstStringVal((char *)"e1")};
+	OrderedIndex_InsertTuple(idx, 21, 1, other, 2);
+	// Nor are single attribute entries.
+	OrderedIndex_Insert(idx, 22, 0, SI_LongVal(1));
+
+	SIValue full[2] = {SI_LongVal(1), SI_ConstStringVal((char *)"e4")};
+	OrderedIndexIter *iter = OrderedIndex_IterateTuplePrefix(idx, 0, full, 2);
+	NodeID eq[1] = {4};
+	_assert_ids(_collect(iter), eq, 1);
+	OrderedIndexIter_Free(iter);
+
+	// A leading value does not match a prefix of a longer value.
+	SIValue prefix[2] = {SI_LongVal(1), SI_ConstStringVal((char *)"e")};
+	iter = OrderedIndex_IterateTuplePrefix(idx, 0, prefix, 2);
+	_assert_ids(_collect(iter), NULL, 0);
+	OrderedIndexIter_Free(iter);
+
+	iter = OrderedIndex_IterateTuplePrefix(idx, 0, partial, 1);
+	NodeID leading[4] = {20, 1, 4, 7};
+	_assert_ids(_collect(iter), leading, 4);
+	OrderedIndexIter_Free(iter);
+
+	OrderedIndex_RemoveNode(idx, 4);
+	iter = OrderedIndex_IterateTuplePrefix(idx, 0, partial, 1);
+	NodeID removed[3] = {20, 1, 7};
+	_assert_ids(_collect(iter), removed, 3);
+	OrderedIndexIter_Free(iter);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, EdgeEntries) {
+	OrderedIndex *idx = OrderedIndex_NewEdgeIndex();
+	// Edge i connects node i to node i + 100 and holds value i % 2.
+	for(EdgeID i = 0; i < 6; i++) OrderedIndex_InsertEdge(idx, i, i, i + 100, 0, SI_LongVal(i % 2));
+	ASSERT_EQ(OrderedIndex_EntryCount(idx), 6);
+
+	EdgeID id;
+	NodeID src;
+	NodeID dest;
+	NumericRange range = {1, 1, true, true, true};
+	OrderedIndexIter *iter = OrderedIndex_IterateNumericRange(idx, 0, &range);
+	for(EdgeID expected = 1; expected < 6; expected += 2) {
+		ASSERT_TRUE(OrderedIndexIter_NextEdge(iter, &id, &src, &dest));
+		ASSERT_EQ(id, expected);
+		ASSERT_EQ(src, expected);
+		ASSERT_EQ(dest, expected + 100);
+	}
+	ASSERT_FALSE(OrderedIndexIter_NextEdge(iter, &id, &src, &dest));
+
+	// Removing an edge removes its entries.
+	OrderedIndex_RemoveNode(idx, 3);
+	OrderedIndexIter_Reset(iter);
+	NodeID expected[2] = {1, 5};
+	_assert_ids(_collect(iter), expected, 2);
+
+	OrderedIndexIter_Free(iter);
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, Lookup) {
+	OrderedIndex *idx = OrderedIndex_New();
+	OrderedIndex_Insert(idx, 1, 0, SI_ConstStringVal((char *)"a"));
+	OrderedIndex_Insert(idx, 2, 0, SI_ConstStringVal((char *)"ab"));
+	OrderedIndex_Insert(idx, 3, 0, SI_LongVal(7));
+	OrderedIndex_Insert(idx, 4, 1, SI_LongVal(8));
+
+	NodeID id;
+	ASSERT_TRUE(OrderedIndex_Lookup(idx, 0, SI_ConstStringVal((char *)"a"), INVALID_ENTITY_ID, &id));
+	ASSERT_EQ(id, 1);
+	// Numerics compare by value.
+	ASSERT_TRUE(OrderedIndex_Lookup(idx, 0, SI_DoubleVal(7.0), INVALID_ENTITY_ID, &id));
+	ASSERT_EQ(id, 3);
+	// The excluded entity isn't reported.
+	ASSERT_FALSE(OrderedIndex_Lookup(idx, 0, SI_LongVal(7), 3, &id));
+	// Prefixes and values of other attributes don't match.
+	ASSERT_FALSE(OrderedIndex_Lookup(idx, 0, SI_ConstStringVal((char *)""), INVALID_ENTITY_ID, &id));
+	ASSERT_FALSE(OrderedIndex_Lookup(idx, 0, SI_LongVal(8), INVALID_ENTITY_ID, &id));
+	ASSERT_FALSE(OrderedIndex_Lookup(idx, 0, SI_NullVal(), INVALID_ENTITY_ID, &id));
+
+	ASSERT_FALSE(OrderedIndex_HasDuplicates(idx, 0));
+	OrderedIndex_Insert(idx, 5, 0, SI_ConstStringVal((char *)"ab"));
+	ASSERT_TRUE(OrderedIndex_HasDuplicates(idx, 0));
+	ASSERT_FALSE(OrderedIndex_HasDuplicates(idx, 1));
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, AttributeOrder) {
+	OrderedIndex *idx = OrderedIndex_New();
+	OrderedIndex_Insert(idx, 1, 0, SI_LongVal(3));
+	OrderedIndex_Insert(idx, 2, 0, SI_DoubleVal(-1.5));
+	OrderedIndex_Insert(idx, 3, 0, SI_LongVal(10));
+	OrderedIndex_Insert(idx, 4, 0, SI_ConstStringVal((char *)"b"));
+	OrderedIndex_Insert(idx, 5, 0, SI_ConstStringVal((char *)"a"));
+	OrderedIndex_Insert(idx, 6, 1, SI_LongVal(0));
+
+	uint64_t booleans;
+	ASSERT_EQ(OrderedIndex_AttributeEntryCount(idx, 0, &booleans), 5);
+	ASSERT_EQ(booleans, 0);
+	ASSERT_EQ(OrderedIndex_AttributeEntryCount(idx, 1, &booleans), 1);
+
+	OrderedIndexIter *iter = OrderedIndex_IterateAttribute(idx, 0, T_DOUBLE, false);
+	NodeID numerics[3] = {2, 1, 3};
+	_assert_ids(_collect(iter), numerics, 3);
+	OrderedIndexIter_Free(iter);
+
+	iter = OrderedIndex_IterateAttribute(idx, 0, T_DOUBLE, true);
+	NodeID numerics_desc[3] = {3, 1, 2};
+	_assert_ids(_collect(iter), numerics_desc, 3);
+	OrderedIndexIter_Free(iter);
+
+	iter = OrderedIndex_IterateAttribute(idx, 0, T_STRING, true);
+	NodeID strings_desc[2] = {4, 5};
+	_assert_ids(_collect(iter), strings_desc, 2);
+	OrderedIndexIter_Free(iter);
+
+	// Booleans are counted, as they're indexed among numerics.
+	OrderedIndex_Insert(idx, 7, 0, SI_BoolVal(true));
+	ASSERT_EQ(OrderedIndex_AttributeEntryCount(idx, 0, &booleans), 6);
+	ASSERT_EQ(booleans, 1);
+
+	OrderedIndex_RemoveNode(idx, 7);
+	OrderedIndex_RemoveNode(idx, 1);
+	ASSERT_EQ(OrderedIndex_AttributeEntryCount(idx, 0, &booleans), 4);
+	ASSERT_EQ(booleans, 0);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, EntryValues) {
+	OrderedIndex *idx = OrderedIndex_New();
+	OrderedIndex_Insert(idx, 1, 0, SI_LongVal(-3));
+	OrderedIndex_Insert(idx, 2, 0, SI_DoubleVal(2.5));
+	OrderedIndex_Insert(idx, 3, 0, SI_BoolVal(true));
+	// Beyond 2^53, integers are ordered but not restored.
+	OrderedIndex_Insert(idx, 4, 0, SI_LongVal((1LL << 53) + 1));
+	OrderedIndex_Insert(idx, 5, 1, SI_ConstStringVal((char *)"abc"));
+
+	NumericRange range = {-INFINITY, INFINITY, true, true, true};
+	OrderedIndexIter *iter = OrderedIndex_IterateNumericRange(idx, 0, &range);
+	ASSERT_EQ(OrderedIndexIter_Attribute(iter), 0);
+
+	NodeID id;
+	SIValue v;
+	ASSERT_TRUE(OrderedIndexIter_NextValue(iter, &id, &v));
+	ASSERT_EQ(id, 1);
+	ASSERT_EQ(SI_TYPE(v), T_INT64);
+	ASSERT_EQ(v.longval, -3);
+	ASSERT_TRUE(OrderedIndexIter_NextValue(iter, &id, &v));
+	ASSERT_EQ(id, 3);
+	ASSERT_EQ(SI_TYPE(v), T_BOOL);
+	ASSERT_TRUE(v.longval);
+	ASSERT_TRUE(OrderedIndexIter_NextValue(iter, &id, &v));
+	ASSERT_EQ(id, 2);
+	ASSERT_EQ(SI_TYPE(v), T_DOUBLE);
+	ASSERT_EQ(v.doubleval, 2.5);
+	ASSERT_TRUE(OrderedIndexIter_NextValue(iter, &id, &v));
+	ASSERT_EQ(id, 4);
+	ASSERT_EQ(SI_TYPE(v), T_NULL);
+	ASSERT_FALSE(OrderedIndexIter_NextValue(iter, &id, &v));
+	OrderedIndexIter_Free(iter);
+
+	iter = OrderedIndex_IterateAttribute(idx, 1, T_STRING, false);
+	ASSERT_TRUE(OrderedIndexIter_NextValue(iter, &id, &v));
+	ASSERT_EQ(id, 5);
+	ASSERT_EQ(SI_TYPE(v), T_STRING);
+	ASSERT_STREQ(v.stringval, "abc");
+	OrderedIndexIter_Free(iter);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, IDStreams) {
+	OrderedIndex *idx = OrderedIndex_New();
+	// Attribute 0 holds i % 3, attribute 1 holds i % 2, attribute 2 holds i.
+	for(NodeID i = 0; i < 30; i++) {
+		OrderedIndex_Insert(idx, i, 0, SI_LongVal(i % 3));
+		OrderedIndex_Insert(idx, i, 1, SI_LongVal(i % 2));
+		OrderedIndex_Insert(idx, i, 2, SI_LongVal(i));
+	}
+
+	NumericRange zero = {0, 0, true, true, true};
+	NumericRange one = {1, 1, true, true, true};
+	NumericRange high = {20, INFINITY, false, false, true};
+
+	// (attr0 = 0 AND attr1 = 1) OR attr2 > 20
+	IDStream **conjunction = array_new(IDStream *, 2);
+	OrderedIndexIter *iter = OrderedIndex_IterateNumericRange(idx, 0, &zero);
+	ASSERT_TRUE(OrderedIndexIter_SingleValue(iter));
+	conjunction = array_append(conjunction, IDStream_NewValue(iter));
+	iter = OrderedIndex_IterateNumericRange(idx, 1, &one);
+	conjunction = array_append(conjunction, IDStream_NewValue(iter));
+
+	IDStream **disjunction = array_new(IDStream *, 2);
+	disjunction = array_append(disjunction, IDStream_NewIntersection(conjunction));
+	iter = OrderedIndex_IterateNumericRange(idx, 2, &high);
+	ASSERT_FALSE(OrderedIndexIter_SingleValue(iter));
+	disjunction = array_append(disjunction, IDStream_NewRange(iter));
+	IDStream *s = IDStream_NewUnion(disjunction);
+
+	NodeID expected[12] = {3, 9, 15, 21, 22, 23, 24, 25, 26, 27, 28, 29};
+	NodeID id;
+	for(int pass = 0; pass < 2; pass++) {
+		uint count = 0;
+		while(IDStream_Next(s, &id)) {
+			ASSERT_LT(count, 12);
+			ASSERT_EQ(id, expected[count++]);
+		}
+		ASSERT_EQ(count, 12);
+		IDStream_Reset(s);
+	}
+
+	// Skipping reproduces the current ID if it's the target or past it.
+	ASSERT_TRUE(IDStream_SkipTo(s, 10, &id));
+	ASSERT_EQ(id, 15);
+	ASSERT_TRUE(IDStream_SkipTo(s, 12, &id));
+	ASSERT_EQ(id, 15);
+	ASSERT_TRUE(IDStream_Next(s, &id));
+	ASSERT_EQ(id, 21);
+	ASSERT_FALSE(IDStream_SkipTo(s, 30, &id));
+	IDStream_Free(s);
+
+	s = IDStream_NewEmpty();
+	ASSERT_FALSE(IDStream_Next(s, &id));
+	IDStream_Free(s);
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, PointBoxes) {
+	OrderedIndex *idx = OrderedIndex_New();
+	// A point every degree of latitude and every two degrees of longitude.
+	NodeID id = 0;
+	for(int lat = -90; lat <= 90; lat++) {
+		for(int lon = -180; lon < 180; lon += 2) {
+			OrderedIndex_Insert(idx, id++, 0, SI_Point(lat, lon));
+		}
+	}
+	NodeID point_count = id;
+	// Points are left out of the attribute's ordered entries.
+	uint64_t booleans;
+	ASSERT_EQ(OrderedIndex_AttributeEntryCount(idx, 0, &booleans), 0);
+
+	// Points are indexed under their exact value.
+	NodeID found;
+	ASSERT_TRUE(OrderedIndex_Lookup(idx, 0, SI_Point(10, 20), INVALID_ENTITY_ID, &found));
+	ASSERT_EQ(found, (10 + 90) * 180 + (20 + 180) / 2);
+	ASSERT_FALSE(OrderedIndex_Lookup(idx, 0, SI_Point(10, 21), INVALID_ENTITY_ID, &found));
+
+	PointBox boxes[3] = {
+		{10, 20, 12, 26},           // Small box.
+		{-90, -180, 90, 180},       // Entire globe.
+		{0.5, 0.5, 0.6, 0.6}        // Box holding no points.
+	};
+	NodeID expected[3] = {3 * 4, point_count, 0};
+
+	for(int i = 0; i < 3; i++) {
+		OrderedIndexIter **iters = OrderedIndex_IteratePointBox(idx, 0, boxes + i);
+		uint iter_count = array_len(iters);
+		ASSERT_LE(iter_count, 4);
+
+		// Every point within the box is produced once.
+		NodeID within = 0;
+		NodeID produced = 0;
+		bool *seen = (bool *)calloc(point_count, sizeof(bool));
+		for(uint j = 0; j < iter_count; j++) {
+			SIValue v;
+			while(OrderedIndexIter_NextValue(iters[j], &id, &v)) {
+				ASSERT_EQ(SI_TYPE(v), T_POINT);
+				ASSERT_FALSE(seen[id]);
+				seen[id] = true;
+				produced++;
+				if(v.point.latitude >= boxes[i].min_lat && v.point.latitude <= boxes[i].max_lat &&
+				   v.point.longitude >= boxes[i].min_lon && v.point.longitude <= boxes[i].max_lon) {
+					within++;
+				}
+			}
+			OrderedIndexIter_Free(iters[j]);
+		}
+		array_free(iters);
+		free(seen);
+		ASSERT_EQ(within, expected[i]);
+		// Cells are limited to the box's vicinity.
+		if(i == 0) ASSERT_LT(produced, point_count / 100);
+	}
+
+	OrderedIndex_Free(idx);
+}
+
+TEST_F(OrderedIndexTest, PointRadius) {
+	SIValue london = SI_Point(51.5074, -0.1278);
+	SIValue paris = SI_Point(48.8566, 2.3522);
+	double distance = Point_Distance(london, paris);
+	ASSERT_NEAR(distance, 343556, 1000);
+	ASSERT_EQ(Point_Distance(london, london), 0);
+
+	// A radius reaching Paris bounds it.
+	PointBox boxes[2];
+	ASSERT_EQ(Point_RadiusBoxes(london, distance, boxes), 1);
+	ASSERT_LE(boxes[0].min_lat, paris.point.latitude);
+	ASSERT_GE(boxes[0].max_lon, paris.point.longitude);
+	ASSERT_GT(boxes[0].min_lat, 40);
+
+	// Circles crossing the antimeridian are split.
+	SIValue fiji = SI_Point(-17.7134, 179.9);
+	ASSERT_EQ(Point_RadiusBoxes(fiji, 100000, boxes), 2);
+	ASSERT_EQ(boxes[0].max_lon, 180);
+	ASSERT_EQ(boxes[1].min_lon, -180);
+
+	// Circles containing a pole span every longitude.
+	SIValue north = SI_Point(89.5, 45);
+	ASSERT_EQ(Point_RadiusBoxes(north, 100000, boxes), 1);
+	ASSERT_EQ(boxes[0].min_lon, -180);
+	ASSERT_EQ(boxes[0].max_lon, 180);
+	ASSERT_EQ(boxes[0].max_lat, 90);
+}
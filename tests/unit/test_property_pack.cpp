@@ -0,0 +1,62 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/datatypes/array.h"
+#include "../../src/graph/entities/property_pack.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class PropertyPackTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(PropertyPackTest, RoundTrip) {
+	SIValue list = SI_Array(3);
+	SIArray_Append(&list, SI_LongVal(1));
+	SIArray_Append(&list, SI_ConstStringVal((char *)"two"));
+	SIArray_Append(&list, SI_DoubleVal(3.5));
+
+	EntityProperty properties[8] = {
+		{0, SI_LongVal(-1)},
+		{1, SI_LongVal(INT64_MAX)},
+		{2, SI_LongVal(INT64_MIN)},
+		{3, SI_DoubleVal(-0.25)},
+		{4, SI_BoolVal(true)},
+		{300, SI_ConstStringVal((char *)"Amsterdam")},
+		{6, SI_ConstStringVal((char *)"")},
+		{7, list},
+	};
+
+	void *pack = PropertyPack_New(properties, 8);
+	// Small values occupy a few bytes.
+	ASSERT_LT(PropertyPack_Size(pack), sizeof(properties));
+
+	EntityProperty unpacked[8];
+	PropertyPack_Unpack(pack, 8, unpacked);
+	for(int i = 0; i < 8; i++) {
+		ASSERT_EQ(unpacked[i].id, properties[i].id);
+		ASSERT_EQ(SI_TYPE(unpacked[i].value), SI_TYPE(properties[i].value));
+		ASSERT_EQ(SIValue_Compare(unpacked[i].value, properties[i].value, NULL), 0);
+		SIValue_Free(unpacked[i].value);
+	}
+
+	PropertyPack_Free(pack);
+	SIValue_Free(list);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/graph/entities/property_slab.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class PropertySlabTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(PropertySlabTest, Capacity) {
+	ASSERT_EQ(PropertySlab_Capacity(1), 1);
+	ASSERT_EQ(PropertySlab_Capacity(5), 6);
+	ASSERT_EQ(PropertySlab_Capacity(16), 16);
+	// Large arrays aren't rounded.
+	ASSERT_EQ(PropertySlab_Capacity(17), 17);
+}
+
+TEST_F(PropertySlabTest, GrowWithinClass) {
+	EntityProperty *properties = PropertySlab_Alloc(5);
+	for(int i = 0; i < 5; i++) properties[i] = {(Attribute_ID)i, SI_LongVal(i)};
+
+	// Growing within the class capacity keeps the array in place.
+	ASSERT_EQ(PropertySlab_Realloc(properties, 5, 6), properties);
+	properties[5] = {5, SI_LongVal(5)};
+
+	// Growing beyond moves the array, retaining its properties.
+	EntityProperty *moved = PropertySlab_Realloc(properties, 6, 7);
+	ASSERT_NE(moved, properties);
+	for(int i = 0; i < 6; i++) {
+		ASSERT_EQ(moved[i].id, i);
+		ASSERT_EQ(moved[i].value.longval, i);
+	}
+
+	// Beyond the largest class arrays are heap allocated.
+	EntityProperty *large = PropertySlab_Realloc(moved, 7, 20);
+	for(int i = 0; i < 6; i++) ASSERT_EQ(large[i].id, i);
+	EntityProperty *shrunk = PropertySlab_Realloc(large, 20, 3);
+	for(int i = 0; i < 3; i++) ASSERT_EQ(shrunk[i].id, i);
+	PropertySlab_Free(shrunk, 3);
+}
+
+TEST_F(PropertySlabTest, ReuseFreed) {
+	size_t allocated;
+	size_t used;
+	PropertySlab_Stats(&allocated, &used);
+	size_t initial_used = used;
+
+	EntityProperty *a = PropertySlab_Alloc(2);
+	EntityProperty *b = PropertySlab_Alloc(2);
+	ASSERT_NE(a, b);
+	PropertySlab_Stats(&allocated, &used);
+	ASSERT_EQ(used, initial_used + 2 * 2 * sizeof(EntityProperty));
+	ASSERT_GE(allocated, used);
+
+	// Freed arrays are handed to the next allocation of their class.
+	PropertySlab_Free(a, 2);
+	ASSERT_EQ(PropertySlab_Alloc(2), a);
+
+	PropertySlab_Free(a, 2);
+	PropertySlab_Free(b, 2);
+	PropertySlab_Stats(&allocated, &used);
+	ASSERT_EQ(used, initial_used);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/arr.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/query_stats/query_stats.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class QueryStatsTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+static QueryStatsSnapshot *_Find(QueryStatsSnapshot *snapshot, uint64_t fingerprint) {
+	for(uint i = 0; i < array_len(snapshot); i++) {
+		if(snapshot[i].fingerprint == fingerprint) return snapshot + i;
+	}
+	return NULL;
+}
+
+TEST_F(QueryStatsTest, AggregateByFingerprint) {
+	QueryStats *stats = QueryStats_New();
+	QueryStats_Record(stats, 1, "MATCH (n) RETURN n", 2, false);
+	QueryStats_Record(stats, 1, "MATCH (m) RETURN m", 4, true);
+	QueryStats_Record(stats, 2, "CREATE ()", 1, false);
+
+	QueryStatsSnapshot *snapshot = QueryStats_Snapshot(stats);
+	ASSERT_EQ(array_len(snapshot), 2);
+
+	QueryStatsSnapshot *entry = _Find(snapshot, 1);
+	ASSERT_TRUE(entry != NULL);
+	// The first query executed by the plan describes it.
+	ASSERT_STREQ(entry->query, "MATCH (n) RETURN n");
+	ASSERT_EQ(entry->latency.count, 2);
+	ASSERT_EQ(entry->errors, 1);
+	ASSERT_DOUBLE_EQ(entry->latency.mean, 3);
+	ASSERT_DOUBLE_EQ(entry->latency.max, 4);
+
+	entry = _Find(snapshot, 2);
+	ASSERT_TRUE(entry != NULL);
+	ASSERT_EQ(entry->latency.count, 1);
+	ASSERT_EQ(entry->errors, 0);
+
+	QueryStats_FreeSnapshot(snapshot);
+	QueryStats_Free(stats);
+}
+
+TEST_F(QueryStatsTest, EvictLeastExecuted) {
+	QueryStats *stats = QueryStats_New();
+	// Fingerprint 1 is executed the least.
+	for(uint64_t i = 1; i <= QUERY_STATS_CAPACITY; i++) {
+		for(uint64_t j = 0; j < 1 + (i > 1); j++) QueryStats_Record(stats, i, "RETURN 1", 1, false);
+	}
+
+	uint64_t fingerprint = QUERY_STATS_CAPACITY + 1;
+	QueryStats_Record(stats, fingerprint, "RETURN 2", 1, false);
+
+	QueryStatsSnapshot *snapshot = QueryStats_Snapshot(stats);
+	ASSERT_EQ(array_len(snapshot), QUERY_STATS_CAPACITY);
+	ASSERT_TRUE(_Find(snapshot, 1) == NULL);
+	ASSERT_TRUE(_Find(snapshot, 2) != NULL);
+	ASSERT_STREQ(_Find(snapshot, fingerprint)->query, "RETURN 2");
+
+	QueryStats_FreeSnapshot(snapshot);
+	QueryStats_Free(stats);
+}
@@ -0,0 +1,138 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/util/hll.h"
+#include "../../src/util/cms.h"
+#include "../../src/util/tdigest.h"
+#include "../../src/util/rmalloc.h"
+#include <math.h>
+#ifdef __cplusplus
+}
+#endif
+
+class SketchTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+
+	// Scrambles x into a uniformly distributed hash code.
+	static uint64_t _hash(uint64_t x) {
+		x += 0x9e3779b97f4a7c15ULL;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+		return x ^ (x >> 31);
+	}
+};
+
+TEST_F(SketchTest, HLLCount) {
+	HLL *hll = HLL_New();
+	ASSERT_EQ(HLL_Count(hll), 0);
+
+	// Small cardinalities are nearly exact.
+	for(uint64_t i = 0; i < 10; i++) HLL_Add(hll, _hash(i));
+	// Repeated items aren't counted again.
+	for(uint64_t i = 0; i < 10; i++) HLL_Add(hll, _hash(i));
+	ASSERT_EQ(HLL_Count(hll), 10);
+
+	for(uint64_t i = 10; i < 100000; i++) HLL_Add(hll, _hash(i));
+	ASSERT_NEAR(HLL_Count(hll), 100000, 5000);
+	HLL_Free(hll);
+}
+
+TEST_F(SketchTest, HLLMerge) {
+	// Overlapping halves estimate their union.
+	HLL *a = HLL_New();
+	HLL *b = HLL_New();
+	for(uint64_t i = 0; i < 60000; i++) HLL_Add(a, _hash(i));
+	for(uint64_t i = 40000; i < 100000; i++) HLL_Add(b, _hash(i));
+	HLL_Merge(a, b);
+	ASSERT_NEAR(HLL_Count(a), 100000, 5000);
+	HLL_Free(a);
+	HLL_Free(b);
+}
+
+TEST_F(SketchTest, TDigestQuantile) {
+	// Few values are interpolated exactly.
+	TDigest *td = TDigest_New();
+	for(int i = 1; i <= 5; i++) TDigest_Add(td, i * 2);
+	ASSERT_EQ(TDigest_Quantile(td, 0), 2);
+	ASSERT_NEAR(TDigest_Quantile(td, 0.1), 2.8, 1e-9);
+	ASSERT_EQ(TDigest_Quantile(td, 0.5), 6);
+	ASSERT_EQ(TDigest_Quantile(td, 1), 10);
+	TDigest_Free(td);
+
+	// Many values are summarized by few centroids.
+	td = TDigest_New();
+	double min = 1000000;
+	for(uint64_t i = 0; i < 1000000; i++) {
+		double v = _hash(i) % 1000000;
+		if(v < min) min = v;
+		TDigest_Add(td, v);
+	}
+	ASSERT_EQ(TDigest_Count(td), 1000000);
+	ASSERT_LE(td->cap, TDIGEST_CAPACITY);
+	double qs[5] = {0.001, 0.1, 0.5, 0.9, 0.999};
+	for(int i = 0; i < 5; i++) {
+		// Quantile rank error is small, and smaller still near the tails.
+		double tolerance = 1000000 * 0.01 * sqrt(qs[i] * (1 - qs[i]) * 4);
+		ASSERT_NEAR(TDigest_Quantile(td, qs[i]), qs[i] * 1000000, tolerance);
+	}
+	// The extremes are exact.
+	ASSERT_EQ(TDigest_Quantile(td, 0), min);
+	TDigest_Free(td);
+}
+
+TEST_F(SketchTest, TDigestMerge) {
+	TDigest *a = TDigest_New();
+	TDigest *b = TDigest_New();
+	// Each digest holds a separate half of the range.
+	for(int i = 0; i < 50000; i++) TDigest_Add(a, i);
+	for(int i = 50000; i < 100000; i++) TDigest_Add(b, i);
+	TDigest_Merge(a, b);
+	ASSERT_EQ(TDigest_Count(a), 100000);
+	ASSERT_NEAR(TDigest_Quantile(a, 0.5), 50000, 1000);
+	ASSERT_NEAR(TDigest_Quantile(a, 0.25), 25000, 1000);
+	ASSERT_EQ(TDigest_Quantile(a, 1), 99999);
+	TDigest_Free(a);
+	TDigest_Free(b);
+}
+
+TEST_F(SketchTest, CMSEstimate) {
+	CMS *cms = CMS_New();
+	ASSERT_EQ(CMS_Estimate(cms, _hash(0)), 0);
+
+	// A few frequent items among many infrequent ones.
+	uint64_t total = 0;
+	for(uint64_t i = 0; i < 100000; i++) {
+		uint64_t item = (i % 10 == 0) ? i % 40 : 1000 + i;
+		total += 1;
+		ASSERT_GE(CMS_Add(cms, _hash(item), 1), 1);
+	}
+	ASSERT_EQ(CMS_Total(cms), total);
+
+	// Estimates never undercount, and overcount by a fraction of the total.
+	double bound = total * M_E / CMS_WIDTH;
+	for(uint64_t i = 0; i < 40; i += 10) {
+		uint64_t estimate = CMS_Estimate(cms, _hash(i));
+		ASSERT_GE(estimate, 2500);
+		ASSERT_LE(estimate, 2500 + bound);
+	}
+	uint64_t estimate = CMS_Estimate(cms, _hash(1001));
+	ASSERT_GE(estimate, 1);
+	ASSERT_LE(estimate, 1 + bound);
+
+	// Weighted additions count as many occurrences.
+	ASSERT_GE(CMS_Add(cms, _hash(5000000), 100), 100);
+	ASSERT_EQ(CMS_Total(cms), total + 100);
+	CMS_Free(cms);
+}
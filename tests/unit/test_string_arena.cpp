@@ -0,0 +1,62 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/string_arena.h"
+#include <string.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+class StringArenaTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(StringArenaTest, CopiesStrings) {
+	const char *strings[4] = {"NL", "", "Amsterdam", "NL"};
+	char *copies[4];
+	StringArena_New(strings, 4, copies);
+
+	for(int i = 0; i < 4; i++) {
+		ASSERT_NE(copies[i], strings[i]);
+		ASSERT_STREQ(copies[i], strings[i]);
+	}
+
+	// Strings are laid out consecutively.
+	for(int i = 1; i < 4; i++) ASSERT_GT(copies[i], copies[i - 1]);
+	ASSERT_LT(copies[3] - copies[0], 64);
+
+	for(int i = 0; i < 4; i++) StringArena_Release(copies[i]);
+}
+
+TEST_F(StringArenaTest, ReleaseInAnyOrder) {
+	char longest[STRING_ARENA_MAX_LEN + 1];
+	memset(longest, 'x', STRING_ARENA_MAX_LEN);
+	longest[STRING_ARENA_MAX_LEN] = '\0';
+
+	const char *strings[3] = {"a", longest, "c"};
+	char *copies[3];
+	StringArena_New(strings, 3, copies);
+
+	// Remaining strings are intact while others are released.
+	StringArena_Release(copies[1]);
+	ASSERT_STREQ(copies[0], "a");
+	ASSERT_STREQ(copies[2], "c");
+	StringArena_Release(copies[2]);
+	ASSERT_STREQ(copies[0], "a");
+	StringArena_Release(copies[0]);
+}
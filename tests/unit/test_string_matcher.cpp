@@ -0,0 +1,74 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/string_matcher.h"
+#include <string.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+class StringMatcherTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(StringMatcherTest, Contains) {
+	const char *strings[7] = {"abracadabra", "cadabra", "abracad", "cad", "ca", "", "xxcadxx"};
+	StringMatcher *matcher = StringMatcher_New("cad", STRING_MATCH_CONTAINS);
+	// Agrees with strstr.
+	for(int i = 0; i < 7; i++) {
+		ASSERT_EQ(StringMatcher_Match(matcher, strings[i]), strstr(strings[i], "cad") != NULL);
+	}
+	StringMatcher_Free(matcher);
+
+	// Repeated characters within the pattern.
+	matcher = StringMatcher_New("aab", STRING_MATCH_CONTAINS);
+	ASSERT_TRUE(StringMatcher_Match(matcher, "aaaab"));
+	ASSERT_FALSE(StringMatcher_Match(matcher, "abaaba"));
+	StringMatcher_Free(matcher);
+
+	matcher = StringMatcher_New("b", STRING_MATCH_CONTAINS);
+	ASSERT_TRUE(StringMatcher_Match(matcher, "aab"));
+	ASSERT_FALSE(StringMatcher_Match(matcher, "aaa"));
+	StringMatcher_Free(matcher);
+
+	// Every string contains the empty string.
+	matcher = StringMatcher_New("", STRING_MATCH_CONTAINS);
+	ASSERT_TRUE(StringMatcher_Match(matcher, ""));
+	ASSERT_TRUE(StringMatcher_Match(matcher, "a"));
+	StringMatcher_Free(matcher);
+}
+
+TEST_F(StringMatcherTest, PrefixAndSuffix) {
+	StringMatcher *prefix = StringMatcher_New("abc", STRING_MATCH_PREFIX);
+	ASSERT_TRUE(StringMatcher_Match(prefix, "abc"));
+	ASSERT_TRUE(StringMatcher_Match(prefix, "abcd"));
+	ASSERT_FALSE(StringMatcher_Match(prefix, "ab"));
+	ASSERT_FALSE(StringMatcher_Match(prefix, "xabc"));
+	StringMatcher_Free(prefix);
+
+	StringMatcher *suffix = StringMatcher_New("abc", STRING_MATCH_SUFFIX);
+	ASSERT_TRUE(StringMatcher_Match(suffix, "abc"));
+	ASSERT_TRUE(StringMatcher_Match(suffix, "xabc"));
+	ASSERT_FALSE(StringMatcher_Match(suffix, "bc"));
+	ASSERT_FALSE(StringMatcher_Match(suffix, "abcd"));
+	StringMatcher_Free(suffix);
+
+	StringMatcher *empty = StringMatcher_New("", STRING_MATCH_SUFFIX);
+	ASSERT_TRUE(StringMatcher_Match(empty, ""));
+	StringMatcher_Free(empty);
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2018-2020 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/string_pool.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class StringPoolTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(StringPoolTest, InternSharesAllocation) {
+	StringPool *pool = StringPool_New();
+	char buf[16] = "Netherlands";
+
+	char *a = StringPool_Intern(pool, "Netherlands");
+	char *b = StringPool_Intern(pool, buf);
+	char *c = StringPool_Intern(pool, "Norway");
+
+	ASSERT_EQ(a, b);
+	ASSERT_NE(a, c);
+	ASSERT_STREQ(a, "Netherlands");
+	ASSERT_STREQ(c, "Norway");
+	ASSERT_EQ(StringPool_Count(pool), 2);
+
+	StringPool_Free(pool);
+}
+
+TEST_F(StringPoolTest, ReleaseFreesUnreferenced) {
+	StringPool *pool = StringPool_New();
+
+	char *a = StringPool_Intern(pool, "active");
+	StringPool_Retain(a);
+	StringPool_Retain(a);
+
+	StringPool_Release(a);
+	ASSERT_EQ(StringPool_Count(pool), 1);
+	ASSERT_EQ(StringPool_Intern(pool, "active"), a);
+
+	StringPool_Release(a);
+	ASSERT_EQ(StringPool_Count(pool), 0);
+
+	// String is reintroduced once interned again.
+	a = StringPool_Intern(pool, "active");
+	ASSERT_STREQ(a, "active");
+	ASSERT_EQ(StringPool_Count(pool), 1);
+
+	StringPool_Free(pool);
+}
+
+TEST_F(StringPoolTest, InternedValues) {
+	StringPool *pool = StringPool_New();
+	char *s = StringPool_Intern(pool, "pending");
+	StringPool_Retain(s);
+	SIValue v = SI_InternedStringVal(s);
+
+	// Shared and cloned values don't own a reference to the pooled string.
+	SIValue shared = SI_ShareValue(v);
+	ASSERT_EQ(shared.allocation, M_VOLATILE);
+	SIValue clone = SI_CloneValue(v);
+	ASSERT_EQ(clone.allocation, M_SELF);
+	ASSERT_NE(clone.stringval, s);
+	ASSERT_EQ(SIValue_Compare(v, clone, NULL), 0);
+	SIValue_Free(clone);
+	ASSERT_EQ(StringPool_Count(pool), 1);
+
+	// Freeing the value releases its reference.
+	SIValue_Free(v);
+	ASSERT_EQ(StringPool_Count(pool), 0);
+
+	StringPool_Free(pool);
+}
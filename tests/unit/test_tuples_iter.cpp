@@ -526,3 +526,171 @@ TEST_F(TuplesTest, IteratorRange) {
 	ASSERT_TRUE(depleted);
 }
 
+
+TEST_F(TuplesTest, HypersparseIteratorTest) {
+
+	// Matrix is 1000X1000, only a handful of rows are populated.
+	GrB_Index indices[6][2] = {
+		{3, 2},
+		{3, 900},
+		{17, 1},
+		{500, 0},
+		{500, 4},
+		{999, 999}
+	};
+
+	bool depleted;
+	bool is_hyper;
+	GrB_Info info;
+	GrB_Index row;
+	GrB_Index col;
+	GrB_Index nvals;
+
+	// Create and populate a hypersparse matrix.
+	GrB_Index n = 1000;
+	GrB_Matrix A = CreateSquareNByNEmptyMatrix(n);
+	GxB_Matrix_Option_set(A, GxB_HYPER, GxB_ALWAYS_HYPER);
+	for(int i = 0; i < 6; i ++) {
+		row = indices[i][0];
+		col = indices[i][1];
+		GrB_Matrix_setElement_BOOL(A, true, row, col);
+	}
+	// Flush pending changes.
+	GrB_Matrix_nvals(&nvals, A);
+	GxB_Matrix_Option_get(A, GxB_IS_HYPER, &is_hyper);
+	ASSERT_TRUE(is_hyper);
+
+	// Create iterator.
+	GxB_MatrixTupleIter *iter;
+	GxB_MatrixTupleIter_new(&iter, A);
+
+	// Iterate over the entire matrix.
+	for(int i = 0; i < 6; i ++) {
+		info = GxB_MatrixTupleIter_next(iter, &row, &col, &depleted);
+		ASSERT_EQ(GrB_SUCCESS, info);
+		ASSERT_FALSE(depleted);
+		ASSERT_EQ(indices[i][0], row);
+		ASSERT_EQ(indices[i][1], col);
+	}
+	GxB_MatrixTupleIter_next(iter, &row, &col, &depleted);
+	ASSERT_TRUE(depleted);
+
+	// Iterate over a populated row.
+	info = GxB_MatrixTupleIter_iterate_row(iter, 500);
+	ASSERT_EQ(GrB_SUCCESS, info);
+	for(int i = 3; i < 5; i ++) {
+		GxB_MatrixTupleIter_next(iter, &row, &col, &depleted);
+		ASSERT_FALSE(depleted);
+		ASSERT_EQ(indices[i][0], row);
+		ASSERT_EQ(indices[i][1], col);
+	}
+	GxB_MatrixTupleIter_next(iter, &row, &col, &depleted);
+	ASSERT_TRUE(depleted);
+
+	// Iterate over an empty row.
+	info = GxB_MatrixTupleIter_iterate_row(iter, 18);
+	ASSERT_EQ(GrB_SUCCESS, info);
+	GxB_MatrixTupleIter_next(iter, &row, &col, &depleted);
+	ASSERT_TRUE(depleted);
+
+	// Iterate over a range whose bounds are empty rows.
+	info = GxB_MatrixTupleIter_iterate_range(iter, 4, 998);
+	ASSERT_EQ(GrB_SUCCESS, info);
+	for(int i = 2; i < 5; i ++) {
+		GxB_MatrixTupleIter_next(iter, &row, &col, &depleted);
+		ASSERT_FALSE(depleted);
+		ASSERT_EQ(indices[i][0], row);
+		ASSERT_EQ(indices[i][1], col);
+	}
+	GxB_MatrixTupleIter_next(iter, &row, &col, &depleted);
+	ASSERT_TRUE(depleted);
+
+	// Jump to an empty row, iteration resumes from the following populated row.
+	info = GxB_MatrixTupleIter_jump_to_row(iter, 501);
+	ASSERT_EQ(GrB_SUCCESS, info);
+	GxB_MatrixTupleIter_next(iter, &row, &col, &depleted);
+	ASSERT_FALSE(depleted);
+	ASSERT_EQ(999, row);
+	ASSERT_EQ(999, col);
+	GxB_MatrixTupleIter_next(iter, &row, &col, &depleted);
+	ASSERT_TRUE(depleted);
+
+	GxB_MatrixTupleIter_free(iter);
+	GrB_Matrix_free(&A);
+}
+
+TEST_F(TuplesTest, RowSliceIteratorTest) {
+	GrB_Index indices[6][2] = {
+		{1, 0},
+		{1, 3},
+		{1, 7},
+		{4, 2},
+		{4, 5},
+		{9, 9}
+	};
+
+	bool depleted;
+	GrB_Info info;
+	GrB_Index row;
+	GrB_Index col;
+	GrB_Index count;
+	GrB_Index nvals;
+	const GrB_Index *cols;
+	const void *vals;
+
+	GrB_Index n = 10;
+	GrB_Matrix A;
+	GrB_Matrix_new(&A, GrB_UINT64, n, n);
+	for(int i = 0; i < 6; i++) {
+		GrB_Matrix_setElement_UINT64(A, i * 10, indices[i][0], indices[i][1]);
+	}
+	// Flush pending changes.
+	GrB_Matrix_nvals(&nvals, A);
+
+	GxB_MatrixTupleIter *iter;
+	GxB_MatrixTupleIter_new(&iter, A);
+
+	// Each populated row is returned as a single slice.
+	GrB_Index expected_rows[3] = {1, 4, 9};
+	GrB_Index expected_counts[3] = {3, 2, 1};
+	int entry = 0;
+	for(int i = 0; i < 3; i++) {
+		info = GxB_MatrixTupleIter_next_row(iter, &row, &cols, &vals, &count, &depleted);
+		ASSERT_EQ(GrB_SUCCESS, info);
+		ASSERT_FALSE(depleted);
+		ASSERT_EQ(expected_rows[i], row);
+		ASSERT_EQ(expected_counts[i], count);
+		for(GrB_Index j = 0; j < count; j++, entry++) {
+			ASSERT_EQ(indices[entry][1], cols[j]);
+			ASSERT_EQ(entry * 10, ((const uint64_t *)vals)[j]);
+		}
+	}
+	GxB_MatrixTupleIter_next_row(iter, &row, &cols, &vals, &count, &depleted);
+	ASSERT_TRUE(depleted);
+	ASSERT_EQ(0, count);
+
+	// A partially consumed row continues from the next entry.
+	GxB_MatrixTupleIter_iterate_row(iter, 1);
+	GxB_MatrixTupleIter_next(iter, &row, &col, &depleted);
+	ASSERT_EQ(0, col);
+	GxB_MatrixTupleIter_next_row(iter, &row, &cols, NULL, &count, &depleted);
+	ASSERT_FALSE(depleted);
+	ASSERT_EQ(1, row);
+	ASSERT_EQ(2, count);
+	ASSERT_EQ(3, cols[0]);
+	ASSERT_EQ(7, cols[1]);
+	GxB_MatrixTupleIter_next_row(iter, &row, &cols, NULL, &count, &depleted);
+	ASSERT_TRUE(depleted);
+
+	// Slices are bounded by the iterated range.
+	GxB_MatrixTupleIter_iterate_range(iter, 2, 8);
+	GxB_MatrixTupleIter_next_row(iter, &row, &cols, NULL, &count, &depleted);
+	ASSERT_FALSE(depleted);
+	ASSERT_EQ(4, row);
+	ASSERT_EQ(2, count);
+	GxB_MatrixTupleIter_next_row(iter, &row, &cols, NULL, &count, &depleted);
+	ASSERT_TRUE(depleted);
+
+	GxB_MatrixTupleIter_free(iter);
+	GrB_Matrix_free(&A);
+}
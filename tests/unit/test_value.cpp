@@ -209,6 +209,39 @@ TEST_F(ValueTest, TestArray) {
 	ASSERT_EQ(origHashCode, otherHashCode);
 }
 
+TEST_F(ValueTest, TestTypedArray) {
+	SIValue arr = SI_Array(8);
+	for(int i = 0; i < 8; i++) SIArray_Append(&arr, SI_DoubleVal(i / 2.0));
+
+	// Cloning a homogeneous array produces a typed array, transparent to its users.
+	SIValue typed = SI_CloneValue(arr);
+	ASSERT_EQ(SIArray_Length(typed), 8);
+	for(int i = 0; i < 8; i++) {
+		SIValue v = SIArray_Get(typed, i);
+		ASSERT_EQ(SI_TYPE(v), T_DOUBLE);
+		ASSERT_EQ(v.doubleval, i / 2.0);
+	}
+	ASSERT_EQ(SIValue_Compare(arr, typed, NULL), 0);
+	ASSERT_EQ(SIValue_HashCode(arr), SIValue_HashCode(typed));
+
+	// Appending a matching value keeps the array typed, others convert it.
+	SIArray_Append(&typed, SI_DoubleVal(4));
+	SIArray_Append(&typed, SI_LongVal(9));
+	SIArray_Append(&typed, SI_ConstStringVal((char *)"end"));
+	ASSERT_EQ(SIArray_Length(typed), 11);
+	ASSERT_EQ(SIArray_Get(typed, 8).doubleval, 4);
+	ASSERT_EQ(SIArray_Get(typed, 9).longval, 9);
+	ASSERT_STREQ(SIArray_Get(typed, 10).stringval, "end");
+
+	// Heterogeneous arrays are cloned as is.
+	SIValue clone = SI_CloneValue(typed);
+	ASSERT_EQ(SIValue_Compare(clone, typed, NULL), 0);
+
+	SIValue_Free(arr);
+	SIValue_Free(typed);
+	SIValue_Free(clone);
+}
+
 /* Test for difference in hash code for the same binary representation
  * for different types. The value boolean "true" and the integer value "1"
  * have the same binary representation. Given that, their types are different,
@@ -0,0 +1,203 @@
+/*
+* Copyright 2018-2020 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/datatypes/array.h"
+#include "../../src/index/vector_index.h"
+#include <math.h>
+#include <stdlib.h>
+#ifdef __cplusplus
+}
+#endif
+
+#define DIM 20
+
+class VectorIndexTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+
+	// Fills vec with pseudo random components in [0, 1).
+	static void _random_vector(float *vec, uint32_t dim, uint64_t *seed) {
+		for(uint32_t i = 0; i < dim; i++) {
+			*seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			vec[i] = (*seed >> 40) / (float)(1 << 24);
+		}
+	}
+
+	// Exact nearest neighbor of query among the count vectors, skipping every skip-th vector.
+	static NodeID _nearest(const float *vectors, uint32_t count, const float *query, uint32_t skip) {
+		NodeID nearest = 0;
+		double best = INFINITY;
+		for(uint32_t i = 0; i < count; i++) {
+			if(skip && i % skip == 0) continue;
+			double d = 0;
+			for(uint32_t j = 0; j < DIM; j++) {
+				double diff = vectors[i * DIM + j] - query[j];
+				d += diff * diff;
+			}
+			if(d < best) {
+				best = d;
+				nearest = i;
+			}
+		}
+		return nearest;
+	}
+};
+
+TEST_F(VectorIndexTest, EuclideanQuery) {
+	VectorIndex *idx = VectorIndex_New("L", "v", 0, 2, VECTOR_METRIC_EUCLIDEAN);
+	// Points on a line, spaced one apart.
+	for(NodeID i = 0; i < 10; i++) {
+		float vec[2] = {(float)i, 0};
+		VectorIndex_Insert(idx, i, vec);
+	}
+	ASSERT_EQ(VectorIndex_Count(idx), 10);
+
+	NodeID ids[3];
+	double distances[3];
+	float query[2] = {4.2, 0};
+	ASSERT_EQ(VectorIndex_Query(idx, query, 3, ids, distances), 3);
+	ASSERT_EQ(ids[0], 4);
+	ASSERT_EQ(ids[1], 5);
+	ASSERT_EQ(ids[2], 3);
+	ASSERT_NEAR(distances[0], 0.2, 1e-5);
+	ASSERT_NEAR(distances[1], 0.8, 1e-5);
+	ASSERT_NEAR(distances[2], 1.2, 1e-5);
+
+	// Retrieving more nodes than indexed.
+	NodeID all[20];
+	double all_distances[20];
+	ASSERT_EQ(VectorIndex_Query(idx, query, 20, all, all_distances), 10);
+
+	VectorIndex_Free(idx);
+}
+
+TEST_F(VectorIndexTest, CosineQuery) {
+	VectorIndex *idx = VectorIndex_New("L", "v", 0, 2, VECTOR_METRIC_COSINE);
+	float east[2] = {10, 0};
+	float north[2] = {0, 0.5};
+	float north_east[2] = {3, 3};
+	float zero[2] = {0, 0};
+	VectorIndex_Insert(idx, 0, east);
+	VectorIndex_Insert(idx, 1, north);
+	VectorIndex_Insert(idx, 2, north_east);
+	// Zero vectors have no direction and are not indexed.
+	VectorIndex_Insert(idx, 3, zero);
+	ASSERT_EQ(VectorIndex_Count(idx), 3);
+
+	// Magnitude doesn't affect distance.
+	NodeID ids[3];
+	double distances[3];
+	float query[2] = {0, 100};
+	ASSERT_EQ(VectorIndex_Query(idx, query, 3, ids, distances), 3);
+	ASSERT_EQ(ids[0], 1);
+	ASSERT_EQ(ids[1], 2);
+	ASSERT_EQ(ids[2], 0);
+	ASSERT_NEAR(distances[0], 0, 1e-5);
+	ASSERT_NEAR(distances[1], 1 - sqrt(0.5), 1e-5);
+	ASSERT_NEAR(distances[2], 1, 1e-5);
+
+	ASSERT_EQ(VectorIndex_Query(idx, zero, 3, ids, distances), 0);
+
+	VectorIndex_Free(idx);
+}
+
+TEST_F(VectorIndexTest, RemoveAndReplace) {
+	VectorIndex *idx = VectorIndex_New("L", "v", 0, 1, VECTOR_METRIC_EUCLIDEAN);
+	for(NodeID i = 0; i < 5; i++) {
+		float vec[1] = {(float)i};
+		VectorIndex_Insert(idx, i, vec);
+	}
+
+	// Removed nodes aren't retrieved.
+	VectorIndex_RemoveNode(idx, 2);
+	ASSERT_EQ(VectorIndex_Count(idx), 4);
+	NodeID ids[1];
+	double distances[1];
+	float query[1] = {2};
+	ASSERT_EQ(VectorIndex_Query(idx, query, 1, ids, distances), 1);
+	ASSERT_NE(ids[0], 2);
+
+	// Reindexing a node replaces its vector.
+	float moved[1] = {100};
+	VectorIndex_Insert(idx, 3, moved);
+	ASSERT_EQ(VectorIndex_Count(idx), 4);
+	query[0] = 99;
+	ASSERT_EQ(VectorIndex_Query(idx, query, 1, ids, distances), 1);
+	ASSERT_EQ(ids[0], 3);
+
+	// Removing every node empties the index.
+	for(NodeID i = 0; i < 5; i++) VectorIndex_RemoveNode(idx, i);
+	ASSERT_EQ(VectorIndex_Count(idx), 0);
+	ASSERT_EQ(VectorIndex_Query(idx, query, 1, ids, distances), 0);
+
+	VectorIndex_Free(idx);
+}
+
+TEST_F(VectorIndexTest, ReadVector) {
+	float vec[2];
+	SIValue list = SIArray_New(2);
+	SIArray_Append(&list, SI_LongVal(1));
+	SIArray_Append(&list, SI_DoubleVal(2.5));
+	ASSERT_TRUE(VectorIndex_ReadVector(list, 2, vec));
+	ASSERT_EQ(vec[0], 1);
+	ASSERT_EQ(vec[1], 2.5);
+
+	// Length must match the index dimension.
+	ASSERT_FALSE(VectorIndex_ReadVector(list, 3, vec));
+	// Components must be numerics.
+	SIArray_Append(&list, SI_ConstStringVal((char *)"3"));
+	ASSERT_FALSE(VectorIndex_ReadVector(list, 3, vec));
+	ASSERT_FALSE(VectorIndex_ReadVector(SI_LongVal(1), 1, vec));
+	SIArray_Free(list);
+
+	VectorMetric metric;
+	ASSERT_TRUE(VectorIndex_ParseMetric("Cosine", &metric));
+	ASSERT_EQ(metric, VECTOR_METRIC_COSINE);
+	ASSERT_TRUE(VectorIndex_ParseMetric("euclidean", &metric));
+	ASSERT_EQ(metric, VECTOR_METRIC_EUCLIDEAN);
+	ASSERT_FALSE(VectorIndex_ParseMetric("manhattan", &metric));
+}
+
+TEST_F(VectorIndexTest, Recall) {
+	const uint32_t count = 2000;
+	const uint32_t queries = 50;
+	uint64_t seed = 1;
+	float *vectors = (float *)malloc(sizeof(float) * count * DIM);
+	VectorIndex *idx = VectorIndex_New("L", "v", 0, DIM, VECTOR_METRIC_EUCLIDEAN);
+	for(uint32_t i = 0; i < count; i++) {
+		_random_vector(vectors + i * DIM, DIM, &seed);
+		VectorIndex_Insert(idx, i, vectors + i * DIM);
+	}
+	// Removed nodes keep routing searches.
+	for(uint32_t i = 0; i < count; i += 5) VectorIndex_RemoveNode(idx, i);
+
+	// The exact nearest neighbor is nearly always retrieved.
+	uint32_t found = 0;
+	for(uint32_t q = 0; q < queries; q++) {
+		float query[DIM];
+		_random_vector(query, DIM, &seed);
+		NodeID ids[10];
+		double distances[10];
+		ASSERT_EQ(VectorIndex_Query(idx, query, 10, ids, distances), 10);
+		for(uint32_t i = 1; i < 10; i++) ASSERT_LE(distances[i - 1], distances[i]);
+		for(uint32_t i = 0; i < 10; i++) ASSERT_NE(ids[i] % 5, 0);
+		if(ids[0] == _nearest(vectors, count, query, 5)) found++;
+	}
+	ASSERT_GE(found, queries * 9 / 10);
+
+	VectorIndex_Free(idx);
+	free(vectors);
+}